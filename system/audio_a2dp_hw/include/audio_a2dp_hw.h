@@ -73,6 +73,13 @@
 // results in unnecessary latency and CPU overhead for Bluetooth.
 #define AUDIO_STREAM_OUTPUT_BUFFER_PERIODS 2
 
+// AUDIO_STREAM_OUTPUT_PERIOD_MS is the default time period of the socket
+// buffer, AUDIO_STREAM_OUTPUT_MIN_PERIOD_MS the shortest period of the low
+// latency mode. A period shorter than the AudioFlinger FastMixer period
+// doesn't reduce the latency further and wakes the stack more often.
+#define AUDIO_STREAM_OUTPUT_PERIOD_MS 20
+#define AUDIO_STREAM_OUTPUT_MIN_PERIOD_MS 5
+
 #define AUDIO_SKT_DISCONNECTED (-1)
 
 typedef enum {
@@ -85,6 +92,12 @@ typedef enum {
   A2DP_CTRL_GET_OUTPUT_AUDIO_CONFIG,
   A2DP_CTRL_SET_OUTPUT_AUDIO_CONFIG,
   A2DP_CTRL_GET_PRESENTATION_POSITION,
+  // Followed by the uint32_t size of the audio buffer. Once acknowledged, the
+  // stack replies with a tA2DP_CTRL_ACK byte carrying, on success, the memory
+  // and event file descriptors of a uipc_shm_t ring. The audio data is then
+  // written to the ring instead of the data socket, until the data socket is
+  // disconnected.
+  A2DP_CTRL_GET_AUDIO_SHM,
 } tA2DP_CTRL_CMD;
 
 typedef enum {
@@ -138,14 +151,22 @@ typedef uint8_t tA2DP_BITS_PER_SAMPLE;
 // Furthermore, the AudioFlinger expects the buffer size to be a multiple
 // of 16 frames.
 //
-// NOTE: Currently, the computation uses the conservative 20ms time period.
+// |time_period_ms| defaults to the conservative 20ms time period, see
+// |audio_a2dp_hw_output_period_ms| for the low latency mode.
 //
 // Returns the computed buffer size. If any of the input parameters is
 // invalid, the return value is the default |AUDIO_STREAM_OUTPUT_BUFFER_SZ|.
 size_t audio_a2dp_hw_stream_compute_buffer_size(
     btav_a2dp_codec_sample_rate_t codec_sample_rate,
     btav_a2dp_codec_bits_per_sample_t codec_bits_per_sample,
-    btav_a2dp_codec_channel_mode_t codec_channel_mode);
+    btav_a2dp_codec_channel_mode_t codec_channel_mode,
+    uint64_t time_period_ms = AUDIO_STREAM_OUTPUT_PERIOD_MS);
+
+// Returns the time period of the output stream in milliseconds, from the
+// low latency period property. The default period is returned if the low
+// latency mode isn't enabled, otherwise the period is clamped to
+// [AUDIO_STREAM_OUTPUT_MIN_PERIOD_MS, AUDIO_STREAM_OUTPUT_PERIOD_MS].
+uint64_t audio_a2dp_hw_output_period_ms();
 
 // Returns whether the delay reporting property is set.
 bool delay_reporting_enabled();
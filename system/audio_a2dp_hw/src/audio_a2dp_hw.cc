@@ -38,7 +38,9 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <mutex>
+#include <thread>
 
 #include <hardware/audio.h>
 #include <hardware/hardware.h>
@@ -47,6 +49,7 @@
 #include "osi/include/hash_map_utils.h"
 #include "osi/include/osi.h"
 #include "osi/include/socket_utils/sockets.h"
+#include "udrv/include/uipc_shm.h"
 
 #include "audio_a2dp_hw.h"
 
@@ -125,16 +128,33 @@ struct a2dp_stream_common {
   std::recursive_mutex* mutex;  // See note below on mutex acquisition order.
   int ctrl_fd;
   int audio_fd;
+  // Ring the audio data is written to instead of |audio_fd|, when supported
+  // by the stack. It is only replaced when the audio path starts, while no
+  // audio data is written, and is valid while |audio_shm_active|.
+  bool use_audio_shm;
+  bool audio_shm_active;
+  uipc_shm_t* audio_shm;
   size_t buffer_sz;
   struct a2dp_config cfg;
   a2dp_state_t state;
 };
 
+// The audio path of a low latency output stream is started by |thread|, so
+// that out_write doesn't wait for the control channel handshake. The audio
+// data written while |pending| is dropped, and its frames are added to
+// |frames_dropped| until out_write can acquire the stream mutex again.
+struct a2dp_async_start {
+  std::thread thread;
+  std::atomic_bool pending{false};
+  std::atomic<uint64_t> frames_dropped{0};
+};
+
 struct a2dp_stream_out {
   struct audio_stream_out stream;
   struct a2dp_stream_common common;
   uint64_t frames_presented;  // frames written, never reset
   uint64_t frames_rendered;   // frames written, reset on standby
+  struct a2dp_async_start* async_start;  // NULL unless low latency
 };
 
 struct a2dp_stream_in {
@@ -478,6 +498,82 @@ static int a2dp_command(struct a2dp_stream_common* common, tA2DP_CTRL_CMD cmd) {
   return 0;
 }
 
+// Receives the status byte of the reply to A2DP_CTRL_GET_AUDIO_SHM, along with
+// up to |max_fds| file descriptors stored in |fds|. Returns the number of file
+// descriptors received, or -1 on failure.
+static int a2dp_ctrl_receive_fds(struct a2dp_stream_common* common,
+                                 uint8_t* status, int* fds, size_t max_fds) {
+  char control[CMSG_SPACE(sizeof(int) * 4)];
+  struct iovec iov = {.iov_base = status, .iov_len = 1};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = recvmsg(common->ctrl_fd, &msg, MSG_CMSG_CLOEXEC));
+  if (ret <= 0) {
+    ERROR("receive control data failed: %s",
+          ret == 0 ? "peer closed" : strerror(errno));
+    skt_disconnect(common->ctrl_fd);
+    common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
+    return -1;
+  }
+
+  size_t num_fds = 0;
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    int* received = (int*)CMSG_DATA(cmsg);
+    for (size_t i = 0; i < count; i++) {
+      if (num_fds < max_fds) {
+        fds[num_fds++] = received[i];
+      } else {
+        close(received[i]);
+      }
+    }
+  }
+  return num_fds;
+}
+
+// Gets the ring to write the audio data to from the stack. Returns NULL if the
+// stack doesn't support it, the audio data is then written to the data socket.
+static uipc_shm_t* a2dp_get_audio_shm(struct a2dp_stream_common* common) {
+  if (a2dp_command(common, A2DP_CTRL_GET_AUDIO_SHM) < 0) {
+    ERROR("get audio shm failed");
+    return NULL;
+  }
+
+  uint32_t buffer_sz = common->buffer_sz;
+  if (a2dp_ctrl_send(common, &buffer_sz, sizeof(buffer_sz)) < 0) {
+    ERROR("send buffer size failed");
+    return NULL;
+  }
+
+  uint8_t status = A2DP_CTRL_ACK_FAILURE;
+  int fds[2];
+  int num_fds = a2dp_ctrl_receive_fds(common, &status, fds, 2);
+  if (num_fds < 0) return NULL;
+  if (status != A2DP_CTRL_ACK_SUCCESS || num_fds != 2) {
+    ERROR("audio shm unavailable (status %d, %d fds)", status, num_fds);
+    for (int i = 0; i < num_fds; i++) close(fds[i]);
+    return NULL;
+  }
+
+  return uipc_shm_attach(fds[0], fds[1]);
+}
+
+// Disconnects the audio data path, the audio data is written to the ring
+// again only once the audio path is restarted.
+static void a2dp_disconnect_audio_path(struct a2dp_stream_common* common) {
+  skt_disconnect(common->audio_fd);
+  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_shm_active = false;
+}
+
 static int check_a2dp_ready(struct a2dp_stream_common* common) {
   if (a2dp_command(common, A2DP_CTRL_CMD_CHECK_READY) < 0) {
     ERROR("check a2dp ready failed");
@@ -640,7 +736,7 @@ static int a2dp_read_output_audio_config(
     common->cfg.format = stream_config.format;
     common->buffer_sz = audio_a2dp_hw_stream_compute_buffer_size(
         codec_config->sample_rate, codec_config->bits_per_sample,
-        codec_config->channel_mode);
+        codec_config->channel_mode, audio_a2dp_hw_output_period_ms());
     if (common->cfg.is_stereo_to_mono) {
       // We need to fetch twice as much data from the Audio framework
       common->buffer_sz *= 2;
@@ -826,6 +922,9 @@ static void a2dp_stream_common_init(struct a2dp_stream_common* common) {
 
   common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->use_audio_shm = false;
+  common->audio_shm_active = false;
+  common->audio_shm = NULL;
   common->state = AUDIO_A2DP_STATE_STOPPED;
 
   /* manages max capacity of socket pipe */
@@ -835,6 +934,9 @@ static void a2dp_stream_common_init(struct a2dp_stream_common* common) {
 static void a2dp_stream_common_destroy(struct a2dp_stream_common* common) {
   FNLOG();
 
+  uipc_shm_free(common->audio_shm);
+  common->audio_shm = NULL;
+
   delete common->mutex;
   common->mutex = NULL;
 }
@@ -862,6 +964,20 @@ static int start_audio_datapath(struct a2dp_stream_common* common) {
       goto error;
     }
   }
+
+  /* write the audio data to shared memory, unless the stack doesn't support
+   * it: the data socket is then used until the stream is closed */
+  if (common->use_audio_shm && !common->audio_shm_active) {
+    uipc_shm_t* audio_shm = a2dp_get_audio_shm(common);
+    if (audio_shm != NULL) {
+      uipc_shm_free(common->audio_shm);
+      common->audio_shm = audio_shm;
+      common->audio_shm_active = true;
+    } else {
+      INFO("writing the audio data to the data socket");
+      common->use_audio_shm = false;
+    }
+  }
   common->state = (a2dp_state_t)AUDIO_A2DP_STATE_STARTED;
 
   /* check to see if delay reporting is enabled */
@@ -892,8 +1008,7 @@ static int stop_audio_datapath(struct a2dp_stream_common* common) {
   common->state = (a2dp_state_t)AUDIO_A2DP_STATE_STOPPED;
 
   /* disconnect audio path */
-  skt_disconnect(common->audio_fd);
-  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  a2dp_disconnect_audio_path(common);
 
   return 0;
 }
@@ -912,9 +1027,7 @@ static int suspend_audio_datapath(struct a2dp_stream_common* common,
     common->state = AUDIO_A2DP_STATE_SUSPENDED;
 
   /* disconnect audio path */
-  skt_disconnect(common->audio_fd);
-
-  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  a2dp_disconnect_audio_path(common);
 
   return 0;
 }
@@ -925,6 +1038,42 @@ static int suspend_audio_datapath(struct a2dp_stream_common* common,
  *
  ****************************************************************************/
 
+static void out_async_start_audio_datapath(struct a2dp_stream_out* out) {
+  {
+    std::lock_guard<std::recursive_mutex> lock(*out->common.mutex);
+    // The stream may have been suspended or closed in the meantime
+    if ((out->common.state == AUDIO_A2DP_STATE_STOPPED) ||
+        (out->common.state == AUDIO_A2DP_STATE_STANDBY)) {
+      start_audio_datapath(&out->common);
+    }
+  }
+  out->async_start->pending = false;
+}
+
+// Returns false if the audio path start is pending, and |bytes| are dropped.
+// Otherwise the start is requested and returns true if |out| is low latency,
+// or the start completes before returning.
+static bool out_start_audio_datapath(struct a2dp_stream_out* out,
+                                     size_t bytes, int* status) {
+  struct a2dp_async_start* async_start = out->async_start;
+  if (async_start == NULL) {
+    *status = start_audio_datapath(&out->common);
+    return true;
+  }
+
+  bool pending = false;
+  if (!async_start->pending.compare_exchange_strong(pending, true)) {
+    async_start->frames_dropped +=
+        bytes / audio_stream_out_frame_size(&out->stream);
+    return false;
+  }
+  // The previous start has completed
+  if (async_start->thread.joinable()) async_start->thread.join();
+  async_start->thread = std::thread(out_async_start_audio_datapath, out);
+  *status = -1;
+  return true;
+}
+
 static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
                          size_t bytes) {
   struct a2dp_stream_out* out = (struct a2dp_stream_out*)stream;
@@ -933,6 +1082,15 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
 
   DEBUG("write %zu bytes (fd %d)", bytes, out->common.audio_fd);
 
+  // The start thread holds the stream mutex during the handshake
+  if (out->async_start != NULL && out->async_start->pending) {
+    out->async_start->frames_dropped +=
+        bytes / audio_stream_out_frame_size(stream);
+    DEBUG("audio path start pending, emulate a2dp write delay");
+    usleep(calc_audiotime_usec(out->common.cfg, bytes));
+    return bytes;
+  }
+
   std::unique_lock<std::recursive_mutex> lock(*out->common.mutex);
   if (out->common.state == AUDIO_A2DP_STATE_SUSPENDED ||
       out->common.state == AUDIO_A2DP_STATE_STOPPING) {
@@ -943,7 +1101,13 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
   /* only allow autostarting if we are in stopped or standby */
   if ((out->common.state == AUDIO_A2DP_STATE_STOPPED) ||
       (out->common.state == AUDIO_A2DP_STATE_STANDBY)) {
-    if (start_audio_datapath(&out->common) < 0) {
+    int status = -1;
+    if (!out_start_audio_datapath(out, bytes, &status)) {
+      lock.unlock();
+      usleep(calc_audiotime_usec(out->common.cfg, bytes));
+      return bytes;
+    }
+    if (status < 0) {
       goto finish;
     }
   } else if (out->common.state != AUDIO_A2DP_STATE_STARTED) {
@@ -964,13 +1128,25 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
           out->common.audio_fd);
   }
 
-  lock.unlock();
-  sent = skt_write(out->common.audio_fd, buffer, write_bytes);
-  lock.lock();
+  if (out->common.audio_shm_active) {
+    uipc_shm_t* audio_shm = out->common.audio_shm;
+    lock.unlock();
+    // The stack stopped reading if the ring stays full for too long
+    size_t written = uipc_shm_write(audio_shm, buffer, write_bytes,
+                                    SOCK_SEND_TIMEOUT_MS);
+    if (written < write_bytes) {
+      WARN("write timeout exceeded, sent %zu bytes", written);
+    }
+    sent = (written == write_bytes) ? (int)written : -1;
+    lock.lock();
+  } else {
+    lock.unlock();
+    sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+    lock.lock();
+  }
 
   if (sent == -1) {
-    skt_disconnect(out->common.audio_fd);
-    out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
+    a2dp_disconnect_audio_path(&out->common);
     if ((out->common.state != AUDIO_A2DP_STATE_SUSPENDED) &&
         (out->common.state != AUDIO_A2DP_STATE_STOPPING)) {
       out->common.state = AUDIO_A2DP_STATE_STOPPED;
@@ -981,7 +1157,10 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
   }
 
 finish:;
-  const size_t frames = bytes / audio_stream_out_frame_size(stream);
+  size_t frames = bytes / audio_stream_out_frame_size(stream);
+  if (out->async_start != NULL) {
+    frames += out->async_start->frames_dropped.exchange(0);
+  }
   out->frames_rendered += frames;
   out->frames_presented += frames;
   lock.unlock();
@@ -1028,9 +1207,9 @@ static size_t out_get_buffer_size(const struct audio_stream* stream) {
 size_t audio_a2dp_hw_stream_compute_buffer_size(
     btav_a2dp_codec_sample_rate_t codec_sample_rate,
     btav_a2dp_codec_bits_per_sample_t codec_bits_per_sample,
-    btav_a2dp_codec_channel_mode_t codec_channel_mode) {
+    btav_a2dp_codec_channel_mode_t codec_channel_mode,
+    uint64_t time_period_ms) {
   size_t buffer_sz = AUDIO_STREAM_OUTPUT_BUFFER_SZ;  // Default value
-  const uint64_t time_period_ms = 20;                // Conservative 20ms
   uint32_t sample_rate;
   uint32_t bits_per_sample;
   uint32_t number_of_channels;
@@ -1618,6 +1797,11 @@ static int adev_open_output_stream(struct audio_hw_device* dev,
 
   /* initialize a2dp specifics */
   a2dp_stream_common_init(&out->common);
+  out->common.use_audio_shm = true;
+  if (audio_a2dp_hw_output_period_ms() < AUDIO_STREAM_OUTPUT_PERIOD_MS) {
+    INFO("low latency output stream");
+    out->async_start = new a2dp_async_start;
+  }
 
   // Make sure we always have the feeding parameters configured
   btav_a2dp_codec_config_t codec_config;
@@ -1677,6 +1861,7 @@ static int adev_open_output_stream(struct audio_hw_device* dev,
   return 0;
 
 err_open:
+  delete out->async_start;
   a2dp_stream_common_destroy(&out->common);
   free(out);
   *stream_out = NULL;
@@ -1694,6 +1879,10 @@ static void adev_close_output_stream(struct audio_hw_device* dev,
 
   // prevent interference with adev_set_parameters.
   std::lock_guard<std::recursive_mutex> lock(*a2dp_dev->mutex);
+  // The start thread only acquires the stream mutex
+  if (out->async_start != NULL && out->async_start->thread.joinable()) {
+    out->async_start->thread.join();
+  }
   {
     std::lock_guard<std::recursive_mutex> lock(*out->common.mutex);
     const a2dp_state_t state = out->common.state;
@@ -1707,6 +1896,7 @@ static void adev_close_output_stream(struct audio_hw_device* dev,
     out->common.ctrl_fd = AUDIO_SKT_DISCONNECTED;
   }
 
+  delete out->async_start;
   a2dp_stream_common_destroy(&out->common);
   free(stream);
   a2dp_dev->output = NULL;
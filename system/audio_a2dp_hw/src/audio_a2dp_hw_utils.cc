@@ -34,6 +34,7 @@ const char* audio_a2dp_hw_dump_ctrl_event(tA2DP_CTRL_CMD event) {
     CASE_RETURN_STR(A2DP_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(A2DP_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(A2DP_CTRL_GET_PRESENTATION_POSITION)
+    CASE_RETURN_STR(A2DP_CTRL_GET_AUDIO_SHM)
   }
 
   return "UNKNOWN A2DP_CTRL_CMD";
@@ -42,3 +43,16 @@ const char* audio_a2dp_hw_dump_ctrl_event(tA2DP_CTRL_CMD event) {
 bool delay_reporting_enabled() {
   return !osi_property_get_bool("persist.bluetooth.disabledelayreports", false);
 }
+
+uint64_t audio_a2dp_hw_output_period_ms() {
+  int32_t period_ms =
+      osi_property_get_int32("persist.bluetooth.a2dp_hw.low_latency_period_ms",
+                             0 /* disabled */);
+  if (period_ms <= 0 || period_ms >= AUDIO_STREAM_OUTPUT_PERIOD_MS) {
+    return AUDIO_STREAM_OUTPUT_PERIOD_MS;
+  }
+  if (period_ms < AUDIO_STREAM_OUTPUT_MIN_PERIOD_MS) {
+    return AUDIO_STREAM_OUTPUT_MIN_PERIOD_MS;
+  }
+  return period_ms;
+}
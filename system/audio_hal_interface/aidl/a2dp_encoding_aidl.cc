@@ -323,6 +323,14 @@ bool a2dp_get_selected_hal_pcm_config(PcmConfiguration* pcm_config) {
   pcm_config->sampleRateHz = A2dpCodecToHalSampleRate(current_codec);
   pcm_config->bitsPerSample = A2dpCodecToHalBitsPerSample(current_codec);
   pcm_config->channelMode = A2dpCodecToHalChannelMode(current_codec);
+  // The PCM is read once per media tick of the encoder, which is shorter in
+  // low latency mode
+  const tA2DP_ENCODER_INTERFACE* encoder_interface =
+      bta_av_co_get_encoder_interface();
+  if (encoder_interface != nullptr) {
+    pcm_config->dataIntervalUs =
+        encoder_interface->get_encoder_interval_ms() * 1000;
+  }
   return (pcm_config->sampleRateHz > 0 && pcm_config->bitsPerSample > 0 &&
           pcm_config->channelMode != ChannelMode::UNKNOWN);
 }
@@ -73,6 +73,13 @@
 // results in unnecessary latency and CPU overhead for Bluetooth.
 #define AUDIO_STREAM_OUTPUT_BUFFER_PERIODS 2
 
+// AUDIO_STREAM_OUTPUT_PERIOD_MS is the default time period of the socket
+// buffer. In the low power mode, the longer AUDIO_STREAM_LOW_POWER_PERIOD_MS
+// period wakes AudioFlinger and the audio HAL up less often. It is a multiple
+// of the ASHA connection intervals, so that each write fills whole intervals.
+#define AUDIO_STREAM_OUTPUT_PERIOD_MS 20
+#define AUDIO_STREAM_LOW_POWER_PERIOD_MS 40
+
 #define AUDIO_SKT_DISCONNECTED (-1)
 
 typedef enum {
@@ -85,6 +92,12 @@ typedef enum {
   HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG,
   HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG,
   HEARING_AID_CTRL_CMD_OFFLOAD_START,
+  // Followed by the uint32_t size of the audio buffer. Once acknowledged, the
+  // stack replies with a tHEARING_AID_CTRL_ACK byte carrying, on success, the
+  // memory and event file descriptors of a uipc_shm_t ring. The audio data is
+  // then written to the ring instead of the data socket, until the data socket
+  // is disconnected.
+  HEARING_AID_CTRL_GET_AUDIO_SHM,
 } tHEARING_AID_CTRL_CMD;
 
 typedef enum {
@@ -135,13 +148,20 @@ typedef uint8_t tHA_CHANNEL_COUNT;
 // Furthermore, the AudioFlinger expects the buffer size to be a multiple
 // of 16 frames.
 //
-// NOTE: Currently, the computation uses the conservative 20ms time period.
+// |time_period_ms| defaults to the conservative 20ms time period, see
+// |audio_ha_hw_output_period_ms| for the low power mode.
 //
 // Returns the computed buffer size. If any of the input parameters is
 // invalid, the return value is the default |AUDIO_STREAM_OUTPUT_BUFFER_SZ|.
 size_t audio_ha_hw_stream_compute_buffer_size(
     btav_a2dp_codec_sample_rate_t codec_sample_rate,
     btav_a2dp_codec_bits_per_sample_t codec_bits_per_sample,
-    btav_a2dp_codec_channel_mode_t codec_channel_mode);
+    btav_a2dp_codec_channel_mode_t codec_channel_mode,
+    uint64_t time_period_ms = AUDIO_STREAM_OUTPUT_PERIOD_MS);
+
+// Returns the time period of the output stream in milliseconds:
+// AUDIO_STREAM_LOW_POWER_PERIOD_MS if the low power property is set,
+// otherwise AUDIO_STREAM_OUTPUT_PERIOD_MS.
+uint64_t audio_ha_hw_output_period_ms();
 
 #endif /* AUDIO_HEARING_AID_HW_H */
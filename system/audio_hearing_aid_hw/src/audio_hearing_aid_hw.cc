@@ -41,6 +41,7 @@
 #include "osi/include/hash_map_utils.h"
 #include "osi/include/osi.h"
 #include "osi/include/socket_utils/sockets.h"
+#include "udrv/include/uipc_shm.h"
 
 #include "audio_hearing_aid_hw/include/audio_hearing_aid_hw.h"
 
@@ -88,6 +89,7 @@ static const char* audio_ha_hw_dump_ctrl_event(tHEARING_AID_CTRL_CMD event) {
     CASE_RETURN_STR(HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_CMD_OFFLOAD_START)
+    CASE_RETURN_STR(HEARING_AID_CTRL_GET_AUDIO_SHM)
     default:
       break;
   }
@@ -134,6 +136,12 @@ struct ha_stream_common {
   std::recursive_mutex* mutex;  // See note below on mutex acquisition order.
   int ctrl_fd;
   int audio_fd;
+  // Ring the audio data is written to instead of |audio_fd|, when supported
+  // by the stack. It is only replaced when the audio path starts, by the
+  // thread writing the audio data, and is valid while |audio_shm_active|.
+  bool use_audio_shm;
+  bool audio_shm_active;
+  uipc_shm_t* audio_shm;
   size_t buffer_sz;
   struct ha_config cfg;
   ha_state_t state;
@@ -480,6 +488,82 @@ static int ha_command(struct ha_stream_common* common,
   return 0;
 }
 
+// Receives the status byte of the reply to HEARING_AID_CTRL_GET_AUDIO_SHM,
+// along with up to |max_fds| file descriptors stored in |fds|. Returns the
+// number of file descriptors received, or -1 on failure.
+static int ha_ctrl_receive_fds(struct ha_stream_common* common,
+                               uint8_t* status, int* fds, size_t max_fds) {
+  char control[CMSG_SPACE(sizeof(int) * 4)];
+  struct iovec iov = {.iov_base = status, .iov_len = 1};
+  struct msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = recvmsg(common->ctrl_fd, &msg, MSG_CMSG_CLOEXEC));
+  if (ret <= 0) {
+    ERROR("receive control data failed: %s",
+          ret == 0 ? "peer closed" : strerror(errno));
+    skt_disconnect(common->ctrl_fd);
+    common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
+    return -1;
+  }
+
+  size_t num_fds = 0;
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+    size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    int* received = (int*)CMSG_DATA(cmsg);
+    for (size_t i = 0; i < count; i++) {
+      if (num_fds < max_fds) {
+        fds[num_fds++] = received[i];
+      } else {
+        close(received[i]);
+      }
+    }
+  }
+  return num_fds;
+}
+
+// Gets the ring to write the audio data to from the stack. Returns NULL if the
+// stack doesn't support it, the audio data is then written to the data socket.
+static uipc_shm_t* ha_get_audio_shm(struct ha_stream_common* common) {
+  if (ha_command(common, HEARING_AID_CTRL_GET_AUDIO_SHM) < 0) {
+    ERROR("get audio shm failed");
+    return NULL;
+  }
+
+  uint32_t buffer_sz = common->buffer_sz;
+  if (ha_ctrl_send(common, &buffer_sz, sizeof(buffer_sz)) < 0) {
+    ERROR("send buffer size failed");
+    return NULL;
+  }
+
+  uint8_t status = HEARING_AID_CTRL_ACK_FAILURE;
+  int fds[2];
+  int num_fds = ha_ctrl_receive_fds(common, &status, fds, 2);
+  if (num_fds < 0) return NULL;
+  if (status != HEARING_AID_CTRL_ACK_SUCCESS || num_fds != 2) {
+    ERROR("audio shm unavailable (status %d, %d fds)", status, num_fds);
+    for (int i = 0; i < num_fds; i++) close(fds[i]);
+    return NULL;
+  }
+
+  return uipc_shm_attach(fds[0], fds[1]);
+}
+
+// Disconnects the audio data path, the audio data is written to the ring
+// again only once the audio path is restarted.
+static void ha_disconnect_audio_path(struct ha_stream_common* common) {
+  skt_disconnect(common->audio_fd);
+  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_shm_active = false;
+}
+
 static int check_ha_ready(struct ha_stream_common* common) {
   if (ha_command(common, HEARING_AID_CTRL_CMD_CHECK_READY) < 0) {
     ERROR("check ha ready failed");
@@ -649,7 +733,7 @@ static int ha_read_output_audio_config(
     common->cfg.format = stream_config.format;
     common->buffer_sz = audio_ha_hw_stream_compute_buffer_size(
         codec_config->sample_rate, codec_config->bits_per_sample,
-        codec_config->channel_mode);
+        codec_config->channel_mode, audio_ha_hw_output_period_ms());
     if (common->cfg.is_stereo_to_mono) {
       // We need to fetch twice as much data from the Audio framework
       common->buffer_sz *= 2;
@@ -807,6 +891,9 @@ static void ha_stream_common_init(struct ha_stream_common* common) {
 
   common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->use_audio_shm = false;
+  common->audio_shm_active = false;
+  common->audio_shm = NULL;
   common->state = AUDIO_HA_STATE_STOPPED;
 
   /* manages max capacity of socket pipe */
@@ -816,6 +903,9 @@ static void ha_stream_common_init(struct ha_stream_common* common) {
 static void ha_stream_common_destroy(struct ha_stream_common* common) {
   FNLOG();
 
+  uipc_shm_free(common->audio_shm);
+  common->audio_shm = NULL;
+
   delete common->mutex;
   common->mutex = NULL;
 }
@@ -843,6 +933,20 @@ static int start_audio_datapath(struct ha_stream_common* common) {
       goto error;
     }
   }
+
+  /* write the audio data to shared memory, unless the stack doesn't support
+   * it: the data socket is then used until the stream is closed */
+  if (common->use_audio_shm && !common->audio_shm_active) {
+    uipc_shm_t* audio_shm = ha_get_audio_shm(common);
+    if (audio_shm != NULL) {
+      uipc_shm_free(common->audio_shm);
+      common->audio_shm = audio_shm;
+      common->audio_shm_active = true;
+    } else {
+      INFO("writing the audio data to the data socket");
+      common->use_audio_shm = false;
+    }
+  }
   common->state = (ha_state_t)AUDIO_HA_STATE_STARTED;
   return 0;
 
@@ -869,8 +973,7 @@ static int stop_audio_datapath(struct ha_stream_common* common) {
   common->state = (ha_state_t)AUDIO_HA_STATE_STOPPED;
 
   /* disconnect audio path */
-  skt_disconnect(common->audio_fd);
-  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  ha_disconnect_audio_path(common);
 
   return 0;
 }
@@ -889,9 +992,7 @@ static int suspend_audio_datapath(struct ha_stream_common* common,
     common->state = AUDIO_HA_STATE_SUSPENDED;
 
   /* disconnect audio path */
-  skt_disconnect(common->audio_fd);
-
-  common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  ha_disconnect_audio_path(common);
 
   return 0;
 }
@@ -941,13 +1042,25 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
           out->common.audio_fd);
   }
 
-  lock.unlock();
-  sent = skt_write(out->common.audio_fd, buffer, write_bytes);
-  lock.lock();
+  if (out->common.audio_shm_active) {
+    uipc_shm_t* audio_shm = out->common.audio_shm;
+    lock.unlock();
+    // The stack stopped reading if the ring stays full for too long
+    size_t written = uipc_shm_write(audio_shm, buffer, write_bytes,
+                                    SOCK_SEND_TIMEOUT_MS);
+    if (written < write_bytes) {
+      WARN("write timeout exceeded, sent %zu bytes", written);
+    }
+    sent = (written == write_bytes) ? (int)written : -1;
+    lock.lock();
+  } else {
+    lock.unlock();
+    sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+    lock.lock();
+  }
 
   if (sent == -1) {
-    skt_disconnect(out->common.audio_fd);
-    out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
+    ha_disconnect_audio_path(&out->common);
     if ((out->common.state != AUDIO_HA_STATE_SUSPENDED) &&
         (out->common.state != AUDIO_HA_STATE_STOPPING)) {
       out->common.state = AUDIO_HA_STATE_STOPPED;
@@ -1005,9 +1118,9 @@ static size_t out_get_buffer_size(const struct audio_stream* stream) {
 size_t audio_ha_hw_stream_compute_buffer_size(
     btav_a2dp_codec_sample_rate_t codec_sample_rate,
     btav_a2dp_codec_bits_per_sample_t codec_bits_per_sample,
-    btav_a2dp_codec_channel_mode_t codec_channel_mode) {
+    btav_a2dp_codec_channel_mode_t codec_channel_mode,
+    uint64_t time_period_ms) {
   size_t buffer_sz = AUDIO_STREAM_OUTPUT_BUFFER_SZ;  // Default value
-  const uint64_t time_period_ms = 20;                // Conservative 20ms
   uint32_t sample_rate;
   uint32_t bits_per_sample;
   uint32_t number_of_channels;
@@ -1582,6 +1695,7 @@ static int adev_open_output_stream(struct audio_hw_device* dev,
 
   /* initialize ha specifics */
   ha_stream_common_init(&out->common);
+  out->common.use_audio_shm = true;
 
   // Make sure we always have the feeding parameters configured
   btav_a2dp_codec_config_t codec_config;
@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #include "audio_hearing_aid_hw/include/audio_hearing_aid_hw.h"
+#include "osi/include/properties.h"
 
 #define CASE_RETURN_STR(const) \
   case const:                  \
@@ -33,9 +34,20 @@ const char* audio_ha_hw_dump_ctrl_event(tHEARING_AID_CTRL_CMD event) {
     CASE_RETURN_STR(HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_CMD_OFFLOAD_START)
+    CASE_RETURN_STR(HEARING_AID_CTRL_GET_AUDIO_SHM)
     default:
       break;
   }
 
   return "UNKNOWN HEARING_AID_CTRL_CMD";
 }
+
+uint64_t audio_ha_hw_output_period_ms() {
+  // Hearing aid users stream for hours, a longer period saves wakeups at the
+  // cost of latency
+  if (osi_property_get_bool("persist.bluetooth.hearing_aid_hw.low_power",
+                            false)) {
+    return AUDIO_STREAM_LOW_POWER_PERIOD_MS;
+  }
+  return AUDIO_STREAM_OUTPUT_PERIOD_MS;
+}
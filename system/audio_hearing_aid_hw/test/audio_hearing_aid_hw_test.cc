@@ -98,48 +98,54 @@ TEST_F(AudioA2dpHwTest, test_compute_buffer_size) {
       BTAV_A2DP_CODEC_CHANNEL_MODE_NONE, BTAV_A2DP_CODEC_CHANNEL_MODE_MONO,
       BTAV_A2DP_CODEC_CHANNEL_MODE_STEREO};
 
-  for (const auto codec_sample_rate : codec_sample_rate_array) {
-    for (const auto codec_bits_per_sample : codec_bits_per_sample_array) {
-      for (const auto codec_channel_mode : codec_channel_mode_array) {
-        size_t buffer_size = audio_ha_hw_stream_compute_buffer_size(
-            codec_sample_rate, codec_bits_per_sample, codec_channel_mode);
-
-        // Check for invalid input
-        if ((codec_sample_rate == BTAV_A2DP_CODEC_SAMPLE_RATE_NONE) ||
-            (codec_bits_per_sample == BTAV_A2DP_CODEC_BITS_PER_SAMPLE_NONE) ||
-            (codec_channel_mode == BTAV_A2DP_CODEC_CHANNEL_MODE_NONE)) {
-          EXPECT_EQ(buffer_size,
-                    static_cast<size_t>(AUDIO_STREAM_OUTPUT_BUFFER_SZ));
-          continue;
+  const uint64_t time_period_ms_array[] = {AUDIO_STREAM_OUTPUT_PERIOD_MS,
+                                           AUDIO_STREAM_LOW_POWER_PERIOD_MS};
+
+  for (const auto time_period_ms : time_period_ms_array) {
+    for (const auto codec_sample_rate : codec_sample_rate_array) {
+      for (const auto codec_bits_per_sample : codec_bits_per_sample_array) {
+        for (const auto codec_channel_mode : codec_channel_mode_array) {
+          size_t buffer_size = audio_ha_hw_stream_compute_buffer_size(
+              codec_sample_rate, codec_bits_per_sample, codec_channel_mode,
+              time_period_ms);
+
+          // Check for invalid input
+          if ((codec_sample_rate == BTAV_A2DP_CODEC_SAMPLE_RATE_NONE) ||
+              (codec_bits_per_sample ==
+               BTAV_A2DP_CODEC_BITS_PER_SAMPLE_NONE) ||
+              (codec_channel_mode == BTAV_A2DP_CODEC_CHANNEL_MODE_NONE)) {
+            EXPECT_EQ(buffer_size,
+                      static_cast<size_t>(AUDIO_STREAM_OUTPUT_BUFFER_SZ));
+            continue;
+          }
+
+          uint32_t sample_rate = codec_sample_rate2value(codec_sample_rate);
+          EXPECT_TRUE(sample_rate != 0);
+
+          uint32_t bits_per_sample =
+              codec_bits_per_sample2value(codec_bits_per_sample);
+          EXPECT_TRUE(bits_per_sample != 0);
+
+          uint32_t number_of_channels =
+              codec_channel_mode2value(codec_channel_mode);
+          EXPECT_TRUE(number_of_channels != 0);
+
+          size_t expected_buffer_size =
+              (time_period_ms * AUDIO_STREAM_OUTPUT_BUFFER_PERIODS *
+               sample_rate * number_of_channels * (bits_per_sample / 8)) /
+              1000;
+
+          // Compute the divisor and adjust the buffer size
+          const size_t divisor = (AUDIO_STREAM_OUTPUT_BUFFER_PERIODS * 16 *
+                                  number_of_channels * bits_per_sample) /
+                                 8;
+          const size_t remainder = expected_buffer_size % divisor;
+          if (remainder != 0) {
+            expected_buffer_size += divisor - remainder;
+          }
+
+          EXPECT_EQ(buffer_size, expected_buffer_size);
         }
-
-        uint32_t sample_rate = codec_sample_rate2value(codec_sample_rate);
-        EXPECT_TRUE(sample_rate != 0);
-
-        uint32_t bits_per_sample =
-            codec_bits_per_sample2value(codec_bits_per_sample);
-        EXPECT_TRUE(bits_per_sample != 0);
-
-        uint32_t number_of_channels =
-            codec_channel_mode2value(codec_channel_mode);
-        EXPECT_TRUE(number_of_channels != 0);
-
-        const uint64_t time_period_ms = 20;  // TODO: Must be a parameter
-        size_t expected_buffer_size =
-            (time_period_ms * AUDIO_STREAM_OUTPUT_BUFFER_PERIODS * sample_rate *
-             number_of_channels * (bits_per_sample / 8)) /
-            1000;
-
-        // Compute the divisor and adjust the buffer size
-        const size_t divisor = (AUDIO_STREAM_OUTPUT_BUFFER_PERIODS * 16 *
-                                number_of_channels * bits_per_sample) /
-                               8;
-        const size_t remainder = expected_buffer_size % divisor;
-        if (remainder != 0) {
-          expected_buffer_size += divisor - remainder;
-        }
-
-        EXPECT_EQ(buffer_size, expected_buffer_size);
       }
     }
   }
@@ -60,6 +60,9 @@ class GdBaseTestClass(base_test.BaseTestClass):
 
     FUNCTION_CALL_TIMEOUT_SECONDS = 5
     SUBPROCESS_WAIT_TIMEOUT_SECONDS = 10
+    # Run root-canal in virtual time, fast-forwarding once the devices are idle for this many milliseconds. Can be
+    # overridden by the virtual_time_idle_ms value of the rootcanal config, 0 disables it.
+    ROOTCANAL_VIRTUAL_TIME_IDLE_MS = 0
 
     def setup_class(self, dut_module, cert_module):
         self.dut_module = dut_module
@@ -168,6 +171,8 @@ class GdBaseTestClass(base_test.BaseTestClass):
             rootcanal_test_port = int(rootcanal_config.get("test_port", "6401"))
             rootcanal_hci_port = int(rootcanal_config.get("hci_port", "6402"))
             rootcanal_link_layer_port = int(rootcanal_config.get("link_layer_port", "6403"))
+            rootcanal_virtual_time_idle_ms = int(
+                rootcanal_config.get("virtual_time_idle_ms", self.ROOTCANAL_VIRTUAL_TIME_IDLE_MS))
             asserts.assert_true(
                 make_ports_available((rootcanal_test_port, rootcanal_hci_port, rootcanal_link_layer_port)),
                 "Failed to free ports rootcanal_test_port={}, rootcanal_hci_port={}, rootcanal_link_layer_port={}".
@@ -180,6 +185,8 @@ class GdBaseTestClass(base_test.BaseTestClass):
                 str(rootcanal_hci_port), '-link_port',
                 str(rootcanal_link_layer_port), '-controller_properties_file=' + controller_properties_file
             ]
+            if rootcanal_virtual_time_idle_ms > 0:
+                rootcanal_cmd.append('-virtual_time_idle_ms=%d' % rootcanal_virtual_time_idle_ms)
             self.log.debug("Running %s" % " ".join(rootcanal_cmd))
             self.rootcanal_process = subprocess.Popen(rootcanal_cmd,
                                                       cwd=get_gd_root(),
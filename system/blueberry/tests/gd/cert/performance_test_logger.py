@@ -14,7 +14,8 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
-from datetime import datetime
+import json
+from datetime import datetime, timedelta
 
 
 class PerformanceTestLogger(object):
@@ -69,3 +70,27 @@ class PerformanceTestLogger(object):
             self._check_interval_label(label)
             yield ((label, self.start_interval_points[label][i], self.end_interval_points[label][i])
                    for i in range(len(self.start_interval_points[label])))
+
+    def get_summary_of_intervals(self, label):
+        """
+        Return the number of intervals with specified label and their total, mean, min and max durations in ms.
+        """
+        durations = [duration / timedelta(milliseconds=1) for duration in self.get_duration_of_intervals(label)]
+        return {
+            "count": len(durations),
+            "total_ms": sum(durations),
+            "mean_ms": sum(durations) / len(durations) if durations else 0,
+            "min_ms": min(durations, default=0),
+            "max_ms": max(durations, default=0),
+        }
+
+    def dump_json(self, path, metrics=None):
+        """
+        Write the summary of the intervals of all labels, and the given metrics, to path as JSON
+        """
+        results = {
+            "intervals": {label: self.get_summary_of_intervals(label) for label in self.start_interval_points},
+            "metrics": metrics or {},
+        }
+        with open(path, "w") as json_file:
+            json.dump(results, json_file, indent=2, sort_keys=True)
@@ -27,13 +27,18 @@ from blueberry.tests.gd.l2cap.classic.l2cap_test import L2capTest
 # TODO(b/194723246): Investigate failures to re-activate the test class.
 from blueberry.tests.gd.l2cap.le.le_l2cap_test import LeL2capTest
 
+# Shares the setup of LeL2capTest, disabled with it.
+from blueberry.tests.gd.l2cap.le.le_l2cap_performance_test import LeL2capPerformanceTest
+
 # TODO(b/194723246): Investigate failures to re-activate the test class.
 from blueberry.tests.gd.security.le_security_test import LeSecurityTest
 
 # TODO(b/194723246): Investigate failures to re-activate the test class.
 from blueberry.tests.gd.security.security_test import SecurityTest
 
-DISABLED_TESTS = {LeScanningManagerTest, L2capTest, LeL2capTest, LeSecurityTest, SecurityTest}
+DISABLED_TESTS = {
+    LeScanningManagerTest, L2capTest, LeL2capTest, LeL2capPerformanceTest, LeSecurityTest, SecurityTest
+}
 
 PRESUBMIT_TESTS = list(ALL_TESTS - DISABLED_TESTS)
 
@@ -13,6 +13,7 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import os
 from datetime import datetime, timedelta
 
 from blueberry.tests.gd.cert.matchers import L2capMatchers
@@ -30,6 +31,8 @@ from mobly import test_runner
 
 
 class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
+    # Long scenarios are fast-forwarded while the stacks are idle
+    ROOTCANAL_VIRTUAL_TIME_IDLE_MS = 50
 
     def setup_class(self):
         gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
@@ -38,8 +41,11 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         gd_base_test.GdBaseTestClass.setup_test(self)
         L2capTestBase.setup_test(self, self.dut, self.cert)
         self.performance_test_logger = PerformanceTestLogger()
+        self.metrics = {}
 
     def teardown_test(self):
+        self.performance_test_logger.dump_json(
+            os.path.join(self.log_path_base, "%s_performance.json" % self.current_test_info.name), self.metrics)
         L2capTestBase.teardown_test(self)
         gd_base_test.GdBaseTestClass.teardown_test(self)
 
@@ -59,6 +65,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
 
         duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
         self.log.info("Duration: %s" % str(duration))
+        self.metrics["tx_bytes_per_second"] = mtu * packets / duration.total_seconds()
 
         return duration
 
@@ -78,6 +85,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
                 dut_channel.send(b'a' * mtu)
             packets_sent += batch_size
             assertThat(cert_channel).emits(L2capMatchers.Data(b'a' * mtu), at_least_times=batch_size)
+        self.metrics["tx_bytes_per_second"] = mtu * packets_sent / (datetime.now() - start_time).total_seconds()
 
         return packets_sent
 
@@ -96,6 +104,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
 
         duration = self.performance_test_logger.get_duration_of_intervals("RX")[0]
         self.log.info("Duration: %s" % str(duration))
+        self.metrics["rx_bytes_per_second"] = mtu * packets / duration.total_seconds()
 
     def _ertm_mode_tx(self, mtu, packets, tx_window_size=10):
         """
@@ -125,6 +134,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
 
         duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
         self.log.info("Duration: %s" % str(duration))
+        self.metrics["tx_bytes_per_second"] = mtu * packets / duration.total_seconds()
 
         return duration
 
@@ -153,6 +163,7 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
 
         duration = self.performance_test_logger.get_duration_of_intervals("RX")[0]
         self.log.info("Duration: %s" % str(duration))
+        self.metrics["rx_bytes_per_second"] = mtu * packets / duration.total_seconds()
 
     def test_basic_mode_tx_672_100(self):
         duration = self._basic_mode_tx(672, 100)
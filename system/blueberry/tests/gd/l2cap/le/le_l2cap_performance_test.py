@@ -0,0 +1,100 @@
+#
+#   Copyright 2023 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+import os
+from datetime import timedelta
+
+from blueberry.tests.gd.cert.matchers import L2capMatchers
+from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
+from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.l2cap.le.le_l2cap_test import LeL2capTest
+from bluetooth_packets_python3 import RawBuilder
+
+from mobly import test_runner
+
+
+class LeL2capPerformanceTest(gd_base_test.GdBaseTestClass):
+    """
+    Transfer rate and latency of LE credit based channels between the DUT and CERT stacks over rootcanal, exported as
+    JSON next to the test logs so that host changes can be compared without RF variability.
+    """
+
+    # Long scenarios are fast-forwarded while the stacks are idle
+    ROOTCANAL_VIRTUAL_TIME_IDLE_MS = 50
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        LeL2capTest.setup_test(self)
+        self.performance_test_logger = PerformanceTestLogger()
+        self.metrics = {}
+
+    def teardown_test(self):
+        self.performance_test_logger.dump_json(
+            os.path.join(self.log_path_base, "%s_performance.json" % self.current_test_info.name), self.metrics)
+        LeL2capTest.teardown_test(self)
+
+    def _coc_tx(self, sdu_size, packets):
+        """
+        Send the specified number of SDUs of one PDU each and return the time interval.
+        """
+        LeL2capTest._setup_link_from_cert(self)
+        # The SDU size takes 2 bytes of the first PDU
+        (dut_channel, cert_channel) = LeL2capTest._open_channel_from_cert(
+            self, mtu=sdu_size, mps=sdu_size + 2, initial_credit=packets)
+
+        self.performance_test_logger.start_interval("TX")
+        for _ in range(packets):
+            dut_channel.send(b'a' * sdu_size)
+        assertThat(cert_channel).emits(
+            L2capMatchers.FirstLeIFrame(b'a' * sdu_size, sdu_size=sdu_size),
+            at_least_times=packets,
+            timeout=timedelta(seconds=60))
+        self.performance_test_logger.end_interval("TX")
+
+        duration = self.performance_test_logger.get_duration_of_intervals("TX")[0]
+        self.log.info("Duration: %s" % str(duration))
+        self.metrics["tx_bytes_per_second"] = sdu_size * packets / duration.total_seconds()
+        return duration
+
+    def test_coc_tx_247_100(self):
+        duration = self._coc_tx(247, 100)
+        assertThat(duration).isWithin(timedelta(seconds=5))
+
+    def test_coc_tx_23_100(self):
+        duration = self._coc_tx(23, 100)
+        assertThat(duration).isWithin(timedelta(seconds=5))
+
+    def test_coc_end_to_end_latency(self):
+        LeL2capTest._setup_link_from_cert(self)
+        (dut_channel, cert_channel) = LeL2capTest._open_channel_from_cert(self)
+
+        data = b"a" * 90
+        data_packet = RawBuilder([x for x in data])
+        # Stay within the credits the DUT granted when opening the channel
+        for _ in range(min(cert_channel.credits_left(), 20)):
+            self.performance_test_logger.start_interval("RX")
+            cert_channel.send_first_le_i_frame(len(data), data_packet)
+            assertThat(dut_channel).emits(L2capMatchers.PacketPayloadRawData(data))
+            self.performance_test_logger.end_interval("RX")
+        summary = self.performance_test_logger.get_summary_of_intervals("RX")
+        self.log.info("Mean: %f ms" % summary["mean_ms"])
+        self.metrics["rx_latency_mean_ms"] = summary["mean_ms"]
+
+
+if __name__ == '__main__':
+    test_runner.main()
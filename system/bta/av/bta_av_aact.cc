@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <map>
 #include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -203,6 +204,149 @@ static uint8_t bta_av_get_scb_sep_type(tBTA_AV_SCB* p_scb,
   return AVDT_TSEP_INVALID;
 }
 
+/* Capabilities of a peer SEP, as returned by AVDTP Get (All) Capabilities */
+typedef struct {
+  uint8_t seid;
+  uint8_t tsep;
+  uint8_t media_type;
+  AvdtpSepConfig caps;
+} tBTA_AV_CACHED_SEP;
+
+typedef struct {
+  uint16_t avdtp_version; /* the capabilities depend on Get vs Get All */
+  uint64_t last_used;
+  std::vector<tBTA_AV_CACHED_SEP> seps;
+} tBTA_AV_CAPS_CACHE_ENTRY;
+
+/* Only accessed from the BTA thread */
+static std::map<RawAddress, tBTA_AV_CAPS_CACHE_ENTRY> bta_av_caps_cache;
+static uint64_t bta_av_caps_cache_clock = 0;
+
+static bool bta_av_caps_cache_sep_matches(const tBTA_AV_CACHED_SEP& cached,
+                                          const tAVDT_SEP_INFO& sep_info) {
+  return cached.seid == sep_info.seid && cached.tsep == sep_info.tsep &&
+         cached.media_type == sep_info.media_type;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_store
+ *
+ * Description      Save the capabilities of a peer SEP, evicting the least
+ *                  recently used peer when the cache is full.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_store(const RawAddress& peer_address,
+                             uint16_t avdtp_version,
+                             const tAVDT_SEP_INFO& sep_info,
+                             const AvdtpSepConfig& caps) {
+  auto it = bta_av_caps_cache.find(peer_address);
+  if (it == bta_av_caps_cache.end()) {
+    if (bta_av_caps_cache.size() >= BTA_AV_CAPS_CACHE_MAX_PEERS) {
+      auto oldest = bta_av_caps_cache.begin();
+      for (auto entry = bta_av_caps_cache.begin();
+           entry != bta_av_caps_cache.end(); entry++) {
+        if (entry->second.last_used < oldest->second.last_used) oldest = entry;
+      }
+      bta_av_caps_cache.erase(oldest);
+    }
+    it = bta_av_caps_cache.emplace(peer_address, tBTA_AV_CAPS_CACHE_ENTRY{})
+             .first;
+    it->second.avdtp_version = avdtp_version;
+  } else if (it->second.avdtp_version != avdtp_version) {
+    it->second.avdtp_version = avdtp_version;
+    it->second.seps.clear();
+  }
+  it->second.last_used = ++bta_av_caps_cache_clock;
+
+  for (auto& cached : it->second.seps) {
+    if (bta_av_caps_cache_sep_matches(cached, sep_info)) {
+      cached.caps = caps;
+      return;
+    }
+  }
+  it->second.seps.push_back({
+      .seid = sep_info.seid,
+      .tsep = sep_info.tsep,
+      .media_type = sep_info.media_type,
+      .caps = caps,
+  });
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_lookup
+ *
+ * Description      Get the cached capabilities of a peer SEP.
+ *
+ * Returns          true if the capabilities were found, false otherwise.
+ *
+ ******************************************************************************/
+bool bta_av_caps_cache_lookup(const RawAddress& peer_address,
+                              uint16_t avdtp_version,
+                              const tAVDT_SEP_INFO& sep_info,
+                              AvdtpSepConfig* p_caps) {
+  auto it = bta_av_caps_cache.find(peer_address);
+  if (it == bta_av_caps_cache.end() ||
+      it->second.avdtp_version != avdtp_version) {
+    return false;
+  }
+  for (const auto& cached : it->second.seps) {
+    if (bta_av_caps_cache_sep_matches(cached, sep_info)) {
+      it->second.last_used = ++bta_av_caps_cache_clock;
+      *p_caps = cached.caps;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_check_seps
+ *
+ * Description      Drop the cached capabilities of the peer if a cached SEP
+ *                  is no longer in the discovery results, the peer was
+ *                  updated or replaced since they were saved.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_check_seps(const RawAddress& peer_address,
+                                  const tAVDT_SEP_INFO* p_sep_info,
+                                  uint8_t num_seps) {
+  auto it = bta_av_caps_cache.find(peer_address);
+  if (it == bta_av_caps_cache.end()) return;
+
+  for (const auto& cached : it->second.seps) {
+    bool found = false;
+    for (uint8_t i = 0; i < num_seps && !found; i++) {
+      found = bta_av_caps_cache_sep_matches(cached, p_sep_info[i]);
+    }
+    if (!found) {
+      LOG_INFO("%s: peer %s SEP seid=%d is gone, dropping cached capabilities",
+               __func__, ADDRESS_TO_LOGGABLE_CSTR(peer_address), cached.seid);
+      bta_av_caps_cache.erase(it);
+      return;
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_caps_cache_remove
+ *
+ * Description      Forget the cached capabilities of a peer.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_caps_cache_remove(const RawAddress& peer_address) {
+  bta_av_caps_cache.erase(peer_address);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_save_addr
@@ -294,9 +438,11 @@ void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
  * Function         bta_av_next_getcap
  *
  * Description      The function gets the capabilities of the next available
- *                  stream found in the discovery results.
+ *                  stream found in the discovery results, from the cache of
+ *                  the peer capabilities if they were already retrieved.
  *
- * Returns          true if we sent request to AVDT, false otherwise.
+ * Returns          true if we sent request to AVDT or reported the cached
+ *                  capabilities, false otherwise.
  *
  ******************************************************************************/
 static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
@@ -317,6 +463,20 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
         (p_scb->sep_info[i].media_type == p_scb->media_type)) {
       p_scb->sep_info_idx = i;
 
+      /* the capabilities are known from a previous connection: report them
+       * as the peer would, without a round trip */
+      if (bta_av_caps_cache_lookup(p_scb->PeerAddress(), p_scb->AvdtpVersion(),
+                                   p_scb->sep_info[i], &p_scb->peer_cap)) {
+        LOG_INFO("%s: peer %s seid=%d capabilities from cache", __func__,
+                 ADDRESS_TO_LOGGABLE_CSTR(p_scb->PeerAddress()),
+                 p_scb->sep_info[i].seid);
+        tAVDT_CTRL avdt_ctrl = {};
+        bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_GETCAP_CFM_EVT,
+                               &avdt_ctrl, p_scb->hdi);
+        sent_cmd = true;
+        break;
+      }
+
       /* we got a stream; get its capabilities */
       bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
                          (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
@@ -1445,6 +1605,8 @@ void bta_av_disc_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_caps_cache_check_seps(p_scb->PeerAddress(), p_scb->sep_info,
+                               p_scb->num_seps);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam not in use, is a sink, and is audio */
@@ -1500,6 +1662,8 @@ void bta_av_disc_res_as_acp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_caps_cache_check_seps(p_scb->PeerAddress(), p_scb->sep_info,
+                               p_scb->num_seps);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam is a sink, and is audio */
@@ -1552,6 +1716,9 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_DEBUG("%s: codec: %s", __func__,
                    A2DP_CodecInfoString(p_scb->peer_cap.codec_info).c_str());
 
+  bta_av_caps_cache_store(p_scb->PeerAddress(), p_scb->AvdtpVersion(), *p_info,
+                          p_scb->peer_cap);
+
   cfg = p_scb->peer_cap;
   /* let application know the capability of the SNK */
   if (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1637,6 +1804,10 @@ void bta_av_open_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   p_scb->open_status = BTA_AV_FAIL_STREAM;
   bta_av_cco_close(p_scb, p_data);
 
+  /* the cached capabilities may be why the peer rejected the configuration,
+   * get them again on the next attempt */
+  bta_av_caps_cache_remove(p_scb->PeerAddress());
+
   /* check whether there is already an opened audio or video connection with the
    * same device */
   for (idx = 0; (idx < BTA_AV_NUM_STRS) && (!is_av_opened); idx++) {
@@ -1697,6 +1868,9 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   uint8_t media_type = A2DP_GetMediaType(p_scb->peer_cap.codec_info);
   tAVDT_SEP_INFO* p_info = &p_scb->sep_info[p_scb->sep_info_idx];
 
+  bta_av_caps_cache_store(p_scb->PeerAddress(), p_scb->AvdtpVersion(), *p_info,
+                          p_scb->peer_cap);
+
   cfg.num_codec = 1;
   cfg.num_protect = p_scb->peer_cap.num_protect;
   memcpy(cfg.codec_info, p_scb->peer_cap.codec_info, AVDT_CODEC_SIZE);
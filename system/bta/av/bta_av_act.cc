@@ -592,6 +592,28 @@ void bta_av_rc_opened(tBTA_AV_CB* p_cb, tBTA_AV_DATA* p_data) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_rc_expect_burst
+ *
+ * Description      Tell the power manager that the stream of the peer of the
+ *                  AVRCP connection is about to start when PLAY is pressed,
+ *                  ahead of the AVDTP start.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_rc_expect_burst(tBTA_AV_CB* p_cb, uint8_t rc_handle,
+                                   const tAVRC_MSG_PASS& pass) {
+  if (pass.op_id != AVRC_ID_PLAY || pass.state != AVRC_STATE_PRESS) return;
+  if (rc_handle >= BTA_AV_NUM_RCB) return;
+  uint8_t lidx = p_cb->rcb[rc_handle].lidx;
+  if (lidx == 0 || lidx > BTA_AV_NUM_LINKS + 1) return;
+  const RawAddress& peer_addr = p_cb->lcb[lidx - 1].addr;
+  if (peer_addr.IsEmpty()) return;
+  bta_sys_expect_burst(BTA_ID_AV, peer_addr);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_rc_remote_cmd
@@ -607,6 +629,8 @@ void bta_av_rc_remote_cmd(tBTA_AV_CB* p_cb, tBTA_AV_DATA* p_data) {
     if (p_data->hdr.layer_specific < BTA_AV_NUM_RCB) {
       p_rcb = &p_cb->rcb[p_data->hdr.layer_specific];
       if (p_rcb->status & BTA_AV_RC_CONN_MASK) {
+        bta_av_rc_expect_burst(p_cb, p_data->hdr.layer_specific,
+                               p_data->api_remote_cmd.msg);
         AVRC_PassCmd(p_rcb->handle, p_data->api_remote_cmd.label,
                      &p_data->api_remote_cmd.msg);
       }
@@ -908,6 +932,8 @@ void bta_av_rc_msg(tBTA_AV_CB* p_cb, tBTA_AV_DATA* p_data) {
       /* set up for callback if supported */
       if (p_data->rc_msg.msg.hdr.ctype == AVRC_RSP_ACCEPT ||
           p_data->rc_msg.msg.hdr.ctype == AVRC_RSP_INTERIM) {
+        bta_av_rc_expect_burst(p_cb, p_data->rc_msg.handle,
+                               p_data->rc_msg.msg.pass);
         evt = BTA_AV_REMOTE_CMD_EVT;
         av.remote_cmd.rc_id = p_data->rc_msg.msg.pass.op_id;
         av.remote_cmd.key_state = p_data->rc_msg.msg.pass.state;
@@ -26,12 +26,16 @@
 
 #define LOG_TAG "bt_bta_av"
 
+#include <base/functional/bind.h>
+#include <base/location.h>
+
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/av/bta_av_int.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/btu.h"  // do_in_main_thread
 #include "types/raw_address.h"
 
 /*****************************************************************************
@@ -640,3 +644,18 @@ void BTA_AvSetLatency(tBTA_AV_HNDL handle, bool is_low_latency) {
 
   bta_sys_sendmsg(p_buf);
 }
+
+/*******************************************************************************
+ *
+ * Function         BTA_AvRemoveDevice
+ *
+ * Description      Forget the stream endpoint capabilities saved for a peer,
+ *                  called when the peer is unpaired.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTA_AvRemoveDevice(const RawAddress& bd_addr) {
+  do_in_main_thread(FROM_HERE,
+                    base::BindOnce(&bta_av_caps_cache_remove, bd_addr));
+}
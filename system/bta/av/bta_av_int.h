@@ -768,6 +768,26 @@ void bta_av_proc_stream_evt(uint8_t handle, const RawAddress& bd_addr,
                             uint8_t event, tAVDT_CTRL* p_data,
                             uint8_t scb_index);
 
+/* number of peers whose SEP capabilities are kept across connections */
+#ifndef BTA_AV_CAPS_CACHE_MAX_PEERS
+#define BTA_AV_CAPS_CACHE_MAX_PEERS 8
+#endif
+
+/* peer SEP capabilities cache, so that reconnects skip AVDTP Get (All)
+ * Capabilities. The entries are keyed by peer address and AVDTP version. */
+void bta_av_caps_cache_store(const RawAddress& peer_address,
+                             uint16_t avdtp_version,
+                             const tAVDT_SEP_INFO& sep_info,
+                             const AvdtpSepConfig& caps);
+bool bta_av_caps_cache_lookup(const RawAddress& peer_address,
+                              uint16_t avdtp_version,
+                              const tAVDT_SEP_INFO& sep_info,
+                              AvdtpSepConfig* p_caps);
+void bta_av_caps_cache_check_seps(const RawAddress& peer_address,
+                                  const tAVDT_SEP_INFO* p_sep_info,
+                                  uint8_t num_seps);
+void bta_av_caps_cache_remove(const RawAddress& peer_address);
+
 /* ssm action functions */
 void bta_av_do_disc_a2dp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_cleanup(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
@@ -35,6 +35,7 @@
 #include "bta_groups.h"
 #include "btif_storage.h"
 #include "csis_types.h"
+#include "gd/common/lru_cache.h"
 #include "gap_api.h"
 #include "gatt_api.h"
 #include "main/shim/le_scanning_manager.h"
@@ -71,6 +72,9 @@ CsisClientImpl* instance;
 std::mutex instance_mutex;
 DeviceGroupsCallbacks* device_group_callbacks;
 
+/* RSIs seen in advertising, with the groups they resolve to */
+constexpr size_t kResolvedRsiCacheSize = 64;
+
 /**
  * -----------------------------------------------------------------------------
  * Coordinated Set Service - Client role
@@ -1229,6 +1233,76 @@ class CsisClientImpl : public CsisClient {
     return std::move(devices);
   }
 
+  /* Returns true if |rsi| resolves with the SIRK of the group |group_id| */
+  bool IsRsiMatchingGroup(const RawAddress& rsi, int group_id) {
+    std::vector<int> group_ids = ResolveRsi(rsi);
+    return std::find(group_ids.begin(), group_ids.end(), group_id) !=
+           group_ids.end();
+  }
+
+  /* Returns the ids of the groups whose SIRK resolves |rsi|. The RSI is
+   * matched against all the SIRKs in one pass, and the result is cached as
+   * set members keep advertising the same RSI. */
+  std::vector<int> ResolveRsi(const RawAddress& rsi) {
+    UpdateRsiSirks();
+
+    auto it = resolved_rsi_.find(rsi);
+    if (it != resolved_rsi_.end()) return it->second;
+
+    std::vector<int> group_ids;
+    if (!rsi_schedules_.empty()) {
+      /* use the 3 MSB of bd address as prand */
+      Octet16 prand{rsi.address[2], rsi.address[1], rsi.address[0]};
+      rsi_hashes_.resize(rsi_schedules_.size());
+      crypto_toolbox::aes_128_multi_key(rsi_schedules_.data(),
+                                        rsi_schedules_.size(), prand,
+                                        rsi_hashes_.data());
+
+      /* the hash is the 3 LSB of bd address */
+      for (size_t i = 0; i < rsi_hashes_.size(); i++) {
+        if (rsi_hashes_[i][0] == rsi.address[5] &&
+            rsi_hashes_[i][1] == rsi.address[4] &&
+            rsi_hashes_[i][2] == rsi.address[3])
+          group_ids.push_back(rsi_group_ids_[i]);
+      }
+    }
+
+    resolved_rsi_.insert_or_assign(rsi, group_ids);
+    return group_ids;
+  }
+
+  /* Expands the SIRKs of the groups which changed since the last call, the
+   * cached RSIs were resolved with the previous ones */
+  void UpdateRsiSirks(void) {
+    bool sirks_changed = false;
+    if (rsi_group_ids_.size() != csis_groups_.size()) {
+      rsi_group_ids_.clear();
+      rsi_sirks_.clear();
+      rsi_schedules_.clear();
+      sirks_changed = true;
+    }
+
+    size_t index = 0;
+    for (const auto& group : csis_groups_) {
+      const Octet16 sirk = group->GetSirk();
+      if (index == rsi_group_ids_.size()) {
+        rsi_group_ids_.push_back(group->GetGroupId());
+        rsi_sirks_.push_back(sirk);
+        rsi_schedules_.push_back(crypto_toolbox::aes_128_key_schedule(sirk));
+        sirks_changed = true;
+      } else if (rsi_group_ids_[index] != group->GetGroupId() ||
+                 rsi_sirks_[index] != sirk) {
+        rsi_group_ids_[index] = group->GetGroupId();
+        rsi_sirks_[index] = sirk;
+        rsi_schedules_[index] = crypto_toolbox::aes_128_key_schedule(sirk);
+        sirks_changed = true;
+      }
+      index++;
+    }
+
+    if (sirks_changed) resolved_rsi_.clear();
+  }
+
   void OnActiveScanResult(const tBTA_DM_INQ_RES* result) {
     auto csis_device = FindDeviceByAddress(result->bd_addr);
     if (csis_device) {
@@ -1255,8 +1329,8 @@ class CsisClientImpl : public CsisClient {
     }
 
     auto discovered_group_rsi = std::find_if(
-        all_rsi.cbegin(), all_rsi.cend(), [&csis_group](const auto& rsi) {
-          return csis_group->IsRsiMatching(rsi);
+        all_rsi.cbegin(), all_rsi.cend(), [&](const auto& rsi) {
+          return IsRsiMatchingGroup(rsi, csis_group->GetGroupId());
         });
     if (discovered_group_rsi != all_rsi.cend()) {
       DLOG(INFO) << "Found set member "
@@ -1319,7 +1393,7 @@ class CsisClientImpl : public CsisClient {
     for (tBTM_INQ_INFO* inq_ent = BTM_InqDbFirst(); inq_ent != nullptr;
          inq_ent = BTM_InqDbNext(inq_ent)) {
       RawAddress rsi = inq_ent->results.ble_ad_rsi;
-      if (!csis_group->IsRsiMatching(rsi)) continue;
+      if (!IsRsiMatchingGroup(rsi, csis_group->GetGroupId())) continue;
 
       RawAddress address = inq_ent->results.remote_bd_addr;
       auto device = FindDeviceByAddress(address);
@@ -1370,7 +1444,7 @@ class CsisClientImpl : public CsisClient {
     /* Notify all the groups this device belongs to. */
     for (auto& group : csis_groups_) {
       for (auto& rsi : all_rsi) {
-        if (group->IsRsiMatching(rsi)) {
+        if (IsRsiMatchingGroup(rsi, group->GetGroupId())) {
           LOG_INFO("Device %s match to group id %d",
                    ADDRESS_TO_LOGGABLE_CSTR(result->bd_addr),
                    group->GetGroupId());
@@ -2060,6 +2134,14 @@ class CsisClientImpl : public CsisClient {
   std::list<std::shared_ptr<CsisGroup>> csis_groups_;
   DeviceGroups* dev_groups_;
   int discovering_group_ = bluetooth::groups::kGroupUnknown;
+
+  /* The SIRKs of |csis_groups_|, in the same order */
+  std::vector<int> rsi_group_ids_;
+  std::vector<Octet16> rsi_sirks_;
+  std::vector<crypto_toolbox::Aes128KeySchedule> rsi_schedules_;
+  std::vector<Octet16> rsi_hashes_;
+  bluetooth::common::LruCache<RawAddress, std::vector<int>> resolved_rsi_{
+      kResolvedRsiCacheSize};
 };
 
 class DeviceGroupsCallbacksImpl : public DeviceGroupsCallbacks {
@@ -131,6 +131,7 @@ static void bta_dm_bond_cancel_complete_cback(tBTM_STATUS result);
 static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
                                            tBT_TRANSPORT transport);
 static void bta_dm_discover_device(const RawAddress& remote_bd_addr);
+static void bta_dm_disc_result_cmpl(tBTA_DM_SEARCH* p_result);
 
 static void bta_dm_disable_search_and_disc(void);
 
@@ -314,6 +315,7 @@ void bta_dm_init_cb(void) {
       bta_dm_cb.pm_timer[i].timer[j] = alarm_new("bta_dm.pm_timer");
     }
   }
+  bta_dm_cb.pm_traffic_timer = alarm_new_periodic("bta_dm.pm_traffic_timer");
 }
 
 /*******************************************************************************
@@ -338,6 +340,7 @@ void bta_dm_deinit_cb(void) {
       alarm_free(bta_dm_cb.pm_timer[i].timer[j]);
     }
   }
+  alarm_free(bta_dm_cb.pm_traffic_timer);
   bta_dm_cb = {};
 }
 
@@ -865,6 +868,7 @@ void bta_dm_search_start(tBTA_DM_MSG* p_data) {
   /* save search params */
   bta_dm_search_cb.p_search_cback = p_data->search.p_cback;
   bta_dm_search_cb.services = p_data->search.services;
+  bta_dm_search_cb.name_in_parallel = false;
 
   const tBTM_STATUS btm_status =
       BTM_StartInquiry(bta_dm_inq_results_cb, bta_dm_inq_cmpl_cb);
@@ -933,6 +937,12 @@ void bta_dm_discover(tBTA_DM_MSG* p_data) {
   bta_dm_search_cb.transport = p_data->discover.transport;
 
   bta_dm_search_cb.name_discover_done = false;
+  bta_dm_search_cb.name_in_parallel = false;
+  if (bta_dm_search_cb.disc_result_pending) {
+    osi_free_and_reset(
+        (void**)&bta_dm_search_cb.pending_disc_result.disc_res.p_uuid_list);
+    bta_dm_search_cb.disc_result_pending = false;
+  }
 
   LOG_INFO("bta_dm_discovery: starting service discovery to %s , transport: %s",
            ADDRESS_TO_LOGGABLE_CSTR(p_data->discover.bd_addr),
@@ -1103,6 +1113,19 @@ void bta_dm_disc_rmt_name(tBTA_DM_MSG* p_data) {
     }
   }
 
+  if (bta_dm_search_cb.name_in_parallel) {
+    /* the SDP search was started along the name request, and reports the
+     * name with its result */
+    bta_dm_search_cb.name_in_parallel = false;
+    if (bta_dm_search_cb.disc_result_pending) {
+      bta_dm_search_cb.disc_result_pending = false;
+      strlcpy((char*)bta_dm_search_cb.pending_disc_result.disc_res.bd_name,
+              bta_dm_get_remname(), BD_NAME_LEN + 1);
+      bta_dm_disc_result_cmpl(&bta_dm_search_cb.pending_disc_result);
+    }
+    return;
+  }
+
   bta_dm_discover_device(p_data->rem_name.result.disc_res.bd_addr);
 }
 
@@ -1320,7 +1343,10 @@ void bta_dm_sdp_result(tBTA_DM_MSG* p_data) {
       /* callbacks */
       /* start next bd_addr if necessary */
 
-      BTM_SecDeleteRmtNameNotifyCallback(&bta_dm_service_search_remname_cback);
+      if (!bta_dm_search_cb.name_in_parallel) {
+        BTM_SecDeleteRmtNameNotifyCallback(
+            &bta_dm_service_search_remname_cback);
+      }
 
       BTM_LogHistory(
           kBtmLogTag, bta_dm_search_cb.peer_bdaddr, "Discovery completed",
@@ -1390,7 +1416,9 @@ void bta_dm_sdp_result(tBTA_DM_MSG* p_data) {
     if (bta_dm_search_cb.p_sdp_db)
       osi_free_and_reset((void**)&bta_dm_search_cb.p_sdp_db);
 
-    BTM_SecDeleteRmtNameNotifyCallback(&bta_dm_service_search_remname_cback);
+    if (!bta_dm_search_cb.name_in_parallel) {
+      BTM_SecDeleteRmtNameNotifyCallback(&bta_dm_service_search_remname_cback);
+    }
 
     p_msg = (tBTA_DM_MSG*)osi_calloc(sizeof(tBTA_DM_MSG));
     p_msg->hdr.event = BTA_DM_DISCOVERY_RESULT_EVT;
@@ -1514,17 +1542,38 @@ void bta_dm_search_cmpl() {
 void bta_dm_disc_result(tBTA_DM_MSG* p_data) {
   APPL_TRACE_EVENT("%s", __func__);
 
+  if (bta_dm_search_cb.name_in_parallel) {
+    LOG_INFO("Service discovery done, waiting for the remote name of %s",
+             ADDRESS_TO_LOGGABLE_CSTR(bta_dm_search_cb.peer_bdaddr));
+    bta_dm_search_cb.pending_disc_result = p_data->disc_result.result;
+    bta_dm_search_cb.disc_result_pending = true;
+    return;
+  }
+
+  bta_dm_disc_result_cmpl(&p_data->disc_result.result);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_disc_result_cmpl
+ *
+ * Description      Reports the service discovery result and completes the
+ *                  discovery
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_disc_result_cmpl(tBTA_DM_SEARCH* p_result) {
   /* disc_res.device_type is set only when GATT discovery is finished in
    * bta_dm_gatt_disc_complete */
-  bool is_gatt_over_ble = ((p_data->disc_result.result.disc_res.device_type &
-                            BT_DEVICE_TYPE_BLE) != 0);
+  bool is_gatt_over_ble =
+      ((p_result->disc_res.device_type & BT_DEVICE_TYPE_BLE) != 0);
 
   /* if any BR/EDR service discovery has been done, report the event */
   if (!is_gatt_over_ble && (bta_dm_search_cb.services &
                             ((BTA_ALL_SERVICE_MASK | BTA_USER_SERVICE_MASK) &
                              ~BTA_BLE_SERVICE_MASK)))
-    bta_dm_search_cb.p_search_cback(BTA_DM_DISC_RES_EVT,
-                                    &p_data->disc_result.result);
+    bta_dm_search_cb.p_search_cback(BTA_DM_DISC_RES_EVT, p_result);
 
   bta_dm_search_cmpl();
 }
@@ -1918,13 +1967,22 @@ static void bta_dm_discover_device(const RawAddress& remote_bd_addr) {
                      "Read remote name",
                      base::StringPrintf("Transport:%s",
                                         bt_transport_text(transport).c_str()));
-      return;
+      /* With the ACL up, as after bonding, the SDP search does not need to
+       * wait for the name: both run on the same link */
+      if (bta_dm_search_get_state() != BTA_DM_DISCOVER_ACTIVE ||
+          transport != BT_TRANSPORT_BR_EDR || !bta_dm_search_cb.services ||
+          !BTM_IsAclConnectionUp(bta_dm_search_cb.peer_bdaddr,
+                                 BT_TRANSPORT_BR_EDR)) {
+        return;
+      }
+      LOG_INFO("Starting service discovery along the remote name request");
+      bta_dm_search_cb.name_in_parallel = true;
     } else {
       LOG_ERROR("Unable to start read remote device name");
-    }
 
-    /* starting name discovery failed */
-    bta_dm_search_cb.name_discover_done = true;
+      /* starting name discovery failed */
+      bta_dm_search_cb.name_discover_done = true;
+    }
   }
 
   /* Reset transport state for next discovery */
@@ -2670,6 +2728,8 @@ void bta_dm_acl_up(const RawAddress& bd_addr, tBT_TRANSPORT transport,
   device->pref_role = BTA_ANY_ROLE;
   device->info = BTA_DM_DI_NONE;
   device->transport = transport;
+  device->pm_traffic_bytes = 0;
+  device->pm_traffic_rate = 0;
 
   if (controller_get_interface()->supports_sniff_subrating() &&
       acl_peer_supports_sniff_subrating(bd_addr)) {
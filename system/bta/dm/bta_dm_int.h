@@ -269,6 +269,8 @@ struct tBTA_DM_PEER_DEVICE {
   tBTA_DM_PM_ACTION pm_mode_failed;
   bool remove_dev_pending;
   tBT_TRANSPORT transport;
+  uint64_t pm_traffic_bytes; /* ACL data exchanged at the last sample */
+  uint32_t pm_traffic_rate;  /* smoothed ACL data rate in bytes per second */
 };
 
 /* structure to store list of
@@ -337,6 +339,7 @@ typedef struct {
   alarm_t* disable_timer;
   uint8_t pm_id;
   tBTA_PM_TIMER pm_timer[BTA_DM_NUM_PM_TIMER];
+  alarm_t* pm_traffic_timer; /* samples the ACL traffic of the links */
   uint8_t cur_av_count;   /* current AV connecions */
 
   /* Storage for pin code request parameters */
@@ -395,6 +398,9 @@ typedef struct {
   tBTA_DM_STATE state;
   RawAddress peer_bdaddr;
   bool name_discover_done;
+  bool name_in_parallel;    /* remote name request runs along the SDP search */
+  bool disc_result_pending; /* service discovery result waits for the name */
+  tBTA_DM_SEARCH pending_disc_result;
   BD_NAME peer_name;
   alarm_t* search_timer;
   uint8_t service_index;
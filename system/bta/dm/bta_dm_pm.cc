@@ -25,6 +25,7 @@
 
 #include <base/functional/bind.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
 #include <vector>
@@ -49,6 +50,8 @@ static void bta_dm_pm_set_mode(const RawAddress& peer_addr,
                                tBTA_DM_PM_ACTION pm_mode,
                                tBTA_DM_PM_REQ pm_req);
 static void bta_dm_pm_timer_cback(void* data);
+static void bta_dm_pm_traffic_timer_cback(void* data);
+static void bta_dm_pm_burst_cback(uint8_t id, const RawAddress& peer_addr);
 static void bta_dm_pm_btm_cback(const RawAddress& bd_addr,
                                 tBTM_PM_STATUS status, uint16_t value,
                                 tHCI_STATUS hci_status);
@@ -78,6 +81,15 @@ static const char kPropertySniffAttempts[] =
 static const char kPropertySniffTimeouts[] =
     "bluetooth.core.classic.sniff_timeouts";
 
+/* Period of the sampling of the ACL traffic of the links */
+static constexpr uint64_t kBtaDmPmTrafficSampleMs = 1000;
+/* ACL data rate in bytes per second better served by the active mode */
+static constexpr uint32_t kBtaDmPmTrafficBurstRate = 16 * 1024;
+/* ACL data allowed to build up between two sniff anchor points */
+static constexpr uint32_t kBtaDmPmTrafficBytesPerInterval = 512;
+/* Baseband slots of 0.625 ms in a second */
+static constexpr uint32_t kBtaDmPmSlotsPerSecond = 1600;
+
 /*******************************************************************************
  *
  * Function         bta_dm_init_pm
@@ -94,6 +106,7 @@ void bta_dm_init_pm(void) {
   /* if there are no power manger entries, so not register */
   if (p_bta_dm_pm_cfg[0].app_id != 0) {
     bta_sys_pm_register(bta_dm_pm_cback);
+    bta_sys_burst_register(bta_dm_pm_burst_cback);
 
     BTM_PmRegister((BTM_PM_REG_SET), &bta_dm_cb.pm_id, bta_dm_pm_btm_cback);
   }
@@ -123,6 +136,8 @@ void bta_dm_disable_pm(void) {
    * re-enabling the PM timers after this call if the callback is invoked.
    */
   bta_sys_pm_register(NULL);
+  bta_sys_burst_register(NULL);
+  alarm_cancel(bta_dm_cb.pm_traffic_timer);
 
   /* Need to stop all active timers. */
   for (int i = 0; i < BTA_DM_NUM_PM_TIMER; i++) {
@@ -366,6 +381,12 @@ static void bta_dm_pm_cback(tBTA_SYS_CONN_STATUS status, uint8_t id,
     return;
   }
 
+  /* the sniff parameters follow the traffic of the links */
+  if (!alarm_is_scheduled(bta_dm_cb.pm_traffic_timer)) {
+    alarm_set_on_mloop(bta_dm_cb.pm_traffic_timer, kBtaDmPmTrafficSampleMs,
+                       bta_dm_pm_traffic_timer_cback, NULL);
+  }
+
   LOG_DEBUG("Stopped all timers for service to device:%s id:%hhu",
             ADDRESS_TO_LOGGABLE_CSTR(peer_addr), id);
   bta_dm_pm_stop_timer_by_srvc_id(peer_addr, id);
@@ -759,6 +780,55 @@ tBTM_PM_PWR_MD get_sniff_entry(uint8_t index) {
   }
   return pwr_mds_cache[index];
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_traffic_max_interval
+ *
+ * Description      Longest sniff interval, in slots, keeping the ACL data
+ *                  exchanged between two anchor points within
+ *                  kBtaDmPmTrafficBytesPerInterval at |rate| bytes per second.
+ *
+ * Returns          the interval, 0 if the traffic does not limit it.
+ *
+ ******************************************************************************/
+static uint16_t bta_dm_pm_traffic_max_interval(uint32_t rate) {
+  if (rate == 0) return 0;
+  uint64_t interval = static_cast<uint64_t>(kBtaDmPmTrafficBytesPerInterval) *
+                      kBtaDmPmSlotsPerSecond / rate;
+  return static_cast<uint16_t>(
+      std::clamp<uint64_t>(interval, 2, UINT16_MAX));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_traffic_sniff_index
+ *
+ * Description      Select the sniff entry for a link exchanging |rate| bytes
+ *                  per second when the profiles request the entry |index|:
+ *                  the entry with the longest interval the traffic allows, or
+ *                  the shortest one if none does, never longer than |index|.
+ *
+ * Returns          index of the sniff entry.
+ *
+ ******************************************************************************/
+static uint8_t bta_dm_pm_traffic_sniff_index(uint32_t rate, uint8_t index) {
+  uint16_t limit = bta_dm_pm_traffic_max_interval(rate);
+  if (limit == 0 || get_sniff_entry(index).max <= limit) return index;
+
+  uint8_t best = index;
+  uint8_t shortest = index;
+  bool found = false;
+  for (uint8_t i = 0; i < BTA_DM_PM_PARK_IDX; i++) {
+    uint16_t max = get_sniff_entry(i).max;
+    if (max < get_sniff_entry(shortest).max) shortest = i;
+    if (max <= limit && (!found || max > get_sniff_entry(best).max)) {
+      best = i;
+      found = true;
+    }
+  }
+  return found ? best : shortest;
+}
 /*******************************************************************************
  *
  * Function         bta_ag_pm_sniff
@@ -803,7 +873,14 @@ void bta_dm_pm_sniff(tBTA_DM_PEER_DEVICE* p_peer_dev, uint8_t index) {
   }
   /* if the current mode is not sniff, issue the sniff command.
    * If sniff, but SSR is not used in this link, still issue the command */
-  tBTM_PM_PWR_MD sniff_entry = get_sniff_entry(index);
+  uint8_t traffic_index =
+      bta_dm_pm_traffic_sniff_index(p_peer_dev->pm_traffic_rate, index);
+  if (traffic_index != index) {
+    LOG_DEBUG("Shortening sniff entry %hhu to %hhu for %u bytes/s peer:%s",
+              index, traffic_index, p_peer_dev->pm_traffic_rate,
+              ADDRESS_TO_LOGGABLE_CSTR(p_peer_dev->peer_bdaddr));
+  }
+  tBTM_PM_PWR_MD sniff_entry = get_sniff_entry(traffic_index);
   memcpy(&pwr_md, &sniff_entry, sizeof(tBTM_PM_PWR_MD));
   if (p_peer_dev->Info() & BTA_DM_DI_INT_SNIFF) {
     LOG_DEBUG("Trying to force power mode");
@@ -894,14 +971,25 @@ static void bta_dm_pm_ssr(const RawAddress& peer_addr, const int ssr) {
       }
     }
 
+    /* do not let the subrating delay the traffic more than sniff would */
+    uint16_t max_lat = p_spec->max_lat;
+    tBTA_DM_PEER_DEVICE* p_dev = bta_dm_find_peer_device(peer_addr);
+    if (p_dev != nullptr) {
+      uint16_t traffic_max_lat =
+          bta_dm_pm_traffic_max_interval(p_dev->pm_traffic_rate);
+      if (traffic_max_lat != 0 && traffic_max_lat < max_lat) {
+        max_lat = traffic_max_lat;
+      }
+    }
+
     LOG_DEBUG(
         "Setting sniff subrating for device:%s spec_name:%s max_latency(s):%.2f"
         " min_local_timeout(s):%.2f min_remote_timeout(s):%.2f",
         ADDRESS_TO_LOGGABLE_CSTR(peer_addr), p_spec->name,
-        ticks_to_seconds(p_spec->max_lat), ticks_to_seconds(p_spec->min_loc_to),
+        ticks_to_seconds(max_lat), ticks_to_seconds(p_spec->min_loc_to),
         ticks_to_seconds(p_spec->min_rmt_to));
     /* set the SSR parameters. */
-    BTM_SetSsrParams(peer_addr, p_spec->max_lat, p_spec->min_rmt_to,
+    BTM_SetSsrParams(peer_addr, max_lat, p_spec->min_rmt_to,
                      p_spec->min_loc_to);
   }
 }
@@ -992,6 +1080,92 @@ static void bta_dm_pm_timer_cback(void* data) {
                             bta_dm_cb.pm_timer[i].pm_action[j]));
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_sample_traffic
+ *
+ * Description      Update the ACL data rate of the BR/EDR links, and bring
+ *                  back to active mode the links in sniff mode seeing a burst.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_pm_sample_traffic() {
+  bool br_edr_links = false;
+  for (int i = 0; i < bta_dm_cb.device_list.count; i++) {
+    tBTA_DM_PEER_DEVICE* p_dev = &bta_dm_cb.device_list.peer_device[i];
+    if (p_dev->conn_state != BTA_DM_CONNECTED ||
+        p_dev->transport != BT_TRANSPORT_BR_EDR) {
+      continue;
+    }
+    br_edr_links = true;
+
+    uint64_t bytes =
+        BTM_GetAclTrafficBytes(p_dev->peer_bdaddr, BT_TRANSPORT_BR_EDR);
+    /* the counter restarts with a new link to the device */
+    uint64_t delta = bytes >= p_dev->pm_traffic_bytes
+                         ? bytes - p_dev->pm_traffic_bytes
+                         : bytes;
+    p_dev->pm_traffic_bytes = bytes;
+    uint32_t rate = static_cast<uint32_t>(std::min<uint64_t>(
+        delta * 1000 / kBtaDmPmTrafficSampleMs, UINT32_MAX));
+    /* follow the bursts at once, and their end slowly */
+    if (rate > p_dev->pm_traffic_rate) {
+      p_dev->pm_traffic_rate = rate;
+    } else {
+      p_dev->pm_traffic_rate = static_cast<uint32_t>(
+          (3 * static_cast<uint64_t>(p_dev->pm_traffic_rate) + rate) / 4);
+    }
+
+    if (rate < kBtaDmPmTrafficBurstRate) continue;
+    tBTM_PM_MODE mode = BTM_PM_MD_ACTIVE;
+    if (BTM_ReadPowerMode(p_dev->peer_bdaddr, &mode) &&
+        mode == BTM_PM_MD_SNIFF) {
+      LOG_DEBUG("Traffic burst of %u bytes/s in sniff mode peer:%s", rate,
+                ADDRESS_TO_LOGGABLE_CSTR(p_dev->peer_bdaddr));
+      bta_dm_pm_active(p_dev->peer_bdaddr);
+    }
+  }
+
+  if (!br_edr_links) {
+    alarm_cancel(bta_dm_cb.pm_traffic_timer);
+  }
+}
+
+/** Power management traffic timer callback */
+static void bta_dm_pm_traffic_timer_cback(void* data) {
+  do_in_main_thread(FROM_HERE, base::Bind(bta_dm_pm_sample_traffic));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_burst_cback
+ *
+ * Description      Bring the link to active mode ahead of the traffic burst
+ *                  a BTA subsystem expects, and keep the sniff intervals short
+ *                  until the traffic sampling sees it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_pm_burst_cback(uint8_t id, const RawAddress& peer_addr) {
+  tBTA_DM_PEER_DEVICE* p_dev = bta_dm_find_peer_device(peer_addr);
+  if (p_dev == nullptr) {
+    LOG_INFO("Unable to find peer device expecting a traffic burst");
+    return;
+  }
+
+  LOG_DEBUG("Traffic burst expected by %s peer:%s", BtaIdSysText(id).c_str(),
+            ADDRESS_TO_LOGGABLE_CSTR(peer_addr));
+  p_dev->pm_traffic_rate =
+      std::max(p_dev->pm_traffic_rate, kBtaDmPmTrafficBurstRate);
+
+  tBTM_PM_MODE mode = BTM_PM_MD_ACTIVE;
+  if (BTM_ReadPowerMode(peer_addr, &mode) && mode == BTM_PM_MD_SNIFF) {
+    bta_dm_pm_active(peer_addr);
+  }
+}
+
 /** Process pm status event from btm */
 void bta_dm_pm_btm_status(const RawAddress& bd_addr, tBTM_PM_STATUS status,
                           uint16_t interval, tHCI_STATUS hci_status) {
@@ -1157,3 +1331,18 @@ tBTM_CONTRL_STATE bta_dm_pm_obtain_controller_state(void) {
   APPL_TRACE_DEBUG("bta_dm_pm_obtain_controller_state: %d", cur_state);
   return cur_state;
 }
+
+namespace bluetooth {
+namespace legacy {
+namespace testing {
+uint16_t bta_dm_pm_traffic_max_interval(uint32_t rate) {
+  return ::bta_dm_pm_traffic_max_interval(rate);
+}
+
+uint8_t bta_dm_pm_traffic_sniff_index(uint32_t rate, uint8_t index) {
+  return ::bta_dm_pm_traffic_sniff_index(rate, index);
+}
+
+}  // namespace testing
+}  // namespace legacy
+}  // namespace bluetooth
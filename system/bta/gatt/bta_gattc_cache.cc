@@ -29,6 +29,7 @@
 #include <base/strings/string_number_conversions.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <sstream>
@@ -212,8 +213,8 @@ tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
   return bta_gattc_sdp_service_disc(conn_id, p_server_cb);
 }
 
-/** start exploring next service, or finish discovery if no more services left
- */
+/** start exploring next services, one per bearer of the connection, or finish
+ * discovery if no more services left */
 static void bta_gattc_explore_next_service(uint16_t conn_id,
                                            tBTA_GATTC_SERV* p_srvc_cb) {
   tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
@@ -222,15 +223,20 @@ static void bta_gattc_explore_next_service(uint16_t conn_id,
     return;
   }
 
-  if (p_srvc_cb->pending_discovery.StartNextServiceExploration()) {
-    const auto& service =
-        p_srvc_cb->pending_discovery.CurrentlyExploredService();
-    VLOG(1) << "Start service discovery";
+  // With EATT, explore services concurrently: the requests of each of them
+  // are sent on the least loaded bearer
+  size_t max_explored = std::max<size_t>(GATTC_GetNumBearers(conn_id), 1);
+  std::pair<uint16_t, uint16_t> service;
+  while (p_srvc_cb->pending_discovery.NumServicesBeingExplored() <
+             max_explored &&
+         p_srvc_cb->pending_discovery.StartServiceExploration(&service)) {
+    VLOG(1) << "Start service discovery, s_handle=" << loghex(service.first);
 
     /* start discovering included services */
     GATTC_Discover(conn_id, GATT_DISC_INC_SRVC, service.first, service.second);
-    return;
   }
+
+  if (p_srvc_cb->pending_discovery.NumServicesBeingExplored() != 0) return;
   // No more services to discover
 
   // As part of service discovery, read the values of "Characteristic Extended
@@ -321,13 +327,14 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
   bta_gattc_reset_discover_st(p_clcb->p_srcb, GATT_SUCCESS);
 }
 
-/** Start discovery for characteristic descriptor */
-void bta_gattc_start_disc_char_dscp(uint16_t conn_id,
-                                    tBTA_GATTC_SERV* p_srvc_cb) {
+/** Start discovery for characteristic descriptor of the explored service */
+static void bta_gattc_start_disc_char_dscp(uint16_t conn_id,
+                                           tBTA_GATTC_SERV* p_srvc_cb,
+                                           uint16_t service_handle) {
   VLOG(1) << "starting discover characteristics descriptor";
 
   std::pair<uint16_t, uint16_t> range =
-      p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore();
+      p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore(service_handle);
   if (range == DatabaseBuilder::EXPLORE_END) {
     goto descriptor_discovery_done;
   }
@@ -342,6 +349,7 @@ descriptor_discovery_done:
   /* all characteristic has been explored, start with next service if any */
   DVLOG(3) << "all characteristics explored";
 
+  p_srvc_cb->pending_discovery.FinishServiceExploration(service_handle);
   bta_gattc_explore_next_service(conn_id, p_srvc_cb);
   return;
 }
@@ -514,10 +522,17 @@ void bta_gattc_disc_res_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
 }
 
 void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
-                               tGATT_STATUS status) {
+                               tGATT_STATUS status, uint16_t e_handle) {
   tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
   tBTA_GATTC_SERV* p_srvc_cb = bta_gattc_find_scb_by_cid(conn_id);
 
+  // The service whose exploration this discovery is part of, if any
+  std::pair<uint16_t, uint16_t> service;
+  bool is_exploration =
+      p_srvc_cb && disc_type != GATT_DISC_SRVC_ALL &&
+      disc_type != GATT_DISC_SRVC_BY_UUID &&
+      p_srvc_cb->pending_discovery.FindExploredService(e_handle, &service);
+
   if (p_clcb && (status != GATT_SUCCESS || p_clcb->status != GATT_SUCCESS)) {
     if (status == GATT_SUCCESS) p_clcb->status = status;
 
@@ -535,6 +550,12 @@ void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
       }
     }
 
+    // Complete the discovery once the other services being explored are done
+    if (is_exploration) {
+      p_srvc_cb->pending_discovery.FinishServiceExploration(service.first);
+      if (p_srvc_cb->pending_discovery.NumServicesBeingExplored() != 0) return;
+    }
+
     bta_gattc_sm_execute(p_clcb, BTA_GATTC_DISCOVER_CMPL_EVT, NULL);
     return;
   }
@@ -553,23 +574,25 @@ void bta_gattc_disc_cmpl_cback(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
       break;
 
     case GATT_DISC_INC_SRVC: {
-      auto& service = p_srvc_cb->pending_discovery.CurrentlyExploredService();
+      if (!is_exploration) break;
       /* start discovering characteristic */
       GATTC_Discover(conn_id, GATT_DISC_CHAR, service.first, service.second);
       break;
     }
 
     case GATT_DISC_CHAR: {
+      if (!is_exploration) break;
 #if (BTA_GATT_DEBUG == TRUE)
       bta_gattc_display_explore_record(p_srvc_cb->pending_discovery);
 #endif
-      bta_gattc_start_disc_char_dscp(conn_id, p_srvc_cb);
+      bta_gattc_start_disc_char_dscp(conn_id, p_srvc_cb, service.first);
       break;
     }
 
     case GATT_DISC_CHAR_DSCPT:
+      if (!is_exploration) break;
       /* start discovering next characteristic for char descriptor */
-      bta_gattc_start_disc_char_dscp(conn_id, p_srvc_cb);
+      bta_gattc_start_disc_char_dscp(conn_id, p_srvc_cb, service.first);
       break;
 
     case GATT_DISC_MAX:
@@ -618,31 +641,23 @@ const std::list<Service>* bta_gattc_get_services(uint16_t conn_id) {
 
 const Service* bta_gattc_get_service_for_handle_srcb(tBTA_GATTC_SERV* p_srcb,
                                                      uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services_srcb(p_srcb);
-  if (services == NULL) return NULL;
-  return bta_gattc_find_matching_service(*services, handle);
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindService(handle);
 }
 
 const Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
                                                 uint16_t handle) {
-  const std::list<Service>* services = bta_gattc_get_services(conn_id);
-  if (services == NULL) return NULL;
+  tBTA_GATTC_CLCB* p_clcb = bta_gattc_find_clcb_by_conn_id(conn_id);
 
-  return bta_gattc_find_matching_service(*services, handle);
+  if (p_clcb == NULL) return NULL;
+
+  return bta_gattc_get_service_for_handle_srcb(p_clcb->p_srcb, handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) return &charac;
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
@@ -657,20 +672,8 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb,
                                                 uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) {
-    return NULL;
-  }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &desc;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -684,18 +687,8 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
 
 const Characteristic* bta_gattc_get_owning_characteristic_srcb(
     tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &charac;
-    }
-  }
-
-  return NULL;
+  if (!p_srcb) return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
@@ -21,7 +21,10 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include <string>
 #include <vector>
@@ -29,13 +32,12 @@
 #include "bta/gatt/bta_gattc_int.h"
 #include "osi/include/log.h"
 
-using gatt::StoredAttribute;
 using std::string;
 using std::vector;
 
 #ifdef TARGET_FLOSS
 #define GATT_CACHE_PREFIX "/var/lib/bluetooth/gatt/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/var/lib/bluetooth/gatt/gatt_hash_"
@@ -43,7 +45,7 @@ using std::vector;
 #define GATT_HASH_FILE_PREFIX "gatt_hash_"
 #else
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/data/misc/bluetooth/gatt_hash_"
@@ -75,7 +77,8 @@ static gatt::Database EMPTY_DB;
  *
  * Function         bta_gattc_load_db
  *
- * Description      Load GATT database from storage.
+ * Description      Load GATT database from storage. The file is mapped and the
+ *                  database built straight from its compact attributes.
  *
  * Parameter        fname: input file name
  *
@@ -84,49 +87,44 @@ static gatt::Database EMPTY_DB;
  *
  ******************************************************************************/
 static gatt::Database bta_gattc_load_db(const char* fname) {
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG(ERROR) << __func__ << ": can't open GATT cache file " << fname
                << " for reading, error: " << strerror(errno);
     return EMPTY_DB;
   }
 
-  uint16_t cache_ver = 0;
-  uint16_t num_attr = 0;
-
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
+  struct stat st;
+  if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(uint16_t)) {
     LOG(ERROR) << __func__ << ": can't read GATT cache version from: " << fname;
-    goto done;
-  }
-
-  if (cache_ver != GATT_CACHE_VERSION) {
-    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
-    goto done;
+    close(fd);
+    return EMPTY_DB;
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't read number of GATT attributes: " << fname;
-    goto done;
+  size_t len = st.st_size;
+  void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": can't map GATT cache file " << fname
+               << ", error: " << strerror(errno);
+    return EMPTY_DB;
   }
 
-  {
-    std::vector<StoredAttribute> attr(num_attr);
-
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      LOG(ERROR) << __func__ << ": can't read GATT attributes: " << fname;
-      goto done;
-    }
-    fclose(fd);
+  const uint8_t* p = static_cast<const uint8_t*>(map);
+  uint16_t cache_ver;
+  STREAM_TO_UINT16(cache_ver, p);
 
-    bool success = false;
-    gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
+  gatt::Database result;
+  bool success = false;
+  if (cache_ver != GATT_CACHE_VERSION) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
+  } else {
+    result = gatt::Database::DeserializeCompact(p, len - sizeof(uint16_t),
+                                                &success);
   }
 
-done:
-  fclose(fd);
-  return EMPTY_DB;
+  munmap(map, len);
+  return success ? result : EMPTY_DB;
 }
 
 /*******************************************************************************
@@ -172,13 +170,13 @@ gatt::Database bta_gattc_hash_load(const Octet16& hash) {
  * Description      Storess GATT db.
  *
  * Parameter        fname: output file name
- *                  attr: attributes to save.
+ *                  data: attributes to save, in their compact form.
  *
  * Returns          true on success, false otherwise
  *
  ******************************************************************************/
 static bool bta_gattc_store_db(const char* fname,
-                               const std::vector<StoredAttribute>& attr) {
+                               const std::vector<uint8_t>& data) {
   FILE* fd = fopen(fname, "wb");
   if (!fd) {
     LOG(ERROR) << __func__
@@ -187,21 +185,16 @@ static bool bta_gattc_store_db(const char* fname,
   }
 
   uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
+  uint8_t header[sizeof(uint16_t)];
+  uint8_t* p = header;
+  UINT16_TO_STREAM(p, cache_ver);
+  if (fwrite(header, sizeof(header), 1, fd) != 1) {
     LOG(ERROR) << __func__ << ": can't write GATT cache version: " << fname;
     fclose(fd);
     return false;
   }
 
-  uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't write GATT cache attribute count: " << fname;
-    fclose(fd);
-    return false;
-  }
-
-  if (fwrite(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
+  if (fwrite(data.data(), 1, data.size(), fd) != data.size()) {
     LOG(ERROR) << __func__ << ": can't write GATT cache attributes: " << fname;
     fclose(fd);
     return false;
@@ -281,7 +274,7 @@ bool bta_gattc_hash_write(const Octet16& hash, const gatt::Database& database) {
   char fname[255] = {0};
   bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
   bta_gattc_hash_remove_least_recently_used_if_possible();
-  return bta_gattc_store_db(fname, database.Serialize());
+  return bta_gattc_store_db(fname, database.SerializeCompact());
 }
 
 /*******************************************************************************
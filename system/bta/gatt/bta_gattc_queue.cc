@@ -16,12 +16,19 @@
 
 #include "bta_gatt_queue.h"
 
+#include <stdio.h>
+
+#include <algorithm>
+#include <iterator>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "osi/include/allocator.h"
+#include "stack/include/btu.h"  // do_in_main_thread
 
+#include <base/bind.h>
 #include <base/logging.h>
 
 using gatt_operation = BtaGattQueue::gatt_operation;
@@ -40,6 +47,13 @@ struct gatt_read_op_data {
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
 std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_set<uint16_t> BtaGattQueue::gatt_read_multi_unsupported;
+std::unordered_map<uint16_t, BtaGattQueue::gatt_queue_stats>
+    BtaGattQueue::gatt_op_queue_stats;
+
+static bool is_control_op(const gatt_operation& op) {
+  return op.type == GATT_CONFIG_MTU || op.type == GATT_WRITE_DESC;
+}
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
   gatt_op_queue_executing.erase(conn_id);
@@ -86,6 +100,78 @@ void BtaGattQueue::gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
   }
 }
 
+struct gatt_read_multi_op_data {
+  uint8_t num_reads;
+  uint8_t types[GATT_MAX_READ_MULTI_HANDLES];
+  GATT_READ_OP_CB cbs[GATT_MAX_READ_MULTI_HANDLES];
+  void* cb_data[GATT_MAX_READ_MULTI_HANDLES];
+};
+
+void BtaGattQueue::gatt_read_multi_op_finished(uint16_t conn_id,
+                                               tGATT_STATUS status,
+                                               tBTA_GATTC_MULTI& handles,
+                                               uint16_t len, uint8_t* value,
+                                               void* data) {
+  gatt_read_multi_op_data* tmp = (gatt_read_multi_op_data*)data;
+
+  struct read_result {
+    GATT_READ_OP_CB cb;
+    void* cb_data;
+    uint16_t handle;
+    uint16_t len;
+    uint8_t* value;
+  };
+  std::vector<read_result> results;
+  std::list<gatt_operation> retries;
+
+  if (status == GATT_REQ_NOT_SUPPORTED) {
+    gatt_read_multi_unsupported.insert(conn_id);
+  }
+
+  /* The response is a list of length and value tuples, truncated to the MTU.
+   * Reads without their complete value, or all of them when the request
+   * failed, are queued again to be sent on their own, which also gives each
+   * one its own error status. */
+  uint8_t* p = value;
+  uint16_t remaining = (status == GATT_SUCCESS) ? len : 0;
+  for (uint8_t i = 0; i < tmp->num_reads && i < handles.num_attr; i++) {
+    if (remaining >= 2) {
+      uint16_t value_len = p[0] | (p[1] << 8);
+      if (remaining - 2 >= value_len) {
+        results.push_back({tmp->cbs[i], tmp->cb_data[i], handles.handles[i],
+                           value_len, p + 2});
+        p += 2 + value_len;
+        remaining -= 2 + value_len;
+        continue;
+      }
+      remaining = 0;
+    }
+
+    retries.push_back({.type = tmp->types[i],
+                       .handle = handles.handles[i],
+                       .read_cb = tmp->cbs[i],
+                       .read_cb_data = tmp->cb_data[i],
+                       .no_read_multi = true});
+  }
+
+  osi_free(data);
+
+  if (!retries.empty()) {
+    std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+    gatt_ops.splice(gatt_ops.begin(), retries);
+  }
+
+  mark_as_not_executing(conn_id);
+  gatt_execute_next_op(conn_id);
+
+  for (const read_result& result : results) {
+    if (result.cb) {
+      result.cb(conn_id, GATT_SUCCESS, result.handle, result.len, result.value,
+                result.cb_data);
+    }
+  }
+}
+
 struct gatt_configure_mtu_op_data {
   GATT_CONFIGURE_MTU_OP_CB cb;
   void* cb_data;
@@ -132,6 +218,8 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 
   std::list<gatt_operation>& gatt_ops = map_ptr->second;
 
+  if (gatt_execute_read_multi(conn_id, gatt_ops)) return;
+
   gatt_operation& op = gatt_ops.front();
 
   if (op.type == GATT_READ_CHAR) {
@@ -179,60 +267,170 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   gatt_ops.pop_front();
 }
 
+/* Send the reads at the front of the queue in a single Read Multiple Variable
+ * Length request. Returns false if there is no more than one. */
+bool BtaGattQueue::gatt_execute_read_multi(
+    uint16_t conn_id, std::list<gatt_operation>& gatt_ops) {
+  auto can_read_multi = [](const gatt_operation& op) {
+    return (op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) &&
+           !op.no_read_multi;
+  };
+
+  auto end = gatt_ops.begin();
+  uint8_t num_reads = 0;
+  while (end != gatt_ops.end() && num_reads < GATT_MAX_READ_MULTI_HANDLES &&
+         can_read_multi(*end)) {
+    end++;
+    num_reads++;
+  }
+
+  if (num_reads < 2 || gatt_read_multi_unsupported.count(conn_id) ||
+      !GATTC_IsReadMultipleVariableLengthSupported(conn_id)) {
+    return false;
+  }
+
+  APPL_TRACE_DEBUG("%s: conn_id=0x%x, reading %d handles at once", __func__,
+                   conn_id, num_reads);
+
+  gatt_read_multi_op_data* data =
+      (gatt_read_multi_op_data*)osi_malloc(sizeof(gatt_read_multi_op_data));
+  tBTA_GATTC_MULTI read_multi;
+  data->num_reads = num_reads;
+  read_multi.num_attr = num_reads;
+
+  uint8_t i = 0;
+  for (auto it = gatt_ops.begin(); it != end; it++, i++) {
+    read_multi.handles[i] = it->handle;
+    data->types[i] = it->type;
+    data->cbs[i] = it->read_cb;
+    data->cb_data[i] = it->read_cb_data;
+  }
+  gatt_ops.erase(gatt_ops.begin(), end);
+
+  BTA_GATTC_ReadMultiple(conn_id, &read_multi, true /* variable_len */,
+                         GATT_AUTH_REQ_NONE, gatt_read_multi_op_finished, data);
+  return true;
+}
+
+/* Queue |op| for |conn_id|, or reject it when the app already queued
+ * kMaxQueuedOps operations. Control operations do not wait behind the reads
+ * and writes of other handles, but keep their order with respect to each other
+ * and to the operations of their own handle. */
+void BtaGattQueue::gatt_enqueue_op(uint16_t conn_id, gatt_operation op) {
+  std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+  gatt_queue_stats& stats = gatt_op_queue_stats[conn_id];
+
+  if (gatt_ops.size() >= kMaxQueuedOps) {
+    if (stats.rejected++ == 0) {
+      LOG(WARNING) << __func__ << ": conn_id=" << loghex(conn_id) << " has "
+                   << gatt_ops.size() << " operations queued, rejecting more";
+    }
+    gatt_reject_op(conn_id, op);
+    return;
+  }
+
+  auto pos = gatt_ops.end();
+  if (is_control_op(op)) {
+    while (pos != gatt_ops.begin()) {
+      auto prev = std::prev(pos);
+      if (is_control_op(*prev) || prev->handle == op.handle) break;
+      pos = prev;
+    }
+  }
+  gatt_ops.insert(pos, std::move(op));
+  stats.max_depth = std::max(stats.max_depth, gatt_ops.size());
+
+  gatt_execute_next_op(conn_id);
+}
+
+/* The callback of a rejected operation is not called from the app's own call
+ * to the queue, which could otherwise retry right away. */
+void BtaGattQueue::gatt_reject_op(uint16_t conn_id, const gatt_operation& op) {
+  if (op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) {
+    if (!op.read_cb) return;
+    do_in_main_thread(FROM_HERE, base::BindOnce(op.read_cb, conn_id, GATT_BUSY,
+                                                op.handle, 0,
+                                                static_cast<uint8_t*>(nullptr),
+                                                op.read_cb_data));
+  } else if (op.type == GATT_WRITE_CHAR || op.type == GATT_WRITE_DESC) {
+    if (!op.write_cb) return;
+    do_in_main_thread(
+        FROM_HERE, base::BindOnce(op.write_cb, conn_id, GATT_BUSY, op.handle,
+                                  0, static_cast<const uint8_t*>(nullptr),
+                                  op.write_cb_data));
+  } else if (op.type == GATT_CONFIG_MTU) {
+    if (!op.mtu_cb) return;
+    do_in_main_thread(FROM_HERE, base::BindOnce(op.mtu_cb, conn_id, GATT_BUSY,
+                                                op.mtu_cb_data));
+  }
+}
+
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
+  gatt_read_multi_unsupported.erase(conn_id);
+  gatt_op_queue_stats.erase(conn_id);
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  gatt_enqueue_op(conn_id, {.type = GATT_READ_CHAR,
+                            .handle = handle,
+                            .read_cb = cb,
+                            .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  gatt_enqueue_op(conn_id, {.type = GATT_READ_DESC,
+                            .handle = handle,
+                            .read_cb = cb,
+                            .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                        std::vector<uint8_t> value,
                                        tGATT_WRITE_TYPE write_type,
                                        GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_CHAR,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  gatt_enqueue_op(conn_id, {.type = GATT_WRITE_CHAR,
+                            .handle = handle,
+                            .write_cb = cb,
+                            .write_cb_data = cb_data,
+                            .write_type = write_type,
+                            .value = std::move(value)});
 }
 
 void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                    std::vector<uint8_t> value,
                                    tGATT_WRITE_TYPE write_type,
                                    GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_DESC,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  gatt_enqueue_op(conn_id, {.type = GATT_WRITE_DESC,
+                            .handle = handle,
+                            .write_cb = cb,
+                            .write_cb_data = cb_data,
+                            .write_type = write_type,
+                            .value = std::move(value)});
 }
 
 void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
   LOG(INFO) << __func__ << ", mtu: " << static_cast<int>(mtu);
   std::vector<uint8_t> value = {static_cast<uint8_t>(mtu & 0xff),
                                 static_cast<uint8_t>(mtu >> 8)};
-  gatt_op_queue[conn_id].push_back({.type = GATT_CONFIG_MTU,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  gatt_enqueue_op(conn_id,
+                  {.type = GATT_CONFIG_MTU, .value = std::move(value)});
+}
+
+void BtaGattQueue::DebugDump(int fd) {
+  dprintf(fd, "BTA GATT client queue:\n");
+  for (const auto& [conn_id, stats] : gatt_op_queue_stats) {
+    auto map_ptr = gatt_op_queue.find(conn_id);
+    size_t depth =
+        (map_ptr == gatt_op_queue.end()) ? 0 : map_ptr->second.size();
+    dprintf(fd,
+            "  conn_id: 0x%04x, queued: %zu, max queued: %zu, rejected: %zu, "
+            "executing: %s\n",
+            conn_id, depth, stats.max_depth, stats.rejected,
+            gatt_op_queue_executing.count(conn_id) ? "true" : "false");
+  }
+  dprintf(fd, "\n");
 }
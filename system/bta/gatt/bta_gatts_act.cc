@@ -23,14 +23,22 @@
  *
  ******************************************************************************/
 
+#include <base/functional/bind.h>
+
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/bta_gatts_int.h"
 #include "bta/include/bta_api.h"
 #include "btif/include/btif_debug_conn.h"
+#include "common/message_loop_thread.h"
 #include "osi/include/allocator.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/include/gatt_api.h"
 #include "types/raw_address.h"
 
@@ -77,6 +85,41 @@ static tGATT_CBACK bta_gatts_cback = {
 tGATT_APPL_INFO bta_gatts_nv_cback = {bta_gatts_nv_save_cback,
                                       bta_gatts_nv_srv_chg_cback};
 
+/* Number of threads the client requests are handed to the applications on,
+ * off the main thread. The requests of a connection are all handed on the
+ * same thread, in order. None by default. */
+#define PROPERTY_GATTS_REQUEST_WORKERS "bluetooth.gatt.server.request_workers"
+#define BTA_GATTS_MAX_REQUEST_WORKERS 4
+
+static std::vector<std::unique_ptr<bluetooth::common::MessageLoopThread>>
+    bta_gatts_request_workers;
+
+static void bta_gatts_start_request_workers() {
+  int num_workers = osi_property_get_int32(PROPERTY_GATTS_REQUEST_WORKERS, 0);
+  num_workers = std::min(num_workers, BTA_GATTS_MAX_REQUEST_WORKERS);
+
+  for (int i = 0; i < num_workers; i++) {
+    auto worker = std::make_unique<bluetooth::common::MessageLoopThread>(
+        "bt_gatts_worker_" + std::to_string(i));
+    worker->StartUp();
+    if (!worker->IsRunning()) {
+      LOG(ERROR) << __func__ << ": unable to start request worker " << i;
+      break;
+    }
+    bta_gatts_request_workers.push_back(std::move(worker));
+  }
+
+  if (!bta_gatts_request_workers.empty()) {
+    LOG(INFO) << __func__ << ": client requests handed on "
+              << bta_gatts_request_workers.size() << " workers";
+  }
+}
+
+static void bta_gatts_stop_request_workers() {
+  for (auto& worker : bta_gatts_request_workers) worker->ShutDown();
+  bta_gatts_request_workers.clear();
+}
+
 /*******************************************************************************
  *
  * Function         bta_gatts_nv_save_cback
@@ -126,6 +169,7 @@ void bta_gatts_enable(tBTA_GATTS_CB* p_cb) {
     p_cb->enabled = true;
 
     gatt_load_bonded();
+    bta_gatts_start_request_workers();
 
     if (!GATTS_NVRegister(&bta_gatts_nv_cback)) {
       LOG(ERROR) << "BTA GATTS NV register failed.";
@@ -151,6 +195,7 @@ void bta_gatts_api_disable(tBTA_GATTS_CB* p_cb) {
         GATT_Deregister(p_cb->rcb[i].gatt_if);
       }
     }
+    bta_gatts_stop_request_workers();
     memset(p_cb, 0, sizeof(tBTA_GATTS_CB));
   } else {
     LOG(ERROR) << "GATTS not enabled";
@@ -529,6 +574,14 @@ void bta_gatts_close(UNUSED_ATTR tBTA_GATTS_CB* p_cb, tBTA_GATTS_DATA* p_msg) {
  * Returns          none.
  *
  ******************************************************************************/
+/** Hand a client request to the application, on a request worker */
+static void bta_gatts_dispatch_request(tBTA_GATTS_CBACK* p_cback,
+                                       tGATTS_REQ_TYPE req_type,
+                                       tBTA_GATTS cb_data, tGATTS_DATA data) {
+  cb_data.req_data.p_data = &data;
+  (*p_cback)(req_type, &cb_data);
+}
+
 static void bta_gatts_send_request_cback(uint16_t conn_id, uint32_t trans_id,
                                          tGATTS_REQ_TYPE req_type,
                                          tGATTS_DATA* p_data) {
@@ -557,6 +610,20 @@ static void bta_gatts_send_request_cback(uint16_t conn_id, uint32_t trans_id,
       cb_data.req_data.trans_id = trans_id;
       cb_data.req_data.p_data = (tGATTS_DATA*)p_data;
 
+      if (!bta_gatts_request_workers.empty() && p_data != nullptr) {
+        /* Spread the connections over the workers, the requests of a
+         * connection stay on one of them so that they are handled in order */
+        size_t index = (conn_id ^ (conn_id >> 8)) %
+                       bta_gatts_request_workers.size();
+        if (bta_gatts_request_workers[index]->DoInThread(
+                FROM_HERE,
+                base::BindOnce(&bta_gatts_dispatch_request, p_rcb->p_cback,
+                               req_type, cb_data, *p_data))) {
+          return;
+        }
+        LOG(WARNING) << __func__ << ": unable to hand request to worker";
+      }
+
       (*p_rcb->p_cback)(req_type, &cb_data);
     } else {
       LOG(ERROR) << "connection request on gatt_if=" << +gatt_if
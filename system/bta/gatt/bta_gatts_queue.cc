@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <stdio.h>
+
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
@@ -29,6 +31,7 @@ std::unordered_map<uint16_t, std::list<gatts_operation>>
     BtaGattServerQueue::gatts_op_queue;
 std::unordered_set<uint16_t> BtaGattServerQueue::gatts_op_queue_executing;
 std::unordered_map<uint16_t, bool> BtaGattServerQueue::congestion_queue;
+std::unordered_map<uint16_t, size_t> BtaGattServerQueue::gatts_op_queue_dropped;
 
 void BtaGattServerQueue::mark_as_not_executing(uint16_t conn_id) {
   gatts_op_queue_executing.erase(conn_id);
@@ -87,12 +90,22 @@ void BtaGattServerQueue::Clean(uint16_t conn_id) {
 
   gatts_op_queue.erase(conn_id);
   gatts_op_queue_executing.erase(conn_id);
+  gatts_op_queue_dropped.erase(conn_id);
 }
 
 void BtaGattServerQueue::SendNotification(uint16_t conn_id, uint16_t handle,
                                           std::vector<uint8_t> value,
                                           bool need_confirm) {
-  gatts_op_queue[conn_id].emplace_back(
+  std::list<gatts_operation>& gatts_ops = gatts_op_queue[conn_id];
+  if (gatts_ops.size() >= kMaxQueuedOps) {
+    if (gatts_op_queue_dropped[conn_id]++ == 0) {
+      APPL_TRACE_WARNING("%s: conn_id=0x%x has %zu notifications queued",
+                         __func__, conn_id, gatts_ops.size());
+    }
+    return;
+  }
+
+  gatts_ops.emplace_back(
       gatts_operation{.type = GATT_NOTIFY,
                       .attr_id = handle,
                       .value = value,
@@ -123,3 +136,14 @@ void BtaGattServerQueue::CongestionCallback(uint16_t conn_id, bool congested) {
     gatts_execute_next_op(conn_id);
   }
 }
+
+void BtaGattServerQueue::DebugDump(int fd) {
+  dprintf(fd, "BTA GATT server queue:\n");
+  for (const auto& [conn_id, gatts_ops] : gatts_op_queue) {
+    auto dropped = gatts_op_queue_dropped.find(conn_id);
+    dprintf(fd, "  conn_id: 0x%04x, queued: %zu, dropped: %zu\n", conn_id,
+            gatts_ops.size(),
+            dropped == gatts_op_queue_dropped.end() ? 0 : dropped->second);
+  }
+  dprintf(fd, "\n");
+}
@@ -21,6 +21,7 @@
 #include <base/logging.h>
 
 #include <algorithm>
+#include <iterator>
 #include <list>
 #include <memory>
 #include <sstream>
@@ -91,6 +92,91 @@ std::string Database::ToString() const {
   return tmp.str();
 }
 
+void Database::BuildIndex() {
+  service_index.clear();
+  handle_index.clear();
+  uuid_index.clear();
+
+  for (const Service& service : services) {
+    service_index.push_back(&service);
+    uuid_index.emplace_back(service.uuid, &service);
+
+    for (const Characteristic& charac : service.characteristics) {
+      handle_index.push_back({charac.value_handle, &service, &charac, nullptr});
+      for (const Descriptor& desc : charac.descriptors) {
+        handle_index.push_back({desc.handle, &service, &charac, &desc});
+      }
+    }
+  }
+
+  std::stable_sort(service_index.begin(), service_index.end(),
+                   [](const Service* a, const Service* b) {
+                     return a->handle < b->handle;
+                   });
+  std::stable_sort(handle_index.begin(), handle_index.end(),
+                   [](const HandleEntry& a, const HandleEntry& b) {
+                     return a.handle < b.handle;
+                   });
+  std::stable_sort(uuid_index.begin(), uuid_index.end(),
+                   [](const std::pair<Uuid, const Service*>& a,
+                      const std::pair<Uuid, const Service*>& b) {
+                     return a.first < b.first;
+                   });
+}
+
+const Service* Database::FindService(uint16_t handle) const {
+  auto it = std::upper_bound(
+      service_index.begin(), service_index.end(), handle,
+      [](uint16_t handle, const Service* s) { return handle < s->handle; });
+  if (it == service_index.begin()) return nullptr;
+
+  const Service* service = *std::prev(it);
+  return HandleInRange(*service, handle) ? service : nullptr;
+}
+
+const Database::HandleEntry* Database::FindHandle(uint16_t handle) const {
+  auto it = std::lower_bound(
+      handle_index.begin(), handle_index.end(), handle,
+      [](const HandleEntry& e, uint16_t handle) { return e.handle < handle; });
+  if (it == handle_index.end() || it->handle != handle) return nullptr;
+  return &*it;
+}
+
+const Characteristic* Database::FindCharacteristic(
+    uint16_t value_handle) const {
+  const HandleEntry* entry = FindHandle(value_handle);
+  if (!entry || entry->descriptor) return nullptr;
+  return entry->characteristic;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  const HandleEntry* entry = FindHandle(handle);
+  return entry ? entry->descriptor : nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(
+    uint16_t handle) const {
+  const HandleEntry* entry = FindHandle(handle);
+  if (!entry || !entry->descriptor) return nullptr;
+  return entry->characteristic;
+}
+
+std::vector<const Service*> Database::FindServices(const Uuid& uuid) const {
+  auto range = std::equal_range(
+      uuid_index.begin(), uuid_index.end(),
+      std::pair<Uuid, const Service*>(uuid, nullptr),
+      [](const std::pair<Uuid, const Service*>& a,
+         const std::pair<Uuid, const Service*>& b) {
+        return a.first < b.first;
+      });
+
+  std::vector<const Service*> result;
+  for (auto it = range.first; it != range.second; ++it) {
+    result.push_back(it->second);
+  }
+  return result;
+}
+
 std::vector<StoredAttribute> Database::Serialize() const {
   std::vector<StoredAttribute> nv_attr;
 
@@ -175,7 +261,8 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
 
     if (attr.type == INCLUDE) {
       Service* included_service =
-          FindService(result.services, attr.value.included_service.handle);
+          gatt::FindService(result.services,
+                            attr.value.included_service.handle);
       if (!included_service) {
         LOG(ERROR) << __func__ << ": Non-existing included service!";
         *success = false;
@@ -209,10 +296,180 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       }
     }
   }
+  result.BuildIndex();
   *success = true;
   return result;
 }
 
+namespace {
+/* Record kinds of the compact form, ORed with COMPACT_UUID_128 when the UUID
+ * of the record is stored on 128 bits */
+enum : uint8_t {
+  COMPACT_PRIMARY_SERVICE = 0,
+  COMPACT_SECONDARY_SERVICE,
+  COMPACT_INCLUDE,
+  COMPACT_CHARACTERISTIC,
+  COMPACT_EXTENDED_PROPERTIES,
+  COMPACT_DESCRIPTOR,
+};
+constexpr uint8_t COMPACT_UUID_128 = 0x80;
+
+uint8_t CompactKind(uint8_t kind, const Uuid& uuid) {
+  return UuidSize(uuid) == Uuid::kNumBytes16 ? kind : kind | COMPACT_UUID_128;
+}
+
+void UuidToCompact(std::vector<uint8_t>& out, const Uuid& uuid) {
+  if (UuidSize(uuid) == Uuid::kNumBytes16) {
+    uint16_t value = uuid.As16Bit();
+    out.push_back(value & 0xff);
+    out.push_back(value >> 8);
+  } else {
+    Uuid::UUID128Bit value = uuid.To128BitLE();
+    out.insert(out.end(), value.begin(), value.end());
+  }
+}
+
+void Uint16ToCompact(std::vector<uint8_t>& out, uint16_t value) {
+  out.push_back(value & 0xff);
+  out.push_back(value >> 8);
+}
+
+/* Reads from the compact form, failing once past its end */
+class CompactReader {
+ public:
+  CompactReader(const uint8_t* data, size_t len)
+      : p_(data), end_(data + len) {}
+
+  bool AtEnd() const { return p_ == end_; }
+
+  bool ReadUint8(uint8_t* value) {
+    if (end_ - p_ < 1) return false;
+    *value = *p_++;
+    return true;
+  }
+
+  bool ReadUint16(uint16_t* value) {
+    if (end_ - p_ < 2) return false;
+    STREAM_TO_UINT16(*value, p_);
+    return true;
+  }
+
+  bool ReadUuid(bool is_128, Uuid* uuid) {
+    if (!is_128) {
+      uint16_t value;
+      if (!ReadUint16(&value)) return false;
+      *uuid = Uuid::From16Bit(value);
+      return true;
+    }
+    if (end_ - p_ < (ptrdiff_t)Uuid::kNumBytes128) return false;
+    *uuid = Uuid::From128BitLE(p_);
+    p_ += Uuid::kNumBytes128;
+    return true;
+  }
+
+ private:
+  const uint8_t* p_;
+  const uint8_t* end_;
+};
+}  // namespace
+
+std::vector<uint8_t> Database::SerializeCompact() const {
+  std::vector<uint8_t> out;
+
+  for (const StoredAttribute& attr : Serialize()) {
+    if (attr.type == PRIMARY_SERVICE || attr.type == SECONDARY_SERVICE) {
+      const Uuid& uuid = attr.value.service.uuid;
+      out.push_back(CompactKind(attr.type == PRIMARY_SERVICE
+                                    ? COMPACT_PRIMARY_SERVICE
+                                    : COMPACT_SECONDARY_SERVICE,
+                                uuid));
+      Uint16ToCompact(out, attr.handle);
+      Uint16ToCompact(out, attr.value.service.end_handle);
+      UuidToCompact(out, uuid);
+    } else if (attr.type == INCLUDE) {
+      const Uuid& uuid = attr.value.included_service.uuid;
+      out.push_back(CompactKind(COMPACT_INCLUDE, uuid));
+      Uint16ToCompact(out, attr.handle);
+      Uint16ToCompact(out, attr.value.included_service.handle);
+      Uint16ToCompact(out, attr.value.included_service.end_handle);
+      UuidToCompact(out, uuid);
+    } else if (attr.type == CHARACTERISTIC) {
+      const Uuid& uuid = attr.value.characteristic.uuid;
+      out.push_back(CompactKind(COMPACT_CHARACTERISTIC, uuid));
+      Uint16ToCompact(out, attr.handle);
+      out.push_back(attr.value.characteristic.properties);
+      Uint16ToCompact(out, attr.value.characteristic.value_handle);
+      UuidToCompact(out, uuid);
+    } else if (attr.type == CHARACTERISTIC_EXTENDED_PROPERTIES) {
+      out.push_back(COMPACT_EXTENDED_PROPERTIES);
+      Uint16ToCompact(out, attr.handle);
+      Uint16ToCompact(out, attr.value.characteristic_extended_properties);
+    } else {
+      out.push_back(CompactKind(COMPACT_DESCRIPTOR, attr.type));
+      Uint16ToCompact(out, attr.handle);
+      UuidToCompact(out, attr.type);
+    }
+  }
+
+  return out;
+}
+
+Database Database::DeserializeCompact(const uint8_t* data, size_t len,
+                                      bool* success) {
+  std::vector<StoredAttribute> nv_attr;
+  CompactReader reader(data, len);
+
+  while (!reader.AtEnd()) {
+    uint8_t kind = 0;
+    StoredAttribute attr = {};
+    bool ok = reader.ReadUint8(&kind) && reader.ReadUint16(&attr.handle);
+    bool is_128 = kind & COMPACT_UUID_128;
+
+    switch (ok ? kind & ~COMPACT_UUID_128 : 0xff) {
+      case COMPACT_PRIMARY_SERVICE:
+      case COMPACT_SECONDARY_SERVICE:
+        attr.type = (kind & ~COMPACT_UUID_128) == COMPACT_PRIMARY_SERVICE
+                        ? PRIMARY_SERVICE
+                        : SECONDARY_SERVICE;
+        ok = reader.ReadUint16(&attr.value.service.end_handle) &&
+             reader.ReadUuid(is_128, &attr.value.service.uuid);
+        break;
+      case COMPACT_INCLUDE:
+        attr.type = INCLUDE;
+        ok = reader.ReadUint16(&attr.value.included_service.handle) &&
+             reader.ReadUint16(&attr.value.included_service.end_handle) &&
+             reader.ReadUuid(is_128, &attr.value.included_service.uuid);
+        break;
+      case COMPACT_CHARACTERISTIC:
+        attr.type = CHARACTERISTIC;
+        ok = reader.ReadUint8(&attr.value.characteristic.properties) &&
+             reader.ReadUint16(&attr.value.characteristic.value_handle) &&
+             reader.ReadUuid(is_128, &attr.value.characteristic.uuid);
+        break;
+      case COMPACT_EXTENDED_PROPERTIES:
+        attr.type = CHARACTERISTIC_EXTENDED_PROPERTIES;
+        ok = reader.ReadUint16(&attr.value.characteristic_extended_properties);
+        break;
+      case COMPACT_DESCRIPTOR:
+        ok = reader.ReadUuid(is_128, &attr.type);
+        break;
+      default:
+        ok = false;
+        break;
+    }
+
+    if (!ok) {
+      LOG(ERROR) << __func__ << ": malformed attribute, index: "
+                 << nv_attr.size();
+      *success = false;
+      return Database();
+    }
+    nv_attr.push_back(attr);
+  }
+
+  return Deserialize(nv_attr, success);
+}
+
 Octet16 Database::Hash() const {
   int len = 0;
   // Compute how much space we need to actually hold the data.
@@ -102,16 +102,48 @@ class DatabaseBuilder;
 
 class Database {
  public:
+  Database() = default;
+  /* The lookup indices point into the services, copies rebuild them */
+  Database(const Database& other) : services(other.services) { BuildIndex(); }
+  Database& operator=(const Database& other) {
+    services = other.services;
+    BuildIndex();
+    return *this;
+  }
+  Database(Database&&) = default;
+  Database& operator=(Database&&) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::vector<const Service*>().swap(service_index);
+    std::vector<HandleEntry>().swap(handle_index);
+    std::vector<std::pair<bluetooth::Uuid, const Service*>>().swap(uuid_index);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
 
+  /* Return the service containing handle, or nullptr */
+  const Service* FindService(uint16_t handle) const;
+
+  /* Return the characteristic with this value handle, or nullptr */
+  const Characteristic* FindCharacteristic(uint16_t value_handle) const;
+
+  /* Return the descriptor with this handle, or nullptr */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return the characteristic owning the descriptor with this handle, or
+   * nullptr */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
+  /* Return the services with this UUID, in handle order */
+  std::vector<const Service*> FindServices(const bluetooth::Uuid& uuid) const;
+
   std::string ToString() const;
 
   std::vector<gatt::StoredAttribute> Serialize() const;
@@ -119,13 +151,41 @@ class Database {
   static Database Deserialize(const std::vector<gatt::StoredAttribute>& nv_attr,
                               bool* success);
 
+  /* Compact binary form of Serialize(), used for the cache files: a few bytes
+   * per attribute, with 16 bit UUIDs stored as such */
+  std::vector<uint8_t> SerializeCompact() const;
+
+  static Database DeserializeCompact(const uint8_t* data, size_t len,
+                                     bool* success);
+
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
   friend class DatabaseBuilder;
 
  private:
+  /* A characteristic value or descriptor handle, with the attributes it
+   * belongs to */
+  struct HandleEntry {
+    uint16_t handle;
+    const Service* service;
+    const Characteristic* characteristic;
+    /* nullptr for a characteristic value handle */
+    const Descriptor* descriptor;
+  };
+
+  /* Rebuild the lookup indices below from the services */
+  void BuildIndex();
+
+  const HandleEntry* FindHandle(uint16_t handle) const;
+
   std::list<Service> services;
+
+  /* Flat, sorted views of the services, so that the lookups done on every
+   * notification are binary searches instead of walks over the services */
+  std::vector<const Service*> service_index;
+  std::vector<HandleEntry> handle_index;
+  std::vector<std::pair<bluetooth::Uuid, const Service*>> uuid_index;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
@@ -162,14 +162,63 @@ DatabaseBuilder::CurrentlyExploredService() {
 }
 
 std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
-  Service* service = FindService(database.services, pending_service.first);
+  return NextDescriptorRange(pending_service.first, &pending_characteristic);
+}
+
+bool DatabaseBuilder::StartServiceExploration(
+    std::pair<uint16_t, uint16_t>* service) {
+  while (!services_to_discover.empty()) {
+    auto handle_range = services_to_discover.begin();
+    *service = *handle_range;
+    services_to_discover.erase(handle_range);
+
+    // Empty service declaration, nothing to explore, skip to next.
+    if (service->first == service->second) continue;
+
+    explored_services[service->first] = ExploredService{
+        .end_handle = service->second,
+        .pending_characteristic = HANDLE_MIN,
+    };
+    return true;
+  }
+  return false;
+}
+
+bool DatabaseBuilder::FindExploredService(
+    uint16_t handle, std::pair<uint16_t, uint16_t>* service) const {
+  auto it = explored_services.upper_bound(handle);
+  if (it == explored_services.begin()) return false;
+
+  it = std::prev(it);
+  if (handle > it->second.end_handle) return false;
+
+  *service = {it->first, it->second.end_handle};
+  return true;
+}
+
+std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore(
+    uint16_t service_handle) {
+  auto it = explored_services.find(service_handle);
+  if (it == explored_services.end()) return EXPLORE_END;
+
+  return NextDescriptorRange(service_handle,
+                             &it->second.pending_characteristic);
+}
+
+void DatabaseBuilder::FinishServiceExploration(uint16_t service_handle) {
+  explored_services.erase(service_handle);
+}
+
+std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRange(
+    uint16_t service_handle, uint16_t* pending_characteristic) {
+  Service* service = FindService(database.services, service_handle);
   if (!service || service->characteristics.empty()) {
     return {HANDLE_MAX, HANDLE_MAX};
   }
 
   for (auto it = service->characteristics.cbegin();
        it != service->characteristics.cend(); it++) {
-    if (it->declaration_handle > pending_characteristic) {
+    if (it->declaration_handle > *pending_characteristic) {
       auto next = std::next(it);
 
       /* Characteristic Declaration is followed by Characteristic Value
@@ -185,12 +234,12 @@ std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
       // No place for descriptor - skip to next characteristic
       if (start > end) continue;
 
-      pending_characteristic = start;
+      *pending_characteristic = start;
       return {start, end};
     }
   }
 
-  pending_characteristic = HANDLE_MAX;
+  *pending_characteristic = HANDLE_MAX;
   return {HANDLE_MAX, HANDLE_MAX};
 }
 
@@ -247,7 +296,10 @@ Database DatabaseBuilder::Build() {
   return tmp;
 }
 
-void DatabaseBuilder::Clear() { database.Clear(); }
+void DatabaseBuilder::Clear() {
+  database.Clear();
+  explored_services.clear();
+}
 
 std::string DatabaseBuilder::ToString() const { return database.ToString(); }
 
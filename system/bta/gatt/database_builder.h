@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <map>
 #include <utility>
 
 #include "bta/gatt/database.h"
@@ -51,6 +52,26 @@ class DatabaseBuilder {
    */
   std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore();
 
+  /* Services can also be explored in parallel, each of them from the start of
+   * its exploration to its end. Returns true and the start and end handle of
+   * the next service to explore, false if there are no more services to
+   * explore. */
+  bool StartServiceExploration(std::pair<uint16_t, uint16_t>* service);
+
+  /* Find the explored service containing handle. Returns false if there is no
+   * such service. */
+  bool FindExploredService(uint16_t handle,
+                           std::pair<uint16_t, uint16_t>* service) const;
+
+  /* Same as above for an explored service, identified by its start handle */
+  std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore(
+      uint16_t service_handle);
+
+  void FinishServiceExploration(uint16_t service_handle);
+
+  /* Return the number of services being explored */
+  size_t NumServicesBeingExplored() const { return explored_services.size(); }
+
   /* Return vector of "Characteristic Extended Properties" descriptors that must
    * be read as part of service discovery process */
   std::vector<uint16_t> DescriptorHandlesToRead() {
@@ -87,6 +108,18 @@ class DatabaseBuilder {
   /* Characteristic inside pending_service that is currently being explored */
   uint16_t pending_characteristic;
 
+  struct ExploredService {
+    uint16_t end_handle;
+    /* Characteristic inside the service that is currently being explored */
+    uint16_t pending_characteristic;
+  };
+
+  /* services being explored, by start handle */
+  std::map<uint16_t, ExploredService> explored_services;
+
+  std::pair<uint16_t, uint16_t> NextDescriptorRange(
+      uint16_t service_handle, uint16_t* pending_characteristic);
+
   /* sorted, unique set of start_handle, end_handle pair of all services that
    * have not yet been discovered */
   std::set<std::pair<uint16_t, uint16_t>> services_to_discover;
@@ -1008,11 +1008,24 @@ class HasClientImpl : public HasClient {
         btif_storage_add_leaudio_has_device(device.addr, presets_bin,
                                             device.GetFeatures(),
                                             device.currently_active_preset);
+        device.stored_presets_bin = std::move(presets_bin);
       }
       NotifyHasDeviceValid(device);
     }
   }
 
+  /* Writes the presets of |device| to the storage, unless they are the same
+   * as the stored ones. Notifications often leave the presets as they were,
+   * e.g. when a bonded server resends its changes on reconnection. */
+  void StorePresets(HasDevice& device) {
+    std::vector<uint8_t> presets_bin;
+    if (!device.SerializePresets(presets_bin)) return;
+    if (presets_bin == device.stored_presets_bin) return;
+
+    btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
+    device.stored_presets_bin = std::move(presets_bin);
+  }
+
   void OnGattWriteCcc(uint16_t conn_id, tGATT_STATUS status, uint16_t handle,
                       void* user_data) {
     DLOG(INFO) << __func__ << ": handle=" << loghex(handle);
@@ -1122,9 +1135,10 @@ class HasClientImpl : public HasClient {
     /* Store features value */
     uint8_t features;
     STREAM_TO_UINT8(features, value);
+    bool features_changed = (features != device->GetFeatures());
     device->UpdateFeatures(features);
 
-    if (device->isGattServiceValid()) {
+    if (device->isGattServiceValid() && features_changed) {
       btif_storage_set_leaudio_has_features(device->addr, features);
     }
 
@@ -1267,10 +1281,7 @@ class HasClientImpl : public HasClient {
 
     if (device.isGattServiceValid()) {
       /* Update preset values in the storage */
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
+      StorePresets(device);
 
       /* Check for the matching coordinated group op. to use group callbacks */
       for (auto it = pending_group_operation_timeouts_.rbegin();
@@ -1365,12 +1376,7 @@ class HasClientImpl : public HasClient {
     }
 
     /* Update preset storage */
-    if (device.isGattServiceValid()) {
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
-    }
+    if (device.isGattServiceValid()) StorePresets(device);
 
     callbacks_->OnPresetInfo(
         device.addr, PresetInfoReason::PRESET_AVAILABILITY_CHANGED, infos);
@@ -1405,12 +1411,7 @@ class HasClientImpl : public HasClient {
     }
 
     /* Update preset storage */
-    if (device.isGattServiceValid()) {
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
-    }
+    if (device.isGattServiceValid()) StorePresets(device);
 
     if (is_deleted)
       callbacks_->OnPresetInfo(device.addr, PresetInfoReason::PRESET_DELETED,
@@ -1501,9 +1502,11 @@ class HasClientImpl : public HasClient {
 
     /* Get the active preset value */
     auto* pp = value;
+    uint8_t prev_active_preset = device->currently_active_preset;
     STREAM_TO_UINT8(device->currently_active_preset, pp);
 
-    if (device->isGattServiceValid()) {
+    if (device->isGattServiceValid() &&
+        device->currently_active_preset != prev_active_preset) {
       btif_storage_set_leaudio_has_active_preset(
           device->addr, device->currently_active_preset);
     }
@@ -1678,6 +1681,7 @@ class HasClientImpl : public HasClient {
 
     VLOG(1) << "Loading HAS service details from storage.";
 
+    device->stored_presets_bin = std::move(presets_bin);
     device->currently_active_preset = active_preset;
 
     /* Update features and refresh opcode support map */
@@ -2281,6 +2281,52 @@ TEST_F(HasClientTest, test_presets_changed_unavailable) {
   ASSERT_FALSE(changed_preset_details[0].available);
 }
 
+TEST_F(HasClientTest, test_presets_unchanged_not_stored) {
+  const RawAddress test_address = GetTestAddress(1);
+  uint16_t test_conn_id = GetTestConnId(test_address);
+
+  std::set<HasPreset, HasPreset::ComparatorDesc> presets = {{
+      HasPreset(1, HasPreset::kPropertyAvailable, "Universal"),
+      HasPreset(2, HasPreset::kPropertyAvailable | HasPreset::kPropertyWritable,
+                "Preset2"),
+  }};
+  SetSampleDatabaseHasPresetsNtf(
+      test_address,
+      bluetooth::has::kFeatureBitHearingAidTypeBanded |
+          bluetooth::has::kFeatureBitWritablePresets |
+          bluetooth::has::kFeatureBitDynamicPresets,
+      presets);
+
+  std::vector<PresetInfo> preset_details;
+  EXPECT_CALL(*callbacks,
+              OnConnectionState(ConnectionState::CONNECTED, test_address));
+  EXPECT_CALL(*callbacks,
+              OnPresetInfo(std::variant<RawAddress, int>(test_address),
+                           PresetInfoReason::ALL_PRESET_INFO, _))
+      .WillOnce(SaveArg<2>(&preset_details));
+  TestConnect(test_address);
+  ASSERT_EQ(2u, preset_details.size());
+
+  /* The change is stored */
+  auto changed_index = preset_details[0].preset_index;
+  EXPECT_CALL(btif_storage_interface_, SetLeaudioHasPresets(test_address, _))
+      .Times(1);
+  InjectPresetChanged(test_conn_id, test_address, false,
+                      *presets.find(changed_index), 0 /* prev_index */,
+                      ::le_audio::has::PresetCtpChangeId::PRESET_UNAVAILABLE,
+                      true /* is_last */);
+  Mock::VerifyAndClearExpectations(&btif_storage_interface_);
+
+  /* The same notification again leaves the storage as it is */
+  EXPECT_CALL(btif_storage_interface_, SetLeaudioHasPresets(test_address, _))
+      .Times(0);
+  InjectPresetChanged(test_conn_id, test_address, false,
+                      *presets.find(changed_index), 0 /* prev_index */,
+                      ::le_audio::has::PresetCtpChangeId::PRESET_UNAVAILABLE,
+                      true /* is_last */);
+  Mock::VerifyAndClearExpectations(&btif_storage_interface_);
+}
+
 TEST_F(HasClientTest, test_select_preset_valid) {
   const RawAddress test_address = GetTestAddress(1);
   SetSampleDatabaseHasPresetsNtf(test_address);
@@ -180,6 +180,9 @@ class HasDevice : public GattServiceDevice {
   std::set<HasPreset, HasPreset::ComparatorDesc> has_presets;
   uint8_t currently_active_preset = bluetooth::has::kHasPresetIndexInvalid;
 
+  /* Presets as last written to or read from the storage */
+  std::vector<uint8_t> stored_presets_bin;
+
   std::list<HasCtpNtf> ctp_notifications_;
   HasJournal has_journal_;
 
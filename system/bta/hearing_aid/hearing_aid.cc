@@ -394,11 +394,12 @@ class HearingAidImpl : public HearingAid {
     }
 
     LOG_INFO(
-        "L2CA_UpdateBleConnParams for device %s min_ce_len:%u "
+        "L2CA_RequestBleConnParams for device %s min_ce_len:%u "
         "max_ce_len:%u",
         ADDRESS_TO_LOGGABLE_CSTR(address), min_ce_len, max_ce_len);
-    L2CA_UpdateBleConnParams(address, connection_interval, connection_interval,
-                             0x000A, 0x0064 /*1s*/, min_ce_len, max_ce_len);
+    L2CA_RequestBleConnParams(address, L2CA_BLE_WORKLOAD_AUDIO,
+                              connection_interval, connection_interval, 0x000A,
+                              0x0064 /*1s*/, min_ce_len, max_ce_len);
     return connection_interval;
   }
 
@@ -1400,15 +1401,30 @@ class HearingAidImpl : public HearingAid {
     // reallocations
     // TODO: this should basically fit the encoded data, tune the size later
     std::vector<uint8_t> encoded_data_left;
+    std::vector<uint8_t> encoded_data_right;
     auto time_point = std::chrono::steady_clock::now();
-    if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
+    if (left && right) {
+      // Encode both sides of the binaural stream in a single pass
       encoded_data_left.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_left, encoded_data_left.data(),
-                      (const int16_t*)chan_left.data(), chan_left.size());
+      encoded_data_right.resize(4000);
+      int encoded_size = g722_encode_stereo(
+          encoder_state_left, encoder_state_right, encoded_data_left.data(),
+          encoded_data_right.data(), (const int16_t*)chan_left.data(),
+          (const int16_t*)chan_right.data(), chan_left.size());
       encoded_data_left.resize(encoded_size);
+      encoded_data_right.resize(encoded_size);
+    }
+
+    if (left) {
+      if (!right) {
+        // TODO: instead of a magic number, we need to figure out the correct
+        // buffer size
+        encoded_data_left.resize(4000);
+        int encoded_size =
+            g722_encode(encoder_state_left, encoded_data_left.data(),
+                        (const int16_t*)chan_left.data(), chan_left.size());
+        encoded_data_left.resize(encoded_size);
+      }
 
       uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
@@ -1434,15 +1450,16 @@ class HearingAidImpl : public HearingAid {
       check_and_do_rssi_read(left);
     }
 
-    std::vector<uint8_t> encoded_data_right;
     if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
-      int encoded_size =
-          g722_encode(encoder_state_right, encoded_data_right.data(),
-                      (const int16_t*)chan_right.data(), chan_right.size());
-      encoded_data_right.resize(encoded_size);
+      if (!left) {
+        // TODO: instead of a magic number, we need to figure out the correct
+        // buffer size
+        encoded_data_right.resize(4000);
+        int encoded_size =
+            g722_encode(encoder_state_right, encoded_data_right.data(),
+                        (const int16_t*)chan_right.data(), chan_right.size());
+        encoded_data_right.resize(encoded_size);
+      }
 
       uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
       uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
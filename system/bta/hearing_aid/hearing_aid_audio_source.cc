@@ -19,6 +19,7 @@
 #include <base/files/file_util.h>
 #include <base/logging.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <sstream>
@@ -33,10 +34,13 @@
 #include "osi/include/wakelock.h"
 #include "stack/include/btu.h"  // get_main_thread
 #include "udrv/include/uipc.h"
+#include "udrv/include/uipc_shm.h"
 
 using base::FilePath;
 
 namespace {
+constexpr char kWakelockOwner[] = "hearing_aid_source";
+
 #define CASE_RETURN_STR(const) \
   case const:                  \
     return #const;
@@ -52,6 +56,7 @@ const char* audio_ha_hw_dump_ctrl_event(tHEARING_AID_CTRL_CMD event) {
     CASE_RETURN_STR(HEARING_AID_CTRL_GET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_SET_OUTPUT_AUDIO_CONFIG)
     CASE_RETURN_STR(HEARING_AID_CTRL_CMD_OFFLOAD_START)
+    CASE_RETURN_STR(HEARING_AID_CTRL_GET_AUDIO_SHM)
     default:
       break;
   }
@@ -67,6 +72,15 @@ bluetooth::common::RepeatingTimer audio_timer;
 HearingAidAudioReceiver* localAudioReceiver = nullptr;
 std::unique_ptr<tUIPC_STATE> uipc_hearing_aid = nullptr;
 
+/* Largest audio buffer the audio HAL may request for the shared memory ring */
+constexpr uint32_t kAudioShmMaxSize = 64 * 1024;
+
+/* Ring carrying the audio data instead of the data socket, once handed to the
+ * audio HAL. It is kept until cleanup, as the main thread may be reading it
+ * when the audio HAL goes away. */
+uipc_shm_t* audio_shm = nullptr;
+std::atomic<bool> audio_shm_attached(false);
+
 struct AudioHalStats {
   size_t media_read_total_underflow_bytes;
   size_t media_read_total_underflow_count;
@@ -86,15 +100,26 @@ AudioHalStats stats;
 bool hearing_aid_on_resume_req(bool start_media_task);
 bool hearing_aid_on_suspend_req();
 
+// Number of bytes of audio data sent to the hearing aids at each connection
+// interval.
+uint32_t get_bytes_per_tick() {
+  return (num_channels * sample_rate * data_interval_ms * (bit_rate / 8)) /
+         1000;
+}
+
 void send_audio_data() {
-  uint32_t bytes_per_tick =
-      (num_channels * sample_rate * data_interval_ms * (bit_rate / 8)) / 1000;
+  uint32_t bytes_per_tick = get_bytes_per_tick();
 
   uint8_t p_buf[bytes_per_tick];
 
   uint32_t bytes_read;
   if (bluetooth::audio::hearing_aid::is_hal_enabled()) {
     bytes_read = bluetooth::audio::hearing_aid::read(p_buf, bytes_per_tick);
+  } else if (audio_shm_attached) {
+    // The audio HAL writes to shared memory, no system call nor copy through
+    // the kernel. The audio HAL is only woken up from here, once per
+    // connection interval, when it waits for room.
+    bytes_read = uipc_shm_read(audio_shm, p_buf, bytes_per_tick);
   } else {
     bytes_read = UIPC_Read(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO, p_buf,
                            bytes_per_tick);
@@ -127,7 +152,7 @@ void start_audio_ticks() {
     LOG_ALWAYS_FATAL("Unsupported data interval: %d", data_interval_ms);
   }
 
-  wakelock_acquire();
+  wakelock_acquire(kWakelockOwner);
   audio_timer.SchedulePeriodic(
       get_main_thread()->GetWeakPtr(), FROM_HERE, base::Bind(&send_audio_data),
 #if BASE_VER < 931007
@@ -141,7 +166,7 @@ void start_audio_ticks() {
 void stop_audio_ticks() {
   LOG_INFO("stopped");
   audio_timer.CancelAndWait();
-  wakelock_release();
+  wakelock_release(kWakelockOwner);
 }
 
 void hearing_aid_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
@@ -162,6 +187,7 @@ void hearing_aid_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
       break;
     case UIPC_CLOSE_EVT:
       LOG_INFO("UIPC_CLOSE_EVT");
+      audio_shm_attached = false;
       hearing_aid_send_ack(HEARING_AID_CTRL_ACK_SUCCESS);
       do_in_main_thread(FROM_HERE, base::BindOnce(stop_audio_ticks));
       break;
@@ -170,6 +196,54 @@ void hearing_aid_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
   }
 }
 
+void hearing_aid_on_get_audio_shm() {
+  uint32_t buffer_size = 0;
+
+  hearing_aid_send_ack(HEARING_AID_CTRL_ACK_SUCCESS);
+  if (UIPC_Read(*uipc_hearing_aid, UIPC_CH_ID_AV_CTRL,
+                reinterpret_cast<uint8_t*>(&buffer_size),
+                sizeof(buffer_size)) != sizeof(buffer_size)) {
+    LOG_ERROR("Error reading buffer size from audio HAL");
+    return;
+  }
+
+  uint8_t status = HEARING_AID_CTRL_ACK_FAILURE;
+  if (buffer_size == 0 || buffer_size > kAudioShmMaxSize) {
+    LOG_ERROR("Invalid buffer size %u", buffer_size);
+  } else {
+    /* Created once with the largest size, the limit sets the buffering */
+    if (audio_shm == nullptr) {
+      audio_shm = uipc_shm_new(kAudioShmMaxSize);
+    }
+    if (audio_shm != nullptr) {
+      /* Buffer whole connection intervals, so that the room freed by each
+       * tick is what the audio HAL waits for */
+      uint32_t bytes_per_tick = data_interval_ms > 0 ? get_bytes_per_tick() : 0;
+      uint32_t limit = buffer_size;
+      if (bytes_per_tick > 0 && limit % bytes_per_tick != 0) {
+        limit += bytes_per_tick - limit % bytes_per_tick;
+      }
+      uipc_shm_set_limit(audio_shm, limit);
+      uipc_shm_flush(audio_shm);
+      status = HEARING_AID_CTRL_ACK_SUCCESS;
+    }
+  }
+
+  if (status != HEARING_AID_CTRL_ACK_SUCCESS) {
+    UIPC_Send(*uipc_hearing_aid, UIPC_CH_ID_AV_CTRL, 0, &status,
+              sizeof(status));
+    return;
+  }
+
+  int fds[] = {uipc_shm_get_memory_fd(audio_shm),
+               uipc_shm_get_event_fd(audio_shm)};
+  if (UIPC_SendFds(*uipc_hearing_aid, UIPC_CH_ID_AV_CTRL, &status,
+                   sizeof(status), fds, 2)) {
+    LOG_DEBUG("audio data over shared memory, buffer size %u", buffer_size);
+    audio_shm_attached = true;
+  }
+}
+
 void hearing_aid_recv_ctrl_data() {
   tHEARING_AID_CTRL_CMD cmd = HEARING_AID_CTRL_CMD_NONE;
   int n;
@@ -309,6 +383,10 @@ void hearing_aid_recv_ctrl_data() {
       break;
     }
 
+    case HEARING_AID_CTRL_GET_AUDIO_SHM:
+      hearing_aid_on_get_audio_shm();
+      break;
+
     default:
       LOG_ERROR("UNSUPPORTED CMD: %u", cmd);
       hearing_aid_send_ack(HEARING_AID_CTRL_ACK_FAILURE);
@@ -323,6 +401,8 @@ void hearing_aid_ctrl_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
     case UIPC_OPEN_EVT:
       break;
     case UIPC_CLOSE_EVT:
+      /* The audio HAL went away, the ring is handed again on reconnection */
+      audio_shm_attached = false;
       /* restart ctrl server unless we are shutting down */
       if (HearingAid::IsHearingAidRunning()) {
         UIPC_Open(*uipc_hearing_aid, UIPC_CH_ID_AV_CTRL, hearing_aid_ctrl_cb,
@@ -428,6 +508,9 @@ void HearingAidAudioSource::CleanUp() {
   } else {
     UIPC_Close(*uipc_hearing_aid, UIPC_CH_ID_ALL);
     uipc_hearing_aid = nullptr;
+    audio_shm_attached = false;
+    uipc_shm_free(audio_shm);
+    audio_shm = nullptr;
   }
 }
 
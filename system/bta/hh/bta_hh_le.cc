@@ -344,6 +344,30 @@ static tBTA_HH_LE_RPT* bta_hh_le_find_report_entry(
   return NULL;
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_find_input_rpt_by_handle
+ *
+ * Description      find the HID input report entry of a characteristic value
+ *                  handle, the handles are unique on the remote device.
+ *
+ * Returns          pointer to the report entry, NULL if not found
+ *
+ ******************************************************************************/
+static tBTA_HH_LE_RPT* bta_hh_le_find_input_rpt_by_handle(tBTA_HH_DEV_CB* p_cb,
+                                                          uint16_t handle) {
+  tBTA_HH_LE_RPT* p_rpt = &p_cb->hid_srvc.report[0];
+
+  for (uint8_t i = 0; i < BTA_HH_LE_RPT_MAX; i++, p_rpt++) {
+    if (p_rpt->in_use && p_rpt->char_inst_id == handle &&
+        p_rpt->rpt_type == BTA_HH_RPTT_INPUT &&
+        p_rpt->uuid != GATT_UUID_BATTERY_LEVEL) {
+      return p_rpt;
+    }
+  }
+  return NULL;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_le_find_rpt_by_idtype
@@ -1368,8 +1392,8 @@ static void read_pref_conn_params_cb(uint16_t conn_id, tGATT_STATUS status,
 
   BTM_BleSetPrefConnParams(p_dev_cb->addr, min_interval, max_interval, latency,
                            timeout);
-  L2CA_UpdateBleConnParams(p_dev_cb->addr, min_interval, max_interval, latency,
-                           timeout, 0, 0);
+  L2CA_RequestBleConnParams(p_dev_cb->addr, L2CA_BLE_WORKLOAD_HID,
+                            min_interval, max_interval, latency, timeout, 0, 0);
 }
 
 /*******************************************************************************
@@ -1560,40 +1584,50 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
     return;
   }
 
-  const gatt::Characteristic* p_char =
-      BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
-  if (p_char == NULL) {
-    APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Characteristic, conn_id: "
-        "0x%04x, handle: 0x%04x",
-        __func__, p_dev_cb->conn_id, p_data->handle);
-    return;
-  }
-
   app_id = p_dev_cb->app_id;
 
-  const gatt::Service* p_svc =
-      BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
-
-  p_rpt = bta_hh_le_find_report_entry(
-      p_dev_cb, p_svc->handle, p_char->uuid.As16Bit(), p_char->value_handle);
+  /* The input reports are found from their value handle, without looking up
+   * the characteristic and its service in the GATT database on every report */
+  p_rpt = bta_hh_le_find_input_rpt_by_handle(p_dev_cb, p_data->handle);
   if (p_rpt == NULL) {
-    APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Report, uuid: %s, handle: "
-        "0x%04x",
-        __func__, p_char->uuid.ToString().c_str(), p_char->value_handle);
-    return;
+    const gatt::Characteristic* p_char =
+        BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
+    if (p_char == NULL) {
+      APPL_TRACE_ERROR(
+          "%s: notification received for Unknown Characteristic, conn_id: "
+          "0x%04x, handle: 0x%04x",
+          __func__, p_dev_cb->conn_id, p_data->handle);
+      return;
+    }
+
+    const gatt::Service* p_svc =
+        BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
+
+    p_rpt = bta_hh_le_find_report_entry(
+        p_dev_cb, p_svc->handle, p_char->uuid.As16Bit(), p_char->value_handle);
+    if (p_rpt == NULL) {
+      APPL_TRACE_ERROR(
+          "%s: notification received for Unknown Report, uuid: %s, handle: "
+          "0x%04x",
+          __func__, p_char->uuid.ToString().c_str(), p_char->value_handle);
+      return;
+    }
   }
 
-  if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_MOUSE_INPUT))
+  if (p_rpt->uuid == GATT_UUID_HID_BT_MOUSE_INPUT)
     app_id = BTA_HH_APP_ID_MI;
-  else if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_KB_INPUT))
+  else if (p_rpt->uuid == GATT_UUID_HID_BT_KB_INPUT)
     app_id = BTA_HH_APP_ID_KB;
 
   APPL_TRACE_DEBUG("Notification received on report ID: %d", p_rpt->rpt_id);
 
-  /* need to append report ID to the head of data */
-  if (p_rpt->rpt_id != 0) {
+  /* need to append report ID to the head of data, in place when it fits */
+  if (p_rpt->rpt_id != 0 && p_data->len < GATT_MAX_ATTR_LEN) {
+    memmove(&p_data->value[1], p_data->value, p_data->len);
+    p_data->value[0] = p_rpt->rpt_id;
+    ++p_data->len;
+    p_buf = p_data->value;
+  } else if (p_rpt->rpt_id != 0) {
     p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
 
     p_buf[0] = p_rpt->rpt_id;
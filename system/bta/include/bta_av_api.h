@@ -686,6 +686,18 @@ void BTA_AvMetaCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CMD cmd_code,
  ******************************************************************************/
 void BTA_AvSetLatency(tBTA_AV_HNDL handle, bool is_low_latency);
 
+/*******************************************************************************
+ *
+ * Function         BTA_AvRemoveDevice
+ *
+ * Description      Forget the stream endpoint capabilities saved for a peer,
+ *                  so that the next connection gets them from the peer.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTA_AvRemoveDevice(const RawAddress& bd_addr);
+
 /*******************************************************************************
  *
  * Function         BTA_AvOffloadStart
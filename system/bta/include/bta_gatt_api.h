@@ -615,6 +615,9 @@ void BTA_GATTC_GetGattDb(uint16_t conn_id, uint16_t start_handle,
 typedef void (*GATT_READ_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                 uint16_t handle, uint16_t len, uint8_t* value,
                                 void* data);
+typedef void (*GATT_READ_MULTI_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
+                                      tBTA_GATTC_MULTI& handles, uint16_t len,
+                                      uint8_t* value, void* data);
 typedef void (*GATT_WRITE_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                  uint16_t handle, uint16_t len,
                                  const uint8_t* value, void* data);
@@ -793,12 +796,17 @@ void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - read multiple parameters.
+ *                    variable_len - use Read Multiple Variable Length, the
+ *                                   value is then a list of length (2 octets)
+ *                                   and value tuples.
+ *                    callback - called with the values read.
  *
  * Returns          None
  *
  ******************************************************************************/
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req);
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data);
 
 /*******************************************************************************
  *
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#pragma once
+
 #include <cstdint>
 #include <list>
 #include <unordered_map>
@@ -32,6 +34,17 @@
  *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
+ *
+ * Reads queued back to back are sent together in a Read Multiple Variable
+ * Length request when the server supports it; each callback is still called
+ * with the value of its own handle.
+ *
+ * Each connection id, which belongs to a single app, keeps at most
+ * kMaxQueuedOps operations. Further reads and writes are rejected: their
+ * callback is called with GATT_BUSY from the main thread, so that the app
+ * slows down instead of delaying the other apps of the device. MTU exchanges
+ * and descriptor writes, which are short control operations, are moved ahead
+ * of the queued characteristic reads and writes of other handles.
  */
 class BtaGattQueue {
  public:
@@ -49,6 +62,9 @@ class BtaGattQueue {
                               tGATT_WRITE_TYPE write_type, GATT_WRITE_OP_CB cb,
                               void* cb_data);
   static void ConfigureMtu(uint16_t conn_id, uint16_t mtu);
+  static void DebugDump(int fd);
+
+  static constexpr size_t kMaxQueuedOps = 128;
 
   /* Holds pending GATT operations */
   struct gatt_operation {
@@ -64,17 +80,29 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* read-specific fields */
+    bool no_read_multi;
   };
 
  private:
   static void mark_as_not_executing(uint16_t conn_id);
+  static void gatt_enqueue_op(uint16_t conn_id, gatt_operation op);
+  static void gatt_reject_op(uint16_t conn_id, const gatt_operation& op);
   static void gatt_execute_next_op(uint16_t conn_id);
+  static bool gatt_execute_read_multi(uint16_t conn_id,
+                                      std::list<gatt_operation>& gatt_ops);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                     uint16_t handle, uint16_t len,
                                     uint8_t* value, void* data);
   static void gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                      uint16_t handle, uint16_t len,
                                      const uint8_t* value, void* data);
+  static void gatt_read_multi_op_finished(uint16_t conn_id,
+                                          tGATT_STATUS status,
+                                          tBTA_GATTC_MULTI& handles,
+                                          uint16_t len, uint8_t* value,
+                                          void* data);
   static void gatt_configure_mtu_op_finished(uint16_t conn_id,
                                              tGATT_STATUS status, void* data);
 
@@ -82,4 +110,14 @@ class BtaGattQueue {
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // contain connection ids whose server rejected Read Multiple Variable Length
+  static std::unordered_set<uint16_t> gatt_read_multi_unsupported;
+
+  struct gatt_queue_stats {
+    size_t max_depth;
+    size_t rejected;
+  };
+
+  // maps connection id to the statistics of its queue, shown in dumpsys
+  static std::unordered_map<uint16_t, gatt_queue_stats> gatt_op_queue_stats;
 };
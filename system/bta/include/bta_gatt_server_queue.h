@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#pragma once
+
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
@@ -21,6 +23,8 @@
 
 #include "bta_gatt_api.h"
 
+/* Each connection id keeps at most kMaxQueuedOps notifications, further ones
+ * are dropped until the queued ones are sent. */
 class BtaGattServerQueue {
  public:
   static void Clean(uint16_t conn_id);
@@ -28,6 +32,9 @@ class BtaGattServerQueue {
                                std::vector<uint8_t> value, bool need_confirm);
   static void NotificationCallback(uint16_t conn_id);
   static void CongestionCallback(uint16_t conn_id, bool congested);
+  static void DebugDump(int fd);
+
+  static constexpr size_t kMaxQueuedOps = 128;
 
   /* Holds pending GATT operations */
   struct gatts_operation {
@@ -51,4 +58,7 @@ class BtaGattServerQueue {
 
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatts_op_queue_executing;
+
+  // maps connection id to the number of notifications it dropped
+  static std::unordered_map<uint16_t, size_t> gatts_op_queue_dropped;
 };
\ No newline at end of file
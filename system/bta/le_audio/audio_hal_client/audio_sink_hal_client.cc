@@ -21,6 +21,7 @@
 #include "audio_hal_client.h"
 #include "audio_hal_interface/le_audio_software.h"
 #include "bta/le_audio/codec_manager.h"
+#include "bta/le_audio/le_audio_latency_histogram.h"
 #include "btu.h"
 #include "common/time_util.h"
 #include "osi/include/log.h"
@@ -37,6 +38,13 @@ enum {
   HAL_STARTED,
 } le_audio_source_hal_state;
 
+struct AudioHalStats {
+  /* Time spent in the HAL writes */
+  LatencyHistogram media_write_latency;
+
+  void Reset() { media_write_latency.Reset(); }
+} sStats;
+
 class SinkImpl : public LeAudioSinkAudioHalClient {
  public:
   // Interface implementation
@@ -201,6 +209,8 @@ bool SinkImpl::Start(const LeAudioCodecConfiguration& codec_configuration,
            codec_configuration.num_channels, codec_configuration.sample_rate,
            codec_configuration.data_interval_us);
 
+  sStats.Reset();
+
   LeAudioClientInterface::PcmParameters pcmParameters = {
       .data_interval_us = codec_configuration.data_interval_us,
       .sample_rate = codec_configuration.sample_rate,
@@ -246,7 +256,10 @@ size_t SinkImpl::SendData(uint8_t* data, uint16_t size) {
   }
 
   /* TODO: What to do if not all data is written ? */
+  uint64_t write_start_us = bluetooth::common::time_get_os_boottime_us();
   bytes_written = halSourceInterface_->Write(data, size);
+  sStats.media_write_latency.Add(bluetooth::common::time_get_os_boottime_us() -
+                                 write_start_us);
   if (bytes_written != size) {
     LOG_ERROR(
         "Not all data is written to source HAL. Bytes written: %zu, total: %d",
@@ -338,6 +351,10 @@ LeAudioSinkAudioHalClient::AcquireUnicast() {
 }
 
 void LeAudioSinkAudioHalClient::DebugDump(int fd) {
-  /* TODO: Add some statistic for LeAudioSink Audio HAL interface */
+  std::stringstream stream;
+  stream << "  LE AudioHalClient Sink:"
+         << "\n    Write latency                                           : "
+         << sStats.media_write_latency.ToString() << std::endl;
+  dprintf(fd, "%s", stream.str().c_str());
 }
 }  // namespace le_audio
@@ -18,9 +18,12 @@
  *
  ******************************************************************************/
 
+#include <algorithm>
+
 #include "audio_hal_client.h"
 #include "audio_hal_interface/le_audio_software.h"
 #include "bta/le_audio/codec_manager.h"
+#include "bta/le_audio/le_audio_latency_histogram.h"
 #include "btu.h"
 #include "common/time_util.h"
 #include "osi/include/log.h"
@@ -30,6 +33,8 @@ using bluetooth::audio::le_audio::LeAudioClientInterface;
 
 namespace le_audio {
 namespace {
+constexpr char kWakelockOwner[] = "le_audio_source";
+
 // TODO: HAL state should be in the HAL implementation
 enum {
   HAL_UNINITIALIZED,
@@ -41,6 +46,8 @@ struct AudioHalStats {
   size_t media_read_total_underflow_bytes;
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
+  /* Time spent in the HAL reads */
+  LatencyHistogram media_read_latency;
 
   AudioHalStats() { Reset(); }
 
@@ -48,6 +55,7 @@ struct AudioHalStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    media_read_latency.Reset();
   }
 } sStats;
 
@@ -88,6 +96,8 @@ class SourceImpl : public LeAudioSourceAudioHalClient {
   void SendAudioData();
 
   bool is_broadcaster_;
+  /* PCM of the current frame, only used on the worker thread */
+  std::vector<uint8_t> audio_data_;
 
   bluetooth::audio::le_audio::LeAudioClientInterface::Sink* halSinkInterface_ =
       nullptr;
@@ -185,19 +195,27 @@ void SourceImpl::SendAudioData() {
       (source_codec_config_.num_channels * source_codec_config_.sample_rate *
        source_codec_config_.data_interval_us / 1000 * bytes_per_sample) /
       1000;
-  std::vector<uint8_t> data(bytes_per_tick);
-
-  uint32_t bytes_read = halSinkInterface_->Read(data.data(), bytes_per_tick);
+  /* The buffer is kept between the ticks, so that it is neither allocated
+   * nor cleared for each frame */
+  audio_data_.resize(bytes_per_tick);
+
+  uint64_t read_start_us = bluetooth::common::time_get_os_boottime_us();
+  uint32_t bytes_read =
+      halSinkInterface_->Read(audio_data_.data(), bytes_per_tick);
+  sStats.media_read_latency.Add(bluetooth::common::time_get_os_boottime_us() -
+                                read_start_us);
   if (bytes_read < bytes_per_tick) {
     sStats.media_read_total_underflow_bytes += bytes_per_tick - bytes_read;
     sStats.media_read_total_underflow_count++;
     sStats.media_read_last_underflow_us =
         bluetooth::common::time_get_os_boottime_us();
+    /* Silence instead of the samples of the previous frame */
+    std::fill(audio_data_.begin() + bytes_read, audio_data_.end(), 0);
   }
 
   std::lock_guard<std::mutex> guard(audioSourceCallbacksMutex_);
   if (audioSourceCallbacks_ != nullptr) {
-    audioSourceCallbacks_->OnAudioDataReady(data);
+    audioSourceCallbacks_->OnAudioDataReady(audio_data_);
   }
 }
 
@@ -224,7 +242,7 @@ bool SourceImpl::InitAudioSinkThread() {
 }
 
 void SourceImpl::StartAudioTicks() {
-  wakelock_acquire();
+  wakelock_acquire(kWakelockOwner);
   audio_timer_.SchedulePeriodic(
       worker_thread_->GetWeakPtr(), FROM_HERE,
       base::Bind(&SourceImpl::SendAudioData, base::Unretained(this)),
@@ -237,7 +255,7 @@ void SourceImpl::StartAudioTicks() {
 
 void SourceImpl::StopAudioTicks() {
   audio_timer_.CancelAndWait();
-  wakelock_release();
+  wakelock_release(kWakelockOwner);
 }
 
 bool SourceImpl::OnSuspendReq() {
@@ -479,7 +497,8 @@ void LeAudioSourceAudioHalClient::DebugDump(int fd) {
                                         sStats.media_read_last_underflow_us) /
                        1000
                  : 0)
-         << std::endl;
+         << "\n    Read latency                                            : "
+         << sStats.media_read_latency.ToString() << std::endl;
   dprintf(fd, "%s", stream.str().c_str());
 }
 }  // namespace le_audio
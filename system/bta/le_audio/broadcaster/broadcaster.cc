@@ -17,6 +17,7 @@
 
 #include <base/functional/bind.h>
 
+#include <algorithm>
 #include <mutex>
 
 #include "bta/include/bta_le_audio_api.h"
@@ -157,11 +158,12 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
     auto const& codec_id = codec_config.GetLeAudioCodecId();
 
+    uint8_t bis_index = 1;
     for (const LeAudioLtvMap& metadata : metadata_group) {
       /* Note: Currently we have a single audio source configured with a one
-       *       set of codec/pcm parameters thus we can use a single subgroup
-       *       for all the BISes. Configure common BIS codec params at the
-       *       subgroup level.
+       *       set of codec/pcm parameters, thus all the subgroups carry the
+       *       same channels, each one on its own BISes. Configure common BIS
+       *       codec params at the subgroup level.
        */
       BasicAudioAnnouncementSubgroup config = {
           .codec_config =
@@ -180,7 +182,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         config.bis_configs.push_back(
             {.codec_specific_params =
                  codec_config.GetBisCodecSpecData(i + 1).Values(),
-             .bis_index = static_cast<uint8_t>(i + 1)});
+             .bis_index = bis_index++});
       }
 
       announcement.subgroup_configs.push_back(config);
@@ -867,26 +869,34 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         return;
       }
 
-      if (enc_audio_buffers_.size() != codec_wrapper_.GetNumChannels()) {
-        enc_audio_buffers_.resize(codec_wrapper_.GetNumChannels());
-      }
-
+      const int num_channels = codec_wrapper_.GetNumChannels();
       const int dt_us = codec_wrapper_.GetDataIntervalUs();
       const int sr_hz = codec_wrapper_.GetSampleRate();
-      const auto encoder_bytes = lc3_encoder_size(dt_us, sr_hz);
-      const auto channel_bytes = codec_wrapper_.GetMaxSduSizePerChannel();
-
-      /* TODO: We should act smart and reuse current configurations */
-      encoders_.clear();
-      encoders_mem_.clear();
-      while (encoders_.size() < codec_wrapper_.GetNumChannels()) {
-        auto& encoder_buf = enc_audio_buffers_.at(encoders_.size());
-        encoder_buf.resize(channel_bytes);
-
-        encoders_mem_.emplace_back(malloc(encoder_bytes), &std::free);
-        encoders_.emplace_back(
-            lc3_setup_encoder(dt_us, sr_hz, 0, encoders_mem_.back().get()));
+      const auto encoders_bytes = lc3_encoders_size(dt_us, sr_hz, num_channels);
+      channel_bytes_ = codec_wrapper_.GetMaxSduSizePerChannel();
+
+      /* The frames of all the channels are encoded in a single buffer, one
+       * after the other, by encoders sharing a single memory space. */
+      enc_audio_buffer_.resize(num_channels * channel_bytes_);
+
+      /* The bitrate only changes the size of the encoded frames, so the
+       * encoders can be kept as long as the PCM parameters are the same */
+      if (encoders_.size() == (size_t)num_channels &&
+          encoders_dt_us_ == dt_us && encoders_sr_hz_ == sr_hz) {
+        LOG_DEBUG("Reusing %d encoders", num_channels);
+        return;
       }
+
+      encoders_.resize(num_channels);
+      encoders_mem_.reset(malloc(encoders_bytes));
+      if (lc3_setup_encoders(dt_us, sr_hz, 0, num_channels,
+                             encoders_mem_.get(), encoders_.data()) != 0) {
+        LOG_ERROR("Unable to setup %d encoders", num_channels);
+        encoders_.clear();
+        return;
+      }
+      encoders_dt_us_ = dt_us;
+      encoders_sr_hz_ = sr_hz;
     }
 
     const BroadcastCodecWrapper& getCurrentCodecConfig(void) const {
@@ -897,23 +907,10 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       codec_wrapper_ = config;
     }
 
-    void encodeLc3Channel(lc3_encoder_t encoder,
-                          std::vector<uint8_t>& out_buffer,
-                          const std::vector<uint8_t>& data,
-                          int initial_channel_offset, int pitch_samples,
-                          int num_channels) {
-      auto encoder_status =
-          lc3_encode(encoder, LC3_PCM_FORMAT_S16,
-                     (int16_t*)(data.data() + initial_channel_offset),
-                     pitch_samples, out_buffer.size(), out_buffer.data());
-      if (encoder_status != 0) {
-        LOG_ERROR("Encoding error=%d", encoder_status);
-      }
-    }
-
     static void sendBroadcastData(
         const std::unique_ptr<BroadcastStateMachine>& broadcast,
-        std::vector<std::vector<uint8_t>>& encoded_channels) {
+        const std::vector<uint8_t>& encoded_channels, int num_channels,
+        uint16_t channel_bytes) {
       auto const& config = broadcast->GetBigConfig();
       if (config == std::nullopt) {
         LOG_ERROR(
@@ -924,15 +921,30 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         return;
       }
 
-      if (config->connection_handles.size() < encoded_channels.size()) {
+      if (config->connection_handles.size() < (size_t)num_channels) {
         LOG_ERROR("Not enough BIS'es to broadcast all channels!");
         return;
       }
 
-      for (uint8_t chan = 0; chan < encoded_channels.size(); ++chan) {
-        IsoManager::GetInstance()->SendIsoData(config->connection_handles[chan],
-                                               encoded_channels[chan].data(),
-                                               encoded_channels[chan].size());
+      /* Each subgroup carries the same encoded channels on its own BISes, so
+       * the channels are encoded once and fanned out to all the subgroups.
+       */
+      auto const& announcement = broadcast->GetBroadcastAnnouncement();
+      for (auto const& subgroup : announcement.subgroup_configs) {
+        auto num_bis = std::min(subgroup.bis_configs.size(),
+                                static_cast<size_t>(num_channels));
+        for (size_t chan = 0; chan < num_bis; ++chan) {
+          /* BIS indices start at 1 */
+          size_t bis_idx = subgroup.bis_configs[chan].bis_index;
+          if (bis_idx == 0 || bis_idx > config->connection_handles.size()) {
+            LOG_ERROR("No BIS for bis_index=%zu", bis_idx);
+            continue;
+          }
+
+          IsoManager::GetInstance()->SendIsoData(
+              config->connection_handles[bis_idx - 1],
+              encoded_channels.data() + chan * channel_bytes, channel_bytes);
+        }
       }
     }
 
@@ -941,15 +953,16 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
       LOG_VERBOSE("Received %zu bytes.", data.size());
 
-      /* Constants for the channel data configuration */
-      const auto num_channels = codec_wrapper_.GetNumChannels();
-      const auto bytes_per_sample = (codec_wrapper_.GetBitsPerSample() / 8);
+      if (encoders_.empty()) return;
 
       /* Prepare encoded data for all channels */
-      for (uint8_t chan = 0; chan < num_channels; ++chan) {
-        /* TODO: Use encoder agnostic wrapper */
-        encodeLc3Channel(encoders_[chan], enc_audio_buffers_[chan], data,
-                         chan * bytes_per_sample, num_channels, num_channels);
+      const int num_channels = encoders_.size();
+      /* TODO: Use encoder agnostic wrapper */
+      auto encoder_status = lc3_encode_channels(
+          encoders_.data(), num_channels, LC3_PCM_FORMAT_S16, data.data(),
+          channel_bytes_, enc_audio_buffer_.data());
+      if (encoder_status != 0) {
+        LOG_ERROR("Encoding error=%d", encoder_status);
       }
 
       /* Currently there is no way to broadcast multiple distinct streams.
@@ -961,7 +974,8 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         if ((broadcast->GetState() ==
              BroadcastStateMachine::State::STREAMING) &&
             !broadcast->IsMuted())
-          sendBroadcastData(broadcast, enc_audio_buffers_);
+          sendBroadcastData(broadcast, enc_audio_buffer_, num_channels,
+                            channel_bytes_);
       }
       LOG_VERBOSE("All data sent.");
     }
@@ -1013,8 +1027,12 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
    private:
     BroadcastCodecWrapper codec_wrapper_;
     std::vector<lc3_encoder_t> encoders_;
-    std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
-    std::vector<std::vector<uint8_t>> enc_audio_buffers_;
+    std::unique_ptr<void, decltype(&std::free)> encoders_mem_{nullptr,
+                                                              &std::free};
+    int encoders_dt_us_ = 0;
+    int encoders_sr_hz_ = 0;
+    uint16_t channel_bytes_ = 0;
+    std::vector<uint8_t> enc_audio_buffer_;
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
@@ -20,6 +20,7 @@
 #include <hardware/audio.h>
 
 #include <chrono>
+#include <set>
 
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
@@ -316,9 +317,13 @@ TEST_F(BroadcasterTest, CreateAudioBroadcastMultiGroups) {
   auto& instance_config = MockBroadcastStateMachine::GetLastInstance()->cfg;
   ASSERT_EQ(instance_config.broadcast_code, default_code);
   ASSERT_EQ(instance_config.announcement.subgroup_configs.size(), (uint8_t) 2);
+  std::set<uint8_t> bis_indices;
   for (auto& subgroup : instance_config.announcement.subgroup_configs) {
     ASSERT_EQ(types::LeAudioLtvMap(subgroup.metadata).RawPacket(),
               default_metadata);
+    for (auto& bis_config : subgroup.bis_configs) {
+      ASSERT_TRUE(bis_indices.insert(bis_config.bis_index).second);
+    }
   }
 }
 
@@ -366,6 +371,31 @@ TEST_F(BroadcasterTest, StartAudioBroadcast) {
   audio_receiver->OnAudioDataReady(sample_data);
 }
 
+TEST_F(BroadcasterTest, StartAudioBroadcastMultiGroups) {
+  auto broadcast_id = InstantiateBroadcast(default_metadata, default_code, 2);
+  LeAudioBroadcaster::Get()->StopAudioBroadcast(broadcast_id);
+
+  LeAudioSourceAudioHalClient::Callbacks* audio_receiver;
+  EXPECT_CALL(*mock_audio_source_, Start)
+      .WillOnce(DoAll(SaveArg<1>(&audio_receiver), Return(true)));
+
+  LeAudioBroadcaster::Get()->StartAudioBroadcast(broadcast_id);
+  ASSERT_NE(audio_receiver, nullptr);
+
+  BigConfig big_cfg;
+  big_cfg.big_id =
+      MockBroadcastStateMachine::GetLastInstance()->GetAdvertisingSid();
+  big_cfg.connection_handles = {0x10, 0x12};
+  big_cfg.max_pdu = 128;
+  MockBroadcastStateMachine::GetLastInstance()->SetExpectedBigConfig(big_cfg);
+
+  // The single encoded channel goes to the BIS of each subgroup
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x10, _, _)).Times(1);
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x12, _, _)).Times(1);
+  std::vector<uint8_t> sample_data(320, 0);
+  audio_receiver->OnAudioDataReady(sample_data);
+}
+
 TEST_F(BroadcasterTest, StartAudioBroadcastMedia) {
   auto broadcast_id = InstantiateBroadcast(media_metadata);
   LeAudioBroadcaster::Get()->StopAudioBroadcast(broadcast_id);
@@ -94,6 +94,12 @@ class MockBroadcastStateMachine
       return this->cfg.broadcast_name;
     });
 
+    ON_CALL(*this, GetBroadcastAnnouncement())
+        .WillByDefault(
+            [this]() -> const bluetooth::le_audio::BasicAudioAnnouncementData& {
+              return this->cfg.announcement;
+            });
+
     ON_CALL(*this, GetPublicBroadcastAnnouncement())
         .WillByDefault(
             [this]() -> bluetooth::le_audio::PublicBroadcastAnnouncementData& {
@@ -70,11 +70,11 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   bool Initialize() override {
     static constexpr uint8_t sNumBisMax = 31;
 
-    if (sm_config_.codec_wrapper.GetNumChannels() > sNumBisMax) {
+    if (GetNumBis() > sNumBisMax) {
       LOG_ERROR(
-          "Channel count of %d exceeds the maximum number of possible BISes, "
+          "BIS count of %zu exceeds the maximum number of possible BISes, "
           "which is %d",
-          sm_config_.codec_wrapper.GetNumChannels(), sNumBisMax);
+          GetNumBis(), sNumBisMax);
       return false;
     }
 
@@ -89,6 +89,15 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
     return sm_config_.codec_wrapper;
   }
 
+  /* Each subgroup of the announcement carries the channels on its own BISes */
+  size_t GetNumBis() const {
+    size_t num_bis = 0;
+    for (auto const& subgroup : sm_config_.announcement.subgroup_configs) {
+      num_bis += subgroup.bis_configs.size();
+    }
+    return num_bis ? num_bis : sm_config_.codec_wrapper.GetNumChannels();
+  }
+
   std::optional<BigConfig> const& GetBigConfig() const override {
     return active_config_;
   }
@@ -406,7 +415,7 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
     /* TODO: Figure out how to decide on the currently hard-codded params. */
     struct bluetooth::hci::iso_manager::big_create_params big_params = {
         .adv_handle = GetAdvertisingSid(),
-        .num_bis = sm_config_.codec_wrapper.GetNumChannels(),
+        .num_bis = static_cast<uint8_t>(GetNumBis()),
         .sdu_itv = sm_config_.codec_wrapper.GetDataIntervalUs(),
         .max_sdu_size = sm_config_.codec_wrapper.GetMaxSduSize(),
         .max_transport_latency = sm_config_.qos_config.getMaxTransportLatency(),
@@ -536,8 +545,9 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
       auto it =
           std::find(conn_handles.begin(), conn_handles.end(), conn_handle);
       if (it != conn_handles.end()) {
-        /* Find BIS index - BIS indices start at 1 */
-        auto bis_idx = it - conn_handles.begin() + 1;
+        /* Find the channel of the BIS - BIS indices start at 1 */
+        auto num_channels = sm_config_.codec_wrapper.GetNumChannels();
+        auto bis_idx = (it - conn_handles.begin()) % num_channels + 1;
 
         /* Compose subgroup params with BIS params  */
         auto params = sm_config_.codec_wrapper.GetSubgroupCodecSpecData();
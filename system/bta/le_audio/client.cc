@@ -18,7 +18,9 @@
 #include <base/functional/bind.h>
 #include <base/strings/string_number_conversions.h>
 
+#include <array>
 #include <deque>
+#include <future>
 #include <mutex>
 #include <optional>
 
@@ -35,6 +37,7 @@
 #include "btm_iso_api.h"
 #include "client_parser.h"
 #include "codec_manager.h"
+#include "common/message_loop_thread.h"
 #include "common/time_util.h"
 #include "content_control_id_keeper.h"
 #include "device/include/controller.h"
@@ -42,7 +45,9 @@
 #include "embdrv/lc3/include/lc3.h"
 #include "gatt/bta_gattc_int.h"
 #include "gd/common/strings.h"
+#include "gd/os/trace.h"
 #include "internal_include/stack_config.h"
+#include "le_audio_latency_histogram.h"
 #include "le_audio_set_configuration_provider.h"
 #include "le_audio_types.h"
 #include "le_audio_utils.h"
@@ -71,6 +76,7 @@ using bluetooth::le_audio::GroupStreamStatus;
 using le_audio::CodecManager;
 using le_audio::ContentControlIdKeeper;
 using le_audio::DeviceConnectState;
+using le_audio::LatencyHistogram;
 using le_audio::LeAudioCodecConfiguration;
 using le_audio::LeAudioDevice;
 using le_audio::LeAudioDeviceGroup;
@@ -176,6 +182,49 @@ inline lc3_pcm_format bits_to_lc3_bits(uint8_t bits_per_sample) {
   return LC3_PCM_FORMAT_S16;
 }
 
+/* Latencies of the SDUs of a CIS through the stack, from the audio HAL read to
+ * the send to the controller for the speaker path, and from the reception from
+ * the controller to the audio HAL write for the microphone path. An SDU is
+ * late when it took longer than the SDU interval.
+ */
+struct CisDataPathStats {
+  uint16_t cis_handle = 0;
+  LatencyHistogram codec_latency;
+  LatencyHistogram total_latency;
+  uint32_t late_sdu_count = 0;
+
+  void AddSdu(uint64_t start_us, uint32_t sdu_interval_us) {
+    uint64_t latency_us =
+        bluetooth::common::time_get_os_boottime_us() - start_us;
+    total_latency.Add(latency_us);
+    if (latency_us > sdu_interval_us) late_sdu_count++;
+  }
+
+  void Reset() { *this = CisDataPathStats(); }
+
+  std::string ToString() const {
+    std::stringstream stream;
+    stream << "cis_handle: " << loghex(cis_handle)
+           << ", late SDUs: " << late_sdu_count << "\n\t  codec: "
+           << codec_latency.ToString() << "\n\t  total: "
+           << total_latency.ToString();
+    return stream.str();
+  }
+};
+
+/* An SDU received for the local sink, with what the data path thread needs of
+ * the stream state to decode it
+ */
+struct IncomingSdu {
+  uint16_t cis_conn_hdl;
+  uint32_t timestamp;
+  uint64_t received_us;
+  bool is_left;
+  bool is_stereo;
+  uint16_t required_byte_count;
+  std::vector<uint8_t> data;
+};
+
 class LeAudioClientImpl;
 LeAudioClientImpl* instance;
 std::mutex instance_mutex;
@@ -218,6 +267,7 @@ DeviceGroupsCallbacks* device_group_callbacks;
 class LeAudioClientImpl : public LeAudioClient {
  public:
   ~LeAudioClientImpl() {
+    data_path_thread_.ShutDown();
     alarm_free(close_vbc_timeout_);
     alarm_free(disable_timer_);
     alarm_free(suspend_timeout_);
@@ -240,8 +290,7 @@ class LeAudioClientImpl : public LeAudioClient {
         in_call_(false),
         current_source_codec_config({0, 0, 0, 0}),
         current_sink_codec_config({0, 0, 0, 0}),
-        lc3_encoder_left_mem(nullptr),
-        lc3_encoder_right_mem(nullptr),
+        lc3_encoders_mem(nullptr),
         lc3_decoder_left_mem(nullptr),
         lc3_decoder_right_mem(nullptr),
         lc3_decoder_left(nullptr),
@@ -279,6 +328,13 @@ class LeAudioClientImpl : public LeAudioClient {
         true);
 
     DeviceGroups::Get()->Initialize(device_group_callbacks);
+
+    data_path_thread_.StartUp();
+    if (!data_path_thread_.IsRunning()) {
+      LOG_ERROR("Unable to start up the data path thread, decoding on main");
+    } else if (!data_path_thread_.EnableRealTimeScheduling()) {
+      LOG_WARN("Unable to increase the data path thread priority");
+    }
   }
 
   void ReconfigureAfterVbcClose() {
@@ -2959,10 +3015,10 @@ class LeAudioClientImpl : public LeAudioClient {
     return true;
   }
 
-  // mix stero signal into mono
-  std::vector<uint8_t> mono_blend(const std::vector<uint8_t>& buf,
-                                  int bytes_per_sample, size_t frames) {
-    std::vector<uint8_t> mono_out;
+  // mix stero signal into mono, in a buffer kept between the frames
+  const std::vector<uint8_t>& mono_blend(const std::vector<uint8_t>& buf,
+                                         int bytes_per_sample, size_t frames) {
+    std::vector<uint8_t>& mono_out = mono_blend_buffer_;
     mono_out.resize(frames * bytes_per_sample);
 
     if (bytes_per_sample == 2) {
@@ -3024,41 +3080,130 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    std::vector<uint8_t> chan_left_enc(byte_count, 0);
-    std::vector<uint8_t> chan_right_enc(byte_count, 0);
-
     bool mono = (left_cis_handle == 0) || (right_cis_handle == 0);
 
+    DLOG(INFO) << __func__ << " left_cis_handle: " << +left_cis_handle
+               << " right_cis_handle: " << right_cis_handle;
+
     if (!mono) {
-      lc3_encode(lc3_encoder_left, bits_per_sample, data.data(), 2,
-                 chan_left_enc.size(), chan_left_enc.data());
-      lc3_encode(lc3_encoder_right, bits_per_sample,
-                 data.data() + bytes_per_sample, 2, chan_right_enc.size(),
-                 chan_right_enc.data());
-    } else {
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
-      if (left_cis_handle) {
-        lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
-                   chan_left_enc.size(), chan_left_enc.data());
-      }
+      /* Left then right channel frames, encoded in a single call */
+      std::vector<uint8_t> chan_enc(2 * byte_count, 0);
+      uint64_t encode_start_us = bluetooth::common::time_get_os_boottime_us();
+      lc3_encode_channels(lc3_encoders, 2, bits_per_sample, data.data(),
+                          byte_count, chan_enc.data());
+      uint64_t encode_us =
+          bluetooth::common::time_get_os_boottime_us() - encode_start_us;
+
+      /* Send data to the controller */
+      CisDataPathStats& left_stats = GetSourceIsoStats(left_cis_handle);
+      CisDataPathStats& right_stats = GetSourceIsoStats(right_cis_handle);
+      left_stats.codec_latency.Add(encode_us);
+      right_stats.codec_latency.Add(encode_us);
+
+      IsoManager::GetInstance()->SendIsoData(left_cis_handle, chan_enc.data(),
+                                             byte_count);
+      left_stats.AddSdu(audio_data_ready_us_, dt_us);
+      IsoManager::GetInstance()->SendIsoData(
+          right_cis_handle, chan_enc.data() + byte_count, byte_count);
+      right_stats.AddSdu(audio_data_ready_us_, dt_us);
+      return;
+    }
 
-      if (right_cis_handle) {
-        lc3_encode(lc3_encoder_right, bits_per_sample, mono.data(), 1,
-                   chan_right_enc.size(), chan_right_enc.data());
+    auto& mono = mono_blend(data, bytes_per_sample,
+                            number_of_required_samples_per_channel);
+    if (left_cis_handle) {
+      EncodeAndSendToCis(left_cis_handle, byte_count, [&](uint8_t* out) {
+        lc3_encode(lc3_encoders[0], bits_per_sample, mono.data(), 1,
+                   byte_count, out);
+      });
+    }
+
+    if (right_cis_handle) {
+      EncodeAndSendToCis(right_cis_handle, byte_count, [&](uint8_t* out) {
+        lc3_encode(lc3_encoders[1], bits_per_sample, mono.data(), 1,
+                   byte_count, out);
+      });
+    }
+  }
+
+  /* Encodes the SDU of |cis_handle| with |encode| directly into the buffer
+   * sent to the controller. The audio is encoded even when the SDU can not be
+   * sent, so that the encoder state follows the stream.
+   */
+  template <typename EncodeFn>
+  void EncodeAndSendToCis(uint16_t cis_handle, uint16_t sdu_len,
+                          EncodeFn&& encode) {
+    uint8_t* sdu =
+        IsoManager::GetInstance()->GetIsoDataBuffer(cis_handle, sdu_len);
+    if (sdu == nullptr) {
+      std::vector<uint8_t> dropped_sdu(sdu_len);
+      encode(dropped_sdu.data());
+      return;
+    }
+
+    CisDataPathStats& stats = GetSourceIsoStats(cis_handle);
+    uint64_t encode_start_us = bluetooth::common::time_get_os_boottime_us();
+    encode(sdu);
+    stats.codec_latency.Add(bluetooth::common::time_get_os_boottime_us() -
+                            encode_start_us);
+
+    IsoManager::GetInstance()->SendIsoDataBuffer(cis_handle);
+    stats.AddSdu(audio_data_ready_us_,
+                 current_source_codec_config.data_interval_us);
+  }
+
+  /* Returns the stats of the speaker |cis_handle|, the slots being taken by the
+   * CISes in the order they first send data.
+   */
+  CisDataPathStats& GetSourceIsoStats(uint16_t cis_handle) {
+    return GetIsoStats(source_iso_stats_, cis_handle);
+  }
+
+  CisDataPathStats& GetSinkIsoStats(uint16_t cis_handle) {
+    return GetIsoStats(sink_iso_stats_, cis_handle);
+  }
+
+  static CisDataPathStats& GetIsoStats(
+      std::array<CisDataPathStats, 2>& iso_stats, uint16_t cis_handle) {
+    for (auto& stats : iso_stats) {
+      if (stats.cis_handle == cis_handle) return stats;
+      if (stats.cis_handle == 0) {
+        stats.cis_handle = cis_handle;
+        return stats;
       }
     }
 
-    DLOG(INFO) << __func__ << " left_cis_handle: " << +left_cis_handle
-               << " right_cis_handle: " << right_cis_handle;
-    /* Send data to the controller */
-    if (left_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          left_cis_handle, chan_left_enc.data(), chan_left_enc.size());
+    /* More CISes than expected, they share the last slot */
+    return iso_stats.back();
+  }
 
-    if (right_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          right_cis_handle, chan_right_enc.data(), chan_right_enc.size());
+  void LogIsoStats(const std::string& direction,
+                   std::array<CisDataPathStats, 2>& iso_stats) {
+    for (auto& stats : iso_stats) {
+      if (stats.total_latency.count == 0) continue;
+
+      LeAudioLogHistory::Get()->AddLogHistory(
+          kLogIsoDataPath, active_group_id_, RawAddress::kEmpty,
+          kLogSduLatencyOp + direction,
+          "cis_handle: " + std::to_string(stats.cis_handle) +
+              " late: " + std::to_string(stats.late_sdu_count) +
+              " p99: " + std::to_string(stats.total_latency.PercentileUs(99)) +
+              "us max: " + std::to_string(stats.total_latency.max_us) + "us");
+    }
+  }
+
+  void printIsoStats(int fd) {
+    std::stringstream stream;
+    stream << " Speaker ISO data path latency\n";
+    for (auto& stats : source_iso_stats_) {
+      if (stats.cis_handle != 0) stream << "\t" << stats.ToString() << "\n";
+    }
+    stream << " Microphone ISO data path latency\n";
+    for (auto& stats : sink_iso_stats_) {
+      if (stats.cis_handle != 0) stream << "\t" << stats.ToString() << "\n";
+    }
+
+    dprintf(fd, "%s", stream.str().c_str());
   }
 
   void PrepareAndSendToSingleCis(
@@ -3082,31 +3227,27 @@ class LeAudioClientImpl : public LeAudioClient {
       LOG(ERROR) << __func__ << "Missing samples";
       return;
     }
-    std::vector<uint8_t> chan_encoded(num_channels * byte_count, 0);
-
-    if (num_channels == 1) {
-      /* Since we always get two channels from framework, lets make it mono here
-       */
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
-
-      auto err = lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
-                            byte_count, chan_encoded.data());
+    /* Encode directly into the data sent to the controller */
+    EncodeAndSendToCis(
+        cis_handle, num_channels * byte_count, [&](uint8_t* chan_encoded) {
+          if (num_channels == 1) {
+            /* Since we always get two channels from framework, lets make it
+             * mono here
+             */
+            auto& mono = mono_blend(data, bytes_per_sample,
+                                    number_of_required_samples_per_channel);
 
-      if (err < 0) {
-        LOG(ERROR) << " error while encoding, error code: " << +err;
-      }
-    } else {
-      lc3_encode(lc3_encoder_left, bits_per_sample, (const int16_t*)data.data(),
-                 2, byte_count, chan_encoded.data());
-      lc3_encode(lc3_encoder_right, bits_per_sample,
-                 (const int16_t*)data.data() + 1, 2, byte_count,
-                 chan_encoded.data() + byte_count);
-    }
+            auto err = lc3_encode(lc3_encoders[0], bits_per_sample,
+                                  mono.data(), 1, byte_count, chan_encoded);
 
-    /* Send data to the controller */
-    IsoManager::GetInstance()->SendIsoData(cis_handle, chan_encoded.data(),
-                                           chan_encoded.size());
+            if (err < 0) {
+              LOG(ERROR) << " error while encoding, error code: " << +err;
+            }
+          } else {
+            lc3_encode_channels(lc3_encoders, 2, bits_per_sample, data.data(),
+                                byte_count, chan_encoded);
+          }
+        });
   }
 
   const struct le_audio::stream_configuration* GetStreamSinkConfiguration(
@@ -3127,6 +3268,9 @@ class LeAudioClientImpl : public LeAudioClient {
         (audio_sender_state_ != AudioState::STARTED))
       return;
 
+    audio_data_ready_us_ = bluetooth::common::time_get_os_boottime_us();
+    BT_TRACE_SCOPE(LE_AUDIO, "LE Audio SDU");
+
     LeAudioDeviceGroup* group = aseGroups_.FindById(active_group_id_);
     if (!group) {
       LOG(ERROR) << __func__ << "There is no streaming group available";
@@ -3166,6 +3310,8 @@ class LeAudioClientImpl : public LeAudioClient {
         (audio_receiver_state_ != AudioState::STARTED))
       return;
 
+    uint64_t received_us = bluetooth::common::time_get_os_boottime_us();
+
     LeAudioDeviceGroup* group = aseGroups_.FindById(active_group_id_);
     if (!group) {
       LOG(ERROR) << __func__ << "There is no streaming group available";
@@ -3196,8 +3342,62 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    uint16_t required_for_channel_byte_count =
-        stream_conf.source_octets_per_codec_frame;
+    IncomingSdu sdu = {
+        .cis_conn_hdl = cis_conn_hdl,
+        .timestamp = timestamp,
+        .received_us = received_us,
+        .is_left = is_left,
+        .is_stereo = (left_cis_handle != 0) && (right_cis_handle != 0),
+        .required_byte_count = stream_conf.source_octets_per_codec_frame,
+        .data = std::vector<uint8_t>(data, data + size),
+    };
+
+    if (!data_path_thread_.IsRunning()) {
+      DecodeIncomingCisData(std::move(sdu));
+      return;
+    }
+
+    /* Decode away from the GATT and HCI traffic of the main thread. The
+     * stream state used there only changes once the data path is flushed.
+     */
+    data_path_thread_.DoInThread(
+        FROM_HERE, base::BindOnce(&LeAudioClientImpl::DecodeIncomingCisData,
+                                  base::Unretained(this), std::move(sdu)));
+  }
+
+  /* Waits for the SDUs queued to the data path thread. To be called before
+   * releasing or resetting the decoders, or the audio HAL client.
+   */
+  void FlushDataPath() {
+    std::promise<void> flush_promise;
+    auto flush_future = flush_promise.get_future();
+    if (!data_path_thread_.DoInThread(
+            FROM_HERE, base::BindOnce(
+                           [](std::promise<void> promise) {
+                             promise.set_value();
+                           },
+                           std::move(flush_promise))))
+      return;
+
+    flush_future.wait();
+  }
+
+  /* Decodes an incoming SDU and sends it to the audio framework, once it has
+   * both channels of a stereo stream. Runs on the data path thread.
+   */
+  void DecodeIncomingCisData(IncomingSdu sdu) {
+    bool is_left = sdu.is_left;
+    uint32_t timestamp = sdu.timestamp;
+    uint8_t* data = sdu.data.data();
+    uint16_t size = sdu.data.size();
+
+    /* The SDUs sent to the audio framework are accounted to the CIS of the
+     * last one received, which completed them.
+     */
+    receiving_cis_stats_ = &GetSinkIsoStats(sdu.cis_conn_hdl);
+    cis_data_received_us_ = sdu.received_us;
+
+    uint16_t required_for_channel_byte_count = sdu.required_byte_count;
 
     int dt_us = current_sink_codec_config.data_interval_us;
     int af_hz = audio_framework_sink_config.sample_rate;
@@ -3220,7 +3420,10 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    std::vector<int16_t> pcm_data_decoded(pcm_size, 0);
+    /* Swapped with the cached channel data below, so that the steady state
+     * does not allocate */
+    std::vector<int16_t>& pcm_data_decoded = decoded_channel_data_;
+    pcm_data_decoded.resize(pcm_size);
 
     int err = 0;
 
@@ -3235,8 +3438,11 @@ class LeAudioClientImpl : public LeAudioClient {
     lc3_decoder_t decoder_to_use =
         is_left ? lc3_decoder_left : lc3_decoder_right;
 
+    uint64_t decode_start_us = bluetooth::common::time_get_os_boottime_us();
     err = lc3_decode(decoder_to_use, data, size, bits_per_sample,
                      pcm_data_decoded.data(), 1 /* pitch */);
+    receiving_cis_stats_->codec_latency.Add(
+        bluetooth::common::time_get_os_boottime_us() - decode_start_us);
 
     if (err < 0) {
       LOG(ERROR) << " bad decoding parameters: " << static_cast<int>(err);
@@ -3246,7 +3452,7 @@ class LeAudioClientImpl : public LeAudioClient {
     /* AF == Audio Framework */
     bool af_is_stereo = (audio_framework_sink_config.num_channels == 2);
 
-    if (!left_cis_handle || !right_cis_handle) {
+    if (!sdu.is_stereo) {
       /* mono or just one device connected */
       SendAudioDataToAF(false /* bt_got_stereo */, af_is_stereo,
                         &pcm_data_decoded, nullptr);
@@ -3257,7 +3463,7 @@ class LeAudioClientImpl : public LeAudioClient {
     if (cached_channel_timestamp_ == 0 && cached_channel_data_.empty()) {
       /* First packet received, cache it. We need both channel data to send it
        * to AF. */
-      cached_channel_data_ = pcm_data_decoded;
+      std::swap(cached_channel_data_, pcm_data_decoded);
       cached_channel_timestamp_ = timestamp;
       cached_channel_is_left_ = is_left;
       return;
@@ -3294,7 +3500,7 @@ class LeAudioClientImpl : public LeAudioClient {
                           &cached_channel_data_);
       }
 
-      cached_channel_data_ = pcm_data_decoded;
+      std::swap(cached_channel_data_, pcm_data_decoded);
       cached_channel_timestamp_ = timestamp;
       cached_channel_is_left_ = is_left;
       return;
@@ -3313,7 +3519,7 @@ class LeAudioClientImpl : public LeAudioClient {
     }
 
     /* Cache the data in case 2nd channel connects */
-    cached_channel_data_ = pcm_data_decoded;
+    std::swap(cached_channel_data_, pcm_data_decoded);
     cached_channel_timestamp_ = timestamp;
     cached_channel_is_left_ = is_left;
   }
@@ -3344,7 +3550,8 @@ class LeAudioClientImpl : public LeAudioClient {
        * Here we handle stream without checking bt_got_stereo flag.
        */
       const size_t mono_size = left ? left->size() : right->size();
-      std::vector<uint16_t> mixed(mono_size * 2);
+      std::vector<int16_t>& mixed = sink_stereo_buffer_;
+      mixed.resize(mono_size * 2);
 
       for (size_t i = 0; i < mono_size; i++) {
         mixed[2 * i] = left ? (*left)[i] : (*right)[i];
@@ -3357,6 +3564,11 @@ class LeAudioClientImpl : public LeAudioClient {
 
     /* TODO: What to do if not all data sinked ? */
     if (written != to_write) LOG(ERROR) << __func__ << ", not all data sinked";
+
+    if (receiving_cis_stats_ != nullptr) {
+      receiving_cis_stats_->AddSdu(cis_data_received_us_,
+                                   current_sink_codec_config.data_interval_us);
+    }
   }
 
   void ConfirmLocalAudioSourceStreamingRequest() {
@@ -3413,26 +3625,20 @@ class LeAudioClientImpl : public LeAudioClient {
         group->GetRemoteDelay(le_audio::types::kLeAudioDirectionSink);
     if (CodecManager::GetInstance()->GetCodecLocation() ==
         le_audio::types::CodecLocation::HOST) {
-      if (lc3_encoder_left_mem) {
+      if (lc3_encoders_mem) {
         LOG(WARNING)
             << " The encoder instance should have been already released.";
-        free(lc3_encoder_left_mem);
-        lc3_encoder_left_mem = nullptr;
-        free(lc3_encoder_right_mem);
-        lc3_encoder_right_mem = nullptr;
+        free(lc3_encoders_mem);
+        lc3_encoders_mem = nullptr;
       }
       int dt_us = current_source_codec_config.data_interval_us;
       int sr_hz = current_source_codec_config.sample_rate;
       int af_hz = audio_framework_source_config.sample_rate;
-      unsigned enc_size = lc3_encoder_size(dt_us, af_hz);
-
-      lc3_encoder_left_mem = malloc(enc_size);
-      lc3_encoder_right_mem = malloc(enc_size);
+      unsigned enc_size = lc3_encoders_size(dt_us, af_hz, 2);
 
-      lc3_encoder_left =
-          lc3_setup_encoder(dt_us, sr_hz, af_hz, lc3_encoder_left_mem);
-      lc3_encoder_right =
-          lc3_setup_encoder(dt_us, sr_hz, af_hz, lc3_encoder_right_mem);
+      lc3_encoders_mem = malloc(enc_size);
+      lc3_setup_encoders(dt_us, sr_hz, af_hz, 2, lc3_encoders_mem,
+                         lc3_encoders);
     }
 
     le_audio_source_hal_client_->UpdateRemoteDelay(remote_delay_ms);
@@ -3477,6 +3683,7 @@ class LeAudioClientImpl : public LeAudioClient {
     uint16_t remote_delay_ms =
         group->GetRemoteDelay(le_audio::types::kLeAudioDirectionSource);
 
+    FlushDataPath();
     CleanCachedMicrophoneData();
 
     if (CodecManager::GetInstance()->GetCodecLocation() ==
@@ -3518,12 +3725,17 @@ class LeAudioClientImpl : public LeAudioClient {
 
   void SuspendAudio(void) {
     CancelStreamingRequest();
+    FlushDataPath();
+
+    LogIsoStats("LocalSource", source_iso_stats_);
+    LogIsoStats("LocalSink", sink_iso_stats_);
+    for (auto& stats : source_iso_stats_) stats.Reset();
+    for (auto& stats : sink_iso_stats_) stats.Reset();
+    receiving_cis_stats_ = nullptr;
 
-    if (lc3_encoder_left_mem) {
-      free(lc3_encoder_left_mem);
-      lc3_encoder_left_mem = nullptr;
-      free(lc3_encoder_right_mem);
-      lc3_encoder_right_mem = nullptr;
+    if (lc3_encoders_mem) {
+      free(lc3_encoders_mem);
+      lc3_encoders_mem = nullptr;
     }
 
     if (lc3_decoder_left_mem) {
@@ -3602,6 +3814,7 @@ class LeAudioClientImpl : public LeAudioClient {
     }
     dprintf(fd, "\n");
     printCurrentStreamConfiguration(fd);
+    printIsoStats(fd);
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  LE Audio Groups:\n");
     aseGroups_.Dump(fd, active_group_id_);
@@ -5267,11 +5480,9 @@ class LeAudioClientImpl : public LeAudioClient {
       .data_interval_us = LeAudioCodecConfiguration::kInterval10000Us,
   };
 
-  void* lc3_encoder_left_mem;
-  void* lc3_encoder_right_mem;
-
-  lc3_encoder_t lc3_encoder_left;
-  lc3_encoder_t lc3_encoder_right;
+  /* Left and right channel encoders, sharing a single memory space */
+  void* lc3_encoders_mem;
+  lc3_encoder_t lc3_encoders[2];
 
   void* lc3_decoder_left_mem;
   void* lc3_decoder_right_mem;
@@ -5280,6 +5491,8 @@ class LeAudioClientImpl : public LeAudioClient {
   lc3_decoder_t lc3_decoder_right;
 
   std::vector<uint8_t> encoded_data;
+  /* Single channel speaker PCM, only used on the audio HAL worker thread */
+  std::vector<uint8_t> mono_blend_buffer_;
   std::unique_ptr<LeAudioSourceAudioHalClient> le_audio_source_hal_client_;
   std::unique_ptr<LeAudioSinkAudioHalClient> le_audio_sink_hal_client_;
   static constexpr uint64_t kAudioSuspentKeepIsoAliveTimeoutMs = 5000;
@@ -5292,10 +5505,29 @@ class LeAudioClientImpl : public LeAudioClient {
   static constexpr uint64_t kDeviceAttachDelayMs = 500;
 
   std::vector<int16_t> cached_channel_data_;
+  /* Microphone PCM buffers, reused for each received SDU */
+  std::vector<int16_t> decoded_channel_data_;
+  std::vector<int16_t> sink_stereo_buffer_;
   uint32_t cached_channel_timestamp_ = 0;
   uint32_t cached_channel_is_left_;
 
+  /* Decodes the microphone SDUs and writes them to the audio HAL. The
+   * encoding of the speaker SDUs runs on the worker thread of the audio HAL
+   * client.
+   */
+  bluetooth::common::MessageLoopThread data_path_thread_{
+      "bt_le_audio_data_path_thread"};
+
+  /* ISO data path latencies, per CIS of the stream */
+  std::array<CisDataPathStats, 2> source_iso_stats_;
+  std::array<CisDataPathStats, 2> sink_iso_stats_;
+  CisDataPathStats* receiving_cis_stats_ = nullptr;
+  uint64_t audio_data_ready_us_ = 0;
+  uint64_t cis_data_received_us_ = 0;
+
   void ClientAudioIntefraceRelease() {
+    FlushDataPath();
+
     if (le_audio_source_hal_client_) {
       le_audio_source_hal_client_->Stop();
       le_audio_source_hal_client_.reset();
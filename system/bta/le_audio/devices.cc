@@ -2068,6 +2068,22 @@ LeAudioDeviceGroup::FindFirstSupportedConfiguration(
   /* Filter out device set for each end every scenario */
 
   auto required_snk_strategy = GetGroupStrategy(Size());
+
+  /* Only look at the configurations which the group size, strategy and ASE
+   * directions allow, the provider keeps these indexed.
+   */
+  uint8_t directions = 0;
+  for (auto* device = GetFirstDeviceWithActiveContext(context_type);
+       device != nullptr;
+       device = GetNextDeviceWithActiveContext(device, context_type)) {
+    for (const auto& ase : device->ases_) directions |= ase.direction;
+  }
+
+  confs = AudioSetConfigurationProvider::Get()->GetCandidateConfigurations(
+      context_type, NumOfConnected(context_type), required_snk_strategy,
+      directions);
+  if (confs == nullptr) return nullptr;
+
   for (const auto& conf : *confs) {
     if (IsConfigurationSupported(conf, context_type, required_snk_strategy)) {
       LOG_DEBUG("found: %s", conf->name.c_str());
@@ -2114,6 +2130,38 @@ bool LeAudioDeviceGroup::Configure(
   return true;
 }
 
+bool LeAudioDeviceGroup::IsConfigurationReusable(
+    LeAudioContextType context_type) {
+  if (stream_conf.conf == nullptr) return false;
+
+  /* The configured ASEs can be reused when the context maps to the very same
+   * audio set configuration they were configured with.
+   */
+  return available_context_to_configuration_map[context_type] ==
+         stream_conf.conf;
+}
+
+void LeAudioDeviceGroup::ReuseConfiguration(
+    LeAudioContextType context_type,
+    const BidirectionalPair<AudioContexts>& metadata_context_types,
+    const BidirectionalPair<std::vector<uint8_t>>& ccid_lists) {
+  LOG_INFO("group_id: %d, reusing configuration %s from %s for %s", group_id_,
+           stream_conf.conf->name.c_str(),
+           bluetooth::common::ToString(configuration_context_type_).c_str(),
+           bluetooth::common::ToString(context_type).c_str());
+
+  for (auto leAudioDevice : leAudioDevices_) {
+    if (leAudioDevice.expired()) continue;
+
+    leAudioDevice.lock()->SetConfiguredAsesContext(
+        configuration_context_type_, context_type, metadata_context_types,
+        ccid_lists);
+  }
+
+  configuration_context_type_ = context_type;
+  metadata_context_type_ = metadata_context_types;
+}
+
 LeAudioDeviceGroup::~LeAudioDeviceGroup(void) { this->Cleanup(); }
 
 void LeAudioDeviceGroup::PrintDebugState(void) {
@@ -2267,10 +2315,7 @@ void LeAudioDevice::ClearPACs(void) {
   src_pacs_.clear();
 }
 
-LeAudioDevice::~LeAudioDevice(void) {
-  alarm_free(link_quality_timer);
-  this->ClearPACs();
-}
+LeAudioDevice::~LeAudioDevice(void) { this->ClearPACs(); }
 
 void LeAudioDevice::RegisterPACs(
     std::vector<struct types::acs_ac_record>* pac_db,
@@ -2852,6 +2897,32 @@ bool LeAudioDevice::ActivateConfiguredAses(LeAudioContextType context_type) {
   return ret;
 }
 
+void LeAudioDevice::SetConfiguredAsesContext(
+    LeAudioContextType configured_context_type, LeAudioContextType context_type,
+    const BidirectionalPair<AudioContexts>& metadata_context_types,
+    const BidirectionalPair<std::vector<uint8_t>>& ccid_lists) {
+  for (auto& ase : ases_) {
+    if (ase.configured_for_context_type != configured_context_type) continue;
+    if (ase.state != AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
+        ase.state != AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED)
+      continue;
+
+    ase.configured_for_context_type = context_type;
+
+    /* Filter multidirectional audio context for each ase direction */
+    auto directional_audio_context =
+        metadata_context_types.get(ase.direction) &
+        GetAvailableContexts(ase.direction);
+    if (directional_audio_context.any()) {
+      ase.metadata =
+          GetMetadata(directional_audio_context, ccid_lists.get(ase.direction));
+    } else {
+      ase.metadata = GetMetadata(AudioContexts(LeAudioContextType::UNSPECIFIED),
+                                 std::vector<uint8_t>());
+    }
+  }
+}
+
 void LeAudioDevice::DeactivateAllAses(void) {
   for (auto& ase : ases_) {
     if (ase.active == false &&
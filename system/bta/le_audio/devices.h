@@ -31,6 +31,7 @@
 #include "bt_types.h"
 #include "bta_groups.h"
 #include "btm_iso_api_types.h"
+#include "common/time_util.h"
 #include "gatt_api.h"
 #include "gd/common/strings.h"
 #include "le_audio_log_history.h"
@@ -118,9 +119,6 @@ class LeAudioDevice {
   struct types::hdl_pair ctp_hdls_;
   uint16_t tmap_role_hdl_;
 
-  alarm_t* link_quality_timer;
-  uint16_t link_quality_timer_data;
-
   LeAudioDevice(const RawAddress& address_, DeviceConnectState state,
                 int group_id = bluetooth::groups::kGroupUnknown)
       : address_(address_),
@@ -134,8 +132,7 @@ class LeAudioDevice {
         encrypted_(false),
         group_id_(group_id),
         csis_member_(false),
-        audio_directions_(0),
-        link_quality_timer(nullptr) {}
+        audio_directions_(0) {}
   ~LeAudioDevice(void);
 
   void SetConnectionState(DeviceConnectState state);
@@ -196,6 +193,12 @@ class LeAudioDevice {
                                             types::AudioContexts src_cont_val);
   void DeactivateAllAses(void);
   bool ActivateConfiguredAses(types::LeAudioContextType context_type);
+  void SetConfiguredAsesContext(
+      types::LeAudioContextType configured_context_type,
+      types::LeAudioContextType context_type,
+      const types::BidirectionalPair<types::AudioContexts>&
+          metadata_context_types,
+      const types::BidirectionalPair<std::vector<uint8_t>>& ccid_lists);
 
   void PrintDebugState(void);
   void DumpPacsDebugState(std::stringstream& stream);
@@ -281,7 +284,8 @@ class LeAudioDeviceGroup {
         pending_group_available_contexts_change_(
             types::LeAudioContextType::UNINITIALIZED),
         target_state_(types::AseState::BTA_LE_AUDIO_ASE_STATE_IDLE),
-        current_state_(types::AseState::BTA_LE_AUDIO_ASE_STATE_IDLE) {
+        current_state_(types::AseState::BTA_LE_AUDIO_ASE_STATE_IDLE),
+        phase_start_us_(0) {
 #ifdef __ANDROID__
     // 22 maps to BluetoothProfile#LE_AUDIO
     is_output_preference_le_audio = android::sysprop::BluetoothProperties::
@@ -348,6 +352,15 @@ class LeAudioDeviceGroup {
                      metadata_context_types,
                  types::BidirectionalPair<std::vector<uint8_t>> ccid_lists = {
                      .sink = {}, .source = {}});
+  /* Returns true if the ASEs configured by the last Configure() call can be
+   * used for |context_type| as is, without a new codec configuration.
+   */
+  bool IsConfigurationReusable(types::LeAudioContextType context_type);
+  void ReuseConfiguration(types::LeAudioContextType context_type,
+                          const types::BidirectionalPair<types::AudioContexts>&
+                              metadata_context_types,
+                          const types::BidirectionalPair<std::vector<uint8_t>>&
+                              ccid_lists);
   uint32_t GetSduInterval(uint8_t direction);
   uint8_t GetSCA(void);
   uint8_t GetPacking(void);
@@ -389,11 +402,17 @@ class LeAudioDeviceGroup {
   void SetState(types::AseState state) {
     LOG(INFO) << __func__ << " current state: " << current_state_
               << " new state: " << state;
+    /* Time of the phase which has just completed for the whole group, since
+     * the previous state change or since the transition was requested.
+     */
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
     LeAudioLogHistory::Get()->AddLogHistory(
         kLogStateMachineTag, group_id_, RawAddress::kEmpty, kLogStateChangedOp,
         bluetooth::common::ToString(current_state_) + "->" +
-            bluetooth::common::ToString(state));
+            bluetooth::common::ToString(state) + ", took " +
+            std::to_string((now_us - phase_start_us_) / 1000) + " ms");
     current_state_ = state;
+    phase_start_us_ = now_us;
   }
 
   inline types::AseState GetTargetState(void) const { return target_state_; }
@@ -406,6 +425,7 @@ class LeAudioDeviceGroup {
         bluetooth::common::ToString(target_state_) + "->" +
             bluetooth::common::ToString(state));
     target_state_ = state;
+    phase_start_us_ = bluetooth::common::time_get_os_boottime_us();
   }
 
   /* Returns context types for which support was recently added or removed */
@@ -486,6 +506,7 @@ class LeAudioDeviceGroup {
 
   types::AseState target_state_;
   types::AseState current_state_;
+  uint64_t phase_start_us_;
   std::vector<std::weak_ptr<LeAudioDevice>> leAudioDevices_;
 };
 
@@ -1396,6 +1396,67 @@ TEST_F(LeAudioAseConfigurationTest, test_reactivation_conversational) {
   ASSERT_EQ(bi_dir_ases_count, 2);
 }
 
+TEST_F(LeAudioAseConfigurationTest, test_configuration_reuse) {
+  LeAudioDevice* left = AddTestDevice(2, 1);
+  LeAudioDevice* right = AddTestDevice(2, 1);
+
+  /* Nothing configured yet */
+  ASSERT_FALSE(group_->IsConfigurationReusable(LeAudioContextType::MEDIA));
+
+  left->snk_audio_locations_ =
+      ::le_audio::codec_spec_conf::kLeAudioLocationFrontLeft;
+  right->snk_audio_locations_ =
+      ::le_audio::codec_spec_conf::kLeAudioLocationFrontRight;
+  group_->ReloadAudioLocations();
+
+  TestGroupAseConfigurationData data[] = {
+      {left, kLeAudioCodecLC3ChannelCountSingleChannel,
+       kLeAudioCodecLC3ChannelCountSingleChannel, 1, 0},
+      {right, kLeAudioCodecLC3ChannelCountSingleChannel,
+       kLeAudioCodecLC3ChannelCountSingleChannel, 1, 0}};
+
+  auto all_configurations =
+      ::le_audio::AudioSetConfigurationProvider::Get()->GetConfigurations(
+          LeAudioContextType::MEDIA);
+  ASSERT_NE(nullptr, all_configurations);
+  ASSERT_NE(all_configurations->end(), all_configurations->begin());
+  TestSingleAseConfiguration(LeAudioContextType::MEDIA, data, 2,
+                             *all_configurations->begin(),
+                             kLeAudioDirectionSink);
+  ASSERT_TRUE(group_->IsConfigurationReusable(LeAudioContextType::MEDIA));
+
+  group_->CigGenerateCisIds(LeAudioContextType::MEDIA);
+
+  /* Simulate stopping stream with caching codec configuration in ASEs */
+  group_->Deactivate();
+  SetAsesToCachedConfiguration(left, LeAudioContextType::MEDIA,
+                               kLeAudioDirectionSink);
+  SetAsesToCachedConfiguration(right, LeAudioContextType::MEDIA,
+                               kLeAudioDirectionSink);
+
+  BidirectionalPair<AudioContexts> metadata_contexts = {
+      .sink = AudioContexts(LeAudioContextType::SOUNDEFFECTS),
+      .source = AudioContexts()};
+  BidirectionalPair<std::vector<uint8_t>> ccid_lists = {{0x01}, {}};
+  group_->ReuseConfiguration(LeAudioContextType::SOUNDEFFECTS,
+                             metadata_contexts, ccid_lists);
+  ASSERT_EQ(LeAudioContextType::SOUNDEFFECTS,
+            group_->GetConfigurationContextType());
+
+  /* The cached ASEs are now activated for the new context */
+  ASSERT_FALSE(group_->Activate(LeAudioContextType::MEDIA));
+  ASSERT_TRUE(group_->Activate(LeAudioContextType::SOUNDEFFECTS));
+
+  for (auto* device : {left, right}) {
+    auto* ase = device->GetFirstActiveAseByDirection(kLeAudioDirectionSink);
+    ASSERT_NE(nullptr, ase);
+    ASSERT_EQ(LeAudioContextType::SOUNDEFFECTS,
+              ase->configured_for_context_type);
+    ASSERT_EQ(device->GetMetadata(metadata_contexts.sink, ccid_lists.sink),
+              ase->metadata);
+  }
+}
+
 TEST_F(LeAudioAseConfigurationTest, test_num_of_connected) {
   auto device1 = AddTestDevice(2, 1);
   auto device2 = AddTestDevice(2, 1);
@@ -1497,6 +1558,53 @@ TEST_F(LeAudioAseConfigurationTest, test_getting_cis_count) {
   ASSERT_EQ(snk_cis_count, 2);
 }
 
+TEST_F(LeAudioAseConfigurationTest, test_candidate_configurations) {
+  auto provider = ::le_audio::AudioSetConfigurationProvider::Get();
+
+  for (auto context_type : kLeAudioContextAllTypesArray) {
+    auto all_configurations = provider->GetConfigurations(context_type);
+    ASSERT_NE(nullptr, all_configurations);
+
+    for (uint8_t num_of_devices = 1; num_of_devices <= 3; num_of_devices++) {
+      for (auto snk_strategy :
+           {LeAudioConfigurationStrategy::MONO_ONE_CIS_PER_DEVICE,
+            LeAudioConfigurationStrategy::STEREO_TWO_CISES_PER_DEVICE,
+            LeAudioConfigurationStrategy::STEREO_ONE_CIS_PER_DEVICE}) {
+        for (uint8_t directions :
+             {kLeAudioDirectionSink, kLeAudioDirectionSource,
+              kLeAudioDirectionSink | kLeAudioDirectionSource}) {
+          auto candidates = provider->GetCandidateConfigurations(
+              context_type, num_of_devices, snk_strategy, directions);
+          ASSERT_NE(nullptr, candidates);
+
+          /* Candidates keep the priority order of all the configurations */
+          auto it = all_configurations->begin();
+          for (auto candidate : *candidates) {
+            it = std::find(it, all_configurations->end(), candidate);
+            ASSERT_NE(it, all_configurations->end());
+
+            ASSERT_TRUE(check_if_may_cover_scenario(candidate, num_of_devices));
+            for (const auto& ent : candidate->confs) {
+              ASSERT_NE(0, ent.direction & directions);
+              if (ent.direction == kLeAudioDirectionSink)
+                ASSERT_EQ(ent.strategy, snk_strategy);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Two earbuds streaming media */
+  auto candidates = provider->GetCandidateConfigurations(
+      LeAudioContextType::MEDIA, 2,
+      LeAudioConfigurationStrategy::MONO_ONE_CIS_PER_DEVICE,
+      kLeAudioDirectionSink | kLeAudioDirectionSource);
+  ASSERT_NE(candidates->begin(), candidates->end());
+  ASSERT_LT(candidates->size(),
+            provider->GetConfigurations(LeAudioContextType::MEDIA)->size());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace le_audio
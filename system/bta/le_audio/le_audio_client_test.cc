@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <future>
 
 #include "bta/csis/csis_types.h"
 #include "bta_gatt_api_mock.h"
@@ -2184,9 +2185,19 @@ class UnicastTestNoInit : public Test {
     std::vector<uint8_t> data(data_len);
     unicast_source_hal_cb_->OnAudioDataReady(data);
 
-    // Inject microphone data from group
-    EXPECT_CALL(*mock_le_audio_sink_hal_client_, SendData(_, _))
-        .Times(cis_count_in > 0 ? 1 : 0);
+    // Inject microphone data from group, decoded on the data path thread
+    bool expect_sink_data = (cis_count_in > 0);
+    std::promise<void> sink_data_promise;
+    auto sink_data_future = sink_data_promise.get_future();
+    if (expect_sink_data) {
+      EXPECT_CALL(*mock_le_audio_sink_hal_client_, SendData(_, _))
+          .WillOnce([&sink_data_promise](uint8_t* data, uint16_t size) {
+            sink_data_promise.set_value();
+            return size;
+          });
+    } else {
+      EXPECT_CALL(*mock_le_audio_sink_hal_client_, SendData(_, _)).Times(0);
+    }
     ASSERT_EQ(streaming_groups.count(group_id), 1u);
 
     if (cis_count_in) {
@@ -2207,6 +2218,10 @@ class UnicastTestNoInit : public Test {
     }
 
     SyncOnMainLoop();
+    if (expect_sink_data) {
+      ASSERT_EQ(sink_data_future.wait_for(std::chrono::seconds(1)),
+                std::future_status::ready);
+    }
     std::sort(handles.begin(), handles.end());
     ASSERT_EQ(cis_count_in, 0);
     handles.clear();
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace le_audio {
+
+/* Histogram of the latencies of a stage of the audio data path. The first
+ * bucket counts the latencies shorter than 250 us, bucket i those shorter
+ * than 250 us * 2^i, and the last one all the longer ones.
+ */
+struct LatencyHistogram {
+  static constexpr size_t kNumBuckets = 12;
+  static constexpr uint64_t kFirstBucketUs = 250;
+
+  std::array<uint32_t, kNumBuckets> buckets{};
+  uint32_t count = 0;
+  uint64_t total_us = 0;
+  uint64_t max_us = 0;
+
+  void Add(uint64_t latency_us) {
+    uint64_t bound_us = kFirstBucketUs;
+    size_t bucket = 0;
+    while (latency_us >= bound_us && bucket < kNumBuckets - 1) {
+      bound_us <<= 1;
+      bucket++;
+    }
+
+    buckets[bucket]++;
+    count++;
+    total_us += latency_us;
+    max_us = std::max(max_us, latency_us);
+  }
+
+  void Reset() { *this = LatencyHistogram(); }
+
+  /* Returns an upper bound of the given percentile of the latencies */
+  uint64_t PercentileUs(uint8_t percentile) const {
+    uint64_t rank = ((uint64_t)count * percentile + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets - 1; bucket++) {
+      seen += buckets[bucket];
+      if (seen >= rank) return std::min(kFirstBucketUs << bucket, max_us);
+    }
+    return max_us;
+  }
+
+  std::string ToString() const {
+    std::stringstream stream;
+    stream << "count: " << count;
+    if (count == 0) return stream.str();
+
+    stream << ", avg: " << total_us / count << " us"
+           << ", p50: " << PercentileUs(50) << " us"
+           << ", p99: " << PercentileUs(99) << " us"
+           << ", max: " << max_us << " us";
+    return stream.str();
+  }
+};
+
+}  // namespace le_audio
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "le_audio_latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+namespace le_audio {
+
+TEST(LatencyHistogramTest, buckets) {
+  LatencyHistogram histogram;
+  histogram.Add(0);
+  histogram.Add(249);
+  histogram.Add(250);
+  histogram.Add(499);
+  histogram.Add(500);
+  histogram.Add(10 * 1000 * 1000);
+
+  ASSERT_EQ(histogram.buckets[0], 2u);
+  ASSERT_EQ(histogram.buckets[1], 2u);
+  ASSERT_EQ(histogram.buckets[2], 1u);
+  ASSERT_EQ(histogram.buckets[LatencyHistogram::kNumBuckets - 1], 1u);
+  ASSERT_EQ(histogram.count, 6u);
+  ASSERT_EQ(histogram.max_us, 10u * 1000 * 1000);
+}
+
+TEST(LatencyHistogramTest, percentiles) {
+  LatencyHistogram histogram;
+  ASSERT_EQ(histogram.PercentileUs(99), 0u);
+  ASSERT_EQ(histogram.ToString(), "count: 0");
+
+  for (int i = 0; i < 98; i++) histogram.Add(100);
+  histogram.Add(1200);
+  histogram.Add(3000);
+
+  ASSERT_EQ(histogram.PercentileUs(50), 250u);
+  ASSERT_EQ(histogram.PercentileUs(99), 2000u);
+  // Bounded by the longest latency
+  ASSERT_EQ(histogram.PercentileUs(100), 3000u);
+  ASSERT_EQ(histogram.ToString(),
+            "count: 100, avg: 140 us, p50: 250 us, p99: 2000 us, max: 3000 us");
+
+  histogram.Reset();
+  ASSERT_EQ(histogram.count, 0u);
+  ASSERT_EQ(histogram.buckets[0], 0u);
+}
+
+}  // namespace le_audio
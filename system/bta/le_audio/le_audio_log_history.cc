@@ -23,6 +23,7 @@
 #include <string>
 
 #include "gd/common/circular_buffer.h"
+#include "gd/common/lock_free_circular_buffer.h"
 #include "gd/common/strings.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/log.h"
@@ -33,22 +34,35 @@ constexpr size_t kMaxLogSize = 255;
 constexpr size_t kLeAudioLogHistoryBufferSize = 200;
 
 class TimestampedStringCircularBuffer
-    : public bluetooth::common::TimestampedCircularBuffer<std::string> {
+    : public bluetooth::common::TimestampedLockFreeCircularBuffer<
+          bluetooth::common::BoundedString<kMaxLogSize>> {
  public:
+  using LogLine = bluetooth::common::BoundedString<kMaxLogSize>;
+
   explicit TimestampedStringCircularBuffer(size_t size)
-      : bluetooth::common::TimestampedCircularBuffer<std::string>(size) {}
+      : bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>(size) {}
 
   void Push(const std::string& s) {
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        s.substr(0, kMaxLogSize));
+    bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>::Push(
+        LogLine(s));
   }
 
   template <typename... Args>
   void Push(Args... args) {
-    char buf[kMaxLogSize];
-    std::snprintf(buf, sizeof(buf), args...);
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        std::string(buf));
+    // Formatted in place, the history is pushed to without allocating
+    LogLine line;
+    std::snprintf(line.data, sizeof(line.data), args...);
+    bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>::Push(line);
+  }
+
+  std::vector<bluetooth::common::TimestampedEntry<std::string>> Pull() const {
+    std::vector<bluetooth::common::TimestampedEntry<std::string>> records;
+    for (const auto& record :
+         bluetooth::common::TimestampedLockFreeCircularBuffer<
+             LogLine>::Pull()) {
+      records.push_back({record.timestamp, record.entry.ToString()});
+    }
+    return records;
   }
 };
 
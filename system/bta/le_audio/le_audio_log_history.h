@@ -29,6 +29,7 @@ static std::string kLogAseStateNotif("ASE_NOTIF");
 static std::string kLogHciEvent("HCI_EVENT");
 static std::string kLogAfCallBt("AF --> ");
 static std::string kLogBtCallAf("AF <-- ");
+static std::string kLogIsoDataPath("ISO_DATA_PATH");
 
 /* Operations on SM and ASEs */
 static std::string kLogStateChangedOp("STATE CHANGED");
@@ -54,6 +55,9 @@ static std::string kLogSetDataPathOp("SET_DATA_PATH: ");
 static std::string kLogRemoveDataPathOp("REMOVE_DATA_PATH: ");
 static std::string kLogDataPathCompleteOp("DATA_PATH_COMPLETE: ");
 
+/* ISO data path statistics */
+static std::string kLogSduLatencyOp("SDU_LATENCY: ");
+
 /* AF Client operations */
 static std::string kLogAfResume("RESUME_REQ: ");
 static std::string kLogAfSuspend("SUSPEND_REQ: ");
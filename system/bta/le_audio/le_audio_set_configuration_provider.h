@@ -32,6 +32,17 @@ class AudioSetConfigurationProvider {
   static void Cleanup();
   virtual const set_configurations::AudioSetConfigurations* GetConfigurations(
       ::le_audio::types::LeAudioContextType content_type) const;
+  /* Returns the configurations of GetConfigurations(), in the same order,
+   * which may be supported by |num_of_devices| devices with the
+   * |snk_strategy| sink strategy and ASEs in the |directions|
+   * (kLeAudioDirectionSink | kLeAudioDirectionSource).
+   */
+  virtual const set_configurations::AudioSetConfigurations*
+  GetCandidateConfigurations(
+      ::le_audio::types::LeAudioContextType content_type,
+      uint8_t num_of_devices,
+      ::le_audio::types::LeAudioConfigurationStrategy snk_strategy,
+      uint8_t directions) const;
 
  private:
   struct impl;
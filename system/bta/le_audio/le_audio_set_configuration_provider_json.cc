@@ -15,9 +15,17 @@
  *
  */
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <map>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <tuple>
 
 #include "audio_set_configurations_generated.h"
 #include "audio_set_scenarios_generated.h"
@@ -64,6 +72,49 @@ static const std::vector<
         {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
 #endif
 
+/* Content file precompiled to a flatbuffer binary at build time, mapped in
+ * memory for the time of the import.
+ */
+class MappedBinaryContent {
+ public:
+  explicit MappedBinaryContent(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_ = static_cast<const uint8_t*>(addr);
+        size_ = st.st_size;
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedBinaryContent() {
+    if (data_ != nullptr) munmap(const_cast<uint8_t*>(data_), size_);
+  }
+
+  MappedBinaryContent(const MappedBinaryContent&) = delete;
+  MappedBinaryContent& operator=(const MappedBinaryContent&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+/* Returns the path of the binary precompiled from the JSON |content_file| */
+static std::string BinaryContentPath(const char* content_file) {
+  std::string path(content_file);
+  auto extension = path.rfind(".json");
+  if (extension != std::string::npos) path.replace(extension, 5, ".bin");
+  return path;
+}
+
 /** Provides a set configurations for the given context type */
 struct AudioSetConfigurationProviderJson {
   static constexpr auto kDefaultScenario = "Media";
@@ -401,6 +452,19 @@ struct AudioSetConfigurationProviderJson {
 
   bool LoadConfigurationsFromFiles(const char* schema_file,
                                    const char* content_file) {
+    /* Prefer the content precompiled at build time, which needs no parsing */
+    MappedBinaryContent binary_content(BinaryContentPath(content_file));
+    if (binary_content.data() != nullptr) {
+      flatbuffers::Verifier verifier(binary_content.data(),
+                                     binary_content.size());
+      if (bluetooth::le_audio::VerifyAudioSetConfigurationsBuffer(verifier)) {
+        return LoadConfigurations(
+            bluetooth::le_audio::GetAudioSetConfigurations(
+                binary_content.data()));
+      }
+      LOG_WARN("Invalid precompiled content, parsing %s", content_file);
+    }
+
     flatbuffers::Parser configurations_parser_;
     std::string configurations_schema_binary_content;
     bool ok = flatbuffers::LoadFile(schema_file, true,
@@ -423,9 +487,13 @@ struct AudioSetConfigurationProviderJson {
     ok = configurations_parser_.Parse(configurations_json_content.c_str());
     if (!ok) return ok;
 
-    /* Import from flatbuffers */
-    auto configurations_root = bluetooth::le_audio::GetAudioSetConfigurations(
-        configurations_parser_.builder_.GetBufferPointer());
+    return LoadConfigurations(bluetooth::le_audio::GetAudioSetConfigurations(
+        configurations_parser_.builder_.GetBufferPointer()));
+  }
+
+  /* Imports the configurations from flatbuffers */
+  bool LoadConfigurations(
+      const bluetooth::le_audio::AudioSetConfigurations* configurations_root) {
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -479,6 +547,18 @@ struct AudioSetConfigurationProviderJson {
 
   bool LoadScenariosFromFiles(const char* schema_file,
                               const char* content_file) {
+    /* Prefer the content precompiled at build time, which needs no parsing */
+    MappedBinaryContent binary_content(BinaryContentPath(content_file));
+    if (binary_content.data() != nullptr) {
+      flatbuffers::Verifier verifier(binary_content.data(),
+                                     binary_content.size());
+      if (bluetooth::le_audio::VerifyAudioSetScenariosBuffer(verifier)) {
+        return LoadScenarios(
+            bluetooth::le_audio::GetAudioSetScenarios(binary_content.data()));
+      }
+      LOG_WARN("Invalid precompiled content, parsing %s", content_file);
+    }
+
     flatbuffers::Parser scenarios_parser_;
     std::string scenarios_schema_binary_content;
     bool ok = flatbuffers::LoadFile(schema_file, true,
@@ -500,9 +580,13 @@ struct AudioSetConfigurationProviderJson {
     ok = scenarios_parser_.Parse(scenarios_json_content.c_str());
     if (!ok) return ok;
 
-    /* Import from flatbuffers */
-    auto scenarios_root = bluetooth::le_audio::GetAudioSetScenarios(
-        scenarios_parser_.builder_.GetBufferPointer());
+    return LoadScenarios(bluetooth::le_audio::GetAudioSetScenarios(
+        scenarios_parser_.builder_.GetBufferPointer()));
+  }
+
+  /* Imports the scenarios from flatbuffers */
+  bool LoadScenarios(
+      const bluetooth::le_audio::AudioSetScenarios* scenarios_root) {
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
@@ -552,13 +636,110 @@ struct AudioSetConfigurationProvider::impl {
     ASSERT_LOG(!config_provider_impl_, " Config provider not available.");
     config_provider_impl_ =
         std::make_unique<AudioSetConfigurationProviderJson>();
+    BuildCandidatesIndex();
   }
 
   void Cleanup() {
     ASSERT_LOG(config_provider_impl_, " Config provider not available.");
+    candidates_index_.clear();
     config_provider_impl_.reset();
   }
 
+  struct CandidatesKey {
+    LeAudioContextType context_type;
+    uint8_t num_of_devices;
+    types::LeAudioConfigurationStrategy snk_strategy;
+    uint8_t directions;
+
+    bool operator<(const CandidatesKey& other) const {
+      return std::tie(context_type, num_of_devices, snk_strategy, directions) <
+             std::tie(other.context_type, other.num_of_devices,
+                      other.snk_strategy, other.directions);
+    }
+  };
+
+  /* Checks the requirements of |conf| which do not depend on the devices
+   * capabilities, the rest being checked by the device group.
+   */
+  static bool MayBeSupported(const AudioSetConfiguration* conf,
+                             const CandidatesKey& key) {
+    if (!set_configurations::check_if_may_cover_scenario(conf,
+                                                         key.num_of_devices))
+      return false;
+
+    for (const auto& ent : conf->confs) {
+      if (!(ent.direction & key.directions)) return false;
+      if (ent.direction == types::kLeAudioDirectionSink &&
+          ent.strategy != key.snk_strategy)
+        return false;
+    }
+    return true;
+  }
+
+  static void FilterCandidates(const AudioSetConfigurations& confs,
+                               const CandidatesKey& key,
+                               AudioSetConfigurations& candidates) {
+    candidates.clear();
+    for (const auto* conf : confs) {
+      if (MayBeSupported(conf, key)) candidates.push_back(conf);
+    }
+  }
+
+  /* Indexes the software configurations of each context type, for the group
+   * sizes they support. Offload configurations are filtered on request.
+   */
+  void BuildCandidatesIndex() {
+    static constexpr types::LeAudioConfigurationStrategy kSnkStrategies[] = {
+        types::LeAudioConfigurationStrategy::MONO_ONE_CIS_PER_DEVICE,
+        types::LeAudioConfigurationStrategy::STEREO_TWO_CISES_PER_DEVICE,
+        types::LeAudioConfigurationStrategy::STEREO_ONE_CIS_PER_DEVICE,
+    };
+    static constexpr uint8_t kDirections[] = {
+        types::kLeAudioDirectionSink,
+        types::kLeAudioDirectionSource,
+        types::kLeAudioDirectionSink | types::kLeAudioDirectionSource,
+    };
+
+    for (LeAudioContextType context : types::kLeAudioContextAllTypesArray) {
+      auto confs =
+          config_provider_impl_->GetConfigurationsByContextType(context);
+      if (confs == nullptr) continue;
+
+      uint8_t max_num_of_devices = 1;
+      for (const auto* conf : *confs) {
+        max_num_of_devices = std::max(
+            max_num_of_devices,
+            set_configurations::get_num_of_devices_in_configuration(conf));
+      }
+
+      for (uint8_t num_of_devices = 1; num_of_devices <= max_num_of_devices;
+           num_of_devices++) {
+        for (auto snk_strategy : kSnkStrategies) {
+          for (auto directions : kDirections) {
+            CandidatesKey key = {context, num_of_devices, snk_strategy,
+                                 directions};
+            auto& entry = candidates_index_[key];
+            entry.confs = confs;
+            FilterCandidates(*confs, key, entry.candidates);
+          }
+        }
+      }
+    }
+  }
+
+  const AudioSetConfigurations* GetCandidates(
+      const AudioSetConfigurations* confs, CandidatesKey key) {
+    if (confs == nullptr) return nullptr;
+
+    auto it = candidates_index_.find(key);
+    if (it != candidates_index_.end() && it->second.confs == confs)
+      return &it->second.candidates;
+
+    /* Offload configurations, or groups larger than any configuration */
+    FilterCandidates(*confs, key, filtered_candidates_);
+    return &filtered_candidates_;
+  }
+
   bool IsRunning() { return config_provider_impl_ ? true : false; }
 
   void Dump(int fd) {
@@ -594,8 +775,16 @@ struct AudioSetConfigurationProvider::impl {
     dprintf(fd, "%s", stream.str().c_str());
   }
 
+  struct Candidates {
+    /* Configurations the candidates were selected from */
+    const AudioSetConfigurations* confs = nullptr;
+    AudioSetConfigurations candidates;
+  };
+
   const AudioSetConfigurationProvider& config_provider_;
   std::unique_ptr<AudioSetConfigurationProviderJson> config_provider_impl_;
+  std::map<CandidatesKey, Candidates> candidates_index_;
+  AudioSetConfigurations filtered_candidates_;
 };
 
 static std::unique_ptr<AudioSetConfigurationProvider> config_provider;
@@ -668,4 +857,14 @@ AudioSetConfigurationProvider::GetConfigurations(
   return nullptr;
 }
 
+const set_configurations::AudioSetConfigurations*
+AudioSetConfigurationProvider::GetCandidateConfigurations(
+    ::le_audio::types::LeAudioContextType content_type, uint8_t num_of_devices,
+    ::le_audio::types::LeAudioConfigurationStrategy snk_strategy,
+    uint8_t directions) const {
+  return pimpl_->GetCandidates(
+      GetConfigurations(content_type),
+      {content_type, num_of_devices, snk_strategy, directions});
+}
+
 }  // namespace le_audio
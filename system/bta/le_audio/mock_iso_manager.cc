@@ -17,6 +17,9 @@
 
 #include "mock_iso_manager.h"
 
+#include <map>
+#include <vector>
+
 MockIsoManager* mock_pimpl_;
 MockIsoManager* MockIsoManager::GetInstance() {
   bluetooth::hci::IsoManager::GetInstance();
@@ -30,6 +33,9 @@ struct IsoManager::impl : public MockIsoManager {
  public:
   impl() = default;
   ~impl() = default;
+
+  // The data written in place, sent through the mocked SendIsoData
+  std::map<uint16_t, std::vector<uint8_t>> iso_data_buffers;
 };
 
 IsoManager::IsoManager() {}
@@ -100,6 +106,21 @@ void IsoManager::SendIsoData(uint16_t iso_handle, const uint8_t* data,
   pimpl_->SendIsoData(iso_handle, data, data_len);
 }
 
+uint8_t* IsoManager::GetIsoDataBuffer(uint16_t iso_handle, uint16_t data_len) {
+  if (!pimpl_) return nullptr;
+  auto& buffer = pimpl_->iso_data_buffers[iso_handle];
+  buffer.assign(data_len, 0);
+  return buffer.data();
+}
+
+void IsoManager::SendIsoDataBuffer(uint16_t iso_handle) {
+  if (!pimpl_) return;
+  auto it = pimpl_->iso_data_buffers.find(iso_handle);
+  if (it == pimpl_->iso_data_buffers.end()) return;
+  pimpl_->SendIsoData(iso_handle, it->second.data(), it->second.size());
+  pimpl_->iso_data_buffers.erase(it);
+}
+
 void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {
   if (!pimpl_) return;
@@ -110,15 +110,6 @@ using le_audio::types::LeAudioContextType;
 
 namespace {
 
-constexpr int linkQualityCheckInterval = 4000;
-
-static void link_quality_cb(void* data) {
-  // very ugly, but we need to pass just two bytes
-  uint16_t cis_conn_handle = *((uint16_t*)data);
-
-  IsoManager::GetInstance()->ReadIsoLinkQuality(cis_conn_handle);
-}
-
 class LeAudioGroupStateMachineImpl;
 LeAudioGroupStateMachineImpl* instance;
 
@@ -175,6 +166,15 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
     switch (group->GetState()) {
       case AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED:
+        /* A different context served by the same configuration does not need
+         * a new codec configuration, only the metadata of the ASEs.
+         */
+        if (group->GetConfigurationContextType() != context_type &&
+            group->IsConfigurationReusable(context_type)) {
+          group->ReuseConfiguration(context_type, metadata_context_types,
+                                    ccid_lists);
+        }
+
         if (group->GetConfigurationContextType() == context_type) {
           if (group->Activate(context_type)) {
             SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
@@ -220,6 +220,19 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return false;
         }
 
+        /* Enable carries the metadata, so let it match the new context */
+        if (group->GetConfigurationContextType() != context_type) {
+          if (group->IsConfigurationReusable(context_type)) {
+            group->ReuseConfiguration(context_type, metadata_context_types,
+                                      ccid_lists);
+          } else {
+            LOG_WARN("Enabling group %d configured for %s, requested %s",
+                     group->group_id_,
+                     ToString(group->GetConfigurationContextType()).c_str(),
+                     ToString(context_type).c_str());
+          }
+        }
+
         /* All ASEs should aim to achieve target state */
         SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
         PrepareAndSendEnableToTheGroup(group);
@@ -423,13 +436,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     }
   }
 
-  void FreeLinkQualityReports(LeAudioDevice* leAudioDevice) {
-    if (leAudioDevice->link_quality_timer == nullptr) return;
-
-    alarm_free(leAudioDevice->link_quality_timer);
-    leAudioDevice->link_quality_timer = nullptr;
-  }
-
   void ProcessHciNotifyOnCigRemoveRecovering(uint8_t status,
                                              LeAudioDeviceGroup* group) {
     group->SetCigState(CigState::NONE);
@@ -482,8 +488,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     if (!leAudioDevice) return;
 
     do {
-      FreeLinkQualityReports(leAudioDevice);
-
       for (auto& ase : leAudioDevice->ases_) {
         ase.data_path_state = AudioStreamDataPathState::IDLE;
       }
@@ -643,7 +647,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
   void ProcessHciNotifAclDisconnected(LeAudioDeviceGroup* group,
                                       LeAudioDevice* leAudioDevice) {
-    FreeLinkQualityReports(leAudioDevice);
     /* mark ASEs as not used. */
     leAudioDevice->DeactivateAllAses();
 
@@ -770,16 +773,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       ases_pair.source->data_path_state =
           AudioStreamDataPathState::CIS_ESTABLISHED;
 
-    if (osi_property_get_bool("persist.bluetooth.iso_link_quality_report",
-                              false)) {
-      leAudioDevice->link_quality_timer =
-          alarm_new_periodic("le_audio_cis_link_quality");
-      leAudioDevice->link_quality_timer_data = event->cis_conn_hdl;
-      alarm_set_on_mloop(leAudioDevice->link_quality_timer,
-                         linkQualityCheckInterval, link_quality_cb,
-                         &leAudioDevice->link_quality_timer_data);
-    }
-
     if (!leAudioDevice->HaveAllActiveAsesCisEst()) {
       /* More cis established events has to come */
       return;
@@ -869,8 +862,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       const bluetooth::hci::iso_manager::cis_disconnected_evt* event) override {
     /* Reset the disconnected CIS states */
 
-    FreeLinkQualityReports(leAudioDevice);
-
     auto ases_pair = leAudioDevice->GetAsesByCisConnHdl(event->cis_conn_hdl);
 
     log_history_->AddLogHistory(
@@ -1996,7 +1987,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
         /* TODO: Config Codec */
         break;
       case AseState::BTA_LE_AUDIO_ASE_STATE_RELEASING:
-        LeAudioDevice* leAudioDeviceNext;
         SetAseState(leAudioDevice, ase,
                     AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
         ase->active = false;
@@ -2019,35 +2009,36 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
-        leAudioDeviceNext = group->GetNextActiveDevice(leAudioDevice);
-
-        /* Configure ASEs for next device in group */
-        if (leAudioDeviceNext) {
-          PrepareAndSendRelease(leAudioDeviceNext);
-        } else {
-          /* Last node is in releasing state*/
+        /* Release was sent to all the devices at once, so just wait for the
+         * remaining ones to complete it
+         */
+        if (!group->HaveAllActiveDevicesAsesTheSameState(
+                AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED)) {
+          LOG_DEBUG("Waiting for more devices to get into configured state");
+          return;
+        }
 
-          group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
-          /* Remote device has cache and keep staying in configured state after
-           * release. Therefore, we assume this is a target state requested by
-           * remote device.
-           */
-          group->SetTargetState(group->GetState());
+        /* Last node is in releasing state*/
+        group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
+        /* Remote device has cache and keep staying in configured state after
+         * release. Therefore, we assume this is a target state requested by
+         * remote device.
+         */
+        group->SetTargetState(group->GetState());
 
-          if (!group->HaveAllCisesDisconnected()) {
-            LOG_WARN(
-                "Not all CISes removed before going to IDLE for group %d, "
-                "waiting...",
-                group->group_id_);
-            group->PrintDebugState();
-            return;
-          }
+        if (!group->HaveAllCisesDisconnected()) {
+          LOG_WARN(
+              "Not all CISes removed before going to IDLE for group %d, "
+              "waiting...",
+              group->group_id_);
+          group->PrintDebugState();
+          return;
+        }
 
-          cancel_watchdog_if_needed(group->group_id_);
+        cancel_watchdog_if_needed(group->group_id_);
 
-          state_machine_callbacks_->StatusReportCb(
-              group->group_id_, GroupStreamStatus::CONFIGURED_AUTONOMOUS);
-        }
+        state_machine_callbacks_->StatusReportCb(
+            group->group_id_, GroupStreamStatus::CONFIGURED_AUTONOMOUS);
         break;
       default:
         LOG(ERROR) << __func__ << ", invalid state transition, from: "
@@ -169,6 +169,9 @@ typedef void(tBTA_SYS_CONN_CBACK)(tBTA_SYS_CONN_STATUS status, uint8_t id,
 typedef void(tBTA_SYS_SSR_CFG_CBACK)(uint8_t id, uint8_t app_id,
                                      uint16_t latency, uint16_t tout);
 
+/* burst callback for low power manager */
+typedef void(tBTA_SYS_BURST_CBACK)(uint8_t id, const RawAddress& peer_addr);
+
 typedef struct {
   bluetooth::Uuid custom_uuid;
   uint32_t handle;
@@ -232,6 +235,9 @@ void bta_sys_sco_unuse(uint8_t id, uint8_t app_id, const RawAddress& peer_addr);
 void bta_sys_idle(uint8_t id, uint8_t app_id, const RawAddress& peer_addr);
 void bta_sys_busy(uint8_t id, uint8_t app_id, const RawAddress& peer_addr);
 
+void bta_sys_burst_register(tBTA_SYS_BURST_CBACK* p_cback);
+void bta_sys_expect_burst(uint8_t id, const RawAddress& peer_addr);
+
 void bta_sys_ssr_cfg_register(tBTA_SYS_SSR_CFG_CBACK* p_cback);
 void bta_sys_chg_ssr_config(uint8_t id, uint8_t app_id, uint16_t max_latency,
                             uint16_t min_tout);
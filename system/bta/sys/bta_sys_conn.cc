@@ -386,6 +386,37 @@ void bta_sys_busy(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_sys_burst_register
+ *
+ * Description      Called by BTA DM to register the callback told of the
+ *                  traffic bursts expected by the other BTA modules
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_burst_register(tBTA_SYS_BURST_CBACK* p_cback) {
+  bta_sys_cb.p_burst_cb = p_cback;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_expect_burst
+ *
+ * Description      Called by BTA subsystems to indicate that a burst of
+ *                  traffic with the peer device is about to start, before
+ *                  the connection is marked busy
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_expect_burst(uint8_t id, const RawAddress& peer_addr) {
+  if (bta_sys_cb.p_burst_cb) {
+    bta_sys_cb.p_burst_cb(id, peer_addr);
+  }
+}
+
 #if (BTA_EIR_CANNED_UUID_LIST != TRUE)
 /*******************************************************************************
  *
@@ -62,6 +62,7 @@ typedef struct {
   tBTA_SYS_CUST_EIR_CBACK* cust_eir_cb; /* add/remove customer UUID into EIR */
 #endif
   tBTA_SYS_SSR_CFG_CBACK* p_ssr_cb;
+  tBTA_SYS_BURST_CBACK* p_burst_cb; /* traffic burst hint registered by DM */
   /* VS event handler */
   tBTA_SYS_VS_EVT_HDLR* p_vs_evt_hdlr;
 
@@ -39,6 +39,12 @@ using namespace std::chrono_literals;
 
 namespace {
 const RawAddress kRawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const tAVDT_SEP_INFO kSinkSep = {
+    .in_use = false,
+    .seid = 1,
+    .media_type = AVDT_MEDIA_TYPE_AUDIO,
+    .tsep = AVDT_TSEP_SNK,
+};
 }  // namespace
 
 // TODO move into mock
@@ -87,3 +93,80 @@ TEST_F(BtaAvTest, bta_av_rc_opened) {
   };
   bta_av_rc_opened(&cb, &data);
 }
+
+TEST_F(BtaAvTest, bta_av_caps_cache) {
+  AvdtpSepConfig caps;
+  caps.num_codec = 1;
+  caps.codec_info[0] = 6;
+  caps.psc_mask = AVDT_PSC_TRANS | AVDT_PSC_DELAY_RPT;
+
+  AvdtpSepConfig cached;
+  ASSERT_FALSE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                        kSinkSep, &cached));
+
+  bta_av_caps_cache_store(kRawAddress, AVDT_VERSION_1_3, kSinkSep, caps);
+  ASSERT_TRUE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                       kSinkSep, &cached));
+  ASSERT_EQ(caps.num_codec, cached.num_codec);
+  ASSERT_EQ(caps.codec_info[0], cached.codec_info[0]);
+  ASSERT_EQ(caps.psc_mask, cached.psc_mask);
+
+  // The in use flag of the discovery results does not change the capabilities
+  tAVDT_SEP_INFO in_use_sep = kSinkSep;
+  in_use_sep.in_use = true;
+  ASSERT_TRUE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                       in_use_sep, &cached));
+
+  // Another SEP, or the capabilities of another AVDTP version, are not cached
+  tAVDT_SEP_INFO other_sep = kSinkSep;
+  other_sep.seid = 2;
+  ASSERT_FALSE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                        other_sep, &cached));
+  ASSERT_FALSE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_2,
+                                        kSinkSep, &cached));
+
+  bta_av_caps_cache_remove(kRawAddress);
+  ASSERT_FALSE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                        kSinkSep, &cached));
+}
+
+TEST_F(BtaAvTest, bta_av_caps_cache_check_seps) {
+  AvdtpSepConfig caps;
+  AvdtpSepConfig cached;
+  bta_av_caps_cache_store(kRawAddress, AVDT_VERSION_1_3, kSinkSep, caps);
+
+  tAVDT_SEP_INFO seps[2] = {kSinkSep, kSinkSep};
+  seps[1].seid = 2;
+  bta_av_caps_cache_check_seps(kRawAddress, seps, 2);
+  ASSERT_TRUE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                       kSinkSep, &cached));
+
+  // The cached SEP is no longer discovered
+  bta_av_caps_cache_check_seps(kRawAddress, &seps[1], 1);
+  ASSERT_FALSE(bta_av_caps_cache_lookup(kRawAddress, AVDT_VERSION_1_3,
+                                        kSinkSep, &cached));
+}
+
+TEST_F(BtaAvTest, bta_av_caps_cache_evicts_the_least_recently_used_peer) {
+  AvdtpSepConfig caps;
+  AvdtpSepConfig cached;
+  std::vector<RawAddress> peers;
+  for (uint8_t i = 0; i <= BTA_AV_CAPS_CACHE_MAX_PEERS; i++) {
+    peers.push_back(RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, i}));
+  }
+  for (size_t i = 0; i < BTA_AV_CAPS_CACHE_MAX_PEERS; i++) {
+    bta_av_caps_cache_store(peers[i], AVDT_VERSION_1_3, kSinkSep, caps);
+  }
+  // The first peer is used again, the second one is now the oldest
+  ASSERT_TRUE(bta_av_caps_cache_lookup(peers[0], AVDT_VERSION_1_3, kSinkSep,
+                                       &cached));
+  bta_av_caps_cache_store(peers.back(), AVDT_VERSION_1_3, kSinkSep, caps);
+
+  ASSERT_TRUE(bta_av_caps_cache_lookup(peers[0], AVDT_VERSION_1_3, kSinkSep,
+                                       &cached));
+  ASSERT_FALSE(bta_av_caps_cache_lookup(peers[1], AVDT_VERSION_1_3, kSinkSep,
+                                        &cached));
+  for (const auto& peer : peers) {
+    bta_av_caps_cache_remove(peer);
+  }
+}
@@ -250,6 +250,10 @@ void bta_dm_remname_cback(const tBTM_REMOTE_DEV_NAME* p);
 tBT_TRANSPORT bta_dm_determine_discovery_transport(
     const RawAddress& remote_bd_addr);
 
+uint16_t bta_dm_pm_traffic_max_interval(uint32_t rate);
+
+uint8_t bta_dm_pm_traffic_sniff_index(uint32_t rate, uint8_t index);
+
 }  // namespace testing
 }  // namespace legacy
 }  // namespace bluetooth
@@ -525,3 +529,31 @@ TEST_F(BtaDmTest, bta_dm_search_evt_text) {
           static_cast<tBTA_DM_SEARCH_EVT>(std::numeric_limits<uint8_t>::max()))
           .c_str());
 }
+
+TEST_F(BtaDmTest, bta_dm_pm_traffic_max_interval) {
+  // No traffic, no limit
+  ASSERT_EQ(0, bluetooth::legacy::testing::bta_dm_pm_traffic_max_interval(0));
+  // 512 bytes per anchor point
+  ASSERT_EQ(50,
+            bluetooth::legacy::testing::bta_dm_pm_traffic_max_interval(16384));
+  ASSERT_EQ(2, bluetooth::legacy::testing::bta_dm_pm_traffic_max_interval(
+                   std::numeric_limits<uint32_t>::max()));
+  ASSERT_EQ(std::numeric_limits<uint16_t>::max(),
+            bluetooth::legacy::testing::bta_dm_pm_traffic_max_interval(1));
+}
+
+TEST_F(BtaDmTest, bta_dm_pm_traffic_sniff_index) {
+  // BTA_DM_PM_SNIFF of 800 slots is kept while the traffic allows it
+  ASSERT_EQ(0, bluetooth::legacy::testing::bta_dm_pm_traffic_sniff_index(0, 0));
+  ASSERT_EQ(0,
+            bluetooth::legacy::testing::bta_dm_pm_traffic_sniff_index(1024, 0));
+  // Longest interval within 50 slots is BTA_DM_PM_SNIFF5 of 36 slots
+  ASSERT_EQ(
+      5, bluetooth::legacy::testing::bta_dm_pm_traffic_sniff_index(16384, 0));
+  // Shorter entries than the limit are not lengthened
+  ASSERT_EQ(
+      4, bluetooth::legacy::testing::bta_dm_pm_traffic_sniff_index(16384, 4));
+  // Nothing fits, the first shortest entry BTA_DM_PM_SNIFF4 of 18 slots
+  ASSERT_EQ(4, bluetooth::legacy::testing::bta_dm_pm_traffic_sniff_index(
+                   std::numeric_limits<uint32_t>::max(), 0));
+}
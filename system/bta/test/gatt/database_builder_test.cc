@@ -178,4 +178,52 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   ASSERT_EQ(service, result.Services().end());
 }
 
+/* This test verifies that DatabaseBuilder keeps track of several services
+ * explored at the same time, each over its own EATT bearer. */
+TEST(DatabaseBuilderTest, ParallelServiceExplorationTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x0010, SERVICE_2_UUID, true);
+  builder.AddService(0x0020, 0x002f, SERVICE_3_UUID, true);
+
+  std::pair<uint16_t, uint16_t> first, second, found;
+  EXPECT_TRUE(builder.StartServiceExploration(&first));
+  ASSERT_EQ(first, make_pair_u16(0x0001, 0x000f));
+  // Empty service is skipped
+  EXPECT_TRUE(builder.StartServiceExploration(&second));
+  ASSERT_EQ(second, make_pair_u16(0x0020, 0x002f));
+  EXPECT_FALSE(builder.StartServiceExploration(&found));
+  EXPECT_EQ(builder.NumServicesBeingExplored(), (size_t)2);
+
+  // Discovery results are matched to their service by end handle
+  EXPECT_TRUE(builder.FindExploredService(0x000f, &found));
+  ASSERT_EQ(found, first);
+  EXPECT_TRUE(builder.FindExploredService(0x0025, &found));
+  ASSERT_EQ(found, second);
+  EXPECT_FALSE(builder.FindExploredService(0x0010, &found));
+
+  builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0021, 0x0022, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0025, 0x0026, SERVICE_1_CHAR_1_UUID, 0x02);
+
+  // Each service has its own pending characteristic
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(0x0020),
+            make_pair_u16(0x0023, 0x0024));
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(0x0001),
+            make_pair_u16(0x0004, 0x000f));
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(0x0020),
+            make_pair_u16(0x0027, 0x002f));
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(0x0001),
+            DatabaseBuilder::EXPLORE_END);
+
+  builder.FinishServiceExploration(0x0001);
+  EXPECT_EQ(builder.NumServicesBeingExplored(), (size_t)1);
+  EXPECT_FALSE(builder.FindExploredService(0x000f, &found));
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(0x0020),
+            DatabaseBuilder::EXPLORE_END);
+  builder.FinishServiceExploration(0x0020);
+  EXPECT_EQ(builder.NumServicesBeingExplored(), (size_t)0);
+}
+
 }  // namespace gatt
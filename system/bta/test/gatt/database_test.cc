@@ -97,6 +97,73 @@ TEST(GattDatabaseTest, serialize_deserialize_binary_test) {
   EXPECT_EQ(serialized[5].value.characteristic_extended_properties, 0x0001);
 }
 
+/* This test makes sure that attributes are found by handle and services by
+ * UUID, also in copies of the database */
+TEST(GattDatabaseTest, find_attributes_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddService(0x0020, 0x002f, SERVICE_1_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddCharacteristic(0x0021, 0x0022, SERVICE_1_CHAR_1_UUID, 0x10);
+  Database db = builder.Build();
+  Database copy = db;
+  db.Clear();
+
+  EXPECT_EQ(copy.FindService(0x0000), nullptr);
+  EXPECT_EQ(copy.FindService(0x0005)->handle, 0x0001);
+  EXPECT_EQ(copy.FindService(0x001f)->handle, 0x0010);
+  EXPECT_EQ(copy.FindService(0x0030), nullptr);
+
+  EXPECT_EQ(copy.FindCharacteristic(0x0004)->declaration_handle, 0x0003);
+  EXPECT_EQ(copy.FindCharacteristic(0x0022)->properties, 0x10);
+  EXPECT_EQ(copy.FindCharacteristic(0x0005), nullptr);
+  EXPECT_EQ(copy.FindCharacteristic(0x0003), nullptr);
+
+  EXPECT_EQ(copy.FindDescriptor(0x0005)->uuid, SERVICE_1_CHAR_1_DESC_1_UUID);
+  EXPECT_EQ(copy.FindDescriptor(0x0004), nullptr);
+  EXPECT_EQ(copy.FindOwningCharacteristic(0x0005)->value_handle, 0x0004);
+  EXPECT_EQ(copy.FindOwningCharacteristic(0x0004), nullptr);
+
+  std::vector<const Service*> services = copy.FindServices(SERVICE_1_UUID);
+  ASSERT_EQ(services.size(), 2u);
+  EXPECT_EQ(services[0]->handle, 0x0001);
+  EXPECT_EQ(services[1]->handle, 0x0020);
+  EXPECT_TRUE(copy.FindServices(SERVICE_1_CHAR_1_UUID).empty());
+}
+
+/* This test makes sure that the compact form holds all the attributes, and is
+ * rejected when truncated */
+TEST(GattDatabaseTest, serialize_deserialize_compact_test) {
+  Uuid long_uuid = Uuid::FromString("00000000-0000-1000-8000-00805f9b34fc");
+
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, long_uuid, false);
+  builder.AddIncludedService(0x0002, long_uuid, 0x0010, 0x001f);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0006, CHARACTERISTIC_EXTENDED_PROPERTIES);
+  builder.AddCharacteristic(0x0011, 0x0012, long_uuid, 0x10);
+  builder.AddDescriptor(0x0013, long_uuid);
+  builder.SetValueOfDescriptors({0x0001});
+  Database db = builder.Build();
+
+  std::vector<uint8_t> compact = db.SerializeCompact();
+  EXPECT_LT(compact.size(), db.Serialize().size() * sizeof(StoredAttribute));
+
+  bool success = false;
+  Database result =
+      Database::DeserializeCompact(compact.data(), compact.size(), &success);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(result.ToString(), db.ToString());
+  EXPECT_EQ(result.Hash(), db.Hash());
+
+  Database::DeserializeCompact(compact.data(), compact.size() - 1, &success);
+  EXPECT_FALSE(success);
+}
+
 /* This test makes sure that Service represented in StoredAttribute have proper
  * binary format. */
 TEST(GattCacheTest, stored_attribute_to_binary_service_test) {
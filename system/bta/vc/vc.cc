@@ -21,6 +21,7 @@
 #include <base/strings/string_util.h>
 #include <hardware/bt_vc.h>
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -447,6 +448,7 @@ class VolumeControlImpl : public VolumeControl {
     auto addr = device->address;
     auto op = find_if(ongoing_operations_.begin(), ongoing_operations_.end(),
                       [addr](auto& operation) {
+                        if (!operation.IsStarted()) return false;
                         auto it = find(operation.devices_.begin(),
                                        operation.devices_.end(), addr);
                         return it != operation.devices_.end();
@@ -468,6 +470,8 @@ class VolumeControlImpl : public VolumeControl {
     if (!op->devices_.empty()) {
       DLOG(INFO) << __func__ << " wait for more responses for operation_id: "
                  << op->operation_id_;
+      /* The device is done with this operation, send its next one */
+      StartQueueOperation();
       return;
     }
 
@@ -688,8 +692,8 @@ class VolumeControlImpl : public VolumeControl {
       op->devices_.erase(it);
       if (op->devices_.empty()) {
         ongoing_operations_.erase(op);
-        StartQueueOperation();
       }
+      StartQueueOperation();
       return;
     }
   }
@@ -755,29 +759,54 @@ class VolumeControlImpl : public VolumeControl {
     instance->CancelVolumeOperation(PTR_TO_INT(data));
   }
 
+  /* Operations are started in order, each one as soon as none of its devices
+   * still waits for an earlier operation. That way a device has at most one
+   * write in flight, the members of a group are written in parallel, and the
+   * operations of distinct devices do not wait for each other.
+   */
   void StartQueueOperation(void) {
     LOG(INFO) << __func__;
-    if (ongoing_operations_.empty()) {
-      return;
-    };
 
-    auto op = &ongoing_operations_.front();
+    std::vector<RawAddress> busy_devices;
+    std::vector<int> operation_ids;
+    for (auto& op : ongoing_operations_) {
+      bool is_blocked =
+          std::any_of(op.devices_.begin(), op.devices_.end(),
+                      [&busy_devices](const RawAddress& addr) {
+                        return find(busy_devices.begin(), busy_devices.end(),
+                                    addr) != busy_devices.end();
+                      });
+      busy_devices.insert(busy_devices.end(), op.devices_.begin(),
+                          op.devices_.end());
 
-    LOG(INFO) << __func__ << " operation_id: " << op->operation_id_;
+      if (op.IsStarted()) continue;
+      if (is_blocked) {
+        LOG(INFO) << __func__ << " operation " << op.operation_id_
+                  << " waits for the previous operations of its devices";
+        continue;
+      }
 
-    if (op->IsStarted()) {
-      LOG(INFO) << __func__ << " wait until operation " << op->operation_id_
-                << " is complete";
-      return;
+      op.Start();
+      operation_ids.push_back(op.operation_id_);
     }
 
-    op->Start();
+    /* The writes may complete synchronously and modify the operation list */
+    for (int operation_id : operation_ids) {
+      auto op = find_if(ongoing_operations_.begin(), ongoing_operations_.end(),
+                        [operation_id](auto& operation) {
+                          return operation.operation_id_ == operation_id;
+                        });
+      if (op == ongoing_operations_.end()) continue;
 
-    alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
-                       INT_TO_PTR(op->operation_id_));
-    devices_control_point_helper(
-        op->devices_, op->opcode_,
-        op->arguments_.size() == 0 ? nullptr : &(op->arguments_));
+      LOG(INFO) << __func__ << " operation_id: " << op->operation_id_;
+
+      alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
+                         INT_TO_PTR(op->operation_id_));
+      devices_control_point_helper(
+          op->devices_, op->opcode_,
+          op->arguments_.size() == 0 ? nullptr : &(op->arguments_),
+          op->operation_id_);
+    }
   }
 
   void CancelVolumeOperation(int operation_id) {
@@ -817,7 +846,8 @@ class VolumeControlImpl : public VolumeControl {
 
     alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
                        INT_TO_PTR(op->operation_id_));
-    devices_control_point_helper(op->devices_, op->opcode_, &(op->arguments_));
+    devices_control_point_helper(op->devices_, op->opcode_, &(op->arguments_),
+                                 op->operation_id_);
   }
 
   void PrepareVolumeControlOperation(std::vector<RawAddress> devices,
@@ -47,6 +47,7 @@ using bluetooth::vc::VolumeControlCallbacks;
 using testing::_;
 using testing::DoAll;
 using testing::DoDefault;
+using testing::ElementsAre;
 using testing::Invoke;
 using testing::Mock;
 using testing::NotNull;
@@ -1231,6 +1232,46 @@ TEST_F(VolumeControlCsis, test_set_volume) {
   GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value2);
 }
 
+TEST_F(VolumeControlCsis, test_set_volume_coalesced_per_device) {
+  TestConnect(test_address_1);
+  GetConnectedEvent(test_address_1, conn_id_1);
+  GetSearchCompleteEvent(conn_id_1);
+  TestConnect(test_address_2);
+  GetConnectedEvent(test_address_2, conn_id_2);
+  GetSearchCompleteEvent(conn_id_2);
+
+  /* A device does not wait for the operation of another device */
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, ElementsAre(0x04, _, 10),
+                                  GATT_WRITE, _, _))
+      .Times(1);
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_2, 0x0024, ElementsAre(0x04, _, 50),
+                                  GATT_WRITE, _, _))
+      .Times(1);
+  VolumeControl::Get()->SetVolume(test_address_1, 10);
+  VolumeControl::Get()->SetVolume(test_address_2, 50);
+  Mock::VerifyAndClearExpectations(&gatt_queue);
+
+  /* Nothing more is written while the first write is in flight */
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, _, GATT_WRITE, _, _))
+      .Times(0);
+  VolumeControl::Get()->SetVolume(test_address_1, 20);
+  VolumeControl::Get()->SetVolume(test_address_1, 30);
+  VolumeControl::Get()->SetVolume(test_address_1, 40);
+  Mock::VerifyAndClearExpectations(&gatt_queue);
+
+  /* Only the latest value is written on completion */
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, ElementsAre(0x04, _, 40),
+                                  GATT_WRITE, _, _))
+      .Times(1);
+  std::vector<uint8_t> value({10, 0x00, 0x02});
+  GetNotificationEvent(conn_id_1, test_address_1, 0x0021, value);
+  Mock::VerifyAndClearExpectations(&gatt_queue);
+}
+
 TEST_F(VolumeControlCsis, test_set_volume_device_not_ready) {
   /* Make sure we did not get responds to the initial reads,
    * so that the device was not marked as ready yet.
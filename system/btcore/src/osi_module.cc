@@ -21,12 +21,18 @@
 #include "btcore/include/osi_module.h"
 #include "btcore/include/module.h"
 #include "osi/include/alarm.h"
+#include "osi/include/buffer_pool.h"
 #include "osi/include/future.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 
+static const char kBufferPoolProperty[] = "bluetooth.osi.buffer_pool.enabled";
+
 future_t* osi_init(void) {
+  buffer_pool_set_enabled(
+      osi_property_get_bool(kBufferPoolProperty, /*default_value=*/false));
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
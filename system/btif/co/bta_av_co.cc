@@ -1493,11 +1493,14 @@ void BtaAvCo::GetPeerEncoderParameters(
   p_peer_params->is_peer_edr = btif_av_is_peer_edr(peer_address);
   p_peer_params->peer_supports_3mbps =
       btif_av_peer_supports_3mbps(peer_address);
+  p_peer_params->is_low_latency = btif_av_is_low_latency(peer_address);
   APPL_TRACE_DEBUG(
-      "%s: peer_address=%s peer_mtu=%d is_peer_edr=%s peer_supports_3mbps=%s",
+      "%s: peer_address=%s peer_mtu=%d is_peer_edr=%s peer_supports_3mbps=%s "
+      "is_low_latency=%s",
       __func__, ADDRESS_TO_LOGGABLE_CSTR(peer_address), p_peer_params->peer_mtu,
       logbool(p_peer_params->is_peer_edr).c_str(),
-      logbool(p_peer_params->peer_supports_3mbps).c_str());
+      logbool(p_peer_params->peer_supports_3mbps).c_str(),
+      logbool(p_peer_params->is_low_latency).c_str());
 }
 
 const tA2DP_ENCODER_INTERFACE* BtaAvCo::GetSourceEncoderInterface() {
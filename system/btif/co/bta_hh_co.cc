@@ -25,6 +25,7 @@
 #include <linux/uhid.h>
 #include <poll.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -34,6 +35,7 @@
 #include "bta_hh_api.h"
 #include "btif_hh.h"
 #include "btif_util.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
@@ -387,6 +389,38 @@ int bta_hh_co_write(int fd, uint8_t* rpt, uint16_t len) {
   return uhid_write(fd, &ev);
 }
 
+// The input reports are written from a preallocated event, only used from
+// bta_hh_co_data, with UHID_INPUT2. Only the event up to the end of the report
+// is written, and the kernel takes the report size from the event, so each
+// report copies a few bytes instead of the whole 4 KiB event.
+static struct uhid_event input_ev;
+
+static int bta_hh_co_write_input(int fd, const uint8_t* rpt, uint16_t len) {
+  if (len > sizeof(input_ev.u.input2.data)) {
+    APPL_TRACE_WARNING("%s: Report size greater than allowed size", __func__);
+    return -1;
+  }
+
+  input_ev.type = UHID_INPUT2;
+  input_ev.u.input2.size = len;
+  memcpy(input_ev.u.input2.data, rpt, len);
+
+  size_t ev_len = offsetof(struct uhid_event, u.input2.data) + len;
+  ssize_t ret;
+  OSI_NO_INTR(ret = write(fd, &input_ev, ev_len));
+  if (ret < 0) {
+    int rtn = -errno;
+    APPL_TRACE_ERROR("%s: Cannot write to uhid:%s", __func__, strerror(errno));
+    return rtn;
+  } else if (ret != (ssize_t)ev_len) {
+    APPL_TRACE_ERROR("%s: Wrong size written to uhid: %zd != %zu", __func__,
+                     ret, ev_len);
+    return -EFAULT;
+  }
+
+  return 0;
+}
+
 /*******************************************************************************
  *
  * Function      bta_hh_co_open
@@ -456,6 +490,7 @@ bool bta_hh_co_open(uint8_t dev_handle, uint8_t sub_class,
   }
 
   p_dev->dev_status = BTHH_CONN_STATE_CONNECTED;
+  p_dev->input_stats = {};
   p_dev->get_rpt_id_queue = fixed_queue_new(SIZE_MAX);
   CHECK(p_dev->get_rpt_id_queue);
 #if ENABLE_UHID_SET_REPORT
@@ -546,9 +581,23 @@ void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len,
   }
 
   // Send the HID data to the kernel.
+  btif_hh_input_stats_t* p_stats = &p_dev->input_stats;
   if ((p_dev->fd >= 0) && p_dev->ready_for_data) {
-    bta_hh_co_write(p_dev->fd, p_rpt, len);
+    uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
+    if (bta_hh_co_write_input(p_dev->fd, p_rpt, len) < 0) {
+      p_stats->num_dropped++;
+      return;
+    }
+    uint64_t end_us = bluetooth::common::time_get_os_boottime_us();
+
+    if (p_stats->num_reports++ == 0) p_stats->first_report_us = start_us;
+    p_stats->last_report_us = end_us;
+    p_stats->total_write_us += end_us - start_us;
+    if (end_us - start_us > p_stats->max_write_us) {
+      p_stats->max_write_us = end_us - start_us;
+    }
   } else {
+    p_stats->num_dropped++;
     APPL_TRACE_WARNING("%s: Error: fd = %d, ready %d, len = %d", __func__,
                        p_dev->fd, p_dev->ready_for_data, len);
   }
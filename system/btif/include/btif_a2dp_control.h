@@ -22,6 +22,8 @@
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 
+typedef struct uipc_shm_t uipc_shm_t;
+
 // Initialize the A2DP control module. It should be called during the
 // startup stage of A2DP streaming.
 void btif_a2dp_control_init(void);
@@ -30,6 +32,11 @@ void btif_a2dp_control_init(void);
 // stage of A2DP streaming.
 void btif_a2dp_control_cleanup(void);
 
+// Returns the shared memory ring carrying the audio data from the audio HAL,
+// or nullptr if the audio data goes through the data socket. Must only be
+// read from the media task.
+uipc_shm_t* btif_a2dp_control_get_audio_shm(void);
+
 // Acknowledge A2DP command to the origin of audio streaming.
 // |status| is the acknowledement status - see |tA2DP_CTRL_ACK|.
 void btif_a2dp_command_ack(tA2DP_CTRL_ACK status);
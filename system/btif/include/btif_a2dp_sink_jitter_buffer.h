@@ -0,0 +1,146 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SINK_JITTER_BUFFER_H
+#define BTIF_A2DP_SINK_JITTER_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// Playout control of the A2DP Sink receive queue.
+//
+// The receive queue absorbs the arrival jitter of the media packets: playout
+// only starts once the queue holds a delay sized from the measured jitter,
+// and is then paced by the local clock rather than by the packet arrivals.
+// The drift between the clock of the peer and the local clock shows as a slow
+// change of the queue delay, which is compensated for by resampling the
+// decoded audio at |GetResampleRatio()|.
+//
+// The jitter buffer only tracks timings, the packets stay in the queue of the
+// caller. It is not thread-safe.
+//
+class BtifA2dpSinkJitterBuffer {
+ public:
+  struct Stats {
+    uint64_t received_packets = 0;
+    // Packets received later than the target delay could absorb
+    uint64_t late_packets = 0;
+    // Packets dropped because the receive queue was full
+    uint64_t dropped_packets = 0;
+    // Times the playout ran out of packets
+    uint64_t underruns = 0;
+    uint64_t max_jitter_us = 0;
+  };
+
+  // |max_queue_length| is the number of packets the receive queue can hold,
+  // playout starts when it is half full whatever the target delay.
+  explicit BtifA2dpSinkJitterBuffer(size_t max_queue_length);
+
+  // Restarts the measurements and statistics, for a new stream.
+  void Reset();
+
+  // Called when a packet is received at |now_us|, before being queued.
+  void OnPacketReceived(uint64_t now_us);
+
+  // Called when a received packet is dropped because the queue is full.
+  void OnPacketDropped();
+
+  // Returns whether |queue_length| packets are enough to start playout.
+  bool IsReadyToPlay(size_t queue_length) const;
+
+  // Called when the playout starts and stops, at |now_us|.
+  void OnPlayoutStarted(uint64_t now_us);
+  void OnPlayoutStopped();
+
+  // Called on each playout tick at |now_us|, with |queue_length| packets
+  // queued. The packets are then dequeued and decoded while
+  // |IsAudioNeeded()| returns true.
+  void OnPlayoutTick(uint64_t now_us, size_t queue_length);
+
+  // Returns whether the audio output needs another packet for this tick.
+  bool IsAudioNeeded() const;
+
+  // Called when a packet is decoded into |duration_us| of (resampled) audio.
+  void OnPacketDecoded(uint64_t duration_us);
+
+  // Called when a packet is needed and the queue is empty. Playout resumes
+  // once the queue is ready to play again.
+  void OnUnderrun();
+
+  // Returns the number of input samples to consume per output sample.
+  double GetResampleRatio() const { return resample_ratio_; }
+
+  uint64_t GetJitterUs() const { return jitter_us_; }
+  uint64_t GetTargetDelayUs() const;
+  uint64_t GetQueueDelayUs() const { return queue_delay_us_; }
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  enum class State { kStopped, kBuffering, kPlaying };
+
+  // Average audio duration of a queued packet
+  uint64_t GetPacketDurationUs() const;
+
+  size_t max_queue_length_;
+  State state_;
+  uint64_t last_arrival_us_;
+  uint64_t arrival_interval_us_;
+  uint64_t jitter_us_;
+  uint64_t packet_duration_us_;
+  uint64_t last_tick_us_;
+  int64_t budget_us_;
+  uint64_t queue_delay_us_;
+  double resample_ratio_;
+  Stats stats_;
+};
+
+//
+// Resamples interleaved PCM by a ratio close to 1, with a linear
+// interpolation that is transparent for the small ratios needed to compensate
+// for clock drift. 16 and 32 bits samples are resampled, other formats are
+// passed through.
+//
+class BtifA2dpSinkResampler {
+ public:
+  BtifA2dpSinkResampler();
+
+  // Sets the PCM format, and resets the resampler.
+  void Configure(int bits_per_sample, int channel_count);
+
+  // Resamples the |len| bytes of |data| at |ratio| input samples per output
+  // sample. Returns the resampled audio, valid until the next call, and
+  // stores its length in |out_len|.
+  uint8_t* Resample(const uint8_t* data, size_t len, double ratio,
+                    size_t* out_len);
+
+ private:
+  template <typename T>
+  size_t ResampleFrames(const T* input, size_t frames, double ratio);
+
+  int bits_per_sample_;
+  int channel_count_;
+  // Position of the next output sample, relative to the last input frame
+  // of the previous buffer
+  double phase_;
+  std::vector<int32_t> last_frame_;
+  std::vector<uint8_t> output_;
+};
+
+#endif /* BTIF_A2DP_SINK_JITTER_BUFFER_H */
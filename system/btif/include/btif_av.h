@@ -240,4 +240,15 @@ void btif_av_set_dynamic_audio_buffer_size(uint8_t dynamic_audio_buffer_size);
  */
 void btif_av_set_low_latency(bool is_low_latency);
 
+/**
+ * Check whether the low latency mode is enabled for a peer.
+ *
+ * The A2DP Source encoder applies the mode when it is set up for the next
+ * audio session: fewer frames per packet and a shorter media tick.
+ *
+ * @param peer_address the peer address
+ * @return true if the low latency mode is enabled for the peer
+ */
+bool btif_av_is_low_latency(const RawAddress& peer_address);
+
 #endif /* BTIF_AV_H */
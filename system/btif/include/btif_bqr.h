@@ -18,7 +18,6 @@
 #define BTIF_BQR_H_
 
 #include "btm_api_types.h"
-#include "common/leaky_bonded_queue.h"
 #include "include/hardware/bt_bqr.h"
 #include "osi/include/osi.h"
 #include "raw_address.h"
@@ -123,6 +122,10 @@ static constexpr int8_t kCriWarnRssi = -80;
 static constexpr uint8_t kCriWarnUnusedCh = 55;
 // The queue size of recording the BQR events.
 static constexpr uint8_t kBqrEventQueueSize = 25;
+// The count of links whose Link Quality related BQR events are aggregated.
+static constexpr uint8_t kBqrLinkStatisticsSize = 16;
+// The weight of a new event in the rolling averages, as a power of two.
+static constexpr uint8_t kBqrRollingAverageShift = 3;
 // The Property of BQR event mask configuration.
 static constexpr const char* kpPropertyEventMask =
     "persist.bluetooth.bqr.event_mask";
@@ -319,6 +322,33 @@ typedef struct {
   const uint8_t* vendor_specific_parameter;
 } BqrLogDumpEvent;
 
+// Rolling statistics of the Link Quality related BQR events of a link
+typedef struct {
+  // Whether the entry holds the statistics of a link.
+  bool in_use;
+  // Connection handle of the connection.
+  uint16_t connection_handle;
+  // Remote address of the connection, as reported by the last event.
+  RawAddress bdaddr;
+  // Count of the events of the link per quality report ID.
+  uint32_t monitor_count;
+  uint32_t approach_lsto_count;
+  uint32_t choppy_count;
+  uint32_t connect_fail_count;
+  // Rolling averages of the RSSI and SNR, in 1/256 dBm and dB.
+  int32_t rssi_average;
+  int32_t snr_average;
+  // Lowest RSSI reported.
+  int8_t rssi_min;
+  // Sum of the packet counters of the events.
+  uint64_t retransmission_count;
+  uint64_t no_rx_count;
+  uint64_t nak_count;
+  uint64_t flow_off_count;
+  // Boot time of the last event, in milliseconds.
+  uint64_t last_event_ms;
+} BqrLinkStatistics;
+
 // BQR sub-event of Vendor Specific Event
 class BqrVseSubEvt {
  public:
@@ -418,6 +448,13 @@ void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event);
 void AddLinkQualityEventToQueue(uint8_t length,
                                 const uint8_t* p_link_quality_event);
 
+// Aggregate a Link Quality related BQR event in the statistics of its link.
+//
+// @param event The Link Quality related BQR event.
+// @param now_ms The boot time of the event, in milliseconds.
+void AddLinkQualityEventToStatistics(const BqrLinkQualityEvent& event,
+                                     uint64_t now_ms);
+
 // Dump the LMP/LL message handshaking with the remote device to a log file.
 //
 // @param length Lengths of the LMP/LL message trace event.
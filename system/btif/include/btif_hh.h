@@ -86,6 +86,16 @@ inline std::string btif_hh_status_text(const BTIF_HH_STATUS& status) {
 }
 #undef CASE_RETURN_TEXT
 
+// Statistics of the input reports written to uhid
+typedef struct {
+  uint64_t num_reports;      // Input reports written
+  uint64_t num_dropped;      // Input reports not written, or failed
+  uint64_t first_report_us;  // Time the first input report was written
+  uint64_t last_report_us;   // Time the last input report was written
+  uint64_t total_write_us;   // Total time spent in the uhid writes
+  uint64_t max_write_us;     // Longest uhid write
+} btif_hh_input_stats_t;
+
 // Shared with uhid polling thread
 typedef struct {
   bthh_connection_state_t dev_status;
@@ -104,6 +114,7 @@ typedef struct {
   fixed_queue_t* set_rpt_id_queue;
 #endif // ENABLE_UHID_SET_REPORT
   bool local_vup;  // Indicated locally initiated VUP
+  btif_hh_input_stats_t input_stats;
 } btif_hh_device_t;
 
 /* Control block to maintain properties of devices */
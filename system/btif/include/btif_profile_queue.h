@@ -36,10 +36,19 @@ typedef bt_status_t (*btif_connect_cb_t)(RawAddress* bda, uint16_t uuid);
 bt_status_t btif_queue_connect(uint16_t uuid, const RawAddress* bda,
                                btif_connect_cb_t connect_cb);
 void btif_queue_cleanup(uint16_t uuid);
-void btif_queue_advance();
 
 /**
- * Dispatch the next pending connect request.
+ * Remove the connect request in progress for a device, and dispatch the next
+ * pending connect requests.
+ *
+ * @param bda the address of the device whose connection completed or failed
+ */
+void btif_queue_advance(const RawAddress& bda);
+
+/**
+ * Dispatch the next pending connect request of each device. The requests of
+ * different devices are executed concurrently, the requests of a device are
+ * executed in order.
  * NOTE: Must be called on the JNI thread.
  *
  * @return BT_STATUS_SUCCESS on success, otherwise the corresponding error
@@ -187,26 +187,16 @@ bt_status_t btif_storage_add_bonded_device(RawAddress* remote_bd_addr,
  ******************************************************************************/
 bt_status_t btif_storage_remove_bonded_device(const RawAddress* remote_bd_addr);
 
-/*******************************************************************************
- *
- * Function         btif_storage_load_le_devices
- *
- * Description      BTIF storage API - Loads all LE-only and Dual Mode devices
- *                  from NVRAM. This API invokes the adaper_properties_cb.
- *                  It also invokes invoke_address_consolidate_cb
- *                  to consolidate each Dual Mode device and
- *                  invoke_le_address_associate_cb to associate each LE-only
- *                  device between its RPA and identity address.
- *
- ******************************************************************************/
-void btif_storage_load_le_devices(void);
-
 /*******************************************************************************
  *
  * Function         btif_storage_load_bonded_devices
  *
  * Description      BTIF storage API - Loads all the bonded devices from NVRAM
  *                  and adds to the BTA.
+ *                  This API invokes invoke_address_consolidate_cb to
+ *                  consolidate each Dual Mode device and
+ *                  invoke_le_address_associate_cb to associate each LE-only
+ *                  device between its RPA and identity address.
  *                  Additionally, this API also invokes the adaper_properties_cb
  *                  and remote_device_properties_cb for each of the bonded
  *                  devices.
@@ -53,7 +53,10 @@
 #include "bta/hh/bta_hh_int.h"  // for HID HACK profile methods
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_ar_api.h"
+#include "bta/include/bta_av_api.h"
 #include "bta/include/bta_csis_api.h"
+#include "bta/include/bta_gatt_queue.h"
+#include "bta/include/bta_gatt_server_queue.h"
 #include "bta/include/bta_has_api.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
@@ -91,6 +94,8 @@
 #include "device/include/interop_config.h"
 #include "gd/common/init_flags.h"
 #include "gd/os/parameter_provider.h"
+#include "gd/os/task_monitor.h"
+#include "gd/os/trace.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
 #include "osi/include/alarm.h"
@@ -106,9 +111,11 @@
 #include "stack/include/avdt_api.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btu.h"
+#include "stack/include/gatt_api.h"
 #include "stack/include/hfp_msbc_decoder.h"
 #include "stack/include/hfp_msbc_encoder.h"
 #include "stack/include/hidh_api.h"
+#include "stack/include/l2c_api.h"
 #include "stack/include/pan_api.h"
 #include "stack_config.h"
 #include "types/raw_address.h"
@@ -292,6 +299,7 @@ struct CoreInterfaceImpl : bluetooth::core::CoreInterface {
     btif_hd_remove_device(bd_addr);
 #endif
     btif_hearing_aid_get_interface()->RemoveDevice(bd_addr);
+    BTA_AvRemoveDevice(bd_addr);
 
 #ifndef TARGET_FLOSS
     if (bluetooth::csis::CsisClient::IsCsisClientRunning())
@@ -782,6 +790,8 @@ static void dump(int fd, const char** arguments) {
   wakelock_debug_dump(fd);
   osi_allocator_debug_dump(fd);
   alarm_debug_dump(fd);
+  bluetooth::os::DumpTrace(fd);
+  bluetooth::os::DumpTaskMonitors(fd);
   bluetooth::csis::CsisClient::DebugDump(fd);
 #ifndef TARGET_FLOSS
   le_audio::has::HasClient::DebugDump(fd);
@@ -793,6 +803,10 @@ static void dump(int fd, const char** arguments) {
   VolumeControl::DebugDump(fd);
 #endif
   connection_manager::dump(fd);
+  L2CA_Dumpsys(fd);
+  GATT_Dumpsys(fd);
+  BtaGattQueue::DebugDump(fd);
+  BtaGattServerQueue::DebugDump(fd);
   bluetooth::bqr::DebugDump(fd);
   PAN_Dumpsys(fd);
   DumpsysHid(fd);
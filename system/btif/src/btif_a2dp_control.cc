@@ -25,6 +25,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include <atomic>
+
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "btif_a2dp.h"
 #include "btif_a2dp_sink.h"
@@ -35,9 +37,13 @@
 #include "osi/include/osi.h"
 #include "types/raw_address.h"
 #include "uipc.h"
+#include "uipc_shm.h"
 
 #define A2DP_DATA_READ_POLL_MS 10
 
+/* Largest audio buffer the audio HAL may request for the shared memory ring */
+#define A2DP_AUDIO_SHM_MAX_SIZE (64 * 1024)
+
 struct {
   uint64_t total_bytes_read = 0;
   uint16_t audio_delay = 0;
@@ -51,6 +57,12 @@ static void btif_a2dp_ctrl_cb(tUIPC_CH_ID ch_id, tUIPC_EVENT event);
 static tA2DP_CTRL_CMD a2dp_cmd_pending = A2DP_CTRL_CMD_NONE;
 std::unique_ptr<tUIPC_STATE> a2dp_uipc = nullptr;
 
+/* Ring carrying the audio data instead of the data socket, once handed to the
+ * audio HAL. It is kept until cleanup, as the media task may be reading it
+ * when the audio HAL goes away. */
+static uipc_shm_t* a2dp_audio_shm = nullptr;
+static std::atomic<bool> a2dp_audio_shm_attached(false);
+
 void btif_a2dp_control_init(void) {
   a2dp_uipc = UIPC_Init();
   UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, btif_a2dp_ctrl_cb, A2DP_CTRL_PATH);
@@ -61,6 +73,14 @@ void btif_a2dp_control_cleanup(void) {
   if (a2dp_uipc != nullptr) {
     UIPC_Close(*a2dp_uipc, UIPC_CH_ID_ALL);
   }
+
+  a2dp_audio_shm_attached = false;
+  uipc_shm_free(a2dp_audio_shm);
+  a2dp_audio_shm = nullptr;
+}
+
+uipc_shm_t* btif_a2dp_control_get_audio_shm(void) {
+  return a2dp_audio_shm_attached ? a2dp_audio_shm : nullptr;
 }
 
 static tA2DP_CTRL_ACK btif_a2dp_control_on_check_ready() {
@@ -246,6 +266,47 @@ static void btif_a2dp_control_on_get_presentation_position() {
   UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, (uint8_t*)&nsec, sizeof(nsec));
 }
 
+static void btif_a2dp_control_on_get_audio_shm() {
+  uint32_t buffer_size = 0;
+
+  btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
+  if (UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_CTRL,
+                reinterpret_cast<uint8_t*>(&buffer_size),
+                sizeof(buffer_size)) != sizeof(buffer_size)) {
+    APPL_TRACE_ERROR("%s: Error reading buffer size from audio HAL", __func__);
+    return;
+  }
+
+  uint8_t status = A2DP_CTRL_ACK_FAILURE;
+  if (buffer_size == 0 || buffer_size > A2DP_AUDIO_SHM_MAX_SIZE) {
+    APPL_TRACE_ERROR("%s: Invalid buffer size %u", __func__, buffer_size);
+  } else {
+    /* Created once with the largest size, the limit sets the buffering */
+    if (a2dp_audio_shm == nullptr) {
+      a2dp_audio_shm = uipc_shm_new(A2DP_AUDIO_SHM_MAX_SIZE);
+    }
+    if (a2dp_audio_shm != nullptr) {
+      uipc_shm_set_limit(a2dp_audio_shm, buffer_size);
+      uipc_shm_flush(a2dp_audio_shm);
+      status = A2DP_CTRL_ACK_SUCCESS;
+    }
+  }
+
+  if (status != A2DP_CTRL_ACK_SUCCESS) {
+    UIPC_Send(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, 0, &status, sizeof(status));
+    return;
+  }
+
+  int fds[] = {uipc_shm_get_memory_fd(a2dp_audio_shm),
+               uipc_shm_get_event_fd(a2dp_audio_shm)};
+  if (UIPC_SendFds(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, &status, sizeof(status),
+                   fds, 2)) {
+    APPL_TRACE_DEBUG("%s: audio data over shared memory, buffer size %u",
+                     __func__, buffer_size);
+    a2dp_audio_shm_attached = true;
+  }
+}
+
 static void btif_a2dp_recv_ctrl_data(void) {
   tA2DP_CTRL_CMD cmd = A2DP_CTRL_CMD_NONE;
   int n;
@@ -305,6 +366,10 @@ static void btif_a2dp_recv_ctrl_data(void) {
       btif_a2dp_control_on_get_presentation_position();
       break;
 
+    case A2DP_CTRL_GET_AUDIO_SHM:
+      btif_a2dp_control_on_get_audio_shm();
+      break;
+
     default:
       APPL_TRACE_ERROR("%s: UNSUPPORTED CMD (%d)", __func__, cmd);
       btif_a2dp_command_ack(A2DP_CTRL_ACK_FAILURE);
@@ -339,6 +404,8 @@ static void btif_a2dp_ctrl_cb(UNUSED_ATTR tUIPC_CH_ID ch_id,
       break;
 
     case UIPC_CLOSE_EVT:
+      /* The audio HAL went away, the ring is handed again on reconnection */
+      a2dp_audio_shm_attached = false;
       /* restart ctrl server unless we are shutting down */
       if (btif_a2dp_source_media_task_is_running())
         UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_CTRL, btif_a2dp_ctrl_cb,
@@ -382,6 +449,7 @@ static void btif_a2dp_data_cb(UNUSED_ATTR tUIPC_CH_ID ch_id,
 
     case UIPC_CLOSE_EVT:
       APPL_TRACE_EVENT("%s: ## AUDIO PATH DETACHED ##", __func__);
+      a2dp_audio_shm_attached = false;
       btif_a2dp_command_ack(A2DP_CTRL_ACK_SUCCESS);
       /* Post stop event and wait for audio path to stop */
       btif_av_stream_stop(RawAddress::kEmpty);
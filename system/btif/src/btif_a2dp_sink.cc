@@ -23,17 +23,20 @@
 
 #include <base/functional/bind.h>
 #include <base/logging.h>
+#include <stdio.h>
 
 #include <atomic>
 #include <mutex>
 #include <string>
 
 #include "bt_target.h"  // Must be first to define build configuration
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
 #include "btif/include/btif_av.h"
 #include "btif/include/btif_av_co.h"
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
@@ -53,9 +56,6 @@ using LockGuard = std::lock_guard<std::mutex>;
 
 #define BTIF_SINK_MEDIA_TIME_TICK_MS 20
 
-/* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
-#define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
-
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
   BTIF_A2DP_SINK_STATE_STARTING_UP,
@@ -95,7 +95,9 @@ class BtifA2dpSinkControlBlock {
         channel_count(0),
         rx_focus_state(BTIF_A2DP_SINK_FOCUS_NOT_GRANTED),
         audio_track(nullptr),
-        decoder_interface(nullptr) {}
+        decoder_interface(nullptr),
+        jitter_buffer(MAX_INPUT_A2DP_FRAME_QUEUE_SZ),
+        decoded_bytes(0) {}
 
   void Reset() {
     if (audio_track != nullptr) {
@@ -112,6 +114,8 @@ class BtifA2dpSinkControlBlock {
     sample_rate = 0;
     channel_count = 0;
     decoder_interface = nullptr;
+    jitter_buffer.Reset();
+    decoded_bytes = 0;
   }
 
   MessageLoopThread worker_thread;
@@ -124,6 +128,9 @@ class BtifA2dpSinkControlBlock {
   btif_a2dp_sink_focus_state_t rx_focus_state; /* audio focus state */
   void* audio_track;
   const tA2DP_DECODER_INTERFACE* decoder_interface;
+  BtifA2dpSinkJitterBuffer jitter_buffer; /* playout of rx_audio_queue */
+  BtifA2dpSinkResampler resampler;        /* clock drift compensation */
+  size_t decoded_bytes; /* audio bytes output for the packet being decoded */
 };
 
 // Mutex for below data structures.
@@ -470,6 +477,7 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
     btif_a2dp_sink_audio_rx_flush_req();
     old_alarm = btif_a2dp_sink_cb.decode_alarm;
     btif_a2dp_sink_cb.decode_alarm = nullptr;
+    btif_a2dp_sink_cb.jitter_buffer.OnPlayoutStopped();
   }
 
   // Drop the lock here, btif_decode_alarm_cb may in the process of being called
@@ -520,15 +528,33 @@ static void btif_a2dp_sink_audio_handle_start_decoding() {
   }
   alarm_set(btif_a2dp_sink_cb.decode_alarm, BTIF_SINK_MEDIA_TIME_TICK_MS,
             btif_decode_alarm_cb, nullptr);
+  btif_a2dp_sink_cb.jitter_buffer.OnPlayoutStarted(
+      bluetooth::common::time_get_os_boottime_us());
 }
 
+// Must be called while locked.
 static void btif_a2dp_sink_on_decode_complete(uint8_t* data, uint32_t len) {
+  size_t resampled_len;
+  uint8_t* resampled = btif_a2dp_sink_cb.resampler.Resample(
+      data, len, btif_a2dp_sink_cb.jitter_buffer.GetResampleRatio(),
+      &resampled_len);
+  btif_a2dp_sink_cb.decoded_bytes += resampled_len;
 #ifdef __ANDROID__
   BtifAvrcpAudioTrackWriteData(btif_a2dp_sink_cb.audio_track,
-                               reinterpret_cast<void*>(data), len);
+                               reinterpret_cast<void*>(resampled),
+                               resampled_len);
 #endif
 }
 
+// Returns the duration of |bytes| of decoded audio, must be called while
+// locked.
+static uint64_t btif_a2dp_sink_audio_duration_us(size_t bytes) {
+  uint64_t frame_size = btif_a2dp_sink_cb.channel_count *
+                        (btif_a2dp_sink_cb.bits_per_sample / 8);
+  if (frame_size == 0 || btif_a2dp_sink_cb.sample_rate == 0) return 0;
+  return (bytes / frame_size) * 1000000 / btif_a2dp_sink_cb.sample_rate;
+}
+
 // Must be called while locked.
 static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg) {
   if ((btif_av_get_peer_sep() == AVDT_TSEP_SNK) ||
@@ -547,8 +573,13 @@ static void btif_a2dp_sink_avk_handle_timer() {
   LockGuard lock(g_mutex);
 
   BT_HDR* p_msg;
+  BtifA2dpSinkJitterBuffer& jitter_buffer = btif_a2dp_sink_cb.jitter_buffer;
+  jitter_buffer.OnPlayoutTick(
+      bluetooth::common::time_get_os_boottime_us(),
+      fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue));
   if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
     APPL_TRACE_DEBUG("%s: empty queue", __func__);
+    if (jitter_buffer.IsAudioNeeded()) jitter_buffer.OnUnderrun();
     return;
   }
 
@@ -564,18 +595,24 @@ static void btif_a2dp_sink_avk_handle_timer() {
     return;
   }
 
+  /* Only decode the audio played during this tick, the remaining packets
+   * absorb the arrival jitter */
   APPL_TRACE_DEBUG("%s: process frames begin", __func__);
-  while (true) {
+  while (jitter_buffer.IsAudioNeeded()) {
     p_msg = (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue);
     if (p_msg == NULL) {
+      jitter_buffer.OnUnderrun();
       break;
     }
     APPL_TRACE_DEBUG("%s: number of packets in queue %zu", __func__,
                      fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue));
 
     /* Queue packet has less frames */
+    btif_a2dp_sink_cb.decoded_bytes = 0;
     btif_a2dp_sink_handle_inc_media(p_msg);
     osi_free(p_msg);
+    jitter_buffer.OnPacketDecoded(
+        btif_a2dp_sink_audio_duration_us(btif_a2dp_sink_cb.decoded_bytes));
   }
   APPL_TRACE_DEBUG("%s: process frames end", __func__);
 }
@@ -627,6 +664,7 @@ static void btif_a2dp_sink_decoder_update_event(
   btif_a2dp_sink_cb.sample_rate = sample_rate;
   btif_a2dp_sink_cb.bits_per_sample = bits_per_sample;
   btif_a2dp_sink_cb.channel_count = channel_count;
+  btif_a2dp_sink_cb.resampler.Configure(bits_per_sample, channel_count);
 
   btif_a2dp_sink_cb.rx_flush = false;
   APPL_TRACE_DEBUG("%s: reset to Sink role", __func__);
@@ -665,10 +703,13 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   if (btif_a2dp_sink_cb.rx_flush) /* Flush enabled, do not enqueue */
     return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
 
+  btif_a2dp_sink_cb.jitter_buffer.OnPacketReceived(
+      bluetooth::common::time_get_os_boottime_us());
   if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
       MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
     uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
+    btif_a2dp_sink_cb.jitter_buffer.OnPacketDropped();
     return ret;
   }
 
@@ -680,8 +721,10 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   p_msg->offset = 0;
   memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
   fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
-  if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
-      MAX_A2DP_DELAYED_START_FRAME_COUNT) {
+  /* Delay the start until the queue absorbs the arrival jitter */
+  if (btif_a2dp_sink_cb.decode_alarm == nullptr &&
+      btif_a2dp_sink_cb.jitter_buffer.IsReadyToPlay(
+          fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue))) {
     BTIF_TRACE_DEBUG("%s: Initiate decoding. Current focus state:%d", __func__,
                      btif_a2dp_sink_cb.rx_focus_state);
     if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
@@ -706,8 +749,34 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(UNUSED_ATTR int fd) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  const BtifA2dpSinkJitterBuffer& jitter_buffer =
+      btif_a2dp_sink_cb.jitter_buffer;
+  const BtifA2dpSinkJitterBuffer::Stats& stats = jitter_buffer.GetStats();
+
+  dprintf(fd, "\nA2DP Sink State:\n");
+  dprintf(fd, "  RxQueue:\n");
+  dprintf(fd,
+          "  Counts (received/late/dropped/underruns)                : %llu / "
+          "%llu / %llu / %llu\n",
+          (unsigned long long)stats.received_packets,
+          (unsigned long long)stats.late_packets,
+          (unsigned long long)stats.dropped_packets,
+          (unsigned long long)stats.underruns);
+  dprintf(fd,
+          "  Jitter in ms (current/max)                              : %llu / "
+          "%llu\n",
+          (unsigned long long)jitter_buffer.GetJitterUs() / 1000,
+          (unsigned long long)stats.max_jitter_us / 1000);
+  dprintf(fd,
+          "  Delay in ms (target/queued)                             : %llu / "
+          "%llu\n",
+          (unsigned long long)jitter_buffer.GetTargetDelayUs() / 1000,
+          (unsigned long long)jitter_buffer.GetQueueDelayUs() / 1000);
+  dprintf(fd,
+          "  Resampling ratio                                        : %f\n",
+          jitter_buffer.GetResampleRatio());
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
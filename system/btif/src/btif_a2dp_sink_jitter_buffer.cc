@@ -0,0 +1,255 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Bounds of the delay the queue is filled to before playout starts
+constexpr uint64_t kMinTargetDelayUs = 60 * 1000;
+constexpr uint64_t kMaxTargetDelayUs = 500 * 1000;
+
+// Number of jitter deviations covered by the target delay
+constexpr uint64_t kJitterMultiplier = 4;
+
+// The jitter estimate grows quickly on congestion and decays slowly, so that
+// a congested link doesn't underrun again right after recovering
+constexpr int64_t kJitterAttackShift = 2;
+constexpr int64_t kJitterReleaseShift = 8;
+
+// Averaging of the packet interval and duration estimates
+constexpr int64_t kIntervalShift = 4;
+
+// Averaging of the queue delay over ~1 second of 20 ms ticks, so the drift
+// compensation only follows the slow changes caused by clock drift
+constexpr int64_t kQueueDelayShift = 6;
+
+// Largest deviation of the resampling ratio from 1, far beyond the drift of
+// actual clocks but inaudible
+constexpr double kMaxResampleDeviation = 0.002;
+
+// Limits the audio decoded at once after the playout thread was delayed
+constexpr int64_t kMaxBudgetUs = 100 * 1000;
+
+// Moves |average| 1 / 2^|shift| of its distance towards |value|
+uint64_t smooth(uint64_t average, uint64_t value, int64_t shift) {
+  int64_t delta = static_cast<int64_t>(value) - static_cast<int64_t>(average);
+  return static_cast<int64_t>(average) + delta / (1 << shift);
+}
+
+}  // namespace
+
+BtifA2dpSinkJitterBuffer::BtifA2dpSinkJitterBuffer(size_t max_queue_length)
+    : max_queue_length_(max_queue_length) {
+  Reset();
+}
+
+void BtifA2dpSinkJitterBuffer::Reset() {
+  state_ = State::kStopped;
+  last_arrival_us_ = 0;
+  arrival_interval_us_ = 0;
+  jitter_us_ = 0;
+  packet_duration_us_ = 0;
+  last_tick_us_ = 0;
+  budget_us_ = 0;
+  queue_delay_us_ = 0;
+  resample_ratio_ = 1.0;
+  stats_ = Stats();
+}
+
+void BtifA2dpSinkJitterBuffer::OnPacketReceived(uint64_t now_us) {
+  stats_.received_packets++;
+
+  if (last_arrival_us_ != 0 && now_us > last_arrival_us_) {
+    uint64_t interval_us = now_us - last_arrival_us_;
+    if (arrival_interval_us_ == 0) {
+      arrival_interval_us_ = interval_us;
+    } else {
+      if (interval_us > arrival_interval_us_ + GetTargetDelayUs()) {
+        stats_.late_packets++;
+      }
+
+      uint64_t deviation_us = (interval_us > arrival_interval_us_)
+                                  ? interval_us - arrival_interval_us_
+                                  : arrival_interval_us_ - interval_us;
+      jitter_us_ = smooth(jitter_us_, deviation_us,
+                          deviation_us > jitter_us_ ? kJitterAttackShift
+                                                    : kJitterReleaseShift);
+      stats_.max_jitter_us = std::max(stats_.max_jitter_us, jitter_us_);
+      arrival_interval_us_ =
+          smooth(arrival_interval_us_, interval_us, kIntervalShift);
+    }
+  }
+  last_arrival_us_ = now_us;
+}
+
+void BtifA2dpSinkJitterBuffer::OnPacketDropped() { stats_.dropped_packets++; }
+
+uint64_t BtifA2dpSinkJitterBuffer::GetTargetDelayUs() const {
+  return std::clamp(kMinTargetDelayUs + kJitterMultiplier * jitter_us_,
+                    kMinTargetDelayUs, kMaxTargetDelayUs);
+}
+
+uint64_t BtifA2dpSinkJitterBuffer::GetPacketDurationUs() const {
+  // Until packets are decoded their duration is estimated from their rate
+  return packet_duration_us_ != 0 ? packet_duration_us_ : arrival_interval_us_;
+}
+
+bool BtifA2dpSinkJitterBuffer::IsReadyToPlay(size_t queue_length) const {
+  if (queue_length == 0) return false;
+  if (queue_length >= max_queue_length_ / 2) return true;
+
+  uint64_t packet_duration_us = GetPacketDurationUs();
+  if (packet_duration_us == 0) return false;
+  return queue_length * packet_duration_us >= GetTargetDelayUs();
+}
+
+void BtifA2dpSinkJitterBuffer::OnPlayoutStarted(uint64_t now_us) {
+  state_ = State::kPlaying;
+  last_tick_us_ = now_us;
+  budget_us_ = 0;
+  queue_delay_us_ = GetTargetDelayUs();
+  resample_ratio_ = 1.0;
+}
+
+void BtifA2dpSinkJitterBuffer::OnPlayoutStopped() {
+  state_ = State::kStopped;
+  budget_us_ = 0;
+  resample_ratio_ = 1.0;
+  // The packets received after the stream is resumed are not late
+  last_arrival_us_ = 0;
+}
+
+void BtifA2dpSinkJitterBuffer::OnPlayoutTick(uint64_t now_us,
+                                             size_t queue_length) {
+  if (state_ == State::kStopped) return;
+
+  uint64_t elapsed_us = now_us > last_tick_us_ ? now_us - last_tick_us_ : 0;
+  last_tick_us_ = now_us;
+
+  if (state_ == State::kBuffering) {
+    if (!IsReadyToPlay(queue_length)) return;
+    state_ = State::kPlaying;
+    budget_us_ = 0;
+  }
+
+  budget_us_ = std::min<int64_t>(budget_us_ + elapsed_us, kMaxBudgetUs);
+
+  // Consume the queue faster when it holds more than the target delay, and
+  // slower when it holds less
+  uint64_t target_delay_us = GetTargetDelayUs();
+  queue_delay_us_ = smooth(queue_delay_us_,
+                           queue_length * GetPacketDurationUs(),
+                           kQueueDelayShift);
+  double error = (static_cast<double>(queue_delay_us_) -
+                  static_cast<double>(target_delay_us)) /
+                 target_delay_us;
+  resample_ratio_ =
+      1.0 + kMaxResampleDeviation * std::clamp(2.0 * error, -1.0, 1.0);
+}
+
+bool BtifA2dpSinkJitterBuffer::IsAudioNeeded() const {
+  return state_ == State::kPlaying && budget_us_ > 0;
+}
+
+void BtifA2dpSinkJitterBuffer::OnPacketDecoded(uint64_t duration_us) {
+  budget_us_ -= duration_us;
+
+  // The queued packets are not resampled yet
+  uint64_t packet_duration_us =
+      static_cast<uint64_t>(duration_us * resample_ratio_);
+  packet_duration_us_ =
+      (packet_duration_us_ == 0)
+          ? packet_duration_us
+          : smooth(packet_duration_us_, packet_duration_us, kIntervalShift);
+}
+
+void BtifA2dpSinkJitterBuffer::OnUnderrun() {
+  if (state_ != State::kPlaying) return;
+
+  stats_.underruns++;
+  state_ = State::kBuffering;
+  budget_us_ = 0;
+}
+
+BtifA2dpSinkResampler::BtifA2dpSinkResampler() { Configure(16, 2); }
+
+void BtifA2dpSinkResampler::Configure(int bits_per_sample, int channel_count) {
+  bits_per_sample_ = bits_per_sample;
+  channel_count_ = std::max(channel_count, 1);
+  phase_ = 1.0;
+  last_frame_.assign(channel_count_, 0);
+  output_.clear();
+}
+
+uint8_t* BtifA2dpSinkResampler::Resample(const uint8_t* data, size_t len,
+                                         double ratio, size_t* out_len) {
+  size_t frame_size = channel_count_ * bits_per_sample_ / 8;
+  switch (bits_per_sample_) {
+    case 16:
+      *out_len = ResampleFrames(reinterpret_cast<const int16_t*>(data),
+                                len / frame_size, ratio);
+      break;
+    case 32:
+      *out_len = ResampleFrames(reinterpret_cast<const int32_t*>(data),
+                                len / frame_size, ratio);
+      break;
+    default:
+      output_.assign(data, data + len);
+      *out_len = len;
+      break;
+  }
+  return output_.data();
+}
+
+template <typename T>
+size_t BtifA2dpSinkResampler::ResampleFrames(const T* input, size_t frames,
+                                             double ratio) {
+  if (frames == 0) return 0;
+
+  size_t channels = channel_count_;
+  size_t max_frames = static_cast<size_t>((frames + phase_) / ratio) + 2;
+  output_.resize(max_frames * channels * sizeof(T));
+  T* output = reinterpret_cast<T*>(output_.data());
+
+  // Input frame -1 is the last frame of the previous buffer
+  double position = phase_ - 1.0;
+  size_t count = 0;
+  while (position < static_cast<double>(frames - 1)) {
+    int64_t index = static_cast<int64_t>(std::floor(position));
+    double fraction = position - index;
+    for (size_t c = 0; c < channels; c++) {
+      double a = (index < 0) ? last_frame_[c] : input[index * channels + c];
+      double b = input[(index + 1) * channels + c];
+      output[count * channels + c] =
+          static_cast<T>(std::lrint(a + fraction * (b - a)));
+    }
+    count++;
+    position += ratio;
+  }
+
+  phase_ = position - static_cast<double>(frames - 1);
+  for (size_t c = 0; c < channels; c++) {
+    last_frame_[c] = input[(frames - 1) * channels + c];
+  }
+  return count * channels * sizeof(T);
+}
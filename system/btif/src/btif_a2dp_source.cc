@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
@@ -46,6 +47,7 @@
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
+#include "gd/os/trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
@@ -56,6 +58,7 @@
 #include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
 #include "uipc.h"
+#include "uipc_shm.h"
 
 using bluetooth::common::A2dpSessionMetrics;
 using bluetooth::common::BluetoothMetricsLogger;
@@ -63,6 +66,9 @@ using bluetooth::common::RepeatingTimer;
 
 extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
 
+// Owner of the wakelock held while the audio is streamed
+static constexpr char kWakelockOwner[] = "a2dp_source";
+
 /**
  * The typical runlevel of the tx queue size is ~1 buffer
  * but due to link flow control or thread preemption in lower
@@ -70,6 +76,20 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * Encoding is deferred when a media tick finds this many buffers still in the
+ * tx queue: the lower layers are congested, and encoding more would only add
+ * latency until the queue overflows and is dropped. Encoding resumes as soon
+ * as the lower layers take buffers from the queue.
+ */
+#define A2DP_SOURCE_TX_DEFER_QUEUE_SZ 2
+
+/**
+ * Encoding is deferred for this many media ticks at most, which the encoders
+ * catch up on the next tick without dropping audio data.
+ */
+#define A2DP_SOURCE_TX_MAX_DEFERRED_TICKS 2
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -137,6 +157,8 @@ class BtifMediaStats {
     tx_queue_max_dropped_messages = 0;
     tx_queue_dropouts = 0;
     tx_queue_last_dropouts_us = 0;
+    tx_queue_total_deferred_ticks = 0;
+    tx_queue_total_early_encodes = 0;
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
@@ -166,6 +188,11 @@ class BtifMediaStats {
   size_t tx_queue_dropouts;
   uint64_t tx_queue_last_dropouts_us;
 
+  // Media ticks deferred while the lower layers were congested, and encodings
+  // started before the media tick when they took buffers again
+  size_t tx_queue_total_deferred_ticks;
+  size_t tx_queue_total_early_encodes;
+
   size_t media_read_total_underflow_bytes;
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
@@ -185,6 +212,8 @@ class BtifA2dpSource {
   BtifA2dpSource()
       : tx_audio_queue(nullptr),
         tx_flush(false),
+        tx_deferred(false),
+        deferred_ticks(0),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
         state_(kStateOff) {}
@@ -194,7 +223,9 @@ class BtifA2dpSource {
     tx_audio_queue = nullptr;
     tx_flush = false;
     media_alarm.CancelAndWait();
-    wakelock_release();
+    tx_deferred = false;
+    deferred_ticks = 0;
+    wakelock_release(kWakelockOwner);
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
     stats.Reset();
@@ -221,6 +252,9 @@ class BtifA2dpSource {
   fixed_queue_t* tx_audio_queue;
   bool tx_flush; /* Discards any outgoing data when true */
   RepeatingTimer media_alarm;
+  /* Encoding waits for the lower layers to take buffers from the tx queue */
+  std::atomic<bool> tx_deferred;
+  uint8_t deferred_ticks; /* Consecutive deferred media ticks */
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
   BtifMediaStats stats;
@@ -264,6 +298,7 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_handle_tx_ready(void);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
@@ -314,6 +349,8 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
       dst->tx_queue_max_dropped_messages, src->tx_queue_max_dropped_messages);
   dst->tx_queue_dropouts += src->tx_queue_dropouts;
   dst->tx_queue_last_dropouts_us = src->tx_queue_last_dropouts_us;
+  dst->tx_queue_total_deferred_ticks += src->tx_queue_total_deferred_ticks;
+  dst->tx_queue_total_early_encodes += src->tx_queue_total_early_encodes;
   dst->media_read_total_underflow_bytes +=
       src->media_read_total_underflow_bytes;
   dst->media_read_total_underflow_count +=
@@ -506,7 +543,7 @@ static void btif_a2dp_source_shutdown_delayed(
 
   // Stop the timer
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
-  wakelock_release();
+  wakelock_release(kWakelockOwner);
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     bluetooth::audio::a2dp::cleanup();
@@ -811,8 +848,10 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
 
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
+  btif_a2dp_source_cb.tx_deferred = false;
+  btif_a2dp_source_cb.deferred_ticks = 0;
 
-  wakelock_acquire();
+  wakelock_acquire(kWakelockOwner);
   btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
       btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
       base::Bind(&btif_a2dp_source_audio_handle_timer),
@@ -856,9 +895,13 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
   uint8_t p_buf[AUDIO_STREAM_OUTPUT_BUFFER_SZ * 2];
 
   // Keep track of audio data still left in the pipe
+  uipc_shm_t* audio_shm = btif_a2dp_control_get_audio_shm();
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     btif_a2dp_control_log_bytes_read(
         bluetooth::audio::a2dp::read(p_buf, sizeof(p_buf)));
+  } else if (audio_shm != nullptr) {
+    btif_a2dp_control_log_bytes_read(
+        uipc_shm_read(audio_shm, p_buf, sizeof(p_buf)));
   } else if (a2dp_uipc != nullptr) {
     btif_a2dp_control_log_bytes_read(
         UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, p_buf, sizeof(p_buf)));
@@ -866,7 +909,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   /* Stop the timer first */
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
-  wakelock_release();
+  wakelock_release(kWakelockOwner);
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     bluetooth::audio::a2dp::ack_stream_suspended(A2DP_CTRL_ACK_SUCCESS);
@@ -899,6 +942,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
 static void btif_a2dp_source_audio_handle_timer(void) {
   if (btif_av_is_a2dp_offload_running()) return;
+  BT_TRACE_SCOPE(A2DP, "A2DP encode tick");
 
 #ifndef TARGET_FLOSS
   uint64_t timestamp_us = bluetooth::common::time_get_os_boottime_us();
@@ -920,11 +964,31 @@ static void btif_a2dp_source_audio_handle_timer(void) {
 #ifdef __ANDROID__
   ATRACE_INT("btif TX queue", transmit_queue_length);
 #endif
+  BT_TRACE_COUNTER(A2DP, "A2DP TX queue", transmit_queue_length);
   if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
       nullptr) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
         transmit_queue_length);
   }
+
+  // The packets encoded on the previous ticks haven't been sent yet: let
+  // btif_a2dp_source_audio_readbuf() resume encoding when the lower layers
+  // take them. The flag is set before checking the queue again, so that
+  // buffers taken meanwhile aren't missed.
+  if (transmit_queue_length >= A2DP_SOURCE_TX_DEFER_QUEUE_SZ &&
+      btif_a2dp_source_cb.deferred_ticks < A2DP_SOURCE_TX_MAX_DEFERRED_TICKS) {
+    btif_a2dp_source_cb.tx_deferred = true;
+    if (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) >=
+        A2DP_SOURCE_TX_DEFER_QUEUE_SZ) {
+      btif_a2dp_source_cb.deferred_ticks++;
+      btif_a2dp_source_cb.stats.tx_queue_total_deferred_ticks++;
+      bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
+      return;
+    }
+  }
+  btif_a2dp_source_cb.tx_deferred = false;
+  btif_a2dp_source_cb.deferred_ticks = 0;
+
   btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
   bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
   update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
@@ -932,11 +996,41 @@ static void btif_a2dp_source_audio_handle_timer(void) {
                           btif_a2dp_source_cb.encoder_interval_ms * 1000);
 }
 
+// Encodes the frames of the deferred media ticks, as soon as the lower layers
+// took buffers from the tx queue rather than on the next media tick.
+static void btif_a2dp_source_audio_handle_tx_ready(void) {
+  if (btif_av_is_a2dp_offload_running()) return;
+  if (!btif_a2dp_source_is_streaming()) return;
+  if (btif_a2dp_source_cb.deferred_ticks == 0) return;  // Already encoded
+
+  btif_a2dp_source_cb.deferred_ticks = 0;
+  btif_a2dp_source_cb.stats.tx_queue_total_early_encodes++;
+
+  CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
+  if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
+      nullptr) {
+    btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
+        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue));
+  }
+#ifndef TARGET_FLOSS
+  uint64_t timestamp_us = bluetooth::common::time_get_os_boottime_us();
+#else
+  uint64_t timestamp_us = bluetooth::common::time_get_os_monotonic_raw_us();
+#endif
+  btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
+  bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
+}
+
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
   uint32_t bytes_read = 0;
+  uipc_shm_t* audio_shm = btif_a2dp_control_get_audio_shm();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     bytes_read = bluetooth::audio::a2dp::read(p_buf, len);
+  } else if (audio_shm != nullptr) {
+    // The audio HAL writes to shared memory, no system call nor copy through
+    // the kernel
+    bytes_read = uipc_shm_read(audio_shm, p_buf, len);
   } else if (a2dp_uipc != nullptr) {
     bytes_read = UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, p_buf, len);
   }
@@ -1013,6 +1107,12 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
         btif_av_source_active_peer(), btif_a2dp_source_cb.encoder_interval_ms,
         drop_n, num_dropped_encoded_frames, num_dropped_encoded_bytes);
 
+    // Let the encoder lower its bit rate for the congested link
+    if (btif_a2dp_source_cb.encoder_interface != nullptr &&
+        btif_a2dp_source_cb.encoder_interface->on_transmit_flush != nullptr) {
+      btif_a2dp_source_cb.encoder_interface->on_transmit_flush();
+    }
+
     // Intel controllers don't handle ReadRSSI, ReadFailedContactCounter, and
     // ReadTxPower very well, it sends back Hardware Error event which will
     // crash the daemon. So temporarily disable this for Floss.
@@ -1068,6 +1168,8 @@ static void btif_a2dp_source_audio_tx_flush_event(void) {
   fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
 
   if (!bluetooth::audio::a2dp::is_hal_enabled() && a2dp_uipc != nullptr) {
+    uipc_shm_t* audio_shm = btif_a2dp_control_get_audio_shm();
+    if (audio_shm != nullptr) uipc_shm_flush(audio_shm);
     UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_REQ_RX_FLUSH, nullptr);
   }
 }
@@ -1092,6 +1194,16 @@ BT_HDR* btif_a2dp_source_audio_readbuf(void) {
     update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_dequeue_stats,
                             now_us,
                             btif_a2dp_source_cb.encoder_interval_ms * 1000);
+
+    // The lower layers are moving data again, encode the next buffers just in
+    // time for them
+    if (btif_a2dp_source_cb.tx_deferred &&
+        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) <
+            A2DP_SOURCE_TX_DEFER_QUEUE_SZ &&
+        btif_a2dp_source_cb.tx_deferred.exchange(false)) {
+      btif_a2dp_source_thread.DoInThread(
+          FROM_HERE, base::Bind(&btif_a2dp_source_audio_handle_tx_ready));
+    }
   }
 
   return p_buf;
@@ -1201,6 +1313,12 @@ void btif_a2dp_source_debug_dump(int fd) {
           "  Counts (max dropped)                                    : %zu\n",
           accumulated_stats->tx_queue_max_dropped_messages);
 
+  dprintf(fd,
+          "  Counts (deferred ticks/early encodes)                   : %zu / "
+          "%zu\n",
+          accumulated_stats->tx_queue_total_deferred_ticks,
+          accumulated_stats->tx_queue_total_early_encodes);
+
   dprintf(
       fd,
       "  Last update time ago in ms (flushed/dropped)            : %llu / "
@@ -358,6 +358,9 @@ class BtifAvPeer {
     use_latency_mode_ = use_latency_mode;
   }
 
+  bool IsLowLatency() const { return is_low_latency_; }
+  void SetLowLatency(bool is_low_latency) { is_low_latency_ = is_low_latency; }
+
  private:
   const RawAddress peer_address_;
   const uint8_t peer_sep_;  // SEP type of peer device
@@ -372,6 +375,7 @@ class BtifAvPeer {
   uint16_t delay_report_;
   bool mandatory_codec_preferred_ = false;
   bool use_latency_mode_ = false;
+  bool is_low_latency_ = false;
 };
 
 class BtifAvSource {
@@ -961,6 +965,7 @@ bt_status_t BtifAvPeer::Init() {
   alarm_free(av_open_on_rc_timer_);
   av_open_on_rc_timer_ = alarm_new("btif_av_peer.av_open_on_rc_timer");
   is_silenced_ = false;
+  is_low_latency_ = false;
 
   state_machine_.Start();
   return BT_STATUS_SUCCESS;
@@ -1510,7 +1515,7 @@ bool BtifAvStateMachine::StateIdle::ProcessEvent(uint32_t event, void* p_data) {
             "peers",
             __PRETTY_FUNCTION__, ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()));
         if (peer_.SelfInitiatedConnection()) {
-          btif_queue_advance();
+          btif_queue_advance(peer_.PeerAddress());
         }
         break;
       }
@@ -1657,7 +1662,7 @@ bool BtifAvStateMachine::StateIdle::ProcessEvent(uint32_t event, void* p_data) {
         DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(peer_.PeerAddress(),
                                            IOT_CONF_KEY_A2DP_CONN_FAIL_COUNT);
       }
-      btif_queue_advance();
+      btif_queue_advance(peer_.PeerAddress());
     } break;
 
     case BTA_AV_REMOTE_CMD_EVT:
@@ -1746,7 +1751,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
                                    bt_status_t::BT_STATUS_FAIL, BTA_AV_FAIL);
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_queue_advance(peer_.PeerAddress());
       }
       break;
     case BTA_AV_REJECT_EVT:
@@ -1762,7 +1767,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
           bt_status_t::BT_STATUS_AUTH_REJECTED, BTA_AV_FAIL);
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_queue_advance(peer_.PeerAddress());
       }
       break;
 
@@ -1827,7 +1832,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
         BTA_AvOpenRc(peer_.BtaHandle());
       }
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_queue_advance(peer_.PeerAddress());
       }
     } break;
 
@@ -1852,7 +1857,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
       log_counter_metrics_btif(
           android::bluetooth::CodePathCounterKeyEnum::A2DP_ALREADY_CONNECTING,
           1);
-      btif_queue_advance();
+      btif_queue_advance(peer_.PeerAddress());
     } break;
 
     case BTA_AV_PENDING_EVT: {
@@ -1890,7 +1895,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
       DEVICE_IOT_CONFIG_ADDR_INT_ADD_ONE(peer_.PeerAddress(),
                                          IOT_CONF_KEY_A2DP_CONN_FAIL_COUNT);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_queue_advance(peer_.PeerAddress());
       }
       break;
 
@@ -1906,7 +1911,7 @@ bool BtifAvStateMachine::StateOpening::ProcessEvent(uint32_t event,
                                    A2DP_CONNECTION_DISCONNECTED,
                                1);
       if (peer_.SelfInitiatedConnection()) {
-        btif_queue_advance();
+        btif_queue_advance(peer_.PeerAddress());
       }
       break;
 
@@ -2139,7 +2144,7 @@ bool BtifAvStateMachine::StateOpened::ProcessEvent(uint32_t event,
                          __PRETTY_FUNCTION__,
                          ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()),
                          BtifAvEvent::EventName(event).c_str());
-      btif_queue_advance();
+      btif_queue_advance(peer_.PeerAddress());
     } break;
 
     case BTIF_AV_OFFLOAD_START_REQ_EVT:
@@ -2171,6 +2176,8 @@ bool BtifAvStateMachine::StateOpened::ProcessEvent(uint32_t event,
                p_set_latency_req->is_low_latency ? "true" : "false");
 
       BTA_AvSetLatency(peer_.BtaHandle(), p_set_latency_req->is_low_latency);
+      // The encoder applies the mode to the next audio session
+      peer_.SetLowLatency(p_set_latency_req->is_low_latency);
     } break;
 
     default:
@@ -2394,6 +2401,8 @@ bool BtifAvStateMachine::StateStarted::ProcessEvent(uint32_t event,
                p_set_latency_req->is_low_latency ? "true" : "false");
 
       BTA_AvSetLatency(peer_.BtaHandle(), p_set_latency_req->is_low_latency);
+      // The encoder applies the mode to the next audio session
+      peer_.SetLowLatency(p_set_latency_req->is_low_latency);
     } break;
 
       CHECK_RC_EVENT(event, (tBTA_AV*)p_data);
@@ -2481,7 +2490,7 @@ bool BtifAvStateMachine::StateClosing::ProcessEvent(uint32_t event,
                          __PRETTY_FUNCTION__,
                          ADDRESS_TO_LOGGABLE_CSTR(peer_.PeerAddress()),
                          BtifAvEvent::EventName(event).c_str());
-      btif_queue_advance();
+      btif_queue_advance(peer_.PeerAddress());
       peer_.StateMachine().TransitionTo(BtifAvStateMachine::kStateIdle);
       break;
 
@@ -3002,7 +3011,7 @@ static bt_status_t connect_int(RawAddress* peer_address, uint16_t uuid) {
       peer = btif_av_sink.FindOrCreatePeer(*peer_address, kBtaHandleUnknown);
     }
     if (peer == nullptr) {
-      btif_queue_advance();
+      btif_queue_advance(*peer_address);
       return;
     }
     peer->StateMachine().ProcessEvent(BTIF_AV_CONNECT_REQ_EVT, nullptr);
@@ -3549,6 +3558,17 @@ bool btif_av_peer_supports_3mbps(const RawAddress& peer_address) {
   return (is_connected && is3mbps);
 }
 
+bool btif_av_is_low_latency(const RawAddress& peer_address) {
+  BtifAvPeer* peer = btif_av_find_peer(peer_address);
+  if (peer == nullptr) {
+    BTIF_TRACE_WARNING("%s: No peer found for peer_address=%s", __func__,
+                       ADDRESS_TO_LOGGABLE_CSTR(peer_address));
+    return false;
+  }
+
+  return peer->IsConnected() && peer->IsLowLatency();
+}
+
 bool btif_av_peer_prefers_mandatory_codec(const RawAddress& peer_address) {
   BtifAvPeer* peer = btif_av_find_peer(peer_address);
   if (peer == nullptr) {
@@ -3615,6 +3635,7 @@ static void btif_debug_av_peer_dump(int fd, const BtifAvPeer& peer) {
           peer.GetDelayReport());
   dprintf(fd, "    Codec Preferred: %s\n",
           peer.IsMandatoryCodecPreferred() ? "Mandatory" : "Optional");
+  dprintf(fd, "    Low Latency: %s\n", peer.IsLowLatency() ? "true" : "false");
 }
 
 static void btif_debug_av_source_dump(int fd) {
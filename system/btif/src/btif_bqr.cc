@@ -23,13 +23,17 @@
 #include <stdio.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <mutex>
+
 #include "btif/include/stack_manager.h"
 #include "btif_bqr.h"
 #include "btif_common.h"
 #include "btif_storage.h"
 #include "btm_api.h"
 #include "btm_ble_api.h"
-#include "common/leaky_bonded_queue.h"
 #include "common/time_util.h"
 #include "core_callbacks.h"
 #include "osi/include/properties.h"
@@ -39,12 +43,19 @@
 namespace bluetooth {
 namespace bqr {
 
-using bluetooth::common::LeakyBondedQueue;
 using std::chrono::system_clock;
 
-// The instance of BQR event queue
-static std::unique_ptr<LeakyBondedQueue<BqrVseSubEvt>> kpBqrEventQueue(
-    new LeakyBondedQueue<BqrVseSubEvt>(kBqrEventQueueSize));
+// The history of the Link Quality related BQR events, the oldest one being
+// overwritten once full. The events are kept parsed, and only formatted when
+// dumped.
+static std::array<BqrVseSubEvt, kBqrEventQueueSize> bqr_event_history;
+static size_t bqr_event_history_next = 0;
+static size_t bqr_event_history_count = 0;
+// The statistics of the links, the least recently updated one being replaced
+// by a new link once full.
+static std::array<BqrLinkStatistics, kBqrLinkStatisticsSize>
+    bqr_link_statistics;
+static std::mutex bqr_event_history_mutex;
 
 static uint16_t vendor_cap_supported_version;
 
@@ -124,13 +135,14 @@ void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
   length -= kLogDumpParamTotalLen;
   bqr_log_dump_event_.vendor_specific_parameter = p_param_buf;
 
-  std::stringstream ss_log;
-  ss_log << "\n"
-         << std::put_time(&tm_timestamp_, "%m-%d %H:%M:%S ")
-         << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
-         << " VSP: ";
+  char log[64];
+  size_t log_len =
+      strftime(log, sizeof(log), "\n%m-%d %H:%M:%S ", &tm_timestamp_);
+  log_len += snprintf(log + log_len, sizeof(log) - log_len,
+                      "Handle: 0x%04x VSP: ",
+                      bqr_log_dump_event_.connection_handle);
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
+  TEMP_FAILURE_RETRY(write(fd, log, log_len));
   TEMP_FAILURE_RETRY(
       write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
   LmpLlMessageTraceCounter++;
@@ -146,13 +158,14 @@ void BqrVseSubEvt::WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
   length -= kLogDumpParamTotalLen;
   bqr_log_dump_event_.vendor_specific_parameter = p_param_buf;
 
-  std::stringstream ss_log;
-  ss_log << "\n"
-         << std::put_time(&tm_timestamp_, "%m-%d %H:%M:%S ")
-         << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
-         << " VSP: ";
+  char log[64];
+  size_t log_len =
+      strftime(log, sizeof(log), "\n%m-%d %H:%M:%S ", &tm_timestamp_);
+  log_len += snprintf(log + log_len, sizeof(log) - log_len,
+                      "Handle: 0x%04x VSP: ",
+                      bqr_log_dump_event_.connection_handle);
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
+  TEMP_FAILURE_RETRY(write(fd, log, log_len));
   TEMP_FAILURE_RETRY(
       write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
   BtSchedulingTraceCounter++;
@@ -535,12 +548,20 @@ void CategorizeBqrEvent(uint8_t length, const uint8_t* p_bqr_event) {
 
 void AddLinkQualityEventToQueue(uint8_t length,
                                 const uint8_t* p_link_quality_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
+  BqrVseSubEvt bqr_event;
+  BqrVseSubEvt* p_bqr_event = &bqr_event;
   RawAddress bd_addr;
 
   p_bqr_event->ParseBqrLinkQualityEvt(length, p_link_quality_event);
 
-  LOG(WARNING) << *p_bqr_event;
+  // The periodic reports of the monitoring mode are aggregated in the link
+  // statistics, and only logged when the link is in bad condition.
+  const BqrLinkQualityEvent& event = p_bqr_event->bqr_link_quality_event_;
+  bool warning = (event.rssi < kCriWarnRssi ||
+                  event.unused_afh_channel_count > kCriWarnUnusedCh);
+  if (event.quality_report_id != QUALITY_REPORT_ID_MONITOR_MODE || warning) {
+    LOG(WARNING) << *p_bqr_event;
+  }
   GetInterfaceToProfiles()->events->invoke_link_quality_report_cb(
       bluetooth::common::time_get_os_boottime_ms(),
       p_bqr_event->bqr_link_quality_event_.quality_report_id,
@@ -600,11 +621,83 @@ void AddLinkQualityEventToQueue(uint8_t length,
     }
   }
 
-  kpBqrEventQueue->Enqueue(p_bqr_event.release());
+  std::unique_lock<std::mutex> lock(bqr_event_history_mutex);
+  bqr_event_history[bqr_event_history_next] = bqr_event;
+  bqr_event_history_next = (bqr_event_history_next + 1) % kBqrEventQueueSize;
+  if (bqr_event_history_count < kBqrEventQueueSize) {
+    bqr_event_history_count++;
+  }
+  AddLinkQualityEventToStatistics(p_bqr_event->bqr_link_quality_event_,
+                                  bluetooth::common::time_get_os_boottime_ms());
+}
+
+void AddLinkQualityEventToStatistics(const BqrLinkQualityEvent& event,
+                                     uint64_t now_ms) {
+  BqrLinkStatistics* p_stats = nullptr;
+  BqrLinkStatistics* p_oldest = &bqr_link_statistics[0];
+  for (auto& stats : bqr_link_statistics) {
+    if (!stats.in_use) {
+      if (p_oldest->in_use) p_oldest = &stats;
+      continue;
+    }
+    if (stats.connection_handle == event.connection_handle) {
+      p_stats = &stats;
+      break;
+    }
+    if (p_oldest->in_use && stats.last_event_ms < p_oldest->last_event_ms) {
+      p_oldest = &stats;
+    }
+  }
+
+  // The handle of a disconnected link may be reused by another device
+  if (p_stats != nullptr && p_stats->bdaddr != event.bdaddr) {
+    p_oldest = p_stats;
+    p_stats = nullptr;
+  }
+
+  if (p_stats == nullptr) {
+    p_stats = p_oldest;
+    *p_stats = {};
+    p_stats->in_use = true;
+    p_stats->connection_handle = event.connection_handle;
+    p_stats->bdaddr = event.bdaddr;
+    p_stats->rssi_average = event.rssi * 256;
+    p_stats->snr_average = event.snr * 256;
+    p_stats->rssi_min = event.rssi;
+  } else {
+    p_stats->rssi_average += (event.rssi * 256 - p_stats->rssi_average) /
+                             (1 << kBqrRollingAverageShift);
+    p_stats->snr_average += (event.snr * 256 - p_stats->snr_average) /
+                            (1 << kBqrRollingAverageShift);
+    p_stats->rssi_min = std::min(p_stats->rssi_min, event.rssi);
+  }
+
+  switch (event.quality_report_id) {
+    case QUALITY_REPORT_ID_MONITOR_MODE:
+      p_stats->monitor_count++;
+      break;
+    case QUALITY_REPORT_ID_APPROACH_LSTO:
+      p_stats->approach_lsto_count++;
+      break;
+    case QUALITY_REPORT_ID_A2DP_AUDIO_CHOPPY:
+    case QUALITY_REPORT_ID_SCO_VOICE_CHOPPY:
+    case QUALITY_REPORT_ID_LE_AUDIO_CHOPPY:
+      p_stats->choppy_count++;
+      break;
+    case QUALITY_REPORT_ID_CONNECT_FAIL:
+      p_stats->connect_fail_count++;
+      break;
+  }
+  p_stats->retransmission_count += event.retransmission_count;
+  p_stats->no_rx_count += event.no_rx_count;
+  p_stats->nak_count += event.nak_count;
+  p_stats->flow_off_count += event.flow_off_count;
+  p_stats->last_event_ms = now_ms;
 }
 
 void DumpLmpLlMessage(uint8_t length, const uint8_t* p_lmp_ll_message_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
+  BqrVseSubEvt bqr_event;
+  BqrVseSubEvt* p_bqr_event = &bqr_event;
 
   if (LmpLlMessageTraceLogFd == INVALID_FD ||
       LmpLlMessageTraceCounter >= kLogDumpEventPerFile) {
@@ -639,7 +732,8 @@ int OpenLmpLlTraceLogFile() {
 }
 
 void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
+  BqrVseSubEvt bqr_event;
+  BqrVseSubEvt* p_bqr_event = &bqr_event;
 
   if (BtSchedulingTraceLogFd == INVALID_FD ||
       BtSchedulingTraceCounter == kLogDumpEventPerFile) {
@@ -651,6 +745,24 @@ void DumpBtScheduling(uint8_t length, const uint8_t* p_bt_scheduling_event) {
   }
 }
 
+static void DumpLinkStatistics(int fd) {
+  dprintf(fd, "\nBT Quality Report Link Statistics: \n");
+  for (const auto& stats : bqr_link_statistics) {
+    if (!stats.in_use) continue;
+    dprintf(fd,
+            "  Handle: 0x%04x, RemoteDevAddr: %s, Monitoring: %u, "
+            "ApproachLSTO: %u, Choppy: %u, ConnectFail: %u, RSSI: %.1f "
+            "(min %d), SNR: %.1f, ReTx: %" PRIu64 ", NoRX: %" PRIu64
+            ", NAK: %" PRIu64 ", FlowOff: %" PRIu64 "\n",
+            stats.connection_handle, ADDRESS_TO_LOGGABLE_CSTR(stats.bdaddr),
+            stats.monitor_count, stats.approach_lsto_count, stats.choppy_count,
+            stats.connect_fail_count, stats.rssi_average / 256.0,
+            stats.rssi_min, stats.snr_average / 256.0,
+            stats.retransmission_count, stats.no_rx_count, stats.nak_count,
+            stats.flow_off_count);
+  }
+}
+
 int OpenBtSchedulingTraceLogFile() {
   if (rename(kpBtSchedulingTraceLogPath, kpBtSchedulingTraceLastLogPath) != 0 &&
       errno != ENOENT) {
@@ -674,15 +786,23 @@ int OpenBtSchedulingTraceLogFile() {
 }
 
 void DebugDump(int fd) {
+  std::unique_lock<std::mutex> lock(bqr_event_history_mutex);
+  DumpLinkStatistics(fd);
+
   dprintf(fd, "\nBT Quality Report Events: \n");
 
-  if (kpBqrEventQueue->Empty()) {
+  if (bqr_event_history_count == 0) {
     dprintf(fd, "Event queue is empty.\n");
     return;
   }
 
-  while (!kpBqrEventQueue->Empty()) {
-    std::unique_ptr<BqrVseSubEvt> p_event(kpBqrEventQueue->Dequeue());
+  // The events are dumped from the oldest one, and forgotten once dumped
+  size_t index = (bqr_event_history_next + kBqrEventQueueSize -
+                  bqr_event_history_count) %
+                 kBqrEventQueueSize;
+  for (; bqr_event_history_count > 0; bqr_event_history_count--) {
+    const BqrVseSubEvt* p_event = &bqr_event_history[index];
+    index = (index + 1) % kBqrEventQueueSize;
 
     bool warning = (p_event->bqr_link_quality_event_.rssi < kCriWarnRssi ||
                     p_event->bqr_link_quality_event_.unused_afh_channel_count >
@@ -357,4 +357,7 @@ void btif_debug_config_dump(int fd) {
   dprintf(fd, "  Devices loaded: %zu\n", devices.size());
   dprintf(fd, "  File created/tagged: %s\n", btif_config_time_created);
   dprintf(fd, "  File source: %s\n", file_source->c_str());
+  if (bluetooth::shim::is_gd_stack_started_up()) {
+    bluetooth::shim::BtifConfigInterface::Dump(fd);
+  }
 }
@@ -74,6 +74,7 @@
 #include "btif_util.h"
 #include "common/lru.h"
 #include "common/metrics.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/device_iot_config.h"
 #include "device/include/interop.h"
@@ -223,6 +224,33 @@ typedef struct {
 static bluetooth::common::LruCache<RawAddress, std::set<Uuid>> eir_uuids_cache(
     MAX_NUM_DEVICES_IN_EIR_UUID_CACHE);
 
+/* The inquiry results repeating the last report of a device within this
+ * interval are not reported again */
+#define BTIF_DM_INQUIRY_REPORT_INTERVAL_MS 1000
+
+#define MAX_NUM_DEVICES_IN_INQUIRY_REPORT_CACHE 256
+
+/* Last inquiry result reported and stored for a device during the current
+ * discovery */
+typedef struct {
+  uint64_t report_time_ms;
+  std::string name;
+  uint32_t cod;
+  bt_device_type_t dev_type;
+  tBLE_ADDR_TYPE addr_type;
+  bool include_rsi;
+  int16_t asha_capability;
+  uint32_t asha_truncated_hi_sync_id;
+  size_t num_eir_uuids;
+  uint16_t appearance;
+} btif_dm_inquiry_report_t;
+
+static bluetooth::common::LruCache<RawAddress, btif_dm_inquiry_report_t>
+    inquiry_reports(MAX_NUM_DEVICES_IN_INQUIRY_REPORT_CACHE);
+
+/* Read once per discovery */
+static bool restrict_discovered_device_report = false;
+
 static skip_sdp_entry_t sdp_rejectlist[] = {{76}};  // Apple Mouse and Keyboard
 
 /* This flag will be true if HCI_Inquiry is in progress */
@@ -1122,6 +1150,34 @@ static void btif_dm_ssp_key_notif_evt(tBTA_DM_SP_KEY_NOTIF* p_ssp_key_notif) {
       bd_addr, bd_name, cod, BT_SSP_VARIANT_PASSKEY_NOTIFICATION,
       p_ssp_key_notif->passkey);
 }
+/*******************************************************************************
+ *
+ * Function         btif_dm_inquiry_report_is_repeat
+ *
+ * Description      Checks if the inquiry result |report| only repeats the
+ *                  |last_report| of the device, recently enough
+ *
+ * Returns          true if |report| does not need to be reported
+ *
+ ******************************************************************************/
+static bool btif_dm_inquiry_report_is_repeat(
+    const btif_dm_inquiry_report_t& last_report,
+    const btif_dm_inquiry_report_t& report) {
+  if (report.report_time_ms - last_report.report_time_ms >=
+      BTIF_DM_INQUIRY_REPORT_INTERVAL_MS) {
+    return false;
+  }
+  return last_report.name == report.name && last_report.cod == report.cod &&
+         last_report.dev_type == report.dev_type &&
+         last_report.addr_type == report.addr_type &&
+         last_report.include_rsi == report.include_rsi &&
+         last_report.asha_capability == report.asha_capability &&
+         last_report.asha_truncated_hi_sync_id ==
+             report.asha_truncated_hi_sync_id &&
+         last_report.num_eir_uuids == report.num_eir_uuids &&
+         last_report.appearance == report.appearance;
+}
+
 /*******************************************************************************
  *
  * Function         btif_dm_auth_cmpl_evt
@@ -1387,6 +1443,10 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
                 "failed to save remote device property", status);
         GetInterfaceToProfiles()->events->invoke_remote_device_properties_cb(
             status, bdaddr, 1, properties);
+        auto report_iter = inquiry_reports.find(bdaddr);
+        if (report_iter != inquiry_reports.end()) {
+          report_iter->second.name = (char*)p_search_data->disc_res.bd_name;
+        }
         /** Fix inquiry time too long @{ */
         uint32_t cod = 0;
         /* Check if we already have cod in our btif_storage cache */
@@ -1427,8 +1487,23 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
                        p_search_data->inq_res.device_type);
       bdname.name[0] = 0;
 
-      if (!check_eir_remote_name(p_search_data, bdname.name, &remote_name_len))
-        check_cached_remote_name(p_search_data, bdname.name, &remote_name_len);
+      /* The name and type of a device already reported in this discovery are
+       * known without reading the storage */
+      auto report_iter = inquiry_reports.find(bdaddr);
+      const btif_dm_inquiry_report_t* p_last_report =
+          (report_iter != inquiry_reports.end()) ? &report_iter->second
+                                                 : nullptr;
+
+      if (!check_eir_remote_name(p_search_data, bdname.name,
+                                 &remote_name_len)) {
+        if (p_last_report != nullptr) {
+          strlcpy((char*)bdname.name, p_last_report->name.c_str(),
+                  sizeof(bdname.name));
+        } else {
+          check_cached_remote_name(p_search_data, bdname.name,
+                                   &remote_name_len);
+        }
+      }
 
       /* Check EIR for services */
       if (p_search_data->inq_res.p_eir) {
@@ -1473,7 +1548,16 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
 
         /* Verify if the device is dual mode in NVRAM */
         int stored_device_type = 0;
-        if (btif_get_device_type(bdaddr, &stored_device_type) &&
+        bool has_stored_device_type;
+        if (p_last_report != nullptr) {
+          /* the type of the last report is the one stored */
+          stored_device_type = p_last_report->dev_type;
+          has_stored_device_type = true;
+        } else {
+          has_stored_device_type =
+              btif_get_device_type(bdaddr, &stored_device_type);
+        }
+        if (has_stored_device_type &&
             ((stored_device_type != BT_DEVICE_TYPE_BREDR &&
               p_search_data->inq_res.device_type == BT_DEVICE_TYPE_BREDR) ||
              (stored_device_type != BT_DEVICE_TYPE_BLE &&
@@ -1536,6 +1620,8 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
 #endif
         // Scope needs to persist until `invoke_device_found_cb` below.
         std::vector<uint8_t> property_value;
+        size_t num_eir_uuids =
+            (p_last_report != nullptr) ? p_last_report->num_eir_uuids : 0;
         /* Cache EIR queried services */
         if (num_uuids > 0) {
           uint16_t* p_uuid16 = (uint16_t*)uuid_list;
@@ -1550,6 +1636,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
             LOG_INFO("        %s", uuid.ToString().c_str());
             uuid_iter->second.insert(uuid);
           }
+          num_eir_uuids = uuid_iter->second.size();
 
           if (report_eir_uuids) {
             for (auto uuid : uuid_iter->second) {
@@ -1575,6 +1662,29 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
           num_properties++;
         }
 
+        btif_dm_inquiry_report_t report = {
+            .report_time_ms = bluetooth::common::time_get_os_boottime_ms(),
+            .name = (char*)bdname.name,
+            .cod = cod,
+            .dev_type = dev_type,
+            .addr_type = addr_type,
+            .include_rsi = p_search_data->inq_res.include_rsi,
+            .asha_capability = asha_capability,
+            .asha_truncated_hi_sync_id = asha_truncated_hi_sync_id,
+            .num_eir_uuids = num_eir_uuids,
+            .appearance = appearance,
+        };
+        /* Advertising and scan response data carry different fields */
+        if (p_last_report != nullptr && report.appearance == 0) {
+          report.appearance = p_last_report->appearance;
+        }
+        if (p_last_report != nullptr &&
+            btif_dm_inquiry_report_is_repeat(*p_last_report, report)) {
+          /* Only the RSSI changed, nothing new to store or report */
+          break;
+        }
+        inquiry_reports.insert_or_assign(bdaddr, report);
+
         status =
             btif_storage_add_remote_device(&bdaddr, num_properties, properties);
         ASSERTC(status == BT_STATUS_SUCCESS,
@@ -1583,9 +1693,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         ASSERTC(status == BT_STATUS_SUCCESS,
                 "failed to save remote addr type (inquiry)", status);
 
-        bool restrict_report = osi_property_get_bool(
-            "bluetooth.restrict_discovered_device.enabled", false);
-        if (restrict_report &&
+        if (restrict_discovered_device_report &&
             p_search_data->inq_res.device_type == BT_DEVICE_TYPE_BLE &&
             !(p_search_data->inq_res.ble_evt_type & BTM_BLE_CONNECTABLE_MASK)) {
           LOG_INFO("%s: Ble device is not connectable",
@@ -2101,11 +2209,8 @@ void BTIF_dm_enable() {
   pairing_cb = {};
   pairing_cb.bond_type = tBTM_SEC_DEV_REC::BOND_TYPE_PERSISTENT;
 
-  // Enable address consolidation.
-  btif_storage_load_le_devices();
-
-  /* This function will also trigger the adapter_properties_cb
-  ** and bonded_devices_info_cb
+  /* This function will also consolidate the LE addresses, and trigger the
+  ** adapter_properties_cb and bonded_devices_info_cb
   */
   btif_storage_load_bonded_devices();
   bluetooth::bqr::EnableBtQualityReport(true);
@@ -2454,6 +2559,9 @@ void btif_dm_start_discovery(void) {
 
   /* Will be enabled to true once inquiry busy level has been received */
   btif_dm_inquiry_in_progress = false;
+  inquiry_reports.clear();
+  restrict_discovered_device_report = osi_property_get_bool(
+      "bluetooth.restrict_discovered_device.enabled", false);
   /* find nearby devices */
   BTA_DmSearch(btif_dm_search_devices_evt);
 }
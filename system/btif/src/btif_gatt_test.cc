@@ -154,7 +154,7 @@ static void btif_test_discovery_result_cback(UNUSED_ATTR uint16_t conn_id,
 
 static void btif_test_discovery_complete_cback(
     UNUSED_ATTR uint16_t conn_id, UNUSED_ATTR tGATT_DISC_TYPE disc_type,
-    tGATT_STATUS status) {
+    tGATT_STATUS status, UNUSED_ATTR uint16_t e_handle) {
   LOG_INFO("%s: status=%d", __func__, status);
 }
 
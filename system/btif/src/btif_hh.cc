@@ -31,6 +31,7 @@
 
 #include <base/logging.h>
 
+#include <cinttypes>
 #include <cstdint>
 
 #include "bta_hh_co.h"
@@ -1901,6 +1902,20 @@ void DumpsysHid(int fd) {
                   bthh_connection_state_text(p_dev->dev_status).c_str(),
                   (p_dev->ready_for_data) ? ("T") : ("F"),
                   static_cast<int>(p_dev->hh_poll_thread_id));
+      const btif_hh_input_stats_t* p_stats = &p_dev->input_stats;
+      if (p_stats->num_reports == 0) continue;
+      uint64_t duration_us =
+          p_stats->last_report_us - p_stats->first_report_us;
+      LOG_DUMPSYS(fd,
+                  "     input reports:%" PRIu64 " dropped:%" PRIu64
+                  " rate:%" PRIu64 "/s write avg:%" PRIu64 "us max:%" PRIu64
+                  "us",
+                  p_stats->num_reports, p_stats->num_dropped,
+                  (duration_us > 0)
+                      ? (p_stats->num_reports - 1) * 1000000 / duration_us
+                      : 0,
+                  p_stats->total_write_us / p_stats->num_reports,
+                  p_stats->max_write_us);
     }
   }
   for (unsigned i = 0; i < BTIF_HH_MAX_ADDED_DEV; i++) {
@@ -34,11 +34,15 @@
 #include <base/strings/stringprintf.h>
 #include <string.h>
 
+#include <algorithm>
+#include <chrono>
 #include <list>
+#include <vector>
 
 #include "btif/include/stack_manager.h"
 #include "btif_common.h"
 #include "main/shim/dumpsys.h"
+#include "osi/include/alarm.h"
 #include "types/raw_address.h"
 
 /*******************************************************************************
@@ -50,7 +54,10 @@ class ConnectNode {
  public:
   ConnectNode(const RawAddress& address, uint16_t uuid,
               btif_connect_cb_t connect_cb)
-      : address_(address), uuid_(uuid), busy_(false), connect_cb_(connect_cb) {}
+      : address_(address),
+        uuid_(uuid),
+        busy_(false),
+        connect_cb_(connect_cb) {}
 
   std::string ToString() const {
     return base::StringPrintf("address=%s UUID=%04X busy=%s",
@@ -60,17 +67,21 @@ class ConnectNode {
 
   const RawAddress& address() const { return address_; }
   uint16_t uuid() const { return uuid_; }
+  bool busy() const { return busy_; }
+  std::chrono::steady_clock::time_point deadline() const { return deadline_; }
 
   /**
    * Initiate the connection.
    *
+   * @param deadline the time after which the connection is considered stuck
    * @return BT_STATUS_SUCCESS on success, othewise the corresponding error
    * code. Note: if a previous connect request hasn't been completed, the
    * return value is BT_STATUS_SUCCESS.
    */
-  bt_status_t connect() {
+  bt_status_t connect(std::chrono::steady_clock::time_point deadline) {
     if (busy_) return BT_STATUS_SUCCESS;
     busy_ = true;
+    deadline_ = deadline;
     return connect_cb_(&address_, uuid_);
   }
 
@@ -79,20 +90,59 @@ class ConnectNode {
   uint16_t uuid_;
   bool busy_;
   btif_connect_cb_t connect_cb_;
+  std::chrono::steady_clock::time_point deadline_;
 };
 
 /*******************************************************************************
  *  Static variables
  ******************************************************************************/
 
+// The requests are executed in order for each device, the requests of
+// different devices are executed concurrently.
 static std::list<ConnectNode> connect_queue;
 
 static const size_t MAX_REASONABLE_REQUESTS = 20;
 
+// A request still not advanced after this time is dropped, so that the next
+// requests of the device are not blocked by a profile that never reports.
+static const std::chrono::seconds CONNECT_TIMEOUT{30};
+
+static alarm_t* connect_timeout_alarm = nullptr;
+
 /*******************************************************************************
  *  Queue helper functions
  ******************************************************************************/
 
+static void queue_int_timeout();
+
+// Arm the timeout alarm for the first busy request to time out.
+static void queue_int_schedule_timeout() {
+  const ConnectNode* first = nullptr;
+  for (const auto& node : connect_queue) {
+    if (node.busy() &&
+        (first == nullptr || node.deadline() < first->deadline())) {
+      first = &node;
+    }
+  }
+
+  if (first == nullptr) {
+    if (connect_timeout_alarm != nullptr) alarm_cancel(connect_timeout_alarm);
+    return;
+  }
+
+  if (connect_timeout_alarm == nullptr) {
+    connect_timeout_alarm = alarm_new("btif_queue.connect_timeout_alarm");
+  }
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+      first->deadline() - std::chrono::steady_clock::now());
+  alarm_set(
+      connect_timeout_alarm, std::max<int64_t>(delay.count(), 0),
+      [](void*) {
+        do_in_jni_thread(FROM_HERE, base::Bind(&queue_int_timeout));
+      },
+      nullptr);
+}
+
 static void queue_int_add(uint16_t uuid, const RawAddress& bda,
                           btif_connect_cb_t connect_cb) {
   // Sanity check to make sure we're not leaking connection requests
@@ -113,13 +163,31 @@ static void queue_int_add(uint16_t uuid, const RawAddress& bda,
   btif_queue_connect_next();
 }
 
-static void queue_int_advance() {
-  if (connect_queue.empty()) return;
+static void queue_int_advance(const RawAddress& bda) {
+  for (auto it = connect_queue.begin(); it != connect_queue.end(); it++) {
+    if (it->address() != bda) continue;
+    // Only the first request of a device can be in progress
+    if (!it->busy()) break;
+    LOG_INFO("%s: removing connection request: %s", __func__,
+             it->ToString().c_str());
+    connect_queue.erase(it);
+    break;
+  }
+
+  btif_queue_connect_next();
+}
 
-  const ConnectNode& head = connect_queue.front();
-  LOG_INFO("%s: removing connection request: %s", __func__,
-           head.ToString().c_str());
-  connect_queue.pop_front();
+static void queue_int_timeout() {
+  auto now = std::chrono::steady_clock::now();
+  for (auto it = connect_queue.begin(); it != connect_queue.end();) {
+    auto it_prev = it++;
+    const ConnectNode& node = *it_prev;
+    if (node.busy() && node.deadline() <= now) {
+      LOG_WARN("%s: connection request timed out: %s", __func__,
+               node.ToString().c_str());
+      connect_queue.erase(it_prev);
+    }
+  }
 
   btif_queue_connect_next();
 }
@@ -136,9 +204,14 @@ static void queue_int_cleanup(uint16_t uuid) {
       connect_queue.erase(it_prev);
     }
   }
+  queue_int_schedule_timeout();
 }
 
-static void queue_int_release() { connect_queue.clear(); }
+static void queue_int_release() {
+  connect_queue.clear();
+  alarm_free(connect_timeout_alarm);
+  connect_timeout_alarm = nullptr;
+}
 
 /*******************************************************************************
  *
@@ -173,14 +246,14 @@ void btif_queue_cleanup(uint16_t uuid) {
  *
  * Function         btif_queue_advance
  *
- * Description      Clear the queue's busy status and advance to the next
- *                  scheduled connection.
+ * Description      Remove the connection in progress for a device and advance
+ *                  to the next scheduled connections.
  *
  * Returns          void
  *
  ******************************************************************************/
-void btif_queue_advance() {
-  do_in_jni_thread(FROM_HERE, base::Bind(&queue_int_advance));
+void btif_queue_advance(const RawAddress& bda) {
+  do_in_jni_thread(FROM_HERE, base::Bind(&queue_int_advance, bda));
 }
 
 bt_status_t btif_queue_connect_next(void) {
@@ -192,16 +265,40 @@ bt_status_t btif_queue_connect_next(void) {
   if (!stack_manager_get_interface()->get_stack_is_running())
     return BT_STATUS_FAIL;
 
-  ConnectNode& head = connect_queue.front();
+  // Start the first request of each device, the requests of a device wait for
+  // the previous one to be advanced.
+  bt_status_t status = BT_STATUS_FAIL;
+  std::vector<RawAddress> devices;
+  for (auto it = connect_queue.begin(); it != connect_queue.end();) {
+    auto it_prev = it++;
+    ConnectNode& node = *it_prev;
+    if (std::find(devices.begin(), devices.end(), node.address()) !=
+        devices.end()) {
+      continue;
+    }
+    if (node.busy()) {
+      devices.push_back(node.address());
+      status = BT_STATUS_SUCCESS;
+      continue;
+    }
 
-  LOG_INFO("Executing profile connection request:%s", head.ToString().c_str());
-  bt_status_t b_status = head.connect();
-  if (b_status != BT_STATUS_SUCCESS) {
-    LOG_INFO("%s: connect %s failed, advance to next scheduled connection.",
-             __func__, head.ToString().c_str());
-    btif_queue_advance();
+    LOG_INFO("Executing profile connection request:%s",
+             node.ToString().c_str());
+    if (node.connect(std::chrono::steady_clock::now() + CONNECT_TIMEOUT) !=
+        BT_STATUS_SUCCESS) {
+      LOG_INFO("%s: connect %s failed, advance to next scheduled connection.",
+               __func__, node.ToString().c_str());
+      connect_queue.erase(it_prev);
+      // The next request of the device, if any, is the next one to execute
+      it = connect_queue.begin();
+      continue;
+    }
+    devices.push_back(node.address());
+    status = BT_STATUS_SUCCESS;
   }
-  return b_status;
+
+  queue_int_schedule_timeout();
+  return status;
 }
 
 /*******************************************************************************
@@ -23,6 +23,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <unordered_map>
 
 #include "bta/include/bta_jv_api.h"
 #include "btif/include/btif_metrics_logging.h"
@@ -43,9 +44,13 @@
 struct packet {
   struct packet *next, *prev;
   uint32_t len;
+  uint32_t offset;  // bytes of |data| already delivered to app
   uint8_t* data;
 };
 
+// Messages read from the app socket and sent to L2CAP per wakeup
+#define L2CAP_SOCK_TX_BATCH_MAX 8
+
 typedef struct l2cap_socket {
   struct l2cap_socket* prev;  // link to prev list item
   struct l2cap_socket* next;  // link to next list item
@@ -81,6 +86,8 @@ static void btsock_l2cap_server_listen(l2cap_socket* sock);
 static std::mutex state_lock;
 
 l2cap_socket* socks = NULL;
+/* The sockets of |socks| by id, looked up on each data event */
+static std::unordered_map<uint32_t, l2cap_socket*> socks_by_id;
 static uint32_t last_sock_id = 0;
 static uid_set_t* uid_set = NULL;
 static int pth = -1;
@@ -117,60 +124,35 @@ static char packet_get_head_l(l2cap_socket* sock, uint8_t** data,
   else
     sock->last_packet = NULL;
 
-  if (len) sock->bytes_buffered -= *len;
+  sock->bytes_buffered -= p->len - p->offset;
 
   osi_free(p);
 
   return true;
 }
 
-static struct packet* packet_alloc(const uint8_t* data, uint32_t len) {
+/* allocates a packet of |len| bytes, to be filled by the caller */
+static struct packet* packet_alloc(uint32_t len) {
   struct packet* p = (struct packet*)osi_calloc(sizeof(*p));
-  uint8_t* buf = (uint8_t*)osi_malloc(len);
-
-  p->data = buf;
+  p->data = (uint8_t*)osi_malloc(len);
   p->len = len;
-  memcpy(p->data, data, len);
   return p;
 }
 
-/* makes a copy of the data, returns true on success */
-static char packet_put_head_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
-
-  /*
-   * We do not check size limits here since this is used to undo "getting" a
-   * packet that the user read incompletely. That is to say the packet was
-   * already in the queue. We do check thos elimits in packet_put_tail_l() since
-   * that function is used to put new data into the queue.
-   */
-
-  if (!p) return false;
-
-  p->prev = NULL;
-  p->next = sock->first_packet;
-  sock->first_packet = p;
-  if (p->next)
-    p->next->prev = p;
-  else
-    sock->last_packet = p;
-
-  sock->bytes_buffered += len;
-
-  return true;
+static void packet_free(struct packet* p) {
+  osi_free(p->data);
+  osi_free(p);
 }
 
-/* makes a copy of the data, returns true on success */
-static char packet_put_tail_l(l2cap_socket* sock, const void* data,
-                              uint32_t len) {
+/* takes ownership of |p|, returns true on success */
+static char packet_put_tail_l(l2cap_socket* sock, struct packet* p) {
   if (sock->bytes_buffered >= L2CAP_MAX_RX_BUFFER) {
     LOG_ERROR("Unable to add to buffer due to buffer overflow socket_id:%u",
               sock->id);
+    packet_free(p);
     return false;
   }
 
-  struct packet* p = packet_alloc((const uint8_t*)data, len);
   p->next = NULL;
   p->prev = sock->last_packet;
   sock->last_packet = p;
@@ -179,7 +161,7 @@ static char packet_put_tail_l(l2cap_socket* sock, const void* data,
   else
     sock->first_packet = p;
 
-  sock->bytes_buffered += len;
+  sock->bytes_buffered += p->len;
 
   return true;
 }
@@ -191,11 +173,8 @@ static char is_inited(void) {
 
 /* only call with std::mutex taken */
 static l2cap_socket* btsock_l2cap_find_by_id_l(uint32_t id) {
-  l2cap_socket* sock = socks;
-
-  while (sock && sock->id != id) sock = sock->next;
-
-  return sock;
+  auto it = socks_by_id.find(id);
+  return (it != socks_by_id.end()) ? it->second : NULL;
 }
 
 static void btsock_l2cap_free_l(l2cap_socket* sock) {
@@ -225,6 +204,7 @@ static void btsock_l2cap_free_l(l2cap_socket* sock) {
     sock->prev->next = sock->next;
   else
     socks = sock->next;
+  socks_by_id.erase(sock->id);
 
   shutdown(sock->our_fd, SHUT_RDWR);
   close(sock->our_fd);
@@ -316,18 +296,8 @@ static l2cap_socket* btsock_l2cap_alloc_l(const char* name,
   socks = sock;
   /* paranoia cap on: verify no ID duplicates due to overflow and fix as needed
    */
-  while (1) {
-    l2cap_socket* t;
-    t = socks->next;
-    while (t && t->id != sock->id) {
-      t = t->next;
-    }
-    if (!t && sock->id) /* non-zeor handle is unique -> we're done */
-      break;
-    /* if we're here, we found a duplicate */
-    if (!++sock->id) /* no zero IDs allowed */
-      sock->id++;
-  }
+  while (!sock->id || socks_by_id.count(sock->id)) sock->id++;
+  socks_by_id[sock->id] = sock;
   last_sock_id = sock->id;
   LOG_INFO("Allocated l2cap socket structure socket_id:%u", sock->id);
   return sock;
@@ -341,6 +311,7 @@ bt_status_t btsock_l2cap_init(int handle, uid_set_t* set) {
   std::unique_lock<std::mutex> lock(state_lock);
   pth = handle;
   socks = NULL;
+  socks_by_id.clear();
   uid_set = set;
   return BT_STATUS_SUCCESS;
 }
@@ -478,6 +449,8 @@ static void on_srv_l2cap_psm_connect_l(tBTA_JV_L2CAP_OPEN* p_open,
   uint32_t new_listen_id = accept_rs->id;
   accept_rs->id = sock->id;
   sock->id = new_listen_id;
+  socks_by_id[accept_rs->id] = accept_rs;
+  socks_by_id[sock->id] = sock;
 
   btif_sock_connection_logger(
       SOCKET_CONNECTION_STATE_CONNECTED,
@@ -661,10 +634,13 @@ static void on_l2cap_data_ind(tBTA_JV* evt, uint32_t id) {
   uint32_t count;
 
   if (BTA_JvL2capReady(sock->handle, &count) == BTA_JV_SUCCESS) {
-    std::vector<uint8_t> buffer(count);
-    if (BTA_JvL2capRead(sock->handle, sock->id, buffer.data(), count) ==
+    /* Read all the queued data straight into the packet given to the app */
+    struct packet* p = packet_alloc(count);
+    if (BTA_JvL2capRead(sock->handle, sock->id, p->data, count) !=
         BTA_JV_SUCCESS) {
-      if (packet_put_tail_l(sock, buffer.data(), count)) {
+      packet_free(p);
+    } else {
+      if (packet_put_tail_l(sock, p)) {
         bytes_read = count;
         btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP, SOCK_THREAD_FD_WR,
                              sock->id);
@@ -853,24 +829,26 @@ bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel,
  * (for example: unrecoverable error or no data)
  */
 static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  uint32_t len;
+  struct packet* p;
 
-  while (packet_get_head_l(sock, &buf, &len)) {
+  while ((p = sock->first_packet) != NULL) {
+    uint32_t len = p->len - p->offset;
     ssize_t sent;
-    OSI_NO_INTR(sent = send(sock->our_fd, buf, len, MSG_DONTWAIT));
+    OSI_NO_INTR(sent = send(sock->our_fd, p->data + p->offset, len,
+                            MSG_DONTWAIT));
     int saved_errno = errno;
 
-    if (sent == (signed)len)
-      osi_free(buf);
-    else if (sent >= 0) {
-      packet_put_head_l(sock, buf + sent, len - sent);
+    if (sent == (signed)len) {
+      uint8_t* buf;
+      packet_get_head_l(sock, &buf, NULL);
       osi_free(buf);
+    } else if (sent >= 0) {
+      /* keep the rest of the packet in place for the next wakeup */
+      p->offset += sent;
+      sock->bytes_buffered -= sent;
       if (!sent) /* special case if other end not keeping up */
         return true;
     } else {
-      packet_put_head_l(sock, buf, len);
-      osi_free(buf);
       return saved_errno == EWOULDBLOCK || saved_errno == EAGAIN;
     }
   }
@@ -903,9 +881,15 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
   if ((flags & SOCK_THREAD_FD_RD) && !sock->server) {
     // app sending data
     if (sock->connected) {
-      int size = 0;
-      bool ioctl_success = ioctl(sock->our_fd, FIONREAD, &size) == 0;
-      if (!(flags & SOCK_THREAD_FD_EXCEPTION) || (ioctl_success && size)) {
+      /* Drain the messages already queued by the app, the L2CAP tx queue
+         reports congestion once the credits of the channel run out. */
+      for (int i = 0; i < L2CAP_SOCK_TX_BATCH_MAX; i++) {
+        int size = 0;
+        bool ioctl_success = ioctl(sock->our_fd, FIONREAD, &size) == 0;
+        if ((i > 0 || (flags & SOCK_THREAD_FD_EXCEPTION)) &&
+            !(ioctl_success && size))
+          break;
+
         /* FIONREAD return number of bytes that are immediately available for
            reading, might be bigger than awaiting packet.
 
@@ -920,6 +904,14 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
         ssize_t count;
         OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
                                  MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
+        if (count < 0) {
+          /* Nothing was written, keep monitoring the socket */
+          if (i == 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            btsock_thread_add_fd(pth, sock->our_fd, BTSOCK_L2CAP,
+                                 SOCK_THREAD_FD_RD, sock->id);
+          osi_free(buffer);
+          break;
+        }
         if (count > sock->tx_mtu) {
           /* This can't happen thanks to check in BluetoothSocket.java but leave
            * this in case this socket is ever used anywhere else*/
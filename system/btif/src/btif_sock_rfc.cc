@@ -22,8 +22,10 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <cstdint>
 #include <mutex>
+#include <unordered_map>
 
 #include "bt_target.h"  // Must be first to define build configuration
 
@@ -95,6 +97,9 @@ typedef struct {
 } rfc_slot_t;
 
 static rfc_slot_t rfc_slots[MAX_RFC_CHANNEL];
+// The slots in use by id, looked up on each data event. The ids are not
+// reused, a stale id does not find the next user of its slot.
+static std::unordered_map<uint32_t, rfc_slot_t*> rfc_slots_by_id;
 static uint32_t rfc_slot_id;
 static volatile int pth = -1;  // poll thread handle
 static std::recursive_mutex slot_lock;
@@ -114,6 +119,7 @@ bt_status_t btsock_rfc_init(int poll_thread_handle, uid_set_t* set) {
   uid_set = set;
 
   memset(rfc_slots, 0, sizeof(rfc_slots));
+  rfc_slots_by_id.clear();
   for (size_t i = 0; i < ARRAY_SIZE(rfc_slots); ++i) {
     rfc_slots[i].scn = -1;
     rfc_slots[i].sdp_handle = 0;
@@ -152,8 +158,8 @@ static rfc_slot_t* find_free_slot(void) {
 static rfc_slot_t* find_rfc_slot_by_id(uint32_t id) {
   CHECK(id != 0);
 
-  for (size_t i = 0; i < ARRAY_SIZE(rfc_slots); ++i)
-    if (rfc_slots[i].id == id) return &rfc_slots[i];
+  auto it = rfc_slots_by_id.find(id);
+  if (it != rfc_slots_by_id.end()) return it->second;
 
   LOG_ERROR("%s unable to find RFCOMM slot id: %u", __func__, id);
   return NULL;
@@ -203,8 +209,11 @@ static rfc_slot_t* alloc_rfc_slot(const RawAddress* addr, const char* name,
     return NULL;
   }
 
-  // Increment slot id and make sure we don't use id=0.
-  if (++rfc_slot_id == 0) rfc_slot_id = 1;
+  // Increment slot id and make sure we don't use id=0, or an id still in use
+  // after a wrap around.
+  do {
+    if (++rfc_slot_id == 0) rfc_slot_id = 1;
+  } while (rfc_slots_by_id.count(rfc_slot_id));
 
   slot->fd = fds[0];
   slot->app_fd = fds[1];
@@ -226,6 +235,7 @@ static rfc_slot_t* alloc_rfc_slot(const RawAddress* addr, const char* name,
     slot->addr = RawAddress::kEmpty;
   }
   slot->id = rfc_slot_id;
+  rfc_slots_by_id[slot->id] = slot;
   slot->f.server = server;
   slot->tx_bytes = 0;
   slot->rx_bytes = 0;
@@ -261,6 +271,8 @@ static rfc_slot_t* create_srv_accept_rfc_slot(rfc_slot_t* srv_rs,
   uint32_t new_listen_id = accept_rs->id;
   accept_rs->id = srv_rs->id;
   srv_rs->id = new_listen_id;
+  rfc_slots_by_id[accept_rs->id] = accept_rs;
+  rfc_slots_by_id[srv_rs->id] = srv_rs;
 
   return accept_rs;
 }
@@ -452,6 +464,7 @@ static void cleanup_rfc_slot(rfc_slot_t* slot) {
 
   slot->rfc_port_handle = 0;
   memset(&slot->f, 0, sizeof(slot->f));
+  rfc_slots_by_id.erase(slot->id);
   slot->id = 0;
   slot->scn_notified = false;
   slot->tx_bytes = 0;
@@ -808,6 +821,9 @@ typedef enum {
   SENT_ALL,
 } sent_status_t;
 
+// Buffers of the incoming queue sent to the app by a single system call
+#define RFC_SEND_IOV_MAX 16
+
 static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
   if (p_buf->len == 0) return SENT_ALL;
 
@@ -831,10 +847,56 @@ static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
   return SENT_PARTIAL;
 }
 
+// Sends the buffers at the front of the |incoming_queue| of |slot| straight
+// from the BT_HDRs with a single sendmsg, and frees the ones sent entirely.
+// Returns SENT_ALL once all of these buffers were sent.
+static sent_status_t send_incoming_queue_to_app(rfc_slot_t* slot) {
+  struct iovec iov[RFC_SEND_IOV_MAX];
+  int iov_count = 0;
+  size_t total = 0;
+  for (const list_node_t* node = list_begin(slot->incoming_queue);
+       node != list_end(slot->incoming_queue) && iov_count < RFC_SEND_IOV_MAX;
+       node = list_next(node)) {
+    BT_HDR* p_buf = (BT_HDR*)list_node(node);
+    iov[iov_count].iov_base = p_buf->data + p_buf->offset;
+    iov[iov_count].iov_len = p_buf->len;
+    total += p_buf->len;
+    iov_count++;
+  }
+
+  ssize_t sent = 0;
+  if (total > 0) {
+    struct msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    OSI_NO_INTR(sent = sendmsg(slot->fd, &msg, MSG_DONTWAIT));
+
+    if (sent == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return SENT_NONE;
+      LOG_ERROR("%s error writing RFCOMM data back to app: %s", __func__,
+                strerror(errno));
+      return SENT_FAILED;
+    }
+
+    if (sent == 0) return SENT_FAILED;
+  }
+
+  for (; iov_count > 0; iov_count--) {
+    BT_HDR* p_buf = (BT_HDR*)list_front(slot->incoming_queue);
+    if (sent < p_buf->len) {
+      p_buf->offset += sent;
+      p_buf->len -= sent;
+      return SENT_PARTIAL;
+    }
+    sent -= p_buf->len;
+    list_remove(slot->incoming_queue, p_buf);
+  }
+  return SENT_ALL;
+}
+
 static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
   while (!list_is_empty(slot->incoming_queue)) {
-    BT_HDR* p_buf = (BT_HDR*)list_front(slot->incoming_queue);
-    switch (send_data_to_app(slot->fd, p_buf)) {
+    switch (send_incoming_queue_to_app(slot)) {
       case SENT_NONE:
       case SENT_PARTIAL:
         // monitor the fd to get callback when app is ready to receive data
@@ -843,11 +905,11 @@ static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
         return true;
 
       case SENT_ALL:
-        list_remove(slot->incoming_queue, p_buf);
         break;
 
       case SENT_FAILED:
-        list_remove(slot->incoming_queue, p_buf);
+        list_remove(slot->incoming_queue,
+                    list_front(slot->incoming_queue));
         return false;
     }
   }
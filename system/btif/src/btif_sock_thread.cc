@@ -33,13 +33,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -50,6 +49,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 #include "bta_api.h"
 #include "btif_common.h"
@@ -66,11 +66,13 @@
   } while (0)
 
 #define MAX_THREAD 8
-#define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
-#define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e)&POLLIN)
-#define IS_WRITE(e) ((e)&POLLOUT)
+// Events handled per wakeup. The sockets still ready after a wakeup are
+// reported again after the others, so none of them starves.
+#define MAX_EPOLL_EVENTS 64
+#define EPOLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
+#define IS_EXCEPTION(e) ((e)&EPOLL_EXCEPTION_EVENTS)
+#define IS_READ(e) ((e)&EPOLLIN)
+#define IS_WRITE(e) ((e)&EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
@@ -79,16 +81,15 @@
 #define CMD_USER_PRIVATE 5
 
 struct poll_slot_t {
-  struct pollfd pfd;
   uint32_t user_id;
   int type;
   int flags;
 };
 struct thread_slot_t {
   int cmd_fdr, cmd_fdw;
-  int poll_count;
-  poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
+  int epoll_fd;
+  // polled sockets by fd, only accessed in the socket poll thread
+  std::unordered_map<int, poll_slot_t> poll_slots;
   std::optional<pthread_t> thread_id;
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
@@ -157,9 +158,9 @@ void btsock_thread_init() {
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
       ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].epoll_fd = -1;
       ts[h].used = 0;
       ts[h].thread_id = std::nullopt;
-      ts[h].poll_count = 0;
       ts[h].callback = NULL;
       ts[h].cmd_callback = NULL;
     }
@@ -186,17 +187,32 @@ int btsock_thread_create(btsock_signaled_cb callback,
   return h;
 }
 
-/* create dummy socket pair used to wake up select loop */
+/* create dummy socket pair used to wake up epoll loop */
 static inline void init_cmd_fd(int h) {
   asrt(ts[h].cmd_fdr == -1 && ts[h].cmd_fdw == -1);
+  asrt(ts[h].epoll_fd == -1);
+  ts[h].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ts[h].epoll_fd == -1) {
+    APPL_TRACE_ERROR("epoll_create1 failed: %s", strerror(errno));
+    return;
+  }
   if (socketpair(AF_UNIX, SOCK_STREAM, 0, &ts[h].cmd_fdr) < 0) {
     APPL_TRACE_ERROR("socketpair failed: %s", strerror(errno));
     return;
   }
-  // add the cmd fd for read & write
-  add_poll(h, ts[h].cmd_fdr, 0, SOCK_THREAD_FD_RD, 0);
+  // the cmd fd is always polled for read, outside of the poll slots
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = ts[h].cmd_fdr;
+  if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, ts[h].cmd_fdr, &event) == -1)
+    APPL_TRACE_ERROR("epoll_ctl cmd fd failed: %s", strerror(errno));
 }
 static inline void close_cmd_fd(int h) {
+  if (ts[h].epoll_fd != -1) {
+    close(ts[h].epoll_fd);
+    ts[h].epoll_fd = -1;
+  }
+  ts[h].poll_slots.clear();
   if (ts[h].cmd_fdr != -1) {
     close(ts[h].cmd_fdr);
     ts[h].cmd_fdr = -1;
@@ -333,73 +349,63 @@ int btsock_thread_exit(int h) {
   return false;
 }
 static void init_poll(int h) {
-  int i;
-  ts[h].poll_count = 0;
+  ts[h].poll_slots.clear();
   ts[h].thread_id = std::nullopt;
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
-  for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
-  }
   init_cmd_fd(h);
 }
-static inline unsigned int flags2pevents(int flags) {
-  unsigned int pevents = 0;
-  if (flags & SOCK_THREAD_FD_WR) pevents |= POLLOUT;
-  if (flags & SOCK_THREAD_FD_RD) pevents |= POLLIN;
-  pevents |= POLL_EXCEPTION_EVENTS;
-  return pevents;
+static inline uint32_t flags2events(int flags) {
+  uint32_t events = 0;
+  if (flags & SOCK_THREAD_FD_WR) events |= EPOLLOUT;
+  if (flags & SOCK_THREAD_FD_RD) events |= EPOLLIN;
+  events |= EPOLL_EXCEPTION_EVENTS;
+  return events;
 }
 
-static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
-                            uint32_t user_id) {
-  ps->pfd.fd = fd;
-  ps->user_id = user_id;
-  if (ps->type != 0 && ps->type != type)
-    APPL_TRACE_ERROR(
-        "poll socket type should not changed! type was:%d, type now:%d",
-        ps->type, type);
-  ps->type = type;
-  ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
+static inline void set_poll(int h, int fd, int op, const poll_slot_t& ps) {
+  struct epoll_event event = {};
+  event.events = flags2events(ps.flags);
+  event.data.fd = fd;
+  if (epoll_ctl(ts[h].epoll_fd, op, fd, &event) == 0) return;
+  // a closed fd leaves the epoll set by itself, and may be reused since
+  if (op == EPOLL_CTL_MOD && errno == ENOENT &&
+      epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0)
+    return;
+  APPL_TRACE_ERROR("epoll_ctl op:%d fd:%d failed: %s", op, fd,
+                   strerror(errno));
 }
 static inline void add_poll(int h, int fd, int type, int flags,
                             uint32_t user_id) {
   asrt(fd != -1);
-  int i;
-  int empty = -1;
-  poll_slot_t* ps = ts[h].ps;
-
-  for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
-      asrt(ts[h].poll_count < MAX_POLL);
-
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
-      return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1)
-      empty = i;
-  }
-  if (empty >= 0) {
-    asrt(ts[h].poll_count < MAX_POLL);
-    set_poll(&ps[empty], fd, type, flags, user_id);
-    ++ts[h].poll_count;
+  auto it = ts[h].poll_slots.find(fd);
+  if (it != ts[h].poll_slots.end()) {
+    poll_slot_t& ps = it->second;
+    if (ps.type != 0 && ps.type != type)
+      APPL_TRACE_ERROR(
+          "poll socket type should not changed! type was:%d, type now:%d",
+          ps.type, type);
+    ps.type = type;
+    ps.flags |= flags;
+    ps.user_id = user_id;
+    set_poll(h, fd, EPOLL_CTL_MOD, ps);
     return;
   }
-  APPL_TRACE_ERROR("exceeded max poll slot:%d!", MAX_POLL);
+  poll_slot_t& ps = ts[h].poll_slots[fd];
+  ps = {.user_id = user_id, .type = type, .flags = flags};
+  set_poll(h, fd, EPOLL_CTL_ADD, ps);
 }
-static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
+static inline void remove_poll(int h, int fd, poll_slot_t* ps, int flags) {
   if (flags == ps->flags) {
     // all monitored events signaled. To remove it, just clear the slot
-    --ts[h].poll_count;
-    memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
+    if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_DEL, fd, NULL) == -1)
+      APPL_TRACE_ERROR("epoll_ctl del fd:%d failed: %s", fd, strerror(errno));
+    ts[h].poll_slots.erase(fd);
   } else {
     // one read or one write monitor event signaled, removed the accordding bit
     ps->flags &= ~flags;
     // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
+    set_poll(h, fd, EPOLL_CTL_MOD, *ps);
   }
 }
 static int process_cmd_sock(int h) {
@@ -417,16 +423,14 @@ static int process_cmd_sock(int h) {
     case CMD_ADD_FD:
       add_poll(h, cmd.fd, cmd.type, cmd.flags, cmd.user_id);
       break;
-    case CMD_REMOVE_FD:
-      for (int i = 1; i < MAX_POLL; ++i) {
-        poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
-          remove_poll(h, poll_slot, poll_slot->flags);
-          break;
-        }
+    case CMD_REMOVE_FD: {
+      auto it = ts[h].poll_slots.find(cmd.fd);
+      if (it != ts[h].poll_slots.end()) {
+        remove_poll(h, cmd.fd, &it->second, it->second.flags);
       }
       close(cmd.fd);
       break;
+    }
     case CMD_WAKEUP:
       break;
     case CMD_USER_PRIVATE:
@@ -443,94 +447,64 @@ static int process_cmd_sock(int h) {
   return true;
 }
 
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count,
+static void process_data_sock(int h, const struct epoll_event* events,
                               int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        LOG_INFO("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags)
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
+  // each socket is signaled at most once per wakeup
+  for (int i = 0; i < event_count; i++) {
+    int fd = events[i].data.fd;
+    if (fd == ts[h].cmd_fdr) continue;
+    auto it = ts[h].poll_slots.find(fd);
+    if (it == ts[h].poll_slots.end()) {
+      // removed by a previous callback of this wakeup
+      LOG_INFO("Socket has been removed from poll set");
+      continue;
     }
-  }
-}
-
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      APPL_TRACE_ERROR(
-          "exceed max poll range, ps_i:%d, MAX_POLL:%d, count:%d, "
-          "ts[h].poll_count:%d",
-          ps_i, MAX_POLL, count, ts[h].poll_count);
-      return;
+    uint32_t user_id = it->second.user_id;
+    int type = it->second.type;
+    int flags = 0;
+    if (IS_READ(events[i].events)) {
+      flags |= SOCK_THREAD_FD_RD;
     }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
+    if (IS_WRITE(events[i].events)) {
+      flags |= SOCK_THREAD_FD_WR;
     }
-    ps_i++;
+    if (IS_EXCEPTION(events[i].events)) {
+      flags |= SOCK_THREAD_FD_EXCEPTION;
+      // remove the whole slot not flags
+      remove_poll(h, fd, &it->second, it->second.flags);
+    } else if (flags)
+      remove_poll(h, fd, &it->second,
+                  flags);  // remove the monitor flags that already processed
+    if (flags) ts[h].callback(fd, type, flags, user_id);
   }
 }
+
 static void* sock_poll_thread(void* arg) {
-  std::array<struct pollfd, MAX_POLL> pfds;
+  std::array<struct epoll_event, MAX_EPOLL_EVENTS> events;
 
   int h = (intptr_t)arg;
   for (;;) {
-    pfds = {};
-    prepare_poll_fds(h, pfds.data());
     int ret;
-    OSI_NO_INTR(ret = poll(pfds.data(), ts[h].poll_count, -1));
+    OSI_NO_INTR(
+        ret = epoll_wait(ts[h].epoll_fd, events.data(), events.size(), -1));
     if (ret == -1) {
-      APPL_TRACE_ERROR("poll ret -1, exit the thread, errno:%d, err:%s", errno,
+      APPL_TRACE_ERROR("epoll ret -1, exit the thread, errno:%d, err:%s", errno,
                        strerror(errno));
       break;
     }
     if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
-        if (!process_cmd_sock(h)) {
-          LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
-          break;
-        }
-        if (ret == 1)
-          need_process_data_fd = false;
-        else
-          ret--;  // exclude the cmd fd
+      // the commands are processed ahead of the data sockets
+      bool has_cmd = false;
+      for (int i = 0; i < ret; i++) {
+        if (events[i].data.fd == ts[h].cmd_fdr) has_cmd = true;
+      }
+      if (has_cmd && !process_cmd_sock(h)) {
+        LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
+        break;
       }
-      if (need_process_data_fd)
-        process_data_sock(h, pfds.data(), pfds_count, ret);
+      process_data_sock(h, events.data(), ret);
     } else {
-      LOG_INFO("no data, select ret: %d", ret);
+      LOG_INFO("no data, epoll ret: %d", ret);
     };
   }
   LOG_INFO("socket poll thread exiting, h:%d", h);
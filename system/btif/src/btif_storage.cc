@@ -39,6 +39,7 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
 #include <unordered_set>
 #include <vector>
 
@@ -429,19 +430,20 @@ bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
  * Function         btif_in_fetch_bonded_devices
  *
  * Description      Internal helper function to fetch the bonded devices
- *                  from NVRAM
+ *                  from NVRAM, among the paired devices of the config
  *
  * Returns          BT_STATUS_SUCCESS if successful, BT_STATUS_FAIL otherwise
  *
  ******************************************************************************/
 static bt_status_t btif_in_fetch_bonded_devices(
+    const std::vector<RawAddress>& paired_devices,
     btif_bonded_devices_t* p_bonded_devices, int add) {
   memset(p_bonded_devices, 0, sizeof(btif_bonded_devices_t));
 
   bool bt_linkkey_file_found = false;
   int device_type;
 
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
+  for (const auto& bd_addr : paired_devices) {
     auto name = bd_addr.ToString();
 
     BTIF_TRACE_DEBUG("Remote device:%s", ADDRESS_TO_LOGGABLE_CSTR(bd_addr));
@@ -631,7 +633,8 @@ bt_status_t btif_storage_get_adapter_property(bt_property_t* property) {
   } else if (property->type == BT_PROPERTY_ADAPTER_BONDED_DEVICES) {
     btif_bonded_devices_t bonded_devices;
 
-    btif_in_fetch_bonded_devices(&bonded_devices, 0);
+    btif_in_fetch_bonded_devices(btif_config_get_paired_devices(),
+                                 &bonded_devices, 0);
 
     BTIF_TRACE_DEBUG(
         "%s: Number of bonded devices: %d "
@@ -901,11 +904,10 @@ bt_status_t btif_storage_remove_bonded_device(
  * We still allow such devices to bond in order to give the user a chance to
  * update firmware.
  */
-static void remove_devices_with_sample_ltk() {
+static void remove_devices_with_sample_ltk(
+    std::vector<RawAddress>& paired_devices) {
   std::vector<RawAddress> bad_ltk;
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
-    auto name = bd_addr.ToString();
-
+  for (const auto& bd_addr : paired_devices) {
     tBTA_LE_KEY_VALUE key;
     memset(&key, 0, sizeof(key));
 
@@ -923,24 +925,26 @@ static void remove_devices_with_sample_ltk() {
                << ADDRESS_TO_LOGGABLE_STR(address);
 
     btif_storage_remove_bonded_device(&address);
+    paired_devices.erase(
+        std::remove(paired_devices.begin(), paired_devices.end(), address),
+        paired_devices.end());
   }
 }
 
 /*******************************************************************************
  *
- * Function         btif_storage_load_le_devices
+ * Function         btif_storage_consolidate_le_devices
  *
- * Description      BTIF storage API - Loads all LE-only and Dual Mode devices
- *                  from NVRAM. This API invokes the adaper_properties_cb.
- *                  It also invokes invoke_address_consolidate_cb
- *                  to consolidate each Dual Mode device and
- *                  invoke_le_address_associate_cb to associate each LE-only
- *                  device between its RPA and identity address.
+ * Description      Internal helper function to report the LE-only and Dual
+ *                  Mode devices among the bonded devices. This invokes the
+ *                  adaper_properties_cb. It also invokes
+ *                  invoke_address_consolidate_cb to consolidate each Dual
+ *                  Mode device and invoke_le_address_associate_cb to associate
+ *                  each LE-only device between its RPA and identity address.
  *
  ******************************************************************************/
-void btif_storage_load_le_devices(void) {
-  btif_bonded_devices_t bonded_devices;
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+static void btif_storage_consolidate_le_devices(
+    const btif_bonded_devices_t& bonded_devices) {
   std::unordered_set<RawAddress> bonded_addresses;
   for (uint16_t i = 0; i < bonded_devices.num_devices; i++) {
     bonded_addresses.insert(bonded_devices.devices[i]);
@@ -1003,7 +1007,9 @@ void btif_storage_load_le_devices(void) {
  * Function         btif_storage_load_bonded_devices
  *
  * Description      BTIF storage API - Loads all the bonded devices from NVRAM
- *                  and adds to the BTA.
+ *                  and adds to the BTA, in a single sweep of the config.
+ *                  The LE-only and Dual Mode devices are consolidated first,
+ *                  see btif_storage_consolidate_le_devices.
  *                  Additionally, this API also invokes the adaper_properties_cb
  *                  and remote_device_properties_cb for each of the bonded
  *                  devices.
@@ -1025,9 +1031,13 @@ bt_status_t btif_storage_load_bonded_devices(void) {
   Uuid remote_uuids[BT_MAX_NUM_UUIDS];
   bt_status_t status;
 
-  remove_devices_with_sample_ltk();
+  std::vector<RawAddress> paired_devices = btif_config_get_paired_devices();
+  remove_devices_with_sample_ltk(paired_devices);
+
+  btif_in_fetch_bonded_devices(paired_devices, &bonded_devices, 1);
 
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  // Enable address consolidation.
+  btif_storage_consolidate_le_devices(bonded_devices);
 
   /* Now send the adapter_properties_cb with all adapter_properties */
   {
@@ -1523,7 +1533,8 @@ bool btif_storage_is_restricted_device(const RawAddress* remote_bd_addr) {
 
 int btif_storage_get_num_bonded_devices(void) {
   btif_bonded_devices_t bonded_devices;
-  btif_in_fetch_bonded_devices(&bonded_devices, 0);
+  btif_in_fetch_bonded_devices(btif_config_get_paired_devices(),
+                               &bonded_devices, 0);
   return bonded_devices.num_devices;
 }
 
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr size_t kMaxQueueLength = 28;
+constexpr uint64_t kPacketDurationUs = 20000;
+constexpr uint64_t kTickUs = 20000;
+
+class BtifA2dpSinkJitterBufferTest : public ::testing::Test {
+ protected:
+  // Receives |count| packets |interval_us| apart
+  void ReceivePackets(size_t count, uint64_t interval_us) {
+    for (size_t i = 0; i < count; i++) {
+      now_us_ += interval_us;
+      jitter_buffer_.OnPacketReceived(now_us_);
+      queue_length_++;
+    }
+  }
+
+  // Runs a playout tick decoding packets of |duration_us|, returns the number
+  // of packets decoded
+  size_t Tick(uint64_t duration_us) {
+    tick_us_ += kTickUs;
+    jitter_buffer_.OnPlayoutTick(tick_us_, queue_length_);
+    size_t count = 0;
+    while (jitter_buffer_.IsAudioNeeded()) {
+      if (queue_length_ == 0) {
+        jitter_buffer_.OnUnderrun();
+        break;
+      }
+      queue_length_--;
+      count++;
+      jitter_buffer_.OnPacketDecoded(duration_us);
+    }
+    return count;
+  }
+
+  BtifA2dpSinkJitterBuffer jitter_buffer_{kMaxQueueLength};
+  uint64_t now_us_ = 1000000;
+  uint64_t tick_us_ = 1000000;
+  size_t queue_length_ = 0;
+};
+
+TEST_F(BtifA2dpSinkJitterBufferTest, start_after_target_delay) {
+  EXPECT_FALSE(jitter_buffer_.IsReadyToPlay(0));
+  ReceivePackets(1, kPacketDurationUs);
+  EXPECT_FALSE(jitter_buffer_.IsReadyToPlay(queue_length_));
+
+  // Regular arrivals only need the minimum delay
+  ReceivePackets(1, kPacketDurationUs);
+  EXPECT_FALSE(jitter_buffer_.IsReadyToPlay(queue_length_));
+  ReceivePackets(1, kPacketDurationUs);
+  EXPECT_TRUE(jitter_buffer_.IsReadyToPlay(queue_length_));
+  EXPECT_EQ(60000u, jitter_buffer_.GetTargetDelayUs());
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, target_delay_follows_jitter) {
+  ReceivePackets(10, kPacketDurationUs);
+  uint64_t initial_target_us = jitter_buffer_.GetTargetDelayUs();
+
+  // Bursts after gaps, as seen on a congested link
+  for (int i = 0; i < 10; i++) {
+    ReceivePackets(1, 5 * kPacketDurationUs);
+    ReceivePackets(4, 0);
+  }
+  EXPECT_GT(jitter_buffer_.GetTargetDelayUs(), initial_target_us);
+  EXPECT_GT(jitter_buffer_.GetStats().max_jitter_us, 0u);
+  EXPECT_LE(jitter_buffer_.GetTargetDelayUs(), 500000u);
+  EXPECT_FALSE(jitter_buffer_.IsReadyToPlay(4));
+
+  // Half a queue is always enough to start
+  EXPECT_TRUE(jitter_buffer_.IsReadyToPlay(kMaxQueueLength / 2));
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, playout_paced_by_ticks) {
+  ReceivePackets(4, kPacketDurationUs);
+  jitter_buffer_.OnPlayoutStarted(tick_us_);
+
+  // One packet per tick, while receiving one packet per tick
+  for (int i = 0; i < 50; i++) {
+    EXPECT_EQ(1u, Tick(kPacketDurationUs));
+    ReceivePackets(1, kPacketDurationUs);
+  }
+  EXPECT_EQ(4u, queue_length_);
+  EXPECT_EQ(0u, jitter_buffer_.GetStats().underruns);
+
+  // Half size packets, two per tick
+  ReceivePackets(4, kPacketDurationUs / 2);
+  EXPECT_EQ(2u, Tick(kPacketDurationUs / 2));
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, underrun_and_resume) {
+  ReceivePackets(4, kPacketDurationUs);
+  jitter_buffer_.OnPlayoutStarted(tick_us_);
+
+  for (int i = 0; i < 4; i++) EXPECT_EQ(1u, Tick(kPacketDurationUs));
+  EXPECT_EQ(0u, Tick(kPacketDurationUs));
+  EXPECT_EQ(1u, jitter_buffer_.GetStats().underruns);
+
+  // Waits for the target delay again before resuming
+  ReceivePackets(1, 5 * kPacketDurationUs);
+  EXPECT_EQ(1u, jitter_buffer_.GetStats().late_packets);
+  EXPECT_EQ(0u, Tick(kPacketDurationUs));
+  EXPECT_EQ(1u, jitter_buffer_.GetStats().underruns);
+  ReceivePackets(kMaxQueueLength / 2, kPacketDurationUs);
+  EXPECT_EQ(1u, Tick(kPacketDurationUs));
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, stop_ignores_resume_gap) {
+  ReceivePackets(4, kPacketDurationUs);
+  jitter_buffer_.OnPlayoutStarted(tick_us_);
+  jitter_buffer_.OnPlayoutStopped();
+  EXPECT_EQ(0u, Tick(kPacketDurationUs));
+
+  ReceivePackets(1, 100 * kPacketDurationUs);
+  EXPECT_EQ(0u, jitter_buffer_.GetStats().late_packets);
+  EXPECT_EQ(0u, jitter_buffer_.GetJitterUs());
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, dropped_packets) {
+  jitter_buffer_.OnPacketDropped();
+  jitter_buffer_.OnPacketDropped();
+  EXPECT_EQ(2u, jitter_buffer_.GetStats().dropped_packets);
+
+  jitter_buffer_.Reset();
+  EXPECT_EQ(0u, jitter_buffer_.GetStats().dropped_packets);
+}
+
+TEST_F(BtifA2dpSinkJitterBufferTest, drift_compensation) {
+  ReceivePackets(4, kPacketDurationUs);
+  jitter_buffer_.OnPlayoutStarted(tick_us_);
+  EXPECT_EQ(1.0, jitter_buffer_.GetResampleRatio());
+
+  // The source sends one packet more every 10 ticks than is played, the queue
+  // delay grows until the resampling consumes packets faster
+  for (int i = 0; i < 200; i++) {
+    ReceivePackets(i % 10 == 0 ? 2 : 1, kPacketDurationUs);
+    Tick(static_cast<uint64_t>(kPacketDurationUs /
+                               jitter_buffer_.GetResampleRatio()));
+  }
+  EXPECT_GT(jitter_buffer_.GetResampleRatio(), 1.0);
+  EXPECT_LE(jitter_buffer_.GetResampleRatio(), 1.002);
+
+  // The source now sends less, the queue drains below target
+  for (int i = 0; i < 400; i++) {
+    if (i % 2 == 0) ReceivePackets(1, kPacketDurationUs);
+    Tick(static_cast<uint64_t>(kPacketDurationUs /
+                               jitter_buffer_.GetResampleRatio()));
+  }
+  EXPECT_LT(jitter_buffer_.GetResampleRatio(), 1.0);
+  EXPECT_GE(jitter_buffer_.GetResampleRatio(), 0.998);
+}
+
+TEST(BtifA2dpSinkResamplerTest, unity_ratio_preserves_samples) {
+  BtifA2dpSinkResampler resampler;
+  resampler.Configure(16, 2);
+
+  std::vector<int16_t> input(2 * 100);
+  for (size_t i = 0; i < input.size(); i++) input[i] = i * 10;
+  std::vector<int16_t> output;
+  for (int n = 0; n < 3; n++) {
+    size_t len;
+    const int16_t* out = reinterpret_cast<const int16_t*>(resampler.Resample(
+        reinterpret_cast<const uint8_t*>(input.data()),
+        input.size() * sizeof(int16_t), 1.0, &len));
+    output.insert(output.end(), out, out + len / sizeof(int16_t));
+  }
+
+  // Delayed by one frame
+  ASSERT_EQ(3 * input.size() - 2, output.size());
+  for (size_t i = 0; i < input.size(); i++) EXPECT_EQ(input[i], output[i]);
+  EXPECT_EQ(input[input.size() - 2], output[2 * input.size() - 2]);
+  EXPECT_EQ(input[0], output[input.size()]);
+}
+
+TEST(BtifA2dpSinkResamplerTest, ratio_changes_frame_count) {
+  BtifA2dpSinkResampler resampler;
+  resampler.Configure(32, 1);
+
+  std::vector<int32_t> input(1000);
+  for (size_t i = 0; i < input.size(); i++) input[i] = 1000 * i;
+  size_t faster_frames = 0;
+  size_t slower_frames = 0;
+  for (int n = 0; n < 10; n++) {
+    size_t len;
+    const int32_t* out = reinterpret_cast<const int32_t*>(resampler.Resample(
+        reinterpret_cast<const uint8_t*>(input.data()),
+        input.size() * sizeof(int32_t), 1.002, &len));
+    faster_frames += len / sizeof(int32_t);
+    // The ramp is interpolated exactly, after the first sample that may be
+    // interpolated from the end of the previous buffer
+    for (size_t i = 2; i + 1 < len / sizeof(int32_t); i++) {
+      EXPECT_NEAR(out[i] - out[i - 1], 1002, 1);
+    }
+  }
+  resampler.Configure(32, 1);
+  for (int n = 0; n < 10; n++) {
+    size_t len;
+    resampler.Resample(reinterpret_cast<const uint8_t*>(input.data()),
+                       input.size() * sizeof(int32_t), 0.998, &len);
+    slower_frames += len / sizeof(int32_t);
+  }
+
+  EXPECT_NEAR(10000 / 1.002, faster_frames, 2);
+  EXPECT_NEAR(10000 / 0.998, slower_frames, 2);
+}
+
+TEST(BtifA2dpSinkResamplerTest, other_formats_pass_through) {
+  BtifA2dpSinkResampler resampler;
+  resampler.Configure(24, 2);
+
+  std::vector<uint8_t> input(6 * 10);
+  for (size_t i = 0; i < input.size(); i++) input[i] = i;
+  size_t len;
+  uint8_t* out = resampler.Resample(input.data(), input.size(), 1.002, &len);
+  ASSERT_EQ(input.size(), len);
+  EXPECT_EQ(input, std::vector<uint8_t>(out, out + len));
+}
+
+}  // namespace
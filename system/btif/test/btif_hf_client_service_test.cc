@@ -52,7 +52,7 @@ bt_status_t btif_transfer_context(tBTIF_CBACK* p_cback, uint16_t event,
                                   tBTIF_COPY_CBACK* p_copy_cback) {
   return BT_STATUS_SUCCESS;
 }
-void btif_queue_advance() {}
+void btif_queue_advance(const RawAddress& bda) {}
 const char* dump_hf_client_event(uint16_t event) {
   return "UNKNOWN MSG ID";
 }
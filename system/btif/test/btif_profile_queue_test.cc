@@ -126,18 +126,19 @@ TEST_F(BtifProfileQueueTest, test_connect_fail_still_can_advance_the_queue) {
   // not executed
   btif_queue_connect(kTestUuid2, &kTestAddr1, test_connect_cb_fail);
   EXPECT_EQ(sResult, NOT_SET);
-  // Third connect-message for UUID1-ADDR2 be pushed into connect-queue, but is
-  // not executed
+  // Third connect-message for UUID1-ADDR2 is executed for the other device,
+  // fails and is removed from connect-queue
   btif_queue_connect(kTestUuid1, &kTestAddr2, test_connect_cb_fail);
-  EXPECT_EQ(sResult, NOT_SET);
-  // Fourth connect-message for UUID2-ADDR2 be pushed into connect-queue, but is
-  // not executed
+  EXPECT_EQ(sResult, UUID1_ADDR2);
+  // Fourth connect-message for UUID2-ADDR2 is then executed right away
+  sResult = NOT_SET;
   btif_queue_connect(kTestUuid2, &kTestAddr2, test_connect_cb_fail);
-  EXPECT_EQ(sResult, NOT_SET);
+  EXPECT_EQ(sResult, UUID2_ADDR2);
   // removed First connect-message from connect-queue, check it can advance to
   // subsequent connect-message.
-  btif_queue_advance();
-  EXPECT_EQ(sResult, UUID2_ADDR2);
+  sResult = NOT_SET;
+  btif_queue_advance(kTestAddr1);
+  EXPECT_EQ(sResult, UUID2_ADDR1);
 }
 
 TEST_F(BtifProfileQueueTest, test_connect_same_uuid_do_not_repeat) {
@@ -150,7 +151,7 @@ TEST_F(BtifProfileQueueTest, test_connect_same_uuid_do_not_repeat) {
   EXPECT_EQ(sResult, NOT_SET);
   // Not even after we advance the queue
   sResult = NOT_SET;
-  btif_queue_advance();
+  btif_queue_advance(kTestAddr1);
   btif_queue_connect_next();
   EXPECT_EQ(sResult, NOT_SET);
 }
@@ -162,7 +163,7 @@ TEST_F(BtifProfileQueueTest, test_multiple_connects) {
   EXPECT_EQ(sResult, UUID1_ADDR1);
   // Second item with advance is executed
   sResult = NOT_SET;
-  btif_queue_advance();
+  btif_queue_advance(kTestAddr1);
   btif_queue_connect(kTestUuid2, &kTestAddr1, test_connect_cb);
   EXPECT_EQ(sResult, UUID2_ADDR1);
 }
@@ -176,11 +177,13 @@ TEST_F(BtifProfileQueueTest, test_multiple_connects_without_advance) {
   sResult = NOT_SET;
   btif_queue_connect(kTestUuid2, &kTestAddr1, test_connect_cb);
   EXPECT_EQ(sResult, NOT_SET);
-  // Third item for same UUID1, but different address ADDR2
+  // Third item for same UUID1, but different address ADDR2 is executed
+  // concurrently
   sResult = NOT_SET;
   btif_queue_connect(kTestUuid1, &kTestAddr2, test_connect_cb);
-  EXPECT_EQ(sResult, NOT_SET);
-  // Fourth item for same UUID2, but different address ADDR2
+  EXPECT_EQ(sResult, UUID1_ADDR2);
+  // Fourth item for same UUID2, but different address ADDR2 waits for the
+  // third one
   sResult = NOT_SET;
   btif_queue_connect(kTestUuid2, &kTestAddr2, test_connect_cb);
   EXPECT_EQ(sResult, NOT_SET);
@@ -188,18 +191,35 @@ TEST_F(BtifProfileQueueTest, test_multiple_connects_without_advance) {
   sResult = NOT_SET;
   btif_queue_connect_next();
   EXPECT_EQ(sResult, NOT_SET);
-  // Advance moves queue to execute second item
+  // Advance of ADDR1 moves queue to execute second item
   sResult = NOT_SET;
-  btif_queue_advance();
+  btif_queue_advance(kTestAddr1);
   EXPECT_EQ(sResult, UUID2_ADDR1);
-  // Advance moves queue to execute third item
-  sResult = NOT_SET;
-  btif_queue_advance();
-  EXPECT_EQ(sResult, UUID1_ADDR2);
-  // Advance moves queue to execute fourth item
+  // Advance of ADDR2 moves queue to execute fourth item
   sResult = NOT_SET;
-  btif_queue_advance();
+  btif_queue_advance(kTestAddr2);
   EXPECT_EQ(sResult, UUID2_ADDR2);
+  // Nothing left to execute
+  sResult = NOT_SET;
+  btif_queue_advance(kTestAddr1);
+  btif_queue_advance(kTestAddr2);
+  EXPECT_EQ(sResult, NOT_SET);
+}
+
+TEST_F(BtifProfileQueueTest, test_advance_of_an_idle_device_is_ignored) {
+  // First item is executed
+  sResult = NOT_SET;
+  btif_queue_connect(kTestUuid1, &kTestAddr1, test_connect_cb);
+  EXPECT_EQ(sResult, UUID1_ADDR1);
+  // Second item without advance is not executed
+  sResult = NOT_SET;
+  btif_queue_connect(kTestUuid2, &kTestAddr1, test_connect_cb);
+  EXPECT_EQ(sResult, NOT_SET);
+  // ADDR2 has no connection in progress, ADDR1 is not affected
+  btif_queue_advance(kTestAddr2);
+  EXPECT_EQ(sResult, NOT_SET);
+  btif_queue_advance(kTestAddr1);
+  EXPECT_EQ(sResult, UUID2_ADDR1);
 }
 
 TEST_F(BtifProfileQueueTest, test_cleanup_first_allow_second) {
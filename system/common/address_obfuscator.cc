@@ -22,6 +22,7 @@
 #include <openssl/hmac.h>
 
 #include <algorithm>
+#include <shared_mutex>
 
 #include "bt_trace.h"
 #include "types/raw_address.h"
@@ -35,25 +36,33 @@ bool AddressObfuscator::IsSaltValid(const Octet32& salt_256bit) {
 }
 
 void AddressObfuscator::Initialize(const Octet32& salt_256bit) {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  std::lock_guard<std::shared_mutex> lock(instance_mutex_);
   salt_256bit_ = salt_256bit;
+  obfuscated_addresses_.Clear();
 }
 
 bool AddressObfuscator::IsInitialized() {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  std::shared_lock<std::shared_mutex> lock(instance_mutex_);
   return IsSaltValid(salt_256bit_);
 }
 
 std::string AddressObfuscator::Obfuscate(const RawAddress& address) {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
-  CHECK(IsInitialized());
+  std::shared_lock<std::shared_mutex> lock(instance_mutex_);
+  CHECK(IsSaltValid(salt_256bit_));
+  std::string obfuscated;
+  if (obfuscated_addresses_.Get(address, &obfuscated)) {
+    return obfuscated;
+  }
+
   std::array<uint8_t, EVP_MAX_MD_SIZE> result = {};
   unsigned int out_len = 0;
   CHECK(::HMAC(EVP_sha256(), salt_256bit_.data(), salt_256bit_.size(),
                address.address, address.kLength, result.data(),
                &out_len) != nullptr);
   CHECK_EQ(out_len, static_cast<unsigned int>(kOctet32Length));
-  return std::string(reinterpret_cast<const char*>(result.data()), out_len);
+  obfuscated.assign(reinterpret_cast<const char*>(result.data()), out_len);
+  obfuscated_addresses_.Put(address, obfuscated);
+  return obfuscated;
 }
 
 }  // namespace common
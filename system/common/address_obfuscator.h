@@ -19,9 +19,10 @@
 #pragma once
 
 #include <array>
-#include <mutex>
+#include <shared_mutex>
 #include <string>
 
+#include "lru.h"
 #include "raw_address.h"
 
 namespace bluetooth {
@@ -30,6 +31,7 @@ namespace common {
 class AddressObfuscator {
  public:
   static constexpr unsigned int kOctet32Length = 32;
+  static constexpr size_t kMaxNumCachedAddresses = 64;
   using Octet32 = std::array<uint8_t, kOctet32Length>;
   static AddressObfuscator* GetInstance() {
     static auto instance = new AddressObfuscator();
@@ -59,7 +61,9 @@ class AddressObfuscator {
   bool IsInitialized();
 
   /**
-   * Obfuscate Bluetooth MAC address into an anonymous ID string
+   * Obfuscate Bluetooth MAC address into an anonymous ID string, the IDs of
+   * the last kMaxNumCachedAddresses addresses are kept until the next
+   * Initialize()
    *
    * @param address Bluetooth MAC address to be obfuscated
    * @return the obfuscated MAC address in 256 bit
@@ -67,9 +71,13 @@ class AddressObfuscator {
   std::string Obfuscate(const RawAddress& address);
 
  private:
-  AddressObfuscator() : salt_256bit_({0}) {}
+  AddressObfuscator()
+      : salt_256bit_({0}),
+        obfuscated_addresses_(kMaxNumCachedAddresses, "AddressObfuscator") {}
   Octet32 salt_256bit_;
-  std::recursive_mutex instance_mutex_;
+  LegacyLruCache<RawAddress, std::string> obfuscated_addresses_;
+  // Shared by the Obfuscate() calls, the cache has its own lock
+  std::shared_mutex instance_mutex_;
 };
 
 }  // namespace common
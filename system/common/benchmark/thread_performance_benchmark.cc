@@ -22,6 +22,7 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "abstract_message_loop.h"
 #include "common/message_loop_thread.h"
@@ -359,6 +360,38 @@ BENCHMARK_F(BM_MessageLooopThread, batch_enque_dequeue)(State& state) {
   }
 };
 
+BENCHMARK_F(BM_MessageLooopThread, batch_enque_dequeue_using_batch)
+(State& state) {
+  for (auto _ : state) {
+    g_counter = 0;
+    g_counter_promise = std::make_unique<std::promise<void>>();
+    std::future<void> counter_future = g_counter_promise->get_future();
+    std::vector<base::OnceClosure> tasks;
+    tasks.reserve(NUM_MESSAGES_TO_SEND);
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      fixed_queue_enqueue(bt_msg_queue_, (void*)&g_counter);
+      tasks.push_back(base::BindOnce(&callback_batch, bt_msg_queue_, nullptr));
+    }
+    message_loop_thread_->DoInThreadBatch(FROM_HERE, std::move(tasks));
+    counter_future.wait();
+  }
+};
+
+BENCHMARK_F(BM_MessageLooopThread, batch_enque_dequeue_using_queue)
+(State& state) {
+  for (auto _ : state) {
+    g_counter = 0;
+    g_counter_promise = std::make_unique<std::promise<void>>();
+    std::future<void> counter_future = g_counter_promise->get_future();
+    for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
+      fixed_queue_enqueue(bt_msg_queue_, (void*)&g_counter);
+      message_loop_thread_->DoInThreadQueued(
+          FROM_HERE, base::BindOnce(&callback_batch, bt_msg_queue_, nullptr));
+    }
+    counter_future.wait();
+  }
+};
+
 BENCHMARK_F(BM_MessageLooopThread, sequential_execution)(State& state) {
   for (auto _ : state) {
     for (int i = 0; i < NUM_MESSAGES_TO_SEND; i++) {
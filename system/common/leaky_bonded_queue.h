@@ -17,9 +17,13 @@
  ******************************************************************************/
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 namespace bluetooth {
 
@@ -157,6 +161,254 @@ bool LeakyBondedQueue<T>::Empty() {
   return queue_.empty();
 }
 
+/*
+ *   LeakyBondedByteQueue<T>
+ *
+ * - LeakyBondedByteQueue<T> is a leaky queue for one producer thread and one
+ *   consumer thread, e.g. the audio data path, bounded by the number of items,
+ *   by the total size of the items in bytes, and by the age of the items.
+ * - When an enqueued item doesn't fit, the producer drops the oldest items
+ *   until it does. Items older than the maximum age are dropped by the
+ *   consumer instead of being dequeued, as late audio is useless anyway.
+ * - Enqueue and dequeue take no lock: the items are kept in a ring of slots
+ *   with sequence numbers, and the head of the ring is claimed with a
+ *   compare-and-swap so that the producer can drop the oldest item while the
+ *   consumer dequeues it.
+ * - The dropped items are counted by reason.
+ *
+ */
+template <class T>
+class LeakyBondedByteQueue {
+ public:
+  struct DropCounts {
+    // Dropped because the queue had |capacity| items
+    size_t capacity = 0;
+    // Dropped to make room for the bytes of a new item
+    size_t bytes = 0;
+    // Dropped because they were older than the maximum age
+    size_t age = 0;
+    // New items larger than the maximum number of bytes on their own
+    size_t oversized = 0;
+  };
+
+  /*
+   * A MAX_BYTES or MAX_AGE of zero disables the corresponding bound
+   */
+  LeakyBondedByteQueue(size_t capacity, size_t max_bytes,
+                       std::chrono::milliseconds max_age);
+  /*
+   * Free the remaining items, must not race with Enqueue() nor Dequeue()
+   */
+  ~LeakyBondedByteQueue();
+  /*
+   * Add item NEW_ITEM of BYTES bytes to the queue, dropping the oldest items
+   * as needed. Must only be called from the producer thread
+   */
+  void Enqueue(T* new_item, size_t bytes);
+  /*
+   * Dequeues the oldest item that is not too old, dropping the older ones.
+   * Return nullptr if there is none. Must only be called from the consumer
+   * thread
+   */
+  T* Dequeue();
+  /*
+   * Pops all items from the queue. Must only be called from the consumer
+   * thread
+   */
+  void Clear();
+  /*
+   * Returns the length of queue
+   */
+  size_t Length() const;
+  /*
+   * Returns the total size of the queued items in bytes
+   */
+  size_t Bytes() const;
+  /*
+   * Returns the defined capacity of the queue
+   */
+  size_t Capacity() const;
+  /*
+   * Returns whether the queue is empty
+   */
+  bool Empty() const;
+  /*
+   * Returns the number of dropped items by reason
+   */
+  DropCounts GetDropCounts() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Slot {
+    // Position of the slot in the ring: equal to the index of the next item
+    // written to it when it is free, plus one once the item is written
+    std::atomic<size_t> sequence;
+    std::unique_ptr<T> item;
+    size_t bytes;
+    Clock::time_point enqueue_time;
+  };
+
+  // Pop the oldest item into |item|, from either thread. Return false if the
+  // queue is empty
+  bool PopOldest(std::unique_ptr<T>* item, Clock::time_point* enqueue_time);
+
+  const size_t capacity_;
+  const size_t max_bytes_;
+  const std::chrono::milliseconds max_age_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+  std::atomic<size_t> bytes_;
+  std::atomic<size_t> dropped_capacity_;
+  std::atomic<size_t> dropped_bytes_;
+  std::atomic<size_t> dropped_age_;
+  std::atomic<size_t> dropped_oversized_;
+};
+
+template <class T>
+LeakyBondedByteQueue<T>::LeakyBondedByteQueue(
+    size_t capacity, size_t max_bytes, std::chrono::milliseconds max_age)
+    : capacity_(capacity > 0 ? capacity : 1),
+      max_bytes_(max_bytes),
+      max_age_(max_age),
+      slots_(new Slot[capacity_]),
+      head_(0),
+      tail_(0),
+      bytes_(0),
+      dropped_capacity_(0),
+      dropped_bytes_(0),
+      dropped_age_(0),
+      dropped_oversized_(0) {
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+    slots_[i].bytes = 0;
+  }
+}
+
+template <class T>
+LeakyBondedByteQueue<T>::~LeakyBondedByteQueue() {
+  Clear();
+}
+
+template <class T>
+bool LeakyBondedByteQueue<T>::PopOldest(std::unique_ptr<T>* item,
+                                        Clock::time_point* enqueue_time) {
+  size_t position = head_.load(std::memory_order_relaxed);
+  while (true) {
+    Slot& slot = slots_[position % capacity_];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(sequence) -
+                static_cast<intptr_t>(position + 1);
+    if (diff < 0) {
+      // Not written yet, or the previous item of the slot is still being
+      // moved out
+      return false;
+    }
+    if (diff > 0) {
+      // The other thread popped this item
+      position = head_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (head_.compare_exchange_weak(position, position + 1,
+                                    std::memory_order_relaxed)) {
+      *item = std::move(slot.item);
+      *enqueue_time = slot.enqueue_time;
+      bytes_.fetch_sub(slot.bytes, std::memory_order_relaxed);
+      slot.sequence.store(position + capacity_, std::memory_order_release);
+      return true;
+    }
+  }
+}
+
+template <class T>
+void LeakyBondedByteQueue<T>::Enqueue(T* new_item, size_t bytes) {
+  std::unique_ptr<T> item(new_item);
+  std::unique_ptr<T> dropped;
+  Clock::time_point dropped_time;
+  if (max_bytes_ > 0 && bytes > max_bytes_) {
+    dropped_oversized_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  while (max_bytes_ > 0 &&
+         bytes_.load(std::memory_order_relaxed) + bytes > max_bytes_ &&
+         PopOldest(&dropped, &dropped_time)) {
+    dropped_bytes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  size_t position = tail_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[position % capacity_];
+  while (slot.sequence.load(std::memory_order_acquire) != position) {
+    if (PopOldest(&dropped, &dropped_time)) {
+      dropped_capacity_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // The consumer is moving the item out of this slot
+      std::this_thread::yield();
+    }
+  }
+  slot.item = std::move(item);
+  slot.bytes = bytes;
+  slot.enqueue_time = Clock::now();
+  bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  slot.sequence.store(position + 1, std::memory_order_release);
+  tail_.store(position + 1, std::memory_order_release);
+}
+
+template <class T>
+T* LeakyBondedByteQueue<T>::Dequeue() {
+  std::unique_ptr<T> item;
+  Clock::time_point enqueue_time;
+  while (PopOldest(&item, &enqueue_time)) {
+    if (max_age_.count() == 0 || Clock::now() - enqueue_time <= max_age_) {
+      return item.release();
+    }
+    dropped_age_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return nullptr;
+}
+
+template <class T>
+void LeakyBondedByteQueue<T>::Clear() {
+  std::unique_ptr<T> item;
+  Clock::time_point enqueue_time;
+  while (PopOldest(&item, &enqueue_time)) {
+    // unique_ptr does not need to be freed
+  }
+}
+
+template <class T>
+size_t LeakyBondedByteQueue<T>::Length() const {
+  size_t head = head_.load(std::memory_order_acquire);
+  size_t tail = tail_.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+template <class T>
+size_t LeakyBondedByteQueue<T>::Bytes() const {
+  return bytes_.load(std::memory_order_relaxed);
+}
+
+template <class T>
+size_t LeakyBondedByteQueue<T>::Capacity() const {
+  return capacity_;
+}
+
+template <class T>
+bool LeakyBondedByteQueue<T>::Empty() const {
+  return Length() == 0;
+}
+
+template <class T>
+typename LeakyBondedByteQueue<T>::DropCounts
+LeakyBondedByteQueue<T>::GetDropCounts() const {
+  DropCounts counts;
+  counts.capacity = dropped_capacity_.load(std::memory_order_relaxed);
+  counts.bytes = dropped_bytes_.load(std::memory_order_relaxed);
+  counts.age = dropped_age_.load(std::memory_order_relaxed);
+  counts.oversized = dropped_oversized_.load(std::memory_order_relaxed);
+  return counts;
+}
+
 }  // namespace common
 
 }  // namespace bluetooth
@@ -20,10 +20,14 @@
 
 #include <base/logging.h>
 
+#include <chrono>
+#include <thread>
+
 #include "common/leaky_bonded_queue.h"
 
 namespace testing {
 
+using bluetooth::common::LeakyBondedByteQueue;
 using bluetooth::common::LeakyBondedQueue;
 
 #define ITEM_EQ(a, b)                  \
@@ -239,4 +243,101 @@ TEST(LeakyBondedQueueTest, TestPushNullDeleteQueue) {
   queue->Enqueue(item2);
   delete queue;
 }
+
+TEST(LeakyBondedByteQueueTest, TestEnqueueDequeueOverCapacity) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  MockItem* item3 = new MockItem(3);
+  LeakyBondedByteQueue<MockItem> queue(2, 0, std::chrono::milliseconds(0));
+  EXPECT_EQ(queue.Capacity(), static_cast<size_t>(2));
+  queue.Enqueue(item1, 10);
+  queue.Enqueue(item2, 10);
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(2));
+  EXPECT_EQ(queue.Bytes(), static_cast<size_t>(20));
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  queue.Enqueue(item3, 10);
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(2));
+  EXPECT_EQ(queue.GetDropCounts().capacity, static_cast<size_t>(1));
+  MockItem* item2_2 = queue.Dequeue();
+  MockItem* item3_3 = queue.Dequeue();
+  ITEM_EQ(item2_2, item2);
+  ITEM_EQ(item3_3, item3);
+  EXPECT_THAT(queue.Dequeue(), IsNull());
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Bytes(), static_cast<size_t>(0));
+  EXPECT_CALL(*item2, Destruct()).Times(1);
+  EXPECT_CALL(*item3, Destruct()).Times(1);
+  delete item2;
+  delete item3;
+}
+
+TEST(LeakyBondedByteQueueTest, TestDropOldestForBytes) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  MockItem* item3 = new MockItem(3);
+  MockItem* item4 = new MockItem(4);
+  LeakyBondedByteQueue<MockItem> queue(10, 100, std::chrono::milliseconds(0));
+  queue.Enqueue(item1, 40);
+  queue.Enqueue(item2, 40);
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  queue.Enqueue(item3, 40);
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(2));
+  EXPECT_EQ(queue.Bytes(), static_cast<size_t>(80));
+  EXPECT_EQ(queue.GetDropCounts().bytes, static_cast<size_t>(1));
+  // Larger than the queue on its own
+  EXPECT_CALL(*item4, Destruct()).Times(1);
+  queue.Enqueue(item4, 101);
+  EXPECT_EQ(queue.Length(), static_cast<size_t>(2));
+  EXPECT_EQ(queue.GetDropCounts().oversized, static_cast<size_t>(1));
+  EXPECT_CALL(*item2, Destruct()).Times(1);
+  EXPECT_CALL(*item3, Destruct()).Times(1);
+  queue.Clear();
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Bytes(), static_cast<size_t>(0));
+}
+
+TEST(LeakyBondedByteQueueTest, TestDropExpired) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  LeakyBondedByteQueue<MockItem> queue(10, 0, std::chrono::milliseconds(50));
+  queue.Enqueue(item1, 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  queue.Enqueue(item2, 10);
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  MockItem* item2_2 = queue.Dequeue();
+  ITEM_EQ(item2_2, item2);
+  EXPECT_EQ(queue.GetDropCounts().age, static_cast<size_t>(1));
+  EXPECT_CALL(*item2, Destruct()).Times(1);
+  delete item2;
+}
+
+TEST(LeakyBondedByteQueueTest, TestProducerConsumer) {
+  constexpr int kNumItems = 100000;
+  LeakyBondedByteQueue<Item> queue(16, 1000, std::chrono::milliseconds(0));
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kNumItems; i++) {
+      queue.Enqueue(new Item(i), 100);
+    }
+  });
+  int last_index = -1;
+  int dequeued = 0;
+  while (last_index < kNumItems - 1) {
+    Item* item = queue.Dequeue();
+    if (item == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Items are dropped, never reordered
+    EXPECT_GT(item->index, last_index);
+    last_index = item->index;
+    dequeued++;
+    delete item;
+  }
+  producer.join();
+  auto drops = queue.GetDropCounts();
+  EXPECT_EQ(static_cast<size_t>(dequeued) + drops.capacity + drops.bytes,
+            static_cast<size_t>(kNumItems));
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Bytes(), static_cast<size_t>(0));
+}
 }  // namespace testing
@@ -29,6 +29,7 @@
 #include <base/logging.h>
 
 #include "check.h"
+#include "gd/common/flat_lru_cache.h"
 
 namespace bluetooth {
 
@@ -105,6 +106,25 @@ class LegacyLruCache {
     return true;
   }
 
+  /**
+   * Same as Get, but does not move the key to the head, so that concurrent
+   * readers only race on the internal lock
+   *
+   * @param key
+   * @param value, output parameter of value of the key
+   * @return true if the cache has the key
+   */
+  bool Peek(const K& key, V* value) const {
+    CHECK(value != nullptr);
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    auto map_iterator = lru_map_.find(key);
+    if (map_iterator == lru_map_.end()) {
+      return false;
+    }
+    *value = map_iterator->second->second;
+    return true;
+  }
+
   /**
    * Check if the cache has the input key, move the key to the head
    * if there is one
@@ -186,5 +206,127 @@ class LegacyLruCache {
   mutable std::recursive_mutex lru_mutex_;
 };
 
+/**
+ * Same as LegacyLruCache, backed by a FlatLruCache: the nodes are allocated
+ * once by the constructor instead of by each Put(). Better for the small and
+ * hot caches, while a large LegacyLruCache only allocates what it uses.
+ */
+template <typename K, typename V>
+class LegacyFlatLruCache {
+ public:
+  using Node = std::pair<K, V>;
+  /**
+   * Constructor of the cache
+   *
+   * @param capacity maximum size of the cache
+   * @param log_tag, keyword to put at the head of log.
+   */
+  LegacyFlatLruCache(const size_t& capacity, const std::string& log_tag)
+      : cache_(capacity) {
+    if (capacity == 0) {
+      // don't allow invalid capacity
+      LOG(FATAL) << log_tag << " unable to have 0 LRU Cache capacity";
+    }
+  }
+
+  // delete copy constructor
+  LegacyFlatLruCache(LegacyFlatLruCache const&) = delete;
+  LegacyFlatLruCache& operator=(LegacyFlatLruCache const&) = delete;
+
+  ~LegacyFlatLruCache() { Clear(); }
+
+  /**
+   * Clear the cache
+   */
+  void Clear() {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    cache_.clear();
+  }
+
+  /**
+   * Same as Get, but return a pointer to the accessed element
+   *
+   * Modifying the returned value does not warm up the cache
+   *
+   * @param key
+   * @return pointer to the underlying value to allow in-place modification
+   * nullptr when not found, will be invalidated when the key is evicted
+   */
+  V* Find(const K& key) {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    auto iter = cache_.find(key);
+    return (iter == cache_.end()) ? nullptr : &iter->second;
+  }
+
+  /**
+   * Get the value of a key, and move the key to the head of cache, if there is
+   * one
+   *
+   * @param key
+   * @param value, output parameter of value of the key
+   * @return true if the cache has the key
+   */
+  bool Get(const K& key, V* value) {
+    CHECK(value != nullptr);
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    auto value_ptr = Find(key);
+    if (value_ptr == nullptr) {
+      return false;
+    }
+    *value = *value_ptr;
+    return true;
+  }
+
+  /**
+   * Check if the cache has the input key, move the key to the head
+   * if there is one
+   *
+   * @param key
+   * @return true if the cache has the key
+   */
+  bool HasKey(const K& key) {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    return cache_.contains(key);
+  }
+
+  /**
+   * Put a key-value pair to the head of cache
+   *
+   * @param key
+   * @param value
+   * @return evicted node if tail value is popped, std::nullopt if no value
+   * is popped. std::optional can be treated as a boolean as well
+   */
+  std::optional<Node> Put(const K& key, V value) {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    return cache_.insert_or_assign(key, std::move(value));
+  }
+
+  /**
+   * Delete a key from cache
+   *
+   * @param key
+   * @return true if deleted successfully
+   */
+  bool Remove(const K& key) {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    return cache_.extract(key).has_value();
+  }
+
+  /**
+   * Return size of the cache
+   *
+   * @return size of the cache
+   */
+  int Size() const {
+    std::lock_guard<std::recursive_mutex> lock(lru_mutex_);
+    return cache_.size();
+  }
+
+ private:
+  FlatLruCache<K, V> cache_;
+  mutable std::recursive_mutex lru_mutex_;
+};
+
 }  // namespace common
 }  // namespace bluetooth
@@ -26,6 +26,7 @@
 
 namespace testing {
 
+using bluetooth::common::LegacyFlatLruCache;
 using bluetooth::common::LegacyLruCache;
 
 TEST(BluetoothLegacyLruCacheTest, LegacyLruCacheMainTest1) {
@@ -157,6 +158,20 @@ TEST(BluetoothLegacyLruCacheTest, LegacyLruCacheGetTest) {
   EXPECT_EQ(value, 10);
 }
 
+TEST(BluetoothLegacyLruCacheTest, LegacyLruCachePeekTest) {
+  LegacyLruCache<int, int> cache(2, "testing");
+  cache.Put(1, 10);
+  cache.Put(2, 20);
+  int value = 0;
+  EXPECT_TRUE(cache.Peek(1, &value));
+  EXPECT_EQ(value, 10);
+  EXPECT_FALSE(cache.Peek(3, &value));
+  // 1 was not warmed up, it is evicted first
+  auto evicted = cache.Put(3, 30);
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(evicted->first, 1);
+}
+
 TEST(BluetoothLegacyLruCacheTest, LegacyLruCacheRemoveTest) {
   LegacyLruCache<int, int> cache(10, "testing");
   for (int key = 0; key <= 30; key++) {
@@ -247,4 +262,35 @@ TEST(BluetoothLegacyLruCacheTest, BluetoothLruMultiThreadPressureTest) {
   EXPECT_EQ(cache.Size(), 0);
 }
 
+TEST(BluetoothLegacyLruCacheTest, LegacyFlatLruCacheSameAsLegacyLruCache) {
+  int value = 0;
+  LegacyFlatLruCache<int, int> cache(3, "testing");
+  EXPECT_FALSE(cache.Put(1, 10));
+  EXPECT_FALSE(cache.Put(2, 20));
+  EXPECT_FALSE(cache.Put(3, 30));
+  EXPECT_EQ(cache.Size(), 3);
+
+  // Warm up 1 so that 2 is evicted first
+  EXPECT_TRUE(cache.Get(1, &value));
+  EXPECT_EQ(value, 10);
+  EXPECT_THAT(cache.Put(4, 40), Optional(Pair(2, 20)));
+  EXPECT_FALSE(cache.HasKey(2));
+
+  // Updating a key evicts nothing
+  EXPECT_FALSE(cache.Put(3, 31));
+  int* value_ptr = cache.Find(3);
+  ASSERT_NE(value_ptr, nullptr);
+  EXPECT_EQ(*value_ptr, 31);
+
+  EXPECT_TRUE(cache.Remove(4));
+  EXPECT_FALSE(cache.Remove(4));
+  EXPECT_FALSE(cache.Put(5, 50));
+  EXPECT_EQ(cache.Size(), 3);
+  EXPECT_THAT(cache.Put(6, 60), Optional(Pair(1, 10)));
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_FALSE(cache.Get(3, &value));
+}
+
 }  // namespace testing
@@ -24,6 +24,7 @@
 #include <thread>
 
 #include "gd/common/init_flags.h"
+#include "gd/os/thread_policy.h"
 #include "osi/include/log.h"
 
 namespace bluetooth {
@@ -45,7 +46,9 @@ MessageLoopThread::MessageLoopThread(const std::string& thread_name,
       linux_tid_(-1),
       weak_ptr_factory_(this),
       shutting_down_(false),
-      is_main_(is_main) {}
+      is_main_(is_main),
+      queued_tasks_pending_(0),
+      accepting_queued_tasks_(false) {}
 
 MessageLoopThread::~MessageLoopThread() { ShutDown(); }
 
@@ -80,6 +83,11 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                << ", from " << from_here.ToString();
     return false;
   }
+  if (task_monitor_ != nullptr) {
+    task = os::TaskMonitor::Wrap(
+        task_monitor_, from_here.function_name(), std::move(task),
+        std::chrono::microseconds(delay.InMicroseconds()));
+  }
   if (!message_loop_->task_runner()->PostDelayedTask(from_here, std::move(task),
                                                      delay)) {
     LOG(ERROR) << __func__
@@ -90,6 +98,56 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
   return true;
 }
 
+bool MessageLoopThread::DoInThreadBatch(const base::Location& from_here,
+                                        std::vector<base::OnceClosure> tasks) {
+  return DoInThread(from_here,
+                    base::BindOnce(
+                        [](std::vector<base::OnceClosure> tasks) {
+                          for (auto& task : tasks) {
+                            std::move(task).Run();
+                          }
+                        },
+                        std::move(tasks)));
+}
+
+bool MessageLoopThread::DoInThreadQueued(const base::Location& from_here,
+                                         base::OnceClosure task) {
+  if (!accepting_queued_tasks_.load(std::memory_order_acquire)) {
+    LOG(ERROR) << __func__ << ": thread " << *this << " is not running"
+               << ", from " << from_here.ToString();
+    return false;
+  }
+  queued_tasks_.Push(std::move(task));
+  if (queued_tasks_pending_.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    // If the thread just stopped, the task is run once it is started again
+    return ScheduleQueuedTasks(from_here);
+  }
+  return true;
+}
+
+bool MessageLoopThread::ScheduleQueuedTasks(const base::Location& from_here) {
+  return DoInThread(from_here,
+                    base::BindOnce(&MessageLoopThread::RunQueuedTasks,
+                                   base::Unretained(this)));
+}
+
+void MessageLoopThread::RunQueuedTasks() {
+  // Only the tasks posted so far, so that a busy producer doesn't starve the
+  // other tasks of the message loop
+  size_t pending = queued_tasks_pending_.load(std::memory_order_acquire);
+  size_t handled = 0;
+  base::OnceClosure task;
+  while (handled < pending && queued_tasks_.Pop(&task)) {
+    handled++;
+    std::move(task).Run();
+  }
+  // Tasks that are left, or still being pushed, have no scheduled run yet
+  if (queued_tasks_pending_.fetch_sub(handled, std::memory_order_acq_rel) !=
+      handled) {
+    ScheduleQueuedTasks(FROM_HERE);
+  }
+}
+
 void MessageLoopThread::ShutDown() {
   {
     std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
@@ -159,14 +217,13 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
     return false;
   }
 
-  struct sched_param rt_params = {.sched_priority =
-                                      kRealTimeFifoSchedulingPriority};
-  int rc = sched_setscheduler(linux_tid_, SCHED_FIFO, &rt_params);
-  if (rc != 0) {
+  // The priority configured for the thread, if any, wins over the default
+  if (!os::ApplyThreadPolicy(
+          linux_tid_,
+          os::GetThreadPolicy(thread_name_, kRealTimeFifoSchedulingPriority))) {
     LOG(ERROR) << __func__ << ": unable to set SCHED_FIFO priority "
                << kRealTimeFifoSchedulingPriority << " for linux_tid "
-               << std::to_string(linux_tid_) << ", thread " << *this
-               << ", error: " << strerror(errno);
+               << std::to_string(linux_tid_) << ", thread " << *this;
     return false;
   }
   return true;
@@ -188,6 +245,12 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
     run_loop_ = new base::RunLoop();
     thread_id_ = base::PlatformThread::CurrentId();
     linux_tid_ = static_cast<pid_t>(syscall(SYS_gettid));
+    os::ApplyThreadPolicy(linux_tid_, os::GetThreadPolicy(thread_name_));
+    task_monitor_ = os::TaskMonitor::Create(thread_name_);
+    accepting_queued_tasks_.store(true, std::memory_order_release);
+    if (queued_tasks_pending_.load(std::memory_order_acquire) != 0) {
+      ScheduleQueuedTasks(FROM_HERE);
+    }
     start_up_promise.set_value();
   }
 
@@ -196,8 +259,10 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
 
   {
     std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+    accepting_queued_tasks_.store(false, std::memory_order_release);
     thread_id_ = -1;
     linux_tid_ = -1;
+    task_monitor_.reset();
     delete message_loop_;
     message_loop_ = nullptr;
     delete run_loop_;
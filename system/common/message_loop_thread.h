@@ -22,12 +22,16 @@
 #include <base/threading/platform_thread.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <future>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "abstract_message_loop.h"
+#include "gd/common/mpsc_queue.h"
+#include "gd/os/task_monitor.h"
 
 namespace bluetooth {
 
@@ -74,6 +78,34 @@ class MessageLoopThread final {
    */
   bool DoInThread(const base::Location& from_here, base::OnceClosure task);
 
+  /**
+   * Post tasks to run on this thread, in order, as a single message loop task
+   *
+   * @param from_here location where these tasks are originated
+   * @param tasks tasks created through base::Bind()
+   * @return true if tasks are successfully scheduled, false if tasks cannot be
+   * scheduled
+   */
+  bool DoInThreadBatch(const base::Location& from_here,
+                       std::vector<base::OnceClosure> tasks);
+
+  /**
+   * Post a task to run on this thread through a lock-free inbound queue. The
+   * queue is drained by a single message loop task, which is only posted when
+   * the queue goes from empty to non-empty, so posting a burst of tasks takes
+   * neither the API lock nor the message loop task queue lock for each task.
+   *
+   * Tasks posted this way run in order, but are not ordered with the tasks
+   * posted through DoInThread().
+   *
+   * @param from_here location where this task is originated
+   * @param task task created through base::Bind()
+   * @return true if task is successfully scheduled, false if task cannot be
+   * scheduled
+   */
+  bool DoInThreadQueued(const base::Location& from_here,
+                        base::OnceClosure task);
+
   /**
    * Shutdown the current thread as if it is never started. IsRunning() and
    * DoInThread() will return false after this call. Blocks until the thread is
@@ -189,6 +221,17 @@ class MessageLoopThread final {
    */
   void Run(std::promise<void> start_up_promise);
 
+  /**
+   * Run the tasks of the inbound queue that were posted before this call,
+   * called on this thread
+   */
+  void RunQueuedTasks();
+
+  /**
+   * Post RunQueuedTasks() to the message loop
+   */
+  bool ScheduleQueuedTasks(const base::Location& from_here);
+
   mutable std::recursive_mutex api_mutex_;
   const std::string thread_name_;
   btbase::AbstractMessageLoop* message_loop_;
@@ -200,6 +243,13 @@ class MessageLoopThread final {
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
   bool is_main_;
+  // Inbound queue of DoInThreadQueued(), |queued_tasks_pending_| counts the
+  // tasks that have not run yet
+  MpscQueue<base::OnceClosure> queued_tasks_;
+  std::atomic<size_t> queued_tasks_pending_;
+  std::atomic<bool> accepting_queued_tasks_;
+  // Times the tasks while the thread runs, if task monitoring is enabled
+  std::shared_ptr<os::TaskMonitor> task_monitor_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -16,8 +16,11 @@
 #include "message_loop_thread.h"
 
 #include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -328,3 +331,67 @@ TEST_F(MessageLoopThreadTest, shut_down_start_up_multi_thread) {
   auto thread = std::thread(&MessageLoopThread::StartUp, &message_loop_thread);
   thread.join();
 }
+
+TEST_F(MessageLoopThreadTest, test_do_in_thread_batch) {
+  MessageLoopThread message_loop_thread("test_thread");
+  message_loop_thread.StartUp();
+  std::vector<int> order;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  std::vector<base::OnceClosure> tasks;
+  for (int i = 0; i < 10; i++) {
+    tasks.push_back(base::BindOnce(
+        [](std::vector<int>* order, int i) { order->push_back(i); }, &order,
+        i));
+  }
+  tasks.push_back(base::BindOnce(&std::promise<void>::set_value,
+                                 base::Unretained(&promise)));
+  ASSERT_TRUE(message_loop_thread.DoInThreadBatch(FROM_HERE, std::move(tasks)));
+  future.wait();
+  ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(MessageLoopThreadTest, test_do_in_thread_queued_before_start) {
+  MessageLoopThread message_loop_thread("test_thread");
+  ASSERT_FALSE(message_loop_thread.DoInThreadQueued(
+      FROM_HERE, base::BindOnce(&MessageLoopThreadTest::ShouldNotHappen,
+                                base::Unretained(this))));
+}
+
+// Verify the tasks of each posting thread run in order
+TEST_F(MessageLoopThreadTest, test_do_in_thread_queued_multi_thread) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTasksPerThread = 10000;
+  MessageLoopThread message_loop_thread("test_thread");
+  message_loop_thread.StartUp();
+  std::vector<int> last_tasks(kNumThreads, -1);
+  int num_tasks = 0;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([&, i]() {
+      for (int task = 0; task < kNumTasksPerThread; task++) {
+        ASSERT_TRUE(message_loop_thread.DoInThreadQueued(
+            FROM_HERE, base::BindOnce(
+                           [](std::vector<int>* last_tasks, int* num_tasks,
+                              std::promise<void>* promise, int i, int task) {
+                             ASSERT_EQ((*last_tasks)[i] + 1, task);
+                             (*last_tasks)[i] = task;
+                             if (++(*num_tasks) ==
+                                 kNumThreads * kNumTasksPerThread) {
+                               promise->set_value();
+                             }
+                           },
+                           &last_tasks, &num_tasks, &promise, i, task)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(10)),
+            std::future_status::ready);
+  message_loop_thread.ShutDown();
+}
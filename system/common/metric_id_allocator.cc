@@ -22,6 +22,7 @@
 
 #include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 
 #include "types/raw_address.h"
@@ -51,7 +52,7 @@ MetricIdAllocator::MetricIdAllocator()
 bool MetricIdAllocator::Init(
     const std::unordered_map<RawAddress, int>& paired_device_map,
     Callback save_id_callback, Callback forget_device_callback) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   if (initialized_) {
     return false;
   }
@@ -91,7 +92,7 @@ bool MetricIdAllocator::Init(
 MetricIdAllocator::~MetricIdAllocator() { Close(); }
 
 bool MetricIdAllocator::Close() {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   if (!initialized_) {
     return false;
   }
@@ -108,15 +109,25 @@ MetricIdAllocator& MetricIdAllocator::GetInstance() {
 }
 
 bool MetricIdAllocator::IsEmpty() const {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::shared_lock<std::shared_mutex> lock(id_allocator_mutex_);
   return paired_device_cache_.Size() == 0 &&
          temporary_device_cache_.Size() == 0;
 }
 
 // call this function when a new device is scanned
 int MetricIdAllocator::AllocateId(const RawAddress& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
   int id = 0;
+  {
+    // Fast path for the metrics logged by the connected devices. The paired
+    // devices are not warmed up, the cache is large enough to never evict
+    // them.
+    std::shared_lock<std::shared_mutex> lock(id_allocator_mutex_);
+    if (paired_device_cache_.Peek(mac_address, &id)) {
+      return id;
+    }
+  }
+
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   // if already have an id, return it
   if (paired_device_cache_.Get(mac_address, &id)) {
     return id;
@@ -148,7 +159,7 @@ int MetricIdAllocator::AllocateId(const RawAddress& mac_address) {
 
 // call this function when a device is paired
 bool MetricIdAllocator::SaveDevice(const RawAddress& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   int id = 0;
   if (paired_device_cache_.Get(mac_address, &id)) {
     return true;
@@ -178,7 +189,7 @@ bool MetricIdAllocator::SaveDevice(const RawAddress& mac_address) {
 
 // call this function when a device is forgotten
 void MetricIdAllocator::ForgetDevice(const RawAddress& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   int id = 0;
   if (!paired_device_cache_.Get(mac_address, &id)) {
     LOG(ERROR) << LOGGING_TAG
@@ -53,6 +53,8 @@ extern std::mutex config_lock;  // protects operations on |config|.
 extern std::unique_ptr<config_t> config;
 extern alarm_t* config_timer;
 
+static std::mutex file_lock;  // serializes the writes of the config file.
+
 using bluetooth::common::InitFlags;
 
 static void cleanup() {
@@ -199,16 +201,24 @@ void device_iot_config_write(uint16_t event, UNUSED_ATTR char* p_param) {
   CHECK(config_timer != NULL);
 
   LOG_INFO("evt=%d", event);
-  std::unique_lock<std::mutex> lock(config_lock);
-  if (event == IOT_CONFIG_SAVE_TIMER_FIRED_EVT) {
-    device_iot_config_set_modified_time();
+  // The file is written from a snapshot, so that the updates of the config
+  // don't wait for the file system
+  config_t snapshot;
+  {
+    std::unique_lock<std::mutex> lock(config_lock);
+    if (event == IOT_CONFIG_SAVE_TIMER_FIRED_EVT) {
+      device_iot_config_set_modified_time();
+    }
+
+    device_iot_config_restrict_device_num(*config);
+    device_iot_config_sections_sort_by_entry_key(*config,
+                                                 device_iot_config_compare_key);
+    snapshot = *config;
   }
 
+  std::unique_lock<std::mutex> lock(file_lock);
   rename(IOT_CONFIG_FILE_PATH, IOT_CONFIG_BACKUP_PATH);
-  device_iot_config_restrict_device_num(*config);
-  device_iot_config_sections_sort_by_entry_key(*config,
-                                               device_iot_config_compare_key);
-  config_save(*config, IOT_CONFIG_FILE_PATH);
+  config_save(snapshot, IOT_CONFIG_FILE_PATH);
 }
 
 void device_iot_config_sections_sort_by_entry_key(config_t& config,
@@ -237,6 +247,9 @@ void device_iot_config_save_async(void) {
   CHECK(config != NULL);
   CHECK(config_timer != NULL);
 
+  // Batched with the write already scheduled
+  if (alarm_is_scheduled(config_timer)) return;
+
   LOG_VERBOSE("");
   alarm_set(config_timer, CONFIG_SETTLE_PERIOD_MS,
             device_iot_config_timer_save_cb, NULL);
@@ -58,7 +58,8 @@ static const char* IOT_CONFIG_BACKUP_PATH =
 static const char* IOT_CONFIG_FILE_PATH = "bt_remote_dev_info.conf";
 static const char* IOT_CONFIG_BACKUP_PATH = "bt_remote_dev_info.bak";
 #endif  // __ANDROID__
-static const uint64_t CONFIG_SETTLE_PERIOD_MS = 12000;
+// The changes are batched into a single write of the file per period
+static const uint64_t CONFIG_SETTLE_PERIOD_MS = 60000;
 
 enum ConfigSource { NOT_LOADED, ORIGINAL, BACKUP, NEW_FILE, RESET };
 
@@ -32,6 +32,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <map>
 #include <string>
@@ -84,6 +86,14 @@ bool interop_is_initialized = false;
 // protects operations on |interop_list|
 pthread_mutex_t interop_list_lock;
 
+// Bloom filter over the keys of the entries of |interop_list|, so that the
+// lookups matching no entry, the common case, don't walk the list. The names
+// are keyed by their first INTEROP_FILTER_NAME_KEY_LEN characters since they
+// match by prefix. Protected by |interop_list_lock|.
+#define INTEROP_FILTER_BITS (8192)
+#define INTEROP_FILTER_NAME_KEY_LEN (8)
+static std::bitset<INTEROP_FILTER_BITS> interop_filter;
+
 // protects operations on |config|
 static pthread_mutex_t file_lock;
 static std::unique_ptr<const config_t> config_static;
@@ -296,6 +306,7 @@ static future_t* interop_clean_up(void) {
   pthread_mutex_lock(&interop_list_lock);
   list_free(interop_list);
   interop_list = NULL;
+  interop_filter.reset();
   list_free(media_player_list);
   media_player_list = NULL;
   interop_is_initialized = false;
@@ -601,6 +612,183 @@ static bool interop_config_add_or_remove(interop_db_entry_t* db_entry,
   return status;
 }
 
+static void interop_filter_hash_(interop_bl_type bl_type, int feature,
+                                 const uint8_t* key, size_t length,
+                                 size_t* bit_1, size_t* bit_2) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint8_t byte) { hash = (hash ^ byte) * 1099511628211ULL; };
+  mix(bl_type);
+  mix(feature & 0xff);
+  mix(feature >> 8);
+  mix(length);
+  for (size_t i = 0; i < length; i++) mix(key[i]);
+  *bit_1 = (hash & 0xffffffff) % INTEROP_FILTER_BITS;
+  *bit_2 = (hash >> 32) % INTEROP_FILTER_BITS;
+}
+
+static void interop_filter_set_(interop_bl_type bl_type, int feature,
+                                const uint8_t* key, size_t length) {
+  size_t bit_1, bit_2;
+  interop_filter_hash_(bl_type, feature, key, length, &bit_1, &bit_2);
+  interop_filter.set(bit_1);
+  interop_filter.set(bit_2);
+}
+
+static bool interop_filter_test_(interop_bl_type bl_type, int feature,
+                                 const uint8_t* key, size_t length) {
+  size_t bit_1, bit_2;
+  interop_filter_hash_(bl_type, feature, key, length, &bit_1, &bit_2);
+  return interop_filter.test(bit_1) && interop_filter.test(bit_2);
+}
+
+// Copies the lower case filter key of |name| to |key|, returns its length.
+static size_t interop_filter_name_key_(const char* name, uint8_t* key) {
+  size_t length = 0;
+  while (length < INTEROP_FILTER_NAME_KEY_LEN && name[length] != '\0') {
+    key[length] = tolower((unsigned char)name[length]);
+    length++;
+  }
+  return length;
+}
+
+// Adds the key of |db_entry| to |interop_filter|.
+static void interop_filter_add_(const interop_db_entry_t* db_entry) {
+  switch (db_entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      const interop_addr_entry_t* cur = &db_entry->entry_type.addr_entry;
+      interop_filter_set_(db_entry->bl_type, cur->feature, cur->addr.address,
+                          std::min(cur->length, sizeof(RawAddress)));
+      break;
+    }
+    case INTEROP_BL_TYPE_NAME: {
+      const interop_name_entry_t* cur = &db_entry->entry_type.name_entry;
+      uint8_t key[INTEROP_FILTER_NAME_KEY_LEN];
+      size_t length = interop_filter_name_key_(cur->name, key);
+      interop_filter_set_(db_entry->bl_type, cur->feature, key, length);
+      break;
+    }
+    case INTEROP_BL_TYPE_MANUFACTURE: {
+      const interop_manufacturer_t* cur = &db_entry->entry_type.mnfr_entry;
+      uint8_t key[] = {(uint8_t)cur->manufacturer,
+                       (uint8_t)(cur->manufacturer >> 8)};
+      interop_filter_set_(db_entry->bl_type, cur->feature, key, sizeof(key));
+      break;
+    }
+    case INTEROP_BL_TYPE_VNDR_PRDT: {
+      const interop_hid_multitouch_t* cur =
+          &db_entry->entry_type.vnr_pdt_entry;
+      uint8_t key[] = {(uint8_t)cur->vendor_id, (uint8_t)(cur->vendor_id >> 8),
+                       (uint8_t)cur->product_id,
+                       (uint8_t)(cur->product_id >> 8)};
+      interop_filter_set_(db_entry->bl_type, cur->feature, key, sizeof(key));
+      break;
+    }
+    case INTEROP_BL_TYPE_SSR_MAX_LAT: {
+      const interop_hid_ssr_max_lat_t* cur =
+          &db_entry->entry_type.ssr_max_lat_entry;
+      interop_filter_set_(db_entry->bl_type, cur->feature, cur->addr.address,
+                          3);
+      break;
+    }
+    case INTEROP_BL_TYPE_VERSION: {
+      const interop_version_t* cur = &db_entry->entry_type.version_entry;
+      uint8_t key[] = {(uint8_t)cur->version, (uint8_t)(cur->version >> 8)};
+      interop_filter_set_(db_entry->bl_type, cur->feature, key, sizeof(key));
+      break;
+    }
+    case INTEROP_BL_TYPE_LMP_VERSION: {
+      const interop_lmp_version_t* cur =
+          &db_entry->entry_type.lmp_version_entry;
+      interop_filter_set_(db_entry->bl_type, cur->feature, cur->addr.address,
+                          3);
+      break;
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE: {
+      // The ranges are only filtered by feature
+      const interop_addr_range_entry_t* cur =
+          &db_entry->entry_type.addr_range_entry;
+      interop_filter_set_(db_entry->bl_type, cur->feature, NULL, 0);
+      break;
+    }
+  }
+}
+
+// Returns false if |entry| matches none of the entries of |interop_list|.
+static bool interop_filter_may_match_(const interop_db_entry_t* entry) {
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      // The entries match any address starting with their |length| bytes
+      const interop_addr_entry_t* src = &entry->entry_type.addr_entry;
+      for (size_t length = 1; length <= sizeof(RawAddress); length++) {
+        if (interop_filter_test_(entry->bl_type, src->feature,
+                                 src->addr.address, length))
+          return true;
+      }
+      return false;
+    }
+    case INTEROP_BL_TYPE_NAME: {
+      // The entries match any name starting with them
+      const interop_name_entry_t* src = &entry->entry_type.name_entry;
+      uint8_t key[INTEROP_FILTER_NAME_KEY_LEN];
+      size_t key_length = interop_filter_name_key_(src->name, key);
+      for (size_t length = 0; length <= key_length; length++) {
+        if (interop_filter_test_(entry->bl_type, src->feature, key, length))
+          return true;
+      }
+      return false;
+    }
+    case INTEROP_BL_TYPE_MANUFACTURE: {
+      const interop_manufacturer_t* src = &entry->entry_type.mnfr_entry;
+      uint8_t key[] = {(uint8_t)src->manufacturer,
+                       (uint8_t)(src->manufacturer >> 8)};
+      return interop_filter_test_(entry->bl_type, src->feature, key,
+                                  sizeof(key));
+    }
+    case INTEROP_BL_TYPE_VNDR_PRDT: {
+      const interop_hid_multitouch_t* src = &entry->entry_type.vnr_pdt_entry;
+      uint8_t key[] = {(uint8_t)src->vendor_id, (uint8_t)(src->vendor_id >> 8),
+                       (uint8_t)src->product_id,
+                       (uint8_t)(src->product_id >> 8)};
+      return interop_filter_test_(entry->bl_type, src->feature, key,
+                                  sizeof(key));
+    }
+    case INTEROP_BL_TYPE_SSR_MAX_LAT: {
+      const interop_hid_ssr_max_lat_t* src =
+          &entry->entry_type.ssr_max_lat_entry;
+      return interop_filter_test_(entry->bl_type, src->feature,
+                                  src->addr.address, 3);
+    }
+    case INTEROP_BL_TYPE_VERSION: {
+      const interop_version_t* src = &entry->entry_type.version_entry;
+      uint8_t key[] = {(uint8_t)src->version, (uint8_t)(src->version >> 8)};
+      return interop_filter_test_(entry->bl_type, src->feature, key,
+                                  sizeof(key));
+    }
+    case INTEROP_BL_TYPE_LMP_VERSION: {
+      const interop_lmp_version_t* src = &entry->entry_type.lmp_version_entry;
+      return interop_filter_test_(entry->bl_type, src->feature,
+                                  src->addr.address, 3);
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE: {
+      const interop_addr_range_entry_t* src =
+          &entry->entry_type.addr_range_entry;
+      return interop_filter_test_(entry->bl_type, src->feature, NULL, 0);
+    }
+  }
+  return true;
+}
+
+// Rebuilds |interop_filter| once entries were removed from |interop_list|.
+static void interop_filter_rebuild_(void) {
+  interop_filter.reset();
+  if (interop_list == NULL) return;
+  for (const list_node_t* node = list_begin(interop_list);
+       node != list_end(interop_list); node = list_next(node)) {
+    interop_filter_add_((interop_db_entry_t*)list_node(node));
+  }
+}
+
 static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
   interop_db_entry_t* ret_entry = NULL;
   bool match_found =
@@ -618,6 +806,7 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
 
   if (interop_list) {
     list_append(interop_list, db_entry);
+    interop_filter_add_(db_entry);
   }
 
   pthread_mutex_unlock(&interop_list_lock);
@@ -636,7 +825,8 @@ static bool interop_database_match(interop_db_entry_t* entry,
   CHECK(entry);
   bool found = false;
   pthread_mutex_lock(&interop_list_lock);
-  if (interop_list == NULL || list_length(interop_list) == 0) {
+  if (interop_list == NULL || list_length(interop_list) == 0 ||
+      !interop_filter_may_match_(entry)) {
     pthread_mutex_unlock(&interop_list_lock);
     return false;
   }
@@ -776,6 +966,7 @@ static bool interop_database_remove_(interop_db_entry_t* entry) {
   // first remove it from linked list
   pthread_mutex_lock(&interop_list_lock);
   list_remove(interop_list, (void*)ret_entry);
+  interop_filter_rebuild_();
   pthread_mutex_unlock(&interop_list_lock);
 
   return interop_config_add_or_remove(entry, false);
@@ -1568,6 +1759,10 @@ bool interop_database_remove_feature(const interop_feature_t feature) {
     }
   }
 
+  pthread_mutex_lock(&interop_list_lock);
+  interop_filter_rebuild_();
+  pthread_mutex_unlock(&interop_list_lock);
+
   for (const section_t& sec : config_dynamic.get()->sections) {
     if (feature == interop_feature_name_to_feature_id(sec.name.c_str())) {
       LOG_WARN("found feature - %s", interop_feature_string_(feature));
@@ -2929,13 +2929,31 @@ TEST_F(DeviceIotConfigTest, test_device_iot_config_remove) {
 }
 
 TEST_F(DeviceIotConfigTest, test_device_iot_config_save_async) {
+  bool return_value;
+
+  test::mock::osi_alarm::alarm_is_scheduled.body =
+      [&](const alarm_t* alarm) -> bool { return return_value; };
+
   {
     reset_mock_function_count_map();
 
+    return_value = false;
     device_iot_config_save_async();
 
     EXPECT_EQ(get_func_call_count("alarm_set"), 1);
   }
+
+  {
+    reset_mock_function_count_map();
+
+    // Batched with the scheduled write
+    return_value = true;
+    device_iot_config_save_async();
+
+    EXPECT_EQ(get_func_call_count("alarm_set"), 0);
+  }
+
+  test::mock::osi_alarm::alarm_is_scheduled.body = {};
 }
 
 TEST_F(DeviceIotConfigTest, test_device_iot_config_flush) {
@@ -703,6 +703,32 @@ TEST_F(InteropTest, test_dynamic_name) {
   module_clean_up(&interop_module);
 }
 
+TEST_F(InteropTest, test_dynamic_name_prefix) {
+  module_init(&interop_module);
+
+  // Longer than the filter keys of the names
+  interop_database_add_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                            "Long Device Name");
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                 "long device name 2"));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                  "Long Device"));
+  EXPECT_FALSE(
+      interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "Long Device Name"));
+
+  interop_database_add_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, "Lo");
+  EXPECT_TRUE(
+      interop_match_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, "Low"));
+
+  interop_database_remove_feature(INTEROP_DISABLE_LE_SECURE_CONNECTIONS);
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS,
+                                  "Long Device Name 2"));
+  EXPECT_FALSE(
+      interop_match_name(INTEROP_DISABLE_LE_SECURE_CONNECTIONS, "Low"));
+
+  module_clean_up(&interop_module);
+}
+
 TEST_F(InteropTest, test_dynamic_vndr_prdt) {
   module_init(&interop_module);
 
@@ -59,6 +59,19 @@ APTXBTENCEXPORT int aptxbtenc_init(void* _state, short endian);
  * occurred during the initialisation. */
 APTXBTENCEXPORT int aptxbtenc_setsync_mode(void* _state, int32_t sync_mode);
 
+/* The implementations of the QMF filters and of the quantisation searches,
+ * vectorized or not. All of them produce the same codewords. */
+#define APTXBTENC_KERNELS_SCALAR 0
+#define APTXBTENC_KERNELS_SSE4_2 1
+#define APTXBTENC_KERNELS_NEON 2
+
+/* aptxbtenc_use_kernels selects the implementation of the encoder kernels
+ * for all the encoder instances. aptxbtenc_init selects the fastest
+ * implementation of the CPU unless one was selected, so this is intended for
+ * tests and benchmarks. The function returns 1 if the implementation is not
+ * supported, and 0 otherwise. */
+APTXBTENCEXPORT int aptxbtenc_use_kernels(int kernels);
+
 /* StereoEncode will take 8 audio samples (16-bit per sample)
  * and generate one 32-bit codeword with autosync inserted. */
 APTXBTENCEXPORT int aptxbtenc_encodestereo(void* _state, void* _pcmL,
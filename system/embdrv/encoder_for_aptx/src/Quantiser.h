@@ -37,6 +37,10 @@ void quantiseDifferenceLH(const int32_t diffSignal, const int32_t ditherVal,
 void quantiseDifferenceHH(const int32_t diffSignal, const int32_t ditherVal,
                           const int32_t delta, Quantiser_data* qdata_pt);
 
+/* Selects the kernels of the quantisation searches, one of the
+ * APTXBTENC_KERNELS_* values. Returns 1 if they are not supported. */
+int32_t QuantiserUseKernels(int32_t kernels);
+
 #ifdef _GCC
 #pragma GCC visibility pop
 #endif
@@ -69,6 +69,18 @@ APTXBTENCEXPORT int SizeofAptxbtenc(void) { return (sizeof(aptxbtenc)); }
 
 APTXBTENCEXPORT const char* aptxbtenc_version() { return (swversion); }
 
+/* Set once the kernels are selected, by the application or the first init */
+static int32_t kernelsSelected = 0;
+
+APTXBTENCEXPORT int aptxbtenc_use_kernels(int kernels) {
+  if (QmfConvUseKernels(kernels) != 0) {
+    return 1;
+  }
+  QuantiserUseKernels(kernels);
+  kernelsSelected = 1;
+  return 0;
+}
+
 APTXBTENCEXPORT int aptxbtenc_init(void* _state, short endian) {
   aptxbtenc* state = (aptxbtenc*)_state;
   int32_t j = 0;
@@ -80,6 +92,11 @@ APTXBTENCEXPORT int aptxbtenc_init(void* _state, short endian) {
   if (state == 0) {
     return 1;
   }
+  if (!kernelsSelected &&
+      aptxbtenc_use_kernels(APTXBTENC_KERNELS_NEON) != 0 &&
+      aptxbtenc_use_kernels(APTXBTENC_KERNELS_SSE4_2) != 0) {
+    aptxbtenc_use_kernels(APTXBTENC_KERNELS_SCALAR);
+  }
   state->m_syncWordPhase = 7L;
 
   if (endian == 0) {
@@ -50,6 +50,19 @@ APTXHDBTENCEXPORT const char* aptxhdbtenc_version(void);
  * The function returns 0 if no error occurred during the initialisation. */
 APTXHDBTENCEXPORT int aptxhdbtenc_init(void* _state, short endian);
 
+/* The implementations of the QMF filters and of the quantisation searches,
+ * vectorized or not. All of them produce the same codewords. */
+#define APTXHDBTENC_KERNELS_SCALAR 0
+#define APTXHDBTENC_KERNELS_SSE4_2 1
+#define APTXHDBTENC_KERNELS_NEON 2
+
+/* aptxhdbtenc_use_kernels selects the implementation of the encoder kernels
+ * for all the encoder instances. aptxhdbtenc_init selects the fastest
+ * implementation of the CPU unless one was selected, so this is intended for
+ * tests and benchmarks. The function returns 1 if the implementation is not
+ * supported, and 0 otherwise. */
+APTXHDBTENCEXPORT int aptxhdbtenc_use_kernels(int kernels);
+
 /* StereoEncode will take 8 audio samples (24-bit per sample)
  * and generate two 24-bit codeword with autosync inserted.
  * The bitstream is compatible with be BC05 implementation. */
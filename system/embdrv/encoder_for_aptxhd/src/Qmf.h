@@ -77,6 +77,10 @@ void AsmQmfConvI_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
 void AsmQmfConvO_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
                     const int32_t* coeffPtr, int32_t* convSumDiff);
 
+/* Selects the kernels of the QMF convolutions, one of the
+ * APTXHDBTENC_KERNELS_* values. Returns 1 if they are not supported. */
+int32_t QmfConvUseKernels_HD(int32_t kernels);
+
 XBT_INLINE_ void QmfAnalysisFilter(const int32_t pcm[4], Qmf_storage* Qmf_St,
                                    const int32_t* predVals,
                                    int32_t* aqmfOutputs) {
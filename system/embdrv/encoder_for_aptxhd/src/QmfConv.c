@@ -20,30 +20,37 @@
  *----------------------------------------------------------------------------*/
 
 #include "Qmf.h"
-
-void AsmQmfConvO_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
-                    const int32_t* coeffPtr, int32_t* convSumDiff) {
-  /* Since all manipulated data are "int16_t" it is possible to
-   * reduce the number of loads by using int32_t type and manipulating
-   * pairs of data
-   */
-
-  int32_t acc;
-  // Manual inlining as IAR compiler does not seem to do it itself...
-  // WARNING: This inlining assumes that m_qmfDelayLineLength == 16
-  int32_t tmp_round0;
+#include "aptXHDbtenc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* The convolutions of a QMF filter are split between the two polyphase
+ * components: sums[0] accumulates coeffPtr[k] * p1dl_buffPtr[-k] and sums[1]
+ * accumulates coeffPtr[k] * p2dl_buffPtr[k], for the 16 coefficients. The
+ * 64 bits sums are exact, so that all the kernels are bit-exact. */
+typedef void (*tQmfConvSumsO)(const int32_t* p1dl_buffPtr,
+                              const int32_t* p2dl_buffPtr,
+                              const int32_t* coeffPtr, int64_t sums[2]);
+typedef void (*tQmfConvSumsI)(const int32_t* p1dl_buffPtr,
+                              const int32_t* p2dl_buffPtr,
+                              const int32_t* coeffPtr, int64_t sums[2]);
+
+static void QmfConvSumsOScalar(const int32_t* p1dl_buffPtr,
+                               const int32_t* p2dl_buffPtr,
+                               const int32_t* coeffPtr, int64_t sums[2]) {
   int64_t local_acc0;
   int64_t local_acc1;
-
   int32_t coeffVal0;
   int32_t coeffVal1;
   int32_t data0;
   int32_t data1;
   int32_t data2;
   int32_t data3;
-  int32_t phaseConv[2];
-  int32_t convSum;
-  int32_t convDiff;
 
   coeffVal0 = (*(coeffPtr));
   coeffVal1 = (*(coeffPtr + 1));
@@ -141,78 +148,21 @@ void AsmQmfConvO_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
   local_acc0 += ((int64_t)(coeffVal1) * (int64_t)data2);
   local_acc1 += ((int64_t)(coeffVal1) * (int64_t)data3);
 
-  tmp_round0 = (int32_t)local_acc0;
-
-  local_acc0 += 0x00400000L;
-  acc = (int32_t)(local_acc0 >> 23);
-
-  if ((((tmp_round0 << 8) ^ 0x40000000) == 0)) {
-    acc--;
-  }
-
-  if (acc > 8388607) {
-    acc = 8388607;
-  }
-  if (acc < -8388608) {
-    acc = -8388608;
-  }
-
-  phaseConv[0] = acc;
-
-  tmp_round0 = (int32_t)local_acc1;
-
-  local_acc1 += 0x00400000L;
-  acc = (int32_t)(local_acc1 >> 23);
-  if ((((tmp_round0 << 8) ^ 0x40000000) == 0)) {
-    acc--;
-  }
-
-  if (acc > 8388607) {
-    acc = 8388607;
-  }
-  if (acc < -8388608) {
-    acc = -8388608;
-  }
-
-  phaseConv[1] = acc;
-
-  convSum = phaseConv[1] + phaseConv[0];
-  if (convSum > 8388607) {
-    convSum = 8388607;
-  }
-  if (convSum < -8388608) {
-    convSum = -8388608;
-  }
-
-  convDiff = phaseConv[1] - phaseConv[0];
-  if (convDiff > 8388607) {
-    convDiff = 8388607;
-  }
-  if (convDiff < -8388608) {
-    convDiff = -8388608;
-  }
-
-  *(convSumDiff) = convSum;
-  *(convSumDiff + 2) = convDiff;
+  sums[0] = local_acc0;
+  sums[1] = local_acc1;
 }
 
-void AsmQmfConvI_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
-                    const int32_t* coeffPtr, int32_t* filterOutputs) {
-  int32_t acc;
-  // WARNING: This inlining assumes that m_qmfDelayLineLength == 16
-  int32_t tmp_round0;
+static void QmfConvSumsIScalar(const int32_t* p1dl_buffPtr,
+                               const int32_t* p2dl_buffPtr,
+                               const int32_t* coeffPtr, int64_t sums[2]) {
   int64_t local_acc0;
   int64_t local_acc1;
-
   int32_t coeffVal0;
   int32_t coeffVal1;
   int32_t data0;
   int32_t data1;
   int32_t data2;
   int32_t data3;
-  int32_t phaseConv[2];
-  int32_t convSum;
-  int32_t convDiff;
 
   coeffVal0 = (*(coeffPtr));
   coeffVal1 = (*(coeffPtr + 1));
@@ -310,6 +260,230 @@ void AsmQmfConvI_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
   local_acc0 += ((int64_t)(coeffVal1)*data2);
   local_acc1 += ((int64_t)(coeffVal1)*data3);
 
+  sums[0] = local_acc0;
+  sums[1] = local_acc1;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Accumulates the 64 bits products of the four lanes of coeffs and data */
+__attribute__((target("sse4.2"))) static inline __m128i QmfMulAccSse42(
+    __m128i coeffs, __m128i data, __m128i acc) {
+  acc = _mm_add_epi64(acc, _mm_mul_epi32(coeffs, data));
+  return _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(coeffs, 32),
+                                          _mm_srli_epi64(data, 32)));
+}
+
+__attribute__((target("sse4.2"))) static inline int64_t QmfHorizontalSumSse42(
+    __m128i acc) {
+  int64_t sum;
+  acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+  _mm_storel_epi64((__m128i*)&sum, acc);
+  return sum;
+}
+
+__attribute__((target("sse4.2"))) static void QmfConvSumsOSse42(
+    const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+    const int32_t* coeffPtr, int64_t sums[2]) {
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  for (int32_t k = 0; k < 16; k += 4) {
+    __m128i coeffs = _mm_loadu_si128((const __m128i*)(coeffPtr + k));
+    __m128i data0 = _mm_loadu_si128((const __m128i*)(p1dl_buffPtr - k - 3));
+    __m128i data1 = _mm_loadu_si128((const __m128i*)(p2dl_buffPtr + k));
+    acc0 = QmfMulAccSse42(_mm_shuffle_epi32(coeffs, _MM_SHUFFLE(0, 1, 2, 3)),
+                          data0, acc0);
+    acc1 = QmfMulAccSse42(coeffs, data1, acc1);
+  }
+  sums[0] = QmfHorizontalSumSse42(acc0);
+  sums[1] = QmfHorizontalSumSse42(acc1);
+}
+
+__attribute__((target("sse4.2"))) static void QmfConvSumsISse42(
+    const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+    const int32_t* coeffPtr, int64_t sums[2]) {
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = _mm_setzero_si128();
+  for (int32_t k = 0; k < 16; k += 4) {
+    __m128i coeffs = _mm_loadu_si128((const __m128i*)(coeffPtr + k));
+    __m128i data0 = _mm_loadu_si128((const __m128i*)(p1dl_buffPtr - k - 3));
+    __m128i data1 = _mm_loadu_si128((const __m128i*)(p2dl_buffPtr + k));
+    acc0 = QmfMulAccSse42(_mm_shuffle_epi32(coeffs, _MM_SHUFFLE(0, 1, 2, 3)),
+                          data0, acc0);
+    acc1 = QmfMulAccSse42(coeffs, data1, acc1);
+  }
+  sums[0] = QmfHorizontalSumSse42(acc0);
+  sums[1] = QmfHorizontalSumSse42(acc1);
+}
+#endif
+
+#if defined(__ARM_NEON)
+/* Accumulates the 64 bits products of the four lanes of coeffs and data */
+static inline int64x2_t QmfMulAccNeon(int32x4_t coeffs, int32x4_t data,
+                                      int64x2_t acc) {
+  acc = vmlal_s32(acc, vget_low_s32(coeffs), vget_low_s32(data));
+  return vmlal_s32(acc, vget_high_s32(coeffs), vget_high_s32(data));
+}
+
+static inline int32x4_t QmfReverseNeon(int32x4_t v) {
+  v = vrev64q_s32(v);
+  return vcombine_s32(vget_high_s32(v), vget_low_s32(v));
+}
+
+static void QmfConvSumsONeon(const int32_t* p1dl_buffPtr,
+                             const int32_t* p2dl_buffPtr,
+                             const int32_t* coeffPtr, int64_t sums[2]) {
+  int64x2_t acc0 = vdupq_n_s64(0);
+  int64x2_t acc1 = vdupq_n_s64(0);
+  for (int32_t k = 0; k < 16; k += 4) {
+    int32x4_t coeffs = vld1q_s32(coeffPtr + k);
+    int32x4_t data0 = vld1q_s32(p1dl_buffPtr - k - 3);
+    int32x4_t data1 = vld1q_s32(p2dl_buffPtr + k);
+    acc0 = QmfMulAccNeon(QmfReverseNeon(coeffs), data0, acc0);
+    acc1 = QmfMulAccNeon(coeffs, data1, acc1);
+  }
+  sums[0] = vgetq_lane_s64(acc0, 0) + vgetq_lane_s64(acc0, 1);
+  sums[1] = vgetq_lane_s64(acc1, 0) + vgetq_lane_s64(acc1, 1);
+}
+
+static void QmfConvSumsINeon(const int32_t* p1dl_buffPtr,
+                             const int32_t* p2dl_buffPtr,
+                             const int32_t* coeffPtr, int64_t sums[2]) {
+  int64x2_t acc0 = vdupq_n_s64(0);
+  int64x2_t acc1 = vdupq_n_s64(0);
+  for (int32_t k = 0; k < 16; k += 4) {
+    int32x4_t coeffs = vld1q_s32(coeffPtr + k);
+    int32x4_t data0 = vld1q_s32(p1dl_buffPtr - k - 3);
+    int32x4_t data1 = vld1q_s32(p2dl_buffPtr + k);
+    acc0 = QmfMulAccNeon(QmfReverseNeon(coeffs), data0, acc0);
+    acc1 = QmfMulAccNeon(coeffs, data1, acc1);
+  }
+  sums[0] = vgetq_lane_s64(acc0, 0) + vgetq_lane_s64(acc0, 1);
+  sums[1] = vgetq_lane_s64(acc1, 0) + vgetq_lane_s64(acc1, 1);
+}
+#endif
+
+static tQmfConvSumsO QmfConvSumsO = QmfConvSumsOScalar;
+static tQmfConvSumsI QmfConvSumsI = QmfConvSumsIScalar;
+
+int32_t QmfConvUseKernels_HD(int32_t kernels) {
+  switch (kernels) {
+    case APTXHDBTENC_KERNELS_SCALAR:
+      QmfConvSumsO = QmfConvSumsOScalar;
+      QmfConvSumsI = QmfConvSumsIScalar;
+      return 0;
+#if defined(__x86_64__) || defined(__i386__)
+    case APTXHDBTENC_KERNELS_SSE4_2:
+      if (!__builtin_cpu_supports("sse4.2")) {
+        return 1;
+      }
+      QmfConvSumsO = QmfConvSumsOSse42;
+      QmfConvSumsI = QmfConvSumsISse42;
+      return 0;
+#endif
+#if defined(__ARM_NEON)
+    case APTXHDBTENC_KERNELS_NEON:
+      QmfConvSumsO = QmfConvSumsONeon;
+      QmfConvSumsI = QmfConvSumsINeon;
+      return 0;
+#endif
+    default:
+      return 1;
+  }
+}
+
+void AsmQmfConvO_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+                    const int32_t* coeffPtr, int32_t* convSumDiff) {
+  /* Since all manipulated data are "int16_t" it is possible to
+   * reduce the number of loads by using int32_t type and manipulating
+   * pairs of data
+   */
+
+  int32_t acc;
+  // Manual inlining as IAR compiler does not seem to do it itself...
+  // WARNING: This inlining assumes that m_qmfDelayLineLength == 16
+  int32_t tmp_round0;
+  int64_t local_acc0;
+  int64_t local_acc1;
+  int64_t sums[2];
+  int32_t phaseConv[2];
+  int32_t convSum;
+  int32_t convDiff;
+
+  QmfConvSumsO(p1dl_buffPtr, p2dl_buffPtr, coeffPtr, sums);
+  local_acc0 = sums[0];
+  local_acc1 = sums[1];
+
+  tmp_round0 = (int32_t)local_acc0;
+
+  local_acc0 += 0x00400000L;
+  acc = (int32_t)(local_acc0 >> 23);
+
+  if ((((tmp_round0 << 8) ^ 0x40000000) == 0)) {
+    acc--;
+  }
+
+  if (acc > 8388607) {
+    acc = 8388607;
+  }
+  if (acc < -8388608) {
+    acc = -8388608;
+  }
+
+  phaseConv[0] = acc;
+
+  tmp_round0 = (int32_t)local_acc1;
+
+  local_acc1 += 0x00400000L;
+  acc = (int32_t)(local_acc1 >> 23);
+  if ((((tmp_round0 << 8) ^ 0x40000000) == 0)) {
+    acc--;
+  }
+
+  if (acc > 8388607) {
+    acc = 8388607;
+  }
+  if (acc < -8388608) {
+    acc = -8388608;
+  }
+
+  phaseConv[1] = acc;
+
+  convSum = phaseConv[1] + phaseConv[0];
+  if (convSum > 8388607) {
+    convSum = 8388607;
+  }
+  if (convSum < -8388608) {
+    convSum = -8388608;
+  }
+
+  convDiff = phaseConv[1] - phaseConv[0];
+  if (convDiff > 8388607) {
+    convDiff = 8388607;
+  }
+  if (convDiff < -8388608) {
+    convDiff = -8388608;
+  }
+
+  *(convSumDiff) = convSum;
+  *(convSumDiff + 2) = convDiff;
+}
+
+void AsmQmfConvI_HD(const int32_t* p1dl_buffPtr, const int32_t* p2dl_buffPtr,
+                    const int32_t* coeffPtr, int32_t* filterOutputs) {
+  int32_t acc;
+  // WARNING: This inlining assumes that m_qmfDelayLineLength == 16
+  int32_t tmp_round0;
+  int64_t local_acc0;
+  int64_t local_acc1;
+  int64_t sums[2];
+  int32_t phaseConv[2];
+  int32_t convSum;
+  int32_t convDiff;
+
+  QmfConvSumsI(p1dl_buffPtr, p2dl_buffPtr, coeffPtr, sums);
+  local_acc0 = sums[0];
+  local_acc1 = sums[1];
+
   tmp_round0 = (int32_t)local_acc0;
 
   local_acc0 += 0x00400000L;
@@ -15,6 +15,14 @@
  */
 
 #include "Quantiser.h"
+#include "aptXHDbtenc.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 XBT_INLINE_ int32_t BsearchLL(const int32_t absDiffSignalShifted,
                               const int32_t delta,
@@ -82,6 +90,106 @@ XBT_INLINE_ int32_t BsearchLL(const int32_t absDiffSignalShifted,
   return (qCode);
 }
 
+/* The binary search of BsearchLL adds the three thresholds of each step
+ * (qCode + step, qCode + 2 * step and qCode + 3 * step) which it passes to
+ * the code, testing them at once: a 4-ary search of the same increasing
+ * thresholds, with the same comparisons, finds the same code. */
+typedef int32_t (*tBsearchLL)(const int32_t absDiffSignalShifted,
+                              const int32_t delta,
+                              const int32_t* dqbitTablePrt);
+
+static int32_t BsearchLLScalar(const int32_t absDiffSignalShifted,
+                               const int32_t delta,
+                               const int32_t* dqbitTablePrt) {
+  return BsearchLL(absDiffSignalShifted, delta, dqbitTablePrt);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.2"))) static int32_t BsearchLLSse42(
+    const int32_t absDiffSignalShifted, const int32_t delta,
+    const int32_t* dqbitTablePrt) {
+  const __m128i lc_delta = _mm_set1_epi32(delta << 8);
+  const __m128i absDiff =
+      _mm_set1_epi64x((int64_t)((uint64_t)absDiffSignalShifted << 32));
+  const __m128i one = _mm_set1_epi64x(1);
+  int32_t qCode = 0;
+
+  for (int32_t step = 64; step > 0; step >>= 2) {
+    __m128i thresholds01 =
+        _mm_set_epi32(0, dqbitTablePrt[qCode + 2 * step], 0,
+                      dqbitTablePrt[qCode + step]);
+    __m128i thresholds2 = _mm_cvtsi32_si128(dqbitTablePrt[qCode + 3 * step]);
+    __m128i above01 = _mm_cmpgt_epi64(
+        _mm_sub_epi64(_mm_mul_epi32(lc_delta, thresholds01), absDiff), one);
+    __m128i above2 = _mm_cmpgt_epi64(
+        _mm_sub_epi64(_mm_mul_epi32(lc_delta, thresholds2), absDiff), one);
+    int32_t above = _mm_movemask_pd(_mm_castsi128_pd(above01)) |
+                    ((_mm_movemask_pd(_mm_castsi128_pd(above2)) & 1) << 2);
+    qCode += (3 - __builtin_popcount(above)) * step;
+  }
+  return qCode;
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+static int32_t BsearchLLNeon(const int32_t absDiffSignalShifted,
+                             const int32_t delta,
+                             const int32_t* dqbitTablePrt) {
+  const int32x2_t lc_delta = vdup_n_s32(delta << 8);
+  const int64x2_t absDiff =
+      vdupq_n_s64((int64_t)((uint64_t)absDiffSignalShifted << 32));
+  const int64x2_t one = vdupq_n_s64(1);
+  int32_t qCode = 0;
+
+  for (int32_t step = 64; step > 0; step >>= 2) {
+    int32x2_t thresholds01 = vset_lane_s32(
+        dqbitTablePrt[qCode + 2 * step],
+        vdup_n_s32(dqbitTablePrt[qCode + step]), 1);
+    int32x2_t thresholds2 = vdup_n_s32(dqbitTablePrt[qCode + 3 * step]);
+    int64x2_t above01 = vreinterpretq_s64_u64(vcgtq_s64(
+        vsubq_s64(vmull_s32(lc_delta, thresholds01), absDiff), one));
+    int64x2_t above2 = vreinterpretq_s64_u64(vcgtq_s64(
+        vsubq_s64(vmull_s32(lc_delta, thresholds2), absDiff), one));
+    /* The lanes above the difference are all ones, i.e. -1 */
+    int32_t passed = 3 + (int32_t)(vgetq_lane_s64(above01, 0) +
+                                   vgetq_lane_s64(above01, 1) +
+                                   vgetq_lane_s64(above2, 0));
+    qCode += passed * step;
+  }
+  return qCode;
+}
+#endif
+
+static tBsearchLL BsearchLLKernel = BsearchLLScalar;
+
+int32_t QuantiserUseKernels_HD(int32_t kernels) {
+  switch (kernels) {
+    case APTXHDBTENC_KERNELS_SCALAR:
+      BsearchLLKernel = BsearchLLScalar;
+      return 0;
+#if defined(__x86_64__) || defined(__i386__)
+    case APTXHDBTENC_KERNELS_SSE4_2:
+      if (!__builtin_cpu_supports("sse4.2")) {
+        return 1;
+      }
+      BsearchLLKernel = BsearchLLSse42;
+      return 0;
+#endif
+#if defined(__ARM_NEON)
+    case APTXHDBTENC_KERNELS_NEON:
+#if defined(__aarch64__)
+      BsearchLLKernel = BsearchLLNeon;
+#else
+      /* The 64 bits comparisons are missing from ARMv7 NEON */
+      BsearchLLKernel = BsearchLLScalar;
+#endif
+      return 0;
+#endif
+    default:
+      return 1;
+  }
+}
+
 XBT_INLINE_ int32_t BsearchHL(const int32_t absDiffSignalShifted,
                               const int32_t delta,
                               const int32_t* dqbitTablePrt) {
@@ -493,8 +601,8 @@ void quantiseDifference_HDLL(const int32_t diffSignal, const int32_t ditherVal,
    * table index of the LARGEST threshold table value for which
    * absDiffSignalShifted >= (delta * threshold)
    */
-  index =
-      BsearchLL(absDiffSignalShifted, delta, qdata_pt->thresholdTablePtr_sl1);
+  index = BsearchLLKernel(absDiffSignalShifted, delta,
+                          qdata_pt->thresholdTablePtr_sl1);
 
   /* We actually wanted the SMALLEST magnitude quantised code for which
    * absDiffSignalShifted < (delta * threshold)
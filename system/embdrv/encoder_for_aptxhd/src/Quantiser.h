@@ -37,6 +37,10 @@ void quantiseDifference_HDLH(const int32_t diffSignal, const int32_t ditherVal,
 void quantiseDifference_HDHH(const int32_t diffSignal, const int32_t ditherVal,
                              const int32_t delta, Quantiser_data* qdata_p);
 
+/* Selects the kernels of the quantisation searches, one of the
+ * APTXHDBTENC_KERNELS_* values. Returns 1 if they are not supported. */
+int32_t QuantiserUseKernels_HD(int32_t kernels);
+
 #ifdef _GCC
 #pragma GCC visibility pop
 #endif
@@ -63,6 +63,18 @@ APTXHDBTENCEXPORT int SizeofAptxhdbtenc() { return (sizeof(aptxhdbtenc)); }
 
 APTXHDBTENCEXPORT const char* aptxhdbtenc_version() { return (swversion); }
 
+/* Set once the kernels are selected, by the application or the first init */
+static int32_t kernelsSelected = 0;
+
+APTXHDBTENCEXPORT int aptxhdbtenc_use_kernels(int kernels) {
+  if (QmfConvUseKernels_HD(kernels) != 0) {
+    return 1;
+  }
+  QuantiserUseKernels_HD(kernels);
+  kernelsSelected = 1;
+  return 0;
+}
+
 APTXHDBTENCEXPORT int aptxhdbtenc_init(void* _state, short endian) {
   aptxhdbtenc* state = (aptxhdbtenc*)_state;
 
@@ -71,6 +83,11 @@ APTXHDBTENCEXPORT int aptxhdbtenc_init(void* _state, short endian) {
   if (state == 0) {
     return 1;
   }
+  if (!kernelsSelected &&
+      aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_NEON) != 0 &&
+      aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_SSE4_2) != 0) {
+    aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_SCALAR);
+  }
   state->m_syncWordPhase = 7L;
 
   if (endian == 0) {
@@ -136,6 +136,12 @@ extern "C" {
 g722_encode_state_t *g722_encode_init(g722_encode_state_t *s, unsigned int rate, int options);
 int g722_encode_release(g722_encode_state_t *s);
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[], const int16_t amp[], int len);
+/* Encodes the left and right channels of a binaural stream in a single pass,
+   bit exact with g722_encode on each channel. |len| is the number of samples
+   per channel, and must be even. Returns the number of bytes per channel. */
+int g722_encode_stereo(g722_encode_state_t *left, g722_encode_state_t *right,
+                       uint8_t g722_data_left[], uint8_t g722_data_right[],
+                       const int16_t amp_left[], const int16_t amp_right[], int len);
 
 g722_decode_state_t *g722_decode_init(g722_decode_state_t *s, unsigned int rate, int options);
 int g722_decode_release(g722_decode_state_t *s);
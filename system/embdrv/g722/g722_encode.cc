@@ -32,6 +32,13 @@
 #include "g722_typedefs.h"
 #include "g722_enc_dec.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -268,8 +275,66 @@ static int16_t ihp[3] = {0, 3, 2};
 static int16_t wh[3] = {0, -214, 798};
 static int16_t rh2[4] = {2, 1, 2, 1};
 
-int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
-                       const int16_t amp[], int len)
+/* The transmit QMF as a single 24 taps filter on the signal history, for
+   the low band (sumeven + sumodd) and the high band (sumeven - sumodd). The
+   sums are exact in 32 bits, so any order of accumulation is bit exact. */
+static const int16_t qmf_low_coeffs[24] =
+{
+       3, -11,  -11,  53,   12, -156,   32,  362, -210, -805,  951, 3876,
+    3876, 951, -805, -210,  362,   32, -156,   12,   53,  -11,  -11,    3,
+};
+static const int16_t qmf_high_coeffs[24] =
+{
+      -3, -11,   11,  53,  -12, -156,  -32,  362,  210, -805, -951, 3876,
+   -3876, 951,  805, -210, -362,   32,  156,   12,  -53,  -11,   11,    3,
+};
+
+#if defined(__SSE2__)
+static __inline int32_t qmf_dot_product(const int16_t x[24], const int16_t c[24])
+{
+    __m128i sum;
+
+    sum = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) x),
+                         _mm_loadu_si128((const __m128i *) c));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 8)),
+                                            _mm_loadu_si128((const __m128i *) (c + 8))));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 16)),
+                                            _mm_loadu_si128((const __m128i *) (c + 16))));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+#elif defined(__ARM_NEON)
+static __inline int32_t qmf_dot_product(const int16_t x[24], const int16_t c[24])
+{
+    int32x4_t sum;
+    int32x2_t sum2;
+    int i;
+
+    sum = vmull_s16(vld1_s16(x), vld1_s16(c));
+    for (i = 4;  i < 24;  i += 4)
+        sum = vmlal_s16(sum, vld1_s16(x + i), vld1_s16(c + i));
+    sum2 = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+    sum2 = vpadd_s32(sum2, sum2);
+    return vget_lane_s32(sum2, 0);
+}
+#else
+static __inline int32_t qmf_dot_product(const int16_t x[24], const int16_t c[24])
+{
+    int32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0;  i < 24;  i++)
+        sum += x[i]*c[i];
+    return sum;
+}
+#endif
+/*- End of function --------------------------------------------------------*/
+
+/* Encodes a pair of low and high band samples from the QMF, returns the
+   G.722 code */
+static __inline int encode_sample(g722_encode_state_t *s, int xlow, int xhigh)
 {
     int dlow;
     int dhigh;
@@ -283,6 +348,98 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     int wd3;
     int eh;
     int mih;
+    int i;
+    int k;
+    int det;
+    int ihigh;
+    int ilow;
+    int code;
+
+    /* Block 1L, SUBTRA */
+    el = saturate(xlow - s->band[0].s);
+
+    /* Block 1L, QUANTL */
+    wd = (el >= 0)  ?  el  :  -(el + 1);
+
+    /* The thresholds increase with i, so the first one above wd follows the
+       count of those below it. Counting has no data dependent branch, and
+       vectorizes. */
+    det = s->band[0].det;
+    i = 1;
+    for (k = 1;  k < 30;  k++)
+        i += (wd >= ((q6[k]*det) >> 12));
+    ilow = (el < 0)  ?  iln[i]  :  ilp[i];
+
+    /* Block 2L, INVQAL */
+    ril = ilow >> 2;
+    wd2 = qm4[ril];
+    dlow = (s->band[0].det*wd2) >> 15;
+
+    /* Block 3L, LOGSCL */
+    il4 = rl42[ril];
+    wd = (s->band[0].nb*127) >> 7;
+    s->band[0].nb = wd + wl[il4];
+    if (s->band[0].nb < 0)
+        s->band[0].nb = 0;
+    else if (s->band[0].nb > 18432)
+        s->band[0].nb = 18432;
+
+    /* Block 3L, SCALEL */
+    wd1 = (s->band[0].nb >> 6) & 31;
+    wd2 = 8 - (s->band[0].nb >> 11);
+    wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+    s->band[0].det = wd3 << 2;
+
+    block4(&s->band[0], dlow);
+    {
+        int nb;
+
+        /* Block 1H, SUBTRA */
+        eh = saturate(xhigh - s->band[1].s);
+
+        /* Block 1H, QUANTH */
+        wd = (eh >= 0)  ?  eh  :  -(eh + 1);
+        wd1 = (564*s->band[1].det) >> 12;
+        mih = (wd >= wd1)  ?  2  :  1;
+        ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
+
+        /* Block 2H, INVQAH */
+        wd2 = qm2[ihigh];
+        dhigh = (s->band[1].det*wd2) >> 15;
+
+        /* Block 3H, LOGSCH */
+        ih2 = rh2[ihigh];
+        wd = (s->band[1].nb*127) >> 7;
+
+        nb = wd + wh[ih2];
+        if (nb < 0)
+            nb = 0;
+        else if (nb > 22528)
+            nb = 22528;
+        s->band[1].nb = nb;
+
+        /* Block 3H, SCALEH */
+        wd1 = (s->band[1].nb >> 6) & 31;
+        wd2 = 10 - (s->band[1].nb >> 11);
+        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+        s->band[1].det = wd3 << 2;
+
+        block4(&s->band[1], dhigh);
+#if   BITS_PER_SAMPLE == 8
+        code = ((ihigh << 6) | ilow);
+#elif BITS_PER_SAMPLE == 7
+        code = ((ihigh << 6) | ilow) >> 1;
+#elif BITS_PER_SAMPLE == 6
+        code = ((ihigh << 6) | ilow) >> 2;
+#endif
+    }
+    return code;
+}
+/*- End of function --------------------------------------------------------*/
+
+int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
+                       const int16_t amp[], int len)
+{
     int i;
     int j;
     /* Low and high band PCM from the QMF */
@@ -292,8 +449,6 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     /* Even and odd tap accumulators */
     int sumeven;
     int sumodd;
-    int ihigh;
-    int ilow;
     int code;
 
     g722_bytes = 0;
@@ -340,83 +495,7 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
 #endif
             }
         }
-        /* Block 1L, SUBTRA */
-        el = saturate(xlow - s->band[0].s);
-
-        /* Block 1L, QUANTL */
-        wd = (el >= 0)  ?  el  :  -(el + 1);
-
-        for (i = 1;  i < 30;  i++)
-        {
-            wd1 = (q6[i]*s->band[0].det) >> 12;
-            if (wd < wd1)
-                break;
-        }
-        ilow = (el < 0)  ?  iln[i]  :  ilp[i];
-
-        /* Block 2L, INVQAL */
-        ril = ilow >> 2;
-        wd2 = qm4[ril];
-        dlow = (s->band[0].det*wd2) >> 15;
-
-        /* Block 3L, LOGSCL */
-        il4 = rl42[ril];
-        wd = (s->band[0].nb*127) >> 7;
-        s->band[0].nb = wd + wl[il4];
-        if (s->band[0].nb < 0)
-            s->band[0].nb = 0;
-        else if (s->band[0].nb > 18432)
-            s->band[0].nb = 18432;
-
-        /* Block 3L, SCALEL */
-        wd1 = (s->band[0].nb >> 6) & 31;
-        wd2 = 8 - (s->band[0].nb >> 11);
-        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-        s->band[0].det = wd3 << 2;
-
-        block4(&s->band[0], dlow);
-        {
-	    int nb;
-
-            /* Block 1H, SUBTRA */
-            eh = saturate(xhigh - s->band[1].s);
-
-            /* Block 1H, QUANTH */
-            wd = (eh >= 0)  ?  eh  :  -(eh + 1);
-            wd1 = (564*s->band[1].det) >> 12;
-            mih = (wd >= wd1)  ?  2  :  1;
-            ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
-
-            /* Block 2H, INVQAH */
-            wd2 = qm2[ihigh];
-            dhigh = (s->band[1].det*wd2) >> 15;
-
-            /* Block 3H, LOGSCH */
-            ih2 = rh2[ihigh];
-            wd = (s->band[1].nb*127) >> 7;
-
-            nb = wd + wh[ih2];
-            if (nb < 0)
-                nb = 0;
-            else if (nb > 22528)
-                nb = 22528;
-	    s->band[1].nb = nb;
-
-            /* Block 3H, SCALEH */
-            wd1 = (s->band[1].nb >> 6) & 31;
-            wd2 = 10 - (s->band[1].nb >> 11);
-            wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-            s->band[1].det = wd3 << 2;
-
-            block4(&s->band[1], dhigh);
-#if   BITS_PER_SAMPLE == 8
-            code = ((ihigh << 6) | ilow);
-#elif BITS_PER_SAMPLE == 7
-            code = ((ihigh << 6) | ilow) >> 1;
-#elif BITS_PER_SAMPLE == 6
-            code = ((ihigh << 6) | ilow) >> 2;
-#endif
-        }
+        code = encode_sample(s, xlow, xhigh);
 
 #if PACKED_OUTPUT == 1
             /* Pack the code bits */
@@ -435,4 +514,80 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     return g722_bytes;
 }
 /*- End of function --------------------------------------------------------*/
+
+/* Applies the transmit QMF to the 24 samples of history |x| and encodes the
+   low and high band samples, returns the G.722 code */
+static __inline int encode_qmf(g722_encode_state_t *s, const int16_t x[24])
+{
+    int xlow;
+    int xhigh;
+
+    xlow = qmf_dot_product(x, qmf_low_coeffs) >> 14;
+    xhigh = qmf_dot_product(x, qmf_high_coeffs) >> 14;
+#ifdef RUN_LIKE_REFERENCE_G722
+    xlow = limitValues(xlow);
+    xhigh = limitValues(xhigh);
+#endif
+    return encode_sample(s, xlow, xhigh);
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Number of sample pairs filtered between two moves of the QMF history */
+#define QMF_BLOCK_PAIRS 64
+
+int g722_encode_stereo(g722_encode_state_t *left, g722_encode_state_t *right,
+                       uint8_t g722_data_left[], uint8_t g722_data_right[],
+                       const int16_t amp_left[], const int16_t amp_right[], int len)
+{
+    /* The QMF history followed by a block of samples, filtered in place
+       rather than shuffled down for each pair of samples */
+    int16_t x_left[24 + 2*QMF_BLOCK_PAIRS];
+    int16_t x_right[24 + 2*QMF_BLOCK_PAIRS];
+    int pairs;
+    int block;
+    int i;
+    int j;
+
+    if (PACKED_OUTPUT  ||  left->itu_test_mode  ||  right->itu_test_mode)
+    {
+        g722_encode(left, g722_data_left, amp_left, len);
+        return g722_encode(right, g722_data_right, amp_right, len);
+    }
+
+    /* The history holds the samples from the previous calls, 16 bits wide */
+    for (i = 0;  i < 24;  i++)
+    {
+        x_left[i] = (int16_t) left->x[i];
+        x_right[i] = (int16_t) right->x[i];
+    }
+
+    pairs = len/2;
+    for (j = 0;  j < pairs;  j += block)
+    {
+        block = pairs - j;
+        if (block > QMF_BLOCK_PAIRS)
+            block = QMF_BLOCK_PAIRS;
+        memcpy(x_left + 24, amp_left + 2*j, 2*block*sizeof(int16_t));
+        memcpy(x_right + 24, amp_right + 2*j, 2*block*sizeof(int16_t));
+
+        /* Both channels in the same pass, their ADPCM states are independent */
+        for (i = 0;  i < block;  i++)
+        {
+            g722_data_left[j + i] = (uint8_t) encode_qmf(left, x_left + 2*i + 2);
+            g722_data_right[j + i] = (uint8_t) encode_qmf(right, x_right + 2*i + 2);
+        }
+
+        /* Keep the last 24 samples as the history of the next block */
+        memmove(x_left, x_left + 2*block, 24*sizeof(int16_t));
+        memmove(x_right, x_right + 2*block, 24*sizeof(int16_t));
+    }
+
+    for (i = 0;  i < 24;  i++)
+    {
+        left->x[i] = x_left[i];
+        right->x[i] = x_right[i];
+    }
+    return pairs;
+}
+/*- End of function --------------------------------------------------------*/
 /*- End of file ------------------------------------------------------------*/
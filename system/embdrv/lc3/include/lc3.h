@@ -103,6 +103,16 @@
  *
  *   with `nch` as the number of channels in the PCM stream
  *
+ * The encoders of all the channels can also be setup in a single memory
+ * space, and the channels encoded in a single call :
+ *
+ *   | lc3_setup_encoders(frame_us, samplerate, 0, nch,
+ *   |      malloc(lc3_encoders_size(frame_us, samplerate, nch)), encoder);
+ *   | ...
+ *   | lc3_encode_channels(encoder, nch, fmt, pcm, nbytes, out);
+ *   | ...
+ *   | free(encoder[0]);
+ *
  * ---
  *
  * Antoine SOULIER, Tempow / Google LLC
@@ -258,6 +268,50 @@ lc3_encoder_t lc3_setup_encoder(
 int lc3_encode(lc3_encoder_t encoder, enum lc3_pcm_format fmt,
     const void *pcm, int stride, int nbytes, void *out);
 
+/**
+ * Return size needed for the encoders of several channels
+ * dt_us           Frame duration in us, 7500 or 10000
+ * sr_hz           Samplerate in Hz, 8000, 16000, 24000, 32000 or 48000
+ * nch             Number of channels
+ * return          Size of the encoders in bytes, 0 on bad parameters
+ *
+ * As for `lc3_encoder_size()`, the `sr_hz` parameter is the samplerate
+ * of the PCM input stream.
+ */
+unsigned lc3_encoders_size(int dt_us, int sr_hz, int nch);
+
+/**
+ * Setup the encoders of several channels
+ * dt_us           Frame duration in us, 7500 or 10000
+ * sr_hz           Samplerate in Hz, 8000, 16000, 24000, 32000 or 48000
+ * sr_pcm_hz       Input samplerate, downsampling option of input, or 0
+ * nch             Number of channels
+ * mem             Encoders memory space, aligned to pointer type
+ * encoders        Return the `nch` handles of the encoders
+ * return          0: On success  -1: Wrong parameters
+ *
+ * The encoders are laid out one after the other in `mem`, of the size
+ * given by `lc3_encoders_size()`.
+ */
+int lc3_setup_encoders(int dt_us, int sr_hz, int sr_pcm_hz,
+    int nch, void *mem, lc3_encoder_t *encoders);
+
+/**
+ * Encode a frame of several channels
+ * encoders        Handles of the encoders, one for each channel
+ * nch             Number of channels
+ * fmt             PCM input format
+ * pcm             Input PCM samples, interleaved by channel
+ * nbytes          Target size, in bytes, of the frame of each channel
+ * out             Output buffer of `nch * nbytes` size
+ * return          0: On success  -1: Wrong parameters
+ *
+ * The frames are output one after the other, in the order of the channels.
+ * The result is the same as encoding each channel with `lc3_encode()`.
+ */
+int lc3_encode_channels(lc3_encoder_t const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void *out);
+
 /**
  * Return size needed for an decoder
  * dt_us           Frame duration in us, 7500 or 10000
@@ -359,6 +359,89 @@ int lc3_encode(struct lc3_encoder *encoder, enum lc3_pcm_format fmt,
     return 0;
 }
 
+/**
+ * Return size needed for the encoders of several channels
+ */
+unsigned lc3_encoders_size(int dt_us, int sr_hz, int nch)
+{
+    unsigned size = lc3_encoder_size(dt_us, sr_hz);
+    unsigned align = sizeof(void *);
+
+    if (nch <= 0)
+        return 0;
+
+    return nch * ((size + align - 1) & ~(align - 1));
+}
+
+/**
+ * Setup the encoders of several channels
+ */
+int lc3_setup_encoders(int dt_us, int sr_hz, int sr_pcm_hz,
+    int nch, void *mem, lc3_encoder_t *encoders)
+{
+    unsigned size = lc3_encoders_size(
+        dt_us, sr_pcm_hz > 0 ? sr_pcm_hz : sr_hz, nch);
+
+    if (!size || !mem || !encoders)
+        return -1;
+
+    for (int ich = 0; ich < nch; ich++) {
+        encoders[ich] = lc3_setup_encoder(
+            dt_us, sr_hz, sr_pcm_hz, (char *)mem + ich * (size / nch));
+        if (!encoders[ich])
+            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Encode a frame of several channels
+ */
+int lc3_encode_channels(lc3_encoder_t const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void *out)
+{
+    static void (* const load[])(struct lc3_encoder *, const void *, int) = {
+        [LC3_PCM_FORMAT_S16] = load_s16,
+        [LC3_PCM_FORMAT_S24] = load_s24,
+    };
+
+    static const int pcm_sbytes[] = {
+        [LC3_PCM_FORMAT_S16] = sizeof(int16_t),
+        [LC3_PCM_FORMAT_S24] = sizeof(int32_t),
+    };
+
+    /* --- Check parameters --- */
+
+    if (!encoders || nch <= 0 || nbytes < LC3_MIN_FRAME_BYTES
+                              || nbytes > LC3_MAX_FRAME_BYTES)
+        return -1;
+
+    for (int ich = 0; ich < nch; ich++)
+        if (!encoders[ich])
+            return -1;
+
+    /* --- Processing ---
+     * The channels are processed one after the other, sharing the working
+     * buffers, so that the tables and the code stay hot in the caches */
+
+    struct side_data side;
+    uint16_t xq[LC3_MAX_NE];
+
+    for (int ich = 0; ich < nch; ich++) {
+        struct lc3_encoder *encoder = encoders[ich];
+
+        load[fmt](encoder,
+            (const char *)pcm + ich * pcm_sbytes[fmt], nch);
+
+        analyze(encoder, nbytes, &side, xq);
+
+        encode(encoder, &side, xq, nbytes, (uint8_t *)out + ich * nbytes);
+    }
+
+    return 0;
+}
+
 
 /* ----------------------------------------------------------------------------
  *  Decoder
@@ -0,0 +1,256 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE3__
+
+#include <pmmintrin.h>
+
+/**
+ * When `TEST_SSE` is defined the functions are compiled alongside the
+ * generic ones, without replacing them, so that they can be compared.
+ */
+
+
+/**
+ * Load a single complex value in the low half of a vector
+ */
+static inline __m128 sse_load_c(const struct lc3_complex *x)
+{
+    return _mm_castpd_ps( _mm_load_sd((const double *)x) );
+}
+
+/**
+ * Complex multiplication of 2 pairs of interleaved complex values
+ */
+static inline __m128 sse_cmul(__m128 x, __m128 w)
+{
+    __m128 xr = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+
+    return _mm_addsub_ps( _mm_mul_ps(x , _mm_moveldup_ps(w)),
+                          _mm_mul_ps(xr, _mm_movehdup_ps(w)) );
+}
+
+/**
+ * FFT 5 Points
+ * The number of interleaved transform `n` assumed to be even
+ */
+#ifndef fft_5
+LC3_HOT static inline void sse_fft_5(
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    const __m128 cos1 = _mm_set1_ps( 0.3090169944);
+    const __m128 cos2 = _mm_set1_ps(-0.8090169944);
+
+    const __m128 sin1 = _mm_setr_ps(
+        0.9510565163, -0.9510565163, 0.9510565163, -0.9510565163);
+    const __m128 sin2 = _mm_setr_ps(
+        0.5877852523, -0.5877852523, 0.5877852523, -0.5877852523);
+
+    for (int i = 0; i < n; i += 2, x += 2, y += 10) {
+
+        __m128 y0, y1, y2, y3, y4;
+
+        __m128 x0 = _mm_loadu_ps( (float *)(x + 0*n) );
+        __m128 x1 = _mm_loadu_ps( (float *)(x + 1*n) );
+        __m128 x2 = _mm_loadu_ps( (float *)(x + 2*n) );
+        __m128 x3 = _mm_loadu_ps( (float *)(x + 3*n) );
+        __m128 x4 = _mm_loadu_ps( (float *)(x + 4*n) );
+
+        __m128 s14 = _mm_add_ps(x1, x4);
+        __m128 s23 = _mm_add_ps(x2, x3);
+
+        __m128 d14 = _mm_sub_ps(x1, x4);
+        __m128 d23 = _mm_sub_ps(x2, x3);
+        d14 = _mm_shuffle_ps(d14, d14, _MM_SHUFFLE(2, 3, 0, 1));
+        d23 = _mm_shuffle_ps(d23, d23, _MM_SHUFFLE(2, 3, 0, 1));
+
+        y0 = _mm_add_ps( x0, _mm_add_ps(s14, s23) );
+
+        y4 = _mm_add_ps( x0, _mm_mul_ps(s14, cos1) );
+        y4 = _mm_add_ps( y4, _mm_mul_ps(s23, cos2) );
+
+        y1 = _mm_add_ps( y4, _mm_mul_ps(d14, sin1) );
+        y1 = _mm_add_ps( y1, _mm_mul_ps(d23, sin2) );
+
+        y4 = _mm_sub_ps( y4, _mm_mul_ps(d14, sin1) );
+        y4 = _mm_sub_ps( y4, _mm_mul_ps(d23, sin2) );
+
+        y3 = _mm_add_ps( x0, _mm_mul_ps(s14, cos2) );
+        y3 = _mm_add_ps( y3, _mm_mul_ps(s23, cos1) );
+
+        y2 = _mm_add_ps( y3, _mm_mul_ps(d14, sin2) );
+        y2 = _mm_sub_ps( y2, _mm_mul_ps(d23, sin1) );
+
+        y3 = _mm_sub_ps( y3, _mm_mul_ps(d14, sin2) );
+        y3 = _mm_add_ps( y3, _mm_mul_ps(d23, sin1) );
+
+        _mm_storel_pi( (__m64 *)(y + 0), y0 );
+        _mm_storel_pi( (__m64 *)(y + 1), y1 );
+        _mm_storel_pi( (__m64 *)(y + 2), y2 );
+        _mm_storel_pi( (__m64 *)(y + 3), y3 );
+        _mm_storel_pi( (__m64 *)(y + 4), y4 );
+
+        _mm_storeh_pi( (__m64 *)(y + 5), y0 );
+        _mm_storeh_pi( (__m64 *)(y + 6), y1 );
+        _mm_storeh_pi( (__m64 *)(y + 7), y2 );
+        _mm_storeh_pi( (__m64 *)(y + 8), y3 );
+        _mm_storeh_pi( (__m64 *)(y + 9), y4 );
+    }
+}
+
+#ifndef TEST_SSE
+#define fft_5 sse_fft_5
+#endif
+#endif /* fft_5 */
+
+/**
+ * FFT Butterfly 3 Points
+ */
+#ifndef fft_bf3
+LC3_HOT static inline void sse_fft_bf3(
+    const struct lc3_fft_bf3_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n3 = twiddles->n3;
+    const struct lc3_complex (*w0_ptr)[2] = twiddles->t;
+    const struct lc3_complex (*w1_ptr)[2] = w0_ptr + n3;
+    const struct lc3_complex (*w2_ptr)[2] = w1_ptr + n3;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n3;
+    const struct lc3_complex *x2_ptr = x1_ptr + n*n3;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n3;
+    struct lc3_complex *y2_ptr = y1_ptr + n3;
+
+    for (int j, i = 0; i < n; i++,
+            y0_ptr += 3*n3, y1_ptr += 3*n3, y2_ptr += 3*n3) {
+
+        /* --- Process by pair ---
+         * The twiddles of the 2 points are loaded as `{ w[j], w[j+1] }`
+         * for each of the 2 inputs */
+
+        for (j = 0; j < (n3 >> 1); j++,
+                x0_ptr += 2, x1_ptr += 2, x2_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps( (float *)x0_ptr );
+            __m128 x1 = _mm_loadu_ps( (float *)x1_ptr );
+            __m128 x2 = _mm_loadu_ps( (float *)x2_ptr );
+
+            const struct lc3_complex (*w_ptr[3])[2] =
+                { w0_ptr + 2*j, w1_ptr + 2*j, w2_ptr + 2*j };
+            struct lc3_complex *y_ptr[3] =
+                { y0_ptr + 2*j, y1_ptr + 2*j, y2_ptr + 2*j };
+
+            for (int k = 0; k < 3; k++) {
+                __m128 wa = _mm_loadu_ps( (float *)(w_ptr[k] + 0) );
+                __m128 wb = _mm_loadu_ps( (float *)(w_ptr[k] + 1) );
+
+                __m128 yn = _mm_add_ps( x0,
+                    sse_cmul(x1, _mm_movelh_ps(wa, wb)) );
+                yn = _mm_add_ps( yn, sse_cmul(x2, _mm_movehl_ps(wb, wa)) );
+                _mm_storeu_ps( (float *)y_ptr[k], yn );
+            }
+        }
+
+        /* --- Last iteration --- */
+
+        if (n3 & 1) {
+
+            __m128 x0 = sse_load_c(x0_ptr++);
+            __m128 x1 = sse_load_c(x1_ptr++);
+            __m128 x2 = sse_load_c(x2_ptr++);
+
+            const struct lc3_complex (*w_ptr[3])[2] =
+                { w0_ptr + 2*j, w1_ptr + 2*j, w2_ptr + 2*j };
+            struct lc3_complex *y_ptr[3] =
+                { y0_ptr + 2*j, y1_ptr + 2*j, y2_ptr + 2*j };
+
+            for (int k = 0; k < 3; k++) {
+                __m128 w = _mm_loadu_ps( (float *)w_ptr[k] );
+
+                __m128 yn = _mm_add_ps( x0, sse_cmul(x1, w) );
+                yn = _mm_add_ps( yn,
+                    sse_cmul(x2, _mm_movehl_ps(w, w)) );
+                _mm_storel_pi( (__m64 *)y_ptr[k], yn );
+            }
+        }
+
+    }
+}
+
+#ifndef TEST_SSE
+#define fft_bf3 sse_fft_bf3
+#endif
+#endif /* fft_bf3 */
+
+/**
+ * FFT Butterfly 2 Points
+ */
+#ifndef fft_bf2
+LC3_HOT static inline void sse_fft_bf2(
+    const struct lc3_fft_bf2_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n2 = twiddles->n2;
+    const struct lc3_complex *w_ptr = twiddles->t;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n2;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n2;
+
+    for (int j, i = 0; i < n; i++, y0_ptr += 2*n2, y1_ptr += 2*n2) {
+
+        /* --- Process by pair --- */
+
+        for (j = 0; j < (n2 >> 1); j++, x0_ptr += 2, x1_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps( (float *)x0_ptr );
+            __m128 x1 = _mm_loadu_ps( (float *)x1_ptr );
+
+            __m128 x1w = sse_cmul(x1, _mm_loadu_ps( (float *)(w_ptr + 2*j) ));
+
+            _mm_storeu_ps( (float *)(y0_ptr + 2*j), _mm_add_ps(x0, x1w) );
+            _mm_storeu_ps( (float *)(y1_ptr + 2*j), _mm_sub_ps(x0, x1w) );
+        }
+
+        /* --- Last iteration --- */
+
+        if (n2 & 1) {
+
+            __m128 x0 = sse_load_c(x0_ptr++);
+            __m128 x1 = sse_load_c(x1_ptr++);
+
+            __m128 w = sse_load_c(w_ptr + 2*j);
+            __m128 x1w = sse_cmul(x1, w);
+
+            _mm_storel_pi( (__m64 *)(y0_ptr + 2*j), _mm_add_ps(x0, x1w) );
+            _mm_storel_pi( (__m64 *)(y1_ptr + 2*j), _mm_sub_ps(x0, x1w) );
+        }
+    }
+}
+
+#ifndef TEST_SSE
+#define fft_bf2 sse_fft_bf2
+#endif
+#endif /* fft_bf2 */
+
+#endif /* __SSE3__ */
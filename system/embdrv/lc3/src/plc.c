@@ -50,6 +50,12 @@ void lc3_plc_synthesize(enum lc3_dt dt, enum lc3_srate sr,
     alpha *= (plc->count < 4 ? 1.0f :
               plc->count < 8 ? 0.9f : 0.85f);
 
+    /* Mute once the attenuation is far below the resolution of the output,
+     * instead of moving to denormal values, slow to compute on long losses */
+
+    if (alpha < 1e-6f)
+        alpha = 0;
+
     for (int i = 0; i < ne; i++) {
         seed = (16831 + seed * 12821) & 0xffff;
         y[i] = alpha * (seed & 0x8000 ? -x[i] : x[i]);
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE4_1__
+
+#include <smmintrin.h>
+
+/**
+ * When `TEST_SSE` is defined the functions are compiled alongside the
+ * generic ones, without replacing them, so that they can be compared.
+ */
+
+
+/**
+ * Import
+ */
+
+static float unquantize_gain(int g_int);
+
+
+/**
+ * Spectrum quantization
+ * The number of coefficients is assumed to be a multiple of 4
+ */
+#ifndef quantize
+LC3_HOT static void sse_quantize(enum lc3_dt dt, enum lc3_srate sr,
+    int g_int, float *x, uint16_t *xq, int *nq)
+{
+    const __m128 g_inv = _mm_set1_ps(1 / unquantize_gain(g_int));
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(INT32_MAX));
+    const __m128 offset = _mm_set1_ps(6.f/16);
+    const __m128 q_max = _mm_set1_ps(INT16_MAX);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+
+    int ne = LC3_NE(dt, sr);
+
+    *nq = 0;
+
+    for (int i = 0; i < ne; i += 4) {
+        __m128 xn = _mm_mul_ps(_mm_loadu_ps(x + i), g_inv);
+        _mm_storeu_ps(x + i, xn);
+
+        __m128i qn = _mm_cvttps_epi32( _mm_min_ps(
+            _mm_add_ps(_mm_and_ps(xn, abs_mask), offset), q_max) );
+
+        /* --- Sign bit is set for negative non-zero values --- */
+
+        __m128i nz = _mm_cmpgt_epi32(qn, zero);
+        __m128i neg = _mm_castps_si128(_mm_cmplt_ps(xn, _mm_setzero_ps()));
+        __m128i sn = _mm_and_si128(one, _mm_and_si128(nz, neg));
+
+        __m128i xqn = _mm_or_si128(_mm_slli_epi32(qn, 1), sn);
+        _mm_storel_epi64((__m128i *)(xq + i), _mm_packus_epi32(xqn, xqn));
+
+        /* --- Count up to the last pair holding a non-zero value --- */
+
+        int nz_mask = _mm_movemask_ps(_mm_castsi128_ps(nz));
+        if (nz_mask)
+            *nq = i + (nz_mask & 0xc ? 4 : 2);
+    }
+}
+
+#ifndef TEST_SSE
+#define quantize sse_quantize
+#endif
+#endif /* quantize */
+
+#endif /* __SSE4_1__ */
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ *  Copyright 2023 Google LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_SSE
+#include <spec.c>
+
+/* -------------------------------------------------------------------------- */
+
+static int check_quantize()
+{
+    float x[LC3_MAX_NE], x_sse[LC3_MAX_NE];
+    uint16_t xq[LC3_MAX_NE], xq_sse[LC3_MAX_NE];
+    int nq, nq_sse;
+
+    for (enum lc3_dt dt = 0; dt < LC3_NUM_DT; dt++)
+        for (enum lc3_srate sr = 0; sr < LC3_NUM_SRATE; sr++) {
+            int ne = LC3_NE(dt, sr);
+
+            /* Leave the high frequencies of every other frame silent,
+             * to check the count of significant coefficients */
+
+            for (int k = 0; k < 2; k++) {
+                for (int i = 0; i < ne; i++)
+                    x[i] = x_sse[i] = k && i > ne/2 ? 0 :
+                        ((float)rand() / RAND_MAX - 0.5f) * 65536;
+
+                int g_int = rand() % 64 - 8;
+
+                quantize(dt, sr, g_int, x, xq, &nq);
+                sse_quantize(dt, sr, g_int, x_sse, xq_sse, &nq_sse);
+
+                if (nq != nq_sse ||
+                    memcmp(x, x_sse, ne * sizeof(*x)) != 0 ||
+                    memcmp(xq, xq_sse, ne * sizeof(*xq)) != 0)
+                    return -1;
+            }
+        }
+
+    return 0;
+}
+
+int check_spec(void)
+{
+    int ret;
+
+    if ((ret = check_quantize()) < 0)
+        return ret;
+
+    return 0;
+}
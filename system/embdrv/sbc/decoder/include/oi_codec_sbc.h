@@ -486,6 +486,24 @@ uint16_t OI_CODEC_SBC_CalculatePcmBytes(OI_CODEC_SBC_COMMON_CONTEXT* common);
  */
 OI_CHAR* OI_CODEC_Version(void);
 
+/* Implementations of the 8 subbands synthesis window */
+#define SBC_SYNTH_WINDOW_SCALAR 0
+#define SBC_SYNTH_WINDOW_AVX2 1
+#define SBC_SYNTH_WINDOW_NEON 2
+
+/**
+ * Use the |impl| implementation of the 8 subbands synthesis window instead of
+ * the fastest one supported by the CPU, which is selected by the first call to
+ * OI_CODEC_SBC_DecoderReset(). All implementations decode the same samples.
+ * Intended for tests and benchmarks.
+ *
+ * @param impl  One of the SBC_SYNTH_WINDOW_* values
+ *
+ * @return FALSE if the decoder was built without |impl| or the CPU doesn't
+ * support it
+ */
+OI_BOOL OI_CODEC_SBC_UseSynthWindow(uint8_t impl);
+
 /**
 @}
 
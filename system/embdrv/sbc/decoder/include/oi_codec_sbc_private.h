@@ -183,6 +183,7 @@ PRIVATE void cosineModulateSynth4(SBC_BUFFER_T* RESTRICT out,
                                   int32_t const* RESTRICT in);
 PRIVATE void SynthWindow40_int32_int32_symmetry_with_sum(
     int16_t* pcm, SBC_BUFFER_T buffer[80], OI_UINT strideShift);
+PRIVATE void OI_SBC_SynthInit(void);
 
 INLINE void dct3_4(int32_t* RESTRICT out, int32_t const* RESTRICT in);
 PRIVATE void analyze4_generated(SBC_BUFFER_T analysisBuffer[RESTRICT 40],
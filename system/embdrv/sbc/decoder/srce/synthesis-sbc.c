@@ -165,6 +165,13 @@ The output samples X[0..7] are defined as sums of W:
 
 #include "oi_codec_sbc_private.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 const int32_t dec_window_4[21] = {
     0,      /* +0.00000000E+00 */
     97,     /* +5.36548976E-04 */
@@ -266,13 +273,188 @@ typedef void (*SYNTH_FRAME)(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
 #endif
 
 #ifndef SYNTH80
-#define SYNTH80 SynthWindow80_generated
+#define SYNTH80_DISPATCH
+#define SYNTH80 SynthWindow80
 #endif
 
 #ifndef SYNTH112
 #define SYNTH112 SynthWindow112_generated
 #endif
 
+#ifdef SYNTH80_DISPATCH
+/* SynthWindow80_generated computes each of the 8 output samples as a sum of
+ * taps coef * buffer[idx], each shifted by its own amount. For every 16
+ * samples group of the buffer, output j takes one tap from the first half of
+ * the group (buffer[4..8]) and one from the second half (buffer[9..12]), at
+ * offsets mirrored around the middle of the group:
+ *
+ *   j           0   1   2   3   4   5   6   7
+ *   first tap   4   5   6   7   8   7   6   5
+ *   second tap  12  11  10  9   -   9   10  11
+ *
+ * which vectorizes over the output samples. The tables below hold the
+ * coefficients and shifts of the taps of group g as synthWindow80Coef[g][0]
+ * and [g][1], a positive shift is to the left and a negative one to the right.
+ * Missing taps have a 0 coefficient. Every kernel forms the same products and
+ * shifts as SynthWindow80_generated, so the output is bit exact. */
+static const int16_t synthWindow80Coef[5][2][8] = {
+    {{0, -3263, -10385, -16457, 10445, 16913, 11167, 9293},
+     {8235, 29293, 24995, 19083, 0, -8443, -10337, -6087}},
+    {{-23167, -5229, -309, -23641, -5297, 3687, 1917, 1247},
+     {26479, 30835, 9161, -29015, 0, -301, -30605, -2893}},
+    {{-17397, -27021, -23063, -12889, 22299, 15447, 8317, 23671},
+     {9399, 31633, 27561, 6145, 0, 10255, 9553, 18055}},
+    {{17397, 17319, 2309, 24211, 10603, -18233, 22117, 11537},
+     {26479, 26663, 12705, 23469, 0, 9405, 16383, 1747}},
+    {{23167, 4555, 6239, 21223, 9539, 1499, 7543, 685},
+     {8235, 12419, 9251, 26913, 0, 26189, 8603, 8721}},
+};
+
+static const int32_t synthWindow80Shift[5][2][8] = {
+    {{0, -5, -6, -6, -4, -5, -4, -3}, {-3, -5, -5, -5, 0, -7, -4, -2}},
+    {{-3, 0, 4, -2, 1, 1, 2, 3}, {-2, -3, -3, -4, 0, 5, -1, 3}},
+    {{1, 1, 1, 2, 2, 2, 3, 2}, {3, 1, 1, 3, 0, 2, 2, 1}},
+    {{1, 1, 3, -1, 0, -3, -4, -1}, {-2, -2, -1, -2, 0, -1, -2, 1}},
+    {{-3, -1, -3, -8, -4, -1, -3, 1}, {-3, -4, -4, -6, 0, -7, -6, -7}},
+};
+
+typedef void (*SYNTH_WINDOW)(int16_t* pcm, SBC_BUFFER_T const* RESTRICT buffer,
+                             OI_UINT strideShift);
+
+#if defined(__x86_64__) || defined(__i386__)
+/* AVX2 is the first x86 extension with per lane variable shifts */
+__attribute__((target("avx2"))) PRIVATE void SynthWindow80_avx2(
+    int16_t* pcm, SBC_BUFFER_T const* RESTRICT buffer, OI_UINT strideShift) {
+  __m256i sum = _mm256_setzero_si256();
+  __m128i out;
+  OI_UINT g, i;
+
+  for (g = 0; g < 5; g++) {
+    SBC_BUFFER_T const* group = buffer + 16 * g;
+    __m128i taps[2];
+    taps[0] = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((__m128i const*)(group + 4)),
+        _mm_shufflelo_epi16(_mm_loadl_epi64((__m128i const*)(group + 5)),
+                            0x1b));
+    taps[1] = _mm_unpacklo_epi64(
+        _mm_shufflelo_epi16(_mm_loadl_epi64((__m128i const*)(group + 9)),
+                            0x1b),
+        _mm_loadl_epi64((__m128i const*)(group + 8)));
+    for (i = 0; i < 2; i++) {
+      __m256i coef = _mm256_cvtepi16_epi32(
+          _mm_loadu_si128((__m128i const*)synthWindow80Coef[g][i]));
+      __m256i shift =
+          _mm256_loadu_si256((__m256i const*)synthWindow80Shift[g][i]);
+      __m256i left = _mm256_max_epi32(shift, _mm256_setzero_si256());
+      __m256i right = _mm256_sub_epi32(left, shift);
+      __m256i product =
+          _mm256_mullo_epi32(_mm256_cvtepi16_epi32(taps[i]), coef);
+      product = _mm256_sllv_epi32(_mm256_srav_epi32(product, right), left);
+      sum = _mm256_add_epi32(sum, product);
+    }
+  }
+
+  /* sum / 32768, rounded towards zero, then clipped by the saturating pack */
+  sum = _mm256_add_epi32(
+      sum, _mm256_srli_epi32(_mm256_srai_epi32(sum, 31), 32 - 15));
+  sum = _mm256_srai_epi32(sum, 15);
+  out = _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                        _mm256_extracti128_si256(sum, 1));
+  if (strideShift == 0) {
+    _mm_storeu_si128((__m128i*)pcm, out);
+  } else {
+    int16_t samples[8];
+    _mm_storeu_si128((__m128i*)samples, out);
+    for (i = 0; i < 8; i++) {
+      pcm[i << strideShift] = samples[i];
+    }
+  }
+}
+#endif
+
+#if defined(__ARM_NEON)
+PRIVATE void SynthWindow80_neon(int16_t* pcm,
+                                SBC_BUFFER_T const* RESTRICT buffer,
+                                OI_UINT strideShift) {
+  int32x4_t sum[2] = {vdupq_n_s32(0), vdupq_n_s32(0)};
+  int16x8_t out;
+  OI_UINT g, i;
+
+  for (g = 0; g < 5; g++) {
+    SBC_BUFFER_T const* group = buffer + 16 * g;
+    /* First and second taps of the outputs 0..3, then of the outputs 4..7 */
+    int16x4_t taps[2][2] = {
+        {vld1_s16(group + 4), vrev64_s16(vld1_s16(group + 9))},
+        {vrev64_s16(vld1_s16(group + 5)), vld1_s16(group + 8)}};
+    for (i = 0; i < 2; i++) {
+      /* vshlq_s32 shifts to the right, rounding down, by negative amounts */
+      sum[0] = vaddq_s32(
+          sum[0], vshlq_s32(vmull_s16(taps[0][i],
+                                      vld1_s16(synthWindow80Coef[g][i])),
+                            vld1q_s32(synthWindow80Shift[g][i])));
+      sum[1] = vaddq_s32(
+          sum[1], vshlq_s32(vmull_s16(taps[1][i],
+                                      vld1_s16(synthWindow80Coef[g][i] + 4)),
+                            vld1q_s32(synthWindow80Shift[g][i] + 4)));
+    }
+  }
+
+  /* sum / 32768, rounded towards zero, then clipped by the saturating narrow */
+  for (i = 0; i < 2; i++) {
+    uint32x4_t sign = vreinterpretq_u32_s32(vshrq_n_s32(sum[i], 31));
+    sum[i] =
+        vaddq_s32(sum[i], vreinterpretq_s32_u32(vshrq_n_u32(sign, 32 - 15)));
+  }
+  out = vcombine_s16(vqshrn_n_s32(sum[0], 15), vqshrn_n_s32(sum[1], 15));
+  if (strideShift == 0) {
+    vst1q_s16(pcm, out);
+  } else {
+    int16_t samples[8];
+    vst1q_s16(samples, out);
+    for (i = 0; i < 8; i++) {
+      pcm[i << strideShift] = samples[i];
+    }
+  }
+}
+#endif
+
+static SYNTH_WINDOW SynthWindow80 = NULL;
+
+OI_BOOL OI_CODEC_SBC_UseSynthWindow(uint8_t impl) {
+  switch (impl) {
+    case SBC_SYNTH_WINDOW_SCALAR:
+      SynthWindow80 = SynthWindow80_generated;
+      return TRUE;
+#if defined(__x86_64__) || defined(__i386__)
+    case SBC_SYNTH_WINDOW_AVX2:
+      if (!__builtin_cpu_supports("avx2")) return FALSE;
+      SynthWindow80 = SynthWindow80_avx2;
+      return TRUE;
+#endif
+#if defined(__ARM_NEON)
+    case SBC_SYNTH_WINDOW_NEON:
+      SynthWindow80 = SynthWindow80_neon;
+      return TRUE;
+#endif
+    default:
+      return FALSE;
+  }
+}
+
+PRIVATE void OI_SBC_SynthInit(void) {
+  if (SynthWindow80 != NULL) return;
+  if (OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_AVX2)) return;
+  if (OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_NEON)) return;
+  OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_SCALAR);
+}
+#else
+OI_BOOL OI_CODEC_SBC_UseSynthWindow(uint8_t impl) {
+  return impl == SBC_SYNTH_WINDOW_SCALAR;
+}
+
+PRIVATE void OI_SBC_SynthInit(void) {}
+#endif /* SYNTH80_DISPATCH */
+
 PRIVATE void OI_SBC_SynthFrame_80(OI_CODEC_SBC_DECODER_CONTEXT* context,
                                   int16_t* pcm, OI_UINT blkstart,
                                   OI_UINT blkcount) {
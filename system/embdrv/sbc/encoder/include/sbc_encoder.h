@@ -139,6 +139,16 @@
 #define SBC_IS_64_MULT_IN_QUANTIZER TRUE
 #endif /*SBC_IS_64_MULT_IN_IDCT */
 
+/* Set SBC_VECTORIZED_WINDOW_ACCU to TRUE to perform the windowing of the
+ * analysis filter with the SSE2, AVX2 or NEON instructions supported by the
+ * CPU, selected at runtime. The results are the same as with the scalar code.
+ */
+/* CAUTION: It only apply if SBC_IPAQ_OPT is set to TRUE, and
+ * SBC_IS_64_MULT_IN_WINDOW_ACCU and SBC_ARM_ASM_OPT are set to FALSE */
+#ifndef SBC_VECTORIZED_WINDOW_ACCU
+#define SBC_VECTORIZED_WINDOW_ACCU TRUE
+#endif /*SBC_VECTORIZED_WINDOW_ACCU */
+
 /* Debug only: set this flag to FALSE to disable fast DCT algorithm */
 #ifndef SBC_FAST_DCT
 #define SBC_FAST_DCT TRUE
@@ -205,6 +215,18 @@ uint32_t SBC_Encode(SBC_ENC_PARAMS* strEncParams, int16_t* input,
                     uint8_t* output);
 void SBC_Encoder_Init(SBC_ENC_PARAMS* strEncParams);
 
+/* Implementations of the windowing of the analysis filter, see
+ * SBC_VECTORIZED_WINDOW_ACCU */
+#define SBC_WINDOW_ACCU_SCALAR 0
+#define SBC_WINDOW_ACCU_SSE2 1
+#define SBC_WINDOW_ACCU_AVX2 2
+#define SBC_WINDOW_ACCU_NEON 3
+
+/* Use the |impl| implementation of the windowing instead of the fastest one
+ * supported by the CPU. Return false if the encoder was built without it or
+ * the CPU doesn't support it. Intended for tests and benchmarks. */
+bool SBC_Encoder_UseWindowAccu(uint8_t impl);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,12 @@
 #include <string.h>
 #include "sbc_enc_func_declare.h"
 #include "sbc_encoder.h"
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 /*#include <math.h>*/
 
 #if (SBC_IS_64_MULT_IN_WINDOW_ACCU == TRUE)
@@ -1185,6 +1191,239 @@ static int16_t* s16X =
 #endif
 #endif
 
+#if ((SBC_VECTORIZED_WINDOW_ACCU == TRUE) && (SBC_IPAQ_OPT == TRUE) && \
+     (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE) && (SBC_ARM_ASM_OPT == FALSE))
+#define SBC_WINDOW_ACCU_DISPATCH TRUE
+#else
+#define SBC_WINDOW_ACCU_DISPATCH FALSE
+#endif
+
+#if (SBC_WINDOW_ACCU_DISPATCH == TRUE)
+/* The windowing coefficients laid out as used by WINDOW_PARTIAL_4 and
+ * WINDOW_PARTIAL_8: s32DCTY[k] is the sum of the products of
+ * as16Window[j][k] and s16X[ChOffset + j * 2 * SubBands + k] for the 5 rows
+ * j of the window, which vectorizes over k. */
+static const int16_t as16Window4[5][8] = {
+    {0, WIND_4_SUBBANDS_1_0, WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_1_4},
+    {WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_1, WIND_4_SUBBANDS_2_1,
+     WIND_4_SUBBANDS_3_1, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_3,
+     WIND_4_SUBBANDS_2_3, WIND_4_SUBBANDS_1_3},
+    {WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_2, WIND_4_SUBBANDS_2_2,
+     WIND_4_SUBBANDS_3_2, WIND_4_SUBBANDS_4_2, WIND_4_SUBBANDS_3_2,
+     WIND_4_SUBBANDS_2_2, WIND_4_SUBBANDS_1_2},
+    {-WIND_4_SUBBANDS_0_2, WIND_4_SUBBANDS_1_3, WIND_4_SUBBANDS_2_3,
+     WIND_4_SUBBANDS_3_3, WIND_4_SUBBANDS_4_1, WIND_4_SUBBANDS_3_1,
+     WIND_4_SUBBANDS_2_1, WIND_4_SUBBANDS_1_1},
+    {-WIND_4_SUBBANDS_0_1, WIND_4_SUBBANDS_1_4, WIND_4_SUBBANDS_2_4,
+     WIND_4_SUBBANDS_3_4, WIND_4_SUBBANDS_4_0, WIND_4_SUBBANDS_3_0,
+     WIND_4_SUBBANDS_2_0, WIND_4_SUBBANDS_1_0},
+};
+
+static const int16_t as16Window8[5][16] = {
+    {0, WIND_8_SUBBANDS_1_0, WIND_8_SUBBANDS_2_0, WIND_8_SUBBANDS_3_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_5_0, WIND_8_SUBBANDS_6_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_8_0, WIND_8_SUBBANDS_7_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_5_4, WIND_8_SUBBANDS_4_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_2_4, WIND_8_SUBBANDS_1_4},
+    {WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_1_3},
+    {WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_8_2,
+     WIND_8_SUBBANDS_7_2, WIND_8_SUBBANDS_6_2, WIND_8_SUBBANDS_5_2,
+     WIND_8_SUBBANDS_4_2, WIND_8_SUBBANDS_3_2, WIND_8_SUBBANDS_2_2,
+     WIND_8_SUBBANDS_1_2},
+    {-WIND_8_SUBBANDS_0_2, WIND_8_SUBBANDS_1_3, WIND_8_SUBBANDS_2_3,
+     WIND_8_SUBBANDS_3_3, WIND_8_SUBBANDS_4_3, WIND_8_SUBBANDS_5_3,
+     WIND_8_SUBBANDS_6_3, WIND_8_SUBBANDS_7_3, WIND_8_SUBBANDS_8_1,
+     WIND_8_SUBBANDS_7_1, WIND_8_SUBBANDS_6_1, WIND_8_SUBBANDS_5_1,
+     WIND_8_SUBBANDS_4_1, WIND_8_SUBBANDS_3_1, WIND_8_SUBBANDS_2_1,
+     WIND_8_SUBBANDS_1_1},
+    {-WIND_8_SUBBANDS_0_1, WIND_8_SUBBANDS_1_4, WIND_8_SUBBANDS_2_4,
+     WIND_8_SUBBANDS_3_4, WIND_8_SUBBANDS_4_4, WIND_8_SUBBANDS_5_4,
+     WIND_8_SUBBANDS_6_4, WIND_8_SUBBANDS_7_4, WIND_8_SUBBANDS_8_0,
+     WIND_8_SUBBANDS_7_0, WIND_8_SUBBANDS_6_0, WIND_8_SUBBANDS_5_0,
+     WIND_8_SUBBANDS_4_0, WIND_8_SUBBANDS_3_0, WIND_8_SUBBANDS_2_0,
+     WIND_8_SUBBANDS_1_0},
+};
+
+typedef void (*tSBC_WINDOW_ACCU)(const int16_t* ps16X, int32_t* ps32Y);
+
+static void SbcWindowAccu4Scalar(const int16_t* ps16X, int32_t* ps32Y) {
+  int32_t k, j, s32Temp;
+  for (k = 0; k < 8; k++) {
+    s32Temp = 0;
+    for (j = 0; j < 5; j++)
+      s32Temp += (int32_t)as16Window4[j][k] * (int32_t)ps16X[j * 8 + k];
+    ps32Y[k] = s32Temp;
+  }
+}
+
+static void SbcWindowAccu8Scalar(const int16_t* ps16X, int32_t* ps32Y) {
+  int32_t k, j, s32Temp;
+  for (k = 0; k < 16; k++) {
+    s32Temp = 0;
+    for (j = 0; j < 5; j++)
+      s32Temp += (int32_t)as16Window8[j][k] * (int32_t)ps16X[j * 16 + k];
+    ps32Y[k] = s32Temp;
+  }
+}
+
+#if defined(__SSE2__)
+/* Accumulate the 32 bits products of 8 samples and coefficients, formed from
+ * their low and high 16 bits halves */
+#define SBC_SSE2_MULT_ACCU(x, w, lo, hi)                                     \
+  {                                                                          \
+    __m128i s128ProdLo = _mm_mullo_epi16(x, w);                              \
+    __m128i s128ProdHi = _mm_mulhi_epi16(x, w);                              \
+    lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(s128ProdLo, s128ProdHi));      \
+    hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(s128ProdLo, s128ProdHi));      \
+  }
+
+static void SbcWindowAccu4Sse2(const int16_t* ps16X, int32_t* ps32Y) {
+  __m128i s128Lo = _mm_setzero_si128();
+  __m128i s128Hi = _mm_setzero_si128();
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    __m128i s128X = _mm_loadu_si128((const __m128i*)(ps16X + j * 8));
+    __m128i s128W = _mm_loadu_si128((const __m128i*)as16Window4[j]);
+    SBC_SSE2_MULT_ACCU(s128X, s128W, s128Lo, s128Hi);
+  }
+  _mm_storeu_si128((__m128i*)ps32Y, s128Lo);
+  _mm_storeu_si128((__m128i*)(ps32Y + 4), s128Hi);
+}
+
+static void SbcWindowAccu8Sse2(const int16_t* ps16X, int32_t* ps32Y) {
+  __m128i s128Lo = _mm_setzero_si128();
+  __m128i s128Hi = _mm_setzero_si128();
+  __m128i s128Lo2 = _mm_setzero_si128();
+  __m128i s128Hi2 = _mm_setzero_si128();
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    __m128i s128X = _mm_loadu_si128((const __m128i*)(ps16X + j * 16));
+    __m128i s128X2 = _mm_loadu_si128((const __m128i*)(ps16X + j * 16 + 8));
+    __m128i s128W = _mm_loadu_si128((const __m128i*)as16Window8[j]);
+    __m128i s128W2 = _mm_loadu_si128((const __m128i*)(as16Window8[j] + 8));
+    SBC_SSE2_MULT_ACCU(s128X, s128W, s128Lo, s128Hi);
+    SBC_SSE2_MULT_ACCU(s128X2, s128W2, s128Lo2, s128Hi2);
+  }
+  _mm_storeu_si128((__m128i*)ps32Y, s128Lo);
+  _mm_storeu_si128((__m128i*)(ps32Y + 4), s128Hi);
+  _mm_storeu_si128((__m128i*)(ps32Y + 8), s128Lo2);
+  _mm_storeu_si128((__m128i*)(ps32Y + 12), s128Hi2);
+}
+
+/* The 4 subbands windowing is too narrow for the AVX2 registers, it keeps
+ * using SSE2 */
+__attribute__((target("avx2"))) static void SbcWindowAccu8Avx2(
+    const int16_t* ps16X, int32_t* ps32Y) {
+  __m256i s256Lo = _mm256_setzero_si256();
+  __m256i s256Hi = _mm256_setzero_si256();
+  int32_t j;
+  for (j = 0; j < 5; j++) {
+    __m256i s256X = _mm256_loadu_si256((const __m256i*)(ps16X + j * 16));
+    __m256i s256W = _mm256_loadu_si256((const __m256i*)as16Window8[j]);
+    __m256i s256ProdLo = _mm256_mullo_epi16(s256X, s256W);
+    __m256i s256ProdHi = _mm256_mulhi_epi16(s256X, s256W);
+    /* Unpacking works on each 128 bits lane: s256Lo holds the sums for k in
+     * 0..3 and 8..11, s256Hi for k in 4..7 and 12..15 */
+    s256Lo =
+        _mm256_add_epi32(s256Lo, _mm256_unpacklo_epi16(s256ProdLo, s256ProdHi));
+    s256Hi =
+        _mm256_add_epi32(s256Hi, _mm256_unpackhi_epi16(s256ProdLo, s256ProdHi));
+  }
+  _mm256_storeu_si256((__m256i*)ps32Y,
+                      _mm256_permute2x128_si256(s256Lo, s256Hi, 0x20));
+  _mm256_storeu_si256((__m256i*)(ps32Y + 8),
+                      _mm256_permute2x128_si256(s256Lo, s256Hi, 0x31));
+}
+#endif /* __SSE2__ */
+
+#if defined(__ARM_NEON)
+static void SbcWindowAccu4Neon(const int16_t* ps16X, int32_t* ps32Y) {
+  int32x4_t s128Lo = vmull_s16(vld1_s16(ps16X), vld1_s16(as16Window4[0]));
+  int32x4_t s128Hi =
+      vmull_s16(vld1_s16(ps16X + 4), vld1_s16(as16Window4[0] + 4));
+  int32_t j;
+  for (j = 1; j < 5; j++) {
+    s128Lo = vmlal_s16(s128Lo, vld1_s16(ps16X + j * 8),
+                       vld1_s16(as16Window4[j]));
+    s128Hi = vmlal_s16(s128Hi, vld1_s16(ps16X + j * 8 + 4),
+                       vld1_s16(as16Window4[j] + 4));
+  }
+  vst1q_s32(ps32Y, s128Lo);
+  vst1q_s32(ps32Y + 4, s128Hi);
+}
+
+static void SbcWindowAccu8Neon(const int16_t* ps16X, int32_t* ps32Y) {
+  int32x4_t as128Y[4];
+  int32_t i, j;
+  for (i = 0; i < 4; i++) {
+    as128Y[i] =
+        vmull_s16(vld1_s16(ps16X + i * 4), vld1_s16(as16Window8[0] + i * 4));
+  }
+  for (j = 1; j < 5; j++) {
+    for (i = 0; i < 4; i++) {
+      as128Y[i] = vmlal_s16(as128Y[i], vld1_s16(ps16X + j * 16 + i * 4),
+                            vld1_s16(as16Window8[j] + i * 4));
+    }
+  }
+  for (i = 0; i < 4; i++) vst1q_s32(ps32Y + i * 4, as128Y[i]);
+}
+#endif /* __ARM_NEON */
+
+static tSBC_WINDOW_ACCU SbcWindowAccu4 = NULL;
+static tSBC_WINDOW_ACCU SbcWindowAccu8 = NULL;
+
+bool SBC_Encoder_UseWindowAccu(uint8_t impl) {
+  switch (impl) {
+    case SBC_WINDOW_ACCU_SCALAR:
+      SbcWindowAccu4 = SbcWindowAccu4Scalar;
+      SbcWindowAccu8 = SbcWindowAccu8Scalar;
+      return true;
+#if defined(__SSE2__)
+    case SBC_WINDOW_ACCU_SSE2:
+      SbcWindowAccu4 = SbcWindowAccu4Sse2;
+      SbcWindowAccu8 = SbcWindowAccu8Sse2;
+      return true;
+    case SBC_WINDOW_ACCU_AVX2:
+      if (!__builtin_cpu_supports("avx2")) return false;
+      SbcWindowAccu4 = SbcWindowAccu4Sse2;
+      SbcWindowAccu8 = SbcWindowAccu8Avx2;
+      return true;
+#endif
+#if defined(__ARM_NEON)
+    case SBC_WINDOW_ACCU_NEON:
+      SbcWindowAccu4 = SbcWindowAccu4Neon;
+      SbcWindowAccu8 = SbcWindowAccu8Neon;
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+/* Select the fastest windowing supported by the CPU, unless one was chosen
+ * with SBC_Encoder_UseWindowAccu */
+static void SbcWindowAccuInit(void) {
+  if (SbcWindowAccu8 != NULL) return;
+  if (SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_AVX2)) return;
+  if (SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_SSE2)) return;
+  if (SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_NEON)) return;
+  SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_SCALAR);
+}
+#else
+bool SBC_Encoder_UseWindowAccu(uint8_t impl) {
+  return impl == SBC_WINDOW_ACCU_SCALAR;
+}
+#endif /* SBC_WINDOW_ACCU_DISPATCH */
+
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
 /****************************************************************************
@@ -1257,7 +1496,11 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
+#if (SBC_WINDOW_ACCU_DISPATCH == TRUE)
+      SbcWindowAccu4(s16X + ChOffset, s32DCTY);
+#else
       WINDOW_PARTIAL_4
+#endif
 
       SBC_FastIDCT4(s32DCTY, ps32SbBuf);
 
@@ -1370,7 +1613,11 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
+#if (SBC_WINDOW_ACCU_DISPATCH == TRUE)
+      SbcWindowAccu8(s16X + ChOffset, s32DCTY);
+#else
       WINDOW_PARTIAL_8
+#endif
 
       SBC_FastIDCT8(s32DCTY, ps32SbBuf);
 
@@ -1397,4 +1644,7 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 void SbcAnalysisInit(void) {
   memset(s16X, 0, ENC_VX_BUFFER_SIZE * sizeof(int16_t));
   ShiftCounter = 0;
+#if (SBC_WINDOW_ACCU_DISPATCH == TRUE)
+  SbcWindowAccuInit();
+#endif
 }
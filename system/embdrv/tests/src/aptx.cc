@@ -22,11 +22,47 @@
 
 #include <fstream>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "aptXbtenc.h"
 
 #define BYTES_PER_CODEWORD 16
 
+// Encode with a fresh encoder full scale noise, then low level noise, then a
+// full scale square wave, to go through all the quantisation codes.
+static std::vector<uint16_t> encode_test_signal() {
+  void* encoder = malloc(SizeofAptxbtenc());
+  aptxbtenc_init(encoder, 0);
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> full_scale(INT16_MIN, INT16_MAX);
+  std::uniform_int_distribution<int32_t> low_level(-100, 100);
+  std::vector<uint16_t> codewords;
+  for (size_t i = 0; i < 3 * 4096; i++) {
+    int32_t pcmL[4];
+    int32_t pcmR[4];
+    for (size_t j = 0; j < 4; j++) {
+      switch (i / 4096) {
+        case 0:
+          pcmL[j] = full_scale(generator);
+          break;
+        case 1:
+          pcmL[j] = low_level(generator);
+          break;
+        default:
+          pcmL[j] = (i / 8) % 2 ? INT16_MAX : INT16_MIN;
+          break;
+      }
+      pcmR[j] = full_scale(generator);
+    }
+    uint16_t codeword[2];
+    aptxbtenc_encodestereo(encoder, pcmL, pcmR, codeword);
+    codewords.insert(codewords.end(), codeword, codeword + 2);
+  }
+  free(encoder);
+  return codewords;
+}
+
 class LibAptxEncTest : public ::testing::Test {
  private:
   void* aptxbtenc = nullptr;
@@ -38,7 +74,10 @@ class LibAptxEncTest : public ::testing::Test {
     ASSERT_EQ(aptxbtenc_init(aptxbtenc, 0), 0);
   }
 
-  void TearDown() override { free(aptxbtenc); }
+  void TearDown() override {
+    free(aptxbtenc);
+    aptxbtenc_use_kernels(APTXBTENC_KERNELS_SCALAR);
+  }
 
   void codeword_cmp(const uint16_t pcm[8], const uint32_t codeword) {
     uint32_t pcmL[4];
@@ -75,3 +114,17 @@ TEST_F(LibAptxEncTest, encode_fake_data) {
     ++idx;
   }
 }
+
+TEST_F(LibAptxEncTest, vectorized_kernels_are_bit_exact) {
+  ASSERT_EQ(aptxbtenc_use_kernels(APTXBTENC_KERNELS_SCALAR), 0);
+  std::vector<uint16_t> reference = encode_test_signal();
+
+  for (int kernels : {APTXBTENC_KERNELS_SSE4_2, APTXBTENC_KERNELS_NEON}) {
+    if (aptxbtenc_use_kernels(kernels) != 0) continue;
+    EXPECT_EQ(encode_test_signal(), reference) << "kernels " << kernels;
+  }
+}
+
+TEST_F(LibAptxEncTest, unknown_kernels_are_rejected) {
+  ASSERT_NE(aptxbtenc_use_kernels(-1), 0);
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+
+#include <random>
+
+#include "aptXHDbtenc.h"
+#include "aptXbtenc.h"
+
+using ::benchmark::State;
+
+// Number of codewords encoded per iteration, 8 ms of audio at 48 kHz
+static constexpr size_t kCodewords = 96;
+
+// Encode 16 bits stereo audio with each implementation of the kernels.
+static void BM_AptxEncode(State& state) {
+  if (aptxbtenc_use_kernels(state.range(0)) != 0) {
+    state.SkipWithError("kernels not supported");
+    return;
+  }
+
+  void* encoder = malloc(SizeofAptxbtenc());
+  aptxbtenc_init(encoder, 0);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> sample(INT16_MIN, INT16_MAX);
+  int32_t pcmL[kCodewords][4];
+  int32_t pcmR[kCodewords][4];
+  for (size_t i = 0; i < kCodewords; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      pcmL[i][j] = sample(generator);
+      pcmR[i][j] = sample(generator);
+    }
+  }
+  uint16_t codeword[2];
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < kCodewords; i++) {
+      aptxbtenc_encodestereo(encoder, pcmL[i], pcmR[i], codeword);
+      benchmark::DoNotOptimize(codeword);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kCodewords);
+  free(encoder);
+  aptxbtenc_use_kernels(APTXBTENC_KERNELS_SCALAR);
+}
+
+BENCHMARK(BM_AptxEncode)
+    ->ArgName("kernels")
+    ->Arg(APTXBTENC_KERNELS_SCALAR)
+    ->Arg(APTXBTENC_KERNELS_SSE4_2)
+    ->Arg(APTXBTENC_KERNELS_NEON);
+
+// Encode 24 bits stereo audio, the filters and the larger quantisation
+// tables of aptX HD doubling the load of aptX.
+static void BM_AptxHdEncode(State& state) {
+  if (aptxhdbtenc_use_kernels(state.range(0)) != 0) {
+    state.SkipWithError("kernels not supported");
+    return;
+  }
+
+  void* encoder = malloc(SizeofAptxhdbtenc());
+  aptxhdbtenc_init(encoder, 0);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> sample(-8388608, 8388607);
+  int32_t pcmL[kCodewords][4];
+  int32_t pcmR[kCodewords][4];
+  for (size_t i = 0; i < kCodewords; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      pcmL[i][j] = sample(generator);
+      pcmR[i][j] = sample(generator);
+    }
+  }
+  uint32_t codeword[2];
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < kCodewords; i++) {
+      aptxhdbtenc_encodestereo(encoder, pcmL[i], pcmR[i], codeword);
+      benchmark::DoNotOptimize(codeword);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kCodewords);
+  free(encoder);
+  aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_SCALAR);
+}
+
+BENCHMARK(BM_AptxHdEncode)
+    ->ArgName("kernels")
+    ->Arg(APTXHDBTENC_KERNELS_SCALAR)
+    ->Arg(APTXHDBTENC_KERNELS_SSE4_2)
+    ->Arg(APTXHDBTENC_KERNELS_NEON);
+
+BENCHMARK_MAIN();
@@ -22,11 +22,47 @@
 
 #include <fstream>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #include "aptXHDbtenc.h"
 
 #define BYTES_PER_CODEWORD 24
 
+// Encode with a fresh encoder full scale noise, then low level noise, then a
+// full scale square wave, to go through all the quantisation codes.
+static std::vector<uint32_t> encode_test_signal() {
+  void* encoder = malloc(SizeofAptxhdbtenc());
+  aptxhdbtenc_init(encoder, 0);
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> full_scale(-8388608, 8388607);
+  std::uniform_int_distribution<int32_t> low_level(-100, 100);
+  std::vector<uint32_t> codewords;
+  for (size_t i = 0; i < 3 * 4096; i++) {
+    int32_t pcmL[4];
+    int32_t pcmR[4];
+    for (size_t j = 0; j < 4; j++) {
+      switch (i / 4096) {
+        case 0:
+          pcmL[j] = full_scale(generator);
+          break;
+        case 1:
+          pcmL[j] = low_level(generator);
+          break;
+        default:
+          pcmL[j] = (i / 8) % 2 ? 8388607 : -8388608;
+          break;
+      }
+      pcmR[j] = full_scale(generator);
+    }
+    uint32_t codeword[2];
+    aptxhdbtenc_encodestereo(encoder, pcmL, pcmR, codeword);
+    codewords.insert(codewords.end(), codeword, codeword + 2);
+  }
+  free(encoder);
+  return codewords;
+}
+
 class LibAptxHdEncTest : public ::testing::Test {
  private:
  protected:
@@ -37,7 +73,10 @@ class LibAptxHdEncTest : public ::testing::Test {
     ASSERT_EQ(aptxhdbtenc_init(aptxhdbtenc, 0), 0);
   }
 
-  void TearDown() override { free(aptxhdbtenc); }
+  void TearDown() override {
+    free(aptxhdbtenc);
+    aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_SCALAR);
+  }
 
   void codeword_cmp(const uint8_t p[BYTES_PER_CODEWORD],
                     const uint32_t codeword[2]) {
@@ -78,3 +117,17 @@ TEST_F(LibAptxHdEncTest, encode_fake_data) {
     ++idx;
   }
 }
+
+TEST_F(LibAptxHdEncTest, vectorized_kernels_are_bit_exact) {
+  ASSERT_EQ(aptxhdbtenc_use_kernels(APTXHDBTENC_KERNELS_SCALAR), 0);
+  std::vector<uint32_t> reference = encode_test_signal();
+
+  for (int kernels : {APTXHDBTENC_KERNELS_SSE4_2, APTXHDBTENC_KERNELS_NEON}) {
+    if (aptxhdbtenc_use_kernels(kernels) != 0) continue;
+    EXPECT_EQ(encode_test_signal(), reference) << "kernels " << kernels;
+  }
+}
+
+TEST_F(LibAptxHdEncTest, unknown_kernels_are_rejected) {
+  ASSERT_NE(aptxhdbtenc_use_kernels(-1), 0);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "g722_enc_dec.h"
+
+namespace {
+
+// 10 ms of 16 kHz audio, the hearing aid frame
+constexpr int kFrameSamples = 160;
+constexpr int kNumFrames = 100;
+
+// Pseudo random audio for each frame, with a varying level so that the
+// encoder adapts its scale factors.
+std::vector<int16_t> generate_audio(unsigned seed, int shift) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  std::vector<int16_t> pcm(kFrameSamples * kNumFrames);
+  for (size_t i = 0; i < pcm.size(); i++) {
+    pcm[i] = sample(generator) >> ((i / kFrameSamples) % 8 + shift);
+  }
+  return pcm;
+}
+
+class G722EncodeStereoTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(G722EncodeStereoTest, bit_exact_with_mono_encode) {
+  std::vector<int16_t> left = generate_audio(1, GetParam());
+  std::vector<int16_t> right = generate_audio(2, GetParam());
+
+  g722_encode_state_t* mono_left = g722_encode_init(nullptr, 64000, G722_PACKED);
+  g722_encode_state_t* mono_right =
+      g722_encode_init(nullptr, 64000, G722_PACKED);
+  g722_encode_state_t* stereo_left =
+      g722_encode_init(nullptr, 64000, G722_PACKED);
+  g722_encode_state_t* stereo_right =
+      g722_encode_init(nullptr, 64000, G722_PACKED);
+
+  uint8_t expected_left[kFrameSamples / 2];
+  uint8_t expected_right[kFrameSamples / 2];
+  uint8_t encoded_left[kFrameSamples / 2];
+  uint8_t encoded_right[kFrameSamples / 2];
+  for (int i = 0; i < kNumFrames; i++) {
+    const int16_t* pcm_left = left.data() + i * kFrameSamples;
+    const int16_t* pcm_right = right.data() + i * kFrameSamples;
+    ASSERT_EQ(kFrameSamples / 2, g722_encode(mono_left, expected_left,
+                                             pcm_left, kFrameSamples));
+    ASSERT_EQ(kFrameSamples / 2, g722_encode(mono_right, expected_right,
+                                             pcm_right, kFrameSamples));
+
+    // Alternate with the mono encoder, the states stay interchangeable
+    if (i % 10 == 9) {
+      ASSERT_EQ(kFrameSamples / 2, g722_encode(stereo_left, encoded_left,
+                                               pcm_left, kFrameSamples));
+      ASSERT_EQ(kFrameSamples / 2, g722_encode(stereo_right, encoded_right,
+                                               pcm_right, kFrameSamples));
+    } else {
+      ASSERT_EQ(kFrameSamples / 2,
+                g722_encode_stereo(stereo_left, stereo_right, encoded_left,
+                                   encoded_right, pcm_left, pcm_right,
+                                   kFrameSamples));
+    }
+    ASSERT_EQ(0, memcmp(expected_left, encoded_left, sizeof(encoded_left)))
+        << "frame " << i;
+    ASSERT_EQ(0, memcmp(expected_right, encoded_right, sizeof(encoded_right)))
+        << "frame " << i;
+  }
+
+  g722_encode_release(mono_left);
+  g722_encode_release(mono_right);
+  g722_encode_release(stereo_left);
+  g722_encode_release(stereo_right);
+}
+
+// Full scale audio, and the 15 bits audio sent to the hearing aids
+INSTANTIATE_TEST_SUITE_P(G722EncodeStereo, G722EncodeStereoTest,
+                         ::testing::Values(0, 1));
+
+TEST(G722EncodeStereo, long_buffer) {
+  // More samples than the QMF filters at once
+  constexpr int kSamples = 1000;
+  std::vector<int16_t> left = generate_audio(3, 1);
+  std::vector<int16_t> right = generate_audio(4, 1);
+
+  g722_encode_state_t mono_left, mono_right, stereo_left, stereo_right;
+  g722_encode_init(&mono_left, 64000, G722_PACKED);
+  g722_encode_init(&mono_right, 64000, G722_PACKED);
+  g722_encode_init(&stereo_left, 64000, G722_PACKED);
+  g722_encode_init(&stereo_right, 64000, G722_PACKED);
+
+  std::vector<uint8_t> expected_left(kSamples / 2);
+  std::vector<uint8_t> expected_right(kSamples / 2);
+  std::vector<uint8_t> encoded_left(kSamples / 2);
+  std::vector<uint8_t> encoded_right(kSamples / 2);
+  g722_encode(&mono_left, expected_left.data(), left.data(), kSamples);
+  g722_encode(&mono_right, expected_right.data(), right.data(), kSamples);
+  ASSERT_EQ(kSamples / 2,
+            g722_encode_stereo(&stereo_left, &stereo_right,
+                               encoded_left.data(), encoded_right.data(),
+                               left.data(), right.data(), kSamples));
+  ASSERT_EQ(expected_left, encoded_left);
+  ASSERT_EQ(expected_right, encoded_right);
+}
+
+}  // namespace
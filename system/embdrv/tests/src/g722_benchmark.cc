@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+
+#include <random>
+
+#include "g722_enc_dec.h"
+
+using ::benchmark::State;
+
+// 10 ms of 16 kHz audio for each hearing aid of a binaural stream
+constexpr int kFrameSamples = 160;
+
+static void generate_audio(int16_t* left, int16_t* right) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  for (int i = 0; i < kFrameSamples; i++) {
+    left[i] = sample(generator) >> 1;
+    right[i] = sample(generator) >> 1;
+  }
+}
+
+static void BM_G722EncodeMono(State& state) {
+  int16_t left[kFrameSamples], right[kFrameSamples];
+  uint8_t encoded_left[kFrameSamples / 2], encoded_right[kFrameSamples / 2];
+  generate_audio(left, right);
+
+  g722_encode_state_t state_left, state_right;
+  g722_encode_init(&state_left, 64000, G722_PACKED);
+  g722_encode_init(&state_right, 64000, G722_PACKED);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        g722_encode(&state_left, encoded_left, left, kFrameSamples));
+    benchmark::DoNotOptimize(
+        g722_encode(&state_right, encoded_right, right, kFrameSamples));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_G722EncodeStereo(State& state) {
+  int16_t left[kFrameSamples], right[kFrameSamples];
+  uint8_t encoded_left[kFrameSamples / 2], encoded_right[kFrameSamples / 2];
+  generate_audio(left, right);
+
+  g722_encode_state_t state_left, state_right;
+  g722_encode_init(&state_left, 64000, G722_PACKED);
+  g722_encode_init(&state_right, 64000, G722_PACKED);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        g722_encode_stereo(&state_left, &state_right, encoded_left,
+                           encoded_right, left, right, kFrameSamples));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_G722EncodeMono);
+BENCHMARK(BM_G722EncodeStereo);
+
+BENCHMARK_MAIN();
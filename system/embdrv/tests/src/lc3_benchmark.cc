@@ -0,0 +1,165 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <lc3.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using ::benchmark::State;
+
+namespace {
+
+// Mono frames at 48 kHz, as encoded and decoded for each channel of the LE
+// Audio media configurations
+constexpr int kSampleRate = 48000;
+
+std::vector<int16_t> make_signal(int num_samples) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> noise(-512, 512);
+  std::vector<int16_t> pcm(num_samples);
+  for (int i = 0; i < num_samples; i++) {
+    pcm[i] = 8000 * std::sin(i * 0.05) + 3000 * std::sin(i * 0.71) +
+             noise(generator);
+  }
+  return pcm;
+}
+
+}  // namespace
+
+static void BM_Lc3Encode(State& state) {
+  int frame_us = state.range(0);
+  int frame_bytes = state.range(1);
+
+  std::vector<uint8_t> encoder_mem(lc3_encoder_size(frame_us, kSampleRate));
+  lc3_encoder_t encoder =
+      lc3_setup_encoder(frame_us, kSampleRate, 0, encoder_mem.data());
+  std::vector<int16_t> pcm =
+      make_signal(lc3_frame_samples(frame_us, kSampleRate));
+  std::vector<uint8_t> frame(frame_bytes);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lc3_encode(encoder, LC3_PCM_FORMAT_S16, pcm.data(),
+                                        1, frame_bytes, frame.data()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Encode the interleaved channels of a broadcast, 10 ms frames of 100 bytes
+// per channel, with the number of channels as argument
+static void BM_Lc3EncodeChannels(State& state) {
+  constexpr int kFrameUs = 10000;
+  constexpr int kFrameBytes = 100;
+  int num_channels = state.range(0);
+
+  std::vector<uint8_t> encoders_mem(
+      lc3_encoders_size(kFrameUs, kSampleRate, num_channels));
+  std::vector<lc3_encoder_t> encoders(num_channels);
+  lc3_setup_encoders(kFrameUs, kSampleRate, 0, num_channels,
+                     encoders_mem.data(), encoders.data());
+  std::vector<int16_t> pcm =
+      make_signal(num_channels * lc3_frame_samples(kFrameUs, kSampleRate));
+  std::vector<uint8_t> frames(num_channels * kFrameBytes);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        lc3_encode_channels(encoders.data(), num_channels, LC3_PCM_FORMAT_S16,
+                            pcm.data(), kFrameBytes, frames.data()));
+  }
+  state.SetItemsProcessed(state.iterations() * num_channels);
+}
+
+static void BM_Lc3Decode(State& state) {
+  int frame_us = state.range(0);
+  int frame_bytes = state.range(1);
+
+  std::vector<uint8_t> encoder_mem(lc3_encoder_size(frame_us, kSampleRate));
+  lc3_encoder_t encoder =
+      lc3_setup_encoder(frame_us, kSampleRate, 0, encoder_mem.data());
+  std::vector<int16_t> pcm =
+      make_signal(lc3_frame_samples(frame_us, kSampleRate));
+  std::vector<uint8_t> frame(frame_bytes);
+  lc3_encode(encoder, LC3_PCM_FORMAT_S16, pcm.data(), 1, frame_bytes,
+             frame.data());
+
+  std::vector<uint8_t> decoder_mem(lc3_decoder_size(frame_us, kSampleRate));
+  lc3_decoder_t decoder =
+      lc3_setup_decoder(frame_us, kSampleRate, 0, decoder_mem.data());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lc3_decode(decoder, frame.data(), frame_bytes,
+                                        LC3_PCM_FORMAT_S16, pcm.data(), 1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Decode or conceal (frame_bytes of 0) mono frames with a decoder instance per
+// benchmark thread, as for the concurrent microphone streams of a group
+static void BM_Lc3DecodeStreams(State& state) {
+  constexpr int kFrameUs = 10000;
+  int frame_bytes = state.range(0);
+
+  std::vector<uint8_t> encoder_mem(lc3_encoder_size(kFrameUs, kSampleRate));
+  lc3_encoder_t encoder =
+      lc3_setup_encoder(kFrameUs, kSampleRate, 0, encoder_mem.data());
+  std::vector<int16_t> pcm =
+      make_signal(lc3_frame_samples(kFrameUs, kSampleRate));
+  std::vector<uint8_t> frame(100);
+  lc3_encode(encoder, LC3_PCM_FORMAT_S16, pcm.data(), 1, frame.size(),
+             frame.data());
+
+  std::vector<uint8_t> decoder_mem(lc3_decoder_size(kFrameUs, kSampleRate));
+  lc3_decoder_t decoder =
+      lc3_setup_decoder(kFrameUs, kSampleRate, 0, decoder_mem.data());
+  const uint8_t* in = frame_bytes ? frame.data() : nullptr;
+
+  // A good frame first, so that the concealment has a spectrum to work on
+  lc3_decode(decoder, frame.data(), frame.size(), LC3_PCM_FORMAT_S16,
+             pcm.data(), 1);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lc3_decode(decoder, in, frame_bytes,
+                                        LC3_PCM_FORMAT_S16, pcm.data(), 1));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Lc3Encode)
+    ->ArgNames({"frame_us", "frame_bytes"})
+    ->Args({7500, 75})
+    ->Args({10000, 100})
+    ->Args({10000, 120});
+
+BENCHMARK(BM_Lc3EncodeChannels)->ArgName("channels")->Arg(2)->Arg(4);
+
+BENCHMARK(BM_Lc3Decode)
+    ->ArgNames({"frame_us", "frame_bytes"})
+    ->Args({7500, 75})
+    ->Args({10000, 100})
+    ->Args({10000, 120});
+
+BENCHMARK(BM_Lc3DecodeStreams)
+    ->ArgName("frame_bytes")
+    ->Arg(100)
+    ->Arg(0)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(4)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "sbc_encoder.h"
+
+namespace {
+
+constexpr int kNumFrames = 64;
+
+// Encode the same pseudo random audio with every configuration.
+std::vector<uint8_t> encode_all_configurations() {
+  std::vector<uint8_t> encoded;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  int16_t pcm[SBC_MAX_PCM_BUFFER_SIZE];
+  uint8_t frame[512];
+
+  for (int16_t subbands : {4, 8}) {
+    for (int16_t blocks : {SBC_BLOCK_0, SBC_BLOCK_1, SBC_BLOCK_2, SBC_BLOCK_3}) {
+      for (int16_t mode : {SBC_MONO, SBC_DUAL, SBC_STEREO, SBC_JOINT_STEREO}) {
+        SBC_ENC_PARAMS params;
+        memset(&params, 0, sizeof(params));
+        params.s16SamplingFreq = SBC_sf44100;
+        params.s16ChannelMode = mode;
+        params.s16NumOfSubBands = subbands;
+        params.s16NumOfBlocks = blocks;
+        params.s16AllocationMethod = SBC_LOUDNESS;
+        params.u16BitRate = 328;
+        params.Format = SBC_FORMAT_GENERAL;
+        SBC_Encoder_Init(&params);
+
+        for (int i = 0; i < kNumFrames; i++) {
+          // Vary the level so that the frames use different scale factors
+          for (int j = 0; j < subbands * blocks * params.s16NumOfChannels; j++) {
+            pcm[j] = sample(generator) >> (i % 8);
+          }
+          uint32_t length = SBC_Encode(&params, pcm, frame);
+          encoded.insert(encoded.end(), frame, frame + length);
+        }
+      }
+    }
+  }
+  return encoded;
+}
+
+class LibSbcEncTest : public ::testing::Test {
+ protected:
+  void TearDown() override { SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_SCALAR); }
+};
+
+TEST_F(LibSbcEncTest, vectorized_window_accu_is_bit_exact) {
+  ASSERT_TRUE(SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_SCALAR));
+  std::vector<uint8_t> reference = encode_all_configurations();
+  ASSERT_FALSE(reference.empty());
+
+  for (uint8_t impl :
+       {SBC_WINDOW_ACCU_SSE2, SBC_WINDOW_ACCU_AVX2, SBC_WINDOW_ACCU_NEON}) {
+    if (!SBC_Encoder_UseWindowAccu(impl)) continue;
+    EXPECT_EQ(encode_all_configurations(), reference)
+        << "windowing implementation " << static_cast<int>(impl);
+  }
+}
+
+TEST_F(LibSbcEncTest, unknown_window_accu_is_rejected) {
+  ASSERT_FALSE(SBC_Encoder_UseWindowAccu(0xff));
+}
+
+}  // namespace
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+// Encode 8 subbands and 16 blocks joint stereo frames, the A2DP configuration
+// used by most sinks, with each windowing implementation.
+static void BM_SbcEncode(State& state) {
+  if (!SBC_Encoder_UseWindowAccu(state.range(0))) {
+    state.SkipWithError("windowing implementation not supported");
+    return;
+  }
+
+  SBC_ENC_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = SBC_JOINT_STEREO;
+  params.s16NumOfSubBands = 8;
+  params.s16NumOfBlocks = SBC_BLOCK_3;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = 328;
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  int16_t pcm[SBC_MAX_PCM_BUFFER_SIZE];
+  for (auto& value : pcm) value = sample(generator);
+  uint8_t frame[512];
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(SBC_Encode(&params, pcm, frame));
+  }
+  state.SetItemsProcessed(state.iterations());
+  SBC_Encoder_UseWindowAccu(SBC_WINDOW_ACCU_SCALAR);
+}
+
+BENCHMARK(BM_SbcEncode)
+    ->ArgName("window_accu")
+    ->Arg(SBC_WINDOW_ACCU_SCALAR)
+    ->Arg(SBC_WINDOW_ACCU_SSE2)
+    ->Arg(SBC_WINDOW_ACCU_AVX2)
+    ->Arg(SBC_WINDOW_ACCU_NEON);
+
+BENCHMARK_MAIN();
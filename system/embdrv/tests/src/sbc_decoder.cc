@@ -0,0 +1,113 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_encoder.h"
+
+namespace {
+
+constexpr int kNumFrames = 64;
+constexpr int kMaxSamplesPerFrame = 16 * 8 * 2;
+
+// Encode pseudo random audio, loud enough for some samples to be clipped by
+// the decoder, with the 8 subbands configurations.
+std::vector<uint8_t> encode_8_subbands_configurations() {
+  std::vector<uint8_t> encoded;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  int16_t pcm[SBC_MAX_PCM_BUFFER_SIZE];
+  uint8_t frame[512];
+
+  for (int16_t blocks : {SBC_BLOCK_0, SBC_BLOCK_1, SBC_BLOCK_2, SBC_BLOCK_3}) {
+    for (int16_t mode : {SBC_MONO, SBC_DUAL, SBC_STEREO, SBC_JOINT_STEREO}) {
+      SBC_ENC_PARAMS params;
+      memset(&params, 0, sizeof(params));
+      params.s16SamplingFreq = SBC_sf44100;
+      params.s16ChannelMode = mode;
+      params.s16NumOfSubBands = 8;
+      params.s16NumOfBlocks = blocks;
+      params.s16AllocationMethod = SBC_LOUDNESS;
+      params.u16BitRate = 328;
+      params.Format = SBC_FORMAT_GENERAL;
+      SBC_Encoder_Init(&params);
+
+      for (int i = 0; i < kNumFrames; i++) {
+        for (int j = 0; j < 8 * blocks * params.s16NumOfChannels; j++) {
+          pcm[j] = sample(generator) >> (i % 8);
+        }
+        uint32_t length = SBC_Encode(&params, pcm, frame);
+        encoded.insert(encoded.end(), frame, frame + length);
+      }
+    }
+  }
+  return encoded;
+}
+
+std::vector<int16_t> decode(const std::vector<uint8_t>& encoded) {
+  std::vector<int16_t> decoded;
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  std::vector<uint32_t> context_data(
+      CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS));
+  EXPECT_EQ(OI_CODEC_SBC_DecoderReset(&context, context_data.data(),
+                                      context_data.size() * sizeof(uint32_t),
+                                      2, 2, FALSE),
+            OI_OK);
+
+  const OI_BYTE* data = encoded.data();
+  uint32_t bytes = encoded.size();
+  int16_t pcm[kMaxSamplesPerFrame];
+  while (bytes > 0) {
+    uint32_t pcm_bytes = sizeof(pcm);
+    OI_STATUS status =
+        OI_CODEC_SBC_DecodeFrame(&context, &data, &bytes, pcm, &pcm_bytes);
+    EXPECT_EQ(status, OI_OK);
+    if (!OI_SUCCESS(status)) break;
+    decoded.insert(decoded.end(), pcm, pcm + pcm_bytes / sizeof(int16_t));
+  }
+  return decoded;
+}
+
+class LibSbcDecTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_SCALAR);
+  }
+};
+
+TEST_F(LibSbcDecTest, vectorized_synth_window_is_bit_exact) {
+  std::vector<uint8_t> encoded = encode_8_subbands_configurations();
+  ASSERT_TRUE(OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_SCALAR));
+  std::vector<int16_t> reference = decode(encoded);
+  ASSERT_FALSE(reference.empty());
+
+  for (uint8_t impl : {SBC_SYNTH_WINDOW_AVX2, SBC_SYNTH_WINDOW_NEON}) {
+    if (!OI_CODEC_SBC_UseSynthWindow(impl)) continue;
+    EXPECT_EQ(decode(encoded), reference)
+        << "synthesis window implementation " << static_cast<int>(impl);
+  }
+}
+
+TEST_F(LibSbcDecTest, unknown_synth_window_is_rejected) {
+  ASSERT_FALSE(OI_CODEC_SBC_UseSynthWindow(0xff));
+}
+
+}  // namespace
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_encoder.h"
+
+using ::benchmark::State;
+
+// Decode 8 subbands and 16 blocks joint stereo frames, the A2DP configuration
+// used by most sources, with each synthesis window implementation.
+static void BM_SbcDecode(State& state) {
+  if (!OI_CODEC_SBC_UseSynthWindow(state.range(0))) {
+    state.SkipWithError("synthesis window implementation not supported");
+    return;
+  }
+
+  SBC_ENC_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = SBC_JOINT_STEREO;
+  params.s16NumOfSubBands = 8;
+  params.s16NumOfBlocks = SBC_BLOCK_3;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = 328;
+  params.Format = SBC_FORMAT_GENERAL;
+  SBC_Encoder_Init(&params);
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> sample(INT16_MIN, INT16_MAX);
+  int16_t pcm[SBC_MAX_PCM_BUFFER_SIZE];
+  for (auto& value : pcm) value = sample(generator);
+  uint8_t frame[512];
+  uint32_t frame_length = SBC_Encode(&params, pcm, frame);
+
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  std::vector<uint32_t> context_data(
+      CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS));
+  OI_CODEC_SBC_DecoderReset(&context, context_data.data(),
+                            context_data.size() * sizeof(uint32_t), 2, 2,
+                            FALSE);
+
+  for (auto _ : state) {
+    const OI_BYTE* data = frame;
+    uint32_t bytes = frame_length;
+    uint32_t pcm_bytes = sizeof(pcm);
+    benchmark::DoNotOptimize(
+        OI_CODEC_SBC_DecodeFrame(&context, &data, &bytes, pcm, &pcm_bytes));
+  }
+  state.SetItemsProcessed(state.iterations());
+  OI_CODEC_SBC_UseSynthWindow(SBC_SYNTH_WINDOW_SCALAR);
+}
+
+BENCHMARK(BM_SbcDecode)
+    ->ArgName("synth_window")
+    ->Arg(SBC_SYNTH_WINDOW_SCALAR)
+    ->Arg(SBC_SYNTH_WINDOW_AVX2)
+    ->Arg(SBC_SYNTH_WINDOW_NEON);
+
+BENCHMARK_MAIN();
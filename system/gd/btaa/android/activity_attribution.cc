@@ -45,7 +45,7 @@ const ModuleFactory ActivityAttribution::Factory = ModuleFactory([]() { return n
 static const std::string kBtWakelockName("hal_bluetooth_lock");
 static const std::string kBtWakeupReason("hs_uart_wakeup");
 static const std::string kSuspendService("suspend_control");
-static const size_t kHciAclHeaderSize = 4;
+static const size_t kHciDataHeaderSize = 2;
 
 static std::mutex g_module_mutex;
 static ActivityAttribution* g_module = nullptr;
@@ -141,6 +141,10 @@ struct ActivityAttribution::impl {
     attribution_processor_.OnBtaaPackets(std::move(hci_processor_.OnHciPacket(std::move(packet), type, length)));
   }
 
+  void on_data_packets() {
+    attribution_processor_.OnBtaaPackets(std::move(hci_processor_.OnDataPackets(&data_packet_aggregator_)));
+  }
+
   void on_wakelock_acquired() {
     wakelock_processor_.OnWakelockAcquired();
   }
@@ -148,6 +152,7 @@ struct ActivityAttribution::impl {
   void on_wakelock_released() {
     uint32_t wakelock_duration_ms = 0;
 
+    on_data_packets();
     wakelock_duration_ms = wakelock_processor_.OnWakelockReleased();
     if (wakelock_duration_ms != 0) {
       attribution_processor_.OnWakelockReleased(wakelock_duration_ms);
@@ -155,6 +160,8 @@ struct ActivityAttribution::impl {
   }
 
   void on_wakeup() {
+    // The data packets received before the wakeup did not cause it
+    on_data_packets();
     attribution_processor_.OnWakeup();
   }
 
@@ -168,37 +175,42 @@ struct ActivityAttribution::impl {
 
   void Dump(
       std::promise<flatbuffers::Offset<ActivityAttributionData>> promise, flatbuffers::FlatBufferBuilder* fb_builder) {
+    on_data_packets();
     attribution_processor_.Dump(std::move(promise), fb_builder);
   }
 
   ActivityAttributionCallback* callback_;
   AttributionProcessor attribution_processor_;
   HciProcessor hci_processor_;
+  DataPacketAggregator data_packet_aggregator_;
   WakelockProcessor wakelock_processor_;
 };
 
 void ActivityAttribution::Capture(const hal::HciPacket& packet, hal::SnoopLogger::PacketType type) {
   uint16_t original_length = packet.size();
-  uint16_t truncate_length;
+  if (!original_length) {
+    return;
+  }
 
   switch (type) {
     case hal::SnoopLogger::PacketType::CMD:
     case hal::SnoopLogger::PacketType::EVT:
-      truncate_length = packet.size();
+      CallOn(pimpl_.get(), &impl::on_hci_packet, packet, type, original_length);
       break;
     case hal::SnoopLogger::PacketType::ACL:
     case hal::SnoopLogger::PacketType::SCO:
-    case hal::SnoopLogger::PacketType::ISO:
-      truncate_length = kHciAclHeaderSize;
+    case hal::SnoopLogger::PacketType::ISO: {
+      if (packet.size() < kHciDataHeaderSize) {
+        return;
+      }
+      // Data packets are only counted per connection handle here, and attributed in batches on the module handler.
+      uint16_t connection_handle = (packet[0] | (packet[1] << 8)) & 0xfff;
+      if (pimpl_->data_packet_aggregator_.OnDataPacket(type, connection_handle, original_length)) {
+        CallOn(pimpl_.get(), &impl::on_data_packets);
+      }
       break;
+    }
   }
-
-  if (!truncate_length) {
-    return;
-  }
-
-  hal::HciPacket truncate_packet(packet.begin(), packet.begin() + truncate_length);
-  CallOn(pimpl_.get(), &impl::on_hci_packet, truncate_packet, type, original_length);
 }
 
 void ActivityAttribution::OnWakelockAcquired() {
@@ -38,7 +38,7 @@ struct AddressActivityKey {
 struct AddressActivityKeyHasher {
   std::size_t operator()(const AddressActivityKey& key) const {
     return (
-        (std::hash<std::string>()(key.address.ToString()) ^
+        (std::hash<hci::Address>()(key.address) ^
          (std::hash<unsigned char>()(static_cast<unsigned char>(key.activity)))));
   }
 };
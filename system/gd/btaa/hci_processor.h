@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
+
 #include "btaa/activity_attribution.h"
 #include "btaa/cmd_evt_classification.h"
 #include "hal/snoop_logger.h"
@@ -27,10 +31,10 @@ namespace activity_attribution {
 struct BtaaHciPacket {
   Activity activity;
   hci::Address address;
-  uint16_t byte_count;
+  uint32_t byte_count;
 
   BtaaHciPacket() {}
-  BtaaHciPacket(Activity activity, hci::Address address, uint16_t byte_count)
+  BtaaHciPacket(Activity activity, hci::Address address, uint32_t byte_count)
       : activity(activity), address(address), byte_count(byte_count) {}
 };
 
@@ -42,6 +46,31 @@ class DeviceParser {
   std::map<uint16_t, hci::Address> connection_lookup_table_;
 };
 
+// Byte counts of the ACL, SCO and ISO packets per connection handle, written from the HCI thread without locking
+// and drained into BtaaHciPackets by the HciProcessor in the background.
+class DataPacketAggregator {
+ public:
+  static constexpr size_t kNumHandles = 0x1000;
+
+  // Adds |byte_count| to |connection_handle|, returns true if the aggregator was empty and has to be drained.
+  bool OnDataPacket(hal::SnoopLogger::PacketType type, uint16_t connection_handle, uint16_t byte_count);
+
+  // Calls |on_handle| with the activity and byte count of each handle counted since the previous drain.
+  void Drain(const std::function<void(uint16_t, Activity, uint32_t)>& on_handle);
+
+ private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  struct Entry {
+    std::atomic<uint32_t> byte_count{0};
+    std::atomic<Activity> activity{Activity::UNKNOWN};
+  };
+
+  std::array<Entry, kNumHandles> entries_;
+  std::array<std::atomic<uint64_t>, kNumHandles / kBitsPerWord> dirty_{};
+  std::atomic<bool> pending_{false};
+};
+
 struct PendingCommand {
   hci::OpCode opcode;
   BtaaHciPacket btaa_hci_packet;
@@ -50,6 +79,7 @@ struct PendingCommand {
 class HciProcessor {
  public:
   std::vector<BtaaHciPacket> OnHciPacket(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length);
+  std::vector<BtaaHciPacket> OnDataPackets(DataPacketAggregator* aggregator);
 
  private:
   void process_le_event(std::vector<BtaaHciPacket>& btaa_hci_packets, int16_t byte_count, hci::EventView& event);
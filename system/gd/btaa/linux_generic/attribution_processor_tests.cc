@@ -83,3 +83,28 @@ TEST_F(AttributionProcessorTest, UAFInOnWakelockReleasedRegressionTest) {
   pAttProc->OnBtaaPackets(btaaPackets);
   pAttProc->OnWakelockReleased(100);
 }
+
+TEST(DataPacketAggregatorTest, DrainsByteCountsPerHandle) {
+  DataPacketAggregator aggregator;
+
+  EXPECT_TRUE(aggregator.OnDataPacket(bluetooth::hal::SnoopLogger::PacketType::ACL, 0x0001, 100));
+  EXPECT_FALSE(aggregator.OnDataPacket(bluetooth::hal::SnoopLogger::PacketType::ACL, 0x0001, 50));
+  EXPECT_FALSE(aggregator.OnDataPacket(bluetooth::hal::SnoopLogger::PacketType::SCO, 0x0080, 60));
+  EXPECT_FALSE(aggregator.OnDataPacket(bluetooth::hal::SnoopLogger::PacketType::ISO, 0x0eff, 10));
+
+  std::vector<BtaaHciPacket> packets = HciProcessor().OnDataPackets(&aggregator);
+  ASSERT_EQ(3u, packets.size());
+  EXPECT_EQ(Activity::ACL, packets[0].activity);
+  EXPECT_EQ(150u, packets[0].byte_count);
+  EXPECT_EQ(Activity::HFP, packets[1].activity);
+  EXPECT_EQ(60u, packets[1].byte_count);
+  EXPECT_EQ(Activity::ISO, packets[2].activity);
+  EXPECT_EQ(10u, packets[2].byte_count);
+
+  // Empty until the next packet, which schedules the next drain
+  EXPECT_TRUE(HciProcessor().OnDataPackets(&aggregator).empty());
+  EXPECT_TRUE(aggregator.OnDataPacket(bluetooth::hal::SnoopLogger::PacketType::ACL, 0x0001, 20));
+  packets = HciProcessor().OnDataPackets(&aggregator);
+  ASSERT_EQ(1u, packets.size());
+  EXPECT_EQ(20u, packets[0].byte_count);
+}
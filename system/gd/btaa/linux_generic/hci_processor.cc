@@ -31,6 +31,45 @@ void DeviceParser::match_handle_with_address(uint16_t connection_handle, hci::Ad
   }
 }
 
+bool DataPacketAggregator::OnDataPacket(
+    hal::SnoopLogger::PacketType type, uint16_t connection_handle, uint16_t byte_count) {
+  Activity activity = Activity::ACL;
+  if (type == hal::SnoopLogger::PacketType::SCO) {
+    activity = Activity::HFP;
+  } else if (type == hal::SnoopLogger::PacketType::ISO) {
+    activity = Activity::ISO;
+  }
+
+  connection_handle &= kNumHandles - 1;
+  auto& entry = entries_[connection_handle];
+  entry.activity.store(activity, std::memory_order_relaxed);
+  entry.byte_count.fetch_add(byte_count, std::memory_order_relaxed);
+
+  uint64_t bit = 1ULL << (connection_handle % kBitsPerWord);
+  auto& word = dirty_[connection_handle / kBitsPerWord];
+  if ((word.load(std::memory_order_relaxed) & bit) == 0) {
+    word.fetch_or(bit, std::memory_order_release);
+  }
+  return !pending_.exchange(true, std::memory_order_acq_rel);
+}
+
+void DataPacketAggregator::Drain(const std::function<void(uint16_t, Activity, uint32_t)>& on_handle) {
+  // Cleared first, so that a packet counted during the drain schedules the next one.
+  pending_.store(false, std::memory_order_release);
+  for (size_t i = 0; i < dirty_.size(); i++) {
+    uint64_t word = dirty_[i].exchange(0, std::memory_order_acquire);
+    while (word) {
+      uint16_t connection_handle = i * kBitsPerWord + __builtin_ctzll(word);
+      word &= word - 1;
+      auto& entry = entries_[connection_handle];
+      uint32_t byte_count = entry.byte_count.exchange(0, std::memory_order_relaxed);
+      if (byte_count) {
+        on_handle(connection_handle, entry.activity.load(std::memory_order_relaxed), byte_count);
+      }
+    }
+  }
+}
+
 void HciProcessor::process_le_event(
     std::vector<BtaaHciPacket>& btaa_hci_packets, int16_t byte_count, hci::EventView& event) {
   uint16_t connection_handle_value = 0;
@@ -264,5 +303,15 @@ std::vector<BtaaHciPacket> HciProcessor::OnHciPacket(
   return btaa_hci_packets;
 }
 
+std::vector<BtaaHciPacket> HciProcessor::OnDataPackets(DataPacketAggregator* aggregator) {
+  std::vector<BtaaHciPacket> btaa_hci_packets;
+  aggregator->Drain([&](uint16_t connection_handle, Activity activity, uint32_t byte_count) {
+    hci::Address address_value;
+    device_parser_.match_handle_with_address(connection_handle, address_value);
+    btaa_hci_packets.push_back(BtaaHciPacket(activity, address_value, byte_count));
+  });
+  return btaa_hci_packets;
+}
+
 }  // namespace activity_attribution
 }  // namespace bluetooth
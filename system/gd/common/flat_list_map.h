@@ -0,0 +1,458 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+// A map that maintains the insertion order of its elements, with the same semantics as ListMap but without a list
+// node and a hash node allocated per element. An element that is put earlier will appear before an element that is put
+// later when iterating through this map's entries. Keys must be unique.
+//
+// Implementation:
+//   - the elements live in a slab of chunks of 8, 16, 32... entries, so that growing the map never moves an element;
+//     they are linked in order by pointers and the free entries are linked in a free list
+//   - keys are indexed by an open addressing hash table of at least twice the size, with linear probing and backward
+//     shift deletion, so that there are no tombstones
+//   - references and iterators to an element stay valid until the element is removed, as for ListMap, except that
+//     splice() from another map moves the element to this map
+//
+// Performance:
+//   - Key look-up and modification is O(1), an insertion allocates only when a chunk or the hash table grows
+//   - Memory consumption is O(capacity*(sizeof(K)+sizeof(V)+32) + 16*capacity), memory is released by clear() only
+//   - NOT THREAD SAFE
+//
+// Template:
+//   - Key key type
+//   - T value type
+//   - Hash hash function of the keys
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class FlatListMap {
+ private:
+  static constexpr size_t kFirstChunkBits = 3;
+
+  struct Entry;
+  template <bool kConst>
+  class Iterator;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  // different from c++17 node_type on purpose as we want node to be copyable
+  using node_type = std::pair<Key, T>;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructor of the list map, does not allocate
+  FlatListMap() = default;
+
+  // for move
+  FlatListMap(FlatListMap&& other) noexcept {
+    *this = std::move(other);
+  }
+  FlatListMap& operator=(FlatListMap&& other) noexcept {
+    if (&other == this) {
+      return *this;
+    }
+    chunks_ = std::move(other.chunks_);
+    buckets_ = std::move(other.buckets_);
+    shift_ = std::exchange(other.shift_, 64);
+    size_ = std::exchange(other.size_, 0);
+    allocated_ = std::exchange(other.allocated_, 0);
+    head_ = std::exchange(other.head_, nullptr);
+    tail_ = std::exchange(other.tail_, nullptr);
+    free_ = std::exchange(other.free_, nullptr);
+    other.chunks_.clear();
+    other.buckets_.clear();
+    return *this;
+  }
+
+  // copy-constructor, the copy is compacted in order
+  FlatListMap(const FlatListMap& other) {
+    for (const auto& node : other) {
+      try_emplace_back(node.first, node.second);
+    }
+  }
+
+  // copy-assignment
+  FlatListMap& operator=(const FlatListMap& other) {
+    if (&other != this) {
+      *this = FlatListMap(other);
+    }
+    return *this;
+  }
+
+  // comparison operators
+  bool operator==(const FlatListMap& rhs) const {
+    if (size_ != rhs.size_) {
+      return false;
+    }
+    for (auto lhs_iter = begin(), rhs_iter = rhs.begin(); lhs_iter != end(); ++lhs_iter, ++rhs_iter) {
+      if (*lhs_iter != *rhs_iter) {
+        return false;
+      }
+    }
+    return true;
+  }
+  bool operator!=(const FlatListMap& rhs) const {
+    return !(*this == rhs);
+  }
+
+  ~FlatListMap() = default;
+
+  // Clear the list map and release its memory
+  void clear() {
+    chunks_.clear();
+    buckets_.clear();
+    shift_ = 64;
+    size_ = 0;
+    allocated_ = 0;
+    head_ = nullptr;
+    tail_ = nullptr;
+    free_ = nullptr;
+  }
+
+  // const version of find()
+  const_iterator find(const Key& key) const {
+    return const_cast<FlatListMap*>(this)->find(key);
+  }
+
+  // Get the value of a key. Return iterator to the item if found, end() if not found
+  iterator find(const Key& key) {
+    if (size_ == 0) {
+      return end();
+    }
+    return iterator(this, buckets_[find_bucket(key, Hash{}(key))]);
+  }
+
+  // Check if key exist in the map. Return true if key exist in map, false if not.
+  bool contains(const Key& key) const {
+    return find(key) != end();
+  }
+
+  // Try emplace an element before a specific position |pos| of the list map. If the |key| already exists, does nothing.
+  // Moved arguments won't be moved when key already exists. Return <iterator, true> when key does not exist, <iterator,
+  // false> when key exist and iterator is the position where it was placed.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const_iterator pos, const Key& key, Args&&... args) {
+    size_t hash = Hash{}(key);
+    if (size_ != 0 && buckets_[find_bucket(key, hash)] != nullptr) {
+      return std::make_pair(end(), false);
+    }
+    Entry* inserted = emplace_before(pos.entry_, hash, key, std::forward<Args>(args)...);
+    return std::make_pair(iterator(this, inserted), true);
+  }
+
+  // Try emplace an element before the end of the list map. If the key already exists, does nothing. Moved arguments
+  // won't be moved when key already exists return <iterator, true> when key does not exist, <iterator, false> when key
+  // exist and iterator is the position where it was placed
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace_back(const Key& key, Args&&... args) {
+    return try_emplace(end(), key, std::forward<Args>(args)...);
+  }
+
+  // Put a key-value pair to the map before position. If key already exist, |pos| will be ignored and existing value
+  // will be replaced
+  void insert_or_assign(const_iterator pos, const Key& key, T value) {
+    size_t hash = Hash{}(key);
+    if (size_ != 0) {
+      Entry* existing = buckets_[find_bucket(key, hash)];
+      if (existing != nullptr) {
+        existing->value->second = std::move(value);
+        return;
+      }
+    }
+    emplace_before(pos.entry_, hash, key, std::move(value));
+  }
+
+  // Put a key-value pair to the tail of the map or replace the current value without moving the key if key exists
+  void insert_or_assign(const Key& key, T value) {
+    insert_or_assign(end(), key, std::move(value));
+  }
+
+  // STL splice, same as std::list::splice
+  // - pos: element before which the content will be inserted
+  // - other: another container to transfer the content from
+  // - it: the element to transfer from other to *this, moved to the slab of *this when other is another map
+  void splice(const_iterator pos, FlatListMap& other, const_iterator it) {
+    if (&other != this) {
+      size_t hash = it.entry_->hash;
+      node_type node = other.remove(it.entry_);
+      emplace_before(pos.entry_, hash, node.first, std::move(node.second));
+      return;
+    }
+    if (pos.entry_ == it.entry_) {
+      return;
+    }
+    unlink(it.entry_);
+    link_before(pos.entry_, it.entry_);
+  }
+
+  // Remove a key from the list map and return removed value if key exits, std::nullopt if not. The return value will be
+  // evaluated to true in a boolean context if a value is contained by std::optional, false otherwise.
+  std::optional<node_type> extract(const Key& key) {
+    if (size_ == 0) {
+      return std::nullopt;
+    }
+    Entry* removed = buckets_[find_bucket(key, Hash{}(key))];
+    if (removed == nullptr) {
+      return std::nullopt;
+    }
+    return remove(removed);
+  }
+
+  // Remove an iterator pointed item from the list map and return the iterator immediately after the erased item
+  iterator erase(const_iterator iter) {
+    Entry* next = iter.entry_->next;
+    remove(iter.entry_);
+    return iterator(this, next);
+  }
+
+  // Return size of the list map
+  inline size_t size() const {
+    return size_;
+  }
+
+  // Return iterator interface for begin
+  inline iterator begin() {
+    return iterator(this, head_);
+  }
+
+  // Iterator interface for begin, const
+  inline const_iterator begin() const {
+    return const_iterator(this, head_);
+  }
+
+  // Iterator interface for end
+  inline iterator end() {
+    return iterator(this, nullptr);
+  }
+
+  // Iterator interface for end, const
+  inline const_iterator end() const {
+    return const_iterator(this, nullptr);
+  }
+
+ private:
+  struct Entry {
+    std::optional<value_type> value;
+    size_t hash = 0;
+    // Previous and next elements, or the next free entry
+    Entry* prev = nullptr;
+    Entry* next = nullptr;
+  };
+
+  template <bool kConst>
+  class Iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::conditional_t<kConst, const FlatListMap::value_type, FlatListMap::value_type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using map_pointer = std::conditional_t<kConst, const FlatListMap*, FlatListMap*>;
+
+    Iterator() = default;
+    Iterator(map_pointer map, Entry* entry) : map_(map), entry_(entry) {}
+    // iterator to const_iterator
+    template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+    Iterator(const Iterator<kOtherConst>& other) : map_(other.map_), entry_(other.entry_) {}
+
+    reference operator*() const {
+      return *entry_->value;
+    }
+    pointer operator->() const {
+      return &*entry_->value;
+    }
+    Iterator& operator++() {
+      entry_ = entry_->next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator iter = *this;
+      ++*this;
+      return iter;
+    }
+    // Decrementing end() gives the last element, as for std::list
+    Iterator& operator--() {
+      entry_ = entry_ == nullptr ? map_->tail_ : entry_->prev;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator iter = *this;
+      --*this;
+      return iter;
+    }
+    bool operator==(const Iterator& rhs) const {
+      return entry_ == rhs.entry_;
+    }
+    bool operator!=(const Iterator& rhs) const {
+      return !(*this == rhs);
+    }
+
+   private:
+    friend class FlatListMap;
+    template <bool>
+    friend class Iterator;
+    map_pointer map_ = nullptr;
+    Entry* entry_ = nullptr;
+  };
+
+  // Fibonacci hashing, so that keys with a trivial hash, e.g. consecutive integers, don't cluster
+  size_t ideal_bucket(size_t hash) const {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ull) >> shift_);
+  }
+
+  // Return the bucket holding |key|, or the empty bucket where it would be inserted. The table must not be empty.
+  size_t find_bucket(const Key& key, size_t hash) const {
+    size_t mask = buckets_.size() - 1;
+    size_t bucket = ideal_bucket(hash);
+    while (buckets_[bucket] != nullptr) {
+      const Entry* candidate = buckets_[bucket];
+      if (candidate->hash == hash && candidate->value->first == key) {
+        break;
+      }
+      bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+  }
+
+  // Grow the hash table so that it stays at most half full with one more key
+  void reserve_bucket() {
+    if ((size_ + 1) * 2 <= buckets_.size()) {
+      return;
+    }
+    size_t num_buckets = buckets_.empty() ? 8 : buckets_.size() * 2;
+    buckets_.assign(num_buckets, nullptr);
+    shift_ = 64 - __builtin_ctzll(num_buckets);
+    for (Entry* existing = head_; existing != nullptr; existing = existing->next) {
+      buckets_[find_bucket(existing->value->first, existing->hash)] = existing;
+    }
+  }
+
+  static constexpr size_t chunk_size(size_t chunk) {
+    return size_t(1) << (kFirstChunkBits + chunk);
+  }
+
+  // Take an entry from the free list, or from the last chunk, allocating one twice the size of the previous one when
+  // it is full. Chunk k holds 8 * 2^k entries.
+  Entry* allocate_entry() {
+    if (free_ != nullptr) {
+      return std::exchange(free_, free_->next);
+    }
+    if (chunks_.empty() || allocated_ == chunk_size(chunks_.size() - 1)) {
+      chunks_.emplace_back(new Entry[chunk_size(chunks_.size())]);
+      allocated_ = 0;
+    }
+    return &chunks_.back()[allocated_++];
+  }
+
+  template <class... Args>
+  Entry* emplace_before(Entry* pos, size_t hash, const Key& key, Args&&... args) {
+    reserve_bucket();
+    Entry* inserted = allocate_entry();
+    inserted->value.emplace(
+        std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    inserted->hash = hash;
+    buckets_[find_bucket(key, hash)] = inserted;
+    link_before(pos, inserted);
+    size_++;
+    return inserted;
+  }
+
+  void unlink(Entry* linked) {
+    if (linked->prev != nullptr) {
+      linked->prev->next = linked->next;
+    } else {
+      head_ = linked->next;
+    }
+    if (linked->next != nullptr) {
+      linked->next->prev = linked->prev;
+    } else {
+      tail_ = linked->prev;
+    }
+  }
+
+  // Link |linked| before |pos|, nullptr being the end
+  void link_before(Entry* pos, Entry* linked) {
+    linked->next = pos;
+    linked->prev = pos != nullptr ? pos->prev : tail_;
+    if (linked->prev != nullptr) {
+      linked->prev->next = linked;
+    } else {
+      head_ = linked;
+    }
+    if (pos != nullptr) {
+      pos->prev = linked;
+    } else {
+      tail_ = linked;
+    }
+  }
+
+  node_type remove(Entry* removed) {
+    erase_bucket(find_bucket(removed->value->first, removed->hash));
+    unlink(removed);
+    node_type node(removed->value->first, std::move(removed->value->second));
+    removed->value.reset();
+    removed->prev = nullptr;
+    removed->next = free_;
+    free_ = removed;
+    size_--;
+    return node;
+  }
+
+  // Backward shift deletion: move the following entries of the probe sequence into the hole, when their ideal bucket
+  // is not between the hole and them
+  void erase_bucket(size_t hole) {
+    size_t mask = buckets_.size() - 1;
+    buckets_[hole] = nullptr;
+    for (size_t bucket = (hole + 1) & mask; buckets_[bucket] != nullptr; bucket = (bucket + 1) & mask) {
+      size_t ideal = ideal_bucket(buckets_[bucket]->hash);
+      if (((bucket - ideal) & mask) >= ((bucket - hole) & mask)) {
+        buckets_[hole] = buckets_[bucket];
+        buckets_[bucket] = nullptr;
+        hole = bucket;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Entry[]>> chunks_;
+  std::vector<Entry*> buckets_;
+  // log2 of the number of buckets, subtracted from 64
+  int shift_ = 64;
+  size_t size_ = 0;
+  // Entries taken from the last chunk so far, including the free ones
+  size_t allocated_ = 0;
+  // First and last elements, and first free entry
+  Entry* head_ = nullptr;
+  Entry* tail_ = nullptr;
+  Entry* free_ = nullptr;
+};
+
+}  // namespace common
+}  // namespace bluetooth
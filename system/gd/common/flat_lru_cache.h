@@ -0,0 +1,406 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+// A fixed capacity LRU map-cache that evicts the oldest item when reaching capacity, with the same semantics as
+// LruCache but no allocation after construction
+//
+// Usage:
+//   - keys are sorted from warmest to coldest
+//   - iterating through the cache won't warm up keys
+//   - operations on iterators won't warm up keys
+//   - find(), contains(), insert_or_assign(), try_emplace() will warm up the key
+//   - insert_or_assign() will evict coldest key when cache reaches capacity
+//   - NOT THREAD SAFE
+//
+// Implementation:
+//   - the items live in a slab of |capacity| entries allocated by the constructor, linked from warmest to coldest by
+//     indices, and the free entries are linked in a free list
+//   - keys are indexed by an open addressing hash table of at least twice the capacity, with linear probing and
+//     backward shift deletion, so that there are no tombstones
+//   - pointers and iterators to an item stay valid until the item is removed or evicted
+//
+// Performance:
+//   - Key look-up and modification is O(1), without allocation for keys and values that don't allocate themselves
+//   - Memory consumption is O(capacity*(sizeof(K)+sizeof(V)+24) + 8*capacity), whatever the size of the cache
+//
+// Template:
+//   - Key key type
+//   - T value type
+//   - Hash hash function of the keys
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class FlatLruCache {
+ private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  template <bool kConst>
+  class Iterator;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  using node_type = std::pair<Key, T>;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructor a LRU cache with |capacity|
+  explicit FlatLruCache(size_t capacity) : entries_(capacity) {
+    ASSERT_LOG(capacity != 0, "Unable to have 0 LRU Cache capacity");
+    ASSERT_LOG(capacity < kNone / 2, "LRU Cache capacity %zu is too large", capacity);
+    size_t num_buckets = 2;
+    shift_ = 63;
+    while (num_buckets < capacity * 2) {
+      num_buckets <<= 1;
+      shift_--;
+    }
+    buckets_.assign(num_buckets, kNone);
+    mask_ = num_buckets - 1;
+    reset_free_list();
+  }
+
+  FlatLruCache(const FlatLruCache& other) = default;
+  FlatLruCache(FlatLruCache&& other) noexcept = default;
+  FlatLruCache& operator=(FlatLruCache&& other) noexcept = default;
+  // Keys are const in the slab, use the copy constructor instead
+  FlatLruCache& operator=(const FlatLruCache& other) = delete;
+
+  ~FlatLruCache() = default;
+
+  // Clear the cache
+  void clear() {
+    for (auto& entry : entries_) {
+      entry.value.reset();
+    }
+    buckets_.assign(buckets_.size(), kNone);
+    size_ = 0;
+    reset_free_list();
+  }
+
+  // Find the value of a key, and move the key to the head of cache, if there is one. Return iterator to value if key
+  // exists, end() if not. Iterator might be invalidated when removed or evicted. Const version.
+  //
+  // LRU: Will warm up key
+  // LRU: Access to returned iterator won't move key in LRU
+  const_iterator find(const Key& key) const {
+    return const_cast<FlatLruCache*>(this)->find(key);
+  }
+
+  // Find the value of a key, and move the key to the head of cache, if there is one. Return iterator to value if key
+  // exists, end() if not. Iterator might be invalidated when removed or evicted
+  //
+  // LRU: Will warm up key
+  // LRU: Access to returned iterator won't move key in LRU
+  iterator find(const Key& key) {
+    size_t bucket = find_bucket(key, Hash{}(key));
+    if (buckets_[bucket] == kNone) {
+      return end();
+    }
+    uint32_t index = buckets_[bucket];
+    move_to_front(index);
+    return iterator(this, index);
+  }
+
+  // Check if key exist in the cache. Return true if key exist in cache, false, if not
+  //
+  // LRU: Will warm up key
+  bool contains(const Key& key) const {
+    return find(key) != end();
+  }
+
+  // Put a key-value pair to the head of cache, evict the oldest key if cache is at capacity. Eviction is based on key
+  // ONLY. Hence, updating a key will not evict the oldest key. Return evicted value if old value was evicted,
+  // std::nullopt if not.
+  //
+  // LRU: Will warm up key
+  std::optional<node_type> insert_or_assign(const Key& key, T value) {
+    size_t hash = Hash{}(key);
+    size_t bucket = find_bucket(key, hash);
+    if (buckets_[bucket] != kNone) {
+      uint32_t index = buckets_[bucket];
+      move_to_front(index);
+      entries_[index].value->second = std::move(value);
+      return std::nullopt;
+    }
+    std::optional<node_type> evicted_node = evict_if_full();
+    if (evicted_node) {
+      // The eviction shifted the buckets
+      bucket = find_bucket(key, hash);
+    }
+    emplace_front(bucket, hash, key, std::move(value));
+    return evicted_node;
+  }
+
+  // Put a key-value pair to the head of cache, evict the oldest key if cache is at capacity. Eviction is based on key
+  // ONLY. Hence, updating a key will not evict the oldest key. This method tries to construct the value in-place. If
+  // the key already exist, this method only update the value. Return inserted iterator, whether insertion happens, and
+  // evicted value if old value was evicted or std::nullopt
+  //
+  // LRU: Will warm up key
+  template <class... Args>
+  std::tuple<iterator, bool, std::optional<node_type>> try_emplace(const Key& key, Args&&... args) {
+    size_t hash = Hash{}(key);
+    size_t bucket = find_bucket(key, hash);
+    if (buckets_[bucket] != kNone) {
+      move_to_front(buckets_[bucket]);
+      return std::make_tuple(end(), false, std::nullopt);
+    }
+    std::optional<node_type> evicted_node = evict_if_full();
+    if (evicted_node) {
+      bucket = find_bucket(key, hash);
+    }
+    uint32_t index = emplace_front(bucket, hash, key, std::forward<Args>(args)...);
+    return std::make_tuple(iterator(this, index), true, std::move(evicted_node));
+  }
+
+  // Delete a key from cache, return removed value if old value was evicted, std::nullopt if not
+  std::optional<node_type> extract(const Key& key) {
+    size_t bucket = find_bucket(key, Hash{}(key));
+    if (buckets_[bucket] == kNone) {
+      return std::nullopt;
+    }
+    return remove(buckets_[bucket]);
+  }
+
+  // Remove an iterator pointed item from the lru cache and return the iterator immediately after the erased item
+  iterator erase(const_iterator iter) {
+    uint32_t next = entries_[iter.index_].next;
+    remove(iter.index_);
+    return iterator(this, next);
+  }
+
+  // Return size of the cache
+  inline size_t size() const {
+    return size_;
+  }
+
+  // Return capacity of the cache
+  inline size_t capacity() const {
+    return entries_.size();
+  }
+
+  // Iterator interface for begin
+  inline iterator begin() {
+    return iterator(this, head_);
+  }
+
+  // Return iterator interface for begin, const
+  inline const_iterator begin() const {
+    return const_iterator(this, head_);
+  }
+
+  // Return iterator interface for end
+  inline iterator end() {
+    return iterator(this, kNone);
+  }
+
+  // Iterator interface for end, const
+  inline const_iterator end() const {
+    return const_iterator(this, kNone);
+  }
+
+ private:
+  struct Entry {
+    std::optional<value_type> value;
+    size_t hash = 0;
+    // Warmer and colder entries, or the next free entry
+    uint32_t prev = kNone;
+    uint32_t next = kNone;
+  };
+
+  template <bool kConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::conditional_t<kConst, const FlatLruCache::value_type, FlatLruCache::value_type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using cache_pointer = std::conditional_t<kConst, const FlatLruCache*, FlatLruCache*>;
+
+    Iterator() = default;
+    Iterator(cache_pointer cache, uint32_t index) : cache_(cache), index_(index) {}
+    // iterator to const_iterator
+    template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+    Iterator(const Iterator<kOtherConst>& other) : cache_(other.cache_), index_(other.index_) {}
+
+    reference operator*() const {
+      return *cache_->entries_[index_].value;
+    }
+    pointer operator->() const {
+      return &*cache_->entries_[index_].value;
+    }
+    Iterator& operator++() {
+      index_ = cache_->entries_[index_].next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator iter = *this;
+      ++*this;
+      return iter;
+    }
+    bool operator==(const Iterator& rhs) const {
+      return index_ == rhs.index_;
+    }
+    bool operator!=(const Iterator& rhs) const {
+      return !(*this == rhs);
+    }
+
+   private:
+    friend class FlatLruCache;
+    template <bool>
+    friend class Iterator;
+    cache_pointer cache_ = nullptr;
+    uint32_t index_ = kNone;
+  };
+
+  void reset_free_list() {
+    head_ = kNone;
+    tail_ = kNone;
+    for (size_t i = 0; i < entries_.size(); i++) {
+      entries_[i].prev = kNone;
+      entries_[i].next = (i + 1 < entries_.size()) ? i + 1 : kNone;
+    }
+    free_ = 0;
+  }
+
+  // Fibonacci hashing, so that keys with a trivial hash, e.g. consecutive integers, don't cluster
+  size_t ideal_bucket(size_t hash) const {
+    return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9e3779b97f4a7c15ull) >> shift_);
+  }
+
+  // Return the bucket holding |key|, or the empty bucket where it would be inserted
+  size_t find_bucket(const Key& key, size_t hash) const {
+    size_t bucket = ideal_bucket(hash);
+    while (buckets_[bucket] != kNone) {
+      const Entry& entry = entries_[buckets_[bucket]];
+      if (entry.hash == hash && entry.value->first == key) {
+        break;
+      }
+      bucket = (bucket + 1) & mask_;
+    }
+    return bucket;
+  }
+
+  void unlink(uint32_t index) {
+    Entry& entry = entries_[index];
+    if (entry.prev != kNone) {
+      entries_[entry.prev].next = entry.next;
+    } else {
+      head_ = entry.next;
+    }
+    if (entry.next != kNone) {
+      entries_[entry.next].prev = entry.prev;
+    } else {
+      tail_ = entry.prev;
+    }
+  }
+
+  void link_front(uint32_t index) {
+    Entry& entry = entries_[index];
+    entry.prev = kNone;
+    entry.next = head_;
+    if (head_ != kNone) {
+      entries_[head_].prev = index;
+    } else {
+      tail_ = index;
+    }
+    head_ = index;
+  }
+
+  void move_to_front(uint32_t index) {
+    if (index != head_) {
+      unlink(index);
+      link_front(index);
+    }
+  }
+
+  std::optional<node_type> evict_if_full() {
+    if (size_ < entries_.size()) {
+      return std::nullopt;
+    }
+    return remove(tail_);
+  }
+
+  template <class... Args>
+  uint32_t emplace_front(size_t bucket, size_t hash, const Key& key, Args&&... args) {
+    uint32_t index = free_;
+    Entry& entry = entries_[index];
+    free_ = entry.next;
+    entry.value.emplace(
+        std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    entry.hash = hash;
+    buckets_[bucket] = index;
+    link_front(index);
+    size_++;
+    return index;
+  }
+
+  node_type remove(uint32_t index) {
+    Entry& entry = entries_[index];
+    erase_bucket(find_bucket(entry.value->first, entry.hash));
+    unlink(index);
+    node_type node(entry.value->first, std::move(entry.value->second));
+    entry.value.reset();
+    entry.prev = kNone;
+    entry.next = free_;
+    free_ = index;
+    size_--;
+    return node;
+  }
+
+  // Backward shift deletion: move the following entries of the probe sequence into the hole, when their ideal bucket
+  // is not between the hole and them
+  void erase_bucket(size_t hole) {
+    buckets_[hole] = kNone;
+    for (size_t bucket = (hole + 1) & mask_; buckets_[bucket] != kNone; bucket = (bucket + 1) & mask_) {
+      size_t ideal = ideal_bucket(entries_[buckets_[bucket]].hash);
+      if (((bucket - ideal) & mask_) >= ((bucket - hole) & mask_)) {
+        buckets_[hole] = buckets_[bucket];
+        buckets_[bucket] = kNone;
+        hole = bucket;
+      }
+    }
+  }
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> buckets_;
+  size_t mask_ = 0;
+  // log2 of the number of buckets, subtracted from 64
+  int shift_ = 63;
+  size_t size_ = 0;
+  // Warmest and coldest entries, and first free entry
+  uint32_t head_ = kNone;
+  uint32_t tail_ = kNone;
+  uint32_t free_ = kNone;
+};
+
+}  // namespace common
+}  // namespace bluetooth
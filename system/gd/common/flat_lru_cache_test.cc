@@ -0,0 +1,184 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/flat_lru_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "common/lru_cache.h"
+
+namespace testing {
+
+using bluetooth::common::FlatLruCache;
+using bluetooth::common::LruCache;
+
+// Hash everything to the same bucket, to exercise the probing and the backward shift deletion
+struct CollidingHash {
+  size_t operator()(int) const {
+    return 7;
+  }
+};
+
+TEST(FlatLruCacheTest, empty_test) {
+  FlatLruCache<int, int> cache(3);
+  EXPECT_EQ(cache.size(), 0ul);
+  EXPECT_EQ(cache.capacity(), 3ul);
+  EXPECT_EQ(cache.find(42), cache.end());
+  cache.clear();  // should not crash
+  EXPECT_EQ(cache.find(42), cache.end());
+  EXPECT_FALSE(cache.contains(42));
+  EXPECT_FALSE(cache.extract(42));
+  EXPECT_EQ(cache.begin(), cache.end());
+}
+
+TEST(FlatLruCacheTest, insert_and_evict_test) {
+  FlatLruCache<int, int> cache(3);
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  EXPECT_FALSE(cache.insert_or_assign(3, 30));
+  ASSERT_THAT(cache, ElementsAre(Pair(3, 30), Pair(2, 20), Pair(1, 10)));
+
+  // Warm up 1, so that 2 is the coldest
+  EXPECT_EQ(cache.find(1)->second, 10);
+  auto evicted = cache.insert_or_assign(4, 40);
+  EXPECT_EQ(evicted, std::make_pair(2, 20));
+  ASSERT_THAT(cache, ElementsAre(Pair(4, 40), Pair(1, 10), Pair(3, 30)));
+
+  // Updating a key doesn't evict anything
+  EXPECT_FALSE(cache.insert_or_assign(3, 31));
+  ASSERT_THAT(cache, ElementsAre(Pair(3, 31), Pair(4, 40), Pair(1, 10)));
+  EXPECT_EQ(cache.size(), 3ul);
+}
+
+TEST(FlatLruCacheTest, try_emplace_test) {
+  FlatLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto result = cache.try_emplace(42, 420);
+  // 1, 10 evicted
+  EXPECT_EQ(std::get<2>(result), std::make_pair(1, 10));
+  EXPECT_TRUE(std::get<1>(result));
+  auto iter = cache.find(42);
+  EXPECT_EQ(iter->second, 420);
+  EXPECT_EQ(iter, std::get<0>(result));
+  ASSERT_THAT(cache, ElementsAre(Pair(42, 420), Pair(2, 20)));
+
+  // An existing key is warmed up, not updated
+  result = cache.try_emplace(2, 21);
+  EXPECT_FALSE(std::get<1>(result));
+  EXPECT_FALSE(std::get<2>(result));
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 20), Pair(42, 420)));
+}
+
+TEST(FlatLruCacheTest, extract_and_erase_test) {
+  FlatLruCache<int, int> cache(4);
+  for (int i = 0; i < 4; i++) {
+    cache.insert_or_assign(i, i * 10);
+  }
+  EXPECT_EQ(cache.extract(2), std::make_pair(2, 20));
+  EXPECT_FALSE(cache.extract(2));
+  ASSERT_THAT(cache, ElementsAre(Pair(3, 30), Pair(1, 10), Pair(0, 0)));
+
+  // Erase the odd keys while iterating
+  for (auto it = cache.begin(); it != cache.end();) {
+    it = (it->first % 2 == 1) ? cache.erase(it) : std::next(it);
+  }
+  ASSERT_THAT(cache, ElementsAre(Pair(0, 0)));
+
+  // The freed entries are reused without evicting
+  EXPECT_FALSE(cache.insert_or_assign(5, 50));
+  EXPECT_FALSE(cache.insert_or_assign(6, 60));
+  EXPECT_FALSE(cache.insert_or_assign(7, 70));
+  EXPECT_EQ(cache.insert_or_assign(8, 80), std::make_pair(0, 0));
+  EXPECT_EQ(cache.size(), 4ul);
+}
+
+TEST(FlatLruCacheTest, colliding_keys_test) {
+  FlatLruCache<int, int, CollidingHash> cache(8);
+  for (int i = 0; i < 8; i++) {
+    cache.insert_or_assign(i, i);
+  }
+  // Remove from the middle of the probe sequence, the keys after it must still be found
+  EXPECT_TRUE(cache.extract(3));
+  EXPECT_TRUE(cache.extract(0));
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(cache.contains(i), i != 3 && i != 0) << i;
+  }
+  // Evictions keep the table consistent too
+  for (int i = 8; i < 100; i++) {
+    cache.insert_or_assign(i, i);
+  }
+  EXPECT_EQ(cache.size(), 8ul);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(cache.contains(i), i >= 92) << i;
+  }
+}
+
+TEST(FlatLruCacheTest, pointer_stability_test) {
+  FlatLruCache<int, std::string> cache(3);
+  cache.insert_or_assign(1, "one");
+  const std::string* one = &cache.find(1)->second;
+  cache.insert_or_assign(2, "two");
+  cache.insert_or_assign(3, "three");
+  cache.find(1);
+  cache.insert_or_assign(4, "four");
+  EXPECT_EQ(one, &cache.find(1)->second);
+  EXPECT_EQ(*one, "one");
+}
+
+TEST(FlatLruCacheTest, move_only_value_test) {
+  FlatLruCache<int, std::unique_ptr<int>> cache(1);
+  cache.insert_or_assign(1, std::make_unique<int>(10));
+  auto evicted = cache.insert_or_assign(2, std::make_unique<int>(20));
+  ASSERT_TRUE(evicted);
+  EXPECT_EQ(*evicted->second, 10);
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0ul);
+  EXPECT_FALSE(cache.insert_or_assign(3, std::make_unique<int>(30)));
+}
+
+TEST(FlatLruCacheTest, same_as_lru_cache_test) {
+  // Drive both caches with the same pseudo random operations
+  LruCache<int, int> reference(16);
+  FlatLruCache<int, int> cache(16);
+  uint32_t seed = 1;
+  for (int i = 0; i < 10000; i++) {
+    seed = seed * 1103515245 + 12345;
+    int key = (seed >> 16) % 40;
+    switch ((seed >> 8) % 3) {
+      case 0:
+        EXPECT_EQ(reference.insert_or_assign(key, i), cache.insert_or_assign(key, i));
+        break;
+      case 1:
+        EXPECT_EQ(reference.contains(key), cache.contains(key));
+        break;
+      case 2:
+        EXPECT_EQ(reference.extract(key).has_value(), cache.extract(key).has_value());
+        break;
+    }
+    ASSERT_EQ(reference.size(), cache.size());
+  }
+  ASSERT_TRUE(std::equal(reference.begin(), reference.end(), cache.begin(), cache.end(), [](auto& a, auto& b) {
+    return a.first == b.first && a.second == b.second;
+  }));
+}
+
+}  // namespace testing
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/flat_list_map.h"
+#include "common/list_map.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+constexpr size_t kPropertiesPerSection = 12;
+
+std::string SectionName(size_t i) {
+  char name[18];
+  snprintf(name, sizeof(name), "00:11:22:%02zx:%02zx:%02zx", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+  return name;
+}
+
+std::string PropertyName(size_t i) {
+  return "Property" + std::to_string(i);
+}
+
+// A config of range(0) device sections, each one with the same properties as a bonded device
+template <typename Map>
+Map MakeConfig(size_t num_sections) {
+  Map config;
+  for (size_t i = 0; i < num_sections; i++) {
+    auto section = config.try_emplace_back(SectionName(i), typename Map::node_type::second_type{}).first;
+    for (size_t p = 0; p < kPropertiesPerSection; p++) {
+      section->second.insert_or_assign(PropertyName(p), "0123456789abcdef0123456789abcdef");
+    }
+  }
+  return config;
+}
+}  // namespace
+
+template <typename Map>
+static void BM_ConfigBuild(State& state) {
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(MakeConfig<Map>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * kPropertiesPerSection);
+}
+BENCHMARK_TEMPLATE(BM_ConfigBuild, ListMap<std::string, ListMap<std::string, std::string>>)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_ConfigBuild, FlatListMap<std::string, FlatListMap<std::string, std::string>>)
+    ->Arg(16)
+    ->Arg(256);
+
+// Lookup of a property of a section, as done by ConfigCache::GetProperty()
+template <typename Map>
+static void BM_ConfigLookup(State& state) {
+  size_t num_sections = state.range(0);
+  auto config = MakeConfig<Map>(num_sections);
+  std::vector<std::string> sections;
+  for (size_t i = 0; i < num_sections; i++) {
+    sections.push_back(SectionName(i));
+  }
+  std::vector<std::string> properties;
+  for (size_t p = 0; p < kPropertiesPerSection; p++) {
+    properties.push_back(PropertyName(p));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto section = config.find(sections[(i * 7) % num_sections]);
+    ::benchmark::DoNotOptimize(section->second.find(properties[i % kPropertiesPerSection]));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ConfigLookup, ListMap<std::string, ListMap<std::string, std::string>>)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_ConfigLookup, FlatListMap<std::string, FlatListMap<std::string, std::string>>)
+    ->Arg(16)
+    ->Arg(256);
+
+// Full iteration of the config, as done when it is serialized
+template <typename Map>
+static void BM_ConfigIterate(State& state) {
+  auto config = MakeConfig<Map>(state.range(0));
+  for (auto _ : state) {
+    size_t total = 0;
+    for (const auto& section : config) {
+      for (const auto& property : section.second) {
+        total += property.second.size();
+      }
+    }
+    ::benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * kPropertiesPerSection);
+}
+BENCHMARK_TEMPLATE(BM_ConfigIterate, ListMap<std::string, ListMap<std::string, std::string>>)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(BM_ConfigIterate, FlatListMap<std::string, FlatListMap<std::string, std::string>>)
+    ->Arg(16)
+    ->Arg(256);
+
+}  // namespace common
+}  // namespace bluetooth
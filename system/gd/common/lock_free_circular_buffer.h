@@ -0,0 +1,180 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "common/circular_buffer.h"
+
+namespace bluetooth {
+namespace common {
+
+// A circular buffer keeping the last |size| items pushed, for history logging from hot paths. Push() may be called
+// concurrently from any number of threads and never takes a lock; Pull() takes a snapshot from any thread without
+// blocking the producers.
+//
+// Each slot is a seqlock: a producer takes a ticket, marks the slot of the ticket as being written, copies the item
+// into it word by word and marks it as written. Pull() copies the slots of the last |size| tickets and keeps the ones
+// that were written for their ticket and not modified while being copied. Hence items being pushed while the snapshot
+// is taken may be missing from it.
+//
+// T must be trivially copyable, see BoundedString for strings.
+template <typename T>
+class LockFreeCircularBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "Items are copied word by word, they must be trivially copyable");
+
+ public:
+  explicit LockFreeCircularBuffer(size_t size)
+      : size_(std::max<size_t>(size, 1)),
+        sequences_(new std::atomic<uint64_t>[size_]),
+        words_(new std::atomic<uint64_t>[size_ * kWordsPerItem]) {
+    for (size_t i = 0; i < size_; i++) {
+      sequences_[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < size_ * kWordsPerItem; i++) {
+      words_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeCircularBuffer(const LockFreeCircularBuffer&) = delete;
+  LockFreeCircularBuffer& operator=(const LockFreeCircularBuffer&) = delete;
+
+  // Push one item to the circular buffer, overwriting the oldest one when full
+  void Push(const T& item) {
+    uint64_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<uint64_t>& sequence = sequences_[ticket % size_];
+    uint64_t current = sequence.load(std::memory_order_relaxed);
+    while (true) {
+      if (current >= Writing(ticket)) {
+        // A newer item already took the slot, this one would have been overwritten right away
+        return;
+      }
+      if ((current & 1) != 0) {
+        // The producer of the previous round is still writing, only when |size| pushes race with it
+        std::this_thread::yield();
+        current = sequence.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (sequence.compare_exchange_weak(current, Writing(ticket), std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t words[kWordsPerItem] = {};
+    std::memcpy(words, &item, sizeof(T));
+    std::atomic<uint64_t>* slot = &words_[(ticket % size_) * kWordsPerItem];
+    for (size_t i = 0; i < kWordsPerItem; i++) {
+      slot[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence.store(Written(ticket), std::memory_order_release);
+  }
+
+  // Take a snapshot of the circular buffer and return it as a vector, from the oldest to the newest item
+  std::vector<T> Pull() const {
+    uint64_t end = next_ticket_.load(std::memory_order_acquire);
+    uint64_t begin = end > size_ ? end - size_ : 0;
+    std::vector<T> items;
+    items.reserve(end - begin);
+    for (uint64_t ticket = begin; ticket < end; ticket++) {
+      const std::atomic<uint64_t>& sequence = sequences_[ticket % size_];
+      if (sequence.load(std::memory_order_acquire) != Written(ticket)) {
+        continue;
+      }
+      uint64_t words[kWordsPerItem];
+      const std::atomic<uint64_t>* slot = &words_[(ticket % size_) * kWordsPerItem];
+      for (size_t i = 0; i < kWordsPerItem; i++) {
+        words[i] = slot[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence.load(std::memory_order_relaxed) != Written(ticket)) {
+        continue;
+      }
+      T item;
+      std::memcpy(&item, words, sizeof(T));
+      items.push_back(item);
+    }
+    return items;
+  }
+
+  // Number of items pushed since the construction, including the overwritten ones
+  uint64_t GetPushedCount() const {
+    return next_ticket_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kWordsPerItem = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  // 0 for a slot never written, then odd while the item of |ticket| is being written and even once written, increasing
+  // with the ticket
+  static constexpr uint64_t Writing(uint64_t ticket) {
+    return 2 * ticket + 1;
+  }
+  static constexpr uint64_t Written(uint64_t ticket) {
+    return 2 * ticket + 2;
+  }
+
+  const size_t size_;
+  std::atomic<uint64_t> next_ticket_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> sequences_;
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;
+};
+
+template <typename T>
+class TimestampedLockFreeCircularBuffer : public LockFreeCircularBuffer<TimestampedEntry<T>> {
+ public:
+  explicit TimestampedLockFreeCircularBuffer(
+      size_t size, std::unique_ptr<Timestamper> timestamper = std::make_unique<TimestamperInMilliseconds>())
+      : LockFreeCircularBuffer<TimestampedEntry<T>>(size), timestamper_(std::move(timestamper)) {}
+
+  void Push(const T& item) {
+    LockFreeCircularBuffer<TimestampedEntry<T>>::Push(TimestampedEntry<T>{timestamper_->GetTimestamp(), item});
+  }
+
+ private:
+  std::unique_ptr<Timestamper> timestamper_;
+};
+
+// A string of at most |kMaxLength| characters stored inline, so that it can be pushed to a LockFreeCircularBuffer
+// without allocating. Longer strings are truncated.
+template <size_t kMaxLength>
+struct BoundedString {
+  BoundedString() = default;
+  explicit BoundedString(std::string_view text) {
+    size_t length = std::min(text.size(), kMaxLength);
+    std::memcpy(data, text.data(), length);
+    data[length] = '\0';
+  }
+
+  std::string ToString() const {
+    return std::string(data);
+  }
+
+  char data[kMaxLength + 1] = {};
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/lock_free_circular_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::common::BoundedString;
+using bluetooth::common::LockFreeCircularBuffer;
+using bluetooth::common::TimestampedLockFreeCircularBuffer;
+
+struct FakeTimestamper : public bluetooth::common::Timestamper {
+  long long GetTimestamp() const override {
+    return timestamp_++;
+  }
+  mutable long long timestamp_{100};
+};
+
+// Both halves are written together, a torn copy would break the invariant
+struct Item {
+  uint32_t producer;
+  uint32_t sequence;
+  uint64_t check;
+  char padding[40];
+};
+
+TEST(LockFreeCircularBufferTest, simple) {
+  TimestampedLockFreeCircularBuffer<BoundedString<16>> buffer(10, std::make_unique<FakeTimestamper>());
+  ASSERT_TRUE(buffer.Pull().empty());
+
+  buffer.Push(BoundedString<16>("One"));
+  buffer.Push(BoundedString<16>("Two"));
+  buffer.Push(BoundedString<16>("Three"));
+
+  auto vec = buffer.Pull();
+  ASSERT_EQ(vec.size(), 3ul);
+  ASSERT_EQ(vec[0].entry.ToString(), "One");
+  ASSERT_EQ(vec[1].entry.ToString(), "Two");
+  ASSERT_EQ(vec[2].entry.ToString(), "Three");
+  ASSERT_EQ(vec[0].timestamp, 100);
+  ASSERT_EQ(vec[2].timestamp, 102);
+
+  // Pull takes a snapshot, it doesn't drain
+  ASSERT_EQ(buffer.Pull().size(), 3ul);
+}
+
+TEST(LockFreeCircularBufferTest, keeps_last_items) {
+  LockFreeCircularBuffer<int> buffer(10);
+  for (int i = 0; i < 25; i++) {
+    buffer.Push(i);
+  }
+  auto vec = buffer.Pull();
+  ASSERT_EQ(vec.size(), 10ul);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(vec[i], 15 + i);
+  }
+  ASSERT_EQ(buffer.GetPushedCount(), 25ul);
+}
+
+TEST(LockFreeCircularBufferTest, bounded_string_truncates) {
+  ASSERT_EQ(BoundedString<5>("abcdefgh").ToString(), "abcde");
+  ASSERT_EQ(BoundedString<5>("abc").ToString(), "abc");
+  ASSERT_EQ(BoundedString<5>().ToString(), "");
+}
+
+TEST(LockFreeCircularBufferTest, concurrent_producers_and_reader) {
+  constexpr uint32_t kProducers = 4;
+  constexpr uint32_t kItemsPerProducer = 20000;
+  LockFreeCircularBuffer<Item> buffer(64);
+  std::atomic<uint32_t> running_producers{kProducers};
+
+  std::vector<std::thread> producers;
+  for (uint32_t producer = 0; producer < kProducers; producer++) {
+    producers.emplace_back([&buffer, &running_producers, producer] {
+      for (uint32_t sequence = 0; sequence < kItemsPerProducer; sequence++) {
+        uint64_t check = (static_cast<uint64_t>(producer) << 32 | sequence) ^ 0x5a5a5a5a5a5a5a5aull;
+        buffer.Push(Item{producer, sequence, check, {}});
+      }
+      running_producers--;
+    });
+  }
+
+  size_t snapshots = 0;
+  do {
+    auto vec = buffer.Pull();
+    ASSERT_LE(vec.size(), 64ul);
+    std::vector<int64_t> last_sequence(kProducers, -1);
+    for (const auto& item : vec) {
+      ASSERT_LT(item.producer, kProducers);
+      ASSERT_EQ(item.check, (static_cast<uint64_t>(item.producer) << 32 | item.sequence) ^ 0x5a5a5a5a5a5a5a5aull);
+      // The items of a producer are pulled in the order they were pushed
+      ASSERT_GT(static_cast<int64_t>(item.sequence), last_sequence[item.producer]);
+      last_sequence[item.producer] = item.sequence;
+    }
+    snapshots++;
+  } while (running_producers > 0);
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_GT(snapshots, 0ul);
+  ASSERT_EQ(buffer.Pull().size(), 64ul);
+  ASSERT_EQ(buffer.GetPushedCount(), kProducers * kItemsPerProducer);
+}
+
+}  // namespace testing
@@ -48,15 +48,16 @@ namespace common {
 // Template:
 //   - Key key type
 //   - T value type
+//   - Map insertion ordered map holding the items, ListMap or FlatListMap
 // */
-template <typename Key, typename T>
+template <typename Key, typename T, typename Map = ListMap<Key, T>>
 class LruCache {
  public:
-  using value_type = typename ListMap<Key, T>::value_type;
+  using value_type = typename Map::value_type;
   // different from c++17 node_type on purpose as we want node to be copyable
-  using node_type = typename ListMap<Key, T>::node_type;
-  using iterator = typename ListMap<Key, T>::iterator;
-  using const_iterator = typename ListMap<Key, T>::const_iterator;
+  using node_type = typename Map::node_type;
+  using iterator = typename Map::iterator;
+  using const_iterator = typename Map::const_iterator;
 
   // Constructor a LRU cache with |capacity|
   explicit LruCache(size_t capacity) : capacity_(capacity) {
@@ -123,6 +124,14 @@ class LruCache {
     return iter;
   }
 
+  // Find the value of a key without moving it in the cache. Return iterator to value if key exists, end() if not.
+  // Unlike find(), does not modify the cache and can be called by concurrent readers.
+  //
+  // LRU: Won't warm up key
+  const_iterator peek(const Key& key) const {
+    return list_map_.find(key);
+  }
+
   // Check if key exist in the cache. Return true if key exist in cache, false, if not
   //
   // LRU: Will warm up key
@@ -212,7 +221,7 @@ class LruCache {
 
  private:
   size_t capacity_;
-  ListMap<Key, T> list_map_;
+  Map list_map_;
 };
 
 }  // namespace common
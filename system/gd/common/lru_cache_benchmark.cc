@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/flat_lru_cache.h"
+#include "common/lru_cache.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+template <typename Key>
+Key MakeKey(size_t i);
+
+// Keys shaped like the addresses of the devices seen by a scan, as in the config cache
+template <>
+std::string MakeKey<std::string>(size_t i) {
+  char key[18];
+  snprintf(key, sizeof(key), "00:11:22:%02zx:%02zx:%02zx", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+  return key;
+}
+
+template <>
+uint64_t MakeKey<uint64_t>(size_t i) {
+  return 0x001122000000 + i;
+}
+
+template <typename Cache>
+std::vector<typename Cache::node_type::first_type> MakeKeys(size_t count) {
+  std::vector<typename Cache::node_type::first_type> keys;
+  for (size_t i = 0; i < count; i++) {
+    keys.push_back(MakeKey<typename Cache::node_type::first_type>(i));
+  }
+  return keys;
+}
+}  // namespace
+
+// Insertion of new keys in a full cache of range(0) keys, each one evicting the coldest key
+template <typename Cache>
+static void BM_LruInsertEvict(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys<Cache>(capacity * 4);
+  Cache cache(capacity);
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(cache.insert_or_assign(keys[i % keys.size()], static_cast<int>(i)));
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LruInsertEvict, LruCache<std::string, int>)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LruInsertEvict, FlatLruCache<std::string, int>)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LruInsertEvict, LruCache<uint64_t, int>)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LruInsertEvict, FlatLruCache<uint64_t, int>)->Arg(64)->Arg(1024);
+
+// Lookups of keys present in a full cache of range(0) keys, warming each of them up
+template <typename Cache>
+static void BM_LruFindHit(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys<Cache>(capacity);
+  Cache cache(capacity);
+  for (size_t i = 0; i < capacity; i++) {
+    cache.insert_or_assign(keys[i], static_cast<int>(i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    // Stride through the keys so that every lookup moves its key to the head
+    ::benchmark::DoNotOptimize(cache.find(keys[(i++ * 7) % capacity]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LruFindHit, LruCache<std::string, int>)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LruFindHit, FlatLruCache<std::string, int>)->Arg(64)->Arg(1024);
+
+// Lookups of keys absent from a full cache of range(0) keys, e.g. the advertisers that are not bonded
+template <typename Cache>
+static void BM_LruFindMiss(State& state) {
+  size_t capacity = state.range(0);
+  auto keys = MakeKeys<Cache>(capacity * 2);
+  Cache cache(capacity);
+  for (size_t i = 0; i < capacity; i++) {
+    cache.insert_or_assign(keys[i], static_cast<int>(i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(cache.find(keys[capacity + i++ % capacity]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LruFindMiss, LruCache<std::string, int>)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_LruFindMiss, FlatLruCache<std::string, int>)->Arg(64)->Arg(1024);
+
+}  // namespace common
+}  // namespace bluetooth
@@ -332,6 +332,21 @@ TEST(LruCacheTest, get_test) {
   EXPECT_EQ(*evicted, std::make_pair(2, 20));
 }
 
+TEST(LruCacheTest, peek_test) {
+  LruCache<int, int> cache(2);
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  EXPECT_EQ(cache.peek(3), cache.end());
+  auto iter = cache.peek(1);
+  EXPECT_NE(iter, cache.end());
+  EXPECT_EQ(iter->second, 10);
+  // 1, 2 in cache, 1 was not warmed up
+  auto evicted = cache.insert_or_assign(3, 30);
+  // 3, 2 in cache
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(*evicted, std::make_pair(1, 10));
+}
+
 TEST(LruCacheTest, remove_test) {
   LruCache<int, int> cache(10);
   for (int key = 0; key <= 30; key++) {
@@ -21,6 +21,7 @@
 #include <iterator>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <thread>
 
 #include "os/log.h"
@@ -51,7 +52,7 @@ MetricIdManager::MetricIdManager()
 bool MetricIdManager::Init(
     const std::unordered_map<Address, int>& paired_device_map,
     Callback save_id_callback, Callback forget_device_callback) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   if (initialized_) {
     return false;
   }
@@ -98,7 +99,7 @@ bool MetricIdManager::Init(
 MetricIdManager::~MetricIdManager() { Close(); }
 
 bool MetricIdManager::Close() {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   if (!initialized_) {
     return false;
   }
@@ -115,14 +116,24 @@ MetricIdManager& MetricIdManager::GetInstance() {
 }
 
 bool MetricIdManager::IsEmpty() const {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::shared_lock<std::shared_mutex> lock(id_allocator_mutex_);
   return paired_device_cache_.size() == 0 &&
          temporary_device_cache_.size() == 0;
 }
 
 // call this function when a new device is scanned
 int MetricIdManager::AllocateId(const Address& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  {
+    // Fast path for the metrics logged by the connected devices. The paired
+    // devices are not warmed up, the cache is large enough to never evict them.
+    std::shared_lock<std::shared_mutex> lock(id_allocator_mutex_);
+    auto it = paired_device_cache_.peek(mac_address);
+    if (it != paired_device_cache_.end()) {
+      return it->second;
+    }
+  }
+
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   auto it = paired_device_cache_.find(mac_address);
   // if already have an id, return it
   if (it != paired_device_cache_.end()) {
@@ -156,7 +167,7 @@ int MetricIdManager::AllocateId(const Address& mac_address) {
 
 // call this function when a device is paired
 bool MetricIdManager::SaveDevice(const Address& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   if (paired_device_cache_.contains(mac_address)) {
     return true;
   }
@@ -184,7 +195,7 @@ bool MetricIdManager::SaveDevice(const Address& mac_address) {
 
 // call this function when a device is forgotten
 void MetricIdManager::ForgetDevice(const Address& mac_address) {
-  std::lock_guard<std::mutex> lock(id_allocator_mutex_);
+  std::lock_guard<std::shared_mutex> lock(id_allocator_mutex_);
   auto opt = paired_device_cache_.extract(mac_address);
   if (!opt) {
     LOG_ERROR("Failed to remove device from paired_device_cache_");
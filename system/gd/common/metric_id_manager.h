@@ -19,6 +19,7 @@
 #pragma once
 
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_set>
@@ -117,7 +118,8 @@ class MetricIdManager {
   MetricIdManager();
 
  private:
-  mutable std::mutex id_allocator_mutex_;
+  // Shared by the AllocateId() calls of the paired devices
+  mutable std::shared_mutex id_allocator_mutex_;
 
   LruCache<hci::Address, int> paired_device_cache_;
   LruCache<hci::Address, int> temporary_device_cache_;
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace bluetooth {
+namespace common {
+
+// An unbounded, lock-free, multi-producer/single-consumer FIFO queue.
+// Push() may be called concurrently from any number of threads. Pop() must only ever be called from one thread at a
+// time (or be serialized externally). Based on the intrusive MPSC node queue described by Dmitry Vyukov.
+//
+// Pop() may transiently report the queue as empty while a producer is in the middle of a Push(); callers that need
+// an exact element count must track it separately.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    Clear();
+  }
+
+  // Enqueue an item. Safe to call from any thread.
+  void Push(T item) {
+    enqueue(new Node(std::move(item)));
+  }
+
+  // Dequeue the oldest item into |item|. Returns false if no item is currently available. Consumer thread only.
+  bool Pop(T* item) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return false;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return take(tail, item);
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A producer has swapped head_ but not yet linked its node
+      return false;
+    }
+    enqueue(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return take(tail, item);
+    }
+    return false;
+  }
+
+  // Discard every item currently available. Consumer thread only.
+  void Clear() {
+    T item;
+    while (Pop(&item)) {
+    }
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T item) : value(std::move(item)) {}
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  void enqueue(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  bool take(Node* node, T* item) {
+    *item = std::move(node->value);
+    delete node;
+    return true;
+  }
+
+  Node stub_;
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+namespace {
+
+TEST(MpscQueueTest, empty) {
+  MpscQueue<int> queue;
+  int value = 0;
+  ASSERT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, fifo_order) {
+  MpscQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+  for (int i = 0; i < 10; i++) {
+    int value = -1;
+    ASSERT_TRUE(queue.Pop(&value));
+    ASSERT_EQ(value, i);
+  }
+  int value = -1;
+  ASSERT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, interleaved_push_pop) {
+  MpscQueue<int> queue;
+  int value = -1;
+  queue.Push(1);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 1);
+  ASSERT_FALSE(queue.Pop(&value));
+  queue.Push(2);
+  queue.Push(3);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 2);
+  queue.Push(4);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 3);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 4);
+  ASSERT_FALSE(queue.Pop(&value));
+}
+
+TEST(MpscQueueTest, move_only_type) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(42));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(*value, 42);
+}
+
+TEST(MpscQueueTest, clear_releases_items) {
+  auto item = std::make_shared<int>(1);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.Push(item);
+    queue.Push(item);
+    ASSERT_EQ(item.use_count(), 3);
+    queue.Clear();
+    ASSERT_EQ(item.use_count(), 1);
+    queue.Push(item);
+  }
+  ASSERT_EQ(item.use_count(), 1);
+}
+
+TEST(MpscQueueTest, multiple_producers) {
+  constexpr int kProducers = 4;
+  constexpr int kItemsPerProducer = 10000;
+  MpscQueue<std::pair<int, int>> queue;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&queue, p]() {
+      for (int i = 0; i < kItemsPerProducer; i++) {
+        queue.Push({p, i});
+      }
+    });
+  }
+
+  std::vector<int> next_expected(kProducers, 0);
+  int received = 0;
+  while (received < kProducers * kItemsPerProducer) {
+    std::pair<int, int> item;
+    if (!queue.Pop(&item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    // Items from a single producer must come out in the order they were pushed
+    ASSERT_EQ(item.second, next_expected[item.first]);
+    next_expected[item.first]++;
+    received++;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  std::pair<int, int> item;
+  ASSERT_FALSE(queue.Pop(&item));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace bluetooth
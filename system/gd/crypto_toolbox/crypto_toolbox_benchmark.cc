@@ -0,0 +1,80 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/crypto_toolbox.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace crypto_toolbox {
+
+namespace {
+Octet16 make_octet16(uint8_t seed) {
+  Octet16 value;
+  for (size_t i = 0; i < value.size(); i++) {
+    value[i] = static_cast<uint8_t>(i * 151 + seed);
+  }
+  return value;
+}
+}  // namespace
+
+// One block with the software AES, key expansion included, as the reference for BM_Aes128
+static void BM_Aes128Software(State& state) {
+  Octet16 key = make_octet16(1);
+  Octet16 message = make_octet16(2);
+  Octet16 output;
+  for (auto _ : state) {
+    aes_context ctx;
+    aes_set_key(key.data(), key.size(), &ctx);
+    aes_encrypt(message.data(), output.data(), &ctx);
+    ::benchmark::DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Aes128Software);
+
+// One block with the AES instructions of the CPU when it has them, as for each IRK tried to resolve an RPA
+static void BM_Aes128(State& state) {
+  Octet16 key = make_octet16(1);
+  Octet16 message = make_octet16(2);
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(aes_128(key, message));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Aes128);
+
+// The CMAC of range(0) bytes, as for the GATT database hash
+static void BM_AesCmac(State& state) {
+  Octet16 key = make_octet16(1);
+  std::vector<uint8_t> message(state.range(0));
+  for (size_t i = 0; i < message.size(); i++) {
+    message[i] = static_cast<uint8_t>(i * 151 + 7);
+  }
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(aes_cmac(key, message.data(), message.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+}
+BENCHMARK(BM_AesCmac)->Arg(65)->Arg(1024);
+
+}  // namespace crypto_toolbox
+}  // namespace bluetooth
@@ -352,5 +352,31 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// aes_128 uses the AES instructions of the CPU when it has them, they must give the same output as the software AES
+TEST(CryptoToolboxTest, aes_128_matches_software_aes) {
+  uint32_t seed = 0x12345678;
+  auto next_byte = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<uint8_t>(seed >> 16);
+  };
+
+  for (int i = 0; i < 1000; i++) {
+    Octet16 key, message;
+    std::generate(key.begin(), key.end(), next_byte);
+    std::generate(message.begin(), message.end(), next_byte);
+
+    // aes_128 takes and returns little endian values
+    Octet16 key_reversed, message_reversed, expected;
+    std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+    std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
+    aes_context ctx;
+    aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
+    aes_encrypt(message_reversed.data(), expected.data(), &ctx);
+    std::reverse(expected.begin(), expected.end());
+
+    ASSERT_EQ(expected, aes_128(key, message)) << "at iteration " << i;
+  }
+}
+
 }  // namespace crypto_toolbox
 }  // namespace bluetooth
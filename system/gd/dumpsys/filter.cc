@@ -16,7 +16,7 @@
 
 #include "dumpsys/filter.h"
 
-#include <memory>
+#include <utility>
 
 #include "common/init_flags.h"
 #include "dumpsys/internal/filter_internal.h"
@@ -25,183 +25,172 @@
 using namespace bluetooth;
 using namespace dumpsys;
 
-class Filter {
- public:
-  Filter(const dumpsys::ReflectionSchema& reflection_schema) : reflection_schema_(reflection_schema) {}
-
-  virtual ~Filter() = default;
-
-  virtual void FilterInPlace(char* dumpsys_data) = 0;
-
-  static std::unique_ptr<Filter> Factory(
-      dumpsys::FilterType filter_type, const dumpsys::ReflectionSchema& reflection_schema);
-
- protected:
-  /**
-   * Given both reflection field data and the populated flatbuffer table data, if any,
-   * filter the contents of the field based upon the filtering privacy level.
-   *
-   * Primitives and composite strings may be successfully processed at this point.
-   * Other composite types (e.g. structs or tables) must be expanded into the
-   * respective grouping of subfields.
-   *
-   * @param field The reflection field information from the bundled schema
-   * @param table The populated field data, if any
-   *
-   * @return true if field was filtered successfully, false otherwise.
-   */
-  virtual bool FilterField(const reflection::Field* field, flatbuffers::Table* table) {
-    return false;
-  }
-
-  /**
-   * Given both reflection object data and the populated flatbuffer table data, if any,
-   * filter the object fields based upon the filtering privacy level.
-   *
-   * @param object The reflection object information from the bundled schema
-   * @param table The populated field data, if any
-   *
-   */
-  virtual void FilterObject(const reflection::Object* object, flatbuffers::Table* table){};
-
-  /**
-   * Given both reflection field data and the populated table data, if any,
-   * filter the contents of the table based upon the filtering privacy level.
-   *
-   * @param schema The reflection schema information from the bundled schema
-   * @param table The populated field data, if any
-   *
-   */
-  virtual void FilterTable(const reflection::Schema* schema, flatbuffers::Table* table){};
-
-  const dumpsys::ReflectionSchema& reflection_schema_;
+struct CompiledFilter::Field {
+  const reflection::Field* field;
+  internal::PrivacyLevel privacy_level;
+  flatbuffers::BaseType type;
+  // The compiled table of the data the field points to, if it is followed
+  int sub_table = -1;
 };
 
-class DeveloperPrivacyFilter : public Filter {
- public:
-  DeveloperPrivacyFilter(const dumpsys::ReflectionSchema& reflection_schema) : Filter(reflection_schema) {}
-  void FilterInPlace(char* dumpsys_data) override { /* Nothing to do in this mode */
-  }
+struct CompiledFilter::Table {
+  std::vector<Field> fields;
 };
 
-class UserPrivacyFilter : public Filter {
- public:
-  UserPrivacyFilter(const dumpsys::ReflectionSchema& reflection_schema) : Filter(reflection_schema) {}
-  void FilterInPlace(char* dumpsys_data) override;
+namespace {
 
- protected:
-  bool FilterField(const reflection::Field* field, flatbuffers::Table* table) override;
-  void FilterObject(const reflection::Object* object, flatbuffers::Table* table) override;
-  void FilterTable(const reflection::Schema* schema, flatbuffers::Table* table) override;
-};
-
-bool UserPrivacyFilter::FilterField(const reflection::Field* field, flatbuffers::Table* table) {
-  ASSERT(field != nullptr);
-  ASSERT(table != nullptr);
-  internal::PrivacyLevel privacy_level = internal::FindFieldPrivacyLevel(*field);
+bool IsFilteredInField(flatbuffers::BaseType type) {
+  switch (type) {
+    case flatbuffers::BASE_TYPE_INT:
+    case flatbuffers::BASE_TYPE_FLOAT:
+    case flatbuffers::BASE_TYPE_STRING:
+    case flatbuffers::BASE_TYPE_BOOL:
+    case flatbuffers::BASE_TYPE_LONG:
+      return true;
+    default:
+      return false;
+  }
+}
 
-  const auto type = static_cast<flatbuffers::BaseType>(field->type()->base_type());
+/**
+ * Given both reflection field data and the populated flatbuffer table data, filter the contents of the field based
+ * upon the filtering privacy level.
+ *
+ * Primitives and composite strings may be successfully processed at this point. Other composite types (e.g. structs
+ * or tables) must be expanded into the respective grouping of subfields.
+ *
+ * @return true if field was filtered successfully, false otherwise.
+ */
+bool FilterField(
+    const reflection::Field& field,
+    flatbuffers::BaseType type,
+    internal::PrivacyLevel privacy_level,
+    flatbuffers::Table* table) {
   switch (type) {
     case flatbuffers::BASE_TYPE_INT:
-      return internal::FilterTypeInteger(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeInteger(field, table, privacy_level);
     case flatbuffers::BASE_TYPE_FLOAT:
-      return internal::FilterTypeFloat(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeFloat(field, table, privacy_level);
     case flatbuffers::BASE_TYPE_STRING:
-      return internal::FilterTypeString(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeString(field, table, privacy_level);
     case flatbuffers::BASE_TYPE_STRUCT:
-      return internal::FilterTypeStruct(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeStruct(field, table, privacy_level);
     case flatbuffers::BASE_TYPE_BOOL:
-      return internal::FilterTypeBool(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeBool(field, table, privacy_level);
     case flatbuffers::BASE_TYPE_LONG:
-      return internal::FilterTypeLong(*field, table, privacy_level);
-      break;
+      return internal::FilterTypeLong(field, table, privacy_level);
     default:
-      LOG_WARN("Unsupported base type:%s", internal::FlatbufferTypeText(type).c_str());
       break;
   }
   return false;
 }
 
-void UserPrivacyFilter::FilterObject(const reflection::Object* object, flatbuffers::Table* table) {
-  ASSERT(object != nullptr);
-  if (table == nullptr) {
-    return;  // table data is not populated
-  }
-  for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
-    if (!FilterField(*it, table)) {
-      LOG_ERROR("%s Unable to filter field from an object when it's expected it will work", __func__);
-    };
+}  // namespace
+
+CompiledFilter::CompiledFilter(FilterType filter_type, const ReflectionSchema& reflection_schema) {
+  if (filter_type == FilterType::AS_DEVELOPER) {
+    return;  // Nothing to do in this mode
   }
+  const reflection::Schema* root_schema = reflection_schema.FindInReflectionSchema(reflection_schema.GetRootName());
+  root_ = CompileSchema(reflection_schema, root_schema);
 }
 
-void UserPrivacyFilter::FilterTable(const reflection::Schema* schema, flatbuffers::Table* table) {
+CompiledFilter::~CompiledFilter() = default;
+
+int CompiledFilter::CompileSchema(const ReflectionSchema& reflection_schema, const reflection::Schema* schema) {
   if (schema == nullptr) {
     LOG_WARN("%s schema is nullptr...probably ok", __func__);
-    return;
+    return -1;
+  }
+  for (const auto& compiled_schema : compiled_schemas_) {
+    if (compiled_schema.first == schema) {
+      return compiled_schema.second;
+    }
   }
 
   const reflection::Object* object = schema->root_table();
   if (object == nullptr) {
     LOG_WARN("%s reflection object is nullptr...is ok ?", __func__);
-    return;
+    return -1;
   }
 
-  if (table == nullptr) {
-    return;  // table not populated
-  }
+  int index = tables_.size();
+  tables_.emplace_back();
+  compiled_schemas_.emplace_back(schema, index);
 
   for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
-    if (FilterField(*it, table)) {
-      continue;  // Field successfully filtered
-    }
-    // Get the index of this complex non-string object from the schema which is
-    // also the same index into the data table.
-    int32_t index = it->type()->index();
-    ASSERT(index != -1);
-
-    flatbuffers::Table* sub_table = table->GetPointer<flatbuffers::Table*>(it->offset());
-    const reflection::Schema* sub_schema =
-        reflection_schema_.FindInReflectionSchema(schema->objects()->Get(index)->name()->str());
-
-    if (sub_schema != nullptr) {
-      FilterTable(sub_schema, sub_table);  // Top level schema
-    } else {
-      // Leaf node schema
-      const flatbuffers::String* name = schema->objects()->Get(index)->name();
-      const reflection::Object* sub_object = internal::FindReflectionObject(schema->objects(), name);
-      if (sub_object != nullptr) {
-        FilterObject(sub_object, sub_table);
+    const auto type = static_cast<flatbuffers::BaseType>(it->type()->base_type());
+    Field field{*it, internal::FindFieldPrivacyLevel(**it), type};
+    if (!IsFilteredInField(type)) {
+      if (type != flatbuffers::BASE_TYPE_STRUCT) {
+        LOG_WARN("Unsupported base type:%s", internal::FlatbufferTypeText(type).c_str());
+      }
+      // Get the index of this complex non-string object from the schema which is
+      // also the same index into the data table.
+      int32_t object_index = it->type()->index();
+      if (object_index == -1) {
+        LOG_ERROR("Unable to filter field:%s", it->name()->c_str());
+        tables_[index].fields.push_back(field);
+        continue;
+      }
+
+      const flatbuffers::String* name = schema->objects()->Get(object_index)->name();
+      const reflection::Schema* sub_schema = reflection_schema.FindInReflectionSchema(name->str());
+      if (sub_schema != nullptr) {
+        field.sub_table = CompileSchema(reflection_schema, sub_schema);  // Top level schema
       } else {
-        LOG_ERROR("Unable to find reflection sub object:%s\n", name->c_str());
+        // Leaf node schema
+        const reflection::Object* sub_object = internal::FindReflectionObject(schema->objects(), name);
+        if (sub_object != nullptr) {
+          field.sub_table = CompileObject(sub_object);
+        } else {
+          LOG_ERROR("Unable to find reflection sub object:%s\n", name->c_str());
+        }
       }
     }
+    tables_[index].fields.push_back(field);
   }
+  return index;
 }
 
-void UserPrivacyFilter::FilterInPlace(char* dumpsys_data) {
-  ASSERT(dumpsys_data != nullptr);
-  const reflection::Schema* root_schema = reflection_schema_.FindInReflectionSchema(reflection_schema_.GetRootName());
-  flatbuffers::Table* table = const_cast<flatbuffers::Table*>(flatbuffers::GetRoot<flatbuffers::Table>(dumpsys_data));
-  FilterTable(root_schema, table);
+int CompiledFilter::CompileObject(const reflection::Object* object) {
+  int index = tables_.size();
+  tables_.emplace_back();
+  for (auto it = object->fields()->cbegin(); it != object->fields()->cend(); ++it) {
+    const auto type = static_cast<flatbuffers::BaseType>(it->type()->base_type());
+    if (!IsFilteredInField(type)) {
+      LOG_ERROR("%s Unable to filter field from an object when it's expected it will work", __func__);
+    }
+    tables_[index].fields.push_back(Field{*it, internal::FindFieldPrivacyLevel(**it), type});
+  }
+  return index;
 }
 
-std::unique_ptr<Filter> Filter::Factory(
-    dumpsys::FilterType filter_type, const dumpsys::ReflectionSchema& reflection_schema) {
-  switch (filter_type) {
-    case dumpsys::FilterType::AS_DEVELOPER:
-      return std::make_unique<DeveloperPrivacyFilter>(reflection_schema);
-    default:
-      return std::make_unique<UserPrivacyFilter>(reflection_schema);
+void CompiledFilter::FilterTable(int index, flatbuffers::Table* table) const {
+  if (index == -1 || table == nullptr) {
+    return;  // table not populated
+  }
+  for (const auto& field : tables_[index].fields) {
+    if (FilterField(*field.field, field.type, field.privacy_level, table)) {
+      continue;  // Field successfully filtered
+    }
+    if (field.sub_table != -1) {
+      FilterTable(field.sub_table, table->GetPointer<flatbuffers::Table*>(field.field->offset()));
+    }
+  }
+}
+
+void CompiledFilter::FilterInPlace(std::string* dumpsys_data) const {
+  ASSERT(dumpsys_data != nullptr);
+  if (root_ == -1) {
+    return;
   }
+  flatbuffers::Table* table =
+      const_cast<flatbuffers::Table*>(flatbuffers::GetRoot<flatbuffers::Table>(dumpsys_data->data()));
+  FilterTable(root_, table);
 }
 
 void bluetooth::dumpsys::FilterInPlace(
     FilterType filter_type, const ReflectionSchema& reflection_schema, std::string* dumpsys_data) {
-  auto filter = Filter::Factory(filter_type, reflection_schema);
-  filter->FilterInPlace(dumpsys_data->data());
+  CompiledFilter(filter_type, reflection_schema).FilterInPlace(dumpsys_data);
 }
@@ -15,6 +15,8 @@
  */
 
 #include <string>
+#include <vector>
+
 #include "dumpsys/reflection_schema.h"
 
 namespace bluetooth {
@@ -22,6 +24,35 @@ namespace dumpsys {
 
 enum FilterType { AS_USER = 0, AS_DEVELOPER };
 
+/**
+ * A privacy filter compiled once from the reflection schema: the fields of every table, their privacy level and the
+ * tables they lead to are resolved when it is built, so that filtering a dump only walks the data.
+ */
+class CompiledFilter {
+ public:
+  CompiledFilter(FilterType filter_type, const ReflectionSchema& reflection_schema);
+  ~CompiledFilter();
+
+  CompiledFilter(const CompiledFilter&) = delete;
+  CompiledFilter& operator=(const CompiledFilter&) = delete;
+
+  void FilterInPlace(std::string* dumpsys_data) const;
+
+ private:
+  struct Field;
+  struct Table;
+
+  // Returns the index of the compiled root table of |schema|, compiling it the first time
+  int CompileSchema(const ReflectionSchema& reflection_schema, const reflection::Schema* schema);
+  // Returns the index of the compiled table of the fields of |object|, which aren't followed
+  int CompileObject(const reflection::Object* object);
+  void FilterTable(int index, flatbuffers::Table* table) const;
+
+  std::vector<Table> tables_;
+  std::vector<std::pair<const reflection::Schema*, int>> compiled_schemas_;
+  int root_ = -1;
+};
+
 void FilterInPlace(FilterType filter_type, const ReflectionSchema& reflection_schema, std::string* dumpsys_data);
 
 }  // namespace dumpsys
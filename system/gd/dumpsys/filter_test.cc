@@ -177,4 +177,26 @@ TEST_F(DumpsysFilterTest, filter_as_user) {
   ASSERT_STREQ("Qux Module String", qux->qux_string_name()->c_str());
 }
 
+TEST_F(DumpsysFilterTest, compiled_filter_multiple_dumps) {
+  dumpsys::ReflectionSchema reflection_schema(testing::GetBundledSchemaData());
+  const dumpsys::CompiledFilter filter(dumpsys::FilterType::AS_USER, reflection_schema);
+
+  std::string first_dumpsys_data = PopulateTestSchema();
+  std::string expected_dumpsys_data = first_dumpsys_data;
+  dumpsys::FilterInPlace(dumpsys::FilterType::AS_USER, reflection_schema, &expected_dumpsys_data);
+
+  // The compiled filter is reused for every dump
+  for (int i = 0; i < 2; i++) {
+    std::string dumpsys_data = first_dumpsys_data;
+    filter.FilterInPlace(&dumpsys_data);
+    ASSERT_EQ(expected_dumpsys_data, dumpsys_data);
+
+    const testing::DumpsysTestDataRoot* data_root = GetDumpsysTestDataRoot(dumpsys_data.data());
+    ASSERT_TRUE(data_root->string_private() == nullptr);
+    ASSERT_TRUE(data_root->int_any() == 0xabc);
+    ASSERT_EQ(nullptr, data_root->baz_module_data()->sub_table_private());
+    ASSERT_EQ(0, data_root->qux_module_data()->qux_int_private());
+  }
+}
+
 }  // namespace testing
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+namespace bluetooth {
+namespace fuzz {
+
+// Measures the time spent by a fuzz target in a parser, from construction to destruction. The executions per second
+// of each parser are printed when the fuzzer exits, which tells apart the parsers of targets fuzzing several of them.
+// Inputs taking longer than BT_FUZZ_SLOW_INPUT_MS milliseconds (10 by default) are reported, as they hint at
+// algorithmic complexity bugs. If BT_FUZZ_ABORT_ON_SLOW_INPUT is set, the fuzzer aborts on them so that libFuzzer
+// saves the input.
+class ScopedParserTimer {
+ public:
+  ScopedParserTimer(const char* parser, size_t size)
+      : parser_(parser), size_(size), start_(std::chrono::steady_clock::now()) {}
+  ScopedParserTimer(const ScopedParserTimer&) = delete;
+  ScopedParserTimer& operator=(const ScopedParserTimer&) = delete;
+
+  ~ScopedParserTimer() {
+    auto duration = std::chrono::steady_clock::now() - start_;
+    Stats& stats = GetStats()[parser_];
+    stats.executions++;
+    stats.duration += duration;
+    if (duration < GetSlowInputThreshold()) {
+      return;
+    }
+    stats.slow_inputs++;
+    fprintf(
+        stderr,
+        "==%s== slow input: %zu bytes parsed in %lld us\n",
+        parser_,
+        size_,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    if (getenv("BT_FUZZ_ABORT_ON_SLOW_INPUT") != nullptr) {
+      abort();
+    }
+  }
+
+ private:
+  struct Stats {
+    uint64_t executions{0};
+    std::chrono::steady_clock::duration duration{};
+    uint64_t slow_inputs{0};
+  };
+
+  static std::map<std::string, Stats>& GetStats() {
+    static std::map<std::string, Stats>* stats = []() {
+      atexit(PrintStats);
+      return new std::map<std::string, Stats>();
+    }();
+    return *stats;
+  }
+
+  static std::chrono::steady_clock::duration GetSlowInputThreshold() {
+    static const std::chrono::milliseconds threshold = []() {
+      const char* value = getenv("BT_FUZZ_SLOW_INPUT_MS");
+      return std::chrono::milliseconds(value != nullptr ? atoi(value) : 10);
+    }();
+    return threshold;
+  }
+
+  static void PrintStats() {
+    for (const auto& [parser, stats] : GetStats()) {
+      double seconds = std::chrono::duration<double>(stats.duration).count();
+      fprintf(
+          stderr,
+          "stat::%s_executions: %llu\nstat::%s_exec_per_sec: %.0f\nstat::%s_slow_inputs: %llu\n",
+          parser.c_str(),
+          static_cast<unsigned long long>(stats.executions),
+          parser.c_str(),
+          seconds > 0 ? stats.executions / seconds : 0.0,
+          parser.c_str(),
+          static_cast<unsigned long long>(stats.slow_inputs));
+    }
+  }
+
+  const char* parser_;
+  size_t size_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace fuzz
+}  // namespace bluetooth
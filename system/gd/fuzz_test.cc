@@ -17,13 +17,24 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "fuzz/parser_timer.h"
+
 void RunL2capClassicDynamicChannelAllocatorFuzzTest(const uint8_t* data, size_t size);
 void RunL2capPacketFuzzTest(const uint8_t* data, size_t size);
 void RunHciPacketFuzzTest(const uint8_t* data, size_t size);
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
-  RunL2capClassicDynamicChannelAllocatorFuzzTest(data, size);
-  RunL2capPacketFuzzTest(data, size);
-  RunHciPacketFuzzTest(data, size);
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("l2cap_classic_dynamic_channel_allocator", size);
+    RunL2capClassicDynamicChannelAllocatorFuzzTest(data, size);
+  }
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("l2cap_packet", size);
+    RunL2capPacketFuzzTest(data, size);
+  }
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("hci_packet", size);
+    RunHciPacketFuzzTest(data, size);
+  }
   return 0;
 }
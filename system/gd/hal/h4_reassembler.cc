@@ -0,0 +1,124 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_reassembler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "os/log.h"
+
+namespace {
+constexpr uint8_t kH4Command = 0x01;
+constexpr uint8_t kH4Acl = 0x02;
+constexpr uint8_t kH4Sco = 0x03;
+constexpr uint8_t kH4Event = 0x04;
+constexpr uint8_t kH4Iso = 0x05;
+
+constexpr size_t kH4HeaderSize = 1;
+constexpr size_t kMaxHciHeaderSize = 4;
+
+size_t hci_header_size(uint8_t type) {
+  switch (type) {
+    case kH4Command:
+      return 3;
+    case kH4Acl:
+      return 4;
+    case kH4Sco:
+      return 3;
+    case kH4Event:
+      return 2;
+    case kH4Iso:
+      return 4;
+  }
+  ASSERT_LOG(false, "Unknown H4 packet type 0x%02x", type);
+  return 0;
+}
+
+size_t hci_payload_size(uint8_t type, const uint8_t* header) {
+  switch (type) {
+    case kH4Command:
+      return header[2];
+    case kH4Acl:
+      return header[2] | (header[3] << 8);
+    case kH4Sco:
+      return header[2];
+    case kH4Event:
+      return header[1];
+    case kH4Iso:
+      return header[2] | ((header[3] & 0x3f) << 8);
+  }
+  return 0;
+}
+}  // namespace
+
+namespace bluetooth {
+namespace hal {
+
+H4Reassembler::H4Reassembler(PacketCallback on_packet) : on_packet_(std::move(on_packet)) {}
+
+uint8_t* H4Reassembler::PrepareReceive(size_t* size) {
+  size_t pending = end_ - begin_;
+  if (buffer_ && pending == 0 && buffer_.use_count() == 1) {
+    // No view refers to the buffer anymore, start over from its beginning
+    begin_ = 0;
+    end_ = 0;
+  }
+
+  // The pending packet must fit in the buffer, or at least its header while its size is not known yet
+  size_t needed = std::max(pending_packet_size(), kH4HeaderSize + kMaxHciHeaderSize);
+  if (!buffer_ || buffer_->size() - end_ < kMinFreeSpace || buffer_->size() - begin_ < needed) {
+    auto buffer = packet::Buffer::Create(std::max(kBufferSize, needed + kMinFreeSpace));
+    if (pending > 0) {
+      std::memcpy(buffer->data(), buffer_->data() + begin_, pending);
+    }
+    buffer_ = std::move(buffer);
+    begin_ = 0;
+    end_ = pending;
+  }
+
+  *size = buffer_->size() - end_;
+  return buffer_->data() + end_;
+}
+
+void H4Reassembler::OnReceived(size_t size) {
+  ASSERT(buffer_ && end_ + size <= buffer_->size());
+  end_ += size;
+  for (size_t packet_size = pending_packet_size(); packet_size != 0 && end_ - begin_ >= packet_size;
+       packet_size = pending_packet_size()) {
+    uint8_t type = buffer_->data()[begin_];
+    packet::View packet(buffer_, begin_ + kH4HeaderSize, begin_ + packet_size);
+    begin_ += packet_size;
+    on_packet_(type, std::move(packet));
+  }
+}
+
+size_t H4Reassembler::pending_packet_size() const {
+  size_t pending = end_ - begin_;
+  if (pending < kH4HeaderSize) {
+    return 0;
+  }
+  const uint8_t* packet = buffer_->data() + begin_;
+  size_t header_size = hci_header_size(packet[0]);
+  if (pending < kH4HeaderSize + header_size) {
+    return 0;
+  }
+  return kH4HeaderSize + header_size + hci_payload_size(packet[0], packet + kH4HeaderSize);
+}
+
+}  // namespace hal
+}  // namespace bluetooth
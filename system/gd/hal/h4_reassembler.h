@@ -0,0 +1,65 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "packet/buffer.h"
+#include "packet/view.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Splits a stream of H4 packets into HCI packets without copying them. As many bytes as the transport has are
+// received at once into a pooled buffer, and every complete packet is handed out as a view on that buffer. Only a
+// packet straddling the end of a buffer is copied, to the start of the next one.
+class H4Reassembler {
+ public:
+  // Invoked with the H4 packet type and the HCI packet, without its H4 header
+  using PacketCallback = std::function<void(uint8_t type, packet::View packet)>;
+
+  // Size of the receive buffers, unless a larger packet needs more
+  static constexpr size_t kBufferSize = packet::Buffer::kMaxPooledCapacity;
+  // A buffer is done with once it has less free space than this
+  static constexpr size_t kMinFreeSpace = 256;
+
+  explicit H4Reassembler(PacketCallback on_packet);
+
+  H4Reassembler(const H4Reassembler&) = delete;
+  H4Reassembler& operator=(const H4Reassembler&) = delete;
+
+  // Return where the next bytes are to be received, and in *size how many of them fit there (at least one)
+  uint8_t* PrepareReceive(size_t* size);
+
+  // Account for size bytes received where PrepareReceive() said, and hand out every packet they completed
+  void OnReceived(size_t size);
+
+ private:
+  // Size of the H4 packet at the start of the unparsed bytes, 0 if its header isn't complete yet
+  size_t pending_packet_size() const;
+
+  PacketCallback on_packet_;
+  packet::SharedBuffer buffer_;
+  // The received bytes that haven't been handed out yet are [begin_, end_) of buffer_
+  size_t begin_ = 0;
+  size_t end_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
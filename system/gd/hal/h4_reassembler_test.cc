@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/h4_reassembler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr uint8_t kH4Acl = 0x02;
+constexpr uint8_t kH4Event = 0x04;
+constexpr uint8_t kH4Iso = 0x05;
+
+struct ReceivedPacket {
+  uint8_t type;
+  std::vector<uint8_t> bytes;
+  const uint8_t* data;
+};
+
+std::vector<uint8_t> make_acl(size_t payload_size, uint8_t fill) {
+  std::vector<uint8_t> packet = {
+      kH4Acl, 0x01, 0x20, static_cast<uint8_t>(payload_size & 0xff), static_cast<uint8_t>(payload_size >> 8)};
+  packet.resize(packet.size() + payload_size, fill);
+  return packet;
+}
+
+std::vector<uint8_t> make_event(size_t payload_size, uint8_t fill) {
+  std::vector<uint8_t> packet = {kH4Event, 0x0e, static_cast<uint8_t>(payload_size)};
+  packet.resize(packet.size() + payload_size, fill);
+  return packet;
+}
+
+std::vector<uint8_t> make_iso(size_t payload_size, uint8_t fill) {
+  std::vector<uint8_t> packet = {
+      kH4Iso, 0x01, 0x20, static_cast<uint8_t>(payload_size & 0xff), static_cast<uint8_t>(payload_size >> 8)};
+  packet.resize(packet.size() + payload_size, fill);
+  return packet;
+}
+
+class H4ReassemblerTest : public ::testing::Test {
+ protected:
+  // Feed the stream in chunks of at most chunk_size bytes
+  void feed(const std::vector<uint8_t>& stream, size_t chunk_size) {
+    size_t offset = 0;
+    while (offset < stream.size()) {
+      size_t size;
+      uint8_t* data = reassembler_.PrepareReceive(&size);
+      ASSERT_GT(size, 0u);
+      size = std::min({size, chunk_size, stream.size() - offset});
+      std::memcpy(data, stream.data() + offset, size);
+      offset += size;
+      reassembler_.OnReceived(size);
+    }
+  }
+
+  void expect_packets(const std::vector<std::vector<uint8_t>>& packets) {
+    ASSERT_EQ(received_.size(), packets.size());
+    for (size_t i = 0; i < packets.size(); i++) {
+      ASSERT_EQ(received_[i].type, packets[i][0]);
+      ASSERT_EQ(received_[i].bytes, std::vector<uint8_t>(packets[i].begin() + 1, packets[i].end()));
+    }
+  }
+
+  std::vector<ReceivedPacket> received_;
+  std::vector<packet::View> views_;
+  H4Reassembler reassembler_{[this](uint8_t type, packet::View packet) {
+    received_.push_back({type, std::vector<uint8_t>(packet.data(), packet.data() + packet.size()), packet.data()});
+    views_.push_back(packet);
+  }};
+};
+
+TEST_F(H4ReassemblerTest, packets_in_one_read) {
+  std::vector<std::vector<uint8_t>> packets = {make_event(4, 0xe0), make_acl(200, 0xa0), make_iso(100, 0x10)};
+  std::vector<uint8_t> stream;
+  for (const auto& packet : packets) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  feed(stream, stream.size());
+  expect_packets(packets);
+  // All the packets were handed out from the same buffer, without being copied
+  ASSERT_EQ(received_[1].data, received_[0].data + packets[0].size());
+  ASSERT_EQ(received_[2].data, received_[1].data + packets[1].size());
+}
+
+TEST_F(H4ReassemblerTest, byte_by_byte) {
+  std::vector<std::vector<uint8_t>> packets = {make_acl(0, 0), make_event(255, 0xe1), make_acl(1021, 0xa1)};
+  std::vector<uint8_t> stream;
+  for (const auto& packet : packets) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  feed(stream, 1);
+  expect_packets(packets);
+}
+
+TEST_F(H4ReassemblerTest, packets_straddling_buffers) {
+  std::vector<std::vector<uint8_t>> packets;
+  std::vector<uint8_t> stream;
+  // Enough data for several buffers, in packets that don't line up with their ends
+  for (int i = 0; i < 40; i++) {
+    packets.push_back(make_acl(300 + i, static_cast<uint8_t>(i)));
+    stream.insert(stream.end(), packets.back().begin(), packets.back().end());
+  }
+  feed(stream, 700);
+  expect_packets(packets);
+}
+
+TEST_F(H4ReassemblerTest, packet_larger_than_buffer) {
+  std::vector<std::vector<uint8_t>> packets = {
+      make_event(2, 0xe2), make_iso(2 * H4Reassembler::kBufferSize, 0x12), make_event(3, 0xe3)};
+  std::vector<uint8_t> stream;
+  for (const auto& packet : packets) {
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  }
+  feed(stream, 1000);
+  expect_packets(packets);
+}
+
+TEST_F(H4ReassemblerTest, buffer_is_reused_once_released) {
+  feed(make_event(4, 0xe4), 100);
+  ASSERT_EQ(received_.size(), 1u);
+  views_.clear();
+  feed(make_event(4, 0xe5), 100);
+  ASSERT_EQ(received_.size(), 2u);
+  ASSERT_EQ(received_[1].data, received_[0].data);
+}
+
+TEST_F(H4ReassemblerTest, unknown_packet_type) {
+  ASSERT_DEATH(feed({0x42, 0x00, 0x00, 0x00, 0x00}, 5), "");
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "module.h"
+#include "packet/base_packet_builder.h"
+#include "packet/bit_inserter.h"
+#include "packet/view.h"
 
 namespace bluetooth {
 namespace hal {
@@ -51,6 +55,21 @@ class HciHalCallbacks {
   // Send an ISO data packet from the controller to the host
   // @param data the ISO HCI packet to be passed to the host stack
   virtual void isoDataReceived(HciPacket data) = 0;
+
+  // Variants of the above for HALs that receive straight into packet buffers, taking a view on the packet. Receivers
+  // that can use the view without copying it should override them; by default the packet is copied to an HciPacket.
+  virtual void hciEventBufferReceived(packet::View event) {
+    hciEventReceived(HciPacket(event.data(), event.data() + event.size()));
+  }
+  virtual void aclDataBufferReceived(packet::View data) {
+    aclDataReceived(HciPacket(data.data(), data.data() + data.size()));
+  }
+  virtual void scoDataBufferReceived(packet::View data) {
+    scoDataReceived(HciPacket(data.data(), data.data() + data.size()));
+  }
+  virtual void isoDataBufferReceived(packet::View data) {
+    isoDataReceived(HciPacket(data.data(), data.data() + data.size()));
+  }
 };
 
 // Mirrors hardware/interfaces/bluetooth/1.0/IBluetoothHci.hal in Android
@@ -88,6 +107,15 @@ class HciHal : public ::bluetooth::Module {
   // Packets must be processed in order.
   virtual void sendAclData(HciPacket data) = 0;
 
+  // Send an HCI ACL data packet that is still a builder. HALs able to transmit from scattered buffers override this
+  // to reference the payload instead of copying it; by default the packet is serialized and sent with sendAclData().
+  virtual void sendAclPacket(std::unique_ptr<packet::BasePacketBuilder> packet) {
+    HciPacket data;
+    packet::BitInserter it(data);
+    packet->Serialize(it);
+    sendAclData(std::move(data));
+  }
+
   // Send an SCO data packet (as specified in the Bluetooth Specification
   // V4.2, Vol 2, Part 5, Section 5.4.3) to the Bluetooth controller.
   // Packets must be processed in order.
@@ -21,12 +21,15 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
+#include <deque>
 #include <mutex>
-#include <queue>
 
 #include "gd/common/init_flags.h"
 #include "hal/hci_hal.h"
@@ -36,6 +39,8 @@
 #include "os/log.h"
 #include "os/reactor.h"
 #include "os/thread.h"
+#include "packet/buffer.h"
+#include "packet/scatter_gather_inserter.h"
 
 namespace {
 constexpr int INVALID_FD = -1;
@@ -52,6 +57,8 @@ constexpr uint8_t kHciScoHeaderSize = 3;
 constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
+// Maximum number of queued packets written with a single syscall
+constexpr size_t kMaxPacketsPerWrite = 32;
 
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
@@ -237,7 +244,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(command);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
     packet.insert(packet.cbegin(), kH4Command);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
   void sendAclData(HciPacket data) override {
@@ -246,7 +253,32 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
     packet.insert(packet.cbegin(), kH4Acl);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
+  }
+
+  void sendAclPacket(std::unique_ptr<packet::BasePacketBuilder> packet) override {
+    std::lock_guard<std::mutex> lock(api_mutex_);
+    ASSERT(sock_fd_ != INVALID_FD);
+    OutgoingPacket outgoing;
+    // The payload is written straight from the builder, only the headers are serialized
+    outgoing.bytes.push_back(kH4Acl);
+    packet::ScatterGatherInserter it(outgoing.bytes);
+    packet->Serialize(it);
+    outgoing.iovecs = it.GetIovecs();
+    outgoing.builder = std::move(packet);
+
+    // The snoop logger may rewrite what it captures, so it gets its own flat copy
+    HciPacket captured;
+    captured.reserve(it.size() - kH4HeaderSize);
+    size_t skipped = kH4HeaderSize;
+    for (const auto& iov : outgoing.iovecs) {
+      auto* data = static_cast<const uint8_t*>(iov.iov_base);
+      size_t skip = std::min(skipped, iov.iov_len);
+      captured.insert(captured.end(), data + skip, data + iov.iov_len);
+      skipped -= skip;
+    }
+    btsnoop_logger_->Capture(captured, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+    enqueue_outgoing(std::move(outgoing));
   }
 
   void sendScoData(HciPacket data) override {
@@ -255,7 +287,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
     packet.insert(packet.cbegin(), kH4Sco);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
   void sendIsoData(HciPacket data) override {
@@ -264,7 +296,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ISO);
     packet.insert(packet.cbegin(), kH4Iso);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
   uint16_t getMsftOpcode() override {
@@ -325,12 +357,28 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  // An H4 packet waiting to be written, as the segments of a single writev
+  struct OutgoingPacket {
+    // The whole packet, or only its headers when the payload is referenced from builder
+    std::vector<uint8_t> bytes;
+    std::unique_ptr<packet::BasePacketBuilder> builder;
+    std::vector<struct iovec> iovecs;
+  };
+  std::deque<OutgoingPacket> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
 
   void write_to_fd(HciPacket packet) {
+    OutgoingPacket outgoing;
+    outgoing.bytes = std::move(packet);
+    outgoing.iovecs = {{outgoing.bytes.data(), outgoing.bytes.size()}};
+    enqueue_outgoing(std::move(outgoing));
+  }
+
+  void enqueue_outgoing(OutgoingPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.push_back(std::move(packet));
+    // Only start waiting for the socket to be writable when the queue stops being empty, packets queued in the
+    // meantime will be written at the same time
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
@@ -339,12 +387,24 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    hci_outgoing_queue_.pop();
-    if (bytes_written == -1) {
+    // Write all the queued packets at once. Each one is a message of its own, so that packet boundaries are kept on
+    // sockets that care about them.
+    std::array<struct mmsghdr, kMaxPacketsPerWrite> messages{};
+    unsigned int num_messages = 0;
+    for (auto& packet_to_send : hci_outgoing_queue_) {
+      if (num_messages == messages.size()) {
+        break;
+      }
+      messages[num_messages].msg_hdr.msg_iov = packet_to_send.iovecs.data();
+      messages[num_messages].msg_hdr.msg_iovlen = packet_to_send.iovecs.size();
+      num_messages++;
+    }
+    int messages_sent;
+    RUN_NO_INTR(messages_sent = sendmmsg(sock_fd_, messages.data(), num_messages, 0));
+    if (messages_sent == -1) {
       abort();
     }
+    hci_outgoing_queue_.erase(hci_outgoing_queue_.begin(), hci_outgoing_queue_.begin() + messages_sent);
     if (hci_outgoing_queue_.empty()) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_ONLY);
     }
@@ -358,10 +418,15 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
+    // Receive the packet straight into a pooled buffer and only keep the H4 header aside, so that the packet can be
+    // handed up without being copied
+    uint8_t h4_type = 0;
+    auto buffer = packet::Buffer::Create(kBufSize - kH4HeaderSize);
+    uint8_t* buf = buffer->data();
+    struct iovec iov[] = {{&h4_type, kH4HeaderSize}, {buf, buffer->size()}};
 
     ssize_t received_size;
-    RUN_NO_INTR(received_size = read(sock_fd_, buf, kBufSize));
+    RUN_NO_INTR(received_size = readv(sock_fd_, iov, 2));
     ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
     if (received_size == 0) {
       LOG_WARN("Can't read H4 header. EOF received");
@@ -371,10 +436,10 @@ class HciHalHost : public HciHal {
       return;
     }
 
-    if (buf[0] == kH4Event) {
+    if (h4_type == kH4Event) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciEvtHeaderSize, "Received bad HCI_EVT packet size: %zu", received_size);
-      uint8_t hci_evt_parameter_total_length = buf[2];
+      uint8_t hci_evt_parameter_total_length = buf[1];
       ssize_t payload_size = received_size - (kH4HeaderSize + kHciEvtHeaderSize);
       ASSERT_LOG(
           payload_size == hci_evt_parameter_total_length,
@@ -382,8 +447,8 @@ class HciHalHost : public HciHal {
           payload_size,
           hci_evt_parameter_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + payload_size);
+      buffer->Truncate(kHciEvtHeaderSize + payload_size);
+      HciPacket receivedHciPacket(buffer->begin(), buffer->end());
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -391,15 +456,15 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventBufferReceived(packet::View(buffer, 0, buffer->size()));
       }
     }
 
-    if (buf[0] == kH4Acl) {
+    if (h4_type == kH4Acl) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciAclHeaderSize, "Received bad HCI_ACL packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciAclHeaderSize);
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
+      uint16_t hci_acl_data_total_length = (buf[3] << 8) + buf[2];
       ASSERT_LOG(
           payload_size == hci_acl_data_total_length,
           "malformed ACL length received: %d != %d",
@@ -407,8 +472,8 @@ class HciHalHost : public HciHal {
           hci_acl_data_total_length);
       ASSERT_LOG(hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize, "packet too long");
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
+      buffer->Truncate(kHciAclHeaderSize + payload_size);
+      HciPacket receivedHciPacket(buffer->begin(), buffer->end());
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -416,23 +481,23 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataBufferReceived(packet::View(buffer, 0, buffer->size()));
       }
     }
 
-    if (buf[0] == kH4Sco) {
+    if (h4_type == kH4Sco) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciScoHeaderSize, "Received bad HCI_SCO packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciScoHeaderSize);
-      uint8_t hci_sco_data_total_length = buf[3];
+      uint8_t hci_sco_data_total_length = buf[2];
       ASSERT_LOG(
           payload_size == hci_sco_data_total_length,
           "malformed SCO length received: %d != %d",
           payload_size,
           hci_sco_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + payload_size);
+      buffer->Truncate(kHciScoHeaderSize + payload_size);
+      HciPacket receivedHciPacket(buffer->begin(), buffer->end());
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -440,23 +505,23 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataBufferReceived(packet::View(buffer, 0, buffer->size()));
       }
     }
 
-    if (buf[0] == kH4Iso) {
+    if (h4_type == kH4Iso) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciIsoHeaderSize, "Received bad HCI_ISO packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciIsoHeaderSize);
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
+      uint16_t hci_iso_data_total_length = ((buf[3] & 0x3f) << 8) + buf[2];
       ASSERT_LOG(
           payload_size == hci_iso_data_total_length,
           "malformed ISO length received: %d != %d",
           payload_size,
           hci_iso_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + payload_size);
+      buffer->Truncate(kHciIsoHeaderSize + payload_size);
+      HciPacket receivedHciPacket(buffer->begin(), buffer->end());
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -464,10 +529,9 @@ class HciHalHost : public HciHal {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataBufferReceived(packet::View(buffer, 0, buffer->size()));
       }
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
@@ -21,19 +21,24 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
+#include <deque>
 #include <mutex>
-#include <queue>
 
+#include "hal/h4_reassembler.h"
 #include "hal/hci_hal.h"
 #include "hal/snoop_logger.h"
 #include "metrics/counter_metrics.h"
 #include "os/log.h"
 #include "os/reactor.h"
 #include "os/thread.h"
+#include "packet/scatter_gather_inserter.h"
 
 namespace {
 constexpr int INVALID_FD = -1;
@@ -45,11 +50,8 @@ constexpr uint8_t kH4Event = 0x04;
 constexpr uint8_t kH4Iso = 0x05;
 
 constexpr uint8_t kH4HeaderSize = 1;
-constexpr uint8_t kHciAclHeaderSize = 4;
-constexpr uint8_t kHciScoHeaderSize = 3;
-constexpr uint8_t kHciEvtHeaderSize = 2;
-constexpr uint8_t kHciIsoHeaderSize = 4;
-constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
+// Maximum number of queued packets written with a single syscall
+constexpr size_t kMaxPacketsPerWrite = 32;
 
 int ConnectToSocket() {
   auto* config = bluetooth::hal::HciHalHostRootcanalConfig::Get();
@@ -126,7 +128,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(command);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
     packet.insert(packet.cbegin(), kH4Command);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
   void sendAclData(HciPacket data) override {
@@ -135,7 +137,32 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
     packet.insert(packet.cbegin(), kH4Acl);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
+  }
+
+  void sendAclPacket(std::unique_ptr<packet::BasePacketBuilder> packet) override {
+    std::lock_guard<std::mutex> lock(api_mutex_);
+    ASSERT(sock_fd_ != INVALID_FD);
+    OutgoingPacket outgoing;
+    // The payload is written straight from the builder, only the headers are serialized
+    outgoing.bytes.push_back(kH4Acl);
+    packet::ScatterGatherInserter it(outgoing.bytes);
+    packet->Serialize(it);
+    outgoing.iovecs = it.GetIovecs();
+    outgoing.builder = std::move(packet);
+
+    // The snoop logger may rewrite what it captures, so it gets its own flat copy
+    HciPacket captured;
+    captured.reserve(it.size() - kH4HeaderSize);
+    size_t skipped = kH4HeaderSize;
+    for (const auto& iov : outgoing.iovecs) {
+      auto* data = static_cast<const uint8_t*>(iov.iov_base);
+      size_t skip = std::min(skipped, iov.iov_len);
+      captured.insert(captured.end(), data + skip, data + iov.iov_len);
+      skipped -= skip;
+    }
+    btsnoop_logger_->Capture(captured, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+    enqueue_outgoing(std::move(outgoing));
   }
 
   void sendScoData(HciPacket data) override {
@@ -144,7 +171,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::SCO);
     packet.insert(packet.cbegin(), kH4Sco);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
   void sendIsoData(HciPacket data) override {
@@ -153,7 +180,7 @@ class HciHalHost : public HciHal {
     std::vector<uint8_t> packet = std::move(data);
     btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ISO);
     packet.insert(packet.cbegin(), kH4Iso);
-    write_to_fd(packet);
+    write_to_fd(std::move(packet));
   }
 
  protected:
@@ -210,12 +237,28 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  // An H4 packet waiting to be written, as the segments of a single writev
+  struct OutgoingPacket {
+    // The whole packet, or only its headers when the payload is referenced from builder
+    std::vector<uint8_t> bytes;
+    std::unique_ptr<packet::BasePacketBuilder> builder;
+    std::vector<struct iovec> iovecs;
+  };
+  std::deque<OutgoingPacket> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
 
   void write_to_fd(HciPacket packet) {
+    OutgoingPacket outgoing;
+    outgoing.bytes = std::move(packet);
+    outgoing.iovecs = {{outgoing.bytes.data(), outgoing.bytes.size()}};
+    enqueue_outgoing(std::move(outgoing));
+  }
+
+  void enqueue_outgoing(OutgoingPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
+    hci_outgoing_queue_.push_back(std::move(packet));
+    // Only start waiting for the socket to be writable when the queue stops being empty, packets queued in the
+    // meantime will be written at the same time
     if (hci_outgoing_queue_.size() == 1) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_WRITE);
     }
@@ -224,31 +267,29 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    hci_outgoing_queue_.pop();
-    if (bytes_written == -1) {
+    // Write all the queued packets at once. Each one is a message of its own, so that packet boundaries are kept on
+    // sockets that care about them.
+    std::array<struct mmsghdr, kMaxPacketsPerWrite> messages{};
+    unsigned int num_messages = 0;
+    for (auto& packet_to_send : hci_outgoing_queue_) {
+      if (num_messages == messages.size()) {
+        break;
+      }
+      messages[num_messages].msg_hdr.msg_iov = packet_to_send.iovecs.data();
+      messages[num_messages].msg_hdr.msg_iovlen = packet_to_send.iovecs.size();
+      num_messages++;
+    }
+    int messages_sent;
+    RUN_NO_INTR(messages_sent = sendmmsg(sock_fd_, messages.data(), num_messages, 0));
+    if (messages_sent == -1) {
       abort();
     }
+    hci_outgoing_queue_.erase(hci_outgoing_queue_.begin(), hci_outgoing_queue_.begin() + messages_sent);
     if (hci_outgoing_queue_.empty()) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_ONLY);
     }
   }
 
-  bool socketRecvAll(void* buffer, int bufferLen) {
-    auto buf = static_cast<char*>(buffer);
-    while (bufferLen > 0) {
-      ssize_t ret;
-      RUN_NO_INTR(ret = recv(sock_fd_, buf, bufferLen, 0));
-      if (ret <= 0) {
-        return false;
-      }
-      buf += ret;
-      bufferLen -= ret;
-    }
-    return true;
-  }
-
   void incoming_packet_received() {
     {
       std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -257,114 +298,71 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
+    // Take whatever the socket has, the reassembler hands out every packet it completes
+    size_t size;
+    uint8_t* buf = h4_reassembler_.PrepareReceive(&size);
 
     ssize_t received_size;
-    RUN_NO_INTR(received_size = recv(sock_fd_, buf, kH4HeaderSize, 0));
+    RUN_NO_INTR(received_size = recv(sock_fd_, buf, size, 0));
     ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
     if (received_size == 0) {
       LOG_WARN("Can't read H4 header. EOF received");
       raise(SIGINT);
       return;
     }
+    h4_reassembler_.OnReceived(received_size);
+  }
 
-    if (buf[0] == kH4Event) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciEvtHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint8_t hci_evt_parameter_total_length = buf[2];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciEvtHeaderSize, hci_evt_parameter_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + hci_evt_parameter_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
-      {
+  void on_h4_packet(uint8_t type, packet::View packet) {
+    HciPacket receivedHciPacket(packet.data(), packet.data() + packet.size());
+    switch (type) {
+      case kH4Event: {
+        btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventBufferReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Acl) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciAclHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciAclHeaderSize, hci_acl_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + hci_acl_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
-      {
+      case kH4Acl: {
+        btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataBufferReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Sco) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciScoHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint8_t hci_sco_data_total_length = buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciScoHeaderSize, hci_sco_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + hci_sco_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
-      {
+      case kH4Sco: {
+        btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataBufferReceived(std::move(packet));
+        break;
       }
-    }
-
-    if (buf[0] == kH4Iso) {
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize, kHciIsoHeaderSize), "Can't receive from socket: %s", strerror(errno));
-
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
-      ASSERT_LOG(
-          socketRecvAll(buf + kH4HeaderSize + kHciIsoHeaderSize, hci_iso_data_total_length),
-          "Can't receive from socket: %s",
-          strerror(errno));
-
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + hci_iso_data_total_length);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
-      {
+      case kH4Iso: {
+        btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataBufferReceived(std::move(packet));
+        break;
       }
+      default:
+        LOG_WARN("Dropping an H4 packet of type 0x%02x", type);
+        break;
     }
-    memset(buf, 0, kBufSize);
   }
+
+  H4Reassembler h4_reassembler_{[this](uint8_t type, packet::View packet) { on_h4_packet(type, std::move(packet)); }};
 };
 
 const ModuleFactory HciHal::Factory = ModuleFactory([]() { return new HciHalHost(); });
@@ -26,6 +26,7 @@
 #include <unistd.h>
 
 #include <cstring>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <utility>
@@ -371,6 +372,18 @@ TEST_F(HciHalRootcanalTest, send_acl) {
   check_packet_equal({kH4Acl, acl_packet}, read_buf);
 }
 
+TEST_F(HciHalRootcanalTest, send_acl_packet) {
+  uint8_t acl_payload_size = 200;
+  HciPacket acl_packet = make_sample_hci_acl_pkt(acl_payload_size);
+  hal_->sendAclPacket(std::make_unique<packet::RawBuilder>(acl_packet));
+  H4Packet read_buf(1 + 2 + 2 + acl_payload_size);
+  SetFakeServerSocketToBlocking();
+  auto size_read = read_with_retry(fake_server_socket_, read_buf.data(), read_buf.size());
+
+  ASSERT_EQ(size_read, 1 + acl_packet.size());
+  check_packet_equal({kH4Acl, acl_packet}, read_buf);
+}
+
 TEST_F(HciHalRootcanalTest, send_sco) {
   uint8_t sco_payload_size = 200;
   HciPacket sco_packet = make_sample_hci_sco_pkt(sco_payload_size);
@@ -18,11 +18,11 @@
 
 #include <arpa/inet.h>
 #include <sys/stat.h>
+#include <zlib.h>
 
 #include <algorithm>
 #include <bitset>
 #include <chrono>
-#include <sstream>
 
 #include "common/circular_buffer.h"
 #include "common/init_flags.h"
@@ -84,6 +84,144 @@ bool FilterTracker::IsAcceptlistedDlci(uint8_t dlci) {
   return rfcomm_channels.find(dlci) != rfcomm_channels.end();
 }
 
+ChannelFilterTable::Connection* ChannelFilterTable::GetConnection(uint16_t handle, bool create) {
+  handle &= kMaxHandles - 1;
+  if (connection_index_[handle] != 0) {
+    return &connections_[connection_index_[handle] - 1];
+  }
+  if (!create) {
+    return nullptr;
+  }
+
+  size_t index = 0;
+  while (index < connections_.size() && connections_[index].handle != kMaxHandles) {
+    index++;
+  }
+  if (index == connections_.size()) {
+    if (index == UINT8_MAX) {
+      LOG_WARN("Too many connections to filter, ignoring handle 0x%x", handle);
+      return nullptr;
+    }
+    connections_.emplace_back();
+  }
+  connections_[index] = {.handle = handle};
+  connection_index_[handle] = index + 1;
+  return &connections_[index];
+}
+
+const ChannelFilterTable::Connection* ChannelFilterTable::GetConnection(uint16_t handle) const {
+  uint8_t index = connection_index_[handle & (kMaxHandles - 1)];
+  return index != 0 ? &connections_[index - 1] : nullptr;
+}
+
+void ChannelFilterTable::ReleaseConnectionIfUnused(Connection* connection) {
+  if (connection->channels.empty() && connection->rfcomm_dlcis == 1) {
+    connection_index_[connection->handle] = 0;
+    connection->handle = kMaxHandles;
+  }
+}
+
+void ChannelFilterTable::UpdateChannel(uint16_t handle, bool local, uint16_t cid, uint8_t flag, bool set) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Connection* connection = GetConnection(handle, set);
+  if (connection == nullptr) {
+    return;
+  }
+
+  auto channel = std::find_if(connection->channels.begin(), connection->channels.end(), [&](const Channel& entry) {
+    return entry.cid == cid && entry.local == local;
+  });
+  if (channel == connection->channels.end()) {
+    if (!set) {
+      return;
+    }
+    channel = connection->channels.insert(channel, {.cid = cid, .local = local, .flags = 0});
+  }
+
+  if (set) {
+    channel->flags |= flag;
+  } else {
+    channel->flags &= ~flag;
+  }
+  if (channel->flags == 0) {
+    connection->channels.erase(channel);
+    ReleaseConnectionIfUnused(connection);
+  }
+}
+
+void ChannelFilterTable::ClearChannels(uint16_t handle, uint8_t flag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Connection* connection = GetConnection(handle, false);
+  if (connection == nullptr) {
+    return;
+  }
+
+  for (auto& channel : connection->channels) {
+    channel.flags &= ~flag;
+  }
+  connection->channels.erase(
+      std::remove_if(
+          connection->channels.begin(),
+          connection->channels.end(),
+          [](const Channel& channel) { return channel.flags == 0; }),
+      connection->channels.end());
+  ReleaseConnectionIfUnused(connection);
+}
+
+uint8_t ChannelFilterTable::GetChannelFlags(uint16_t handle, bool local, uint16_t cid) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Connection* connection = GetConnection(handle);
+  if (connection == nullptr) {
+    return 0;
+  }
+
+  for (const auto& channel : connection->channels) {
+    if (channel.cid == cid && channel.local == local) {
+      return channel.flags;
+    }
+  }
+  return 0;
+}
+
+void ChannelFilterTable::AddRfcommDlci(uint16_t handle, uint8_t dlci) {
+  // The DLCI of the RFCOMM frames is 6 bits long
+  if (dlci >= 64) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Connection* connection = GetConnection(handle, true);
+  if (connection != nullptr) {
+    connection->rfcomm_dlcis |= 1ULL << dlci;
+  }
+}
+
+void ChannelFilterTable::ClearRfcommDlcis(uint16_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Connection* connection = GetConnection(handle, false);
+  if (connection != nullptr) {
+    connection->rfcomm_dlcis = 1;
+    ReleaseConnectionIfUnused(connection);
+  }
+}
+
+bool ChannelFilterTable::IsAcceptlistedDlci(uint16_t handle, uint8_t dlci) const {
+  if (dlci >= 64) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Connection* connection = GetConnection(handle);
+  uint64_t rfcomm_dlcis = connection != nullptr ? connection->rfcomm_dlcis : 1;
+  return (rfcomm_dlcis >> dlci) & 1;
+}
+
+void ChannelFilterTable::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  connection_index_.fill(0);
+  connections_.clear();
+}
+
 void ProfilesFilter::SetupProfilesFilter(bool pbap_filtered, bool map_filtered) {
   if (setup_done_flag) {
     return;
@@ -297,6 +435,17 @@ constexpr size_t kDefaultBtSnoozMaxBytesPerPacket = 150;
 constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
     kDefaultBtSnoozMaxBytesPerPacket - sizeof(SnoopLogger::PacketHeaderType);
 
+// Number of packets the capture ring holds for the btsnoop writer thread, must be a power of 2
+constexpr size_t kBtSnoopWriterRingSize = 2048;
+// The writer thread is woken up once this many packets are queued, and otherwise writes on each interval
+constexpr size_t kBtSnoopWriterWakeupPackets = kBtSnoopWriterRingSize / 4;
+constexpr std::chrono::milliseconds kBtSnoopWriterInterval = std::chrono::milliseconds(50);
+// Size of the blocks written to the btsnoop log at once, and of the chunks of the compressed log
+constexpr size_t kBtSnoopWriterBlockSize = 64 * 1024;
+// A chunk of the compressed log is written once it is full or after this interval, which bounds how much of the
+// log is lost if the process crashes.
+constexpr std::chrono::seconds kBtSnoopCompressedChunkInterval = std::chrono::seconds(5);
+
 using namespace std::chrono_literals;
 constexpr std::chrono::hours kBtSnoozLogLifeTime = 12h;
 constexpr std::chrono::hours kBtSnoozLogDeleteRepeatingAlarmInterval = 1h;
@@ -305,6 +454,15 @@ std::mutex filter_tracker_list_mutex;
 std::unordered_map<uint16_t, FilterTracker> filter_tracker_list;
 std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 
+// The channels of |filter_tracker_list| and |a2dpMediaChannels|, looked up for each captured packet
+ChannelFilterTable channel_filter_table;
+
+// Bits of SnoopLogger::enabled_filters_
+constexpr uint8_t kFilterHeaders = 1 << 0;
+constexpr uint8_t kFilterA2dp = 1 << 1;
+constexpr uint8_t kFilterRfcomm = 1 << 2;
+constexpr uint8_t kFilterProfiles = 1 << 3;
+
 std::mutex a2dpMediaChannels_mutex;
 std::vector<SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
 
@@ -326,6 +484,10 @@ std::string get_btsnoop_log_path(std::string log_dir, bool filtered) {
   return log_dir;
 }
 
+std::string get_compressed_log_path(std::string log_file_path) {
+  return log_file_path.append(".z");
+}
+
 std::string get_last_log_path(std::string log_file_path) {
   return log_file_path.append(".last");
 }
@@ -435,6 +597,7 @@ const std::string SnoopLogger::kBtSnoopMaxPacketsPerFileProperty = "persist.blue
 const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
+const std::string SnoopLogger::kBtSnoopLogCompressedProperty = "persist.bluetooth.btsnoopcompressed";
 const std::string SnoopLogger::kBtSnoopLogPersists = "persist.bluetooth.btsnooplogpersists";
 // Truncates ACL packets (non-fragment) to fixed (MAX_HCI_ACL_LEN) number of bytes
 const std::string SnoopLogger::kBtSnoopLogFilterHeadersProperty =
@@ -485,7 +648,8 @@ SnoopLogger::SnoopLogger(
     bool qualcomm_debug_log_enabled,
     const std::chrono::milliseconds snooz_log_life_time,
     const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-    bool snoop_log_persists)
+    bool snoop_log_persists,
+    bool snoop_log_compressed)
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
       max_packets_per_file_(max_packets_per_file),
@@ -493,7 +657,9 @@ SnoopLogger::SnoopLogger(
       qualcomm_debug_log_enabled_(qualcomm_debug_log_enabled),
       snooz_log_life_time_(snooz_log_life_time),
       snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval),
+      snoop_log_compressed_(snoop_log_compressed),
       snoop_log_persists(snoop_log_persists) {
+  static_assert((kBtSnoopWriterRingSize & (kBtSnoopWriterRingSize - 1)) == 0, "ring size must be a power of 2");
   btsnoop_mode_ = btsnoop_mode;
 
   if (btsnoop_mode_ == kBtSnoopLogModeFiltered &&
@@ -521,12 +687,24 @@ SnoopLogger::SnoopLogger(
     // delete both filtered and unfiltered logs
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
+    delete_btsnoop_files(get_compressed_log_path(get_btsnoop_log_path(snoop_log_path_, true)));
+    delete_btsnoop_files(get_compressed_log_path(get_btsnoop_log_path(snoop_log_path_, false)));
   }
 
   snoop_logger_socket_thread_ = nullptr;
   socket_ = nullptr;
   // Add ".filtered" extension if necessary
   snoop_log_path_ = get_btsnoop_log_path(snoop_log_path_, btsnoop_mode_ == kBtSnoopLogModeFiltered);
+  if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
+    // Only keep the logs of the format in use
+    if (snoop_log_compressed_) {
+      LOG_INFO("Snoop Logs compressed");
+      delete_btsnoop_files(snoop_log_path_);
+      snoop_log_path_ = get_compressed_log_path(snoop_log_path_);
+    } else {
+      delete_btsnoop_files(get_compressed_log_path(snoop_log_path_));
+    }
+  }
 }
 
 void SnoopLogger::CloseCurrentSnoopLogFile() {
@@ -565,9 +743,10 @@ void SnoopLogger::OpenNextSnoopLogFile() {
     LOG_ALWAYS_FATAL("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   umask(prevmask);
-  if (!btsnoop_ostream_.write(
-          reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
-          sizeof(SnoopLoggerCommon::FileHeaderType))) {
+  const SnoopLoggerCommon::FileHeaderType& file_header = snoop_log_compressed_
+                                                             ? SnoopLoggerCommon::kBtSnoopCompressedFileHeader
+                                                             : SnoopLoggerCommon::kBtSnoopFileHeader;
+  if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&file_header), sizeof(SnoopLoggerCommon::FileHeaderType))) {
     LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   if (!btsnoop_ostream_.flush()) {
@@ -579,7 +758,7 @@ void SnoopLogger::EnableFilters() {
   if (btsnoop_mode_ != kBtSnoopLogModeFiltered) {
     return;
   }
-  std::lock_guard<std::mutex> lock(snoop_log_filters_mutex);
+  std::unique_lock<std::mutex> lock(snoop_log_filters_mutex);
   for (auto itr = kBtSnoopLogFilterState.begin(); itr != kBtSnoopLogFilterState.end(); itr++) {
     auto filter_enabled_property = os::GetSystemProperty(itr->first);
     if (filter_enabled_property) {
@@ -596,10 +775,12 @@ void SnoopLogger::EnableFilters() {
     }
     LOG_INFO("%s: %s", itr->first.c_str(), itr->second.c_str());
   }
+  lock.unlock();
+  UpdateEnabledFilters();
 }
 
 void SnoopLogger::DisableFilters() {
-  std::lock_guard<std::mutex> lock(snoop_log_filters_mutex);
+  std::unique_lock<std::mutex> lock(snoop_log_filters_mutex);
   for (auto itr = kBtSnoopLogFilterState.begin(); itr != kBtSnoopLogFilterState.end(); itr++) {
     itr->second = false;
     LOG_INFO("%s, %d", itr->first.c_str(), itr->second);
@@ -608,6 +789,37 @@ void SnoopLogger::DisableFilters() {
     itr->second = SnoopLogger::kBtSnoopLogFilterProfileModeDisabled;
     LOG_INFO("%s, %s", itr->first.c_str(), itr->second.c_str());
   }
+  lock.unlock();
+  UpdateEnabledFilters();
+
+  // The connections are gone, forget their channels
+  {
+    std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
+    filter_tracker_list.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
+    a2dpMediaChannels.clear();
+  }
+  channel_filter_table.Clear();
+}
+
+void SnoopLogger::UpdateEnabledFilters() {
+  uint8_t enabled_filters = 0;
+  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
+    enabled_filters |= kFilterHeaders;
+  }
+  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+    enabled_filters |= kFilterA2dp;
+  }
+  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+    enabled_filters |= kFilterRfcomm;
+  }
+  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
+      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
+    enabled_filters |= kFilterProfiles;
+  }
+  enabled_filters_ = enabled_filters;
 }
 
 bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
@@ -626,22 +838,22 @@ bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
 }
 
 bool SnoopLogger::ShouldFilterLog(bool is_received, uint8_t* packet) {
+  constexpr uint16_t L2CAP_SIGNALING_CID = 0x0001;
   uint16_t conn_handle =
       ((((uint16_t)packet[ACL_CHANNEL_OFFSET + 1]) << 8) + packet[ACL_CHANNEL_OFFSET]) & 0x0fff;
-  std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
-  auto& filters = filter_tracker_list[conn_handle];
   uint16_t cid = (packet[L2CAP_CHANNEL_OFFSET + 1] << 8) + packet[L2CAP_CHANNEL_OFFSET];
-  if (filters.IsRfcommChannel(is_received, cid)) {
+  uint8_t flags = channel_filter_table.GetChannelFlags(conn_handle, is_received, cid);
+  if (flags & ChannelFilterTable::kRfcomm) {
     uint8_t rfcomm_event = packet[RFCOMM_EVENT_OFFSET] & 0b11101111;
     if (rfcomm_event == RFCOMM_SABME || rfcomm_event == RFCOMM_UA) {
       return false;
     }
 
     uint8_t rfcomm_dlci = packet[RFCOMM_CHANNEL_OFFSET] >> 2;
-    if (!filters.IsAcceptlistedDlci(rfcomm_dlci)) {
+    if (!channel_filter_table.IsAcceptlistedDlci(conn_handle, rfcomm_dlci)) {
       return true;
     }
-  } else if (!filters.IsAcceptlistedL2cap(is_received, cid)) {
+  } else if (cid != L2CAP_SIGNALING_CID && !(flags & ChannelFilterTable::kL2capAcceptlisted)) {
     return true;
   }
 
@@ -892,6 +1104,8 @@ void SnoopLogger::AcceptlistL2capChannel(
   // This will create the entry if there is no associated filter with the
   // connection.
   filter_tracker_list[conn_handle].AddL2capCid(local_cid, remote_cid);
+  channel_filter_table.UpdateChannel(conn_handle, true, local_cid, ChannelFilterTable::kL2capAcceptlisted, true);
+  channel_filter_table.UpdateChannel(conn_handle, false, remote_cid, ChannelFilterTable::kL2capAcceptlisted, true);
 }
 
 void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid, uint8_t dlci) {
@@ -904,6 +1118,7 @@ void SnoopLogger::AcceptlistRfcommDlci(uint16_t conn_handle, uint16_t local_cid,
   std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
 
   filter_tracker_list[conn_handle].AddRfcommDlci(dlci);
+  channel_filter_table.AddRfcommDlci(conn_handle, dlci);
 }
 
 void SnoopLogger::AddRfcommL2capChannel(
@@ -922,6 +1137,10 @@ void SnoopLogger::AddRfcommL2capChannel(
 
   filter_tracker_list[conn_handle].SetRfcommCid(local_cid, remote_cid);
   local_cid_to_acl.insert({local_cid, conn_handle});
+  // A connection has one RFCOMM channel
+  channel_filter_table.ClearChannels(conn_handle, ChannelFilterTable::kRfcomm);
+  channel_filter_table.UpdateChannel(conn_handle, true, local_cid, ChannelFilterTable::kRfcomm, true);
+  channel_filter_table.UpdateChannel(conn_handle, false, remote_cid, ChannelFilterTable::kRfcomm, true);
 }
 
 void SnoopLogger::ClearL2capAcceptlist(
@@ -938,7 +1157,14 @@ void SnoopLogger::ClearL2capAcceptlist(
       remote_cid);
   std::lock_guard<std::mutex> lock(filter_tracker_list_mutex);
 
-  filter_tracker_list[conn_handle].RemoveL2capCid(local_cid, remote_cid);
+  auto& filters = filter_tracker_list[conn_handle];
+  if (filters.IsRfcommChannel(true, local_cid)) {
+    channel_filter_table.ClearChannels(conn_handle, ChannelFilterTable::kRfcomm);
+    channel_filter_table.ClearRfcommDlcis(conn_handle);
+  }
+  filters.RemoveL2capCid(local_cid, remote_cid);
+  channel_filter_table.UpdateChannel(conn_handle, true, local_cid, ChannelFilterTable::kL2capAcceptlisted, false);
+  channel_filter_table.UpdateChannel(conn_handle, false, remote_cid, ChannelFilterTable::kL2capAcceptlisted, false);
 }
 
 bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
@@ -971,7 +1197,7 @@ bool SnoopLogger::IsA2dpMediaPacket(bool is_received, uint8_t* packet) {
   conn_handle = (uint16_t)((packet[0] + (packet[1] << 8)) & 0x0FFF);
   cid = (uint16_t)(packet[6] + (packet[7] << 8));
 
-  return IsA2dpMediaChannel(conn_handle, cid, is_local_cid);
+  return channel_filter_table.GetChannelFlags(conn_handle, is_local_cid, cid) & ChannelFilterTable::kA2dpMedia;
 }
 
 void SnoopLogger::AddA2dpMediaChannel(
@@ -989,6 +1215,8 @@ void SnoopLogger::AddA2dpMediaChannel(
         remote_cid);
     std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
     a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    channel_filter_table.UpdateChannel(conn_handle, true, local_cid, ChannelFilterTable::kA2dpMedia, true);
+    channel_filter_table.UpdateChannel(conn_handle, false, remote_cid, ChannelFilterTable::kA2dpMedia, true);
   }
 }
 
@@ -999,14 +1227,17 @@ void SnoopLogger::RemoveA2dpMediaChannel(uint16_t conn_handle, uint16_t local_ci
   }
 
   std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  a2dpMediaChannels.erase(
-      std::remove_if(
-          a2dpMediaChannels.begin(),
-          a2dpMediaChannels.end(),
-          [conn_handle, local_cid](auto& el) {
-            return (el.conn_handle == conn_handle && el.local_cid == local_cid);
-          }),
-      a2dpMediaChannels.end());
+  auto removed = std::stable_partition(
+      a2dpMediaChannels.begin(),
+      a2dpMediaChannels.end(),
+      [conn_handle, local_cid](auto& el) {
+        return !(el.conn_handle == conn_handle && el.local_cid == local_cid);
+      });
+  for (auto it = removed; it != a2dpMediaChannels.end(); it++) {
+    channel_filter_table.UpdateChannel(conn_handle, true, it->local_cid, ChannelFilterTable::kA2dpMedia, false);
+    channel_filter_table.UpdateChannel(conn_handle, false, it->remote_cid, ChannelFilterTable::kA2dpMedia, false);
+  }
+  a2dpMediaChannels.erase(removed, a2dpMediaChannels.end());
 }
 
 void SnoopLogger::SetRfcommPortOpen(
@@ -1158,19 +1389,19 @@ void SnoopLogger::FilterCapturedPacket(
     return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  uint8_t enabled_filters = enabled_filters_;
+  if (enabled_filters & kFilterA2dp) {
     if (IsA2dpMediaPacket(direction == Direction::INCOMING, (uint8_t*)packet.data())) {
       length = 0;
       return;
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
+  if (enabled_filters & kFilterHeaders) {
     CalculateAclPacketLength(length, (uint8_t*)packet.data(), direction == Direction::INCOMING);
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
-      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
+  if (enabled_filters & kFilterProfiles) {
     // If HeadersFiltered applied, do not use ProfilesFiltered
     if (length == ntohl(header.length_original)) {
       if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
@@ -1184,7 +1415,7 @@ void SnoopLogger::FilterCapturedPacket(
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
+  if (enabled_filters & kFilterRfcomm) {
     bool shouldFilter =
         SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, (uint8_t*)packet.data());
     if (shouldFilter) {
@@ -1218,23 +1449,20 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
   PacketHeaderType header = {.length_original = htonl(length),
                              .length_captured = htonl(length),
                              .flags = htonl(static_cast<uint32_t>(flags.to_ulong())),
-                             .dropped_packets = 0,
+                             .dropped_packets = htonl(static_cast<uint32_t>(dropped_packets_.load())),
                              .timestamp = htonll(timestamp_us + kBtSnoopEpochDelta),
                              .type = static_cast<uint8_t>(type)};
   {
     std::lock_guard<std::recursive_mutex> lock(file_mutex_);
     if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
       // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
       size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
       header.length_captured = htonl(included_length + /* type byte */ PACKET_TYPE_LENGTH);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      btsnooz_buffer_.Push(ss.str());
+      std::string record;
+      record.reserve(sizeof(PacketHeaderType) + included_length);
+      record.append(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+      record.append(reinterpret_cast<const char*>(packet.data()), included_length);
+      btsnooz_buffer_.Push(std::move(record));
       return;
     }
 
@@ -1246,29 +1474,183 @@ void SnoopLogger::Capture(HciPacket& packet, Direction direction, PacketType typ
       header.length_captured = htonl(length);
     }
 
+    // The btsnoop log file is written by the writer thread
+    PushWriterRecord(header, packet.data(), length - /* type byte */ PACKET_TYPE_LENGTH);
+
+    if (socket_ != nullptr) {
+      // One write per record, so that a client queue never holds half a record. The payload is the one of the file
+      // record, which is truncated in filtered mode.
+      std::string record(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+      record.append(reinterpret_cast<const char*>(packet.data()), length - /* type byte */ PACKET_TYPE_LENGTH);
+      socket_->Write(record.data(), record.size());
+    }
+  }
+}
+
+uint64_t SnoopLogger::GetDroppedPackets() const {
+  return dropped_packets_.load();
+}
+
+void SnoopLogger::PushWriterRecord(const PacketHeaderType& header, const uint8_t* data, size_t length) {
+  size_t tail = writer_ring_tail_.load(std::memory_order_relaxed);
+  size_t queued = tail - writer_ring_head_.load(std::memory_order_acquire);
+  if (writer_ring_.empty() || queued == writer_ring_.size()) {
+    if (dropped_packets_.fetch_add(1) == 0) {
+      LOG_WARN("btsnoop writer can't keep up, dropping packets");
+    }
+    return;
+  }
+
+  // The slots keep their capacity, so the ring does not allocate once it has wrapped around
+  std::string& record = writer_ring_[tail & (writer_ring_.size() - 1)];
+  record.assign(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+  record.append(reinterpret_cast<const char*>(data), length);
+  writer_ring_tail_.store(tail + 1, std::memory_order_release);
+
+  if (queued + 1 == kBtSnoopWriterWakeupPackets) {
+    writer_cv_.notify_one();
+  }
+}
+
+bool SnoopLogger::DrainWriterRing() {
+  size_t head = writer_ring_head_.load(std::memory_order_relaxed);
+  size_t tail = writer_ring_tail_.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+
+  for (; head != tail; head++) {
     packet_counter_++;
     if (packet_counter_ > max_packets_per_file_) {
+      WriteWriterBlock(/* end_chunk= */ true);
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-      LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
+    const std::string& record = writer_ring_[head & (writer_ring_.size() - 1)];
+    if (snoop_log_compressed_) {
+      PacketHeaderType header;
+      memcpy(&header, record.data(), sizeof(PacketHeaderType));
+      if (chunk_header_.packets == 0) {
+        chunk_header_.first_timestamp = header.timestamp;
+        chunk_start_time_ = std::chrono::steady_clock::now();
+      }
+      chunk_header_.last_timestamp = header.timestamp;
+      chunk_header_.packets++;
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), length - 1)) {
-      LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
+    writer_block_.append(record);
+    // Hand the slot back to Capture() as soon as it is copied
+    writer_ring_head_.store(head + 1, std::memory_order_release);
+    if (writer_block_.size() >= kBtSnoopWriterBlockSize) {
+      WriteWriterBlock(/* end_chunk= */ false);
     }
+  }
 
-    if (socket_ != nullptr) {
-      socket_->Write(&header, sizeof(PacketHeaderType));
-      socket_->Write(packet.data(), packet.size());
+  WriteWriterBlock(/* end_chunk= */ false);
+  // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
+  // crashes, up to the packets still queued in the capture ring. However, data will be lost if there is a kernel
+  // panic, which is out of scope of BT snoop log.
+  if (!btsnoop_ostream_.flush()) {
+    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+  }
+  return true;
+}
+
+void SnoopLogger::WriteWriterBlock(bool end_chunk) {
+  if (writer_block_.empty()) {
+    return;
+  }
+
+  if (!snoop_log_compressed_) {
+    if (!btsnoop_ostream_.write(writer_block_.data(), writer_block_.size())) {
+      LOG_ERROR("Failed to write packets for btsnoop, error: \"%s\"", strerror(errno));
+    }
+    writer_block_.clear();
+    return;
+  }
+
+  if (!end_chunk && writer_block_.size() < kBtSnoopWriterBlockSize &&
+      std::chrono::steady_clock::now() - chunk_start_time_ < kBtSnoopCompressedChunkInterval) {
+    return;
+  }
+
+  uLongf compressed_length = compressBound(writer_block_.size());
+  compressed_chunk_.resize(compressed_length);
+  int ret = compress2(
+      compressed_chunk_.data(),
+      &compressed_length,
+      reinterpret_cast<const Bytef*>(writer_block_.data()),
+      writer_block_.size(),
+      Z_BEST_SPEED);
+  if (ret != Z_OK) {
+    LOG_ERROR("Failed to compress %zu packets for btsnoop, error: %d", (size_t)chunk_header_.packets, ret);
+  } else {
+    SnoopLoggerCommon::ChunkHeaderType chunk_header = {
+        .compressed_length = htonl(static_cast<uint32_t>(compressed_length)),
+        .original_length = htonl(static_cast<uint32_t>(writer_block_.size())),
+        .packets = htonl(chunk_header_.packets),
+        .first_timestamp = chunk_header_.first_timestamp,
+        .last_timestamp = chunk_header_.last_timestamp};
+    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&chunk_header), sizeof(chunk_header)) ||
+        !btsnoop_ostream_.write(reinterpret_cast<const char*>(compressed_chunk_.data()), compressed_length)) {
+      LOG_ERROR("Failed to write packets for btsnoop, error: \"%s\"", strerror(errno));
     }
+  }
+  writer_block_.clear();
+  chunk_header_ = {};
+}
+
+void SnoopLogger::StartWriterThread() {
+  writer_ring_.resize(kBtSnoopWriterRingSize);
+  writer_ring_head_ = 0;
+  writer_ring_tail_ = 0;
+  dropped_packets_ = 0;
+  writer_block_.reserve(kBtSnoopWriterBlockSize);
+  chunk_header_ = {};
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    writer_thread_running_ = true;
+  }
+  writer_thread_ = std::make_unique<std::thread>(&SnoopLogger::RunWriterThread, this);
+}
+
+void SnoopLogger::StopWriterThread() {
+  if (writer_thread_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    writer_thread_running_ = false;
+  }
+  writer_cv_.notify_one();
+  if (writer_thread_->joinable()) {
+    writer_thread_->join();
+  }
+  writer_thread_.reset();
+  if (dropped_packets_ > 0) {
+    LOG_WARN("btsnoop writer dropped %llu packets", static_cast<unsigned long long>(dropped_packets_.load()));
+  }
+}
 
-    // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
-    // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
-    // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
-    //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
-      LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+void SnoopLogger::RunWriterThread() {
+  std::unique_lock<std::mutex> lock(writer_mutex_);
+  while (writer_thread_running_) {
+    writer_cv_.wait_for(lock, kBtSnoopWriterInterval);
+    lock.unlock();
+    if (!DrainWriterRing() && snoop_log_compressed_ && !writer_block_.empty()) {
+      // Write the pending chunk once it times out, even when no more packets are captured
+      WriteWriterBlock(/* end_chunk= */ false);
+      if (!btsnoop_ostream_.flush()) {
+        LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+      }
     }
+    lock.lock();
+  }
+  lock.unlock();
+  // Write the packets captured until the thread was stopped
+  while (DrainWriterRing()) {
+  }
+  WriteWriterBlock(/* end_chunk= */ true);
+  if (!btsnoop_ostream_.flush()) {
+    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
   }
 }
 
@@ -1322,6 +1704,7 @@ void SnoopLogger::Start() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
     OpenNextSnoopLogFile();
+    StartWriterThread();
 
     if (btsnoop_mode_ == kBtSnoopLogModeFiltered) {
       EnableFilters();
@@ -1347,6 +1730,8 @@ void SnoopLogger::Start() {
 }
 
 void SnoopLogger::Stop() {
+  // Outside of |file_mutex_|, as the writer thread takes it to rotate the log file
+  StopWriterThread();
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   LOG_DEBUG("Closing btsnoop log data at %s", snoop_log_path_.c_str());
   CloseCurrentSnoopLogFile();
@@ -1447,6 +1832,10 @@ bool SnoopLogger::IsBtSnoopLogPersisted() {
   return is_debuggable && os::GetSystemPropertyBool(kBtSnoopLogPersists, false);
 }
 
+bool SnoopLogger::IsBtSnoopLogCompressed() {
+  return os::GetSystemPropertyBool(kBtSnoopLogCompressedProperty, false);
+}
+
 bool SnoopLogger::IsQualcommDebugLogEnabled() {
   // Check system prop if the soc manufacturer is Qualcomm
   bool qualcomm_debug_log_enabled = false;
@@ -1468,7 +1857,8 @@ const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
       IsQualcommDebugLogEnabled(),
       kBtSnoozLogLifeTime,
       kBtSnoozLogDeleteRepeatingAlarmInterval,
-      IsBtSnoopLogPersisted());
+      IsBtSnoopLogPersisted(),
+      IsBtSnoopLogCompressed());
 });
 
 }  // namespace hal
@@ -16,15 +16,22 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/circular_buffer.h"
 #include "hal/hci_hal.h"
+#include "hal/snoop_logger_common.h"
 #include "hal/snoop_logger_socket_thread.h"
 #include "hal/syscall_wrapper_impl.h"
 #include "module.h"
@@ -64,6 +71,60 @@ class FilterTracker {
   bool IsAcceptlistedDlci(uint8_t dlci);
 };
 
+// Lookup table of the L2CAP channels and RFCOMM DLCIs of each ACL connection that the snoop log filters act on.
+// It is updated when the channels are opened or closed, so that filtering a packet takes a couple of array lookups
+// instead of searching the filter state of each filter.
+class ChannelFilterTable {
+ public:
+  // Flags of a channel
+  static constexpr uint8_t kL2capAcceptlisted = 1 << 0;
+  static constexpr uint8_t kRfcomm = 1 << 1;
+  static constexpr uint8_t kA2dpMedia = 1 << 2;
+
+  // Sets or clears |flag| of the local or remote channel |cid| of the connection |handle|.
+  void UpdateChannel(uint16_t handle, bool local, uint16_t cid, uint8_t flag, bool set);
+
+  // Clears |flag| of all the channels of the connection |handle|.
+  void ClearChannels(uint16_t handle, uint8_t flag);
+
+  // Returns the flags of the local or remote channel |cid| of the connection |handle|.
+  uint8_t GetChannelFlags(uint16_t handle, bool local, uint16_t cid) const;
+
+  // Acceptlists the RFCOMM |dlci| of the connection |handle|, or clears the acceptlisted DLCIs.
+  void AddRfcommDlci(uint16_t handle, uint8_t dlci);
+  void ClearRfcommDlcis(uint16_t handle);
+
+  bool IsAcceptlistedDlci(uint16_t handle, uint8_t dlci) const;
+
+  void Clear();
+
+ private:
+  struct Channel {
+    uint16_t cid;
+    bool local;
+    uint8_t flags;
+  };
+  struct Connection {
+    // kMaxHandles when the entry is free
+    uint16_t handle;
+    std::vector<Channel> channels;
+    // DLCI 0, the RFCOMM control channel, is always acceptlisted
+    uint64_t rfcomm_dlcis = 1;
+  };
+
+  static constexpr size_t kMaxHandles = 0x1000;
+
+  Connection* GetConnection(uint16_t handle, bool create);
+  const Connection* GetConnection(uint16_t handle) const;
+  // Frees the entry of |connection| once it holds no filter state
+  void ReleaseConnectionIfUnused(Connection* connection);
+
+  mutable std::mutex mutex_;
+  // 1 + index in |connections_| of the connection of each handle, 0 if the connection has no entry
+  std::array<uint8_t, kMaxHandles> connection_index_ = {};
+  std::vector<Connection> connections_;
+};
+
 typedef enum {
   FILTER_PROFILE_NONE = -1,
   FILTER_PROFILE_PBAP = 0,
@@ -145,6 +206,7 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kIsDebuggableProperty;
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopLogPersists;
+  static const std::string kBtSnoopLogCompressedProperty;
   static const std::string kBtSnoopDefaultLogModeProperty;
   static const std::string kBtSnoopLogFilterHeadersProperty;
   static const std::string kBtSnoopLogFilterProfileA2dpProperty;
@@ -207,6 +269,10 @@ class SnoopLogger : public ::bluetooth::Module {
   // Returns whether snoop log persists even after restarting Bluetooth
   static bool IsBtSnoopLogPersisted();
 
+  // Returns whether the btsnoop log is written in the compressed format
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsBtSnoopLogCompressed();
+
   // Has to be defined from 1 to 4 per btsnoop format
   enum PacketType {
     CMD = 1,
@@ -262,6 +328,9 @@ class SnoopLogger : public ::bluetooth::Module {
 
   void RegisterSocket(SnoopLoggerSocketInterface* socket);
 
+  // Returns the number of packets dropped from the btsnoop log because the writer thread could not keep up
+  uint64_t GetDroppedPackets() const;
+
  protected:
   // Packet type length
   static const size_t PACKET_TYPE_LENGTH;
@@ -288,10 +357,22 @@ class SnoopLogger : public ::bluetooth::Module {
       bool qualcomm_debug_log_enabled,
       const std::chrono::milliseconds snooz_log_life_time,
       const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-      bool snoop_log_persists);
+      bool snoop_log_persists,
+      bool snoop_log_compressed);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
   void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
+  // Start and stop the thread writing the captured packets to the btsnoop log
+  void StartWriterThread();
+  void StopWriterThread();
+  void RunWriterThread();
+  // Queue a captured packet record for the writer thread, or count it as dropped if the capture ring is full
+  void PushWriterRecord(const PacketHeaderType& header, const uint8_t* data, size_t length);
+  // Move the records of the capture ring to the btsnoop log, returns false if the ring was empty
+  bool DrainWriterRing();
+  // Write the block of records to the btsnoop log. In compressed mode the block is kept until it fills a chunk,
+  // times out or |end_chunk| is set.
+  void WriteWriterBlock(bool end_chunk);
   // Enable filters according to their sysprops
   void EnableFilters();
   // Disable all filters
@@ -330,6 +411,8 @@ class SnoopLogger : public ::bluetooth::Module {
       PacketType type,
       uint32_t& length,
       PacketHeaderType header);
+  // Cache the filters enabled in |enabled_filters_| for the packet path
+  void UpdateEnabledFilters();
 
   std::unique_ptr<SnoopLoggerSocketThread> snoop_logger_socket_thread_;
 
@@ -343,6 +426,26 @@ class SnoopLogger : public ::bluetooth::Module {
   bool qualcomm_debug_log_enabled_ = false;
   size_t packet_counter_ = 0;
   mutable std::recursive_mutex file_mutex_;
+  // Bitmask of the filters enabled, checked on each captured packet
+  std::atomic<uint8_t> enabled_filters_ = 0;
+
+  // Capture ring between Capture() and the writer thread. Capture() is serialized by |file_mutex_|, so the ring only
+  // has one producer and one consumer and the writer never contends with the HCI thread.
+  std::vector<std::string> writer_ring_;
+  std::atomic<size_t> writer_ring_head_ = 0;
+  std::atomic<size_t> writer_ring_tail_ = 0;
+  std::atomic<uint64_t> dropped_packets_ = 0;
+  // Block of records written to the btsnoop log at once, only used by the writer thread
+  std::string writer_block_;
+  // Compressed btsnoop log chunk being written, only used by the writer thread
+  bool snoop_log_compressed_ = false;
+  std::vector<uint8_t> compressed_chunk_;
+  SnoopLoggerCommon::ChunkHeaderType chunk_header_ = {};
+  std::chrono::steady_clock::time_point chunk_start_time_;
+  std::unique_ptr<std::thread> writer_thread_;
+  std::mutex writer_mutex_;
+  std::condition_variable writer_cv_;
+  bool writer_thread_running_ = false;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   std::chrono::milliseconds snooz_log_life_time_;
   std::chrono::milliseconds snooz_log_delete_alarm_interval_;
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hal/snoop_logger.h"
+#include "module.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+// An ACL packet of an A2DP stream, the bulk of what a snoop log captures
+std::vector<uint8_t> MakeAclPacket(size_t payload_size) {
+  std::vector<uint8_t> packet = {
+      0x0b, 0x20,  // Handle and flags
+      static_cast<uint8_t>((payload_size + 4) & 0xff),
+      static_cast<uint8_t>((payload_size + 4) >> 8),
+      static_cast<uint8_t>(payload_size & 0xff),
+      static_cast<uint8_t>(payload_size >> 8),
+      0x41, 0x00,  // Dynamic channel
+  };
+  for (size_t i = 0; i < payload_size; i++) {
+    packet.push_back(static_cast<uint8_t>(i));
+  }
+  return packet;
+}
+
+// Expose the protected constructor, with a snooz buffer of the default size
+class BenchmarkSnoopLogger : public SnoopLogger {
+ public:
+  BenchmarkSnoopLogger(std::string snoop_log_path, std::string snooz_log_path, const std::string& btsnoop_mode)
+      : SnoopLogger(
+            std::move(snoop_log_path),
+            std::move(snooz_log_path),
+            1000000,
+            SnoopLogger::GetMaxPacketsPerBuffer(),
+            btsnoop_mode,
+            false,
+            std::chrono::hours(1),
+            std::chrono::hours(1),
+            false,
+            false) {}
+
+  std::string ToString() const override {
+    return std::string("BenchmarkSnoopLogger");
+  }
+};
+}  // namespace
+
+// Capture of outgoing ACL packets of range(0) bytes of payload, in each snoop log mode
+class BM_SnoopLogger : public ::benchmark::Fixture {
+ protected:
+  void Start(const std::string& btsnoop_mode) {
+    auto temp_dir = std::filesystem::temp_directory_path();
+    snoop_log_ = temp_dir / "bm_btsnoop_hci.log";
+    snooz_log_ = temp_dir / "bm_btsnooz_hci.log";
+    snoop_logger_ = new BenchmarkSnoopLogger(snoop_log_.string(), snooz_log_.string(), btsnoop_mode);
+    registry_.InjectTestModule(&SnoopLogger::Factory, snoop_logger_);
+  }
+
+  void TearDown(State& st) override {
+    registry_.StopAll();
+    for (const auto& path : {snoop_log_, snooz_log_}) {
+      std::filesystem::remove(path);
+      std::filesystem::remove(path.string() + ".last");
+      std::filesystem::remove(path.string() + ".filtered");
+      std::filesystem::remove(path.string() + ".filtered.last");
+    }
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void Run(State& state) {
+    auto packet = MakeAclPacket(state.range(0));
+    for (auto _ : state) {
+      snoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * packet.size());
+  }
+
+  TestModuleRegistry registry_;
+  SnoopLogger* snoop_logger_{nullptr};
+  std::filesystem::path snoop_log_;
+  std::filesystem::path snooz_log_;
+};
+
+// Only the snooz buffer kept for the bug reports
+BENCHMARK_DEFINE_F(BM_SnoopLogger, disabled)(State& state) {
+  Start(SnoopLogger::kBtSnoopLogModeDisabled);
+  Run(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SnoopLogger, disabled)->Arg(27)->Arg(600);
+
+// Payloads truncated before being written to the file
+BENCHMARK_DEFINE_F(BM_SnoopLogger, filtered)(State& state) {
+  Start(SnoopLogger::kBtSnoopLogModeFiltered);
+  Run(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SnoopLogger, filtered)->Arg(27)->Arg(600);
+
+// Whole packets written to the file
+BENCHMARK_DEFINE_F(BM_SnoopLogger, full)(State& state) {
+  Start(SnoopLogger::kBtSnoopLogModeFull);
+  Run(state);
+}
+
+BENCHMARK_REGISTER_F(BM_SnoopLogger, full)->Arg(27)->Arg(600);
+
+}  // namespace hal
+}  // namespace bluetooth
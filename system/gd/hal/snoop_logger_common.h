@@ -16,6 +16,10 @@
  *
  ******************************************************************************/
 
+#pragma once
+
+#include <cstdint>
+
 namespace bluetooth {
 namespace hal {
 
@@ -41,6 +45,24 @@ class SnoopLoggerCommon {
       .identification_pattern = {'b', 't', 's', 'n', 'o', 'o', 'p', 0x00},
       .version_number = BTSNOOP_VERSION_NUMBER,
       .datalink_type = BTSNOOP_DATALINK_TYPE};
+
+  // The compressed btsnoop log is the file header below followed by chunks, each a chunk header and the
+  // zlib-compressed btsnoop records of the chunk. Decompressing the chunks after a plain btsnoop file header gives
+  // back the plain btsnoop log, and the chunk headers index the log by time without decompressing it.
+  static constexpr FileHeaderType kBtSnoopCompressedFileHeader = {
+      .identification_pattern = {'b', 't', 's', 'n', 'o', 'o', 'p', 'z'},
+      .version_number = BTSNOOP_VERSION_NUMBER,
+      .datalink_type = BTSNOOP_DATALINK_TYPE};
+
+  // All fields are big endian, as in the btsnoop records
+  struct ChunkHeaderType {
+    uint32_t compressed_length;
+    uint32_t original_length;
+    uint32_t packets;
+    // Timestamps of the first and last records of the chunk, in btsnoop format
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+  } __attribute__((__packed__));
 };
 
 }  // namespace hal
@@ -87,6 +87,32 @@ void SnoopLoggerSocket::Write(const void* data, size_t length) {
   Write(client_socket_, data, length);
 }
 
+uint64_t SnoopLoggerSocket::GetClientId() {
+  std::lock_guard<std::mutex> lock(client_socket_mutex_);
+  return IsClientSocketConnected() ? client_id_ : 0;
+}
+
+ssize_t SnoopLoggerSocket::Send(uint64_t client_id, const void* data, size_t length) {
+  std::lock_guard<std::mutex> lock(client_socket_mutex_);
+  if (!IsClientSocketConnected() || client_id != client_id_) {
+    return -1;
+  }
+
+  ssize_t ret;
+  RUN_NO_INTR(ret = syscall_if_->Send(client_socket_, data, length, MSG_DONTWAIT));
+  if (ret >= 0) {
+    return ret;
+  }
+
+  int errno_ = syscall_if_->GetErrno();
+  if (errno_ == EAGAIN || errno_ == EWOULDBLOCK) {
+    return 0;
+  }
+  LOG_WARN("Closing snoop client socket, error: %s", strerror(errno_));
+  SafeCloseSocket(client_socket_);
+  return -1;
+}
+
 int SnoopLoggerSocket::InitializeCommunications() {
   int self_pipe_fds[2];
   int ret;
@@ -195,6 +221,7 @@ void SnoopLoggerSocket::ClientSocketConnected(int client_socket) {
   std::lock_guard<std::mutex> lock(client_socket_mutex_);
   SafeCloseSocket(client_socket_);
   client_socket_ = client_socket;
+  client_id_++;
   client_socket_cv_.notify_one();
 }
 
@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <sys/types.h>
+
 #include <condition_variable>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -48,6 +51,12 @@ class SnoopLoggerSocket {
   int NotifySocketListener();
   void Write(const void* data, size_t length);
 
+  // Returns the id of the connected client, 0 if no client is connected. Each new client gets a new id.
+  uint64_t GetClientId();
+  // Sends |data| to the client |client_id| without blocking. Returns the number of bytes sent, 0 if the socket is
+  // congested, or -1 if the client is gone.
+  ssize_t Send(uint64_t client_id, const void* data, size_t length);
+
   int AcceptIncomingConnection(int listen_socket, int& client_socket);
   int CreateSocket();
   void ClientSocketConnected(int client_socket);
@@ -80,6 +89,7 @@ class SnoopLoggerSocket {
   // Reference to connected client socket.
   std::mutex client_socket_mutex_;
   int client_socket_;
+  uint64_t client_id_ = 0;
   std::condition_variable client_socket_cv_;
 };
 
@@ -27,6 +27,7 @@ class SnoopLoggerSocketInterface {
  public:
   virtual ~SnoopLoggerSocketInterface() = default;
 
+  // Writes a btsnoop record to the connected client, if any
   virtual void Write(const void* data, size_t length) = 0;
 };
 
@@ -33,6 +33,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <mutex>
 
 #include "common/init_flags.h"
@@ -45,6 +46,11 @@
 namespace bluetooth {
 namespace hal {
 
+// Maximum number of bytes queued for the client, records beyond it are dropped
+static constexpr size_t kMaxSendQueueBytes = 512 * 1024;
+// Time to wait for a congested client socket to drain
+static constexpr std::chrono::milliseconds kSendRetryInterval = std::chrono::milliseconds(10);
+
 SnoopLoggerSocketThread::SnoopLoggerSocketThread(std::unique_ptr<SnoopLoggerSocket>&& socket) {
   socket_ = std::move(socket);
   stop_thread_ = false;
@@ -61,6 +67,11 @@ std::future<bool> SnoopLoggerSocketThread::Start() {
   auto future = thread_started.get_future();
   listen_thread_ = std::make_unique<std::thread>(&SnoopLoggerSocketThread::Run, this, std::move(thread_started));
   stop_thread_ = false;
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    send_thread_running_ = true;
+  }
+  send_thread_ = std::make_unique<std::thread>(&SnoopLoggerSocketThread::RunSender, this);
   return std::move(future);
 }
 
@@ -74,10 +85,90 @@ void SnoopLoggerSocketThread::Stop() {
     listen_thread_->join();
     listen_thread_.reset();
   }
+
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    send_thread_running_ = false;
+  }
+  send_cv_.notify_one();
+  if (send_thread_ && send_thread_->joinable()) {
+    send_thread_->join();
+    send_thread_.reset();
+  }
+  if (dropped_packets_ > 0) {
+    LOG_WARN("Dropped %llu snoop packets for the client", static_cast<unsigned long long>(dropped_packets_.load()));
+  }
 }
 
 void SnoopLoggerSocketThread::Write(const void* data, size_t length) {
-  socket_->Write(data, length);
+  uint64_t client_id = socket_->GetClientId();
+  if (client_id == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  if (client_id != send_client_id_) {
+    // The records of the previous client are not for this one
+    send_queue_.clear();
+    send_client_id_ = client_id;
+  }
+  if (send_queue_.size() + length > kMaxSendQueueBytes) {
+    if (dropped_packets_.fetch_add(1) == 0) {
+      LOG_WARN("Snoop client can't keep up, dropping packets");
+    }
+    return;
+  }
+
+  bool was_empty = send_queue_.empty();
+  send_queue_.append(reinterpret_cast<const char*>(data), length);
+  if (was_empty) {
+    send_cv_.notify_one();
+  }
+}
+
+uint64_t SnoopLoggerSocketThread::GetDroppedPackets() const {
+  return dropped_packets_;
+}
+
+void SnoopLoggerSocketThread::RunSender() {
+  std::string batch;
+  std::unique_lock<std::mutex> lock(send_mutex_);
+  while (true) {
+    send_cv_.wait(lock, [this] { return !send_thread_running_ || !send_queue_.empty(); });
+    if (!send_thread_running_) {
+      return;
+    }
+
+    // Send all the queued records at once, Write() fills the other buffer in the meantime
+    batch.swap(send_queue_);
+    uint64_t client_id = send_client_id_;
+    lock.unlock();
+
+    size_t offset = 0;
+    while (offset < batch.size()) {
+      ssize_t ret = socket_->Send(client_id, batch.data() + offset, batch.size() - offset);
+      if (ret < 0) {
+        // The client is gone
+        break;
+      }
+      offset += ret;
+      if (ret == 0) {
+        // Congested, retry the rest of the batch so that the client never gets a partial record
+        lock.lock();
+        bool running = send_thread_running_;
+        if (running) {
+          send_cv_.wait_for(lock, kSendRetryInterval, [this] { return !send_thread_running_; });
+          running = send_thread_running_;
+        }
+        lock.unlock();
+        if (!running) {
+          break;
+        }
+      }
+    }
+    batch.clear();
+    lock.lock();
+  }
 }
 
 bool SnoopLoggerSocketThread::ThreadIsRunning() const {
@@ -23,6 +23,7 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 
 #include "hal/snoop_logger_socket.h"
@@ -39,13 +40,18 @@ class SnoopLoggerSocketThread : public SnoopLoggerSocketInterface {
 
   std::future<bool> Start();
   void Stop();
+  // Queues the record for the connected client, it is dropped if the queue of the client is full
   void Write(const void* data, size_t length) override;
   bool ThreadIsRunning() const;
 
   SnoopLoggerSocket* GetSocket();
 
+  // Returns the number of records dropped because the client could not keep up
+  uint64_t GetDroppedPackets() const;
+
  private:
   void Run(std::promise<bool> thread_started);
+  void RunSender();
 
   std::unique_ptr<SnoopLoggerSocket> socket_;
 
@@ -56,6 +62,16 @@ class SnoopLoggerSocketThread : public SnoopLoggerSocketInterface {
   std::condition_variable listen_thread_running_cv_;
   std::mutex listen_thread_running_mutex_;
   std::atomic<bool> stop_thread_;
+
+  // Thread sending the queued records to the client, so that a slow client never blocks Write()
+  std::unique_ptr<std::thread> send_thread_;
+  std::mutex send_mutex_;
+  std::condition_variable send_cv_;
+  // Records queued for the client |send_client_id_|, sent at once
+  std::string send_queue_;
+  uint64_t send_client_id_ = 0;
+  bool send_thread_running_ = false;
+  std::atomic<uint64_t> dropped_packets_ = 0;
 };
 
 }  // namespace hal
@@ -22,6 +22,7 @@
 #include <sys/socket.h>
 
 #include <future>
+#include <vector>
 
 #include "common/init_flags.h"
 #include "hal/snoop_logger_common.h"
@@ -293,4 +294,38 @@ TEST_F(SnoopLoggerSocketThreadModuleTest, socket_send_recv_test) {
   close(socket_fd);
 }
 
+TEST_F(SnoopLoggerSocketThreadModuleTest, socket_slow_client_drops_packets_test) {
+  int ret = 0;
+  SyscallWrapperImpl socket_if;
+  SnoopLoggerSocketThread sls(std::make_unique<SnoopLoggerSocket>(&socket_if));
+  auto thread_start_future = sls.Start();
+  thread_start_future.wait();
+  ASSERT_TRUE(thread_start_future.get());
+
+  // // Create a TCP socket file descriptor
+  int socket_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+  ASSERT_TRUE(socket_fd != INVALID_FD);
+
+  struct sockaddr_in addr;
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(SnoopLoggerSocket::DEFAULT_LOCALHOST_);
+  addr.sin_port = htons(SnoopLoggerSocket::DEFAULT_LISTEN_PORT_);
+
+  // Connect to snoop logger socket
+  RUN_NO_INTR(ret = connect(socket_fd, (struct sockaddr*)&addr, sizeof(addr)));
+  ASSERT_TRUE(ret == 0);
+
+  sls.GetSocket()->WaitForClientSocketConnected();
+
+  // The client never reads, the writes must not block once the socket is full
+  std::vector<char> test_data(1024, 0x5a);
+  for (int i = 0; i < 32 * 1024; i++) {
+    sls.Write(test_data.data(), test_data.size());
+  }
+  ASSERT_GT(sls.GetDroppedPackets(), 0u);
+
+  sls.Stop();
+  close(socket_fd);
+}
+
 }  // namespace testing
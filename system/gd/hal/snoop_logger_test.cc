@@ -20,7 +20,9 @@
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <zlib.h>
 
+#include <fstream>
 #include <future>
 #include <unordered_map>
 
@@ -129,7 +131,8 @@ class TestSnoopLoggerModule : public SnoopLogger {
       size_t max_packets_per_file,
       const std::string& btsnoop_mode,
       bool qualcomm_debug_log_enabled,
-      bool snoop_log_persists)
+      bool snoop_log_persists,
+      bool snoop_log_compressed = false)
       : SnoopLogger(
             std::move(snoop_log_path),
             std::move(snooz_log_path),
@@ -139,7 +142,8 @@ class TestSnoopLoggerModule : public SnoopLogger {
             qualcomm_debug_log_enabled,
             20ms,
             5ms,
-            snoop_log_persists) {}
+            snoop_log_persists,
+            snoop_log_compressed) {}
 
   std::string ToString() const override {
     return std::string("TestSnoopLoggerModule");
@@ -303,6 +307,93 @@ TEST_F(SnoopLoggerModuleTest, capture_one_packet_test) {
       sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size());
 }
 
+TEST_F(SnoopLoggerModuleTest, capture_packets_written_at_stop_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10000,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  const size_t num_packets = 1000;
+  for (size_t i = 0; i < num_packets; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * num_packets);
+}
+
+TEST_F(SnoopLoggerModuleTest, capture_compressed_snoop_log_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10000,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      true);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  const size_t num_packets = 1000;
+  for (size_t i = 0; i < num_packets; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  const std::filesystem::path temp_snoop_log_compressed = temp_snoop_log_.string() + ".z";
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_compressed));
+
+  std::ifstream log(temp_snoop_log_compressed, std::ios::binary);
+  SnoopLoggerCommon::FileHeaderType file_header;
+  ASSERT_TRUE(log.read(reinterpret_cast<char*>(&file_header), sizeof(file_header)));
+  ASSERT_EQ(
+      0,
+      memcmp(
+          &file_header, &SnoopLoggerCommon::kBtSnoopCompressedFileHeader, sizeof(SnoopLoggerCommon::FileHeaderType)));
+
+  // Decompress all the chunks back to the btsnoop records
+  const size_t record_size = sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size();
+  size_t packets = 0;
+  SnoopLoggerCommon::ChunkHeaderType chunk_header;
+  while (log.read(reinterpret_cast<char*>(&chunk_header), sizeof(chunk_header))) {
+    std::vector<uint8_t> compressed(ntohl(chunk_header.compressed_length));
+    ASSERT_TRUE(log.read(reinterpret_cast<char*>(compressed.data()), compressed.size()));
+    std::vector<uint8_t> records(ntohl(chunk_header.original_length));
+    uLongf records_length = records.size();
+    ASSERT_EQ(Z_OK, uncompress(records.data(), &records_length, compressed.data(), compressed.size()));
+    ASSERT_EQ(records.size(), records_length);
+    ASSERT_EQ(records.size(), ntohl(chunk_header.packets) * record_size);
+    for (size_t offset = 0; offset < records.size(); offset += record_size) {
+      ASSERT_EQ(
+          0,
+          memcmp(
+              records.data() + offset + sizeof(SnoopLogger::PacketHeaderType),
+              kInformationRequest.data(),
+              kInformationRequest.size()));
+    }
+    packets += ntohl(chunk_header.packets);
+  }
+  ASSERT_EQ(num_packets, packets);
+
+  log.close();
+  ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_compressed));
+}
+
 TEST_F(SnoopLoggerModuleTest, capture_hci_cmd_btsnooz_test) {
   // Actual test
   auto* snoop_logger = new TestSnoopLoggerModule(
@@ -660,6 +751,43 @@ TEST_F(SnoopLoggerModuleTest, filter_tracker_test) {
   ASSERT_FALSE(filter_list[handle].IsAcceptlistedDlci(dlci));
 }
 
+TEST_F(SnoopLoggerModuleTest, channel_filter_table_test) {
+  using bluetooth::hal::ChannelFilterTable;
+  ChannelFilterTable table;
+  uint16_t handle = 1;
+  uint16_t local_cid = 0x40;
+  uint16_t remote_cid = 0x41;
+  uint8_t dlci = 0x02;
+
+  table.UpdateChannel(handle, true, local_cid, ChannelFilterTable::kL2capAcceptlisted, true);
+  table.UpdateChannel(handle, true, local_cid, ChannelFilterTable::kA2dpMedia, true);
+  table.UpdateChannel(handle, false, remote_cid, ChannelFilterTable::kL2capAcceptlisted, true);
+  ASSERT_EQ(
+      ChannelFilterTable::kL2capAcceptlisted | ChannelFilterTable::kA2dpMedia,
+      table.GetChannelFlags(handle, true, local_cid));
+  ASSERT_EQ(ChannelFilterTable::kL2capAcceptlisted, table.GetChannelFlags(handle, false, remote_cid));
+  ASSERT_EQ(0, table.GetChannelFlags(handle, false, local_cid));
+  ASSERT_EQ(0, table.GetChannelFlags(handle + 1, true, local_cid));
+
+  table.UpdateChannel(handle, true, local_cid, ChannelFilterTable::kL2capAcceptlisted, false);
+  ASSERT_EQ(ChannelFilterTable::kA2dpMedia, table.GetChannelFlags(handle, true, local_cid));
+  table.ClearChannels(handle, ChannelFilterTable::kA2dpMedia);
+  ASSERT_EQ(0, table.GetChannelFlags(handle, true, local_cid));
+  ASSERT_EQ(ChannelFilterTable::kL2capAcceptlisted, table.GetChannelFlags(handle, false, remote_cid));
+
+  ASSERT_TRUE(table.IsAcceptlistedDlci(handle, 0));
+  ASSERT_FALSE(table.IsAcceptlistedDlci(handle, dlci));
+  table.AddRfcommDlci(handle, dlci);
+  ASSERT_TRUE(table.IsAcceptlistedDlci(handle, dlci));
+  ASSERT_FALSE(table.IsAcceptlistedDlci(handle + 1, dlci));
+  table.ClearRfcommDlcis(handle);
+  ASSERT_FALSE(table.IsAcceptlistedDlci(handle, dlci));
+  ASSERT_TRUE(table.IsAcceptlistedDlci(handle, 0));
+
+  table.Clear();
+  ASSERT_EQ(0, table.GetChannelFlags(handle, false, remote_cid));
+}
+
 TEST_F(SnoopLoggerModuleTest, a2dp_packets_filtered_test) {
   // Actual test
   uint16_t conn_handle = 0x000b;
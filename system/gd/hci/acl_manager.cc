@@ -421,6 +421,46 @@ void AclManager::HACK_SetAclTxPriority(uint8_t handle, bool high_priority) {
   CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkPriority, handle, high_priority);
 }
 
+void AclManager::SetAclTxWeightedFairQueuing(bool enable) {
+  CallOn(
+      pimpl_->round_robin_scheduler_,
+      &RoundRobinScheduler::SetSchedulingMode,
+      enable ? RoundRobinScheduler::WEIGHTED_FAIR : RoundRobinScheduler::ROUND_ROBIN);
+}
+
+void AclManager::SetAclTxWeight(uint16_t handle, uint8_t weight) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkWeight, handle, weight);
+}
+
+void AclManager::SetAclTxCreditReservation(uint16_t handle, uint16_t credits) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetCreditReservation, handle, credits);
+}
+
+void AclManager::GetAclTxStats(uint16_t handle, std::promise<acl_manager::AclTxStats> promise) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::GetLinkStats, handle, std::move(promise));
+}
+
+void AclManager::GetClassicAclBufferStats(std::promise<acl_manager::AclBufferStats> promise) {
+  CallOn(
+      pimpl_->round_robin_scheduler_,
+      &RoundRobinScheduler::GetBufferStats,
+      RoundRobinScheduler::ConnectionType::CLASSIC,
+      std::move(promise));
+}
+
+void AclManager::GetLeAclBufferStats(std::promise<acl_manager::AclBufferStats> promise) {
+  CallOn(
+      pimpl_->round_robin_scheduler_,
+      &RoundRobinScheduler::GetBufferStats,
+      RoundRobinScheduler::ConnectionType::LE,
+      std::move(promise));
+}
+
+void AclManager::SetAclTxBackpressureCallback(
+    uint16_t handle, common::ContextualCallback<void(bool congested)> callback) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetBackpressureCallback, handle, std::move(callback));
+}
+
 void AclManager::ListDependencies(ModuleList* list) const {
   list->add<HciLayer>();
   list->add<Controller>();
@@ -455,6 +495,15 @@ void AclManager::impl::Dump(
       (le_impl_ != nullptr) ? connectability_state_machine_text(le_impl_->connectability_state_) : "INDETERMINATE";
   const auto le_create_connection_timeout_alarms_count =
       (le_impl_ != nullptr) ? (int)le_impl_->create_connection_timeout_alarms_.size() : 0;
+  const auto le_create_connection_restart_count =
+      (le_impl_ != nullptr) ? (int)le_impl_->create_connection_restart_count_ : 0;
+  const auto le_direct_connection_count = (le_impl_ != nullptr) ? (int)le_impl_->direct_connection_count_ : 0;
+  const auto le_direct_connection_latency_mean_ms =
+      (le_direct_connection_count != 0)
+          ? (int)(le_impl_->direct_connection_latency_total_.count() / le_direct_connection_count)
+          : 0;
+  const auto le_direct_connection_latency_max_ms =
+      (le_impl_ != nullptr) ? (int)le_impl_->direct_connection_latency_max_.count() : 0;
 
   auto title = fb_builder->CreateString("----- Acl Manager Dumpsys -----");
   auto le_connectability_state = fb_builder->CreateString(le_connectability_state_text);
@@ -473,6 +522,10 @@ void AclManager::impl::Dump(
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  builder.add_le_create_connection_restart_count(le_create_connection_restart_count);
+  builder.add_le_direct_connection_count(le_direct_connection_count);
+  builder.add_le_direct_connection_latency_mean_ms(le_direct_connection_latency_mean_ms);
+  builder.add_le_direct_connection_latency_max_ms(le_direct_connection_latency_max_ms);
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
@@ -22,6 +22,7 @@
 
 #include "common/bidi_queue.h"
 #include "common/callback.h"
+#include "hci/acl_manager/acl_tx_stats.h"
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
@@ -149,6 +150,19 @@ public:
  virtual void OnLeSuspendInitiatedDisconnect(uint16_t handle, ErrorCode reason);
  virtual void SetSystemSuspendState(bool suspended);
 
+ // Share the controller buffers between the connections by weighted fair queuing rather than round robin
+ virtual void SetAclTxWeightedFairQueuing(bool enable);
+ // Weighted fair queuing lets a connection send weight fragments per round, 1 by default
+ virtual void SetAclTxWeight(uint16_t handle, uint8_t weight);
+ // Keep credits controller buffers available to the connection under weighted fair queuing
+ virtual void SetAclTxCreditReservation(uint16_t handle, uint16_t credits);
+ virtual void GetAclTxStats(uint16_t handle, std::promise<acl_manager::AclTxStats> promise);
+ virtual void GetClassicAclBufferStats(std::promise<acl_manager::AclBufferStats> promise);
+ virtual void GetLeAclBufferStats(std::promise<acl_manager::AclBufferStats> promise);
+ // Invoked with true when the controller buffers for the connection are used up, and with false once it may send
+ // again, so that the upper layer stops dequeuing in the meantime
+ virtual void SetAclTxBackpressureCallback(uint16_t handle, common::ContextualCallback<void(bool congested)> callback);
+
  static const ModuleFactory Factory;
 
 protected:
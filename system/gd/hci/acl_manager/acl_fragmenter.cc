@@ -16,8 +16,9 @@
 
 #include "hci/acl_manager/acl_fragmenter.h"
 
-#include "os/log.h"
-#include "packet/fragmenting_inserter.h"
+#include <iterator>
+
+#include "packet/view_builder.h"
 
 namespace bluetooth {
 namespace hci {
@@ -26,12 +27,10 @@ namespace acl_manager {
 AclFragmenter::AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> packet)
     : mtu_(mtu), packet_(std::move(packet)) {}
 
-std::vector<std::unique_ptr<packet::RawBuilder>> AclFragmenter::GetFragments() {
-  std::vector<std::unique_ptr<packet::RawBuilder>> to_return;
-  packet::FragmentingInserter fragmenting_inserter(mtu_, std::back_insert_iterator(to_return));
-  packet_->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
-  return to_return;
+std::vector<std::unique_ptr<packet::BasePacketBuilder>> AclFragmenter::GetFragments() {
+  auto fragments = packet::ViewBuilder::Fragment(*packet_, mtu_);
+  return std::vector<std::unique_ptr<packet::BasePacketBuilder>>(
+      std::make_move_iterator(fragments.begin()), std::make_move_iterator(fragments.end()));
 }
 
 }  // namespace acl_manager
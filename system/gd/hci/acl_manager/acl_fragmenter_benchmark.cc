@@ -0,0 +1,95 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/acl_manager/acl_fragmenter.h"
+#include "packet/bit_inserter.h"
+#include "packet/fragmenting_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Fragment a PDU into ACL payloads of mtu bytes, then serialize each of them like the HAL would
+class BM_AclFragmenter : public ::benchmark::Fixture {
+ protected:
+  static constexpr size_t kPduSize = 64 * 1024;
+
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    pdu_.resize(kPduSize);
+    for (size_t i = 0; i < pdu_.size(); i++) {
+      pdu_[i] = static_cast<uint8_t>(i);
+    }
+    output_.reserve(st.range(0));
+  }
+
+  template <typename Fragment>
+  void serialize(const std::vector<std::unique_ptr<Fragment>>& fragments) {
+    for (const auto& fragment : fragments) {
+      output_.clear();
+      packet::BitInserter it(output_);
+      fragment->Serialize(it);
+      ::benchmark::DoNotOptimize(output_.data());
+    }
+  }
+
+  std::vector<uint8_t> pdu_;
+  std::vector<uint8_t> output_;
+};
+
+// The PDU copied byte by byte into a RawBuilder per fragment
+BENCHMARK_DEFINE_F(BM_AclFragmenter, fragmenting_inserter)(State& state) {
+  for (auto _ : state) {
+    auto packet = std::make_unique<packet::RawBuilder>(pdu_);
+    std::vector<std::unique_ptr<packet::RawBuilder>> fragments;
+    packet::FragmentingInserter it(state.range(0), std::back_insert_iterator(fragments));
+    packet->Serialize(it);
+    it.finalize();
+    serialize(fragments);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kPduSize);
+}
+
+BENCHMARK_REGISTER_F(BM_AclFragmenter, fragmenting_inserter)
+    ->Arg(251)
+    ->Arg(1021)
+    ->Unit(::benchmark::kMicrosecond);
+
+// The PDU serialized once, with views on it as fragments
+BENCHMARK_DEFINE_F(BM_AclFragmenter, views)(State& state) {
+  for (auto _ : state) {
+    auto fragments = AclFragmenter(state.range(0), std::make_unique<packet::RawBuilder>(pdu_)).GetFragments();
+    serialize(fragments);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * kPduSize);
+}
+
+BENCHMARK_REGISTER_F(BM_AclFragmenter, views)
+    ->Arg(251)
+    ->Arg(1021)
+    ->Unit(::benchmark::kMicrosecond);
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_fragmenter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+std::vector<uint8_t> payload_of_size(size_t size) {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = static_cast<uint8_t>(i * 7);
+  }
+  return payload;
+}
+
+std::vector<uint8_t> serialize(const packet::BasePacketBuilder& builder) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter it(bytes);
+  builder.Serialize(it);
+  return bytes;
+}
+
+TEST(AclFragmenterTest, fragments_of_mtu_size) {
+  auto payload = payload_of_size(1000);
+  auto fragments = AclFragmenter(300, std::make_unique<packet::RawBuilder>(payload)).GetFragments();
+  ASSERT_EQ(fragments.size(), 4u);
+
+  std::vector<uint8_t> reassembled;
+  for (size_t i = 0; i < fragments.size(); i++) {
+    ASSERT_EQ(fragments[i]->size(), i < 3 ? 300u : 100u);
+    auto bytes = serialize(*fragments[i]);
+    ASSERT_EQ(bytes.size(), fragments[i]->size());
+    reassembled.insert(reassembled.end(), bytes.begin(), bytes.end());
+  }
+  ASSERT_EQ(reassembled, payload);
+}
+
+TEST(AclFragmenterTest, packet_of_exactly_mtu_size) {
+  auto payload = payload_of_size(600);
+  auto fragments = AclFragmenter(300, std::make_unique<packet::RawBuilder>(payload)).GetFragments();
+  ASSERT_EQ(fragments.size(), 2u);
+  ASSERT_EQ(serialize(*fragments[0]), std::vector<uint8_t>(payload.begin(), payload.begin() + 300));
+  ASSERT_EQ(serialize(*fragments[1]), std::vector<uint8_t>(payload.begin() + 300, payload.end()));
+}
+
+TEST(AclFragmenterTest, fragments_outlive_fragmenter_and_packet) {
+  std::vector<std::unique_ptr<packet::BasePacketBuilder>> fragments;
+  {
+    AclFragmenter fragmenter(10, std::make_unique<packet::RawBuilder>(payload_of_size(25)));
+    fragments = fragmenter.GetFragments();
+  }
+  ASSERT_EQ(fragments.size(), 3u);
+  auto expected = payload_of_size(25);
+  ASSERT_EQ(serialize(*fragments[2]), std::vector<uint8_t>(expected.begin() + 20, expected.end()));
+}
+
+TEST(AclFragmenterTest, empty_packet) {
+  auto fragments = AclFragmenter(300, std::make_unique<packet::RawBuilder>()).GetFragments();
+  ASSERT_TRUE(fragments.empty());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
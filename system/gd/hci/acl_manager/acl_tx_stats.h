@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Transmit statistics of one ACL connection, accumulated since it was registered with the RoundRobinScheduler
+struct AclTxStats {
+  // Fragments waiting in the scheduler, including those of a packet held back by weighted fair queuing
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+  // Fragments handed to the HCI layer or waiting in the scheduler that the controller hasn't completed yet
+  uint16_t in_flight = 0;
+  uint16_t max_in_flight = 0;
+  uint64_t sent_fragments = 0;
+  // Time between a packet being taken from the connection queue and its fragments being handed to the HCI layer
+  std::chrono::microseconds total_latency{0};
+  std::chrono::microseconds max_latency{0};
+};
+
+// Use of the controller ACL buffers of one connection type (BR/EDR or LE), accumulated since the scheduler started
+struct AclBufferStats {
+  uint16_t total_credits = 0;
+  uint16_t available_credits = 0;
+  uint16_t max_credits_in_use = 0;
+  // How many times all the buffers got used up, and for how long in total
+  uint64_t credit_exhaustion_count = 0;
+  std::chrono::microseconds total_credit_wait{0};
+  // Whether the connections are currently asked to hold their traffic back
+  bool congested = false;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -18,9 +18,12 @@
 
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -64,6 +67,8 @@ constexpr uint16_t kScanWindowSlow = 0x0030;      /* 30 ms = 48 *0.625 */
 constexpr uint16_t kScanIntervalSystemSuspend = 0x0400; /* 640 ms = 1024 * 0.625 */
 constexpr uint16_t kScanWindowSystemSuspend = 0x0012;   /* 11.25ms = 18 * 0.625 */
 constexpr uint32_t kCreateConnectionTimeoutMs = 30 * 1000;
+// Apps register their background connections in bursts, when the stack starts and after each reconnection
+constexpr uint32_t kAcceptListSyncWindowMs = 20;
 constexpr uint8_t PHY_LE_NO_PACKET = 0x00;
 constexpr uint8_t PHY_LE_1M = 0x01;
 constexpr uint8_t PHY_LE_2M = 0x02;
@@ -76,6 +81,7 @@ static const std::string kPropertyMaxConnInterval = "bluetooth.core.le.max_conne
 static const std::string kPropertyConnLatency = "bluetooth.core.le.connection_latency";
 static const std::string kPropertyConnSupervisionTimeout = "bluetooth.core.le.connection_supervision_timeout";
 static const std::string kPropertyDirectConnTimeout = "bluetooth.core.le.direct_connection_timeout";
+static const std::string kPropertyAcceptListSyncWindow = "bluetooth.core.le.accept_list_sync_window_ms";
 static const std::string kPropertyConnScanIntervalFast = "bluetooth.core.le.connection_scan_interval_fast";
 static const std::string kPropertyConnScanWindowFast = "bluetooth.core.le.connection_scan_window_fast";
 static const std::string kPropertyConnScanWindow2mFast = "bluetooth.core.le.connection_scan_window_2m_fast";
@@ -148,6 +154,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         controller->GetMacAddress(),
         controller->GetLeFilterAcceptListSize(),
         controller->GetLeResolvingListSize());
+    le_address_manager_->SetListSyncWindow(std::chrono::milliseconds(
+        os::GetSystemPropertyUint32(kPropertyAcceptListSyncWindow, kAcceptListSyncWindowMs)));
   }
 
   ~le_impl() {
@@ -382,6 +390,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         create_le_connection(remote_address, false, false);
         return;
       }
+      on_direct_connection_attempt_complete(remote_address, status);
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
@@ -530,6 +539,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         create_le_connection(remote_address, false, false);
         return;
       }
+      on_direct_connection_attempt_complete(remote_address, status);
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
@@ -791,23 +801,25 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
   }
 
-  void add_device_to_connect_list(AddressWithType address_with_type) {
+  // Returns true if the device was added, and the filter accept list of the controller is updated
+  bool add_device_to_connect_list(AddressWithType address_with_type) {
     if (connections.alreadyConnected(address_with_type)) {
       LOG_INFO("Device already connected, return");
-      return;
+      return false;
     }
 
     if (connect_list.find(address_with_type) != connect_list.end()) {
       LOG_WARN(
           "Device already exists in acceptlist and cannot be added:%s",
           ADDRESS_TO_LOGGABLE_CSTR(address_with_type));
-      return;
+      return false;
     }
 
     connect_list.insert(address_with_type);
     register_with_address_manager();
     le_address_manager_->AddDeviceToFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    return true;
   }
 
   bool is_device_in_connect_list(AddressWithType address_with_type) {
@@ -823,6 +835,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     connect_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
     direct_connections_.erase(address_with_type);
+    direct_connection_attempts_.erase(address_with_type);
     register_with_address_manager();
     le_address_manager_->RemoveDeviceFromFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
@@ -1056,10 +1069,15 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
 
     // TODO: Configure default LE connection parameters?
+    bool connect_list_changed = false;
+    bool scan_parameters_changed = false;
     if (add_to_connect_list) {
-      add_device_to_connect_list(address_with_type);
+      connect_list_changed = add_device_to_connect_list(address_with_type);
       if (is_direct) {
+        // The first direct connection switches the scan to the fast parameters
+        scan_parameters_changed = direct_connections_.empty();
         direct_connections_.insert(address_with_type);
+        direct_connection_attempts_.emplace(address_with_type, std::chrono::steady_clock::now());
         if (create_connection_timeout_alarms_.find(address_with_type) == create_connection_timeout_alarms_.end()) {
           create_connection_timeout_alarms_.emplace(
               std::piecewise_construct,
@@ -1094,11 +1112,26 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     switch (connectability_state_) {
       case ConnectabilityState::ARMED:
       case ConnectabilityState::ARMING:
+        // A device already in the filter accept list does not pause the connection. It is only restarted, once
+        // armed, when its scan parameters have to change.
+        if (!connect_list_changed && scan_parameters_changed) {
+          LOG_INFO("Restarting le create connection with the direct connection parameters");
+          create_connection_restart_count_++;
+          disarm_connectability();
+          break;
+        }
         // Ignored, if we add new device to the filter accept list, create connection command will be sent by OnResume.
         LOG_DEBUG(
             "Deferred until filter accept list updated create connection state %s",
             connectability_state_machine_text(connectability_state_).c_str());
         break;
+      case ConnectabilityState::DISARMED:
+        // No filter accept list update to wait for
+        if (!connect_list_changed && !arm_on_resume_) {
+          handler_->CallOn(this, &le_impl::arm_connectability);
+          break;
+        }
+        [[fallthrough]];
       default:
         // If we added to filter accept list then the arming of the le state machine
         // must wait until the filter accept list command as completed
@@ -1131,6 +1164,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
       if (background_connections_.find(address_with_type) != background_connections_.end()) {
         direct_connections_.erase(address_with_type);
+        direct_connection_attempts_.erase(address_with_type);
         disarm_connectability();
       } else {
         cancel_connect(address_with_type);
@@ -1143,6 +1177,28 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
   }
 
+  // Accounts the time from the direct connection request to its connection complete
+  void on_direct_connection_attempt_complete(AddressWithType address_with_type, ErrorCode status) {
+    auto attempt = direct_connection_attempts_.find(address_with_type);
+    if (attempt == direct_connection_attempts_.end()) {
+      return;
+    }
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - attempt->second);
+    direct_connection_attempts_.erase(attempt);
+    LOG_INFO(
+        "Direct connection to %s completed in %lld ms, status:%s",
+        ADDRESS_TO_LOGGABLE_CSTR(address_with_type),
+        static_cast<long long>(latency.count()),
+        ErrorCodeText(status).c_str());
+    if (status != ErrorCode::SUCCESS) {
+      return;
+    }
+    direct_connection_count_++;
+    direct_connection_latency_total_ += latency;
+    direct_connection_latency_max_ = std::max(direct_connection_latency_max_, latency);
+  }
+
   void cancel_connect(AddressWithType address_with_type) {
     // Remove any alarms for this peer, if any
     if (create_connection_timeout_alarms_.find(address_with_type) != create_connection_timeout_alarms_.end()) {
@@ -1274,6 +1330,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     arm_on_resume_ = !connecting_le_.empty();
+    if (arm_on_resume_) {
+      create_connection_restart_count_++;
+      LOG_DEBUG("Restarting le create connection, %zu restarts so far", create_connection_restart_count_);
+    }
     disarm_connectability();
   }
 
@@ -1354,6 +1414,14 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   bool disarmed_while_arming_ = false;
   bool system_suspend_ = false;
   ConnectabilityState connectability_state_{ConnectabilityState::DISARMED};
+  // Create connections canceled to pause the connections, or to change the scan parameters, and sent again
+  size_t create_connection_restart_count_{0};
+  // Start of the pending direct connection requests
+  std::map<AddressWithType, std::chrono::steady_clock::time_point> direct_connection_attempts_{};
+  // Latency of the direct connections established
+  size_t direct_connection_count_{0};
+  std::chrono::milliseconds direct_connection_latency_total_{0};
+  std::chrono::milliseconds direct_connection_latency_max_{0};
   std::map<AddressWithType, os::Alarm> create_connection_timeout_alarms_{};
 };
 
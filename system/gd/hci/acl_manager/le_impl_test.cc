@@ -452,6 +452,8 @@ class LeImplTest : public ::testing::Test {
  protected:
   void SetUp() override {
     bluetooth::common::InitFlags::SetAllForTesting();
+    // Send the accept list changes as soon as they are made
+    os::SetSystemProperty(kPropertyAcceptListSyncWindow, "0");
     thread_ = new Thread("thread", Thread::Priority::NORMAL);
     handler_ = new Handler(thread_);
     controller_ = new TestController();
@@ -827,6 +829,88 @@ TEST_F(LeImplTest, enhanced_connection_complete_with_central_role) {
   ASSERT_EQ(ConnectabilityState::DISARMED, le_impl_->connectability_state_);
 }
 
+TEST_F(LeImplTest, direct_connection_of_a_background_device_restarts_with_fast_parameters) {
+  set_random_device_address_policy();
+
+  hci::Address remote_address;
+  Address::FromString("D0:05:04:03:02:01", remote_address);
+  hci::AddressWithType address_with_type(remote_address, hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  // Background connection
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  le_impl_->create_le_connection(address_with_type, true, false);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  hci_layer_->CommandCompleteCallback(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  auto command = LeCreateConnectionView::Create(LeConnectionManagementCommandView::Create(
+      AclCommandView::Create(hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION))));
+  ASSERT_TRUE(command.IsValid());
+  ASSERT_EQ(kScanIntervalSlow, command.GetLeScanInterval());
+  hci_layer_->CommandStatusCallback(LeCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+  ASSERT_EQ(ConnectabilityState::ARMED, le_impl_->connectability_state_);
+
+  // The direct connection of the same device does not update the filter accept list
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  le_impl_->create_le_connection(address_with_type, true, true);
+  hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION_CANCEL);
+  hci_layer_->CommandCompleteCallback(LeCreateConnectionCancelCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  ASSERT_EQ(1UL, le_impl_->create_connection_restart_count_);
+
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  hci_layer_->IncomingLeMetaEvent(LeConnectionCompleteBuilder::Create(
+      ErrorCode::UNKNOWN_CONNECTION,
+      0x0000,
+      Role::CENTRAL,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      Address::kEmpty,
+      0x0000,
+      0x0000,
+      0x0000,
+      ClockAccuracy::PPM_30));
+  command = LeCreateConnectionView::Create(LeConnectionManagementCommandView::Create(
+      AclCommandView::Create(hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION))));
+  ASSERT_TRUE(command.IsValid());
+  ASSERT_EQ(kScanIntervalFast, command.GetLeScanInterval());
+  hci_layer_->CommandStatusCallback(LeCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+  ASSERT_EQ(ConnectabilityState::ARMED, le_impl_->connectability_state_);
+  ASSERT_TRUE(hci_layer_->IsPacketQueueEmpty());
+}
+
+TEST_F(LeImplTest, direct_connection_latency) {
+  set_random_device_address_policy();
+
+  hci::Address remote_address;
+  Address::FromString("D0:05:04:03:02:01", remote_address);
+  hci::AddressWithType address_with_type(remote_address, hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  le_impl_->create_le_connection(address_with_type, true, true);
+  ASSERT_EQ(1UL, le_impl_->direct_connection_attempts_.size());
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_NO_FATAL_FAILURE(hci_layer_->SetCommandFuture());
+  hci_layer_->CommandCompleteCallback(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  hci_layer_->GetCommand(OpCode::LE_CREATE_CONNECTION);
+  hci_layer_->CommandStatusCallback(LeCreateConnectionStatusBuilder::Create(ErrorCode::SUCCESS, 0x01));
+  sync_handler();
+
+  EXPECT_CALL(mock_le_connection_callbacks_, OnLeConnectSuccess(address_with_type, _));
+  hci_layer_->IncomingLeMetaEvent(LeConnectionCompleteBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x0041,
+      Role::CENTRAL,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      remote_address,
+      0x0024,
+      0x0000,
+      0x0011,
+      ClockAccuracy::PPM_30));
+  sync_handler();
+
+  ASSERT_TRUE(le_impl_->direct_connection_attempts_.empty());
+  ASSERT_EQ(1UL, le_impl_->direct_connection_count_);
+  ASSERT_LE(le_impl_->direct_connection_latency_max_, le_impl_->direct_connection_latency_total_);
+}
+
 // b/260917913
 TEST_F(LeImplTest, DISABLED_register_with_address_manager__AddressPolicyNotSet) {
   auto log_capture = std::make_unique<LogCapture>();
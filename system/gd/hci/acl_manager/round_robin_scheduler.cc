@@ -17,10 +17,16 @@
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/acl_manager/acl_fragmenter.h"
 
+#include <algorithm>
+
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
 RoundRobinScheduler::RoundRobinScheduler(
     os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end)
     : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end) {
@@ -43,7 +49,8 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
                                    std::shared_ptr<acl_manager::AclConnection::Queue> queue) {
   ASSERT(acl_queue_handlers_.count(handle) == 0);
   acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
-  acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  acl_queue_handlers_.insert(
+      std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, std::move(acl_queue_handler)));
   if (fragments_to_send_.size() == 0) {
     start_round_robin();
   }
@@ -51,13 +58,19 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
 
 void RoundRobinScheduler::Unregister(uint16_t handle) {
   ASSERT(acl_queue_handlers_.count(handle) == 1);
-  auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
+  auto& acl_queue_handler = acl_queue_handlers_.find(handle)->second;
   // Reclaim outstanding packets
+  bool credit_was_zero;
   if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
+    credit_was_zero = acl_packet_credits_ == 0;
     acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
   } else {
+    credit_was_zero = le_acl_packet_credits_ == 0;
     le_acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
   }
+  if (acl_queue_handler.number_of_sent_packets_ > 0) {
+    on_credits_returned(acl_queue_handler.connection_type_, credit_was_zero);
+  }
   acl_queue_handler.number_of_sent_packets_ = 0;
 
   if (acl_queue_handler.dequeue_is_registered_) {
@@ -77,6 +90,133 @@ void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
   acl_queue_handler->second.high_priority_ = high_priority;
 }
 
+void RoundRobinScheduler::SetSchedulingMode(SchedulingMode mode) {
+  if (mode == scheduling_mode_) {
+    return;
+  }
+  scheduling_mode_ = mode;
+  if (mode == WEIGHTED_FAIR) {
+    for (auto& acl_queue_handler : acl_queue_handlers_) {
+      acl_queue_handler.second.deficit_ = 0;
+    }
+    return;
+  }
+  // Round robin doesn't hold packets back, send the ones that were waiting for enough deficit
+  for (auto acl_queue_handler = acl_queue_handlers_.begin(); acl_queue_handler != acl_queue_handlers_.end();
+       acl_queue_handler = std::next(acl_queue_handler)) {
+    if (acl_queue_handler->second.head_of_line_packet_ != nullptr) {
+      buffer_fragments(
+          acl_queue_handler,
+          std::move(acl_queue_handler->second.head_of_line_packet_),
+          acl_queue_handler->second.head_of_line_time_);
+    }
+  }
+  if (!fragments_to_send_.empty()) {
+    unregister_all_connections();
+    start_round_robin();
+  }
+}
+
+void RoundRobinScheduler::SetLinkWeight(uint16_t handle, uint8_t weight) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  if (weight == 0) {
+    LOG_WARN("Ignore weight 0 for handle %d", handle);
+    return;
+  }
+  acl_queue_handler->second.weight_ = weight;
+}
+
+void RoundRobinScheduler::SetCreditReservation(uint16_t handle, uint16_t credits) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  ConnectionType connection_type = acl_queue_handler->second.connection_type_;
+  uint16_t max_credits =
+      connection_type == ConnectionType::CLASSIC ? max_acl_packet_credits_ : le_max_acl_packet_credits_;
+  size_t reserved_credits = credits;
+  for (const auto& other : acl_queue_handlers_) {
+    if (other.first != handle && other.second.connection_type_ == connection_type) {
+      reserved_credits += other.second.reserved_credits_;
+    }
+  }
+  // At least one buffer has to remain shared, or the connections without a reservation would never send
+  if (reserved_credits >= max_credits) {
+    LOG_WARN(
+        "Can't reserve %hu credits for handle %d, %zu out of %hu would be reserved",
+        credits,
+        handle,
+        reserved_credits,
+        max_credits);
+    return;
+  }
+  acl_queue_handler->second.reserved_credits_ = credits;
+  if (scheduling_mode_ == WEIGHTED_FAIR && fragments_to_send_.empty()) {
+    start_round_robin();
+  }
+}
+
+void RoundRobinScheduler::GetLinkStats(uint16_t handle, std::promise<AclTxStats> promise) {
+  AclTxStats stats;
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    promise.set_value(stats);
+    return;
+  }
+  const auto& link = acl_queue_handler->second;
+  stats.queue_depth = link.queued_fragments_;
+  if (link.head_of_line_packet_ != nullptr) {
+    stats.queue_depth += number_of_fragments(link.connection_type_, *link.head_of_line_packet_);
+  }
+  stats.max_queue_depth = link.max_queued_fragments_;
+  stats.in_flight = link.number_of_sent_packets_;
+  stats.max_in_flight = link.max_sent_packets_;
+  stats.sent_fragments = link.sent_fragments_;
+  stats.total_latency = link.total_latency_;
+  stats.max_latency = link.max_latency_;
+  promise.set_value(stats);
+}
+
+void RoundRobinScheduler::GetBufferStats(ConnectionType connection_type, std::promise<AclBufferStats> promise) {
+  const auto& accounting = buffer_accounting_[connection_type];
+  AclBufferStats stats;
+  if (connection_type == ConnectionType::CLASSIC) {
+    stats.total_credits = max_acl_packet_credits_;
+    stats.available_credits = acl_packet_credits_;
+  } else {
+    stats.total_credits = le_max_acl_packet_credits_;
+    stats.available_credits = le_acl_packet_credits_;
+  }
+  stats.max_credits_in_use = accounting.max_credits_in_use_;
+  stats.credit_exhaustion_count = accounting.credit_exhaustion_count_;
+  stats.total_credit_wait = accounting.total_credit_wait_;
+  if (stats.available_credits == 0 && stats.total_credits > 0) {
+    // Include the wait still going on
+    stats.total_credit_wait += duration_cast<microseconds>(steady_clock::now() - accounting.exhaustion_time_);
+  }
+  stats.congested = accounting.congested_;
+  promise.set_value(stats);
+}
+
+void RoundRobinScheduler::SetBackpressureCallback(
+    uint16_t handle, common::ContextualCallback<void(bool congested)> callback) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  acl_queue_handler->second.backpressure_callback_ = std::move(callback);
+  if (buffer_accounting_[acl_queue_handler->second.connection_type_].congested_) {
+    acl_queue_handler->second.backpressure_callback_.Invoke(true);
+  }
+}
+
 uint16_t RoundRobinScheduler::GetCredits() {
   return acl_packet_credits_;
 }
@@ -90,7 +230,7 @@ void RoundRobinScheduler::start_round_robin() {
     return;
   }
   if (!fragments_to_send_.empty()) {
-    auto connection_type = fragments_to_send_.front().first;
+    auto connection_type = fragments_to_send_.front().connection_type_;
     bool classic_buffer_full = acl_packet_credits_ == 0 && connection_type == ConnectionType::CLASSIC;
     bool le_buffer_full = le_acl_packet_credits_ == 0 && connection_type == ConnectionType::LE;
     if (classic_buffer_full || le_buffer_full) {
@@ -104,6 +244,10 @@ void RoundRobinScheduler::start_round_robin() {
     LOG_INFO("No any acl connection");
     return;
   }
+  if (scheduling_mode_ == WEIGHTED_FAIR) {
+    start_weighted_fair_queuing();
+    return;
+  }
 
   if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
     starting_point_ = acl_queue_handlers_.begin();
@@ -131,19 +275,113 @@ void RoundRobinScheduler::start_round_robin() {
   starting_point_ = std::next(starting_point_);
 }
 
+// Deficit round robin: the connection being served keeps sending as long as its deficit covers the fragments of its
+// next packet, then the next connection with something to send gets its weight added to its deficit. Packets are taken
+// from the connection queues directly, the dequeue callbacks are only registered once all of them are empty.
+void RoundRobinScheduler::start_weighted_fair_queuing() {
+  if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
+    starting_point_ = acl_queue_handlers_.begin();
+  }
+
+  // Stop after visiting every connection once without any of them having anything to send
+  size_t idle_count = 0;
+  while (idle_count < acl_queue_handlers_.size()) {
+    auto& link = starting_point_->second;
+    if (has_credits_for(starting_point_)) {
+      if (link.head_of_line_packet_ == nullptr) {
+        link.head_of_line_packet_ = link.queue_->GetDownEnd()->TryDequeue();
+        link.head_of_line_time_ = steady_clock::now();
+      }
+      if (link.head_of_line_packet_ != nullptr) {
+        size_t fragments = number_of_fragments(link.connection_type_, *link.head_of_line_packet_);
+        if (link.deficit_ >= fragments) {
+          link.deficit_ -= fragments;
+          unregister_all_connections();
+          buffer_fragments(starting_point_, std::move(link.head_of_line_packet_), link.head_of_line_time_);
+          send_next_fragment();
+          return;
+        }
+        idle_count = 0;
+      } else {
+        // Like in any deficit round robin, an idle connection doesn't save up for later
+        link.deficit_ = 0;
+        idle_count++;
+      }
+    } else {
+      idle_count++;
+    }
+
+    starting_point_ = std::next(starting_point_);
+    if (starting_point_ == acl_queue_handlers_.end()) {
+      starting_point_ = acl_queue_handlers_.begin();
+    }
+    if (has_credits_for(starting_point_)) {
+      starting_point_->second.deficit_ += starting_point_->second.weight_;
+    }
+  }
+
+  for (auto acl_queue_handler = acl_queue_handlers_.begin(); acl_queue_handler != acl_queue_handlers_.end();
+       acl_queue_handler = std::next(acl_queue_handler)) {
+    if (!acl_queue_handler->second.dequeue_is_registered_ && has_credits_for(acl_queue_handler)) {
+      acl_queue_handler->second.dequeue_is_registered_ = true;
+      uint16_t acl_handle = acl_queue_handler->first;
+      acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
+          handler_, common::Bind(&RoundRobinScheduler::buffer_packet, common::Unretained(this), acl_handle));
+    }
+  }
+}
+
+bool RoundRobinScheduler::has_credits_for(
+    std::map<uint16_t, acl_queue_handler>::const_iterator acl_queue_handler) const {
+  ConnectionType connection_type = acl_queue_handler->second.connection_type_;
+  uint16_t credits = connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ : le_acl_packet_credits_;
+  if (scheduling_mode_ != WEIGHTED_FAIR) {
+    return credits > 0;
+  }
+  // Leave the part of their reservation the other connections aren't using
+  size_t reserved_for_others = 0;
+  for (auto other = acl_queue_handlers_.begin(); other != acl_queue_handlers_.end(); other = std::next(other)) {
+    if (other != acl_queue_handler && other->second.connection_type_ == connection_type &&
+        other->second.reserved_credits_ > other->second.number_of_sent_packets_) {
+      reserved_for_others += other->second.reserved_credits_ - other->second.number_of_sent_packets_;
+    }
+  }
+  return credits > reserved_for_others;
+}
+
+size_t RoundRobinScheduler::number_of_fragments(
+    ConnectionType connection_type, const packet::BasePacketBuilder& packet) const {
+  size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
+  return std::max<size_t>(1, (packet.size() + mtu - 1) / mtu);
+}
+
 void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
-  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
   auto acl_queue_handler = acl_queue_handlers_.find(acl_handle);
   if( acl_queue_handler == acl_queue_handlers_.end()) {
     LOG_ERROR("Ignore since ACL connection vanished with handle: 0x%X", acl_handle);
     return;
   }
+  if (scheduling_mode_ == WEIGHTED_FAIR) {
+    // The deficits decide which connection goes first, not the order in which their queues became ready
+    unregister_all_connections();
+    start_weighted_fair_queuing();
+    return;
+  }
 
-  // Wrap packet and enqueue it
-  uint16_t handle = acl_queue_handler->first;
   auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
   ASSERT(packet != nullptr);
+  unregister_all_connections();
+  buffer_fragments(acl_queue_handler, std::move(packet), steady_clock::now());
+  send_next_fragment();
+}
 
+void RoundRobinScheduler::buffer_fragments(
+    std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler,
+    std::unique_ptr<packet::BasePacketBuilder> packet,
+    steady_clock::time_point buffered_time) {
+  BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
+  // Wrap packet and enqueue it
+  uint16_t handle = acl_queue_handler->first;
   ConnectionType connection_type = acl_queue_handler->second.connection_type_;
   size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
   PacketBoundaryFlag packet_boundary_flag = (packet->IsFlushable())
@@ -151,27 +389,37 @@ void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
                                                 : PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE;
 
   int acl_priority = acl_queue_handler->second.high_priority_ ? 1 : 0;
+  size_t number_of_fragments = 0;
   if (packet->size() <= mtu) {
     fragments_to_send_.push(
-        std::make_pair(
-            connection_type, AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))),
+        fragment{
+            connection_type,
+            handle,
+            buffered_time,
+            AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(packet))},
         acl_priority);
+    number_of_fragments = 1;
   } else {
     auto fragments = AclFragmenter(mtu, std::move(packet)).GetFragments();
     for (size_t i = 0; i < fragments.size(); i++) {
       fragments_to_send_.push(
-          std::make_pair(
+          fragment{
               connection_type,
-              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))),
+              handle,
+              buffered_time,
+              AclBuilder::Create(handle, packet_boundary_flag, broadcast_flag, std::move(fragments[i]))},
           acl_priority);
       packet_boundary_flag = PacketBoundaryFlag::CONTINUING_FRAGMENT;
     }
+    number_of_fragments = fragments.size();
   }
-  ASSERT(fragments_to_send_.size() > 0);
-  unregister_all_connections();
+  ASSERT(number_of_fragments > 0);
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
-  send_next_fragment();
+  auto& link = acl_queue_handler->second;
+  link.number_of_sent_packets_ += number_of_fragments;
+  link.queued_fragments_ += number_of_fragments;
+  link.max_sent_packets_ = std::max(link.max_sent_packets_, link.number_of_sent_packets_);
+  link.max_queued_fragments_ = std::max(link.max_queued_fragments_, link.queued_fragments_);
 }
 
 void RoundRobinScheduler::unregister_all_connections() {
@@ -193,7 +441,7 @@ void RoundRobinScheduler::send_next_fragment() {
 
 // Invoked from some external Queue Reactable context 1
 std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment() {
-  ConnectionType connection_type = fragments_to_send_.front().first;
+  ConnectionType connection_type = fragments_to_send_.front().connection_type_;
   if (connection_type == ConnectionType::CLASSIC) {
     ASSERT(acl_packet_credits_ > 0);
     acl_packet_credits_ -= 1;
@@ -201,8 +449,20 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     ASSERT(le_acl_packet_credits_ > 0);
     le_acl_packet_credits_ -= 1;
   }
+  on_credits_used(connection_type);
+
+  auto acl_queue_handler = acl_queue_handlers_.find(fragments_to_send_.front().handle_);
+  // The connection may be gone, or its handle reused by a new one
+  if (acl_queue_handler != acl_queue_handlers_.end() && acl_queue_handler->second.queued_fragments_ > 0) {
+    auto& link = acl_queue_handler->second;
+    auto latency = duration_cast<microseconds>(steady_clock::now() - fragments_to_send_.front().buffered_time_);
+    link.queued_fragments_--;
+    link.sent_fragments_++;
+    link.total_latency_ += latency;
+    link.max_latency_ = std::max(link.max_latency_, latency);
+  }
 
-  auto raw_pointer = fragments_to_send_.front().second.release();
+  auto raw_pointer = fragments_to_send_.front().packet_.release();
   fragments_to_send_.pop();
   if (fragments_to_send_.empty()) {
     if (enqueue_registered_.exchange(false)) {
@@ -210,7 +470,7 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
     }
     handler_->Post(common::BindOnce(&RoundRobinScheduler::start_round_robin, common::Unretained(this)));
   } else {
-    ConnectionType next_connection_type = fragments_to_send_.front().first;
+    ConnectionType next_connection_type = fragments_to_send_.front().connection_type_;
     bool classic_buffer_full = next_connection_type == ConnectionType::CLASSIC && acl_packet_credits_ == 0;
     bool le_buffer_full = next_connection_type == ConnectionType::LE && le_acl_packet_credits_ == 0;
     if ((classic_buffer_full || le_buffer_full) && enqueue_registered_.exchange(false)) {
@@ -253,11 +513,63 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("le acl packet credits overflow due to receive %hx credits", credits);
     }
   }
-  if (credit_was_zero) {
+  on_credits_returned(acl_queue_handler->second.connection_type_, credit_was_zero);
+  // Credits coming back may also release a reservation that held weighted fair queuing back
+  if (credit_was_zero || (scheduling_mode_ == WEIGHTED_FAIR && fragments_to_send_.empty())) {
     start_round_robin();
   }
 }
 
+void RoundRobinScheduler::on_credits_used(ConnectionType connection_type) {
+  auto& accounting = buffer_accounting_[connection_type];
+  uint16_t max_credits, credits;
+  if (connection_type == ConnectionType::CLASSIC) {
+    max_credits = max_acl_packet_credits_;
+    credits = acl_packet_credits_;
+  } else {
+    max_credits = le_max_acl_packet_credits_;
+    credits = le_acl_packet_credits_;
+  }
+  accounting.max_credits_in_use_ = std::max<uint16_t>(accounting.max_credits_in_use_, max_credits - credits);
+  if (credits == 0) {
+    accounting.credit_exhaustion_count_++;
+    accounting.exhaustion_time_ = steady_clock::now();
+    set_congested(connection_type, true);
+  }
+}
+
+void RoundRobinScheduler::on_credits_returned(ConnectionType connection_type, bool credit_was_zero) {
+  auto& accounting = buffer_accounting_[connection_type];
+  uint16_t max_credits, credits;
+  if (connection_type == ConnectionType::CLASSIC) {
+    max_credits = max_acl_packet_credits_;
+    credits = acl_packet_credits_;
+  } else {
+    max_credits = le_max_acl_packet_credits_;
+    credits = le_acl_packet_credits_;
+  }
+  if (credit_was_zero && credits > 0) {
+    accounting.total_credit_wait_ += duration_cast<microseconds>(steady_clock::now() - accounting.exhaustion_time_);
+  }
+  // Wait for half of the buffers, so that a trickle of completed packets doesn't toggle the backpressure every time
+  if (credits > 0 && 2 * credits >= max_credits) {
+    set_congested(connection_type, false);
+  }
+}
+
+void RoundRobinScheduler::set_congested(ConnectionType connection_type, bool congested) {
+  auto& accounting = buffer_accounting_[connection_type];
+  if (accounting.congested_ == congested) {
+    return;
+  }
+  accounting.congested_ = congested;
+  for (auto& acl_queue_handler : acl_queue_handlers_) {
+    if (acl_queue_handler.second.connection_type_ == connection_type) {
+      acl_queue_handler.second.backpressure_callback_.InvokeIfNotEmpty(congested);
+    }
+  }
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
@@ -18,9 +18,14 @@
 
 #include <stdint.h>
 
+#include <chrono>
+#include <future>
+
 #include "common/bidi_queue.h"
+#include "common/contextual_callback.h"
 #include "common/multi_priority_queue.h"
 #include "hci/acl_manager.h"
+#include "hci/acl_manager/acl_tx_stats.h"
 #include "hci/controller.h"
 #include "hci/hci_packets.h"
 #include "os/handler.h"
@@ -37,42 +42,97 @@ class RoundRobinScheduler {
 
   enum ConnectionType { CLASSIC, LE };
 
+  // ROUND_ROBIN takes one packet from each connection in turn. WEIGHTED_FAIR is a deficit round robin, where each
+  // connection may send as many fragments per round as its weight, and may have controller buffers reserved for it.
+  enum SchedulingMode { ROUND_ROBIN, WEIGHTED_FAIR };
+
   struct acl_queue_handler {
     ConnectionType connection_type_;
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
     bool high_priority_ = false;           // For A2dp use
+    // Weighted fair queuing
+    uint8_t weight_ = 1;
+    uint16_t reserved_credits_ = 0;
+    size_t deficit_ = 0;  // Fragments the connection may still send in this round
+    std::unique_ptr<packet::BasePacketBuilder> head_of_line_packet_;  // Dequeued, waiting for enough deficit
+    std::chrono::steady_clock::time_point head_of_line_time_;
+    // Statistics
+    size_t queued_fragments_ = 0;
+    uint64_t sent_fragments_ = 0;
+    std::chrono::microseconds total_latency_{0};
+    std::chrono::microseconds max_latency_{0};
+    size_t max_queued_fragments_ = 0;
+    uint16_t max_sent_packets_ = 0;
+    common::ContextualCallback<void(bool congested)> backpressure_callback_;
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  void SetSchedulingMode(SchedulingMode mode);
+  // Share of the controller buffers the connection gets in WEIGHTED_FAIR mode, relative to the other connections
+  void SetLinkWeight(uint16_t handle, uint8_t weight);
+  // Controller buffers the other connections leave for this one in WEIGHTED_FAIR mode
+  void SetCreditReservation(uint16_t handle, uint16_t credits);
+  void GetLinkStats(uint16_t handle, std::promise<AclTxStats> promise);
+  void GetBufferStats(ConnectionType connection_type, std::promise<AclBufferStats> promise);
+  // Invoked with true once the controller buffers of the connection type are all used up, so that the upper layer
+  // stops dequeuing packets it can't send anyway, and with false once half of them are available again
+  void SetBackpressureCallback(uint16_t handle, common::ContextualCallback<void(bool congested)> callback);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
 
  private:
+  struct fragment {
+    ConnectionType connection_type_;
+    uint16_t handle_;
+    std::chrono::steady_clock::time_point buffered_time_;
+    std::unique_ptr<AclBuilder> packet_;
+  };
+
   void start_round_robin();
+  void start_weighted_fair_queuing();
   void buffer_packet(uint16_t acl_handle);
+  void buffer_fragments(
+      std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler,
+      std::unique_ptr<packet::BasePacketBuilder> packet,
+      std::chrono::steady_clock::time_point buffered_time);
+  size_t number_of_fragments(ConnectionType connection_type, const packet::BasePacketBuilder& packet) const;
+  bool has_credits_for(std::map<uint16_t, acl_queue_handler>::const_iterator acl_queue_handler) const;
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
+  void on_credits_used(ConnectionType connection_type);
+  void on_credits_returned(ConnectionType connection_type, bool credit_was_zero);
+  void set_congested(ConnectionType connection_type, bool congested);
+
+  struct buffer_accounting {
+    uint16_t max_credits_in_use_ = 0;
+    uint64_t credit_exhaustion_count_ = 0;
+    std::chrono::steady_clock::time_point exhaustion_time_;
+    std::chrono::microseconds total_credit_wait_{0};
+    bool congested_ = false;
+  };
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
-  common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
+  common::MultiPriorityQueue<fragment, 2> fragments_to_send_;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
   uint16_t le_max_acl_packet_credits_ = 0;
   uint16_t le_acl_packet_credits_ = 0;
+  buffer_accounting buffer_accounting_[2];  // Indexed by ConnectionType
   size_t hci_mtu_{0};
   size_t le_hci_mtu_{0};
   std::atomic_bool enqueue_registered_ = false;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
-  // first register queue end for the Round-robin schedule
+  SchedulingMode scheduling_mode_ = ROUND_ROBIN;
+  // first register queue end for the Round-robin schedule, connection being served in WEIGHTED_FAIR mode
   std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
 };
 
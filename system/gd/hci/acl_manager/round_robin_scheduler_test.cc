@@ -152,6 +152,24 @@ class RoundRobinSchedulerTest : public ::testing::Test {
     sent_acl_packets_.pop();
   }
 
+  AclTxStats GetLinkStats(uint16_t handle) {
+    std::promise<AclTxStats> promise;
+    auto future = promise.get_future();
+    handler_->CallOn(round_robin_scheduler_, &RoundRobinScheduler::GetLinkStats, handle, std::move(promise));
+    return future.get();
+  }
+
+  AclBufferStats GetBufferStats(RoundRobinScheduler::ConnectionType connection_type) {
+    std::promise<AclBufferStats> promise;
+    auto future = promise.get_future();
+    handler_->CallOn(round_robin_scheduler_, &RoundRobinScheduler::GetBufferStats, connection_type, std::move(promise));
+    return future.get();
+  }
+
+  void OnBackpressure(bool congested) {
+    backpressure_.push_back(congested);
+  }
+
   void SetPacketFuture(uint16_t count) {
     ASSERT_EQ(packet_promise_, nullptr) << "Promises, Promises, ... Only one at a time.";
     packet_count_ = count;
@@ -170,6 +188,7 @@ class RoundRobinSchedulerTest : public ::testing::Test {
   std::unique_ptr<std::future<void>> packet_future_;
   std::unique_ptr<std::promise<void>> enqueue_promise_;
   std::unique_ptr<std::future<void>> enqueue_future_;
+  std::vector<bool> backpressure_;
 };
 
 TEST_F(RoundRobinSchedulerTest, startup_teardown) {}
@@ -412,6 +431,171 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, weighted_fair_queuing_follows_weights) {
+  uint16_t le_handle1 = 0x01;
+  uint16_t le_handle2 = 0x02;
+  auto le_connection_queue1 = std::make_shared<AclConnection::Queue>(10);
+  auto le_connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+
+  // Both connections are backlogged before they get scheduled
+  for (uint8_t i = 0; i < 8; i++) {
+    EnqueueAclUpEnd(le_connection_queue1->GetUpEnd(), {0x01, i});
+  }
+  for (uint8_t i = 0; i < 4; i++) {
+    EnqueueAclUpEnd(le_connection_queue2->GetUpEnd(), {0x02, i});
+  }
+  enqueue_future_->wait();
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(12));
+  handler_->Post(common::BindOnce(
+      [](RoundRobinScheduler* scheduler,
+         uint16_t le_handle1,
+         std::shared_ptr<AclConnection::Queue> le_connection_queue1,
+         uint16_t le_handle2,
+         std::shared_ptr<AclConnection::Queue> le_connection_queue2) {
+        scheduler->SetSchedulingMode(RoundRobinScheduler::WEIGHTED_FAIR);
+        scheduler->Register(RoundRobinScheduler::ConnectionType::LE, le_handle1, le_connection_queue1);
+        scheduler->Register(RoundRobinScheduler::ConnectionType::LE, le_handle2, le_connection_queue2);
+        scheduler->SetLinkWeight(le_handle1, 3);
+      },
+      common::Unretained(round_robin_scheduler_),
+      le_handle1,
+      le_connection_queue1,
+      le_handle2,
+      le_connection_queue2));
+  packet_future_->wait();
+
+  // The first packet went out before the weight was set, then three packets of the first connection go for each one
+  // of the second
+  VerifyPacket(le_handle1, {0x01, 0});
+  VerifyPacket(le_handle2, {0x02, 0});
+  for (uint8_t i = 0; i < 2; i++) {
+    VerifyPacket(le_handle1, {0x01, static_cast<uint8_t>(3 * i + 1)});
+    VerifyPacket(le_handle1, {0x01, static_cast<uint8_t>(3 * i + 2)});
+    VerifyPacket(le_handle1, {0x01, static_cast<uint8_t>(3 * i + 3)});
+    VerifyPacket(le_handle2, {0x02, static_cast<uint8_t>(i + 1)});
+  }
+  VerifyPacket(le_handle1, {0x01, 7});
+  VerifyPacket(le_handle2, {0x02, 3});
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), controller_->le_max_acl_packet_credits_ - 12);
+
+  auto stats = GetLinkStats(le_handle1);
+  ASSERT_EQ(stats.sent_fragments, 8u);
+  ASSERT_EQ(stats.queue_depth, 0u);
+  ASSERT_LE(stats.max_latency, stats.total_latency);
+  ASSERT_EQ(GetLinkStats(le_handle2).sent_fragments, 4u);
+
+  round_robin_scheduler_->Unregister(le_handle1);
+  round_robin_scheduler_->Unregister(le_handle2);
+}
+
+TEST_F(RoundRobinSchedulerTest, weighted_fair_queuing_keeps_reserved_credits) {
+  uint16_t handle1 = 0x01;
+  uint16_t handle2 = 0x02;
+  auto connection_queue1 = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+
+  for (uint8_t i = 0; i < 10; i++) {
+    EnqueueAclUpEnd(connection_queue2->GetUpEnd(), {0x02, i});
+  }
+  enqueue_future_->wait();
+
+  // The second connection may only use the credits the first one didn't reserve
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(6));
+  handler_->Post(common::BindOnce(
+      [](RoundRobinScheduler* scheduler,
+         uint16_t handle1,
+         std::shared_ptr<AclConnection::Queue> connection_queue1,
+         uint16_t handle2,
+         std::shared_ptr<AclConnection::Queue> connection_queue2) {
+        scheduler->SetSchedulingMode(RoundRobinScheduler::WEIGHTED_FAIR);
+        scheduler->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle1, connection_queue1);
+        scheduler->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+        scheduler->SetCreditReservation(handle1, 4);
+      },
+      common::Unretained(round_robin_scheduler_),
+      handle1,
+      connection_queue1,
+      handle2,
+      connection_queue2));
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(sent_acl_packets_.size(), 6u);
+  for (uint8_t i = 0; i < 6; i++) {
+    VerifyPacket(handle2, {0x02, i});
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 4);
+  auto stats = GetLinkStats(handle2);
+  ASSERT_EQ(stats.sent_fragments, 6u);
+  ASSERT_EQ(stats.queue_depth, 0u);
+
+  // The reserved credits are still there for the first connection
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(1));
+  EnqueueAclUpEnd(connection_queue1->GetUpEnd(), {0x01, 0x00});
+  packet_future_->wait();
+  VerifyPacket(handle1, {0x01, 0x00});
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 3);
+
+  // Only the unused part of the reservation is held back once the second connection gets its credits back
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(4));
+  controller_->SendCompletedAclPacketsCallback(handle2, 6);
+  packet_future_->wait();
+  for (uint8_t i = 6; i < 10; i++) {
+    VerifyPacket(handle2, {0x02, i});
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 5);
+
+  round_robin_scheduler_->Unregister(handle1);
+  round_robin_scheduler_->Unregister(handle2);
+}
+
+TEST_F(RoundRobinSchedulerTest, backpressure_and_buffer_accounting) {
+  uint16_t handle = 0x01;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(15);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  handler_->CallOn(
+      round_robin_scheduler_,
+      &RoundRobinScheduler::SetBackpressureCallback,
+      handle,
+      handler_->BindOn(this, &RoundRobinSchedulerTest::OnBackpressure));
+  sync_handler();
+
+  // Use up every controller buffer
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x01, i});
+  }
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(backpressure_, std::vector<bool>({true}));
+
+  auto buffer_stats = GetBufferStats(RoundRobinScheduler::ConnectionType::CLASSIC);
+  ASSERT_EQ(buffer_stats.total_credits, controller_->max_acl_packet_credits_);
+  ASSERT_EQ(buffer_stats.available_credits, 0);
+  ASSERT_EQ(buffer_stats.max_credits_in_use, controller_->max_acl_packet_credits_);
+  ASSERT_EQ(buffer_stats.credit_exhaustion_count, 1u);
+  ASSERT_TRUE(buffer_stats.congested);
+  ASSERT_FALSE(GetBufferStats(RoundRobinScheduler::ConnectionType::LE).congested);
+
+  // Backpressure is only released once half of the buffers are available
+  controller_->SendCompletedAclPacketsCallback(handle, controller_->max_acl_packet_credits_ / 2 - 1);
+  sync_handler();
+  ASSERT_EQ(backpressure_, std::vector<bool>({true}));
+  controller_->SendCompletedAclPacketsCallback(handle, 1);
+  sync_handler();
+  ASSERT_EQ(backpressure_, std::vector<bool>({true, false}));
+
+  buffer_stats = GetBufferStats(RoundRobinScheduler::ConnectionType::CLASSIC);
+  ASSERT_EQ(buffer_stats.available_credits, controller_->max_acl_packet_credits_ / 2);
+  ASSERT_FALSE(buffer_stats.congested);
+  auto link_stats = GetLinkStats(handle);
+  ASSERT_EQ(link_stats.in_flight, controller_->max_acl_packet_credits_ / 2);
+  ASSERT_EQ(link_stats.max_in_flight, controller_->max_acl_packet_credits_);
+  ASSERT_EQ(link_stats.max_queue_depth, 1u);
+
+  round_robin_scheduler_->Unregister(handle);
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
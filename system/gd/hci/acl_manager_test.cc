@@ -33,6 +33,7 @@
 #include "hci/hci_layer.h"
 #include "hci/hci_layer_fake.h"
 #include "os/fake_timer/fake_timerfd.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -105,6 +106,8 @@ class TestController : public Controller {
 class AclManagerNoCallbacksTest : public ::testing::Test {
  protected:
   void SetUp() override {
+    // Send the accept list changes as soon as they are made, the alarms running on fake timers
+    os::SetSystemProperty("bluetooth.core.le.accept_list_sync_window_ms", "0");
     test_hci_layer_ = new TestHciLayer;  // Ownership is transferred to registry
     test_controller_ = new TestController;
     fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
@@ -1189,6 +1192,8 @@ TEST_F(AclManagerWithConnectionTest, send_read_clock) {
 class AclManagerWithResolvableAddressTest : public AclManagerNoCallbacksTest {
  protected:
   void SetUp() override {
+    // Send the accept list changes as soon as they are made, the alarms running on fake timers
+    os::SetSystemProperty("bluetooth.core.le.accept_list_sync_window_ms", "0");
     test_hci_layer_ = new TestHciLayer;  // Ownership is transferred to registry
     test_controller_ = new TestController;
     fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
@@ -17,16 +17,23 @@
 #include "hci/controller.h"
 
 #include <android-base/strings.h>
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/init_flags.h"
 #include "hci/hci_layer.h"
 #include "hci_controller_generated.h"
 #include "os/metrics.h"
 #include "os/system_properties.h"
+#include "storage/storage_module.h"
 #include "sysprops/sysprops_module.h"
 
 namespace bluetooth {
@@ -44,48 +51,73 @@ constexpr bool kDefaultErroneousDataReportingEnabled = true;
 static const std::string kPropertyErroneousDataReportingEnabled =
     "bluetooth.hci.erroneous_data_reporting.enabled";
 
+// What the controller reports about itself is cached in storage, for as long as its firmware is the same
+static const std::string kControllerSection = "Controller";
+static const std::string kFirmwareVersionProperty = "FirmwareVersion";
+static const std::string kSupportedCommandsProperty = "SupportedCommands";
+static const std::string kLmpFeaturesProperty = "LmpFeatures";
+static const std::string kLeFeaturesProperty = "LeFeatures";
+static const std::string kLeStatesProperty = "LeStates";
+static const std::string kCachedValueProperties[] = {
+    "LeFilterAcceptListSize",
+    "LeResolvingListSize",
+    "LeMaxTxOctets",
+    "LeMaxTxTime",
+    "LeMaxRxOctets",
+    "LeMaxRxTime",
+    "LeMaxAdvertisingDataLength",
+    "LeNumberOfAdvertisingSets",
+    "LePeriodicAdvertiserListSize",
+};
+
 using os::Handler;
 
 struct Controller::impl {
   impl(Controller& module) : module_(module) {}
 
-  void Start(hci::HciLayer* hci) {
+  void Start(hci::HciLayer* hci, storage::StorageModule* storage) {
     hci_ = hci;
+    storage_ = storage;
     Handler* handler = module_.GetHandler();
     hci_->RegisterEventHandler(
         EventCode::NUMBER_OF_COMPLETED_PACKETS, handler->BindOn(this, &Controller::impl::NumberOfCompletedPackets));
 
     set_event_mask(kDefaultEventMask);
     write_le_host_support(Enable::ENABLED, Enable::DISABLED);
-    hci_->EnqueueCommand(ReadLocalNameBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
-    hci_->EnqueueCommand(ReadLocalVersionInformationBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
-    hci_->EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
-
-    hci_->EnqueueCommand(
-        LeReadLocalSupportedFeaturesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
-
-    hci_->EnqueueCommand(
-        LeReadSupportedStatesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
 
-    // Wait for all extended features read
-    std::promise<void> features_promise;
-    auto features_future = features_promise.get_future();
-
-    hci_->EnqueueCommand(ReadLocalExtendedFeaturesBuilder::Create(0x00),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                             std::move(features_promise)));
-    features_future.wait();
+    // The HCI layer pipelines the reads, which are only waited for once per batch: first what identifies the
+    // controller, then what the remaining reads depend on, unless it is cached for this firmware, then the rest.
+    auto reads = begin_reads();
+    enqueue_read(ReadLocalNameBuilder::Create(), &Controller::impl::read_local_name_complete_handler);
+    enqueue_read(
+        ReadLocalVersionInformationBuilder::Create(),
+        &Controller::impl::read_local_version_information_complete_handler);
+    enqueue_read(ReadBufferSizeBuilder::Create(), &Controller::impl::read_buffer_size_complete_handler);
+    enqueue_read(ReadBdAddrBuilder::Create(), &Controller::impl::read_controller_mac_address_handler);
+    wait_for_reads(std::move(reads));
+
+    bool cached = load_cached_capabilities();
+    if (!cached) {
+      reads = begin_reads();
+      enqueue_read(
+          ReadLocalSupportedCommandsBuilder::Create(),
+          &Controller::impl::read_local_supported_commands_complete_handler);
+      enqueue_read(
+          LeReadLocalSupportedFeaturesBuilder::Create(), &Controller::impl::le_read_local_supported_features_handler);
+      enqueue_read(LeReadSupportedStatesBuilder::Create(), &Controller::impl::le_read_supported_states_handler);
+      // The handler reads the following pages
+      enqueue_read(
+          ReadLocalExtendedFeaturesBuilder::Create(0x00),
+          &Controller::impl::read_local_extended_features_complete_handler);
+      enqueue_read(
+          LeReadFilterAcceptListSizeBuilder::Create(), &Controller::impl::le_read_connect_list_size_handler);
+      wait_for_reads(std::move(reads));
+    }
+    apply_disabled_commands();
 
     le_set_event_mask(MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
 
-    hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
-
+    reads = begin_reads();
     if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
       hci_->EnqueueCommand(
           SetMinEncryptionKeySizeBuilder::Create(kMinEncryptionKeySize),
@@ -93,31 +125,80 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
+      enqueue_read(LeReadBufferSizeV2Builder::Create(), &Controller::impl::le_read_buffer_size_v2_handler);
+    } else {
+      enqueue_read(LeReadBufferSizeV1Builder::Create(), &Controller::impl::le_read_buffer_size_handler);
+    }
+
+    if (!cached) {
+      read_le_capabilities();
+    }
+
+    // SSP is managed by security layer once enabled
+    write_simple_pairing_mode(Enable::ENABLED);
+    if (module_.SupportsSecureConnections()) {
       hci_->EnqueueCommand(
-          LeReadBufferSizeV2Builder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_v2_handler));
+          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
+          handler->BindOnceOn(
+              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
+    }
+    if (is_supported(OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
+      enqueue_read(
+          LeReadSuggestedDefaultDataLengthBuilder::Create(),
+          &Controller::impl::le_read_suggested_default_data_length_handler);
     } else {
+      LOG_INFO("LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH not supported, defaulting to 27 (0x1B)");
+      le_suggested_default_data_length_ = 27;
+    }
+
+    if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
       hci_->EnqueueCommand(
-          LeReadBufferSizeV1Builder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_handler));
+          LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
+          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
     }
 
-    hci_->EnqueueCommand(
-        LeReadFilterAcceptListSizeBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_connect_list_size_handler));
+    if (common::init_flags::subrating_is_enabled() && is_supported(OpCode::LE_SET_HOST_FEATURE) &&
+        module_.SupportsBleConnectionSubrating()) {
+      hci_->EnqueueCommand(
+          LeSetHostFeatureBuilder::Create(
+              LeHostFeatureBits::CONNECTION_SUBRATING_HOST_SUPPORT, Enable::ENABLED),
+          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+    }
+
+    if (os::GetSystemPropertyBool(
+            kPropertyErroneousDataReportingEnabled, kDefaultErroneousDataReportingEnabled)) {
+        if (is_supported(OpCode::READ_DEFAULT_ERRONEOUS_DATA_REPORTING)) {
+          enqueue_read(
+              ReadDefaultErroneousDataReportingBuilder::Create(),
+              &Controller::impl::read_default_erroneous_data_reporting_handler);
+        }
+    }
+
+    // Skip vendor capabilities check if configured.
+    if (os::GetSystemPropertyBool(
+            kPropertyVendorCapabilitiesEnabled, kDefaultVendorCapabilitiesEnabled)) {
+      enqueue_read(LeGetVendorCapabilitiesBuilder::Create(), &Controller::impl::le_get_vendor_capabilities_handler);
+    } else {
+      vendor_capabilities_.is_supported_ = 0x00;
+    }
+    wait_for_reads(std::move(reads));
+
+    if (!cached) {
+      save_cached_capabilities();
+    }
+  }
 
+  // The LE reads that depend on the supported commands and features, but not on anything the host sets
+  void read_le_capabilities() {
     if (is_supported(OpCode::LE_READ_RESOLVING_LIST_SIZE) && module_.SupportsBlePrivacy()) {
-      hci_->EnqueueCommand(
-          LeReadResolvingListSizeBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_resolving_list_size_handler));
+      enqueue_read(LeReadResolvingListSizeBuilder::Create(), &Controller::impl::le_read_resolving_list_size_handler);
     } else {
       LOG_INFO("LE_READ_RESOLVING_LIST_SIZE not supported, defaulting to 0");
       le_resolving_list_size_ = 0;
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(LeReadMaximumDataLengthBuilder::Create(),
-                           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
+      enqueue_read(LeReadMaximumDataLengthBuilder::Create(), &Controller::impl::le_read_maximum_data_length_handler);
     } else {
       LOG_INFO("LE_READ_MAXIMUM_DATA_LENGTH not supported, defaulting to 0");
       le_maximum_data_length_.supported_max_rx_octets_ = 0;
@@ -126,27 +207,10 @@ struct Controller::impl {
       le_maximum_data_length_.supported_max_tx_time_ = 0;
     }
 
-    // SSP is managed by security layer once enabled
-    write_simple_pairing_mode(Enable::ENABLED);
-    if (module_.SupportsSecureConnections()) {
-      hci_->EnqueueCommand(
-          WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
-          handler->BindOnceOn(
-              this, &Controller::impl::write_secure_connections_host_support_complete_handler));
-    }
-    if (is_supported(OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(
-          LeReadSuggestedDefaultDataLengthBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_suggested_default_data_length_handler));
-    } else {
-      LOG_INFO("LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH not supported, defaulting to 27 (0x1B)");
-      le_suggested_default_data_length_ = 27;
-    }
-
     if (is_supported(OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH) && module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_read(
           LeReadMaximumAdvertisingDataLengthBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_maximum_advertising_data_length_handler));
+          &Controller::impl::le_read_maximum_advertising_data_length_handler);
     } else {
       LOG_INFO("LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH not supported, defaulting to 31 (0x1F)");
       le_maximum_advertising_data_length_ = 31;
@@ -154,9 +218,9 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS) &&
         module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_read(
           LeReadNumberOfSupportedAdvertisingSetsBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_number_of_supported_advertising_sets_handler));
+          &Controller::impl::le_read_number_of_supported_advertising_sets_handler);
     } else {
       LOG_INFO("LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS not supported, defaulting to 1");
       le_number_supported_advertising_sets_ = 1;
@@ -164,54 +228,146 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE) &&
         module_.SupportsBlePeriodicAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_read(
           LeReadPeriodicAdvertiserListSizeBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_periodic_advertiser_list_size_handler));
+          &Controller::impl::le_read_periodic_advertiser_list_size_handler);
     } else {
       LOG_INFO("LE_READ_PERIODIC_ADVERTISER_LIST_SIZE not supported, defaulting to 0");
       le_periodic_advertiser_list_size_ = 0;
     }
-    if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
-      hci_->EnqueueCommand(
-          LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
-          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+  }
+
+  // Start a batch of reads, the returned future is ready once they all completed after wait_for_reads()
+  std::future<void> begin_reads() {
+    reads_done_ = std::promise<void>();
+    // Held until wait_for_reads(), so that the batch isn't done before all its reads are enqueued
+    pending_reads_ = 1;
+    return reads_done_.get_future();
+  }
+
+  void wait_for_reads(std::future<void> reads) {
+    on_read_done();
+    reads.wait();
+  }
+
+  void enqueue_read(std::unique_ptr<CommandBuilder> command, void (impl::*handler)(CommandCompleteView)) {
+    pending_reads_++;
+    hci_->EnqueueCommand(
+        std::move(command), module_.GetHandler()->BindOnceOn(this, &Controller::impl::on_read_complete, handler));
+  }
+
+  void on_read_complete(void (impl::*handler)(CommandCompleteView), CommandCompleteView view) {
+    (this->*handler)(std::move(view));
+    on_read_done();
+  }
+
+  void on_read_done() {
+    if (pending_reads_.fetch_sub(1) == 1) {
+      reads_done_.set_value();
     }
+  }
 
-    if (common::init_flags::subrating_is_enabled() && is_supported(OpCode::LE_SET_HOST_FEATURE) &&
-        module_.SupportsBleConnectionSubrating()) {
-      hci_->EnqueueCommand(
-          LeSetHostFeatureBuilder::Create(
-              LeHostFeatureBits::CONNECTION_SUBRATING_HOST_SUPPORT, Enable::ENABLED),
-          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+  std::string firmware_version() const {
+    std::stringstream version;
+    version << std::hex << static_cast<int>(local_version_information_.hci_version_) << "."
+            << local_version_information_.hci_revision_ << "."
+            << static_cast<int>(local_version_information_.lmp_version_) << "."
+            << local_version_information_.manufacturer_name_ << "." << local_version_information_.lmp_subversion_;
+    return version.str();
+  }
+
+  // Restore what the controller reported when it last came up with the same firmware
+  bool load_cached_capabilities() {
+    auto version = storage_->GetProperty(kControllerSection, kFirmwareVersionProperty);
+    if (!version.has_value() || *version != firmware_version()) {
+      return false;
+    }
+    auto supported_commands = storage_->GetBin(kControllerSection, kSupportedCommandsProperty);
+    auto lmp_features = storage_->GetBin(kControllerSection, kLmpFeaturesProperty);
+    auto le_features = storage_->GetUint64(kControllerSection, kLeFeaturesProperty);
+    auto le_states = storage_->GetUint64(kControllerSection, kLeStatesProperty);
+    std::vector<std::optional<int>> values;
+    for (const auto& property : kCachedValueProperties) {
+      values.push_back(storage_->GetInt(kControllerSection, property));
+    }
+    if (!supported_commands.has_value() || supported_commands->size() != controller_supported_commands_.size() ||
+        !lmp_features.has_value() || lmp_features->empty() || lmp_features->size() % sizeof(uint64_t) != 0 ||
+        !le_features.has_value() || !le_states.has_value() ||
+        std::find(values.begin(), values.end(), std::nullopt) != values.end()) {
+      LOG_WARN("Discarding incomplete cached capabilities of controller firmware %s", version->c_str());
+      return false;
     }
 
-    if (os::GetSystemPropertyBool(
-            kPropertyErroneousDataReportingEnabled, kDefaultErroneousDataReportingEnabled)) {
-        if (is_supported(OpCode::READ_DEFAULT_ERRONEOUS_DATA_REPORTING)) {
-          hci_->EnqueueCommand(
-              ReadDefaultErroneousDataReportingBuilder::Create(),
-              handler->BindOnceOn(
-                  this, &Controller::impl::read_default_erroneous_data_reporting_handler));
-        }
+    std::copy(supported_commands->begin(), supported_commands->end(), controller_supported_commands_.begin());
+    extended_lmp_features_array_.clear();
+    for (size_t i = 0; i < lmp_features->size(); i += sizeof(uint64_t)) {
+      uint64_t page = 0;
+      for (size_t j = 0; j < sizeof(uint64_t); j++) {
+        page |= static_cast<uint64_t>((*lmp_features)[i + j]) << (8 * j);
+      }
+      extended_lmp_features_array_.push_back(page);
     }
+    le_local_supported_features_ = *le_features;
+    le_supported_states_ = *le_states;
+    auto value = values.begin();
+    le_connect_list_size_ = **value++;
+    le_resolving_list_size_ = **value++;
+    le_maximum_data_length_.supported_max_tx_octets_ = **value++;
+    le_maximum_data_length_.supported_max_tx_time_ = **value++;
+    le_maximum_data_length_.supported_max_rx_octets_ = **value++;
+    le_maximum_data_length_.supported_max_rx_time_ = **value++;
+    le_maximum_advertising_data_length_ = **value++;
+    le_number_supported_advertising_sets_ = **value++;
+    le_periodic_advertiser_list_size_ = **value++;
+    LOG_INFO("Using cached capabilities of controller firmware %s", version->c_str());
+    return true;
+  }
 
-    // Skip vendor capabilities check if configured.
-    if (os::GetSystemPropertyBool(
-            kPropertyVendorCapabilitiesEnabled, kDefaultVendorCapabilitiesEnabled)) {
-      hci_->EnqueueCommand(
-          LeGetVendorCapabilitiesBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_get_vendor_capabilities_handler));
-    } else {
-      vendor_capabilities_.is_supported_ = 0x00;
+  void save_cached_capabilities() {
+    // Drop the previous firmware's values first, the version is only set once all the values are
+    storage_->RemoveSection(kControllerSection);
+    storage_->SetBin(
+        kControllerSection,
+        kSupportedCommandsProperty,
+        std::vector<uint8_t>(controller_supported_commands_.begin(), controller_supported_commands_.end()));
+    std::vector<uint8_t> lmp_features;
+    for (uint64_t page : extended_lmp_features_array_) {
+      for (size_t j = 0; j < sizeof(uint64_t); j++) {
+        lmp_features.push_back(static_cast<uint8_t>(page >> (8 * j)));
+      }
+    }
+    storage_->SetBin(kControllerSection, kLmpFeaturesProperty, lmp_features);
+    storage_->SetUint64(kControllerSection, kLeFeaturesProperty, le_local_supported_features_);
+    storage_->SetUint64(kControllerSection, kLeStatesProperty, le_supported_states_);
+    const int values[] = {
+        le_connect_list_size_,
+        le_resolving_list_size_,
+        le_maximum_data_length_.supported_max_tx_octets_,
+        le_maximum_data_length_.supported_max_tx_time_,
+        le_maximum_data_length_.supported_max_rx_octets_,
+        le_maximum_data_length_.supported_max_rx_time_,
+        le_maximum_advertising_data_length_,
+        le_number_supported_advertising_sets_,
+        le_periodic_advertiser_list_size_,
+    };
+    static_assert(std::size(values) == std::size(kCachedValueProperties));
+    for (size_t i = 0; i < std::size(values); i++) {
+      storage_->SetInt(kControllerSection, kCachedValueProperties[i], values[i]);
     }
+    storage_->SetProperty(kControllerSection, kFirmwareVersionProperty, firmware_version());
+  }
 
-    // We only need to synchronize the last read. Make BD_ADDR to be the last one.
-    std::promise<void> promise;
-    auto future = promise.get_future();
-    hci_->EnqueueCommand(
-        ReadBdAddrBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
-    future.wait();
+  // Commands disabled through the system property are removed from what the controller supports
+  void apply_disabled_commands() {
+    local_supported_commands_ = controller_supported_commands_;
+    if (auto disabledCommands = os::GetSystemProperty(kPropertyDisabledCommands)) {
+      for (const auto& command : android::base::Split(*disabledCommands, ",")) {
+        uint16_t index = std::stoi(command);
+        uint16_t byte_index = index / 10;
+        uint16_t bit_index = index % 10;
+        local_supported_commands_[byte_index] &= ~(1 << bit_index);
+      }
+    }
   }
 
   void Stop() {
@@ -228,14 +384,15 @@ struct Controller::impl {
     }
     auto complete_view = NumberOfCompletedPacketsView::Create(event);
     ASSERT(complete_view.IsValid());
-    for (auto completed_packets : complete_view.GetCompletedPackets()) {
+    // Walk the handles in place, this event follows every batch of ACL packets sent
+    complete_view.ForEachCompletedPackets([this](const CompletedPackets& completed_packets) {
       uint16_t handle = completed_packets.connection_handle_;
       uint16_t credits = completed_packets.host_num_of_completed_packets_;
       acl_credits_callback_.Invoke(handle, credits);
       if (!acl_monitor_credits_callback_.IsEmpty()) {
         acl_monitor_credits_callback_.Invoke(handle, credits);
       }
-    }
+    });
   }
 
   void register_completed_acl_packets_callback(CompletedAclPacketsCallback callback) {
@@ -307,19 +464,10 @@ struct Controller::impl {
     ASSERT(complete_view.IsValid());
     ErrorCode status = complete_view.GetStatus();
     ASSERT_LOG(status == ErrorCode::SUCCESS, "Status 0x%02hhx, %s", status, ErrorCodeText(status).c_str());
-    local_supported_commands_ = complete_view.GetSupportedCommands();
-
-    if (auto disabledCommands = os::GetSystemProperty(kPropertyDisabledCommands)) {
-      for (const auto& command : android::base::Split(*disabledCommands, ",")) {
-        uint16_t index = std::stoi(command);
-        uint16_t byte_index = index / 10;
-        uint16_t bit_index = index % 10;
-        local_supported_commands_[byte_index] &= ~(1 << bit_index);
-      }
-    }
+    controller_supported_commands_ = complete_view.GetSupportedCommands();
   }
 
-  void read_local_extended_features_complete_handler(std::promise<void> promise, CommandCompleteView view) {
+  void read_local_extended_features_complete_handler(CommandCompleteView view) {
     auto complete_view = ReadLocalExtendedFeaturesCompleteView::Create(view);
     ASSERT(complete_view.IsValid());
     ErrorCode status = complete_view.GetStatus();
@@ -330,12 +478,9 @@ struct Controller::impl {
     // Query all extended features
     if (page_number < complete_view.GetMaximumPageNumber()) {
       page_number++;
-      hci_->EnqueueCommand(
+      enqueue_read(
           ReadLocalExtendedFeaturesBuilder::Create(page_number),
-          module_.GetHandler()->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                           std::move(promise)));
-    } else {
-      promise.set_value();
+          &Controller::impl::read_local_extended_features_complete_handler);
     }
   }
 
@@ -351,13 +496,12 @@ struct Controller::impl {
     sco_buffers_ = complete_view.GetTotalNumSynchronousDataPackets();
   }
 
-  void read_controller_mac_address_handler(std::promise<void> promise, CommandCompleteView view) {
+  void read_controller_mac_address_handler(CommandCompleteView view) {
     auto complete_view = ReadBdAddrCompleteView::Create(view);
     ASSERT(complete_view.IsValid());
     ErrorCode status = complete_view.GetStatus();
     ASSERT_LOG(status == ErrorCode::SUCCESS, "Status 0x%02hhx, %s", status, ErrorCodeText(status).c_str());
     mac_address_ = complete_view.GetBdAddr();
-    promise.set_value();
   }
 
   void le_read_buffer_size_handler(CommandCompleteView view) {
@@ -1067,10 +1211,17 @@ struct Controller::impl {
   Controller& module_;
 
   HciLayer* hci_;
+  storage::StorageModule* storage_;
+
+  // Reads of the current Start() batch that haven't completed yet
+  std::atomic<int> pending_reads_{0};
+  std::promise<void> reads_done_;
 
   CompletedAclPacketsCallback acl_credits_callback_{};
   CompletedAclPacketsCallback acl_monitor_credits_callback_{};
   LocalVersionInformation local_version_information_{};
+  // As reported by the controller, local_supported_commands_ has the disabled commands removed
+  std::array<uint8_t, 64> controller_supported_commands_{};
   std::array<uint8_t, 64> local_supported_commands_{};
   std::vector<uint64_t> extended_lmp_features_array_{};
   uint16_t acl_buffer_length_{};
@@ -1369,11 +1520,12 @@ const ModuleFactory Controller::Factory = ModuleFactory([]() { return new Contro
 
 void Controller::ListDependencies(ModuleList* list) const {
   list->add<hci::HciLayer>();
+  list->add<storage::StorageModule>();
   list->add<sysprops::SyspropsModule>();
 }
 
 void Controller::Start() {
-  impl_->Start(GetDependency<hci::HciLayer>());
+  impl_->Start(GetDependency<hci::HciLayer>(), GetDependency<storage::StorageModule>());
 }
 
 void Controller::Stop() {
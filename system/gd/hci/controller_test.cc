@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <future>
 #include <map>
 #include <memory>
@@ -29,6 +30,7 @@
 #include "common/init_flags.h"
 #include "hci/address.h"
 #include "hci/hci_layer.h"
+#include "os/parameter_provider.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -88,6 +90,11 @@ class TestHciLayer : public HciLayer {
     CommandView command = CommandView::Create(packet_view);
     ASSERT_TRUE(command.IsValid());
 
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      handled_commands_[command.GetOpCode()]++;
+    }
+
     uint8_t num_packets = 1;
     std::unique_ptr<packet::BasePacketBuilder> event_builder;
     switch (command.GetOpCode()) {
@@ -101,7 +108,7 @@ class TestHciLayer : public HciLayer {
         local_version_information.hci_revision_ = 0x1234;
         local_version_information.lmp_version_ = LmpVersion::V_4_2;
         local_version_information.manufacturer_name_ = 0xBAD;
-        local_version_information.lmp_subversion_ = 0x5678;
+        local_version_information.lmp_subversion_ = lmp_subversion;
         event_builder = ReadLocalVersionInformationCompleteBuilder::Create(
             num_packets, ErrorCode::SUCCESS, local_version_information);
       } break;
@@ -268,6 +275,11 @@ class TestHciLayer : public HciLayer {
     return command;
   }
 
+  int GetHandledCount(OpCode op_code) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return handled_commands_[op_code];
+  }
+
   void ListDependencies(ModuleList* list) const {}
   void Start() override {}
   void Stop() override {}
@@ -278,8 +290,10 @@ class TestHciLayer : public HciLayer {
   constexpr static uint16_t total_num_synchronous_data_packets = 12;
   uint64_t event_mask = 0;
   uint64_t le_event_mask = 0;
+  uint16_t lmp_subversion = 0x5678;
 
  private:
+  std::map<OpCode, int> handled_commands_;
   common::ContextualCallback<void(EventView)> number_of_completed_packets_callback_;
   std::queue<CommandView> command_queue_;
   mutable std::mutex mutex_;
@@ -291,15 +305,34 @@ class ControllerTest : public ::testing::Test {
   void SetUp() override {
     feature_spec_version = feature_spec_version_;
     bluetooth::common::InitFlags::SetAllForTesting();
+    temp_config_ = std::filesystem::temp_directory_path() / "controller_test_config.txt";
+    DeleteConfigFiles();
+    os::ParameterProvider::OverrideConfigFilePath(temp_config_.string());
+    StartController();
+  }
+
+  void TearDown() override {
+    fake_registry_.StopAll();
+    DeleteConfigFiles();
+  }
+
+  void StartController(uint16_t lmp_subversion = 0x5678) {
     test_hci_layer_ = new TestHciLayer;
+    test_hci_layer_->lmp_subversion = lmp_subversion;
     fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
     client_handler_ = fake_registry_.GetTestModuleHandler(&HciLayer::Factory);
     fake_registry_.Start<Controller>(&thread_);
     controller_ = static_cast<Controller*>(fake_registry_.GetModuleUnderTest(&Controller::Factory));
   }
 
-  void TearDown() override {
+  void RestartController(uint16_t lmp_subversion = 0x5678) {
     fake_registry_.StopAll();
+    StartController(lmp_subversion);
+  }
+
+  void DeleteConfigFiles() {
+    std::filesystem::remove(temp_config_);
+    std::filesystem::remove(std::filesystem::path(temp_config_).replace_extension(".bak"));
   }
 
   TestModuleRegistry fake_registry_;
@@ -308,6 +341,7 @@ class ControllerTest : public ::testing::Test {
   Controller* controller_ = nullptr;
   os::Handler* client_handler_ = nullptr;
   uint16_t feature_spec_version_ = 98;
+  std::filesystem::path temp_config_;
 };
 }  // namespace
 
@@ -360,6 +394,37 @@ TEST_F(ControllerTest, read_controller_info) {
   ASSERT_EQ(controller_->GetLeNumberOfSupportedAdverisingSets(), 0xF0);
 }
 
+TEST_F(ControllerTest, capabilities_cached_for_same_firmware) {
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS), 1);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_EXTENDED_FEATURES), 3);
+  auto local_features = controller_->GetLocalFeatures(0x02);
+  auto le_features = controller_->GetLocalLeFeatures();
+  auto le_maximum_data_length = controller_->GetLeMaximumDataLength();
+  auto le_number_of_advertising_sets = controller_->GetLeNumberOfSupportedAdverisingSets();
+
+  RestartController();
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_VERSION_INFORMATION), 1);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_BD_ADDR), 1);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS), 0);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_EXTENDED_FEATURES), 0);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::LE_READ_MAXIMUM_DATA_LENGTH), 0);
+  ASSERT_EQ(controller_->GetLocalFeatures(0x02), local_features);
+  ASSERT_EQ(controller_->GetLocalLeFeatures(), le_features);
+  ASSERT_EQ(
+      controller_->GetLeMaximumDataLength().supported_max_tx_octets_, le_maximum_data_length.supported_max_tx_octets_);
+  ASSERT_EQ(
+      controller_->GetLeMaximumDataLength().supported_max_rx_time_, le_maximum_data_length.supported_max_rx_time_);
+  ASSERT_EQ(controller_->GetLeNumberOfSupportedAdverisingSets(), le_number_of_advertising_sets);
+  ASSERT_TRUE(controller_->IsSupported(OpCode::LE_READ_BUFFER_SIZE_V1));
+}
+
+TEST_F(ControllerTest, capabilities_read_again_for_other_firmware) {
+  RestartController(0x5679);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS), 1);
+  ASSERT_EQ(test_hci_layer_->GetHandledCount(OpCode::READ_LOCAL_EXTENDED_FEATURES), 3);
+  ASSERT_EQ(controller_->GetLocalVersionInformation().lmp_subversion_, 0x5679);
+}
+
 TEST_F(ControllerTest, read_write_local_name) {
   ASSERT_EQ(controller_->GetLocalName(), "DUT");
   controller_->WriteLocalName("New name");
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/distance_measurement_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace bluetooth::hci {
+
+namespace {
+// The median of |values|, which are reordered
+double Median(std::vector<double>& values) {
+  size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  double median = values[middle];
+  if (values.size() % 2 == 0) {
+    median = (median + *std::max_element(values.begin(), values.begin() + middle)) / 2;
+  }
+  return median;
+}
+}  // namespace
+
+DistanceMeasurementFilterType DistanceMeasurementFilterTypeFromString(const std::string& name) {
+  if (name == "none") {
+    return DistanceMeasurementFilterType::NONE;
+  }
+  if (name == "kalman") {
+    return DistanceMeasurementFilterType::KALMAN;
+  }
+  return DistanceMeasurementFilterType::MEDIAN;
+}
+
+DistanceMeasurementFilter::DistanceMeasurementFilter(DistanceMeasurementFilterParameters parameters)
+    : parameters_(parameters), samples_(std::max<size_t>(parameters.window, 1)) {}
+
+void DistanceMeasurementFilter::AddSample(double centimeter) {
+  if (count_ == 0) {
+    kalman_estimate_ = centimeter;
+    kalman_variance_ = parameters_.measurement_noise;
+  } else {
+    double variance = kalman_variance_ + parameters_.process_noise;
+    double gain = variance / (variance + parameters_.measurement_noise);
+    kalman_estimate_ += gain * (centimeter - kalman_estimate_);
+    kalman_variance_ = (1 - gain) * variance;
+  }
+  samples_[next_] = centimeter;
+  next_ = (next_ + 1) % samples_.size();
+  count_ = std::min(count_ + 1, samples_.size());
+}
+
+DistanceMeasurementEstimate DistanceMeasurementFilter::GetEstimate() const {
+  switch (parameters_.type) {
+    case DistanceMeasurementFilterType::NONE: {
+      // A single sample carries no error estimate, the distance bounds it
+      double last = samples_[(next_ + samples_.size() - 1) % samples_.size()];
+      return {static_cast<uint32_t>(last), static_cast<uint32_t>(last)};
+    }
+    case DistanceMeasurementFilterType::MEDIAN: {
+      std::vector<double> values(samples_.begin(), samples_.begin() + count_);
+      double median = Median(values);
+      // The median absolute deviation, scaled to the standard deviation of normal samples
+      for (auto& value : values) {
+        value = std::abs(value - median);
+      }
+      double deviation = 1.4826 * Median(values);
+      return {static_cast<uint32_t>(median), static_cast<uint32_t>(deviation)};
+    }
+    case DistanceMeasurementFilterType::KALMAN:
+      return {
+          static_cast<uint32_t>(std::max(kalman_estimate_, 0.0)), static_cast<uint32_t>(std::sqrt(kalman_variance_))};
+  }
+  return {0, 0};
+}
+
+void DistanceMeasurementFilter::Reset() {
+  next_ = 0;
+  count_ = 0;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bluetooth::hci {
+
+enum class DistanceMeasurementFilterType {
+  /// The last sample, as measured.
+  NONE,
+  /// The median of the samples of the window, robust to the RSSI spikes.
+  MEDIAN,
+  /// A one dimension Kalman filter of the samples, smoother for moving devices.
+  KALMAN,
+};
+
+/// Returns the filter type named |name|, MEDIAN when the name is unknown.
+DistanceMeasurementFilterType DistanceMeasurementFilterTypeFromString(const std::string& name);
+
+struct DistanceMeasurementFilterParameters {
+  DistanceMeasurementFilterType type{DistanceMeasurementFilterType::MEDIAN};
+  /// Number of samples kept by the ring buffer of the device.
+  size_t window{8};
+  /// Variance added to the Kalman estimate for each sample, in square centimeters.
+  double process_noise{400.0};
+  /// Variance of a sample for the Kalman filter, in square centimeters.
+  double measurement_noise{22500.0};
+};
+
+struct DistanceMeasurementEstimate {
+  uint32_t centimeter;
+  uint32_t error_centimeter;
+};
+
+/// The distance measurement filter keeps the last samples of a device in a
+/// ring buffer and estimates the distance from them, so that one filtered
+/// result is reported for several samples.
+class DistanceMeasurementFilter {
+ public:
+  explicit DistanceMeasurementFilter(DistanceMeasurementFilterParameters parameters);
+
+  void AddSample(double centimeter);
+
+  /// Returns true once a sample was added since the last Reset.
+  bool HasEstimate() const {
+    return count_ > 0;
+  }
+
+  /// Returns the filtered distance and its error, only valid if HasEstimate().
+  DistanceMeasurementEstimate GetEstimate() const;
+
+  /// Forget the samples of the device.
+  void Reset();
+
+ private:
+  DistanceMeasurementFilterParameters parameters_;
+  std::vector<double> samples_;
+  size_t next_ = 0;
+  size_t count_ = 0;
+  double kalman_estimate_ = 0;
+  double kalman_variance_ = 0;
+};
+
+}  // namespace bluetooth::hci
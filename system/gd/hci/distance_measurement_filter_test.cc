@@ -0,0 +1,84 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/distance_measurement_filter.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+TEST(DistanceMeasurementFilterTest, filter_type_from_string) {
+  ASSERT_EQ(DistanceMeasurementFilterType::NONE, DistanceMeasurementFilterTypeFromString("none"));
+  ASSERT_EQ(DistanceMeasurementFilterType::MEDIAN, DistanceMeasurementFilterTypeFromString("median"));
+  ASSERT_EQ(DistanceMeasurementFilterType::KALMAN, DistanceMeasurementFilterTypeFromString("kalman"));
+  ASSERT_EQ(DistanceMeasurementFilterType::MEDIAN, DistanceMeasurementFilterTypeFromString(""));
+}
+
+TEST(DistanceMeasurementFilterTest, no_filter_reports_the_last_sample) {
+  DistanceMeasurementFilter filter({.type = DistanceMeasurementFilterType::NONE});
+  ASSERT_FALSE(filter.HasEstimate());
+  filter.AddSample(100);
+  filter.AddSample(250);
+  ASSERT_TRUE(filter.HasEstimate());
+  ASSERT_EQ(250u, filter.GetEstimate().centimeter);
+}
+
+TEST(DistanceMeasurementFilterTest, median_drops_the_spikes) {
+  DistanceMeasurementFilter filter({.type = DistanceMeasurementFilterType::MEDIAN, .window = 5});
+  for (double sample : {100.0, 102.0, 900.0, 98.0, 101.0}) {
+    filter.AddSample(sample);
+  }
+  auto estimate = filter.GetEstimate();
+  ASSERT_EQ(101u, estimate.centimeter);
+  ASSERT_LT(estimate.error_centimeter, 10u);
+
+  // The oldest samples leave the ring buffer
+  for (double sample : {300.0, 300.0, 300.0}) {
+    filter.AddSample(sample);
+  }
+  ASSERT_EQ(300u, filter.GetEstimate().centimeter);
+}
+
+TEST(DistanceMeasurementFilterTest, median_of_an_even_number_of_samples) {
+  DistanceMeasurementFilter filter({.type = DistanceMeasurementFilterType::MEDIAN, .window = 4});
+  for (double sample : {100.0, 400.0, 200.0, 300.0}) {
+    filter.AddSample(sample);
+  }
+  ASSERT_EQ(250u, filter.GetEstimate().centimeter);
+}
+
+TEST(DistanceMeasurementFilterTest, kalman_converges) {
+  DistanceMeasurementFilter filter({.type = DistanceMeasurementFilterType::KALMAN});
+  filter.AddSample(500);
+  uint32_t initial_error = filter.GetEstimate().error_centimeter;
+  for (int i = 0; i < 50; i++) {
+    filter.AddSample(i % 2 ? 180 : 220);
+  }
+  auto estimate = filter.GetEstimate();
+  ASSERT_NEAR(200, estimate.centimeter, 20);
+  ASSERT_LT(estimate.error_centimeter, initial_error);
+}
+
+TEST(DistanceMeasurementFilterTest, reset) {
+  DistanceMeasurementFilter filter({});
+  filter.AddSample(100);
+  filter.Reset();
+  ASSERT_FALSE(filter.HasEstimate());
+  filter.AddSample(300);
+  ASSERT_EQ(300u, filter.GetEstimate().centimeter);
+}
+
+}  // namespace bluetooth::hci
@@ -17,13 +17,16 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 #include "hci/acl_manager.h"
+#include "hci/distance_measurement_filter.h"
 #include "hci/hci_layer.h"
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace hci {
@@ -33,6 +36,12 @@ const ModuleFactory DistanceMeasurementManager::Factory =
 static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
 static constexpr uint8_t kTxPowerNotAvailable = 0xfe;
 static constexpr int8_t kRSSIDropOffAt1M = 41;
+// The RSSI is sampled kSamplesPerReport times per report, and never more often than every
+// kMinRssiSampleIntervalMs
+static constexpr uint16_t kSamplesPerReport = 4;
+static constexpr uint16_t kMinRssiSampleIntervalMs = 50;
+static constexpr char kDistanceMeasurementFilterProperty[] =
+    "bluetooth.core.le.distance_measurement_filter";
 
 struct DistanceMeasurementManager::impl {
   ~impl() {}
@@ -40,6 +49,8 @@ struct DistanceMeasurementManager::impl {
     handler_ = handler;
     hci_layer_ = hci_layer;
     acl_manager_ = acl_manager;
+    filter_parameters_.type = DistanceMeasurementFilterTypeFromString(
+        os::GetSystemProperty(kDistanceMeasurementFilterProperty).value_or(""));
     hci_layer_->RegisterLeEventHandler(
         hci::SubeventCode::TRANSMIT_POWER_REPORTING,
         handler_->BindOn(this, &impl::on_transmit_power_reporting));
@@ -75,6 +86,9 @@ struct DistanceMeasurementManager::impl {
           rssi_trackers[address].remote_tx_power = kTxPowerNotAvailable;
           rssi_trackers[address].started = false;
           rssi_trackers[address].alarm = std::make_unique<os::Alarm>(handler_);
+          rssi_trackers[address].filter =
+              std::make_unique<DistanceMeasurementFilter>(filter_parameters_);
+          rssi_trackers[address].pending_samples = 0;
           hci_layer_->EnqueueCommand(
               LeReadRemoteTransmitPowerLevelBuilder::Create(
                   acl_manager_->HACK_GetLeHandle(address), 0x01),
@@ -132,7 +146,11 @@ struct DistanceMeasurementManager::impl {
 
     rssi_trackers[address].alarm->Schedule(
         common::BindOnce(&impl::read_rssi_regularly, common::Unretained(this), address, frequency),
-        std::chrono::milliseconds(rssi_trackers[address].frequency));
+        std::chrono::milliseconds(get_rssi_sample_interval(rssi_trackers[address].frequency)));
+  }
+
+  static uint16_t get_rssi_sample_interval(uint16_t frequency) {
+    return std::max<uint16_t>(frequency / kSamplesPerReport, kMinRssiSampleIntervalMs);
   }
 
   void on_read_remote_transmit_power_level_status(Address address, CommandStatusView view) {
@@ -247,10 +265,21 @@ struct DistanceMeasurementManager::impl {
     int8_t rssi = complete_view.GetRssi();
     double pow_value = (remote_tx_power - rssi - kRSSIDropOffAt1M) / 20.0;
     double distance = pow(10.0, pow_value);
+
+    // The samples are filtered here, and a single result reported once per requested interval
+    auto& tracker = rssi_trackers[address];
+    tracker.filter->AddSample(distance * 100);
+    uint16_t samples_per_report =
+        std::max(tracker.frequency / get_rssi_sample_interval(tracker.frequency), 1);
+    if (++tracker.pending_samples < samples_per_report) {
+      return;
+    }
+    tracker.pending_samples = 0;
+    auto estimate = tracker.filter->GetEstimate();
     distance_measurement_callbacks_->OnDistanceMeasurementResult(
         address,
-        distance * 100,
-        distance * 100,
+        estimate.centimeter,
+        estimate.error_centimeter,
         -1,
         -1,
         -1,
@@ -277,12 +306,15 @@ struct DistanceMeasurementManager::impl {
     uint8_t remote_tx_power;
     bool started;
     std::unique_ptr<os::Alarm> alarm;
+    std::unique_ptr<DistanceMeasurementFilter> filter;
+    uint16_t pending_samples;
   };
 
   os::Handler* handler_;
   hci::HciLayer* hci_layer_;
   hci::AclManager* acl_manager_;
   std::unordered_map<Address, RSSITracker> rssi_trackers;
+  DistanceMeasurementFilterParameters filter_parameters_;
   DistanceMeasurementCallbacks* distance_measurement_callbacks_;
 };
 
@@ -16,13 +16,21 @@
 
 #include "hci/hci_layer.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <vector>
+
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "common/stop_watch.h"
 #include "hci/hci_metrics_logging.h"
+#include "hci_layer_generated.h"
 #include "os/alarm.h"
 #include "os/metrics.h"
 #include "os/queue.h"
+#include "os/trace.h"
 #include "packet/packet_builder.h"
 #include "storage/storage_module.h"
 
@@ -76,6 +84,9 @@ class CommandQueueEntry {
 
   unique_ptr<CommandBuilder> command;
   unique_ptr<CommandView> command_view;
+  // Set once the command is serialized, before it is sent
+  std::shared_ptr<std::vector<uint8_t>> bytes;
+  OpCode op_code{OpCode::NONE};
 
   bool waiting_for_status_;
   ContextualOnceCallback<void(CommandStatusView)> on_status;
@@ -97,6 +108,29 @@ class CommandQueueEntry {
   }
 };
 
+// Event and subevent codes are one octet
+static constexpr size_t kNumEventCodes = 256;
+
+// How many events of a code were received and how long it took to dispatch them
+struct EventStats {
+  // Bucket i counts the dispatches that took [2^i, 2^(i+1)) microseconds, the last bucket the longer ones
+  static constexpr size_t kHistogramBuckets = 16;
+
+  void Record(std::chrono::steady_clock::duration dispatch_time) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(dispatch_time).count();
+    size_t bucket = 0;
+    while (us > 1 && bucket + 1 < kHistogramBuckets) {
+      us >>= 1;
+      bucket++;
+    }
+    count++;
+    histogram[bucket]++;
+  }
+
+  uint64_t count{0};
+  std::array<uint32_t, kHistogramBuckets> histogram{};
+};
+
 struct HciLayer::impl {
   impl(hal::HciHal* hal, HciLayer& module) : hal_(hal), module_(module) {
     hci_timeout_alarm_ = new Alarm(module.GetHandler());
@@ -113,6 +147,7 @@ struct HciLayer::impl {
       delete hci_abort_alarm_;
     }
     command_queue_.clear();
+    in_flight_commands_.clear();
   }
 
   void drop(EventView event) {
@@ -121,10 +156,8 @@ struct HciLayer::impl {
 
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    BT_TRACE_INSTANT(ACL_TX, "ACL TX", packet->size());
+    hal_->sendAclPacket(std::move(packet));
   }
 
   void on_outbound_sco_ready() {
@@ -181,26 +214,33 @@ struct HciLayer::impl {
     bool is_status = logging_id == "status";
 
     ASSERT_LOG(
-        !command_queue_.empty(),
+        !in_flight_commands_.empty(),
         "Unexpected %s event with OpCode 0x%02hx (%s)",
         logging_id.c_str(),
         op_code,
         OpCodeText(op_code).c_str());
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    // There is at most one command per opcode in flight
+    auto command = std::find_if(
+        in_flight_commands_.begin(), in_flight_commands_.end(), [op_code](const CommandQueueEntry& entry) {
+          return entry.op_code == op_code;
+        });
+    if (command == in_flight_commands_.end() &&
+        in_flight_commands_.front().op_code == OpCode::CONTROLLER_DEBUG_INFO) {
       LOG_ERROR("Discarding event that came after timeout 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
       return;
     }
     ASSERT_LOG(
-        waiting_command_ == op_code,
+        command != in_flight_commands_.end(),
         "Waiting for 0x%02hx (%s), got 0x%02hx (%s)",
-        waiting_command_,
-        OpCodeText(waiting_command_).c_str(),
+        in_flight_commands_.front().op_code,
+        OpCodeText(in_flight_commands_.front().op_code).c_str(),
         op_code,
         OpCodeText(op_code).c_str());
+    log_hci_event(command->command_view, event, module_.GetDependency<storage::StorageModule>());
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected,
       // we can't treat this as hard failure since we have no way of probing this lack of support at
@@ -208,22 +248,24 @@ struct HciLayer::impl {
       // packet, which will be interpreted as invalid response.
       CommandCompleteView command_complete_view = CommandCompleteView::Create(
           EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-      command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(
-          std::move(command_complete_view));
+      command->GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
     } else {
-      if (command_queue_.front().waiting_for_status_ == is_status) {
-        command_queue_.front().GetCallback<TResponse>()->Invoke(std::move(response_view));
+      if (command->waiting_for_status_ == is_status) {
+        command->GetCallback<TResponse>()->Invoke(std::move(response_view));
       } else {
         CommandCompleteView command_complete_view = CommandCompleteView::Create(
             EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-        command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
+        command->GetCallback<CommandCompleteView>()->Invoke(std::move(command_complete_view));
       }
     }
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    bool was_oldest = command == in_flight_commands_.begin();
+    in_flight_commands_.erase(command);
     if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Cancel();
+      if (was_oldest) {
+        hci_timeout_alarm_->Cancel();
+        schedule_hci_timeout();
+      }
       send_next_command();
     }
   }
@@ -233,11 +275,11 @@ struct HciLayer::impl {
     LOG_ERROR("Timed out waiting for 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
     // TODO: LogMetricHciTimeoutEvent(static_cast<uint32_t>(op_code));
 
-    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size());
+    LOG_ERROR("Flushing %zd waiting commands", in_flight_commands_.size() + command_queue_.size());
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
+    in_flight_commands_.clear();
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
     // Ignore the response, since we don't know what might come back.
     enqueue_command(ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce([](CommandCompleteView) {}));
     // Don't time out for this one;
@@ -254,29 +296,64 @@ struct HciLayer::impl {
     }
   }
 
+  // Send as many queued commands as the controller has room for. Commands are sent in order, and the queue waits
+  // while its front can't go: Reset goes alone, and a command waits for the response to a previous one with the
+  // same opcode, which responses couldn't tell apart otherwise.
   void send_next_command() {
-    if (command_credits_ == 0) {
-      return;
+    while (command_credits_ > 0 && !command_queue_.empty()) {
+      auto& command = command_queue_.front();
+      if (command.command_view == nullptr) {
+        serialize_command(command);
+      }
+      if (!can_send_now(command.op_code)) {
+        return;
+      }
+      BT_TRACE_INSTANT(HCI_COMMAND, "HCI command", command.op_code);
+      hal_->sendHciCommand(*command.bytes);
+      log_link_layer_connection_command(command.command_view);
+      log_classic_pairing_command_status(command.command_view, ErrorCode::STATUS_UNKNOWN);
+      command_credits_--;
+      in_flight_commands_.splice(in_flight_commands_.end(), command_queue_, command_queue_.begin());
+      if (in_flight_commands_.size() == 1) {
+        schedule_hci_timeout();
+      }
     }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
+  }
+
+  void serialize_command(CommandQueueEntry& command) {
+    command.bytes = std::make_shared<std::vector<uint8_t>>();
+    command.bytes->reserve(command.command->size());
+    BitInserter bi(*command.bytes);
+    command.command->Serialize(bi);
+
+    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(command.bytes));
+    ASSERT(cmd_view.IsValid());
+    command.op_code = cmd_view.GetOpCode();
+    command.command_view = std::make_unique<CommandView>(std::move(cmd_view));
+  }
+
+  bool can_send_now(OpCode op_code) const {
+    if (in_flight_commands_.empty()) {
+      return true;
     }
-    if (command_queue_.size() == 0) {
-      return;
+    if (op_code == OpCode::RESET) {
+      return false;
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
+    for (const auto& in_flight : in_flight_commands_) {
+      if (in_flight.op_code == op_code || in_flight.op_code == OpCode::RESET) {
+        return false;
+      }
+    }
+    return true;
+  }
 
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    ASSERT(cmd_view.IsValid());
-    OpCode op_code = cmd_view.GetOpCode();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
+  // The timeout runs for the oldest command in flight. It starts over for the next one once the controller responds,
+  // so that each command gets kHciTimeoutMs from the point it is the one being waited for.
+  void schedule_hci_timeout() {
+    if (in_flight_commands_.empty()) {
+      return;
+    }
+    OpCode op_code = in_flight_commands_.front().op_code;
     if (hci_timeout_alarm_ != nullptr) {
       hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
     } else {
@@ -291,28 +368,28 @@ struct HciLayer::impl {
         EventCode::LE_META_EVENT,
         EventCodeText(EventCode::LE_META_EVENT).c_str());
     ASSERT_LOG(
-        event_handlers_.count(event) == 0,
+        event_handlers_[static_cast<uint8_t>(event)].IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         EventCodeText(event).c_str());
-    event_handlers_[event] = handler;
+    event_handlers_[static_cast<uint8_t>(event)] = handler;
   }
 
   void unregister_event(EventCode event) {
-    event_handlers_.erase(event);
+    event_handlers_[static_cast<uint8_t>(event)] = {};
   }
 
   void register_le_event(SubeventCode event, ContextualCallback<void(LeMetaEventView)> handler) {
     ASSERT_LOG(
-        subevent_handlers_.count(event) == 0,
+        subevent_handlers_[static_cast<uint8_t>(event)].IsEmpty(),
         "Can not register a second handler for %02hhx (%s)",
         event,
         SubeventCodeText(event).c_str());
-    subevent_handlers_[event] = handler;
+    subevent_handlers_[static_cast<uint8_t>(event)] = handler;
   }
 
   void unregister_le_event(SubeventCode event) {
-    subevent_handlers_.erase(subevent_handlers_.find(event));
+    subevent_handlers_[static_cast<uint8_t>(event)] = {};
   }
 
   static void abort_after_root_inflammation(uint8_t vse_error) {
@@ -338,8 +415,11 @@ struct HciLayer::impl {
   }
 
   void on_hci_event(EventView event) {
+    auto dispatch_start = std::chrono::steady_clock::now();
     ASSERT(event.IsValid());
-    if (command_queue_.empty()) {
+    BT_TRACE_SCOPE(HCI_EVENT, "HCI event dispatch");
+    BT_TRACE_INSTANT(HCI_EVENT, "HCI event", event.GetEventCode());
+    if (in_flight_commands_.empty()) {
       auto event_code = event.GetEventCode();
       // BT Core spec 5.2 (Volume 4, Part E section 4.4) allows anytime
       // COMMAND_COMPLETE and COMMAND_STATUS with opcode 0x0 for flow control
@@ -367,12 +447,13 @@ struct HciLayer::impl {
             op_code,
             OpCodeText(op_code).c_str());
       }
+    }
+    EventCode event_code = event.GetEventCode();
+    // Command responses are logged along with the command they are for, once it is found
+    if (event_code != EventCode::COMMAND_COMPLETE && event_code != EventCode::COMMAND_STATUS) {
       std::unique_ptr<CommandView> no_waiting_command{nullptr};
       log_hci_event(no_waiting_command, event, module_.GetDependency<storage::StorageModule>());
-    } else {
-      log_hci_event(command_queue_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
     }
-    EventCode event_code = event.GetEventCode();
     // Root Inflamation is a special case, since it aborts here
     if (event_code == EventCode::VENDOR_SPECIFIC) {
       auto view = VendorSpecificEventView::Create(event);
@@ -396,38 +477,52 @@ struct HciLayer::impl {
       case EventCode::LE_META_EVENT:
         on_le_meta_event(event);
         break;
-      default:
-        if (event_handlers_.find(event_code) == event_handlers_.end()) {
+      default: {
+        auto& handler = event_handlers_[static_cast<uint8_t>(event_code)];
+        if (handler.IsEmpty()) {
           LOG_WARN(
               "Unhandled event of type 0x%02hhx (%s)",
               event_code,
               EventCodeText(event_code).c_str());
         } else {
-          event_handlers_[event_code].Invoke(event);
+          handler.Invoke(event);
         }
+      }
     }
+    event_stats_[static_cast<uint8_t>(event_code)].Record(std::chrono::steady_clock::now() - dispatch_start);
   }
 
   void on_le_meta_event(EventView event) {
+    auto dispatch_start = std::chrono::steady_clock::now();
     LeMetaEventView meta_event_view = LeMetaEventView::Create(event);
     ASSERT(meta_event_view.IsValid());
     SubeventCode subevent_code = meta_event_view.GetSubeventCode();
-    if (subevent_handlers_.find(subevent_code) == subevent_handlers_.end()) {
+    auto& handler = subevent_handlers_[static_cast<uint8_t>(subevent_code)];
+    if (handler.IsEmpty()) {
       LOG_WARN("Unhandled le subevent of type 0x%02hhx (%s)", subevent_code, SubeventCodeText(subevent_code).c_str());
-      return;
+    } else {
+      handler.Invoke(meta_event_view);
     }
-    subevent_handlers_[subevent_code].Invoke(meta_event_view);
+    subevent_stats_[static_cast<uint8_t>(subevent_code)].Record(std::chrono::steady_clock::now() - dispatch_start);
   }
 
+  void Dump(std::promise<flatbuffers::Offset<HciLayerData>> promise, flatbuffers::FlatBufferBuilder* fb_builder) const;
+
   hal::HciHal* hal_;
   HciLayer& module_;
 
   // Command Handling
+  // Commands not sent yet
   std::list<CommandQueueEntry> command_queue_;
-
-  std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
-  std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> subevent_handlers_;
-  OpCode waiting_command_{OpCode::NONE};
+  // Commands sent and waiting for their response, oldest first
+  std::list<CommandQueueEntry> in_flight_commands_;
+
+  // Handlers and dispatch statistics, indexed by event and subevent code
+  std::array<ContextualCallback<void(EventView)>, kNumEventCodes> event_handlers_;
+  std::array<ContextualCallback<void(LeMetaEventView)>, kNumEventCodes> subevent_handlers_;
+  std::array<EventStats, kNumEventCodes> event_stats_;
+  std::array<EventStats, kNumEventCodes> subevent_stats_;
+  // Num_HCI_Command_Packets from the last response, less the commands sent since
   uint8_t command_credits_{1};  // Send reset first
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
@@ -456,6 +551,7 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   }
 
   void aclDataReceived(hal::HciPacket data_bytes) override {
+    BT_TRACE_INSTANT(ACL_RX, "ACL RX", data_bytes.size());
     auto packet = packet::PacketView<packet::kLittleEndian>(
         std::make_shared<std::vector<uint8_t>>(std::move(data_bytes)));
     auto acl = std::make_unique<AclView>(AclView::Create(packet));
@@ -476,6 +572,31 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
     module_.impl_->incoming_iso_buffer_.Enqueue(std::move(iso), module_.GetHandler());
   }
 
+  void hciEventBufferReceived(packet::View event_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>({std::move(event_bytes)});
+    EventView event = EventView::Create(packet);
+    module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event));
+  }
+
+  void aclDataBufferReceived(packet::View data_bytes) override {
+    BT_TRACE_INSTANT(ACL_RX, "ACL RX", data_bytes.size());
+    auto packet = packet::PacketView<packet::kLittleEndian>({std::move(data_bytes)});
+    auto acl = std::make_unique<AclView>(AclView::Create(packet));
+    module_.impl_->incoming_acl_buffer_.Enqueue(std::move(acl), module_.GetHandler());
+  }
+
+  void scoDataBufferReceived(packet::View data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>({std::move(data_bytes)});
+    auto sco = std::make_unique<ScoView>(ScoView::Create(packet));
+    module_.impl_->incoming_sco_buffer_.Enqueue(std::move(sco), module_.GetHandler());
+  }
+
+  void isoDataBufferReceived(packet::View data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>({std::move(data_bytes)});
+    auto iso = std::make_unique<IsoView>(IsoView::Create(packet));
+    module_.impl_->incoming_iso_buffer_.Enqueue(std::move(iso), module_.GetHandler());
+  }
+
   HciLayer& module_;
 };
 
@@ -526,6 +647,58 @@ void HciLayer::UnregisterLeEventHandler(SubeventCode event) {
   CallOn(impl_, &impl::unregister_le_event, event);
 }
 
+void HciLayer::impl::Dump(
+    std::promise<flatbuffers::Offset<HciLayerData>> promise, flatbuffers::FlatBufferBuilder* fb_builder) const {
+  ASSERT(fb_builder != nullptr);
+  auto title = fb_builder->CreateString("----- Hci Layer Dumpsys -----");
+
+  // Only the codes which were received, most of the table is never used
+  auto dispatch_data = [fb_builder](const std::array<EventStats, kNumEventCodes>& stats, auto code_text) {
+    std::vector<flatbuffers::Offset<EventDispatchData>> data;
+    for (size_t code = 0; code < kNumEventCodes; code++) {
+      if (stats[code].count == 0) {
+        continue;
+      }
+      data.push_back(CreateEventDispatchData(
+          *fb_builder,
+          static_cast<uint8_t>(code),
+          fb_builder->CreateString(code_text(code)),
+          stats[code].count,
+          fb_builder->CreateVector(stats[code].histogram.data(), stats[code].histogram.size())));
+    }
+    return fb_builder->CreateVector(data);
+  };
+  auto events = dispatch_data(event_stats_, [](size_t code) { return EventCodeText(static_cast<EventCode>(code)); });
+  auto le_subevents = dispatch_data(
+      subevent_stats_, [](size_t code) { return SubeventCodeText(static_cast<SubeventCode>(code)); });
+
+  HciLayerDataBuilder builder(*fb_builder);
+  builder.add_title(title);
+  builder.add_events(events);
+  builder.add_le_subevents(le_subevents);
+
+  flatbuffers::Offset<HciLayerData> dumpsys_data = builder.Finish();
+  promise.set_value(dumpsys_data);
+}
+
+DumpsysDataFinisher HciLayer::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  ASSERT(fb_builder != nullptr);
+  // Test doubles derive from HciLayer without starting it
+  if (impl_ == nullptr) {
+    return Module::GetDumpsysData(fb_builder);
+  }
+
+  std::promise<flatbuffers::Offset<HciLayerData>> promise;
+  auto future = promise.get_future();
+  impl_->Dump(std::move(promise), fb_builder);
+
+  auto dumpsys_data = future.get();
+
+  return [dumpsys_data](DumpsysDataBuilder* dumpsys_builder) {
+    dumpsys_builder->add_hci_layer_dumpsys_data(dumpsys_data);
+  };
+}
+
 void HciLayer::on_disconnection_complete(EventView event_view) {
   auto disconnection_view = DisconnectionCompleteView::Create(event_view);
   if (!disconnection_view.IsValid()) {
@@ -117,6 +117,8 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
 
   void Stop() override;
 
+  DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;  // Module
+
   virtual void Disconnect(uint16_t handle, ErrorCode reason);
   virtual void ReadRemoteVersion(
       hci::ErrorCode hci_status,
@@ -20,6 +20,7 @@
 
 #include <chrono>
 #include <future>
+#include <string>
 
 #include "common/bind.h"
 #include "common/init_flags.h"
@@ -435,5 +436,158 @@ TEST_F(HciLayerTest, command_status_callback_is_invoked_with_failure_status) {
   sync_handler();
 }
 
+TEST_F(HciLayerTest, commands_pipelined_up_to_num_hci_command_packets) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  std::promise<OpCode> clock_offset_promise;
+  auto clock_offset = clock_offset_promise.get_future();
+  std::promise<OpCode> scan_enable_promise;
+  auto scan_enable = scan_enable_promise.get_future();
+  hci_->EnqueueCommand(
+      ReadClockOffsetBuilder::Create(0x001),
+      hci_handler_->BindOnce(
+          [](std::promise<OpCode>* promise, CommandStatusView view) { promise->set_value(view.GetCommandOpCode()); },
+          &clock_offset_promise));
+  hci_->EnqueueCommand(
+      WriteScanEnableBuilder::Create(ScanEnable::NO_SCANS),
+      hci_handler_->BindOnce(
+          [](std::promise<OpCode>* promise, CommandCompleteView view) { promise->set_value(view.GetCommandOpCode()); },
+          &scan_enable_promise));
+  hci_->EnqueueCommand(
+      ReadRemoteVersionInformationBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView view) {}));
+  sync_handler();
+
+  // Two commands go without waiting, the third one waits for a free slot
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::READ_CLOCK_OFFSET);
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::WRITE_SCAN_ENABLE);
+  ASSERT_FALSE(hal_->GetSentCommand(10ms).has_value());
+
+  // Responses are matched to their command, in whichever order they come
+  hal_->InjectEvent(WriteScanEnableCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+  ASSERT_EQ(scan_enable.wait_for(1s), std::future_status::ready);
+  ASSERT_EQ(scan_enable.get(), OpCode::WRITE_SCAN_ENABLE);
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::READ_REMOTE_VERSION_INFORMATION);
+
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  ASSERT_EQ(clock_offset.wait_for(1s), std::future_status::ready);
+  ASSERT_EQ(clock_offset.get(), OpCode::READ_CLOCK_OFFSET);
+}
+
+TEST_F(HciLayerTest, command_waits_for_response_with_same_opcode) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(5, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadClockOffsetBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView view) {}));
+  hci_->EnqueueCommand(ReadClockOffsetBuilder::Create(0x002), hci_handler_->BindOnce([](CommandStatusView view) {}));
+  hci_->EnqueueCommand(
+      WriteScanEnableBuilder::Create(ScanEnable::NO_SCANS), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  sync_handler();
+
+  // Commands are sent in order, so the one after the second Read Clock Offset waits too
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::READ_CLOCK_OFFSET);
+  ASSERT_FALSE(hal_->GetSentCommand(10ms).has_value());
+
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 5));
+  auto second = hal_->GetSentCommand();
+  ASSERT_TRUE(second.has_value());
+  auto read_clock_offset =
+      ReadClockOffsetView::Create(ConnectionManagementCommandView::Create(AclCommandView::Create(*second)));
+  ASSERT_TRUE(read_clock_offset.IsValid());
+  ASSERT_EQ(read_clock_offset.GetConnectionHandle(), 0x002);
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::WRITE_SCAN_ENABLE);
+}
+
+TEST_F(HciLayerTest, reset_is_not_pipelined) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(5, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadClockOffsetBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView view) {}));
+  hci_->EnqueueCommand(ResetBuilder::Create(), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  hci_->EnqueueCommand(
+      WriteScanEnableBuilder::Create(ScanEnable::NO_SCANS), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  sync_handler();
+
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::READ_CLOCK_OFFSET);
+  ASSERT_FALSE(hal_->GetSentCommand(10ms).has_value());
+
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 5));
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::RESET);
+  ASSERT_FALSE(hal_->GetSentCommand(10ms).has_value());
+
+  hal_->InjectEvent(ResetCompleteBuilder::Create(5, ErrorCode::SUCCESS));
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::WRITE_SCAN_ENABLE);
+}
+
+TEST_F(HciLayerTest, hci_timeout_restarts_for_next_command_in_flight) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(ReadClockOffsetBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView view) {}));
+  hci_->EnqueueCommand(
+      WriteScanEnableBuilder::Create(ScanEnable::NO_SCANS), hci_handler_->BindOnce([](CommandCompleteView view) {}));
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::READ_CLOCK_OFFSET);
+  ASSERT_EQ(hal_->GetSentCommand()->GetOpCode(), OpCode::WRITE_SCAN_ENABLE);
+
+  FakeTimerAdvance(HciLayer::kHciTimeoutMs.count() / 2);
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  sync_handler();
+
+  // Write Scan Enable is only waited for from the response to Read Clock Offset on
+  FakeTimerAdvance(HciLayer::kHciTimeoutMs.count() - 1);
+  sync_handler();
+  ASSERT_FALSE(hal_->GetSentCommand(10ms).has_value());
+
+  FakeTimerAdvance(1);
+  sync_handler();
+  auto sent_command = hal_->GetSentCommand();
+  ASSERT_TRUE(sent_command.has_value());
+  auto debug_info_view = ControllerDebugInfoView::Create(VendorCommandView::Create(*sent_command));
+  ASSERT_TRUE(debug_info_view.IsValid());
+}
+
+TEST_F(HciLayerTest, event_handler_can_be_registered_again_once_unregistered) {
+  FailIfResetNotSent();
+  hci_->RegisterLeEventHandler(SubeventCode::SCAN_TIMEOUT, hci_handler_->Bind([](LeMetaEventView view) {}));
+  hci_->UnregisterLeEventHandler(SubeventCode::SCAN_TIMEOUT);
+  std::promise<void> invoked;
+  auto future = invoked.get_future();
+  hci_->RegisterLeEventHandler(
+      SubeventCode::SCAN_TIMEOUT,
+      hci_handler_->Bind([](std::promise<void>* invoked, LeMetaEventView view) { invoked->set_value(); }, &invoked));
+  hal_->InjectEvent(LeScanTimeoutBuilder::Create());
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+}
+
+TEST_F(HciLayerTest, event_dispatch_is_counted_in_dumpsys) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+  hci_->RegisterLeEventHandler(SubeventCode::SCAN_TIMEOUT, hci_handler_->Bind([](LeMetaEventView view) {}));
+  for (int i = 0; i < 3; i++) {
+    hal_->InjectEvent(LeScanTimeoutBuilder::Create());
+  }
+  sync_handler();
+
+  std::string output;
+  ModuleDumper(fake_registry_, "HciLayerTest").DumpState(&output);
+  auto hci_layer_data = GetDumpsysData(output.data())->hci_layer_dumpsys_data();
+  ASSERT_NE(hci_layer_data, nullptr);
+
+  ASSERT_EQ(hci_layer_data->events()->size(), 2u);
+  auto command_complete = hci_layer_data->events()->Get(0);
+  ASSERT_EQ(command_complete->code(), static_cast<uint8_t>(EventCode::COMMAND_COMPLETE));
+  ASSERT_EQ(command_complete->count(), 1u);
+  auto le_meta_event = hci_layer_data->events()->Get(1);
+  ASSERT_EQ(le_meta_event->code(), static_cast<uint8_t>(EventCode::LE_META_EVENT));
+  ASSERT_EQ(le_meta_event->count(), 3u);
+
+  ASSERT_EQ(hci_layer_data->le_subevents()->size(), 1u);
+  auto scan_timeout = hci_layer_data->le_subevents()->Get(0);
+  ASSERT_EQ(scan_timeout->code(), static_cast<uint8_t>(SubeventCode::SCAN_TIMEOUT));
+  ASSERT_EQ(scan_timeout->name()->str(), SubeventCodeText(SubeventCode::SCAN_TIMEOUT));
+  ASSERT_EQ(scan_timeout->count(), 3u);
+  uint32_t dispatches = 0;
+  for (auto bucket : *scan_timeout->dispatch_time_histogram()) {
+    dispatches += bucket;
+  }
+  ASSERT_EQ(dispatches, 3u);
+}
+
 }  // namespace hci
 }  // namespace bluetooth
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+#include "packet/bit_inserter.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+PacketView<packet::kLittleEndian> Serialize(std::unique_ptr<packet::BasePacketBuilder> builder) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter it(*bytes);
+  builder->Serialize(it);
+  return PacketView<packet::kLittleEndian>(bytes);
+}
+
+// A Number Of Completed Packets event crediting |handles| connections
+PacketView<packet::kLittleEndian> MakeNumberOfCompletedPackets(size_t handles) {
+  std::vector<CompletedPackets> completed_packets;
+  for (size_t i = 0; i < handles; i++) {
+    CompletedPackets completed;
+    completed.connection_handle_ = static_cast<uint16_t>(0x40 + i);
+    completed.host_num_of_completed_packets_ = static_cast<uint16_t>(1 + i % 4);
+    completed_packets.push_back(completed);
+  }
+  return Serialize(NumberOfCompletedPacketsBuilder::Create(completed_packets));
+}
+
+// An LE Extended Advertising Report event with |reports| reports of 31 bytes of advertising data
+PacketView<packet::kLittleEndian> MakeExtendedAdvertisingReport(size_t reports) {
+  std::vector<LeExtendedAdvertisingResponseRaw> responses;
+  for (size_t i = 0; i < reports; i++) {
+    LeExtendedAdvertisingResponseRaw response{};
+    response.connectable_ = 1;
+    response.address_type_ = DirectAdvertisingAddressType::RANDOM_DEVICE_ADDRESS;
+    response.address_ = Address({0x00, 0x11, 0x22, 0x33, 0x44, static_cast<uint8_t>(i)});
+    response.primary_phy_ = PrimaryPhyType::LE_1M;
+    response.secondary_phy_ = SecondaryPhyType::LE_2M;
+    response.advertising_sid_ = static_cast<uint8_t>(i % 16);
+    response.tx_power_ = 0x7f;
+    response.rssi_ = static_cast<uint8_t>(-60);
+    response.advertising_data_ = std::vector<uint8_t>(31, static_cast<uint8_t>(i));
+    responses.push_back(response);
+  }
+  return Serialize(LeExtendedAdvertisingReportRawBuilder::Create(responses));
+}
+}  // namespace
+
+// Parse of the credits of range(0) connections, as done by the controller for every batch of ACL packets sent
+static void BM_NumberOfCompletedPacketsVector(State& state) {
+  auto packet = MakeNumberOfCompletedPackets(state.range(0));
+  for (auto _ : state) {
+    auto event = EventView::Create(packet);
+    ::benchmark::DoNotOptimize(event.IsValid());
+    auto completed_view = NumberOfCompletedPacketsView::Create(event);
+    ::benchmark::DoNotOptimize(completed_view.IsValid());
+    uint32_t credits = 0;
+    for (const auto& completed : completed_view.GetCompletedPackets()) {
+      credits += completed.host_num_of_completed_packets_;
+    }
+    ::benchmark::DoNotOptimize(credits);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NumberOfCompletedPacketsVector)->Arg(1)->Arg(4);
+
+// Same as BM_NumberOfCompletedPacketsVector, visiting the credits in place
+static void BM_NumberOfCompletedPacketsForEach(State& state) {
+  auto packet = MakeNumberOfCompletedPackets(state.range(0));
+  for (auto _ : state) {
+    auto event = EventView::Create(packet);
+    ::benchmark::DoNotOptimize(event.IsValid());
+    auto completed_view = NumberOfCompletedPacketsView::Create(event);
+    ::benchmark::DoNotOptimize(completed_view.IsValid());
+    uint32_t credits = 0;
+    completed_view.ForEachCompletedPackets(
+        [&credits](const CompletedPackets& completed) { credits += completed.host_num_of_completed_packets_; });
+    ::benchmark::DoNotOptimize(credits);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NumberOfCompletedPacketsForEach)->Arg(1)->Arg(4);
+
+// Parse of the reports of an extended advertising report event down to their advertising data, as the scanning
+// manager does for each of them
+static void BM_ExtendedAdvertisingReport(State& state) {
+  auto packet = MakeExtendedAdvertisingReport(state.range(0));
+  for (auto _ : state) {
+    auto event = EventView::Create(packet);
+    ::benchmark::DoNotOptimize(event.IsValid());
+    auto meta_event = LeMetaEventView::Create(event);
+    ::benchmark::DoNotOptimize(meta_event.IsValid());
+    auto report_view = LeExtendedAdvertisingReportRawView::Create(meta_event);
+    ::benchmark::DoNotOptimize(report_view.IsValid());
+    for (const auto& response : report_view.GetResponses()) {
+      ::benchmark::DoNotOptimize(response.advertising_data_.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ExtendedAdvertisingReport)->Arg(1)->Arg(4);
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -42,6 +42,10 @@ LeAddressManager::~LeAddressManager() {
     address_rotation_alarm_->Cancel();
     address_rotation_alarm_.reset();
   }
+  if (list_sync_alarm_ != nullptr) {
+    list_sync_alarm_->Cancel();
+    list_sync_alarm_.reset();
+  }
 }
 
 // Called on initialization, and on IRK rotation
@@ -248,11 +252,6 @@ void LeAddressManager::pause_registered_clients() {
   }
 }
 
-void LeAddressManager::push_command(Command command) {
-  pause_registered_clients();
-  cached_commands_.push(std::move(command));
-}
-
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
   if (registered_clients_.find(callback) == registered_clients_.end()) {
     LOG_INFO("No clients registered to ack pause");
@@ -463,9 +462,12 @@ void LeAddressManager::handle_next_command() {
 
 void LeAddressManager::AddDeviceToFilterAcceptList(
     FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+  handler_->BindOnceOn(
+              this,
+              &LeAddressManager::update_filter_accept_list,
+              AcceptListEntry(connect_list_address_type, address),
+              true)
+      .Invoke();
 }
 
 void LeAddressManager::AddDeviceToResolvingList(
@@ -477,40 +479,22 @@ void LeAddressManager::AddDeviceToResolvingList(
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
-
-  auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
-      peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
-  Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
-
-  if (supports_ble_privacy_) {
-    auto packet_builder =
-        hci::LeSetPrivacyModeBuilder::Create(peer_identity_address_type, peer_identity_address, PrivacyMode::DEVICE);
-    Command command = {CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(packet_builder)}};
-    cached_commands_.push(std::move(command));
-  }
-
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
-
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
-  } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
-  }
+  handler_->BindOnceOn(
+              this,
+              &LeAddressManager::update_resolving_list,
+              ResolvingListKey(peer_identity_address_type, peer_identity_address),
+              std::optional<ResolvingListEntry>(ResolvingListEntry{peer_irk, local_irk}))
+      .Invoke();
 }
 
 void LeAddressManager::RemoveDeviceFromFilterAcceptList(
     FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+  handler_->BindOnceOn(
+              this,
+              &LeAddressManager::update_filter_accept_list,
+              AcceptListEntry(connect_list_address_type, address),
+              false)
+      .Invoke();
 }
 
 void LeAddressManager::RemoveDeviceFromResolvingList(
@@ -519,32 +503,16 @@ void LeAddressManager::RemoveDeviceFromResolvingList(
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
-
-  auto packet_builder =
-      hci::LeRemoveDeviceFromResolvingListBuilder::Create(peer_identity_address_type, peer_identity_address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
-
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
-
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
-  } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
-  }
+  handler_->BindOnceOn(
+              this,
+              &LeAddressManager::update_resolving_list,
+              ResolvingListKey(peer_identity_address_type, peer_identity_address),
+              std::optional<ResolvingListEntry>())
+      .Invoke();
 }
 
 void LeAddressManager::ClearFilterAcceptList() {
-  auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
-  Command command = {CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+  handler_->BindOnceOn(this, &LeAddressManager::clear_filter_accept_list).Invoke();
 }
 
 void LeAddressManager::ClearResolvingList() {
@@ -552,31 +520,149 @@ void LeAddressManager::ClearResolvingList() {
     return;
   }
 
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+  handler_->BindOnceOn(this, &LeAddressManager::clear_resolving_list).Invoke();
+}
 
-  auto packet_builder = hci::LeClearResolvingListBuilder::Create();
-  Command command = {CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+void LeAddressManager::SetListSyncWindow(std::chrono::milliseconds window) {
+  list_sync_window_ = window;
+}
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+void LeAddressManager::update_filter_accept_list(AcceptListEntry entry, bool present) {
+  pending_filter_accept_list_changes_[entry] = present;
+  schedule_list_sync();
+}
 
-  handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+void LeAddressManager::update_resolving_list(ResolvingListKey key, std::optional<ResolvingListEntry> entry) {
+  pending_resolving_list_changes_[key] = entry;
+  schedule_list_sync();
+}
+
+void LeAddressManager::clear_filter_accept_list() {
+  pending_filter_accept_list_changes_.clear();
+  pending_filter_accept_list_clear_ = true;
+  schedule_list_sync();
+}
+
+void LeAddressManager::clear_resolving_list() {
+  pending_resolving_list_changes_.clear();
+  pending_resolving_list_clear_ = true;
+  schedule_list_sync();
+}
+
+// The sync runs after the changes already posted to the handler, or at the end of the sync window, so that a burst of
+// changes, like the ones made when reconnecting all the bonded devices, is sent within a single pause of the clients.
+void LeAddressManager::schedule_list_sync() {
+  if (list_sync_scheduled_) {
+    return;
+  }
+  list_sync_scheduled_ = true;
+  if (list_sync_window_.count() == 0) {
+    handler_->BindOnceOn(this, &LeAddressManager::sync_lists).Invoke();
+    return;
+  }
+  if (list_sync_alarm_ == nullptr) {
+    list_sync_alarm_ = std::make_unique<os::Alarm>(handler_);
+  }
+  list_sync_alarm_->Schedule(
+      common::BindOnce(&LeAddressManager::sync_lists, common::Unretained(this)), list_sync_window_);
+}
+
+void LeAddressManager::sync_lists() {
+  list_sync_scheduled_ = false;
+  std::vector<Command> commands;
+
+  if (pending_filter_accept_list_clear_) {
+    auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
+    commands.push_back({CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+    filter_accept_list_.clear();
+    filter_accept_list_known_ = true;
+    pending_filter_accept_list_clear_ = false;
+  }
+  for (const auto& [entry, present] : pending_filter_accept_list_changes_) {
+    bool in_controller = filter_accept_list_.count(entry) != 0;
+    if (filter_accept_list_known_ && in_controller == present) {
+      continue;
+    }
+    if (present) {
+      auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(entry.first, entry.second);
+      commands.push_back({CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+      filter_accept_list_.insert(entry);
+    } else {
+      auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(entry.first, entry.second);
+      commands.push_back({CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+      filter_accept_list_.erase(entry);
+    }
+  }
+  pending_filter_accept_list_changes_.clear();
+
+  // Address resolution is disabled only once around all the changes of the resolving list
+  std::vector<Command> resolving_list_commands;
+  if (pending_resolving_list_clear_) {
+    auto packet_builder = hci::LeClearResolvingListBuilder::Create();
+    resolving_list_commands.push_back({CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+    resolving_list_.clear();
+    resolving_list_known_ = true;
+    pending_resolving_list_clear_ = false;
+  }
+  for (const auto& [key, entry] : pending_resolving_list_changes_) {
+    auto in_controller = resolving_list_.find(key);
+    bool was_present = in_controller != resolving_list_.end();
+    if (resolving_list_known_ && entry.has_value() == was_present && (!was_present || in_controller->second == *entry)) {
+      continue;
+    }
+    // The IRKs of a device already in the list change by adding it again
+    if (was_present || (!resolving_list_known_ && !entry.has_value())) {
+      auto packet_builder = hci::LeRemoveDeviceFromResolvingListBuilder::Create(key.first, key.second);
+      resolving_list_commands.push_back(
+          {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+      resolving_list_.erase(key);
+    }
+    if (entry.has_value()) {
+      auto packet_builder =
+          hci::LeAddDeviceToResolvingListBuilder::Create(key.first, key.second, entry->peer_irk, entry->local_irk);
+      resolving_list_commands.push_back(
+          {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+      auto privacy_mode_builder = hci::LeSetPrivacyModeBuilder::Create(key.first, key.second, PrivacyMode::DEVICE);
+      resolving_list_commands.push_back({CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(privacy_mode_builder)}});
+      resolving_list_[key] = *entry;
+    }
+  }
+  pending_resolving_list_changes_.clear();
+
+  if (!resolving_list_commands.empty()) {
+    auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
+    commands.push_back({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
+    for (auto& command : resolving_list_commands) {
+      commands.push_back(std::move(command));
+    }
+    auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
+    commands.push_back({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
+  }
+
+  if (commands.empty()) {
+    LOG_DEBUG("Lists already in sync with the controller");
+    return;
+  }
+
+  LOG_INFO("Syncing the lists with %zu commands", commands.size());
+  for (auto& command : commands) {
+    cached_commands_.push(std::move(command));
+  }
+  if (registered_clients_.empty()) {
+    handle_next_command();
+  } else {
+    pause_registered_clients();
+  }
 }
 
 template <class View>
-void LeAddressManager::on_command_complete(CommandCompleteView view) {
+bool LeAddressManager::on_command_complete(CommandCompleteView view) {
   auto op_code = view.GetCommandOpCode();
 
   auto complete_view = View::Create(view);
   if (!complete_view.IsValid()) {
     LOG_ERROR("Received %s complete with invalid packet", hci::OpCodeText(op_code).c_str());
-    return;
+    return false;
   }
   auto status = complete_view.GetStatus();
   if (status != ErrorCode::SUCCESS) {
@@ -584,7 +670,9 @@ void LeAddressManager::on_command_complete(CommandCompleteView view) {
         "Received %s complete with status %s",
         hci::OpCodeText(op_code).c_str(),
         ErrorCodeText(complete_view.GetStatus()).c_str());
+    return false;
   }
+  return true;
 }
 
 void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView view) {
@@ -624,11 +712,15 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
       break;
 
     case OpCode::LE_ADD_DEVICE_TO_RESOLVING_LIST:
-      on_command_complete<LeAddDeviceToResolvingListCompleteView>(view);
+      if (!on_command_complete<LeAddDeviceToResolvingListCompleteView>(view)) {
+        resolving_list_known_ = false;
+      }
       break;
 
     case OpCode::LE_REMOVE_DEVICE_FROM_RESOLVING_LIST:
-      on_command_complete<LeRemoveDeviceFromResolvingListCompleteView>(view);
+      if (!on_command_complete<LeRemoveDeviceFromResolvingListCompleteView>(view)) {
+        resolving_list_known_ = false;
+      }
       break;
 
     case OpCode::LE_CLEAR_RESOLVING_LIST:
@@ -636,11 +728,15 @@ void LeAddressManager::OnCommandComplete(bluetooth::hci::CommandCompleteView vie
       break;
 
     case OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST:
-      on_command_complete<LeAddDeviceToFilterAcceptListCompleteView>(view);
+      if (!on_command_complete<LeAddDeviceToFilterAcceptListCompleteView>(view)) {
+        filter_accept_list_known_ = false;
+      }
       break;
 
     case OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST:
-      on_command_complete<LeRemoveDeviceFromFilterAcceptListCompleteView>(view);
+      if (!on_command_complete<LeRemoveDeviceFromFilterAcceptListCompleteView>(view)) {
+        filter_accept_list_known_ = false;
+      }
       break;
 
     case OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE:
@@ -17,6 +17,7 @@
 
 #include <map>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <variant>
 
@@ -96,6 +97,9 @@ class LeAddressManager {
   void RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type, Address peer_identity_address);
   void ClearFilterAcceptList();
   void ClearResolvingList();
+  // The list changes requested within |window| of the first one are synced together, in a single pause of the
+  // clients. With no window, only the changes already posted to the handler are. Must be set before any change.
+  void SetListSyncWindow(std::chrono::milliseconds window);
   void OnCommandComplete(CommandCompleteView view);
   std::chrono::milliseconds GetNextPrivateAddressIntervalMs();
 
@@ -147,8 +151,19 @@ class LeAddressManager {
     std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand> contents;
   };
 
+  using AcceptListEntry = std::pair<FilterAcceptListAddressType, Address>;
+  using ResolvingListKey = std::pair<PeerAddressType, Address>;
+
+  struct ResolvingListEntry {
+    std::array<uint8_t, 16> peer_irk;
+    std::array<uint8_t, 16> local_irk;
+
+    bool operator==(const ResolvingListEntry& other) const {
+      return peer_irk == other.peer_irk && local_irk == other.local_irk;
+    }
+  };
+
   void pause_registered_clients();
-  void push_command(Command command);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -163,9 +178,15 @@ class LeAddressManager {
   hci::Address generate_rpa();
   hci::Address generate_nrpa();
   void handle_next_command();
+  void update_filter_accept_list(AcceptListEntry entry, bool present);
+  void update_resolving_list(ResolvingListKey key, std::optional<ResolvingListEntry> entry);
+  void clear_filter_accept_list();
+  void clear_resolving_list();
+  void schedule_list_sync();
+  void sync_lists();
   void check_cached_commands();
   template <class View>
-  void on_command_complete(CommandCompleteView view);
+  bool on_command_complete(CommandCompleteView view);
 
   common::Callback<void(std::unique_ptr<CommandBuilder>)> enqueue_command_;
   os::Handler* handler_;
@@ -180,6 +201,22 @@ class LeAddressManager {
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
   bool supports_ble_privacy_{false};
+
+  // The lists as they will be in the controller once the cached commands are sent. They stop being known when a
+  // command changing them fails, until they are cleared: changes are then sent even if they look redundant.
+  std::set<AcceptListEntry> filter_accept_list_;
+  bool filter_accept_list_known_{true};
+  std::map<ResolvingListKey, ResolvingListEntry> resolving_list_;
+  bool resolving_list_known_{true};
+
+  // The changes requested since the lists were last synced, only the last one for each device matters
+  std::map<AcceptListEntry, bool> pending_filter_accept_list_changes_;
+  bool pending_filter_accept_list_clear_{false};
+  std::map<ResolvingListKey, std::optional<ResolvingListEntry>> pending_resolving_list_changes_;
+  bool pending_resolving_list_clear_{false};
+  bool list_sync_scheduled_{false};
+  std::chrono::milliseconds list_sync_window_{0};
+  std::unique_ptr<os::Alarm> list_sync_alarm_;
 };
 
 }  // namespace hci
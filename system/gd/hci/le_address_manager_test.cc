@@ -390,6 +390,66 @@ TEST_F(LeAddressManagerWithSingleClientTest, clear_filter_accept_list) {
   clients[0].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, sync_filter_accept_list_changes) {
+  Address address;
+  Address::FromString("01:02:03:04:05:06", address);
+  Address other_address;
+  Address::FromString("01:02:03:04:05:07", other_address);
+
+  // Changes cancelling each other are dropped
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, other_address);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  le_address_manager_->RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM, other_address);
+  auto packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+      LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address, packet_view.GetAddress());
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+
+  // Adding a device already in the list changes nothing
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  sync_handler(handler_);
+  sync_handler(handler_);
+  ASSERT_FALSE(clients[0].get()->paused);
+  ASSERT_EQ(0u, le_address_manager_->NumberCachedCommands());
+
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  test_hci_layer_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST);
+  test_hci_layer_->IncomingEvent(LeRemoveDeviceFromFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+}
+
+TEST_F(LeAddressManagerWithSingleClientTest, sync_filter_accept_list_changes_within_window) {
+  Address address;
+  Address::FromString("01:02:03:04:05:06", address);
+  Address other_address;
+  Address::FromString("01:02:03:04:05:07", other_address);
+  le_address_manager_->SetListSyncWindow(std::chrono::milliseconds(100));
+
+  // The first change waits for the others of the window
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  sync_handler(handler_);
+  sync_handler(handler_);
+  ASSERT_FALSE(clients[0].get()->paused);
+  ASSERT_EQ(0u, le_address_manager_->NumberCachedCommands());
+
+  // Both are sent within the same pause
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, other_address);
+  test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_EQ(1u, le_address_manager_->NumberCachedCommands());
+  ASSERT_NO_FATAL_FAILURE(test_hci_layer_->SetCommandFuture());
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  ASSERT_TRUE(clients[0].get()->paused);
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+}
+
 // b/260916288
 TEST_F(LeAddressManagerWithSingleClientTest, DISABLED_add_device_to_resolving_list) {
   Address address;
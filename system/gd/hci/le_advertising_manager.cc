@@ -15,6 +15,7 @@
  */
 #include "hci/le_advertising_manager.h"
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 
@@ -41,6 +42,8 @@ constexpr int64_t kLeAdvertisingTxPowerMin = -127;
 constexpr int64_t kLeAdvertisingTxPowerMax = 20;
 constexpr int64_t kLeTxPathLossCompMin = -128;
 constexpr int64_t kLeTxPathLossCompMax = 127;
+// Advertising sets whose address rotation is due within this window are rotated together
+constexpr std::chrono::milliseconds kAddressRotationBatchWindow = std::chrono::seconds(30);
 
 // system properties
 const std::string kLeTxPathLossCompProperty = "bluetooth.hardware.radio.le_tx_path_loss_comp_db";
@@ -77,6 +80,7 @@ struct Advertiser {
   bool directed = false;
   bool in_use = false;
   std::unique_ptr<os::Alarm> address_rotation_alarm;
+  std::chrono::steady_clock::time_point address_rotation_deadline;
 };
 
 /**
@@ -316,11 +320,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           advertising_sets_[advertiser_id].max_extended_advertising_events == 0) {
         LOG_INFO("Reenable advertising");
         if (was_rotating_address) {
-          advertising_sets_[advertiser_id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-          advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-              common::BindOnce(
-                  &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-              le_address_manager_->GetNextPrivateAddressIntervalMs());
+          schedule_address_rotation(advertiser_id);
         }
         enable_advertiser(advertiser_id, true, 0, 0);
       }
@@ -573,11 +573,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       // addresses don't rotate)
       if (advertising_sets_[id].address_type != AdvertiserAddressType::PUBLIC) {
         // start timer for random address
-        advertising_sets_[id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-        advertising_sets_[id].address_rotation_alarm->Schedule(
-            common::BindOnce(
-                &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), id),
-            le_address_manager_->GetNextPrivateAddressIntervalMs());
+        schedule_address_rotation(id);
       }
     }
     if (config.advertising_type == AdvertisingType::ADV_IND ||
@@ -660,45 +656,83 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
-  void set_advertising_set_random_address_on_timer(AdvertiserId advertiser_id) {
-    // This function should only be trigger by enabled advertising set or IRK rotation
-    if (enabled_sets_[advertiser_id].advertising_handle_ == kInvalidHandle) {
-      if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
-        advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
-        advertising_sets_[advertiser_id].address_rotation_alarm.reset();
-      }
-      return;
+  void schedule_address_rotation(AdvertiserId advertiser_id) {
+    auto& advertising_set = advertising_sets_[advertiser_id];
+    if (advertising_set.address_rotation_alarm == nullptr) {
+      advertising_set.address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
     }
+    auto interval = le_address_manager_->GetNextPrivateAddressIntervalMs();
+    advertising_set.address_rotation_deadline = std::chrono::steady_clock::now() + interval;
+    advertising_set.address_rotation_alarm->Schedule(
+        common::BindOnce(&impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
+        interval);
+  }
 
+  // Rotate the address of the given enabled advertising sets. The connectable ones have to be disabled meanwhile,
+  // all with a single command, so that they only stop advertising once however many sets are rotated.
+  void rotate_advertiser_addresses(const std::vector<AdvertiserId>& advertiser_ids) {
     // TODO handle duration and max_extended_advertising_events_
-    EnabledSet curr_set;
-    curr_set.advertising_handle_ = advertiser_id;
-    curr_set.duration_ = advertising_sets_[advertiser_id].duration;
-    curr_set.max_extended_advertising_events_ = advertising_sets_[advertiser_id].max_extended_advertising_events;
-    std::vector<EnabledSet> enabled_sets = {curr_set};
+    std::vector<EnabledSet> connectable_sets;
+    for (auto advertiser_id : advertiser_ids) {
+      if (advertising_sets_[advertiser_id].connectable) {
+        EnabledSet curr_set;
+        curr_set.advertising_handle_ = advertiser_id;
+        curr_set.duration_ = advertising_sets_[advertiser_id].duration;
+        curr_set.max_extended_advertising_events_ = advertising_sets_[advertiser_id].max_extended_advertising_events;
+        connectable_sets.push_back(curr_set);
+      }
+    }
 
-    // For connectable advertising, we should disable it first
-    if (advertising_sets_[advertiser_id].connectable) {
+    // If we are paused, every set is already disabled and will be enabled in OnResume(), so leave them alone.
+    // Note that OnResume() can never re-enable us while we are changing our address, since the
+    // DISABLED and ENABLED commands are enqueued synchronously, so OnResume() doesn't need an
+    // analogous check.
+    bool disable = !paused && !connectable_sets.empty() && advertising_api_type_ == AdvertisingApiType::EXTENDED;
+    if (disable) {
       le_advertising_interface_->EnqueueCommand(
-          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, enabled_sets),
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, connectable_sets),
           module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
     }
 
-    rotate_advertiser_address(advertiser_id);
+    for (auto advertiser_id : advertiser_ids) {
+      rotate_advertiser_address(advertiser_id);
+    }
 
-    // If we are paused, we will be enabled in OnResume(), so don't resume now.
-    // Note that OnResume() can never re-enable us while we are changing our address, since the
-    // DISABLED and ENABLED commands are enqueued synchronously, so OnResume() doesn't need an
-    // analogous check.
-    if (advertising_sets_[advertiser_id].connectable && !paused) {
+    if (disable) {
       le_advertising_interface_->EnqueueCommand(
-          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, enabled_sets),
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, connectable_sets),
           module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
     }
+  }
 
-    advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-        common::BindOnce(&impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-        le_address_manager_->GetNextPrivateAddressIntervalMs());
+  void set_advertising_set_random_address_on_timer(AdvertiserId advertiser_id) {
+    // This function should only be trigger by enabled advertising set or IRK rotation
+    if (enabled_sets_[advertiser_id].advertising_handle_ == kInvalidHandle) {
+      if (advertising_sets_[advertiser_id].address_rotation_alarm != nullptr) {
+        advertising_sets_[advertiser_id].address_rotation_alarm->Cancel();
+        advertising_sets_[advertiser_id].address_rotation_alarm.reset();
+      }
+      return;
+    }
+
+    // Bring forward the rotation of the sets due soon, instead of disabling them again in a moment
+    auto batch_deadline = std::chrono::steady_clock::now() + kAddressRotationBatchWindow;
+    std::vector<AdvertiserId> advertiser_ids = {advertiser_id};
+    for (auto& [id, advertising_set] : advertising_sets_) {
+      if (id != advertiser_id && id < enabled_sets_.size() && enabled_sets_[id].advertising_handle_ != kInvalidHandle &&
+          advertising_set.address_rotation_alarm != nullptr &&
+          advertising_set.address_rotation_deadline <= batch_deadline) {
+        advertiser_ids.push_back(id);
+      }
+    }
+    if (advertiser_ids.size() > 1) {
+      LOG_INFO("Rotating the address of %zu advertising sets together", advertiser_ids.size());
+    }
+
+    rotate_advertiser_addresses(advertiser_ids);
+    for (auto id : advertiser_ids) {
+      schedule_address_rotation(id);
+    }
   }
 
   void register_advertiser(
@@ -1049,6 +1083,63 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  static size_t data_length(const std::vector<GapData>& data) {
+    size_t data_len = 0;
+    for (const auto& gap_data : data) {
+      data_len += gap_data.size();
+    }
+    return data_len;
+  }
+
+  void update_advertising_sets(std::vector<LeAdvertisingManager::AdvertisingSetUpdate> updates) {
+    // The controller only takes fragmented data for disabled advertising sets: disable all the enabled sets that
+    // need it with one command, and enable them back with another once all the data is sent.
+    std::vector<EnabledSet> disabled_sets;
+    for (const auto& update : updates) {
+      AdvertiserId advertiser_id = update.advertiser_id;
+      if (advertising_sets_.find(advertiser_id) == advertising_sets_.end()) {
+        LOG_WARN("No advertising set with key: %d", advertiser_id);
+        continue;
+      }
+      // Leave room for the flags set_data() may add
+      bool fragmented = (update.advertising_data.has_value() &&
+                         data_length(*update.advertising_data) + kLenOfFlags > kLeMaximumFragmentLength) ||
+                        (update.scan_response.has_value() &&
+                         data_length(*update.scan_response) > kLeMaximumFragmentLength);
+      if (fragmented && !paused && advertising_api_type_ == AdvertisingApiType::EXTENDED &&
+          enabled_sets_[advertiser_id].advertising_handle_ != kInvalidHandle) {
+        disabled_sets.push_back(enabled_sets_[advertiser_id]);
+      }
+    }
+
+    if (!disabled_sets.empty()) {
+      le_advertising_interface_->EnqueueCommand(
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, disabled_sets),
+          module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
+    }
+
+    for (auto& update : updates) {
+      if (advertising_sets_.find(update.advertiser_id) == advertising_sets_.end()) {
+        continue;
+      }
+      if (update.scan_response.has_value()) {
+        set_data(update.advertiser_id, true, std::move(*update.scan_response));
+      }
+      if (update.advertising_data.has_value()) {
+        set_data(update.advertiser_id, false, std::move(*update.advertising_data));
+      }
+      if (update.periodic_data.has_value()) {
+        set_periodic_data(update.advertiser_id, std::move(*update.periodic_data));
+      }
+    }
+
+    if (!disabled_sets.empty()) {
+      le_advertising_interface_->EnqueueCommand(
+          hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, disabled_sets),
+          module_handler_->BindOnce(impl::check_status<LeSetExtendedAdvertisingEnableCompleteView>));
+    }
+  }
+
   void enable_advertiser(
       AdvertiserId advertiser_id, bool enable, uint16_t duration, uint8_t max_extended_advertising_events) {
     EnabledSet curr_set;
@@ -1327,11 +1418,13 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   // If you are a future developer making this asynchronous, you need to add some kind of ->AckIRKChange() method to the
   // address manager so we can defer resumption to after this completes.
   void NotifyOnIRKChange() override {
+    std::vector<AdvertiserId> advertiser_ids;
     for (size_t i = 0; i < enabled_sets_.size(); i++) {
       if (enabled_sets_[i].advertising_handle_ != kInvalidHandle) {
-        rotate_advertiser_address(i);
+        advertiser_ids.push_back(i);
       }
     }
+    rotate_advertiser_addresses(advertiser_ids);
   }
 
   common::Callback<void(Address, AddressType)> scan_callback_;
@@ -1756,6 +1849,10 @@ void LeAdvertisingManager::SetData(AdvertiserId advertiser_id, bool set_scan_rsp
   CallOn(pimpl_.get(), &impl::set_data, advertiser_id, set_scan_rsp, data);
 }
 
+void LeAdvertisingManager::UpdateAdvertisingSets(std::vector<AdvertisingSetUpdate> updates) {
+  CallOn(pimpl_.get(), &impl::update_advertising_sets, std::move(updates));
+}
+
 void LeAdvertisingManager::EnableAdvertiser(
     AdvertiserId advertiser_id, bool enable, uint16_t duration, uint8_t max_extended_advertising_events) {
   CallOn(pimpl_.get(), &impl::enable_advertiser, advertiser_id, enable, duration, max_extended_advertising_events);
@@ -16,6 +16,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -139,6 +141,18 @@ class LeAdvertisingManager : public bluetooth::Module {
 
   void SetData(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data);
 
+  // The data to replace in one advertising set, the rest is left unchanged
+  struct AdvertisingSetUpdate {
+    AdvertiserId advertiser_id;
+    std::optional<std::vector<GapData>> advertising_data;
+    std::optional<std::vector<GapData>> scan_response;
+    std::optional<std::vector<GapData>> periodic_data;
+  };
+
+  // Update several advertising sets at once. The sets that have to be disabled to take their new data are all
+  // disabled, then enabled again, with a single command each.
+  void UpdateAdvertisingSets(std::vector<AdvertisingSetUpdate> updates);
+
   void EnableAdvertiser(
       AdvertiserId advertiser_id, bool enable, uint16_t duration, uint8_t max_extended_advertising_events);
 
@@ -952,6 +952,46 @@ TEST_F(LeExtendedAdvertisingAPITest, set_scan_response_fragments_test) {
   test_hci_layer_->IncomingEvent(LeSetExtendedScanResponseDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, update_advertising_sets_test) {
+  std::vector<GapData> advertising_data{};
+  for (uint8_t i = 0; i < 3; i++) {
+    GapData data_item{};
+    data_item.data_type_ = GapDataType::SERVICE_DATA_128_BIT_UUIDS;
+    data_item.data_.resize(1 + 16 + 200, i);
+    advertising_data.push_back(data_item);
+  }
+  LeAdvertisingManager::AdvertisingSetUpdate update{};
+  update.advertiser_id = advertiser_id_;
+  update.advertising_data = advertising_data;
+  le_advertising_manager_->UpdateAdvertisingSets({update});
+
+  // The enabled set can only take fragmented data while disabled
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+
+  // Data fitting in one command doesn't stop advertising
+  update.advertising_data = std::vector<GapData>{advertising_data[0]};
+  le_advertising_manager_->UpdateAdvertisingSets({update});
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+}
+
 TEST_F(LeExtendedAdvertisingAPITest, set_data_with_invalid_ad_structure) {
   // Set advertising data with AD structure that length greater than 251
   std::vector<GapData> advertising_data{};
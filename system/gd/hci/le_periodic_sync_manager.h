@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <utility>
@@ -81,9 +82,15 @@ class PeriodicSyncManager {
   explicit PeriodicSyncManager(ScanningCallback* callbacks)
       : le_scanning_interface_(nullptr), handler_(nullptr), callbacks_(callbacks), sync_received_callback_id(0) {}
 
-  void Init(hci::LeScanningInterface* le_scanning_interface, os::Handler* handler) {
+  // Up to |periodic_advertiser_list_size| syncs are established in parallel through the periodic advertiser list,
+  // with one sync at a time when the controller has no list
+  void Init(
+      hci::LeScanningInterface* le_scanning_interface,
+      os::Handler* handler,
+      uint8_t periodic_advertiser_list_size = 0) {
     le_scanning_interface_ = le_scanning_interface;
     handler_ = handler;
+    periodic_advertiser_list_size_ = periodic_advertiser_list_size;
   }
 
   void SetScanningCallback(ScanningCallback* callbacks) {
@@ -108,6 +115,16 @@ class PeriodicSyncManager {
               request.advertiser_sid);
     pending_sync_requests_.emplace_back(
         request.advertiser_sid, request.address_with_type, skip, sync_timeout, handler_);
+    if (UsePeriodicAdvertiserList()) {
+      auto listed = std::count_if(pending_sync_requests_.begin(), pending_sync_requests_.end(), [](const auto& it) {
+        return it.busy;
+      });
+      // The request waits for a sync to complete when the list is full
+      if (listed < periodic_advertiser_list_size_) {
+        RestartListedSync();
+      }
+      return;
+    }
     HandleNextRequest();
   }
 
@@ -136,6 +153,17 @@ class PeriodicSyncManager {
       return;
     }
 
+    if (UsePeriodicAdvertiserList()) {
+      LOG_DEBUG("[PSync]: Removing Sync request from the periodic advertiser list");
+      bool listed = periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING;
+      CleanUpRequest(adv_sid, address);
+      periodic_syncs_.erase(periodic_sync);
+      if (listed) {
+        RestartListedSync();
+      }
+      return;
+    }
+
     if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
       LOG_WARN("[PSync]: Sync state is pending");
       le_scanning_interface_->EnqueueCommand(
@@ -267,6 +295,11 @@ class PeriodicSyncManager {
         event_view.GetPeriodicAdvertisingInterval(),
         (uint16_t)event_view.GetAdvertiserClockAccuracy());
 
+    if (UsePeriodicAdvertiserList()) {
+      HandleListedSyncEstablished(event_view);
+      return;
+    }
+
     auto pending_sync_request =
         GetPendingSyncFromAddressAndSid(event_view.GetAdvertiserAddress(), event_view.GetAdvertisingSid());
     if (pending_sync_request != pending_sync_requests_.end()) {
@@ -525,6 +558,174 @@ class PeriodicSyncManager {
     HandleNextRequest();
   }
 
+  bool UsePeriodicAdvertiserList() const {
+    return periodic_advertiser_list_size_ > 0;
+  }
+
+  // The periodic advertiser list can't be changed while a Create Sync is pending: the pending one is cancelled first,
+  // and the list rebuilt from the pending requests when the controller reports the cancellation
+  void RestartListedSync() {
+    if (create_sync_pending_) {
+      if (!create_sync_cancelling_) {
+        create_sync_cancelling_ = true;
+        le_scanning_interface_->EnqueueCommand(
+            hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
+            handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncCancelStatus));
+      }
+      return;
+    }
+    if (pending_sync_requests_.empty()) {
+      LOG_DEBUG("pending_sync_requests_ empty");
+      return;
+    }
+
+    le_scanning_interface_->EnqueueCommand(
+        hci::LeClearPeriodicAdvertiserListBuilder::Create(),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::check_status<LeClearPeriodicAdvertiserListCompleteView>));
+    uint8_t listed = 0;
+    uint16_t skip = 0;
+    uint16_t sync_timeout = 0;
+    for (auto& request : pending_sync_requests_) {
+      if (listed == periodic_advertiser_list_size_) {
+        break;
+      }
+      LOG_INFO(
+          "listing sync request SID=%04X, bd_addr=%s",
+          request.advertiser_sid,
+          ADDRESS_TO_LOGGABLE_CSTR(request.address_with_type));
+      le_scanning_interface_->EnqueueCommand(
+          hci::LeAddDeviceToPeriodicAdvertiserListBuilder::Create(
+              static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+              request.address_with_type.GetAddress(),
+              request.advertiser_sid),
+          handler_->BindOnceOn(
+              this, &PeriodicSyncManager::check_status<LeAddDeviceToPeriodicAdvertiserListCompleteView>));
+      auto sync = GetSyncFromAddressWithTypeAndSid(request.address_with_type, request.advertiser_sid);
+      if (sync != periodic_syncs_.end()) {
+        sync->sync_state = PERIODIC_SYNC_STATE_PENDING;
+      }
+      // Each request keeps the timeout started when it was first listed, whatever the restarts in between
+      if (!request.busy) {
+        request.busy = true;
+        request.sync_timeout_alarm.Schedule(
+            base::BindOnce(
+                &PeriodicSyncManager::OnListedSyncTimeout,
+                base::Unretained(this),
+                request.advertiser_sid,
+                request.address_with_type),
+            kPeriodicSyncTimeout);
+      }
+      // The listed advertisers share the parameters of the Create Sync, the most demanding ones are taken
+      skip = listed == 0 ? request.skip : std::min(skip, request.skip);
+      sync_timeout = std::max(sync_timeout, request.sync_timeout);
+      listed++;
+    }
+
+    PeriodicAdvertisingOptions options;
+    options.use_periodic_advertiser_list_ = 1;
+    auto sync_cte_type =
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOA_CONSTANT_TONE_EXTENSION) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_ONE_US_SLOTS) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_TWO_US_SLOTS);
+    create_sync_pending_ = true;
+    le_scanning_interface_->EnqueueCommand(
+        hci::LePeriodicAdvertisingCreateSyncBuilder::Create(
+            options,
+            0,
+            AdvertisingAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS,
+            Address::kEmpty,
+            skip,
+            sync_timeout,
+            sync_cte_type),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::HandleListedCreateSyncStatus));
+  }
+
+  void HandleListedCreateSyncStatus(CommandStatusView view) {
+    if (view.GetStatus() != ErrorCode::SUCCESS) {
+      LOG_WARN("[PSync]: Create Sync failed, status %s", ErrorCodeText(view.GetStatus()).c_str());
+      create_sync_pending_ = false;
+      create_sync_cancelling_ = false;
+    }
+  }
+
+  // A Create Sync through the list ends with the first advertiser the controller synchronizes to, the others stay
+  // pending for the next one
+  void HandleListedSyncEstablished(LePeriodicAdvertisingSyncEstablishedView event_view) {
+    create_sync_pending_ = false;
+    create_sync_cancelling_ = false;
+    if (event_view.GetStatus() == ErrorCode::OPERATION_CANCELLED_BY_HOST) {
+      LOG_DEBUG("[PSync]: Create Sync cancelled, restarting");
+      RestartListedSync();
+      return;
+    }
+
+    auto address_with_type = AddressWithType(event_view.GetAdvertiserAddress(), event_view.GetAdvertiserAddressType());
+    auto sync = GetSyncFromAddressWithTypeAndSid(
+        AddressWithType(event_view.GetAdvertiserAddress(), ToDeviceAddressType(address_with_type.GetAddressType())),
+        event_view.GetAdvertisingSid());
+    CleanUpRequest(event_view.GetAdvertisingSid(), event_view.GetAdvertiserAddress());
+    if (sync == periodic_syncs_.end()) {
+      LOG_WARN("[PSync]: Invalid address and sid for sync established");
+      if (event_view.GetStatus() == ErrorCode::SUCCESS) {
+        le_scanning_interface_->EnqueueCommand(
+            hci::LePeriodicAdvertisingTerminateSyncBuilder::Create(event_view.GetSyncHandle()),
+            handler_->BindOnceOn(
+                this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
+      }
+      RestartListedSync();
+      return;
+    }
+
+    callbacks_->OnPeriodicSyncStarted(
+        sync->request_id,
+        (uint8_t)event_view.GetStatus(),
+        event_view.GetSyncHandle(),
+        event_view.GetAdvertisingSid(),
+        address_with_type,
+        (uint16_t)event_view.GetAdvertiserPhy(),
+        event_view.GetPeriodicAdvertisingInterval());
+    if (event_view.GetStatus() == ErrorCode::SUCCESS) {
+      sync->sync_handle = event_view.GetSyncHandle();
+      sync->sync_state = PERIODIC_SYNC_STATE_ESTABLISHED;
+    } else {
+      periodic_syncs_.erase(sync);
+    }
+    RestartListedSync();
+  }
+
+  // The request owning the alarm is released once the alarm callback returned
+  void OnListedSyncTimeout(uint8_t adv_sid, AddressWithType address_with_type) {
+    handler_->CallOn(this, &PeriodicSyncManager::HandleListedSyncTimeout, adv_sid, address_with_type);
+  }
+
+  void HandleListedSyncTimeout(uint8_t adv_sid, AddressWithType address_with_type) {
+    if (GetPendingSyncFromAddressAndSid(address_with_type.GetAddress(), adv_sid) == pending_sync_requests_.end()) {
+      return;
+    }
+    LOG_WARN(
+        "%s: sync timeout SID=%04X, bd_addr=%s", __func__, adv_sid, ADDRESS_TO_LOGGABLE_CSTR(address_with_type));
+    CleanUpRequest(adv_sid, address_with_type.GetAddress());
+    auto sync = GetSyncFromAddressWithTypeAndSid(address_with_type, adv_sid);
+    if (sync != periodic_syncs_.end()) {
+      int status = static_cast<int>(ErrorCode::ADVERTISING_TIMEOUT);
+      callbacks_->OnPeriodicSyncStarted(sync->request_id, status, 0, adv_sid, address_with_type, 0, 0);
+      RemoveSyncRequest(sync);
+    }
+    RestartListedSync();
+  }
+
+  static AddressType ToDeviceAddressType(AddressType address_type) {
+    switch (address_type) {
+      case AddressType::PUBLIC_DEVICE_ADDRESS:
+      case AddressType::PUBLIC_IDENTITY_ADDRESS:
+        return AddressType::PUBLIC_DEVICE_ADDRESS;
+      case AddressType::RANDOM_DEVICE_ADDRESS:
+      case AddressType::RANDOM_IDENTITY_ADDRESS:
+        return AddressType::RANDOM_DEVICE_ADDRESS;
+    }
+    return address_type;
+  }
+
   void CleanUpRequest(uint8_t advertiser_sid, Address address) {
     auto it = pending_sync_requests_.begin();
     while (it != pending_sync_requests_.end()) {
@@ -549,6 +750,9 @@ class PeriodicSyncManager {
   std::list<PeriodicSyncTransferStates> periodic_sync_transfers_;
   bool sync_received_callback_registered_ = false;
   int sync_received_callback_id{};
+  uint8_t periodic_advertiser_list_size_ = 0;
+  bool create_sync_pending_ = false;
+  bool create_sync_cancelling_ = false;
 };
 
 }  // namespace hci
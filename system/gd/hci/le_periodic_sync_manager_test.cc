@@ -646,6 +646,92 @@ TEST_F(PeriodicSyncManagerTest, handle_biginfo_advertising_report_test) {
   sync_handler();
 }
 
+TEST_F(PeriodicSyncManagerTest, start_sync_with_periodic_advertiser_list_test) {
+  periodic_sync_manager_->Init(test_le_scanning_interface_, handler_, 2);
+  Address address1, address2;
+  Address::FromString("00:11:22:33:44:55", address1);
+  Address::FromString("00:11:22:33:44:66", address2);
+  AddressWithType address_with_type1 = AddressWithType(address1, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType address_with_type2 = AddressWithType(address2, AddressType::RANDOM_DEVICE_ADDRESS);
+  PeriodicSyncStates request1{
+      .request_id = 0x01,
+      .advertiser_sid = 0x02,
+      .address_with_type = address_with_type1,
+      .sync_handle = 0,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  PeriodicSyncStates request2{
+      .request_id = 0x02,
+      .advertiser_sid = 0x03,
+      .address_with_type = address_with_type2,
+      .sync_handle = 0,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+
+  // The first request is listed and the sync created at once
+  periodic_sync_manager_->StartSync(request1, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_CLEAR_PERIODIC_ADVERTISER_LIST);
+  auto packet = test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST);
+  auto add_view = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(add_view.IsValid());
+  ASSERT_EQ(address1, add_view.GetAdvertiserAddress());
+  ASSERT_EQ(0x02, add_view.GetAdvertisingSid());
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  auto create_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(create_view.IsValid());
+  ASSERT_EQ(1, create_view.GetOptions().use_periodic_advertiser_list_);
+
+  // The second request restarts the pending sync with both advertisers in the list
+  periodic_sync_manager_->StartSync(request2, 0x02, 0x0C);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC_CANCEL);
+  auto cancelled = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::OPERATION_CANCELLED_BY_HOST,
+      0,
+      0,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      Address::kEmpty,
+      SecondaryPhyType::LE_1M,
+      0,
+      ClockAccuracy::PPM_250);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(cancelled))))));
+  test_le_scanning_interface_->GetCommand(OpCode::LE_CLEAR_PERIODIC_ADVERTISER_LIST);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST);
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST);
+  add_view = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(add_view.IsValid());
+  ASSERT_EQ(address2, add_view.GetAdvertiserAddress());
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  create_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(create_view.IsValid());
+  ASSERT_EQ(0x02, create_view.GetSkip());
+  ASSERT_EQ(0x0C, create_view.GetSyncTimeout());
+
+  // Once the second advertiser is synchronized the sync is created again for the first one
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnPeriodicSyncStarted(
+          0x02, (uint8_t)ErrorCode::SUCCESS, 0x12, 0x03, ::testing::_, ::testing::_, ::testing::_));
+  auto established = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x12,
+      0x03,
+      address_with_type2.GetAddressType(),
+      address2,
+      SecondaryPhyType::LE_1M,
+      0xFF,
+      ClockAccuracy::PPM_250);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(established))))));
+  test_le_scanning_interface_->GetCommand(OpCode::LE_CLEAR_PERIODIC_ADVERTISER_LIST);
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST);
+  add_view = LeAddDeviceToPeriodicAdvertiserListView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(add_view.IsValid());
+  ASSERT_EQ(address1, add_view.GetAdvertiserAddress());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  sync_handler();
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
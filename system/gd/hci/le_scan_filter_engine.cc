@@ -0,0 +1,365 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scan_filter_engine.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "os/log.h"
+
+namespace bluetooth::hci {
+
+namespace {
+// GAP AD types the filters look at
+constexpr uint8_t kIncomplete16BitUuids = 0x02;
+constexpr uint8_t kComplete16BitUuids = 0x03;
+constexpr uint8_t kIncomplete32BitUuids = 0x04;
+constexpr uint8_t kComplete32BitUuids = 0x05;
+constexpr uint8_t kIncomplete128BitUuids = 0x06;
+constexpr uint8_t kComplete128BitUuids = 0x07;
+constexpr uint8_t kShortenedLocalName = 0x08;
+constexpr uint8_t kCompleteLocalName = 0x09;
+constexpr uint8_t kSolicitation16BitUuids = 0x14;
+constexpr uint8_t kSolicitation128BitUuids = 0x15;
+constexpr uint8_t kServiceData16BitUuid = 0x16;
+constexpr uint8_t kSolicitation32BitUuids = 0x1f;
+constexpr uint8_t kServiceData32BitUuid = 0x20;
+constexpr uint8_t kServiceData128BitUuid = 0x21;
+constexpr uint8_t kTransportDiscoveryData = 0x26;
+constexpr uint8_t kManufacturerSpecificData = 0xff;
+
+// Size of the organization id, flags and length preceding the transport data
+constexpr size_t kTransportDiscoveryDataHeaderSize = 3;
+
+// The AD types a condition looks at
+std::vector<uint8_t> ad_types_of(const AdvertisingPacketContentFilterCommand& command) {
+  switch (command.filter_type) {
+    case ApcfFilterType::SERVICE_UUID:
+      switch (command.uuid.GetShortestRepresentationSize()) {
+        case Uuid::kNumBytes16:
+          return {kIncomplete16BitUuids, kComplete16BitUuids};
+        case Uuid::kNumBytes32:
+          return {kIncomplete32BitUuids, kComplete32BitUuids};
+        default:
+          return {kIncomplete128BitUuids, kComplete128BitUuids};
+      }
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      switch (command.uuid.GetShortestRepresentationSize()) {
+        case Uuid::kNumBytes16:
+          return {kSolicitation16BitUuids};
+        case Uuid::kNumBytes32:
+          return {kSolicitation32BitUuids};
+        default:
+          return {kSolicitation128BitUuids};
+      }
+    case ApcfFilterType::LOCAL_NAME:
+      return {kShortenedLocalName, kCompleteLocalName};
+    case ApcfFilterType::MANUFACTURER_DATA:
+      return {kManufacturerSpecificData};
+    case ApcfFilterType::SERVICE_DATA:
+      return {kServiceData16BitUuid, kServiceData32BitUuid, kServiceData128BitUuid};
+    case ApcfFilterType::TRANSPORT_DISCOVERY_DATA:
+      return {kTransportDiscoveryData};
+    case ApcfFilterType::AD_TYPE:
+      return {command.ad_type};
+    default:
+      return {};
+  }
+}
+
+// The little endian representation of a UUID in uuid_size bytes
+std::vector<uint8_t> uuid_bytes(const Uuid& uuid, size_t uuid_size) {
+  switch (uuid_size) {
+    case Uuid::kNumBytes16: {
+      uint16_t value = uuid.As16Bit();
+      return {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+    }
+    case Uuid::kNumBytes32: {
+      uint32_t value = uuid.As32Bit();
+      return {
+          static_cast<uint8_t>(value),
+          static_cast<uint8_t>(value >> 8),
+          static_cast<uint8_t>(value >> 16),
+          static_cast<uint8_t>(value >> 24)};
+    }
+    default: {
+      auto value = uuid.To128BitLE();
+      return std::vector<uint8_t>(value.begin(), value.end());
+    }
+  }
+}
+
+// True if value starts with data, comparing only the bits set in mask. An
+// empty mask compares every bit.
+bool masked_prefix_matches(
+    const uint8_t* value, size_t length, const std::vector<uint8_t>& data, const std::vector<uint8_t>& mask) {
+  if (length < data.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < data.size(); i++) {
+    uint8_t bits = i < mask.size() ? mask[i] : 0xff;
+    if ((value[i] & bits) != (data[i] & bits)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool uuid_list_matches(const AdvertisingPacketContentFilterCommand& command, const uint8_t* value, size_t length) {
+  size_t uuid_size = command.uuid.GetShortestRepresentationSize();
+  std::vector<uint8_t> uuid = uuid_bytes(command.uuid, uuid_size);
+  std::vector<uint8_t> mask =
+      command.uuid_mask.IsEmpty() ? std::vector<uint8_t>() : uuid_bytes(command.uuid_mask, uuid_size);
+  for (size_t offset = 0; offset + uuid_size <= length; offset += uuid_size) {
+    if (masked_prefix_matches(value + offset, uuid_size, uuid, mask)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// True if the value of a field of one of the AD types of the condition
+// satisfies it
+bool condition_matches(const AdvertisingPacketContentFilterCommand& command, const uint8_t* value, size_t length) {
+  switch (command.filter_type) {
+    case ApcfFilterType::SERVICE_UUID:
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      return uuid_list_matches(command, value, length);
+    case ApcfFilterType::LOCAL_NAME:
+      return length == command.name.size() && std::memcmp(value, command.name.data(), length) == 0;
+    case ApcfFilterType::MANUFACTURER_DATA: {
+      if (length < 2) {
+        return false;
+      }
+      uint16_t company = value[0] | (value[1] << 8);
+      uint16_t company_mask = command.company_mask != 0 ? command.company_mask : 0xffff;
+      return (company & company_mask) == (command.company & company_mask) &&
+             masked_prefix_matches(value + 2, length - 2, command.data, command.data_mask);
+    }
+    case ApcfFilterType::TRANSPORT_DISCOVERY_DATA: {
+      if (length < kTransportDiscoveryDataHeaderSize || value[0] != command.org_id ||
+          (value[1] & command.tds_flags_mask) != (command.tds_flags & command.tds_flags_mask)) {
+        return false;
+      }
+      size_t transport_data_length = std::min<size_t>(value[2], length - kTransportDiscoveryDataHeaderSize);
+      return masked_prefix_matches(
+          value + kTransportDiscoveryDataHeaderSize, transport_data_length, command.data, command.data_mask);
+    }
+    case ApcfFilterType::SERVICE_DATA:
+    case ApcfFilterType::AD_TYPE:
+      return masked_prefix_matches(value, length, command.data, command.data_mask);
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+LeScanFilterEngine::Filter& LeScanFilterEngine::GetOrCreate(uint8_t filter_index) {
+  auto it = filters_.find(filter_index);
+  if (it != filters_.end()) {
+    return it->second;
+  }
+  Filter& filter = filters_[filter_index];
+  filter.offloaded = false;
+  filter.has_parameters = false;
+  num_host_filters_++;
+  SetOffloaded(filter, num_offloaded_filters_ < max_offloaded_filters_);
+  LOG_INFO(
+      "Scan filter %d is %s", filter_index, filter.offloaded ? "offloaded to the controller" : "evaluated on the host");
+  return filter;
+}
+
+void LeScanFilterEngine::SetOffloaded(Filter& filter, bool offloaded) {
+  if (filter.offloaded == offloaded) {
+    return;
+  }
+  filter.offloaded = offloaded;
+  if (offloaded) {
+    num_offloaded_filters_++;
+    num_host_filters_--;
+  } else {
+    num_offloaded_filters_--;
+    num_host_filters_++;
+  }
+}
+
+bool LeScanFilterEngine::SetParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameters) {
+  Filter& filter = GetOrCreate(filter_index);
+  filter.has_parameters = true;
+  filter.parameters = parameters;
+  Compile();
+  return filter.offloaded;
+}
+
+bool LeScanFilterEngine::AddConditions(
+    uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions, bool can_offload) {
+  Filter& filter = GetOrCreate(filter_index);
+  if (filter.offloaded && !can_offload) {
+    LOG_INFO("Scan filter %d is now evaluated on the host, the controller can't evaluate it", filter_index);
+    SetOffloaded(filter, false);
+  }
+  filter.conditions.insert(filter.conditions.end(), conditions.begin(), conditions.end());
+  Compile();
+  return filter.offloaded;
+}
+
+void LeScanFilterEngine::Remove(uint8_t filter_index) {
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    return;
+  }
+  if (it->second.offloaded) {
+    num_offloaded_filters_--;
+  } else {
+    num_host_filters_--;
+  }
+  filters_.erase(it);
+  Compile();
+}
+
+void LeScanFilterEngine::Clear() {
+  filters_.clear();
+  num_offloaded_filters_ = 0;
+  num_host_filters_ = 0;
+  Compile();
+}
+
+bool LeScanFilterEngine::IsOffloaded(uint8_t filter_index) const {
+  auto it = filters_.find(filter_index);
+  return it != filters_.end() && it->second.offloaded;
+}
+
+std::vector<uint8_t> LeScanFilterEngine::GetOffloadedFilters() const {
+  std::vector<uint8_t> filter_indexes;
+  for (const auto& [filter_index, filter] : filters_) {
+    if (filter.offloaded) {
+      filter_indexes.push_back(filter_index);
+    }
+  }
+  return filter_indexes;
+}
+
+void LeScanFilterEngine::Compile() {
+  compiled_conditions_.clear();
+  compiled_addresses_.clear();
+  compiled_features_.clear();
+  compiled_filters_.clear();
+
+  for (const auto& [filter_index, filter] : filters_) {
+    CompiledFilter compiled_filter = {
+        // No threshold until the parameters are set
+        .rssi_threshold =
+            filter.has_parameters ? static_cast<int8_t>(filter.parameters.rssi_high_thresh) : static_cast<int8_t>(INT8_MIN),
+        .first_feature = compiled_features_.size(),
+        .num_features = 0,
+    };
+
+    // One feature per filter type, ordered by type
+    std::map<ApcfFilterType, size_t> features;
+    for (const auto& command : filter.conditions) {
+      uint16_t feature_bit = 1 << static_cast<uint8_t>(command.filter_type);
+      if (filter.has_parameters && (filter.parameters.feature_selection & feature_bit) == 0) {
+        continue;
+      }
+      if (command.filter_type != ApcfFilterType::BROADCASTER_ADDRESS && ad_types_of(command).empty()) {
+        continue;
+      }
+      auto [feature, inserted] = features.emplace(command.filter_type, compiled_features_.size());
+      if (inserted) {
+        compiled_features_.push_back(
+            {.or_logic = filter.has_parameters && (filter.parameters.list_logic_type & feature_bit) != 0});
+        compiled_filter.num_features++;
+      }
+      if (command.filter_type == ApcfFilterType::BROADCASTER_ADDRESS) {
+        compiled_addresses_.emplace_back(command.address, feature->second);
+        continue;
+      }
+      for (uint8_t ad_type : ad_types_of(command)) {
+        compiled_conditions_.push_back({.ad_type = ad_type, .command = &command, .feature = feature->second});
+      }
+    }
+    compiled_filters_.push_back(compiled_filter);
+  }
+
+  std::stable_sort(
+      compiled_conditions_.begin(),
+      compiled_conditions_.end(),
+      [](const CompiledCondition& a, const CompiledCondition& b) { return a.ad_type < b.ad_type; });
+  size_t condition = 0;
+  for (size_t ad_type = 0; ad_type < first_condition_of_type_.size(); ad_type++) {
+    while (condition < compiled_conditions_.size() && compiled_conditions_[condition].ad_type < ad_type) {
+      condition++;
+    }
+    first_condition_of_type_[ad_type] = static_cast<uint16_t>(condition);
+  }
+  feature_matched_.assign(compiled_features_.size(), false);
+}
+
+bool LeScanFilterEngine::Matches(Address address, int8_t rssi, const std::vector<uint8_t>& advertising_data) {
+  if (!enabled_ || !HasHostFilters()) {
+    return true;
+  }
+
+  std::fill(feature_matched_.begin(), feature_matched_.end(), false);
+  for (const auto& [filter_address, feature] : compiled_addresses_) {
+    if (filter_address == address) {
+      feature_matched_[feature] = true;
+    }
+  }
+
+  // Walk the advertising data once, evaluating the conditions on each field
+  const uint8_t* data = advertising_data.data();
+  size_t position = 0;
+  while (position < advertising_data.size()) {
+    uint8_t length = data[position];
+    if (length == 0 || position + length >= advertising_data.size()) {
+      break;
+    }
+    uint8_t ad_type = data[position + 1];
+    for (size_t i = first_condition_of_type_[ad_type]; i < first_condition_of_type_[ad_type + 1]; i++) {
+      const CompiledCondition& condition = compiled_conditions_[i];
+      if (!feature_matched_[condition.feature] &&
+          condition_matches(*condition.command, data + position + 2, length - 1)) {
+        feature_matched_[condition.feature] = true;
+      }
+    }
+    position += length + 1;
+  }
+
+  for (const auto& filter : compiled_filters_) {
+    if (rssi < filter.rssi_threshold) {
+      continue;
+    }
+    bool and_matched = true;
+    bool has_or_features = false;
+    bool or_matched = false;
+    for (size_t i = filter.first_feature; i < filter.first_feature + filter.num_features; i++) {
+      if (compiled_features_[i].or_logic) {
+        has_or_features = true;
+        or_matched = or_matched || feature_matched_[i];
+      } else {
+        and_matched = and_matched && feature_matched_[i];
+      }
+    }
+    if (and_matched && (!has_or_features || or_matched)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/le_scanning_callback.h"
+
+namespace bluetooth::hci {
+
+/// The LE scan filter engine keeps the advertising packet content filters
+/// (APCF) of every filter index, and decides which of them are offloaded to
+/// the controller. A filter index is offloaded when the controller supports
+/// the features of all its conditions and has room for it; the others are
+/// evaluated on the host against the complete advertising reports.
+///
+/// A controller only reports what its own filters match, so as soon as one
+/// filter index is evaluated on the host, controller filtering has to be
+/// turned off and every filter index is evaluated on the host.
+class LeScanFilterEngine {
+ public:
+  /// Set how many filter indexes the controller holds, zero when it
+  /// doesn't support filtering. Forgets all the filters.
+  void SetControllerCapacity(size_t max_offloaded_filters) {
+    max_offloaded_filters_ = max_offloaded_filters;
+    Clear();
+  }
+
+  /// Set the parameters of a filter index, creating it if needed. Returns
+  /// true if the filter index is offloaded.
+  bool SetParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameters);
+
+  /// Add conditions to a filter index, creating it if needed. Returns true if
+  /// the filter index is offloaded; false if it is now evaluated on the host
+  /// because the controller is full or doesn't support the conditions.
+  bool AddConditions(
+      uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions, bool can_offload);
+
+  /// Remove a filter index with its conditions.
+  void Remove(uint8_t filter_index);
+
+  /// Remove all the filter indexes.
+  void Clear();
+
+  void SetEnabled(bool enabled) {
+    enabled_ = enabled;
+  }
+
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  bool IsOffloaded(uint8_t filter_index) const;
+
+  /// The filter indexes offloaded to the controller, in increasing order.
+  std::vector<uint8_t> GetOffloadedFilters() const;
+
+  /// True when at least one filter index is evaluated on the host.
+  bool HasHostFilters() const {
+    return num_host_filters_ != 0;
+  }
+
+  /// Returns true if the complete advertising report must be reported: when
+  /// filtering is disabled, left to the controller, or one of the filter
+  /// indexes matches it.
+  bool Matches(Address address, int8_t rssi, const std::vector<uint8_t>& advertising_data);
+
+ private:
+  struct Filter {
+    bool offloaded;
+    bool has_parameters;
+    AdvertisingFilterParameter parameters;
+    std::vector<AdvertisingPacketContentFilterCommand> conditions;
+  };
+
+  Filter& GetOrCreate(uint8_t filter_index);
+  void SetOffloaded(Filter& filter, bool offloaded);
+
+  /// Rebuild the decision tables below from the filters.
+  void Compile();
+
+  /// A condition on the fields of one AD type, with the index of the filter
+  /// feature it belongs to in compiled_features_.
+  struct CompiledCondition {
+    uint8_t ad_type;
+    const AdvertisingPacketContentFilterCommand* command;
+    size_t feature;
+  };
+
+  /// The conditions of one type of a filter index; it matches when any of
+  /// them does, or_logic tells how it combines with the other features.
+  struct CompiledFeature {
+    bool or_logic;
+  };
+
+  struct CompiledFilter {
+    int8_t rssi_threshold;
+    size_t first_feature;
+    size_t num_features;
+  };
+
+  size_t max_offloaded_filters_ = 0;
+  size_t num_offloaded_filters_ = 0;
+  size_t num_host_filters_ = 0;
+  bool enabled_ = false;
+  std::map<uint8_t, Filter> filters_;
+
+  /// The conditions sorted by AD type, with the range of the conditions of
+  /// each type, so that a single walk over the advertising data evaluates
+  /// only the conditions on the fields it contains.
+  std::vector<CompiledCondition> compiled_conditions_;
+  std::array<uint16_t, 257> first_condition_of_type_{};
+  /// Broadcaster address conditions, which don't look at the data.
+  std::vector<std::pair<Address, size_t>> compiled_addresses_;
+  std::vector<CompiledFeature> compiled_features_;
+  std::vector<CompiledFilter> compiled_filters_;
+  /// Scratch space of Matches, one entry per compiled feature.
+  std::vector<bool> feature_matched_;
+};
+
+}  // namespace bluetooth::hci
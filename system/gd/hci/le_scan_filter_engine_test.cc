@@ -0,0 +1,179 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scan_filter_engine.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+const Address kAddress({0x00, 0x11, 0x22, 0x33, 0x44, 0x55});
+const Address kOtherAddress({0x00, 0x11, 0x22, 0x33, 0x44, 0x66});
+
+// Flags, complete 16 bit UUIDs 0x180f and 0xfe2c, manufacturer 0x00e0 data
+// and the complete local name "Tag"
+const std::vector<uint8_t> kAdvertisingData = {
+    0x02, 0x01, 0x06, 0x05, 0x03, 0x0f, 0x18, 0x2c, 0xfe, 0x05,
+    0xff, 0xe0, 0x00, 0x01, 0x02, 0x04, 0x09, 0x54, 0x61, 0x67};
+
+constexpr uint16_t kFeatureAddress = 1 << static_cast<uint8_t>(ApcfFilterType::BROADCASTER_ADDRESS);
+constexpr uint16_t kFeatureServiceUuid = 1 << static_cast<uint8_t>(ApcfFilterType::SERVICE_UUID);
+constexpr uint16_t kFeatureLocalName = 1 << static_cast<uint8_t>(ApcfFilterType::LOCAL_NAME);
+
+AdvertisingPacketContentFilterCommand address_filter(Address address) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::BROADCASTER_ADDRESS;
+  command.address = address;
+  return command;
+}
+
+AdvertisingPacketContentFilterCommand uuid_filter(Uuid uuid) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::SERVICE_UUID;
+  command.uuid = uuid;
+  command.uuid_mask = Uuid::kEmpty;
+  return command;
+}
+
+AdvertisingPacketContentFilterCommand name_filter(std::string name) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::LOCAL_NAME;
+  command.name = std::vector<uint8_t>(name.begin(), name.end());
+  return command;
+}
+
+AdvertisingPacketContentFilterCommand manufacturer_filter(
+    uint16_t company, std::vector<uint8_t> data, std::vector<uint8_t> data_mask) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::MANUFACTURER_DATA;
+  command.company = company;
+  command.data = data;
+  command.data_mask = data_mask;
+  return command;
+}
+
+AdvertisingFilterParameter parameters(uint16_t feature_selection, uint16_t list_logic_type, int8_t rssi_threshold) {
+  AdvertisingFilterParameter parameters{};
+  parameters.feature_selection = feature_selection;
+  parameters.list_logic_type = list_logic_type;
+  parameters.rssi_high_thresh = static_cast<uint8_t>(rssi_threshold);
+  return parameters;
+}
+
+TEST(LeScanFilterEngineTest, filters_are_offloaded_while_the_controller_has_room) {
+  LeScanFilterEngine engine;
+  engine.SetControllerCapacity(2);
+  ASSERT_TRUE(engine.AddConditions(1, {address_filter(kAddress)}, true));
+  ASSERT_TRUE(engine.AddConditions(2, {name_filter("Tag")}, true));
+  ASSERT_FALSE(engine.HasHostFilters());
+  ASSERT_FALSE(engine.AddConditions(3, {name_filter("Other")}, true));
+  ASSERT_TRUE(engine.HasHostFilters());
+  ASSERT_EQ(engine.GetOffloadedFilters(), std::vector<uint8_t>({1, 2}));
+
+  // Conditions the controller can't evaluate bring their filter to the host
+  ASSERT_FALSE(engine.AddConditions(2, {uuid_filter(Uuid::From16Bit(0x180f))}, false));
+  ASSERT_EQ(engine.GetOffloadedFilters(), std::vector<uint8_t>({1}));
+
+  engine.Remove(2);
+  engine.Remove(3);
+  ASSERT_FALSE(engine.HasHostFilters());
+  ASSERT_TRUE(engine.AddConditions(4, {name_filter("Tag")}, true));
+}
+
+TEST(LeScanFilterEngineTest, reports_are_not_filtered_by_the_host_without_host_filters) {
+  LeScanFilterEngine engine;
+  engine.SetControllerCapacity(1);
+  engine.SetEnabled(true);
+  engine.AddConditions(1, {name_filter("Other")}, true);
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+
+  engine.AddConditions(2, {name_filter("Other")}, true);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.SetEnabled(false);
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+}
+
+TEST(LeScanFilterEngineTest, conditions_on_advertising_data) {
+  LeScanFilterEngine engine;
+  engine.SetEnabled(true);
+
+  engine.AddConditions(1, {uuid_filter(Uuid::From16Bit(0x1812))}, false);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.AddConditions(2, {uuid_filter(Uuid::From16Bit(0xfe2c))}, false);
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.Clear();
+
+  engine.AddConditions(1, {name_filter("Ta")}, false);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.AddConditions(1, {name_filter("Tag")}, false);
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.Clear();
+
+  engine.AddConditions(1, {manufacturer_filter(0x00e0, {0x01, 0x03}, {0xff, 0xff})}, false);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.AddConditions(2, {manufacturer_filter(0x00e0, {0x01, 0x03}, {0xff, 0xfc})}, false);
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+  engine.Clear();
+
+  engine.AddConditions(1, {address_filter(kOtherAddress)}, false);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  ASSERT_TRUE(engine.Matches(kOtherAddress, -50, {}));
+}
+
+TEST(LeScanFilterEngineTest, features_are_combined_with_the_list_logic) {
+  LeScanFilterEngine engine;
+  engine.SetEnabled(true);
+  engine.AddConditions(1, {address_filter(kOtherAddress), name_filter("Tag")}, false);
+
+  // Both features have to match by default
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  ASSERT_TRUE(engine.Matches(kOtherAddress, -50, kAdvertisingData));
+
+  engine.SetParameters(1, parameters(kFeatureAddress | kFeatureLocalName, kFeatureAddress | kFeatureLocalName, -127));
+  ASSERT_TRUE(engine.Matches(kAddress, -50, kAdvertisingData));
+  ASSERT_FALSE(engine.Matches(kAddress, -50, {}));
+
+  // Features left out of the selection are ignored
+  engine.SetParameters(1, parameters(kFeatureAddress | kFeatureServiceUuid, 0, -127));
+  ASSERT_FALSE(engine.Matches(kAddress, -50, kAdvertisingData));
+  ASSERT_TRUE(engine.Matches(kOtherAddress, -50, {}));
+
+  // Reports below the RSSI threshold are dropped
+  engine.SetParameters(1, parameters(kFeatureAddress, 0, -60));
+  ASSERT_TRUE(engine.Matches(kOtherAddress, -50, {}));
+  ASSERT_FALSE(engine.Matches(kOtherAddress, -70, {}));
+
+  // A filter without any condition lets everything through
+  engine.SetParameters(2, parameters(0, 0, -127));
+  ASSERT_TRUE(engine.Matches(kAddress, -70, {}));
+}
+
+TEST(LeScanFilterEngineTest, malformed_advertising_data) {
+  LeScanFilterEngine engine;
+  engine.SetEnabled(true);
+  engine.AddConditions(1, {name_filter("Tag")}, false);
+  ASSERT_FALSE(engine.Matches(kAddress, -50, {0x05, 0x09, 0x54, 0x61, 0x67}));
+  ASSERT_FALSE(engine.Matches(kAddress, -50, {0x00, 0x04, 0x09, 0x54, 0x61, 0x67}));
+  ASSERT_FALSE(engine.Matches(kAddress, -50, {0x01}));
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
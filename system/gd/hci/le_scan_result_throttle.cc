@@ -0,0 +1,57 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/le_scan_result_throttle.h"
+
+#include <cstdlib>
+#include <string_view>
+
+namespace bluetooth::hci {
+
+bool LeScanResultThrottle::ShouldReport(
+    uint8_t address_type,
+    Address address,
+    uint8_t advertising_sid,
+    int8_t rssi,
+    const std::vector<uint8_t>& advertising_data,
+    std::chrono::steady_clock::time_point now) {
+  uint64_t key = 0;
+  for (size_t i = 0; i < Address::kLength; i++) {
+    key = (key << 8) | address.address[i];
+  }
+  key = (key << 16) | (address_type << 8) | advertising_sid;
+
+  size_t data_hash = std::hash<std::string_view>{}(
+      std::string_view(reinterpret_cast<const char*>(advertising_data.data()), advertising_data.size()));
+
+  auto it = reported_advertisers_.find(key);
+  if (it != reported_advertisers_.end()) {
+    const ReportedAdvertiser& reported = it->second;
+    bool interval_elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - reported.time) >= parameters_.report_interval;
+    bool data_changed = parameters_.report_on_data_change && data_hash != reported.data_hash;
+    bool rssi_changed = parameters_.rssi_delta != 0 && std::abs(rssi - reported.rssi) >= parameters_.rssi_delta;
+    if (!interval_elapsed && !data_changed && !rssi_changed) {
+      return false;
+    }
+  } else if (reported_advertisers_.size() >= kMaximumReportedAdvertisers) {
+    reported_advertisers_.clear();
+  }
+
+  reported_advertisers_[key] = {now, data_hash, rssi};
+  return true;
+}
+
+}  // namespace bluetooth::hci
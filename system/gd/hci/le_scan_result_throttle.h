@@ -0,0 +1,79 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// Which of the advertising reports of an advertiser a scanner needs.
+/// The default parameters report every advertisement.
+struct ScanResultThrottleParameters {
+  /// Minimum time between two reports of the same advertiser.
+  /// Zero reports every advertisement, max() only the first one.
+  std::chrono::milliseconds report_interval{0};
+  /// Report an advertiser again as soon as its advertising data changes.
+  bool report_on_data_change{false};
+  /// Report an advertiser again as soon as its RSSI moved by at least this
+  /// many dB from the last reported value, zero to ignore RSSI changes.
+  uint8_t rssi_delta{0};
+};
+
+/// The LE scan result throttle drops the complete advertising reports
+/// a scanner is not interested in, before they are sent to the upper layers.
+/// Advertisers are told apart by address, address type and advertising SID.
+class LeScanResultThrottle {
+ public:
+  explicit LeScanResultThrottle(ScanResultThrottleParameters parameters) : parameters_(parameters) {}
+
+  /// Returns true if the advertising report received at time now must be
+  /// reported, in which case it becomes the last reported one of its advertiser.
+  bool ShouldReport(
+      uint8_t address_type,
+      Address address,
+      uint8_t advertising_sid,
+      int8_t rssi,
+      const std::vector<uint8_t>& advertising_data,
+      std::chrono::steady_clock::time_point now);
+
+  /// Forget the advertisers reported so far.
+  void Reset() {
+    reported_advertisers_.clear();
+  }
+
+ private:
+  ScanResultThrottleParameters parameters_;
+
+  /// The last report of an advertiser.
+  struct ReportedAdvertiser {
+    std::chrono::steady_clock::time_point time;
+    size_t data_hash;
+    int8_t rssi;
+  };
+
+  /// Reported advertisers indexed by address, address type and SID packed
+  /// in 64 bits. All of them are forgotten once kMaximumReportedAdvertisers
+  /// are tracked, so that busy environments do not grow it without bound.
+  static constexpr size_t kMaximumReportedAdvertisers = 1024;
+  std::unordered_map<uint64_t, ReportedAdvertiser> reported_advertisers_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scan_result_throttle.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+static constexpr uint8_t kPublic = 0x00;
+static constexpr uint8_t kRandom = 0x01;
+static constexpr uint8_t kSidNotPresent = 0xff;
+
+static const Address kTestAddress = Address({0, 1, 2, 3, 4, 5});
+static const Address kOtherAddress = Address({5, 4, 3, 2, 1, 0});
+static const std::vector<uint8_t> kData = {0x2, 0x1, 0x6};
+static const std::vector<uint8_t> kOtherData = {0x2, 0x1, 0x4};
+
+class LeScanResultThrottleTest : public ::testing::Test {
+ protected:
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+TEST_F(LeScanResultThrottleTest, default_parameters_report_everything) {
+  LeScanResultThrottle throttle({});
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+  }
+}
+
+TEST_F(LeScanResultThrottleTest, first_report_only) {
+  LeScanResultThrottle throttle({.report_interval = std::chrono::milliseconds::max()});
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -40, kOtherData, start_ + 1h));
+
+  // Advertisers are told apart by address, address type and SID
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kOtherAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_TRUE(throttle.ShouldReport(kRandom, kTestAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, 0x1, -50, kData, start_));
+
+  throttle.Reset();
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+}
+
+TEST_F(LeScanResultThrottleTest, report_interval) {
+  LeScanResultThrottle throttle({.report_interval = 100ms});
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 99ms));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 100ms));
+  // The interval runs from the last report
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 150ms));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 200ms));
+}
+
+TEST_F(LeScanResultThrottleTest, report_on_data_change) {
+  LeScanResultThrottle throttle(
+      {.report_interval = std::chrono::milliseconds::max(), .report_on_data_change = true});
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 1ms));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kOtherData, start_ + 2ms));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kOtherData, start_ + 3ms));
+}
+
+TEST_F(LeScanResultThrottleTest, rssi_delta) {
+  LeScanResultThrottle throttle({.report_interval = std::chrono::milliseconds::max(), .rssi_delta = 10});
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -59, kData, start_ + 1ms));
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -41, kData, start_ + 2ms));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -60, kData, start_ + 3ms));
+  // The delta is measured from the last reported RSSI
+  ASSERT_FALSE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -51, kData, start_ + 4ms));
+  ASSERT_TRUE(throttle.ShouldReport(kPublic, kTestAddress, kSidNotPresent, -50, kData, start_ + 5ms));
+}
+
+}  // namespace bluetooth::hci
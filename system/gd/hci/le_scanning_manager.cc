@@ -15,7 +15,10 @@
  */
 #include "hci/le_scanning_manager.h"
 
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include "hci/acl_manager.h"
@@ -23,6 +26,8 @@
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "hci/le_periodic_sync_manager.h"
+#include "hci/le_scan_filter_engine.h"
+#include "hci/le_scan_result_throttle.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/le_scanning_reassembler.h"
 #include "hci/vendor_specific_event_manager.h"
@@ -71,6 +76,7 @@ enum class ScanApiType {
 struct Scanner {
   Uuid app_uuid;
   bool in_use;
+  std::optional<LeScanResultThrottle> result_throttle;
 };
 
 class NullScanningCallback : public ScanningCallback {
@@ -188,7 +194,11 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     le_address_manager_ = acl_manager->GetLeAddressManager();
     le_scanning_interface_ = hci_layer_->GetLeScanningInterface(
         module_handler_->BindOn(this, &LeScanningManager::impl::handle_scan_results));
-    periodic_sync_manager_.Init(le_scanning_interface_, module_handler_);
+    uint8_t periodic_advertiser_list_size = 0;
+    if (controller_->IsSupported(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISER_LIST)) {
+      periodic_advertiser_list_size = controller_->GetLePeriodicAdvertiserListSize();
+    }
+    periodic_sync_manager_.Init(le_scanning_interface_, module_handler_, periodic_advertiser_list_size);
     /* Check to see if the opcode is supported and C19 (support for extended advertising). */
     if (controller_->IsSupported(OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS) &&
         controller->SupportsBleExtendedAdvertising()) {
@@ -201,6 +211,11 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       api_type_ = ScanApiType::LEGACY;
     }
     is_filter_supported_ = controller_->IsSupported(OpCode::LE_ADV_FILTER);
+    if (is_filter_supported_) {
+      // Controllers not telling how many filters they hold are not limited
+      size_t max_filter = controller->GetVendorCapabilities().max_filter_;
+      scan_filter_engine_.SetControllerCapacity(max_filter != 0 ? max_filter : std::numeric_limits<size_t>::max());
+    }
     if (os::GetSystemProperty(kPropertyDisableApcfExtendedFeatures) == "1")
       kDisableApcfExtendedFeatures = true;
     if (is_filter_supported_ && !kDisableApcfExtendedFeatures) {
@@ -452,6 +467,15 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
           break;
       }
 
+      int8_t calibrated_rssi = get_rssi_after_calibration(rssi);
+      if (!scan_filter_engine_.Matches(address, calibrated_rssi, complete_advertising_data.value())) {
+        return;
+      }
+      if (!should_report_scan_result(
+              address_type, address, advertising_sid, calibrated_rssi, complete_advertising_data.value())) {
+        return;
+      }
+
       scanning_callbacks_->OnScanResult(
           event_type,
           address_type,
@@ -460,12 +484,38 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
           secondary_phy,
           advertising_sid,
           tx_power,
-          get_rssi_after_calibration(rssi),
+          calibrated_rssi,
           periodic_advertising_interval,
           complete_advertising_data.value());
     }
   }
 
+  // Scan results are not sent per scanner, a result is reported
+  // as soon as one of the registered scanners wants it.
+  bool should_report_scan_result(
+      uint8_t address_type,
+      Address address,
+      uint8_t advertising_sid,
+      int8_t rssi,
+      const std::vector<uint8_t>& advertising_data) {
+    auto now = std::chrono::steady_clock::now();
+    bool throttled = false;
+    bool report = false;
+    for (auto& scanner : scanners_) {
+      if (!scanner.in_use) {
+        continue;
+      }
+      if (!scanner.result_throttle.has_value()) {
+        return true;
+      }
+      throttled = true;
+      // Each throttle tracks the results its scanner gets, so they are all asked
+      report |=
+          scanner.result_throttle->ShouldReport(address_type, address, advertising_sid, rssi, advertising_data, now);
+    }
+    return report || !throttled;
+  }
+
   void configure_scan() {
     std::vector<PhyScanParameters> parameter_vector;
     PhyScanParameters phy_scan_parameters;
@@ -540,6 +590,7 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     if (scanners_[scanner_id].in_use) {
       scanners_[scanner_id].in_use = false;
       scanners_[scanner_id].app_uuid = Uuid::kEmpty;
+      scanners_[scanner_id].result_throttle.reset();
     } else {
       LOG_WARN("Unregister scanner with unused scanner id");
     }
@@ -547,6 +598,12 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan(bool start) {
     if (start) {
+      // Every advertiser is reported again in a new scan
+      for (auto& scanner : scanners_) {
+        if (scanner.result_throttle.has_value()) {
+          scanner.result_throttle->Reset();
+        }
+      }
       configure_scan();
       start_scan();
     } else {
@@ -642,22 +699,66 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     scanning_callbacks_->OnSetScannerParameterComplete(scanner_id, ScanningCallback::SUCCESS);
   }
 
+  void set_scan_result_throttle(ScannerId scanner_id, ScanResultThrottleParameters parameters) {
+    if (scanner_id <= 0 || scanner_id > kMaxAppNum || !scanners_[scanner_id].in_use) {
+      LOG_WARN("Invalid scanner id %d", scanner_id);
+      return;
+    }
+    scanners_[scanner_id].result_throttle.emplace(parameters);
+  }
+
   void set_scan_filter_policy(LeScanningFilterPolicy filter_policy) {
     filter_policy_ = filter_policy;
   }
 
   void scan_filter_enable(bool enable) {
-    if (!is_filter_supported_) {
-      LOG_WARN("Advertising filter is not supported");
+    Enable apcf_enable = enable ? Enable::ENABLED : Enable::DISABLED;
+    scan_filter_engine_.SetEnabled(enable);
+    if (!is_filter_supported_ || scan_filter_engine_.HasHostFilters()) {
+      LOG_INFO("Advertising filters are evaluated on the host");
+      update_controller_filtering();
+      scanning_callbacks_->OnFilterEnable(apcf_enable, static_cast<uint8_t>(ErrorCode::SUCCESS));
       return;
     }
 
-    Enable apcf_enable = enable ? Enable::ENABLED : Enable::DISABLED;
+    controller_filtering_enabled_ = enable;
     le_scanning_interface_->EnqueueCommand(
         LeAdvFilterEnableBuilder::Create(apcf_enable),
         module_handler_->BindOnceOn(this, &impl::on_advertising_filter_complete));
   }
 
+  // The controller only reports what its own filters match, so it can't filter
+  // while some filters are evaluated on the host
+  void update_controller_filtering() {
+    bool enable = scan_filter_engine_.IsEnabled() && !scan_filter_engine_.HasHostFilters();
+    if (!is_filter_supported_ || enable == controller_filtering_enabled_) {
+      return;
+    }
+    controller_filtering_enabled_ = enable;
+    le_scanning_interface_->EnqueueCommand(
+        LeAdvFilterEnableBuilder::Create(enable ? Enable::ENABLED : Enable::DISABLED),
+        module_handler_->BindOnceOn(this, &impl::on_host_filtering_complete));
+  }
+
+  bool can_offload_filter(const AdvertisingPacketContentFilterCommand& filter) {
+    switch (filter.filter_type) {
+      case ApcfFilterType::BROADCASTER_ADDRESS:
+      case ApcfFilterType::SERVICE_UUID:
+      case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      case ApcfFilterType::LOCAL_NAME:
+      case ApcfFilterType::MANUFACTURER_DATA:
+      case ApcfFilterType::SERVICE_DATA:
+        return true;
+      case ApcfFilterType::TRANSPORT_DISCOVERY_DATA:
+        return is_transport_discovery_data_filter_supported_ ||
+               controller_->GetLocalVersionInformation().manufacturer_name_ == LMP_COMPID_QTI;
+      case ApcfFilterType::AD_TYPE:
+        return is_ad_type_filter_supported_;
+      default:
+        return false;
+    }
+  }
+
   bool is_bonded(Address target_address) {
     for (auto device : storage_module_->GetBondedDevices()) {
       if (device.GetAddress() == target_address) {
@@ -671,8 +772,25 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
-    if (!is_filter_supported_) {
-      LOG_WARN("Advertising filter is not supported");
+    bool offloaded = false;
+    switch (action) {
+      case ApcfAction::ADD:
+        offloaded = scan_filter_engine_.SetParameters(filter_index, advertising_filter_parameter);
+        break;
+      case ApcfAction::DELETE:
+        offloaded = scan_filter_engine_.IsOffloaded(filter_index);
+        scan_filter_engine_.Remove(filter_index);
+        break;
+      case ApcfAction::CLEAR:
+        offloaded = is_filter_supported_;
+        scan_filter_engine_.Clear();
+        break;
+      default:
+        break;
+    }
+    update_controller_filtering();
+    if (!offloaded) {
+      scanning_callbacks_->OnFilterParamSetup(0, action, static_cast<uint8_t>(ErrorCode::SUCCESS));
       return;
     }
 
@@ -734,8 +852,23 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   }
 
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
-    if (!is_filter_supported_) {
-      LOG_WARN("Advertising filter is not supported");
+    bool can_offload = is_filter_supported_;
+    for (const auto& filter : filters) {
+      can_offload = can_offload && can_offload_filter(filter);
+    }
+    bool was_offloaded = scan_filter_engine_.IsOffloaded(filter_index);
+    if (!scan_filter_engine_.AddConditions(filter_index, filters, can_offload)) {
+      if (was_offloaded) {
+        // Its parameters are already in the controller
+        le_scanning_interface_->EnqueueCommand(
+            LeAdvFilterDeleteFilteringParametersBuilder::Create(filter_index),
+            module_handler_->BindOnceOn(this, &impl::on_host_filtering_complete));
+      }
+      update_controller_filtering();
+      for (const auto& filter : filters) {
+        scanning_callbacks_->OnFilterConfigCallback(
+            filter.filter_type, 0, ApcfAction::ADD, static_cast<uint8_t>(ErrorCode::SUCCESS));
+      }
       return;
     }
 
@@ -1463,6 +1596,20 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     }
   }
 
+  // Completion of the filter commands made on behalf of the host filtering,
+  // which the upper layers didn't ask for
+  void on_host_filtering_complete(CommandCompleteView view) {
+    ASSERT(view.IsValid());
+    auto status_view = LeAdvFilterCompleteView::Create(view);
+    ASSERT(status_view.IsValid());
+    if (status_view.GetStatus() != ErrorCode::SUCCESS) {
+      LOG_WARN(
+          "Got a Command complete %s, status %s",
+          OpCodeText(view.GetCommandOpCode()).c_str(),
+          ErrorCodeText(status_view.GetStatus()).c_str());
+    }
+  }
+
   void on_apcf_read_extended_features_complete(CommandCompleteView view) {
     ASSERT(view.IsValid());
     auto status_view = LeAdvFilterCompleteView::Create(view);
@@ -1640,6 +1787,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   bool paused_ = false;
   LeScanningReassembler scanning_reassembler_;
   bool is_filter_supported_ = false;
+  bool controller_filtering_enabled_ = false;
+  LeScanFilterEngine scan_filter_engine_;
   bool is_ad_type_filter_supported_ = false;
   bool is_batch_scan_supported_ = false;
   bool is_periodic_advertising_sync_transfer_sender_supported_ = false;
@@ -1810,6 +1959,10 @@ void LeScanningManager::SyncTxParameters(
   CallOn(pimpl_.get(), &impl::sync_tx_parameters, address, mode, skip, timeout, reg_id);
 }
 
+void LeScanningManager::SetScanResultThrottle(ScannerId scanner_id, ScanResultThrottleParameters parameters) {
+  CallOn(pimpl_.get(), &impl::set_scan_result_throttle, scanner_id, parameters);
+}
+
 void LeScanningManager::TrackAdvertiser(uint8_t filter_index, ScannerId scanner_id) {
   CallOn(pimpl_.get(), &impl::track_advertiser, filter_index, scanner_id);
 }
@@ -20,6 +20,7 @@
 #include "common/callback.h"
 #include "hci/address_with_type.h"
 #include "hci/hci_packets.h"
+#include "hci/le_scan_result_throttle.h"
 #include "hci/le_scanning_callback.h"
 #include "hci/uuid.h"
 #include "module.h"
@@ -56,6 +57,9 @@ class LeScanningManager : public bluetooth::Module {
 
   virtual void SetScanFilterPolicy(LeScanningFilterPolicy filter_policy);
 
+  /* Drop the scan results the scanner does not need */
+  virtual void SetScanResultThrottle(ScannerId scanner_id, ScanResultThrottleParameters parameters);
+
   /* Scan filter */
   virtual void ScanFilterEnable(bool enable);
 
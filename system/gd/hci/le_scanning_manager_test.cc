@@ -362,6 +362,28 @@ TEST_F(LeScanningManagerTest, start_scan_test) {
   test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report}));
 }
 
+TEST_F(LeScanningManagerTest, scan_result_throttle_test) {
+  start_le_scanning_manager();
+
+  Uuid app_uuid = Uuid::From16Bit(0x1234);
+  EXPECT_CALL(mock_callbacks_, OnScannerRegistered(app_uuid, 1, ScanningCallback::ScanningStatus::SUCCESS));
+  le_scanning_manager->RegisterScanner(app_uuid);
+  le_scanning_manager->SetScanResultThrottle(1, {.report_interval = std::chrono::milliseconds::max()});
+
+  le_scanning_manager->Scan(true);
+  ASSERT_EQ(OpCode::LE_SET_SCAN_PARAMETERS, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // Only the first report of the advertiser is wanted
+  LeAdvertisingResponse report = make_advertising_report();
+  EXPECT_CALL(mock_callbacks_, OnScanResult).Times(1);
+  test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report}));
+  test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report}));
+  sync_client_handler();
+}
+
 TEST_F(LeScanningManagerTest, is_ad_type_filter_supported_false_test) {
   start_le_scanning_manager();
   ASSERT_TRUE(fake_registry_.IsStarted(&HciLayer::Factory));
@@ -377,6 +399,34 @@ TEST_F(LeScanningManagerTest, scan_filter_add_ad_type_not_supported_test) {
   le_scanning_manager->ScanFilterAdd(0x01, filters);
 }
 
+TEST_F(LeScanningManagerTest, scan_filter_evaluated_on_host_test) {
+  start_le_scanning_manager();
+
+  // Without controller support the filters are evaluated on the host
+  AdvertisingPacketContentFilterCommand filter{};
+  filter.filter_type = ApcfFilterType::BROADCASTER_ADDRESS;
+  Address::FromString("12:34:56:78:9a:bc", filter.address);
+  EXPECT_CALL(mock_callbacks_, OnFilterConfigCallback(ApcfFilterType::BROADCASTER_ADDRESS, _, ApcfAction::ADD, _));
+  EXPECT_CALL(mock_callbacks_, OnFilterEnable(Enable::ENABLED, _));
+  le_scanning_manager->ScanFilterAdd(0x01, {filter});
+  le_scanning_manager->ScanFilterEnable(true);
+
+  le_scanning_manager->Scan(true);
+  ASSERT_EQ(OpCode::LE_SET_SCAN_PARAMETERS, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_SET_SCAN_ENABLE, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // Only the report of the filtered advertiser goes through
+  LeAdvertisingResponse report = make_advertising_report();
+  LeAdvertisingResponse other_report = make_advertising_report();
+  Address::FromString("12:34:56:78:9a:bd", other_report.address_);
+  EXPECT_CALL(mock_callbacks_, OnScanResult).Times(1);
+  test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({other_report}));
+  test_hci_layer_->IncomingLeMetaEvent(LeAdvertisingReportBuilder::Create({report}));
+  sync_client_handler();
+}
+
 TEST_F(LeScanningManagerAndroidHciTest, startup_teardown) {}
 
 TEST_F(LeScanningManagerAndroidHciTest, start_scan_test) {
@@ -15,6 +15,7 @@
  */
 #include "hci/le_scanning_reassembler.h"
 
+#include <iterator>
 #include <memory>
 #include <unordered_map>
 
@@ -69,11 +70,6 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
   std::list<AdvertisingFragment>::iterator advertising_fragment =
       AppendFragment(key, advertising_data);
 
-  // Trim the advertising data when the complete payload is received.
-  if (data_status != DataStatus::CONTINUING) {
-    advertising_fragment->data = TrimAdvertisingData(advertising_fragment->data);
-  }
-
   // TODO(b/272120114) waiting for a scan response here is prone to failure as the
   // SCAN_REQ PDUs can be rejected by the advertiser according to the
   // advertising filter parameter.
@@ -83,14 +79,20 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessAdvertisingRep
   // - For legacy advertising, when a scan response is expected.
   // - For extended advertising, when the current data is marked
   //   incomplete OR when a scan response is expected.
-  if (data_status == DataStatus::CONTINUING || expect_scan_response) {
+  if (data_status == DataStatus::CONTINUING) {
+    return {};
+  }
+
+  // Trim the advertising data when the complete payload is received.
+  std::vector<uint8_t> complete_advertising_data = TrimAdvertisingData(advertising_fragment->data);
+  if (expect_scan_response) {
+    advertising_fragment->data.assign(complete_advertising_data.begin(), complete_advertising_data.end());
     return {};
   }
 
   // Otherwise the full advertising report has been reassembled,
   // removed the cache entry and return the complete advertising data.
-  std::vector<uint8_t> complete_advertising_data = std::move(advertising_fragment->data);
-  cache_.erase(advertising_fragment);
+  EraseFragment(advertising_fragment);
   return complete_advertising_data;
 }
 
@@ -132,42 +134,55 @@ LeScanningReassembler::AdvertisingKey::AdvertisingKey(
   }
 }
 
-bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) {
+bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& other) const {
   return address == other.address && sid == other.sid;
 }
 
 /// Append to the current advertising data of the selected advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
-/// dropping the oldest advertiser.
+/// dropping the least recently used advertiser.
 std::list<LeScanningReassembler::AdvertisingFragment>::iterator
 LeScanningReassembler::AppendFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data) {
   auto it = FindFragment(key);
   if (it != cache_.end()) {
     it->data.insert(it->data.end(), data.cbegin(), data.cend());
+    cache_.splice(cache_.begin(), cache_, it);
     return it;
   }
 
-  if (cache_.size() > kMaximumCacheSize) {
-    cache_.pop_back();
+  if (cache_.size() >= kMaximumCacheSize) {
+    EraseFragment(std::prev(cache_.end()));
   }
 
-  cache_.emplace_front(key, data);
+  if (free_fragments_.empty()) {
+    free_fragments_.emplace_front(key, std::vector<uint8_t>());
+    free_fragments_.front().data.reserve(kMaximumAdvertisingDataLength);
+  }
+  cache_.splice(cache_.begin(), free_fragments_, free_fragments_.begin());
+  cache_.front().key = key;
+  cache_.front().data.assign(data.cbegin(), data.cend());
   return cache_.begin();
 }
 
 void LeScanningReassembler::RemoveFragment(const AdvertisingKey& key) {
   auto it = FindFragment(key);
   if (it != cache_.end()) {
-    cache_.erase(it);
+    EraseFragment(it);
   }
 }
 
+void LeScanningReassembler::EraseFragment(std::list<AdvertisingFragment>::iterator it) {
+  free_fragments_.splice(free_fragments_.begin(), cache_, it);
+}
+
 bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) {
   return FindFragment(key) != cache_.end();
 }
 
 std::list<LeScanningReassembler::AdvertisingFragment>::iterator LeScanningReassembler::FindFragment(
     const AdvertisingKey& key) {
+  // The cache is small and the advertisers looked up are usually the most
+  // recent ones, a linear search from the front beats hashing the key.
   for (auto it = cache_.begin(); it != cache_.end(); it++) {
     if (it->key == key) {
       return it;
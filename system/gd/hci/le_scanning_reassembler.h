@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <list>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "hci/address_with_type.h"
@@ -83,7 +84,7 @@ class LeScanningReassembler {
     std::optional<uint8_t> sid;
 
     AdvertisingKey(Address address, DirectAdvertisingAddressType address_type, uint8_t sid);
-    bool operator==(const AdvertisingKey& other);
+    bool operator==(const AdvertisingKey& other) const;
   };
 
   /// Packs incomplete advertising data.
@@ -91,8 +92,7 @@ class LeScanningReassembler {
     AdvertisingKey key;
     std::vector<uint8_t> data;
 
-    AdvertisingFragment(const AdvertisingKey& key, const std::vector<uint8_t>& data)
-        : key(key), data(data.begin(), data.end()) {}
+    AdvertisingFragment(const AdvertisingKey& key, std::vector<uint8_t> data) : key(key), data(std::move(data)) {}
   };
 
   /// Advertising cache for de-fragmenting extended advertising reports,
@@ -100,13 +100,22 @@ class LeScanningReassembler {
   /// applicable.
   /// The cached advertising data is removed as soon as the complete
   /// advertisement is got (including the scan response).
+  /// The cache is kept in least recently used order, most recent first,
+  /// and the least recently used advertiser is dropped when it is full.
   static constexpr size_t kMaximumCacheSize = 16;
   std::list<AdvertisingFragment> cache_;
 
+  /// Removed cache entries, reused for the next advertisers along with
+  /// their buffer. The buffers are reserved for the largest extended
+  /// advertising data so that appending fragments does not reallocate.
+  static constexpr size_t kMaximumAdvertisingDataLength = 1650;
+  std::list<AdvertisingFragment> free_fragments_;
+
   /// Advertising cache management methods.
   std::list<AdvertisingFragment>::iterator AppendFragment(
       const AdvertisingKey& key, const std::vector<uint8_t>& data);
   void RemoveFragment(const AdvertisingKey& key);
+  void EraseFragment(std::list<AdvertisingFragment>::iterator it);
   bool ContainsFragment(const AdvertisingKey& key);
   std::list<AdvertisingFragment>::iterator FindFragment(const AdvertisingKey& key);
 
@@ -115,6 +124,7 @@ class LeScanningReassembler {
   static std::vector<uint8_t> TrimAdvertisingData(const std::vector<uint8_t>& advertising_data);
 
   FRIEND_TEST(LeScanningReassemblerTest, trim_advertising_data);
+  FRIEND_TEST(LeScanningReassemblerTest, least_recently_used_advertiser_is_dropped);
 };
 
 }  // namespace bluetooth::hci
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/le_scanning_reassembler.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+// Event type fields.
+constexpr uint16_t kScannable = 0x2;
+constexpr uint16_t kScanResponse = 0x8;
+constexpr uint16_t kLegacy = 0x10;
+constexpr uint16_t kComplete = 0x0;
+constexpr uint16_t kContinuation = 0x20;
+
+constexpr uint8_t kSidNotPresent = 0xff;
+
+// Number of advertisers the controller interleaves the reports of
+constexpr size_t kInterleavedAdvertisers = 8;
+
+struct AdvertisingReport {
+  uint16_t event_type;
+  uint8_t address_type;
+  Address address;
+  uint8_t sid;
+  std::vector<uint8_t> data;
+};
+
+// A single manufacturer specific data entry of the given size
+std::vector<uint8_t> make_data(size_t size, uint8_t fill) {
+  std::vector<uint8_t> data(size, fill);
+  data[0] = static_cast<uint8_t>(size - 1);
+  data[1] = 0xff;
+  return data;
+}
+
+// The reports of one advertiser, in the proportions seen when scanning a crowded place:
+// a quarter each of non scannable and scannable legacy advertisers, of extended advertisers
+// sending 600 bytes in three reports, and of extended advertisers fitting in a single report.
+std::vector<AdvertisingReport> advertiser_reports(size_t index) {
+  Address address({0x00, 0x11, 0x22, 0x33, static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index)});
+  uint8_t fill = static_cast<uint8_t>(index);
+  uint8_t sid = static_cast<uint8_t>(index % 16);
+  uint8_t random = static_cast<uint8_t>(AddressType::RANDOM_DEVICE_ADDRESS);
+  switch (index % 4) {
+    case 0:
+      return {{kLegacy | kComplete, random, address, kSidNotPresent, make_data(31, fill)}};
+    case 1:
+      return {
+          {kLegacy | kScannable, random, address, kSidNotPresent, make_data(31, fill)},
+          {kLegacy | kScannable | kScanResponse, random, address, kSidNotPresent, make_data(20, fill)}};
+    case 2:
+      return {
+          {kContinuation, random, address, sid, make_data(229, fill)},
+          {kContinuation, random, address, sid, make_data(229, fill)},
+          {kComplete, random, address, sid, make_data(142, fill)}};
+    default:
+      return {{kComplete, random, address, sid, make_data(100, fill)}};
+  }
+}
+
+// The reports of all the advertisers, the ones of a few advertisers at a time arriving interleaved
+std::vector<AdvertisingReport> dense_scan_trace(size_t advertisers) {
+  std::vector<AdvertisingReport> trace;
+  for (size_t first = 0; first < advertisers; first += kInterleavedAdvertisers) {
+    std::vector<std::vector<AdvertisingReport>> group;
+    for (size_t index = first; index < std::min(advertisers, first + kInterleavedAdvertisers); index++) {
+      group.push_back(advertiser_reports(index));
+    }
+    for (size_t report = 0; report < 3; report++) {
+      for (const auto& reports : group) {
+        if (report < reports.size()) {
+          trace.push_back(reports[report]);
+        }
+      }
+    }
+  }
+  return trace;
+}
+}  // namespace
+
+class BM_LeScanningReassembler : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    trace_ = dense_scan_trace(st.range(0));
+  }
+
+  std::vector<AdvertisingReport> trace_;
+};
+
+// Replay the reports of range(0) advertisers
+BENCHMARK_DEFINE_F(BM_LeScanningReassembler, dense_scan)(State& state) {
+  LeScanningReassembler reassembler;
+  for (auto _ : state) {
+    for (const auto& report : trace_) {
+      auto advertising_data = reassembler.ProcessAdvertisingReport(
+          report.event_type, report.address_type, report.address, report.sid, report.data);
+      ::benchmark::DoNotOptimize(advertising_data);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * trace_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_LeScanningReassembler, dense_scan)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(::benchmark::kMicrosecond);
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -324,4 +324,38 @@ TEST_F(LeScanningReassemblerTest, interleaved_advertising) {
       std::vector<uint8_t>({0x2, 0x3, 0x3}));
 }
 
+TEST_F(LeScanningReassemblerTest, least_recently_used_advertiser_is_dropped) {
+  // Fill the cache with fragments of as many advertisers as it can hold,
+  // then refresh the first one.
+  for (uint8_t sid = 0; sid < LeScanningReassembler::kMaximumCacheSize; sid++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, sid, {0x3, sid})
+                     .has_value());
+  }
+  ASSERT_FALSE(reassembler_
+                   .ProcessAdvertisingReport(
+                       kContinuation, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x0, {0x3})
+                   .has_value());
+
+  // A new advertiser drops the least recently used one, which is the second.
+  ASSERT_FALSE(reassembler_
+                   .ProcessAdvertisingReport(
+                       kContinuation, (uint8_t)AddressType::RANDOM_DEVICE_ADDRESS, kTestAddress, 0x0, {0x2, 0x4})
+                   .has_value());
+
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x0, {0x4}),
+      std::vector<uint8_t>({0x3, 0x0, 0x3, 0x4}));
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x2, {0x6, 0x7}),
+      std::vector<uint8_t>({0x3, 0x2, 0x6, 0x7}));
+  ASSERT_EQ(
+      reassembler_.ProcessAdvertisingReport(
+          kComplete, (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS, kTestAddress, 0x1, {0x1, 0x5}),
+      std::vector<uint8_t>({0x1, 0x5}));
+}
+
 }  // namespace bluetooth::hci
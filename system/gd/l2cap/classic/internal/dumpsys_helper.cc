@@ -30,13 +30,12 @@ bluetooth::l2cap::classic::internal::DumpsysHelper::DumpsysHelper(const LinkMana
 std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::ChannelData>>
 bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveDynamicChannels(
     flatbuffers::FlatBufferBuilder* fb_builder,
-    const l2cap::internal::DynamicChannelAllocator& channel_allocator) const {
+    const l2cap::internal::DynamicChannelAllocator& channel_allocator,
+    const l2cap::internal::DataPipelineManager& data_pipeline_manager) const {
   std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::ChannelData>> channel_offsets;
 
   for (auto it = channel_allocator.channels_.cbegin(); it != channel_allocator.channels_.cend(); ++it) {
-    ChannelDataBuilder builder(*fb_builder);
-    builder.add_cid(it->first);
-    channel_offsets.push_back(builder.Finish());
+    channel_offsets.push_back(DumpChannel(fb_builder, it->first, data_pipeline_manager));
   }
   return channel_offsets;
 }
@@ -46,17 +45,41 @@ bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveFixedChannels(
     flatbuffers::FlatBufferBuilder* fb_builder,
     const bluetooth::l2cap::internal::FixedChannelAllocator<
         bluetooth::l2cap::classic::internal::FixedChannelImpl,
-        bluetooth::l2cap::classic::internal::Link>& channel_allocator) const {
+        bluetooth::l2cap::classic::internal::Link>& channel_allocator,
+    const l2cap::internal::DataPipelineManager& data_pipeline_manager) const {
   std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::ChannelData>> channel_offsets;
 
   for (auto it = channel_allocator.channels_.cbegin(); it != channel_allocator.channels_.cend(); ++it) {
-    ChannelDataBuilder builder(*fb_builder);
-    builder.add_cid(it->first);
-    channel_offsets.push_back(builder.Finish());
+    channel_offsets.push_back(DumpChannel(fb_builder, it->first, data_pipeline_manager));
   }
   return channel_offsets;
 }
 
+flatbuffers::Offset<bluetooth::l2cap::classic::ChannelData>
+bluetooth::l2cap::classic::internal::DumpsysHelper::DumpChannel(
+    flatbuffers::FlatBufferBuilder* fb_builder,
+    Cid cid,
+    const l2cap::internal::DataPipelineManager& data_pipeline_manager) const {
+  auto stats = data_pipeline_manager.GetChannelStats(cid);
+
+  ChannelDataBuilder builder(*fb_builder);
+  builder.add_cid(cid);
+  builder.add_sdus_sent(stats.sdus_sent);
+  builder.add_bytes_sent(stats.bytes_sent);
+  builder.add_pdus_sent(stats.pdus_sent);
+  builder.add_sdus_received(stats.sdus_received);
+  builder.add_pdus_received(stats.pdus_received);
+  builder.add_bytes_received(stats.bytes_received);
+  builder.add_retransmissions(stats.retransmissions);
+  builder.add_tx_queue_depth(stats.tx_queue_depth);
+  builder.add_rx_queue_depth(stats.rx_queue_depth);
+  builder.add_time_in_queue_p50_us(stats.time_in_queue_p50.count());
+  builder.add_time_in_queue_p90_us(stats.time_in_queue_p90.count());
+  builder.add_time_in_queue_p99_us(stats.time_in_queue_p99.count());
+  builder.add_time_in_queue_max_us(stats.time_in_queue_max.count());
+  return builder.Finish();
+}
+
 std::vector<flatbuffers::Offset<bluetooth::l2cap::classic::LinkData>>
 bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveLinks(flatbuffers::FlatBufferBuilder* fb_builder) const {
   const std::unordered_map<hci::Address, Link>* links = &link_manager_.links_;
@@ -65,10 +88,12 @@ bluetooth::l2cap::classic::internal::DumpsysHelper::DumpActiveLinks(flatbuffers:
 
   for (auto it = links->cbegin(); it != links->cend(); ++it) {
     auto link_address = fb_builder->CreateString(it->second.ToString());
-    auto dynamic_channel_offsets = DumpActiveDynamicChannels(fb_builder, it->second.dynamic_channel_allocator_);
+    auto dynamic_channel_offsets = DumpActiveDynamicChannels(
+        fb_builder, it->second.dynamic_channel_allocator_, it->second.data_pipeline_manager_);
     auto dynamic_channels = fb_builder->CreateVector(dynamic_channel_offsets);
 
-    auto fixed_channel_offsets = DumpActiveFixedChannels(fb_builder, it->second.fixed_channel_allocator_);
+    auto fixed_channel_offsets = DumpActiveFixedChannels(
+        fb_builder, it->second.fixed_channel_allocator_, it->second.data_pipeline_manager_);
     auto fixed_channels = fb_builder->CreateVector(fixed_channel_offsets);
 
     LinkDataBuilder builder(*fb_builder);
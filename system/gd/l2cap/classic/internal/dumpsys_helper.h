@@ -19,6 +19,7 @@
 #include "l2cap/classic/internal/fixed_channel_impl.h"
 #include "l2cap/classic/internal/link.h"
 #include "l2cap/classic/internal/link_manager.h"
+#include "l2cap/internal/data_pipeline_manager.h"
 #include "l2cap/internal/dynamic_channel_allocator.h"
 #include "l2cap/internal/fixed_channel_allocator.h"
 #include "l2cap_classic_module_generated.h"
@@ -34,13 +35,20 @@ class DumpsysHelper {
 
   std::vector<flatbuffers::Offset<ChannelData>> DumpActiveDynamicChannels(
       flatbuffers::FlatBufferBuilder* fb_builder,
-      const l2cap::internal::DynamicChannelAllocator& channel_allocator) const;
+      const l2cap::internal::DynamicChannelAllocator& channel_allocator,
+      const l2cap::internal::DataPipelineManager& data_pipeline_manager) const;
   std::vector<flatbuffers::Offset<ChannelData>> DumpActiveFixedChannels(
       flatbuffers::FlatBufferBuilder* fb_builder,
-      const l2cap::internal::FixedChannelAllocator<FixedChannelImpl, Link>& channel_allocator) const;
+      const l2cap::internal::FixedChannelAllocator<FixedChannelImpl, Link>& channel_allocator,
+      const l2cap::internal::DataPipelineManager& data_pipeline_manager) const;
   std::vector<flatbuffers::Offset<LinkData>> DumpActiveLinks(flatbuffers::FlatBufferBuilder* fb_builder) const;
 
  private:
+  flatbuffers::Offset<ChannelData> DumpChannel(
+      flatbuffers::FlatBufferBuilder* fb_builder,
+      Cid cid,
+      const l2cap::internal::DataPipelineManager& data_pipeline_manager) const;
+
   const LinkManager& link_manager_;
 };
 
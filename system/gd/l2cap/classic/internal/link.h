@@ -115,6 +115,9 @@ class Link : public l2cap::internal::ILink,
                                      PendingDynamicChannelConnection pending_dynamic_channel_connection);
   void SetChannelTxPriority(Cid local_cid, bool high_priority) override;
 
+  // Invoked by LinkManager when the ACL scheduler asks to hold outgoing traffic back, or lets it go again
+  virtual void OnAclTxBackpressure(bool congested);
+
   // When a Link is established, LinkManager notifies pending dynamic channels to connect
   virtual void SetPendingDynamicChannels(std::list<Psm> psm_list,
                                          std::list<Link::PendingDynamicChannelConnection> callback_list);
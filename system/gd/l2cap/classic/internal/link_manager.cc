@@ -124,6 +124,14 @@ void LinkManager::RegisterLinkPropertyListener(os::Handler* handler, LinkPropert
   link_property_listener_ = listener;
 }
 
+void LinkManager::OnAclTxBackpressure(hci::Address remote, bool congested) {
+  auto* link = GetLink(remote);
+  if (link == nullptr) {
+    return;
+  }
+  link->OnAclTxBackpressure(congested);
+}
+
 void LinkManager::OnPendingPacketChange(hci::Address remote, int num_packets) {
   if (disconnected_links_.count(remote) != 0 && num_packets == 0) {
     links_.erase(remote);
@@ -248,6 +256,8 @@ void LinkManager::OnConnectSuccess(std::unique_ptr<hci::acl_manager::ClassicAclC
                      dynamic_channel_service_manager_, fixed_channel_service_manager_, this);
   auto* link = GetLink(device);
   ASSERT(link != nullptr);
+  acl_manager_->SetAclTxBackpressureCallback(
+      link->GetAclHandle(), l2cap_handler_->BindOn(this, &LinkManager::OnAclTxBackpressure, device));
   link->SendInformationRequest(InformationRequestInfoType::EXTENDED_FEATURES_SUPPORTED);
   link->SendInformationRequest(InformationRequestInfoType::FIXED_CHANNELS_SUPPORTED);
   link->ReadRemoteVersionInformation();
@@ -122,6 +122,9 @@ class LinkManager : public hci::acl_manager::ConnectionCallbacks {
   // If there is anything outstanding, don't delete link
   void OnPendingPacketChange(hci::Address remote, int num_packets);
 
+  // Backpressure from the ACL scheduler for the link to remote
+  void OnAclTxBackpressure(hci::Address remote, bool congested);
+
  private:
   // Handles requests from LinkSecurityInterface
   friend class LinkSecurityInterfaceImpl;
@@ -373,6 +373,8 @@ void ClassicSignallingManager::OnConfigurationRequest(SignalId signal_id, Cid ci
     }
     configuration_state.state_ = ChannelConfigurationState::State::CONFIGURED;
     data_pipeline_manager_->AttachChannel(cid, channel, l2cap::internal::DataPipelineManager::ChannelMode::BASIC);
+    data_pipeline_manager_->SetChannelTxPriorityClass(
+        cid, l2cap::internal::PriorityScheduler::GetDefaultTxPriorityClass(channel->GetPsm()));
     data_pipeline_manager_->UpdateClassicConfiguration(cid, configuration_state);
   } else if (configuration_state.state_ == ChannelConfigurationState::State::WAIT_CONFIG_REQ_RSP) {
     configuration_state.state_ = ChannelConfigurationState::State::WAIT_CONFIG_RSP;
@@ -578,6 +580,8 @@ void ClassicSignallingManager::OnConfigurationResponse(SignalId signal_id, Cid c
     }
     configuration_state.state_ = ChannelConfigurationState::State::CONFIGURED;
     data_pipeline_manager_->AttachChannel(cid, channel, l2cap::internal::DataPipelineManager::ChannelMode::BASIC);
+    data_pipeline_manager_->SetChannelTxPriorityClass(
+        cid, l2cap::internal::PriorityScheduler::GetDefaultTxPriorityClass(channel->GetPsm()));
     data_pipeline_manager_->UpdateClassicConfiguration(cid, configuration_state);
   } else if (configuration_state.state_ == ChannelConfigurationState::State::WAIT_CONFIG_REQ_RSP) {
     configuration_state.state_ = ChannelConfigurationState::State::WAIT_CONFIG_REQ;
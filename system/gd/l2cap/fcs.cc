@@ -16,9 +16,16 @@
 
 #include "l2cap/fcs.h"
 
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FCS_CLMUL 1
+#endif
+
 namespace {
 // Table for optimizing the CRC calculation, which is a bitwise operation.
-static const uint16_t crctab[256] = {
+constexpr uint16_t crctab[256] = {
     0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1,
     0xc481, 0x0440, 0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81, 0x0b40,
     0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1,
@@ -39,6 +46,115 @@ static const uint16_t crctab[256] = {
     0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
     0x4100, 0x81c1, 0x8081, 0x4040,
 };
+
+// Slice-by-8 tables: kSliceTables[k][b] is the CRC of byte b followed by k zero bytes, so that the CRC of eight bytes
+// is the XOR of one lookup per byte.
+using SliceTables = std::array<std::array<uint16_t, 256>, 8>;
+
+constexpr SliceTables MakeSliceTables() {
+  SliceTables tables{};
+  for (size_t b = 0; b < 256; b++) {
+    tables[0][b] = crctab[b];
+  }
+  for (size_t k = 1; k < tables.size(); k++) {
+    for (size_t b = 0; b < 256; b++) {
+      uint16_t crc = tables[k - 1][b];
+      tables[k][b] = (crc >> 8) ^ crctab[crc & 0x00ff];
+    }
+  }
+  return tables;
+}
+
+constexpr SliceTables kSliceTables = MakeSliceTables();
+
+uint16_t UpdateSliceBy8(uint16_t crc, const uint8_t* data, size_t length) {
+  const auto& t = kSliceTables;
+  while (length >= 8) {
+    uint16_t low = crc ^ (data[0] | (data[1] << 8));
+    crc = t[7][low & 0x00ff] ^ t[6][low >> 8] ^ t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^
+          t[1][data[6]] ^ t[0][data[7]];
+    data += 8;
+    length -= 8;
+  }
+  while (length-- > 0) {
+    crc = ((crc >> 8) & 0x00ff) ^ crctab[(crc & 0x00ff) ^ *data++];
+  }
+  return crc;
+}
+
+#ifdef FCS_CLMUL
+// Carry-less multiplication folds the data 16 bytes at a time into four 128 bit accumulators, each congruent modulo
+// the FCS polynomial P(x) = x^16 + x^15 + x^2 + 1 to the data it has folded. The result is reduced with the tables.
+//
+// The FCS is bit reflected: bit k of a 128 bit accumulator is the coefficient of x^(127 - k). Folding an accumulator
+// A(x) * x^64 + C(x) over the next D bits is A(x) * (x^(D + 63) mod P) * x + C(x) * (x^(D - 1) mod P) * x, where the
+// factor x comes from the carry-less multiplication of two reflected 64 bit values.
+constexpr size_t kClmulMinLength = 128;
+
+constexpr uint64_t ReflectedXPowModP(size_t n) {
+  uint32_t r = 1;
+  for (size_t i = 0; i < n; i++) {
+    r <<= 1;
+    if (r & 0x10000) {
+      r ^= 0x18005;
+    }
+  }
+  uint64_t reflected = 0;
+  for (size_t i = 0; i < 16; i++) {
+    if (r & (1u << i)) {
+      reflected |= uint64_t{1} << (63 - i);
+    }
+  }
+  return reflected;
+}
+
+__attribute__((target("pclmul,sse2"))) __m128i Fold(__m128i accumulator, __m128i constants, __m128i next) {
+  __m128i high_degrees = _mm_clmulepi64_si128(accumulator, constants, 0x00);
+  __m128i low_degrees = _mm_clmulepi64_si128(accumulator, constants, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high_degrees, low_degrees), next);
+}
+
+__attribute__((target("pclmul,sse2"))) uint16_t UpdateClmul(uint16_t crc, const uint8_t* data, size_t length) {
+  const __m128i fold_by_512 = _mm_set_epi64x(ReflectedXPowModP(511), ReflectedXPowModP(575));
+  const __m128i fold_by_128 = _mm_set_epi64x(ReflectedXPowModP(127), ReflectedXPowModP(191));
+  auto load = [&data](size_t block) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * block));
+  };
+
+  // Starting from crc is the same as starting from zero with crc added to the first two bytes
+  __m128i x0 = _mm_xor_si128(load(0), _mm_cvtsi32_si128(crc));
+  __m128i x1 = load(1);
+  __m128i x2 = load(2);
+  __m128i x3 = load(3);
+  data += 64;
+  length -= 64;
+  while (length >= 64) {
+    x0 = Fold(x0, fold_by_512, load(0));
+    x1 = Fold(x1, fold_by_512, load(1));
+    x2 = Fold(x2, fold_by_512, load(2));
+    x3 = Fold(x3, fold_by_512, load(3));
+    data += 64;
+    length -= 64;
+  }
+  x1 = Fold(x0, fold_by_128, x1);
+  x2 = Fold(x1, fold_by_128, x2);
+  x3 = Fold(x2, fold_by_128, x3);
+  while (length >= 16) {
+    x3 = Fold(x3, fold_by_128, load(0));
+    data += 16;
+    length -= 16;
+  }
+
+  alignas(16) uint8_t folded[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(folded), x3);
+  return UpdateSliceBy8(UpdateSliceBy8(0, folded, sizeof(folded)), data, length);
+}
+
+bool HasClmul() {
+  static const bool has_clmul = __builtin_cpu_supports("pclmul");
+  return has_clmul;
+}
+#endif
 }  // namespace
 
 namespace bluetooth {
@@ -52,9 +168,22 @@ void Fcs::AddByte(uint8_t byte) {
   crc = ((crc >> 8) & 0x00ff) ^ crctab[(crc & 0x00ff) ^ byte];
 }
 
+void Fcs::AddBytes(const uint8_t* data, size_t length) {
+  crc = Update(crc, data, length);
+}
+
 uint16_t Fcs::GetChecksum() const {
   return crc;
 }
 
+uint16_t Fcs::Update(uint16_t crc, const uint8_t* data, size_t length) {
+#ifdef FCS_CLMUL
+  if (length >= kClmulMinLength && HasClmul()) {
+    return UpdateClmul(crc, data, length);
+  }
+#endif
+  return UpdateSliceBy8(crc, data, length);
+}
+
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace bluetooth {
@@ -28,8 +29,14 @@ class Fcs {
 
   void AddByte(uint8_t byte);
 
+  // Same as AddByte() on each byte, eight bytes at a time
+  void AddBytes(const uint8_t* data, size_t length);
+
   uint16_t GetChecksum() const;
 
+  // Continues the FCS crc over data. Shared with the legacy stack, which computes the FCS over whole buffers.
+  static uint16_t Update(uint16_t crc, const uint8_t* data, size_t length);
+
  private:
   uint16_t crc;
 };
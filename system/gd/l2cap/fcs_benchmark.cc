@@ -0,0 +1,67 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "l2cap/fcs.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+
+namespace {
+std::vector<uint8_t> make_data(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<uint8_t>(i * 151 + 7);
+  }
+  return data;
+}
+}  // namespace
+
+// The FCS of range(0) bytes, one byte at a time
+static void BM_FcsAddByte(State& state) {
+  auto data = make_data(state.range(0));
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    for (auto byte : data) {
+      fcs.AddByte(byte);
+    }
+    ::benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * data.size());
+}
+BENCHMARK(BM_FcsAddByte)->Arg(64)->Arg(1024)->Arg(65536);
+
+// The FCS of range(0) bytes at once, with carry-less multiplication for long buffers when the CPU has it
+static void BM_FcsAddBytes(State& state) {
+  auto data = make_data(state.range(0));
+  for (auto _ : state) {
+    Fcs fcs;
+    fcs.Initialize();
+    fcs.AddBytes(data.data(), data.size());
+    ::benchmark::DoNotOptimize(fcs.GetChecksum());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * data.size());
+}
+BENCHMARK(BM_FcsAddBytes)->Arg(64)->Arg(1024)->Arg(65536);
+
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/fcs.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace l2cap {
+namespace {
+
+uint16_t fcs_by_byte(const std::vector<uint8_t>& data) {
+  Fcs fcs;
+  fcs.Initialize();
+  for (auto byte : data) {
+    fcs.AddByte(byte);
+  }
+  return fcs.GetChecksum();
+}
+
+TEST(FcsTest, check_value) {
+  // CRC-16/ARC check value
+  std::vector<uint8_t> data = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  ASSERT_EQ(fcs_by_byte(data), 0xbb3d);
+  ASSERT_EQ(Fcs::Update(0, data.data(), data.size()), 0xbb3d);
+}
+
+TEST(FcsTest, add_bytes_matches_add_byte) {
+  std::vector<uint8_t> data;
+  for (size_t length = 0; length < 40; length++) {
+    Fcs fcs;
+    fcs.Initialize();
+    // Split in two to also continue from a non zero crc
+    fcs.AddBytes(data.data(), length / 3);
+    fcs.AddBytes(data.data() + length / 3, length - length / 3);
+    ASSERT_EQ(fcs.GetChecksum(), fcs_by_byte(data)) << "length " << length;
+    data.push_back(static_cast<uint8_t>(length * 37 + 11));
+  }
+}
+
+TEST(FcsTest, long_buffers) {
+  // Long enough for the carry-less multiplication path where the CPU has one
+  std::vector<uint8_t> data;
+  for (size_t length = 0; length < 600; length++) {
+    for (size_t offset : {0, 1, 7}) {
+      if (offset > length) {
+        continue;
+      }
+      uint16_t crc = fcs_by_byte(std::vector<uint8_t>(data.begin(), data.begin() + offset));
+      ASSERT_EQ(Fcs::Update(crc, data.data() + offset, length - offset), fcs_by_byte(data))
+          << "length " << length << " offset " << offset;
+    }
+    data.push_back(static_cast<uint8_t>(length * 151 + 7));
+  }
+}
+
+}  // namespace
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -38,6 +38,8 @@ void BasicModeDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilder> s
 }
 
 void BasicModeDataController::OnPdu(packet::PacketView<true> pdu) {
+  pdus_received_++;
+  bytes_received_ += pdu.size();
   auto basic_frame_view = BasicFrameView::Create(pdu);
   if (!basic_frame_view.IsValid()) {
     LOG_WARN("Received invalid frame");
@@ -52,6 +54,14 @@ std::unique_ptr<packet::BasePacketBuilder> BasicModeDataController::GetNextPacke
   return next;
 }
 
+void BasicModeDataController::GetStats(ChannelStats* stats) const {
+  // Each PDU is an SDU
+  stats->sdus_received = pdus_received_;
+  stats->pdus_received = pdus_received_;
+  stats->bytes_received = bytes_received_;
+  stats->rx_queue_depth = enqueue_buffer_.Size();
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -54,6 +54,7 @@ class BasicModeDataController : public DataController {
 
   void EnableFcs(bool enabled) override {}
   void SetRetransmissionAndFlowControlOptions(const RetransmissionAndFlowControlConfigurationOption& option) override {}
+  void GetStats(ChannelStats* stats) const override;
 
  private:
   Cid cid_;
@@ -62,6 +63,8 @@ class BasicModeDataController : public DataController {
   os::Handler* handler_;
   std::queue<std::unique_ptr<packet::BasePacketBuilder>> pdu_queue_;
   Scheduler* scheduler_;
+  uint64_t pdus_received_ = 0;
+  uint64_t bytes_received_ = 0;
 };
 
 }  // namespace internal
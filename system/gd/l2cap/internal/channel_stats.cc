@@ -0,0 +1,53 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/channel_stats.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+void DurationHistogram::Add(std::chrono::microseconds duration) {
+  uint64_t us = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+  size_t bucket = us == 0 ? 0 : 64 - __builtin_clzll(us);
+  if (bucket >= kNumBuckets) {
+    bucket = kNumBuckets - 1;
+  }
+  buckets_[bucket]++;
+  num_samples_++;
+}
+
+std::chrono::microseconds DurationHistogram::Percentile(unsigned percent) const {
+  if (num_samples_ == 0) {
+    return std::chrono::microseconds(0);
+  }
+  uint64_t rank = (num_samples_ * percent + 99) / 100;
+  if (rank == 0) {
+    rank = 1;
+  }
+  uint64_t count = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+    count += buckets_[bucket];
+    if (count >= rank) {
+      return std::chrono::microseconds(1ll << bucket);
+    }
+  }
+  return std::chrono::microseconds(1ll << (kNumBuckets - 1));
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+/**
+ * Counts durations in buckets of powers of two microseconds, to tell their percentiles without keeping every sample.
+ */
+class DurationHistogram {
+ public:
+  // Bucket i holds the durations shorter than 2^i us, not held by bucket i - 1. The last bucket holds the longer ones.
+  static constexpr size_t kNumBuckets = 24;
+
+  void Add(std::chrono::microseconds duration);
+
+  uint64_t NumSamples() const {
+    return num_samples_;
+  }
+
+  // The upper bound of the bucket of the given percentile of the durations, zero if there are none
+  std::chrono::microseconds Percentile(unsigned percent) const;
+
+ private:
+  std::array<uint32_t, kNumBuckets> buckets_{};
+  uint64_t num_samples_ = 0;
+};
+
+/**
+ * A snapshot of the data path counters of a channel, gathered from its Sender, DataController and the Scheduler of
+ * its link.
+ */
+struct ChannelStats {
+  uint64_t sdus_sent = 0;
+  uint64_t bytes_sent = 0;  // In SDUs
+  uint64_t pdus_sent = 0;
+  uint64_t sdus_received = 0;
+  uint64_t pdus_received = 0;
+  uint64_t bytes_received = 0;  // In PDUs
+  uint64_t retransmissions = 0;
+  size_t tx_queue_depth = 0;  // PDUs waiting for the link
+  size_t rx_queue_depth = 0;  // SDUs waiting for the user of the channel
+  // How long the PDUs sent waited for the link
+  std::chrono::microseconds time_in_queue_p50{0};
+  std::chrono::microseconds time_in_queue_p90{0};
+  std::chrono::microseconds time_in_queue_p99{0};
+  std::chrono::microseconds time_in_queue_max{0};
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
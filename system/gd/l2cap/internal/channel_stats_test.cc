@@ -0,0 +1,63 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/channel_stats.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+using std::chrono::microseconds;
+
+TEST(DurationHistogramTest, empty) {
+  DurationHistogram histogram;
+  EXPECT_EQ(histogram.NumSamples(), 0u);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(0));
+}
+
+TEST(DurationHistogramTest, percentiles) {
+  DurationHistogram histogram;
+  for (int i = 0; i < 90; i++) {
+    histogram.Add(microseconds(100));
+  }
+  for (int i = 0; i < 9; i++) {
+    histogram.Add(microseconds(3000));
+  }
+  histogram.Add(microseconds(50000));
+  EXPECT_EQ(histogram.NumSamples(), 100u);
+  EXPECT_EQ(histogram.Percentile(50), microseconds(128));
+  EXPECT_EQ(histogram.Percentile(90), microseconds(128));
+  EXPECT_EQ(histogram.Percentile(99), microseconds(4096));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(65536));
+}
+
+TEST(DurationHistogramTest, bucket_bounds) {
+  DurationHistogram histogram;
+  histogram.Add(microseconds(0));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(1));
+  histogram.Add(microseconds(1));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(2));
+  histogram.Add(std::chrono::hours(1));
+  EXPECT_EQ(histogram.Percentile(100), microseconds(1 << (DurationHistogram::kNumBuckets - 1)));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -18,6 +18,7 @@
 
 #include <memory>
 
+#include "l2cap/internal/channel_stats.h"
 #include "l2cap/l2cap_packets.h"
 #include "packet/base_packet_builder.h"
 #include "packet/packet_view.h"
@@ -46,6 +47,9 @@ class DataController {
   // This only applies to some modes (ERTM).
   virtual void SetRetransmissionAndFlowControlOptions(
       const RetransmissionAndFlowControlConfigurationOption& option) = 0;
+
+  // Fill the receive path counters, the retransmissions and the receive queue depth of the channel in stats
+  virtual void GetStats(ChannelStats* stats) const {}
 };
 
 }  // namespace internal
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "l2cap/internal/basic_mode_channel_data_controller.h"
+#include "l2cap/internal/ilink.h"
+#include "l2cap/internal/le_credit_based_channel_data_controller.h"
+#include "l2cap/internal/scheduler.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+namespace {
+constexpr Cid kCid = 0x41;
+// MPS of the LE credit based data controller until the signalling sets it
+constexpr size_t kDefaultMps = 251;
+
+std::unique_ptr<packet::BasePacketBuilder> CreateSdu(const std::vector<uint8_t>& payload) {
+  auto raw_builder = std::make_unique<packet::RawBuilder>();
+  raw_builder->AddOctets(payload);
+  return raw_builder;
+}
+
+// Serialize the packet as the ACL fragmenter would, to account for the cost of the builders
+size_t Serialize(std::unique_ptr<packet::BasePacketBuilder> packet, std::vector<uint8_t>& bytes) {
+  bytes.clear();
+  packet::BitInserter it(bytes);
+  packet->Serialize(it);
+  return bytes.size();
+}
+
+class NullLink : public ILink {
+ public:
+  void SendDisconnectionRequest(Cid, Cid) override {}
+  hci::AddressWithType GetDevice() const override {
+    return hci::AddressWithType();
+  }
+};
+}  // namespace
+
+// A channel sending SDUs of range(0) bytes, from the SDU to the serialized PDUs
+class BM_DataController : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    thread_ = std::make_unique<os::Thread>("bm_data_controller", os::Thread::Priority::NORMAL);
+    handler_ = std::make_unique<os::Handler>(thread_.get());
+    sdu_ = std::vector<uint8_t>(st.range(0));
+    for (size_t i = 0; i < sdu_.size(); i++) {
+      sdu_[i] = static_cast<uint8_t>(i);
+    }
+  }
+
+  void TearDown(State& st) override {
+    handler_->Clear();
+    handler_.reset();
+    thread_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::unique_ptr<os::Thread> thread_;
+  std::unique_ptr<os::Handler> handler_;
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue_{10};
+  Scheduler scheduler_;
+  std::vector<uint8_t> sdu_;
+};
+
+BENCHMARK_DEFINE_F(BM_DataController, basic_mode_transmit)(State& state) {
+  BasicModeDataController controller{kCid, kCid, channel_queue_.GetDownEnd(), handler_.get(), &scheduler_};
+  std::vector<uint8_t> bytes;
+  size_t total = 0;
+  for (auto _ : state) {
+    controller.OnSdu(CreateSdu(sdu_));
+    total += Serialize(controller.GetNextPacket(), bytes);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(total);
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, basic_mode_transmit)->Arg(48)->Arg(672);
+
+// The SDUs are segmented in PDUs of the default MPS
+BENCHMARK_DEFINE_F(BM_DataController, le_credit_based_transmit)(State& state) {
+  NullLink link;
+  LeCreditBasedDataController controller{&link, kCid, kCid, channel_queue_.GetDownEnd(), handler_.get(), &scheduler_};
+  controller.SetMtu(static_cast<Mtu>(sdu_.size()));
+  // Each PDU carries up to MPS - 2 bytes of the SDU
+  size_t pdus = (sdu_.size() + kDefaultMps - 3) / (kDefaultMps - 2);
+  std::vector<uint8_t> bytes;
+  size_t total = 0;
+  for (auto _ : state) {
+    controller.OnCredit(static_cast<uint16_t>(pdus));
+    controller.OnSdu(CreateSdu(sdu_));
+    for (size_t i = 0; i < pdus; i++) {
+      total += Serialize(controller.GetNextPacket(), bytes);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(total);
+}
+
+BENCHMARK_REGISTER_F(BM_DataController, le_credit_based_transmit)->Arg(48)->Arg(672);
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -31,6 +31,9 @@ void DataPipelineManager::AttachChannel(Cid cid, std::shared_ptr<ChannelImpl> ch
   ASSERT(sender_map_.find(cid) == sender_map_.end());
   sender_map_.emplace(std::piecewise_construct, std::forward_as_tuple(cid),
                       std::forward_as_tuple(handler_, link_, scheduler_.get(), channel, mode));
+  if (link_congested_) {
+    sender_map_.find(cid)->second.SetLinkCongested(true);
+  }
 }
 
 void DataPipelineManager::DetachChannel(Cid cid) {
@@ -62,6 +65,29 @@ void DataPipelineManager::SetChannelTxPriority(Cid cid, bool high_priority) {
   scheduler_->SetChannelTxPriority(cid, high_priority);
 }
 
+void DataPipelineManager::SetChannelTxPriorityClass(Cid cid, TxPriorityClass priority_class) {
+  ASSERT(sender_map_.find(cid) != sender_map_.end());
+  scheduler_->SetChannelTxPriorityClass(cid, priority_class);
+}
+
+void DataPipelineManager::OnLinkCongestionChange(bool congested) {
+  link_congested_ = congested;
+  for (auto& sender : sender_map_) {
+    sender.second.SetLinkCongested(congested);
+  }
+}
+
+ChannelStats DataPipelineManager::GetChannelStats(Cid cid) const {
+  ChannelStats stats;
+  auto sender = sender_map_.find(cid);
+  if (sender == sender_map_.end()) {
+    return stats;
+  }
+  sender->second.GetStats(&stats);
+  scheduler_->GetStats(cid, &stats);
+  return stats;
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
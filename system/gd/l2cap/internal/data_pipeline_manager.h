@@ -25,9 +25,10 @@
 #include "l2cap/cid.h"
 #include "l2cap/classic/internal/channel_configuration_state.h"
 #include "l2cap/internal/channel_impl.h"
+#include "l2cap/internal/channel_stats.h"
 #include "l2cap/internal/receiver.h"
 #include "l2cap/internal/scheduler.h"
-#include "l2cap/internal/scheduler_fifo.h"
+#include "l2cap/internal/scheduler_priority.h"
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/mtu.h"
 #include "os/handler.h"
@@ -56,7 +57,7 @@ class DataPipelineManager {
   using LowerQueueUpEnd = common::BidiQueueEnd<LowerEnqueue, LowerDequeue>;
 
   DataPipelineManager(os::Handler* handler, ILink* link, LowerQueueUpEnd* link_queue_up_end)
-      : handler_(handler), link_(link), scheduler_(std::make_unique<Fifo>(this, link_queue_up_end, handler)),
+      : handler_(handler), link_(link), scheduler_(std::make_unique<PriorityScheduler>(this, link_queue_up_end, handler)),
         receiver_(link_queue_up_end, handler, this) {}
 
   using ChannelMode = Sender::ChannelMode;
@@ -67,6 +68,11 @@ class DataPipelineManager {
   virtual void OnPacketSent(Cid cid);
   virtual void UpdateClassicConfiguration(Cid cid, classic::internal::ChannelConfigurationState config);
   virtual void SetChannelTxPriority(Cid cid, bool high_priority);
+  virtual void SetChannelTxPriorityClass(Cid cid, TxPriorityClass priority_class);
+  // Backpressure from the ACL scheduler, applied to every sender of the link
+  virtual void OnLinkCongestionChange(bool congested);
+  // The data path counters of an attached channel, all zero for other channels
+  virtual ChannelStats GetChannelStats(Cid cid) const;
   virtual ~DataPipelineManager() = default;
 
  private:
@@ -75,6 +81,7 @@ class DataPipelineManager {
   std::unordered_map<Cid, Sender> sender_map_;
   std::unique_ptr<Scheduler> scheduler_;
   Receiver receiver_;
+  bool link_congested_ = false;
 };
 }  // namespace internal
 }  // namespace l2cap
@@ -32,11 +32,8 @@ std::shared_ptr<DynamicChannelImpl> DynamicChannelAllocator::AllocateChannel(Psm
     LOG_INFO("Remote cid 0x%x is used", remote_cid);
     return nullptr;
   }
-  Cid cid = kFirstDynamicChannel;
-  for (; cid <= kLastDynamicChannel; cid++) {
-    if (used_cid_.find(cid) == used_cid_.end()) break;
-  }
-  if (cid > kLastDynamicChannel) {
+  Cid cid = allocate_cid();
+  if (cid == kInvalidCid) {
     LOG_WARN("All cid are used");
     return nullptr;
   }
@@ -49,7 +46,11 @@ std::shared_ptr<DynamicChannelImpl> DynamicChannelAllocator::AllocateChannel(Psm
       ADDRESS_TO_LOGGABLE_CSTR(link_->GetDevice()));
   ASSERT(elem.first->second != nullptr);
   used_remote_cid_.insert(remote_cid);
-  used_cid_.insert(cid);
+  size_t index = cid - kFirstDynamicChannel;
+  if (index >= channel_by_cid_.size()) {
+    channel_by_cid_.resize(index + 1);
+  }
+  channel_by_cid_[index] = elem.first->second;
   return elem.first->second;
 }
 
@@ -68,24 +69,26 @@ std::shared_ptr<DynamicChannelImpl> DynamicChannelAllocator::AllocateReservedCha
       ADDRESS_TO_LOGGABLE_CSTR(link_->GetDevice()));
   ASSERT(elem.first->second != nullptr);
   used_remote_cid_.insert(remote_cid);
+  if (reserved_cid >= kFirstDynamicChannel) {
+    size_t index = reserved_cid - kFirstDynamicChannel;
+    if (index >= channel_by_cid_.size()) {
+      channel_by_cid_.resize(index + 1);
+    }
+    channel_by_cid_[index] = elem.first->second;
+  }
   return elem.first->second;
 }
 
 Cid DynamicChannelAllocator::ReserveChannel() {
-  Cid cid = kFirstDynamicChannel;
-  for (; cid <= kLastDynamicChannel; cid++) {
-    if (used_cid_.find(cid) == used_cid_.end()) break;
-  }
-  if (cid > kLastDynamicChannel) {
+  Cid cid = allocate_cid();
+  if (cid == kInvalidCid) {
     LOG_WARN("All cid are used");
-    return kInvalidCid;
   }
-  used_cid_.insert(cid);
   return cid;
 }
 
 void DynamicChannelAllocator::FreeChannel(Cid cid) {
-  used_cid_.erase(cid);
+  free_cid(cid);
   auto channel = FindChannelByCid(cid);
   if (channel == nullptr) {
     LOG_INFO("Channel is not in use: cid %d, device %s", cid,
@@ -94,6 +97,11 @@ void DynamicChannelAllocator::FreeChannel(Cid cid) {
   }
   used_remote_cid_.erase(channel->GetRemoteCid());
   channels_.erase(cid);
+  size_t index = cid - kFirstDynamicChannel;
+  channel_by_cid_[index].reset();
+  while (!channel_by_cid_.empty() && channel_by_cid_.back() == nullptr) {
+    channel_by_cid_.pop_back();
+  }
 }
 
 bool DynamicChannelAllocator::IsPsmUsed(Psm psm) const {
@@ -106,11 +114,12 @@ bool DynamicChannelAllocator::IsPsmUsed(Psm psm) const {
 }
 
 std::shared_ptr<DynamicChannelImpl> DynamicChannelAllocator::FindChannelByCid(Cid cid) {
-  if (channels_.find(cid) == channels_.end()) {
+  if (cid < kFirstDynamicChannel || cid - kFirstDynamicChannel >= channel_by_cid_.size() ||
+      channel_by_cid_[cid - kFirstDynamicChannel] == nullptr) {
     LOG_WARN("Can't find cid %d", cid);
     return nullptr;
   }
-  return channels_.find(cid)->second;
+  return channel_by_cid_[cid - kFirstDynamicChannel];
 }
 
 std::shared_ptr<DynamicChannelImpl> DynamicChannelAllocator::FindChannelByRemoteCid(Cid remote_cid) {
@@ -126,6 +135,40 @@ size_t DynamicChannelAllocator::NumberOfChannels() const {
   return channels_.size();
 }
 
+Cid DynamicChannelAllocator::allocate_cid() {
+  for (size_t summary = 0; summary < kNumSummaryWords; summary++) {
+    uint64_t free_words = ~full_cid_words_[summary];
+    if (free_words == 0) {
+      continue;
+    }
+    size_t word = summary * 64 + __builtin_ctzll(free_words);
+    if (word >= kNumCidWords) {
+      break;
+    }
+    size_t bit = __builtin_ctzll(~used_cid_[word]);
+    size_t index = word * 64 + bit;
+    if (index >= kNumDynamicCids) {
+      break;
+    }
+    used_cid_[word] |= uint64_t{1} << bit;
+    if (used_cid_[word] == ~uint64_t{0}) {
+      full_cid_words_[summary] |= uint64_t{1} << (word % 64);
+    }
+    return static_cast<Cid>(kFirstDynamicChannel + index);
+  }
+  return kInvalidCid;
+}
+
+void DynamicChannelAllocator::free_cid(Cid cid) {
+  if (cid < kFirstDynamicChannel) {
+    return;
+  }
+  size_t index = cid - kFirstDynamicChannel;
+  size_t word = index / 64;
+  used_cid_[word] &= ~(uint64_t{1} << (index % 64));
+  full_cid_words_[word / 64] &= ~(uint64_t{1} << (word % 64));
+}
+
 void DynamicChannelAllocator::OnAclDisconnected(hci::ErrorCode reason) {
   for (auto& elem : channels_) {
     elem.second->OnClosed(reason);
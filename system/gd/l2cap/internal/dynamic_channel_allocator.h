@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "hci/acl_manager.h"
 #include "l2cap/cid.h"
@@ -77,8 +79,22 @@ class DynamicChannelAllocator {
   friend class bluetooth::l2cap::classic::internal::DumpsysHelper;
   l2cap::internal::ILink* link_;
   os::Handler* l2cap_handler_;
-  std::unordered_set<Cid> used_cid_;
+
+  static constexpr size_t kNumDynamicCids = kLastDynamicChannel - kFirstDynamicChannel + 1;
+  static constexpr size_t kNumCidWords = (kNumDynamicCids + 63) / 64;
+  static constexpr size_t kNumSummaryWords = (kNumCidWords + 63) / 64;
+
+  // Returns the first unused cid, marked used, or kInvalidCid if all are used
+  Cid allocate_cid();
+  void free_cid(Cid cid);
+
+  // Bit i of used_cid_ is set when cid kFirstDynamicChannel + i is used, and bit w of full_cid_words_ when all the
+  // bits of used_cid_[w] are set, so finding a free cid looks at two words past the full ones.
+  std::array<uint64_t, kNumCidWords> used_cid_{};
+  std::array<uint64_t, kNumSummaryWords> full_cid_words_{};
   std::unordered_map<Cid, std::shared_ptr<DynamicChannelImpl>> channels_;
+  // The channels indexed by cid - kFirstDynamicChannel. Cids are allocated from the lowest, so it stays short.
+  std::vector<std::shared_ptr<DynamicChannelImpl>> channel_by_cid_;
   std::unordered_set<Cid> used_remote_cid_;
 };
 
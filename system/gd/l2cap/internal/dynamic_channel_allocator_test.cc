@@ -87,6 +87,30 @@ TEST_F(L2capClassicDynamicChannelAllocatorTest, reserve_channel) {
   EXPECT_FALSE(channel_allocator_->IsPsmUsed(psm));
 }
 
+TEST_F(L2capClassicDynamicChannelAllocatorTest, lowest_free_cid_is_reused) {
+  Cid first = channel_allocator_->ReserveChannel();
+  Cid second = channel_allocator_->ReserveChannel();
+  Cid third = channel_allocator_->ReserveChannel();
+  EXPECT_EQ(first, kFirstDynamicChannel);
+  EXPECT_EQ(second, kFirstDynamicChannel + 1);
+  EXPECT_EQ(third, kFirstDynamicChannel + 2);
+  channel_allocator_->FreeChannel(second);
+  EXPECT_EQ(channel_allocator_->ReserveChannel(), second);
+  EXPECT_EQ(channel_allocator_->ReserveChannel(), kFirstDynamicChannel + 3);
+}
+
+TEST_F(L2capClassicDynamicChannelAllocatorTest, find_channel_by_cid) {
+  EXPECT_EQ(nullptr, channel_allocator_->FindChannelByCid(kFirstDynamicChannel));
+  EXPECT_EQ(nullptr, channel_allocator_->FindChannelByCid(kLastDynamicChannel));
+  auto first = channel_allocator_->AllocateChannel(0x03, kFirstDynamicChannel);
+  auto second = channel_allocator_->AllocateChannel(0x05, kFirstDynamicChannel + 1);
+  EXPECT_EQ(first, channel_allocator_->FindChannelByCid(first->GetCid()));
+  EXPECT_EQ(second, channel_allocator_->FindChannelByCid(second->GetCid()));
+  channel_allocator_->FreeChannel(second->GetCid());
+  EXPECT_EQ(nullptr, channel_allocator_->FindChannelByCid(second->GetCid()));
+  EXPECT_EQ(first, channel_allocator_->FindChannelByCid(first->GetCid()));
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -16,6 +16,9 @@
 
 #include "l2cap/internal/enhanced_retransmission_mode_channel_data_controller.h"
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
 #include <map>
 #include <queue>
 #include <vector>
@@ -23,8 +26,7 @@
 #include "common/bind.h"
 #include "l2cap/internal/ilink.h"
 #include "os/alarm.h"
-#include "packet/fragmenting_inserter.h"
-#include "packet/raw_builder.h"
+#include "packet/view_builder.h"
 
 namespace bluetooth {
 namespace l2cap {
@@ -40,7 +42,8 @@ ErtmController::~ErtmController() {
 
 struct ErtmController::impl {
   impl(ErtmController* controller, os::Handler* handler)
-      : controller_(controller), handler_(handler), retrans_timer_(handler), monitor_timer_(handler) {}
+      : controller_(controller), handler_(handler), tx_window_(controller->remote_tx_window_), retrans_timer_(handler),
+        monitor_timer_(handler) {}
 
   ErtmController* controller_;
   os::Handler* handler_;
@@ -48,8 +51,15 @@ struct ErtmController::impl {
   // We don't support extended window
   static constexpr uint8_t kMaxTxWin = 64;
 
-  // We don't support sending SREJ
-  static constexpr bool kSendSrej = false;
+  // Missing I-frames are requested one by one with SREJ, so that a single lost frame doesn't retransmit the whole
+  // window (go-back-N with REJ)
+  static constexpr bool kSendSrej = true;
+
+  // The transmit window adapts to the round trip time measured on the I-frames acknowledged at their first
+  // transmission: it shrinks by one when the smoothed RTT reaches kRttQueueingFactor times the minimum one, meaning
+  // the frames are queueing up below us, and grows by one otherwise, up to the window of the remote. A retransmission
+  // halves it.
+  static constexpr int kRttQueueingFactor = 2;
 
   // States (@see 8.6.5.2): Transmitter state and receiver state
 
@@ -80,9 +90,10 @@ struct ErtmController::impl {
   int unacked_frames_ = 0;
   // TODO: Instead of having a map, we may consider about a better data structure
   // Map from TxSeq to (SAR, SDU size for START packet, information payload)
-  std::map<uint8_t, std::tuple<SegmentationAndReassembly, uint16_t, std::shared_ptr<packet::RawBuilder>>> unacked_list_;
+  // The segments are views of the serialized SDU, every transmission shares its bytes
+  std::map<uint8_t, std::tuple<SegmentationAndReassembly, uint16_t, packet::ViewBuilder>> unacked_list_;
   // Stores (SAR, SDU size for START packet, information payload)
-  std::queue<std::tuple<SegmentationAndReassembly, uint16_t, std::unique_ptr<packet::RawBuilder>>> pending_frames_;
+  std::queue<std::tuple<SegmentationAndReassembly, uint16_t, std::unique_ptr<packet::ViewBuilder>>> pending_frames_;
   int retry_count_ = 0;
   std::map<uint8_t /* tx_seq, */, int /* count */> retry_i_frames_;
   bool rnr_sent_ = false;
@@ -90,14 +101,21 @@ struct ErtmController::impl {
   bool srej_actioned_ = false;
   uint16_t srej_save_req_seq_ = 0;
   bool send_rej_ = false;
-  int buffer_seq_srej_ = 0;
   int frames_sent_ = 0;
+  // TxSeq of the missing I-frames we sent a SREJ for, in the order they were requested
+  std::deque<uint8_t> srej_list_;
+  // I-frames received out of sequence in SREJ_SENT state, waiting for the missing ones before reassembly
+  std::map<uint8_t, std::tuple<SegmentationAndReassembly, uint16_t, packet::PacketView<true>>> srej_saved_frames_;
+  uint16_t tx_window_;
+  std::map<uint8_t /* tx_seq */, std::chrono::steady_clock::time_point> first_transmission_time_;
+  std::chrono::steady_clock::duration smoothed_rtt_{};
+  std::chrono::steady_clock::duration min_rtt_ = std::chrono::steady_clock::duration::max();
   os::Alarm retrans_timer_;
   os::Alarm monitor_timer_;
 
   // Events (@see 8.6.5.4)
 
-  void data_request(SegmentationAndReassembly sar, std::unique_ptr<packet::RawBuilder> pdu, uint16_t sdu_size = 0) {
+  void data_request(SegmentationAndReassembly sar, std::unique_ptr<packet::ViewBuilder> pdu, uint16_t sdu_size = 0) {
     // Note: sdu_size only applies to START packet
     if (tx_state_ == TxState::XMIT && !remote_busy() && rem_window_not_full()) {
       send_data(sar, sdu_size, std::move(pdu));
@@ -198,7 +216,11 @@ struct ErtmController::impl {
       } else if (with_unexpected_tx_seq(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f) &&
                  !local_busy()) {
         if constexpr (kSendSrej) {
-          // We don't support sending SREJ
+          pass_to_tx(req_seq, f);
+          init_srej();
+          send_srej_up_to(tx_seq);
+          save_i_frame_srej(tx_seq, sar, sdu_size, payload);
+          rx_state_ = RxState::SREJ_SENT;
         } else {
           pass_to_tx(req_seq, f);
           send_rej();
@@ -240,12 +262,45 @@ struct ErtmController::impl {
         pass_to_tx(req_seq, f);
       }
     } else if (rx_state_ == RxState::SREJ_SENT) {
-      // SREJ NOT SUPPORTED
+      if (with_expected_tx_seq_srej(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
+        // The oldest missing frame: reassemble it with the frames saved after it
+        pass_to_tx_srej(req_seq, f);
+        pop_srej_list();
+        save_i_frame_srej(tx_seq, sar, sdu_size, payload);
+        data_indication_srej();
+        if (srej_list_.empty()) {
+          rx_state_ = RxState::RECV;
+          send_ack(Final::NOT_SET);
+        }
+      } else if (with_unexpected_tx_seq_srej(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
+        // A missing frame arrived before older missing ones: the remote lost our SREJ for those, request them again
+        pass_to_tx_srej(req_seq, f);
+        while (srej_list_.front() != tx_seq) {
+          send_srej(srej_list_.front());
+          srej_list_.push_back(srej_list_.front());
+          srej_list_.pop_front();
+        }
+        pop_srej_list();
+        save_i_frame_srej(tx_seq, sar, sdu_size, payload);
+      } else if (with_expected_tx_seq(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
+        pass_to_tx_srej(req_seq, f);
+        increment_expected_tx_seq();
+        save_i_frame_srej(tx_seq, sar, sdu_size, payload);
+      } else if (with_unexpected_tx_seq(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
+        pass_to_tx_srej(req_seq, f);
+        send_srej_up_to(tx_seq);
+        save_i_frame_srej(tx_seq, sar, sdu_size, payload);
+      } else if (with_duplicate_tx_seq_srej(tx_seq) && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
+        pass_to_tx_srej(req_seq, f);
+      } else if (with_invalid_req_seq(req_seq)) {
+        CloseChannel();
+      }
     }
   }
 
   void recv_rr(uint8_t req_seq, Poll p = Poll::NOT_SET, Final f = Final::NOT_SET) {
-    if (rx_state_ == RxState::RECV) {
+    // The transmit side of SREJ_SENT behaves as RECV, only the acknowledgement we send back differs (@see ack_seq())
+    if (rx_state_ == RxState::RECV || rx_state_ == RxState::SREJ_SENT) {
       if (p == Poll::NOT_SET && f == Final::NOT_SET && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
         pass_to_tx(req_seq, f);
         if (remote_busy() && unacked_frames_ > 0) {
@@ -295,13 +350,12 @@ struct ErtmController::impl {
       } else if (with_invalid_req_seq(req_seq)) {
         CloseChannel();
       }
-    } else if (rx_state_ == RxState::SREJ_SENT) {
-      // SREJ NOT SUPPORTED
     }
   }
 
   void recv_rej(uint8_t req_seq, Poll p = Poll::NOT_SET, Final f = Final::NOT_SET) {
-    if (rx_state_ == RxState::RECV) {
+    // The transmit side of SREJ_SENT behaves as RECV, only the acknowledgement we send back differs (@see ack_seq())
+    if (rx_state_ == RxState::RECV || rx_state_ == RxState::SREJ_SENT) {
       if (f == Final::NOT_SET && with_valid_req_seq_retrans(req_seq) &&
           retry_i_frames_less_than_max_transmit(req_seq) && with_valid_f_bit(f)) {
         remote_busy_ = false;
@@ -351,13 +405,12 @@ struct ErtmController::impl {
       } else if (with_invalid_req_seq_retrans(req_seq)) {
         CloseChannel();
       }
-    } else if (rx_state_ == RxState::SREJ_SENT) {
-      // SREJ NOT SUPPORTED
     }
   }
 
   void recv_rnr(uint8_t req_seq, Poll p = Poll::NOT_SET, Final f = Final::NOT_SET) {
-    if (rx_state_ == RxState::RECV) {
+    // The transmit side of SREJ_SENT behaves as RECV, only the acknowledgement we send back differs (@see ack_seq())
+    if (rx_state_ == RxState::RECV || rx_state_ == RxState::SREJ_SENT) {
       if (p == Poll::NOT_SET && with_valid_req_seq(req_seq) && with_valid_f_bit(f)) {
         remote_busy_ = true;
         pass_to_tx(req_seq, f);
@@ -382,13 +435,12 @@ struct ErtmController::impl {
       } else if (with_invalid_req_seq_retrans(req_seq)) {
         CloseChannel();
       }
-    } else if (rx_state_ == RxState::SREJ_SENT) {
-      // SREJ NOT SUPPORTED
     }
   }
 
   void recv_srej(uint8_t req_seq, Poll p = Poll::NOT_SET, Final f = Final::NOT_SET) {
-    if (rx_state_ == RxState::RECV) {
+    // The transmit side of SREJ_SENT behaves as RECV, only the acknowledgement we send back differs (@see ack_seq())
+    if (rx_state_ == RxState::RECV || rx_state_ == RxState::SREJ_SENT) {
       if (p == Poll::NOT_SET && f == Final::NOT_SET && with_valid_req_seq_retrans(req_seq) &&
           retry_i_frames_less_than_max_transmit(req_seq) && with_valid_f_bit(f)) {
         remote_busy_ = false;
@@ -456,8 +508,6 @@ struct ErtmController::impl {
       } else if (with_invalid_req_seq_retrans(req_seq)) {
         CloseChannel();
       }
-    } else if (rx_state_ == RxState::SREJ_SENT) {
-      // SREJ NOT SUPPORTED
     }
   }
 
@@ -471,11 +521,12 @@ struct ErtmController::impl {
   }
 
   bool rem_window_not_full() {
-    return unacked_frames_ < controller_->remote_tx_window_;
+    return unacked_frames_ < tx_window_;
   }
 
   bool rem_window_full() {
-    return unacked_frames_ == controller_->remote_tx_window_;
+    // The window may have shrunk below the frames already in flight
+    return unacked_frames_ >= tx_window_;
   }
 
   bool rnr_sent() {
@@ -547,34 +598,22 @@ struct ErtmController::impl {
     return !with_invalid_tx_seq(tx_seq) && !with_expected_tx_seq(tx_seq);
   }
 
-  bool with_expected_tx_seq_srej() {
-    // We don't support sending SREJ
-    return false;
+  bool with_expected_tx_seq_srej(uint8_t tx_seq) {
+    return !srej_list_.empty() && srej_list_.front() == tx_seq;
   }
 
-  bool send_req_is_true() {
-    // We don't support sending SREJ
-    return false;
+  bool with_unexpected_tx_seq_srej(uint8_t tx_seq) {
+    return !with_expected_tx_seq_srej(tx_seq) &&
+           std::find(srej_list_.begin(), srej_list_.end(), tx_seq) != srej_list_.end();
   }
 
-  bool srej_list_is_one() {
-    // We don't support sending SREJ
-    return false;
-  }
-
-  bool with_unexpected_tx_seq_srej() {
-    // We don't support sending SREJ
-    return false;
-  }
-
-  bool with_duplicate_tx_seq_srej() {
-    // We don't support sending SREJ
-    return false;
+  bool with_duplicate_tx_seq_srej(uint8_t tx_seq) {
+    return srej_saved_frames_.count(tx_seq) != 0 || with_duplicate_tx_seq(tx_seq);
   }
 
   // Actions (@see 8.6.5.6)
 
-  void _send_i_frame(SegmentationAndReassembly sar, std::unique_ptr<CopyablePacketBuilder> segment, uint8_t req_seq,
+  void _send_i_frame(SegmentationAndReassembly sar, std::unique_ptr<packet::ViewBuilder> segment, uint8_t req_seq,
                      uint8_t tx_seq, uint16_t sdu_size = 0, Final f = Final::NOT_SET) {
     std::unique_ptr<packet::BasePacketBuilder> builder;
     if (sar == SegmentationAndReassembly::START) {
@@ -597,15 +636,14 @@ struct ErtmController::impl {
     controller_->send_pdu(std::move(builder));
   }
 
-  void send_data(SegmentationAndReassembly sar, uint16_t sdu_size, std::unique_ptr<packet::RawBuilder> segment,
+  void send_data(SegmentationAndReassembly sar, uint16_t sdu_size, std::unique_ptr<packet::ViewBuilder> segment,
                  Final f = Final::NOT_SET) {
-    std::shared_ptr<packet::RawBuilder> shared_segment(segment.release());
+    // The segment is kept for retransmission
     unacked_list_.emplace(std::piecewise_construct, std::forward_as_tuple(next_tx_seq_),
-                          std::forward_as_tuple(sar, sdu_size, shared_segment));
+                          std::forward_as_tuple(sar, sdu_size, *segment));
 
-    std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-        std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(next_tx_seq_)->second));
-    _send_i_frame(sar, std::move(copyable_packet_builder), buffer_seq_, next_tx_seq_, sdu_size, f);
+    _send_i_frame(sar, std::move(segment), buffer_seq_, next_tx_seq_, sdu_size, f);
+    first_transmission_time_[next_tx_seq_] = std::chrono::steady_clock::now();
     unacked_frames_++;
     frames_sent_++;
     retry_i_frames_[next_tx_seq_] = 1;
@@ -613,14 +651,20 @@ struct ErtmController::impl {
     start_retrans_timer();
   }
 
-  void pend_data(SegmentationAndReassembly sar, uint16_t sdu_size, std::unique_ptr<packet::RawBuilder> data) {
+  void pend_data(SegmentationAndReassembly sar, uint16_t sdu_size, std::unique_ptr<packet::ViewBuilder> data) {
     pending_frames_.emplace(std::make_tuple(sar, sdu_size, std::move(data)));
   }
 
   void process_req_seq(uint8_t req_seq) {
+    auto now = std::chrono::steady_clock::now();
     for (int i = expected_ack_seq_; i < req_seq; i++) {
       unacked_list_.erase(i);
       retry_i_frames_[i] = 0;
+      auto sent = first_transmission_time_.find(i);
+      if (sent != first_transmission_time_.end()) {
+        update_tx_window(now - sent->second);
+        first_transmission_time_.erase(sent);
+      }
     }
     unacked_frames_ -= ((req_seq - expected_ack_seq_) + kMaxTxWin) % kMaxTxWin;
     expected_ack_seq_ = req_seq;
@@ -639,20 +683,25 @@ struct ErtmController::impl {
     controller_->send_pdu(std::move(builder));
   }
 
+  // In SREJ_SENT state expected_tx_seq_ is past the missing frames, only acknowledge what was reassembled
+  uint8_t ack_seq() {
+    return rx_state_ == RxState::SREJ_SENT ? buffer_seq_ : expected_tx_seq_;
+  }
+
   void send_rr(Poll p) {
-    _send_s_frame(SupervisoryFunction::RECEIVER_READY, expected_tx_seq_, p, Final::NOT_SET);
+    _send_s_frame(SupervisoryFunction::RECEIVER_READY, ack_seq(), p, Final::NOT_SET);
   }
 
   void send_rr(Final f) {
-    _send_s_frame(SupervisoryFunction::RECEIVER_READY, expected_tx_seq_, Poll::NOT_SET, f);
+    _send_s_frame(SupervisoryFunction::RECEIVER_READY, ack_seq(), Poll::NOT_SET, f);
   }
 
   void send_rnr(Poll p) {
-    _send_s_frame(SupervisoryFunction::RECEIVER_NOT_READY, expected_tx_seq_, p, Final::NOT_SET);
+    _send_s_frame(SupervisoryFunction::RECEIVER_NOT_READY, ack_seq(), p, Final::NOT_SET);
   }
 
   void send_rnr(Final f) {
-    _send_s_frame(SupervisoryFunction::RECEIVER_NOT_READY, expected_tx_seq_, Poll::NOT_SET, f);
+    _send_s_frame(SupervisoryFunction::RECEIVER_NOT_READY, ack_seq(), Poll::NOT_SET, f);
     rnr_sent_ = true;
   }
 
@@ -683,8 +732,18 @@ struct ErtmController::impl {
     }
   }
 
-  void send_srej() {
-    // Sending SREJ is not supported
+  void send_srej(uint8_t tx_seq) {
+    _send_s_frame(SupervisoryFunction::SELECT_REJECT, tx_seq, Poll::NOT_SET, Final::NOT_SET);
+  }
+
+  // Request every frame from expected_tx_seq_ up to, but excluding, the received tx_seq
+  void send_srej_up_to(uint8_t tx_seq) {
+    while (expected_tx_seq_ != tx_seq) {
+      send_srej(expected_tx_seq_);
+      srej_list_.push_back(expected_tx_seq_);
+      increment_expected_tx_seq();
+    }
+    increment_expected_tx_seq();
   }
 
   void start_retrans_timer() {
@@ -705,6 +764,19 @@ struct ErtmController::impl {
     recv_f_bit(f);
   }
 
+  // A poll response received in SREJ_SENT state also answers our poll on the transmit side
+  void pass_to_tx_srej(uint8_t req_seq, Final f) {
+    pass_to_tx(req_seq, f);
+    if (f == Final::POLL_RESPONSE) {
+      if (!rej_actioned_) {
+        retransmit_i_frames(req_seq);
+        send_pending_i_frames();
+      } else {
+        rej_actioned_ = false;
+      }
+    }
+  }
+
   void data_indication(SegmentationAndReassembly sar, uint16_t sdu_size, const packet::PacketView<true>& segment) {
     controller_->stage_for_reassembly(sar, sdu_size, segment);
     buffer_seq_ = (buffer_seq_ + 1) % kMaxTxWin;
@@ -733,11 +805,13 @@ struct ErtmController::impl {
   }
 
   void init_srej() {
-    // We don't support sending SREJ
+    srej_list_.clear();
+    srej_saved_frames_.clear();
   }
 
-  void save_i_frame_srej() {
-    // We don't support sending SREJ
+  void save_i_frame_srej(uint8_t tx_seq, SegmentationAndReassembly sar, uint16_t sdu_size,
+                         const packet::PacketView<true>& payload) {
+    srej_saved_frames_.insert_or_assign(tx_seq, std::make_tuple(sar, sdu_size, payload));
   }
 
   void store_or_ignore() {
@@ -751,39 +825,60 @@ struct ErtmController::impl {
   void retransmit_i_frames(uint8_t req_seq, Poll p = Poll::NOT_SET) {
     uint8_t i = req_seq;
     Final f = (p == Poll::NOT_SET ? Final::NOT_SET : Final::POLL_RESPONSE);
-    while (unacked_list_.find(i) != unacked_list_.end()) {
+    for (auto frame = unacked_list_.find(i); frame != unacked_list_.end(); frame = unacked_list_.find(i)) {
       if (retry_i_frames_[i] == controller_->local_max_transmit_) {
         CloseChannel();
         return;
       }
-      std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-          std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(i)->second));
-      _send_i_frame(std::get<0>(unacked_list_.find(i)->second), std::move(copyable_packet_builder), buffer_seq_, i,
-                    std::get<1>(unacked_list_.find(i)->second), f);
+      auto& [sar, sdu_size, segment] = frame->second;
+      _send_i_frame(sar, std::make_unique<packet::ViewBuilder>(segment), buffer_seq_, i, sdu_size, f);
+      first_transmission_time_.erase(i);
       retry_i_frames_[i]++;
+      controller_->retransmissions_++;
       frames_sent_++;
       f = Final::NOT_SET;
       i++;
     }
     if (i != req_seq) {
+      on_i_frames_lost();
       start_retrans_timer();
     }
   }
 
   void retransmit_requested_i_frame(uint8_t req_seq, Poll p) {
     Final f = p == Poll::POLL ? Final::POLL_RESPONSE : Final::NOT_SET;
-    if (unacked_list_.find(req_seq) == unacked_list_.end()) {
+    auto frame = unacked_list_.find(req_seq);
+    if (frame == unacked_list_.end()) {
       LOG_ERROR("Received invalid SREJ");
       return;
     }
-    std::unique_ptr<CopyablePacketBuilder> copyable_packet_builder =
-        std::make_unique<CopyablePacketBuilder>(std::get<2>(unacked_list_.find(req_seq)->second));
-    _send_i_frame(std::get<0>(unacked_list_.find(req_seq)->second), std::move(copyable_packet_builder), buffer_seq_,
-                  req_seq, std::get<1>(unacked_list_.find(req_seq)->second), f);
+    auto& [sar, sdu_size, segment] = frame->second;
+    _send_i_frame(sar, std::make_unique<packet::ViewBuilder>(segment), buffer_seq_, req_seq, sdu_size, f);
+    first_transmission_time_.erase(req_seq);
     retry_i_frames_[req_seq]++;
+    controller_->retransmissions_++;
+    on_i_frames_lost();
     start_retrans_timer();
   }
 
+  // The round trip time is only sampled on frames acknowledged at their first transmission, as the acknowledgement
+  // of a retransmitted frame can't be matched with one of its transmissions
+  void update_tx_window(std::chrono::steady_clock::duration rtt) {
+    min_rtt_ = std::min(min_rtt_, rtt);
+    smoothed_rtt_ = smoothed_rtt_ == std::chrono::steady_clock::duration::zero() ? rtt : (7 * smoothed_rtt_ + rtt) / 8;
+    if (smoothed_rtt_ >= kRttQueueingFactor * min_rtt_) {
+      if (tx_window_ > 1) {
+        tx_window_--;
+      }
+    } else if (tx_window_ < controller_->remote_tx_window_) {
+      tx_window_++;
+    }
+  }
+
+  void on_i_frames_lost() {
+    tx_window_ = std::max(tx_window_ / 2, 1);
+  }
+
   void send_pending_i_frames(Final f = Final::NOT_SET) {
     if (p_bit_outstanding()) {
       return;
@@ -801,23 +896,26 @@ struct ErtmController::impl {
   }
 
   void pop_srej_list() {
-    // We don't support sending SREJ
+    srej_list_.pop_front();
   }
 
+  // Reassemble the saved frames that are now in sequence
   void data_indication_srej() {
-    // We don't support sending SREJ
+    for (auto frame = srej_saved_frames_.find(buffer_seq_); frame != srej_saved_frames_.end();
+         frame = srej_saved_frames_.find(buffer_seq_)) {
+      auto [sar, sdu_size, payload] = frame->second;
+      srej_saved_frames_.erase(frame);
+      data_indication(sar, sdu_size, payload);
+    }
   }
 };
 
 // Segmentation is handled here
 void ErtmController::OnSdu(std::unique_ptr<packet::BasePacketBuilder> sdu) {
   auto sdu_size = sdu->size();
-  std::vector<std::unique_ptr<packet::RawBuilder>> segments;
   auto size_each_packet = (remote_mps_ - 4 /* basic L2CAP header */ - 2 /* SDU length */ - 2 /* Enhanced control */ -
                            (fcs_enabled_ ? 2 : 0));
-  packet::FragmentingInserter fragmenting_inserter(size_each_packet, std::back_insert_iterator(segments));
-  sdu->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
+  auto segments = packet::ViewBuilder::Fragment(*sdu, size_each_packet);
   if (segments.size() == 1) {
     pimpl_->data_request(SegmentationAndReassembly::UNSEGMENTED, std::move(segments[0]));
     return;
@@ -830,6 +928,8 @@ void ErtmController::OnSdu(std::unique_ptr<packet::BasePacketBuilder> sdu) {
 }
 
 void ErtmController::OnPdu(packet::PacketView<true> pdu) {
+  pdus_received_++;
+  bytes_received_ += pdu.size();
   if (fcs_enabled_) {
     on_pdu_fcs(pdu);
   } else {
@@ -976,6 +1076,7 @@ void ErtmController::stage_for_reassembly(SegmentationAndReassembly sar, uint16_
       }
       // TODO: Enforce MTU
       enqueue_buffer_.Enqueue(std::make_unique<packet::PacketView<kLittleEndian>>(payload), handler_);
+      sdus_received_++;
       if (enqueue_buffer_.Size() == kEnqueueBufferBusyThreshold) {
         pimpl_->local_busy_detected();
         enqueue_buffer_.NotifyOnEmpty(common::BindOnce(&impl::local_busy_clear, common::Unretained(pimpl_.get())));
@@ -1019,6 +1120,7 @@ void ErtmController::stage_for_reassembly(SegmentationAndReassembly sar, uint16_
       }
       reassembly_stage_.AppendPacketView(payload);
       enqueue_buffer_.Enqueue(std::make_unique<packet::PacketView<kLittleEndian>>(reassembly_stage_), handler_);
+      sdus_received_++;
       if (enqueue_buffer_.Size() == kEnqueueBufferBusyThreshold) {
         pimpl_->local_busy_detected();
         enqueue_buffer_.NotifyOnEmpty(common::BindOnce(&impl::local_busy_clear, common::Unretained(pimpl_.get())));
@@ -1027,6 +1129,14 @@ void ErtmController::stage_for_reassembly(SegmentationAndReassembly sar, uint16_
   }
 }
 
+void ErtmController::GetStats(ChannelStats* stats) const {
+  stats->sdus_received = sdus_received_;
+  stats->pdus_received = pdus_received_;
+  stats->bytes_received = bytes_received_;
+  stats->retransmissions = retransmissions_;
+  stats->rx_queue_depth = enqueue_buffer_.Size();
+}
+
 void ErtmController::EnableFcs(bool enabled) {
   fcs_enabled_ = enabled;
 }
@@ -1039,6 +1149,7 @@ void ErtmController::send_pdu(std::unique_ptr<packet::BasePacketBuilder> pdu) {
 void ErtmController::SetRetransmissionAndFlowControlOptions(
     const RetransmissionAndFlowControlConfigurationOption& option) {
   remote_tx_window_ = option.tx_window_size_;
+  pimpl_->tx_window_ = remote_tx_window_;
   local_max_transmit_ = option.max_transmit_;
   local_retransmit_timeout_ms_ = option.retransmission_time_out_;
   local_monitor_timeout_ms_ = option.monitor_time_out_;
@@ -1049,14 +1160,6 @@ void ErtmController::close_channel() {
   link_->SendDisconnectionRequest(cid_, remote_cid_);
 }
 
-size_t ErtmController::CopyablePacketBuilder::size() const {
-  return builder_->size();
-}
-
-void ErtmController::CopyablePacketBuilder::Serialize(BitInserter& it) const {
-  builder_->Serialize(it);
-}
-
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -31,7 +31,7 @@
 #include "os/queue.h"
 #include "packet/base_packet_builder.h"
 #include "packet/packet_view.h"
-#include "packet/raw_builder.h"
+#include "packet/view_builder.h"
 
 namespace bluetooth {
 namespace l2cap {
@@ -52,6 +52,7 @@ class ErtmController : public DataController {
   std::unique_ptr<packet::BasePacketBuilder> GetNextPacket() override;
   void EnableFcs(bool enabled) override;
   void SetRetransmissionAndFlowControlOptions(const RetransmissionAndFlowControlConfigurationOption& option) override;
+  void GetStats(ChannelStats* stats) const override;
 
  private:
   ILink* link_;
@@ -80,22 +81,15 @@ class ErtmController : public DataController {
     }
   };
 
-  class CopyablePacketBuilder : public packet::BasePacketBuilder {
-   public:
-    CopyablePacketBuilder(std::shared_ptr<packet::RawBuilder> builder) : builder_(std::move(builder)) {}
-
-    void Serialize(BitInserter& it) const override;
-
-    size_t size() const override;
-
-   private:
-    std::shared_ptr<packet::RawBuilder> builder_;
-  };
-
   PacketViewForReassembly reassembly_stage_{PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
   SegmentationAndReassembly sar_state_ = SegmentationAndReassembly::END;
   uint16_t remaining_sdu_continuation_packet_size_ = 0;
 
+  uint64_t sdus_received_ = 0;
+  uint64_t pdus_received_ = 0;
+  uint64_t bytes_received_ = 0;
+  uint64_t retransmissions_ = 0;
+
   void stage_for_reassembly(SegmentationAndReassembly sar, uint16_t sdu_size,
                             const packet::PacketView<kLittleEndian>& payload);
   void send_pdu(std::unique_ptr<packet::BasePacketBuilder> pdu);
@@ -42,6 +42,18 @@ PacketView<kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilde
   return packet::PacketView<packet::kLittleEndian>(bytes);
 }
 
+std::unique_ptr<packet::BasePacketBuilder> CreateIFrame(uint8_t tx_seq, std::vector<uint8_t> payload) {
+  return EnhancedInformationFrameBuilder::Create(1, tx_seq, Final::NOT_SET, 0, SegmentationAndReassembly::UNSEGMENTED,
+                                                 CreateSdu(std::move(payload)));
+}
+
+EnhancedSupervisoryFrameView GetSFrameView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto view = GetPacketView(std::move(packet));
+  auto s_frame_view = EnhancedSupervisoryFrameView::Create(StandardFrameView::Create(BasicFrameView::Create(view)));
+  EXPECT_TRUE(s_frame_view.IsValid());
+  return s_frame_view;
+}
+
 void sync_handler(os::Handler* handler) {
   std::promise<void> promise;
   auto future = promise.get_future();
@@ -204,6 +216,59 @@ TEST_F(ErtmDataControllerTest, receive_packet_with_fcs) {
   EXPECT_EQ(data, "abcd");
 }
 
+TEST_F(ErtmDataControllerTest, receive_out_of_sequence_sends_srej) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.OnPdu(GetPacketView(CreateIFrame(0, {'a'})));
+  auto rr_view = GetSFrameView(controller.GetNextPacket());
+  EXPECT_EQ(rr_view.GetS(), SupervisoryFunction::RECEIVER_READY);
+  EXPECT_EQ(rr_view.GetReqSeq(), 1);
+  sync_handler(queue_handler_);
+  EXPECT_NE(channel_queue.GetUpEnd()->TryDequeue(), nullptr);
+
+  // Frame 1 is lost: only it is requested, frame 2 is kept until it arrives
+  controller.OnPdu(GetPacketView(CreateIFrame(2, {'c'})));
+  auto srej_view = GetSFrameView(controller.GetNextPacket());
+  EXPECT_EQ(srej_view.GetS(), SupervisoryFunction::SELECT_REJECT);
+  EXPECT_EQ(srej_view.GetReqSeq(), 1);
+  sync_handler(queue_handler_);
+  EXPECT_EQ(channel_queue.GetUpEnd()->TryDequeue(), nullptr);
+
+  controller.OnPdu(GetPacketView(CreateIFrame(1, {'b'})));
+  rr_view = GetSFrameView(controller.GetNextPacket());
+  EXPECT_EQ(rr_view.GetS(), SupervisoryFunction::RECEIVER_READY);
+  EXPECT_EQ(rr_view.GetReqSeq(), 3);
+  sync_handler(queue_handler_);
+  auto payload = channel_queue.GetUpEnd()->TryDequeue();
+  ASSERT_NE(payload, nullptr);
+  EXPECT_EQ(std::string(payload->begin(), payload->end()), "b");
+  payload = channel_queue.GetUpEnd()->TryDequeue();
+  ASSERT_NE(payload, nullptr);
+  EXPECT_EQ(std::string(payload->begin(), payload->end()), "c");
+}
+
+TEST_F(ErtmDataControllerTest, srej_retransmits_only_the_requested_frame) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  for (uint8_t data : {'a', 'b', 'c'}) {
+    controller.OnSdu(CreateSdu({data}));
+    controller.GetNextPacket();
+  }
+  auto srej =
+      EnhancedSupervisoryFrameBuilder::Create(1, SupervisoryFunction::SELECT_REJECT, Poll::NOT_SET, Final::NOT_SET, 1);
+  controller.OnPdu(GetPacketView(std::move(srej)));
+  auto view = GetPacketView(controller.GetNextPacket());
+  auto i_frame_view = EnhancedInformationFrameView::Create(StandardFrameView::Create(BasicFrameView::Create(view)));
+  ASSERT_TRUE(i_frame_view.IsValid());
+  EXPECT_EQ(i_frame_view.GetTxSeq(), 1);
+  auto payload = i_frame_view.GetPayload();
+  EXPECT_EQ(std::string(payload.begin(), payload.end()), "b");
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <type_traits>
 #include <unordered_map>
 
@@ -62,6 +63,7 @@ class FixedChannelAllocator {
         cid,
         ToLoggableStr(*link_).c_str());  // TODO RENAME ADDRESS_TO_LOGGABLE_CSTR
     ASSERT(elem.first->second != nullptr);
+    channel_by_cid_[cid] = elem.first->second;
     return elem.first->second;
   }
 
@@ -72,10 +74,11 @@ class FixedChannelAllocator {
                cid, ToLoggableStr(*link_).c_str());
 
     channels_.erase(cid);
+    channel_by_cid_[cid].reset();
   }
 
   virtual bool IsChannelAllocated(Cid cid) const {
-    return channels_.find(cid) != channels_.end();
+    return cid <= kLastFixedChannel && channel_by_cid_[cid] != nullptr;
   }
 
   virtual std::shared_ptr<FixedChannelImplType> FindChannel(Cid cid) {
@@ -83,7 +86,7 @@ class FixedChannelAllocator {
                "Channel is not in use: cid %d, link %s",
                cid, ToLoggableStr(*link_).c_str());
 
-    return channels_.find(cid)->second;
+    return channel_by_cid_[cid];
   }
 
   virtual size_t NumberOfChannels() const {
@@ -111,6 +114,8 @@ class FixedChannelAllocator {
   LinkType* link_;
   os::Handler* l2cap_handler_;
   std::unordered_map<Cid, std::shared_ptr<FixedChannelImplType>> channels_;
+  // The channels of channels_ indexed by cid, for lookups on the receive path
+  std::array<std::shared_ptr<FixedChannelImplType>, kLastFixedChannel + 1> channel_by_cid_;
 };
 
 }  // namespace internal
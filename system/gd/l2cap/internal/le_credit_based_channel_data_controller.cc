@@ -16,15 +16,27 @@
 
 #include "l2cap/internal/le_credit_based_channel_data_controller.h"
 
+#include <algorithm>
+
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/le/internal/link.h"
-#include "packet/fragmenting_inserter.h"
-#include "packet/raw_builder.h"
+#include "packet/view_builder.h"
 
 namespace bluetooth {
 namespace l2cap {
 namespace internal {
 
+namespace {
+// Memory reserved for the PDUs of one channel, granted or held until the upper layer dequeues them
+constexpr uint32_t kMaxReservedBytesPerChannel = 64 * 1024;
+// If the enqueue buffer holds this many SDUs, credits are withheld until it is empty
+constexpr size_t kEnqueueBufferBusyThreshold = 3;
+// The time for credits to reach the remote and its PDUs sent with them to come back, over a couple of connection
+// events each way
+constexpr std::chrono::milliseconds kCreditRoundTrip(100);
+constexpr std::chrono::milliseconds kRateSampleInterval(200);
+}  // namespace
+
 LeCreditBasedDataController::LeCreditBasedDataController(ILink* link, Cid cid, Cid remote_cid,
                                                          UpperQueueDownEnd* channel_queue_end, os::Handler* handler,
                                                          Scheduler* scheduler)
@@ -40,11 +52,8 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
   if (sdu_size > mtu_) {
     LOG_WARN("Received sdu_size %d > mtu %d", static_cast<int>(sdu_size), mtu_);
   }
-  std::vector<std::unique_ptr<packet::RawBuilder>> segments;
   // TODO: We don't need to waste 2 bytes for continuation segment.
-  packet::FragmentingInserter fragmenting_inserter(mps_ - 2, std::back_insert_iterator(segments));
-  sdu->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
+  auto segments = packet::ViewBuilder::Fragment(*sdu, mps_ - 2);
   std::unique_ptr<BasicFrameBuilder> builder;
   builder = FirstLeInformationFrameBuilder::Create(remote_cid_, sdu_size, std::move(segments[0]));
   pdu_queue_.emplace(std::move(builder));
@@ -65,6 +74,8 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
 }
 
 void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
+  pdus_received_++;
+  bytes_received_ += pdu.size();
   auto basic_frame_view = BasicFrameView::Create(pdu);
   if (!basic_frame_view.IsValid()) {
     LOG_WARN("Received invalid frame");
@@ -89,16 +100,31 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
     remaining_sdu_continuation_packet_size_ -= payload.size();
     reassembly_stage_.AppendPacketView(payload);
   }
+  pdus_in_reassembly_++;
   if (remaining_sdu_continuation_packet_size_ == 0) {
     enqueue_buffer_.Enqueue(std::make_unique<PacketView<kLittleEndian>>(reassembly_stage_), handler_);
+    sdus_received_++;
+    pdus_in_enqueue_buffer_ += pdus_in_reassembly_;
+    pdus_in_reassembly_ = 0;
+    if (!notify_on_empty_registered_) {
+      notify_on_empty_registered_ = true;
+      enqueue_buffer_.NotifyOnEmpty(
+          common::BindOnce(&LeCreditBasedDataController::on_enqueue_buffer_empty, common::Unretained(this)));
+    }
   } else if (remaining_sdu_continuation_packet_size_ < 0 || reassembly_stage_.size() > mtu_) {
     LOG_WARN("Received larger SDU size than expected");
     reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
     remaining_sdu_continuation_packet_size_ = 0;
+    pdus_in_reassembly_ = 0;
     link_->SendDisconnectionRequest(cid_, remote_cid_);
   }
-  // TODO: Improve the logic by sending credit only after user dequeued the SDU
-  link_->SendLeCredit(cid_, 1);
+  if (remote_credits_ == 0) {
+    LOG_WARN("Received frame while the remote has no credit");
+  } else {
+    remote_credits_--;
+  }
+  measure_remote_send_rate();
+  replenish_credits();
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
@@ -133,6 +159,74 @@ void LeCreditBasedDataController::OnCredit(uint16_t credits) {
   }
 }
 
+void LeCreditBasedDataController::SetInitialGrantedCredits(uint16_t credits) {
+  initial_granted_credits_ = credits;
+  remote_credits_ = credits;
+}
+
+void LeCreditBasedDataController::PreGrantCredits(uint32_t bandwidth_delay_product_bytes) {
+  uint32_t credits = (bandwidth_delay_product_bytes + mps_ - 1) / mps_;
+  pre_granted_credits_ = std::min<uint32_t>(credits, 0xffff);
+  replenish_credits();
+}
+
+void LeCreditBasedDataController::GetStats(ChannelStats* stats) const {
+  stats->sdus_received = sdus_received_;
+  stats->pdus_received = pdus_received_;
+  stats->bytes_received = bytes_received_;
+  stats->rx_queue_depth = enqueue_buffer_.Size();
+}
+
+void LeCreditBasedDataController::measure_remote_send_rate() {
+  auto now = std::chrono::steady_clock::now();
+  if (pdus_in_rate_sample_ == 0) {
+    rate_sample_start_ = now;
+  }
+  pdus_in_rate_sample_++;
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - rate_sample_start_);
+  if (elapsed < kRateSampleInterval) {
+    return;
+  }
+  uint32_t pdus_per_second = pdus_in_rate_sample_ * 1000 / elapsed.count();
+  remote_pdus_per_second_ =
+      remote_pdus_per_second_ == 0 ? pdus_per_second : (3 * remote_pdus_per_second_ + pdus_per_second) / 4;
+  pdus_in_rate_sample_ = 0;
+}
+
+uint16_t LeCreditBasedDataController::credit_target() const {
+  uint32_t rate_credits = (remote_pdus_per_second_ * kCreditRoundTrip.count() + 999) / 1000;
+  uint32_t target = std::max({rate_credits, static_cast<uint32_t>(initial_granted_credits_),
+                              static_cast<uint32_t>(pre_granted_credits_), static_cast<uint32_t>(1)});
+  uint32_t max_credits = std::max(kMaxReservedBytesPerChannel / mps_, static_cast<uint32_t>(1));
+  if (pdus_in_enqueue_buffer_ >= max_credits) {
+    return 0;
+  }
+  return std::min({target, max_credits - pdus_in_enqueue_buffer_, static_cast<uint32_t>(0xffff)});
+}
+
+void LeCreditBasedDataController::replenish_credits() {
+  if (enqueue_buffer_.Size() >= kEnqueueBufferBusyThreshold) {
+    // Wait for the upper layer to dequeue
+    return;
+  }
+  auto target = credit_target();
+  if (remote_credits_ > target / 2) {
+    return;
+  }
+  uint16_t credits = target - remote_credits_;
+  if (credits == 0) {
+    return;
+  }
+  remote_credits_ += credits;
+  link_->SendLeCredit(cid_, credits);
+}
+
+void LeCreditBasedDataController::on_enqueue_buffer_empty() {
+  notify_on_empty_registered_ = false;
+  pdus_in_enqueue_buffer_ = 0;
+  replenish_credits();
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -58,6 +59,14 @@ class LeCreditBasedDataController : public DataController {
   // TODO: Handle credits
   void OnCredit(uint16_t credits);
 
+  // The credits we granted to the remote in the connection request or response
+  void SetInitialGrantedCredits(uint16_t credits);
+  // Keep enough credits granted to the remote to cover the given bandwidth-delay product, for bulk transfers. The
+  // credits are still capped by the memory we reserve for each channel.
+  void PreGrantCredits(uint32_t bandwidth_delay_product_bytes);
+
+  void GetStats(ChannelStats* stats) const override;
+
  private:
   Cid cid_;
   Cid remote_cid_;
@@ -80,6 +89,28 @@ class LeCreditBasedDataController : public DataController {
   };
   PacketViewForReassembly reassembly_stage_{PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
   uint16_t remaining_sdu_continuation_packet_size_ = 0;
+  uint64_t sdus_received_ = 0;
+  uint64_t pdus_received_ = 0;
+  uint64_t bytes_received_ = 0;
+
+  // Receive credits: instead of returning one credit per PDU, credits are returned in a batch when the remote is down
+  // to half of the target, which covers the measured send rate of the remote over the credit round trip. Credits are
+  // withheld while the upper layer doesn't dequeue, and the PDUs held in the enqueue buffer count towards the memory
+  // reserved for the channel.
+  uint16_t remote_credits_ = 0;
+  uint16_t initial_granted_credits_ = 0;
+  uint16_t pre_granted_credits_ = 0;
+  uint16_t pdus_in_reassembly_ = 0;
+  uint32_t pdus_in_enqueue_buffer_ = 0;
+  bool notify_on_empty_registered_ = false;
+  std::chrono::steady_clock::time_point rate_sample_start_;
+  uint32_t pdus_in_rate_sample_ = 0;
+  uint32_t remote_pdus_per_second_ = 0;
+
+  void measure_remote_send_rate();
+  uint16_t credit_target() const;
+  void replenish_credits();
+  void on_enqueue_buffer_empty();
 };
 
 }  // namespace internal
@@ -179,6 +179,35 @@ TEST_F(LeCreditBasedDataControllerTest, receive_segmented_with_wrong_sdu_length)
   EXPECT_EQ(payload, nullptr);
 }
 
+TEST_F(LeCreditBasedDataControllerTest, credits_are_returned_in_a_batch) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetInitialGrantedCredits(10);
+  // Nothing is returned until the remote is down to half of its credits
+  EXPECT_CALL(link, SendLeCredit(0x41, 5));
+  for (uint8_t i = 0; i < 5; i++) {
+    controller.OnPdu(GetPacketView(FirstLeInformationFrameBuilder::Create(0x41, 1, CreateSdu({i}))));
+    sync_handler(queue_handler_);
+    EXPECT_NE(channel_queue.GetUpEnd()->TryDequeue(), nullptr);
+  }
+}
+
+TEST_F(LeCreditBasedDataControllerTest, pre_grant_credits_for_bandwidth_delay_product) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetMps(100);
+  controller.SetInitialGrantedCredits(10);
+  EXPECT_CALL(link, SendLeCredit(0x41, 30));
+  controller.PreGrantCredits(4000);
+  // The memory reserved for the channel caps the credits
+  EXPECT_CALL(link, SendLeCredit(0x41, 615));
+  controller.PreGrantCredits(1000000);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
@@ -22,6 +22,7 @@
 #include "l2cap/cid.h"
 #include "l2cap/classic/dynamic_channel_configuration_option.h"
 #include "l2cap/internal/channel_impl.h"
+#include "l2cap/internal/channel_stats.h"
 #include "l2cap/internal/data_controller.h"
 #include "l2cap/internal/sender.h"
 #include "l2cap/l2cap_packets.h"
@@ -32,6 +33,16 @@ namespace bluetooth {
 namespace l2cap {
 namespace internal {
 
+/**
+ * The class of traffic of a channel, telling how long its packets can wait for the link. Listed from the most to the
+ * least urgent.
+ */
+enum class TxPriorityClass {
+  MEDIA,       // Audio, e.g. the A2DP media channel
+  SIGNALLING,  // L2CAP and profile signalling, e.g. AVDTP, AVCTP, ATT
+  BULK,        // Transfers, e.g. OBEX
+};
+
 /**
  * Handle the scheduling of packets through the l2cap stack.
  * For each attached channel, dequeue its outgoing packets and enqueue it to the given LinkQueueUpEnd, according to some
@@ -60,11 +71,21 @@ class Scheduler {
    */
   virtual void SetChannelTxPriority(Cid cid, bool high_priority) {}
 
+  /**
+   * Set the class of traffic of a channel, for schedulers that tell them apart.
+   */
+  virtual void SetChannelTxPriorityClass(Cid cid, TxPriorityClass priority_class) {}
+
   /**
    * Called by data controller to indicate that a channel is closed and packets should be dropped
    */
   virtual void RemoveChannel(Cid cid) {}
 
+  /**
+   * Fill the transmit queue depth and the time in queue of a channel in stats, for schedulers that keep them.
+   */
+  virtual void GetStats(Cid cid, ChannelStats* stats) const {}
+
   virtual ~Scheduler() = default;
 };
 
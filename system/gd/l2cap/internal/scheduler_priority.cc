@@ -0,0 +1,220 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_priority.h"
+
+#include <algorithm>
+
+#include "common/bind.h"
+#include "l2cap/internal/data_pipeline_manager.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+namespace {
+constexpr Psm kHidControlPsm = 0x0011;
+constexpr Psm kHidInterruptPsm = 0x0013;
+constexpr Psm kAvctpPsm = 0x0017;
+constexpr Psm kAvdtpPsm = 0x0019;
+constexpr Psm kAvctpBrowsingPsm = 0x001B;
+
+int64_t to_us(PriorityScheduler::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}  // namespace
+
+PriorityScheduler::PriorityScheduler(
+    DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler)
+    : data_pipeline_manager_(data_pipeline_manager), link_queue_up_end_(link_queue_up_end), handler_(handler) {
+  ASSERT(link_queue_up_end_ != nullptr && handler_ != nullptr);
+}
+
+// Invoked from some external Handler context
+PriorityScheduler::~PriorityScheduler() {
+  if (link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+PriorityScheduler::Clock::duration PriorityScheduler::GetDeadline(TxPriorityClass priority_class) {
+  switch (priority_class) {
+    case TxPriorityClass::MEDIA:
+      return std::chrono::milliseconds(0);
+    case TxPriorityClass::SIGNALLING:
+      return std::chrono::milliseconds(20);
+    case TxPriorityClass::BULK:
+      return std::chrono::milliseconds(200);
+  }
+  return std::chrono::milliseconds(200);
+}
+
+TxPriorityClass PriorityScheduler::GetDefaultTxPriorityClass(Psm psm) {
+  switch (psm) {
+    case kHidControlPsm:
+    case kHidInterruptPsm:
+    case kAvctpPsm:
+    case kAvdtpPsm:
+    case kAvctpBrowsingPsm:
+      // The A2DP media channel is AVDTP as well, it becomes media with SetChannelTxPriority
+      return TxPriorityClass::SIGNALLING;
+    default:
+      return TxPriorityClass::BULK;
+  }
+}
+
+// Invoked within L2CAP Handler context
+void PriorityScheduler::OnPacketsReady(Cid cid, int number_packets) {
+  if (number_packets == 0) {
+    return;
+  }
+  get_channel(cid).ready_packets.emplace_back(Clock::now(), number_packets);
+  num_ready_packets_ += number_packets;
+  try_register_link_queue_enqueue();
+}
+
+// Invoked within L2CAP Handler context
+void PriorityScheduler::SetChannelTxPriority(Cid cid, bool high_priority) {
+  // Channels are reset to low priority when detached, don't bring them back
+  if (!high_priority && channels_.find(cid) == channels_.end()) {
+    return;
+  }
+  get_channel(cid).high_priority = high_priority;
+}
+
+// Invoked within L2CAP Handler context
+void PriorityScheduler::SetChannelTxPriorityClass(Cid cid, TxPriorityClass priority_class) {
+  get_channel(cid).priority_class = priority_class;
+}
+
+void PriorityScheduler::RemoveChannel(Cid cid) {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end()) {
+    return;
+  }
+  const auto& queueing_delay = channel->second.queueing_delay;
+  if (queueing_delay.num_packets != 0) {
+    LOG_INFO(
+        "cid:0x%04x sent %lu packets, queueing delay average:%ldus max:%ldus",
+        cid,
+        static_cast<unsigned long>(queueing_delay.num_packets),
+        static_cast<long>(to_us(queueing_delay.total_delay) / queueing_delay.num_packets),
+        static_cast<long>(to_us(queueing_delay.max_delay)));
+  }
+  for (const auto& ready_packets : channel->second.ready_packets) {
+    num_ready_packets_ -= ready_packets.second;
+  }
+  channels_.erase(channel);
+  try_unregister_link_queue_enqueue();
+}
+
+PriorityScheduler::QueueingDelayStats PriorityScheduler::GetQueueingDelayStats(Cid cid) const {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end()) {
+    return {};
+  }
+  return channel->second.queueing_delay;
+}
+
+void PriorityScheduler::GetStats(Cid cid, ChannelStats* stats) const {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end()) {
+    return;
+  }
+  const auto& queueing_delay = channel->second.queueing_delay;
+  stats->pdus_sent = queueing_delay.num_packets;
+  stats->tx_queue_depth = 0;
+  for (const auto& ready_packets : channel->second.ready_packets) {
+    stats->tx_queue_depth += ready_packets.second;
+  }
+  stats->time_in_queue_p50 = queueing_delay.histogram.Percentile(50);
+  stats->time_in_queue_p90 = queueing_delay.histogram.Percentile(90);
+  stats->time_in_queue_p99 = queueing_delay.histogram.Percentile(99);
+  stats->time_in_queue_max = std::chrono::duration_cast<std::chrono::microseconds>(queueing_delay.max_delay);
+}
+
+PriorityScheduler::Channel& PriorityScheduler::get_channel(Cid cid) {
+  auto channel = channels_.find(cid);
+  if (channel == channels_.end()) {
+    TxPriorityClass priority_class = cid < kFirstDynamicChannel ? TxPriorityClass::SIGNALLING : TxPriorityClass::BULK;
+    channel = channels_.emplace(cid, Channel{.priority_class = priority_class}).first;
+  }
+  return channel->second;
+}
+
+TxPriorityClass PriorityScheduler::get_priority_class(const Channel& channel) const {
+  return channel.high_priority ? TxPriorityClass::MEDIA : channel.priority_class;
+}
+
+// Invoked from some external Queue Reactable context
+std::unique_ptr<PriorityScheduler::UpperDequeue> PriorityScheduler::link_queue_enqueue_callback() {
+  ASSERT(num_ready_packets_ != 0);
+
+  // Earliest deadline first, the most urgent class first between equal deadlines
+  Cid next_cid = kInvalidCid;
+  Channel* next_channel = nullptr;
+  Clock::time_point next_deadline;
+  for (auto& [cid, channel] : channels_) {
+    if (channel.ready_packets.empty()) {
+      continue;
+    }
+    auto priority_class = get_priority_class(channel);
+    auto deadline = channel.ready_packets.front().first + GetDeadline(priority_class);
+    if (next_channel == nullptr || deadline < next_deadline ||
+        (deadline == next_deadline && priority_class < get_priority_class(*next_channel))) {
+      next_cid = cid;
+      next_channel = &channel;
+      next_deadline = deadline;
+    }
+  }
+  ASSERT(next_channel != nullptr);
+
+  auto& ready_packets = next_channel->ready_packets.front();
+  auto queueing_delay = Clock::now() - ready_packets.first;
+  auto& stats = next_channel->queueing_delay;
+  stats.num_packets++;
+  stats.total_delay += queueing_delay;
+  stats.max_delay = std::max(stats.max_delay, queueing_delay);
+  stats.histogram.Add(std::chrono::duration_cast<std::chrono::microseconds>(queueing_delay));
+  if (--ready_packets.second == 0) {
+    next_channel->ready_packets.pop_front();
+  }
+  num_ready_packets_--;
+
+  auto packet = data_pipeline_manager_->GetDataController(next_cid)->GetNextPacket();
+  data_pipeline_manager_->OnPacketSent(next_cid);
+  try_unregister_link_queue_enqueue();
+  return packet;
+}
+
+void PriorityScheduler::try_register_link_queue_enqueue() {
+  if (link_queue_enqueue_registered_.exchange(true)) {
+    return;
+  }
+  link_queue_up_end_->RegisterEnqueue(
+      handler_, common::Bind(&PriorityScheduler::link_queue_enqueue_callback, common::Unretained(this)));
+}
+
+void PriorityScheduler::try_unregister_link_queue_enqueue() {
+  if (num_ready_packets_ == 0 && link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+#include "l2cap/cid.h"
+#include "l2cap/internal/scheduler.h"
+#include "l2cap/psm.h"
+#include "os/handler.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+class DataPipelineManager;
+
+/**
+ * Schedule the packets of the channels of a link by deadline. The packets made ready by a channel are due after the
+ * queueing delay its class of traffic tolerates, and the link takes the packet due first. Media goes before signalling,
+ * which goes before bulk transfers, but a bulk transfer is not starved by a steady stream of more urgent traffic.
+ *
+ * Channels are signalling when fixed, and bulk when dynamic, until told otherwise. A high priority channel (See
+ * SetChannelTxPriority) is media.
+ */
+class PriorityScheduler : public Scheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct QueueingDelayStats {
+    uint64_t num_packets = 0;
+    Clock::duration total_delay{0};
+    Clock::duration max_delay{0};
+    DurationHistogram histogram;
+  };
+
+  PriorityScheduler(
+      DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler);
+  ~PriorityScheduler();
+  void OnPacketsReady(Cid cid, int number_packets) override;
+  void SetChannelTxPriority(Cid cid, bool high_priority) override;
+  void SetChannelTxPriorityClass(Cid cid, TxPriorityClass priority_class) override;
+  void RemoveChannel(Cid cid) override;
+  void GetStats(Cid cid, ChannelStats* stats) const override;
+
+  // The queueing delay of the packets of a channel sent so far
+  QueueingDelayStats GetQueueingDelayStats(Cid cid) const;
+
+  // The queueing delay tolerated by a class of traffic
+  static Clock::duration GetDeadline(TxPriorityClass priority_class);
+
+  // The class of traffic of a classic dynamic channel, from its PSM
+  static TxPriorityClass GetDefaultTxPriorityClass(Psm psm);
+
+ private:
+  struct Channel {
+    TxPriorityClass priority_class;
+    bool high_priority = false;
+    // When packets were made ready, and how many
+    std::deque<std::pair<Clock::time_point, int>> ready_packets;
+    QueueingDelayStats queueing_delay;
+  };
+
+  DataPipelineManager* data_pipeline_manager_;
+  LowerQueueUpEnd* link_queue_up_end_;
+  os::Handler* handler_;
+  std::unordered_map<Cid, Channel> channels_;
+  size_t num_ready_packets_ = 0;
+  std::atomic_bool link_queue_enqueue_registered_ = false;
+
+  Channel& get_channel(Cid cid);
+  TxPriorityClass get_priority_class(const Channel& channel) const;
+  void try_register_link_queue_enqueue();
+  void try_unregister_link_queue_enqueue();
+  std::unique_ptr<LowerEnqueue> link_queue_enqueue_callback();
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_priority.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "l2cap/internal/channel_impl_mock.h"
+#include "l2cap/internal/data_controller_mock.h"
+#include "l2cap/internal/data_pipeline_manager_mock.h"
+#include "os/handler.h"
+#include "os/mock_queue.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+
+constexpr Cid kBulkCid = 0x40;
+constexpr Cid kMediaCid = 0x41;
+
+std::unique_ptr<packet::BasePacketBuilder> CreateSdu(std::vector<uint8_t> payload) {
+  auto raw_builder = std::make_unique<packet::RawBuilder>();
+  raw_builder->AddOctets(payload);
+  return raw_builder;
+}
+
+PacketView<kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter i(*bytes);
+  bytes->reserve(packet->size());
+  packet->Serialize(i);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+class MyDataController : public testing::MockDataController {
+ public:
+  std::unique_ptr<BasePacketBuilder> GetNextPacket() override {
+    auto next = std::move(next_packets.front());
+    next_packets.pop();
+    return next;
+  }
+
+  std::queue<std::unique_ptr<BasePacketBuilder>> next_packets;
+};
+
+class L2capSchedulerPriorityTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    queue_handler_ = new os::Handler(thread_);
+    mock_data_pipeline_manager_ = new testing::MockDataPipelineManager(queue_handler_, &queue_end_);
+    scheduler_ = new PriorityScheduler(mock_data_pipeline_manager_, &queue_end_, queue_handler_);
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(kClassicSignallingCid))
+        .WillRepeatedly(Return(&signalling_data_controller_));
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(kBulkCid))
+        .WillRepeatedly(Return(&bulk_data_controller_));
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(kMediaCid))
+        .WillRepeatedly(Return(&media_data_controller_));
+  }
+
+  void TearDown() override {
+    delete scheduler_;
+    delete mock_data_pipeline_manager_;
+    queue_handler_->Clear();
+    delete queue_handler_;
+    delete thread_;
+  }
+
+  void push_packet(MyDataController& data_controller, Cid cid, std::vector<uint8_t> payload) {
+    data_controller.next_packets.push(BasicFrameBuilder::Create(cid, CreateSdu(payload)));
+  }
+
+  Cid pop_enqueued_cid() {
+    auto packet = std::move(enqueue_.enqueued.front());
+    enqueue_.enqueued.pop();
+    auto basic_frame_view = BasicFrameView::Create(GetPacketView(std::move(packet)));
+    EXPECT_TRUE(basic_frame_view.IsValid());
+    return basic_frame_view.GetChannelId();
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* queue_handler_ = nullptr;
+  os::MockIQueueDequeue<Scheduler::LowerDequeue> dequeue_;
+  os::MockIQueueEnqueue<Scheduler::LowerEnqueue> enqueue_;
+  common::BidiQueueEnd<Scheduler::LowerEnqueue, Scheduler::LowerDequeue> queue_end_{&enqueue_, &dequeue_};
+  testing::MockDataPipelineManager* mock_data_pipeline_manager_ = nullptr;
+  MyDataController signalling_data_controller_;
+  MyDataController bulk_data_controller_;
+  MyDataController media_data_controller_;
+  PriorityScheduler* scheduler_ = nullptr;
+};
+
+TEST_F(L2capSchedulerPriorityTest, send_packets_by_priority_class) {
+  push_packet(bulk_data_controller_, kBulkCid, {'a'});
+  push_packet(signalling_data_controller_, kClassicSignallingCid, {'b'});
+  push_packet(media_data_controller_, kMediaCid, {'c'});
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(3);
+
+  scheduler_->SetChannelTxPriority(kMediaCid, true);
+  scheduler_->OnPacketsReady(kBulkCid, 1);
+  scheduler_->OnPacketsReady(kClassicSignallingCid, 1);
+  scheduler_->OnPacketsReady(kMediaCid, 1);
+  enqueue_.run_enqueue(3);
+
+  ASSERT_EQ(pop_enqueued_cid(), kMediaCid);
+  ASSERT_EQ(pop_enqueued_cid(), kClassicSignallingCid);
+  ASSERT_EQ(pop_enqueued_cid(), kBulkCid);
+  ASSERT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerPriorityTest, set_priority_class) {
+  push_packet(bulk_data_controller_, kBulkCid, {'a'});
+  push_packet(signalling_data_controller_, kClassicSignallingCid, {'b'});
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(2);
+
+  scheduler_->SetChannelTxPriorityClass(kClassicSignallingCid, TxPriorityClass::BULK);
+  scheduler_->SetChannelTxPriorityClass(kBulkCid, TxPriorityClass::SIGNALLING);
+  scheduler_->OnPacketsReady(kClassicSignallingCid, 1);
+  scheduler_->OnPacketsReady(kBulkCid, 1);
+  enqueue_.run_enqueue(2);
+
+  ASSERT_EQ(pop_enqueued_cid(), kBulkCid);
+  ASSERT_EQ(pop_enqueued_cid(), kClassicSignallingCid);
+}
+
+TEST_F(L2capSchedulerPriorityTest, remove_channel) {
+  push_packet(bulk_data_controller_, kBulkCid, {'a'});
+  push_packet(bulk_data_controller_, kBulkCid, {'b'});
+  push_packet(signalling_data_controller_, kClassicSignallingCid, {'c'});
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(kBulkCid));
+
+  scheduler_->OnPacketsReady(kClassicSignallingCid, 1);
+  scheduler_->OnPacketsReady(kBulkCid, 2);
+  scheduler_->RemoveChannel(kClassicSignallingCid);
+  enqueue_.run_enqueue(1);
+  ASSERT_EQ(pop_enqueued_cid(), kBulkCid);
+  ASSERT_NE(enqueue_.registered_handler, nullptr);
+
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(kBulkCid)).Times(0);
+  scheduler_->RemoveChannel(kBulkCid);
+  ASSERT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerPriorityTest, queueing_delay_stats) {
+  push_packet(bulk_data_controller_, kBulkCid, {'a'});
+  push_packet(bulk_data_controller_, kBulkCid, {'b'});
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(kBulkCid)).Times(2);
+
+  scheduler_->OnPacketsReady(kBulkCid, 2);
+  enqueue_.run_enqueue(2);
+
+  auto stats = scheduler_->GetQueueingDelayStats(kBulkCid);
+  ASSERT_EQ(stats.num_packets, 2u);
+  ASSERT_LE(stats.max_delay, stats.total_delay);
+  ASSERT_EQ(scheduler_->GetQueueingDelayStats(kMediaCid).num_packets, 0u);
+}
+
+TEST_F(L2capSchedulerPriorityTest, channel_stats) {
+  push_packet(bulk_data_controller_, kBulkCid, {'a'});
+  push_packet(bulk_data_controller_, kBulkCid, {'b'});
+  push_packet(bulk_data_controller_, kBulkCid, {'c'});
+  EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(kBulkCid)).Times(2);
+
+  scheduler_->OnPacketsReady(kBulkCid, 3);
+  enqueue_.run_enqueue(2);
+
+  ChannelStats stats;
+  scheduler_->GetStats(kBulkCid, &stats);
+  ASSERT_EQ(stats.pdus_sent, 2u);
+  ASSERT_EQ(stats.tx_queue_depth, 1u);
+  ASSERT_LE(stats.time_in_queue_p50, stats.time_in_queue_p99);
+  ASSERT_GT(stats.time_in_queue_p99, std::chrono::microseconds(0));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
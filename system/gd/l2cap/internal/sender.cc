@@ -73,7 +73,33 @@ DataController* Sender::GetDataController() {
   return data_controller_.get();
 }
 
+void Sender::GetStats(ChannelStats* stats) const {
+  stats->sdus_sent = sdus_sent_;
+  stats->bytes_sent = bytes_sent_;
+  data_controller_->GetStats(stats);
+}
+
+void Sender::SetLinkCongested(bool congested) {
+  if (congested == link_congested_) {
+    return;
+  }
+  link_congested_ = congested;
+  if (congested) {
+    if (is_dequeue_registered_.exchange(false)) {
+      queue_end_->UnregisterDequeue();
+      dequeue_paused_ = true;
+    }
+  } else if (dequeue_paused_) {
+    dequeue_paused_ = false;
+    try_register_dequeue();
+  }
+}
+
 void Sender::try_register_dequeue() {
+  if (link_congested_) {
+    dequeue_paused_ = true;
+    return;
+  }
   if (is_dequeue_registered_.exchange(true)) {
     return;
   }
@@ -84,6 +110,8 @@ void Sender::try_register_dequeue() {
 void Sender::dequeue_callback() {
   auto packet = queue_end_->TryDequeue();
   ASSERT(packet != nullptr);
+  sdus_sent_++;
+  bytes_sent_ += packet->size();
   handler_->Post(
       common::BindOnce(&DataController::OnSdu, common::Unretained(data_controller_.get()), std::move(packet)));
   if (is_dequeue_registered_.exchange(false)) {
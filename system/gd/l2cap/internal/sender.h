@@ -26,6 +26,7 @@
 #include "l2cap/cid.h"
 #include "l2cap/classic/internal/channel_configuration_state.h"
 #include "l2cap/internal/channel_impl.h"
+#include "l2cap/internal/channel_stats.h"
 #include "l2cap/internal/data_controller.h"
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/mtu.h"
@@ -75,6 +76,17 @@ class Sender {
   void UpdateClassicConfiguration(classic::internal::ChannelConfigurationState config);
   DataController* GetDataController();
 
+  /**
+   * Called when the controller buffers of the link are used up (or available again). While the link is congested,
+   * sender leaves SDUs in the channel queue rather than segmenting packets that can't be sent anyway.
+   */
+  void SetLinkCongested(bool congested);
+
+  /**
+   * Fill the counters of the SDUs sent, and the ones of the data controller, in stats.
+   */
+  void GetStats(ChannelStats* stats) const;
+
  private:
   os::Handler* handler_;
   ILink* link_;
@@ -83,8 +95,12 @@ class Sender {
   const Cid channel_id_;
   const Cid remote_channel_id_;
   std::atomic_bool is_dequeue_registered_ = false;
+  bool link_congested_ = false;
+  bool dequeue_paused_ = false;  // Dequeue is to be registered once the link isn't congested anymore
   RetransmissionAndFlowControlModeOption mode_ = RetransmissionAndFlowControlModeOption::L2CAP_BASIC;
   std::unique_ptr<DataController> data_controller_;
+  uint64_t sdus_sent_ = 0;
+  uint64_t bytes_sent_ = 0;
 
   void try_register_dequeue();
   void dequeue_callback();
@@ -120,6 +120,20 @@ TEST_F(L2capSenderTest, send_packet) {
   EXPECT_EQ(payload_string, "abc");
 }
 
+TEST_F(L2capSenderTest, hold_sdus_while_link_is_congested) {
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  scheduler_.SetOnPacketsReady([&promise](Cid cid, int number_packets) { promise.set_value(); });
+  sender_->SetLinkCongested(true);
+  channel_queue_.GetUpEnd()->RegisterEnqueue(
+      queue_handler_, common::Bind(&L2capSenderTest::enqueue_callback, common::Unretained(this)));
+  EXPECT_EQ(future.wait_for(std::chrono::milliseconds(20)), std::future_status::timeout);
+
+  sender_->SetLinkCongested(false);
+  EXPECT_EQ(future.wait_for(std::chrono::milliseconds(100)), std::future_status::ready);
+  EXPECT_NE(sender_->GetNextPacket(), nullptr);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
@@ -297,6 +297,10 @@ void Link::ReadRemoteVersionInformation() {
   acl_connection_->ReadRemoteVersionInformation();
 }
 
+void Link::OnAclTxBackpressure(bool congested) {
+  data_pipeline_manager_.OnLinkCongestionChange(congested);
+}
+
 void Link::on_connection_update_complete(SignalId signal_id, hci::ErrorCode error_code) {
   if (!signal_id.IsValid()) {
     LOG_INFO("Invalid signal_id");
@@ -171,6 +171,9 @@ class Link : public l2cap::internal::ILink,
 
   void ReadRemoteVersionInformation();
 
+  // Invoked by LinkManager when the ACL scheduler asks to hold outgoing traffic back, or lets it go again
+  void OnAclTxBackpressure(bool congested);
+
   void OnPendingPacketChange(Cid local_cid, bool has_packet) override;
 
  private:
@@ -113,6 +113,8 @@ void LinkManager::OnLeConnectSuccess(hci::AddressWithType connecting_address_wit
   links_.try_emplace(connected_address_with_type, l2cap_handler_, std::move(acl_connection), parameter_provider_,
                      dynamic_channel_service_manager_, fixed_channel_service_manager_, this);
   auto* link = GetLink(connected_address_with_type);
+  acl_manager_->SetAclTxBackpressureCallback(
+      handle, l2cap_handler_->BindOn(this, &LinkManager::OnAclTxBackpressure, connected_address_with_type));
 
   if (link_property_callback_handler_ != nullptr) {
     link_property_callback_handler_->CallOn(
@@ -205,6 +207,14 @@ void LinkManager::OnReadRemoteVersionInformationComplete(
   }
 }
 
+void LinkManager::OnAclTxBackpressure(hci::AddressWithType remote, bool congested) {
+  auto* link = GetLink(remote);
+  if (link == nullptr) {
+    return;
+  }
+  link->OnAclTxBackpressure(congested);
+}
+
 void LinkManager::OnPendingPacketChange(hci::AddressWithType remote, int num_packets) {
   if (disconnected_links_.count(remote) != 0 && num_packets == 0) {
     links_.erase(remote);
@@ -102,6 +102,9 @@ class LinkManager : public hci::acl_manager::LeConnectionCallbacks {
   // If there is anything outstanding, don't delete link
   void OnPendingPacketChange(hci::AddressWithType remote, int num_packets);
 
+  // Backpressure from the ACL scheduler for the link to remote
+  void OnAclTxBackpressure(hci::AddressWithType remote, bool congested);
+
  private:
   // Dependencies
   os::Handler* l2cap_handler_;
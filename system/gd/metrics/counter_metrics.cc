@@ -17,6 +17,11 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <thread>
+
 #include "common/bind.h"
 #include "os/log.h"
 #include "os/metrics.h"
@@ -26,8 +31,111 @@ namespace metrics {
 
 const int COUNTER_METRICS_PERDIOD_MINUTES = 360; // Drain counters every 6 hours
 
+namespace {
+
+// Key of the free slots of a shard, the counters with this key go through the locked maps
+constexpr int32_t kEmptyKey = INT32_MIN;
+constexpr size_t kNumCounterSlots = 256;
+constexpr size_t kNumHistogramSlots = 16;
+
+std::atomic<uint64_t> next_instance_id{1};
+
+// Adds |count| to |total|, saturating at LLONG_MAX. Returns false if it overflowed.
+bool SaturatingAdd(int64_t& total, int64_t count) {
+  if (LLONG_MAX - total < count) {
+    total = LLONG_MAX;
+    return false;
+  }
+  total += count;
+  return true;
+}
+
+// Adds |count| to |value|, which is only written by the calling thread, so it needs no atomic read-modify-write
+bool SaturatingAdd(std::atomic<int64_t>& value, int64_t count) {
+  int64_t total = value.load(std::memory_order_relaxed);
+  bool ret = SaturatingAdd(total, count);
+  value.store(total, std::memory_order_relaxed);
+  return ret;
+}
+
+}  // namespace
+
+/**
+ * The counters and histograms of one thread. They are totals since the shard was created, only written by its
+ * thread, and the drain reports what they grew by since the previous drain.
+ */
+struct CounterMetrics::Shard {
+  struct CounterSlot {
+    std::atomic<int32_t> key{kEmptyKey};
+    std::atomic<int64_t> value{0};
+    // The value at the last drain, only accessed by the drain
+    int64_t drained = 0;
+  };
+
+  struct HistogramSlot {
+    std::atomic<int32_t> key{kEmptyKey};
+    std::array<std::atomic<int64_t>, CounterHistogram::kNumBuckets> buckets{};
+    std::atomic<int64_t> sum{0};
+    // The histogram at the last drain, only accessed by the drain
+    CounterHistogram drained;
+  };
+
+  // Returns the slot of |key|, claiming a free one the first time, or nullptr if they are all taken. Only called from
+  // the thread of the shard.
+  template <typename Slot, size_t N>
+  static Slot* Find(std::array<Slot, N>& slots, int32_t key) {
+    if (key == kEmptyKey) {
+      return nullptr;
+    }
+    size_t index = static_cast<uint32_t>(key) % N;
+    for (size_t i = 0; i < N; i++) {
+      Slot& slot = slots[(index + i) % N];
+      int32_t slot_key = slot.key.load(std::memory_order_relaxed);
+      if (slot_key == key) {
+        return &slot;
+      }
+      if (slot_key == kEmptyKey) {
+        slot.key.store(key, std::memory_order_release);
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  std::thread::id thread_id;
+  std::array<CounterSlot, kNumCounterSlots> counters;
+  std::array<HistogramSlot, kNumHistogramSlots> histograms;
+};
+
+size_t CounterHistogram::BucketOf(int64_t value) {
+  if (value <= 0) {
+    return 0;
+  }
+  size_t bucket = 64 - __builtin_clzll(static_cast<uint64_t>(value));
+  return std::min(bucket, kNumBuckets - 1);
+}
+
+int64_t CounterHistogram::Percentile(unsigned percent) const {
+  if (count == 0) {
+    return 0;
+  }
+  int64_t rank = std::max<int64_t>((count * percent + 99) / 100, 1);
+  int64_t samples = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+    samples += buckets[bucket];
+    if (samples >= rank) {
+      return bucket == 0 ? 0 : (int64_t{1} << bucket);
+    }
+  }
+  return int64_t{1} << (kNumBuckets - 1);
+}
+
 const ModuleFactory CounterMetrics::Factory = ModuleFactory([]() { return new CounterMetrics(); });
 
+CounterMetrics::CounterMetrics() : instance_id_(next_instance_id++) {}
+
+CounterMetrics::~CounterMetrics() = default;
+
 void CounterMetrics::ListDependencies(ModuleList* list) const {
 }
 
@@ -58,6 +166,15 @@ bool CounterMetrics::CacheCount(int32_t key, int64_t count) {
     LOG_WARN("count is not larger than 0. count: %s, key: %d", std::to_string(count).c_str(), key);
     return false;
   }
+  Shard::CounterSlot* slot = Shard::Find(GetShard()->counters, key);
+  if (slot != nullptr) {
+    if (!SaturatingAdd(slot->value, count)) {
+      LOG_WARN("Counter metric overflows. count %s key: %d", std::to_string(count).c_str(), key);
+      return false;
+    }
+    return true;
+  }
+
   int64_t total = 0;
   std::lock_guard<std::mutex> lock(mutex_);
   if (counters_.find(key) != counters_.end()) {
@@ -73,6 +190,53 @@ bool CounterMetrics::CacheCount(int32_t key, int64_t count) {
   return true;
 }
 
+bool CounterMetrics::CacheHistogram(int32_t key, int64_t value) {
+  if (!IsInitialized()) {
+    LOG_WARN("Counter metrics isn't initialized");
+    return false;
+  }
+  if (value < 0) {
+    LOG_WARN("value is negative. value: %s, key: %d", std::to_string(value).c_str(), key);
+    return false;
+  }
+  size_t bucket = CounterHistogram::BucketOf(value);
+  Shard::HistogramSlot* slot = Shard::Find(GetShard()->histograms, key);
+  if (slot != nullptr) {
+    SaturatingAdd(slot->buckets[bucket], 1);
+    SaturatingAdd(slot->sum, value);
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  CounterHistogram& histogram = histograms_[key];
+  histogram.buckets[bucket]++;
+  histogram.count++;
+  SaturatingAdd(histogram.sum, value);
+  return true;
+}
+
+CounterMetrics::Shard* CounterMetrics::GetShard() {
+  // The shard of the calling thread in the last instance it counted into
+  static thread_local uint64_t shard_instance_id = 0;
+  static thread_local Shard* shard = nullptr;
+  if (shard_instance_id == instance_id_) {
+    return shard;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto thread_id = std::this_thread::get_id();
+  auto it = std::find_if(
+      shards_.begin(), shards_.end(), [thread_id](const auto& shard) { return shard->thread_id == thread_id; });
+  if (it == shards_.end()) {
+    shards_.push_back(std::make_unique<Shard>());
+    shards_.back()->thread_id = thread_id;
+    it = std::prev(shards_.end());
+  }
+  shard = it->get();
+  shard_instance_id = instance_id_;
+  return shard;
+}
+
 bool CounterMetrics::Count(int32_t key, int64_t count) {
   if (!IsInitialized()) {
     LOG_WARN("Counter metrics isn't initialized");
@@ -93,10 +257,64 @@ void CounterMetrics::DrainBufferedCounters() {
   }
   std::lock_guard<std::mutex> lock(mutex_);
   LOG_INFO("Draining buffered counters");
+  for (auto& shard : shards_) {
+    for (auto& slot : shard->counters) {
+      int32_t key = slot.key.load(std::memory_order_acquire);
+      if (key == kEmptyKey) {
+        continue;
+      }
+      int64_t value = slot.value.load(std::memory_order_relaxed);
+      if (value > slot.drained) {
+        SaturatingAdd(counters_[key], value - slot.drained);
+        slot.drained = value;
+      }
+    }
+    for (auto& slot : shard->histograms) {
+      int32_t key = slot.key.load(std::memory_order_acquire);
+      if (key == kEmptyKey) {
+        continue;
+      }
+      CounterHistogram delta;
+      for (size_t bucket = 0; bucket < CounterHistogram::kNumBuckets; bucket++) {
+        int64_t samples = slot.buckets[bucket].load(std::memory_order_relaxed);
+        delta.buckets[bucket] = samples - slot.drained.buckets[bucket];
+        delta.count += delta.buckets[bucket];
+        slot.drained.buckets[bucket] = samples;
+      }
+      int64_t sum = slot.sum.load(std::memory_order_relaxed);
+      delta.sum = sum - slot.drained.sum;
+      slot.drained.sum = sum;
+      if (delta.count == 0) {
+        continue;
+      }
+      CounterHistogram& histogram = histograms_[key];
+      for (size_t bucket = 0; bucket < CounterHistogram::kNumBuckets; bucket++) {
+        histogram.buckets[bucket] += delta.buckets[bucket];
+      }
+      histogram.count += delta.count;
+      SaturatingAdd(histogram.sum, delta.sum);
+    }
+  }
   for (auto const& pair : counters_) {
     Count(pair.first, pair.second);
   }
   counters_.clear();
+  for (auto const& pair : histograms_) {
+    LogHistogram(pair.first, pair.second);
+  }
+  histograms_.clear();
+}
+
+void CounterMetrics::LogHistogram(int32_t key, const CounterHistogram& histogram) {
+  // The code path counter atom has no histogram field, the histograms are only logged
+  LOG_INFO(
+      "Histogram key: %d count: %s sum: %s p50: %s p90: %s p99: %s",
+      key,
+      std::to_string(histogram.count).c_str(),
+      std::to_string(histogram.sum).c_str(),
+      std::to_string(histogram.Percentile(50)).c_str(),
+      std::to_string(histogram.Percentile(90)).c_str(),
+      std::to_string(histogram.Percentile(99)).c_str());
 }
 
 }  // namespace metrics
@@ -15,7 +15,11 @@
  */
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -23,9 +27,33 @@
 namespace bluetooth {
 namespace metrics {
 
+/**
+ * The distribution of the values of a histogram metric, in buckets of powers of two.
+ */
+struct CounterHistogram {
+  // Bucket 0 holds the zero values, bucket i holds the values in [2^(i-1), 2^i). The last bucket holds the larger ones.
+  static constexpr size_t kNumBuckets = 32;
+
+  static size_t BucketOf(int64_t value);
+
+  // The upper bound of the bucket of the given percentile of the values, zero if there are none
+  int64_t Percentile(unsigned percent) const;
+
+  std::array<int64_t, kNumBuckets> buckets{};
+  int64_t count = 0;
+  int64_t sum = 0;
+};
+
 class CounterMetrics : public bluetooth::Module {
  public:
+  CounterMetrics();
+  ~CounterMetrics() override;
+
+  // Adds |value| to the counter |key|, reported at the next drain. Cheap enough for the per-packet paths: the counters
+  // are sharded per thread and only take a lock the first time a thread counts.
   bool CacheCount(int32_t key, int64_t value);
+  // Adds a sample of |value| to the histogram |key|, reported at the next drain
+  bool CacheHistogram(int32_t key, int64_t value);
   virtual bool Count(int32_t key, int64_t count);
   void Stop() override;
   static const ModuleFactory Factory;
@@ -40,9 +68,19 @@ class CounterMetrics : public bluetooth::Module {
   virtual bool IsInitialized() {
     return initialized_;
   }
+  // Reports the samples of the histogram |key| added since the last drain
+  virtual void LogHistogram(int32_t key, const CounterHistogram& histogram);
 
  private:
+  struct Shard;
+  Shard* GetShard();
+
+  // The shards of the threads which counted, only written by their thread
+  std::vector<std::unique_ptr<Shard>> shards_;
+  const uint64_t instance_id_;
+  // Counters and histograms which didn't fit in the shard of their thread
   std::unordered_map<int32_t, int64_t> counters_;
+  std::unordered_map<int32_t, CounterHistogram> histograms_;
   mutable std::mutex mutex_;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   bool initialized_ {false};
@@ -16,7 +16,9 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -32,11 +34,15 @@ class CounterMetricsTest : public ::testing::Test {
       DrainBufferedCounters();
     }
     std::unordered_map<int32_t, int64_t> test_counters_;
+    std::unordered_map<int32_t, CounterHistogram> test_histograms_;
    private:
     bool Count(int32_t key, int64_t count) override {
       test_counters_[key] = count;
       return true;
     }
+    void LogHistogram(int32_t key, const CounterHistogram& histogram) override {
+      test_histograms_[key] = histogram;
+    }
     bool IsInitialized() override {
       return true;
     }
@@ -87,6 +93,66 @@ TEST_F(CounterMetricsTest, non_positive) {
   ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
 }
 
+TEST_F(CounterMetricsTest, multiple_threads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([this]() {
+      for (int j = 0; j < 1000; j++) {
+        testable_counter_metrics_.CacheCount(1, 1);
+        testable_counter_metrics_.CacheCount(2, 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(2, 1));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 4000);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[2], 8001);
+
+  // Only what was counted since the last drain is reported
+  testable_counter_metrics_.test_counters_.clear();
+  ASSERT_TRUE(testable_counter_metrics_.CacheCount(2, 3));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_.count(1), 0u);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[2], 3);
+}
+
+TEST_F(CounterMetricsTest, many_keys) {
+  // More keys than the slots of a shard
+  for (int32_t key = 0; key < 1000; key++) {
+    ASSERT_TRUE(testable_counter_metrics_.CacheCount(key, key + 1));
+  }
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_.size(), 1000u);
+  for (int32_t key = 0; key < 1000; key++) {
+    ASSERT_EQ(testable_counter_metrics_.test_counters_[key], key + 1);
+  }
+}
+
+TEST_F(CounterMetricsTest, histogram) {
+  ASSERT_TRUE(testable_counter_metrics_.CacheHistogram(1, 0));
+  for (int i = 0; i < 98; i++) {
+    ASSERT_TRUE(testable_counter_metrics_.CacheHistogram(1, 5));
+  }
+  ASSERT_TRUE(testable_counter_metrics_.CacheHistogram(1, 1000));
+  ASSERT_FALSE(testable_counter_metrics_.CacheHistogram(1, -1));
+  testable_counter_metrics_.DrainBuffer();
+
+  const CounterHistogram& histogram = testable_counter_metrics_.test_histograms_[1];
+  ASSERT_EQ(histogram.count, 100);
+  ASSERT_EQ(histogram.sum, 98 * 5 + 1000);
+  ASSERT_EQ(histogram.buckets[0], 1);
+  ASSERT_EQ(histogram.buckets[CounterHistogram::BucketOf(5)], 98);
+  ASSERT_EQ(histogram.Percentile(50), 8);
+  ASSERT_EQ(histogram.Percentile(100), 1024);
+
+  testable_counter_metrics_.test_histograms_.clear();
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_TRUE(testable_counter_metrics_.test_histograms_.empty());
+}
+
 }  // namespace
 }  // namespace metrics
 }  // namespace bluetooth
@@ -17,7 +17,16 @@
 
 #include "module.h"
 
+#include <time.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <set>
+#include <thread>
+
 #include "common/init_flags.h"
+#include "os/trace.h"
 #include "os/wakelock_manager.h"
 
 using ::bluetooth::os::Handler;
@@ -28,6 +37,23 @@ namespace bluetooth {
 
 constexpr std::chrono::milliseconds kModuleStopTimeout = std::chrono::milliseconds(2000);
 
+namespace {
+
+// The wall and CPU times of the calling thread, the wall time it spent off CPU is the time it was blocked
+struct ThreadTimes {
+  static ThreadTimes Now() {
+    struct timespec cpu;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    return ThreadTimes{
+        std::chrono::steady_clock::now(), std::chrono::seconds(cpu.tv_sec) + std::chrono::nanoseconds(cpu.tv_nsec)};
+  }
+
+  std::chrono::steady_clock::time_point wall;
+  std::chrono::nanoseconds cpu;
+};
+
+}  // namespace
+
 ModuleFactory::ModuleFactory(std::function<Module*()> ctor) : ctor_(ctor) {
 }
 
@@ -56,18 +82,99 @@ Module* Module::GetDependency(const ModuleFactory* module) const {
 }
 
 Module* ModuleRegistry::Get(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto instance = started_modules_.find(module);
   ASSERT_LOG(instance != started_modules_.end(), "Request for module not started up, maybe not in Start(ModuleList)?");
   return instance->second;
 }
 
 bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   return started_modules_.find(module) != started_modules_.end();
 }
 
-void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
-  for (auto it = modules->list_.begin(); it != modules->list_.end(); it++) {
-    Start(*it, thread);
+void ModuleRegistry::Start(ModuleList* modules, Thread* thread, size_t num_start_threads) {
+  // The modules to start in depth-first order, dependencies first, each waiting for its dependencies not started yet
+  struct Node {
+    const ModuleFactory* module;
+    Module* instance;
+    size_t pending_dependencies;
+    std::vector<size_t> dependents;
+  };
+  std::vector<Node> nodes;
+  std::map<const ModuleFactory*, size_t> node_index;
+  std::function<void(const ModuleFactory*)> add_module = [&](const ModuleFactory* module) {
+    if (IsStarted(module) || node_index.find(module) != node_index.end()) {
+      return;
+    }
+    LOG_INFO("Constructing next module");
+    Module* instance = module->ctor_();
+    set_registry_and_handler(instance, thread);
+    instance->ListDependencies(&instance->dependencies_);
+    // Placeholder until the dependencies are added, a cycle is caught when starting
+    node_index[module] = SIZE_MAX;
+    for (auto dependency : instance->dependencies_.list_) {
+      add_module(dependency);
+    }
+    size_t index = nodes.size();
+    nodes.push_back(Node{module, instance, 0, {}});
+    node_index[module] = index;
+    for (auto dependency : instance->dependencies_.list_) {
+      auto dependency_index = node_index.find(dependency);
+      if (dependency_index == node_index.end()) {
+        continue;  // Started before
+      }
+      ASSERT_LOG(
+          dependency_index->second != SIZE_MAX, "Dependency cycle through %s", instance->ToString().c_str());
+      nodes[dependency_index->second].dependents.push_back(index);
+      nodes[index].pending_dependencies++;
+    }
+  };
+  for (auto module : modules->list_) {
+    add_module(module);
+  }
+
+  // The first ready module in depth-first order goes next, so that a single thread starts them in that order, and
+  // the other start threads take the modules which don't depend on the ones being started.
+  std::set<size_t> ready;
+  for (size_t index = 0; index < nodes.size(); index++) {
+    if (nodes[index].pending_dependencies == 0) {
+      ready.insert(index);
+    }
+  }
+  std::mutex mutex;
+  std::condition_variable ready_changed;
+  size_t remaining = nodes.size();
+
+  auto start_modules = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (remaining > 0) {
+      if (ready.empty()) {
+        ready_changed.wait(lock);
+        continue;
+      }
+      size_t index = *ready.begin();
+      ready.erase(ready.begin());
+      lock.unlock();
+      StartInstance(nodes[index].module, nodes[index].instance);
+      lock.lock();
+      remaining--;
+      for (auto dependent : nodes[index].dependents) {
+        if (--nodes[dependent].pending_dependencies == 0) {
+          ready.insert(dependent);
+        }
+      }
+      ready_changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> start_threads;
+  for (size_t i = 1; i < std::min(num_start_threads, nodes.size()); i++) {
+    start_threads.emplace_back(start_modules);
+  }
+  start_modules();
+  for (auto& start_thread : start_threads) {
+    start_thread.join();
   }
 }
 
@@ -77,9 +184,12 @@ void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread)
 }
 
 Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
-  auto started_instance = started_modules_.find(module);
-  if (started_instance != started_modules_.end()) {
-    return started_instance->second;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto started_instance = started_modules_.find(module);
+    if (started_instance != started_modules_.end()) {
+      return started_instance->second;
+    }
   }
 
   LOG_INFO("Constructing next module");
@@ -90,14 +200,41 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
   instance->ListDependencies(&instance->dependencies_);
   Start(&instance->dependencies_, thread);
 
+  StartInstance(module, instance);
+  return instance;
+}
+
+void ModuleRegistry::StartInstance(const ModuleFactory* module, Module* instance) {
   LOG_INFO("Finished starting dependencies and calling Start() of %s", instance->ToString().c_str());
+  size_t start_index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_instance_ = "starting " + instance->ToString();
+    start_index = start_order_.size();
+  }
+
+  auto begin = ThreadTimes::Now();
+  {
+    BT_TRACE_SCOPE(STACK, "Module start");
+    BT_TRACE_INSTANT(STACK, "Module start order", start_index);
+    instance->Start();
+  }
+  auto end = ThreadTimes::Now();
 
-  last_instance_ = "starting " + instance->ToString();
-  instance->Start();
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A module is only started once all its dependencies are, so the start order stays a valid stop order
   start_order_.push_back(module);
   started_modules_[module] = instance;
-  LOG_INFO("Started %s", instance->ToString().c_str());
-  return instance;
+
+  auto& timing = timings_[instance->ToString()];
+  timing.start_time = std::chrono::duration_cast<std::chrono::microseconds>(end.wall - begin.wall);
+  auto cpu_time = std::chrono::duration_cast<std::chrono::microseconds>(end.cpu - begin.cpu);
+  timing.start_blocked_time = std::max(timing.start_time - cpu_time, std::chrono::microseconds(0));
+  LOG_INFO(
+      "Started %s in %lld us (%lld us blocked)",
+      instance->ToString().c_str(),
+      static_cast<long long>(timing.start_time.count()),
+      static_cast<long long>(timing.start_blocked_time.count()));
 }
 
 void ModuleRegistry::StopAll() {
@@ -112,7 +249,14 @@ void ModuleRegistry::StopAll() {
     instance->second->handler_->Clear();
     instance->second->handler_->WaitUntilStopped(kModuleStopTimeout);
     LOG_INFO("Stopping Module %s", instance->second->ToString().c_str());
-    instance->second->Stop();
+    auto begin = std::chrono::steady_clock::now();
+    {
+      BT_TRACE_SCOPE(STACK, "Module stop");
+      instance->second->Stop();
+    }
+    auto stop_time = std::chrono::steady_clock::now() - begin;
+    timings_[instance->second->ToString()].stop_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(stop_time);
   }
   for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
     auto instance = started_modules_.find(*it);
@@ -127,6 +271,7 @@ void ModuleRegistry::StopAll() {
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto started_instance = started_modules_.find(module);
   if (started_instance != started_modules_.end()) {
     return started_instance->second->GetHandler();
@@ -154,6 +299,22 @@ void ModuleDumper::DumpState(std::string* output) const {
 
   auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
 
+  std::vector<flatbuffers::Offset<ModuleTimingData>> timings;
+  for (const auto& module : module_registry_.start_order_) {
+    auto name = module_registry_.started_modules_.at(module)->ToString();
+    auto timing = module_registry_.timings_.find(name);
+    if (timing == module_registry_.timings_.end()) {
+      continue;  // Injected test module
+    }
+    timings.push_back(CreateModuleTimingData(
+        builder,
+        builder.CreateString(name),
+        timing->second.start_time.count(),
+        timing->second.start_blocked_time.count(),
+        timing->second.stop_time.count()));
+  }
+  auto timings_offset = builder.CreateVector(timings);
+
   std::queue<DumpsysDataFinisher> queue;
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
     auto instance = module_registry_.started_modules_.find(*it);
@@ -165,6 +326,7 @@ void ModuleDumper::DumpState(std::string* output) const {
   data_builder.add_title(title);
   data_builder.add_init_flags(init_flags_offset);
   data_builder.add_wakelock_manager_data(wakelock_offset);
+  data_builder.add_module_timing_data(timings_offset);
 
   while (!queue.empty()) {
     queue.front()(&data_builder);
@@ -21,6 +21,7 @@
 #include <functional>
 #include <future>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -66,6 +67,14 @@ public:
 
 using DumpsysDataFinisher = std::function<void(DumpsysDataBuilder* dumpsys_data_builder)>;
 
+// How long a module took to start and stop. The blocked time is the part of its Start() the starting thread was off
+// CPU, which is mostly waiting for the HCI commands of the module.
+struct ModuleTiming {
+  std::chrono::microseconds start_time{0};
+  std::chrono::microseconds start_blocked_time{0};
+  std::chrono::microseconds stop_time{0};
+};
+
 // Each leaf node module must have a factory like so:
 //
 // static const ModuleFactory Factory;
@@ -136,8 +145,9 @@ class ModuleRegistry {
   bool IsStarted(const ModuleFactory* factory) const;
 
   // Start all the modules on this list and their dependencies
-  // in dependency order
-  void Start(ModuleList* modules, ::bluetooth::os::Thread* thread);
+  // in dependency order. With more than one start thread, the modules which don't depend on each other are started
+  // concurrently; their handlers are all on |thread| anyway.
+  void Start(ModuleList* modules, ::bluetooth::os::Thread* thread, size_t num_start_threads = 1);
 
   template <class T>
   T* Start(::bluetooth::os::Thread* thread) {
@@ -149,6 +159,11 @@ class ModuleRegistry {
   // Stop all running modules in reverse order of start
   void StopAll();
 
+  // The timings of the modules started by this registry, by name. They are kept after StopAll() for the stop times.
+  const std::map<std::string, ModuleTiming>& GetTimings() const {
+    return timings_;
+  }
+
  protected:
   Module* Get(const ModuleFactory* module) const;
 
@@ -156,9 +171,15 @@ class ModuleRegistry {
 
   os::Handler* GetModuleHandler(const ModuleFactory* module) const;
 
+  // Calls Start() of |instance|, its dependencies are started
+  void StartInstance(const ModuleFactory* module, Module* instance);
+
+  // Guards the started modules while the start threads add to them
+  mutable std::mutex mutex_;
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
   std::string last_instance_;
+  std::map<std::string, ModuleTiming> timings_;
 };
 
 class ModuleDumper {
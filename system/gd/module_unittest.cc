@@ -21,9 +21,12 @@
 
 #include "gtest/gtest.h"
 
+#include <condition_variable>
 #include <functional>
 #include <future>
+#include <mutex>
 #include <string>
+#include <thread>
 
 using ::bluetooth::os::Thread;
 
@@ -217,6 +220,128 @@ class TestModuleDumpState : public Module {
 
 const ModuleFactory TestModuleDumpState::Factory = ModuleFactory([]() { return new TestModuleDumpState(); });
 
+class TestModuleSlowStart : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {
+    list->add<TestModuleNoDependency>();
+  }
+
+  void Start() override {
+    // Blocked as if waiting for the controller
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("TestModuleSlowStart");
+  }
+};
+
+const ModuleFactory TestModuleSlowStart::Factory = ModuleFactory([]() { return new TestModuleSlowStart(); });
+
+// The modules of a diamond, the leaves can start concurrently and wait for each other to check it
+std::mutex dag_mutex;
+std::condition_variable dag_leaf_started;
+size_t dag_leaves_starting = 0;
+bool dag_leaves_wait = false;
+bool dag_leaves_concurrent = false;
+std::vector<std::string> dag_events;
+
+void dag_event(const std::string& event) {
+  std::lock_guard<std::mutex> lock(dag_mutex);
+  dag_events.push_back(event);
+}
+
+class TestModuleDagLeaf : public Module {
+ protected:
+  void ListDependencies(ModuleList* list) const {}
+
+  void Start() override {
+    dag_event("start " + ToString());
+    std::unique_lock<std::mutex> lock(dag_mutex);
+    dag_leaves_starting++;
+    dag_leaf_started.notify_all();
+    if (dag_leaves_wait && dag_leaf_started.wait_for(lock, std::chrono::seconds(1), [] {
+          return dag_leaves_starting == 2;
+        })) {
+      dag_leaves_concurrent = true;
+    }
+  }
+
+  void Stop() override {
+    dag_event("stop " + ToString());
+  }
+};
+
+class TestModuleDagLeafOne : public TestModuleDagLeaf {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  std::string ToString() const override {
+    return std::string("TestModuleDagLeafOne");
+  }
+};
+
+const ModuleFactory TestModuleDagLeafOne::Factory = ModuleFactory([]() { return new TestModuleDagLeafOne(); });
+
+class TestModuleDagLeafTwo : public TestModuleDagLeaf {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  std::string ToString() const override {
+    return std::string("TestModuleDagLeafTwo");
+  }
+};
+
+const ModuleFactory TestModuleDagLeafTwo::Factory = ModuleFactory([]() { return new TestModuleDagLeafTwo(); });
+
+class TestModuleDagTop : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {
+    list->add<TestModuleDagLeafOne>();
+    list->add<TestModuleDagLeafTwo>();
+  }
+
+  void Start() override {
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleDagLeafOne>());
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleDagLeafTwo>());
+    EXPECT_FALSE(GetModuleRegistry()->IsStarted<TestModuleDagTop>());
+    EXPECT_NE(nullptr, GetDependency<TestModuleDagLeafOne>());
+    dag_event("start " + ToString());
+  }
+
+  void Stop() override {
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleDagLeafOne>());
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleDagLeafTwo>());
+    dag_event("stop " + ToString());
+  }
+
+  std::string ToString() const override {
+    return std::string("TestModuleDagTop");
+  }
+};
+
+const ModuleFactory TestModuleDagTop::Factory = ModuleFactory([]() { return new TestModuleDagTop(); });
+
+class ModuleDagTest : public ModuleTest {
+ protected:
+  void SetUp() override {
+    ModuleTest::SetUp();
+    dag_leaves_starting = 0;
+    dag_leaves_concurrent = false;
+    dag_events.clear();
+  }
+};
+
 TEST_F(ModuleTest, no_dependency) {
   ModuleList list;
   list.add<TestModuleNoDependency>();
@@ -314,5 +439,93 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleDagTest, sequential_start_is_depth_first) {
+  dag_leaves_wait = false;
+  ModuleList list;
+  list.add<TestModuleDagTop>();
+  list.add<TestModuleNoDependency>();
+  registry_->Start(&list, thread_);
+  registry_->StopAll();
+
+  std::vector<std::string> expected = {
+      "start TestModuleDagLeafOne",
+      "start TestModuleDagLeafTwo",
+      "start TestModuleDagTop",
+      "stop TestModuleDagTop",
+      "stop TestModuleDagLeafTwo",
+      "stop TestModuleDagLeafOne",
+  };
+  EXPECT_EQ(expected, dag_events);
+  EXPECT_FALSE(dag_leaves_concurrent);
+}
+
+TEST_F(ModuleDagTest, independent_modules_start_concurrently) {
+  dag_leaves_wait = true;
+  ModuleList list;
+  list.add<TestModuleDagTop>();
+  list.add<TestModuleOneDependency>();
+  registry_->Start(&list, thread_, 4);
+
+  EXPECT_TRUE(dag_leaves_concurrent);
+  EXPECT_TRUE(registry_->IsStarted<TestModuleDagTop>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  ASSERT_EQ(3u, dag_events.size());
+  EXPECT_EQ("start TestModuleDagTop", dag_events[2]);
+
+  // Each module stops before its dependencies
+  registry_->StopAll();
+  ASSERT_EQ(6u, dag_events.size());
+  EXPECT_EQ("stop TestModuleDagTop", dag_events[3]);
+  EXPECT_FALSE(registry_->IsStarted<TestModuleDagLeafOne>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+}
+
+TEST_F(ModuleDagTest, start_threads_skip_started_modules) {
+  dag_leaves_wait = false;
+  registry_->Start<TestModuleDagLeafOne>(thread_);
+  ModuleList list;
+  list.add<TestModuleDagTop>();
+  registry_->Start(&list, thread_, 4);
+  registry_->StopAll();
+
+  std::vector<std::string> expected = {
+      "start TestModuleDagLeafOne",
+      "start TestModuleDagLeafTwo",
+      "start TestModuleDagTop",
+      "stop TestModuleDagTop",
+      "stop TestModuleDagLeafTwo",
+      "stop TestModuleDagLeafOne",
+  };
+  EXPECT_EQ(expected, dag_events);
+}
+
+TEST_F(ModuleTest, timings) {
+  ModuleList list;
+  list.add<TestModuleSlowStart>();
+  registry_->Start(&list, thread_);
+
+  const auto& timings = registry_->GetTimings();
+  ASSERT_EQ(2u, timings.size());
+  const auto& slow = timings.at("TestModuleSlowStart");
+  EXPECT_GE(slow.start_time, std::chrono::milliseconds(20));
+  EXPECT_GE(slow.start_blocked_time, std::chrono::milliseconds(15));
+  EXPECT_LE(slow.start_blocked_time, slow.start_time);
+  // The start of the dependencies is not counted in the start of the module
+  EXPECT_LT(timings.at("TestModuleNoDependency").start_time, std::chrono::milliseconds(20));
+
+  ModuleDumper dumper(*registry_, "Test Dump Title");
+  std::string output;
+  dumper.DumpState(&output);
+  auto data = flatbuffers::GetRoot<DumpsysData>(output.data());
+  ASSERT_EQ(2u, data->module_timing_data()->size());
+  EXPECT_STREQ("TestModuleNoDependency", data->module_timing_data()->Get(0)->name()->c_str());
+  EXPECT_STREQ("TestModuleSlowStart", data->module_timing_data()->Get(1)->name()->c_str());
+  EXPECT_EQ(
+      static_cast<uint64_t>(slow.start_time.count()), data->module_timing_data()->Get(1)->start_time_us());
+
+  registry_->StopAll();
+  EXPECT_EQ(2u, registry_->GetTimings().size());
+}
+
 }  // namespace
 }  // namespace bluetooth
@@ -18,10 +18,12 @@
 #include "neighbor/connectability.h"
 
 #include <memory>
+#include <optional>
 
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "module.h"
+#include "neighbor/page.h"
 #include "neighbor/scan.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -33,6 +35,7 @@ struct ConnectabilityModule::impl {
   void StartConnectability();
   void StopConnectability();
   bool IsConnectable() const;
+  void SetScanLoad(ScanLoad load);
 
   void Start();
   void Stop();
@@ -43,6 +46,11 @@ struct ConnectabilityModule::impl {
   ConnectabilityModule& module_;
 
   neighbor::ScanModule* scan_module_;
+  neighbor::PageModule* page_module_;
+
+  // Page scan activity from before the links became busy
+  std::optional<ScanParameters> idle_scan_activity_;
+  uint32_t scan_duty_cycle_divisor_ = 1;
 };
 
 const ModuleFactory neighbor::ConnectabilityModule::Factory =
@@ -62,8 +70,32 @@ bool neighbor::ConnectabilityModule::impl::IsConnectable() const {
   return scan_module_->IsPageEnabled();
 }
 
+void neighbor::ConnectabilityModule::impl::SetScanLoad(ScanLoad load) {
+  uint32_t divisor = ScanDutyCycleDivisor(load);
+  if (divisor == scan_duty_cycle_divisor_) {
+    return;
+  }
+  scan_duty_cycle_divisor_ = divisor;
+
+  if (!idle_scan_activity_.has_value()) {
+    idle_scan_activity_ = page_module_->GetScanActivity();
+  }
+  ScanParameters params = ScaleScanParameters(*idle_scan_activity_, load);
+  LOG_INFO(
+      "Page scan interval:%hu window:%hu for %zu links audio:%d",
+      params.interval,
+      params.window,
+      load.active_links,
+      load.audio_streaming);
+  page_module_->SetScanActivity(params);
+  if (divisor == 1) {
+    idle_scan_activity_.reset();
+  }
+}
+
 void neighbor::ConnectabilityModule::impl::Start() {
   scan_module_ = module_.GetDependency<neighbor::ScanModule>();
+  page_module_ = module_.GetDependency<neighbor::PageModule>();
 }
 
 void neighbor::ConnectabilityModule::impl::Stop() {}
@@ -86,10 +118,15 @@ bool neighbor::ConnectabilityModule::IsConnectable() const {
   return pimpl_->IsConnectable();
 }
 
+void neighbor::ConnectabilityModule::SetScanLoad(ScanLoad load) {
+  pimpl_->SetScanLoad(load);
+}
+
 /**
  * Module stuff
  */
 void neighbor::ConnectabilityModule::ListDependencies(ModuleList* list) const {
+  list->add<neighbor::PageModule>();
   list->add<neighbor::ScanModule>();
 }
 
@@ -18,6 +18,7 @@
 #include <memory>
 
 #include "module.h"
+#include "neighbor/scan_parameters.h"
 
 namespace bluetooth {
 namespace neighbor {
@@ -28,6 +29,10 @@ class ConnectabilityModule : public bluetooth::Module {
   void StopConnectability();
   bool IsConnectable() const;
 
+  // Reduces the page scan duty cycle while the links are busy, and restores the previous page scan activity once
+  // they are idle again
+  void SetScanLoad(ScanLoad load);
+
   ConnectabilityModule();
   ConnectabilityModule(const ConnectabilityModule&) = delete;
   ConnectabilityModule& operator=(const ConnectabilityModule&) = delete;
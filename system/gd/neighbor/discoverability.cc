@@ -18,11 +18,13 @@
 #include "neighbor/discoverability.h"
 
 #include <memory>
+#include <optional>
 
 #include "common/bind.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "module.h"
+#include "neighbor/inquiry.h"
 #include "neighbor/scan.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -39,6 +41,7 @@ struct DiscoverabilityModule::impl {
 
   bool IsGeneralDiscoverabilityEnabled() const;
   bool IsLimitedDiscoverabilityEnabled() const;
+  void SetScanLoad(ScanLoad load);
 
   void Start();
 
@@ -52,8 +55,13 @@ struct DiscoverabilityModule::impl {
 
   hci::HciLayer* hci_layer_;
   neighbor::ScanModule* scan_module_;
+  neighbor::InquiryModule* inquiry_module_;
   os::Handler* handler_;
 
+  // Inquiry scan activity from before the links became busy
+  std::optional<ScanParameters> idle_scan_activity_;
+  uint32_t scan_duty_cycle_divisor_ = 1;
+
   DiscoverabilityModule& module_;
   void Dump() const;
 };
@@ -111,9 +119,33 @@ bool neighbor::DiscoverabilityModule::impl::IsLimitedDiscoverabilityEnabled() co
   return scan_module_->IsInquiryEnabled() && laps_.size() == 2;
 }
 
+void neighbor::DiscoverabilityModule::impl::SetScanLoad(ScanLoad load) {
+  uint32_t divisor = ScanDutyCycleDivisor(load);
+  if (divisor == scan_duty_cycle_divisor_) {
+    return;
+  }
+  scan_duty_cycle_divisor_ = divisor;
+
+  if (!idle_scan_activity_.has_value()) {
+    idle_scan_activity_ = inquiry_module_->GetScanActivity();
+  }
+  ScanParameters params = ScaleScanParameters(*idle_scan_activity_, load);
+  LOG_INFO(
+      "Inquiry scan interval:%hu window:%hu for %zu links audio:%d",
+      params.interval,
+      params.window,
+      load.active_links,
+      load.audio_streaming);
+  inquiry_module_->SetScanActivity(params);
+  if (divisor == 1) {
+    idle_scan_activity_.reset();
+  }
+}
+
 void neighbor::DiscoverabilityModule::impl::Start() {
   hci_layer_ = module_.GetDependency<hci::HciLayer>();
   scan_module_ = module_.GetDependency<neighbor::ScanModule>();
+  inquiry_module_ = module_.GetDependency<neighbor::InquiryModule>();
   handler_ = module_.GetHandler();
 
   hci_layer_->EnqueueCommand(
@@ -176,11 +208,16 @@ bool neighbor::DiscoverabilityModule::IsLimitedDiscoverabilityEnabled() const {
   return pimpl_->IsLimitedDiscoverabilityEnabled();
 }
 
+void neighbor::DiscoverabilityModule::SetScanLoad(ScanLoad load) {
+  pimpl_->SetScanLoad(load);
+}
+
 /**
  * Module stuff
  */
 void neighbor::DiscoverabilityModule::ListDependencies(ModuleList* list) const {
   list->add<hci::HciLayer>();
+  list->add<neighbor::InquiryModule>();
   list->add<neighbor::ScanModule>();
 }
 
@@ -19,6 +19,7 @@
 #include <string>
 
 #include "module.h"
+#include "neighbor/scan_parameters.h"
 
 namespace bluetooth {
 namespace neighbor {
@@ -32,6 +33,10 @@ class DiscoverabilityModule : public bluetooth::Module {
   bool IsGeneralDiscoverabilityEnabled() const;
   bool IsLimitedDiscoverabilityEnabled() const;
 
+  // Reduces the inquiry scan duty cycle while the links are busy, and restores the previous inquiry scan activity
+  // once they are idle again
+  void SetScanLoad(ScanLoad load);
+
   static const ModuleFactory Factory;
 
   DiscoverabilityModule();
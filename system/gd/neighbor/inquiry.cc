@@ -48,6 +48,7 @@ struct InquiryModule::impl {
   void StopPeriodicInquiry();
 
   void SetScanActivity(ScanParameters params);
+  ScanParameters GetScanActivity() const;
 
   void SetScanType(hci::InquiryScanType scan_type);
 
@@ -362,6 +363,10 @@ void neighbor::InquiryModule::impl::SetInquiryMode(hci::InquiryMode mode) {
   LOG_INFO("Set inquiry mode:%s", hci::InquiryModeText(mode).c_str());
 }
 
+ScanParameters neighbor::InquiryModule::impl::GetScanActivity() const {
+  return inquiry_scan_;
+}
+
 void neighbor::InquiryModule::impl::SetScanActivity(ScanParameters params) {
   EnqueueCommandComplete(hci::WriteInquiryScanActivityBuilder::Create(params.interval, params.window));
   inquiry_scan_ = params;
@@ -457,6 +462,10 @@ void neighbor::InquiryModule::SetScanActivity(ScanParameters params) {
       common::BindOnce(&neighbor::InquiryModule::impl::SetScanActivity, common::Unretained(pimpl_.get()), params));
 }
 
+ScanParameters neighbor::InquiryModule::GetScanActivity() const {
+  return pimpl_->GetScanActivity();
+}
+
 void neighbor::InquiryModule::SetInterlacedScan() {
   GetHandler()->Post(common::BindOnce(
       &neighbor::InquiryModule::impl::SetScanType, common::Unretained(pimpl_.get()), hci::InquiryScanType::INTERLACED));
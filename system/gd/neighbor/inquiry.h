@@ -56,6 +56,7 @@ class InquiryModule : public bluetooth::Module {
   void StopPeriodicInquiry();
 
   void SetScanActivity(ScanParameters parms);
+  ScanParameters GetScanActivity() const;
 
   void SetInterlacedScan();
   void SetStandardScan();
@@ -48,6 +48,7 @@ class MockInquiryModule : public InquiryModule {
       (InquiryLength inquiry_length, NumResponses num_responses, PeriodLength max_delay, PeriodLength min_delay));
   MOCK_METHOD(void, StopPeriodicInquiry, ());
   MOCK_METHOD(void, SetScanActivity, (ScanParameters parms));
+  MOCK_METHOD(ScanParameters, GetScanActivity, (), (const));
   MOCK_METHOD(void, SetInterlacedScan, ());
   MOCK_METHOD(void, SetStandardScan, ());
   MOCK_METHOD(void, SetStandardInquiryResultMode, ());
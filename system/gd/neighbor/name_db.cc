@@ -17,7 +17,9 @@
 
 #include "neighbor/name_db.h"
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -36,6 +38,14 @@ struct PendingRemoteNameRead {
   ReadRemoteNameDbCallback callback_;
   os::Handler* handler_;
 };
+
+// Names are served from the cache for this long before a new remote name request is sent
+constexpr std::chrono::hours kNameCacheTtl = std::chrono::hours(1);
+
+struct CachedRemoteName {
+  RemoteName name_;
+  std::chrono::steady_clock::time_point read_time_;
+};
 }  // namespace
 
 struct NameDbModule::impl {
@@ -52,7 +62,12 @@ struct NameDbModule::impl {
 
  private:
   std::unordered_map<hci::Address, std::list<PendingRemoteNameRead>> address_to_pending_read_map_;
-  std::unordered_map<hci::Address, RemoteName> address_to_name_map_;
+  // Read by the clients from their own handlers, written from the module handler
+  mutable std::mutex name_map_mutex_;
+  std::unordered_map<hci::Address, CachedRemoteName> address_to_name_map_;
+
+  // Must be called with name_map_mutex_ held
+  const CachedRemoteName* FindFreshName(hci::Address address) const;
 
   void OnRemoteNameResponse(hci::Address address, hci::ErrorCode status, RemoteName name);
 
@@ -75,6 +90,15 @@ void neighbor::NameDbModule::impl::ReadRemoteNameRequest(
     return;
   }
 
+  {
+    std::unique_lock<std::mutex> lock(name_map_mutex_);
+    if (FindFreshName(address) != nullptr) {
+      LOG_DEBUG("Remote name of %s is cached", address.ToRedactedStringForLogging().c_str());
+      handler->Call(std::move(callback), address, true);
+      return;
+    }
+  }
+
   std::list<PendingRemoteNameRead> tmp;
   address_to_pending_read_map_[address] = std::move(tmp);
   address_to_pending_read_map_[address].push_back({std::move(callback), handler});
@@ -102,7 +126,8 @@ void neighbor::NameDbModule::impl::OnRemoteNameResponse(
     hci::Address address, hci::ErrorCode status, RemoteName name) {
   ASSERT(address_to_pending_read_map_.find(address) != address_to_pending_read_map_.end());
   if (status == hci::ErrorCode::SUCCESS) {
-    address_to_name_map_[address] = name;
+    std::unique_lock<std::mutex> lock(name_map_mutex_);
+    address_to_name_map_[address] = {name, std::chrono::steady_clock::now()};
   }
   auto& callback_list = address_to_pending_read_map_.at(address);
   for (auto& it : callback_list) {
@@ -111,13 +136,27 @@ void neighbor::NameDbModule::impl::OnRemoteNameResponse(
   address_to_pending_read_map_.erase(address);
 }
 
+const CachedRemoteName* neighbor::NameDbModule::impl::FindFreshName(hci::Address address) const {
+  auto it = address_to_name_map_.find(address);
+  if (it == address_to_name_map_.end()) {
+    return nullptr;
+  }
+  if (std::chrono::steady_clock::now() - it->second.read_time_ > kNameCacheTtl) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
 bool neighbor::NameDbModule::impl::IsNameCached(hci::Address address) const {
+  std::unique_lock<std::mutex> lock(name_map_mutex_);
   return address_to_name_map_.count(address) == 1;
 }
 
 RemoteName neighbor::NameDbModule::impl::ReadCachedRemoteName(hci::Address address) const {
-  ASSERT(IsNameCached(address));
-  return address_to_name_map_.at(address);
+  std::unique_lock<std::mutex> lock(name_map_mutex_);
+  auto it = address_to_name_map_.find(address);
+  ASSERT(it != address_to_name_map_.end());
+  return it->second.name_;
 }
 
 /**
@@ -32,8 +32,11 @@ using ReadRemoteNameDbCallback = common::OnceCallback<void(hci::Address address,
 
 class NameDbModule : public bluetooth::Module {
  public:
+  // Completes right away when the name was read recently, concurrent requests for the same address share a single
+  // remote name request
   virtual void ReadRemoteNameRequest(hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler);
 
+  // The cached names are kept after they expire, until a new remote name request succeeds
   bool IsNameCached(hci::Address address) const;
   RemoteName ReadCachedRemoteName(hci::Address address) const;
 
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 
 namespace bluetooth {
@@ -38,5 +40,46 @@ using ScanParameters = struct {
   ScanWindow window;
 };
 
+static constexpr ScanInterval kMaxScanInterval = 0x1000;
+static constexpr ScanWindow kMinScanWindow = 0x0011;
+
+// Load of the links sharing the radio with the page and inquiry scans
+struct ScanLoad {
+  size_t active_links;
+  bool audio_streaming;  // A2DP or SCO
+};
+
+// The scan duty cycle (window / interval) is divided by these while links are active
+static constexpr uint32_t kScanDutyCycleDivisorOneLink = 2;
+static constexpr uint32_t kScanDutyCycleDivisorLinks = 4;
+static constexpr uint32_t kScanDutyCycleDivisorAudio = 8;
+
+inline uint32_t ScanDutyCycleDivisor(ScanLoad load) {
+  if (load.audio_streaming) {
+    return kScanDutyCycleDivisorAudio;
+  }
+  if (load.active_links > 1) {
+    return kScanDutyCycleDivisorLinks;
+  }
+  return (load.active_links == 1) ? kScanDutyCycleDivisorOneLink : 1;
+}
+
+// Returns |params| with the duty cycle reduced for |load|. The window is shortened first, down to its minimum, then
+// the interval is lengthened, up to its maximum.
+inline ScanParameters ScaleScanParameters(ScanParameters params, ScanLoad load) {
+  uint32_t divisor = ScanDutyCycleDivisor(load);
+  if (divisor == 1 || params.window == 0 || params.interval == 0) {
+    return params;
+  }
+  uint32_t window = std::min<uint32_t>(std::max<uint32_t>(params.window / divisor, kMinScanWindow), params.window);
+  uint32_t interval = static_cast<uint32_t>(params.interval) * divisor * window / params.window;
+  // Only even intervals are valid
+  interval = std::min<uint32_t>(std::max<uint32_t>(interval, params.interval), kMaxScanInterval) & ~1u;
+  return {
+      .interval = static_cast<ScanInterval>(interval),
+      .window = static_cast<ScanWindow>(std::min(window, interval)),
+  };
+}
+
 }  // namespace neighbor
 }  // namespace bluetooth
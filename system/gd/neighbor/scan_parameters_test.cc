@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "neighbor/scan_parameters.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace neighbor {
+namespace {
+
+// 11.25ms every 1.28s
+static const ScanParameters kIdleParameters = {
+    .interval = 0x0800,
+    .window = 0x0012,
+};
+
+double DutyCycle(ScanParameters params) {
+  return static_cast<double>(params.window) / params.interval;
+}
+
+TEST(ScanParametersTest, idle_links_keep_parameters) {
+  ScanParameters params = ScaleScanParameters(kIdleParameters, {.active_links = 0, .audio_streaming = false});
+  ASSERT_EQ(kIdleParameters.interval, params.interval);
+  ASSERT_EQ(kIdleParameters.window, params.window);
+}
+
+TEST(ScanParametersTest, busy_links_reduce_duty_cycle) {
+  ScanParameters one_link = ScaleScanParameters(kIdleParameters, {.active_links = 1, .audio_streaming = false});
+  ASSERT_EQ(kMinScanWindow, one_link.window);
+  ASSERT_EQ(0, one_link.interval % 2);
+  ASSERT_NEAR(DutyCycle(kIdleParameters) / 2, DutyCycle(one_link), 0.0001);
+
+  ScanParameters links = ScaleScanParameters(kIdleParameters, {.active_links = 3, .audio_streaming = false});
+  ASSERT_EQ(kMaxScanInterval, links.interval);
+  ASSERT_LT(DutyCycle(links), DutyCycle(one_link));
+
+  ScanParameters audio = ScaleScanParameters(kIdleParameters, {.active_links = 1, .audio_streaming = true});
+  ASSERT_EQ(kMaxScanInterval, audio.interval);
+  ASSERT_EQ(kMinScanWindow, audio.window);
+}
+
+TEST(ScanParametersTest, long_window_shrinks_first) {
+  ScanParameters params = ScaleScanParameters({.interval = 0x0800, .window = 0x0400}, {.active_links = 2, .audio_streaming = false});
+  ASSERT_EQ(0x0800, params.interval);
+  ASSERT_EQ(0x0100, params.window);
+}
+
+}  // namespace
+}  // namespace neighbor
+}  // namespace bluetooth
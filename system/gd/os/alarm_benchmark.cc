@@ -17,6 +17,7 @@
 #include <chrono>
 #include <future>
 #include <unordered_map>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
@@ -27,6 +28,7 @@
 using ::benchmark::State;
 using ::bluetooth::common::Bind;
 using ::bluetooth::os::Alarm;
+using ::bluetooth::os::AlarmBackend;
 using ::bluetooth::os::Handler;
 using ::bluetooth::os::RepeatingAlarm;
 using ::bluetooth::os::Thread;
@@ -39,6 +41,7 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
     handler_ = std::make_unique<Handler>(thread_.get());
     alarm_ = std::make_unique<Alarm>(handler_.get());
     repeating_alarm_ = std::make_unique<RepeatingAlarm>(handler_.get());
+    wheel_alarm_ = std::make_unique<Alarm>(handler_.get(), AlarmBackend::TIMER_WHEEL);
     map_.clear();
     scheduled_tasks_ = 0;
     task_length_ = 0;
@@ -50,6 +53,8 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
   void TearDown(State& st) override {
     alarm_ = nullptr;
     repeating_alarm_ = nullptr;
+    wheel_alarm_ = nullptr;
+    handler_->Clear();
     handler_ = nullptr;
     thread_->Stop();
     thread_ = nullptr;
@@ -71,6 +76,12 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
     promise_.set_value();
   }
 
+  void CountAndFire() {
+    if (++task_counter_ >= scheduled_tasks_) {
+      promise_.set_value();
+    }
+  }
+
   int64_t scheduled_tasks_;
   int64_t task_length_;
   int64_t task_interval_;
@@ -82,6 +93,7 @@ class BM_ReactableAlarm : public ::benchmark::Fixture {
   std::unique_ptr<Handler> handler_;
   std::unique_ptr<Alarm> alarm_;
   std::unique_ptr<RepeatingAlarm> repeating_alarm_;
+  std::unique_ptr<Alarm> wheel_alarm_;
 };
 
 BENCHMARK_DEFINE_F(BM_ReactableAlarm, timer_performance_ms)(State& state) {
@@ -140,3 +152,63 @@ BENCHMARK_REGISTER_F(BM_ReactableAlarm, periodic_accuracy)
     ->Args({2000, 15, 20})
     ->Iterations(1)
     ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, timer_wheel_performance_ms)(State& state) {
+  auto milliseconds = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    auto start_time_point = std::chrono::steady_clock::now();
+    wheel_alarm_->Schedule(
+        Bind(&BM_ReactableAlarm_timer_wheel_performance_ms_Benchmark::TimerFire, bluetooth::common::Unretained(this)),
+        std::chrono::milliseconds(milliseconds));
+    promise_.get_future().get();
+    auto end_time_point = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time_point - start_time_point);
+    state.SetIterationTime(static_cast<double>(duration.count()) * 1e-6);
+    wheel_alarm_->Cancel();
+  }
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, timer_wheel_performance_ms)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(10)
+    ->Arg(20)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(2000)
+    ->Iterations(1)
+    ->UseRealTime();
+
+// Arm many concurrent alarms with spread out delays, as with per-connection L2CAP, GATT and scan timers.
+// Arguments: number of alarms, backend (0: TIMERFD, 1: TIMER_WHEEL)
+BENCHMARK_DEFINE_F(BM_ReactableAlarm, many_alarms)(State& state) {
+  auto num_alarms = static_cast<int>(state.range(0));
+  auto backend = state.range(1) == 0 ? AlarmBackend::TIMERFD : AlarmBackend::TIMER_WHEEL;
+  std::vector<std::unique_ptr<Alarm>> alarms;
+  for (int i = 0; i < num_alarms; i++) {
+    alarms.push_back(std::make_unique<Alarm>(handler_.get(), backend));
+  }
+  for (auto _ : state) {
+    scheduled_tasks_ = num_alarms;
+    task_counter_ = 0;
+    promise_ = std::promise<void>();
+    auto future = promise_.get_future();
+    for (int i = 0; i < num_alarms; i++) {
+      alarms[i]->Schedule(
+          Bind(&BM_ReactableAlarm_many_alarms_Benchmark::CountAndFire, bluetooth::common::Unretained(this)),
+          std::chrono::milliseconds(1 + i % 50));
+    }
+    future.get();
+  }
+  alarms.clear();
+};
+
+BENCHMARK_REGISTER_F(BM_ReactableAlarm, many_alarms)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({500, 0})
+    ->Args({500, 1})
+    ->Iterations(10)
+    ->UseRealTime();
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define ATRACE_TAG ATRACE_TAG_BLUETOOTH
+
+#include "os/trace.h"
+
+#include <cutils/trace.h>
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace bluetooth {
+namespace os {
+
+// The slices are on the track of their thread, Perfetto nests them
+void TraceBegin(TraceTrack track, const char* name) {
+  atrace_begin(ATRACE_TAG, name);
+}
+
+void TraceEnd(TraceTrack track) {
+  atrace_end(ATRACE_TAG);
+}
+
+void TraceInstant(TraceTrack track, const char* name, int64_t value) {
+  if (!ATRACE_ENABLED()) {
+    return;
+  }
+  char event[64];
+  snprintf(event, sizeof(event), "%s %" PRId64, name, value);
+  atrace_instant_for_track(ATRACE_TAG, TraceTrackText(track), event);
+}
+
+void TraceCounter(TraceTrack track, const char* name, int64_t value) {
+  atrace_int64(ATRACE_TAG, name, value);
+}
+
+void DumpTrace(int fd) {
+  // The events are recorded by Perfetto
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -22,48 +22,54 @@
 #include "common/callback.h"
 #include "os/log.h"
 #include "os/reactor.h"
+#include "os/task_monitor.h"
 #include "os/utils.h"
 
 namespace bluetooth {
 namespace os {
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
-  event_ = thread_->GetReactor()->NewEvent();
+Handler::Handler(Thread* thread) : task_queue_(std::make_shared<TaskQueue>()), thread_(thread) {
+  task_queue_->event = thread_->GetReactor()->NewEvent();
+  task_queue_->monitor = thread_->GetTaskMonitor();
   reactable_ = thread_->GetReactor()->Register(
-      event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
+      task_queue_->event->Id(), common::Bind(&Handler::handle_next_event, task_queue_), common::Closure());
 }
 
 Handler::~Handler() {
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(task_queue_->mutex);
     ASSERT_LOG(was_cleared(), "Handlers must be cleared before they are destroyed");
+    // Drop anything that raced with Clear()
+    task_queue_->tasks.Clear();
   }
-  event_->Close();
+  task_queue_->event->Close();
 }
 
 void Handler::Post(OnceClosure closure) {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (was_cleared()) {
-      LOG_WARN("Posting to a handler which has been cleared");
-      return;
-    }
-    tasks_->emplace(std::move(closure));
+  if (was_cleared()) {
+    LOG_WARN("Posting to a handler which has been cleared");
+    return;
+  }
+  if (task_queue_->monitor != nullptr) {
+    // There is no posting location here, the tasks are attributed to the handler's thread
+    closure = TaskMonitor::Wrap(task_queue_->monitor, nullptr, std::move(closure));
+  }
+  task_queue_->tasks.Push(std::move(closure));
+  if (task_queue_->pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    task_queue_->event->Notify();
   }
-  event_->Notify();
 }
 
 void Handler::Clear() {
-  std::queue<OnceClosure>* tmp = nullptr;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(task_queue_->mutex);
     ASSERT_LOG(!was_cleared(), "Handlers must only be cleared once");
-    std::swap(tasks_, tmp);
+    task_queue_->cleared.store(true, std::memory_order_release);
+    task_queue_->tasks.Clear();
   }
-  delete tmp;
 
-  event_->Clear();
+  task_queue_->event->Clear();
 
   thread_->GetReactor()->Unregister(reactable_);
   reactable_ = nullptr;
@@ -74,21 +80,31 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   ASSERT(thread_->GetReactor()->WaitForUnregisteredReactable(timeout));
 }
 
-void Handler::handle_next_event() {
-  common::OnceClosure closure;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    bool has_data = event_->Read();
+void Handler::handle_next_event(std::shared_ptr<TaskQueue> task_queue) {
+  task_queue->event->Read();
 
-    if (was_cleared()) {
-      return;
+  size_t handled = 0;
+  while (handled < kMaxTasksPerWakeup) {
+    common::OnceClosure closure;
+    {
+      std::lock_guard<std::mutex> lock(task_queue->mutex);
+      if (task_queue->cleared) {
+        return;
+      }
+      if (!task_queue->tasks.Pop(&closure)) {
+        break;
+      }
     }
-    ASSERT_LOG(has_data, "Notified for work but no work available");
+    handled++;
+    std::move(closure).Run();
+  }
 
-    closure = std::move(tasks_->front());
-    tasks_->pop();
+  // Work that is still pending (or being pushed right now) owns no notification yet, so schedule another wakeup
+  // instead of looping here and starving the other reactables on this thread.
+  std::lock_guard<std::mutex> lock(task_queue->mutex);
+  if (task_queue->pending.fetch_sub(handled, std::memory_order_acq_rel) != handled && !task_queue->cleared) {
+    task_queue->event->Notify();
   }
-  std::move(closure).Run();
 }
 
 }  // namespace os
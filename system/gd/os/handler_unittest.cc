@@ -18,6 +18,7 @@
 
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -94,6 +95,52 @@ TEST_F(HandlerTest, post_task_cleared) {
   ASSERT_EQ(val, 1);
 }
 
+TEST_F(HandlerTest, post_burst_runs_in_order) {
+  constexpr int kNumTasks = 3 * Handler::kMaxTasksPerWakeup + 1;
+  std::vector<int> order;
+  std::promise<void> all_ran;
+  auto future = all_ran.get_future();
+  for (int i = 0; i < kNumTasks; i++) {
+    handler_->Post(common::BindOnce([](std::vector<int>* order, int i) { order->push_back(i); }, &order, i));
+  }
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&all_ran)));
+  future.wait();
+  ASSERT_EQ(order.size(), static_cast<size_t>(kNumTasks));
+  for (int i = 0; i < kNumTasks; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+  handler_->Clear();
+}
+
+TEST_F(HandlerTest, post_from_multiple_threads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kTasksPerThread = 1000;
+  std::atomic<int> counter = 0;
+  std::promise<void> all_ran;
+  auto future = all_ran.get_future();
+  std::vector<std::thread> posters;
+  for (int t = 0; t < kNumThreads; t++) {
+    posters.emplace_back([this, &counter, &all_ran]() {
+      for (int i = 0; i < kTasksPerThread; i++) {
+        handler_->Post(common::BindOnce(
+            [](std::atomic<int>* counter, std::promise<void>* all_ran) {
+              if (++(*counter) == kNumThreads * kTasksPerThread) {
+                all_ran->set_value();
+              }
+            },
+            &counter,
+            &all_ran));
+      }
+    });
+  }
+  for (auto& poster : posters) {
+    poster.join();
+  }
+  future.wait();
+  ASSERT_EQ(counter, kNumThreads * kTasksPerThread);
+  handler_->Clear();
+}
+
 void check_int(std::unique_ptr<int> number, std::shared_ptr<int> to_change) {
   *to_change = *number;
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/trace.h"
+
+#include "os/trace_buffer.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+// There is no system tracer, the events are kept for dumpsys
+TraceBuffer trace_buffer;
+}  // namespace
+
+void TraceBegin(TraceTrack track, const char* name) {
+  trace_buffer.Record(track, TraceBuffer::Type::BEGIN, name, 0);
+}
+
+void TraceEnd(TraceTrack track) {
+  trace_buffer.Record(track, TraceBuffer::Type::END, nullptr, 0);
+}
+
+void TraceInstant(TraceTrack track, const char* name, int64_t value) {
+  trace_buffer.Record(track, TraceBuffer::Type::INSTANT, name, value);
+}
+
+void TraceCounter(TraceTrack track, const char* name, int64_t value) {
+  trace_buffer.Record(track, TraceBuffer::Type::COUNTER, name, value);
+}
+
+void DumpTrace(int fd) {
+  trace_buffer.Dump(fd);
+}
+
+}  // namespace os
+}  // namespace bluetooth
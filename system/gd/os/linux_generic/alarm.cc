@@ -37,7 +37,16 @@ namespace os {
 using common::Closure;
 using common::OnceClosure;
 
-Alarm::Alarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, 0)) {
+Alarm::Alarm(Handler* handler, AlarmBackend backend) : handler_(handler) {
+  if (backend == AlarmBackend::TIMER_WHEEL) {
+    fd_ = -1;
+    timer_wheel_ = TimerWheel::ForHandler(handler_);
+    timer_ = std::make_unique<TimerWheel::Timer>(
+        common::Bind(&Alarm::on_timer_wheel_fire, common::Unretained(this)));
+    return;
+  }
+
+  fd_ = TIMERFD_CREATE(ALARM_CLOCK, 0);
   ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
 
   token_ = handler_->thread_->GetReactor()->Register(
@@ -45,6 +54,11 @@ Alarm::Alarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLO
 }
 
 Alarm::~Alarm() {
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Remove(timer_.get());
+    return;
+  }
+
   handler_->thread_->GetReactor()->Unregister(token_);
 
   int close_status;
@@ -54,6 +68,12 @@ Alarm::~Alarm() {
 
 void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay) {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Arm(timer_.get(), delay, std::chrono::milliseconds(0));
+    task_ = std::move(task);
+    return;
+  }
+
   long delay_ms = delay.count();
   itimerspec timer_itimerspec{{/* interval for periodic timer */}, {delay_ms / 1000, delay_ms % 1000 * 1000000}};
   int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
@@ -64,6 +84,11 @@ void Alarm::Schedule(OnceClosure task, std::chrono::milliseconds delay) {
 
 void Alarm::Cancel() {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Disarm(timer_.get());
+    return;
+  }
+
   itimerspec disarm_itimerspec{/* disarm timer */};
   int result = TIMERFD_SETTIME(fd_, 0, &disarm_itimerspec, nullptr);
   ASSERT(result == 0);
@@ -84,5 +109,12 @@ void Alarm::on_fire() {
       fd_);
 }
 
+void Alarm::on_timer_wheel_fire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto task = std::move(task_);
+  lock.unlock();
+  std::move(task).Run();
+}
+
 }  // namespace os
 }  // namespace bluetooth
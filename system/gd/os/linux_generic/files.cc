@@ -206,6 +206,49 @@ bool WriteToFile(const std::string& path, const std::string& data) {
   return true;
 }
 
+bool AppendToFile(const std::string& path, const std::string& data) {
+  ASSERT(!path.empty());
+  bool created = !FileExists(path);
+  int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+  if (fd < 0) {
+    LOG_ERROR("unable to open file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result = write(fd, data.data() + written, data.size() - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("unable to append to file '%s', error: %s", path.c_str(), strerror(errno));
+      close(fd);
+      return false;
+    }
+    written += result;
+  }
+  // Appends only need the data and the file size on disk, fdatasync() skips flushing the other inode metadata
+  if (fdatasync(fd) != 0) {
+    LOG_WARN("unable to fdatasync file '%s', error: %s", path.c_str(), strerror(errno));
+  }
+  if (close(fd) != 0) {
+    LOG_ERROR("unable to close file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  if (created) {
+    // Make sure the directory entry of the new file makes it to disk as well
+    std::string path_for_dir(path);
+    int dir_fd = open(dirname(path_for_dir.data()), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0) {
+      if (fsync(dir_fd) != 0) {
+        LOG_WARN("unable to fsync dir of '%s', error: %s", path.c_str(), strerror(errno));
+      }
+      close(dir_fd);
+    }
+  }
+  return true;
+}
+
 bool RemoveFile(const std::string& path) {
   if (remove(path.c_str()) != 0) {
     LOG_ERROR("unable to remove file '%s', error: %s", path.c_str(), strerror(errno));
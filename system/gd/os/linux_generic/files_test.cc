@@ -23,6 +23,7 @@
 
 namespace testing {
 
+using bluetooth::os::AppendToFile;
 using bluetooth::os::FileExists;
 using bluetooth::os::ReadSmallFile;
 using bluetooth::os::RenameFile;
@@ -38,6 +39,17 @@ TEST(FilesTest, exist_test) {
   EXPECT_FALSE(FileExists(none_file.string()));
 }
 
+TEST(FilesTest, append_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_file = temp_dir / "file_append.txt";
+  std::filesystem::remove(temp_file);
+  ASSERT_TRUE(AppendToFile(temp_file.string(), "Hello "));
+  EXPECT_THAT(ReadSmallFile(temp_file.string()), Optional(StrEq("Hello ")));
+  ASSERT_TRUE(AppendToFile(temp_file.string(), "world!\n"));
+  EXPECT_THAT(ReadSmallFile(temp_file.string()), Optional(StrEq("Hello world!\n")));
+  ASSERT_TRUE(std::filesystem::remove(temp_file));
+}
+
 TEST(FilesTest, rename_test) {
   auto temp_dir = std::filesystem::temp_directory_path();
   auto temp_file = temp_dir / "file_1.txt";
@@ -21,6 +21,7 @@
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <thread>
 #include <unordered_map>
 
 #include "common/bind.h"
@@ -931,6 +932,101 @@ TEST_F(EnqueueBufferTest, delete_when_in_callback) {
   delete queue;
 }
 
+class MpscEnqueueBufferTest : public EnqueueBufferTest {
+ protected:
+  void SetUp() override {
+    EnqueueBufferTest::SetUp();
+    mpsc_enqueue_buffer_ = std::make_unique<MpscEnqueueBuffer<int>>(&enqueue_, handler_);
+  }
+
+  void TearDown() override {
+    mpsc_enqueue_buffer_.reset();
+    EnqueueBufferTest::TearDown();
+  }
+
+  std::unique_ptr<MpscEnqueueBuffer<int>> mpsc_enqueue_buffer_;
+};
+
+TEST_F(MpscEnqueueBufferTest, enqueue) {
+  int num_items = 10;
+  for (int i = 0; i < num_items; i++) {
+    mpsc_enqueue_buffer_->Enqueue(std::make_unique<int>(i));
+  }
+  // Once for the registration, once for the callbacks it posted
+  SynchronizeHandler();
+  SynchronizeHandler();
+  for (int i = 0; i < num_items; i++) {
+    ASSERT_EQ(enqueue_.queue_.front(), i);
+    enqueue_.queue_.pop();
+  }
+  ASSERT_FALSE(enqueue_.registered_);
+  ASSERT_EQ(mpsc_enqueue_buffer_->Size(), 0u);
+}
+
+TEST_F(MpscEnqueueBufferTest, clear) {
+  enqueue_.dont_handle_register_enqueue_ = true;
+  int num_items = 10;
+  for (int i = 0; i < num_items; i++) {
+    mpsc_enqueue_buffer_->Enqueue(std::make_unique<int>(i));
+  }
+  SynchronizeHandler();
+  ASSERT_TRUE(enqueue_.registered_);
+  mpsc_enqueue_buffer_->Clear();
+  ASSERT_FALSE(enqueue_.registered_);
+  ASSERT_EQ(mpsc_enqueue_buffer_->Size(), 0u);
+
+  // Dropped once cleared
+  mpsc_enqueue_buffer_->Enqueue(std::make_unique<int>(num_items));
+  SynchronizeHandler();
+  ASSERT_FALSE(enqueue_.registered_);
+}
+
+TEST_F(MpscEnqueueBufferTest, enqueue_from_many_threads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumItemsPerThread = 1000;
+  Queue<int> queue(kQueueSize);
+  auto enqueue_buffer = std::make_unique<MpscEnqueueBuffer<int>>(&queue, handler_);
+
+  std::promise<std::vector<int>> promise;
+  auto future = promise.get_future();
+  std::vector<int> dequeued;
+  queue.RegisterDequeue(
+      handler_,
+      common::Bind(
+          [](Queue<int>* queue, std::vector<int>* dequeued, std::promise<std::vector<int>>* promise) {
+            dequeued->push_back(*queue->TryDequeue());
+            if (dequeued->size() == kNumThreads * kNumItemsPerThread) {
+              promise->set_value(*dequeued);
+            }
+          },
+          common::Unretained(&queue),
+          common::Unretained(&dequeued),
+          common::Unretained(&promise)));
+
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < kNumThreads; thread++) {
+    threads.emplace_back([&enqueue_buffer, thread]() {
+      for (int i = 0; i < kNumItemsPerThread; i++) {
+        enqueue_buffer->Enqueue(std::make_unique<int>(thread * kNumItemsPerThread + i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  auto items = future.get();
+  // Items of each thread are in order
+  std::vector<int> last_items(kNumThreads, -1);
+  for (int item : items) {
+    ASSERT_GT(item, last_items[item / kNumItemsPerThread]);
+    last_items[item / kNumItemsPerThread] = item;
+  }
+  queue.UnregisterDequeue();
+  enqueue_buffer.reset();
+}
+
 }  // namespace
 }  // namespace os
 }  // namespace bluetooth
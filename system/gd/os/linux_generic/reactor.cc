@@ -31,7 +31,7 @@
 namespace {
 
 // Use at most sizeof(epoll_event) * kEpollMaxEvents kernel memory
-constexpr int kEpollMaxEvents = 64;
+constexpr int kEpollMaxEvents = 128;
 constexpr uint64_t kStopReactor = 1 << 0;
 constexpr uint64_t kWaitForIdle = 1 << 1;
 
@@ -40,6 +40,9 @@ constexpr uint64_t kWaitForIdle = 1 << 1;
 namespace bluetooth {
 namespace os {
 using common::Closure;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
 
 struct Reactor::Event::impl {
   impl() {
@@ -89,12 +92,19 @@ class Reactor::Reactable {
         on_read_ready_(std::move(on_read_ready)),
         on_write_ready_(std::move(on_write_ready)),
         is_executing_(false),
-        removed_(false) {}
+        removed_(false),
+        dispatch_count_(0),
+        total_callback_duration_(0),
+        max_callback_duration_(0) {}
   const int fd_;
   Closure on_read_ready_;
   Closure on_write_ready_;
   bool is_executing_;
   bool removed_;
+  // Statistics are written by the reactor thread, protected by mutex_
+  uint64_t dispatch_count_;
+  microseconds total_callback_duration_;
+  microseconds max_callback_duration_;
   std::mutex mutex_;
   std::unique_ptr<std::promise<void>> finished_promise_;
 };
@@ -134,6 +144,7 @@ void Reactor::Run() {
     {
       std::unique_lock<std::mutex> lock(mutex_);
       invalidation_list_.clear();
+      executing_reactable_finished_ = nullptr;
     }
     epoll_event events[kEpollMaxEvents];
     int count;
@@ -146,6 +157,11 @@ void Reactor::Run() {
       idle_promise_->set_value();
       idle_promise_ = nullptr;
     }
+    wakeup_count_.fetch_add(1, std::memory_order_relaxed);
+    event_count_.fetch_add(count, std::memory_order_relaxed);
+    if (count > max_events_per_wakeup_.load(std::memory_order_relaxed)) {
+      max_events_per_wakeup_.store(count, std::memory_order_relaxed);
+    }
 
     for (int i = 0; i < count; ++i) {
       auto event = events[i];
@@ -168,27 +184,33 @@ void Reactor::Run() {
         }
       }
       auto* reactable = static_cast<Reactor::Reactable*>(event.data.ptr);
-      std::unique_lock<std::mutex> lock(mutex_);
-      executing_reactable_finished_ = nullptr;
-      // See if this reactable has been removed in the meantime.
-      if (std::find(invalidation_list_.begin(), invalidation_list_.end(), reactable) != invalidation_list_.end()) {
-        continue;
-      }
-
       {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // See if this reactable has been removed in the meantime. The list is empty unless something was unregistered
+        // since the last epoll_wait().
+        if (!invalidation_list_.empty() &&
+            std::find(invalidation_list_.begin(), invalidation_list_.end(), reactable) != invalidation_list_.end()) {
+          continue;
+        }
+
         std::lock_guard<std::mutex> reactable_lock(reactable->mutex_);
         lock.unlock();
         reactable->is_executing_ = true;
       }
+      auto start_time = steady_clock::now();
       if (event.events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP | EPOLLERR) && !reactable->on_read_ready_.is_null()) {
         reactable->on_read_ready_.Run();
       }
       if (event.events & EPOLLOUT && !reactable->on_write_ready_.is_null()) {
         reactable->on_write_ready_.Run();
       }
+      auto callback_duration = duration_cast<microseconds>(steady_clock::now() - start_time);
       {
         std::unique_lock<std::mutex> reactable_lock(reactable->mutex_);
         reactable->is_executing_ = false;
+        reactable->dispatch_count_++;
+        reactable->total_callback_duration_ += callback_duration;
+        reactable->max_callback_duration_ = std::max(reactable->max_callback_duration_, callback_duration);
         if (reactable->removed_) {
           reactable->finished_promise_->set_value();
           reactable_lock.unlock();
@@ -220,6 +242,10 @@ Reactor::Reactable* Reactor::Register(int fd, Closure on_read_ready, Closure on_
     poll_event_type |= EPOLLOUT;
   }
   auto* reactable = new Reactable(fd, on_read_ready, on_write_ready);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    registered_.insert(reactable);
+  }
   epoll_event event = {
       .events = poll_event_type,
       .data = {.ptr = reactable},
@@ -235,6 +261,7 @@ void Reactor::Unregister(Reactor::Reactable* reactable) {
   {
     std::lock_guard<std::mutex> lock(mutex_);
     invalidation_list_.push_back(reactable);
+    registered_.erase(reactable);
   }
   bool delaying_delete_until_callback_finished = false;
   {
@@ -289,6 +316,27 @@ bool Reactor::WaitForIdle(std::chrono::milliseconds timeout) {
   return idle_status == std::future_status::ready;
 }
 
+Reactor::Stats Reactor::GetStats() const {
+  Stats stats = {
+      .wakeup_count = wakeup_count_.load(std::memory_order_relaxed),
+      .event_count = event_count_.load(std::memory_order_relaxed),
+      .max_events_per_wakeup = max_events_per_wakeup_.load(std::memory_order_relaxed),
+      .reactables = {},
+  };
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats.reactables.reserve(registered_.size());
+  for (auto* reactable : registered_) {
+    std::lock_guard<std::mutex> reactable_lock(reactable->mutex_);
+    stats.reactables.push_back({
+        .fd = reactable->fd_,
+        .dispatch_count = reactable->dispatch_count_,
+        .total_callback_duration = reactable->total_callback_duration_,
+        .max_callback_duration = reactable->max_callback_duration_,
+    });
+  }
+  return stats;
+}
+
 void Reactor::ModifyRegistration(Reactor::Reactable* reactable, ReactOn react_on) {
   ASSERT(reactable != nullptr);
 
@@ -448,6 +448,36 @@ TEST_F(ReactorTest, modify_registration) {
   reactor_->Unregister(reactable);
 }
 
+TEST_F(ReactorTest, get_stats) {
+  FakeReactable fake_reactable;
+  auto* reactable = reactor_->Register(
+      fake_reactable.fd_, Bind(&FakeReactable::OnReadReady, common::Unretained(&fake_reactable)), common::Closure());
+
+  auto stats = reactor_->GetStats();
+  ASSERT_EQ(stats.reactables.size(), 1u);
+  ASSERT_EQ(stats.reactables[0].fd, fake_reactable.fd_);
+  ASSERT_EQ(stats.reactables[0].dispatch_count, 0u);
+
+  auto reactor_thread = std::thread(&Reactor::Run, reactor_);
+  auto future = g_promise->get_future();
+  auto write_result = eventfd_write(fake_reactable.fd_, FakeReactable::kSetPromise);
+  EXPECT_EQ(write_result, 0);
+  EXPECT_EQ(future.get(), kReadReadyValue);
+  reactor_->Stop();
+  reactor_thread.join();
+
+  stats = reactor_->GetStats();
+  ASSERT_GE(stats.wakeup_count, 1u);
+  ASSERT_GE(stats.event_count, 1u);
+  ASSERT_GE(stats.max_events_per_wakeup, 1);
+  ASSERT_EQ(stats.reactables.size(), 1u);
+  ASSERT_EQ(stats.reactables[0].dispatch_count, 1u);
+  ASSERT_GE(stats.reactables[0].total_callback_duration, stats.reactables[0].max_callback_duration);
+
+  reactor_->Unregister(reactable);
+  ASSERT_TRUE(reactor_->GetStats().reactables.empty());
+}
+
 }  // namespace
 }  // namespace os
 }  // namespace bluetooth
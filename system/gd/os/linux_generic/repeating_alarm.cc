@@ -36,7 +36,16 @@ namespace bluetooth {
 namespace os {
 using common::Closure;
 
-RepeatingAlarm::RepeatingAlarm(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, 0)) {
+RepeatingAlarm::RepeatingAlarm(Handler* handler, AlarmBackend backend) : handler_(handler) {
+  if (backend == AlarmBackend::TIMER_WHEEL) {
+    fd_ = -1;
+    timer_wheel_ = TimerWheel::ForHandler(handler_);
+    timer_ = std::make_unique<TimerWheel::Timer>(
+        common::Bind(&RepeatingAlarm::on_timer_wheel_fire, common::Unretained(this)));
+    return;
+  }
+
+  fd_ = TIMERFD_CREATE(ALARM_CLOCK, 0);
   ASSERT(fd_ != -1);
 
   token_ = handler_->thread_->GetReactor()->Register(
@@ -44,6 +53,11 @@ RepeatingAlarm::RepeatingAlarm(Handler* handler) : handler_(handler), fd_(TIMERF
 }
 
 RepeatingAlarm::~RepeatingAlarm() {
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Remove(timer_.get());
+    return;
+  }
+
   handler_->thread_->GetReactor()->Unregister(token_);
 
   int close_status;
@@ -53,6 +67,12 @@ RepeatingAlarm::~RepeatingAlarm() {
 
 void RepeatingAlarm::Schedule(Closure task, std::chrono::milliseconds period) {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Arm(timer_.get(), period, period);
+    task_ = std::move(task);
+    return;
+  }
+
   long period_ms = period.count();
   itimerspec timer_itimerspec{{period_ms / 1000, period_ms % 1000 * 1000000},
                               {period_ms / 1000, period_ms % 1000 * 1000000}};
@@ -64,6 +84,11 @@ void RepeatingAlarm::Schedule(Closure task, std::chrono::milliseconds period) {
 
 void RepeatingAlarm::Cancel() {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (timer_wheel_ != nullptr) {
+    timer_wheel_->Disarm(timer_.get());
+    return;
+  }
+
   itimerspec disarm_itimerspec{/* disarm timer */};
   int result = TIMERFD_SETTIME(fd_, 0, &disarm_itimerspec, nullptr);
   ASSERT(result == 0);
@@ -79,5 +104,12 @@ void RepeatingAlarm::on_fire() {
   ASSERT(bytes_read == static_cast<ssize_t>(sizeof(uint64_t)));
 }
 
+void RepeatingAlarm::on_timer_wheel_fire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto task = task_;
+  lock.unlock();
+  task.Run();
+}
+
 }  // namespace os
 }  // namespace bluetooth
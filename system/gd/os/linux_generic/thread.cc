@@ -24,6 +24,7 @@
 #include <cstring>
 
 #include "os/log.h"
+#include "os/thread_policy.h"
 
 namespace bluetooth {
 namespace os {
@@ -33,18 +34,15 @@ constexpr int kRealTimeFifoSchedulingPriority = 1;
 }
 
 Thread::Thread(const std::string& name, const Priority priority)
-    : name_(name), reactor_(), running_thread_(&Thread::run, this, priority) {}
+    : name_(name),
+      reactor_(),
+      task_monitor_(TaskMonitor::Create(name)),
+      running_thread_(&Thread::run, this, priority) {}
 
 void Thread::run(Priority priority) {
-  if (priority == Priority::REAL_TIME) {
-    struct sched_param rt_params = {.sched_priority = kRealTimeFifoSchedulingPriority};
-    auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
-    int rc;
-    RUN_NO_INTR(rc = sched_setscheduler(linux_tid, SCHED_FIFO, &rt_params));
-    if (rc != 0) {
-      LOG_ERROR("unable to set SCHED_FIFO priority: %s", strerror(errno));
-    }
-  }
+  auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
+  int default_real_time_priority = (priority == Priority::REAL_TIME) ? kRealTimeFifoSchedulingPriority : 0;
+  ApplyThreadPolicy(linux_tid, GetThreadPolicy(name_, default_real_time_priority));
   reactor_.Run();
 }
 
@@ -72,6 +70,10 @@ Reactor* Thread::GetReactor() const {
   return &reactor_;
 }
 
+std::shared_ptr<TaskMonitor> Thread::GetTaskMonitor() const {
+  return task_monitor_;
+}
+
 std::string Thread::GetThreadName() const {
   return name_;
 }
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/thread_policy.h"
+
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "os/log.h"
+#include "os/system_properties.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+std::optional<uint64_t> ParseUint64(const std::string& value, int base) {
+  if (value.empty() || value[0] == '-') {
+    return std::nullopt;
+  }
+  char* end = nullptr;
+  errno = 0;
+  uint64_t parsed = std::strtoull(value.c_str(), &end, base);
+  if (errno != 0 || *end != '\0') {
+    return std::nullopt;
+  }
+  return parsed;
+}
+
+bool SetTimerSlack(pid_t linux_tid, uint64_t timer_slack_ns) {
+  if (linux_tid == static_cast<pid_t>(syscall(SYS_gettid))) {
+    return prctl(PR_SET_TIMERSLACK, static_cast<unsigned long>(timer_slack_ns)) == 0;
+  }
+  // Another thread of this process
+  std::ofstream timer_slack("/proc/self/task/" + std::to_string(linux_tid) + "/timerslack_ns");
+  timer_slack << timer_slack_ns;
+  timer_slack.close();
+  return timer_slack.good();
+}
+
+}  // namespace
+
+std::optional<ThreadPolicy> ParseThreadPolicy(const std::string& value) {
+  ThreadPolicy policy;
+  std::stringstream stream(value);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    auto separator = field.find('=');
+    if (separator == std::string::npos) {
+      return std::nullopt;
+    }
+    std::string key = field.substr(0, separator);
+    std::string field_value = field.substr(separator + 1);
+    if (key == "fifo") {
+      auto priority = ParseUint64(field_value, 10);
+      if (!priority || *priority > static_cast<uint64_t>(sched_get_priority_max(SCHED_FIFO))) {
+        return std::nullopt;
+      }
+      policy.real_time_priority = static_cast<int>(*priority);
+    } else if (key == "cpus") {
+      auto mask = ParseUint64(field_value, 16);
+      if (!mask || *mask == 0) {
+        return std::nullopt;
+      }
+      policy.cpu_affinity_mask = mask;
+    } else if (key == "slack_ns") {
+      auto timer_slack_ns = ParseUint64(field_value, 10);
+      if (!timer_slack_ns) {
+        return std::nullopt;
+      }
+      policy.timer_slack_ns = timer_slack_ns;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return policy;
+}
+
+ThreadPolicy GetThreadPolicy(const std::string& thread_name, int default_real_time_priority) {
+  ThreadPolicy policy;
+  auto value = GetSystemProperty(kThreadPolicyPropertyPrefix + thread_name);
+  if (value && !value->empty()) {
+    auto parsed = ParseThreadPolicy(*value);
+    if (parsed) {
+      LOG_INFO("Thread %s uses policy \"%s\"", thread_name.c_str(), value->c_str());
+      policy = *parsed;
+    } else {
+      LOG_ERROR("Ignoring malformed policy \"%s\" of thread %s", value->c_str(), thread_name.c_str());
+    }
+  }
+  if (!policy.real_time_priority && default_real_time_priority > 0) {
+    policy.real_time_priority = default_real_time_priority;
+  }
+  return policy;
+}
+
+bool ApplyThreadPolicy(pid_t linux_tid, const ThreadPolicy& policy) {
+  bool success = true;
+  if (policy.real_time_priority) {
+    struct sched_param params = {.sched_priority = *policy.real_time_priority};
+    int scheduling_policy = (*policy.real_time_priority > 0) ? SCHED_FIFO : SCHED_OTHER;
+    int rc;
+    RUN_NO_INTR(rc = sched_setscheduler(linux_tid, scheduling_policy, &params));
+    if (rc != 0) {
+      LOG_ERROR(
+          "unable to set priority %d for linux_tid %d: %s", *policy.real_time_priority, linux_tid, strerror(errno));
+      success = false;
+    }
+  }
+  if (policy.cpu_affinity_mask) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+      if ((*policy.cpu_affinity_mask >> cpu) & 1) {
+        CPU_SET(cpu, &cpu_set);
+      }
+    }
+    if (sched_setaffinity(linux_tid, sizeof(cpu_set), &cpu_set) != 0) {
+      LOG_ERROR(
+          "unable to set CPU affinity 0x%llx for linux_tid %d: %s",
+          static_cast<unsigned long long>(*policy.cpu_affinity_mask),
+          linux_tid,
+          strerror(errno));
+      success = false;
+    }
+  }
+  if (policy.timer_slack_ns && !SetTimerSlack(linux_tid, *policy.timer_slack_ns)) {
+    LOG_ERROR(
+        "unable to set timer slack %llu ns for linux_tid %d",
+        static_cast<unsigned long long>(*policy.timer_slack_ns),
+        linux_tid);
+    success = false;
+  }
+  return success;
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/thread_policy.h"
+
+#include <gtest/gtest.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "os/system_properties.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+TEST(ThreadPolicyTest, parse_policy) {
+  auto policy = ParseThreadPolicy("fifo=2,cpus=f0,slack_ns=50000");
+  ASSERT_TRUE(policy);
+  ASSERT_EQ(policy->real_time_priority, 2);
+  ASSERT_EQ(policy->cpu_affinity_mask, 0xf0u);
+  ASSERT_EQ(policy->timer_slack_ns, 50000u);
+
+  policy = ParseThreadPolicy("cpus=0x3");
+  ASSERT_TRUE(policy);
+  ASSERT_FALSE(policy->real_time_priority);
+  ASSERT_EQ(policy->cpu_affinity_mask, 0x3u);
+  ASSERT_FALSE(policy->timer_slack_ns);
+
+  policy = ParseThreadPolicy("");
+  ASSERT_TRUE(policy);
+  ASSERT_FALSE(policy->real_time_priority);
+}
+
+TEST(ThreadPolicyTest, parse_malformed_policy) {
+  ASSERT_FALSE(ParseThreadPolicy("fifo"));
+  ASSERT_FALSE(ParseThreadPolicy("fifo=-1"));
+  ASSERT_FALSE(ParseThreadPolicy("fifo=1000"));
+  ASSERT_FALSE(ParseThreadPolicy("fifo=2x"));
+  ASSERT_FALSE(ParseThreadPolicy("cpus=0"));
+  ASSERT_FALSE(ParseThreadPolicy("cpus=zz"));
+  ASSERT_FALSE(ParseThreadPolicy("nice=3"));
+}
+
+TEST(ThreadPolicyTest, default_real_time_priority) {
+  std::string thread_name = "ThreadPolicyTest_default";
+  ASSERT_TRUE(SetSystemProperty(kThreadPolicyPropertyPrefix + thread_name, "cpus=1"));
+  auto policy = GetThreadPolicy(thread_name, 1);
+  ASSERT_EQ(policy.real_time_priority, 1);
+  ASSERT_EQ(policy.cpu_affinity_mask, 1u);
+
+  // The property wins over the default of the thread
+  ASSERT_TRUE(SetSystemProperty(kThreadPolicyPropertyPrefix + thread_name, "fifo=0"));
+  policy = GetThreadPolicy(thread_name, 1);
+  ASSERT_EQ(policy.real_time_priority, 0);
+
+  // A malformed policy is ignored
+  ASSERT_TRUE(SetSystemProperty(kThreadPolicyPropertyPrefix + thread_name, "fifo=x"));
+  policy = GetThreadPolicy(thread_name);
+  ASSERT_FALSE(policy.real_time_priority);
+  ASSERT_FALSE(policy.cpu_affinity_mask);
+}
+
+TEST(ThreadPolicyTest, apply_timer_slack) {
+  ThreadPolicy policy;
+  policy.timer_slack_ns = 100000;
+  auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
+  int old_timer_slack_ns = prctl(PR_GET_TIMERSLACK);
+  ASSERT_TRUE(ApplyThreadPolicy(linux_tid, policy));
+  ASSERT_EQ(prctl(PR_GET_TIMERSLACK), 100000);
+  policy.timer_slack_ns = old_timer_slack_ns;
+  ASSERT_TRUE(ApplyThreadPolicy(linux_tid, policy));
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/timer_wheel.h"
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "common/bind.h"
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+#ifdef __ANDROID__
+#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
+#else
+#define ALARM_CLOCK CLOCK_BOOTTIME
+#endif
+
+namespace bluetooth {
+namespace os {
+using common::Closure;
+
+namespace {
+constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+
+constexpr size_t level_shift(size_t level) {
+  return TimerWheel::kSlotBits * level;
+}
+}  // namespace
+
+std::shared_ptr<TimerWheel> TimerWheel::ForHandler(Handler* handler) {
+  static std::mutex registry_mutex;
+  static auto* registry = new std::unordered_map<Handler*, std::weak_ptr<TimerWheel>>();
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto wheel = (*registry)[handler].lock();
+  if (wheel == nullptr) {
+    // Drop entries of wheels that have been released
+    for (auto it = registry->begin(); it != registry->end();) {
+      it = it->second.expired() ? registry->erase(it) : std::next(it);
+    }
+    wheel = std::make_shared<TimerWheel>(handler);
+    (*registry)[handler] = wheel;
+  }
+  return wheel;
+}
+
+TimerWheel::TimerWheel(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, TFD_NONBLOCK)) {
+  ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
+  current_ms_ = now_ms();
+
+  token_ = handler_->thread_->GetReactor()->Register(
+      fd_, common::Bind(&TimerWheel::on_fire, common::Unretained(this)), Closure());
+}
+
+TimerWheel::~TimerWheel() {
+  Reactor* reactor = handler_->thread_->GetReactor();
+  reactor->Unregister(token_);
+  if (!handler_->thread_->IsSameThread()) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+
+  int close_status;
+  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
+  ASSERT(close_status != -1);
+}
+
+uint64_t TimerWheel::now_ms() const {
+#ifdef USE_FAKE_TIMERS
+  return fake_timer::fake_timerfd_get_clock();
+#else
+  timespec ts;
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+void TimerWheel::Arm(Timer* timer, std::chrono::milliseconds delay, std::chrono::milliseconds period) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  unlink(timer);
+  if (timer->pending_dispatch_) {
+    timer->pending_dispatch_ = false;
+    expired_.erase(std::remove(expired_.begin(), expired_.end(), timer), expired_.end());
+  }
+
+  uint64_t now = now_ms();
+  if (overflow_.empty() && std::all_of(level_sizes_.begin(), level_sizes_.end(), [](size_t n) { return n == 0; })) {
+    // Nothing to cascade, so the wheel can jump straight to the present
+    current_ms_ = std::max(current_ms_, now);
+  }
+  timer->deadline_ms_ = now + delay.count();
+  timer->period_ms_ = period.count();
+  insert(timer, current_ms_ + 1);
+
+  if (timer->deadline_ms_ < timerfd_deadline_ms_) {
+    arm_timerfd(now);
+  }
+}
+
+void TimerWheel::Disarm(Timer* timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  unlink(timer);
+  if (timer->pending_dispatch_) {
+    timer->pending_dispatch_ = false;
+    expired_.erase(std::remove(expired_.begin(), expired_.end(), timer), expired_.end());
+  }
+  // The timerfd is left armed; if it was armed for this timer, the wakeup re-arms it for the next deadline.
+}
+
+void TimerWheel::Remove(Timer* timer) {
+  Disarm(timer);
+  if (handler_->thread_->IsSameThread()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  dispatch_finished_.wait(lock, [this, timer]() { return dispatching_ != timer; });
+}
+
+void TimerWheel::insert(Timer* timer, uint64_t earliest_ms) {
+  // Place the timer on the lowest level whose range still holds its deadline, that is the lowest level above which
+  // the deadline and the current time agree.
+  uint64_t deadline = std::max(timer->deadline_ms_, earliest_ms);
+  Bucket* bucket = &overflow_;
+  size_t level = kLevels;
+  for (size_t l = 0; l < kLevels; l++) {
+    if ((deadline >> level_shift(l + 1)) == (current_ms_ >> level_shift(l + 1))) {
+      bucket = &levels_[l][(deadline >> level_shift(l)) & kSlotMask];
+      level = l;
+      level_sizes_[l]++;
+      break;
+    }
+  }
+  timer->level_ = level;
+  timer->bucket_ = bucket;
+  timer->position_ = bucket->insert(bucket->end(), timer);
+  timer->armed_ = true;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+  if (!timer->armed_) {
+    return;
+  }
+  timer->bucket_->erase(timer->position_);
+  if (timer->level_ < kLevels) {
+    level_sizes_[timer->level_]--;
+  }
+  timer->bucket_ = nullptr;
+  timer->armed_ = false;
+}
+
+void TimerWheel::cascade(size_t level) {
+  Bucket bucket;
+  if (level == kLevels) {
+    bucket.swap(overflow_);
+  } else {
+    bucket.swap(levels_[level][(current_ms_ >> level_shift(level)) & kSlotMask]);
+    level_sizes_[level] -= bucket.size();
+  }
+  // The slot of the current millisecond is expired right after cascading, so timers due now can still go there
+  for (auto* timer : bucket) {
+    timer->armed_ = false;
+    insert(timer, current_ms_);
+  }
+}
+
+void TimerWheel::advance(uint64_t now) {
+  while (current_ms_ < now) {
+    // Jump over the span covered by the lowest empty levels, there is nothing to cascade or expire in it
+    size_t empty_levels = 0;
+    while (empty_levels < kLevels && level_sizes_[empty_levels] == 0) {
+      empty_levels++;
+    }
+    if (empty_levels == kLevels && overflow_.empty()) {
+      current_ms_ = now;
+      return;
+    }
+    if (empty_levels > 0) {
+      current_ms_ = std::min(now, current_ms_ | ((uint64_t{1} << level_shift(empty_levels)) - 1));
+      if (current_ms_ == now) {
+        return;
+      }
+    }
+
+    current_ms_++;
+    for (size_t level = kLevels; level > 0; level--) {
+      if ((current_ms_ & ((uint64_t{1} << level_shift(level)) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+
+    Bucket& bucket = levels_[0][current_ms_ & kSlotMask];
+    while (!bucket.empty()) {
+      Timer* timer = bucket.front();
+      unlink(timer);
+      if (!timer->pending_dispatch_) {
+        timer->pending_dispatch_ = true;
+        expired_.push_back(timer);
+      }
+      if (timer->period_ms_ != 0) {
+        // Like a periodic timerfd, expiries missed while overrunning are coalesced into one
+        if (timer->deadline_ms_ <= now) {
+          timer->deadline_ms_ += ((now - timer->deadline_ms_) / timer->period_ms_ + 1) * timer->period_ms_;
+        }
+        insert(timer, current_ms_ + 1);
+      }
+    }
+  }
+}
+
+bool TimerWheel::next_deadline(uint64_t* deadline) const {
+  const Bucket* bucket = &overflow_;
+  for (size_t level = 0; level < kLevels; level++) {
+    if (level_sizes_[level] == 0) {
+      continue;
+    }
+    // Slots of a level are visited in order, so the first non-empty slot from the current one holds the earliest
+    // deadlines, and every level expires before the next one.
+    for (uint64_t slot = (current_ms_ >> level_shift(level)) & kSlotMask; slot < kSlots; slot++) {
+      if (!levels_[level][slot].empty()) {
+        bucket = &levels_[level][slot];
+        break;
+      }
+    }
+    break;
+  }
+  if (bucket->empty()) {
+    return false;
+  }
+  uint64_t earliest = UINT64_MAX;
+  for (const auto* timer : *bucket) {
+    earliest = std::min(earliest, timer->deadline_ms_);
+  }
+  *deadline = std::max(earliest, current_ms_ + 1);
+  return true;
+}
+
+void TimerWheel::arm_timerfd(uint64_t now) {
+  uint64_t deadline;
+  itimerspec timer_itimerspec{/* disarm timer */};
+  if (next_deadline(&deadline)) {
+    uint64_t delay_ms = deadline > now ? deadline - now : 1;
+    timer_itimerspec.it_value = {static_cast<time_t>(delay_ms / 1000), static_cast<long>(delay_ms % 1000 * 1000000)};
+    timerfd_deadline_ms_ = deadline;
+  } else {
+    timerfd_deadline_ms_ = UINT64_MAX;
+  }
+  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
+  ASSERT(result == 0);
+}
+
+void TimerWheel::on_fire() {
+  uint64_t times_invoked;
+  // Can be empty if the timerfd was re-armed after it became readable
+  read(fd_, &times_invoked, sizeof(uint64_t));
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t now = now_ms();
+  advance(now);
+  arm_timerfd(now);
+
+  while (!expired_.empty()) {
+    Timer* timer = expired_.front();
+    expired_.erase(expired_.begin());
+    timer->pending_dispatch_ = false;
+    dispatching_ = timer;
+    // The timer may be disarmed or destroyed by its own callback
+    Closure on_expired = timer->on_expired_;
+    lock.unlock();
+    on_expired.Run();
+    lock.lock();
+    dispatching_ = nullptr;
+    dispatch_finished_.notify_all();
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
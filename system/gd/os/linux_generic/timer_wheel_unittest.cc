@@ -0,0 +1,175 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/timer_wheel.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+#include "os/alarm.h"
+#include "os/fake_timer/fake_timerfd.h"
+#include "os/repeating_alarm.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+using common::BindOnce;
+using fake_timer::fake_timerfd_advance;
+using fake_timer::fake_timerfd_reset;
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_);
+  }
+
+  void TearDown() override {
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    fake_timerfd_reset();
+  }
+
+  // Advance the fake clock and wait until the wheel had a chance to dispatch what expired
+  void fake_timer_advance(uint64_t ms) {
+    std::promise<void> advanced;
+    auto future = advanced.get_future();
+    handler_->Post(common::BindOnce(fake_timerfd_advance, ms));
+    handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&advanced)));
+    future.get();
+    ASSERT_TRUE(thread_->GetReactor()->WaitForIdle(std::chrono::milliseconds(100)));
+  }
+
+  Handler* handler_;
+  Thread* thread_;
+};
+
+TEST_F(TimerWheelTest, alarms_share_one_wheel) {
+  auto alarm1 = std::make_unique<Alarm>(handler_, AlarmBackend::TIMER_WHEEL);
+  auto wheel = TimerWheel::ForHandler(handler_);
+  auto alarm2 = std::make_unique<RepeatingAlarm>(handler_, AlarmBackend::TIMER_WHEEL);
+  ASSERT_EQ(wheel, TimerWheel::ForHandler(handler_));
+  // Held by the two alarms and this test
+  ASSERT_EQ(wheel.use_count(), 3);
+  alarm1.reset();
+  alarm2.reset();
+  ASSERT_EQ(wheel.use_count(), 1);
+}
+
+TEST_F(TimerWheelTest, schedule) {
+  Alarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm.Schedule(BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(10));
+  fake_timer_advance(9);
+  ASSERT_EQ(future.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+  fake_timer_advance(1);
+  future.get();
+}
+
+TEST_F(TimerWheelTest, cancel_alarm) {
+  Alarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  alarm.Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), std::chrono::milliseconds(3));
+  alarm.Cancel();
+  fake_timer_advance(10);
+}
+
+TEST_F(TimerWheelTest, schedule_while_alarm_armed) {
+  Alarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  alarm.Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), std::chrono::milliseconds(1));
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm.Schedule(BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(10));
+  fake_timer_advance(10);
+  future.get();
+}
+
+TEST_F(TimerWheelTest, delete_while_alarm_armed) {
+  auto alarm = std::make_unique<Alarm>(handler_, AlarmBackend::TIMER_WHEEL);
+  alarm->Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), std::chrono::milliseconds(1));
+  alarm.reset();
+  fake_timer_advance(10);
+}
+
+TEST_F(TimerWheelTest, expire_in_deadline_order_across_levels) {
+  const std::vector<int> delays_ms = {70000, 1, 4096, 63, 65, 5000, 64, 4095, 262144, 300000, 2};
+  std::vector<std::unique_ptr<Alarm>> alarms;
+  std::vector<int> fired;
+  for (int delay_ms : delays_ms) {
+    alarms.push_back(std::make_unique<Alarm>(handler_, AlarmBackend::TIMER_WHEEL));
+    alarms.back()->Schedule(
+        BindOnce([](std::vector<int>* fired, int delay_ms) { fired->push_back(delay_ms); }, &fired, delay_ms),
+        std::chrono::milliseconds(delay_ms));
+  }
+  fake_timer_advance(300000);
+  std::vector<int> expected = delays_ms;
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(fired, expected);
+}
+
+TEST_F(TimerWheelTest, long_delay_does_not_fire_early) {
+  Alarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm.Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), std::chrono::milliseconds(70000));
+  for (int i = 0; i < 6; i++) {
+    fake_timer_advance(10000);
+  }
+  fake_timer_advance(9999);
+  ASSERT_EQ(future.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+  fake_timer_advance(1);
+  future.get();
+}
+
+TEST_F(TimerWheelTest, repeating_alarm) {
+  RepeatingAlarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  int counter = 0;
+  alarm.Schedule(common::Bind([](int* counter) { (*counter)++; }, &counter), std::chrono::milliseconds(10));
+  for (int i = 1; i <= 10; i++) {
+    fake_timer_advance(10);
+    ASSERT_EQ(counter, i);
+  }
+  alarm.Cancel();
+  fake_timer_advance(10);
+  ASSERT_EQ(counter, 10);
+}
+
+TEST_F(TimerWheelTest, repeating_alarm_cancel_from_callback) {
+  RepeatingAlarm alarm(handler_, AlarmBackend::TIMER_WHEEL);
+  int counter = 0;
+  alarm.Schedule(
+      common::Bind(
+          [](RepeatingAlarm* alarm, int* counter) {
+            (*counter)++;
+            alarm->Cancel();
+          },
+          common::Unretained(&alarm),
+          &counter),
+      std::chrono::milliseconds(1));
+  fake_timer_advance(5);
+  ASSERT_EQ(counter, 1);
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
@@ -21,7 +21,9 @@
 #include "os/wakelock_manager.h"
 
 #include <cerrno>
+#include <map>
 #include <mutex>
+#include <vector>
 
 #include "os/internal/wakelock_native.h"
 #include "os/log.h"
@@ -45,6 +47,15 @@ const std::string WakelockManager::kBtWakelockId = "bluetooth_gd_timer";
 
 // Wakelock statistics for the "bluetooth_timer"
 struct WakelockManager::Stats {
+  // Wake reason statistics, for each owner of the wakelock
+  struct OwnerStats {
+    // Acquire calls of the owner not released yet
+    size_t depth = 0;
+    size_t acquired_count = 0;
+    uint64_t last_acquired_timestamp_ms = 0;
+    uint64_t total_held_ms = 0;
+  };
+
   bool is_acquired = false;
   size_t acquired_count = 0;
   size_t released_count = 0;
@@ -59,6 +70,7 @@ struct WakelockManager::Stats {
   uint64_t last_reset_timestamp_ms = now_ms();
   StatusCode last_acquired_error = StatusCode::SUCCESS;
   StatusCode last_released_error = StatusCode::SUCCESS;
+  std::map<std::string, OwnerStats> owners;
 
   void Reset() {
     is_acquired = false;
@@ -75,6 +87,26 @@ struct WakelockManager::Stats {
     last_reset_timestamp_ms = now_ms();
     last_acquired_error = StatusCode::SUCCESS;
     last_released_error = StatusCode::SUCCESS;
+    owners.clear();
+  }
+
+  void UpdateOwnerAcquiredStats(const std::string& owner) {
+    OwnerStats& stats = owners[owner];
+    if (stats.depth++ == 0) {
+      stats.acquired_count++;
+      stats.last_acquired_timestamp_ms = now_ms();
+    }
+  }
+
+  void UpdateOwnerReleasedStats(const std::string& owner) {
+    auto it = owners.find(owner);
+    if (it == owners.end() || it->second.depth == 0) {
+      return;
+    }
+    OwnerStats& stats = it->second;
+    if (--stats.depth == 0) {
+      stats.total_held_ms += now_ms() - stats.last_acquired_timestamp_ms;
+    }
   }
 
   // Update the Bluetooth acquire wakelock statistics.
@@ -156,6 +188,17 @@ struct WakelockManager::Stats {
       avg_interval_ms = total_interval_ms / acquired_count;
     }
 
+    std::vector<flatbuffers::Offset<WakelockOwnerData>> owners_data;
+    for (const auto& [owner, stats] : owners) {
+      uint64_t held_ms = stats.total_held_ms;
+      if (stats.depth > 0) {
+        held_ms += just_now_ms - stats.last_acquired_timestamp_ms;
+      }
+      owners_data.push_back(CreateWakelockOwnerData(
+          *fb_builder, fb_builder->CreateString(owner), stats.depth > 0, stats.acquired_count, held_ms));
+    }
+    auto owners_offset = fb_builder->CreateVector(owners_data);
+
     WakelockManagerDataBuilder builder(*fb_builder);
     builder.add_title(fb_builder->CreateString("Bluetooth Wakelock Statistics"));
     builder.add_is_acquired(is_acquired);
@@ -174,6 +217,7 @@ struct WakelockManager::Stats {
     builder.add_avg_interval_millis(avg_interval_ms);
     builder.add_total_interval_millis(total_interval_ms);
     builder.add_total_time_since_reset_millis(just_now_ms - last_reset_timestamp_ms);
+    builder.add_owners(owners_offset);
     return builder.Finish();
   }
 };
@@ -192,7 +236,7 @@ void WakelockManager::SetOsCallouts(OsCallouts* callouts, Handler* handler) {
   LOG_INFO("set to %s", is_native_ ? "native" : "non-native");
 }
 
-bool WakelockManager::Acquire() {
+bool WakelockManager::Acquire(const std::string& owner) {
   std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
   if (!initialized_) {
     if (is_native_) {
@@ -210,6 +254,7 @@ bool WakelockManager::Acquire() {
   }
 
   pstats_->UpdateAcquiredStats(status);
+  pstats_->UpdateOwnerAcquiredStats(owner);
 
   if (status != StatusCode::SUCCESS) {
     LOG_ERROR("unable to acquire wake lock, error code: %u", status);
@@ -218,7 +263,7 @@ bool WakelockManager::Acquire() {
   return status == StatusCode ::SUCCESS;
 }
 
-bool WakelockManager::Release() {
+bool WakelockManager::Release(const std::string& owner) {
   std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
   if (!initialized_) {
     if (is_native_) {
@@ -236,6 +281,7 @@ bool WakelockManager::Release() {
   }
 
   pstats_->UpdateReleasedStats(status);
+  pstats_->UpdateOwnerReleasedStats(owner);
 
   if (status != StatusCode::SUCCESS) {
     LOG_ERROR("unable to release wake lock, error code: %u", status);
@@ -252,7 +298,7 @@ void WakelockManager::CleanUp() {
   }
   if (pstats_->is_acquired) {
     LOG_ERROR("Releasing wake lock as part of cleanup");
-    Release();
+    Release(kBtWakelockId);
   }
   if (is_native_) {
     WakelockNative::Get().CleanUp();
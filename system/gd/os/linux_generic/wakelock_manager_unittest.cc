@@ -39,6 +39,8 @@ using bluetooth::os::WakelockManager;
 using bluetooth::os::WakelockManagerData;
 using bluetooth::os::WakelockManagerDataBuilder;
 
+constexpr char kOwner[] = "test_owner";
+
 class TestOsCallouts : public WakelockManager::OsCallouts {
  public:
   void AcquireCallout(const std::string& lock_name) override {
@@ -102,17 +104,17 @@ TEST_F(WakelockManagerTest, test_set_os_callouts_repeated_acquire) {
   ASSERT_TRUE(os_callouts.acquired_lock_counts.empty());
   ASSERT_FALSE(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId));
 
-  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire(kOwner);
   SyncHandler();
   ASSERT_EQ(os_callouts.acquired_lock_counts.size(), (size_t)1);
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
 
-  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire(kOwner);
   SyncHandler();
   ASSERT_EQ(os_callouts.acquired_lock_counts.size(), (size_t)1);
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(2)));
 
-  WakelockManager::Get().Release();
+  WakelockManager::Get().Release(kOwner);
   SyncHandler();
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
 
@@ -128,18 +130,18 @@ TEST_F(WakelockManagerTest, test_set_os_callouts_repeated_release) {
   ASSERT_TRUE(os_callouts.acquired_lock_counts.empty());
   ASSERT_FALSE(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId));
 
-  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire(kOwner);
   SyncHandler();
   ASSERT_EQ(os_callouts.acquired_lock_counts.size(), (size_t)1);
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
 
-  WakelockManager::Get().Release();
+  WakelockManager::Get().Release(kOwner);
   SyncHandler();
   ASSERT_EQ(os_callouts.acquired_lock_counts.size(), (size_t)1);
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(0)));
 
   // OS callouts allow pass through for repeated release calls
-  WakelockManager::Get().Release();
+  WakelockManager::Get().Release(kOwner);
   SyncHandler();
   ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(-1)));
 
@@ -156,11 +158,11 @@ TEST_F(WakelockManagerTest, test_with_os_callouts_in_a_loop_and_dump) {
   ASSERT_FALSE(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId));
 
   for (size_t i = 0; i < 1000; i++) {
-    WakelockManager::Get().Acquire();
+    WakelockManager::Get().Acquire(kOwner);
     SyncHandler();
     ASSERT_EQ(os_callouts.acquired_lock_counts.size(), (size_t)1);
     ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
-    WakelockManager::Get().Release();
+    WakelockManager::Get().Release(kOwner);
     SyncHandler();
     ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(0)));
   }
@@ -173,6 +175,10 @@ TEST_F(WakelockManagerTest, test_with_os_callouts_in_a_loop_and_dump) {
 
     ASSERT_EQ(data->acquired_count(), 1000);
     ASSERT_EQ(data->released_count(), 1000);
+    ASSERT_EQ(data->owners()->size(), 1u);
+    ASSERT_EQ(data->owners()->Get(0)->name()->str(), kOwner);
+    ASSERT_FALSE(data->owners()->Get(0)->is_holding());
+    ASSERT_EQ(data->owners()->Get(0)->acquired_count(), 1000);
   }
 
   WakelockManager::Get().CleanUp();
@@ -186,7 +192,41 @@ TEST_F(WakelockManagerTest, test_with_os_callouts_in_a_loop_and_dump) {
 
     ASSERT_EQ(data->acquired_count(), 0);
     ASSERT_EQ(data->released_count(), 0);
+    ASSERT_EQ(data->owners()->size(), 0u);
+  }
+}
+
+TEST_F(WakelockManagerTest, test_dump_owners) {
+  TestOsCallouts os_callouts;
+  WakelockManager::Get().SetOsCallouts(&os_callouts, handler_);
+
+  WakelockManager::Get().Acquire("owner_1");
+  WakelockManager::Get().Acquire("owner_2");
+  WakelockManager::Get().Release("owner_1");
+  WakelockManager::Get().Acquire("owner_1");
+  SyncHandler();
+
+  {
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto offset = WakelockManager::Get().GetDumpsysData(&builder);
+    FinishWakelockManagerDataBuffer(builder, offset);
+    auto data = GetWakelockManagerData(builder.GetBufferPointer());
+
+    ASSERT_EQ(data->owners()->size(), 2u);
+    auto owner_1 = data->owners()->Get(0);
+    ASSERT_EQ(owner_1->name()->str(), "owner_1");
+    ASSERT_TRUE(owner_1->is_holding());
+    ASSERT_EQ(owner_1->acquired_count(), 2);
+    auto owner_2 = data->owners()->Get(1);
+    ASSERT_EQ(owner_2->name()->str(), "owner_2");
+    ASSERT_TRUE(owner_2->is_holding());
+    ASSERT_EQ(owner_2->acquired_count(), 1);
   }
+
+  WakelockManager::Get().Release("owner_1");
+  WakelockManager::Get().Release("owner_2");
+  WakelockManager::Get().CleanUp();
+  SyncHandler();
 }
 
 }  // namespace testing
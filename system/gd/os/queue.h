@@ -18,12 +18,16 @@
 
 #include <unistd.h>
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 #include "common/bind.h"
 #include "common/callback.h"
+#include "common/mpsc_queue.h"
 #include "os/handler.h"
 #include "os/linux_generic/reactive_semaphore.h"
 #include "os/log.h"
@@ -157,6 +161,110 @@ class EnqueueBuffer {
   common::OnceClosure callback_on_empty_;
 };
 
+// An EnqueueBuffer for realtime streams such as SCO and ISO data, which are enqueued from a thread outside of the
+// stack. Enqueue() doesn't take a lock or touch the queue registration: items go into a lock-free list and |handler|
+// is only posted to when the buffer goes from empty to non-empty. The enqueue callback is registered and
+// unregistered on |handler|, so a burst of packets costs one post instead of a mutex and a reactor update each.
+template <typename T>
+class MpscEnqueueBuffer {
+ public:
+  MpscEnqueueBuffer(IQueueEnqueue<T>* queue, Handler* handler) : state_(std::make_shared<State>(queue, handler)) {}
+
+  MpscEnqueueBuffer(const MpscEnqueueBuffer&) = delete;
+  MpscEnqueueBuffer& operator=(const MpscEnqueueBuffer&) = delete;
+
+  ~MpscEnqueueBuffer() {
+    Clear();
+  }
+
+  // Safe to call from any number of threads. Items enqueued after Clear() are dropped.
+  void Enqueue(std::unique_ptr<T> t) {
+    if (state_->cleared) {
+      return;
+    }
+    state_->buffer.Push(std::move(t));
+    if (state_->pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+      state_->handler->Post(common::BindOnce(&State::register_enqueue, state_));
+    }
+  }
+
+  // Unregister from the queue and drop the buffered items. Must not race with Enqueue().
+  void Clear() {
+    if (state_->cleared.exchange(true)) {
+      return;
+    }
+    while (true) {
+      Registration registration = state_->registration.load();
+      if (registration == Registration::REGISTERING) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (registration == Registration::REGISTERED && !state_->Unregister()) {
+        continue;
+      }
+      break;
+    }
+    state_->buffer.Clear();
+    state_->pending = 0;
+  }
+
+  auto Size() const {
+    return state_->pending.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum class Registration { UNREGISTERED, REGISTERING, REGISTERED };
+
+  // Shared with the posted registration and the enqueue callback, which may outlive this buffer
+  struct State {
+    State(IQueueEnqueue<T>* queue, Handler* handler) : queue(queue), handler(handler) {}
+
+    // Returns false if the enqueue callback was already unregistered by someone else
+    bool Unregister() {
+      Registration expected = Registration::REGISTERED;
+      if (!registration.compare_exchange_strong(expected, Registration::UNREGISTERED)) {
+        return false;
+      }
+      queue->UnregisterEnqueue();
+      return true;
+    }
+
+    static void register_enqueue(std::shared_ptr<State> state) {
+      Registration expected = Registration::UNREGISTERED;
+      if (state->cleared || !state->registration.compare_exchange_strong(expected, Registration::REGISTERING)) {
+        return;
+      }
+      state->queue->RegisterEnqueue(state->handler, common::Bind(&State::enqueue_callback, state));
+      state->registration = Registration::REGISTERED;
+      // Clear() may have missed the registration, in which case it is undone here
+      if (state->cleared) {
+        state->Unregister();
+      }
+    }
+
+    static std::unique_ptr<T> enqueue_callback(std::shared_ptr<State> state) {
+      std::unique_ptr<T> enqueued_t;
+      // |pending| is only increased once an item is pushed, an earlier producer may still be linking its own
+      while (!state->buffer.Pop(&enqueued_t)) {
+        std::this_thread::yield();
+      }
+      if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        state->Unregister();
+      }
+      return enqueued_t;
+    }
+
+    IQueueEnqueue<T>* queue;
+    Handler* handler;
+    common::MpscQueue<std::unique_ptr<T>> buffer;
+    std::atomic<size_t> pending = 0;
+    std::atomic<Registration> registration = Registration::UNREGISTERED;
+    std::atomic_bool cleared = false;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
 #include "os/linux_generic/queue.tpp"
 
 }  // namespace os
@@ -19,12 +19,14 @@
 #include <sys/epoll.h>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
-#include <list>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "common/callback.h"
 #include "os/utils.h"
@@ -96,12 +98,35 @@ class Reactor {
   };
   std::unique_ptr<Reactor::Event> NewEvent() const;
 
+  // Dispatch statistics of one registered reactable, accumulated since it was registered
+  struct ReactableStats {
+    int fd;
+    uint64_t dispatch_count;
+    std::chrono::microseconds total_callback_duration;
+    std::chrono::microseconds max_callback_duration;
+  };
+
+  struct Stats {
+    uint64_t wakeup_count;
+    uint64_t event_count;
+    int max_events_per_wakeup;
+    std::vector<ReactableStats> reactables;
+  };
+
+  // Take a snapshot of the dispatch statistics of this reactor and its currently registered reactables. May be invoked
+  // from any thread.
+  Stats GetStats() const;
+
  private:
   mutable std::mutex mutex_;
   int epoll_fd_;
   int control_fd_;
   std::atomic<bool> is_running_;
-  std::list<Reactable*> invalidation_list_;
+  std::unordered_set<Reactable*> registered_;
+  std::vector<Reactable*> invalidation_list_;
+  std::atomic<uint64_t> wakeup_count_{0};
+  std::atomic<uint64_t> event_count_{0};
+  std::atomic<int> max_events_per_wakeup_{0};
   std::shared_ptr<std::future<void>> executing_reactable_finished_;
   std::shared_ptr<std::promise<void>> idle_promise_;
 };
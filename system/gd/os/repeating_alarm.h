@@ -23,6 +23,7 @@
 #include "common/callback.h"
 #include "os/handler.h"
 #include "os/thread.h"
+#include "os/timer_wheel.h"
 #include "os/utils.h"
 
 namespace bluetooth {
@@ -30,11 +31,12 @@ namespace os {
 
 // A repeating alarm for reactor-based thread, implemented by Linux timerfd.
 // When it's constructed, it will register a reactable on the specified thread; when it's destroyed, it will unregister
-// itself from the thread.
+// itself from the thread. With AlarmBackend::TIMER_WHEEL, the timerfd and reactable are instead shared with every other
+// TIMER_WHEEL alarm on the same handler.
 class RepeatingAlarm {
  public:
   // Create and register a repeating alarm on a given handler
-  explicit RepeatingAlarm(Handler* handler);
+  explicit RepeatingAlarm(Handler* handler, AlarmBackend backend = AlarmBackend::TIMERFD);
 
   RepeatingAlarm(const RepeatingAlarm&) = delete;
   RepeatingAlarm& operator=(const RepeatingAlarm&) = delete;
@@ -52,9 +54,12 @@ class RepeatingAlarm {
   common::Closure task_;
   Handler* handler_;
   int fd_ = 0;
-  Reactor::Reactable* token_;
+  Reactor::Reactable* token_ = nullptr;
+  std::shared_ptr<TimerWheel> timer_wheel_;
+  std::unique_ptr<TimerWheel::Timer> timer_;
   mutable std::mutex mutex_;
   void on_fire();
+  void on_timer_wheel_fire();
 };
 
 }  // namespace os
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/task_monitor.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/bind.h"
+#include "os/log.h"
+#include "os/system_properties.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+constexpr std::chrono::milliseconds kMinWatchdogPeriod = std::chrono::milliseconds(1);
+// Tags printed per thread by the dump, the ones with the longest total run time first
+constexpr size_t kMaxDumpedTags = 10;
+
+int64_t ToUs(TaskMonitor::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+int64_t ToMs(TaskMonitor::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+const char* TagText(const char* tag) {
+  return tag != nullptr ? tag : "(untagged)";
+}
+
+}  // namespace
+
+// Thread checking the running task of every monitor, started with the first monitor. It is never destroyed, so that
+// the monitors of static threads can still unregister at exit.
+class TaskWatchdog {
+ public:
+  static TaskWatchdog* Get() {
+    static TaskWatchdog* watchdog = new TaskWatchdog();
+    return watchdog;
+  }
+
+  void Register(TaskMonitor* monitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    monitors_.push_back(monitor);
+    if (!started_) {
+      started_ = true;
+      std::thread(&TaskWatchdog::Run, this).detach();
+    }
+    cv_.notify_all();
+  }
+
+  void Unregister(TaskMonitor* monitor) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    monitors_.erase(std::remove(monitors_.begin(), monitors_.end(), monitor), monitors_.end());
+  }
+
+  void Dump(int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (monitors_.empty()) {
+      dprintf(fd, "\nBluetooth task monitor: disabled, enable with %s\n", kTaskMonitorBudgetProperty.c_str());
+      return;
+    }
+    dprintf(fd, "\nBluetooth task monitor (%zu threads):\n", monitors_.size());
+    for (const auto* monitor : monitors_) {
+      monitor->Dump(fd);
+    }
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (monitors_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      // Half the shortest budget, so that an offender is reported before it has run for twice its budget
+      auto period = monitors_.front()->GetBudget();
+      for (const auto* monitor : monitors_) {
+        period = std::min(period, monitor->GetBudget());
+      }
+      cv_.wait_for(lock, std::max(period / 2, kMinWatchdogPeriod));
+      auto now = TaskMonitor::Clock::now();
+      for (auto* monitor : monitors_) {
+        monitor->CheckRunningTask(now);
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<TaskMonitor*> monitors_;
+  bool started_ = false;
+};
+
+void TaskMonitor::Histogram::Add(Clock::duration duration) {
+  uint64_t us = std::max<int64_t>(ToUs(duration), 0);
+  size_t bucket = 0;
+  while (us > 1 && bucket < kNumBuckets - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  buckets[bucket]++;
+  count++;
+  total += duration;
+  max = std::max(max, duration);
+}
+
+TaskMonitor::Clock::duration TaskMonitor::Histogram::Percentile(int percentile) const {
+  uint64_t threshold = (count * percentile + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; bucket++) {
+    seen += buckets[bucket];
+    if (seen >= threshold && seen > 0) {
+      return bucket == kNumBuckets - 1 ? max : std::chrono::microseconds(uint64_t(2) << bucket);
+    }
+  }
+  return Clock::duration::zero();
+}
+
+std::shared_ptr<TaskMonitor> TaskMonitor::Create(const std::string& thread_name) {
+  uint32_t budget_ms = GetSystemPropertyUint32(kTaskMonitorBudgetProperty, 0);
+  if (budget_ms == 0) {
+    return nullptr;
+  }
+  return std::make_shared<TaskMonitor>(thread_name, std::chrono::milliseconds(budget_ms));
+}
+
+TaskMonitor::TaskMonitor(const std::string& thread_name, std::chrono::milliseconds budget)
+    : thread_name_(thread_name), budget_(budget) {
+  TaskWatchdog::Get()->Register(this);
+}
+
+TaskMonitor::~TaskMonitor() {
+  TaskWatchdog::Get()->Unregister(this);
+}
+
+common::OnceClosure TaskMonitor::Wrap(
+    std::shared_ptr<TaskMonitor> monitor, const char* tag, common::OnceClosure task, Clock::duration delay) {
+  return common::BindOnce(&TaskMonitor::RunTask, std::move(monitor), tag, Clock::now() + delay, std::move(task));
+}
+
+void TaskMonitor::RunTask(
+    std::shared_ptr<TaskMonitor> monitor, const char* tag, Clock::time_point posted, common::OnceClosure task) {
+  auto start = Clock::now();
+  monitor->running_tag_.store(tag, std::memory_order_release);
+  monitor->running_since_.store(start.time_since_epoch().count(), std::memory_order_release);
+
+  std::move(task).Run();
+
+  auto end = Clock::now();
+  monitor->running_since_.store(0, std::memory_order_release);
+
+  auto queue_latency = std::max(start - posted, Clock::duration::zero());
+  auto run_time = end - start;
+  bool over_budget = run_time > monitor->budget_;
+  if (over_budget) {
+    LOG_WARN(
+        "Task from %s on %s ran for %" PRId64 " ms, over the budget of %" PRId64 " ms (queued for %" PRId64 " ms)",
+        TagText(tag),
+        monitor->thread_name_.c_str(),
+        ToMs(run_time),
+        static_cast<int64_t>(monitor->budget_.count()),
+        ToMs(queue_latency));
+  }
+
+  std::lock_guard<std::mutex> lock(monitor->mutex_);
+  monitor->queue_latency_.Add(queue_latency);
+  monitor->run_time_.Add(run_time);
+  auto& stats = monitor->tag_stats_[tag];
+  stats.count++;
+  stats.over_budget += over_budget ? 1 : 0;
+  stats.total_run_time += run_time;
+  stats.max_run_time = std::max(stats.max_run_time, run_time);
+  stats.max_queue_latency = std::max(stats.max_queue_latency, queue_latency);
+}
+
+void TaskMonitor::CheckRunningTask(Clock::time_point now) {
+  Clock::rep since = running_since_.load(std::memory_order_acquire);
+  if (since == 0 || reported_since_.load(std::memory_order_relaxed) == since) {
+    return;
+  }
+  auto running_for = now - Clock::time_point(Clock::duration(since));
+  if (running_for <= budget_) {
+    return;
+  }
+  const char* tag = running_tag_.load(std::memory_order_acquire);
+  // The tag is the one of the next task if the thread moved on meanwhile
+  if (running_since_.load(std::memory_order_acquire) != since) {
+    return;
+  }
+  reported_since_.store(since, std::memory_order_relaxed);
+  watchdog_reports_.fetch_add(1, std::memory_order_relaxed);
+  LOG_WARN(
+      "Task from %s on %s is running for %" PRId64 " ms, over the budget of %" PRId64 " ms",
+      TagText(tag),
+      thread_name_.c_str(),
+      ToMs(running_for),
+      static_cast<int64_t>(budget_.count()));
+}
+
+TaskMonitor::Histogram TaskMonitor::GetQueueLatency() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_latency_;
+}
+
+TaskMonitor::Histogram TaskMonitor::GetRunTime() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return run_time_;
+}
+
+TaskMonitor::TagStats TaskMonitor::GetTagStats(const char* tag) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tag_stats_.find(tag);
+  return it != tag_stats_.end() ? it->second : TagStats{};
+}
+
+static void DumpHistogram(int fd, const char* name, const TaskMonitor::Histogram& histogram) {
+  dprintf(
+      fd,
+      "    %s: %" PRIu64 " tasks, mean %" PRId64 " us, p50 < %" PRId64 " us, p99 < %" PRId64 " us, max %" PRId64
+      " us\n",
+      name,
+      histogram.count,
+      histogram.count > 0 ? ToUs(histogram.total) / static_cast<int64_t>(histogram.count) : 0,
+      ToUs(histogram.Percentile(50)),
+      ToUs(histogram.Percentile(99)),
+      ToUs(histogram.max));
+  dprintf(fd, "     ");
+  for (size_t bucket = 0; bucket < TaskMonitor::kNumBuckets; bucket++) {
+    if (histogram.buckets[bucket] != 0) {
+      dprintf(fd, " <%" PRIu64 "us:%" PRIu64, uint64_t(2) << bucket, histogram.buckets[bucket]);
+    }
+  }
+  dprintf(fd, "\n");
+}
+
+void TaskMonitor::Dump(int fd) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dprintf(
+      fd,
+      "  %s (budget %" PRId64 " ms, %" PRIu64 " watchdog reports):\n",
+      thread_name_.c_str(),
+      static_cast<int64_t>(budget_.count()),
+      GetWatchdogReports());
+  DumpHistogram(fd, "queue latency", queue_latency_);
+  DumpHistogram(fd, "run time", run_time_);
+
+  std::vector<std::pair<const char*, TagStats>> tags(tag_stats_.begin(), tag_stats_.end());
+  std::sort(tags.begin(), tags.end(), [](const auto& a, const auto& b) {
+    return a.second.total_run_time > b.second.total_run_time;
+  });
+  if (tags.size() > kMaxDumpedTags) {
+    tags.resize(kMaxDumpedTags);
+  }
+  for (const auto& [tag, stats] : tags) {
+    dprintf(
+        fd,
+        "    %-48s %8" PRIu64 " tasks, %4" PRIu64 " over budget, total %8" PRId64 " ms, max run %6" PRId64
+        " ms, max latency %6" PRId64 " ms\n",
+        TagText(tag),
+        stats.count,
+        stats.over_budget,
+        ToMs(stats.total_run_time),
+        ToMs(stats.max_run_time),
+        ToMs(stats.max_queue_latency));
+  }
+}
+
+void DumpTaskMonitors(int fd) {
+  TaskWatchdog::Get()->Dump(fd);
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/callback.h"
+
+namespace bluetooth {
+namespace os {
+
+// Timing of the tasks run by a stack thread: the time from posting to running (queue latency) and the time spent
+// running, for the whole thread and per posting location. A watchdog logs the tasks that run for longer than the
+// budget of their thread while they are still running, so that a long closure delaying everything else shows up in
+// the logs as it happens.
+//
+// Monitoring is off unless the persist.bluetooth.task_monitor.budget_ms system property is set, in which case every
+// task of the gd handlers and of the message loop threads is wrapped when it is posted.
+class TaskMonitor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Bucket i holds the durations of [2^i, 2^(i+1)) microseconds, the first one anything shorter and the last one
+  // anything longer (about 8 s)
+  static constexpr size_t kNumBuckets = 24;
+
+  struct Histogram {
+    std::array<uint64_t, kNumBuckets> buckets{};
+    uint64_t count = 0;
+    Clock::duration total{};
+    Clock::duration max{};
+
+    void Add(Clock::duration duration);
+    // Upper bound of the bucket holding the |percentile| of the durations
+    Clock::duration Percentile(int percentile) const;
+  };
+
+  struct TagStats {
+    uint64_t count = 0;
+    uint64_t over_budget = 0;
+    Clock::duration total_run_time{};
+    Clock::duration max_run_time{};
+    Clock::duration max_queue_latency{};
+  };
+
+  // Return the monitor of the thread |thread_name|, nullptr if monitoring is disabled
+  static std::shared_ptr<TaskMonitor> Create(const std::string& thread_name);
+
+  TaskMonitor(const std::string& thread_name, std::chrono::milliseconds budget);
+  TaskMonitor(const TaskMonitor&) = delete;
+  TaskMonitor& operator=(const TaskMonitor&) = delete;
+  ~TaskMonitor();
+
+  // Wrap |task| so that it is timed when it runs, |delay| after now. |tag| identifies where the task was posted from
+  // and is only kept as a pointer, so it must be a string literal or base::Location::function_name().
+  static common::OnceClosure Wrap(
+      std::shared_ptr<TaskMonitor> monitor,
+      const char* tag,
+      common::OnceClosure task,
+      Clock::duration delay = Clock::duration::zero());
+
+  const std::string& GetThreadName() const {
+    return thread_name_;
+  }
+
+  std::chrono::milliseconds GetBudget() const {
+    return budget_;
+  }
+
+  Histogram GetQueueLatency() const;
+  Histogram GetRunTime() const;
+  TagStats GetTagStats(const char* tag) const;
+  uint64_t GetWatchdogReports() const {
+    return watchdog_reports_.load(std::memory_order_relaxed);
+  }
+
+  void Dump(int fd) const;
+
+ private:
+  friend class TaskWatchdog;
+
+  static void RunTask(
+      std::shared_ptr<TaskMonitor> monitor, const char* tag, Clock::time_point posted, common::OnceClosure task);
+  // Called by the watchdog, log the running task if it is over the budget and wasn't reported yet
+  void CheckRunningTask(Clock::time_point now);
+
+  const std::string thread_name_;
+  const std::chrono::milliseconds budget_;
+
+  mutable std::mutex mutex_;
+  Histogram queue_latency_;
+  Histogram run_time_;
+  std::unordered_map<const char*, TagStats> tag_stats_;
+
+  // The task being run, read by the watchdog. |running_since_| is 0 when the thread is idle.
+  std::atomic<const char*> running_tag_{nullptr};
+  std::atomic<Clock::rep> running_since_{0};
+  std::atomic<Clock::rep> reported_since_{0};
+  std::atomic<uint64_t> watchdog_reports_{0};
+};
+
+static const std::string kTaskMonitorBudgetProperty = "persist.bluetooth.task_monitor.budget_ms";
+
+// Dumps the task timing of every monitored thread
+void DumpTaskMonitors(int fd);
+
+}  // namespace os
+}  // namespace bluetooth
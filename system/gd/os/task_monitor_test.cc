@@ -0,0 +1,112 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/task_monitor.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "common/bind.h"
+#include "os/system_properties.h"
+
+namespace testing {
+
+using bluetooth::common::BindOnce;
+using bluetooth::os::TaskMonitor;
+
+constexpr char kTagA[] = "TaskA";
+constexpr char kTagB[] = "TaskB";
+
+TEST(TaskMonitorTest, histogram_buckets_test) {
+  TaskMonitor::Histogram histogram;
+  histogram.Add(std::chrono::microseconds(0));
+  histogram.Add(std::chrono::microseconds(3));
+  histogram.Add(std::chrono::microseconds(3));
+  histogram.Add(std::chrono::milliseconds(10));
+
+  ASSERT_EQ(histogram.count, 4u);
+  ASSERT_EQ(histogram.buckets[0], 1u);
+  ASSERT_EQ(histogram.buckets[1], 2u);
+  // 10000 us is in [8192, 16384)
+  ASSERT_EQ(histogram.buckets[13], 1u);
+  ASSERT_EQ(histogram.max, std::chrono::milliseconds(10));
+  ASSERT_EQ(histogram.Percentile(50), std::chrono::microseconds(4));
+  ASSERT_EQ(histogram.Percentile(99), std::chrono::microseconds(16384));
+}
+
+TEST(TaskMonitorTest, records_tasks_per_tag_test) {
+  auto monitor = std::make_shared<TaskMonitor>("test_thread", std::chrono::seconds(10));
+  int runs = 0;
+  for (int i = 0; i < 3; i++) {
+    TaskMonitor::Wrap(monitor, kTagA, BindOnce([](int* runs) { (*runs)++; }, &runs)).Run();
+  }
+  TaskMonitor::Wrap(monitor, kTagB, BindOnce([](int* runs) { (*runs)++; }, &runs)).Run();
+
+  ASSERT_EQ(runs, 4);
+  ASSERT_EQ(monitor->GetRunTime().count, 4u);
+  ASSERT_EQ(monitor->GetQueueLatency().count, 4u);
+  ASSERT_EQ(monitor->GetTagStats(kTagA).count, 3u);
+  ASSERT_EQ(monitor->GetTagStats(kTagB).count, 1u);
+  ASSERT_EQ(monitor->GetTagStats(kTagA).over_budget, 0u);
+  ASSERT_EQ(monitor->GetTagStats(nullptr).count, 0u);
+}
+
+TEST(TaskMonitorTest, queue_latency_test) {
+  auto monitor = std::make_shared<TaskMonitor>("test_thread", std::chrono::seconds(10));
+  auto task = TaskMonitor::Wrap(monitor, kTagA, BindOnce([] {}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  std::move(task).Run();
+  ASSERT_GE(monitor->GetTagStats(kTagA).max_queue_latency, std::chrono::milliseconds(20));
+
+  // The delay of a delayed task is not latency
+  TaskMonitor::Wrap(monitor, kTagB, BindOnce([] {}), std::chrono::seconds(60)).Run();
+  ASSERT_EQ(monitor->GetTagStats(kTagB).max_queue_latency, TaskMonitor::Clock::duration::zero());
+}
+
+TEST(TaskMonitorTest, watchdog_reports_long_task_test) {
+  auto monitor = std::make_shared<TaskMonitor>("test_thread", std::chrono::milliseconds(10));
+  TaskMonitor::Wrap(monitor, kTagA, BindOnce([] { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }))
+      .Run();
+
+  // Reported by the watchdog once, while it was still running
+  ASSERT_EQ(monitor->GetWatchdogReports(), 1u);
+  ASSERT_EQ(monitor->GetTagStats(kTagA).over_budget, 1u);
+  ASSERT_GE(monitor->GetTagStats(kTagA).max_run_time, std::chrono::milliseconds(100));
+
+  TaskMonitor::Wrap(monitor, kTagB, BindOnce([] {})).Run();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  ASSERT_EQ(monitor->GetWatchdogReports(), 1u);
+  ASSERT_EQ(monitor->GetTagStats(kTagB).over_budget, 0u);
+}
+
+TEST(TaskMonitorTest, enabled_by_property_test) {
+  if (!bluetooth::os::ClearSystemPropertiesForHost()) {
+    GTEST_SKIP() << "The properties of the device can't be cleared";
+  }
+  ASSERT_EQ(TaskMonitor::Create("test_thread"), nullptr);
+
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(bluetooth::os::kTaskMonitorBudgetProperty, "20"));
+  auto monitor = TaskMonitor::Create("test_thread");
+  ASSERT_NE(monitor, nullptr);
+  ASSERT_EQ(monitor->GetThreadName(), "test_thread");
+  ASSERT_EQ(monitor->GetBudget(), std::chrono::milliseconds(20));
+  bluetooth::os::ClearSystemPropertiesForHost();
+}
+
+}  // namespace testing
@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
 #include "os/reactor.h"
+#include "os/task_monitor.h"
 #include "os/utils.h"
 
 namespace bluetooth {
@@ -64,11 +66,15 @@ class Thread {
   // Return the pointer of underlying reactor. The ownership is NOT transferred.
   Reactor* GetReactor() const;
 
+  // Return the monitor timing the tasks of the handlers of this thread, nullptr if task monitoring is disabled
+  std::shared_ptr<TaskMonitor> GetTaskMonitor() const;
+
  private:
   void run(Priority priority);
   mutable std::mutex mutex_;
   const std::string name_;
   mutable Reactor reactor_;
+  const std::shared_ptr<TaskMonitor> task_monitor_;
   std::thread running_thread_;
 };
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace bluetooth {
+namespace os {
+
+// Scheduling policy of a stack thread, shared by the gd and osi threads. The policy of a thread is read from the
+// persist.bluetooth.thread_policy.<thread name> system property, a comma separated list of:
+//   fifo=<priority>   SCHED_FIFO priority, 0 for the default time-sharing policy
+//   cpus=<hex mask>   CPUs the thread may run on, e.g. f0 to keep an audio thread on the big cores
+//   slack_ns=<ns>     timer slack of the thread
+// Fields that are not set keep the defaults of the thread.
+struct ThreadPolicy {
+  std::optional<int> real_time_priority;
+  std::optional<uint64_t> cpu_affinity_mask;
+  std::optional<uint64_t> timer_slack_ns;
+};
+
+static const std::string kThreadPolicyPropertyPrefix = "persist.bluetooth.thread_policy.";
+
+// Parse a policy in the format of the property, return std::nullopt if |value| is malformed
+std::optional<ThreadPolicy> ParseThreadPolicy(const std::string& value);
+
+// Get the policy configured for |thread_name|, with |default_real_time_priority| as the SCHED_FIFO priority if the
+// property doesn't set one (0 keeps the default policy of the thread)
+ThreadPolicy GetThreadPolicy(const std::string& thread_name, int default_real_time_priority = 0);
+
+// Apply |policy| to the thread |linux_tid|, return false if any part of it couldn't be applied
+bool ApplyThreadPolicy(pid_t linux_tid, const ThreadPolicy& policy);
+
+}  // namespace os
+}  // namespace bluetooth
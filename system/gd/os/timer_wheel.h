@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/callback.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+// How an Alarm or RepeatingAlarm is backed.
+enum class AlarmBackend {
+  // The alarm owns a dedicated timerfd registered on the reactor
+  TIMERFD,
+  // The alarm shares the TimerWheel of its handler, and with it a single timerfd
+  TIMER_WHEEL,
+};
+
+// A hierarchical timer wheel with millisecond resolution, multiplexing any number of timers onto a single timerfd
+// registered on the reactor of one handler's thread. The timerfd is only armed for the earliest pending deadline, so an
+// idle wheel costs no wakeups.
+//
+// Timers are grouped in kLevels levels of kSlots slots; level n has a resolution of kSlots^n milliseconds and they are
+// cascaded down a level when the wheel reaches their slot. Insertion and removal are O(1).
+class TimerWheel {
+ public:
+  class Timer {
+   public:
+    // on_expired is invoked on the thread of the wheel each time the timer expires
+    explicit Timer(common::Closure on_expired) : on_expired_(std::move(on_expired)) {}
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    friend class TimerWheel;
+    common::Closure on_expired_;
+    uint64_t deadline_ms_ = 0;
+    uint64_t period_ms_ = 0;
+    bool armed_ = false;
+    bool pending_dispatch_ = false;
+    size_t level_ = 0;
+    std::list<Timer*>* bucket_ = nullptr;
+    std::list<Timer*>::iterator position_;
+  };
+
+  // Return the wheel shared by all TIMER_WHEEL alarms on the given handler, creating it if needed. The wheel is
+  // released when the last reference to it goes away.
+  static std::shared_ptr<TimerWheel> ForHandler(Handler* handler);
+
+  explicit TimerWheel(Handler* handler);
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Unregister the timerfd from the thread. All timers must have been removed.
+  ~TimerWheel();
+
+  // (Re)arm a timer to expire after delay. If period is non-zero, it will then expire every period until disarmed.
+  void Arm(Timer* timer, std::chrono::milliseconds delay, std::chrono::milliseconds period);
+
+  // Disarm a timer, including an expiry that was already collected but not yet dispatched. No-op if it's not armed.
+  void Disarm(Timer* timer);
+
+  // Disarm a timer and wait until it is no longer being dispatched on another thread, so that it can be destroyed.
+  void Remove(Timer* timer);
+
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kSlots = 1 << kSlotBits;
+  static constexpr size_t kLevels = 4;
+
+ private:
+  using Bucket = std::list<Timer*>;
+
+  uint64_t now_ms() const;
+  void insert(Timer* timer, uint64_t earliest_ms);
+  void unlink(Timer* timer);
+  void cascade(size_t level);
+  void advance(uint64_t now);
+  bool next_deadline(uint64_t* deadline) const;
+  void arm_timerfd(uint64_t now);
+  void on_fire();
+
+  Handler* handler_;
+  int fd_ = 0;
+  Reactor::Reactable* token_;
+  mutable std::mutex mutex_;
+  std::condition_variable dispatch_finished_;
+  // Last millisecond processed by the wheel
+  uint64_t current_ms_;
+  std::array<std::array<Bucket, kSlots>, kLevels> levels_;
+  std::array<size_t, kLevels> level_sizes_{};
+  // Timers beyond the range of the top level, re-inserted every time the top level wraps around
+  Bucket overflow_;
+  // Timers that expired but have not been dispatched yet
+  std::vector<Timer*> expired_;
+  Timer* dispatching_ = nullptr;
+  // Deadline the timerfd is currently armed for, UINT64_MAX if disarmed
+  uint64_t timerfd_deadline_ms_ = UINT64_MAX;
+};
+
+}  // namespace os
+}  // namespace bluetooth
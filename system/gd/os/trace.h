@@ -0,0 +1,86 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace bluetooth {
+namespace os {
+
+// The tracks of the trace events of the hot paths of the stack
+enum class TraceTrack : uint8_t {
+  HCI_COMMAND = 0,
+  HCI_EVENT,
+  ACL_TX,
+  ACL_RX,
+  L2CAP,
+  GATT,
+  A2DP,
+  LE_AUDIO,
+  STACK,
+};
+
+const char* TraceTrackText(TraceTrack track);
+
+// Trace events to correlate e.g. the audio glitches with the activity of the stack. On Android they are atrace events
+// of the bluetooth category, recorded by Perfetto and systrace. Elsewhere they are kept in a ring buffer in memory,
+// printed by dumpsys. The |name| of the events has to be a string literal, the ring buffer only keeps the pointer.
+
+// Begins a slice on the calling thread, ended by TraceEnd() from the same thread
+void TraceBegin(TraceTrack track, const char* name);
+void TraceEnd(TraceTrack track);
+// An event of |value| at this time, e.g. the opcode of a command
+void TraceInstant(TraceTrack track, const char* name, int64_t value);
+// The new |value| of the counter |name|, e.g. the depth of a queue
+void TraceCounter(TraceTrack track, const char* name, int64_t value);
+
+// Dumps the trace events kept in memory, if any
+void DumpTrace(int fd);
+
+class ScopedTrace {
+ public:
+  ScopedTrace(TraceTrack track, const char* name) : track_(track) {
+    TraceBegin(track, name);
+  }
+  ~ScopedTrace() {
+    TraceEnd(track_);
+  }
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  TraceTrack track_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
+
+// The trace events compile out of the builds which define BT_DISABLE_TRACE
+#ifndef BT_DISABLE_TRACE
+#define BT_TRACE_CONCAT_(a, b) a##b
+#define BT_TRACE_CONCAT(a, b) BT_TRACE_CONCAT_(a, b)
+#define BT_TRACE_SCOPE(track, name) \
+  ::bluetooth::os::ScopedTrace BT_TRACE_CONCAT(bt_trace_scope_, __LINE__)(::bluetooth::os::TraceTrack::track, name)
+#define BT_TRACE_INSTANT(track, name, value) \
+  ::bluetooth::os::TraceInstant(::bluetooth::os::TraceTrack::track, name, static_cast<int64_t>(value))
+#define BT_TRACE_COUNTER(track, name, value) \
+  ::bluetooth::os::TraceCounter(::bluetooth::os::TraceTrack::track, name, static_cast<int64_t>(value))
+#else
+#define BT_TRACE_SCOPE(track, name)
+#define BT_TRACE_INSTANT(track, name, value)
+#define BT_TRACE_COUNTER(track, name, value)
+#endif
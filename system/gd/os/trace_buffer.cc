@@ -0,0 +1,147 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/trace_buffer.h"
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+uint64_t NowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_BOOTTIME, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t ThreadId() {
+  static thread_local uint32_t thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+  return thread_id;
+}
+
+const char* TypeText(TraceBuffer::Type type) {
+  switch (type) {
+    case TraceBuffer::Type::BEGIN:
+      return "B";
+    case TraceBuffer::Type::END:
+      return "E";
+    case TraceBuffer::Type::INSTANT:
+      return "I";
+    case TraceBuffer::Type::COUNTER:
+      return "C";
+  }
+  return "?";
+}
+
+}  // namespace
+
+const char* TraceTrackText(TraceTrack track) {
+  switch (track) {
+    case TraceTrack::HCI_COMMAND:
+      return "HCI command";
+    case TraceTrack::HCI_EVENT:
+      return "HCI event";
+    case TraceTrack::ACL_TX:
+      return "ACL TX";
+    case TraceTrack::ACL_RX:
+      return "ACL RX";
+    case TraceTrack::L2CAP:
+      return "L2CAP";
+    case TraceTrack::GATT:
+      return "GATT";
+    case TraceTrack::A2DP:
+      return "A2DP";
+    case TraceTrack::LE_AUDIO:
+      return "LE Audio";
+    case TraceTrack::STACK:
+      return "Stack";
+  }
+  return "Unknown";
+}
+
+void TraceBuffer::Record(TraceTrack track, Type type, const char* name, int64_t value) {
+  uint64_t index = next_index_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[index % kNumEvents];
+  // Tell the dump that the slot is being overwritten before touching it
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestamp_us.store(NowUs(), std::memory_order_relaxed);
+  slot.info.store(
+      static_cast<uint64_t>(ThreadId()) << 32 | static_cast<uint64_t>(track) << 8 | static_cast<uint64_t>(type),
+      std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.value.store(value, std::memory_order_relaxed);
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+std::vector<TraceBuffer::Event> TraceBuffer::GetEvents() const {
+  std::vector<Event> events;
+  uint64_t end = next_index_.load(std::memory_order_acquire);
+  uint64_t begin = end > kNumEvents ? end - kNumEvents : 0;
+  events.reserve(end - begin);
+  for (uint64_t index = begin; index < end; index++) {
+    const Slot& slot = slots_[index % kNumEvents];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+      continue;
+    }
+    uint64_t info = slot.info.load(std::memory_order_relaxed);
+    Event event{
+        .timestamp_us = slot.timestamp_us.load(std::memory_order_relaxed),
+        .thread_id = static_cast<uint32_t>(info >> 32),
+        .track = static_cast<TraceTrack>((info >> 8) & 0xff),
+        .type = static_cast<Type>(info & 0xff),
+        .name = slot.name.load(std::memory_order_relaxed),
+        .value = slot.value.load(std::memory_order_relaxed),
+    };
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+      // Overwritten while it was read
+      continue;
+    }
+    events.push_back(event);
+  }
+  return events;
+}
+
+void TraceBuffer::Dump(int fd) const {
+  auto events = GetEvents();
+  dprintf(fd, "\nBluetooth trace events (last %zu):\n", events.size());
+  for (const auto& event : events) {
+    dprintf(
+        fd,
+        "  %" PRIu64 ".%06" PRIu64 " %6u %-11s %s %s",
+        event.timestamp_us / 1000000,
+        event.timestamp_us % 1000000,
+        event.thread_id,
+        TraceTrackText(event.track),
+        TypeText(event.type),
+        event.name != nullptr ? event.name : "");
+    if (event.type == Type::INSTANT || event.type == Type::COUNTER) {
+      dprintf(fd, " %" PRId64, event.value);
+    }
+    dprintf(fd, "\n");
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
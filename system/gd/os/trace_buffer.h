@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "os/trace.h"
+
+namespace bluetooth {
+namespace os {
+
+/**
+ * Ring buffer of the last trace events, for the platforms without a system tracer. Recording takes no lock, and an
+ * event overwritten while being dumped is skipped.
+ */
+class TraceBuffer {
+ public:
+  static constexpr size_t kNumEvents = 8192;
+
+  enum class Type : uint8_t {
+    BEGIN = 0,
+    END,
+    INSTANT,
+    COUNTER,
+  };
+
+  struct Event {
+    uint64_t timestamp_us;  // Since boot
+    uint32_t thread_id;
+    TraceTrack track;
+    Type type;
+    const char* name;
+    int64_t value;
+  };
+
+  void Record(TraceTrack track, Type type, const char* name, int64_t value);
+
+  // The events in the buffer, oldest first
+  std::vector<Event> GetEvents() const;
+
+  void Dump(int fd) const;
+
+ private:
+  struct Slot {
+    // Index of the event plus one once it is written, zero while it is
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> timestamp_us{0};
+    // Thread id, track and type
+    std::atomic<uint64_t> info{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> value{0};
+  };
+
+  std::atomic<uint64_t> next_index_{0};
+  std::array<Slot, kNumEvents> slots_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
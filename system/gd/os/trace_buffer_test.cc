@@ -0,0 +1,74 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/trace_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::os::TraceBuffer;
+using bluetooth::os::TraceTrack;
+
+TEST(TraceBufferTest, record_events_test) {
+  auto buffer = std::make_unique<TraceBuffer>();
+  buffer->Record(TraceTrack::HCI_EVENT, TraceBuffer::Type::BEGIN, "dispatch", 0);
+  buffer->Record(TraceTrack::HCI_COMMAND, TraceBuffer::Type::INSTANT, "command", 0x0c03);
+  buffer->Record(TraceTrack::HCI_EVENT, TraceBuffer::Type::END, nullptr, 0);
+
+  auto events = buffer->GetEvents();
+  ASSERT_EQ(events.size(), 3u);
+  ASSERT_EQ(events[0].type, TraceBuffer::Type::BEGIN);
+  ASSERT_STREQ(events[0].name, "dispatch");
+  ASSERT_EQ(events[1].track, TraceTrack::HCI_COMMAND);
+  ASSERT_EQ(events[1].value, 0x0c03);
+  ASSERT_EQ(events[2].type, TraceBuffer::Type::END);
+  ASSERT_LE(events[0].timestamp_us, events[2].timestamp_us);
+}
+
+TEST(TraceBufferTest, keeps_last_events_test) {
+  auto buffer = std::make_unique<TraceBuffer>();
+  for (size_t i = 0; i < TraceBuffer::kNumEvents + 10; i++) {
+    buffer->Record(TraceTrack::ACL_TX, TraceBuffer::Type::COUNTER, "queue", i);
+  }
+
+  auto events = buffer->GetEvents();
+  ASSERT_EQ(events.size(), TraceBuffer::kNumEvents);
+  ASSERT_EQ(events.front().value, 10);
+  ASSERT_EQ(events.back().value, static_cast<int64_t>(TraceBuffer::kNumEvents + 9));
+}
+
+TEST(TraceBufferTest, record_from_threads_test) {
+  auto buffer = std::make_unique<TraceBuffer>();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&buffer]() {
+      for (int j = 0; j < 1000; j++) {
+        buffer->Record(TraceTrack::ACL_RX, TraceBuffer::Type::INSTANT, "packet", j);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(buffer->GetEvents().size(), 4000u);
+}
+
+}  // namespace testing
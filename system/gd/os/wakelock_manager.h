@@ -58,15 +58,15 @@ class WakelockManager {
   // This method must be called before calling Acquire() or Release()
   void SetOsCallouts(OsCallouts* callouts, Handler* handler);
 
-  // Acquire the Bluetooth wakelock.
+  // Acquire the Bluetooth wakelock on behalf of |owner|, the wakelock time of each owner is dumped.
   // Return true on success, otherwise false.
   // The function is thread safe.
-  bool Acquire();
+  bool Acquire(const std::string& owner);
 
-  // Release the Bluetooth wakelock.
+  // Release the Bluetooth wakelock on behalf of |owner|.
   // Return true on success, otherwise false.
   // The function is thread safe.
-  bool Release();
+  bool Release(const std::string& owner);
 
   // Cleanup the wakelock internal runtime state.
   // This will NOT clean up the callouts
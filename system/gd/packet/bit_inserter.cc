@@ -44,5 +44,13 @@ void BitInserter::insert_byte(uint8_t byte) {
   insert_bits(byte, 8);
 }
 
+void BitInserter::insert_bytes(const uint8_t* data, size_t size) {
+  if (num_saved_bits_ != 0 || has_observers()) {
+    ByteInserter::insert_bytes(data, size);
+    return;
+  }
+  container->insert(container->end(), data, data + size);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
@@ -35,6 +35,9 @@ class BitInserter : public ByteInserter {
 
   void insert_byte(uint8_t byte) override;
 
+  // Appends the bytes at once when they are byte aligned and nobody observes them
+  void insert_bytes(const uint8_t* data, size_t size) override;
+
  protected:
   size_t num_saved_bits_{0};
   uint8_t saved_bits_{0};
@@ -78,5 +78,21 @@ TEST(BitInserterTest, observerTest) {
   ASSERT_EQ(result.size(), copy.size());
 }
 
+TEST(BitInserterTest, insertBytes) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  std::vector<uint8_t> data = {0x01, 0x02, 0x03};
+
+  it.insert_bytes(data.data(), data.size());
+  ASSERT_EQ(bytes, data);
+
+  // Bytes that aren't aligned are shifted in with the saved bits
+  it.insert_bits(0b1, 1);
+  it.insert_bytes(data.data(), data.size());
+  it.insert_bits(0b0, 7);
+  std::vector<uint8_t> result = {0x01, 0x02, 0x03, 0x03, 0x04, 0x06, 0x00};
+  ASSERT_EQ(bytes, result);
+}
+
 }  // namespace packet
 }  // namespace bluetooth
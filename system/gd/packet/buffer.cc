@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/buffer.h"
+
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace packet {
+
+namespace {
+
+// Capacities of the pooled buffers: small events and packets, full sized events, full sized ACL packets with their
+// header, receive buffers
+constexpr std::array<size_t, 4> kSizeClasses = {64, 2 + 255 + 7, 1024 + 8, Buffer::kMaxPooledCapacity};
+
+class BufferPool {
+ public:
+  // Index of the smallest size class fitting size, kSizeClasses.size() if none does
+  static size_t SizeClass(size_t size) {
+    size_t size_class = 0;
+    while (size_class < kSizeClasses.size() && kSizeClasses[size_class] < size) {
+      size_class++;
+    }
+    return size_class;
+  }
+
+  void* Take(size_t size_class) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& free_list = free_lists_[size_class];
+    if (free_list.empty()) {
+      return nullptr;
+    }
+    void* memory = free_list.back();
+    free_list.pop_back();
+    return memory;
+  }
+
+  // Returns false if the pool is full and memory should be freed instead
+  bool Give(size_t size_class, void* memory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& free_list = free_lists_[size_class];
+    if (free_list.size() >= Buffer::kMaxPooledBuffersPerClass) {
+      return false;
+    }
+    free_list.push_back(memory);
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::array<std::vector<void*>, kSizeClasses.size()> free_lists_;
+};
+
+BufferPool* GetPool() {
+  // Leaked on purpose, buffers may be released by static destructors
+  static auto* pool = new BufferPool();
+  return pool;
+}
+
+}  // namespace
+
+SharedBuffer Buffer::Create(size_t size) {
+  size_t size_class = BufferPool::SizeClass(size);
+  size_t capacity = size;
+  void* memory = nullptr;
+  if (size_class < kSizeClasses.size()) {
+    capacity = kSizeClasses[size_class];
+    memory = GetPool()->Take(size_class);
+  }
+  if (memory == nullptr) {
+    memory = ::operator new(sizeof(Buffer) + capacity);
+  }
+  return SharedBuffer(new (memory) Buffer(capacity, size));
+}
+
+SharedBuffer Buffer::Create(const uint8_t* data, size_t size) {
+  SharedBuffer buffer = Create(size);
+  if (size > 0) {
+    std::memcpy(buffer->data(), data, size);
+  }
+  return buffer;
+}
+
+void Buffer::Truncate(size_t size) {
+  ASSERT_LOG(size <= size_, "Can't grow a buffer from %zu to %zu bytes", size_, size);
+  size_ = size;
+}
+
+void Buffer::Release() {
+  if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  size_t capacity = capacity_;
+  size_t size_class = BufferPool::SizeClass(capacity);
+  this->~Buffer();
+  if (size_class < kSizeClasses.size() && kSizeClasses[size_class] == capacity && GetPool()->Give(size_class, this)) {
+    return;
+  }
+  ::operator delete(this);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace bluetooth {
+namespace packet {
+
+class SharedBuffer;
+
+// A reference counted byte buffer. The bookkeeping and the bytes share a single allocation, and buffers of up to
+// kMaxPooledCapacity bytes are recycled through a process-wide pool, so that steady state traffic doesn't go through
+// the allocator.
+//
+// A buffer is only written by its creator, and bytes that views refer to must not change afterwards.
+class Buffer {
+ public:
+  // Large enough for the receive buffers of stream transports, which hold several packets
+  static constexpr size_t kMaxPooledCapacity = 4096;
+  // Buffers kept around per size class once released
+  static constexpr size_t kMaxPooledBuffersPerClass = 64;
+
+  // Get a buffer holding size bytes of unspecified content
+  static SharedBuffer Create(size_t size);
+  // Get a buffer holding a copy of data
+  static SharedBuffer Create(const uint8_t* data, size_t size);
+
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
+  uint8_t* data() {
+    return reinterpret_cast<uint8_t*>(this + 1);
+  }
+  const uint8_t* data() const {
+    return reinterpret_cast<const uint8_t*>(this + 1);
+  }
+  const uint8_t* begin() const {
+    return data();
+  }
+  const uint8_t* end() const {
+    return data() + size_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  // Shrink the buffer, e.g. once it is known how much of it a read filled
+  void Truncate(size_t size);
+
+ private:
+  friend class SharedBuffer;
+
+  Buffer(size_t capacity, size_t size) : capacity_(capacity), size_(size) {}
+  ~Buffer() = default;
+
+  void Acquire() {
+    ref_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void Release();
+
+  std::atomic<uint32_t> ref_count_{1};
+  uint32_t capacity_;
+  size_t size_;
+};
+
+// Holds a reference on a Buffer, like a std::shared_ptr without the separate control block.
+class SharedBuffer {
+ public:
+  SharedBuffer() = default;
+  SharedBuffer(const SharedBuffer& other) : buffer_(other.buffer_) {
+    if (buffer_ != nullptr) {
+      buffer_->Acquire();
+    }
+  }
+  SharedBuffer(SharedBuffer&& other) noexcept : buffer_(other.buffer_) {
+    other.buffer_ = nullptr;
+  }
+  SharedBuffer& operator=(SharedBuffer other) noexcept {
+    std::swap(buffer_, other.buffer_);
+    return *this;
+  }
+  ~SharedBuffer() {
+    if (buffer_ != nullptr) {
+      buffer_->Release();
+    }
+  }
+
+  Buffer* get() const {
+    return buffer_;
+  }
+  Buffer* operator->() const {
+    return buffer_;
+  }
+  Buffer& operator*() const {
+    return *buffer_;
+  }
+  explicit operator bool() const {
+    return buffer_ != nullptr;
+  }
+
+  uint32_t use_count() const {
+    return buffer_ == nullptr ? 0 : buffer_->ref_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class Buffer;
+  explicit SharedBuffer(Buffer* buffer) : buffer_(buffer) {}
+
+  Buffer* buffer_ = nullptr;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
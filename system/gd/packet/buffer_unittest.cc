@@ -0,0 +1,96 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "packet/packet_view.h"
+
+using std::vector;
+
+namespace {
+vector<uint8_t> count = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+}  // namespace
+
+namespace bluetooth {
+namespace packet {
+
+TEST(BufferTest, create_copy) {
+  SharedBuffer buffer = Buffer::Create(count.data(), count.size());
+  ASSERT_EQ(buffer->size(), count.size());
+  ASSERT_GE(buffer->capacity(), count.size());
+  ASSERT_EQ(vector<uint8_t>(buffer->begin(), buffer->end()), count);
+}
+
+TEST(BufferTest, reference_counting) {
+  SharedBuffer buffer = Buffer::Create(10);
+  ASSERT_EQ(buffer.use_count(), 1u);
+  {
+    SharedBuffer copy = buffer;
+    ASSERT_EQ(buffer.use_count(), 2u);
+    SharedBuffer moved = std::move(copy);
+    ASSERT_FALSE(copy);
+    ASSERT_EQ(moved.get(), buffer.get());
+    ASSERT_EQ(buffer.use_count(), 2u);
+  }
+  ASSERT_EQ(buffer.use_count(), 1u);
+}
+
+TEST(BufferTest, released_buffers_are_reused) {
+  Buffer* first = Buffer::Create(100).get();
+  SharedBuffer second = Buffer::Create(100);
+  ASSERT_EQ(second.get(), first);
+}
+
+TEST(BufferTest, large_buffers_are_not_pooled) {
+  SharedBuffer buffer = Buffer::Create(Buffer::kMaxPooledCapacity + 1);
+  ASSERT_EQ(buffer->capacity(), Buffer::kMaxPooledCapacity + 1);
+}
+
+TEST(BufferTest, truncate) {
+  SharedBuffer buffer = Buffer::Create(count.data(), count.size());
+  buffer->Truncate(4);
+  ASSERT_EQ(buffer->size(), 4u);
+  ASSERT_EQ(vector<uint8_t>(buffer->begin(), buffer->end()), vector<uint8_t>(count.begin(), count.begin() + 4));
+  ASSERT_DEATH(buffer->Truncate(5), "");
+}
+
+TEST(BufferTest, views_hold_a_reference) {
+  SharedBuffer buffer = Buffer::Create(count.data(), count.size());
+  PacketView<kLittleEndian> packet(buffer);
+  ASSERT_EQ(buffer.use_count(), 2u);
+  {
+    PacketView<kLittleEndian> subview = packet.GetLittleEndianSubview(2, 6);
+    ASSERT_EQ(buffer.use_count(), 3u);
+    ASSERT_EQ(subview.size(), 4u);
+    ASSERT_EQ(subview[0], count[2]);
+    auto it = subview.begin();
+    ASSERT_EQ(it.extract<uint32_t>(), 0x05040302u);
+  }
+  ASSERT_EQ(buffer.use_count(), 2u);
+  buffer = SharedBuffer();
+  ASSERT_EQ(packet.size(), count.size());
+  ASSERT_EQ(packet[count.size() - 1], count.back());
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -33,6 +33,10 @@ class ByteInserter : public std::back_insert_iterator<std::vector<uint8_t>> {
 
   virtual void insert_byte(uint8_t byte);
 
+  // Insert size bytes from data. Inserters that can reference the bytes in place instead of copying them override
+  // this, in which case the bytes have to outlive the serialized packet.
+  virtual void insert_bytes(const uint8_t* data, size_t size);
+
   void RegisterObserver(const ByteObserver& observer);
 
   ByteObserver UnregisterObserver();
@@ -40,6 +44,10 @@ class ByteInserter : public std::back_insert_iterator<std::vector<uint8_t>> {
  protected:
   void on_byte(uint8_t);
 
+  bool has_observers() const {
+    return !registered_observers_.empty();
+  }
+
  private:
   std::vector<ByteObserver> registered_observers_;
 };
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "packet/view.h"
+
+namespace bluetooth {
+namespace packet {
+
+// The ordered fragments a PacketView is made of. Up to kInlineFragments fragments, which covers nearly every packet,
+// are stored in place, so that creating, copying and slicing a view doesn't allocate.
+class FragmentList {
+ public:
+  static constexpr size_t kInlineFragments = 2;
+
+  FragmentList() = default;
+  FragmentList(std::initializer_list<View> fragments) {
+    for (const auto& fragment : fragments) {
+      push_back(fragment);
+    }
+  }
+
+  void push_back(View fragment) {
+    if (size_ < kInlineFragments) {
+      inline_[size_++] = std::move(fragment);
+      return;
+    }
+    if (size_ == kInlineFragments) {
+      // Spill over: from now on all the fragments live in overflow_
+      overflow_.reserve(2 * kInlineFragments);
+      for (auto& inline_fragment : inline_) {
+        overflow_.push_back(std::move(inline_fragment));
+        inline_fragment = View();
+      }
+    }
+    overflow_.push_back(std::move(fragment));
+    size_++;
+  }
+
+  const View* begin() const {
+    return size_ > kInlineFragments ? overflow_.data() : inline_.data();
+  }
+  const View* end() const {
+    return begin() + size_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+
+ private:
+  std::array<View, kInlineFragments> inline_;
+  std::vector<View> overflow_;
+  size_t size_ = 0;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
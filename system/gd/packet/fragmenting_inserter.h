@@ -33,6 +33,9 @@ class FragmentingInserter : public BitInserter {
 
   void insert_bits(uint8_t byte, size_t num_bits) override;
 
+  // Every byte goes through insert_bits(), which splits them into fragments
+  void insert_bytes(const uint8_t* data, size_t size) override;
+
   void finalize();
 
  protected:
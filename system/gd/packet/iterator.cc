@@ -22,7 +22,7 @@ namespace bluetooth {
 namespace packet {
 
 template <bool little_endian>
-Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t offset) {
+Iterator<little_endian>::Iterator(const FragmentList& data, size_t offset) {
   data_ = data;
   index_ = offset;
   begin_ = 0;
@@ -130,7 +130,7 @@ uint8_t Iterator<little_endian>::operator*() const {
       end_);
   size_t index = index_;
 
-  for (auto view : data_) {
+  for (const auto& view : data_) {
     if (index < view.size()) {
       return view[index];
     }
@@ -17,11 +17,11 @@
 #pragma once
 
 #include <cstdint>
-#include <forward_list>
 #include <memory>
 #include <type_traits>
 
 #include "packet/custom_field_fixed_size_interface.h"
+#include "packet/fragment_list.h"
 #include "packet/view.h"
 
 namespace bluetooth {
@@ -45,7 +45,7 @@ struct IteratorTraits : public std::iterator<std::random_access_iterator_tag, ui
 template <bool little_endian>
 class Iterator : public IteratorTraits {
  public:
-  Iterator(const std::forward_list<View>& data, size_t offset);
+  Iterator(const FragmentList& data, size_t offset);
   Iterator(const Iterator& itr) = default;
   virtual ~Iterator() = default;
 
@@ -103,7 +103,7 @@ class Iterator : public IteratorTraits {
   }
 
  private:
-  std::forward_list<View> data_;
+  FragmentList data_;
   size_t index_;
   size_t begin_;
   size_t end_;
@@ -17,6 +17,7 @@
 #include "packet/packet_view.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "os/log.h"
 
@@ -24,9 +25,8 @@ namespace bluetooth {
 namespace packet {
 
 template <bool little_endian>
-PacketView<little_endian>::PacketView(const std::forward_list<class View> fragments)
-    : fragments_(fragments), length_(0) {
-  for (auto fragment : fragments_) {
+PacketView<little_endian>::PacketView(FragmentList fragments) : fragments_(std::move(fragments)), length_(0) {
+  for (const auto& fragment : fragments_) {
     length_ += fragment.size();
   }
 }
@@ -35,6 +35,11 @@ template <bool little_endian>
 PacketView<little_endian>::PacketView(std::shared_ptr<const std::vector<uint8_t>> packet)
     : fragments_({View(packet, 0, packet->size())}), length_(packet->size()) {}
 
+template <bool little_endian>
+PacketView<little_endian>::PacketView(SharedBuffer packet) : length_(packet->size()) {
+  fragments_.push_back(View(std::move(packet), 0, length_));
+}
+
 template <bool little_endian>
 Iterator<little_endian> PacketView<little_endian>::begin() const {
   return Iterator<little_endian>(this->fragments_, 0);
@@ -69,12 +74,21 @@ size_t PacketView<little_endian>::size() const {
 }
 
 template <bool little_endian>
-std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
+void PacketView<little_endian>::CopyTo(uint8_t* destination) const {
+  for (const auto& fragment : fragments_) {
+    if (fragment.size() > 0) {
+      std::memcpy(destination, fragment.data(), fragment.size());
+      destination += fragment.size();
+    }
+  }
+}
+
+template <bool little_endian>
+FragmentList PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
   ASSERT(begin <= end);
   ASSERT(end <= length_);
 
-  std::forward_list<View> view_list;
-  std::forward_list<View>::iterator it = view_list.before_begin();
+  FragmentList view_list;
   size_t length = end - begin;
   for (const auto& fragment : fragments_) {
     if (begin >= fragment.size()) {
@@ -82,8 +96,11 @@ std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin,
     } else {
       View view(fragment, begin, begin + std::min(length, fragment.size() - begin));
       length -= view.size();
-      it = view_list.insert_after(it, view);
+      view_list.push_back(std::move(view));
       begin = 0;
+      if (length == 0) {
+        break;
+      }
     }
   }
   return view_list;
@@ -101,18 +118,8 @@ PacketView<false> PacketView<little_endian>::GetBigEndianSubview(size_t begin, s
 
 template <bool little_endian>
 void PacketView<little_endian>::Append(PacketView to_add) {
-  auto insertion_point = fragments_.begin();
-  size_t remaining_length = length_;
-  while (remaining_length > 0) {
-    remaining_length -= insertion_point->size();
-    if (remaining_length > 0) {
-      insertion_point++;
-    }
-  }
-  ASSERT(insertion_point != fragments_.end());
   for (const auto& fragment : to_add.fragments_) {
-    fragments_.insert_after(insertion_point, fragment);
-    insertion_point++;
+    fragments_.push_back(fragment);
   }
   length_ += to_add.length_;
 }
@@ -17,8 +17,9 @@
 #pragma once
 
 #include <cstdint>
-#include <forward_list>
 
+#include "packet/buffer.h"
+#include "packet/fragment_list.h"
 #include "packet/iterator.h"
 #include "packet/view.h"
 
@@ -33,8 +34,9 @@ static const bool kLittleEndian = true;
 template <bool little_endian>
 class PacketView {
  public:
-  explicit PacketView(std::forward_list<View> fragments);
+  explicit PacketView(FragmentList fragments);
   explicit PacketView(std::shared_ptr<const std::vector<uint8_t>> packet);
+  explicit PacketView(SharedBuffer packet);
   PacketView(const PacketView& PacketView) = default;
   PacketView<little_endian>() = delete;
   virtual ~PacketView() = default;
@@ -47,6 +49,9 @@ class PacketView {
 
   size_t size() const;
 
+  // Copies the size() bytes of the packet to |destination|, a fragment at a time
+  void CopyTo(uint8_t* destination) const;
+
   PacketView<true> GetLittleEndianSubview(size_t begin, size_t end) const;
   PacketView<false> GetBigEndianSubview(size_t begin, size_t end) const;
 
@@ -54,10 +59,10 @@ class PacketView {
   void Append(PacketView to_add);
 
  private:
-  std::forward_list<View> fragments_;
+  FragmentList fragments_;
   size_t length_;
 
-  std::forward_list<View> GetSubviewList(size_t begin, size_t end) const;
+  FragmentList GetSubviewList(size_t begin, size_t end) const;
 };
 
 }  // namespace packet
@@ -552,6 +552,18 @@ TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST_F(PacketViewMultiViewTest, copyToTest) {
+  vector<uint8_t> copy(multi_view.size() + 1, 0xff);
+  multi_view.CopyTo(copy.data());
+  ASSERT_EQ(count_all, vector<uint8_t>(copy.begin(), copy.end() - 1));
+  ASSERT_EQ(0xff, copy.back());
+
+  auto subview = multi_view.GetLittleEndianSubview(count_1.size() - 1, count_1.size() + count_2.size() + 1);
+  vector<uint8_t> subview_copy(subview.size());
+  subview.CopyTo(subview_copy.data());
+  ASSERT_EQ(vector<uint8_t>(subview.begin(), subview.end()), subview_copy);
+}
+
 TEST_F(PacketViewMultiViewAppendTest, sizeTestAppend) {
   ASSERT_EQ(single_view.size(), multi_view.size());
 }
@@ -108,6 +108,16 @@ std::string VectorField::GetDataType() const {
 }
 
 void VectorField::GenExtractor(std::ostream& s, int num_leading_bits, bool for_struct) const {
+  std::string consume;
+  if (element_field_->BuilderParameterMustBeMoved()) {
+    consume = GetName() + "_ptr->push_back(std::move(" + element_field_->GetName() + "_ptr));";
+  } else {
+    consume = GetName() + "_ptr->push_back(" + element_field_->GetName() + "_value);";
+  }
+  GenElementLoop(s, num_leading_bits, for_struct, consume);
+}
+
+void VectorField::GenElementLoop(std::ostream& s, int num_leading_bits, bool for_struct, std::string consume) const {
   s << "auto " << element_field_->GetName() << "_it = " << GetName() << "_it;";
   if (size_field_ != nullptr && size_field_->GetFieldType() == CountField::kFieldType) {
     s << "size_t " << element_field_->GetName() << "_count = ";
@@ -135,11 +145,7 @@ void VectorField::GenExtractor(std::ostream& s, int num_leading_bits, bool for_s
   }
   element_field_->GenExtractor(s, num_leading_bits, for_struct);
   s << "if (" << element_field_->GetName() << "_ptr != nullptr) { ";
-  if (element_field_->BuilderParameterMustBeMoved()) {
-    s << GetName() << "_ptr->push_back(std::move(" << element_field_->GetName() << "_ptr));";
-  } else {
-    s << GetName() << "_ptr->push_back(" << element_field_->GetName() << "_value);";
-  }
+  s << consume;
   s << "}";
   s << "}";
 }
@@ -165,6 +171,23 @@ void VectorField::GenGetter(std::ostream& s, Size start_offset, Size end_offset)
   s << "}\n";
 }
 
+void VectorField::GenForEach(std::ostream& s, Size start_offset, Size end_offset) const {
+  s << "template <typename Visitor> void ForEach" << util::UnderscoreToCamelCase(GetName()) << "(Visitor&& visitor) {";
+  s << "ASSERT(was_validated_);";
+  s << "size_t end_index = size();";
+  s << "auto to_bound = begin();";
+
+  int num_leading_bits = GenBounds(s, start_offset, end_offset, GetSize());
+  std::string consume;
+  if (element_field_->BuilderParameterMustBeMoved()) {
+    consume = "visitor(std::move(" + element_field_->GetName() + "_ptr));";
+  } else {
+    consume = "visitor(" + element_field_->GetName() + "_value);";
+  }
+  GenElementLoop(s, num_leading_bits, false, consume);
+  s << "}\n";
+}
+
 std::string VectorField::GetBuilderParameterType() const {
   std::stringstream ss;
   if (element_field_->BuilderParameterMustBeMoved()) {
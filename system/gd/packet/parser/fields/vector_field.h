@@ -43,6 +43,9 @@ class VectorField : public PacketField {
 
   virtual std::string GetGetterFunctionName() const override;
 
+  // Calls visitor with each element in place, without building the vector returned by the getter
+  void GenForEach(std::ostream& s, Size start_offset, Size end_offset) const;
+
   virtual void GenGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
 
   virtual std::string GetBuilderParameterType() const override;
@@ -88,4 +91,8 @@ class VectorField : public PacketField {
 
   // Size modifier is only used when size_field_ is of type SIZE and is not used with COUNT.
   std::string size_modifier_{""};
+
+ private:
+  // Extracts the elements one at a time, consume is the statement using each of them
+  void GenElementLoop(std::ostream& s, int num_leading_bits, bool for_struct, std::string consume) const;
 };
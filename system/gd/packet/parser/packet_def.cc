@@ -76,7 +76,10 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    // A validated parent validated all the levels above this one, they are not validated again
+    s << " : " << parent_->name_ << "View(std::move(parent)) {";
+    s << "if (was_validated_) { validated_levels_ = " << GetValidationLevel() - 1 << "; }";
+    s << "was_validated_ = false; }";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian> packet) ";
     s << " : PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian>(packet) { was_validated_ = false;}";
@@ -164,6 +167,18 @@ void PacketDef::GenParserFieldGetter(std::ostream& s, const PacketField* field)
   }
 
   field->GenGetter(s, start_field_offset, end_field_offset);
+  if (field->GetFieldType() == VectorField::kFieldType) {
+    s << "\n";
+    static_cast<const VectorField*>(field)->GenForEach(s, start_field_offset, end_field_offset);
+  }
+}
+
+size_t PacketDef::GetValidationLevel() const {
+  size_t level = 1;
+  for (auto ancestor = parent_; ancestor != nullptr; ancestor = ancestor->parent_) {
+    level++;
+  }
+  return level;
 }
 
 TypeDef::Type PacketDef::GetDefinitionType() const {
@@ -197,8 +212,14 @@ void PacketDef::GenValidator(std::ostream& s) const {
   s << "protected:" << std::endl;
   if (parent_ == nullptr) {
     s << "virtual bool Validate() const {" << std::endl;
+    s << "  if (validated_levels_ >= 1) {" << std::endl;
+    s << "    return true;" << std::endl;
+    s << "  }" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
+    s << "  if (validated_levels_ >= " << GetValidationLevel() << ") {" << std::endl;
+    s << "    return true;" << std::endl;
+    s << "  }" << std::endl;
     s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
@@ -330,6 +351,8 @@ void PacketDef::GenValidator(std::ostream& s) const {
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    s << "// Number of levels of the hierarchy, from the root, validated by the view this one was created from\n";
+    s << "uint8_t validated_levels_{0};\n";
   }
 }
 
@@ -362,6 +385,27 @@ void PacketDef::GenParserToString(std::ostream& s) const {
   s << "}\n";
 }
 
+Size PacketDef::GetStaticSize() const {
+  if (fields_.HasPayloadOrBody()) {
+    return Size();
+  }
+  for (const ParentDef* def = this; def != nullptr; def = def->parent_) {
+    for (const auto& field : def->fields_) {
+      if (field->GetFieldType() == PayloadField::kFieldType || field->GetFieldType() == BodyField::kFieldType) {
+        continue;
+      }
+      if (field->GetSize().empty() || field->GetSize().has_dynamic()) {
+        return Size();
+      }
+    }
+  }
+  auto size = GetSize(true);
+  if (size.has_dynamic() || size.bits() % 8 != 0) {
+    return Size();
+  }
+  return size;
+}
+
 void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const {
   s << "class " << name_ << "Builder";
   if (parent_ != nullptr) {
@@ -381,6 +425,12 @@ void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, boo
     GenBuilderCreate(s);
     s << "\n";
 
+    auto static_size = GetStaticSize();
+    if (!static_size.empty()) {
+      // Lets the callers size their buffers at compile time
+      s << "static constexpr size_t kSize = " << static_size.bytes() << ";\n";
+    }
+
     if (generate_fuzzing || generate_tests) {
       GenTestingFromView(s);
       s << "\n";
@@ -41,10 +41,16 @@ class PacketDef : public ParentDef {
 
   void GenValidator(std::ostream& s) const;
 
+  // Depth of the packet in its hierarchy, 1 for a packet without parent
+  size_t GetValidationLevel() const;
+
   void GenParserToString(std::ostream& s) const;
 
   TypeDef::Type GetDefinitionType() const;
 
+  // Size of the serialized packet when it is known at compile time, an empty Size otherwise
+  Size GetStaticSize() const;
+
   void GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
 
   void GenBuilderDefinitionPybind11(std::ostream& s) const;
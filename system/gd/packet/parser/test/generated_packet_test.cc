@@ -126,6 +126,13 @@ TEST(GeneratedPacketTest, testChild) {
   ASSERT_EQ(field_name, child_view.GetFieldName());
 }
 
+TEST(GeneratedPacketTest, testChildStaticSize) {
+  static_assert(ChildBuilder::kSize == 5, "fixed, size, field_name and footer");
+  auto packet = ChildBuilder::Create(0xa2a1, 0xb1);
+  ASSERT_EQ(ChildBuilder::kSize, packet->size());
+  ASSERT_EQ(ChildBuilder::kSize, packet->SerializeToBytes().size());
+}
+
 TEST(GeneratedPacketTest, testValidateWayTooSmall) {
   std::vector<uint8_t> too_small_bytes = {0x34};
   auto too_small = std::make_shared<std::vector<uint8_t>>(too_small_bytes.begin(), too_small_bytes.end());
@@ -217,6 +224,22 @@ TEST(GeneratedPacketTest, testValidatedParentDeath) {
   ASSERT_DEATH(child_view.GetFieldName(), "validated");
 }
 
+TEST(GeneratedPacketTest, testValidatedParentNotValidatedAgain) {
+  auto packet = ChildBuilder::Create(0xa2a1, 0xb1);
+  std::shared_ptr<std::vector<uint8_t>> packet_bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter it(*packet_bytes);
+  packet->Serialize(it);
+
+  PacketView<kLittleEndian> packet_bytes_view(packet_bytes);
+  ParentView parent_view = ParentView::Create(packet_bytes_view);
+  ASSERT_TRUE(parent_view.IsValid());
+
+  // Break the fixed field of the parent, only the views created from a parent not validated yet see it
+  packet_bytes->at(0) = 0x34;
+  ASSERT_TRUE(ChildView::Create(parent_view).IsValid());
+  ASSERT_FALSE(ChildView::Create(ParentView::Create(packet_bytes_view)).IsValid());
+}
+
 vector<uint8_t> middle_four_bits = {
     0x95,  // low_two = ONE, next_four = FIVE, straddle = TEN
     0x8a,  // straddle = TEN, four_more = TWO, high_two = TWO
@@ -993,6 +1016,15 @@ TEST(GeneratedPacketTest, testVectorOfStruct) {
     ASSERT_EQ(array[i].id_, copy_array[i].id_);
     ASSERT_EQ(array[i].count_, copy_array[i].count_);
   }
+
+  size_t visited = 0;
+  view.ForEachArray([&copy_array, &visited](const TwoRelatedNumbers& element) {
+    ASSERT_LT(visited, copy_array.size());
+    ASSERT_EQ(element.id_, copy_array[visited].id_);
+    ASSERT_EQ(element.count_, copy_array[visited].count_);
+    visited++;
+  });
+  ASSERT_EQ(copy_array.size(), visited);
 }
 
 TEST(GeneratedPacketTest, testArrayOfStruct) {
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/scatter_gather_inserter.h"
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace packet {
+
+ScatterGatherInserter::ScatterGatherInserter(std::vector<uint8_t>& headers) : BitInserter(headers), headers_(headers) {}
+
+void ScatterGatherInserter::insert_bytes(const uint8_t* data, size_t size) {
+  // Observers (e.g. FCS computation) need to see every byte, and a payload that isn't byte aligned has to be shifted
+  if (size < kMinReferencedSize || num_saved_bits_ != 0 || has_observers()) {
+    BitInserter::insert_bytes(data, size);
+    return;
+  }
+  if (headers_.size() > headers_begin_) {
+    segments_.push_back({nullptr, headers_begin_, headers_.size() - headers_begin_});
+    headers_begin_ = headers_.size();
+  }
+  segments_.push_back({data, 0, size});
+}
+
+std::vector<struct iovec> ScatterGatherInserter::GetIovecs() const {
+  ASSERT_LOG(num_saved_bits_ == 0, "Packet isn't byte aligned");
+  std::vector<struct iovec> iovecs;
+  iovecs.reserve(segments_.size() + 1);
+  for (const auto& segment : segments_) {
+    const uint8_t* data = segment.data != nullptr ? segment.data : headers_.data() + segment.offset;
+    iovecs.push_back({const_cast<uint8_t*>(data), segment.size});
+  }
+  if (headers_.size() > headers_begin_) {
+    iovecs.push_back({headers_.data() + headers_begin_, headers_.size() - headers_begin_});
+  }
+  return iovecs;
+}
+
+size_t ScatterGatherInserter::size() const {
+  size_t size = headers_.size();
+  for (const auto& segment : segments_) {
+    if (segment.data != nullptr) {
+      size += segment.size;
+    }
+  }
+  return size;
+}
+
+}  // namespace packet
+}  // namespace bluetooth
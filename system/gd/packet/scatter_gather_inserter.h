@@ -0,0 +1,66 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Serializes a packet for scatter-gather I/O. Headers and other fields are written to the given vector, while payloads
+// of at least kMinReferencedSize bytes (e.g. those of RawBuilders) are referenced in place instead of being copied.
+// Whatever the vector already holds, such as a transport header, is part of the serialized packet.
+//
+// The segments returned by GetIovecs() are only valid while the serialized builder is alive and the vector is left
+// untouched.
+class ScatterGatherInserter : public BitInserter {
+ public:
+  // Smaller payloads are cheaper to copy than to give their own segment
+  static constexpr size_t kMinReferencedSize = 64;
+
+  explicit ScatterGatherInserter(std::vector<uint8_t>& headers);
+  ~ScatterGatherInserter() = default;
+
+  void insert_bytes(const uint8_t* data, size_t size) override;
+
+  // The serialized packet, in order
+  std::vector<struct iovec> GetIovecs() const;
+
+  // Total size of the serialized packet
+  size_t size() const;
+
+ private:
+  struct Segment {
+    // Referenced bytes, or nullptr for bytes of headers_ starting at offset
+    const uint8_t* data;
+    size_t offset;
+    size_t size;
+  };
+
+  std::vector<uint8_t>& headers_;
+  // Where the bytes of headers_ not covered by segments_ yet begin
+  size_t headers_begin_{0};
+  std::vector<Segment> segments_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/scatter_gather_inserter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packet/packet_builder.h"
+#include "packet/raw_builder.h"
+
+using std::vector;
+
+namespace bluetooth {
+namespace packet {
+namespace {
+
+// A header and a trailer around a payload, like an L2CAP basic frame with an FCS
+class FrameBuilder : public PacketBuilder<true> {
+ public:
+  FrameBuilder(uint16_t header, std::unique_ptr<BasePacketBuilder> payload, uint16_t trailer)
+      : header_(header), payload_(std::move(payload)), trailer_(trailer) {}
+
+  size_t size() const override {
+    return sizeof(header_) + payload_->size() + sizeof(trailer_);
+  }
+
+  void Serialize(BitInserter& it) const override {
+    insert(header_, it);
+    payload_->Serialize(it);
+    insert(trailer_, it);
+  }
+
+ private:
+  uint16_t header_;
+  std::unique_ptr<BasePacketBuilder> payload_;
+  uint16_t trailer_;
+};
+
+vector<uint8_t> payload_of_size(size_t size) {
+  vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; i++) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+  return payload;
+}
+
+vector<uint8_t> flatten(const vector<struct iovec>& iovecs) {
+  vector<uint8_t> bytes;
+  for (const auto& iov : iovecs) {
+    auto* data = static_cast<const uint8_t*>(iov.iov_base);
+    bytes.insert(bytes.end(), data, data + iov.iov_len);
+  }
+  return bytes;
+}
+
+std::unique_ptr<FrameBuilder> nested_frames(size_t payload_size) {
+  auto inner = std::make_unique<FrameBuilder>(
+      0x0201, std::make_unique<RawBuilder>(payload_of_size(payload_size)), 0x0403);
+  return std::make_unique<FrameBuilder>(0x0605, std::move(inner), 0x0807);
+}
+
+TEST(ScatterGatherInserterTest, payload_is_referenced) {
+  auto builder = nested_frames(300);
+  vector<uint8_t> headers = {0x02};
+  ScatterGatherInserter it(headers);
+  builder->Serialize(it);
+  auto iovecs = it.GetIovecs();
+
+  // Transport and both headers, the payload, then both trailers
+  ASSERT_EQ(iovecs.size(), 3u);
+  ASSERT_EQ(iovecs[0].iov_len, 5u);
+  ASSERT_EQ(iovecs[1].iov_len, 300u);
+  ASSERT_EQ(iovecs[2].iov_len, 4u);
+  ASSERT_EQ(headers.size(), 9u);
+  ASSERT_EQ(it.size(), 1 + builder->size());
+
+  vector<uint8_t> expected = {0x02};
+  auto serialized = builder->SerializeToBytes();
+  expected.insert(expected.end(), serialized.begin(), serialized.end());
+  ASSERT_EQ(flatten(iovecs), expected);
+}
+
+TEST(ScatterGatherInserterTest, small_payload_is_copied) {
+  auto builder = nested_frames(ScatterGatherInserter::kMinReferencedSize - 1);
+  vector<uint8_t> headers;
+  ScatterGatherInserter it(headers);
+  builder->Serialize(it);
+  auto iovecs = it.GetIovecs();
+  ASSERT_EQ(iovecs.size(), 1u);
+  ASSERT_EQ(flatten(iovecs), builder->SerializeToBytes());
+}
+
+TEST(ScatterGatherInserterTest, observed_payload_is_copied) {
+  auto builder = nested_frames(300);
+  vector<uint8_t> headers;
+  ScatterGatherInserter it(headers);
+  size_t observed = 0;
+  it.RegisterObserver(ByteObserver([&observed](uint8_t) { observed++; }, []() { return 0; }));
+  builder->Serialize(it);
+  it.UnregisterObserver();
+  ASSERT_EQ(observed, builder->size());
+  auto iovecs = it.GetIovecs();
+  ASSERT_EQ(iovecs.size(), 1u);
+  ASSERT_EQ(flatten(iovecs), builder->SerializeToBytes());
+}
+
+TEST(ScatterGatherInserterTest, empty) {
+  vector<uint8_t> headers;
+  ScatterGatherInserter it(headers);
+  ASSERT_TRUE(it.GetIovecs().empty());
+  ASSERT_EQ(it.size(), 0u);
+}
+
+}  // namespace
+}  // namespace packet
+}  // namespace bluetooth
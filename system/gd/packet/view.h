@@ -20,25 +20,38 @@
 #include <memory>
 #include <vector>
 
+#include "packet/buffer.h"
+
 namespace bluetooth {
 namespace packet {
 
 // Base class that holds a shared pointer to data with bounds.
 class View {
  public:
+  // An empty view
+  View() = default;
   View(std::shared_ptr<const std::vector<uint8_t>> data, size_t begin, size_t end);
+  View(SharedBuffer data, size_t begin, size_t end);
   View(const View& view, size_t begin, size_t end);
   View(const View& view) = default;
+  View(View&& view) = default;
+  View& operator=(const View& view) = default;
+  View& operator=(View&& view) = default;
   virtual ~View() = default;
 
   uint8_t operator[](size_t i) const;
 
   size_t size() const;
 
+  // The bytes of the view, which are contiguous
+  const uint8_t* data() const;
+
  private:
+  // Only one of the two holds the data
   std::shared_ptr<const std::vector<uint8_t>> data_;
-  size_t begin_;
-  size_t end_;
+  SharedBuffer buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
 };
 
 }  // namespace packet
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/view_builder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace packet {
+
+ViewBuilder::ViewBuilder(View view) : view_(std::move(view)) {}
+
+size_t ViewBuilder::size() const {
+  return view_.size();
+}
+
+void ViewBuilder::Serialize(BitInserter& it) const {
+  it.insert_bytes(view_.data(), view_.size());
+}
+
+std::vector<std::unique_ptr<ViewBuilder>> ViewBuilder::Fragment(const BasePacketBuilder& packet, size_t max_size) {
+  ASSERT(max_size > 0);
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet.size());
+  BitInserter it(*bytes);
+  packet.Serialize(it);
+  std::shared_ptr<const std::vector<uint8_t>> serialized = std::move(bytes);
+
+  std::vector<std::unique_ptr<ViewBuilder>> fragments;
+  fragments.reserve((serialized->size() + max_size - 1) / max_size);
+  for (size_t begin = 0; begin < serialized->size(); begin += max_size) {
+    size_t end = std::min(begin + max_size, serialized->size());
+    fragments.push_back(std::make_unique<ViewBuilder>(View(serialized, begin, end)));
+  }
+  return fragments;
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/packet_builder.h"
+#include "packet/view.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Serializes the bytes of a View, e.g. a fragment of a larger packet serialized beforehand. The bytes are shared with
+// the view rather than copied into the builder.
+class ViewBuilder : public PacketBuilder<true> {
+ public:
+  explicit ViewBuilder(View view);
+  virtual ~ViewBuilder() = default;
+
+  virtual size_t size() const override;
+
+  virtual void Serialize(BitInserter& it) const override;
+
+  // Serializes the packet once and splits it into builders of at most max_size bytes, all sharing the serialized
+  // bytes. A copy of one of them shares the bytes too.
+  static std::vector<std::unique_ptr<ViewBuilder>> Fragment(const BasePacketBuilder& packet, size_t max_size);
+
+ private:
+  View view_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/view_builder.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace packet {
+namespace {
+
+std::vector<uint8_t> serialize(const BasePacketBuilder& builder) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  builder.Serialize(it);
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ViewBuilderTest, fragmentTest) {
+  RawBuilder packet(std::vector<uint8_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  auto fragments = ViewBuilder::Fragment(packet, 4);
+  ASSERT_EQ(3u, fragments.size());
+  ASSERT_EQ(std::vector<uint8_t>({0, 1, 2, 3}), serialize(*fragments[0]));
+  ASSERT_EQ(std::vector<uint8_t>({4, 5, 6, 7}), serialize(*fragments[1]));
+  ASSERT_EQ(std::vector<uint8_t>({8, 9}), serialize(*fragments[2]));
+
+  // Copies serialize the same bytes
+  ViewBuilder copy = *fragments[1];
+  fragments.clear();
+  ASSERT_EQ(4u, copy.size());
+  ASSERT_EQ(std::vector<uint8_t>({4, 5, 6, 7}), serialize(copy));
+}
+
+TEST(ViewBuilderTest, fragmentEmptyTest) {
+  RawBuilder packet;
+  ASSERT_TRUE(ViewBuilder::Fragment(packet, 4).empty());
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -53,10 +53,9 @@ namespace security {
 
 std::pair<std::array<uint8_t, 32>, EcdhPublicKey> GenerateECDHKeyPair() {
   std::array<uint8_t, 32> private_key = GenerateRandom<32>();
-  std::array<uint8_t, 32> private_key_copy = private_key;
   ecc::Point public_key;
 
-  ECC_PointMult(&public_key, &(ecc::curve_p256.G), (uint32_t*)private_key_copy.data());
+  ECC_PointMult_Base(&public_key, (const uint32_t*)private_key.data());
 
   EcdhPublicKey pk;
   memcpy(pk.x.data(), public_key.x, 32);
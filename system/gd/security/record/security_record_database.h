@@ -17,7 +17,9 @@
 #pragma once
 
 #include <set>
+#include <unordered_map>
 
+#include "common/flat_lru_cache.h"
 #include "hci/address_with_type.h"
 #include "security/record/security_record.h"
 #include "security/record/security_record_storage.h"
@@ -41,6 +43,7 @@ class SecurityRecordDatabase {
     // No security record, create one
     auto record_ptr = std::make_shared<SecurityRecord>(address);
     records_.insert(record_ptr);
+    address_index_[address] = record_ptr;
     return record_ptr;
   }
 
@@ -50,16 +53,25 @@ class SecurityRecordDatabase {
     // No record exists
     if (it == records_.end()) return;
 
+    RemoveFromIndex(*it);
     records_.erase(it);
     security_record_storage_.RemoveDevice(address);
   }
 
   iterator Find(hci::AddressWithType address) {
+    auto indexed = FindIndexed(address);
+    if (indexed != nullptr) return records_.find(*indexed);
+
     for (auto it = records_.begin(); it != records_.end(); ++it) {
       std::shared_ptr<SecurityRecord> record = *it;
-      if (record->identity_address_.has_value() && record->identity_address_.value() == address) return it;
-      if (record->GetPseudoAddress() == address) return it;
-      if (record->remote_irk.has_value() && address.IsRpaThatMatchesIrk(record->remote_irk.value())) return it;
+      if (IsRecordAddress(*record, address)) {
+        address_index_[address] = record;
+        return it;
+      }
+      if (IsResolvedRecordAddress(*record, address)) {
+        resolved_rpa_index_.insert_or_assign(address, ResolvedRpa{record, record->remote_irk.value()});
+        return it;
+      }
     }
     return records_.end();
   }
@@ -74,6 +86,55 @@ class SecurityRecordDatabase {
 
   std::set<std::shared_ptr<SecurityRecord>> records_;
   record::SecurityRecordStorage security_record_storage_;
+
+ private:
+  // Resolved RPAs kept in the index, the RPAs of a peer change every few minutes
+  static constexpr size_t kResolvedRpaIndexSize = 64;
+
+  static bool IsRecordAddress(const SecurityRecord& record, const hci::AddressWithType& address) {
+    if (record.identity_address_.has_value() && record.identity_address_.value() == address) return true;
+    return record.pseudo_address_ == address;
+  }
+
+  static bool IsResolvedRecordAddress(const SecurityRecord& record, const hci::AddressWithType& address) {
+    return record.remote_irk.has_value() && address.IsRpaThatMatchesIrk(record.remote_irk.value());
+  }
+
+  // The addresses and keys of a record are updated in place while pairing, an indexed record is checked against the
+  // address before being returned. A resolved RPA is checked against the IRK that resolved it rather than with AES.
+  const std::shared_ptr<SecurityRecord>* FindIndexed(const hci::AddressWithType& address) {
+    auto indexed = address_index_.find(address);
+    if (indexed != address_index_.end()) {
+      if (IsRecordAddress(*indexed->second, address)) return &indexed->second;
+      address_index_.erase(indexed);
+    }
+
+    auto resolved = resolved_rpa_index_.find(address);
+    if (resolved != resolved_rpa_index_.end()) {
+      auto& record = resolved->second.record;
+      if (record->remote_irk.has_value() && record->remote_irk.value() == resolved->second.irk) return &record;
+      resolved_rpa_index_.erase(resolved);
+    }
+    return nullptr;
+  }
+
+  void RemoveFromIndex(const std::shared_ptr<SecurityRecord>& record) {
+    for (auto it = address_index_.begin(); it != address_index_.end();) {
+      it = (it->second == record) ? address_index_.erase(it) : std::next(it);
+    }
+    for (auto it = resolved_rpa_index_.begin(); it != resolved_rpa_index_.end();) {
+      it = (it->second.record == record) ? resolved_rpa_index_.erase(it) : std::next(it);
+    }
+  }
+
+  struct ResolvedRpa {
+    std::shared_ptr<SecurityRecord> record;
+    crypto_toolbox::Octet16 irk;
+  };
+
+  // Identity and pseudo addresses of the records
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> address_index_;
+  common::FlatLruCache<hci::AddressWithType, ResolvedRpa> resolved_rpa_index_{kResolvedRpaIndexSize};
 };
 
 }  // namespace record
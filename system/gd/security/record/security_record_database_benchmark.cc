@@ -0,0 +1,107 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "security/record/security_record_database.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace security {
+namespace record {
+
+namespace {
+crypto_toolbox::Octet16 MakeIrk(uint8_t seed) {
+  crypto_toolbox::Octet16 irk;
+  for (size_t i = 0; i < irk.size(); i++) {
+    irk[i] = static_cast<uint8_t>(i * 151 + seed);
+  }
+  return irk;
+}
+
+hci::AddressWithType MakeRpa(const crypto_toolbox::Octet16& irk) {
+  hci::Address address;
+  address.address[3] = 0x12;
+  address.address[4] = 0x34;
+  address.address[5] = 0x56;
+  crypto_toolbox::Octet16 hash = crypto_toolbox::aes_128(irk, &address.address[3], 3);
+  std::copy_n(hash.begin(), 3, address.address.begin());
+  return hci::AddressWithType(address, hci::AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+// Devices connected at the same time
+constexpr size_t kConnectedDevices = 4;
+
+// Bonded LE devices with an identity address and an IRK each, the last ones are connected
+class BondedDevices {
+ public:
+  explicit BondedDevices(int count) {
+    for (int i = 0; i < count; i++) {
+      hci::Address address({0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)});
+      auto record =
+          database_.FindOrCreate(hci::AddressWithType(address, hci::AddressType::PUBLIC_DEVICE_ADDRESS));
+      record->identity_address_ = record->pseudo_address_;
+      record->remote_irk = MakeIrk(i);
+      if (count - i <= static_cast<int>(kConnectedDevices)) {
+        identity_addresses_.push_back(*record->identity_address_);
+        rpas_.push_back(MakeRpa(*record->remote_irk));
+      }
+    }
+  }
+
+  // The lookups do not touch the storage
+  SecurityRecordDatabase database_{SecurityRecordStorage(nullptr, nullptr)};
+  std::vector<hci::AddressWithType> identity_addresses_;
+  std::vector<hci::AddressWithType> rpas_;
+};
+}  // namespace
+
+// The lookups of an encryption change or a link key request from the connected devices, with range(0) bonded devices
+static void BM_FindByIdentityAddress(State& state) {
+  BondedDevices devices(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    auto& address = devices.identity_addresses_[i++ % devices.identity_addresses_.size()];
+    // Each handler looks the record up a few times
+    for (int lookup = 0; lookup < 3; lookup++) {
+      ::benchmark::DoNotOptimize(devices.database_.FindOrCreate(address));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK(BM_FindByIdentityAddress)->Arg(1)->Arg(16)->Arg(100);
+
+// The same lookups for devices connected with a resolvable private address
+static void BM_FindByResolvablePrivateAddress(State& state) {
+  BondedDevices devices(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    auto& address = devices.rpas_[i++ % devices.rpas_.size()];
+    for (int lookup = 0; lookup < 3; lookup++) {
+      ::benchmark::DoNotOptimize(devices.database_.FindOrCreate(address));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 3);
+}
+BENCHMARK(BM_FindByResolvablePrivateAddress)->Arg(1)->Arg(16)->Arg(100);
+
+}  // namespace record
+}  // namespace security
+}  // namespace bluetooth
@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2023 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+#include "security/record/security_record_database.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace security {
+namespace record {
+namespace {
+
+const hci::AddressWithType kPseudoAddress(
+    hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}), hci::AddressType::RANDOM_DEVICE_ADDRESS);
+const hci::AddressWithType kIdentityAddress(
+    hci::Address({0x11, 0x12, 0x13, 0x14, 0x15, 0x16}), hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+const crypto_toolbox::Octet16 kIrk = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+
+hci::AddressWithType MakeRpa(const crypto_toolbox::Octet16& irk, uint8_t seed) {
+  hci::Address address;
+  address.address[3] = seed;
+  address.address[4] = seed + 1;
+  address.address[5] = 0x40 | (seed & 0x3f);
+  crypto_toolbox::Octet16 hash = crypto_toolbox::aes_128(irk, &address.address[3], 3);
+  std::copy_n(hash.begin(), 3, address.address.begin());
+  return hci::AddressWithType(address, hci::AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+class SecurityRecordDatabaseTest : public ::testing::Test {
+ protected:
+  // The lookups do not touch the storage
+  SecurityRecordDatabase database_{SecurityRecordStorage(nullptr, nullptr)};
+};
+
+TEST_F(SecurityRecordDatabaseTest, find_by_pseudo_and_identity_address) {
+  EXPECT_EQ(database_.Find(kPseudoAddress), database_.records_.end());
+
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  EXPECT_EQ(database_.FindOrCreate(kPseudoAddress), record);
+  EXPECT_EQ(database_.Find(kIdentityAddress), database_.records_.end());
+
+  record->identity_address_ = kIdentityAddress;
+  EXPECT_EQ(*database_.Find(kIdentityAddress), record);
+  EXPECT_EQ(*database_.Find(kPseudoAddress), record);
+  EXPECT_EQ(database_.records_.size(), 1u);
+}
+
+TEST_F(SecurityRecordDatabaseTest, updated_identity_address_is_not_found) {
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  record->identity_address_ = kIdentityAddress;
+  ASSERT_EQ(*database_.Find(kIdentityAddress), record);
+
+  record->identity_address_ = kPseudoAddress;
+  EXPECT_EQ(database_.Find(kIdentityAddress), database_.records_.end());
+  EXPECT_NE(database_.FindOrCreate(kIdentityAddress), record);
+  EXPECT_EQ(database_.records_.size(), 2u);
+}
+
+TEST_F(SecurityRecordDatabaseTest, find_by_resolvable_private_address) {
+  auto other = database_.FindOrCreate(kIdentityAddress);
+  other->remote_irk = crypto_toolbox::Octet16{};
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  record->remote_irk = kIrk;
+
+  auto rpa = MakeRpa(kIrk, 7);
+  ASSERT_TRUE(rpa.IsRpaThatMatchesIrk(kIrk));
+  EXPECT_EQ(*database_.Find(rpa), record);
+  EXPECT_EQ(*database_.Find(rpa), record);
+  EXPECT_EQ(*database_.Find(MakeRpa(kIrk, 8)), record);
+
+  // A new IRK after a new bond does not resolve the previous RPAs
+  record->remote_irk->at(0) ^= 0xff;
+  EXPECT_EQ(database_.Find(rpa), database_.records_.end());
+  EXPECT_EQ(*database_.Find(MakeRpa(*record->remote_irk, 7)), record);
+}
+
+TEST_F(SecurityRecordDatabaseTest, many_resolvable_private_addresses) {
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  record->remote_irk = kIrk;
+
+  // More RPAs than the index holds are all resolved
+  for (int i = 0; i < 200; i++) {
+    EXPECT_EQ(*database_.Find(MakeRpa(kIrk, i)), record) << "seed " << i;
+  }
+  for (int i = 0; i < 200; i++) {
+    EXPECT_EQ(*database_.Find(MakeRpa(kIrk, i)), record) << "seed " << i;
+  }
+}
+
+}  // namespace
+}  // namespace record
+}  // namespace security
+}  // namespace bluetooth
@@ -18,12 +18,16 @@
 #include "dumpsys/dumpsys.h"
 
 #include <future>
+#include <memory>
 #include <string>
 
+#include "common/bind.h"
 #include "dumpsys/filter.h"
 #include "module.h"
+#include "os/handler.h"
 #include "os/log.h"
 #include "os/system_properties.h"
+#include "os/thread.h"
 #include "shim/dumpsys.h"
 #include "shim/dumpsys_args.h"
 
@@ -35,6 +39,7 @@ static const std::string kReadOnlyDebuggableProperty = "ro.debuggable";
 namespace {
 constexpr char kModuleName[] = "shim::Dumpsys";
 constexpr char kDumpsysTitle[] = "----- Gd Dumpsys ------";
+constexpr std::chrono::milliseconds kDumpThreadStopTimeout = std::chrono::milliseconds(2000);
 }  // namespace
 
 struct Dumpsys::impl {
@@ -43,7 +48,7 @@ struct Dumpsys::impl {
   int GetNumberOfBundledSchemas() const;
 
   impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema);
-  ~impl() = default;
+  ~impl();
 
  protected:
   void FilterAsUser(std::string* dumpsys_data);
@@ -53,17 +58,68 @@ struct Dumpsys::impl {
   bool IsDebuggable() const;
 
  private:
-  void DumpWithArgsAsync(int fd, const char** args);
+  void PrintDumpsysData(int fd, const char** args, std::string dumpsys_data, std::promise<void> promise);
 
   const Dumpsys& dumpsys_module_;
   const dumpsys::ReflectionSchema reflection_schema_;
+
+  // Compiled once, the schema is the same for every dump
+  const dumpsys::CompiledFilter user_filter_;
+  const dumpsys::CompiledFilter developer_filter_;
+  std::unique_ptr<flatbuffers::Parser> parser_;
+  std::string parser_error_;
+
+  // Only the snapshot of the modules is taken on the stack thread, filtering and printing it is done here
+  os::Thread dump_thread_{"bt_dumpsys", os::Thread::Priority::NORMAL};
+  os::Handler* dump_handler_;
 };
 
 const ModuleFactory Dumpsys::Factory =
     ModuleFactory([]() { return new Dumpsys(bluetooth::dumpsys::GetBundledSchemaData()); });
 
 Dumpsys::impl::impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema)
-    : dumpsys_module_(dumpsys_module), reflection_schema_(std::move(reflection_schema)) {}
+    : dumpsys_module_(dumpsys_module),
+      reflection_schema_(std::move(reflection_schema)),
+      user_filter_(dumpsys::FilterType::AS_USER, reflection_schema_),
+      developer_filter_(dumpsys::FilterType::AS_DEVELOPER, reflection_schema_),
+      dump_handler_(new os::Handler(&dump_thread_)) {
+  const std::string root_name = reflection_schema_.GetRootName();
+  if (root_name.empty()) {
+    char buf[255];
+    snprintf(buf, sizeof(buf), "ERROR: Unable to find root name in prebundled reflection schema\n");
+    LOG_WARN("%s", buf);
+    parser_error_ = buf;
+    return;
+  }
+
+  const reflection::Schema* schema = reflection_schema_.FindInReflectionSchema(root_name);
+  if (schema == nullptr) {
+    char buf[255];
+    snprintf(buf, sizeof(buf), "ERROR: Unable to find schema root name:%s\n", root_name.c_str());
+    LOG_WARN("%s", buf);
+    parser_error_ = buf;
+    return;
+  }
+
+  flatbuffers::IDLOptions options{};
+  options.output_default_scalars_in_json = true;
+  auto parser = std::make_unique<flatbuffers::Parser>(options);
+  if (!parser->Deserialize(schema)) {
+    char buf[255];
+    snprintf(buf, sizeof(buf), "ERROR: Unable to deserialize bundle root name:%s\n", root_name.c_str());
+    LOG_WARN("%s", buf);
+    parser_error_ = buf;
+    return;
+  }
+  parser_ = std::move(parser);
+}
+
+Dumpsys::impl::~impl() {
+  dump_handler_->Clear();
+  dump_handler_->WaitUntilStopped(kDumpThreadStopTimeout);
+  delete dump_handler_;
+  dump_thread_.Stop();
+}
 
 int Dumpsys::impl::GetNumberOfBundledSchemas() const {
   return reflection_schema_.GetNumberOfBundledSchemas();
@@ -75,65 +131,51 @@ bool Dumpsys::impl::IsDebuggable() const {
 
 void Dumpsys::impl::FilterAsDeveloper(std::string* dumpsys_data) {
   ASSERT(dumpsys_data != nullptr);
-  dumpsys::FilterInPlace(dumpsys::FilterType::AS_DEVELOPER, reflection_schema_, dumpsys_data);
+  developer_filter_.FilterInPlace(dumpsys_data);
 }
 
 void Dumpsys::impl::FilterAsUser(std::string* dumpsys_data) {
   ASSERT(dumpsys_data != nullptr);
-  dumpsys::FilterInPlace(dumpsys::FilterType::AS_USER, reflection_schema_, dumpsys_data);
+  user_filter_.FilterInPlace(dumpsys_data);
 }
 
 std::string Dumpsys::impl::PrintAsJson(std::string* dumpsys_data) const {
   ASSERT(dumpsys_data != nullptr);
 
-  const std::string root_name = reflection_schema_.GetRootName();
-  if (root_name.empty()) {
-    char buf[255];
-    snprintf(buf, sizeof(buf), "ERROR: Unable to find root name in prebundled reflection schema\n");
-    LOG_WARN("%s", buf);
-    return std::string(buf);
-  }
-
-  const reflection::Schema* schema = reflection_schema_.FindInReflectionSchema(root_name);
-  if (schema == nullptr) {
-    char buf[255];
-    snprintf(buf, sizeof(buf), "ERROR: Unable to find schema root name:%s\n", root_name.c_str());
-    LOG_WARN("%s", buf);
-    return std::string(buf);
-  }
-
-  flatbuffers::IDLOptions options{};
-  options.output_default_scalars_in_json = true;
-  flatbuffers::Parser parser{options};
-  if (!parser.Deserialize(schema)) {
-    char buf[255];
-    snprintf(buf, sizeof(buf), "ERROR: Unable to deserialize bundle root name:%s\n", root_name.c_str());
-    LOG_WARN("%s", buf);
-    return std::string(buf);
+  if (parser_ == nullptr) {
+    return parser_error_;
   }
 
   std::string jsongen;
-  flatbuffers::GenerateText(parser, dumpsys_data->data(), &jsongen);
+  flatbuffers::GenerateText(*parser_, dumpsys_data->data(), &jsongen);
   return jsongen;
 }
 
-void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) {
+void Dumpsys::impl::PrintDumpsysData(
+    int fd, const char** args, std::string dumpsys_data, std::promise<void> promise) {
   ParsedDumpsysArgs parsed_dumpsys_args(args);
-  const auto registry = dumpsys_module_.GetModuleRegistry();
-
-  ModuleDumper dumper(*registry, kDumpsysTitle);
-  std::string dumpsys_data;
-  dumper.DumpState(&dumpsys_data);
 
   dprintf(fd, " ----- Filtering as Developer -----\n");
   FilterAsDeveloper(&dumpsys_data);
 
   dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
+  promise.set_value();
 }
 
 void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
-  DumpWithArgsAsync(fd, args);
-  promise.set_value();
+  // The state of the modules is only consistent on the stack thread
+  const auto registry = dumpsys_module_.GetModuleRegistry();
+  ModuleDumper dumper(*registry, kDumpsysTitle);
+  std::string dumpsys_data;
+  dumper.DumpState(&dumpsys_data);
+
+  dump_handler_->Post(common::BindOnce(
+      &Dumpsys::impl::PrintDumpsysData,
+      common::Unretained(this),
+      fd,
+      args,
+      std::move(dumpsys_data),
+      std::move(promise)));
 }
 
 Dumpsys::Dumpsys(const std::string& pre_bundled_schema)
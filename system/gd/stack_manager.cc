@@ -34,12 +34,19 @@ using ::bluetooth::os::WakelockManager;
 
 namespace bluetooth {
 
+// The modules which don't depend on each other start concurrently, most of their start is waiting for the controller
+constexpr size_t kNumModuleStartThreads = 4;
+
+// The wakelock is held while the modules start and stop
+constexpr char kWakelockOwner[] = "stack_manager";
+
 void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
   management_thread_ = new Thread("management_thread", Thread::Priority::NORMAL);
   handler_ = new Handler(management_thread_);
 
-  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire(kWakelockOwner);
 
+  auto start_up_begin = std::chrono::steady_clock::now();
   std::promise<void> promise;
   auto future = promise.get_future();
   handler_->Post(common::BindOnce(&StackManager::handle_start_up, common::Unretained(this), modules, stack_thread,
@@ -47,7 +54,7 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
 
   auto init_status = future.wait_for(std::chrono::seconds(3));
 
-  WakelockManager::Get().Release();
+  WakelockManager::Get().Release(kWakelockOwner);
 
   LOG_INFO("init_status == %d", init_status);
 
@@ -56,16 +63,20 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
       "Can't start stack, last instance: %s",
       registry_.last_instance_.c_str());
 
-  LOG_INFO("init complete");
+  LOG_INFO(
+      "init complete in %lld ms",
+      static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::steady_clock::now() - start_up_begin)
+                                 .count()));
 }
 
 void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, std::promise<void> promise) {
-  registry_.Start(modules, stack_thread);
+  registry_.Start(modules, stack_thread, kNumModuleStartThreads);
   promise.set_value();
 }
 
 void StackManager::ShutDown() {
-  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire(kWakelockOwner);
 
   std::promise<void> promise;
   auto future = promise.get_future();
@@ -73,7 +84,7 @@ void StackManager::ShutDown() {
 
   auto stop_status = future.wait_for(std::chrono::seconds(5));
 
-  WakelockManager::Get().Release();
+  WakelockManager::Get().Release(kWakelockOwner);
   WakelockManager::Get().CleanUp();
 
   ASSERT_LOG(
@@ -94,6 +94,8 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
+  std::atomic_store(&snapshot_state_, std::shared_ptr<SnapshotState>());
+  std::atomic_store(&other.snapshot_state_, std::shared_ptr<SnapshotState>());
   return *this;
 }
 
@@ -124,13 +126,56 @@ void ConfigCache::Clear() {
   }
 }
 
+std::shared_ptr<ConfigCache::SnapshotState> ConfigCache::GetSnapshotState() const {
+  auto snapshot = std::atomic_load(&snapshot_state_);
+  if (snapshot) {
+    return snapshot;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  // another reader may have built it while we were waiting for the mutex
+  snapshot = std::atomic_load(&snapshot_state_);
+  if (snapshot) {
+    return snapshot;
+  }
+  snapshot = std::make_shared<SnapshotState>();
+  for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+    for (const auto& section : *config_section) {
+      auto& properties = snapshot->sections[section.first];
+      for (const auto& property : section.second) {
+        properties.emplace(property.first, property.second);
+      }
+    }
+  }
+  std::atomic_store(&snapshot_state_, snapshot);
+  return snapshot;
+}
+
+std::shared_ptr<const ConfigCache::SectionsSnapshot> ConfigCache::GetSectionsSnapshot() const {
+  auto snapshot = GetSnapshotState();
+  return std::shared_ptr<const SectionsSnapshot>(snapshot, &snapshot->sections);
+}
+
+bool ConfigCache::IsKeystoreValue(const std::string& value) {
+  return os::ParameterProvider::GetBtKeystoreInterface() != nullptr && value == kEncryptedStr;
+}
+
 bool ConfigCache::HasSection(const std::string& section) const {
+  auto snapshot = GetSectionsSnapshot();
+  if (snapshot->find(section) != snapshot->end()) {
+    return true;
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   return information_sections_.contains(section) || persistent_devices_.contains(section) ||
          temporary_devices_.contains(section);
 }
 
 bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
+  // sections are unique among all three maps, a section found in the snapshot can't be a temporary device
+  auto snapshot = GetSectionsSnapshot();
+  auto snapshot_iter = snapshot->find(section);
+  if (snapshot_iter != snapshot->end()) {
+    return snapshot_iter->second.find(property) != snapshot_iter->second.end();
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
@@ -148,6 +193,18 @@ bool ConfigCache::HasProperty(const std::string& section, const std::string& pro
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
+  auto snapshot = GetSectionsSnapshot();
+  auto snapshot_iter = snapshot->find(section);
+  if (snapshot_iter != snapshot->end()) {
+    auto property_iter = snapshot_iter->second.find(property);
+    if (property_iter == snapshot_iter->second.end()) {
+      return std::nullopt;
+    }
+    // encrypted values are fetched from the keystore on the locked path below
+    if (!IsKeystoreValue(property_iter->second)) {
+      return property_iter->second;
+    }
+  }
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
@@ -187,7 +244,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
-      section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
+      section_iter = information_sections_.try_emplace_back(section, PropertyMap{}).first;
     }
     section_iter->second.insert_or_assign(property, std::move(value));
     PersistentConfigChangedCallback();
@@ -200,7 +257,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
     if (section_properties) {
       section_iter = persistent_devices_.try_emplace_back(section, std::move(section_properties->second)).first;
     } else {
-      section_iter = persistent_devices_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
+      section_iter = persistent_devices_.try_emplace_back(section, PropertyMap{}).first;
     }
   }
   if (section_iter != persistent_devices_.end()) {
@@ -218,7 +275,7 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter == temporary_devices_.end()) {
-    auto triple = temporary_devices_.try_emplace(section, common::ListMap<std::string, std::string>{});
+    auto triple = temporary_devices_.try_emplace(section, PropertyMap{});
     section_iter = std::get<0>(triple);
   }
   section_iter->second.insert_or_assign(property, std::move(value));
@@ -419,7 +476,7 @@ std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWi
 namespace {
 
 bool FixDeviceTypeInconsistencyInSection(
-    const std::string& section_name, common::ListMap<std::string, std::string>& device_section_entries) {
+    const std::string& section_name, ConfigCache::PropertyMap& device_section_entries) {
   if (!hci::Address::IsValidAddress(section_name)) {
     return false;
   }
@@ -492,7 +549,7 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
 bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  const common::ListMap<std::string, std::string>* section_ptr;
+  const PropertyMap* section_ptr;
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
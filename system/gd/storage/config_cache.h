@@ -15,17 +15,21 @@
  */
 #pragma once
 
+#include <any>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "common/flat_list_map.h"
 #include "common/list_map.h"
 #include "common/lru_cache.h"
 #include "hci/address.h"
@@ -48,9 +52,20 @@ class Mutation;
 // The definition of persistent sections is up to the user and is defined through the |persistent_property_names|
 // argument. When these properties are link key properties, then persistent sections is equal to bonded devices
 //
-// This class is thread safe
+// This class is thread safe. Lookups in persistent and information sections are served from a read-only snapshot
+// without taking the config mutex; the snapshot is dropped on every persistent change and rebuilt by the next lookup.
 class ConfigCache {
  public:
+  // Properties of a section and sections of the cache, in insertion order. Builds defining BT_CONFIG_CACHE_LIST_MAP
+  // keep the node based ListMap instead of the flat one.
+#ifdef BT_CONFIG_CACHE_LIST_MAP
+  using PropertyMap = common::ListMap<std::string, std::string>;
+  using SectionMap = common::ListMap<std::string, PropertyMap>;
+#else
+  using PropertyMap = common::FlatListMap<std::string, std::string>;
+  using SectionMap = common::FlatListMap<std::string, PropertyMap>;
+#endif
+
   ConfigCache(size_t temp_device_capacity, std::unordered_set<std::string_view> persistent_property_names);
 
   ConfigCache(const ConfigCache&) = delete;
@@ -96,6 +111,39 @@ class ConfigCache {
     }
   };
   virtual std::vector<SectionAndPropertyValue> GetSectionNamesWithProperty(const std::string& property) const;
+  // Copy of the sections written to disk, i.e. persistent and information sections, as raw property values
+  using SectionsSnapshot = std::unordered_map<std::string, std::unordered_map<std::string, std::string>>;
+  // Return the current snapshot, building it under the mutex if it was dropped since the last persistent change
+  std::shared_ptr<const SectionsSnapshot> GetSectionsSnapshot() const;
+
+  // Get property converted by |parse|, a function from std::string to std::optional<T>. Values of persistent and
+  // information sections are parsed once and kept along the snapshot, until the next persistent change
+  template <typename T, typename Parser>
+  std::optional<T> GetParsedProperty(const std::string& section, const std::string& property, Parser parse) const {
+    auto snapshot = GetSnapshotState();
+    auto section_iter = snapshot->sections.find(section);
+    if (section_iter == snapshot->sections.end()) {
+      auto value = GetProperty(section, property);
+      return value ? parse(*value) : std::nullopt;
+    }
+    auto property_iter = section_iter->second.find(property);
+    if (property_iter == section_iter->second.end()) {
+      return std::nullopt;
+    }
+    if (IsKeystoreValue(property_iter->second)) {
+      auto value = GetProperty(section, property);
+      return value ? parse(*value) : std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock(snapshot->parsed_values_mutex);
+    auto& parsed_value = snapshot->parsed_values[section][property];
+    // a property may be read as different types, only the last one is kept
+    if (auto* cached = std::any_cast<std::optional<T>>(&parsed_value)) {
+      return *cached;
+    }
+    std::optional<T> value = parse(property_iter->second);
+    parsed_value = value;
+    return value;
+  }
 
   // modifiers
   // Commit all mutation entries in sequence while holding the config mutex
@@ -132,15 +180,29 @@ class ConfigCache {
   // section would become temporary again
   std::unordered_set<std::string_view> persistent_property_names_;
   // Common section that does not relate to remote device, will be written to disk
-  common::ListMap<std::string, common::ListMap<std::string, std::string>> information_sections_;
+  SectionMap information_sections_;
   // Information about persistent devices, normally paired, will be written to disk
-  common::ListMap<std::string, common::ListMap<std::string, std::string>> persistent_devices_;
+  SectionMap persistent_devices_;
   // Information about temporary devices, normally unpaired, will not be written to disk, will be evicted automatically
   // if capacity exceeds given value during initialization
-  common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
+  common::LruCache<std::string, PropertyMap, SectionMap> temporary_devices_;
+  // Read-only copy of information_sections_ and persistent_devices_, with the values parsed from it
+  struct SnapshotState {
+    SectionsSnapshot sections;
+    std::mutex parsed_values_mutex;
+    std::unordered_map<std::string, std::unordered_map<std::string, std::any>> parsed_values;
+  };
+  // Accessed with std::atomic_load/atomic_store. Temporary devices are left out as looking them up warms up the LRU
+  // cache, which needs the mutex.
+  mutable std::shared_ptr<SnapshotState> snapshot_state_;
+
+  std::shared_ptr<SnapshotState> GetSnapshotState() const;
+  // Return true if |value| stands for a value kept in the keystore
+  static bool IsKeystoreValue(const std::string& value);
 
-  // Convenience method to check if the callback is valid before calling it
+  // Convenience method to check if the callback is valid before calling it, every persistent change goes through here
   inline void PersistentConfigChangedCallback() const {
+    std::atomic_store(&snapshot_state_, std::shared_ptr<SnapshotState>());
     if (persistent_config_changed_callback_) {
       persistent_config_changed_callback_();
     }
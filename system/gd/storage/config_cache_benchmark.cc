@@ -0,0 +1,132 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "storage/config_cache.h"
+#include "storage/device.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+// Capacity of the temporary devices, as set by the storage module
+constexpr size_t kTemporaryDeviceCapacity = 10000;
+
+std::string MakeAddress(size_t i) {
+  char address[18];
+  snprintf(address, sizeof(address), "00:11:22:%02zx:%02zx:%02zx", (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+  return address;
+}
+
+// The properties of a bonded device, in the order the stack writes them after pairing
+void AddBondedDevice(ConfigCache& cache, const std::string& address) {
+  cache.SetProperty(address, "Name", "Headphones " + address);
+  cache.SetProperty(address, "DevClass", "2360324");
+  cache.SetProperty(address, "DevType", "3");
+  cache.SetProperty(address, "AddrType", "0");
+  cache.SetProperty(address, "Manufacturer", "15");
+  cache.SetProperty(address, "Service", "0000110b-0000-1000-8000-00805f9b34fb 0000110e-0000-1000-8000-00805f9b34fb");
+  cache.SetProperty(address, "LinkKeyType", "8");
+  cache.SetProperty(address, "PinLength", "0");
+  cache.SetProperty(address, "LinkKey", "0123456789abcdef0123456789abcdef");
+  cache.SetProperty(address, "LE_KEY_PENC", "0123456789abcdef0123456789abcdef0123456789abcdef0123456789");
+}
+}  // namespace
+
+// A config of range(0) bonded devices
+class BM_ConfigCache : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    cache_ = std::make_unique<ConfigCache>(kTemporaryDeviceCapacity, Device::kLinkKeyProperties);
+    cache_->SetProperty("Adapter", "Address", "01:02:03:04:05:06");
+    cache_->SetProperty("Adapter", "Name", "Phone");
+    addresses_.clear();
+    for (int64_t i = 0; i < st.range(0); i++) {
+      addresses_.push_back(MakeAddress(i));
+      AddBondedDevice(*cache_, addresses_.back());
+    }
+  }
+
+  void TearDown(State& st) override {
+    cache_.reset();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::unique_ptr<ConfigCache> cache_;
+  std::vector<std::string> addresses_;
+};
+
+// Reads of a property of the bonded devices, as done on every connection
+BENCHMARK_DEFINE_F(BM_ConfigCache, get_property)(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(cache_->GetProperty(addresses_[i++ % addresses_.size()], "DevType"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BM_ConfigCache, get_property)->Arg(16)->Arg(256);
+
+// Writes of the value a property already has, the most frequent write from the remote device info updates
+BENCHMARK_DEFINE_F(BM_ConfigCache, set_same_property)(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    cache_->SetProperty(addresses_[i++ % addresses_.size()], "DevClass", "2360324");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BM_ConfigCache, set_same_property)->Arg(16)->Arg(256);
+
+// Writes of a new value to a persistent property
+BENCHMARK_DEFINE_F(BM_ConfigCache, set_new_property)(State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    cache_->SetProperty(addresses_[i % addresses_.size()], "Name", (i % 2) ? "Headphones" : "Earbuds");
+    i++;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BM_ConfigCache, set_new_property)->Arg(16)->Arg(256);
+
+// Properties of the devices found by a scan, going to the temporary devices and evicting the oldest ones once full
+BENCHMARK_DEFINE_F(BM_ConfigCache, scan_results)(State& state) {
+  std::vector<std::string> scanned;
+  for (size_t i = 0; i < 2 * kTemporaryDeviceCapacity; i++) {
+    scanned.push_back(MakeAddress(0x800000 + i));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto& address = scanned[i++ % scanned.size()];
+    cache_->SetProperty(address, "Name", "Beacon");
+    cache_->SetProperty(address, "DevType", "2");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BM_ConfigCache, scan_results)->Arg(16);
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -109,15 +109,13 @@ void ConfigCacheHelper::SetBin(
 
 std::optional<std::vector<uint8_t>> ConfigCacheHelper::GetBin(
     const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
-  auto value = common::FromHexString(*value_str);
-  if (!value) {
-    LOG_WARN("value_str cannot be parsed to std::vector<uint8_t>");
-  }
-  return value;
+  return config_cache_.GetParsedProperty<std::vector<uint8_t>>(section, property, [](const std::string& value_str) {
+    auto value = common::FromHexString(value_str);
+    if (!value) {
+      LOG_WARN("value_str cannot be parsed to std::vector<uint8_t>");
+    }
+    return value;
+  });
 }
 
 }  // namespace storage
@@ -55,28 +55,28 @@ class ConfigCacheHelper {
   virtual void SetBin(const std::string& section, const std::string& property, const std::vector<uint8_t>& value);
   virtual std::optional<std::vector<uint8_t>> GetBin(const std::string& section, const std::string& property) const;
 
+  // Typed getters below parse the property once, and then return the value cached by ConfigCache until the property
+  // or its section changes
   template <typename T, typename std::enable_if<std::is_signed_v<T> && std::is_integral_v<T>, int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
-    auto value = GetInt64(section, property);
-    if (!value) {
-      return std::nullopt;
-    }
-    if (!common::IsNumberInNumericLimits<T>(*value)) {
-      return std::nullopt;
-    }
-    return static_cast<T>(*value);
+    return config_cache_.GetParsedProperty<T>(section, property, [](const std::string& value_str) -> std::optional<T> {
+      auto value = common::Int64FromString(value_str);
+      if (!value || !common::IsNumberInNumericLimits<T>(*value)) {
+        return std::nullopt;
+      }
+      return static_cast<T>(*value);
+    });
   }
 
   template <typename T, typename std::enable_if<std::is_unsigned_v<T> && std::is_integral_v<T>, int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
-    auto value = GetUint64(section, property);
-    if (!value) {
-      return std::nullopt;
-    }
-    if (!common::IsNumberInNumericLimits<T>(*value)) {
-      return std::nullopt;
-    }
-    return static_cast<T>(*value);
+    return config_cache_.GetParsedProperty<T>(section, property, [](const std::string& value_str) -> std::optional<T> {
+      auto value = common::Uint64FromString(value_str);
+      if (!value || !common::IsNumberInNumericLimits<T>(*value)) {
+        return std::nullopt;
+      }
+      return static_cast<T>(*value);
+    });
   }
 
   template <typename T, typename std::enable_if<std::is_same_v<T, std::string>, int>::type = 0>
@@ -96,20 +96,14 @@ class ConfigCacheHelper {
 
   template <typename T, typename std::enable_if<std::is_base_of_v<Serializable<T>, T>, int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
-    auto value = config_cache_.GetProperty(section, property);
-    if (!value) {
-      return std::nullopt;
-    }
-    return T::FromLegacyConfigString(*value);
+    return config_cache_.GetParsedProperty<T>(
+        section, property, [](const std::string& value) { return T::FromLegacyConfigString(value); });
   }
 
   template <typename T, typename std::enable_if<std::is_enum_v<T>, int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
-    auto value = config_cache_.GetProperty(section, property);
-    if (!value) {
-      return std::nullopt;
-    }
-    return bluetooth::FromLegacyConfigString<T>(*value);
+    return config_cache_.GetParsedProperty<T>(
+        section, property, [](const std::string& value) { return bluetooth::FromLegacyConfigString<T>(value); });
   }
 
   template <
@@ -119,21 +113,19 @@ class ConfigCacheHelper {
               std::is_base_of_v<Serializable<typename T::value_type>, typename T::value_type>,
           int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
-    auto value = config_cache_.GetProperty(section, property);
-    if (!value) {
-      return std::nullopt;
-    }
-    auto values = common::StringSplit(*value, " ");
-    T result;
-    result.reserve(values.size());
-    for (const auto& str : values) {
-      auto v = T::value_type::FromLegacyConfigString(str);
-      if (!v) {
-        return std::nullopt;
+    return config_cache_.GetParsedProperty<T>(section, property, [](const std::string& value) -> std::optional<T> {
+      auto values = common::StringSplit(value, " ");
+      T result;
+      result.reserve(values.size());
+      for (const auto& str : values) {
+        auto v = T::value_type::FromLegacyConfigString(str);
+        if (!v) {
+          return std::nullopt;
+        }
+        result.push_back(*v);
       }
-      result.push_back(*v);
-    }
-    return result;
+      return result;
+    });
   }
 
  private:
@@ -19,7 +19,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 #include "hci/enum_helper.h"
 #include "storage/device.h"
@@ -413,4 +416,80 @@ TEST(ConfigCacheTest, test_empty_persistent_properties) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre());
 }
 
+TEST(ConfigCacheTest, lookups_follow_persistent_changes) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+  ASSERT_FALSE(config.HasProperty("CC:DD:EE:FF:00:11", "B"));
+
+  config.SetProperty("A", "B", "D");
+  config.SetProperty("CC:DD:EE:FF:00:11", "B", "E");
+  ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("D")));
+  ASSERT_TRUE(config.HasProperty("CC:DD:EE:FF:00:11", "B"));
+
+  // unpaired device moves to the temporary devices, which are not in the snapshot
+  config.RemoveProperty("CC:DD:EE:FF:00:11", "LinkKey");
+  ASSERT_FALSE(config.HasProperty("CC:DD:EE:FF:00:11", "LinkKey"));
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "B"), Optional(StrEq("E")));
+  ASSERT_FALSE(config.IsPersistentSection("CC:DD:EE:FF:00:11"));
+
+  config.RemoveSection("A");
+  ASSERT_FALSE(config.HasSection("A"));
+  ASSERT_EQ(config.GetProperty("A", "B"), std::nullopt);
+  config.Clear();
+  ASSERT_FALSE(config.HasSection("CC:DD:EE:FF:00:11"));
+}
+
+TEST(ConfigCacheTest, concurrent_lookups_while_modifying) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&config, &done] {
+      while (!done) {
+        ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+        config.HasProperty("CC:DD:EE:FF:00:11", "DevType");
+      }
+    });
+  }
+  for (int i = 0; i < 1000; i++) {
+    config.SetProperty("CC:DD:EE:FF:00:11", "DevType", std::to_string(i % 3));
+    config.SetProperty(GetTestAddress(i % 50), "Name", "Device");
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "DevType"), Optional(StrEq("0")));
+}
+
+TEST(ConfigCacheTest, parsed_properties_are_cached_until_changed) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  config.SetProperty("CC:DD:EE:FF:00:11", "DevType", "1");
+  int num_parse = 0;
+  auto parse = [&num_parse](const std::string& value) -> std::optional<int> {
+    num_parse++;
+    return std::stoi(value);
+  };
+  ASSERT_THAT(config.GetParsedProperty<int>("CC:DD:EE:FF:00:11", "DevType", parse), Optional(1));
+  ASSERT_THAT(config.GetParsedProperty<int>("CC:DD:EE:FF:00:11", "DevType", parse), Optional(1));
+  ASSERT_EQ(num_parse, 1);
+  ASSERT_EQ(config.GetParsedProperty<int>("CC:DD:EE:FF:00:11", "Unknown", parse), std::nullopt);
+  ASSERT_EQ(num_parse, 1);
+
+  config.SetProperty("CC:DD:EE:FF:00:11", "DevType", "3");
+  ASSERT_THAT(config.GetParsedProperty<int>("CC:DD:EE:FF:00:11", "DevType", parse), Optional(3));
+  ASSERT_EQ(num_parse, 2);
+
+  // Properties of temporary devices are parsed on every read
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "DevType", "2");
+  ASSERT_THAT(config.GetParsedProperty<int>("AA:BB:CC:DD:EE:FF", "DevType", parse), Optional(2));
+  ASSERT_THAT(config.GetParsedProperty<int>("AA:BB:CC:DD:EE:FF", "DevType", parse), Optional(2));
+  ASSERT_EQ(num_parse, 4);
+}
+
 }  // namespace testing
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <sstream>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr char kSetTag = 'S';
+constexpr char kRemovePropertyTag = 'P';
+constexpr char kRemoveSectionTag = 'R';
+constexpr char kSeparator = '\t';
+
+bool IsJournalName(const std::string& name) {
+  return !name.empty() && name.find(kSeparator) == std::string::npos && name.find('\n') == std::string::npos;
+}
+
+}  // namespace
+
+ConfigJournal::ConfigJournal(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+std::queue<MutationEntry> ConfigJournal::Diff(
+    const ConfigCache::SectionsSnapshot& from, const ConfigCache::SectionsSnapshot& to) {
+  std::queue<MutationEntry> entries;
+  for (const auto& [section, properties] : from) {
+    auto to_iter = to.find(section);
+    if (to_iter == to.end()) {
+      entries.push(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, section));
+      continue;
+    }
+    for (const auto& property : properties) {
+      if (to_iter->second.find(property.first) == to_iter->second.end()) {
+        entries.push(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, section, property.first));
+      }
+    }
+  }
+  for (const auto& [section, properties] : to) {
+    auto from_iter = from.find(section);
+    for (const auto& [property, value] : properties) {
+      if (from_iter != from.end()) {
+        auto property_iter = from_iter->second.find(property);
+        if (property_iter != from_iter->second.end() && property_iter->second == value) {
+          continue;
+        }
+      }
+      entries.push(MutationEntry::Set(MutationEntry::PropertyType::NORMAL, section, property, value));
+    }
+  }
+  return entries;
+}
+
+bool ConfigJournal::Append(const std::queue<MutationEntry>& entries) {
+  if (entries.empty()) {
+    return true;
+  }
+  std::stringstream serialized;
+  auto remaining = entries;
+  while (!remaining.empty()) {
+    const auto& entry = remaining.front();
+    if (!IsJournalName(entry.section)) {
+      LOG_WARN("section name can't be journaled");
+      return false;
+    }
+    switch (entry.entry_type) {
+      case MutationEntry::EntryType::SET:
+        if (!IsJournalName(entry.property) || entry.value.find('\n') != std::string::npos) {
+          LOG_WARN("property of section %s can't be journaled", entry.section.c_str());
+          return false;
+        }
+        serialized << kSetTag << kSeparator << entry.section << kSeparator << entry.property << kSeparator
+                   << entry.value << '\n';
+        break;
+      case MutationEntry::EntryType::REMOVE_PROPERTY:
+        if (!IsJournalName(entry.property)) {
+          LOG_WARN("property of section %s can't be journaled", entry.section.c_str());
+          return false;
+        }
+        serialized << kRemovePropertyTag << kSeparator << entry.section << kSeparator << entry.property << '\n';
+        break;
+      case MutationEntry::EntryType::REMOVE_SECTION:
+        serialized << kRemoveSectionTag << kSeparator << entry.section << '\n';
+        break;
+    }
+    remaining.pop();
+  }
+  return os::AppendToFile(path_, serialized.str());
+}
+
+size_t ConfigJournal::Replay(ConfigCache& cache) {
+  if (!Exists()) {
+    return 0;
+  }
+  auto content = os::ReadSmallFile(path_);
+  if (!content) {
+    return 0;
+  }
+  std::queue<MutationEntry> entries;
+  size_t line_start = 0;
+  size_t line_end;
+  while ((line_end = content->find('\n', line_start)) != std::string::npos) {
+    auto line = content->substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+    auto tokens = common::StringSplit(line, std::string(1, kSeparator), 4);
+    if (tokens.size() == 4 && tokens[0].size() == 1 && tokens[0][0] == kSetTag) {
+      entries.push(MutationEntry::Set(
+          MutationEntry::PropertyType::NORMAL, std::move(tokens[1]), std::move(tokens[2]), std::move(tokens[3])));
+    } else if (tokens.size() == 3 && tokens[0].size() == 1 && tokens[0][0] == kRemovePropertyTag) {
+      entries.push(
+          MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(tokens[1]), std::move(tokens[2])));
+    } else if (tokens.size() == 2 && tokens[0].size() == 1 && tokens[0][0] == kRemoveSectionTag) {
+      entries.push(MutationEntry::Remove(MutationEntry::PropertyType::NORMAL, std::move(tokens[1])));
+    } else {
+      LOG_WARN("ignoring malformed journal entry");
+    }
+  }
+  if (line_start != content->size()) {
+    LOG_WARN("ignoring incomplete journal entry at the end of %s", path_.c_str());
+  }
+  size_t num_entries = entries.size();
+  cache.Commit(entries);
+  return num_entries;
+}
+
+bool ConfigJournal::Exists() const {
+  return os::FileExists(path_);
+}
+
+bool ConfigJournal::Delete() {
+  if (!Exists()) {
+    return true;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
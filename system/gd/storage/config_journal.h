@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <queue>
+#include <string>
+#include <utility>
+
+#include "storage/config_cache.h"
+#include "storage/mutation_entry.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Append-only log of the changes made to the sections of a config cache written to disk since its legacy config file
+// was last written, so that a small change doesn't rewrite the whole config file. The journal is applied on top of the
+// legacy config file when it is read, and deleted when the legacy config file is written again (compaction).
+//
+// Each line is one mutation entry, fields separated by tabs:
+//   S <section> <property> <value>
+//   P <section> <property>
+//   R <section>
+// A line that isn't terminated by a newline was cut by a crash while appending it, and is ignored.
+class ConfigJournal {
+ public:
+  static ConfigJournal FromPath(std::string path) {
+    return ConfigJournal(std::move(path));
+  }
+  explicit ConfigJournal(std::string path);
+
+  // Return the mutation entries turning |from| into |to|
+  static std::queue<MutationEntry> Diff(
+      const ConfigCache::SectionsSnapshot& from, const ConfigCache::SectionsSnapshot& to);
+
+  // Append |entries| to the journal. Return false if an entry can't be journaled or the file can't be written, the
+  // legacy config file must then be written instead
+  bool Append(const std::queue<MutationEntry>& entries);
+
+  // Apply the journal to |cache|, return the number of entries applied, 0 if there is no journal
+  size_t Replay(ConfigCache& cache);
+
+  bool Exists() const;
+  bool Delete();
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
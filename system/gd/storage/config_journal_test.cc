@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+
+namespace testing {
+
+using bluetooth::os::ReadSmallFile;
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
+using bluetooth::storage::Device;
+
+class ConfigJournalTest : public Test {
+ protected:
+  void SetUp() override {
+    temp_journal_ = std::filesystem::temp_directory_path() / "temp_config.journal";
+    std::filesystem::remove(temp_journal_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(temp_journal_);
+  }
+
+  std::filesystem::path temp_journal_;
+};
+
+TEST_F(ConfigJournalTest, append_and_replay_loop_back_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Old");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  auto before = config.GetSectionsSnapshot();
+
+  ConfigCache saved(100, Device::kLinkKeyProperties);
+  ASSERT_EQ(ConfigJournal::FromPath(temp_journal_.string()).Replay(saved), 0u);
+  ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Append(ConfigJournal::Diff({}, *before)));
+  ASSERT_EQ(ConfigJournal::FromPath(temp_journal_.string()).Replay(saved), 4u);
+  ASSERT_EQ(*saved.GetSectionsSnapshot(), *before);
+
+  config.SetProperty("A", "B", "D");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "New value with spaces");
+  config.RemoveProperty("A", "B");
+  config.SetProperty("A", "E", "F");
+  config.RemoveSection("CC:DD:EE:FF:00:11");
+  config.SetProperty("11:22:33:44:55:66", "LE_KEY_PENC", "AABB");
+  auto after = config.GetSectionsSnapshot();
+  auto entries = ConfigJournal::Diff(*before, *after);
+  ASSERT_EQ(entries.size(), 5u);
+  ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Append(entries));
+
+  ConfigCache replayed(100, Device::kLinkKeyProperties);
+  ASSERT_EQ(ConfigJournal::FromPath(temp_journal_.string()).Replay(replayed), 9u);
+  ASSERT_EQ(*replayed.GetSectionsSnapshot(), *after);
+  ASSERT_TRUE(replayed.IsPersistentSection("11:22:33:44:55:66"));
+  ASSERT_FALSE(replayed.HasSection("CC:DD:EE:FF:00:11"));
+
+  ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Delete());
+  ASSERT_FALSE(ConfigJournal::FromPath(temp_journal_.string()).Exists());
+}
+
+TEST_F(ConfigJournalTest, unchanged_config_appends_nothing_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  auto snapshot = config.GetSectionsSnapshot();
+  auto entries = ConfigJournal::Diff(*snapshot, *snapshot);
+  ASSERT_TRUE(entries.empty());
+  ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Append(entries));
+  ASSERT_FALSE(ConfigJournal::FromPath(temp_journal_.string()).Exists());
+}
+
+TEST_F(ConfigJournalTest, names_with_separator_are_not_journaled_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A\tB", "C", "D");
+  ASSERT_FALSE(ConfigJournal::FromPath(temp_journal_.string()).Append(
+      ConfigJournal::Diff({}, *config.GetSectionsSnapshot())));
+  ASSERT_THAT(ReadSmallFile(temp_journal_.string()), Eq(std::nullopt));
+}
+
+}  // namespace testing
@@ -20,6 +20,8 @@
 #include <ctime>
 #include <iomanip>
 #include <memory>
+#include <queue>
+#include <unordered_set>
 #include <utility>
 
 #include "common/bind.h"
@@ -30,6 +32,7 @@
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/legacy_config_file.h"
 #include "storage/mutation.h"
 
@@ -49,12 +52,28 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine, and 20 ms if including backup file
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// Config saves append the changes to the journal, until it has this many entries and the config file is rewritten
+static const size_t kMaxJournalEntries = 1024;
 
 const int kConfigFileComparePass = 1;
 const int kConfigBackupComparePass = 2;
 const std::string kConfigFilePrefix = "bt_config-origin";
 const std::string kConfigFileHash = "hash";
 
+static size_t CountSections(std::queue<MutationEntry> entries) {
+  std::unordered_set<std::string> sections;
+  for (; !entries.empty(); entries.pop()) {
+    sections.insert(entries.front().section);
+  }
+  return sections.size();
+}
+
+// The config file checksum of common criteria mode doesn't cover the journal, the config file is always rewritten then
+static bool IsJournalingEnabled() {
+  return bluetooth::os::ParameterProvider::GetBtKeystoreInterface() == nullptr ||
+         !bluetooth::os::ParameterProvider::IsCommonCriteriaMode();
+}
+
 const std::string StorageModule::kInfoSection = "Info";
 const std::string StorageModule::kFileSourceProperty = "FileSource";
 const std::string StorageModule::kTimeCreatedProperty = "TimeCreated";
@@ -75,6 +94,8 @@ StorageModule::StorageModule(
       is_single_user_mode_(is_single_user_mode) {
   // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.bak"
   config_backup_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".bak";
+  // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.journal"
+  config_journal_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".journal";
   ASSERT_LOG(
       config_save_delay > kMinConfigSaveDelay,
       "Config save delay of %lld ms is not enough, must be at least %lld ms to avoid overwhelming the disk",
@@ -99,6 +120,11 @@ struct StorageModule::impl {
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  // Sections as saved on disk by the config file and the journal
+  std::shared_ptr<const ConfigCache::SectionsSnapshot> saved_sections_;
+  size_t num_journal_entries_ = 0;
+  bool compaction_needed_ = false;
+  SaveStatistics save_statistics_;
 };
 
 Mutation StorageModule::Modify() {
@@ -122,6 +148,28 @@ void StorageModule::SaveImmediately() {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  auto sections = pimpl_->cache_.GetSectionsSnapshot();
+  auto journal = ConfigJournal::FromPath(config_journal_path_);
+  auto entries = ConfigJournal::Diff(*pimpl_->saved_sections_, *sections);
+  auto& statistics = pimpl_->save_statistics_;
+  statistics.num_saves++;
+  statistics.last_save_entries = entries.size();
+  statistics.last_save_sections = CountSections(entries);
+  if (IsJournalingEnabled()) {
+    if (!pimpl_->compaction_needed_ && pimpl_->num_journal_entries_ + entries.size() <= kMaxJournalEntries &&
+        journal.Append(entries)) {
+      pimpl_->num_journal_entries_ += entries.size();
+      pimpl_->saved_sections_ = std::move(sections);
+      statistics.num_journal_appends++;
+      statistics.num_journal_entries += entries.size();
+      return;
+    }
+  }
+  // The journal must not be replayed on top of the new config file if it doesn't lead to the same content, bring
+  // it up to date so that it stays valid whether the new config file makes it to disk or not
+  if (journal.Exists() && (!IsJournalingEnabled() || !journal.Append(entries))) {
+    journal.Delete();
+  }
   // 1. rename old config to backup name
   if (os::FileExists(config_file_path_)) {
     ASSERT(os::RenameFile(config_file_path_, config_backup_path_));
@@ -130,7 +178,13 @@ void StorageModule::SaveImmediately() {
   ASSERT(LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_));
   // 3. now write back up to disk as well
   ASSERT(LegacyConfigFile::FromPath(config_backup_path_).Write(pimpl_->cache_));
-  // 4. save checksum if it is running in common criteria mode
+  // 4. both config files are up to date, the journal has been compacted into them
+  journal.Delete();
+  pimpl_->saved_sections_ = std::move(sections);
+  pimpl_->num_journal_entries_ = 0;
+  pimpl_->compaction_needed_ = false;
+  statistics.num_compactions++;
+  // 5. save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
@@ -138,6 +192,11 @@ void StorageModule::SaveImmediately() {
   }
 }
 
+StorageModule::SaveStatistics StorageModule::GetSaveStatistics() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return pimpl_->save_statistics_;
+}
+
 void StorageModule::Clear() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   pimpl_->cache_.Clear();
@@ -154,6 +213,7 @@ void StorageModule::Start() {
     LOG_INFO("%s is true, delete config files", kFactoryResetProperty.c_str());
     LegacyConfigFile::FromPath(config_file_path_).Delete();
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
+    ConfigJournal::FromPath(config_journal_path_).Delete();
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
@@ -176,6 +236,18 @@ void StorageModule::Start() {
     config.emplace(temp_devices_capacity_, Device::kLinkKeyProperties);
     file_source = "Empty";
   }
+  // Apply the changes saved since the config file was last written, and write it again to compact them
+  auto journal = ConfigJournal::FromPath(config_journal_path_);
+  if (journal.Exists()) {
+    if (IsJournalingEnabled()) {
+      LOG_INFO("applied %zu config journal entries", journal.Replay(*config));
+    } else {
+      LOG_WARN("dropping config journal at %s in common criteria mode", config_journal_path_.c_str());
+      journal.Delete();
+    }
+    save_needed = true;
+  }
+  auto saved_sections = config->GetSectionsSnapshot();
   if (!file_source.empty()) {
     config->SetProperty(kInfoSection, kFileSourceProperty, std::move(file_source));
   }
@@ -195,8 +267,10 @@ void StorageModule::Start() {
   config->FixDeviceTypeInconsistencies();
   // TODO (b/158035889) Migrate metrics module to GD
   pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
+  pimpl_->saved_sections_ = std::move(saved_sections);
   if (save_needed) {
     // Set a timer and write the new config file to disk.
+    pimpl_->compaction_needed_ = true;
     SaveDelayed();
   }
   pimpl_->cache_.SetPersistentConfigChangedCallback(
@@ -208,8 +282,9 @@ void StorageModule::Start() {
 
 void StorageModule::Stop() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
-  if (pimpl_->has_pending_config_save_) {
-    // Save pending changes before stopping the module.
+  if (pimpl_->has_pending_config_save_ || pimpl_->num_journal_entries_ > 0) {
+    // Save pending changes before stopping the module, and compact the journal into the config file.
+    pimpl_->compaction_needed_ = true;
     SaveImmediately();
   }
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr) {
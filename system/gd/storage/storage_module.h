@@ -41,6 +41,7 @@ class SecurityManagerImpl;
 
 namespace hci {
 class AclManager;
+class Controller;
 }
 
 namespace storage {
@@ -54,6 +55,18 @@ class StorageModule : public bluetooth::Module {
 
   static const std::string kAdapterSection;
 
+  // Counters of the config saves since the module started, a save writes the changes coalesced since the previous
+  // one either to the journal or, when compacting, to the config files
+  struct SaveStatistics {
+    size_t num_saves = 0;
+    size_t num_journal_appends = 0;
+    size_t num_journal_entries = 0;
+    size_t num_compactions = 0;
+    // Changes made by the last save
+    size_t last_save_entries = 0;
+    size_t last_save_sections = 0;
+  };
+
   StorageModule(const StorageModule&) = delete;
   StorageModule& operator=(const StorageModule&) = delete;
 
@@ -120,6 +133,7 @@ class StorageModule : public bluetooth::Module {
 
   friend shim::BtifConfigInterface;
   friend hci::AclManager;
+  friend hci::Controller;
   friend security::internal::SecurityManagerImpl;
   // For unit test only
   ConfigCache* GetMemoryOnlyConfigCache();
@@ -129,6 +143,7 @@ class StorageModule : public bluetooth::Module {
   // In some cases, one may want to save the config immediately to disk. Call this method with caution as it runs
   // immediately on the calling thread
   void SaveImmediately();
+  SaveStatistics GetSaveStatistics() const;
   // remove all content in this config cache, restore it to the state after the explicit constructor
   void Clear();
 
@@ -180,6 +195,7 @@ class StorageModule : public bluetooth::Module {
   std::unique_ptr<impl> pimpl_;
   std::string config_file_path_;
   std::string config_backup_path_;
+  std::string config_journal_path_;
   std::chrono::milliseconds config_save_delay_;
   size_t temp_devices_capacity_;
   bool is_restricted_mode_;
@@ -31,6 +31,7 @@
 #include "os/fake_timer/fake_timerfd.h"
 #include "os/files.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/device.h"
 #include "storage/legacy_config_file.h"
 
@@ -40,6 +41,7 @@ using bluetooth::TestModuleRegistry;
 using bluetooth::hci::Address;
 using bluetooth::os::fake_timer::fake_timerfd_advance;
 using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
 using bluetooth::storage::Device;
 using bluetooth::storage::LegacyConfigFile;
 using bluetooth::storage::StorageModule;
@@ -88,6 +90,10 @@ class TestStorageModule : public StorageModule {
     return RemoveProperty(section, property);
   }
 
+  SaveStatistics GetSaveStatisticsPublic() const {
+    return GetSaveStatistics();
+  }
+
   void ConvertEncryptOrDecryptKeyIfNeededPublic() {
     return ConvertEncryptOrDecryptKeyIfNeeded();
   }
@@ -107,6 +113,7 @@ class StorageModuleTest : public Test {
     temp_dir_ = std::filesystem::temp_directory_path();
     temp_config_ = temp_dir_ / "temp_config.txt";
     temp_backup_config_ = temp_dir_ / "temp_config.bak";
+    temp_journal_ = temp_dir_ / "temp_config.journal";
     DeleteConfigFiles();
     ASSERT_FALSE(std::filesystem::exists(temp_config_));
     ASSERT_FALSE(std::filesystem::exists(temp_backup_config_));
@@ -124,6 +131,18 @@ class StorageModuleTest : public Test {
     if (std::filesystem::exists(temp_backup_config_)) {
       ASSERT_TRUE(std::filesystem::remove(temp_backup_config_));
     }
+    if (std::filesystem::exists(temp_journal_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_journal_));
+    }
+  }
+
+  // Read the config as saved on disk, i.e. the config file with the journal applied
+  std::optional<ConfigCache> ReadSavedConfig() {
+    auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+    if (config) {
+      ConfigJournal::FromPath(temp_journal_.string()).Replay(*config);
+    }
+    return config;
   }
 
   void FakeTimerAdvance(std::chrono::milliseconds time) {
@@ -146,6 +165,7 @@ class StorageModuleTest : public Test {
   std::filesystem::path temp_dir_;
   std::filesystem::path temp_config_;
   std::filesystem::path temp_backup_config_;
+  std::filesystem::path temp_journal_;
 };
 
 TEST_F(StorageModuleTest, empty_config_no_op_test) {
@@ -234,7 +254,7 @@ TEST_F(StorageModuleTest, save_config_test) {
   ASSERT_THAT(storage->GetPropertyPublic("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
   ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
 
-  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  auto config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
 
@@ -242,7 +262,7 @@ TEST_F(StorageModuleTest, save_config_test) {
   storage->RemovePropertyPublic("01:02:03:ab:cd:ea", "name");
   ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
   LOG_INFO("After waiting 2");
-  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_FALSE(config->HasProperty("01:02:03:ab:cd:ea", "name"));
 
@@ -250,7 +270,7 @@ TEST_F(StorageModuleTest, save_config_test) {
   storage->RemoveSectionPublic("01:02:03:ab:cd:ea");
   ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
   LOG_INFO("After waiting 3");
-  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_FALSE(config->HasSection("01:02:03:ab:cd:ea"));
 
@@ -331,4 +351,64 @@ TEST_F(StorageModuleTest, no_config_causes_a_write) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
+TEST_F(StorageModuleTest, small_change_is_journaled_test) {
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", "name", "foo");
+  storage->SetPropertyPublic("01:02:03:ab:cd:eb", "LinkKey", "fedcba0987654321fedcba0987654329");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+
+  // The config file is left as is, the changes are appended to the journal
+  ASSERT_THAT(bluetooth::os::ReadSmallFile(temp_config_.string()), Optional(StrEq(kReadTestConfig)));
+  ASSERT_TRUE(std::filesystem::exists(temp_journal_));
+  auto config = ReadSavedConfig();
+  ASSERT_TRUE(config);
+  ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  ASSERT_THAT(config->GetPersistentSections(), ElementsAre("01:02:03:ab:cd:ea", "01:02:03:ab:cd:eb"));
+
+  storage->RemoveSectionPublic("01:02:03:ab:cd:ea");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+  config = ReadSavedConfig();
+  ASSERT_TRUE(config);
+  ASSERT_FALSE(config->HasSection("01:02:03:ab:cd:ea"));
+  auto statistics = storage->GetSaveStatisticsPublic();
+  ASSERT_EQ(statistics.num_saves, statistics.num_journal_appends);
+  ASSERT_EQ(statistics.num_compactions, 0u);
+  ASSERT_EQ(statistics.last_save_entries, 1u);
+  ASSERT_EQ(statistics.last_save_sections, 1u);
+
+  // The journal is compacted into the config file when stopping
+  test_registry_.StopAll();
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_FALSE(config->HasSection("01:02:03:ab:cd:ea"));
+  ASSERT_THAT(config->GetPersistentSections(), ElementsAre("01:02:03:ab:cd:eb"));
+}
+
+TEST_F(StorageModuleTest, journal_is_replayed_on_start_test) {
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+  ASSERT_TRUE(bluetooth::os::WriteToFile(
+      temp_journal_.string(),
+      "S\t01:02:03:ab:cd:ea\tname\tfoo\n"
+      "R\tMetrics\n"
+      "S\t01:02:03:ab:cd:ea\tname\tcut by a crash"));
+
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  ASSERT_THAT(storage->GetPropertyPublic("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  ASSERT_FALSE(storage->HasSectionPublic("Metrics"));
+
+  test_registry_.StopAll();
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  ASSERT_FALSE(config->HasSection("Metrics"));
+}
+
 }  // namespace testing
\ No newline at end of file
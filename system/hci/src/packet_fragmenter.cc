@@ -299,6 +299,15 @@ static void reassemble_and_dispatch_iso(UNUSED_ATTR BT_HDR* packet) {
         return;
       }
 
+      if (boundary_flag == HCI_ISO_BF_COMPLETE_PACKET) {
+        // The whole SDU is in this packet, hand it up in place
+        packet->layer_specific |= BT_ISO_HDR_OFFSET_POINTS_DATA;
+        packet->offset = iso_hdr_len + HCI_ISO_PREAMBLE_SIZE;
+        callbacks->reassembled(packet);
+        return;
+      }
+
+      // The fragments are copied in place into a buffer of the full SDU
       partial_packet =
           (BT_HDR*)buffer_allocator->alloc(iso_full_len + sizeof(BT_HDR));
       if (!partial_packet) {
@@ -318,14 +327,8 @@ static void reassemble_and_dispatch_iso(UNUSED_ATTR BT_HDR* packet) {
       STREAM_SKIP_UINT16(stream);  // skip the ISO handle
       UINT16_TO_STREAM(stream, iso_full_len - HCI_ISO_PREAMBLE_SIZE);
 
-      if (boundary_flag == HCI_ISO_BF_FIRST_FRAGMENTED_PACKET) {
-        partial_packet->offset = packet->len;
-        partial_iso_packets[handle] = partial_packet;
-      } else {
-        packet->layer_specific |= BT_ISO_HDR_OFFSET_POINTS_DATA;
-        partial_packet->offset = iso_hdr_len + HCI_ISO_PREAMBLE_SIZE;
-        callbacks->reassembled(partial_packet);
-      }
+      partial_packet->offset = packet->len;
+      partial_iso_packets[handle] = partial_packet;
 
       buffer_allocator->free(packet);
       break;
@@ -415,6 +415,8 @@ static void expect_packet_reassembled_iso(uint16_t event, BT_HDR* packet,
   }
 
   ASSERT_EQ(expected_data_length + hdr_size, length);
+  ASSERT_TRUE((packet->layer_specific & BT_ISO_HDR_OFFSET_POINTS_DATA) != 0);
+  ASSERT_EQ(HCI_ISO_PREAMBLE_SIZE + hdr_size, packet->offset);
 
   STREAM_TO_UINT16(packet_seq, data);
   ASSERT_EQ(packet_seq, expected_packet_seq);
@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "bt_common_types.h"
@@ -75,6 +76,20 @@ class AdvertisingTrackInfo {
   std::vector<uint8_t> scan_response;
 };
 
+/** A single advertising report, as delivered in a batch of scan results */
+struct ScanResult {
+  uint16_t event_type;
+  uint8_t addr_type;
+  RawAddress bda;
+  uint8_t primary_phy;
+  uint8_t secondary_phy;
+  uint8_t advertising_sid;
+  int8_t tx_power;
+  int8_t rssi;
+  uint16_t periodic_adv_int;
+  std::vector<uint8_t> adv_data;
+};
+
 /**
  * LE Scanning related callbacks invoked from from the Bluetooth native stack
  * All callbacks are invoked on the JNI thread
@@ -92,6 +107,17 @@ class ScanningCallbacks {
                             int8_t tx_power, int8_t rssi,
                             uint16_t periodic_adv_int,
                             std::vector<uint8_t> adv_data) = 0;
+  // Scan results accumulated by the stack and delivered at once. Implementers
+  // that can process a batch cheaper than each result alone should override
+  // this, by default each result is handed to OnScanResult in order.
+  virtual void OnScanResults(std::vector<ScanResult> results) {
+    for (auto& result : results) {
+      OnScanResult(result.event_type, result.addr_type, result.bda,
+                   result.primary_phy, result.secondary_phy,
+                   result.advertising_sid, result.tx_power, result.rssi,
+                   result.periodic_adv_int, std::move(result.adv_data));
+    }
+  }
   virtual void OnTrackAdvFoundLost(
       AdvertisingTrackInfo advertising_track_info) = 0;
   virtual void OnBatchScanReports(int client_if, int status, int report_format,
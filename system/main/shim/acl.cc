@@ -409,7 +409,7 @@ class ShimAclConnection {
                "Shim Acl was not properly disconnected handle:0x%04x", handle_);
   }
 
-  void EnqueuePacket(std::unique_ptr<packet::RawBuilder> packet) {
+  void EnqueuePacket(std::unique_ptr<packet::BasePacketBuilder> packet) {
     // TODO Handle queue size exceeds some threshold
     queue_.push(std::move(packet));
     RegisterEnqueue();
@@ -491,7 +491,7 @@ class ShimAclConnection {
   SendDataUpwards send_data_upwards_;
   hci::acl_manager::AclConnection::QueueUpEnd* queue_up_end_;
 
-  std::queue<std::unique_ptr<packet::RawBuilder>> queue_;
+  std::queue<std::unique_ptr<packet::BasePacketBuilder>> queue_;
   bool is_enqueue_registered_{false};
   bool is_disconnected_{false};
   CreationTime creation_time_;
@@ -877,8 +877,8 @@ struct shim::legacy::Acl::impl {
            handle_to_classic_connection_map_.end();
   }
 
-  void EnqueueClassicPacket(HciHandle handle,
-                            std::unique_ptr<packet::RawBuilder> packet) {
+  void EnqueueClassicPacket(
+      HciHandle handle, std::unique_ptr<packet::BasePacketBuilder> packet) {
     ASSERT_LOG(IsClassicAcl(handle), "handle %d is not a classic connection",
                handle);
     handle_to_classic_connection_map_[handle]->EnqueuePacket(std::move(packet));
@@ -890,7 +890,7 @@ struct shim::legacy::Acl::impl {
   }
 
   void EnqueueLePacket(HciHandle handle,
-                       std::unique_ptr<packet::RawBuilder> packet) {
+                       std::unique_ptr<packet::BasePacketBuilder> packet) {
     ASSERT_LOG(IsLeAcl(handle), "handle %d is not a LE connection", handle);
     handle_to_le_connection_map_[handle]->EnqueuePacket(std::move(packet));
   }
@@ -1451,7 +1451,7 @@ void shim::legacy::Acl::on_incoming_acl_credits(uint16_t handle,
 }
 
 void shim::legacy::Acl::write_data_sync(
-    HciHandle handle, std::unique_ptr<packet::RawBuilder> packet) {
+    HciHandle handle, std::unique_ptr<packet::BasePacketBuilder> packet) {
   if (pimpl_->IsClassicAcl(handle)) {
     pimpl_->EnqueueClassicPacket(handle, std::move(packet));
   } else if (pimpl_->IsLeAcl(handle)) {
@@ -1461,8 +1461,8 @@ void shim::legacy::Acl::write_data_sync(
   }
 }
 
-void shim::legacy::Acl::WriteData(HciHandle handle,
-                                  std::unique_ptr<packet::RawBuilder> packet) {
+void shim::legacy::Acl::WriteData(
+    HciHandle handle, std::unique_ptr<packet::BasePacketBuilder> packet) {
   handler_->Post(common::BindOnce(&Acl::write_data_sync,
                                   common::Unretained(this), handle,
                                   std::move(packet)));
@@ -25,7 +25,7 @@
 #include "gd/hci/address_with_type.h"
 #include "gd/hci/class_of_device.h"
 #include "gd/os/handler.h"
-#include "gd/packet/raw_builder.h"
+#include "gd/packet/base_packet_builder.h"
 #include "main/shim/acl_legacy_interface.h"
 #include "main/shim/link_connection_interface.h"
 #include "main/shim/link_policy_interface.h"
@@ -113,7 +113,7 @@ class Acl : public hci::acl_manager::ConnectionCallbacks,
                         uint16_t cont_num, uint16_t sup_tout);
 
   void WriteData(uint16_t hci_handle,
-                 std::unique_ptr<packet::RawBuilder> packet);
+                 std::unique_ptr<packet::BasePacketBuilder> packet);
 
   void Dump(int fd) const;
   void DumpConnectionHistory(int fd) const;
@@ -129,7 +129,7 @@ class Acl : public hci::acl_manager::ConnectionCallbacks,
  protected:
   void on_incoming_acl_credits(uint16_t handle, uint16_t credits);
   void write_data_sync(uint16_t hci_handle,
-                       std::unique_ptr<packet::RawBuilder> packet);
+                       std::unique_ptr<packet::BasePacketBuilder> packet);
 
  private:
   os::Handler* handler_;
@@ -19,11 +19,15 @@
  */
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include "hci/le_scanning_callback.h"
 #include "include/hardware/ble_scanner.h"
+#include "os/alarm.h"
 #include "types/ble_address_with_type.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
@@ -53,6 +57,13 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
   ~BleScannerInterfaceImpl() override{};
 
   void Init();
+  void Shutdown();
+
+  // Accumulate scan results for up to |window|, or until |max_results| are
+  // pending, before handing them to the JNI thread in a single batch. A zero
+  // window delivers each result as soon as it is received.
+  void SetScanResultBatching(std::chrono::milliseconds window,
+                             size_t max_results);
 
   // ::BleScannerInterface
   void RegisterScanner(const bluetooth::Uuid& uuid, RegisterCallback) override;
@@ -145,7 +156,18 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
           advertising_packet_content_filter_command,
       ApcfCommand apcf_command);
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
-                                std::vector<uint8_t> advertising_data);
+                                const std::vector<uint8_t>& advertising_data);
+  void flush_scan_results();
+  void deliver_scan_results(std::vector<::ScanResult> results,
+                            std::vector<tBLE_ADDR_TYPE> ble_addr_types);
+
+  // Scan results not yet handed to the JNI thread, with the address type
+  // resolved for each of them. Only accessed on the gd stack thread.
+  std::vector<::ScanResult> pending_scan_results_;
+  std::vector<tBLE_ADDR_TYPE> pending_ble_addr_types_;
+  std::chrono::milliseconds scan_result_batch_window_{0};
+  size_t scan_result_batch_max_results_ = 1;
+  std::unique_ptr<os::Alarm> scan_result_batch_alarm_;
 
   class AddressCache {
    public:
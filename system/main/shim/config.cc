@@ -18,6 +18,8 @@
 
 #include "main/shim/config.h"
 
+#include <stdio.h>
+
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
@@ -153,5 +155,15 @@ void BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {
 
 void BtifConfigInterface::Clear() { GetStorage()->Clear(); }
 
+void BtifConfigInterface::Dump(int fd) {
+  auto statistics = GetStorage()->GetSaveStatistics();
+  dprintf(fd, "  Config saves: %zu\n", statistics.num_saves);
+  dprintf(fd, "  Journal appends: %zu (%zu entries)\n",
+          statistics.num_journal_appends, statistics.num_journal_entries);
+  dprintf(fd, "  Config file compactions: %zu\n", statistics.num_compactions);
+  dprintf(fd, "  Last save: %zu entries in %zu sections\n",
+          statistics.last_save_entries, statistics.last_save_sections);
+}
+
 }  // namespace shim
 }  // namespace bluetooth
@@ -55,6 +55,8 @@ class BtifConfigInterface {
   static std::vector<std::string> GetPersistentDevices();
   static void ConvertEncryptOrDecryptKeyIfNeeded();
   static void Clear();
+  // Print the config save statistics to |fd|
+  static void Dump(int fd);
 };
 
 }  // namespace shim
@@ -18,6 +18,8 @@
 
 #include "main/shim/dumpsys.h"
 
+#include <algorithm>
+#include <cinttypes>
 #include <unordered_map>
 
 #include "main/shim/entry.h"
@@ -31,6 +33,28 @@ constexpr char kModuleName[] = "shim::legacy::dumpsys";
 static std::unordered_map<const void*, bluetooth::shim::DumpsysFunction>
     dumpsys_functions_;
 
+void DumpReactorStats(int fd, const bluetooth::os::Thread* thread) {
+  auto stats = thread->GetReactor()->GetStats();
+  // Worst offenders first
+  std::sort(stats.reactables.begin(), stats.reactables.end(),
+            [](const auto& a, const auto& b) {
+              return a.max_callback_duration > b.max_callback_duration;
+            });
+  dprintf(fd,
+          "%s %s reactor wakeups:%" PRIu64 " events:%" PRIu64
+          " max_events_per_wakeup:%d\n",
+          kModuleName, thread->GetThreadName().c_str(), stats.wakeup_count,
+          stats.event_count, stats.max_events_per_wakeup);
+  for (const auto& reactable : stats.reactables) {
+    dprintf(fd,
+            "%s   fd:%d dispatches:%" PRIu64 " total_us:%" PRId64
+            " max_us:%" PRId64 "\n",
+            kModuleName, reactable.fd, reactable.dispatch_count,
+            static_cast<int64_t>(reactable.total_callback_duration.count()),
+            static_cast<int64_t>(reactable.max_callback_duration.count()));
+  }
+}
+
 }  // namespace
 
 void bluetooth::shim::RegisterDumpsysFunction(const void* token,
@@ -56,6 +80,8 @@ void bluetooth::shim::Dump(int fd, const char** args) {
   }
   bluetooth::shim::Stack::GetInstance()->LockForDumpsys([=]() {
     if (bluetooth::shim::is_gd_stack_started_up()) {
+      DumpReactorStats(
+          fd, bluetooth::shim::Stack::GetInstance()->GetStackThread());
       if (bluetooth::shim::is_gd_dumpsys_module_started()) {
         bluetooth::shim::GetDumpsys()->Dump(fd, args);
       } else {
@@ -33,7 +33,8 @@
 #include "main/shim/stack.h"
 #include "osi/include/allocator.h"
 #include "osi/include/future.h"
-#include "packet/raw_builder.h"
+#include "packet/buffer.h"
+#include "packet/view_builder.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/hcimsgs.h"
@@ -278,20 +279,19 @@ bluetooth::common::BidiQueueEnd<bluetooth::hci::IsoBuilder,
     nullptr;
 static bluetooth::os::EnqueueBuffer<bluetooth::hci::AclBuilder>* pending_data =
     nullptr;
-static bluetooth::os::EnqueueBuffer<bluetooth::hci::IsoBuilder>*
+// Audio data is sent from the legacy threads without taking the buffer locks
+static bluetooth::os::MpscEnqueueBuffer<bluetooth::hci::IsoBuilder>*
     pending_iso_data = nullptr;
-static bluetooth::os::EnqueueBuffer<bluetooth::hci::ScoBuilder>*
+static bluetooth::os::MpscEnqueueBuffer<bluetooth::hci::ScoBuilder>*
     pending_sco_data = nullptr;
 
-static std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
+// The legacy buffer is released once the fragment is sent, so its payload is
+// copied once into a pooled buffer shared with the builder
+static std::unique_ptr<bluetooth::packet::ViewBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
-
-  return payload;
+  auto buffer = bluetooth::packet::Buffer::Create(data, len);
+  return std::make_unique<bluetooth::packet::ViewBuilder>(
+      bluetooth::packet::View(std::move(buffer), 0, len));
 }
 
 static BT_HDR* WrapPacketAndCopy(
@@ -303,7 +303,7 @@ static BT_HDR* WrapPacketAndCopy(
   packet->len = data->size();
   packet->layer_specific = 0;
   packet->event = event;
-  std::copy(data->begin(), data->end(), packet->data);
+  data->CopyTo(packet->data);
   return packet;
 }
 
@@ -413,13 +413,12 @@ static void transmit_sco_fragment(const uint8_t* stream, size_t length) {
   // skip data total length
   stream += 1;
   length -= 1;
-  auto payload = std::vector<uint8_t>(stream, stream + length);
+  // The SCO payload is a field of the builder, it is copied once into it
   auto sco_packet = bluetooth::hci::ScoBuilder::Create(
       handle, bluetooth::hci::PacketStatusFlag::CORRECTLY_RECEIVED,
-      std::move(payload));
+      std::vector<uint8_t>(stream, stream + length));
 
-  pending_sco_data->Enqueue(std::move(sco_packet),
-                            bluetooth::shim::GetGdShimHandler());
+  pending_sco_data->Enqueue(std::move(sco_packet));
 }
 
 static void transmit_iso_fragment(const uint8_t* stream, size_t length) {
@@ -440,8 +439,7 @@ static void transmit_iso_fragment(const uint8_t* stream, size_t length) {
   auto iso_packet = bluetooth::hci::IsoBuilder::Create(handle, pb_flag, ts_flag,
                                                        std::move(payload));
 
-  pending_iso_data->Enqueue(std::move(iso_packet),
-                            bluetooth::shim::GetGdShimHandler());
+  pending_iso_data->Enqueue(std::move(iso_packet));
 }
 
 static void register_event(bluetooth::hci::EventCode event_code) {
@@ -496,8 +494,8 @@ static void register_for_sco() {
       bluetooth::shim::GetGdShimHandler(),
       bluetooth::common::Bind(sco_data_callback));
   pending_sco_data =
-      new bluetooth::os::EnqueueBuffer<bluetooth::hci::ScoBuilder>(
-          hci_sco_queue_end);
+      new bluetooth::os::MpscEnqueueBuffer<bluetooth::hci::ScoBuilder>(
+          hci_sco_queue_end, bluetooth::shim::GetGdShimHandler());
 }
 
 static void register_for_iso() {
@@ -506,8 +504,8 @@ static void register_for_iso() {
       bluetooth::shim::GetGdShimHandler(),
       bluetooth::common::Bind(iso_data_callback));
   pending_iso_data =
-      new bluetooth::os::EnqueueBuffer<bluetooth::hci::IsoBuilder>(
-          hci_iso_queue_end);
+      new bluetooth::os::MpscEnqueueBuffer<bluetooth::hci::IsoBuilder>(
+          hci_iso_queue_end, bluetooth::shim::GetGdShimHandler());
 }
 
 static void on_shutting_down() {
@@ -16,7 +16,8 @@
 #pragma once
 
 #include "gd/common/init_flags.h"
-#include "gd/packet/raw_builder.h"
+#include "gd/packet/bit_inserter.h"
+#include "gd/packet/packet_builder.h"
 #include "hci/address_with_type.h"
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
@@ -105,27 +106,39 @@ inline tBLE_BD_ADDR ToLegacyAddressWithType(
   return legacy_address_with_type;
 }
 
-inline std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
-    const uint8_t* data, size_t len, bool is_flushable) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
-  payload->SetFlushable(is_flushable);
-  return payload;
-}
+// Serializes the payload of a legacy BT_HDR in place, so that it is handed to
+// the gd queues without a copy. The builder owns the BT_HDR and frees it.
+class BtHdrPacketBuilder : public bluetooth::packet::PacketBuilder<true> {
+ public:
+  // The first |skip| bytes of the payload are left out, e.g. the HCI preamble
+  BtHdrPacketBuilder(BT_HDR* p_buf, size_t skip) : p_buf_(p_buf), skip_(skip) {
+    ASSERT(p_buf_->len >= skip_);
+  }
+  BtHdrPacketBuilder(const BtHdrPacketBuilder&) = delete;
+  BtHdrPacketBuilder& operator=(const BtHdrPacketBuilder&) = delete;
+  ~BtHdrPacketBuilder() override { osi_free(p_buf_); }
+
+  size_t size() const override { return p_buf_->len - skip_; }
+
+  void Serialize(bluetooth::packet::BitInserter& it) const override {
+    it.insert_bytes(p_buf_->data + p_buf_->offset + skip_, size());
+  }
+
+ private:
+  BT_HDR* p_buf_;
+  size_t skip_;
+};
 
+// The gd packet is copied once, straight after the |preamble| of the BT_HDR
 inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
     const std::vector<uint8_t>& preamble) {
-  std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
   BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
+      osi_calloc(packet->size() + preamble.size() + sizeof(BT_HDR)));
   std::copy(preamble.begin(), preamble.end(), buffer->data);
-  std::copy(packet_vector.begin(), packet_vector.end(),
-            buffer->data + preamble.size());
-  buffer->len = preamble.size() + packet_vector.size();
+  packet->CopyTo(buffer->data + preamble.size());
+  buffer->len = preamble.size() + packet->size();
   return buffer;
 }
 
@@ -250,6 +263,15 @@ inline bool IsPacketFlushable(const BT_HDR* p_buf) {
   return ToPacketData<const HciDataPreamble>(p_buf)->IsFlushable();
 }
 
+// Takes ownership of |p_buf|
+inline std::unique_ptr<BtHdrPacketBuilder> MakeBtHdrPacket(BT_HDR* p_buf,
+                                                           size_t skip = 0) {
+  bool is_flushable = IsPacketFlushable(p_buf);
+  auto packet = std::make_unique<BtHdrPacketBuilder>(p_buf, skip);
+  packet->SetFlushable(is_flushable);
+  return packet;
+}
+
 namespace debug {
 
 inline void DumpBtHdr(const BT_HDR* p_buf, const char* token) {
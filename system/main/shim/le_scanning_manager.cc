@@ -24,10 +24,12 @@
 #include <hardware/bluetooth.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "advertise_data_parser.h"
 #include "btif/include/btif_common.h"
+#include "common/bind.h"
 #include "hci/address.h"
 #include "hci/le_scanning_manager.h"
 #include "hci/msft.h"
@@ -38,6 +40,7 @@
 #include "main/shim/helpers.h"
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
+#include "os/system_properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/btm_log_history.h"
 #include "storage/device.h"
@@ -62,6 +65,11 @@ constexpr uint8_t kFilterLogicAnd = 0x01;
 constexpr uint8_t kLowestRssiValue = 129;
 constexpr uint16_t kAllowAllFilter = 0x00;
 constexpr uint16_t kListLogicOr = 0x01;
+constexpr char kScanResultBatchWindowProperty[] =
+    "bluetooth.core.le.scan_result_batch_window_ms";
+constexpr char kScanResultBatchMaxResultsProperty[] =
+    "bluetooth.core.le.scan_result_batch_max_results";
+constexpr uint32_t kDefaultScanResultBatchMaxResults = 32;
 
 class DefaultScanningCallback : public ::ScanningCallbacks {
   void OnScannerRegistered(const bluetooth::Uuid app_uuid, uint8_t scanner_id,
@@ -135,7 +143,7 @@ extern void btif_dm_update_ble_remote_properties(const RawAddress& bd_addr,
 void btm_ble_process_adv_addr(RawAddress& raw_address,
                               tBLE_ADDR_TYPE* address_type);
 
-extern bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
+extern bool btm_ble_get_appearance_as_cod(AdvertiseDataIndex const& data,
                                           DEV_CLASS dev_class);
 
 using bluetooth::shim::BleScannerInterfaceImpl;
@@ -147,6 +155,40 @@ void BleScannerInterfaceImpl::Init() {
   if (bluetooth::shim::GetMsftExtensionManager()) {
     bluetooth::shim::GetMsftExtensionManager()->SetScanningCallback(this);
   }
+
+  scan_result_batch_alarm_ = std::make_unique<bluetooth::os::Alarm>(
+      bluetooth::shim::GetGdShimHandler());
+  SetScanResultBatching(
+      std::chrono::milliseconds(bluetooth::os::GetSystemPropertyUint32(
+          kScanResultBatchWindowProperty, 0)),
+      bluetooth::os::GetSystemPropertyUint32(
+          kScanResultBatchMaxResultsProperty,
+          kDefaultScanResultBatchMaxResults));
+}
+
+void BleScannerInterfaceImpl::Shutdown() {
+  scan_result_batch_alarm_.reset();
+  pending_scan_results_.clear();
+  pending_ble_addr_types_.clear();
+}
+
+void BleScannerInterfaceImpl::SetScanResultBatching(
+    std::chrono::milliseconds window, size_t max_results) {
+  bluetooth::shim::GetGdShimHandler()->Post(bluetooth::common::BindOnce(
+      [](BleScannerInterfaceImpl* impl, std::chrono::milliseconds window,
+         size_t max_results) {
+        LOG_INFO("Scan results batched for %d ms, up to %zu results",
+                 static_cast<int>(window.count()), max_results);
+        impl->flush_scan_results();
+        impl->scan_result_batch_window_ = window;
+        impl->scan_result_batch_max_results_ =
+            window.count() > 0 ? std::max<size_t>(max_results, 1) : 1;
+        impl->pending_scan_results_.reserve(
+            impl->scan_result_batch_max_results_);
+        impl->pending_ble_addr_types_.reserve(
+            impl->scan_result_batch_max_results_);
+      },
+      this, window, max_results));
 }
 
 /** Registers a scanner with the stack */
@@ -515,25 +557,74 @@ void BleScannerInterfaceImpl::OnScanResult(
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
   }
 
-  do_in_jni_thread(
-      FROM_HERE,
-      base::BindOnce(&BleScannerInterfaceImpl::handle_remote_properties,
-                     base::Unretained(this), raw_address, ble_addr_type,
-                     advertising_data));
-
-  do_in_jni_thread(
-      FROM_HERE,
-      base::BindOnce(&ScanningCallbacks::OnScanResult,
-                     base::Unretained(scanning_callbacks_), event_type,
-                     static_cast<uint8_t>(address_type), raw_address,
-                     primary_phy, secondary_phy, advertising_sid, tx_power,
-                     rssi, periodic_advertising_interval, advertising_data));
-
   // TODO: Remove when StartInquiry in GD part implemented
   btm_ble_process_adv_pkt_cont_for_inquiry(
       event_type, ble_addr_type, raw_address, primary_phy, secondary_phy,
       advertising_sid, tx_power, rssi, periodic_advertising_interval,
       advertising_data);
+
+  pending_scan_results_.push_back({
+      .event_type = event_type,
+      .addr_type = static_cast<uint8_t>(address_type),
+      .bda = raw_address,
+      .primary_phy = primary_phy,
+      .secondary_phy = secondary_phy,
+      .advertising_sid = advertising_sid,
+      .tx_power = tx_power,
+      .rssi = rssi,
+      .periodic_adv_int = periodic_advertising_interval,
+      .adv_data = std::move(advertising_data),
+  });
+  pending_ble_addr_types_.push_back(ble_addr_type);
+
+  if (pending_scan_results_.size() >= scan_result_batch_max_results_) {
+    flush_scan_results();
+  } else if (pending_scan_results_.size() == 1) {
+    scan_result_batch_alarm_->Schedule(
+        bluetooth::common::BindOnce(
+            &BleScannerInterfaceImpl::flush_scan_results,
+            bluetooth::common::Unretained(this)),
+        scan_result_batch_window_);
+  }
+}
+
+void BleScannerInterfaceImpl::flush_scan_results() {
+  scan_result_batch_alarm_->Cancel();
+  if (pending_scan_results_.empty()) {
+    return;
+  }
+
+  std::vector<::ScanResult> results;
+  std::vector<tBLE_ADDR_TYPE> ble_addr_types;
+  results.reserve(scan_result_batch_max_results_);
+  ble_addr_types.reserve(scan_result_batch_max_results_);
+  results.swap(pending_scan_results_);
+  ble_addr_types.swap(pending_ble_addr_types_);
+
+  do_in_jni_thread(
+      FROM_HERE,
+      base::BindOnce(&BleScannerInterfaceImpl::deliver_scan_results,
+                     base::Unretained(this), std::move(results),
+                     std::move(ble_addr_types)));
+}
+
+void BleScannerInterfaceImpl::deliver_scan_results(
+    std::vector<::ScanResult> results,
+    std::vector<tBLE_ADDR_TYPE> ble_addr_types) {
+  for (size_t i = 0; i < results.size(); i++) {
+    handle_remote_properties(results[i].bda, ble_addr_types[i],
+                             results[i].adv_data);
+  }
+
+  if (results.size() == 1) {
+    auto& result = results.front();
+    scanning_callbacks_->OnScanResult(
+        result.event_type, result.addr_type, result.bda, result.primary_phy,
+        result.secondary_phy, result.advertising_sid, result.tx_power,
+        result.rssi, result.periodic_adv_int, std::move(result.adv_data));
+  } else {
+    scanning_callbacks_->OnScanResults(std::move(results));
+  }
 }
 
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
@@ -737,7 +828,7 @@ bool BleScannerInterfaceImpl::parse_filter_command(
 
 void BleScannerInterfaceImpl::handle_remote_properties(
     RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
-    std::vector<uint8_t> advertising_data) {
+    const std::vector<uint8_t>& advertising_data) {
   if (!bluetooth::shim::is_gd_stack_started_up()) {
     LOG_WARN("Gd stack is stopped, return");
     return;
@@ -748,10 +839,12 @@ void BleScannerInterfaceImpl::handle_remote_properties(
     return;
   }
 
+  const AdvertiseDataIndex advertising_data_index(advertising_data);
+
   auto device_type = bluetooth::hci::DeviceType::LE;
   uint8_t flag_len;
-  const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-      advertising_data, BTM_BLE_AD_TYPE_FLAG, &flag_len);
+  const uint8_t* p_flag =
+      advertising_data_index.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &flag_len);
 
   if (p_flag != NULL && flag_len != 0) {
     if ((BTM_BLE_BREDR_NOT_SPT & *p_flag) == 0) {
@@ -760,12 +853,12 @@ void BleScannerInterfaceImpl::handle_remote_properties(
   }
 
   uint8_t remote_name_len;
-  const uint8_t* p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-      advertising_data, HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  const uint8_t* p_eir_remote_name = advertising_data_index.GetFieldByType(
+      HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
 
   if (p_eir_remote_name == NULL) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        advertising_data, HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+    p_eir_remote_name = advertising_data_index.GetFieldByType(
+        HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
   }
 
   bt_bdname_t bdname = {0};
@@ -794,7 +887,7 @@ void BleScannerInterfaceImpl::handle_remote_properties(
   }
 
   DEV_CLASS dev_class;
-  if (btm_ble_get_appearance_as_cod(advertising_data, dev_class)) {
+  if (btm_ble_get_appearance_as_cod(advertising_data_index, dev_class)) {
     btif_dm_update_ble_remote_properties(bd_addr, bdname.name, dev_class,
                                          device_type);
   }
@@ -852,6 +945,12 @@ void bluetooth::shim::init_scanning_manager() {
       ->Init();
 }
 
+void bluetooth::shim::shutdown_scanning_manager() {
+  if (bt_le_scanner_instance != nullptr) {
+    bt_le_scanner_instance->Shutdown();
+  }
+}
+
 bool bluetooth::shim::is_ad_type_filter_supported() {
   return bluetooth::shim::GetScanning()->IsAdTypeFilterSupported();
 }
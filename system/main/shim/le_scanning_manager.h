@@ -26,6 +26,7 @@ namespace shim {
 
 ::BleScannerInterface* get_ble_scanner_instance();
 void init_scanning_manager();
+void shutdown_scanning_manager();
 bool is_ad_type_filter_supported();
 void set_ad_type_rsi_filter(bool enable);
 void set_empty_filter(bool enable);
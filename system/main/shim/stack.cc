@@ -191,6 +191,10 @@ void Stack::Stop() {
 
   stack_manager_.ShutDown();
 
+  // No more scan results once the modules are stopped, release the alarm
+  // batching them while the handler it was created on still exists.
+  bluetooth::shim::shutdown_scanning_manager();
+
   delete stack_handler_;
   stack_handler_ = nullptr;
 
@@ -244,6 +248,12 @@ os::Handler* Stack::GetHandler() {
   return stack_handler_;
 }
 
+os::Thread* Stack::GetStackThread() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ASSERT(is_running_);
+  return stack_thread_;
+}
+
 bool Stack::IsDumpsysModuleStarted() const {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   return GetStackManager()->IsStarted<Dumpsys>();
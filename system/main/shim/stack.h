@@ -58,6 +58,7 @@ class Stack {
 
   Btm* GetBtm();
   os::Handler* GetHandler();
+  os::Thread* GetStackThread();
 
   void LockForDumpsys(std::function<void()> dumpsys_callback);
 
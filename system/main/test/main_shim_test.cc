@@ -596,6 +596,29 @@ TEST_F(MainShimTest, is_flushable) {
   }
 }
 
+TEST_F(MainShimTest, bt_hdr_packet_builder) {
+  const std::vector<uint8_t> payload = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+  const size_t offset = 8;
+  BT_HDR* bt_hdr = static_cast<BT_HDR*>(osi_calloc(
+      sizeof(BT_HDR) + offset + HCI_DATA_PREAMBLE_SIZE + payload.size()));
+  bt_hdr->offset = offset;
+  bt_hdr->len = HCI_DATA_PREAMBLE_SIZE + payload.size();
+  HciDataPreamble* hci = ToPacketData<HciDataPreamble>(bt_hdr);
+  hci->SetFlushable();
+  std::copy(payload.begin(), payload.end(),
+            ToPacketData<uint8_t>(bt_hdr, HCI_DATA_PREAMBLE_SIZE));
+
+  // Owns and frees the BT_HDR, serializes its payload without the preamble
+  auto packet = MakeBtHdrPacket(bt_hdr, HCI_DATA_PREAMBLE_SIZE);
+  ASSERT_TRUE(packet->IsFlushable());
+  ASSERT_EQ(payload.size(), packet->size());
+
+  std::vector<uint8_t> bytes;
+  bluetooth::packet::BitInserter it(bytes);
+  packet->Serialize(it);
+  ASSERT_EQ(payload, bytes);
+}
+
 TEST_F(MainShimTest, BleScannerInterfaceImpl_nop) {
   auto* ble = static_cast<bluetooth::shim::BleScannerInterfaceImpl*>(
       bluetooth::shim::get_ble_scanner_instance());
@@ -664,7 +687,7 @@ TEST_F(MainShimTest, DISABLED_BleScannerInterfaceImpl_OnScanResult) {
                       periodic_advertising_interval, advertising_data);
   }
 
-  ASSERT_EQ(2 * 2048UL, do_in_jni_thread_task_queue.size());
+  ASSERT_EQ(2048UL, do_in_jni_thread_task_queue.size());
   ASSERT_EQ(0, get_func_call_count("btm_ble_process_adv_addr"));
 
   run_all_jni_thread_task();
@@ -79,6 +79,12 @@ void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data);
 
+// Allows the callback of |alarm| to run up to |slack_ms| after its deadline,
+// so that alarms expiring around the same time are dispatched in a single
+// wakeup. The slack is kept for the following |alarm_set| and
+// |alarm_set_on_mloop| calls, it is 0 by default. |alarm| may not be NULL.
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms);
+
 // This function cancels the |alarm| if it was previously set.
 // When this call returns, the caller has a guarantee that the
 // callback is not in progress and will not be called if it
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size class pools backing |osi_malloc| and |osi_calloc| for the buffer sizes
+// allocated at high rates on the data paths (BT_HDR of the common HCI and
+// L2CAP sizes). Blocks are carved out of slabs of a reserved memory region,
+// each slab holding blocks of a single size class, and are cached per thread
+// so that most allocations and frees don't take a lock.
+
+// Route the allocations of |osi_malloc| and |osi_calloc| to the pools, or back
+// to the system heap. Blocks allocated from the pools are returned to them
+// when freed whether the pools are enabled or not, so this can be switched at
+// any time.
+void buffer_pool_set_enabled(bool enabled);
+bool buffer_pool_is_enabled(void);
+
+// Return a block of at least |size| bytes, or NULL if the pools are disabled,
+// |size| is bigger than the biggest size class or the pools are exhausted.
+void* buffer_pool_alloc(size_t size);
+
+// Return the block at |ptr| to its pool. Return false if |ptr| wasn't allocated
+// by |buffer_pool_alloc|, the caller must then free it.
+bool buffer_pool_free(void* ptr);
+
+// Dump the pool statistics to the |fd| file descriptor.
+void buffer_pool_debug_dump(int fd);
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A bounded queue of pointers for any number of producer threads and a single
+// consumer thread, as a lock-free alternative to |fixed_queue_t| where the
+// queue is on a hot path. Elements are stored in a ring buffer allocated with
+// the queue, so enqueuing doesn't allocate, and the consumer is only woken up
+// when the queue goes from empty to non-empty.
+//
+// Unlike |fixed_queue_t|, enqueuing never blocks and elements can only be
+// taken from the front of the queue.
+
+struct ring_queue_t;
+typedef struct ring_queue_t ring_queue_t;
+typedef struct reactor_t reactor_t;
+
+typedef void (*ring_queue_free_cb)(void* data);
+typedef void (*ring_queue_cb)(ring_queue_t* queue, void* context);
+
+// Creates a new ring queue holding at least |capacity| elements, |capacity| is
+// rounded up to the next power of two. Returns NULL on failure. The caller
+// must free the returned queue with |ring_queue_free|.
+ring_queue_t* ring_queue_new(size_t capacity);
+
+// Frees a queue and (optionally) the enqueued elements. If the |free_cb|
+// callback is not null, it is called on each queue element to free it. The
+// queue must not be in use by any other thread.
+void ring_queue_free(ring_queue_t* queue, ring_queue_free_cb free_cb);
+
+// Returns a value indicating whether the given |queue| is empty. If |queue|
+// is NULL, the return value is true.
+bool ring_queue_is_empty(ring_queue_t* queue);
+
+// Returns the length of the |queue|. If |queue| is NULL, the return value
+// is 0.
+size_t ring_queue_length(ring_queue_t* queue);
+
+// Returns the maximum number of elements this queue may hold. |queue| may
+// not be NULL.
+size_t ring_queue_capacity(ring_queue_t* queue);
+
+// Tries to enqueue |data| into the |queue|, may be called from any thread.
+// This function will never block the caller. Returns false if the queue is
+// full. Neither |queue| nor |data| may be NULL.
+bool ring_queue_try_enqueue(ring_queue_t* queue, void* data);
+
+// Tries to dequeue an element from |queue|, must only be called from the
+// consumer thread. This function will never block the caller. If the queue is
+// empty or NULL, this function returns NULL immediately.
+void* ring_queue_try_dequeue(ring_queue_t* queue);
+
+// Dequeues the next element from |queue|, must only be called from the
+// consumer thread. If the queue is currently empty, this function will block
+// the caller until an item is enqueued. This function will never return NULL.
+// |queue| may not be NULL.
+void* ring_queue_dequeue(ring_queue_t* queue);
+
+// Registers |queue| with |reactor| for dequeue operations, the reactor thread
+// becomes the consumer thread. When there are elements in the queue,
+// |ready_cb| is called once for each of them, and is expected to dequeue one
+// element. The |context| parameter is passed, untouched, to the callback
+// routine. Neither |queue|, nor |reactor|, nor |ready_cb| may be NULL.
+// |context| may be NULL.
+void ring_queue_register_dequeue(ring_queue_t* queue, reactor_t* reactor,
+                                 ring_queue_cb ready_cb, void* context);
+
+// Unregisters the dequeue ready callback for |queue| from whichever reactor
+// it is registered with, if any. This function is idempotent.
+void ring_queue_unregister_dequeue(ring_queue_t* queue);
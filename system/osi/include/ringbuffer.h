@@ -18,10 +18,19 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct ringbuffer_t ringbuffer_t;
 
+// A region of the ringbuffer, made of up to two contiguous segments: the
+// second segment starts at the beginning of the buffer and is only used when
+// the region wraps around its end. Unused segments have a length of 0.
+typedef struct {
+  uint8_t* data[2];
+  size_t length[2];
+} ringbuffer_span_t;
+
 // NOTE:
 // None of the functions below are thread safe when it comes to accessing the
 // *rb pointer. It is *NOT* possible to insert and pop/delete at the same time.
@@ -60,3 +69,24 @@ size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length);
 // Deletes |length| bytes from the ringbuffer starting from the head
 // Return actual number of bytes deleted.
 size_t ringbuffer_delete(ringbuffer_t* rb, size_t length);
+
+// Sets |span| to up to |length| bytes of free space following the data in
+// the buffer, so that it can be written to directly instead of through
+// |ringbuffer_insert|. Returns the size of the region, which can be less than
+// |length| if the buffer is almost full. The bytes written are only added to
+// the buffer by |ringbuffer_commit|.
+size_t ringbuffer_reserve(ringbuffer_t* rb, size_t length,
+                          ringbuffer_span_t* span);
+
+// Adds the first |length| bytes of the region returned by |ringbuffer_reserve|
+// to the buffer. Returns the actual number of bytes added, which can be less
+// than |length| if the buffer is full.
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length);
+
+// Sets |span| to up to |length| bytes of data from the head of the buffer, so
+// that it can be read directly instead of through |ringbuffer_peek|. Returns
+// the size of the region, which can be less than |length| if there is less
+// data in the buffer. The region stays valid until it is consumed with
+// |ringbuffer_delete|.
+size_t ringbuffer_peek_span(const ringbuffer_t* rb, size_t length,
+                            ringbuffer_span_t* span);
@@ -18,3 +18,9 @@
 
 bool thread_scheduler_enable_real_time(pid_t pid);
 bool thread_scheduler_get_priority_range(int& min, int& max);
+
+// Applies the policy configured for |thread_name| (see gd/os/thread_policy.h)
+// to |linux_tid|, with |real_time_priority| as the SCHED_FIFO priority if the
+// policy doesn't set one. 0 keeps the default policy of the thread.
+bool thread_scheduler_apply_policy(pid_t linux_tid, const char* thread_name,
+                                   int real_time_priority);
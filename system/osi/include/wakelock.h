@@ -20,6 +20,7 @@
 
 #include <hardware/bluetooth.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Set the Bluetooth OS callouts to |callouts|.
 // This function should be called when native kernel wakelocks are not used
@@ -27,15 +28,18 @@
 // kernel wakelocks will be used.
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts);
 
-// Acquire the Bluetooth wakelock.
-// The function is thread safe.
+// Acquire the Bluetooth wakelock on behalf of |owner|.
+// The wakelock is held as long as one owner holds it, acquiring it again for
+// the same owner has no effect. The function is thread safe.
 // Return true on success, otherwise false.
-bool wakelock_acquire(void);
+bool wakelock_acquire(const char* owner);
 
-// Release the Bluetooth wakelock.
+// Release the Bluetooth wakelock on behalf of |owner|.
+// Once no owner holds it, the wakelock is released after a short delay, so
+// that the bursts of acquire and release do not reach the OS.
 // The function is thread safe.
 // Return true on success, otherwise false.
-bool wakelock_release(void);
+bool wakelock_release(const char* owner);
 
 // Cleanup the wakelock internal state.
 // This function should be called by the OSI module cleanup during
@@ -49,6 +53,11 @@ void wakelock_cleanup(void);
 // If |lock_path| or |unlock_path| are NULL, that path is not changed.
 void wakelock_set_paths(const char* lock_path, const char* unlock_path);
 
+// This function should not need to be called normally.
+// Set the delay between the release of the last owner and the release of the
+// wakelock to |delay_ms|, 0 releases it immediately.
+void wakelock_set_release_delay(uint64_t delay_ms);
+
 // Dump wakelock-related debug info to the |fd| file descriptor.
 // The caller is responsible for closing the |fd|.
 void wakelock_debug_dump(int fd);
@@ -35,12 +35,13 @@
 
 #include <hardware/bluetooth.h>
 
+#include <algorithm>
 #include <mutex>
+#include <vector>
 
 #include "check.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/thread.h"
@@ -96,6 +97,9 @@ struct alarm_t {
   uint64_t deadline_ms;
   uint64_t prev_deadline_ms;  // Previous deadline - used for accounting of
                               // periodic timers
+  uint64_t slack_ms;  // How late the callback may run, see |alarm_set_slack|
+  size_t heap_index;  // Position in |alarms| while pending, or kNotPending
+  uint64_t heap_sequence;  // Orders the alarms with the same deadline
   bool is_periodic;
   fixed_queue_t* queue;  // The processing queue to add this alarm to
   alarm_callback_t callback;
@@ -112,15 +116,35 @@ struct alarm_t {
 // unit tests to run faster. It should not be modified by production code.
 int64_t TIMER_INTERVAL_FOR_WAKELOCK_IN_MS = 3000;
 static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
+static const char* WAKELOCK_OWNER = "alarm";
+
+static const size_t kNotPending = SIZE_MAX;
+
+// Values of |timer_armed_ms| and |wakeup_timer_armed_ms| besides deadlines
+static const uint64_t kTimerDisarmed = 0;
+static const uint64_t kTimerEndOfTime = UINT64_MAX - 1;
+static const uint64_t kTimerUnknown = UINT64_MAX;
 
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| heap.
 static std::mutex alarms_mutex;
-static list_t* alarms;
+// Pending alarms, as a binary min-heap ordered by deadline
+static std::vector<alarm_t*>* alarms;
+static uint64_t next_heap_sequence;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
+// The times |timer| and |wakeup_timer| are armed for, so that they are only
+// reprogrammed when the next expiration changes
+static uint64_t timer_armed_ms;
+static uint64_t wakeup_timer_armed_ms;
+
+// Wakeup statistics
+static size_t dispatcher_wakeup_count;
+static size_t dispatched_alarm_count;
+static size_t timer_update_count;
+static size_t timer_update_skipped_count;
 
 // All alarm callbacks are dispatched from |dispatcher_thread|
 static thread_t* dispatcher_thread;
@@ -139,6 +163,9 @@ static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
                                fixed_queue_t* queue, bool for_msg_loop);
 static void alarm_cancel_internal(alarm_t* alarm);
 static void remove_pending_alarm(alarm_t* alarm);
+static void pending_alarms_insert(alarm_t* alarm);
+static void pending_alarms_remove(alarm_t* alarm);
+static alarm_t* pending_alarms_front(void);
 static void schedule_next_instance(alarm_t* alarm);
 static void reschedule_root_alarm(void);
 static void alarm_queue_ready(fixed_queue_t* queue, void* context);
@@ -176,6 +203,7 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
   std::shared_ptr<std::recursive_mutex> ptr(new std::recursive_mutex());
   ret->callback_mutex = ptr;
   ret->is_periodic = is_periodic;
+  ret->heap_index = kNotPending;
   ret->stats.name = osi_strdup(name);
 
   ret->for_msg_loop = false;
@@ -242,6 +270,15 @@ static void alarm_set_internal(alarm_t* alarm, uint64_t period_ms,
   alarm->stats.scheduled_count++;
 }
 
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms) {
+  CHECK(alarms != NULL);
+  CHECK(alarm != NULL);
+
+  std::lock_guard<std::mutex> lock(alarms_mutex);
+  alarm->slack_ms = slack_ms;
+  if (alarm->heap_index != kNotPending) reschedule_root_alarm();
+}
+
 void alarm_cancel(alarm_t* alarm) {
   CHECK(alarms != NULL);
   if (!alarm) return;
@@ -260,8 +297,7 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = alarm->heap_index != kNotPending;
 
   remove_pending_alarm(alarm);
 
@@ -301,7 +337,7 @@ void alarm_cleanup(void) {
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
 }
 
@@ -315,14 +351,12 @@ static bool lazy_initialize(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  alarms = list_new(NULL);
-  if (!alarms) {
-    LOG_ERROR("%s unable to allocate alarm list.", __func__);
-    goto error;
-  }
+  alarms = new std::vector<alarm_t*>();
 
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
+  timer_set = false;
+  timer_armed_ms = kTimerDisarmed;
 
   if (!timer_create_internal(CLOCK_BOOTTIME_ALARM, &wakeup_timer)) {
     if (!timer_create_internal(CLOCK_BOOTTIME, &wakeup_timer)) {
@@ -330,6 +364,7 @@ static bool lazy_initialize(void) {
     }
   }
   wakeup_timer_initialized = true;
+  wakeup_timer_armed_ms = kTimerDisarmed;
 
   alarm_expired = semaphore_new(0);
   if (!alarm_expired) {
@@ -380,7 +415,7 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
-  list_free(alarms);
+  delete alarms;
   alarms = NULL;
 
   return false;
@@ -398,10 +433,100 @@ static uint64_t now_ms(void) {
   return (ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL);
 }
 
+// Returns whether |a| expires before |b|. Alarms with the same deadline expire
+// in the order they were set.
+static bool alarm_precedes(const alarm_t* a, const alarm_t* b) {
+  if (a->deadline_ms != b->deadline_ms) return a->deadline_ms < b->deadline_ms;
+  return a->heap_sequence < b->heap_sequence;
+}
+
+static void heap_place(size_t index, alarm_t* alarm) {
+  (*alarms)[index] = alarm;
+  alarm->heap_index = index;
+}
+
+static void heap_sift_up(size_t index) {
+  alarm_t* alarm = (*alarms)[index];
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!alarm_precedes(alarm, (*alarms)[parent])) break;
+    heap_place(index, (*alarms)[parent]);
+    index = parent;
+  }
+  heap_place(index, alarm);
+}
+
+static void heap_sift_down(size_t index) {
+  alarm_t* alarm = (*alarms)[index];
+  const size_t size = alarms->size();
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size) break;
+    if (child + 1 < size &&
+        alarm_precedes((*alarms)[child + 1], (*alarms)[child])) {
+      child++;
+    }
+    if (!alarm_precedes((*alarms)[child], alarm)) break;
+    heap_place(index, (*alarms)[child]);
+    index = child;
+  }
+  heap_place(index, alarm);
+}
+
+// The pending alarms functions must be called with |alarms_mutex| held
+static void pending_alarms_insert(alarm_t* alarm) {
+  CHECK(alarm->heap_index == kNotPending);
+
+  alarm->heap_sequence = next_heap_sequence++;
+  alarms->push_back(alarm);
+  heap_sift_up(alarms->size() - 1);
+}
+
+static void pending_alarms_remove(alarm_t* alarm) {
+  size_t index = alarm->heap_index;
+  if (index == kNotPending) return;
+
+  alarm->heap_index = kNotPending;
+  alarm_t* last = alarms->back();
+  alarms->pop_back();
+  if (last == alarm) return;
+
+  heap_place(index, last);
+  heap_sift_up(index);
+  heap_sift_down(last->heap_index);
+}
+
+static alarm_t* pending_alarms_front(void) {
+  return alarms->empty() ? NULL : alarms->front();
+}
+
+// Lowers |fire_ms| to the deadline plus slack of the alarms in the subtree of
+// the heap at |index|. The deadlines only grow down the heap, so the subtrees
+// of the alarms with a deadline after |fire_ms| are skipped.
+static void lower_fire_time(size_t index, uint64_t* fire_ms) {
+  if (index >= alarms->size()) return;
+
+  const alarm_t* alarm = (*alarms)[index];
+  if (alarm->deadline_ms >= *fire_ms) return;
+  *fire_ms = std::min(*fire_ms, alarm->deadline_ms + alarm->slack_ms);
+  lower_fire_time(2 * index + 1, fire_ms);
+  lower_fire_time(2 * index + 2, fire_ms);
+}
+
+// Returns the latest time to wake up at so that no pending alarm runs later
+// than its deadline plus its slack. Waking up then dispatches together all
+// the alarms that are due.
+// Must be called with |alarms_mutex| held
+static uint64_t next_fire_time_ms(void) {
+  uint64_t fire_ms = UINT64_MAX;
+  lower_fire_time(0, &fire_ms);
+  return fire_ms;
+}
+
 // Remove alarm from internal alarm list and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  pending_alarms_remove(alarm);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -416,10 +541,6 @@ static void remove_pending_alarm(alarm_t* alarm) {
 
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
-  // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -430,28 +551,42 @@ static void schedule_next_instance(alarm_t* alarm) {
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
   alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
+  pending_alarms_insert(alarm);
+
+  // The alarm may have moved the next fire time either way, the timers are
+  // only reprogrammed if it did.
+  reschedule_root_alarm();
+}
+
+// Arms |timer_id| to expire at |deadline_ms|, which may be |kTimerDisarmed| or
+// |kTimerEndOfTime|, unless |armed_ms| says it already is. Returns true if
+// the timer was reprogrammed.
+// Must be called with |alarms_mutex| held
+static bool arm_timer(timer_t timer_id, uint64_t* armed_ms,
+                      uint64_t deadline_ms, const char* timer_name) {
+  if (*armed_ms == deadline_ms) {
+    timer_update_skipped_count++;
+    return false;
+  }
+
+  struct itimerspec timer_time;
+  memset(&timer_time, 0, sizeof(timer_time));
+  if (deadline_ms == kTimerEndOfTime) {
+    timer_time.it_value.tv_sec = (time_t)(1LL << (sizeof(time_t) * 8 - 2));
   } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
+    timer_time.it_value.tv_sec = (deadline_ms / 1000);
+    timer_time.it_value.tv_nsec = (deadline_ms % 1000) * 1000000LL;
   }
 
-  // If the new alarm has the earliest deadline, we need to re-evaluate our
-  // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
-    reschedule_root_alarm();
+  timer_update_count++;
+  if (timer_settime(timer_id, TIMER_ABSTIME, &timer_time, NULL) == -1) {
+    LOG_ERROR("%s unable to set %s: %s", __func__, timer_name,
+              strerror(errno));
+    *armed_ms = kTimerUnknown;
+  } else {
+    *armed_ms = deadline_ms;
   }
+  return true;
 }
 
 // NOTE: must be called with |alarms_mutex| held
@@ -459,26 +594,24 @@ static void reschedule_root_alarm(void) {
   CHECK(alarms != NULL);
 
   const bool timer_was_set = timer_set;
-  alarm_t* next;
+  uint64_t fire_ms;
   int64_t next_expiration;
 
-  // If used in a zeroed state, disarms the timer.
-  struct itimerspec timer_time;
-  memset(&timer_time, 0, sizeof(timer_time));
+  // If left to kTimerDisarmed, disarms the timer.
+  uint64_t timer_ms = kTimerDisarmed;
 
-  if (list_is_empty(alarms)) goto done;
+  if (alarms->empty()) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
-  next_expiration = next->deadline_ms - now_ms();
+  fire_ms = next_fire_time_ms();
+  next_expiration = fire_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
-      if (!wakelock_acquire()) {
+      if (!wakelock_acquire(WAKELOCK_OWNER)) {
         LOG_ERROR("%s unable to acquire wake lock", __func__);
       }
     }
 
-    timer_time.it_value.tv_sec = (next->deadline_ms / 1000);
-    timer_time.it_value.tv_nsec = (next->deadline_ms % 1000) * 1000000LL;
+    timer_ms = fire_ms;
 
     // It is entirely unsafe to call timer_settime(2) with a zeroed timerspec
     // for timers with *_ALARM clock IDs. Although the man page states that the
@@ -492,33 +625,21 @@ static void reschedule_root_alarm(void) {
     // If we've reached this code path, we're going to grab a wake lock and
     // wait for the next timer to fire. In that case, there's no reason to
     // have a pending wakeup timer so we simply cancel it.
-    struct itimerspec end_of_time;
-    memset(&end_of_time, 0, sizeof(end_of_time));
-    end_of_time.it_value.tv_sec = (time_t)(1LL << (sizeof(time_t) * 8 - 2));
-    timer_settime(wakeup_timer, TIMER_ABSTIME, &end_of_time, NULL);
+    arm_timer(wakeup_timer, &wakeup_timer_armed_ms, kTimerEndOfTime,
+              "wakeup timer");
   } else {
     // WARNING: do not attempt to use relative timers with *_ALARM clock IDs
     // in kernels before 3.17 unless you have the following patch:
     // https://lkml.org/lkml/2014/7/7/576
-    struct itimerspec wakeup_time;
-    memset(&wakeup_time, 0, sizeof(wakeup_time));
-
-    wakeup_time.it_value.tv_sec = (next->deadline_ms / 1000);
-    wakeup_time.it_value.tv_nsec = (next->deadline_ms % 1000) * 1000000LL;
-    if (timer_settime(wakeup_timer, TIMER_ABSTIME, &wakeup_time, NULL) == -1)
-      LOG_ERROR("%s unable to set wakeup timer: %s", __func__, strerror(errno));
+    arm_timer(wakeup_timer, &wakeup_timer_armed_ms, fire_ms, "wakeup timer");
   }
 
 done:
-  timer_set =
-      timer_time.it_value.tv_sec != 0 || timer_time.it_value.tv_nsec != 0;
+  timer_set = timer_ms != kTimerDisarmed;
   if (timer_was_set && !timer_set) {
-    wakelock_release();
+    wakelock_release(WAKELOCK_OWNER);
   }
 
-  if (timer_settime(timer, TIMER_ABSTIME, &timer_time, NULL) == -1)
-    LOG_ERROR("%s unable to set timer: %s", __func__, strerror(errno));
-
   // If next expiration was in the past (e.g. short timer that got context
   // switched) then the timer might have diarmed itself. Detect this case and
   // work around it by manually signalling the |alarm_expired| semaphore.
@@ -529,7 +650,7 @@ done:
   // alarm. Nothing bad should happen in that case though since the callback
   // dispatch function checks to make sure the timer at the head of the list
   // actually expired.
-  if (timer_set) {
+  if (arm_timer(timer, &timer_armed_ms, timer_ms, "timer") && timer_set) {
     struct itimerspec time_to_expire;
     timer_gettime(timer, &time_to_expire);
     if (time_to_expire.it_value.tv_sec == 0 &&
@@ -623,39 +744,48 @@ static void callback_dispatch(UNUSED_ATTR void* context) {
     if (!dispatcher_thread_active) break;
 
     std::lock_guard<std::mutex> lock(alarms_mutex);
-    alarm_t* alarm;
-
-    // Take into account that the alarm may get cancelled before we get to it.
-    // We're done here if there are no alarms or the alarm at the front is in
-    // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
-      reschedule_root_alarm();
-      continue;
-    }
 
-    list_remove(alarms, alarm);
+    // The timer that expired disarmed itself
+    timer_armed_ms = kTimerUnknown;
+    wakeup_timer_armed_ms = kTimerUnknown;
+    dispatcher_wakeup_count++;
+
+    // Take into account that the alarms may get cancelled before we get to
+    // them. Dispatch all the alarms that are due in this wakeup, in deadline
+    // order, including the ones whose slack made the wakeup late for them.
+    uint64_t just_now_ms = now_ms();
+    std::vector<alarm_t*> expired_alarms;
+    alarm_t* front;
+    while ((front = pending_alarms_front()) != NULL &&
+           front->deadline_ms <= just_now_ms) {
+      pending_alarms_remove(front);
+      expired_alarms.push_back(front);
+    }
 
-    if (alarm->is_periodic) {
-      alarm->prev_deadline_ms = alarm->deadline_ms;
-      schedule_next_instance(alarm);
-      alarm->stats.rescheduled_count++;
+    for (alarm_t* alarm : expired_alarms) {
+      if (alarm->is_periodic) {
+        alarm->prev_deadline_ms = alarm->deadline_ms;
+        schedule_next_instance(alarm);
+        alarm->stats.rescheduled_count++;
+      }
     }
     reschedule_root_alarm();
 
-    // Enqueue the alarm for processing
-    if (alarm->for_msg_loop) {
-      if (!get_main_thread()) {
-        LOG_ERROR("%s: message loop already NULL. Alarm: %s", __func__,
-                  alarm->stats.name);
-        continue;
+    // Enqueue the alarms for processing
+    for (alarm_t* alarm : expired_alarms) {
+      dispatched_alarm_count++;
+      if (alarm->for_msg_loop) {
+        if (!get_main_thread()) {
+          LOG_ERROR("%s: message loop already NULL. Alarm: %s", __func__,
+                    alarm->stats.name);
+          continue;
+        }
+
+        alarm->closure.i.Reset(Bind(alarm_ready_mloop, alarm));
+        get_main_thread()->DoInThread(FROM_HERE, alarm->closure.i.callback());
+      } else {
+        fixed_queue_enqueue(alarm->queue, alarm);
       }
-
-      alarm->closure.i.Reset(Bind(alarm_ready_mloop, alarm));
-      get_main_thread()->DoInThread(FROM_HERE, alarm->closure.i.callback());
-    } else {
-      fixed_queue_enqueue(alarm->queue, alarm);
     }
   }
 
@@ -734,12 +864,16 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  dprintf(fd, "  Total Alarms: %zu\n", alarms->size());
+  dprintf(fd, "  Dispatcher wakeups / dispatched alarms: %zu / %zu\n",
+          dispatcher_wakeup_count, dispatched_alarm_count);
+  dprintf(fd, "  Timer updates (set/skipped): %zu / %zu\n\n",
+          timer_update_count, timer_update_skipped_count);
 
-  // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
+  // Dump info for each alarm, earliest deadline first
+  std::vector<alarm_t*> sorted_alarms(*alarms);
+  std::sort(sorted_alarms.begin(), sorted_alarms.end(), alarm_precedes);
+  for (alarm_t* alarm : sorted_alarms) {
     alarm_stats_t* stats = &alarm->stats;
 
     dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
@@ -760,6 +894,11 @@ void alarm_debug_dump(int fd) {
             (unsigned long long)alarm->period_ms,
             (long long)(alarm->deadline_ms - just_now_ms));
 
+    if (alarm->slack_ms != 0) {
+      dprintf(fd, "%-51s: %llu\n", "    Slack in ms",
+              (unsigned long long)alarm->slack_ms);
+    }
+
     dump_stat(fd, &stats->overdue_scheduling,
               "    Overdue scheduling time in ms (total/max/avg)");
 
@@ -22,9 +22,17 @@
 #include "check.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_pool.h"
 
 static const allocator_id_t alloc_allocator_id = 42;
 
+static void* allocate(size_t real_size) {
+  void* ptr = buffer_pool_alloc(real_size);
+  if (ptr == NULL) ptr = malloc(real_size);
+  CHECK(ptr);
+  return ptr;
+}
+
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
   size_t real_size = allocation_tracker_resize_for_canary(size);
@@ -59,21 +67,26 @@ char* osi_strndup(const char* str, size_t len) {
 void* osi_malloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = malloc(real_size);
-  CHECK(ptr);
+  void* ptr = allocate(real_size);
   return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
 }
 
 void* osi_calloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = calloc(1, real_size);
+  void* ptr = buffer_pool_alloc(real_size);
+  if (ptr != NULL) {
+    memset(ptr, 0, real_size);
+  } else {
+    ptr = calloc(1, real_size);
+  }
   CHECK(ptr);
   return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
 }
 
 void osi_free(void* ptr) {
-  free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
+  void* real_ptr = allocation_tracker_notify_free(alloc_allocator_id, ptr);
+  if (!buffer_pool_free(real_ptr)) free(real_ptr);
 }
 
 void osi_free_and_reset(void** p_ptr) {
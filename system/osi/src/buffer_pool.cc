@@ -0,0 +1,261 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_osi_buffer_pool"
+
+#include "osi/include/buffer_pool.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include <atomic>
+#include <mutex>
+
+#include "osi/include/log.h"
+
+namespace {
+
+// Size classes in bytes, including the BT_HDR header and the room the stack
+// reserves in front of the payload for the lower layer headers:
+// - small control and event buffers
+// - BT_SMALL_BUFFER_SIZE (HCI commands)
+// - ACL packets of 1021 bytes, the most common controller buffer size
+// - L2CAP_MTU_SIZE
+// - BT_DEFAULT_BUFFER_SIZE
+constexpr size_t kSizeClasses[] = {64, 128, 256, 704, 1152, 1792, 4160};
+constexpr size_t kNumSizeClasses =
+    sizeof(kSizeClasses) / sizeof(kSizeClasses[0]);
+
+constexpr size_t kSlabSize = 64 * 1024;
+// Reserved once, the pages are only backed by memory when first touched
+constexpr size_t kArenaSize = 32 * 1024 * 1024;
+constexpr size_t kNumSlabs = kArenaSize / kSlabSize;
+
+// Blocks kept by each thread for each size class before they are given back
+// to the shared free lists, in batches of |kTransferBatchSize|
+constexpr size_t kThreadCacheCapacity = 32;
+constexpr size_t kTransferBatchSize = kThreadCacheCapacity / 2;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct SizeClassStats {
+  std::atomic<size_t> alloc_count{0};
+  std::atomic<size_t> free_count{0};
+};
+
+std::atomic<bool> pool_enabled(false);
+std::once_flag arena_once;
+std::atomic<uint8_t*> arena(nullptr);
+
+// Guards the slabs and the shared free lists
+std::mutex pool_mutex;
+size_t num_slabs_used = 0;
+uint8_t slab_size_class[kNumSlabs];
+size_t slab_count[kNumSizeClasses];
+FreeBlock* free_lists[kNumSizeClasses];
+
+SizeClassStats stats[kNumSizeClasses];
+std::atomic<size_t> exhausted_count(0);
+
+int size_class_of(size_t size) {
+  for (size_t i = 0; i < kNumSizeClasses; i++) {
+    if (size <= kSizeClasses[i]) return i;
+  }
+  return -1;
+}
+
+// Carve a new slab into the free list of |size_class|, return false if the
+// arena is full. |pool_mutex| must be held.
+bool add_slab(int size_class) {
+  if (num_slabs_used == kNumSlabs) return false;
+  uint8_t* slab =
+      arena.load(std::memory_order_relaxed) + num_slabs_used * kSlabSize;
+  slab_size_class[num_slabs_used++] = size_class;
+  slab_count[size_class]++;
+  const size_t block_size = kSizeClasses[size_class];
+  for (size_t offset = 0; offset + block_size <= kSlabSize;
+       offset += block_size) {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset);
+    block->next = free_lists[size_class];
+    free_lists[size_class] = block;
+  }
+  return true;
+}
+
+// Take up to |max_count| blocks of |size_class| from the shared free lists,
+// return them chained and their number in |count|.
+FreeBlock* take_blocks(int size_class, size_t max_count, size_t* count) {
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  if (free_lists[size_class] == nullptr && !add_slab(size_class)) {
+    *count = 0;
+    return nullptr;
+  }
+  FreeBlock* first = free_lists[size_class];
+  FreeBlock* last = first;
+  size_t taken = 1;
+  while (taken < max_count && last->next != nullptr) {
+    last = last->next;
+    taken++;
+  }
+  free_lists[size_class] = last->next;
+  last->next = nullptr;
+  *count = taken;
+  return first;
+}
+
+// Give the |count| blocks chained from |first| back to the shared free lists.
+void give_blocks(int size_class, FreeBlock* first, size_t count) {
+  if (count == 0) return;
+  FreeBlock* last = first;
+  for (size_t i = 1; i < count; i++) last = last->next;
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  last->next = free_lists[size_class];
+  free_lists[size_class] = first;
+}
+
+struct ThreadCache {
+  FreeBlock* blocks[kNumSizeClasses] = {};
+  size_t counts[kNumSizeClasses] = {};
+  bool alive = true;
+
+  ~ThreadCache() {
+    // Blocks freed by the remaining thread exit code go to the shared lists
+    alive = false;
+    for (size_t i = 0; i < kNumSizeClasses; i++) {
+      give_blocks(i, blocks[i], counts[i]);
+      blocks[i] = nullptr;
+      counts[i] = 0;
+    }
+  }
+};
+
+thread_local ThreadCache thread_cache;
+
+void* alloc_block(int size_class) {
+  ThreadCache& cache = thread_cache;
+  if (!cache.alive) {
+    size_t count;
+    return take_blocks(size_class, 1, &count);
+  }
+  if (cache.blocks[size_class] == nullptr) {
+    cache.blocks[size_class] = take_blocks(size_class, kTransferBatchSize,
+                                           &cache.counts[size_class]);
+    if (cache.blocks[size_class] == nullptr) return nullptr;
+  }
+  FreeBlock* block = cache.blocks[size_class];
+  cache.blocks[size_class] = block->next;
+  cache.counts[size_class]--;
+  return block;
+}
+
+void free_block(int size_class, FreeBlock* block) {
+  ThreadCache& cache = thread_cache;
+  if (!cache.alive) {
+    block->next = nullptr;
+    give_blocks(size_class, block, 1);
+    return;
+  }
+  block->next = cache.blocks[size_class];
+  cache.blocks[size_class] = block;
+  if (++cache.counts[size_class] <= kThreadCacheCapacity) return;
+
+  // Keep the most recently freed blocks, they are the most likely to be hot in
+  // the CPU caches
+  FreeBlock* last_kept = block;
+  for (size_t i = 1; i < kThreadCacheCapacity - kTransferBatchSize; i++) {
+    last_kept = last_kept->next;
+  }
+  FreeBlock* released = last_kept->next;
+  last_kept->next = nullptr;
+  size_t released_count = cache.counts[size_class] -
+                          (kThreadCacheCapacity - kTransferBatchSize);
+  cache.counts[size_class] -= released_count;
+  give_blocks(size_class, released, released_count);
+}
+
+void reserve_arena() {
+  void* region = mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (region == MAP_FAILED) {
+    LOG_ERROR("unable to reserve %zu bytes for the buffer pools", kArenaSize);
+    return;
+  }
+  arena.store(static_cast<uint8_t*>(region), std::memory_order_release);
+}
+
+}  // namespace
+
+void buffer_pool_set_enabled(bool enabled) {
+  if (enabled) {
+    std::call_once(arena_once, reserve_arena);
+    if (arena.load(std::memory_order_acquire) == nullptr) return;
+  }
+  LOG_INFO("buffer pools %s", enabled ? "enabled" : "disabled");
+  pool_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool buffer_pool_is_enabled(void) {
+  return pool_enabled.load(std::memory_order_relaxed);
+}
+
+void* buffer_pool_alloc(size_t size) {
+  if (!pool_enabled.load(std::memory_order_relaxed)) return nullptr;
+  int size_class = size_class_of(size);
+  if (size_class < 0) return nullptr;
+  void* block = alloc_block(size_class);
+  if (block == nullptr) {
+    exhausted_count.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  stats[size_class].alloc_count.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+bool buffer_pool_free(void* ptr) {
+  uint8_t* base = arena.load(std::memory_order_acquire);
+  uint8_t* block = static_cast<uint8_t*>(ptr);
+  if (base == nullptr || block < base || block >= base + kArenaSize) {
+    return false;
+  }
+  int size_class = slab_size_class[(block - base) / kSlabSize];
+  stats[size_class].free_count.fetch_add(1, std::memory_order_relaxed);
+  free_block(size_class, reinterpret_cast<FreeBlock*>(block));
+  return true;
+}
+
+void buffer_pool_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Buffer Pools: %s\n",
+          buffer_pool_is_enabled() ? "enabled" : "disabled");
+  if (arena.load(std::memory_order_acquire) == nullptr) return;
+
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  dprintf(fd, "  Slabs used: %zu / %zu of %zu octets\n", num_slabs_used,
+          kNumSlabs, kSlabSize);
+  dprintf(fd, "  Allocations falling back to the heap: %zu\n",
+          exhausted_count.load(std::memory_order_relaxed));
+  for (size_t i = 0; i < kNumSizeClasses; i++) {
+    size_t alloc_count = stats[i].alloc_count.load(std::memory_order_relaxed);
+    size_t free_count = stats[i].free_count.load(std::memory_order_relaxed);
+    dprintf(fd,
+            "  %4zu octets: slabs %zu, allocated/free/used counts %zu / %zu / "
+            "%zu\n",
+            kSizeClasses[i], slab_count[i], alloc_count, free_count,
+            alloc_count - free_count);
+  }
+}
@@ -28,13 +28,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 #include <sstream>
+#include <string_view>
 #include <type_traits>
+#include <unordered_map>
 
 #include "check.h"
+#include "osi/include/osi.h"
 
 void section_t::Set(std::string key, std::string value) {
   for (entry_t& entry : entries) {
@@ -68,7 +72,7 @@ bool config_t::Has(const std::string& key) {
   return Find(key) != sections.end();
 }
 
-static bool config_parse(FILE* fp, config_t* config);
+static bool config_parse(std::string_view buffer, config_t* config);
 
 template <typename T,
           class = typename std::enable_if<std::is_same<
@@ -99,20 +103,60 @@ std::unique_ptr<config_t> config_new_empty(void) {
 std::unique_ptr<config_t> config_new(const char* filename) {
   CHECK(filename != nullptr);
 
-  std::unique_ptr<config_t> config = config_new_empty();
-
-  FILE* fp = fopen(filename, "rt");
-  if (!fp) {
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
     LOG(ERROR) << __func__ << ": unable to open file '" << filename
                << "': " << strerror(errno);
     return nullptr;
   }
 
-  if (!config_parse(fp, config.get())) {
-    config.reset();
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    LOG(ERROR) << __func__ << ": unable to stat file '" << filename
+               << "': " << strerror(errno);
+    close(fd);
+    return nullptr;
   }
 
-  fclose(fp);
+  std::unique_ptr<config_t> config = config_new_empty();
+
+  // Regular files are parsed in place from a read-only mapping, anything else
+  // is read into memory first.
+  if (S_ISREG(file_stat.st_mode)) {
+    size_t size = file_stat.st_size;
+    if (size > 0) {
+      void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        LOG(ERROR) << __func__ << ": unable to map file '" << filename
+                   << "': " << strerror(errno);
+        close(fd);
+        return nullptr;
+      }
+      if (!config_parse(std::string_view(static_cast<char*>(data), size),
+                        config.get())) {
+        config.reset();
+      }
+      munmap(data, size);
+    }
+  } else {
+    std::string content;
+    char buffer[4096];
+    ssize_t len;
+    while (true) {
+      OSI_NO_INTR(len = read(fd, buffer, sizeof(buffer)));
+      if (len <= 0) break;
+      content.append(buffer, len);
+    }
+    if (len < 0) {
+      LOG(ERROR) << __func__ << ": unable to read file '" << filename
+                 << "': " << strerror(errno);
+      config.reset();
+    } else if (!config_parse(content, config.get())) {
+      config.reset();
+    }
+  }
+
+  close(fd);
   return config;
 }
 
@@ -477,54 +521,84 @@ error2:
   return false;
 }
 
-static char* trim(char* str) {
-  while (isspace(*str)) ++str;
-
-  if (!*str) return str;
-
-  char* end_str = str + strlen(str) - 1;
-  while (end_str > str && isspace(*end_str)) --end_str;
-
-  end_str[1] = '\0';
+static std::string_view trim(std::string_view str) {
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.front())))
+    str.remove_prefix(1);
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.back())))
+    str.remove_suffix(1);
   return str;
 }
 
-static bool config_parse(FILE* fp, config_t* config) {
-  CHECK(fp != nullptr);
+// Parses |buffer| into the empty |config| in a single pass. Sections and keys
+// are looked up in hash indexes of views into |buffer| while parsing, instead
+// of walking the lists for every line, so that only the names and values kept
+// in |config| are copied.
+static bool config_parse(std::string_view buffer, config_t* config) {
   CHECK(config != nullptr);
+  CHECK(config->sections.empty());
 
-  int line_num = 0;
-  char line[4096];
-  char section[4096];
-  strcpy(section, CONFIG_DEFAULT_SECTION);
+  struct section_index_t {
+    section_t* section;
+    std::unordered_map<std::string_view, entry_t*> entries;
+  };
+  std::unordered_map<std::string_view, section_index_t> sections;
+  section_index_t* current = nullptr;
+  std::string_view section_name = CONFIG_DEFAULT_SECTION;
 
-  while (fgets(line, sizeof(line), fp)) {
-    char* line_ptr = trim(line);
+  int line_num = 0;
+  while (!buffer.empty()) {
+    size_t line_end = buffer.find('\n');
+    std::string_view line = buffer.substr(0, line_end);
+    buffer.remove_prefix(line_end == std::string_view::npos ? buffer.size()
+                                                            : line_end + 1);
     ++line_num;
 
+    // Like C strings, a line stops at the first null character.
+    line = trim(line.substr(0, line.find('\0')));
+
     // Skip blank and comment lines.
-    if (*line_ptr == '\0' || *line_ptr == '#') continue;
+    if (line.empty() || line.front() == '#') continue;
 
-    if (*line_ptr == '[') {
-      size_t len = strlen(line_ptr);
-      if (line_ptr[len - 1] != ']') {
+    if (line.front() == '[') {
+      if (line.back() != ']') {
         VLOG(1) << __func__ << ": unterminated section name on line "
                 << line_num;
         return false;
       }
-      strncpy(section, line_ptr + 1, len - 2);  // NOLINT (len < 4096)
-      section[len - 2] = '\0';
-    } else {
-      char* split = strchr(line_ptr, '=');
-      if (!split) {
-        VLOG(1) << __func__ << ": no key/value separator found on line "
-                << line_num;
-        return false;
+      section_name = line.substr(1, line.size() - 2);
+      current = nullptr;
+      continue;
+    }
+
+    size_t split = line.find('=');
+    if (split == std::string_view::npos) {
+      VLOG(1) << __func__ << ": no key/value separator found on line "
+              << line_num;
+      return false;
+    }
+
+    // Sections are created by their first key, and a section appearing
+    // several times in the file is merged into the first one.
+    if (current == nullptr) {
+      auto [section_iter, inserted] = sections.try_emplace(section_name);
+      if (inserted) {
+        config->sections.emplace_back(
+            section_t{.name = std::string(section_name)});
+        section_iter->second.section = &config->sections.back();
       }
+      current = &section_iter->second;
+    }
 
-      *split = '\0';
-      config_set_string(config, section, trim(line_ptr), trim(split + 1));
+    std::string_view key = trim(line.substr(0, split));
+    std::string_view value = trim(line.substr(split + 1));
+    auto [entry_iter, inserted] = current->entries.try_emplace(key, nullptr);
+    if (!inserted) {
+      entry_iter->second->value.assign(value);
+      continue;
     }
+    current->section->entries.emplace_back(
+        entry_t{.key = std::string(key), .value = std::string(value)});
+    entry_iter->second = &current->section->entries.back();
   }
   return true;
 }
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_osi_ring_queue"
+
+#include "osi/include/ring_queue.h"
+
+#include <base/logging.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include "check.h"
+#include "osi/include/log.h"
+#include "osi/include/osi.h"
+#include "osi/include/reactor.h"
+
+namespace {
+
+// Keeps the indexes written by the producers and by the consumer on separate
+// cache lines
+constexpr size_t kCacheLineSize = 64;
+
+// Each cell holds the sequence number of the position expected to use it
+// next: |position| when it is free to be written at |position|, |position| + 1
+// once it holds the element written at |position|.
+struct cell_t {
+  std::atomic<size_t> sequence;
+  void* data;
+};
+
+size_t round_up_to_power_of_two(size_t value) {
+  size_t result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+}  // namespace
+
+struct ring_queue_t {
+  cell_t* cells;
+  size_t mask;
+  int event_fd;
+
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_position;
+  alignas(kCacheLineSize) std::atomic<size_t> dequeue_position;
+  alignas(kCacheLineSize) std::atomic<size_t> length;
+
+  reactor_object_t* dequeue_object;
+  ring_queue_cb dequeue_ready;
+  void* dequeue_context;
+};
+
+static void internal_dequeue_ready(void* context);
+
+ring_queue_t* ring_queue_new(size_t capacity) {
+  ring_queue_t* ret = new ring_queue_t();
+  ret->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (ret->event_fd == INVALID_FD) {
+    LOG_ERROR("%s unable to create eventfd: %s", __func__, strerror(errno));
+    delete ret;
+    return NULL;
+  }
+
+  size_t size = round_up_to_power_of_two(capacity);
+  ret->cells = new cell_t[size];
+  for (size_t i = 0; i < size; i++) {
+    ret->cells[i].sequence.store(i, std::memory_order_relaxed);
+    ret->cells[i].data = NULL;
+  }
+  ret->mask = size - 1;
+  return ret;
+}
+
+void ring_queue_free(ring_queue_t* queue, ring_queue_free_cb free_cb) {
+  if (!queue) return;
+
+  ring_queue_unregister_dequeue(queue);
+
+  void* data;
+  while ((data = ring_queue_try_dequeue(queue)) != NULL) {
+    if (free_cb) free_cb(data);
+  }
+
+  close(queue->event_fd);
+  delete[] queue->cells;
+  delete queue;
+}
+
+bool ring_queue_is_empty(ring_queue_t* queue) {
+  return ring_queue_length(queue) == 0;
+}
+
+size_t ring_queue_length(ring_queue_t* queue) {
+  if (queue == NULL) return 0;
+
+  return queue->length.load(std::memory_order_acquire);
+}
+
+size_t ring_queue_capacity(ring_queue_t* queue) {
+  CHECK(queue != NULL);
+
+  return queue->mask + 1;
+}
+
+bool ring_queue_try_enqueue(ring_queue_t* queue, void* data) {
+  CHECK(queue != NULL);
+  CHECK(data != NULL);
+
+  size_t position = queue->enqueue_position.load(std::memory_order_relaxed);
+  cell_t* cell;
+  while (true) {
+    cell = &queue->cells[position & queue->mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      // The cell is free, claim it unless another producer did first
+      if (queue->enqueue_position.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The cell still holds the element written one lap before
+      return false;
+    } else {
+      position = queue->enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Counted before being written so that the length never drops below the
+  // number of elements the consumer can see
+  bool was_empty = queue->length.fetch_add(1, std::memory_order_acq_rel) == 0;
+  cell->data = data;
+  cell->sequence.store(position + 1, std::memory_order_release);
+
+  // Only wake the consumer up when the queue stops being empty, it dequeues
+  // all the elements before waiting again
+  if (was_empty) {
+    if (eventfd_write(queue->event_fd, 1ULL) == -1) {
+      LOG_ERROR("%s unable to signal queue: %s", __func__, strerror(errno));
+    }
+  }
+  return true;
+}
+
+// Returns whether the element at the front of |queue| has been written, must
+// only be called from the consumer thread.
+static bool front_is_ready(ring_queue_t* queue) {
+  size_t position = queue->dequeue_position.load(std::memory_order_relaxed);
+  cell_t* cell = &queue->cells[position & queue->mask];
+  return cell->sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+void* ring_queue_try_dequeue(ring_queue_t* queue) {
+  if (queue == NULL) return NULL;
+
+  // Empty, or the producer that claimed the front cell hasn't written it yet
+  if (!front_is_ready(queue)) return NULL;
+
+  size_t position = queue->dequeue_position.load(std::memory_order_relaxed);
+  cell_t* cell = &queue->cells[position & queue->mask];
+  void* data = cell->data;
+  cell->sequence.store(position + queue->mask + 1, std::memory_order_release);
+  queue->dequeue_position.store(position + 1, std::memory_order_relaxed);
+  queue->length.fetch_sub(1, std::memory_order_acq_rel);
+  return data;
+}
+
+void* ring_queue_dequeue(ring_queue_t* queue) {
+  CHECK(queue != NULL);
+
+  while (true) {
+    void* data = ring_queue_try_dequeue(queue);
+    if (data != NULL) return data;
+
+    if (!ring_queue_is_empty(queue)) {
+      // An element is being written, the producer won't signal it
+      sched_yield();
+      continue;
+    }
+
+    struct pollfd pfd = {.fd = queue->event_fd, .events = POLLIN};
+    int ret;
+    OSI_NO_INTR(ret = poll(&pfd, 1, -1));
+    if (ret == -1) {
+      LOG_ERROR("%s unable to wait on queue: %s", __func__, strerror(errno));
+      continue;
+    }
+    eventfd_t value;
+    eventfd_read(queue->event_fd, &value);
+  }
+}
+
+void ring_queue_register_dequeue(ring_queue_t* queue, reactor_t* reactor,
+                                 ring_queue_cb ready_cb, void* context) {
+  CHECK(queue != NULL);
+  CHECK(reactor != NULL);
+  CHECK(ready_cb != NULL);
+
+  // Make sure we're not already registered
+  ring_queue_unregister_dequeue(queue);
+
+  queue->dequeue_ready = ready_cb;
+  queue->dequeue_context = context;
+  queue->dequeue_object = reactor_register(reactor, queue->event_fd, queue,
+                                           internal_dequeue_ready, NULL);
+}
+
+void ring_queue_unregister_dequeue(ring_queue_t* queue) {
+  CHECK(queue != NULL);
+
+  if (queue->dequeue_object) {
+    reactor_unregister(queue->dequeue_object);
+    queue->dequeue_object = NULL;
+  }
+}
+
+static void internal_dequeue_ready(void* context) {
+  CHECK(context != NULL);
+
+  ring_queue_t* queue = static_cast<ring_queue_t*>(context);
+
+  // Consume the signal before looking at the queue, so that an element
+  // enqueued from now on wakes the reactor up again
+  eventfd_t value;
+  eventfd_read(queue->event_fd, &value);
+
+  for (size_t count = ring_queue_length(queue);
+       count > 0 && front_is_ready(queue); count--) {
+    queue->dequeue_ready(queue, queue->dequeue_context);
+  }
+
+  // Elements enqueued while the callbacks ran, or not dequeued by them, didn't
+  // signal the queue: come back for them after the other reactor objects
+  if (!ring_queue_is_empty(queue)) {
+    eventfd_write(queue->event_fd, 1ULL);
+  }
+}
@@ -18,6 +18,7 @@
 
 #include <base/logging.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "check.h"
 #include "osi/include/allocator.h"
@@ -31,6 +32,17 @@ struct ringbuffer_t {
   uint8_t* tail;
 };
 
+// Set |span| to the |length| bytes starting at |start|, |length| must fit in
+// the buffer.
+static void ringbuffer_fill_span(const ringbuffer_t* rb, uint8_t* start,
+                                 size_t length, ringbuffer_span_t* span) {
+  const size_t to_end = rb->base + rb->total - start;
+  span->data[0] = start;
+  span->length[0] = length < to_end ? length : to_end;
+  span->data[1] = rb->base;
+  span->length[1] = length - span->length[0];
+}
+
 ringbuffer_t* ringbuffer_init(const size_t size) {
   ringbuffer_t* p =
       static_cast<ringbuffer_t*>(osi_calloc(sizeof(ringbuffer_t)));
@@ -61,12 +73,31 @@ size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length) {
   CHECK(rb);
   CHECK(p);
 
+  ringbuffer_span_t span;
+  length = ringbuffer_reserve(rb, length, &span);
+  memcpy(span.data[0], p, span.length[0]);
+  memcpy(span.data[1], p + span.length[0], span.length[1]);
+  return ringbuffer_commit(rb, length);
+}
+
+size_t ringbuffer_reserve(ringbuffer_t* rb, size_t length,
+                          ringbuffer_span_t* span) {
+  CHECK(rb);
+  CHECK(span);
+
+  if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
+
+  ringbuffer_fill_span(rb, rb->tail, length, span);
+  return length;
+}
+
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  CHECK(rb);
+
   if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
 
-  for (size_t i = 0; i != length; ++i) {
-    *rb->tail++ = *p++;
-    if (rb->tail >= (rb->base + rb->total)) rb->tail = rb->base;
-  }
+  rb->tail += length;
+  if (rb->tail >= (rb->base + rb->total)) rb->tail -= rb->total;
 
   rb->available -= length;
   return length;
@@ -96,14 +127,25 @@ size_t ringbuffer_peek(const ringbuffer_t* rb, off_t offset, uint8_t* p,
                                    ? ringbuffer_size(rb) - offset
                                    : length;
 
-  for (size_t copied = 0; copied < bytes_to_copy; ++copied) {
-    *p++ = *b++;
-    if (b >= (rb->base + rb->total)) b = rb->base;
-  }
+  ringbuffer_span_t span;
+  ringbuffer_fill_span(rb, b, bytes_to_copy, &span);
+  memcpy(p, span.data[0], span.length[0]);
+  memcpy(p + span.length[0], span.data[1], span.length[1]);
 
   return bytes_to_copy;
 }
 
+size_t ringbuffer_peek_span(const ringbuffer_t* rb, size_t length,
+                            ringbuffer_span_t* span) {
+  CHECK(rb);
+  CHECK(span);
+
+  if (length > ringbuffer_size(rb)) length = ringbuffer_size(rb);
+
+  ringbuffer_fill_span(rb, rb->head, length, span);
+  return length;
+}
+
 size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length) {
   CHECK(rb);
   CHECK(p);
@@ -38,6 +38,7 @@
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/reactor.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/semaphore.h"
 
 struct thread_t {
@@ -162,13 +163,10 @@ bool thread_set_priority(thread_t* thread, int priority) {
 bool thread_set_rt_priority(thread_t* thread, int priority) {
   if (!thread) return false;
 
-  struct sched_param rt_params;
-  rt_params.sched_priority = priority;
-
-  const int rc = sched_setscheduler(thread->tid, SCHED_FIFO, &rt_params);
-  if (rc != 0) {
-    LOG_ERROR("%s unable to set SCHED_FIFO priority %d for tid %d, error %s",
-              __func__, priority, thread->tid, strerror(errno));
+  // The priority configured for the thread, if any, wins over |priority|
+  if (!thread_scheduler_apply_policy(thread->tid, thread->name, priority)) {
+    LOG_ERROR("%s unable to set SCHED_FIFO priority %d for tid %d", __func__,
+              priority, thread->tid);
     return false;
   }
 
@@ -205,6 +203,7 @@ static void* run_thread(void* start_arg) {
     return NULL;
   }
   thread->tid = gettid();
+  thread_scheduler_apply_policy(thread->tid, thread->name, 0);
 
   LOG_INFO("%s: thread id %d, thread name %s started", __func__, thread->tid,
            thread->name);
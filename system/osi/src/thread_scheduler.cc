@@ -17,6 +17,8 @@
 #include <sched.h>
 #include <sys/types.h>
 
+#include "gd/os/thread_policy.h"
+
 namespace {
 constexpr int kRealTimeFifoSchedulingPriority = 1;
 }  // namespace
@@ -32,3 +34,10 @@ bool thread_scheduler_get_priority_range(int& min, int& max) {
   max = sched_get_priority_max(SCHED_FIFO);
   return (min != -1 && max != -1) ? true : false;
 }
+
+bool thread_scheduler_apply_policy(pid_t linux_tid, const char* thread_name,
+                                   int real_time_priority) {
+  return bluetooth::os::ApplyThreadPolicy(
+      linux_tid,
+      bluetooth::os::GetThreadPolicy(thread_name, real_time_priority));
+}
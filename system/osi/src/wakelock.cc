@@ -24,12 +24,14 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <pthread.h>
+#include <signal.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <map>
 #include <mutex>
 #include <string>
 
@@ -59,6 +61,30 @@ static pthread_once_t initialized = PTHREAD_ONCE_INIT;
 static int wake_lock_fd = INVALID_FD;
 static int wake_unlock_fd = INVALID_FD;
 
+// The wakelock is released this long after its last owner released it, so
+// that the alarms and tasks executed in bursts do not acquire and release it
+// each time.
+static const uint64_t DEFAULT_RELEASE_DELAY_MS = 200;
+static uint64_t release_delay_ms = DEFAULT_RELEASE_DELAY_MS;
+
+// Wake reason statistics, for each owner of the wakelock
+typedef struct {
+  bool is_holding;
+  size_t acquired_count;
+  uint64_t last_acquired_timestamp_ms;
+  uint64_t total_held_ms;
+} wakelock_owner_stats_t;
+
+// The state of the owners and of the OS wakelock, guarded by |owners_mutex|.
+// |owners_mutex| is taken before |stats_mutex|.
+static std::mutex owners_mutex;
+static std::map<std::string, wakelock_owner_stats_t> wakelock_owners;
+static size_t holding_owners = 0;
+static bool is_os_wakelock_acquired = false;
+static timer_t release_timer;
+static bool release_timer_initialized = false;
+static uint64_t release_deadline_ms = 0;
+
 // Wakelock statistics for the "bluetooth_timer"
 typedef struct {
   bool is_acquired;
@@ -87,6 +113,9 @@ static bt_status_t wakelock_acquire_callout(void);
 static bt_status_t wakelock_acquire_native(void);
 static bt_status_t wakelock_release_callout(void);
 static bt_status_t wakelock_release_native(void);
+static bt_status_t wakelock_release_os(void);
+static void release_timer_callback(union sigval sigval);
+static uint64_t now_ms(void);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
@@ -99,9 +128,24 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   LOG_INFO("%s set to %s", __func__, (is_native) ? "native" : "non-native");
 }
 
-bool wakelock_acquire(void) {
+bool wakelock_acquire(const char* owner) {
+  CHECK(owner != NULL);
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(owners_mutex);
+
+  wakelock_owner_stats_t& owner_stats = wakelock_owners[owner];
+  if (!owner_stats.is_holding) {
+    owner_stats.is_holding = true;
+    owner_stats.acquired_count++;
+    owner_stats.last_acquired_timestamp_ms = now_ms();
+    holding_owners++;
+  }
+
+  // A pending release is cancelled, the OS wakelock is still acquired
+  release_deadline_ms = 0;
+  if (is_os_wakelock_acquired) return true;
+
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -113,6 +157,8 @@ bool wakelock_acquire(void) {
 
   if (status != BT_STATUS_SUCCESS)
     LOG_ERROR("%s unable to acquire wake lock: %d", __func__, status);
+  else
+    is_os_wakelock_acquired = true;
 
   return (status == BT_STATUS_SUCCESS);
 }
@@ -145,9 +191,42 @@ static bt_status_t wakelock_acquire_native(void) {
   return BT_STATUS_SUCCESS;
 }
 
-bool wakelock_release(void) {
+bool wakelock_release(const char* owner) {
+  CHECK(owner != NULL);
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(owners_mutex);
+
+  auto it = wakelock_owners.find(owner);
+  if (it == wakelock_owners.end() || !it->second.is_holding) return true;
+
+  wakelock_owner_stats_t& owner_stats = it->second;
+  owner_stats.is_holding = false;
+  owner_stats.total_held_ms +=
+      now_ms() - owner_stats.last_acquired_timestamp_ms;
+  holding_owners--;
+
+  if (holding_owners > 0 || !is_os_wakelock_acquired) return true;
+
+  if (release_delay_ms == 0 || !release_timer_initialized) {
+    return (wakelock_release_os() == BT_STATUS_SUCCESS);
+  }
+
+  // The timer is armed again by each release, the callback checks the deadline
+  release_deadline_ms = now_ms() + release_delay_ms;
+  struct itimerspec timer_time = {};
+  timer_time.it_value.tv_sec = release_delay_ms / 1000;
+  timer_time.it_value.tv_nsec = (release_delay_ms % 1000) * 1000000LL;
+  if (timer_settime(release_timer, 0, &timer_time, NULL) == -1) {
+    LOG_ERROR("%s unable to set the release timer: %s", __func__,
+              strerror(errno));
+    return (wakelock_release_os() == BT_STATUS_SUCCESS);
+  }
+  return true;
+}
+
+// NOTE: must be called with |owners_mutex| held
+static bt_status_t wakelock_release_os(void) {
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -156,8 +235,22 @@ bool wakelock_release(void) {
     status = wakelock_release_callout();
 
   update_wakelock_released_stats(status);
+  is_os_wakelock_acquired = false;
+  release_deadline_ms = 0;
 
-  return (status == BT_STATUS_SUCCESS);
+  return status;
+}
+
+static void release_timer_callback(UNUSED_ATTR union sigval sigval) {
+  std::lock_guard<std::mutex> lock(owners_mutex);
+
+  // The wakelock was acquired again, or the release was postponed
+  if (holding_owners > 0 || !is_os_wakelock_acquired ||
+      release_deadline_ms == 0 || now_ms() < release_deadline_ms) {
+    return;
+  }
+
+  wakelock_release_os();
 }
 
 static bt_status_t wakelock_release_callout(void) {
@@ -185,6 +278,17 @@ static void wakelock_initialize(void) {
   reset_wakelock_stats();
 
   if (is_native) wakelock_initialize_native();
+
+  struct sigevent sigevent;
+  memset(&sigevent, 0, sizeof(sigevent));
+  sigevent.sigev_notify = SIGEV_THREAD;
+  sigevent.sigev_notify_function = release_timer_callback;
+  release_timer_initialized =
+      timer_create(CLOCK_ID, &sigevent, &release_timer) == 0;
+  if (!release_timer_initialized) {
+    LOG_ERROR("%s unable to create the release timer: %s", __func__,
+              strerror(errno));
+  }
 }
 
 static void wakelock_initialize_native(void) {
@@ -208,10 +312,22 @@ static void wakelock_initialize_native(void) {
 }
 
 void wakelock_cleanup(void) {
-  if (wakelock_stats.is_acquired) {
-    LOG_ERROR("%s releasing wake lock as part of cleanup", __func__);
-    wakelock_release();
+  {
+    std::lock_guard<std::mutex> lock(owners_mutex);
+    if (release_timer_initialized) {
+      timer_delete(release_timer);
+      release_timer_initialized = false;
+    }
+    if (is_os_wakelock_acquired) {
+      if (holding_owners > 0) {
+        LOG_ERROR("%s releasing wake lock as part of cleanup", __func__);
+      }
+      wakelock_release_os();
+    }
+    wakelock_owners.clear();
+    holding_owners = 0;
   }
+  release_delay_ms = DEFAULT_RELEASE_DELAY_MS;
   wake_lock_path.clear();
   wake_unlock_path.clear();
   initialized = PTHREAD_ONCE_INIT;
@@ -223,6 +339,11 @@ void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   if (unlock_path) wake_unlock_path = unlock_path;
 }
 
+void wakelock_set_release_delay(uint64_t delay_ms) {
+  std::lock_guard<std::mutex> lock(owners_mutex);
+  release_delay_ms = delay_ms;
+}
+
 static uint64_t now_ms(void) {
   struct timespec ts;
   if (clock_gettime(CLOCK_ID, &ts) == -1) {
@@ -327,6 +448,7 @@ static void update_wakelock_released_stats(bt_status_t released_status) {
 void wakelock_debug_dump(int fd) {
   const uint64_t just_now_ms = now_ms();
 
+  std::lock_guard<std::mutex> owners_lock(owners_mutex);
   std::lock_guard<std::mutex> lock(stats_mutex);
 
   // Compute the last acquired interval if the wakelock is still acquired
@@ -369,4 +491,15 @@ void wakelock_debug_dump(int fd) {
   dprintf(fd, "  Total run time (ms)            : %llu\n",
           (unsigned long long)(just_now_ms -
                                wakelock_stats.last_reset_timestamp_ms));
+
+  dprintf(fd,
+          "  Owner                          : holding / count / held (ms)\n");
+  for (const auto& [owner, owner_stats] : wakelock_owners) {
+    uint64_t held_ms = owner_stats.total_held_ms;
+    if (owner_stats.is_holding)
+      held_ms += just_now_ms - owner_stats.last_acquired_timestamp_ms;
+    dprintf(fd, "    %-28s : %s / %zu / %llu\n", owner.c_str(),
+            owner_stats.is_holding ? "true" : "false",
+            owner_stats.acquired_count, (unsigned long long)held_ms);
+  }
 }
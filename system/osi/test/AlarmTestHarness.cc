@@ -44,6 +44,8 @@ void AlarmTestHarness::SetUp() {
   TIMER_INTERVAL_FOR_WAKELOCK_IN_MS = 500;
 
   wakelock_set_os_callouts(&bt_wakelock_callouts);
+  // The tests check when the alarms release the wakelock
+  wakelock_set_release_delay(0);
 }
 
 void AlarmTestHarness::TearDown() {
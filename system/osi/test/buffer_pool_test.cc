@@ -0,0 +1,110 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "osi/include/buffer_pool.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include "osi/include/allocator.h"
+#include "osi/test/AllocationTestHarness.h"
+
+class BufferPoolTest : public AllocationTestHarness {
+ protected:
+  void SetUp() override {
+    AllocationTestHarness::SetUp();
+    buffer_pool_set_enabled(true);
+    ASSERT_TRUE(buffer_pool_is_enabled());
+  }
+
+  void TearDown() override {
+    buffer_pool_set_enabled(false);
+    AllocationTestHarness::TearDown();
+  }
+};
+
+TEST_F(BufferPoolTest, test_alloc_and_free) {
+  void* small = buffer_pool_alloc(1);
+  void* large = buffer_pool_alloc(4096 + 16 + 8);
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(large, nullptr);
+  ASSERT_NE(small, large);
+  memset(large, 0xff, 4096 + 16 + 8);
+
+  // The last freed block of a size class is the next one handed out
+  ASSERT_TRUE(buffer_pool_free(small));
+  EXPECT_EQ(small, buffer_pool_alloc(64));
+  ASSERT_TRUE(buffer_pool_free(small));
+  ASSERT_TRUE(buffer_pool_free(large));
+
+  EXPECT_EQ(nullptr, buffer_pool_alloc(64 * 1024));
+}
+
+TEST_F(BufferPoolTest, test_heap_blocks_are_not_freed) {
+  void* ptr = malloc(64);
+  EXPECT_FALSE(buffer_pool_free(ptr));
+  EXPECT_FALSE(buffer_pool_free(nullptr));
+  free(ptr);
+}
+
+TEST_F(BufferPoolTest, test_disabled_pools) {
+  void* ptr = buffer_pool_alloc(64);
+  ASSERT_NE(ptr, nullptr);
+  buffer_pool_set_enabled(false);
+  EXPECT_EQ(nullptr, buffer_pool_alloc(64));
+  // Blocks still go back to the pools they came from
+  EXPECT_TRUE(buffer_pool_free(ptr));
+}
+
+TEST_F(BufferPoolTest, test_osi_malloc_switches_backend) {
+  void* pooled = osi_malloc(100);
+  uint8_t* zeroed = static_cast<uint8_t*>(osi_calloc(100));
+  for (size_t i = 0; i < 100; i++) EXPECT_EQ(0, zeroed[i]);
+
+  buffer_pool_set_enabled(false);
+  void* heap = osi_malloc(100);
+  EXPECT_FALSE(buffer_pool_free(heap)) << "allocated from the heap";
+  osi_free(heap);
+
+  osi_free(pooled);
+  osi_free(zeroed);
+}
+
+TEST_F(BufferPoolTest, test_blocks_freed_on_other_threads) {
+  constexpr size_t kNumBlocks = 1000;
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    void* block = osi_malloc(1000);
+    memset(block, i & 0xff, 1000);
+    blocks.push_back(block);
+  }
+
+  std::thread freeing_thread([&blocks] {
+    for (void* block : blocks) osi_free(block);
+  });
+  freeing_thread.join();
+
+  // All the blocks are reused once the other thread exited
+  std::vector<void*> reused;
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    reused.push_back(osi_malloc(1000));
+  }
+  for (void* block : reused) osi_free(block);
+}
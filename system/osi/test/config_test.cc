@@ -19,6 +19,7 @@
 #include <base/files/file_util.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
 
 #include "AllocationTestHarness.h"
@@ -149,6 +150,48 @@ TEST_F(ConfigTest, config_new) {
   EXPECT_TRUE(config.get() != NULL);
 }
 
+TEST_F(ConfigTest, config_new_merges_repeated_sections_and_keys) {
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+  ASSERT_EQ(config->sections.size(), 2u);
+  EXPECT_EQ(config->sections.front().name, CONFIG_DEFAULT_SECTION);
+  const section_t& did = config->sections.back();
+  EXPECT_EQ(did.name, "DID");
+  ASSERT_EQ(did.entries.size(), 6u);
+  EXPECT_EQ(did.entries.front().key, "recordNumber");
+  auto version = std::find_if(
+      did.entries.begin(), did.entries.end(),
+      [](const entry_t& entry) { return entry.key == "version"; });
+  ASSERT_NE(version, did.entries.end());
+  EXPECT_EQ(version->value, "0x1436");
+}
+
+TEST_F(ConfigTest, config_new_other_line_endings) {
+  auto filename = std::filesystem::temp_directory_path() / "config_crlf.conf";
+  std::string content = "[A]\r\nkey = value\r\n\r\n[B]\r\nempty =\r\nlast=1";
+  base::FilePath file_path(filename.string());
+  ASSERT_EQ(base::WriteFile(file_path, content.data(), content.size()),
+            (int)content.size());
+
+  std::unique_ptr<config_t> config = config_new(filename.c_str());
+  ASSERT_NE(config, nullptr);
+  const std::string* value = config_get_string(*config, "A", "key", nullptr);
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, "value");
+  EXPECT_TRUE(config_has_key(*config, "B", "empty"));
+  EXPECT_EQ(config_get_int(*config, "B", "last", 0), 1);
+
+  // An empty file is an empty config, a malformed one is no config at all
+  ASSERT_EQ(base::WriteFile(file_path, "", 0), 0);
+  config = config_new(filename.c_str());
+  ASSERT_NE(config, nullptr);
+  EXPECT_TRUE(config->sections.empty());
+  ASSERT_EQ(base::WriteFile(file_path, "[A]\nkey\n", 8), 8);
+  EXPECT_EQ(config_new(filename.c_str()), nullptr);
+
+  EXPECT_TRUE(std::filesystem::remove(filename));
+}
+
 TEST_F(ConfigTest, config_new_clone) {
   std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
   std::unique_ptr<config_t> clone = config_new_clone(*config);
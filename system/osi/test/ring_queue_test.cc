@@ -0,0 +1,158 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "osi/include/ring_queue.h"
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AllocationTestHarness.h"
+#include "osi/include/future.h"
+#include "osi/include/osi.h"
+#include "osi/include/thread.h"
+
+static const size_t TEST_QUEUE_SIZE = 10;
+static const char* DUMMY_DATA_STRING1 = "Dummy data string1";
+static const char* DUMMY_DATA_STRING2 = "Dummy data string2";
+static const char* DUMMY_DATA_STRING3 = "Dummy data string3";
+
+static int test_queue_entry_free_counter = 0;
+
+static void test_queue_entry_free_cb(UNUSED_ATTR void* data) {
+  test_queue_entry_free_counter++;
+}
+
+class RingQueueTest : public AllocationTestHarness {};
+
+TEST_F(RingQueueTest, test_ring_queue_new_free) {
+  ring_queue_t* queue = ring_queue_new(0);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ(1u, ring_queue_capacity(queue));
+  ring_queue_free(queue, NULL);
+
+  queue = ring_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ(16u, ring_queue_capacity(queue));
+
+  // Test freeing the remaining elements
+  test_queue_entry_free_counter = 0;
+  EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+  EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING2));
+  ring_queue_free(queue, test_queue_entry_free_cb);
+  EXPECT_EQ(2, test_queue_entry_free_counter);
+
+  // Test a NULL queue
+  ring_queue_free(NULL, NULL);
+  EXPECT_TRUE(ring_queue_is_empty(NULL));
+  EXPECT_EQ(0u, ring_queue_length(NULL));
+  EXPECT_EQ(NULL, ring_queue_try_dequeue(NULL));
+}
+
+TEST_F(RingQueueTest, test_ring_queue_enqueue_dequeue) {
+  ring_queue_t* queue = ring_queue_new(2);
+  ASSERT_TRUE(queue != NULL);
+
+  EXPECT_TRUE(ring_queue_is_empty(queue));
+  EXPECT_EQ(NULL, ring_queue_try_dequeue(queue));
+
+  // Wrap around the ring a few times
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+    EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING2));
+    EXPECT_FALSE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING3));
+    EXPECT_EQ(2u, ring_queue_length(queue));
+
+    EXPECT_EQ(DUMMY_DATA_STRING1, ring_queue_try_dequeue(queue));
+    EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING3));
+    EXPECT_EQ(DUMMY_DATA_STRING2, ring_queue_dequeue(queue));
+    EXPECT_EQ(DUMMY_DATA_STRING3, ring_queue_dequeue(queue));
+    EXPECT_TRUE(ring_queue_is_empty(queue));
+  }
+
+  ring_queue_free(queue, NULL);
+}
+
+TEST_F(RingQueueTest, test_ring_queue_multiple_producers) {
+  constexpr uintptr_t kNumProducers = 4;
+  constexpr uintptr_t kNumElements = 10000;
+  ring_queue_t* queue = ring_queue_new(64);
+  ASSERT_TRUE(queue != NULL);
+
+  std::vector<std::thread> producers;
+  for (uintptr_t producer = 0; producer < kNumProducers; producer++) {
+    producers.emplace_back([queue, producer] {
+      for (uintptr_t i = 1; i <= kNumElements; i++) {
+        void* data = (void*)(i * kNumProducers + producer);
+        while (!ring_queue_try_enqueue(queue, data)) std::this_thread::yield();
+      }
+    });
+  }
+
+  // Each producer's elements are dequeued in order
+  std::vector<uintptr_t> last(kNumProducers, 0);
+  for (uintptr_t i = 0; i < kNumProducers * kNumElements; i++) {
+    uintptr_t value = (uintptr_t)ring_queue_dequeue(queue);
+    uintptr_t producer = value % kNumProducers;
+    EXPECT_EQ(last[producer] + 1, value / kNumProducers);
+    last[producer] = value / kNumProducers;
+  }
+  for (auto& producer : producers) producer.join();
+  EXPECT_TRUE(ring_queue_is_empty(queue));
+
+  ring_queue_free(queue, NULL);
+}
+
+struct received_t {
+  future_t* done;
+  size_t count;
+  size_t expected;
+};
+
+static void ring_queue_ready(ring_queue_t* queue, void* context) {
+  received_t* received = static_cast<received_t*>(context);
+  void* msg = ring_queue_try_dequeue(queue);
+  EXPECT_TRUE(msg != NULL);
+  if (++received->count == received->expected) {
+    future_ready(received->done, FUTURE_SUCCESS);
+  }
+}
+
+TEST_F(RingQueueTest, test_ring_queue_register_dequeue) {
+  ring_queue_t* queue = ring_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  thread_t* worker_thread = thread_new("test_ring_queue_worker_thread");
+  ASSERT_TRUE(worker_thread != NULL);
+
+  received_t received = {future_new(), 0, 3};
+  ring_queue_register_dequeue(queue, thread_get_reactor(worker_thread),
+                              ring_queue_ready, &received);
+
+  // Only the first element signals the queue, all of them are received
+  EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+  EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING2));
+  EXPECT_TRUE(ring_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING3));
+  future_await(received.done);
+  EXPECT_EQ(3u, received.count);
+
+  ring_queue_unregister_dequeue(queue);
+  thread_free(worker_thread);
+  ring_queue_free(queue, NULL);
+}
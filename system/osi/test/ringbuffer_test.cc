@@ -137,3 +137,53 @@ TEST(RingbufferTest, test_multi_insert_delete) {
 
   ringbuffer_free(rb);
 }
+
+TEST(RingbufferTest, test_reserve_commit_and_peek_span) {
+  ringbuffer_t* rb = ringbuffer_init(16);
+  ringbuffer_span_t span;
+
+  // Write directly into the free space
+  EXPECT_EQ((size_t)10, ringbuffer_reserve(rb, 10, &span));
+  EXPECT_EQ((size_t)10, span.length[0]);
+  EXPECT_EQ((size_t)0, span.length[1]);
+  for (size_t i = 0; i != span.length[0]; ++i) span.data[0][i] = i;
+  EXPECT_EQ((size_t)16, ringbuffer_available(rb));
+  EXPECT_EQ((size_t)10, ringbuffer_commit(rb, 10));
+  EXPECT_EQ((size_t)6, ringbuffer_available(rb));
+
+  // Read and consume part of the data in place
+  EXPECT_EQ((size_t)8, ringbuffer_peek_span(rb, 8, &span));
+  EXPECT_EQ((size_t)8, span.length[0]);
+  EXPECT_EQ((size_t)0, span.length[1]);
+  EXPECT_EQ(0, span.data[0][0]);
+  EXPECT_EQ(7, span.data[0][7]);
+  EXPECT_EQ((size_t)8, ringbuffer_delete(rb, 8));
+  EXPECT_EQ((size_t)2, ringbuffer_size(rb));
+
+  // The free space wraps around the end of the buffer
+  EXPECT_EQ((size_t)14, ringbuffer_reserve(rb, 20, &span));
+  EXPECT_EQ((size_t)6, span.length[0]);
+  EXPECT_EQ((size_t)8, span.length[1]);
+  for (size_t i = 0; i != span.length[0]; ++i) span.data[0][i] = 0xAA;
+  for (size_t i = 0; i != span.length[1]; ++i) span.data[1][i] = 0xBB;
+  EXPECT_EQ((size_t)14, ringbuffer_commit(rb, 20));
+  EXPECT_EQ((size_t)0, ringbuffer_available(rb));
+  EXPECT_EQ((size_t)0, ringbuffer_reserve(rb, 1, &span));
+
+  // And so does the data
+  EXPECT_EQ((size_t)16, ringbuffer_peek_span(rb, 20, &span));
+  EXPECT_EQ((size_t)8, span.length[0]);
+  EXPECT_EQ((size_t)8, span.length[1]);
+  EXPECT_EQ(8, span.data[0][0]);
+  EXPECT_EQ(0xAA, span.data[0][7]);
+  EXPECT_EQ(0xBB, span.data[1][0]);
+
+  uint8_t peek[16] = {0};
+  EXPECT_EQ((size_t)10, ringbuffer_peek(rb, 6, peek, sizeof(peek)));
+  EXPECT_EQ(0xAA, peek[0]);
+  EXPECT_EQ(0xAA, peek[1]);
+  EXPECT_EQ(0xBB, peek[2]);
+  EXPECT_EQ(0xBB, peek[9]);
+
+  ringbuffer_free(rb);
+}
@@ -24,14 +24,20 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "osi/include/wakelock.h"
 
 #include "AllocationTestHarness.h"
 
-static bool is_wake_lock_acquired = false;
+static std::atomic<bool> is_wake_lock_acquired = false;
+static int acquire_wake_lock_count = 0;
 
 static int acquire_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = true;
+  acquire_wake_lock_count++;
   return BT_STATUS_SUCCESS;
 }
 
@@ -40,6 +46,9 @@ static int release_wake_lock_cb(const char* lock_name) {
   return BT_STATUS_SUCCESS;
 }
 
+static const char* kOwner1 = "owner1";
+static const char* kOwner2 = "owner2";
+
 static bt_os_callouts_t bt_wakelock_callouts = {
     sizeof(bt_os_callouts_t), NULL, acquire_wake_lock_cb, release_wake_lock_cb};
 
@@ -67,6 +76,10 @@ class WakelockTest : public AllocationTestHarness {
 
     lock_path_fd = creat(lock_path_.c_str(), S_IRWXU);
     unlock_path_fd = creat(unlock_path_.c_str(), S_IRWXU);
+
+    // Release immediately unless a test checks the release delay
+    acquire_wake_lock_count = 0;
+    wakelock_set_release_delay(0);
   }
 
   int lock_path_fd{-1};
@@ -140,9 +153,9 @@ TEST_F(WakelockTest, test_set_os_callouts) {
   ASSERT_FALSE(is_wake_lock_acquired);
 
   for (size_t i = 0; i < 1000; i++) {
-    wakelock_acquire();
+    wakelock_acquire(kOwner1);
     ASSERT_TRUE(is_wake_lock_acquired);
-    wakelock_release();
+    wakelock_release(kOwner1);
     ASSERT_FALSE(is_wake_lock_acquired);
   }
 }
@@ -155,9 +168,44 @@ TEST_F(WakelockTest, test_set_paths) {
   ASSERT_FALSE(IsFileWakeLockAcquired());
 
   for (size_t i = 0; i < 1000; i++) {
-    wakelock_acquire();
+    wakelock_acquire(kOwner1);
     ASSERT_TRUE(IsFileWakeLockAcquired());
-    wakelock_release();
+    wakelock_release(kOwner1);
     ASSERT_FALSE(IsFileWakeLockAcquired());
   }
 }
+
+TEST_F(WakelockTest, test_owners) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  wakelock_acquire(kOwner1);
+  wakelock_acquire(kOwner2);
+  // The same owner acquires only once
+  wakelock_acquire(kOwner1);
+  ASSERT_EQ(acquire_wake_lock_count, 1);
+
+  wakelock_release(kOwner1);
+  ASSERT_TRUE(is_wake_lock_acquired);
+  // Releasing again is ignored, owner2 still holds the wakelock
+  wakelock_release(kOwner1);
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  wakelock_release(kOwner2);
+  ASSERT_FALSE(is_wake_lock_acquired);
+}
+
+TEST_F(WakelockTest, test_release_delay) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_delay(100);
+
+  // The bursts are absorbed while the release is delayed
+  for (size_t i = 0; i < 100; i++) {
+    wakelock_acquire(kOwner1);
+    wakelock_release(kOwner1);
+    ASSERT_TRUE(is_wake_lock_acquired);
+  }
+  ASSERT_EQ(acquire_wake_lock_count, 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  ASSERT_FALSE(is_wake_lock_acquired);
+}
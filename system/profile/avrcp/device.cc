@@ -15,6 +15,8 @@
  */
 #include "device.h"
 
+#include <algorithm>
+
 #include "abstract_message_loop.h"
 #include "avrcp_common.h"
 #include "connection_handler.h"
@@ -39,6 +41,9 @@ namespace avrcp {
 #define DEVICE_VLOG(LEVEL) \
   VLOG(LEVEL) << ADDRESS_TO_LOGGABLE_STR(address_) << " : "
 
+// Minimum interval between two play position changed notifications
+constexpr int64_t kPlayPosMinIntervalMs = 500;
+
 #define VOL_NOT_SUPPORTED -1
 #define VOL_REGISTRATION_FAILED -2
 
@@ -95,6 +100,16 @@ void filter_cover_art(SongInfo& s) {
   }
 }
 
+static bool is_same_song_info(const SongInfo& a, const SongInfo& b) {
+  if (a.media_id != b.media_id) return false;
+  return std::equal(a.attributes.begin(), a.attributes.end(),
+                    b.attributes.begin(), b.attributes.end(),
+                    [](const AttributeEntry& x, const AttributeEntry& y) {
+                      return x.attribute() == y.attribute() &&
+                             x.value() == y.value();
+                    });
+}
+
 bool Device::IsActive() const {
   return address_ == a2dp_interface_->active_peer();
 }
@@ -646,6 +661,23 @@ void Device::TrackChangedNotificationResponse(uint8_t label, bool interim,
       // for playing.
       return;
     }
+
+    // Some media sessions send the same metadata again on every update, only
+    // notify the remote when the current song or its attributes changed.
+    auto song = std::find_if(song_list.begin(), song_list.end(),
+                             [&curr_song_id](const SongInfo& info) {
+                               return info.media_id == curr_song_id;
+                             });
+    if (song != song_list.end() &&
+        is_same_song_info(*song, last_track_changed_info_)) {
+      DEVICE_VLOG(2) << __func__
+                     << ": Not sending notification due to no track update";
+      return;
+    }
+    last_track_changed_info_ = (song != song_list.end())
+                                   ? *song
+                                   : SongInfo{curr_song_id, {}};
+
     active_labels_.erase(label);
     track_changed_ = Notification(false, 0);
   }
@@ -744,6 +776,7 @@ void Device::PlaybackPosNotificationResponse(uint8_t label, bool interim,
   last_play_status_.position = status.position;
 
   if (!interim) {
+    last_play_pos_changed_ = base::TimeTicks::Now();
     active_labels_.erase(label);
     play_pos_changed_ = Notification(false, 0);
   }
@@ -1252,6 +1285,10 @@ void Device::HandleChangePath(uint8_t label,
                    << "\"";
   }
 
+  // The UIDs are only unique in the scope of the current folder, so drop the
+  // items of the previous one, the new UIDs keep counting up from them.
+  vfs_ids_.clear_items();
+
   media_interface_->GetFolderItems(
       curr_browsed_player_id_, CurrentFolder(),
       base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(),
@@ -1487,31 +1524,21 @@ void Device::GetVFSListResponse(uint8_t label,
   auto builder = GetFolderItemsResponseBuilder::MakeVFSBuilder(
       Status::NO_ERROR, 0x0000, browse_mtu_);
 
-  // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
-  // an operation.
-  for (const auto& item : items) {
-    if (item.type == ListItem::FOLDER) {
-      vfs_ids_.insert(item.folder.media_id);
-    } else if (item.type == ListItem::SONG) {
-      vfs_ids_.insert(item.song.media_id);
-    }
-  }
-
   // Add the elements retrieved in the last get folder items request and map
-  // them to UIDs The maps will be cleared every time a directory change
-  // happens. These items do not need to correspond with the now playing list as
-  // the UID's only need to be unique in the context of the current scope and
-  // the current folder
+  // them to UIDs as they are added, so only the items sent are mapped. The maps
+  // will be cleared every time a directory change happens. These items do not
+  // need to correspond with the now playing list as the UID's only need to be
+  // unique in the context of the current scope and the current folder.
   for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
-      FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
+      FolderItem folder_item(vfs_ids_.insert(folder.media_id), 0x00,
                              folder.is_playable, folder.name);
       if (!builder->AddFolder(folder_item)) break;
     } else if (items[i].type == ListItem::SONG) {
-      auto song = items[i].song;
+      auto& song = items[i].song;
 
       // Filter out DEFAULT_COVER_ART handle if this device has no client
       if (!HasBipClient()) {
@@ -1522,7 +1549,7 @@ void Device::GetVFSListResponse(uint8_t label,
           song.attributes.find(Attribute::TITLE) != song.attributes.end()
               ? song.attributes.find(Attribute::TITLE)->value()
               : "No Song Info";
-      MediaElementItem song_item(vfs_ids_.get_uid(song.media_id), title,
+      MediaElementItem song_item(vfs_ids_.insert(song.media_id), title,
                                  std::set<AttributeEntry>());
 
       if (pkt->GetNumAttributes() == 0x00) {  // All attributes requested
@@ -1555,7 +1582,7 @@ void Device::GetNowPlayingListResponse(
 
   for (size_t i = pkt->GetStartItem();
        i <= pkt->GetEndItem() && i < song_list.size(); i++) {
-    auto song = song_list[i];
+    auto& song = song_list[i];
 
     // Filter out DEFAULT_COVER_ART handle if this device has no client
     if (!HasBipClient()) {
@@ -1795,6 +1822,24 @@ void Device::HandlePlayPosUpdate() {
     return;
   }
 
+  // Some media sessions update the position many times per second, coalesce
+  // the updates so that the remote gets at most one per minimum interval,
+  // with the latest position.
+#if BASE_VER < 931007
+  auto min_interval = base::TimeDelta::FromMilliseconds(kPlayPosMinIntervalMs);
+#else
+  auto min_interval = base::Milliseconds(kPlayPosMinIntervalMs);
+#endif
+  auto elapsed = base::TimeTicks::Now() - last_play_pos_changed_;
+  if (elapsed < min_interval) {
+    DEVICE_VLOG(3) << __func__ << ": Coalescing play position update";
+    play_pos_coalesce_cb_.Reset(base::Bind(&Device::HandlePlayPosUpdate,
+                                           weak_ptr_factory_.GetWeakPtr()));
+    btbase::AbstractMessageLoop::current_task_runner()->PostDelayedTask(
+        FROM_HERE, play_pos_coalesce_cb_.callback(), min_interval - elapsed);
+    return;
+  }
+
   media_interface_->GetPlayStatus(base::Bind(
       &Device::PlaybackPosNotificationResponse, weak_ptr_factory_.GetWeakPtr(),
       play_pos_changed_.second, false));
@@ -1834,6 +1879,7 @@ void Device::HandleAddressedPlayerUpdate() {
 void Device::DeviceDisconnected() {
   DEVICE_LOG(INFO) << "Device was disconnected";
   play_pos_update_cb_.Cancel();
+  play_pos_coalesce_cb_.Cancel();
 
   // TODO (apanicke): Once the interfaces are set in the Device construction,
   // remove these conditionals.
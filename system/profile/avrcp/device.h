@@ -18,6 +18,7 @@
 
 #include <base/cancelable_callback.h>
 #include <base/functional/bind.h>
+#include <base/time/time.h>
 
 #include <iostream>
 #include <memory>
@@ -362,9 +363,13 @@ class Device {
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
+  SongInfo last_track_changed_info_;
   PlayStatus last_play_status_;
+  base::TimeTicks last_play_pos_changed_;
 
   base::CancelableClosure play_pos_update_cb_;
+  // Sends the play position updates coalesced within the minimum interval
+  base::CancelableClosure play_pos_coalesce_cb_;
 
   MediaInterface* media_interface_ = nullptr;
   A2dpInterface* a2dp_interface_ = nullptr;
@@ -16,7 +16,9 @@
 
 #pragma once
 
-#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace bluetooth {
 namespace avrcp {
@@ -24,39 +26,53 @@ namespace avrcp {
 // A helper class to convert Media ID's (represented as strings) that are
 // received from the AVRCP Media Interface layer into UID's to be used
 // with connected devices.
+//
+// The UID's are given in sequence, from 1, so the UID to Media ID direction
+// is a vector of pointers to the keys of the Media ID map.
 class MediaIdMap {
  public:
   void clear() {
+    clear_items();
+    first_uid_ = 1;
+  }
+
+  // Drops the mapped items but keeps counting the UID's up, so that the
+  // UID's of the dropped items are not given to other items.
+  void clear_items() {
+    first_uid_ += uid_to_media_id_.size();
     media_id_to_uid_.clear();
     uid_to_media_id_.clear();
   }
 
   std::string get_media_id(uint64_t uid) {
-    const auto& uid_it = uid_to_media_id_.find(uid);
-    if (uid_it == uid_to_media_id_.end()) return "";
-    return uid_it->second;
+    if (uid < first_uid_ || uid - first_uid_ >= uid_to_media_id_.size()) {
+      return "";
+    }
+    return *uid_to_media_id_[uid - first_uid_];
   }
 
-  uint64_t get_uid(std::string media_id) {
+  uint64_t get_uid(const std::string& media_id) {
     const auto& media_id_it = media_id_to_uid_.find(media_id);
     if (media_id_it == media_id_to_uid_.end()) return 0;
     return media_id_it->second;
   }
 
-  uint64_t insert(std::string media_id) {
-    if (media_id_to_uid_.find(media_id) != media_id_to_uid_.end()) {
-      return media_id_to_uid_[media_id];
-    }
+  uint64_t insert(const std::string& media_id) {
+    uint64_t uid = first_uid_ + uid_to_media_id_.size();
+    const auto& result = media_id_to_uid_.emplace(media_id, uid);
+    if (!result.second) return result.first->second;
 
-    uint64_t uid = media_id_to_uid_.size() + 1;
-    media_id_to_uid_.insert(std::pair<std::string, uint64_t>(media_id, uid));
-    uid_to_media_id_.insert(std::pair<uint64_t, std::string>(uid, media_id));
+    uid_to_media_id_.push_back(&result.first->first);
     return uid;
   }
 
+  size_t size() const { return uid_to_media_id_.size(); }
+
  private:
-  std::map<std::string, uint64_t> media_id_to_uid_;
-  std::map<uint64_t, std::string> uid_to_media_id_;
+  uint64_t first_uid_ = 1;
+  std::unordered_map<std::string, uint64_t> media_id_to_uid_;
+  // Keys of media_id_to_uid_, stable until erased, indexed by UID - first_uid_
+  std::vector<const std::string*> uid_to_media_id_;
 };
 
 }  // namespace avrcp
@@ -175,6 +175,47 @@ TEST_F(AvrcpDeviceTest, trackChangedTest) {
   test_device->HandleTrackUpdate();
 }
 
+TEST_F(AvrcpDeviceTest, trackChangedSameSongTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr,
+                                  nullptr);
+
+  SongInfo info = {"test_id",
+                   {// The attribute map
+                    AttributeEntry(Attribute::TITLE, "Test Song"),
+                    AttributeEntry(Attribute::ARTIST_NAME, "Test Artist")}};
+  std::vector<SongInfo> list = {info};
+
+  EXPECT_CALL(interface, GetNowPlayingList(_))
+      .Times(4)
+      .WillRepeatedly(InvokeCb<0>("test_id", list));
+
+  auto interim_response =
+      RegisterNotificationResponseBuilder::MakeTrackChangedBuilder(true, 0x01);
+  EXPECT_CALL(response_cb,
+              Call(1, false, matchPacket(std::move(interim_response))))
+      .Times(2);
+
+  // Only the first update of the song is sent
+  auto changed_response =
+      RegisterNotificationResponseBuilder::MakeTrackChangedBuilder(false, 0x01);
+  EXPECT_CALL(response_cb,
+              Call(1, false, matchPacket(std::move(changed_response))))
+      .Times(1);
+
+  for (int i = 0; i < 2; i++) {
+    auto request = RegisterNotificationRequestBuilder::MakeBuilder(
+        Event::TRACK_CHANGED, 0);
+    auto pkt = TestAvrcpPacket::Make();
+    request->Serialize(pkt);
+    SendMessage(1, pkt);
+
+    test_device->HandleTrackUpdate();
+  }
+}
+
 TEST_F(AvrcpDeviceTest, playerSettingsChangedTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
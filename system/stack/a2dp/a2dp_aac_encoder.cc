@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "a2dp_aac.h"
+#include "a2dp_abr.h"
 #include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -38,6 +39,9 @@
 // A2DP AAC encoder interval in milliseconds
 #define A2DP_AAC_ENCODER_INTERVAL_MS 20
 
+// Bit rate levels of the adaptive bit rate, down to half the configured one
+#define A2DP_AAC_ABR_NUM_LEVELS 5
+
 // offset
 #if (BTA_AV_CO_CP_SCMS_T == TRUE)
 #define A2DP_AAC_OFFSET (AVDT_MEDIA_OFFSET + 1)
@@ -88,6 +92,10 @@ typedef struct {
   tA2DP_AAC_ENCODER_PARAMS aac_encoder_params;
   tA2DP_AAC_FEEDING_STATE aac_feeding_state;
 
+  tA2DP_ABR abr;
+  AACENC_PARAM abr_param;     // AACENC_BITRATE, or AACENC_PEAK_BITRATE if VBR
+  uint32_t abr_max_bit_rate;  // Bit rate of the highest ABR level
+
   a2dp_aac_encoder_stats_t stats;
 } tA2DP_AAC_ENCODER_CB;
 
@@ -306,6 +314,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
         __func__, aac_param_value, aac_error);
     return;  // TODO: Return an error?
   }
+  a2dp_aac_encoder_cb.abr_max_bit_rate = aac_param_value;
 
   // Set the encoder's parameters: PEAK Bit Rate
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
@@ -399,6 +408,15 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
     return;  // TODO: Return an error?
   }
 
+  // The adaptive bit rate lowers the bit rate, or the peak bit rate bounding
+  // the variable bit rate modes
+  a2dp_abr_init(&a2dp_aac_encoder_cb.abr, A2DP_AAC_ABR_NUM_LEVELS);
+  a2dp_aac_encoder_cb.abr_param = AACENC_BITRATE;
+  if (aac_param_value != A2DP_AAC_VARIABLE_BIT_RATE_DISABLED) {
+    a2dp_aac_encoder_cb.abr_param = AACENC_PEAK_BITRATE;
+    a2dp_aac_encoder_cb.abr_max_bit_rate = aac_peak_bit_rate;
+  }
+
   // Mark the end of setting the encoder's parameters
   aac_error =
       aacEncEncode(a2dp_aac_encoder_cb.aac_handle, NULL, NULL, NULL, NULL);
@@ -497,6 +515,37 @@ void a2dp_aac_send_frames(uint64_t timestamp_us) {
   }
 }
 
+// Applies the bit rate of the current ABR level, from the next encoded frame.
+static void a2dp_aac_apply_abr_level(void) {
+  if (!a2dp_aac_encoder_cb.has_aac_handle) return;
+
+  uint32_t bit_rate = a2dp_abr_scale(&a2dp_aac_encoder_cb.abr,
+                                     a2dp_aac_encoder_cb.abr_max_bit_rate,
+                                     a2dp_aac_encoder_cb.abr_max_bit_rate / 2);
+  AACENC_ERROR aac_error = aacEncoder_SetParam(
+      a2dp_aac_encoder_cb.aac_handle, a2dp_aac_encoder_cb.abr_param, bit_rate);
+  if (aac_error != AACENC_OK) {
+    LOG_ERROR("%s: Cannot set AAC bit rate to %u: AAC error 0x%x", __func__,
+              bit_rate, aac_error);
+    return;
+  }
+  LOG_INFO("%s: ABR level %d bit rate %u", __func__,
+           a2dp_aac_encoder_cb.abr.level, bit_rate);
+}
+
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length) {
+  if (a2dp_abr_set_transmit_queue_length(&a2dp_aac_encoder_cb.abr,
+                                         transmit_queue_length)) {
+    a2dp_aac_apply_abr_level();
+  }
+}
+
+void a2dp_aac_on_transmit_flush(void) {
+  if (a2dp_abr_on_transmit_flush(&a2dp_aac_encoder_cb.abr)) {
+    a2dp_aac_apply_abr_level();
+  }
+}
+
 // Obtains the number of frames to send and number of iterations
 // to be used. |num_of_iterations| and |num_of_frames| parameters
 // are used as output param for returning the respective values.
@@ -722,6 +771,14 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
       ((codec_specific_1 & ~A2DP_AAC_VARIABLE_BIT_RATE_MASK) == 0 ? "Constant"
                                                                   : "Variable"),
       codec_specific_1);
+  dprintf(fd,
+          "  AAC bit rate (current/configured)                       : %u / "
+          "%u\n",
+          a2dp_abr_scale(&a2dp_aac_encoder_cb.abr,
+                         a2dp_aac_encoder_cb.abr_max_bit_rate,
+                         a2dp_aac_encoder_cb.abr_max_bit_rate / 2),
+          a2dp_aac_encoder_cb.abr_max_bit_rate);
+  a2dp_abr_debug_dump(&a2dp_aac_encoder_cb.abr, fd);
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_aac_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_aac_get_effective_frame_size());
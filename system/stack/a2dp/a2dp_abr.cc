@@ -0,0 +1,121 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "a2dp_abr"
+
+#include "a2dp_abr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "osi/include/log.h"
+
+// The average queue length is in 1/256 buffers, and moves 1/4 of the way
+// towards each sample
+#define A2DP_ABR_QUEUE_UNIT 256
+#define A2DP_ABR_QUEUE_SHIFT 2
+
+// The link is congested when the encoded packets of the previous ticks are
+// still queued, and clear when the queue is mostly empty
+#define A2DP_ABR_CONGESTED_QUEUE_AVERAGE (A2DP_ABR_QUEUE_UNIT * 5 / 4)
+#define A2DP_ABR_CLEAR_QUEUE_AVERAGE (A2DP_ABR_QUEUE_UNIT / 2)
+
+// Samples after a level change before stepping down again, so that the
+// queue can drain at the new level (~200 ms of 20 ms ticks)
+#define A2DP_ABR_HOLD_SAMPLES 10
+
+// Samples of clear link before stepping up again (~3 s of 20 ms ticks)
+#define A2DP_ABR_INCREASE_SAMPLES 150
+
+// Levels stepped down when the transmit queue overflowed
+#define A2DP_ABR_FLUSH_STEP 2
+
+void a2dp_abr_init(tA2DP_ABR* p_abr, uint8_t num_levels) {
+  memset(p_abr, 0, sizeof(*p_abr));
+  p_abr->num_levels = (num_levels > 0) ? num_levels : 1;
+}
+
+// Moves |p_abr| to |level|, returns true if it changed.
+static bool a2dp_abr_set_level(tA2DP_ABR* p_abr, int level) {
+  if (level < 0) level = 0;
+  if (level > p_abr->num_levels - 1) level = p_abr->num_levels - 1;
+  if (level == p_abr->level) return false;
+
+  LOG_INFO("%s: quality level %d -> %d (queue average %u/%d)", __func__,
+           p_abr->level, level, p_abr->queue_average, A2DP_ABR_QUEUE_UNIT);
+  if (level > p_abr->level) {
+    p_abr->total_decreases++;
+  } else {
+    p_abr->total_increases++;
+  }
+  p_abr->level = level;
+  p_abr->hold_samples = A2DP_ABR_HOLD_SAMPLES;
+  p_abr->clear_samples = 0;
+  return true;
+}
+
+bool a2dp_abr_set_transmit_queue_length(tA2DP_ABR* p_abr,
+                                        size_t transmit_queue_length) {
+  int32_t sample = transmit_queue_length * A2DP_ABR_QUEUE_UNIT;
+  int32_t average = p_abr->queue_average;
+  p_abr->queue_average =
+      average + (sample - average) / (1 << A2DP_ABR_QUEUE_SHIFT);
+
+  if (p_abr->hold_samples > 0) p_abr->hold_samples--;
+
+  if (p_abr->queue_average >= A2DP_ABR_CONGESTED_QUEUE_AVERAGE) {
+    p_abr->clear_samples = 0;
+    // Not while the queue is already draining
+    if (p_abr->hold_samples > 0 || sample < average) return false;
+    return a2dp_abr_set_level(p_abr, p_abr->level + 1);
+  }
+
+  if (p_abr->queue_average > A2DP_ABR_CLEAR_QUEUE_AVERAGE) {
+    p_abr->clear_samples = 0;
+    return false;
+  }
+
+  if (++p_abr->clear_samples < A2DP_ABR_INCREASE_SAMPLES) return false;
+  p_abr->clear_samples = 0;
+  return a2dp_abr_set_level(p_abr, p_abr->level - 1);
+}
+
+bool a2dp_abr_on_transmit_flush(tA2DP_ABR* p_abr) {
+  p_abr->total_flushes++;
+  // The queue is empty after the flush, yet the link is congested
+  p_abr->queue_average = 0;
+  p_abr->clear_samples = 0;
+  return a2dp_abr_set_level(p_abr, p_abr->level + A2DP_ABR_FLUSH_STEP);
+}
+
+uint32_t a2dp_abr_scale(const tA2DP_ABR* p_abr, uint32_t max_value,
+                        uint32_t min_value) {
+  if (p_abr->num_levels <= 1 || min_value >= max_value) return max_value;
+  uint64_t range = max_value - min_value;
+  return max_value - (uint32_t)(range * p_abr->level / (p_abr->num_levels - 1));
+}
+
+void a2dp_abr_debug_dump(const tA2DP_ABR* p_abr, int fd) {
+  dprintf(fd,
+          "  ABR quality level (current/lowest)                      : %d / "
+          "%d\n",
+          p_abr->level, p_abr->num_levels - 1);
+  dprintf(fd,
+          "  ABR level changes (decreases/increases/flushes)         : %zu / "
+          "%zu / %zu\n",
+          p_abr->total_decreases, p_abr->total_increases,
+          p_abr->total_flushes);
+}
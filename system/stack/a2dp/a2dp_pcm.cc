@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "a2dp_pcm.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Frames of the scalar loops, from |start|, once the vector loops are done
+static void a2dp_pcm_deinterleave_16_scalar(const int16_t* src, int32_t* left,
+                                            int32_t* right, size_t start,
+                                            size_t frames) {
+  for (size_t i = start; i < frames; i++) {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+
+static void a2dp_pcm_deinterleave_24_packed_scalar(const uint8_t* src,
+                                                   int32_t* left,
+                                                   int32_t* right,
+                                                   size_t start,
+                                                   size_t frames) {
+  const uint8_t* p = src + 6 * start;
+  for (size_t i = start; i < frames; i++) {
+    left[i] = p[0] | (p[1] << 8) | (((int8_t)p[2]) << 16);
+    right[i] = p[3] | (p[4] << 8) | (((int8_t)p[5]) << 16);
+    p += 6;
+  }
+}
+
+void a2dp_pcm_deinterleave_16(const int16_t* src, int32_t* left,
+                              int32_t* right, size_t frames) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  // Each 32 bits lane holds a frame, the left sample in the low half
+  for (; i + 4 <= frames; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + 2 * i));
+    _mm_storeu_si128((__m128i*)(left + i),
+                     _mm_srai_epi32(_mm_slli_epi32(v, 16), 16));
+    _mm_storeu_si128((__m128i*)(right + i), _mm_srai_epi32(v, 16));
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 8 <= frames; i += 8) {
+    int16x8x2_t v = vld2q_s16(src + 2 * i);
+    vst1q_s32(left + i, vmovl_s16(vget_low_s16(v.val[0])));
+    vst1q_s32(left + i + 4, vmovl_s16(vget_high_s16(v.val[0])));
+    vst1q_s32(right + i, vmovl_s16(vget_low_s16(v.val[1])));
+    vst1q_s32(right + i + 4, vmovl_s16(vget_high_s16(v.val[1])));
+  }
+#endif
+  a2dp_pcm_deinterleave_16_scalar(src, left, right, i, frames);
+}
+
+void a2dp_pcm_deinterleave_24_packed(const uint8_t* src, int32_t* left,
+                                     int32_t* right, size_t frames) {
+  size_t i = 0;
+#if defined(__SSSE3__)
+  // 4 frames span the 24 bytes of two overlapping loads, at 0 and 8. The
+  // shuffles move each sample to the 3 upper bytes of a lane, and the
+  // arithmetic shift sign extends it.
+  const __m128i left_lo = _mm_setr_epi8(-1, 0, 1, 2, -1, 6, 7, 8, -1, 12, 13,
+                                        14, -1, -1, -1, -1);
+  const __m128i left_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, 10, 11, 12);
+  const __m128i right_lo = _mm_setr_epi8(-1, 3, 4, 5, -1, 9, 10, 11, -1, -1,
+                                         -1, -1, -1, -1, -1, -1);
+  const __m128i right_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         7, 8, 9, -1, 13, 14, 15);
+  for (; i + 4 <= frames; i += 4) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)(src + 6 * i));
+    __m128i hi = _mm_loadu_si128((const __m128i*)(src + 6 * i + 8));
+    __m128i l = _mm_or_si128(_mm_shuffle_epi8(lo, left_lo),
+                             _mm_shuffle_epi8(hi, left_hi));
+    __m128i r = _mm_or_si128(_mm_shuffle_epi8(lo, right_lo),
+                             _mm_shuffle_epi8(hi, right_hi));
+    _mm_storeu_si128((__m128i*)(left + i), _mm_srai_epi32(l, 8));
+    _mm_storeu_si128((__m128i*)(right + i), _mm_srai_epi32(r, 8));
+  }
+#elif defined(__ARM_NEON)
+  // The loads split the 3 bytes of the samples, alternately left and right
+  for (; i + 8 <= frames; i += 8) {
+    uint8x16x3_t v = vld3q_u8(src + 6 * i);
+    for (int half = 0; half < 2; half++) {
+      uint8x8_t b0 = half ? vget_high_u8(v.val[0]) : vget_low_u8(v.val[0]);
+      uint8x8_t b1 = half ? vget_high_u8(v.val[1]) : vget_low_u8(v.val[1]);
+      uint8x8_t b2 = half ? vget_high_u8(v.val[2]) : vget_low_u8(v.val[2]);
+      uint16x8_t low = vorrq_u16(vmovl_u8(b0), vshlq_n_u16(vmovl_u8(b1), 8));
+      int16x8_t high = vmovl_s8(vreinterpret_s8_u8(b2));
+      int32x4_t s0 = vorrq_s32(
+          vshlq_n_s32(vmovl_s16(vget_low_s16(high)), 16),
+          vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+      int32x4_t s1 = vorrq_s32(
+          vshlq_n_s32(vmovl_s16(vget_high_s16(high)), 16),
+          vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))));
+      int32x4x2_t lr = vuzpq_s32(s0, s1);
+      vst1q_s32(left + i + 4 * half, lr.val[0]);
+      vst1q_s32(right + i + 4 * half, lr.val[1]);
+    }
+  }
+#endif
+  a2dp_pcm_deinterleave_24_packed_scalar(src, left, right, i, frames);
+}
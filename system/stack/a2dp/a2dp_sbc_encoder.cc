@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_abr.h"
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
@@ -40,6 +41,13 @@
 // A2DP SBC encoder interval in milliseconds.
 #define A2DP_SBC_ENCODER_INTERVAL_MS 20
 
+// A2DP SBC encoder interval in milliseconds, in low latency mode.
+#define A2DP_SBC_LOW_LATENCY_ENCODER_INTERVAL_MS 10
+
+// Maximum number of SBC frames per packet in low latency mode, about one
+// encoder interval of audio, rather than as many as the MTU allows.
+#define A2DP_SBC_LOW_LATENCY_MAX_FRAMES_PER_PACKET 4
+
 /* High quality quality setting @ 44.1 khz */
 #define A2DP_SBC_DEFAULT_BITRATE 328
 
@@ -53,6 +61,9 @@
 /* Define the bitrate step when trying to match bitpool value */
 #define A2DP_SBC_BITRATE_STEP 5
 
+/* Bitpool levels of the adaptive bit rate, down to half the configured one */
+#define A2DP_SBC_ABR_NUM_LEVELS 5
+
 /* Readability constants */
 #define A2DP_SBC_FRAME_HEADER_SIZE_BYTES 4  // A2DP Spec v1.3, 12.4, Table 12.12
 #define A2DP_SBC_SCALE_FACTOR_BITS 4        // A2DP Spec v1.3, 12.4, Table 12.13
@@ -96,6 +107,7 @@ typedef struct {
   a2dp_source_enqueue_callback_t enqueue_callback;
   uint16_t TxAaMtuSize;
   uint8_t tx_sbc_frames;
+  uint32_t encoder_interval_ms;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   uint32_t timestamp;       /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
@@ -103,6 +115,10 @@ typedef struct {
   tA2DP_SBC_FEEDING_STATE feeding_state;
   int16_t pcmBuffer[SBC_MAX_PCM_BUFFER_SIZE];
 
+  tA2DP_ABR abr;
+  int16_t abr_max_bitpool; /* bitpool of the highest ABR level */
+  int16_t abr_min_bitpool; /* bitpool of the lowest ABR level */
+
   a2dp_sbc_encoder_stats_t stats;
 } tA2DP_SBC_ENCODER_CB;
 
@@ -145,6 +161,9 @@ void a2dp_sbc_encoder_init(const tA2DP_ENCODER_INIT_PEER_PARAMS* p_peer_params,
   a2dp_sbc_encoder_cb.enqueue_callback = enqueue_callback;
   a2dp_sbc_encoder_cb.peer_params = *p_peer_params;
   a2dp_sbc_encoder_cb.timestamp = 0;
+  a2dp_sbc_encoder_cb.encoder_interval_ms =
+      p_peer_params->is_low_latency ? A2DP_SBC_LOW_LATENCY_ENCODER_INTERVAL_MS
+                                    : A2DP_SBC_ENCODER_INTERVAL_MS;
 
   // NOTE: Ignore the restart_input / restart_output flags - this initization
   // happens when the audio session is (re)started.
@@ -331,6 +350,12 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   /* Finally update the bitpool in the encoder structure */
   p_encoder_params->s16BitPool = s16BitPool;
 
+  /* The adaptive bit rate steps the bitpool down from the configured one */
+  a2dp_abr_init(&a2dp_sbc_encoder_cb.abr, A2DP_SBC_ABR_NUM_LEVELS);
+  a2dp_sbc_encoder_cb.abr_max_bitpool = s16BitPool;
+  a2dp_sbc_encoder_cb.abr_min_bitpool =
+      (s16BitPool / 2 > min_bitpool) ? s16BitPool / 2 : min_bitpool;
+
   LOG_INFO("%s: final bit rate %d, final bit pool %d", __func__,
            p_encoder_params->u16BitRate, p_encoder_params->s16BitPool);
 
@@ -352,7 +377,7 @@ void a2dp_sbc_feeding_reset(void) {
       (a2dp_sbc_encoder_cb.feeding_params.sample_rate *
        a2dp_sbc_encoder_cb.feeding_params.bits_per_sample / 8 *
        a2dp_sbc_encoder_cb.feeding_params.channel_count *
-       A2DP_SBC_ENCODER_INTERVAL_MS) /
+       a2dp_sbc_encoder_cb.encoder_interval_ms) /
       1000;
 
   LOG_INFO("%s: PCM bytes per tick %u", __func__,
@@ -365,7 +390,7 @@ void a2dp_sbc_feeding_flush(void) {
 }
 
 uint64_t a2dp_sbc_get_encoder_interval_ms(void) {
-  return A2DP_SBC_ENCODER_INTERVAL_MS;
+  return a2dp_sbc_encoder_cb.encoder_interval_ms;
 }
 
 int a2dp_sbc_get_effective_frame_size() {
@@ -387,6 +412,29 @@ void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   }
 }
 
+// Applies the bitpool of the current ABR level, to the next encoded frames.
+static void a2dp_sbc_apply_abr_level(void) {
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  p_encoder_params->s16BitPool = (int16_t)a2dp_abr_scale(
+      &a2dp_sbc_encoder_cb.abr, a2dp_sbc_encoder_cb.abr_max_bitpool,
+      a2dp_sbc_encoder_cb.abr_min_bitpool);
+  LOG_INFO("%s: ABR level %d bitpool %d", __func__,
+           a2dp_sbc_encoder_cb.abr.level, p_encoder_params->s16BitPool);
+}
+
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  if (a2dp_abr_set_transmit_queue_length(&a2dp_sbc_encoder_cb.abr,
+                                         transmit_queue_length)) {
+    a2dp_sbc_apply_abr_level();
+  }
+}
+
+void a2dp_sbc_on_transmit_flush(void) {
+  if (a2dp_abr_on_transmit_flush(&a2dp_sbc_encoder_cb.abr)) {
+    a2dp_sbc_apply_abr_level();
+  }
+}
+
 // Obtains the number of frames to send and number of iterations
 // to be used. |num_of_iterations| and |num_of_frames| parameters
 // are used as output param for returning the respective values.
@@ -404,7 +452,7 @@ static void a2dp_sbc_get_num_frame_iteration(uint8_t* num_of_iterations,
       a2dp_sbc_encoder_cb.feeding_params.bits_per_sample / 8;
   LOG_VERBOSE("%s: pcm_bytes_per_frame %u", __func__, pcm_bytes_per_frame);
 
-  uint32_t us_this_tick = A2DP_SBC_ENCODER_INTERVAL_MS * 1000;
+  uint32_t us_this_tick = a2dp_sbc_encoder_cb.encoder_interval_ms * 1000;
   uint64_t now_us = timestamp_us;
   if (a2dp_sbc_encoder_cb.feeding_state.last_frame_us != 0)
     us_this_tick = (now_us - a2dp_sbc_encoder_cb.feeding_state.last_frame_us);
@@ -412,7 +460,7 @@ static void a2dp_sbc_get_num_frame_iteration(uint8_t* num_of_iterations,
 
   a2dp_sbc_encoder_cb.feeding_state.counter +=
       (float)a2dp_sbc_encoder_cb.feeding_state.bytes_per_tick *
-      (float)us_this_tick / (A2DP_SBC_ENCODER_INTERVAL_MS * 1000);
+      (float)us_this_tick / (a2dp_sbc_encoder_cb.encoder_interval_ms * 1000);
 
   /* Calculate the number of frames pending for this media tick */
   projected_nof =
@@ -796,6 +844,13 @@ static uint8_t calculate_max_frames_per_packet(void) {
       LOG_ERROR("%s: Max number of SBC frames: %d", __func__, result);
       break;
   }
+
+  if (a2dp_sbc_encoder_cb.peer_params.is_low_latency &&
+      result > A2DP_SBC_LOW_LATENCY_MAX_FRAMES_PER_PACKET) {
+    LOG_INFO("%s: low latency mode, limiting SBC frames from %d to %d",
+             __func__, result, A2DP_SBC_LOW_LATENCY_MAX_FRAMES_PER_PACKET);
+    result = A2DP_SBC_LOW_LATENCY_MAX_FRAMES_PER_PACKET;
+  }
   return result;
 }
 
@@ -895,6 +950,12 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
         "  SBC Bitpool (min/max)                                   : %d / %d\n",
         A2DP_GetMinBitpoolSbc(codec_info), A2DP_GetMaxBitpoolSbc(codec_info));
   }
+  dprintf(fd,
+          "  SBC Encoder bitpool (current/configured)                : %d / "
+          "%d\n",
+          a2dp_sbc_encoder_cb.sbc_encoder_params.s16BitPool,
+          a2dp_sbc_encoder_cb.abr_max_bitpool);
+  a2dp_abr_debug_dump(&a2dp_sbc_encoder_cb.abr, fd);
 
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_sbc_get_encoder_interval_ms());
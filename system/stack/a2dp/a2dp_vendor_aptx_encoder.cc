@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_pcm.h"
 #include "a2dp_vendor.h"
 #include "a2dp_vendor_aptx.h"
 #include "aptXbtenc.h"
@@ -95,8 +96,8 @@ static void a2dp_vendor_aptx_encoder_update(A2dpCodecConfig* a2dp_codec_config,
 static void aptx_init_framing_params(tAPTX_FRAMING_PARAMS* framing_params);
 static void aptx_update_framing_params(tAPTX_FRAMING_PARAMS* framing_params);
 static size_t aptx_encode_16bit(tAPTX_FRAMING_PARAMS* framing_params,
-                                size_t* data_out_index, uint16_t* data16_in,
-                                uint8_t* data_out);
+                                size_t* data_out_index, int32_t* pcm_left,
+                                int32_t* pcm_right, uint8_t* data_out);
 
 /*******************************************************************************
  *
@@ -323,7 +324,9 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
   //
   // Read the PCM data and encode it
   //
-  uint16_t read_buffer16[A2DP_APTX_MAX_PCM_BYTES_PER_READ / sizeof(uint16_t)];
+  int16_t read_buffer16[A2DP_APTX_MAX_PCM_BYTES_PER_READ / sizeof(int16_t)];
+  int32_t pcm_left[A2DP_APTX_MAX_PCM_BYTES_PER_READ / 4];
+  int32_t pcm_right[A2DP_APTX_MAX_PCM_BYTES_PER_READ / 4];
   uint32_t expected_read_bytes =
       framing_params->pcm_reads * framing_params->pcm_bytes_per_read;
   size_t encoded_ptr_index = 0;
@@ -348,11 +351,14 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
   }
   a2dp_aptx_encoder_cb.stats.media_read_total_actual_reads_count++;
 
+  // The encoder takes the samples of each channel from its own buffer
+  a2dp_pcm_deinterleave_16(read_buffer16, pcm_left, pcm_right,
+                           expected_read_bytes / 4);
   for (uint32_t reads = 0, offset = 0; reads < framing_params->pcm_reads;
-       reads++, offset +=
-                (framing_params->pcm_bytes_per_read / sizeof(uint16_t))) {
-    pcm_bytes_encoded += aptx_encode_16bit(framing_params, &encoded_ptr_index,
-                                           read_buffer16 + offset, encoded_ptr);
+       reads++, offset += framing_params->pcm_bytes_per_read / 4) {
+    pcm_bytes_encoded +=
+        aptx_encode_16bit(framing_params, &encoded_ptr_index,
+                          pcm_left + offset, pcm_right + offset, encoded_ptr);
   }
 
   // Compute the number of encoded bytes
@@ -379,24 +385,18 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
 }
 
 static size_t aptx_encode_16bit(tAPTX_FRAMING_PARAMS* framing_params,
-                                size_t* data_out_index, uint16_t* data16_in,
-                                uint8_t* data_out) {
+                                size_t* data_out_index, int32_t* pcm_left,
+                                int32_t* pcm_right, uint8_t* data_out) {
   size_t pcm_bytes_encoded = 0;
   size_t frame = 0;
 
   for (size_t aptx_samples = 0;
        aptx_samples < framing_params->pcm_bytes_per_read / 16; aptx_samples++) {
-    uint32_t pcmL[4];
-    uint32_t pcmR[4];
     uint16_t encoded_sample[2];
 
-    for (size_t i = 0, j = frame; i < 4; i++, j++) {
-      pcmL[i] = (uint16_t) * (data16_in + (2 * j));
-      pcmR[i] = (uint16_t) * (data16_in + ((2 * j) + 1));
-    }
-
-    aptx_api.encode_stereo_func(a2dp_aptx_encoder_cb.aptx_encoder_state, &pcmL,
-                                &pcmR, &encoded_sample);
+    aptx_api.encode_stereo_func(a2dp_aptx_encoder_cb.aptx_encoder_state,
+                                pcm_left + frame, pcm_right + frame,
+                                &encoded_sample);
 
     data_out[*data_out_index + 0] = (uint8_t)((encoded_sample[0] >> 8) & 0xff);
     data_out[*data_out_index + 1] = (uint8_t)((encoded_sample[0] >> 0) & 0xff);
@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_pcm.h"
 #include "a2dp_vendor.h"
 #include "a2dp_vendor_aptx_hd.h"
 #include "aptXHDbtenc.h"
@@ -95,8 +96,8 @@ static void aptx_hd_init_framing_params(
 static void aptx_hd_update_framing_params(
     tAPTX_HD_FRAMING_PARAMS* framing_params);
 static size_t aptx_hd_encode_24bit(tAPTX_HD_FRAMING_PARAMS* framing_params,
-                                   size_t* data_out_index, uint32_t* data32_in,
-                                   uint8_t* data_out);
+                                   size_t* data_out_index, int32_t* pcm_left,
+                                   int32_t* pcm_right, uint8_t* data_out);
 
 /*******************************************************************************
  *
@@ -309,6 +310,8 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
   //
   uint32_t
       read_buffer32[A2DP_APTX_HD_MAX_PCM_BYTES_PER_READ / sizeof(uint32_t)];
+  int32_t pcm_left[A2DP_APTX_HD_MAX_PCM_BYTES_PER_READ / 6];
+  int32_t pcm_right[A2DP_APTX_HD_MAX_PCM_BYTES_PER_READ / 6];
   uint32_t expected_read_bytes =
       framing_params->pcm_reads * framing_params->pcm_bytes_per_read;
   size_t encoded_ptr_index = 0;
@@ -334,12 +337,17 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
   }
   a2dp_aptx_hd_encoder_cb.stats.media_read_total_actual_reads_count++;
 
+  // Expand the AUDIO_FORMAT_PCM_24_BIT_PACKED data (3 bytes per sample) into
+  // the AUDIO_FORMAT_PCM_8_24_BIT samples (4 bytes per sample), one buffer
+  // per channel as taken by the encoder
+  a2dp_pcm_deinterleave_24_packed((const uint8_t*)read_buffer32, pcm_left,
+                                  pcm_right, expected_read_bytes / 6);
   for (uint32_t reads = 0, offset = 0; reads < framing_params->pcm_reads;
-       reads++, offset +=
-                framing_params->pcm_bytes_per_read / sizeof(uint32_t)) {
+       reads++, offset += framing_params->pcm_bytes_per_read / 6) {
     pcm_bytes_encoded +=
         aptx_hd_encode_24bit(framing_params, &encoded_ptr_index,
-                             read_buffer32 + offset, encoded_ptr);
+                             pcm_left + offset, pcm_right + offset,
+                             encoded_ptr);
   }
 
   // Compute the number of encoded bytes
@@ -367,30 +375,19 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
 }
 
 static size_t aptx_hd_encode_24bit(tAPTX_HD_FRAMING_PARAMS* framing_params,
-                                   size_t* data_out_index, uint32_t* data32_in,
-                                   uint8_t* data_out) {
+                                   size_t* data_out_index, int32_t* pcm_left,
+                                   int32_t* pcm_right, uint8_t* data_out) {
   size_t pcm_bytes_encoded = 0;
-  const uint8_t* p = (const uint8_t*)(data32_in);
+  size_t frame = 0;
 
   for (size_t aptx_hd_samples = 0;
        aptx_hd_samples < framing_params->pcm_bytes_per_read / 24;
        aptx_hd_samples++) {
-    uint32_t pcmL[4];
-    uint32_t pcmR[4];
     uint32_t encoded_sample[2];
 
-    // Expand from AUDIO_FORMAT_PCM_24_BIT_PACKED data (3 bytes per sample)
-    // into AUDIO_FORMAT_PCM_8_24_BIT (4 bytes per sample).
-    for (size_t i = 0; i < 4; i++) {
-      pcmL[i] = ((p[0] << 0) | (p[1] << 8) | (((int8_t)p[2]) << 16));
-      p += 3;
-      pcmR[i] = ((p[0] << 0) | (p[1] << 8) | (((int8_t)p[2]) << 16));
-      p += 3;
-    }
-
     aptx_hd_api.encode_stereo_func(
-        a2dp_aptx_hd_encoder_cb.aptx_hd_encoder_state, &pcmL, &pcmR,
-        &encoded_sample);
+        a2dp_aptx_hd_encoder_cb.aptx_hd_encoder_state, pcm_left + frame,
+        pcm_right + frame, &encoded_sample);
 
     uint8_t* encoded_ptr = (uint8_t*)&encoded_sample[0];
     data_out[*data_out_index + 0] = *(encoded_ptr + 2);
@@ -400,6 +397,7 @@ static size_t aptx_hd_encode_24bit(tAPTX_HD_FRAMING_PARAMS* framing_params,
     data_out[*data_out_index + 4] = *(encoded_ptr + 5);
     data_out[*data_out_index + 5] = *(encoded_ptr + 4);
 
+    frame += 4;
     pcm_bytes_encoded += 24;
     *data_out_index += 6;
   }
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "a2dp_abr.h"
 #include "a2dp_vendor.h"
 #include "a2dp_vendor_opus.h"
 #include "common/time_util.h"
@@ -32,6 +33,9 @@
 #include "osi/include/osi.h"
 #include "stack/include/bt_hdr.h"
 
+// Bit rate levels of the adaptive bit rate, down to half the configured one
+#define A2DP_OPUS_ABR_NUM_LEVELS 5
+
 typedef struct {
   uint32_t sample_rate;
   uint16_t bitrate;
@@ -80,6 +84,8 @@ typedef struct {
   tA2DP_OPUS_ENCODER_PARAMS opus_encoder_params;
   tA2DP_OPUS_FEEDING_STATE opus_feeding_state;
 
+  tA2DP_ABR abr;
+
   a2dp_opus_encoder_stats_t stats;
 } tA2DP_OPUS_ENCODER_CB;
 
@@ -277,6 +283,7 @@ static bool a2dp_vendor_opus_encoder_update(uint16_t peer_mtu,
     LOG_ERROR("failed to set encoder bitrate");
     return false;
   }
+  a2dp_abr_init(&a2dp_opus_encoder_cb.abr, A2DP_OPUS_ABR_NUM_LEVELS);
 
   // Set the Audio format from pcm_wlength
   if (p_encoder_params->pcm_wlength == 2)
@@ -478,12 +485,42 @@ static bool a2dp_opus_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
   return true;
 }
 
+// Returns the bit rate of the current ABR level.
+static uint32_t a2dp_opus_get_abr_bitrate(void) {
+  uint32_t bitrate = a2dp_opus_encoder_cb.opus_encoder_params.bitrate;
+  return a2dp_abr_scale(&a2dp_opus_encoder_cb.abr, bitrate, bitrate / 2);
+}
+
+// Applies the bit rate of the current ABR level, from the next encoded frame.
+static void a2dp_opus_apply_abr_level(void) {
+  if (!a2dp_opus_encoder_cb.has_opus_handle) return;
+
+  uint32_t bitrate = a2dp_opus_get_abr_bitrate();
+  int error = opus_encoder_ctl(a2dp_opus_encoder_cb.opus_handle,
+                               OPUS_SET_BITRATE(bitrate));
+  if (error != OPUS_OK) {
+    LOG_ERROR("failed to set encoder bitrate to %u", bitrate);
+    return;
+  }
+  LOG_INFO("ABR level %d bitrate %u", a2dp_opus_encoder_cb.abr.level, bitrate);
+}
+
 void a2dp_vendor_opus_set_transmit_queue_length(size_t transmit_queue_length) {
   a2dp_opus_encoder_cb.TxQueueLength = transmit_queue_length;
+  if (a2dp_abr_set_transmit_queue_length(&a2dp_opus_encoder_cb.abr,
+                                         transmit_queue_length)) {
+    a2dp_opus_apply_abr_level();
+  }
 
   return;
 }
 
+void a2dp_vendor_opus_on_transmit_flush(void) {
+  if (a2dp_abr_on_transmit_flush(&a2dp_opus_encoder_cb.abr)) {
+    a2dp_opus_apply_abr_level();
+  }
+}
+
 uint64_t A2dpCodecConfigOpusSource::encoderIntervalMs() const {
   return a2dp_vendor_opus_get_encoder_interval_ms();
 }
@@ -525,5 +562,10 @@ void A2dpCodecConfigOpusSource::debug_codec_dump(int fd) {
           "  OPUS saved transmit queue length                        : %zu\n",
           a2dp_opus_encoder_cb.TxQueueLength);
 
+  dprintf(fd,
+          "  OPUS ABR bitrate                                        : %u\n",
+          a2dp_opus_get_abr_bitrate());
+  a2dp_abr_debug_dump(&a2dp_opus_encoder_cb.abr, fd);
+
   return;
 }
@@ -44,4 +44,5 @@ void tACL_CONN::Reset() {
   rs_disc_pending = BTM_SEC_RS_NOT_PENDING;
   switch_role_state_ = BTM_ACL_SWKEY_STATE_IDLE;
   sca = 0;
+  traffic_bytes = 0;
 }
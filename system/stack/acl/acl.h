@@ -309,6 +309,7 @@ struct tACL_CONN {
 
  public:
   uint8_t sca; /* Sleep clock accuracy */
+  uint64_t traffic_bytes; /* ACL data sent and received, for power management */
 
   void Reset();
 
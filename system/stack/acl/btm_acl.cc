@@ -1316,6 +1316,15 @@ uint16_t BTM_GetHCIConnHandle(const RawAddress& remote_bda,
   return HCI_INVALID_HANDLE;
 }
 
+uint64_t BTM_GetAclTrafficBytes(const RawAddress& remote_bda,
+                                tBT_TRANSPORT transport) {
+  tACL_CONN* p_acl = internal_.btm_bda_to_acl(remote_bda, transport);
+  if (p_acl == nullptr) {
+    return 0;
+  }
+  return p_acl->traffic_bytes;
+}
+
 /*******************************************************************************
  *
  * Function         BTM_IsPhy2mSupported
@@ -2830,6 +2839,7 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
       osi_free(p_buf);
       return;
     }
+    p_acl->traffic_bytes += p_buf->len;
     return bluetooth::shim::ACL_WriteData(p_acl->hci_handle, p_buf);
 }
 
@@ -2930,6 +2940,11 @@ void acl_rcv_acl_data(BT_HDR* p_msg) {
     osi_free(p_msg);
     return;
   }
+  tACL_CONN* p_acl =
+      internal_.acl_get_connection_from_handle(acl_header.handle);
+  if (p_acl != nullptr) {
+    p_acl->traffic_bytes += acl_header.hci_len;
+  }
   l2c_rcv_acl_data(p_msg);
 }
 
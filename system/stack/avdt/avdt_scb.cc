@@ -763,6 +763,23 @@ void avdt_scb_event(AvdtpScb* p_scb, uint8_t event, tAVDT_SCB_EVT* p_data) {
       avdt_scb_st_str[p_scb->state], p_scb, p_scb->stream_config.scb_index);
 #endif
 
+  /* Fast path for the media packets of the streaming state, same actions
+   * as avdt_scb_st_stream. Only the current stream can write, it stays the
+   * current stream while streaming. */
+  if (p_scb->state == AVDT_SCB_STREAM_ST) {
+    if (event == AVDT_SCB_TC_DATA_EVT) {
+      p_scb->curr_evt = event;
+      avdt_scb_hdl_pkt(p_scb, p_data);
+      return;
+    }
+    if (event == AVDT_SCB_API_WRITE_REQ_EVT && p_scb->curr_stream) {
+      p_scb->curr_evt = event;
+      avdt_scb_hdl_write_req(p_scb, p_data);
+      avdt_scb_chk_snd_pkt(p_scb, p_data);
+      return;
+    }
+  }
+
   /* Check that we only send AVDT_SCB_API_WRITE_REQ_EVT to the active stream
    * device */
   uint8_t num_st_streams = 0;
@@ -25,7 +25,10 @@
 #include <base/functional/bind.h>
 #include <string.h>
 
+#include <vector>
+
 #include "btm_ble_int.h"
+#include "common/lru.h"
 #include "device/include/controller.h"
 #include "gap_api.h"
 #include "main/shim/shim.h"
@@ -154,26 +157,98 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
   return false;
 }
 
-/** This function match the random address to the appointed device record,
- * starting from calculating IRK. If the record index exceeds the maximum record
- * number, matching failed and send a callback. */
-static bool btm_ble_match_random_bda(void* data, void* context) {
-  tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
-  RawAddress* random_bda = static_cast<RawAddress*>(context);
+namespace {
 
-  if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
-      !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
-    // Match fails preconditions
-    return true;
+/* The random addresses resolved last, kept until most of them rotated */
+constexpr size_t kResolvedRandomAddrCacheSize = 64;
 
-  if (rpa_matches_irk(*random_bda, p_dev_rec->ble.keys.irk)) {
-    // Matched
-    return false;
+/* Resolves the random addresses in software, with the IRKs of all the
+ * security records at once. The key schedules of the IRKs are expanded once,
+ * and the result of each address is cached until the IRKs change. */
+class RandomAddrResolver {
+ public:
+  tBTM_SEC_DEV_REC* Resolve(const RawAddress& random_bda) {
+    UpdateIrks();
+
+    int index;
+    if (!resolved_.Get(random_bda, &index)) {
+      index = Match(random_bda);
+      resolved_.Put(random_bda, index);
+    }
+    return (index < 0) ? nullptr : records_[index];
   }
 
-  // This item not a match, continue iteration
-  return true;
-}
+ private:
+  /* Collects the records with an IRK, in the order of the list, and expands
+   * the IRKs that changed since the last call */
+  void UpdateIrks() {
+    records_.clear();
+
+    bool irks_changed = false;
+    list_node_t* end = list_end(btm_cb.sec_dev_rec);
+    for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+         node = list_next(node)) {
+      tBTM_SEC_DEV_REC* p_dev_rec =
+          static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
+      if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
+          !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
+        continue;
+
+      size_t index = records_.size();
+      records_.push_back(p_dev_rec);
+      const Octet16& irk = p_dev_rec->ble.keys.irk;
+      if (index == irks_.size()) {
+        irks_.push_back(irk);
+        schedules_.push_back(crypto_toolbox::aes_128_key_schedule(irk));
+        irks_changed = true;
+      } else if (irks_[index] != irk) {
+        irks_[index] = irk;
+        schedules_[index] = crypto_toolbox::aes_128_key_schedule(irk);
+        irks_changed = true;
+      }
+    }
+
+    if (irks_.size() != records_.size()) {
+      irks_.resize(records_.size());
+      schedules_.resize(records_.size());
+      irks_changed = true;
+    }
+
+    /* The indexes of the cached results are of the previous IRKs */
+    if (irks_changed) resolved_.Clear();
+  }
+
+  /* Returns the index of the first IRK resolving |rpa|, or -1 */
+  int Match(const RawAddress& rpa) {
+    if (!BTM_BLE_IS_RESOLVE_BDA(rpa) || schedules_.empty()) return -1;
+
+    /* use the 3 MSB of bd address as prand */
+    Octet16 prand{rpa.address[2], rpa.address[1], rpa.address[0]};
+    hashes_.resize(schedules_.size());
+    crypto_toolbox::aes_128_multi_key(schedules_.data(), schedules_.size(),
+                                      prand, hashes_.data());
+
+    /* the hash is the 3 LSB of bd address */
+    for (size_t i = 0; i < hashes_.size(); i++) {
+      if (hashes_[i][0] == rpa.address[5] && hashes_[i][1] == rpa.address[4] &&
+          hashes_[i][2] == rpa.address[3])
+        return i;
+    }
+    return -1;
+  }
+
+  /* Only valid during a call, the records can be freed in between */
+  std::vector<tBTM_SEC_DEV_REC*> records_;
+  std::vector<Octet16> irks_;
+  std::vector<crypto_toolbox::Aes128KeySchedule> schedules_;
+  std::vector<Octet16> hashes_;
+  bluetooth::common::LegacyFlatLruCache<RawAddress, int> resolved_{
+      kResolvedRandomAddrCacheSize, "RandomAddrResolver"};
+};
+
+RandomAddrResolver random_addr_resolver;
+
+}  // namespace
 
 /** This function is called to resolve a random address.
  * Returns pointer to the security record of the device whom a random address is
@@ -181,10 +256,7 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
-  list_node_t* n = list_foreach(btm_cb.sec_dev_rec, btm_ble_match_random_bda,
-                                (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  return random_addr_resolver.Resolve(random_bda);
 }
 
 /*******************************************************************************
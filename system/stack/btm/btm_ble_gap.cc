@@ -2288,18 +2288,18 @@ static void btm_ble_update_adv_flag(uint8_t flag) {
  * condition
  */
 static uint8_t btm_ble_is_discoverable(const RawAddress& bda,
-                                       std::vector<uint8_t> const& adv_data) {
+                                       AdvertiseDataIndex const& adv_data) {
   uint8_t scan_state = BTM_BLE_NOT_SCANNING;
 
   /* for observer, always "discoverable */
   if (btm_cb.ble_ctr_cb.is_ble_observe_active())
     scan_state |= BTM_BLE_OBS_RESULT;
 
-  if (!adv_data.empty()) {
+  if (adv_data.size() != 0) {
     uint8_t flag = 0;
     uint8_t data_len;
-    const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-        adv_data, BTM_BLE_AD_TYPE_FLAG, &data_len);
+    const uint8_t* p_flag =
+        adv_data.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &data_len);
     if (p_flag != NULL && data_len != 0) {
       flag = *p_flag;
 
@@ -2446,7 +2446,7 @@ static void btm_ble_appearance_to_cod(uint16_t appearance, uint8_t* dev_class) {
   };
 }
 
-bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
+bool btm_ble_get_appearance_as_cod(AdvertiseDataIndex const& data,
                                    DEV_CLASS dev_class) {
   /* Check to see the BLE device has the Appearance UUID in the advertising
    * data. If it does then try to convert the appearance value to a class of
@@ -2454,16 +2454,15 @@ bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
    * it is a HID device based on the service class.
    */
   uint8_t len;
-  const uint8_t* p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_APPEARANCE, &len);
+  const uint8_t* p_uuid16 =
+      data.GetFieldByType(BTM_BLE_AD_TYPE_APPEARANCE, &len);
   if (p_uuid16 && len == 2) {
     btm_ble_appearance_to_cod((uint16_t)p_uuid16[0] | (p_uuid16[1] << 8),
                               dev_class);
     return true;
   }
 
-  p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
+  p_uuid16 = data.GetFieldByType(BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
   if (p_uuid16 == NULL) {
     return false;
   }
@@ -2482,15 +2481,19 @@ bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
   return false;
 }
 
+bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
+                                   DEV_CLASS dev_class) {
+  return btm_ble_get_appearance_as_cod(AdvertiseDataIndex(data), dev_class);
+}
+
 /**
  * Update adv packet information into inquiry result.
  */
-void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
-                               const RawAddress& bda, uint16_t evt_type,
-                               uint8_t primary_phy, uint8_t secondary_phy,
-                               uint8_t advertising_sid, int8_t tx_power,
-                               int8_t rssi, uint16_t periodic_adv_int,
-                               std::vector<uint8_t> const& data) {
+static void btm_ble_update_inq_result(
+    tINQ_DB_ENT* p_i, uint8_t addr_type, const RawAddress& bda,
+    uint16_t evt_type, uint8_t primary_phy, uint8_t secondary_phy,
+    uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+    uint16_t periodic_adv_int, AdvertiseDataIndex const& data) {
   tBTM_INQ_RESULTS* p_cur = &p_i->inq_info.results;
   uint8_t len;
   tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
@@ -2522,9 +2525,8 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
   p_i->inq_count = p_inq->inq_counter; /* Mark entry for current inquiry */
 
   bool has_advertising_flags = false;
-  if (!data.empty()) {
-    const uint8_t* p_flag =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_FLAG, &len);
+  if (data.size() != 0) {
+    const uint8_t* p_flag = data.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &len);
     if (p_flag != NULL && len != 0) {
       has_advertising_flags = true;
       p_cur->flag = *p_flag;
@@ -2532,34 +2534,30 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
 
     btm_ble_get_appearance_as_cod(data, p_cur->dev_class);
 
-    const uint8_t* p_rsi =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_RSI, &len);
+    const uint8_t* p_rsi = data.GetFieldByType(BTM_BLE_AD_TYPE_RSI, &len);
     if (p_rsi != nullptr && len == 6) {
       STREAM_TO_BDADDR(p_cur->ble_ad_rsi, p_rsi);
     }
 
-    const uint8_t* p_service_data = data.data();
-    uint8_t service_data_len = 0;
-
-    while ((p_service_data = AdvertiseDataParser::GetFieldByType(
-                p_service_data + service_data_len,
-                data.size() - (p_service_data - data.data()) - service_data_len,
-                BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE, &service_data_len))) {
-      uint16_t uuid;
-      const uint8_t* p_uuid = p_service_data;
-      if (service_data_len < 2) {
-        continue;
-      }
-      STREAM_TO_UINT16(uuid, p_uuid);
-
-      if (uuid == 0x184E /* Audio Stream Control service */ ||
-          uuid == 0x184F /* Broadcast Audio Scan service */ ||
-          uuid == 0x1850 /* Published Audio Capabilities service */ ||
-          uuid == 0x1853 /* Common Audio service */) {
-        p_cur->ble_ad_is_le_audio_capable = true;
-        break;
-      }
-    }
+    data.ForEachFieldOfType(
+        BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE,
+        [p_cur](const uint8_t* p_service_data, uint8_t service_data_len) {
+          uint16_t uuid;
+          const uint8_t* p_uuid = p_service_data;
+          if (service_data_len < 2) {
+            return true;
+          }
+          STREAM_TO_UINT16(uuid, p_uuid);
+
+          if (uuid == 0x184E /* Audio Stream Control service */ ||
+              uuid == 0x184F /* Broadcast Audio Scan service */ ||
+              uuid == 0x1850 /* Published Audio Capabilities service */ ||
+              uuid == 0x1853 /* Common Audio service */) {
+            p_cur->ble_ad_is_le_audio_capable = true;
+            return false;
+          }
+          return true;
+        });
   }
 
   // Non-connectable packets may omit flags entirely, in which case nothing
@@ -2581,6 +2579,17 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
   }
 }
 
+void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
+                               const RawAddress& bda, uint16_t evt_type,
+                               uint8_t primary_phy, uint8_t secondary_phy,
+                               uint8_t advertising_sid, int8_t tx_power,
+                               int8_t rssi, uint16_t periodic_adv_int,
+                               std::vector<uint8_t> const& data) {
+  btm_ble_update_inq_result(p_i, addr_type, bda, evt_type, primary_phy,
+                            secondary_phy, advertising_sid, tx_power, rssi,
+                            periodic_adv_int, AdvertiseDataIndex(data));
+}
+
 void btm_ble_process_adv_addr(RawAddress& bda, tBLE_ADDR_TYPE* addr_type) {
   /* map address to security record */
   bool match = btm_identity_addr_to_random_pseudo(&bda, addr_type, false);
@@ -2843,10 +2852,12 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
     return;
   }
 
+  // Walk the payload once for all the fields looked up below
+  const AdvertiseDataIndex adv_data_index(adv_data);
+
   bool include_rsi = false;
   uint8_t len;
-  if (AdvertiseDataParser::GetFieldByType(adv_data, BTM_BLE_AD_TYPE_RSI,
-                                          &len)) {
+  if (adv_data_index.GetFieldByType(BTM_BLE_AD_TYPE_RSI, &len)) {
     include_rsi = true;
   }
 
@@ -2887,7 +2898,7 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
   /* update the LE device information in inquiry database */
   btm_ble_update_inq_result(p_i, addr_type, bda, evt_type, primary_phy,
                             secondary_phy, advertising_sid, tx_power, rssi,
-                            periodic_adv_int, adv_data);
+                            periodic_adv_int, adv_data_index);
 
   if (include_rsi) {
     (&p_i->inq_info.results)->include_rsi = true;
@@ -2909,7 +2920,7 @@ void btm_ble_process_adv_pkt_cont(uint16_t evt_type, tBLE_ADDR_TYPE addr_type,
         const_cast<uint8_t*>(adv_data.data()), adv_data.size());
   }
 
-  uint8_t result = btm_ble_is_discoverable(bda, adv_data);
+  uint8_t result = btm_ble_is_discoverable(bda, adv_data_index);
   if (result == 0) {
     // Device no longer discoverable so discard outstanding advertising packet
     cache.Clear(addr_type, bda);
@@ -2948,10 +2959,12 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
   tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
   bool update = true;
 
+  // Walk the payload once for all the fields looked up below
+  const AdvertiseDataIndex advertising_data_index(advertising_data);
+
   bool include_rsi = false;
   uint8_t len;
-  if (AdvertiseDataParser::GetFieldByType(advertising_data, BTM_BLE_AD_TYPE_RSI,
-                                          &len)) {
+  if (advertising_data_index.GetFieldByType(BTM_BLE_AD_TYPE_RSI, &len)) {
     include_rsi = true;
   }
 
@@ -2997,7 +3010,7 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
   /* update the LE device information in inquiry database */
   btm_ble_update_inq_result(p_i, addr_type, bda, evt_type, primary_phy,
                             secondary_phy, advertising_sid, tx_power, rssi,
-                            periodic_adv_int, advertising_data);
+                            periodic_adv_int, advertising_data_index);
 
   if (include_rsi) {
     (&p_i->inq_info.results)->include_rsi = true;
@@ -3019,7 +3032,7 @@ void btm_ble_process_adv_pkt_cont_for_inquiry(
         const_cast<uint8_t*>(advertising_data.data()), advertising_data.size());
   }
 
-  uint8_t result = btm_ble_is_discoverable(bda, advertising_data);
+  uint8_t result = btm_ble_is_discoverable(bda, advertising_data_index);
   if (result == 0) {
     return;
   }
@@ -139,9 +139,31 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
   return true;
 }
 
+/* Drop the lookup cache entries of |p_dev_rec| before it is freed, they may
+ * be under handles or addresses the record no longer has */
+static void btm_uncache_dev(const tBTM_SEC_DEV_REC* p_dev_rec) {
+  for (auto it = btm_cb.sec_dev_rec_by_handle.begin();
+       it != btm_cb.sec_dev_rec_by_handle.end();) {
+    if (it->second == p_dev_rec) {
+      it = btm_cb.sec_dev_rec_by_handle.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = btm_cb.sec_dev_rec_by_address.begin();
+       it != btm_cb.sec_dev_rec_by_address.end();) {
+    if (it->second == p_dev_rec) {
+      it = btm_cb.sec_dev_rec_by_address.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->link_key.fill(0);
   memset(&p_dev_rec->ble.keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_uncache_dev(p_dev_rec);
   list_remove(btm_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -351,8 +373,23 @@ bool is_handle_equal(void* data, void* context) {
  *
  ******************************************************************************/
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
+  /* Handles are assigned all over the stack, so a cached record is checked
+   * against the handle before being returned */
+  auto cached = btm_cb.sec_dev_rec_by_handle.find(handle);
+  if (cached != btm_cb.sec_dev_rec_by_handle.end()) {
+    tBTM_SEC_DEV_REC* p_dev_rec = cached->second;
+    if (p_dev_rec->hci_handle == handle || p_dev_rec->ble_hci_handle == handle)
+      return p_dev_rec;
+  }
+
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    /* Every disconnected record has the invalid handle */
+    if (handle != HCI_INVALID_HANDLE)
+      btm_cb.sec_dev_rec_by_handle[handle] = p_dev_rec;
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -382,9 +419,26 @@ bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  /* Only the identity and pseudo addresses are cached, random addresses
+   * resolved against the IRKs change too often to be worth it */
+  auto cached = btm_cb.sec_dev_rec_by_address.find(bd_addr);
+  if (cached != btm_cb.sec_dev_rec_by_address.end()) {
+    tBTM_SEC_DEV_REC* p_dev_rec = cached->second;
+    if (p_dev_rec->bd_addr == bd_addr ||
+        p_dev_rec->ble.pseudo_addr == bd_addr)
+      return p_dev_rec;
+  }
+
   list_node_t* n =
       list_foreach(btm_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (p_dev_rec->bd_addr == bd_addr ||
+        p_dev_rec->ble.pseudo_addr == bd_addr) {
+      btm_cb.sec_dev_rec_by_address[bd_addr] = p_dev_rec;
+    }
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -33,7 +33,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "advertise_data_parser.h"
 #include "common/time_util.h"
@@ -72,13 +75,16 @@ void btm_log_history_scan_mode(uint8_t scan_mode) {
 
 // Inquiry database lock
 std::mutex inq_db_lock_;
-// Inquiry database
-tINQ_DB_ENT inq_db_[BTM_INQ_DB_SIZE];
+// Inquiry database, allocated with its entries on the first response. The
+// entries are never moved afterwards, and are referenced by pointer.
+std::vector<tINQ_DB_ENT> inq_db_;
+// Entries in use by address
+std::unordered_map<RawAddress, tINQ_DB_ENT*> inq_db_index_;
 
 // Inquiry bluetooth device database lock
 std::mutex bd_db_lock_;
-tINQ_BDADDR* p_bd_db_;    /* Pointer to memory that holds bdaddrs */
-uint16_t num_bd_entries_; /* Number of entries in database */
+/* Inquiry counter of the bdaddrs responding, by bdaddr */
+std::unordered_map<RawAddress, uint32_t> bd_db_;
 uint16_t max_bd_entries_; /* Maximum number of entries that can be stored */
 
 }  // namespace
@@ -129,6 +135,14 @@ using bluetooth::Uuid;
 #define PROPERTY_INQ_SCAN_WINDOW "bluetooth.core.classic.inq_scan_window"
 #endif
 
+#ifndef PROPERTY_INQ_DB_SIZE
+#define PROPERTY_INQ_DB_SIZE "bluetooth.core.classic.inq_db_size"
+#endif
+
+/* Bounds of the inquiry database size set by PROPERTY_INQ_DB_SIZE */
+#define BTM_INQ_DB_MIN_SIZE 8
+#define BTM_INQ_DB_MAX_SIZE 1024
+
 #define BTIF_DM_DEFAULT_INQ_MAX_DURATION 10
 
 /******************************************************************************/
@@ -779,12 +793,9 @@ tBTM_INQ_INFO* BTM_InqDbRead(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbFirst(void) {
-  uint16_t xx;
-
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) return (&p_ent->inq_info);
+  for (tINQ_DB_ENT& ent : inq_db_) {
+    if (ent.in_use) return (&ent.inq_info);
   }
 
   /* If here, no used entry found */
@@ -810,10 +821,10 @@ tBTM_INQ_INFO* BTM_InqDbNext(tBTM_INQ_INFO* p_cur) {
   if (p_cur) {
     tINQ_DB_ENT* p_ent =
         (tINQ_DB_ENT*)((uint8_t*)p_cur - offsetof(tINQ_DB_ENT, inq_info));
-    inx = (uint16_t)((p_ent - inq_db_) + 1);
+    inx = (uint16_t)((p_ent - inq_db_.data()) + 1);
 
-    for (p_ent = &inq_db_[inx]; inx < BTM_INQ_DB_SIZE; inx++, p_ent++) {
-      if (p_ent->in_use) return (&p_ent->inq_info);
+    for (; inx < inq_db_.size(); inx++) {
+      if (inq_db_[inx].in_use) return (&inq_db_[inx].inq_info);
     }
 
     /* If here, more entries found */
@@ -858,17 +869,16 @@ tBTM_STATUS BTM_ClearInqDb(const RawAddress* p_bda) {
  *
  ******************************************************************************/
 void btm_clear_all_pending_le_entry(void) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (tINQ_DB_ENT& ent : inq_db_) {
     /* mark all pending LE entry as unused if an LE only device has scan
      * response outstanding */
-    if ((p_ent->in_use) &&
-        (p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
-        !p_ent->scan_rsp)
-      p_ent->in_use = false;
+    if ((ent.in_use) &&
+        (ent.inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
+        !ent.scan_rsp) {
+      ent.in_use = false;
+      inq_db_index_.erase(ent.inq_info.results.remote_bd_addr);
+    }
   }
 }
 
@@ -1023,20 +1033,20 @@ void btm_inq_clear_ssp(void) {
  *
  ******************************************************************************/
 void btm_clr_inq_db(const RawAddress* p_bda) {
-  uint16_t xx;
-
 #if (BTM_INQ_DEBUG == TRUE)
   BTM_TRACE_DEBUG("btm_clr_inq_db: inq_active:0x%x state:%d",
                   btm_cb.btm_inq_vars.inq_active, btm_cb.btm_inq_vars.state);
 #endif
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) {
-      /* If this is the specified BD_ADDR or clearing all devices */
-      if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
-        p_ent->in_use = false;
-      }
+  if (p_bda == NULL) {
+    /* Clearing all devices */
+    for (tINQ_DB_ENT& ent : inq_db_) ent.in_use = false;
+    inq_db_index_.clear();
+  } else {
+    auto indexed = inq_db_index_.find(*p_bda);
+    if (indexed != inq_db_index_.end()) {
+      indexed->second->in_use = false;
+      inq_db_index_.erase(indexed);
     }
   }
 #if (BTM_INQ_DEBUG == TRUE)
@@ -1058,23 +1068,23 @@ void btm_clr_inq_db(const RawAddress* p_bda) {
 static void btm_init_inq_result_flt(void) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
 
-  if (p_bd_db_ != nullptr) {
-    LOG_ERROR("Memory leak with bluetooth device database");
+  if (max_bd_entries_ != 0) {
+    LOG_ERROR("Bluetooth device database initialized multiple times");
   }
 
-  /* Allocate memory to hold bd_addrs responding */
-  p_bd_db_ = (tINQ_BDADDR*)osi_calloc(BT_DEFAULT_BUFFER_SIZE);
+  /* As many bd_addrs responding as the former fixed size database held */
+  bd_db_.clear();
   max_bd_entries_ = (uint16_t)(BT_DEFAULT_BUFFER_SIZE / sizeof(tINQ_BDADDR));
+  bd_db_.reserve(max_bd_entries_);
 }
 
 void btm_clr_inq_result_flt(void) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
-  if (p_bd_db_ == nullptr) {
+  if (max_bd_entries_ == 0) {
     LOG_WARN("Memory being reset multiple times");
   }
 
-  osi_free_and_reset((void**)&p_bd_db_);
-  num_bd_entries_ = 0;
+  bd_db_ = {};
   max_bd_entries_ = 0;
 }
 
@@ -1090,22 +1100,16 @@ void btm_clr_inq_result_flt(void) {
  ******************************************************************************/
 bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
-  tINQ_BDADDR* p_db = p_bd_db_;
-  uint16_t xx;
 
   /* Don't bother searching, database doesn't exist or periodic mode */
-  if (!p_db) return (false);
-
-  for (xx = 0; xx < num_bd_entries_; xx++, p_db++) {
-    if (p_db->bd_addr == p_bda &&
-        p_db->inq_count == btm_cb.btm_inq_vars.inq_counter)
-      return (true);
-  }
-
-  if (xx < max_bd_entries_) {
-    p_db->inq_count = btm_cb.btm_inq_vars.inq_counter;
-    p_db->bd_addr = p_bda;
-    num_bd_entries_++;
+  if (max_bd_entries_ == 0) return (false);
+
+  auto found = bd_db_.find(p_bda);
+  if (found != bd_db_.end()) {
+    if (found->second == btm_cb.btm_inq_vars.inq_counter) return (true);
+    found->second = btm_cb.btm_inq_vars.inq_counter;
+  } else if (bd_db_.size() < max_bd_entries_) {
+    bd_db_[p_bda] = btm_cb.btm_inq_vars.inq_counter;
   }
 
   /* If here, New Entry */
@@ -1123,14 +1127,11 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
-  }
+  auto indexed = inq_db_index_.find(p_bda);
+  if (indexed != inq_db_index_.end() && indexed->second->in_use)
+    return (indexed->second);
 
   /* If here, not found */
   return (NULL);
@@ -1148,33 +1149,39 @@ tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
-  uint16_t xx;
   uint64_t ot = UINT64_MAX;
 
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  tINQ_DB_ENT* p_old = inq_db_;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (!p_ent->in_use) {
-      memset(p_ent, 0, sizeof(tINQ_DB_ENT));
-      p_ent->inq_info.results.remote_bd_addr = p_bda;
-      p_ent->in_use = true;
+  if (inq_db_.empty()) {
+    int size = osi_property_get_int32(PROPERTY_INQ_DB_SIZE, BTM_INQ_DB_SIZE);
+    inq_db_.resize(std::clamp(size, BTM_INQ_DB_MIN_SIZE, BTM_INQ_DB_MAX_SIZE));
+    inq_db_index_.reserve(inq_db_.size());
+    LOG_INFO("Inquiry database of %zu entries", inq_db_.size());
+  }
 
-      return (p_ent);
+  tINQ_DB_ENT* p_old = inq_db_.data();
+  for (tINQ_DB_ENT& ent : inq_db_) {
+    if (!ent.in_use) {
+      p_old = &ent;
+      break;
     }
 
-    if (p_ent->time_of_resp < ot) {
-      p_old = p_ent;
-      ot = p_ent->time_of_resp;
+    if (ent.time_of_resp < ot) {
+      p_old = &ent;
+      ot = ent.time_of_resp;
     }
   }
 
-  /* If here, no free entry found. Return the oldest. */
+  /* If here with an entry in use, no free entry found. Return the least
+   * recently responding one. */
+  if (p_old->in_use) {
+    inq_db_index_.erase(p_old->inq_info.results.remote_bd_addr);
+  }
 
   memset(p_old, 0, sizeof(tINQ_DB_ENT));
   p_old->inq_info.results.remote_bd_addr = p_bda;
   p_old->in_use = true;
+  inq_db_index_[p_bda] = p_old;
 
   return (p_old);
 }
@@ -1395,16 +1402,16 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
  *
  ******************************************************************************/
 void btm_sort_inq_result(void) {
-  uint8_t xx, yy, num_resp;
+  uint16_t xx, yy, num_resp;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  tINQ_DB_ENT* p_next = inq_db_ + 1;
+  tINQ_DB_ENT* p_ent = inq_db_.data();
+  tINQ_DB_ENT* p_next = p_ent + 1;
   int size;
-  tINQ_DB_ENT* p_tmp = (tINQ_DB_ENT*)osi_malloc(sizeof(tINQ_DB_ENT));
 
-  num_resp = (btm_cb.btm_inq_vars.inq_cmpl_info.num_resp < BTM_INQ_DB_SIZE)
-                 ? btm_cb.btm_inq_vars.inq_cmpl_info.num_resp
-                 : BTM_INQ_DB_SIZE;
+  num_resp = std::min<size_t>(btm_cb.btm_inq_vars.inq_cmpl_info.num_resp,
+                              inq_db_.size());
+  if (num_resp < 2) return;
+  tINQ_DB_ENT* p_tmp = (tINQ_DB_ENT*)osi_malloc(sizeof(tINQ_DB_ENT));
 
   size = sizeof(tINQ_DB_ENT);
   for (xx = 0; xx < num_resp - 1; xx++, p_ent++) {
@@ -1418,6 +1425,12 @@ void btm_sort_inq_result(void) {
   }
 
   osi_free(p_tmp);
+
+  /* The entries moved */
+  inq_db_index_.clear();
+  for (tINQ_DB_ENT& ent : inq_db_) {
+    if (ent.in_use) inq_db_index_[ent.inq_info.results.remote_bd_addr] = &ent;
+  }
 }
 
 /*******************************************************************************
@@ -21,8 +21,10 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "gd/common/circular_buffer.h"
+#include "gd/common/lock_free_circular_buffer.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
@@ -45,22 +47,35 @@ constexpr size_t kMaxInquiryScanHistory = 10;
 extern bluetooth::common::TimestamperInMilliseconds timestamper_in_milliseconds;
 
 class TimestampedStringCircularBuffer
-    : public bluetooth::common::TimestampedCircularBuffer<std::string> {
+    : public bluetooth::common::TimestampedLockFreeCircularBuffer<
+          bluetooth::common::BoundedString<kMaxLogSize>> {
  public:
+  using LogLine = bluetooth::common::BoundedString<kMaxLogSize>;
+
   explicit TimestampedStringCircularBuffer(size_t size)
-      : bluetooth::common::TimestampedCircularBuffer<std::string>(size) {}
+      : bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>(size) {}
 
   void Push(const std::string& s) {
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        s.substr(0, kMaxLogSize));
+    bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>::Push(
+        LogLine(s));
   }
 
   template <typename... Args>
   void Push(Args... args) {
-    char buf[kMaxLogSize];
-    std::snprintf(buf, sizeof(buf), args...);
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        std::string(buf));
+    // Formatted in place, the history is pushed to without allocating
+    LogLine line;
+    std::snprintf(line.data, sizeof(line.data), args...);
+    bluetooth::common::TimestampedLockFreeCircularBuffer<LogLine>::Push(line);
+  }
+
+  std::vector<bluetooth::common::TimestampedEntry<std::string>> Pull() const {
+    std::vector<bluetooth::common::TimestampedEntry<std::string>> records;
+    for (const auto& record :
+         bluetooth::common::TimestampedLockFreeCircularBuffer<
+             LogLine>::Pull()) {
+      records.push_back({record.timestamp, record.entry.ToString()});
+    }
+    return records;
   }
 };
 
@@ -278,6 +293,10 @@ typedef struct tBTM_CB {
   uint8_t disc_reason{0};           /* for legacy devices */
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
   list_t* sec_dev_rec{nullptr}; /* list of tBTM_SEC_DEV_REC */
+  /* Lookup caches in front of |sec_dev_rec|, an entry is only used while
+   * its record still has that handle or address. See btm_find_dev */
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> sec_dev_rec_by_handle;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_by_address;
   tBTM_SEC_SERV_REC* p_out_serv{nullptr};
   tBTM_MKEY_CALLBACK* mkey_cback{nullptr};
 
@@ -359,6 +378,8 @@ typedef struct tBTM_CB {
       *((tBTM_SEC_DEV_REC*)ptr) = {};
       osi_free(ptr);
     });
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_by_address.clear();
 
     /* Initialize BTM component structures */
     btm_inq_vars.Init(); /* Inquiry Database and Structures */
@@ -387,6 +408,8 @@ typedef struct tBTM_CB {
 
     list_free(sec_dev_rec);
     sec_dev_rec = nullptr;
+    sec_dev_rec_by_handle.clear();
+    sec_dev_rec_by_address.clear();
 
     alarm_free(sec_collision_timer);
     sec_collision_timer = nullptr;
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <map>
 #include <memory>
@@ -33,8 +34,10 @@
 #include "device/include/controller.h"
 #include "hci/include/hci_layer.h"
 #include "internal_include/stack_config.h"
+#include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_log_history.h"
 #include "stack/include/hci_error_code.h"
@@ -55,6 +58,9 @@ static constexpr uint8_t kStateFlagIsBroadcast = 0x10;
 
 constexpr char kBtmLogTag[] = "ISO";
 
+/* Period of the ISO link quality readout of all the ISO links */
+static constexpr uint64_t kLinkQualityMonitorIntervalMs = 4000;
+
 struct iso_sync_info {
   uint32_t first_sync_ts;
   uint16_t seq_nb;
@@ -83,8 +89,49 @@ struct iso_base {
     uint64_t evt_last_lost_us = 0;
   };
 
+  /* SDUs given to the controller after their SDU interval, i.e. skipping
+   * sequence numbers on the way out.
+   */
+  struct sdu_stats {
+    size_t sdu_sent_count = 0;
+    size_t sdu_late_count = 0;
+    size_t seq_nb_skipped_count = 0;
+    uint64_t sdu_last_late_us = 0;
+    /* Cleared when the stream (re)starts its sequence numbers */
+    bool last_sent_seq_nb_valid = false;
+    uint16_t last_sent_seq_nb = 0;
+  };
+
+  /* Counters of HCI_LE_Read_ISO_Link_Quality, which are cumulative in the
+   * controller. The window keeps their increase over the last readouts.
+   */
+  struct link_quality_stats {
+    static constexpr size_t kWindowSize = 8;
+
+    struct counters {
+      uint32_t tx_unacked = 0;
+      uint32_t tx_flushed = 0;
+      uint32_t tx_last_subevent = 0;
+      uint32_t rx_unreceived = 0;
+    };
+
+    size_t read_count = 0;
+    counters last_read;
+    std::array<counters, kWindowSize> window;
+    counters window_total;
+  };
+
   credits_stats cr_stats;
   event_stats evt_stats;
+  sdu_stats tx_stats;
+  link_quality_stats lq_stats;
+
+  /* Packet of the SDU being written in place, see get_iso_data_buffer() */
+  BT_HDR* pending_sdu = nullptr;
+
+  ~iso_base() {
+    if (pending_sdu != nullptr) osi_free(pending_sdu);
+  }
 };
 
 typedef iso_base iso_cis;
@@ -94,9 +141,14 @@ struct iso_impl {
   iso_impl() {
     iso_credits_ = controller_get_interface()->get_iso_buffer_count();
     iso_buffer_size_ = controller_get_interface()->get_iso_data_size();
+
+    if (osi_property_get_bool("persist.bluetooth.iso_link_quality_report",
+                              false)) {
+      link_quality_timer_ = alarm_new_periodic("btm_iso_link_quality");
+    }
   }
 
-  ~iso_impl() {}
+  ~iso_impl() { alarm_free(link_quality_timer_); }
 
   void handle_register_cis_callbacks(CigCallbacks* callbacks) {
     LOG_ASSERT(callbacks != nullptr) << "Invalid CIG callbacks";
@@ -483,6 +535,15 @@ struct iso_impl {
     STREAM_TO_UINT32(rxUnreceivedPackets, stream);
     STREAM_TO_UINT32(duplicatePackets, stream);
 
+    update_link_quality_stats(conn_handle, iso->lq_stats,
+                              {.tx_unacked = txUnackedPackets,
+                               .tx_flushed = txFlushedPackets,
+                               .tx_last_subevent = txLastSubeventPackets,
+                               .rx_unreceived = rxUnreceivedPackets});
+
+    /* The BIG users have no use of the link quality yet */
+    if (iso->state_flags & kStateFlagIsBroadcast) return;
+
     LOG_ASSERT(cig_callbacks_ != nullptr) << "Invalid CIG callbacks";
     cig_callbacks_->OnIsoLinkQualityRead(
         conn_handle, iso->cig_id, txUnackedPackets, txFlushedPackets,
@@ -502,6 +563,85 @@ struct iso_impl {
                                    base::Unretained(this)));
   }
 
+  void update_link_quality_stats(
+      uint16_t iso_handle, iso_base::link_quality_stats& stats,
+      const iso_base::link_quality_stats::counters& read) {
+    using counters = iso_base::link_quality_stats::counters;
+
+    /* The first readout only gives the base of the counters */
+    if (stats.read_count++ == 0) {
+      stats.last_read = read;
+      return;
+    }
+
+    counters delta = {
+        .tx_unacked = read.tx_unacked - stats.last_read.tx_unacked,
+        .tx_flushed = read.tx_flushed - stats.last_read.tx_flushed,
+        .tx_last_subevent =
+            read.tx_last_subevent - stats.last_read.tx_last_subevent,
+        .rx_unreceived = read.rx_unreceived - stats.last_read.rx_unreceived,
+    };
+    stats.last_read = read;
+
+    counters& slot = stats.window[stats.read_count % stats.window.size()];
+    bool was_flushing = (stats.window_total.tx_flushed != 0);
+
+    stats.window_total.tx_unacked += delta.tx_unacked - slot.tx_unacked;
+    stats.window_total.tx_flushed += delta.tx_flushed - slot.tx_flushed;
+    stats.window_total.tx_last_subevent +=
+        delta.tx_last_subevent - slot.tx_last_subevent;
+    stats.window_total.rx_unreceived +=
+        delta.rx_unreceived - slot.rx_unreceived;
+    slot = delta;
+
+    /* Only the changes, not to flood the history on a bad link */
+    bool is_flushing = (stats.window_total.tx_flushed != 0);
+    if (was_flushing != is_flushing) {
+      BTM_LogHistory(
+          kBtmLogTag,
+          cis_hdl_to_addr.count(iso_handle) ? cis_hdl_to_addr[iso_handle]
+                                            : RawAddress::kEmpty,
+          is_flushing ? "Link quality degraded" : "Link quality recovered",
+          base::StringPrintf("handle:0x%04x, flushed:%u, unacked:%u, "
+                             "rx_unreceived:%u",
+                             iso_handle, stats.window_total.tx_flushed,
+                             stats.window_total.tx_unacked,
+                             stats.window_total.rx_unreceived));
+    }
+  }
+
+  /* Reads the link quality of all the established ISO links at once, at each
+   * period of the monitor.
+   */
+  void start_link_quality_monitor() {
+    if (link_quality_timer_ == nullptr ||
+        alarm_is_scheduled(link_quality_timer_))
+      return;
+
+    alarm_set_on_mloop(link_quality_timer_, kLinkQualityMonitorIntervalMs,
+                       link_quality_monitor_cb, this);
+  }
+
+  static void link_quality_monitor_cb(void* data) {
+    static_cast<iso_impl*>(data)->read_all_iso_link_quality();
+  }
+
+  void read_all_iso_link_quality() {
+    bool any_link = false;
+    for (auto const& [handle, cis] : conn_hdl_to_cis_map_) {
+      if (!(cis->state_flags & kStateFlagIsConnected)) continue;
+      read_iso_link_quality(handle);
+      any_link = true;
+    }
+    for (auto const& [handle, bis] : conn_hdl_to_bis_map_) {
+      read_iso_link_quality(handle);
+      any_link = true;
+    }
+
+    /* Started again by the next established link */
+    if (!any_link) alarm_cancel(link_quality_timer_);
+  }
+
   BT_HDR* prepare_ts_hci_packet(uint16_t iso_handle, uint32_t ts,
                                 uint16_t seq_nb, uint16_t data_len) {
     /* Add 2 for packet seq., 2 for length, 4 for the timestamp */
@@ -532,23 +672,38 @@ struct iso_impl {
     bte_main_hci_send(packet, MSG_STACK_TO_HC_HCI_ISO | 0x0001);
   }
 
-  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
-                     uint16_t data_len) {
-    iso_base* iso = GetIsoIfKnown(iso_handle);
-    LOG_ASSERT(iso != nullptr)
-        << "No such iso connection handle: " << loghex(iso_handle);
+  static void update_sdu_stats(iso_base::sdu_stats& stats, uint16_t seq_nb,
+                               uint64_t now_us) {
+    /* The sequence number should move by one per SDU, more means that the
+     * previous SDU interval(s) went without data from the audio path.
+     */
+    uint16_t delta = seq_nb - stats.last_sent_seq_nb;
+    if (stats.last_sent_seq_nb_valid && delta > 1) {
+      stats.sdu_late_count++;
+      stats.seq_nb_skipped_count += delta - 1;
+      stats.sdu_last_late_us = now_us;
+    }
+    stats.last_sent_seq_nb = seq_nb;
+    stats.last_sent_seq_nb_valid = true;
+    stats.sdu_sent_count++;
+  }
 
+  /* Takes a credit and allocates the packet of an SDU of |data_len| bytes on
+   * |iso|, or returns nullptr if it can not be sent now.
+   */
+  BT_HDR* allocate_iso_sdu(iso_base* iso, uint16_t iso_handle,
+                           uint16_t data_len) {
     if (!(iso->state_flags & kStateFlagIsBroadcast)) {
       if (!(iso->state_flags & kStateFlagIsConnected)) {
         LOG(WARNING) << __func__ << "Cis handle: " << loghex(iso_handle)
                      << " not established";
-        return;
+        return nullptr;
       }
     }
 
     if (!(iso->state_flags & kStateFlagHasDataPathSet)) {
       LOG_WARN("Data path not set for handle: 0x%04x", iso_handle);
-      return;
+      return nullptr;
     }
 
     /* Calculate sequence number for the ISO data packet.
@@ -556,6 +711,7 @@ struct iso_impl {
      */
     uint32_t ts = bluetooth::common::time_get_os_boottime_us();
     iso->sync_info.seq_nb = (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
+    update_sdu_stats(iso->tx_stats, iso->sync_info.seq_nb, ts);
 
     if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
       iso->cr_stats.credits_underflow_bytes += data_len;
@@ -567,18 +723,69 @@ struct iso_impl {
                    << static_cast<int>(data_len)
                    << ", iso credits: " << static_cast<int>(iso_credits_)
                    << ", iso handle: " << loghex(iso_handle);
-      return;
+      return nullptr;
     }
 
     iso_credits_--;
     iso->used_credits++;
 
-    BT_HDR* packet =
-        prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
+    return prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb,
+                                 data_len);
+  }
+
+  /* Frees the SDU of |iso| that was not sent, and returns its credit */
+  void discard_pending_sdu(iso_base* iso) {
+    if (iso->pending_sdu == nullptr) return;
+
+    osi_free_and_reset((void**)&iso->pending_sdu);
+    iso_credits_++;
+    iso->used_credits--;
+  }
+
+  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
+                     uint16_t data_len) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    LOG_ASSERT(iso != nullptr)
+        << "No such iso connection handle: " << loghex(iso_handle);
+
+    BT_HDR* packet = allocate_iso_sdu(iso, iso_handle, data_len);
+    if (packet == nullptr) return;
+
     memcpy(packet->data + kIsoDataInTsBtHdrOffset, data, data_len);
     send_iso_data_hci_packet(packet);
   }
 
+  uint8_t* get_iso_data_buffer(uint16_t iso_handle, uint16_t data_len) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    LOG_ASSERT(iso != nullptr)
+        << "No such iso connection handle: " << loghex(iso_handle);
+
+    if (iso->pending_sdu != nullptr) {
+      LOG_WARN("Discarding the unsent SDU of handle: 0x%04x", iso_handle);
+      discard_pending_sdu(iso);
+    }
+
+    iso->pending_sdu = allocate_iso_sdu(iso, iso_handle, data_len);
+    if (iso->pending_sdu == nullptr) return nullptr;
+
+    return iso->pending_sdu->data + kIsoDataInTsBtHdrOffset;
+  }
+
+  void send_iso_data_buffer(uint16_t iso_handle) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    LOG_ASSERT(iso != nullptr)
+        << "No such iso connection handle: " << loghex(iso_handle);
+
+    if (iso->pending_sdu == nullptr) {
+      LOG_WARN("No SDU to send for handle: 0x%04x", iso_handle);
+      return;
+    }
+
+    BT_HDR* packet = iso->pending_sdu;
+    iso->pending_sdu = nullptr;
+    send_iso_data_hci_packet(packet);
+  }
+
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
     cis_establish_cmpl_evt evt;
 
@@ -598,6 +805,7 @@ struct iso_impl {
                        hci_error_code_text((tHCI_STATUS)(evt.status)).c_str()));
 
     cis->sync_info.first_sync_ts = bluetooth::common::time_get_os_boottime_us();
+    cis->tx_stats.last_sent_seq_nb_valid = false;
 
     STREAM_TO_UINT24(evt.cig_sync_delay, data);
     STREAM_TO_UINT24(evt.cis_sync_delay, data);
@@ -616,6 +824,8 @@ struct iso_impl {
 
     if (evt.status == HCI_SUCCESS) {
       cis->state_flags |= kStateFlagIsConnected;
+      cis->lq_stats = {};
+      start_link_quality_monitor();
     } else {
       cis_hdl_to_addr.erase(evt.cis_conn_hdl);
     }
@@ -652,6 +862,7 @@ struct iso_impl {
       cis->state_flags &= ~kStateFlagIsConnected;
 
       /* return used credits */
+      discard_pending_sdu(cis);
       iso_credits_ += cis->used_credits;
       cis->used_credits = 0;
 
@@ -748,6 +959,8 @@ struct iso_impl {
       }
     }
 
+    if (evt.status == HCI_SUCCESS) start_link_quality_monitor();
+
     big_callbacks_->OnBigEvent(kIsoEventBigOnCreateCmpl, &evt);
 
     {
@@ -772,6 +985,7 @@ struct iso_impl {
     auto bis_it = conn_hdl_to_bis_map_.cbegin();
     while (bis_it != conn_hdl_to_bis_map_.cend()) {
       if (bis_it->second->big_handle == evt.big_id) {
+        discard_pending_sdu(bis_it->second.get());
         bis_it = conn_hdl_to_bis_map_.erase(bis_it);
         is_known_handle = true;
       } else {
@@ -969,6 +1183,38 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_link_quality_stats(
+      int fd, const iso_base::link_quality_stats& stats) {
+    if (stats.read_count == 0) return;
+
+    dprintf(fd, "        Link Quality Stats (last %zu reads):\n",
+            std::min(stats.read_count - 1,
+                     iso_base::link_quality_stats::kWindowSize));
+    dprintf(fd, "          Tx unacked packets: %u\n",
+            stats.window_total.tx_unacked);
+    dprintf(fd, "          Tx flushed packets: %u\n",
+            stats.window_total.tx_flushed);
+    dprintf(fd, "          Tx last subevent packets: %u\n",
+            stats.window_total.tx_last_subevent);
+    dprintf(fd, "          Rx unreceived packets: %u\n",
+            stats.window_total.rx_unreceived);
+  }
+
+  static void dump_sdu_stats(int fd, const iso_base::sdu_stats& stats) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+    dprintf(fd, "        Tx SDU Stats:\n");
+    dprintf(fd, "          SDUs sent (count): %zu\n", stats.sdu_sent_count);
+    dprintf(fd, "          SDUs sent late (count): %zu\n",
+            stats.sdu_late_count);
+    dprintf(fd, "          Sequence numbers skipped (count): %zu\n",
+            stats.seq_nb_skipped_count);
+    dprintf(fd, "          Last late SDU time ago (ms): %llu\n",
+            (stats.sdu_last_late_us > 0
+                 ? (unsigned long long)(now_us - stats.sdu_last_late_us) / 1000
+                 : 0llu));
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
@@ -988,6 +1234,8 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_sdu_stats(fd, cis_pair.second->tx_stats);
+      dump_link_quality_stats(fd, cis_pair.second->lq_stats);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -1000,6 +1248,8 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_sdu_stats(fd, cis_pair.second->tx_stats);
+      dump_link_quality_stats(fd, cis_pair.second->lq_stats);
     }
     dprintf(fd, "  ----------------\n ");
   }
@@ -1012,6 +1262,8 @@ struct iso_impl {
   uint16_t iso_buffer_size_;
   uint32_t last_big_create_req_sdu_itv_;
 
+  alarm_t* link_quality_timer_ = nullptr;
+
   CigCallbacks* cig_callbacks_ = nullptr;
   BigCallbacks* big_callbacks_ = nullptr;
   std::mutex on_iso_traffic_active_callbacks_list_mutex_;
@@ -111,6 +111,7 @@ static tBTM_STATUS BTM_ChangeEScoLinkParms(uint16_t sco_inx,
                                            tBTM_CHG_ESCO_PARAMS* p_parms);
 
 static uint16_t btm_sco_voice_settings_to_legacy(enh_esco_params_t* p_parms);
+static void btm_send_sco_data(const uint8_t* data, size_t len);
 
 /*******************************************************************************
  *
@@ -344,8 +345,7 @@ void btm_route_sco_data(BT_HDR* p_msg) {
         rc = bluetooth::audio::sco::wbs::dequeue_packet(&encoded);
         if (!rc) break;
 
-        auto data = std::vector<uint8_t>(encoded, encoded + rc);
-        btm_send_sco_packet(std::move(data));
+        btm_send_sco_data(encoded, rc);
       }
     }
   } else {
@@ -366,35 +366,44 @@ void btm_route_sco_data(BT_HDR* p_msg) {
        * send PCM data directly to SCO.
        * We don't maintain buffer read/write offset for NB as we send all data
        * that we read from the audio server. */
-      auto data = std::vector<uint8_t>((uint8_t*)btm_pcm_buf,
-                                       (uint8_t*)btm_pcm_buf + read);
-      btm_send_sco_packet(std::move(data));
+      btm_send_sco_data((uint8_t*)btm_pcm_buf, read);
     }
   }
 }
 
-void btm_send_sco_packet(std::vector<uint8_t> data) {
+// Build a SCO packet from the |len| bytes at |data|
+static BT_HDR* btm_sco_make_packet(const uint8_t* data, size_t len,
+                                   uint16_t sco_handle) {
+  ASSERT_LOG(len <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
+             (unsigned long)len);
+  BT_HDR* p_buf = (BT_HDR*)osi_calloc(BT_SMALL_BUFFER_SIZE);
+  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
+  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
+  p_buf->len = len + 3;
+  uint8_t* payload = p_buf->data;
+  UINT16_TO_STREAM(payload, sco_handle);
+  UINT8_TO_STREAM(payload, len);
+  ARRAY_TO_STREAM(payload, data, static_cast<int>(len));
+  return p_buf;
+}
+
+// Send the SCO data straight from the buffer it was encoded or read into
+static void btm_send_sco_data(const uint8_t* data, size_t len) {
   auto* active_sco = btm_get_active_sco();
-  if (active_sco == nullptr || data.empty()) {
+  if (active_sco == nullptr || len == 0) {
     return;
   }
-  BT_HDR* packet = btm_sco_make_packet(std::move(data), active_sco->hci_handle);
+  BT_HDR* packet = btm_sco_make_packet(data, len, active_sco->hci_handle);
   bte_main_hci_send(packet, BT_EVT_TO_LM_HCI_SCO);
 }
 
+void btm_send_sco_packet(std::vector<uint8_t> data) {
+  btm_send_sco_data(data.data(), data.size());
+}
+
 // Build a SCO packet from uint8
 BT_HDR* btm_sco_make_packet(std::vector<uint8_t> data, uint16_t sco_handle) {
-  ASSERT_LOG(data.size() <= BTM_SCO_DATA_SIZE_MAX, "Invalid SCO data size: %lu",
-             (unsigned long)data.size());
-  BT_HDR* p_buf = (BT_HDR*)osi_calloc(BT_SMALL_BUFFER_SIZE);
-  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
-  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
-  p_buf->len = data.size() + 3;
-  uint8_t* payload = p_buf->data;
-  UINT16_TO_STREAM(payload, sco_handle);
-  UINT8_TO_STREAM(payload, data.size());
-  ARRAY_TO_STREAM(payload, data.data(), static_cast<int>(data.size()));
-  return p_buf;
+  return btm_sco_make_packet(data.data(), data.size(), sco_handle);
 }
 
 /*******************************************************************************
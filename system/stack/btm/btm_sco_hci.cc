@@ -486,7 +486,13 @@ struct tBTM_MSBC_INFO {
 
   size_t write(const uint8_t* input, size_t len) {
     if (len > buf_size - decode_buf_wo) {
-      return 0;
+      /* The offsets don't meet again once bytes were skipped to find a frame
+       * head, so move the remaining data to the front instead of dropping the
+       * packets until the buffer is reset. */
+      if (len > buf_size - decodable()) return 0;
+      memmove(msbc_decode_buf, msbc_decode_buf + decode_buf_ro, decodable());
+      decode_buf_wo -= decode_buf_ro;
+      decode_buf_ro = 0;
     }
 
     std::copy(input, input + len, msbc_decode_buf + decode_buf_wo);
@@ -1568,6 +1568,118 @@ static void btm_sec_check_upgrade(tBTM_SEC_DEV_REC* p_dev_rec,
   }
 }
 
+static tBTM_SEC_ACCESS_STATE btm_sec_access_state(
+    const tBTM_SEC_DEV_REC* p_dev_rec) {
+  return tBTM_SEC_ACCESS_STATE{
+      .sec_flags = p_dev_rec->sec_flags,
+      .hci_handle = p_dev_rec->hci_handle,
+      .sm4 = p_dev_rec->sm4,
+      .link_key_type = p_dev_rec->link_key_type,
+      .bond_type = p_dev_rec->bond_type,
+      .security_mode = btm_cb.security_mode,
+      .remote_supports_secure_connections =
+          p_dev_rec->SupportsSecureConnections(),
+  };
+}
+
+static bool btm_sec_is_access_state(const tBTM_SEC_DEV_REC* p_dev_rec,
+                                    const tBTM_SEC_ACCESS_STATE& state) {
+  const tBTM_SEC_ACCESS_STATE current = btm_sec_access_state(p_dev_rec);
+  return current.sec_flags == state.sec_flags &&
+         current.hci_handle == state.hci_handle && current.sm4 == state.sm4 &&
+         current.link_key_type == state.link_key_type &&
+         current.bond_type == state.bond_type &&
+         current.security_mode == state.security_mode &&
+         current.remote_supports_secure_connections ==
+             state.remote_supports_secure_connections;
+}
+
+static const tBTM_SEC_GRANTED_ACCESS* btm_sec_match_granted_access(
+    const tBTM_SEC_DEV_REC* p_dev_rec, uint16_t security_required,
+    bool is_originator, bool is_mx) {
+  for (uint8_t i = 0; i < p_dev_rec->num_granted_access; i++) {
+    const tBTM_SEC_GRANTED_ACCESS& access = p_dev_rec->granted_access[i];
+    if (access.security_required == security_required &&
+        access.is_originator == is_originator && access.is_mx == is_mx) {
+      return &access;
+    }
+  }
+  return nullptr;
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_find_granted_access
+ *
+ * Description      Look for an access to a BR/EDR service with the same
+ *                  requirements already granted to the device, in its current
+ *                  security state and with no security procedure pending.
+ *
+ * Returns          Pointer to the granted access or NULL
+ *
+ ******************************************************************************/
+static const tBTM_SEC_GRANTED_ACCESS* btm_sec_find_granted_access(
+    const tBTM_SEC_DEV_REC* p_dev_rec, uint16_t security_required,
+    bool is_originator, bool is_mx) {
+  if (p_dev_rec->num_granted_access == 0) return nullptr;
+  if (p_dev_rec->p_callback != nullptr ||
+      p_dev_rec->sec_state != BTM_SEC_STATE_IDLE ||
+      btm_cb.pairing_state != BTM_PAIR_STATE_IDLE) {
+    return nullptr;
+  }
+  if (!btm_sec_is_access_state(p_dev_rec, p_dev_rec->granted_access_state)) {
+    return nullptr;
+  }
+  return btm_sec_match_granted_access(p_dev_rec, security_required,
+                                      is_originator, is_mx);
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_sec_add_granted_access
+ *
+ * Description      Save an access to a BR/EDR service granted by the security
+ *                  procedures, the accesses granted in another security state
+ *                  of the device are dropped. Accesses granted with a link key
+ *                  that could still be upgraded are not saved.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void btm_sec_add_granted_access(tBTM_SEC_DEV_REC* p_dev_rec,
+                                       uint16_t security_required,
+                                       bool is_originator, bool is_mx) {
+  if (BTM_SEC_IS_SM4(p_dev_rec->sm4) &&
+      btm_sec_is_upgrade_possible(p_dev_rec, is_originator)) {
+    return;
+  }
+
+  if (!btm_sec_is_access_state(p_dev_rec, p_dev_rec->granted_access_state)) {
+    p_dev_rec->granted_access_state = btm_sec_access_state(p_dev_rec);
+    p_dev_rec->num_granted_access = 0;
+  }
+  if (btm_sec_match_granted_access(p_dev_rec, security_required,
+                                   is_originator, is_mx) != nullptr) {
+    return;
+  }
+
+  if (p_dev_rec->num_granted_access == BTM_SEC_MAX_GRANTED_ACCESS) {
+    /* Drop the oldest one */
+    memmove(&p_dev_rec->granted_access[0], &p_dev_rec->granted_access[1],
+            sizeof(tBTM_SEC_GRANTED_ACCESS) * (BTM_SEC_MAX_GRANTED_ACCESS - 1));
+    p_dev_rec->num_granted_access--;
+  }
+  p_dev_rec->granted_access[p_dev_rec->num_granted_access++] =
+      tBTM_SEC_GRANTED_ACCESS{
+          .security_required = security_required,
+          .is_originator = is_originator,
+          .is_mx = is_mx,
+          .granted_security_required = p_dev_rec->security_required,
+          .granted_security_flags_for_pairing =
+              p_dev_rec->required_security_flags_for_pairing,
+      };
+}
+
 tBTM_STATUS btm_sec_l2cap_access_req_by_requirement(
     const RawAddress& bd_addr, uint16_t security_required, bool is_originator,
     tBTM_SEC_CALLBACK* p_callback, void* p_ref_data) {
@@ -1587,6 +1699,20 @@ tBTM_STATUS btm_sec_l2cap_access_req_by_requirement(
 
   p_dev_rec->hci_handle = BTM_GetHCIConnHandle(bd_addr, BT_TRANSPORT_BR_EDR);
 
+  const tBTM_SEC_GRANTED_ACCESS* p_granted = btm_sec_find_granted_access(
+      p_dev_rec, security_required, is_originator, false);
+  if (p_granted != nullptr) {
+    LOG_DEBUG("Access already granted in the current security state");
+    p_dev_rec->required_security_flags_for_pairing =
+        p_granted->granted_security_flags_for_pairing;
+    p_dev_rec->security_required = p_granted->granted_security_required;
+    p_dev_rec->p_ref_data = p_ref_data;
+    p_dev_rec->is_originator = is_originator;
+    (*p_callback)(&bd_addr, transport, p_ref_data, BTM_SUCCESS);
+    return BTM_SUCCESS;
+  }
+  const uint16_t requested_security = security_required;
+
   if ((!is_originator) && (security_required & BTM_SEC_MODE4_LEVEL4)) {
     bool local_supports_sc =
         controller_get_interface()->supports_secure_connections();
@@ -1762,6 +1888,10 @@ tBTM_STATUS btm_sec_l2cap_access_req_by_requirement(
     BTM_TRACE_DEBUG("%s: p_dev_rec=%p, clearing callback. old p_callback=%p",
                     __func__, p_dev_rec, p_dev_rec->p_callback);
     p_dev_rec->p_callback = NULL;
+    if (rc == BTM_SUCCESS) {
+      btm_sec_add_granted_access(p_dev_rec, requested_security, is_originator,
+                                 false);
+    }
     (*p_callback)(&bd_addr, transport, p_dev_rec->p_ref_data, rc);
   }
 
@@ -1861,6 +1991,20 @@ tBTM_STATUS btm_sec_mx_access_request(const RawAddress& bd_addr,
   /* Find or get oldest record */
   p_dev_rec = btm_find_or_alloc_dev(bd_addr);
 
+  const tBTM_SEC_GRANTED_ACCESS* p_granted = btm_sec_find_granted_access(
+      p_dev_rec, security_required, is_originator, true);
+  if (p_granted != nullptr) {
+    LOG_DEBUG("Access already granted in the current security state");
+    p_dev_rec->required_security_flags_for_pairing =
+        p_granted->granted_security_flags_for_pairing;
+    p_dev_rec->security_required = p_granted->granted_security_required;
+    p_dev_rec->is_originator = is_originator;
+    p_dev_rec->p_ref_data = p_ref_data;
+    if (p_callback) (*p_callback)(&bd_addr, transport, p_ref_data, BTM_SUCCESS);
+    return BTM_SUCCESS;
+  }
+  const uint16_t requested_security = security_required;
+
   /* there are some devices (moto phone) which connects to several services at
    * the same time */
   /* we will process one after another */
@@ -1994,6 +2138,10 @@ tBTM_STATUS btm_sec_mx_access_request(const RawAddress& bd_addr,
             ADDRESS_TO_LOGGABLE_CSTR(p_dev_rec->RemoteAddress()),
             btm_status_text(rc).c_str());
   if (rc != BTM_CMD_STARTED) {
+    if (rc == BTM_SUCCESS) {
+      btm_sec_add_granted_access(p_dev_rec, requested_security, is_originator,
+                                 true);
+    }
     if (p_callback) {
       p_dev_rec->p_callback = NULL;
       (*p_callback)(&bd_addr, transport, p_ref_data, rc);
@@ -3945,6 +4093,8 @@ void btm_sec_disconnected(uint16_t handle, tHCI_REASON reason,
     p_dev_rec->sec_flags &=
         ~(BTM_SEC_AUTHENTICATED | BTM_SEC_ENCRYPTED | BTM_SEC_ROLE_SWITCHED |
           BTM_SEC_16_DIGIT_PIN_AUTHED);
+    /* The accesses are granted again on the next link */
+    p_dev_rec->num_granted_access = 0;
 
     // Remove temporary key.
     if (p_dev_rec->bond_type == tBTM_SEC_DEV_REC::BOND_TYPE_TEMPORARY)
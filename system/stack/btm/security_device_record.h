@@ -209,6 +209,33 @@ inline std::string class_of_device_text(const DEV_CLASS& cod) {
   return base::StringPrintf("0x%02x%02x%02x", cod[2], cod[1], cod[0]);
 }
 
+/*
+ * Security state of a device in which accesses to BR/EDR services were
+ * granted. The next access requests with the same requirements are granted
+ * without running the security procedures again while the state stays the
+ * same.
+ */
+typedef struct {
+  uint16_t sec_flags;
+  uint16_t hci_handle;
+  uint8_t sm4;
+  uint8_t link_key_type;
+  uint8_t bond_type;
+  uint8_t security_mode;
+  bool remote_supports_secure_connections;
+} tBTM_SEC_ACCESS_STATE;
+
+#define BTM_SEC_MAX_GRANTED_ACCESS 4
+
+typedef struct {
+  uint16_t security_required; /* Security requested for the service */
+  bool is_originator;
+  bool is_mx; /* Requested by a multiplexing protocol */
+  /* Security fields of the device record once the access was granted */
+  uint16_t granted_security_required;
+  uint32_t granted_security_flags_for_pairing;
+} tBTM_SEC_GRANTED_ACCESS;
+
 /*
  * Define structure for Security Device Record.
  * A record exists for each device authenticated with this device
@@ -464,6 +491,11 @@ struct tBTM_SEC_DEV_REC {
   tBTM_SEC_BLE ble;
   tBTM_LE_CONN_PRAMS conn_params;
 
+  /* Accesses to BR/EDR services granted in |granted_access_state| */
+  tBTM_SEC_ACCESS_STATE granted_access_state;
+  tBTM_SEC_GRANTED_ACCESS granted_access[BTM_SEC_MAX_GRANTED_ACCESS];
+  uint8_t num_granted_access;
+
   tREMOTE_VERSION_INFO remote_version_info;
 
   std::string ToString() const {
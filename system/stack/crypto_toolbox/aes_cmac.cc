@@ -25,11 +25,22 @@
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 
+#include <algorithm>
+
 #include "check.h"
 #include "stack/crypto_toolbox/aes.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/bt_octets.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AES_HW 1
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#define AES_HW 1
+#endif
+
 namespace crypto_toolbox {
 
 namespace {
@@ -58,25 +69,186 @@ static void xor_128(Octet16* a, const Octet16& b) {
     aa[i] = aa[i] ^ bb[i];
   }
 }
-}  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
-  Octet16 key_reversed;
+constexpr int kAes128Rounds = 10;
+
+#ifdef AES_HW
+/* The rounds run with the AES instructions of the CPU, over the key schedule
+ * expanded by aes_set_key(), which holds the round keys in the byte order of
+ * FIPS-197 that the instructions use. The output is the same as
+ * aes_encrypt(). */
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("aes,sse2"))) void aes_encrypt_hw(
+    const uint8_t* in, uint8_t* out, const aes_context& ctx) {
+  auto round_key = [&ctx](int round) {
+    return _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(ctx.ksch + round * N_BLOCK));
+  };
+
+  __m128i state = _mm_xor_si128(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), round_key(0));
+  for (int round = 1; round < ctx.rnd; round++) {
+    state = _mm_aesenc_si128(state, round_key(round));
+  }
+  state = _mm_aesenclast_si128(state, round_key(ctx.rnd));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+/* Encrypts the |in| block with |N| keys at once: the rounds of one key wait
+ * for each other, the rounds of different keys overlap in the pipeline. */
+template <size_t N>
+__attribute__((target("aes,sse2"))) void aes_128_multi_key_hw(
+    const Aes128KeySchedule* schedules, const uint8_t* in, Octet16* out) {
+  auto round_key = [schedules](size_t key, int round) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+        schedules[key].round_keys.data() + round * N_BLOCK));
+  };
+
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  __m128i state[N];
+  for (size_t key = 0; key < N; key++) {
+    state[key] = _mm_xor_si128(block, round_key(key, 0));
+  }
+  for (int round = 1; round < kAes128Rounds; round++) {
+    for (size_t key = 0; key < N; key++) {
+      state[key] = _mm_aesenc_si128(state[key], round_key(key, round));
+    }
+  }
+  for (size_t key = 0; key < N; key++) {
+    state[key] =
+        _mm_aesenclast_si128(state[key], round_key(key, kAes128Rounds));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out[key].data()), state[key]);
+  }
+}
+
+bool has_aes_hw() {
+  static const bool has_aes = __builtin_cpu_supports("aes");
+  return has_aes;
+}
+#else
+/* AESE adds the round key before the substitution, so the last round key is
+ * added after the rounds */
+__attribute__((target("aes"))) void aes_encrypt_hw(const uint8_t* in,
+                                                   uint8_t* out,
+                                                   const aes_context& ctx) {
+  uint8x16_t state = vld1q_u8(in);
+  for (int round = 0; round < ctx.rnd - 1; round++) {
+    state = vaesmcq_u8(vaeseq_u8(state, vld1q_u8(ctx.ksch + round * N_BLOCK)));
+  }
+  state = vaeseq_u8(state, vld1q_u8(ctx.ksch + (ctx.rnd - 1) * N_BLOCK));
+  vst1q_u8(out, veorq_u8(state, vld1q_u8(ctx.ksch + ctx.rnd * N_BLOCK)));
+}
+
+/* Encrypts the |in| block with |N| keys at once: the rounds of one key wait
+ * for each other, the rounds of different keys overlap in the pipeline. */
+template <size_t N>
+__attribute__((target("aes"))) void aes_128_multi_key_hw(
+    const Aes128KeySchedule* schedules, const uint8_t* in, Octet16* out) {
+  auto round_key = [schedules](size_t key, int round) {
+    return vld1q_u8(schedules[key].round_keys.data() + round * N_BLOCK);
+  };
+
+  const uint8x16_t block = vld1q_u8(in);
+  uint8x16_t state[N];
+  for (size_t key = 0; key < N; key++) state[key] = block;
+  for (int round = 0; round < kAes128Rounds - 1; round++) {
+    for (size_t key = 0; key < N; key++) {
+      state[key] = vaesmcq_u8(vaeseq_u8(state[key], round_key(key, round)));
+    }
+  }
+  for (size_t key = 0; key < N; key++) {
+    state[key] = vaeseq_u8(state[key], round_key(key, kAes128Rounds - 1));
+    vst1q_u8(out[key].data(),
+             veorq_u8(state[key], round_key(key, kAes128Rounds)));
+  }
+}
+
+bool has_aes_hw() {
+  static const bool has_aes = (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+  return has_aes;
+}
+#endif
+#endif
+
+/* Encrypts the |message| block with the expanded key |ctx|, both in little
+ * endian order */
+Octet16 aes_128(const aes_context& ctx, const Octet16& message) {
   Octet16 message_reversed;
   Octet16 output;
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
   std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
 
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
+#ifdef AES_HW
+  if (has_aes_hw()) {
+    aes_encrypt_hw(message_reversed.data(), output.data(), ctx);
+  } else {
+    aes_encrypt(message_reversed.data(), output.data(), &ctx);
+  }
+#else
   aes_encrypt(message_reversed.data(), output.data(), &ctx);
+#endif
 
   std::reverse(output.begin(), output.end());
   return output;
 }
 
+/* Expands the |key| in little endian order */
+void aes_128_set_key(const Octet16& key, aes_context* ctx) {
+  Octet16 key_reversed;
+  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+  aes_set_key(key_reversed.data(), key_reversed.size(), ctx);
+}
+}  // namespace
+
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+  return aes_128(ctx, message);
+}
+
+Aes128KeySchedule aes_128_key_schedule(const Octet16& key) {
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+
+  Aes128KeySchedule schedule;
+  std::copy(ctx.ksch, ctx.ksch + schedule.round_keys.size(),
+            schedule.round_keys.begin());
+  return schedule;
+}
+
+void aes_128_multi_key(const Aes128KeySchedule* schedules, size_t count,
+                       const Octet16& message, Octet16* outputs) {
+  Octet16 message_reversed;
+  std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
+
+  size_t i = 0;
+#ifdef AES_HW
+  if (has_aes_hw()) {
+    constexpr size_t kKeysPerPass = 4;
+    for (; i + kKeysPerPass <= count; i += kKeysPerPass) {
+      aes_128_multi_key_hw<kKeysPerPass>(&schedules[i], message_reversed.data(),
+                                         &outputs[i]);
+    }
+    for (; i < count; i++) {
+      aes_128_multi_key_hw<1>(&schedules[i], message_reversed.data(),
+                              &outputs[i]);
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    aes_context ctx;
+    std::copy(schedules[i].round_keys.begin(), schedules[i].round_keys.end(),
+              ctx.ksch);
+    ctx.rnd = kAes128Rounds;
+    aes_encrypt(message_reversed.data(), outputs[i].data(), &ctx);
+  }
+
+  for (i = 0; i < count; i++) {
+    std::reverse(outputs[i].begin(), outputs[i].end());
+  }
+}
+
 /** utility function to padding the given text to be a 128 bits data. The
  * parameter dest is input and output parameter, it must point to a
  * OCTET16_LEN memory space; where include length bytes valid data. */
@@ -101,7 +273,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const aes_context& ctx) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -110,10 +282,11 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
   uint16_t i = 1;
   while (i <= cmac_cb.round) {
     /* Mi' := Mi (+) X  */
-    xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN], x);
+    Octet16* block =
+        (Octet16*)&cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN];
+    xor_128(block, x);
 
-    output = aes_128(key, &cmac_cb.text[(cmac_cb.round - i) * OCTET16_LEN],
-                     OCTET16_LEN);
+    output = aes_128(ctx, *block);
     x = output;
     i++;
   }
@@ -145,13 +318,13 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 }
 
 /** This is the function to generate the two subkeys.
- * |key| is CMAC key, expect SRK when used by SMP.
+ * |ctx| is the expanded CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const aes_context& ctx) {
   DVLOG(2) << __func__;
 
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero.data(), OCTET16_LEN);
+  Octet16 p = aes_128(ctx, zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -205,10 +378,14 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
+  /* the key is expanded once for all the blocks */
+  aes_context ctx;
+  aes_128_set_key(key, &ctx);
+
   /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  cmac_generate_subkey(ctx);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(ctx);
 
   /* clean up */
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
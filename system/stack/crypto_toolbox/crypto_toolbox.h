@@ -37,6 +37,20 @@ uint32_t g2(const uint8_t* u, const uint8_t* v, const Octet16& x,
 Octet16 ltk_to_link_key(const Octet16& ltk, bool use_h7);
 Octet16 link_key_to_ltk(const Octet16& link_key, bool use_h7);
 
+/* Round keys of an AES-128 key, expanded once for a key used on many blocks,
+ * as the IRKs tried on each resolvable private address */
+struct Aes128KeySchedule {
+  std::array<uint8_t, 11 * OCTET16_LEN> round_keys;
+};
+
+Aes128KeySchedule aes_128_key_schedule(const Octet16& key);
+
+/* Computes AES_128(key, message) into |outputs| for each of the |count| keys
+ * of |schedules|, with the AES instructions of the CPU working on several keys
+ * at once when it has them */
+void aes_128_multi_key(const Aes128KeySchedule* schedules, size_t count,
+                       const Octet16& message, Octet16* outputs);
+
 /* This function computes AES_128(key, message). |key| must be 128bit.
  * |message| can be at most 16 bytes long, it's length in bytes is given in
  * |length| */
@@ -45,6 +45,7 @@ struct EattExtension::impl {
     reg_info_.pL2CA_DisconnectInd_Cb = eatt_disconnect_ind;
     reg_info_.pL2CA_Error_Cb = eatt_error_cb;
     reg_info_.pL2CA_DataInd_Cb = eatt_data_ind;
+    reg_info_.pL2CA_CongestionStatus_Cb = eatt_congestion_ind;
     reg_info_.pL2CA_CreditBasedCollisionInd_Cb = eatt_collision_ind;
 
     if (L2CA_RegisterLECoc(BT_PSM_EATT, reg_info_, BTM_SEC_NONE, {}) == 0) {
@@ -116,6 +117,11 @@ struct EattExtension::impl {
     if (p_eatt_impl) p_eatt_impl->eatt_l2cap_data_ind(lcid, data_p);
   }
 
+  static void eatt_congestion_ind(uint16_t lcid, bool congested) {
+    auto p_eatt_impl = GetImplInstance();
+    if (p_eatt_impl) p_eatt_impl->eatt_l2cap_congestion_ind(lcid, congested);
+  }
+
   std::unique_ptr<eatt_impl> eatt_impl_;
   tL2CAP_APPL_INFO reg_info_;
 };
@@ -234,7 +234,8 @@ class EattExtension {
       const RawAddress& bd_addr);
 
   /**
-   * Get EATT channel available to send GATT request.
+   * Get EATT channel available to send GATT request: the opened channel with
+   * the fewest queued requests.
    *
    * @param bd_addr peer device address
    *
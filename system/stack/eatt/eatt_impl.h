@@ -119,6 +119,8 @@ struct eatt_impl {
     }
 
     eatt_dev->eatt_channels.erase(lcid);
+    if (eatt_dev->eatt_tcb_)
+      gatt_sr_drop_held_notifications(*eatt_dev->eatt_tcb_, lcid);
 
     if (eatt_dev->eatt_channels.size() == 0) eatt_dev->eatt_tcb_ = NULL;
   }
@@ -546,6 +548,17 @@ struct eatt_impl {
     osi_free(data_p);
   }
 
+  void eatt_l2cap_congestion_ind(uint16_t lcid, bool congested) {
+    LOG_DEBUG("cid: 0x%04x, congested: %d", lcid, congested);
+    eatt_device* eatt_dev = find_device_by_cid(lcid);
+    if (!eatt_dev || !eatt_dev->eatt_tcb_) {
+      LOG_WARN("unknown cid: 0x%04x", lcid);
+      return;
+    }
+
+    gatt_sr_channel_congestion(*eatt_dev->eatt_tcb_, lcid, congested);
+  }
+
   bool is_eatt_supported_by_peer(const RawAddress& bd_addr) {
     return gatt_profile_get_eatt_support(bd_addr);
   }
@@ -687,15 +700,18 @@ struct eatt_impl {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
     if (!eatt_dev) return nullptr;
 
-    auto iter = find_if(
-        eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
-        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
-          return el.second->state_ == EattChannelState::EATT_CHANNEL_OPENED &&
-                 el.second->cl_cmd_q_.empty();
-        });
-
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr
-                                                   : iter->second.get();
+    /* The opened channel with the fewest queued requests, the lowest CID
+     * between equally loaded ones */
+    EattChannel* least_loaded = nullptr;
+    for (const auto& el : eatt_dev->eatt_channels) {
+      EattChannel* channel = el.second.get();
+      if (channel->state_ != EattChannelState::EATT_CHANNEL_OPENED) continue;
+      if (least_loaded == nullptr ||
+          channel->cl_cmd_q_.size() < least_loaded->cl_cmd_q_.size()) {
+        least_loaded = channel;
+      }
+    }
+    return least_loaded;
   }
 
   void free_gatt_resources(const RawAddress& bd_addr) {
@@ -28,6 +28,7 @@
 #include "gatt_int.h"
 #include "l2c_api.h"
 #include "os/log.h"
+#include "os/trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
@@ -526,6 +527,7 @@ tGATT_STATUS attp_send_cl_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
   }
 
   uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, p_clcb->cid);
+  BT_TRACE_INSTANT(GATT, "GATT client request", op_code);
 
   switch (op_code) {
     case GATT_REQ_MTU:
@@ -27,6 +27,8 @@
 #include <base/strings/string_number_conversions.h>
 #include <stdio.h>
 
+#include <cinttypes>
+#include <map>
 #include <string>
 
 #include "bt_target.h"
@@ -50,6 +52,8 @@
 
 using bluetooth::Uuid;
 
+#define BLE_GATT_SVR_SUP_FEAT_EATT_BITMASK 0x01
+
 bool BTM_BackgroundConnectAddressKnown(const RawAddress& address);
 /**
  * Add an service handle range to the list in decending order of the start
@@ -134,11 +138,12 @@ static void gatt_update_last_srv_info() {
   for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
     gatt_cb.last_service_handle = el.s_hdl;
   }
+  gatt_sr_update_handle_index();
 }
 
-/** Update database hash and client status */
+/** Invalidate database hash and update client status */
 static void gatt_update_for_database_change() {
-  gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  gatt_cb.database_hash_stale = true;
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -603,21 +608,14 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   memcpy(notif.value, p_val, val_len);
   notif.auth_req = GATT_AUTH_REQ_NONE;
 
-  tGATT_STATUS cmd_sent;
-  tGATT_SR_MSG gatt_sr_msg;
-  gatt_sr_msg.attr_value = notif;
-
   uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
-  uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
-  BT_HDR* p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF,
-                                    &gatt_sr_msg, payload_size);
 
-  if (p_buf != NULL) {
-    cmd_sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
-  } else {
-    cmd_sent = GATT_NO_RESOURCES;
-  }
-  return cmd_sent;
+  /* The channel is congested: hold the notification to batch it with the
+   * next ones, it is accepted like L2CAP accepts data on a congested channel.
+   */
+  if (gatt_sr_hold_notification(*p_tcb, cid, notif)) return GATT_CONGESTED;
+
+  return gatt_sr_send_notification(*p_tcb, cid, notif);
 }
 
 /*******************************************************************************
@@ -967,6 +965,10 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
   p_clcb->op_subtype = type;
   p_clcb->auth_req = p_read->by_handle.auth_req;
   p_clcb->counter = 0;
+  if (type == GATT_READ_BY_HANDLE || type == GATT_READ_PARTIAL) {
+    p_clcb->cid = gatt_tcb_get_att_cid_for_handle(
+        *p_tcb, p_reg->eatt_support, p_clcb, p_read->by_handle.handle);
+  }
   p_clcb->read_req_current_mtu =
       gatt_tcb_get_payload_size_tx(*p_tcb, p_clcb->cid);
 
@@ -977,13 +979,15 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
       p_clcb->e_handle = p_read->service.e_handle;
       p_clcb->uuid = p_read->service.uuid;
       break;
-    case GATT_READ_MULTIPLE: {
+    case GATT_READ_MULTIPLE:
+    case GATT_READ_MULTIPLE_VAR_LEN: {
       p_clcb->s_handle = 0;
       /* copy multiple handles in CB */
       tGATT_READ_MULTI* p_read_multi =
           (tGATT_READ_MULTI*)osi_malloc(sizeof(tGATT_READ_MULTI));
       p_clcb->p_attr_buf = (uint8_t*)p_read_multi;
       memcpy(p_read_multi, &p_read->read_multiple, sizeof(tGATT_READ_MULTI));
+      p_read_multi->variable_len = (type == GATT_READ_MULTIPLE_VAR_LEN);
       break;
     }
     case GATT_READ_BY_HANDLE:
@@ -1034,6 +1038,49 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
   return GATT_SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultipleVariableLengthSupported
+ *
+ * Description      This function is called to check whether the server
+ *                  supports the Read Multiple Variable Length procedure, which
+ *                  is mandatory for servers supporting EATT.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if GATT_READ_MULTIPLE_VAR_LEN reads can be used.
+ *
+ ******************************************************************************/
+bool GATTC_IsReadMultipleVariableLengthSupported(uint16_t conn_id) {
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+  if (p_tcb == NULL) return false;
+
+  return p_tcb->sr_supp_feat & BLE_GATT_SVR_SUP_FEAT_EATT_BITMASK;
+}
+
+/*******************************************************************************
+ *
+ * Function         GATTC_GetNumBearers
+ *
+ * Description      This function is called to get the number of ATT bearers
+ *                  requests of the connection can be spread over.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          number of bearers, 0 if the connection is unknown.
+ *
+ ******************************************************************************/
+uint8_t GATTC_GetNumBearers(uint16_t conn_id) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  if (p_tcb == NULL || p_reg == NULL) return 0;
+
+  return p_reg->eatt_support ? 1 + p_tcb->eatt : 1;
+}
+
 /*******************************************************************************
  *
  * Function         GATTC_Write
@@ -1069,6 +1116,18 @@ tGATT_STATUS GATTC_Write(uint16_t conn_id, tGATT_WRITE_TYPE type,
   p_clcb->operation = GATTC_OPTYPE_WRITE;
   p_clcb->op_subtype = type;
   p_clcb->auth_req = p_write->auth_req;
+  p_clcb->s_handle = p_write->handle;
+
+  /* The server queues prepared writes per bearer, keep them all on the bearer
+   * of the first one until they are executed */
+  if (type == GATT_WRITE_PREPARE &&
+      gatt_tcb_is_cid_open(*p_tcb, p_tcb->prepare_write_cid)) {
+    p_clcb->cid = p_tcb->prepare_write_cid;
+  } else {
+    p_clcb->cid = gatt_tcb_get_att_cid_for_handle(*p_tcb, p_reg->eatt_support,
+                                                  p_clcb, p_write->handle);
+    if (type == GATT_WRITE_PREPARE) p_tcb->prepare_write_cid = p_clcb->cid;
+  }
 
   p_clcb->p_attr_buf = (uint8_t*)osi_malloc(sizeof(tGATT_VALUE));
   memcpy(p_clcb->p_attr_buf, (void*)p_write, sizeof(tGATT_VALUE));
@@ -1116,6 +1175,10 @@ tGATT_STATUS GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
   if (!p_clcb) return GATT_NO_RESOURCES;
 
   p_clcb->operation = GATTC_OPTYPE_EXE_WRITE;
+  if (gatt_tcb_is_cid_open(*p_tcb, p_tcb->prepare_write_cid)) {
+    p_clcb->cid = p_tcb->prepare_write_cid;
+  }
+  p_tcb->prepare_write_cid = 0;
   tGATT_EXEC_FLAG flag =
       is_execute ? GATT_PREP_WRITE_EXEC : GATT_PREP_WRITE_CANCEL;
   gatt_send_queue_write_cancel(*p_clcb->p_tcb, p_clcb, flag);
@@ -1694,3 +1757,54 @@ void gatt_load_bonded(void) {
     }
   }
 }
+
+#define DUMPSYS_TAG "stack::gatt"
+
+static void gatt_dump_latency(
+    int fd, const char* direction,
+    const std::map<uint8_t, tGATT_LATENCY_HIST>& latency) {
+  for (const auto& [op_code, hist] : latency) {
+    LOG_DUMPSYS(fd,
+                "    %s %-28s count:%-6u avg:%-5" PRIu64 "ms p50:%-5" PRIu64
+                "ms p99:%-5" PRIu64 "ms max:%" PRIu64 "ms",
+                direction, (char*)gatt_dbg_op_name(op_code), hist.count,
+                hist.total_us / hist.count / 1000,
+                gatt_latency_hist_percentile_ms(hist, 50),
+                gatt_latency_hist_percentile_ms(hist, 99),
+                (hist.max_us + 999) / 1000);
+  }
+}
+
+void GATT_Dumpsys(int fd) {
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  int tcbs_in_use = 0;
+  for (const tGATT_TCB& tcb : gatt_cb.tcb) {
+    if (tcb.in_use) tcbs_in_use++;
+  }
+  LOG_DUMPSYS(fd, "  tcb in_use:%d/%d tcb_pool_bytes:%zu", tcbs_in_use,
+              GATT_MAX_PHY_CHANNEL, sizeof(gatt_cb.tcb));
+
+  for (int i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
+    const tGATT_TCB& tcb = gatt_cb.tcb[i];
+    if (!tcb.in_use) continue;
+
+    LOG_DUMPSYS(fd, "  peer:%s transport:%s eatt_channels:%hhu%s",
+                ADDRESS_TO_LOGGABLE_CSTR(tcb.peer_bda),
+                bt_transport_text(tcb.transport).c_str(), tcb.eatt,
+                tcb.slow_peer ? " slow" : "");
+    gatt_dump_latency(fd, "client", tcb.cl_latency);
+    gatt_dump_latency(fd, "server", tcb.sr_latency);
+  }
+
+  if (gatt_cb.slow_peers.empty()) return;
+
+  LOG_DUMPSYS(fd, "  Last slow peers:");
+  for (const tGATT_SLOW_PEER& slow_peer : gatt_cb.slow_peers) {
+    LOG_DUMPSYS(fd, "    peer:%s %s p99:%" PRIu64 "ms at:%" PRIu64 "ms",
+                ADDRESS_TO_LOGGABLE_CSTR(slow_peer.peer_bda),
+                (char*)gatt_dbg_op_name(slow_peer.op_code), slow_peer.p99_ms,
+                slow_peer.detected_ms);
+  }
+}
+#undef DUMPSYS_TAG
@@ -26,6 +26,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "bt_target.h"
 #include "gatt_int.h"
 #include "l2c_api.h"
@@ -223,6 +225,130 @@ void gatt_act_read(tGATT_CLCB* p_clcb, uint16_t offset) {
   }
 }
 
+/** Returns true if the responses to the requests of this clcb are those of a
+ * pipelined long read */
+static bool gatt_long_read_is_pipelined(const tGATT_CLCB* p_clcb) {
+  return p_clcb->long_read.blob || p_clcb->long_read.next_offset != 0;
+}
+
+/** Request the next blob of a pipelined long read on the bearer of p_clcb.
+ * Returns false if there is nothing left to read or the request failed */
+static bool gatt_long_read_send_blob(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
+                                     tGATT_CLCB* p_read) {
+  if (p_read->status != GATT_SUCCESS ||
+      p_read->long_read.next_offset >= p_read->long_read.end) {
+    return false;
+  }
+
+  tGATT_CL_MSG msg;
+  memset(&msg, 0, sizeof(tGATT_CL_MSG));
+  msg.read_blob.handle = p_read->s_handle;
+  msg.read_blob.offset = p_read->long_read.next_offset;
+
+  p_clcb->long_read.offset = msg.read_blob.offset;
+  p_read->long_read.next_offset +=
+      gatt_tcb_get_payload_size_rx(tcb, p_clcb->cid) - 1;
+
+  tGATT_STATUS rt = attp_send_cl_msg(tcb, p_clcb, GATT_REQ_READ_BLOB, &msg);
+  if (rt != GATT_SUCCESS && rt != GATT_CMD_STARTED && rt != GATT_CONGESTED) {
+    LOG_WARN("Unable to send read blob, offset=%d", msg.read_blob.offset);
+    p_read->status = rt;
+    return false;
+  }
+  return true;
+}
+
+/** Continue a pipelined long read once the read blob request of p_clcb is
+ * answered: request the next blob on its bearer, or end it */
+static void gatt_long_read_next(tGATT_TCB& tcb, tGATT_CLCB* p_clcb) {
+  if (p_clcb->long_read.blob) {
+    tGATT_CLCB* p_read = p_clcb->long_read.p_read;
+    if (p_read && gatt_long_read_send_blob(tcb, p_clcb, p_read)) return;
+
+    gatt_end_operation(p_clcb, GATT_SUCCESS, NULL);
+    return;
+  }
+
+  if (gatt_long_read_send_blob(tcb, p_clcb, p_clcb)) return;
+
+  p_clcb->long_read.idle = true;
+  gatt_long_read_complete_if_done(p_clcb);
+}
+
+/** Read the remaining blobs of a long value at once, on the bearer of the
+ * read and on the other idle EATT bearers */
+static void gatt_long_read_start(tGATT_TCB& tcb, tGATT_CLCB* p_read) {
+  VLOG(1) << __func__ << ": pipelining long read from offset "
+          << p_read->counter;
+  gatt_bulk_transfer_start(tcb, p_read);
+
+  p_read->long_read.next_offset = p_read->counter;
+  p_read->long_read.end = GATT_MAX_ATTR_LEN;
+  if (!gatt_long_read_send_blob(tcb, p_read, p_read)) {
+    p_read->long_read.idle = true;
+    gatt_long_read_complete_if_done(p_read);
+    return;
+  }
+
+  while (p_read->long_read.num_blobs < GATT_LONG_READ_MAX_BLOBS &&
+         p_read->long_read.next_offset < p_read->long_read.end) {
+    if (gatt_tcb_is_cid_busy(tcb, gatt_tcb_get_att_cid(tcb, true))) break;
+
+    tGATT_CLCB* p_blob = gatt_clcb_alloc(p_read->conn_id);
+    p_blob->operation = GATTC_OPTYPE_READ;
+    p_blob->op_subtype = GATT_READ_PARTIAL;
+    p_blob->auth_req = p_read->auth_req;
+    p_blob->s_handle = p_read->s_handle;
+    p_blob->long_read.blob = true;
+    p_blob->long_read.p_read = p_read;
+    p_read->long_read.num_blobs++;
+
+    if (!gatt_long_read_send_blob(tcb, p_blob, p_read)) {
+      gatt_end_operation(p_blob, GATT_SUCCESS, NULL);
+      return;
+    }
+  }
+}
+
+/** Copy a blob of a pipelined long read to the attribute buffer of the read,
+ * the first blob shorter than the payload size being the last one */
+static void gatt_long_read_blob_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
+                                    uint16_t len, uint8_t* p_data) {
+  tGATT_CLCB* p_read =
+      p_clcb->long_read.blob ? p_clcb->long_read.p_read : p_clcb;
+  uint16_t offset = p_clcb->long_read.offset;
+
+  if (p_read && offset < GATT_MAX_ATTR_LEN) {
+    memcpy(p_read->p_attr_buf + offset, p_data,
+           std::min<uint16_t>(len, GATT_MAX_ATTR_LEN - offset));
+    if (len != gatt_tcb_get_payload_size_rx(tcb, p_clcb->cid) - 1) {
+      p_read->long_read.end =
+          std::min<uint16_t>(p_read->long_read.end, offset + len);
+    }
+  }
+
+  gatt_long_read_next(tcb, p_clcb);
+}
+
+/** Handle an error response to a read blob of a pipelined long read. Reading
+ * past the end of the value ends the read, other errors fail it */
+static void gatt_long_read_error_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
+                                     tGATT_STATUS reason) {
+  tGATT_CLCB* p_read =
+      p_clcb->long_read.blob ? p_clcb->long_read.p_read : p_clcb;
+
+  if (p_read) {
+    if (reason == GATT_INVALID_OFFSET || reason == GATT_NOT_LONG) {
+      p_read->long_read.end =
+          std::min(p_read->long_read.end, p_clcb->long_read.offset);
+    } else if (p_read->status == GATT_SUCCESS) {
+      p_read->status = reason;
+    }
+  }
+
+  gatt_long_read_next(tcb, p_clcb);
+}
+
 /** GATT write operation */
 void gatt_act_write(tGATT_CLCB* p_clcb, uint8_t sec_act) {
   tGATT_TCB& tcb = *p_clcb->p_tcb;
@@ -267,6 +393,7 @@ void gatt_act_write(tGATT_CLCB* p_clcb, uint8_t sec_act) {
 
       } else {
         /* prepare write for long attribute */
+        gatt_bulk_transfer_start(tcb, p_clcb);
         gatt_send_prepare_write(tcb, p_clcb);
       }
       return;
@@ -555,6 +682,9 @@ void gatt_process_error_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
   if (p_clcb->operation == GATTC_OPTYPE_DISCOVERY) {
     gatt_proc_disc_error_rsp(tcb, p_clcb, opcode, handle,
                              static_cast<tGATT_STATUS>(reason));
+  } else if (p_clcb->operation == GATTC_OPTYPE_READ &&
+             gatt_long_read_is_pipelined(p_clcb)) {
+    gatt_long_read_error_rsp(tcb, p_clcb, static_cast<tGATT_STATUS>(reason));
   } else {
     if ((p_clcb->operation == GATTC_OPTYPE_WRITE) &&
         (p_clcb->op_subtype == GATT_WRITE) &&
@@ -1007,7 +1137,9 @@ void gatt_process_read_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
   uint16_t payload_size = gatt_tcb_get_payload_size_rx(tcb, p_clcb->cid);
 
   if (p_clcb->operation == GATTC_OPTYPE_READ) {
-    if (p_clcb->op_subtype != GATT_READ_BY_HANDLE) {
+    if (gatt_long_read_is_pipelined(p_clcb)) {
+      gatt_long_read_blob_rsp(tcb, p_clcb, len, p);
+    } else if (p_clcb->op_subtype != GATT_READ_BY_HANDLE) {
       p_clcb->counter = len;
       gatt_end_operation(p_clcb, GATT_SUCCESS, (void*)p);
     } else {
@@ -1040,7 +1172,10 @@ void gatt_process_read_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
               "full pkt issue read blob for remianing bytes old offset=%d "
               "len=%d new offset=%d",
               offset, len, p_clcb->counter);
-          gatt_act_read(p_clcb, p_clcb->counter);
+          if (p_clcb->p_reg->eatt_support && tcb.eatt)
+            gatt_long_read_start(tcb, p_clcb);
+          else
+            gatt_act_read(p_clcb, p_clcb->counter);
         } else /* end of request, send callback */
         {
           gatt_end_operation(p_clcb, GATT_SUCCESS, (void*)p_clcb->p_attr_buf);
@@ -1254,6 +1389,7 @@ void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
   }
 
   gatt_stop_rsp_timer(p_clcb);
+  gatt_cl_record_latency(tcb, cmd_code, p_clcb->req_sent_us);
   p_clcb->retry_count = 0;
 
   /* the size of the message may not be bigger than the local max PDU size*/
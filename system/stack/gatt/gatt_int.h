@@ -25,7 +25,9 @@
 
 #include <deque>
 #include <list>
+#include <map>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -236,8 +238,36 @@ typedef struct {
   uint8_t status;
   uint8_t cback_cnt[GATT_MAX_APPS];
   uint16_t cid;
+  uint64_t received_us; /* time the pending request was received */
 } tGATT_SR_CMD;
 
+/* Number of buckets of the ATT latency histograms: the first one counts the
+ * latencies shorter than 1 ms, bucket i those shorter than 2^i ms, and the
+ * last one all the longer ones */
+#define GATT_LATENCY_HIST_BUCKETS 14
+
+/* 99th percentile of the response time to one of our requests, above which
+ * the peer is reported as slow, once it answered enough of them */
+#define GATT_SLOW_PEER_P99_MS 1000
+#define GATT_SLOW_PEER_MIN_SAMPLES 20
+/* number of the last slow peers kept for dumpsys */
+#define GATT_MAX_SLOW_PEERS 8
+
+/* latency of the ATT requests of one opcode */
+typedef struct {
+  uint32_t buckets[GATT_LATENCY_HIST_BUCKETS];
+  uint32_t count;
+  uint64_t total_us;
+  uint64_t max_us;
+} tGATT_LATENCY_HIST;
+
+typedef struct {
+  RawAddress peer_bda;
+  uint8_t op_code;   /* request opcode whose latency is too long */
+  uint64_t p99_ms;
+  uint64_t detected_ms; /* boot time */
+} tGATT_SLOW_PEER;
+
 typedef enum : uint8_t {
   GATT_CH_CLOSE = 0,
   GATT_CH_CLOSING = 1,
@@ -313,6 +343,8 @@ typedef struct {
 
   uint16_t att_lcid; /* L2CAP channel ID for ATT */
   uint16_t payload_size;
+  /* Bearer of the prepared writes waiting for the execute write, 0 if none */
+  uint16_t prepare_write_cid;
 
   tGATT_CH_STATE ch_state;
 
@@ -323,6 +355,11 @@ typedef struct {
   tGATT_SR_CMD sr_cmd;
   uint16_t indicate_handle;
   fixed_queue_t* pending_ind_q;
+  /* channels reported congested by L2CAP */
+  std::unordered_set<uint16_t> congested_cids;
+  /* notifications held while their channel is congested, sent batched in
+   * Multiple Handle Value Notifications once it is not anymore */
+  std::unordered_map<uint16_t, std::deque<tGATT_VALUE>> held_notifs;
 
   alarm_t* conf_timer; /* peer confirm to indication timer */
 
@@ -349,6 +386,15 @@ typedef struct {
   /* Used to set proper TX DATA LEN on the controller*/
   uint16_t max_user_mtu;
 
+  /* ATT request latency by request opcode: from our requests to the peer
+   * responses, and from the peer requests to our responses */
+  std::map<uint8_t, tGATT_LATENCY_HIST> cl_latency;
+  std::map<uint8_t, tGATT_LATENCY_HIST> sr_latency;
+  /* set once the peer has been reported as slow */
+  bool slow_peer;
+  /* long reads and writes in progress, during which the LE link is given the
+   * connection parameters of bulk transfers */
+  uint8_t bulk_transfers;
 } tGATT_TCB;
 
 /* logic channel */
@@ -358,6 +404,31 @@ typedef struct {
   tGATT_DISC_RES result;
   bool wait_for_read_rsp;
 } tGATT_READ_INC_UUID128;
+
+/* Maximum number of read blob requests sent on other bearers for a long read,
+ * in addition to the one on the bearer of the read */
+#define GATT_LONG_READ_MAX_BLOBS 4
+
+/* Long read pipelined over the EATT bearers: the blobs of the value are read
+ * at once on several bearers, each of them by its own read blob clcb, and
+ * copied to the attribute buffer of the long read as they come */
+typedef struct {
+  /* read blob clcb, its responses are reported to the long read only */
+  bool blob;
+  /* read blob clcb: the long read, nullptr once it ended */
+  tGATT_CLCB* p_read;
+  /* offset of the outstanding read blob request */
+  uint16_t offset;
+  /* long read: next offset to read, 0 until the long read is pipelined */
+  uint16_t next_offset;
+  /* long read: length of the value, GATT_MAX_ATTR_LEN until known */
+  uint16_t end;
+  /* long read: number of read blob clcbs */
+  uint8_t num_blobs;
+  /* long read: no read blob request outstanding on its own bearer */
+  bool idle;
+} tGATT_LONG_READ;
+
 struct tGATT_CLCB {
   tGATT_TCB* p_tcb; /* associated TCB of this CLCB */
   tGATT_REG* p_reg; /* owner of this CLCB */
@@ -375,11 +446,14 @@ struct tGATT_CLCB {
   tGATT_STATUS status;     /* operation status */
   bool first_read_blob_after_read;
   tGATT_READ_INC_UUID128 read_uuid128;
+  tGATT_LONG_READ long_read;
   alarm_t* gatt_rsp_timer_ent; /* peer response timer */
   uint8_t retry_count;
   uint16_t read_req_current_mtu; /* This is the MTU value that the read was
                                     initiated with */
   uint16_t cid;
+  uint64_t req_sent_us; /* time the active request was sent */
+  bool bulk; /* counted in the bulk transfers of the tcb */
 };
 
 typedef struct {
@@ -418,6 +492,9 @@ typedef struct {
   tGATT_IF gatt_if;
   std::list<tGATT_HDL_LIST_ELEM>* hdl_list_info;
   std::list<tGATT_SRV_LIST_ELEM>* srv_list_info;
+  /* srv_list_info elements sorted by start handle, to find the service of a
+   * handle with a binary search */
+  std::vector<std::list<tGATT_SRV_LIST_ELEM>::iterator> srv_handle_index;
 
   fixed_queue_t* srv_chg_clt_q; /* service change clients queue */
   tGATT_REG cl_rcb[GATT_MAX_APPS];
@@ -452,12 +529,18 @@ typedef struct {
   uint8_t gatt_cl_supported_feat_mask;
 
   uint16_t handle_of_database_hash;
+  /* use gatts_get_database_hash(), database_hash is only recomputed when it
+   * is needed after the database changed */
   Octet16 database_hash;
+  bool database_hash_stale;
 
   tGATT_APPL_INFO cb_info;
 
   tGATT_HDL_CFG hdl_cfg;
   bool over_br_enabled;
+
+  /* last peers reported as slow, oldest first */
+  std::deque<tGATT_SLOW_PEER> slow_peers;
 } tGATT_CB;
 
 #define GATT_SIZE_OF_SRV_CHG_HNDL_RANGE 4
@@ -531,6 +614,13 @@ void gatt_sr_get_sec_info(const RawAddress& rem_bda, tBT_TRANSPORT transport,
                           tGATT_SEC_FLAG* p_sec_flag, uint8_t* p_key_size);
 void gatt_start_rsp_timer(tGATT_CLCB* p_clcb);
 void gatt_stop_rsp_timer(tGATT_CLCB* p_clcb);
+void gatt_latency_hist_add(tGATT_LATENCY_HIST& hist, uint64_t latency_us);
+uint64_t gatt_latency_hist_percentile_ms(const tGATT_LATENCY_HIST& hist,
+                                         uint8_t percentile);
+void gatt_cl_record_latency(tGATT_TCB& tcb, uint8_t op_code,
+                            uint64_t sent_us);
+void gatt_sr_record_latency(tGATT_TCB& tcb, uint8_t op_code,
+                            uint64_t received_us);
 void gatt_start_conf_timer(tGATT_TCB* p_tcb, uint16_t cid);
 void gatt_stop_conf_timer(tGATT_TCB& tcb, uint16_t cid);
 void gatt_rsp_timeout(void* data);
@@ -566,6 +656,7 @@ bool gatt_auto_connect_dev_remove(tGATT_IF gatt_if, const RawAddress& bd_addr);
 /* server function */
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle);
+void gatt_sr_update_handle_index();
 tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
                                      uint32_t trans_id, uint8_t op_code,
                                      tGATT_STATUS status, tGATTS_RSP* p_msg,
@@ -577,6 +668,12 @@ void gatt_sr_send_req_callback(uint16_t conn_id, uint32_t trans_id,
                                uint8_t op_code, tGATTS_DATA* p_req_data);
 uint32_t gatt_sr_enqueue_cmd(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
                              uint16_t handle);
+tGATT_STATUS gatt_sr_send_notification(tGATT_TCB& tcb, uint16_t cid,
+                                       const tGATT_VALUE& notif);
+bool gatt_sr_hold_notification(tGATT_TCB& tcb, uint16_t cid,
+                               const tGATT_VALUE& notif);
+void gatt_sr_channel_congestion(tGATT_TCB& tcb, uint16_t cid, bool congested);
+void gatt_sr_drop_held_notifications(tGATT_TCB& tcb, uint16_t cid);
 bool gatt_cancel_open(tGATT_IF gatt_if, const RawAddress& bda);
 void gatt_notify_phy_updated(tGATT_STATUS status, uint16_t handle,
                              uint8_t tx_phy, uint8_t rx_phy);
@@ -598,6 +695,10 @@ bool gatt_tcb_get_cid_available_for_indication(tGATT_TCB* p_tcb,
 bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
                                    uint16_t* indicated_handle_p);
 uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support);
+uint16_t gatt_tcb_get_att_cid_for_handle(tGATT_TCB& tcb, bool eatt_support,
+                                         const tGATT_CLCB* p_clcb,
+                                         uint16_t handle);
+bool gatt_tcb_is_cid_open(tGATT_TCB& tcb, uint16_t cid);
 uint16_t gatt_tcb_get_payload_size_tx(tGATT_TCB& tcb, uint16_t cid);
 uint16_t gatt_tcb_get_payload_size_rx(tGATT_TCB& tcb, uint16_t cid);
 void gatt_clcb_invalidate(tGATT_TCB* p_tcb, const tGATT_CLCB* p_clcb);
@@ -636,6 +737,8 @@ tGATT_STATUS gatt_send_write_msg(tGATT_TCB& p_tcb, tGATT_CLCB* p_clcb,
 void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
                             tBT_TRANSPORT transport);
 void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data);
+void gatt_long_read_complete_if_done(tGATT_CLCB* p_read);
+void gatt_bulk_transfer_start(tGATT_TCB& tcb, tGATT_CLCB* p_clcb);
 
 void gatt_act_discovery(tGATT_CLCB* p_clcb);
 void gatt_act_read(tGATT_CLCB* p_clcb, uint16_t offset);
@@ -692,5 +795,6 @@ bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
 
 /* gatt_sr_hash.cc */
 Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr);
+const Octet16& gatts_get_database_hash();
 
 #endif
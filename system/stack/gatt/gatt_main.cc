@@ -193,6 +193,7 @@ void gatt_free(void) {
   gatt_cb.hdl_list_info->clear();
   delete gatt_cb.hdl_list_info;
   gatt_cb.hdl_list_info = nullptr;
+  gatt_cb.srv_handle_index.clear();
   gatt_cb.srv_list_info->clear();
   delete gatt_cb.srv_list_info;
   gatt_cb.srv_list_info = nullptr;
@@ -633,6 +634,10 @@ static void gatt_channel_congestion(tGATT_TCB* p_tcb, bool congested) {
   tGATT_REG* p_reg = NULL;
   uint16_t conn_id;
 
+  if (p_tcb != NULL) {
+    gatt_sr_channel_congestion(*p_tcb, p_tcb->att_lcid, congested);
+  }
+
   /* if uncongested, check to see if there is any more pending data */
   if (p_tcb != NULL && !congested) {
     gatt_cl_send_next_cmd_inq(*p_tcb);
@@ -25,8 +25,10 @@
 #include <string.h>
 
 #include "bt_target.h"
+#include "common/time_util.h"
 #include "gatt_int.h"
 #include "l2c_api.h"
+#include "os/trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -40,6 +42,8 @@
 
 #define GATT_MTU_REQ_MIN_LEN 2
 #define L2CAP_PKT_OVERHEAD 4
+/* Notifications held per congested channel before they are flushed to L2CAP */
+#define GATT_MAX_HELD_NOTIFICATIONS 32
 
 using base::StringPrintf;
 using bluetooth::Uuid;
@@ -83,6 +87,7 @@ uint32_t gatt_sr_enqueue_cmd(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
       p_cmd->op_code = op_code;
       p_cmd->handle = handle;
       p_cmd->status = GATT_NOT_FOUND;
+      p_cmd->received_us = bluetooth::common::time_get_os_boottime_us();
       tcb.trans_id %= GATT_TRANS_ID_MAX;
       trans_id = p_cmd->trans_id;
     }
@@ -130,6 +135,10 @@ void gatt_dequeue_sr_cmd(tGATT_TCB& tcb, uint16_t cid) {
     p_cmd = &channel->server_outstanding_cmd_;
   }
 
+  if (p_cmd->op_code != 0) {
+    gatt_sr_record_latency(tcb, p_cmd->op_code, p_cmd->received_us);
+  }
+
   /* Double check in case any buffers are queued */
   VLOG(1) << "gatt_dequeue_sr_cmd cid: " << loghex(cid);
   if (p_cmd->p_rsp_msg)
@@ -1357,6 +1366,8 @@ static bool gatts_process_db_out_of_sync(tGATT_TCB& tcb, uint16_t cid,
 void gatt_server_handle_client_req(tGATT_TCB& tcb, uint16_t cid,
                                    uint8_t op_code, uint16_t len,
                                    uint8_t* p_data) {
+  BT_TRACE_INSTANT(GATT, "GATT server request", op_code);
+
   /* there is pending command, discard this one */
   if (!gatt_sr_cmd_empty(tcb, cid) && op_code != GATT_HANDLE_VALUE_CONF) return;
 
@@ -1425,3 +1436,148 @@ void gatt_server_handle_client_req(tGATT_TCB& tcb, uint16_t cid,
     }
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_send_notification
+ *
+ * Description      This function sends a single handle value notification on
+ *                  the given channel.
+ *
+ * Returns          GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS gatt_sr_send_notification(tGATT_TCB& tcb, uint16_t cid,
+                                       const tGATT_VALUE& notif) {
+  tGATT_SR_MSG gatt_sr_msg;
+  gatt_sr_msg.attr_value = notif;
+
+  uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+  BT_HDR* p_buf = attp_build_sr_msg(tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg,
+                                    payload_size);
+  if (p_buf == NULL) return GATT_NO_RESOURCES;
+
+  return attp_send_sr_msg(tcb, cid, p_buf);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_send_held_notifications
+ *
+ * Description      This function sends the notifications held for a channel,
+ *                  packing as many of them as fit in the MTU into each
+ *                  Multiple Handle Value Notification.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void gatt_sr_send_held_notifications(tGATT_TCB& tcb, uint16_t cid) {
+  auto it = tcb.held_notifs.find(cid);
+  if (it == tcb.held_notifs.end()) return;
+
+  /* The channel can become congested again while sending, take the queue out
+   * so that nothing is held behind the notifications being sent */
+  std::deque<tGATT_VALUE> notifs = std::move(it->second);
+  tcb.held_notifs.erase(it);
+
+  uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+  VLOG(1) << __func__ << ": cid=" << loghex(cid)
+          << " sending notifications=" << notifs.size();
+
+  while (!notifs.empty()) {
+    /* Opcode, then a handle, length and value tuple per notification */
+    uint16_t len = 1;
+    size_t count = 0;
+    for (const tGATT_VALUE& notif : notifs) {
+      if (len + 4 + notif.len > payload_size) break;
+      len += 4 + notif.len;
+      count++;
+    }
+
+    if (count < 2) {
+      gatt_sr_send_notification(tcb, cid, notifs.front());
+      notifs.pop_front();
+      continue;
+    }
+
+    BT_HDR* p_buf =
+        (BT_HDR*)osi_malloc(sizeof(BT_HDR) + len + L2CAP_MIN_OFFSET);
+    p_buf->offset = L2CAP_MIN_OFFSET;
+    p_buf->len = len;
+
+    uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+    UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+    for (size_t i = 0; i < count; i++) {
+      const tGATT_VALUE& notif = notifs.front();
+      UINT16_TO_STREAM(p, notif.handle);
+      UINT16_TO_STREAM(p, notif.len);
+      ARRAY_TO_STREAM(p, notif.value, notif.len);
+      notifs.pop_front();
+    }
+
+    attp_send_sr_msg(tcb, cid, p_buf);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_hold_notification
+ *
+ * Description      This function holds a notification while its channel is
+ *                  congested, when the client accepts Multiple Handle Value
+ *                  Notifications to batch it in once the channel is not
+ *                  congested anymore.
+ *
+ * Returns          true if the notification was held, false if it has to be
+ *                  sent right away.
+ *
+ ******************************************************************************/
+bool gatt_sr_hold_notification(tGATT_TCB& tcb, uint16_t cid,
+                               const tGATT_VALUE& notif) {
+  if (tcb.congested_cids.count(cid) == 0) return false;
+  if (!gatt_sr_is_cl_multi_variable_len_notif_supported(tcb)) return false;
+
+  std::deque<tGATT_VALUE>& notifs = tcb.held_notifs[cid];
+  notifs.push_back(notif);
+
+  /* Don't hold an unbounded amount of data, L2CAP queues it as well */
+  if (notifs.size() >= GATT_MAX_HELD_NOTIFICATIONS) {
+    gatt_sr_send_held_notifications(tcb, cid);
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_channel_congestion
+ *
+ * Description      This function tracks the congestion state of a channel, and
+ *                  sends the notifications held for it once it is not
+ *                  congested anymore.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_channel_congestion(tGATT_TCB& tcb, uint16_t cid, bool congested) {
+  if (congested) {
+    tcb.congested_cids.insert(cid);
+    return;
+  }
+
+  tcb.congested_cids.erase(cid);
+  gatt_sr_send_held_notifications(tcb, cid);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_drop_held_notifications
+ *
+ * Description      This function forgets the state of a channel being closed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_drop_held_notifications(tGATT_TCB& tcb, uint16_t cid) {
+  tcb.congested_cids.erase(cid);
+  tcb.held_notifs.erase(cid);
+}
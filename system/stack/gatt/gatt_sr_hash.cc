@@ -129,3 +129,14 @@ Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr) {
 
   return db_hash;
 }
+
+/* The hash of the local database, computed once for all the changes made to
+ * the database since it was last needed */
+const Octet16& gatts_get_database_hash() {
+  if (gatt_cb.database_hash_stale) {
+    gatt_cb.database_hash =
+        gatts_calculate_database_hash(gatt_cb.srv_list_info);
+    gatt_cb.database_hash_stale = false;
+  }
+  return gatt_cb.database_hash;
+}
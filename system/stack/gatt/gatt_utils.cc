@@ -26,10 +26,13 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstdint>
 #include <deque>
 
 #include "bt_target.h"  // Must be first to define build configuration
+#include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "rust/src/connection/ffi/connection_shim.h"
@@ -39,6 +42,7 @@
 #include "stack/gatt/gatt_int.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/l2c_api.h"
 #include "stack/include/l2cdefs.h"
 #include "stack/include/sdp_api.h"
 #include "types/bluetooth/uuid.h"
@@ -576,6 +580,7 @@ void gatt_start_rsp_timer(tGATT_CLCB* p_clcb) {
   }
   alarm_set_on_mloop(p_clcb->gatt_rsp_timer_ent, timeout_ms, gatt_rsp_timeout,
                      p_clcb);
+  p_clcb->req_sent_us = bluetooth::common::time_get_os_boottime_us();
 }
 
 /*******************************************************************************
@@ -591,6 +596,76 @@ void gatt_stop_rsp_timer(tGATT_CLCB* p_clcb) {
   alarm_cancel(p_clcb->gatt_rsp_timer_ent);
 }
 
+/** Add a sample to an ATT latency histogram */
+void gatt_latency_hist_add(tGATT_LATENCY_HIST& hist, uint64_t latency_us) {
+  uint64_t latency_ms = latency_us / 1000;
+  size_t bucket = 0;
+  while (latency_ms != 0 && bucket < GATT_LATENCY_HIST_BUCKETS - 1) {
+    latency_ms >>= 1;
+    bucket++;
+  }
+
+  hist.buckets[bucket]++;
+  hist.count++;
+  hist.total_us += latency_us;
+  hist.max_us = std::max(hist.max_us, latency_us);
+}
+
+/** Returns an upper bound of the given percentile of the latencies of an ATT
+ * latency histogram, in ms */
+uint64_t gatt_latency_hist_percentile_ms(const tGATT_LATENCY_HIST& hist,
+                                         uint8_t percentile) {
+  uint64_t max_ms = (hist.max_us + 999) / 1000;
+  uint64_t rank = ((uint64_t)hist.count * percentile + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < GATT_LATENCY_HIST_BUCKETS - 1; bucket++) {
+    seen += hist.buckets[bucket];
+    if (seen >= rank) return std::min<uint64_t>(1 << bucket, max_ms);
+  }
+  return max_ms;
+}
+
+/** Record the latency of the response of the peer to one of our requests, and
+ * report the peer once its response times get too long */
+void gatt_cl_record_latency(tGATT_TCB& tcb, uint8_t op_code,
+                            uint64_t sent_us) {
+  if (sent_us == 0) return;
+
+  tGATT_LATENCY_HIST& hist = tcb.cl_latency[op_code];
+  gatt_latency_hist_add(hist,
+                        bluetooth::common::time_get_os_boottime_us() - sent_us);
+
+  if (tcb.slow_peer || hist.count < GATT_SLOW_PEER_MIN_SAMPLES) return;
+
+  uint64_t p99_ms = gatt_latency_hist_percentile_ms(hist, 99);
+  if (p99_ms <= GATT_SLOW_PEER_P99_MS) return;
+
+  LOG_WARN("Slow peer %s: p99 latency of %s is %" PRIu64 " ms over %u requests",
+           ADDRESS_TO_LOGGABLE_CSTR(tcb.peer_bda),
+           (char*)gatt_dbg_op_name(op_code), p99_ms, hist.count);
+  tcb.slow_peer = true;
+
+  if (gatt_cb.slow_peers.size() == GATT_MAX_SLOW_PEERS) {
+    gatt_cb.slow_peers.pop_front();
+  }
+  gatt_cb.slow_peers.push_back(tGATT_SLOW_PEER{
+      .peer_bda = tcb.peer_bda,
+      .op_code = op_code,
+      .p99_ms = p99_ms,
+      .detected_ms = bluetooth::common::time_get_os_boottime_ms(),
+  });
+}
+
+/** Record the latency of our response to a request of the peer */
+void gatt_sr_record_latency(tGATT_TCB& tcb, uint8_t op_code,
+                            uint64_t received_us) {
+  if (received_us == 0) return;
+
+  gatt_latency_hist_add(
+      tcb.sr_latency[op_code],
+      bluetooth::common::time_get_os_boottime_us() - received_us);
+}
+
 /*******************************************************************************
  *
  * Function         gatt_start_conf_timer
@@ -772,15 +847,46 @@ void  gatt_ind_ack_timeout(void* data) {
  ******************************************************************************/
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle) {
-  auto it = gatt_cb.srv_list_info->begin();
+  const auto& index = gatt_cb.srv_handle_index;
 
-  for (; it != gatt_cb.srv_list_info->end(); it++) {
-    if (it->s_hdl <= handle && it->e_hdl >= handle) {
-      return it;
-    }
-  }
+  /* services don't overlap, only the last one starting at or before the
+   * handle can contain it */
+  auto it = std::upper_bound(
+      index.begin(), index.end(), handle,
+      [](uint16_t handle, std::list<tGATT_SRV_LIST_ELEM>::iterator el) {
+        return handle < el->s_hdl;
+      });
+  if (it == index.begin()) return gatt_cb.srv_list_info->end();
 
-  return it;
+  --it;
+  if ((*it)->e_hdl >= handle) return *it;
+  return gatt_cb.srv_list_info->end();
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_update_handle_index
+ *
+ * Description      Rebuild the handle index of the server services, after a
+ *                  service is added to or removed from srv_list_info.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_update_handle_index() {
+  auto& index = gatt_cb.srv_handle_index;
+  index.clear();
+  if (gatt_cb.srv_list_info == nullptr) return;
+
+  for (auto it = gatt_cb.srv_list_info->begin();
+       it != gatt_cb.srv_list_info->end(); it++) {
+    index.push_back(it);
+  }
+  std::sort(index.begin(), index.end(),
+            [](std::list<tGATT_SRV_LIST_ELEM>::iterator a,
+               std::list<tGATT_SRV_LIST_ELEM>::iterator b) {
+              return a->s_hdl < b->s_hdl;
+            });
 }
 
 /*******************************************************************************
@@ -1100,7 +1206,8 @@ bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
  *
  * Function         gatt_tcb_get_att_cid
  *
- * Description      This function gets cid for the GATT operation
+ * Description      This function gets cid for the GATT operation: the least
+ *                  loaded of the EATT channels and the ATT bearer.
  *
  * Returns          Available CID
  *
@@ -1110,13 +1217,58 @@ uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
   if (eatt_support && tcb.eatt) {
     EattChannel* channel =
         EattExtension::GetInstance()->GetChannelAvailableForClientRequest(tcb.peer_bda);
-    if (channel) {
+    if (channel && channel->cl_cmd_q_.size() <= tcb.cl_cmd_q.size()) {
       return channel->cid_;
     }
   }
   return tcb.att_lcid;
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_get_att_cid_for_handle
+ *
+ * Description      This function gets cid for a GATT read or write of the
+ *                  given attribute handle. Requests on the same handle stay on
+ *                  the bearer of the outstanding one so that the server
+ *                  handles them in order.
+ *
+ * Returns          Available CID
+ *
+ ******************************************************************************/
+uint16_t gatt_tcb_get_att_cid_for_handle(tGATT_TCB& tcb, bool eatt_support,
+                                         const tGATT_CLCB* p_clcb,
+                                         uint16_t handle) {
+  if (!eatt_support || !tcb.eatt) return tcb.att_lcid;
+
+  for (const tGATT_CLCB& clcb : gatt_cb.clcb_queue) {
+    if (&clcb == p_clcb || clcb.p_tcb != &tcb || clcb.s_handle != handle)
+      continue;
+    if (clcb.operation != GATTC_OPTYPE_READ &&
+        clcb.operation != GATTC_OPTYPE_WRITE)
+      continue;
+    if (gatt_tcb_is_cid_open(tcb, clcb.cid)) return clcb.cid;
+  }
+  return gatt_tcb_get_att_cid(tcb, eatt_support);
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_is_cid_open
+ *
+ * Description      This function checks whether cid is the ATT bearer or an
+ *                  EATT channel of the connection.
+ *
+ * Returns          true if the cid can carry requests
+ *
+ ******************************************************************************/
+bool gatt_tcb_is_cid_open(tGATT_TCB& tcb, uint16_t cid) {
+  if (cid == 0) return false;
+  if (cid == tcb.att_lcid) return true;
+  return EattExtension::GetInstance()->FindEattChannelByCid(tcb.peer_bda,
+                                                            cid) != nullptr;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_tcb_get_payload_size_tx
@@ -1154,6 +1306,28 @@ uint16_t gatt_tcb_get_payload_size_rx(tGATT_TCB& tcb, uint16_t cid) {
   return channel->rx_mtu_;
 }
 
+/** Count the long read or write of p_clcb in the bulk transfers of its LE
+ * link, the first one requesting the connection parameters of bulk transfers
+ * until the last one ends */
+void gatt_bulk_transfer_start(tGATT_TCB& tcb, tGATT_CLCB* p_clcb) {
+  if (p_clcb->bulk || tcb.transport != BT_TRANSPORT_LE) return;
+
+  p_clcb->bulk = true;
+  if (tcb.bulk_transfers++ == 0) {
+    L2CA_SetBleBulkTransfer(tcb.peer_bda, true);
+  }
+}
+
+static void gatt_bulk_transfer_end(tGATT_CLCB* p_clcb) {
+  if (!p_clcb->bulk) return;
+
+  p_clcb->bulk = false;
+  tGATT_TCB& tcb = *p_clcb->p_tcb;
+  if (tcb.bulk_transfers > 0 && --tcb.bulk_transfers == 0) {
+    L2CA_SetBleBulkTransfer(tcb.peer_bda, false);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         gatt_clcb_dealloc
@@ -1166,8 +1340,15 @@ uint16_t gatt_tcb_get_payload_size_rx(tGATT_TCB& tcb, uint16_t cid) {
  ******************************************************************************/
 static void gatt_clcb_dealloc(tGATT_CLCB* p_clcb) {
   if (p_clcb) {
+    gatt_bulk_transfer_end(p_clcb);
     alarm_free(p_clcb->gatt_rsp_timer_ent);
     gatt_clcb_invalidate(p_clcb->p_tcb, p_clcb);
+    if (p_clcb->long_read.num_blobs != 0) {
+      /* the read blob clcbs still outstanding end on their own */
+      for (tGATT_CLCB& clcb : gatt_cb.clcb_queue) {
+        if (clcb.long_read.p_read == p_clcb) clcb.long_read.p_read = nullptr;
+      }
+    }
     for (auto clcb_it = gatt_cb.clcb_queue.begin();
          clcb_it != gatt_cb.clcb_queue.end(); clcb_it++) {
       if (&(*clcb_it) == p_clcb) {
@@ -1607,6 +1788,21 @@ bool gatt_is_outstanding_msg_in_att_send_queue(const tGATT_TCB& tcb) {
  *
  ******************************************************************************/
 void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data) {
+  if (p_clcb->long_read.blob) {
+    /* read blob of a pipelined long read, which reports the value */
+    tGATT_CLCB* p_read = p_clcb->long_read.p_read;
+    gatt_stop_rsp_timer(p_clcb);
+    gatt_clcb_dealloc(p_clcb);
+    if (p_read) {
+      p_read->long_read.num_blobs--;
+      if (status != GATT_SUCCESS && p_read->status == GATT_SUCCESS) {
+        p_read->status = status;
+      }
+      gatt_long_read_complete_if_done(p_read);
+    }
+    return;
+  }
+
   tGATT_CL_COMPLETE cb_data;
   tGATT_CMPL_CBACK* p_cmpl_cb =
       (p_clcb->p_reg) ? p_clcb->p_reg->app_cb.p_cmpl_cb : NULL;
@@ -1615,6 +1811,7 @@ void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data) {
   tGATT_DISC_CMPL_CB* p_disc_cmpl_cb =
       (p_clcb->p_reg) ? p_clcb->p_reg->app_cb.p_disc_cmpl_cb : NULL;
   uint16_t conn_id;
+  uint16_t e_handle = p_clcb->e_handle;
   uint8_t operation;
 
   VLOG(1) << __func__
@@ -1667,7 +1864,7 @@ void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data) {
   gatt_clcb_dealloc(p_clcb);
 
   if (p_disc_cmpl_cb && (op == GATTC_OPTYPE_DISCOVERY))
-    (*p_disc_cmpl_cb)(conn_id, disc_type, status);
+    (*p_disc_cmpl_cb)(conn_id, disc_type, status, e_handle);
   else if (p_cmpl_cb && op)
     (*p_cmpl_cb)(conn_id, op, status, &cb_data);
   else
@@ -1677,6 +1874,20 @@ void gatt_end_operation(tGATT_CLCB* p_clcb, tGATT_STATUS status, void* p_data) {
                         operation, p_disc_cmpl_cb, p_cmpl_cb);
 }
 
+/** Ends a pipelined long read once none of its read blob requests are
+ * outstanding anymore */
+void gatt_long_read_complete_if_done(tGATT_CLCB* p_read) {
+  if (!p_read->long_read.idle || p_read->long_read.num_blobs != 0) return;
+
+  if (p_read->status != GATT_SUCCESS) {
+    gatt_end_operation(p_read, p_read->status, NULL);
+    return;
+  }
+
+  p_read->counter = p_read->long_read.end;
+  gatt_end_operation(p_read, GATT_SUCCESS, (void*)p_read->p_attr_buf);
+}
+
 /** This function cleans up the control blocks when L2CAP channel disconnect */
 void gatt_cleanup_upon_disc(const RawAddress& bda, tGATT_DISCONN_REASON reason,
                             tBT_TRANSPORT transport) {
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Adaptive Bit Rate control of the A2DP Source encoders.
+//
+// The controller follows the congestion of the link from the length of the
+// transmit queue, sampled on each media tick, and from the flushes of the
+// queue when it overflows. It steps down through |num_levels| quality levels
+// when the link is congested, and back up once the link stays clear. Level 0
+// is the configured quality, each encoder maps the levels to its own
+// parameter (SBC bitpool, AAC or Opus bit rate).
+//
+
+#ifndef A2DP_ABR_H
+#define A2DP_ABR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+  uint8_t num_levels;      // Number of quality levels
+  uint8_t level;           // Current quality level, 0 is the highest
+  uint32_t queue_average;  // Average transmit queue length, in 1/256 buffers
+  uint32_t hold_samples;   // Samples to wait before stepping down again
+  uint32_t clear_samples;  // Consecutive samples with a clear link
+
+  size_t total_decreases;
+  size_t total_increases;
+  size_t total_flushes;
+} tA2DP_ABR;
+
+// Initializes |p_abr| with |num_levels| quality levels, at the highest one.
+void a2dp_abr_init(tA2DP_ABR* p_abr, uint8_t num_levels);
+
+// Samples the |transmit_queue_length|, once per media tick.
+// Returns true if the quality level changed.
+bool a2dp_abr_set_transmit_queue_length(tA2DP_ABR* p_abr,
+                                        size_t transmit_queue_length);
+
+// Signals that the transmit queue overflowed and was flushed.
+// Returns true if the quality level changed.
+bool a2dp_abr_on_transmit_flush(tA2DP_ABR* p_abr);
+
+// Returns the value of an encoder parameter at the current quality level,
+// linearly from |max_value| at level 0 down to |min_value| at the lowest.
+uint32_t a2dp_abr_scale(const tA2DP_ABR* p_abr, uint32_t max_value,
+                        uint32_t min_value);
+
+// Dumps the state and statistics of |p_abr| to |fd|.
+void a2dp_abr_debug_dump(const tA2DP_ABR* p_abr, int fd);
+
+#endif  // A2DP_ABR_H
@@ -47,6 +47,7 @@ typedef struct {
   bool is_peer_edr;          // True if the A2DP peer supports EDR
   bool peer_supports_3mbps;  // True if the A2DP peer supports 3 Mbps EDR
   uint16_t peer_mtu;         // MTU of the A2DP peer
+  bool is_low_latency;       // True if the stream is in low latency mode
 } tA2DP_ENCODER_INIT_PEER_PARAMS;
 
 class A2dpCodecConfig {
@@ -521,6 +522,10 @@ typedef struct {
 
   // Set transmit queue length for the A2DP encoder.
   void (*set_transmit_queue_length)(size_t transmit_queue_length);
+
+  // Notify the A2DP encoder that the transmit queue overflowed and was
+  // flushed.
+  void (*on_transmit_flush)(void);
 } tA2DP_ENCODER_INTERFACE;
 
 // Prototype for a callback to receive decoded audio data from a
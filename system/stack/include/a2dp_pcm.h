@@ -0,0 +1,43 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// PCM sample format conversions of the A2DP codecs.
+//
+// The audio HAL feeds the encoders with interleaved stereo PCM, which the
+// encoders taking one buffer per channel (aptX, aptX HD) split with these
+// kernels. They use SSE2 / SSSE3 on x86 and NEON on ARM when the build
+// enables them, and scalar loops otherwise, with identical results.
+//
+
+#ifndef A2DP_PCM_H
+#define A2DP_PCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Splits |frames| interleaved stereo frames of 16 bits samples from |src|
+// into the sign extended samples of |left| and |right|.
+void a2dp_pcm_deinterleave_16(const int16_t* src, int32_t* left,
+                              int32_t* right, size_t frames);
+
+// Splits |frames| interleaved stereo frames of packed 24 bits little endian
+// samples (AUDIO_FORMAT_PCM_24_BIT_PACKED, 6 bytes per frame) from |src|
+// into the sign extended samples of |left| and |right|.
+void a2dp_pcm_deinterleave_24_packed(const uint8_t* src, int32_t* left,
+                                     int32_t* right, size_t frames);
+
+#endif  // A2DP_PCM_H
@@ -65,6 +65,12 @@ int a2dp_sbc_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_sbc_send_frames(uint64_t timestamp_us);
 
+// Set transmit queue length for the A2DP SBC encoder, adapting its bitpool.
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length);
+
+// Notify the A2DP SBC encoder that the transmit queue was flushed.
+void a2dp_sbc_on_transmit_flush(void);
+
 // Get SBC bitrate
 // Returns |uint32_t| bitrate in bits per second
 uint32_t a2dp_sbc_get_bitrate();
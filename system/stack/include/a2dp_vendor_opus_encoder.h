@@ -53,6 +53,9 @@ void a2dp_vendor_opus_send_frames(uint64_t timestamp_us);
 // Set transmit queue length for the A2DP Opus (Dynamic Bit Rate) mechanism.
 void a2dp_vendor_opus_set_transmit_queue_length(size_t transmit_queue_length);
 
+// Notify the A2DP Opus encoder that the transmit queue was flushed.
+void a2dp_vendor_opus_on_transmit_flush(void);
+
 // Get the A2DP Opus encoded maximum frame size
 int a2dp_vendor_opus_get_effective_frame_size();
 
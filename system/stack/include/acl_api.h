@@ -286,6 +286,19 @@ void btm_configure_data_path(uint8_t direction, uint8_t path_id,
  ******************************************************************************/
 bool BTM_ReadPowerMode(const RawAddress& remote_bda, tBTM_PM_MODE* p_mode);
 
+/*******************************************************************************
+ *
+ * Function         BTM_GetAclTrafficBytes
+ *
+ * Description      This returns the number of bytes of ACL data sent to and
+ *                  received from the device since the link was created.
+ *
+ * Returns          the number of bytes, 0 if there is no link.
+ *
+ ******************************************************************************/
+uint64_t BTM_GetAclTrafficBytes(const RawAddress& remote_bda,
+                                tBT_TRANSPORT transport);
+
 void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
                      tHCI_ROLE link_role, tBT_TRANSPORT transport);
 
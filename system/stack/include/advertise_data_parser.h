@@ -143,3 +143,105 @@ class AdvertiseDataParser {
     return GetFieldByType(ad.data(), ad.size(), type, p_length);
   }
 };
+
+/**
+ * Index of the fields of an advertising payload, built in a single walk over
+ * the data so that looking up several field types doesn't walk it again for
+ * each of them. The index doesn't copy the payload, which must outlive it.
+ * Lookups return the same fields as AdvertiseDataParser::GetFieldByType.
+ */
+class AdvertiseDataIndex {
+ public:
+  // Enough for any legacy payload; the fields of longer extended payloads past
+  // this many are found by walking the rest of the data.
+  static constexpr size_t kMaxFields = 32;
+
+  struct Field {
+    uint8_t type;
+    uint8_t length;   // Length of the value, without the type
+    uint16_t offset;  // Offset of the value in the payload
+  };
+
+  AdvertiseDataIndex(const uint8_t* ad, size_t ad_len)
+      : ad_(ad), ad_len_(ad_len), tail_position_(ad_len) {
+    size_t position = 0;
+
+    while (position != ad_len) {
+      uint8_t len = ad[position];
+
+      if (len == 0) break;
+      if (position + len >= ad_len) break;
+
+      if (num_fields_ == kMaxFields) {
+        tail_position_ = position;
+        break;
+      }
+
+      fields_[num_fields_++] = {
+          .type = ad[position + 1],
+          .length = static_cast<uint8_t>(len - 1),
+          .offset = static_cast<uint16_t>(position + 2),
+      };
+
+      position += len + 1; /* skip the length of data */
+    }
+  }
+
+  explicit AdvertiseDataIndex(const std::vector<uint8_t>& ad)
+      : AdvertiseDataIndex(ad.data(), ad.size()) {}
+
+  size_t size() const { return num_fields_; }
+  const Field& operator[](size_t i) const { return fields_[i]; }
+
+  /**
+   * Call |callback| with the value and the length of each field of |type|, in
+   * the order they appear in the payload, until it returns false.
+   */
+  template <typename Callback>
+  void ForEachFieldOfType(uint8_t type, Callback callback) const {
+    for (size_t i = 0; i < num_fields_; i++) {
+      if (fields_[i].type == type &&
+          !callback(ad_ + fields_[i].offset, fields_[i].length)) {
+        return;
+      }
+    }
+
+    size_t position = tail_position_;
+    while (position != ad_len_) {
+      uint8_t len = ad_[position];
+
+      if (len == 0) break;
+      if (position + len >= ad_len_) break;
+
+      if (ad_[position + 1] == type &&
+          !callback(ad_ + position + 2, static_cast<uint8_t>(len - 1))) {
+        return;
+      }
+
+      position += len + 1; /* skip the length of data */
+    }
+  }
+
+  /**
+   * Return a pointer to the value of the first field of |type|, together with
+   * its length in |p_length|, or NULL if there is none.
+   */
+  const uint8_t* GetFieldByType(uint8_t type, uint8_t* p_length) const {
+    const uint8_t* value = NULL;
+    *p_length = 0;
+    ForEachFieldOfType(type, [&](const uint8_t* field, uint8_t length) {
+      value = field;
+      *p_length = length;
+      return false;
+    });
+    return value;
+  }
+
+ private:
+  const uint8_t* ad_;
+  size_t ad_len_;
+  // Where the walk stopped because the index was full
+  size_t tail_position_;
+  size_t num_fields_ = 0;
+  std::array<Field, kMaxFields> fields_;
+};
@@ -172,6 +172,24 @@ class IsoManager {
   virtual void SendIsoData(uint16_t conn_handle, const uint8_t* data,
                            uint16_t data_len);
 
+  /**
+   * Gets the buffer of the next iso data sent on a connection, for the caller
+   * to write the data into in place rather than have it copied by
+   * SendIsoData(). The data is sent with SendIsoDataBuffer().
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   * @param data_len iso data length
+   * @return the data buffer, or nullptr if the data can not be sent
+   */
+  virtual uint8_t* GetIsoDataBuffer(uint16_t conn_handle, uint16_t data_len);
+
+  /**
+   * Sends the iso data written into the buffer from GetIsoDataBuffer()
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   */
+  virtual void SendIsoDataBuffer(uint16_t conn_handle);
+
   /**
    * Creates the Broadcast Isochronous Group
    *
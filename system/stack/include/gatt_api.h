@@ -723,9 +723,10 @@ typedef struct {
 typedef void(tGATT_DISC_RES_CB)(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                                 tGATT_DISC_RES* p_data);
 
-/* discover complete callback function */
+/* discover complete callback function, e_handle is the end handle of the
+ * discovered range */
 typedef void(tGATT_DISC_CMPL_CB)(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
-                                 tGATT_STATUS status);
+                                 tGATT_STATUS status, uint16_t e_handle);
 
 /* Define a callback function for when read/write/disc/config operation is
  * completed. */
@@ -1066,6 +1067,35 @@ tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
 tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
                         tGATT_READ_PARAM* p_read);
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultipleVariableLengthSupported
+ *
+ * Description      This function is called to check whether the server
+ *                  supports the Read Multiple Variable Length procedure.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if GATT_READ_MULTIPLE_VAR_LEN reads can be used.
+ *
+ ******************************************************************************/
+bool GATTC_IsReadMultipleVariableLengthSupported(uint16_t conn_id);
+
+/*******************************************************************************
+ *
+ * Function         GATTC_GetNumBearers
+ *
+ * Description      This function is called to get the number of ATT bearers
+ *                  requests of the connection can be spread over: the ATT
+ *                  bearer, and the EATT bearers if the application uses them.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          number of bearers, 0 if the connection is unknown.
+ *
+ ******************************************************************************/
+uint8_t GATTC_GetNumBearers(uint16_t conn_id);
+
 /*******************************************************************************
  *
  * Function         GATTC_Write
@@ -1315,4 +1345,8 @@ void gatt_reset_bgdev_list(bool after_reset);
 // Initialize GATTS list of bonded device service change updates.
 void gatt_load_bonded(void);
 
+// Dumps the ATT request latency of the connected peers, and the last peers
+// reported as slow.
+void GATT_Dumpsys(int fd);
+
 #endif /* GATT_API_H */
@@ -836,6 +836,69 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
                               uint16_t timeout, uint16_t min_ce_len,
                               uint16_t max_ce_len);
 
+/* Workloads of an LE link, each requesting its own connection parameters */
+typedef enum : uint8_t {
+  L2CA_BLE_WORKLOAD_PROFILE = 0, /* L2CA_UpdateBleConnParams() */
+  L2CA_BLE_WORKLOAD_HID,
+  L2CA_BLE_WORKLOAD_AUDIO,
+  L2CA_BLE_WORKLOAD_BULK,
+  L2CA_BLE_WORKLOAD_MAX,
+} tL2CA_BLE_WORKLOAD;
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_RequestBleConnParams
+ *
+ *  Description     Request the connection parameters of a workload of the
+ *                  link. The requests of all the workloads are resolved into
+ *                  the most demanding parameters: the shortest intervals and
+ *                  latency, the longest timeout and connection events.
+ *
+ *  Parameters:     BD Address of remote
+ *                  workload making the request
+ *
+ *  Return value:   true if update started
+ *
+ ******************************************************************************/
+bool L2CA_RequestBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload, uint16_t min_int,
+                               uint16_t max_int, uint16_t latency,
+                               uint16_t timeout, uint16_t min_ce_len,
+                               uint16_t max_ce_len);
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_ReleaseBleConnParams
+ *
+ *  Description     Withdraw the connection parameters requested by a workload
+ *                  of the link. The link goes back to the default parameters
+ *                  once no workload requests any.
+ *
+ *  Parameters:     BD Address of remote
+ *                  workload withdrawing its request
+ *
+ *  Return value:   true if update started
+ *
+ ******************************************************************************/
+bool L2CA_ReleaseBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload);
+
+/*******************************************************************************
+ *
+ *  Function        L2CA_SetBleBulkTransfer
+ *
+ *  Description     Start or end a bulk transfer on the link: short connection
+ *                  intervals are requested for its duration, along with the
+ *                  LE 2M PHY and the maximum data length.
+ *
+ *  Parameters:     BD Address of remote
+ *                  true when the transfer starts
+ *
+ *  Return value:   true if update started
+ *
+ ******************************************************************************/
+bool L2CA_SetBleBulkTransfer(const RawAddress& rem_bda, bool active);
+
 /*******************************************************************************
  *
  *  Function        L2CA_EnableUpdateBleConnParams
@@ -935,4 +998,8 @@ void L2CA_SetMediaStreamChannel(uint16_t local_media_cid, bool status);
 bool L2CA_isMediaChannel(uint16_t handle, uint16_t channel_id,
                          bool is_local_cid);
 
+// Dumps the links and channels of L2CAP, with the memory of their control
+// blocks.
+void L2CA_Dumpsys(int fd);
+
 #endif /* L2C_API_H */
@@ -351,6 +351,21 @@ int PORT_GetState(uint16_t handle, tPORT_STATE* p_settings);
  ******************************************************************************/
 int PORT_FlowControl_MaxCredit(uint16_t handle, bool enable);
 
+/*******************************************************************************
+ *
+ * Function         PORT_SetTxCoalescing
+ *
+ * Description      This function sets how long the small writes to a port
+ *                  wait for more data, so that they are sent together in
+ *                  frames of up to the peer MTU.  Writes are sent right away
+ *                  when the delay is 0, the default.
+ *
+ * Parameters:      handle     - Handle returned in the RFCOMM_CreateConnection
+ *                  delay_ms   - Delay of the small writes, in milliseconds
+ *
+ ******************************************************************************/
+int PORT_SetTxCoalescing(uint16_t handle, uint16_t delay_ms);
+
 #define PORT_DTRDSR_ON 0x01
 #define PORT_CTSRTS_ON 0x02
 #define PORT_RING_ON 0x04
@@ -38,6 +38,7 @@
 #include "gd/os/system_properties.h"
 #include "gd/os/metrics.h"
 #include "hci/include/btsnoop.h"
+#include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
 #include "main/shim/metrics_api.h"
 #include "osi/include/allocator.h"
@@ -1918,3 +1919,21 @@ bool L2CA_isMediaChannel(uint16_t handle, uint16_t channel_id,
 
   return ret;
 }
+
+#define DUMPSYS_TAG "stack::l2cap"
+void L2CA_Dumpsys(int fd) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) return;
+
+  LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+
+  LOG_DUMPSYS(fd, "  links in_use:%hu/%d lcb_pool_bytes:%zu",
+              l2cb.num_used_lcbs, MAX_L2CAP_LINKS, sizeof(l2cb.lcb_pool));
+  LOG_DUMPSYS(fd,
+              "  channels in_use:%d allocated:%hu limit:%hu "
+              "ccb_bytes:%zu",
+              l2cb.num_allocated_ccbs - l2cb.num_free_ccbs,
+              l2cb.num_allocated_ccbs, l2cb.max_ccbs,
+              l2cb.num_allocated_ccbs * sizeof(tL2C_CCB));
+  LOG_DUMPSYS(fd, "  control_block_bytes:%zu", sizeof(tL2C_CB));
+}
+#undef DUMPSYS_TAG
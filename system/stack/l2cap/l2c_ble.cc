@@ -28,6 +28,8 @@
 #include <base/strings/stringprintf.h>
 #include <log/log.h>
 
+#include <algorithm>
+
 #ifdef __ANDROID__
 #include <android/sysprop/BluetoothProperties.sysprop.h>
 #endif
@@ -68,6 +70,10 @@ extern tBTM_CB btm_cb;
 
 using base::StringPrintf;
 
+/* Connection intervals of the bulk transfers, 7.5 to 15 ms */
+#define L2CAP_BLE_BULK_CONN_INT_MIN BTM_BLE_CONN_INT_MIN
+#define L2CAP_BLE_BULK_CONN_INT_MAX 12
+
 static void l2cble_start_conn_update(tL2C_LCB* p_lcb);
 static void l2cble_start_subrate_change(tL2C_LCB* p_lcb);
 void gatt_notify_conn_update(const RawAddress& remote, uint16_t interval,
@@ -89,45 +95,159 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
                               uint16_t max_int, uint16_t latency,
                               uint16_t timeout, uint16_t min_ce_len,
                               uint16_t max_ce_len) {
-  if (bluetooth::shim::is_gd_l2cap_enabled()) {
-    bluetooth::shim::L2CA_LeConnectionUpdate(rem_bda, min_int, max_int, latency,
-                                             timeout, min_ce_len, max_ce_len);
-    return true;
+  return L2CA_RequestBleConnParams(rem_bda, L2CA_BLE_WORKLOAD_PROFILE, min_int,
+                                   max_int, latency, timeout, min_ce_len,
+                                   max_ce_len);
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_resolve_conn_params
+ *
+ *  Description     Resolve the connection parameters requested by the
+ *                  workloads of the link, the most demanding of them winning.
+ *
+ *  Return value:   the parameters, the default ones if no workload has a
+ *                  request.
+ *
+ ******************************************************************************/
+tL2C_BLE_CONN_PARAMS l2cble_resolve_conn_params(const tL2C_LCB& lcb) {
+  tL2C_BLE_CONN_PARAMS params = {
+      .min_int = BTM_BLE_CONN_INT_MIN_DEF,
+      .max_int = BTM_BLE_CONN_INT_MAX_DEF,
+      .latency = BTM_BLE_CONN_PERIPHERAL_LATENCY_DEF,
+      .timeout = BTM_BLE_CONN_TIMEOUT_DEF,
+      .min_ce_len = 0,
+      .max_ce_len = 0,
+  };
+
+  bool first = true;
+  for (int i = 0; i < L2CA_BLE_WORKLOAD_MAX; i++) {
+    if (!(lcb.workload_mask & (1 << i))) continue;
+    const tL2C_BLE_CONN_PARAMS& request = lcb.workload_params[i];
+    if (first) {
+      params = request;
+      first = false;
+      continue;
+    }
+    /* each request meeting the timeout constraint, so does the resolution */
+    params.min_int = std::min(params.min_int, request.min_int);
+    params.max_int = std::min(params.max_int, request.max_int);
+    params.latency = std::min(params.latency, request.latency);
+    params.timeout = std::max(params.timeout, request.timeout);
+    params.min_ce_len = std::max(params.min_ce_len, request.min_ce_len);
+    params.max_ce_len = std::max(params.max_ce_len, request.max_ce_len);
   }
+  return params;
+}
 
-  tL2C_LCB* p_lcb;
+/* Update the connection parameters of the link to the resolution of the
+ * requests of its workloads */
+static void l2cble_update_workload_conn_params(tL2C_LCB* p_lcb) {
+  tL2C_BLE_CONN_PARAMS params = l2cble_resolve_conn_params(*p_lcb);
 
-  /* See if we have a link control block for the remote device */
-  p_lcb = l2cu_find_lcb_by_bd_addr(rem_bda, BT_TRANSPORT_LE);
+  VLOG(2) << __func__ << ": BD_ADDR=" << p_lcb->remote_bd_addr
+          << StringPrintf(" workloads=0x%02x", p_lcb->workload_mask)
+          << ", min_int=" << params.min_int << ", max_int=" << params.max_int
+          << ", latency=" << params.latency << ", timeout=" << params.timeout;
 
-  /* If we do not have one, create one and accept the connection. */
+  p_lcb->min_interval = params.min_int;
+  p_lcb->max_interval = params.max_int;
+  p_lcb->latency = params.latency;
+  p_lcb->timeout = params.timeout;
+  p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
+  p_lcb->min_ce_len = params.min_ce_len;
+  p_lcb->max_ce_len = params.max_ce_len;
+
+  l2cble_start_conn_update(p_lcb);
+}
+
+/* Returns the LE link control block of rem_bda if the link is up */
+static tL2C_LCB* l2cble_find_connected_lcb(const RawAddress& rem_bda) {
+  tL2C_LCB* p_lcb = l2cu_find_lcb_by_bd_addr(rem_bda, BT_TRANSPORT_LE);
   if (!p_lcb || !BTM_IsAclConnectionUp(rem_bda, BT_TRANSPORT_LE)) {
     LOG(WARNING) << __func__ << " - unknown BD_ADDR " << rem_bda;
-    return (false);
+    return nullptr;
   }
 
   if (p_lcb->transport != BT_TRANSPORT_LE) {
     LOG(WARNING) << __func__ << " - BD_ADDR " << rem_bda << " not LE";
+    return nullptr;
+  }
+  return p_lcb;
+}
+
+bool L2CA_RequestBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload, uint16_t min_int,
+                               uint16_t max_int, uint16_t latency,
+                               uint16_t timeout, uint16_t min_ce_len,
+                               uint16_t max_ce_len) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    bluetooth::shim::L2CA_LeConnectionUpdate(rem_bda, min_int, max_int, latency,
+                                             timeout, min_ce_len, max_ce_len);
+    return true;
+  }
+
+  tL2C_LCB* p_lcb = l2cble_find_connected_lcb(rem_bda);
+  if (p_lcb == nullptr) {
     return (false);
   }
 
-  VLOG(2) << __func__ << ": BD_ADDR=" << rem_bda << ", min_int=" << min_int
-          << ", max_int=" << max_int << ", min_ce_len=" << min_ce_len
-          << ", max_ce_len=" << max_ce_len;
+  VLOG(2) << __func__ << ": BD_ADDR=" << rem_bda
+          << ", workload=" << static_cast<int>(workload)
+          << ", min_int=" << min_int << ", max_int=" << max_int
+          << ", min_ce_len=" << min_ce_len << ", max_ce_len=" << max_ce_len;
+
+  p_lcb->workload_params[workload] = {
+      .min_int = min_int,
+      .max_int = max_int,
+      .latency = latency,
+      .timeout = timeout,
+      .min_ce_len = min_ce_len,
+      .max_ce_len = max_ce_len,
+  };
+  p_lcb->workload_mask |= (1 << workload);
+  l2cble_update_workload_conn_params(p_lcb);
 
-  p_lcb->min_interval = min_int;
-  p_lcb->max_interval = max_int;
-  p_lcb->latency = latency;
-  p_lcb->timeout = timeout;
-  p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
-  p_lcb->min_ce_len = min_ce_len;
-  p_lcb->max_ce_len = max_ce_len;
+  return (true);
+}
 
-  l2cble_start_conn_update(p_lcb);
+bool L2CA_ReleaseBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload) {
+  if (bluetooth::shim::is_gd_l2cap_enabled()) {
+    /* the requests are not arbitrated by the gd L2CAP */
+    return false;
+  }
+
+  tL2C_LCB* p_lcb = l2cble_find_connected_lcb(rem_bda);
+  if (p_lcb == nullptr || !(p_lcb->workload_mask & (1 << workload))) {
+    return (false);
+  }
+
+  VLOG(2) << __func__ << ": BD_ADDR=" << rem_bda
+          << ", workload=" << static_cast<int>(workload);
+
+  p_lcb->workload_mask &= ~(1 << workload);
+  l2cble_update_workload_conn_params(p_lcb);
 
   return (true);
 }
 
+bool L2CA_SetBleBulkTransfer(const RawAddress& rem_bda, bool active) {
+  if (!active) {
+    return L2CA_ReleaseBleConnParams(rem_bda, L2CA_BLE_WORKLOAD_BULK);
+  }
+
+  /* the faster PHY and the longer packets are kept once the transfer ends,
+   * they cost nothing to an idle link */
+  BTM_BleSetPhy(rem_bda, PHY_LE_2M, PHY_LE_2M, 0);
+  BTM_SetBleDataLength(rem_bda, BTM_BLE_DATA_SIZE_MAX);
+
+  return L2CA_RequestBleConnParams(
+      rem_bda, L2CA_BLE_WORKLOAD_BULK, L2CAP_BLE_BULK_CONN_INT_MIN,
+      L2CAP_BLE_BULK_CONN_INT_MAX, 0, BTM_BLE_CONN_TIMEOUT_DEF, 0, 0);
+}
+
 /*******************************************************************************
  *
  *  Function        L2CA_EnableUpdateBleConnParams
@@ -32,6 +32,7 @@
 #include "bt_target.h"
 #include "common/time_util.h"
 #include "gd/hal/snoop_logger.h"
+#include "gd/os/trace.h"
 #include "main/shim/metrics_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
@@ -1724,6 +1725,8 @@ void l2c_enqueue_peer_data(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
         p_ccb->remote_cid);
   } else {
     fixed_queue_enqueue(p_ccb->xmit_hold_q, p_buf);
+    BT_TRACE_COUNTER(L2CAP, "L2CAP channel queue",
+                     fixed_queue_length(p_ccb->xmit_hold_q));
   }
 
   l2cu_check_channel_congestion(p_ccb);
@@ -425,6 +425,16 @@ typedef enum : uint8_t {
 /* Define a link control block. There is one link control block between
  * this device and any other device (i.e. BD ADDR).
 */
+/* LE connection parameters requested by a workload of a link */
+typedef struct {
+  uint16_t min_int;
+  uint16_t max_int;
+  uint16_t latency;
+  uint16_t timeout;
+  uint16_t min_ce_len;
+  uint16_t max_ce_len;
+} tL2C_BLE_CONN_PARAMS;
+
 typedef struct t_l2c_linkcb {
   bool in_use; /* true when in use, false when not */
   tL2C_LINK_STATE link_state;
@@ -545,6 +555,10 @@ typedef struct t_l2c_linkcb {
   uint16_t min_ce_len;
   uint16_t max_ce_len;
 
+  /* parameters requested by each workload, resolved into the ones above */
+  tL2C_BLE_CONN_PARAMS workload_params[L2CA_BLE_WORKLOAD_MAX];
+  uint8_t workload_mask; /* workloads with a request */
+
 #define L2C_BLE_SUBRATE_REQ_DISABLE 0x1  // disable subrate req
 #define L2C_BLE_NEW_SUBRATE_PARAM 0x2    // new subrate req parameter to be set
 #define L2C_BLE_SUBRATE_REQ_PENDING 0x4  // waiting for subrate to be completed
@@ -610,11 +624,23 @@ typedef struct {
   bool is_cong_cback_context;
 
   tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];    /* Link Control Block pool */
-  tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
+  /* Channel Control Block pool. The CCBs are allocated as the channels need
+   * them and kept until l2c_free, the local CID of a CCB is given by its index
+   * in the pool. */
+  tL2C_CCB* ccb_pool[MAX_L2CAP_CHANNELS];
   tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
 
+  /* One plus the lcb_pool index of the LCB that was last given each HCI
+   * handle, zero if none. Entries are not cleared when a link goes away, so
+   * the LCB needs to be checked, but they make the lookup of the LCB of a
+   * received packet independent of the number of links. */
+  uint8_t lcb_index_by_handle[HCI_HANDLE_MAX + 1];
+
   tL2C_CCB* p_free_ccb_first; /* Pointer to first free CCB */
   tL2C_CCB* p_free_ccb_last;  /* Pointer to last  free CCB */
+  uint16_t num_allocated_ccbs; /* Number of CCBs allocated in the pool */
+  uint16_t num_free_ccbs;      /* Number of CCBs on the free queue */
+  uint16_t max_ccbs;           /* Limit of the CCBs allocated in the pool */
 
   bool disallow_switch;     /* false, to allow switch at create conn */
   uint16_t num_lm_acl_bufs; /* # of ACL buffers on controller */
@@ -877,6 +903,7 @@ tL2CAP_LE_RESULT_CODE l2ble_sec_access_req(const RawAddress& bd_addr,
                                            void* p_ref_data);
 
 void l2cble_update_data_length(tL2C_LCB* p_lcb);
+tL2C_BLE_CONN_PARAMS l2cble_resolve_conn_params(const tL2C_LCB& lcb);
 
 void l2cu_process_fixed_disc_cback(tL2C_LCB* p_lcb);
 
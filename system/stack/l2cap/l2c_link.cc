@@ -28,6 +28,7 @@
 #include <cstdint>
 
 #include "device/include/device_iot_config.h"
+#include "gd/os/trace.h"
 #include "main/shim/l2c_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
@@ -751,9 +752,9 @@ void l2c_link_adjust_allocation(void) {
 void l2c_link_adjust_chnl_allocation(void) {
   /* assign buffer quota to each channel based on its data rate requirement */
   for (uint8_t xx = 0; xx < MAX_L2CAP_CHANNELS; xx++) {
-    tL2C_CCB* p_ccb = l2cb.ccb_pool + xx;
+    tL2C_CCB* p_ccb = l2cb.ccb_pool[xx];
 
-    if (!p_ccb->in_use) continue;
+    if (p_ccb == nullptr || !p_ccb->in_use) continue;
 
     tL2CAP_CHNL_DATA_RATE data_rate = p_ccb->tx_data_rate + p_ccb->rx_data_rate;
     p_ccb->buff_quota = L2CAP_CBB_DEFAULT_DATA_RATE_BUFF_QUOTA * data_rate;
@@ -1104,6 +1105,8 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
 }
 
 static void l2c_link_send_to_lower(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
+  BT_TRACE_COUNTER(L2CAP, "L2CAP link queue",
+                   list_length(p_lcb->link_xmit_data_q));
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) {
     l2c_link_send_to_lower_br_edr(p_lcb, p_buf);
   } else {
@@ -26,8 +26,11 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "bt_target.h"
 #include "gd/hal/snoop_logger.h"
+#include "gd/os/system_properties.h"
 #include "hcimsgs.h"  // HCID_GET_
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
@@ -838,24 +841,21 @@ void l2c_init(void) {
     return;
   }
 
-  int16_t xx;
-
   memset(&l2cb, 0, sizeof(tL2C_CB));
 
   /* the LE PSM is increased by 1 before being used */
   l2cb.le_dyn_psm = LE_DYNAMIC_PSM_START - 1;
 
-  /* Put all the channel control blocks on the free queue */
-  for (xx = 0; xx < MAX_L2CAP_CHANNELS - 1; xx++) {
-    l2cb.ccb_pool[xx].p_next_ccb = &l2cb.ccb_pool[xx + 1];
-  }
+  /* The channel control blocks are allocated when the channels are created,
+   * up to a limit that devices with few profiles can lower */
+  l2cb.max_ccbs = std::clamp<uint32_t>(
+      bluetooth::os::GetSystemPropertyUint32Base(
+          "bluetooth.l2cap.max_channels.value", MAX_L2CAP_CHANNELS),
+      1, MAX_L2CAP_CHANNELS);
 
   /* it will be set to L2CAP_PKT_START_NON_FLUSHABLE if controller supports */
   l2cb.non_flushable_pbf = L2CAP_PKT_START << L2CAP_PKT_TYPE_SHIFT;
 
-  l2cb.p_free_ccb_first = &l2cb.ccb_pool[0];
-  l2cb.p_free_ccb_last = &l2cb.ccb_pool[MAX_L2CAP_CHANNELS - 1];
-
   /* Set the default idle timeout */
   l2cb.idle_timeout = L2CAP_LINK_INACTIVITY_TOUT;
 
@@ -882,6 +882,14 @@ void l2c_free(void) {
     // L2CAP cleanup should be handled by GD stack manager
     return;
   }
+
+  for (tL2C_CCB*& p_ccb : l2cb.ccb_pool) {
+    delete p_ccb;
+    p_ccb = nullptr;
+  }
+  l2cb.p_free_ccb_first = l2cb.p_free_ccb_last = nullptr;
+  l2cb.num_allocated_ccbs = 0;
+  l2cb.num_free_ccbs = 0;
 }
 
 void l2c_ccb_timer_timeout(void* data) {
@@ -108,6 +108,10 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
              p_lcb.Handle(), handle);
   }
   p_lcb.SetHandle(handle);
+  if (handle <= HCI_HANDLE_MAX) {
+    l2cb.lcb_index_by_handle[handle] =
+        static_cast<uint8_t>(&p_lcb - &l2cb.lcb_pool[0] + 1);
+  }
 }
 
 /*******************************************************************************
@@ -1340,6 +1344,30 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
   }
 }
 
+/* Number of CCBs that must be free before one is reused rather than a new
+ * one allocated */
+#define L2CAP_CCB_REUSE_MIN_FREE 4
+
+/*******************************************************************************
+ *
+ * Function         l2cu_new_ccb
+ *
+ * Description      This function allocates the CCB of the pool slot |index|,
+ *                  which gives its local CID for as long as the stack runs.
+ *
+ * Returns          pointer to CCB, or NULL if the pool reached its limit
+ *
+ ******************************************************************************/
+static tL2C_CCB* l2cu_new_ccb(uint16_t index) {
+  if (l2cb.num_allocated_ccbs >= l2cb.max_ccbs) return nullptr;
+
+  tL2C_CCB* p_ccb = new tL2C_CCB{};
+  p_ccb->local_cid = L2CAP_BASE_APPL_CID + index;
+  l2cb.ccb_pool[index] = p_ccb;
+  l2cb.num_allocated_ccbs++;
+  return p_ccb;
+}
+
 /*******************************************************************************
  *
  * Function         l2cu_allocate_ccb
@@ -1353,19 +1381,44 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
  ******************************************************************************/
 tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
   LOG_DEBUG("is_dynamic = %d, cid 0x%04x", p_lcb != nullptr, cid);
-  if (!l2cb.p_free_ccb_first) {
-    LOG_ERROR("First free ccb is null for cid 0x%04x", cid);
-    return nullptr;
-  }
-  tL2C_CCB* p_ccb;
+  tL2C_CCB* p_ccb = nullptr;
   /* If a CID was passed in, use that, else take the first free one */
   if (cid == 0) {
-    p_ccb = l2cb.p_free_ccb_first;
-    l2cb.p_free_ccb_first = p_ccb->p_next_ccb;
+    /* Released CCBs are only reused once a few are free, so that the local
+     * CID of a channel is not given again right after it was closed */
+    if (l2cb.num_free_ccbs < L2CAP_CCB_REUSE_MIN_FREE) {
+      for (uint16_t xx = 0; xx < MAX_L2CAP_CHANNELS; xx++) {
+        if (l2cb.ccb_pool[xx] == nullptr) {
+          p_ccb = l2cu_new_ccb(xx);
+          break;
+        }
+      }
+    }
+    if (p_ccb == nullptr) {
+      if (!l2cb.p_free_ccb_first) {
+        LOG_ERROR("No free ccb for cid 0x%04x, %hu allocated", cid,
+                  l2cb.num_allocated_ccbs);
+        return nullptr;
+      }
+      p_ccb = l2cb.p_free_ccb_first;
+      l2cb.p_free_ccb_first = p_ccb->p_next_ccb;
+      l2cb.num_free_ccbs--;
+    }
+  } else if (cid < L2CAP_BASE_APPL_CID ||
+             cid >= L2CAP_BASE_APPL_CID + MAX_L2CAP_CHANNELS) {
+    LOG_ERROR("Invalid cid 0x%04x", cid);
+    return nullptr;
+  } else if (l2cb.ccb_pool[cid - L2CAP_BASE_APPL_CID] == nullptr) {
+    p_ccb = l2cu_new_ccb(cid - L2CAP_BASE_APPL_CID);
+    if (p_ccb == nullptr) {
+      LOG_ERROR("No free ccb for cid 0x%04x, %hu allocated", cid,
+                l2cb.num_allocated_ccbs);
+      return nullptr;
+    }
   } else {
     tL2C_CCB* p_prev = nullptr;
 
-    p_ccb = &l2cb.ccb_pool[cid - L2CAP_BASE_APPL_CID];
+    p_ccb = l2cb.ccb_pool[cid - L2CAP_BASE_APPL_CID];
 
     if (p_ccb == l2cb.p_free_ccb_first) {
       l2cb.p_free_ccb_first = p_ccb->p_next_ccb;
@@ -1387,15 +1440,13 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
         return nullptr;
       }
     }
+    l2cb.num_free_ccbs--;
   }
 
   p_ccb->p_next_ccb = p_ccb->p_prev_ccb = nullptr;
 
   p_ccb->in_use = true;
 
-  /* Get a CID for the connection */
-  p_ccb->local_cid = L2CAP_BASE_APPL_CID + (uint16_t)(p_ccb - l2cb.ccb_pool);
-
   p_ccb->p_lcb = p_lcb;
   p_ccb->p_rcb = nullptr;
 
@@ -1600,6 +1651,7 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
     l2cb.p_free_ccb_last->p_next_ccb = p_ccb;
     l2cb.p_free_ccb_last = p_ccb;
   }
+  l2cb.num_free_ccbs++;
 
   /* Flag as not in use */
   p_ccb->in_use = false;
@@ -3373,6 +3425,16 @@ void l2cu_send_peer_ble_credit_based_disconn_req(tL2C_CCB* p_ccb) {
  *
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle) {
+  if (handle <= HCI_HANDLE_MAX) {
+    uint8_t index = l2cb.lcb_index_by_handle[handle];
+    if (index == 0) return (NULL);
+    tL2C_LCB* p_lcb = &l2cb.lcb_pool[index - 1];
+    if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
+      return (p_lcb);
+    }
+    return (NULL);
+  }
+
   int xx;
   tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
 
@@ -3405,10 +3467,10 @@ tL2C_CCB* l2cu_find_ccb_by_cid(tL2C_LCB* p_lcb, uint16_t local_cid) {
 
     if (local_cid >= MAX_L2CAP_CHANNELS) return NULL;
 
-    p_ccb = l2cb.ccb_pool + local_cid;
+    p_ccb = l2cb.ccb_pool[local_cid];
 
     /* make sure the CCB is in use */
-    if (!p_ccb->in_use) {
+    if (p_ccb == nullptr || !p_ccb->in_use) {
       p_ccb = NULL;
     }
     /* make sure it's for the same LCB */
@@ -711,6 +711,44 @@ int PORT_FlowControl_MaxCredit(uint16_t handle, bool enable) {
   return (PORT_SUCCESS);
 }
 
+/*******************************************************************************
+ *
+ * Function         PORT_SetTxCoalescing
+ *
+ * Description      This function sets how long the small writes to a port
+ *                  wait for more data, so that they are sent together in
+ *                  frames of up to the peer MTU.  Writes are sent right away
+ *                  when the delay is 0, the default.
+ *
+ * Parameters:      handle     - Handle returned in the RFCOMM_CreateConnection
+ *                  delay_ms   - Delay of the small writes, in milliseconds
+ *
+ ******************************************************************************/
+int PORT_SetTxCoalescing(uint16_t handle, uint16_t delay_ms) {
+  RFCOMM_TRACE_API("PORT_SetTxCoalescing() handle:%d delay_ms:%d", handle,
+                   delay_ms);
+
+  /* Check if handle is valid to avoid crashing */
+  if ((handle == 0) || (handle > MAX_RFC_PORTS)) {
+    return (PORT_BAD_HANDLE);
+  }
+
+  tPORT* p_port = &rfc_cb.port.port[handle - 1];
+
+  if (!p_port->in_use || (p_port->state == PORT_CONNECTION_STATE_CLOSED)) {
+    return (PORT_NOT_OPENED);
+  }
+
+  p_port->tx_coalesce_ms = delay_ms;
+
+  /* Send what was waiting for more data */
+  if (delay_ms == 0 && alarm_is_scheduled(p_port->rfc.tx_coalesce_timer)) {
+    alarm_cancel(p_port->rfc.tx_coalesce_timer);
+    port_rfc_tx_coalesce_timeout(p_port);
+  }
+  return (PORT_SUCCESS);
+}
+
 /*******************************************************************************
  *
  * Function         PORT_ReadData
@@ -866,6 +904,27 @@ static int port_write(tPORT* p_port, BT_HDR* p_buf) {
     p_port->tx.queue_size += p_buf->len;
 
     return (PORT_CMD_PENDING);
+  } else if (p_port->tx_coalesce_ms != 0) {
+    /* Keep the data in the queue, so that the next small writes are */
+    /* appended to it, and send it once a frame is full or on timeout */
+    fixed_queue_enqueue(p_port->tx.queue, p_buf);
+    p_port->tx.queue_size += p_buf->len;
+
+    if ((p_buf->len < p_port->peer_mtu) &&
+        (fixed_queue_length(p_port->tx.queue) == 1)) {
+      if (!alarm_is_scheduled(p_port->rfc.tx_coalesce_timer)) {
+        alarm_set_on_mloop(p_port->rfc.tx_coalesce_timer,
+                           p_port->tx_coalesce_ms,
+                           port_rfc_tx_coalesce_timeout, p_port);
+      }
+      return (PORT_CMD_PENDING);
+    }
+
+    RFCOMM_TRACE_EVENT("PORT_Write : Coalesced data is being sent");
+
+    alarm_cancel(p_port->rfc.tx_coalesce_timer);
+    port_rfc_send_tx_data(p_port);
+    return (PORT_SUCCESS);
   } else {
     RFCOMM_TRACE_EVENT("PORT_Write : Data is being sent");
 
@@ -119,6 +119,7 @@ typedef struct {
   tRFC_MCB* p_mcb;
 
   alarm_t* port_timer;
+  alarm_t* tx_coalesce_timer; /* Sends the coalesced small writes */
 } tRFC_PORT;
 
 /*
@@ -185,12 +186,15 @@ typedef struct {
   uint16_t
       credit_rx_max; /* Max number of credits we will allow this guy to sent */
   uint16_t credit_rx_low;   /* Number of credits when we send credit update */
+  uint16_t credit_rx_base;  /* Credit window selected from the MTU */
+  uint16_t credit_rx_limit; /* Credit window reached when rx keeps up */
   uint16_t rx_buf_critical; /* port receive queue critical watermark level */
   bool keep_port_handle;    /* true if port is not deallocated when closing */
   /* it is set to true for server when allocating port */
   uint16_t keep_mtu; /* Max MTU that port can receive by server */
   uint16_t sec_mask; /* Bitmask of security requirements for this port */
                      /* see the BTM_SEC_* values in btm_api_types.h */
+  uint16_t tx_coalesce_ms; /* Delay of the small writes, 0 sends them now */
 } tPORT;
 
 /* Define the PORT/RFCOMM control structure
@@ -225,5 +229,7 @@ void port_start_par_neg(tPORT* p_port);
 void port_start_control(tPORT* p_port);
 void port_start_close(tPORT* p_port);
 void port_rfc_closed(tPORT* p_port, uint8_t res);
+uint32_t port_rfc_send_tx_data(tPORT* p_port);
+void port_rfc_tx_coalesce_timeout(void* data);
 
 #endif
@@ -971,6 +971,24 @@ uint32_t port_rfc_send_tx_data(tPORT* p_port) {
   return (events & p_port->ev_mask);
 }
 
+/*******************************************************************************
+ *
+ * Function         port_rfc_tx_coalesce_timeout
+ *
+ * Description      Called when the small writes coalesced in the tx queue
+ *                  waited long enough for more data, sends them
+ *
+ ******************************************************************************/
+void port_rfc_tx_coalesce_timeout(void* data) {
+  tPORT* p_port = (tPORT*)data;
+
+  if (!p_port->in_use || (p_port->rfc.state != RFC_STATE_OPENED)) return;
+
+  uint32_t events = port_rfc_send_tx_data(p_port);
+  if (p_port->p_callback && events)
+    (p_port->p_callback)(events, p_port->handle);
+}
+
 /*******************************************************************************
  *
  * Function         port_rfc_closed
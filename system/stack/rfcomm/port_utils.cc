@@ -78,6 +78,8 @@ tPORT* port_allocate_port(uint8_t dlci, const RawAddress& bd_addr) {
       // During the open set default state for the port connection
       port_set_defaults(p_port);
       p_port->rfc.port_timer = alarm_new("rfcomm_port.port_timer");
+      p_port->rfc.tx_coalesce_timer =
+          alarm_new("rfcomm_port.tx_coalesce_timer");
       p_port->dlci = dlci;
       p_port->bd_addr = bd_addr;
       rfc_cb.rfc.last_port_index = port_index;
@@ -116,6 +118,7 @@ void port_set_defaults(tPORT* p_port) {
 
   p_port->credit_tx = 0;
   p_port->credit_rx = 0;
+  p_port->tx_coalesce_ms = 0;
 
   memset(&p_port->local_ctrl, 0, sizeof(p_port->local_ctrl));
   memset(&p_port->peer_ctrl, 0, sizeof(p_port->peer_ctrl));
@@ -187,6 +190,12 @@ void port_select_mtu(tPORT* p_port) {
   p_port->rx_buf_critical = (PORT_RX_CRITICAL_WM / p_port->mtu);
   if (p_port->rx_buf_critical > PORT_RX_BUF_CRITICAL_WM)
     p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
+  /* The credit window grows up to the critical level while the receiver */
+  /* keeps up, so that the peer never holds more than we can queue */
+  p_port->credit_rx_base = p_port->credit_rx_max;
+  p_port->credit_rx_limit = p_port->rx_buf_critical;
+  if (p_port->credit_rx_limit < p_port->credit_rx_base)
+    p_port->credit_rx_limit = p_port->credit_rx_base;
   RFCOMM_TRACE_DEBUG(
       "%s: credit_rx_max %d, credit_rx_low %d, rx_buf_critical %d", __func__,
       p_port->credit_rx_max, p_port->credit_rx_low, p_port->rx_buf_critical);
@@ -221,6 +230,7 @@ void port_release_port(tPORT* p_port) {
   mutex_global_unlock();
 
   alarm_cancel(p_port->rfc.port_timer);
+  alarm_cancel(p_port->rfc.tx_coalesce_timer);
 
   p_port->state = PORT_CONNECTION_STATE_CLOSED;
 
@@ -249,6 +259,7 @@ void port_release_port(tPORT* p_port) {
       uint32_t mask = p_port->ev_mask;
       tPORT_CALLBACK* p_port_cb = p_port->p_callback;
       tPORT_STATE user_port_pars = p_port->user_port_pars;
+      uint16_t tx_coalesce_ms = p_port->tx_coalesce_ms;
 
       port_set_defaults(p_port);
 
@@ -256,6 +267,7 @@ void port_release_port(tPORT* p_port) {
       p_port->ev_mask = mask;
       p_port->p_callback = p_port_cb;
       p_port->user_port_pars = user_port_pars;
+      p_port->tx_coalesce_ms = tx_coalesce_ms;
       p_port->mtu = p_port->keep_mtu;
 
       p_port->state = PORT_CONNECTION_STATE_OPENING;
@@ -267,6 +279,7 @@ void port_release_port(tPORT* p_port) {
     } else {
       RFCOMM_TRACE_DEBUG("%s Clean-up handle: %d", __func__, p_port->handle);
       alarm_free(p_port->rfc.port_timer);
+      alarm_free(p_port->rfc.tx_coalesce_timer);
       memset(p_port, 0, sizeof(tPORT));
     }
   }
@@ -470,6 +483,13 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* There might be a special case when we just adjusted rx_max */
       if ((p_port->credit_rx <= p_port->credit_rx_low) && !p_port->rx.user_fc &&
           (p_port->credit_rx_max > p_port->credit_rx)) {
+        /* The receive queue stays below its low watermark, grant one more */
+        /* credit with each update */
+        if ((fixed_queue_length(p_port->rx.queue) < p_port->credit_rx_low) &&
+            (p_port->credit_rx_max < p_port->credit_rx_limit)) {
+          p_port->credit_rx_max++;
+        }
+
         rfc_send_credit(p_port->rfc.p_mcb, p_port->dlci,
                         (uint8_t)(p_port->credit_rx_max - p_port->credit_rx));
 
@@ -488,6 +508,11 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       else if (fixed_queue_length(p_port->rx.queue) >= p_port->credit_rx_max) {
         p_port->rx.peer_fc = true;
       }
+
+      /* The receiver falls behind, shrink the credit window granted next */
+      if (p_port->rx.peer_fc) {
+        p_port->credit_rx_max = p_port->credit_rx_base;
+      }
     }
   }
   /* else using TS 07.10 flow control */
@@ -169,12 +169,17 @@ bool SDP_ServiceSearchAttributeRequest(const RawAddress& p_bd_addr,
                                        tSDP_DISC_CMPL_CB* p_cb) {
   tCONN_CB* p_ccb;
 
-  /* Specific BD address */
-  p_ccb = sdp_conn_originate(p_bd_addr);
+  /* Answered from the cache if the same search was done recently */
+  p_ccb = sdp_disc_originate_from_cache(p_bd_addr, p_db);
 
-  if (!p_ccb) return (false);
+  if (!p_ccb) {
+    /* Specific BD address */
+    p_ccb = sdp_conn_originate(p_bd_addr);
 
-  p_ccb->disc_state = SDP_DISC_WAIT_CONN;
+    if (!p_ccb) return (false);
+
+    p_ccb->disc_state = SDP_DISC_WAIT_CONN;
+  }
   p_ccb->p_db = p_db;
   p_ccb->p_cb = p_cb;
 
@@ -202,12 +207,17 @@ bool SDP_ServiceSearchAttributeRequest2(const RawAddress& p_bd_addr,
                                         const void* user_data) {
   tCONN_CB* p_ccb;
 
-  /* Specific BD address */
-  p_ccb = sdp_conn_originate(p_bd_addr);
+  /* Answered from the cache if the same search was done recently */
+  p_ccb = sdp_disc_originate_from_cache(p_bd_addr, p_db);
 
-  if (!p_ccb) return (false);
+  if (!p_ccb) {
+    /* Specific BD address */
+    p_ccb = sdp_conn_originate(p_bd_addr);
 
-  p_ccb->disc_state = SDP_DISC_WAIT_CONN;
+    if (!p_ccb) return (false);
+
+    p_ccb->disc_state = SDP_DISC_WAIT_CONN;
+  }
   p_ccb->p_db = p_db;
   p_ccb->p_cb2 = p_cb2;
 
@@ -41,6 +41,7 @@
 static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
                              const uint8_t* p_his_uuid, uint16_t his_len,
                              int nest_level);
+static void sdp_db_record_changed(const tSDP_RECORD* p_rec);
 
 /*******************************************************************************
  *
@@ -136,6 +137,24 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
   return (false);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_db_record_changed
+ *
+ * Description      This function is called when a record is changed, so that
+ *                  the responses cached for the database get rebuilt. Changes
+ *                  to records outside of the database are ignored.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_record_changed(const tSDP_RECORD* p_rec) {
+  tSDP_DB* p_db = &sdp_cb.server_db;
+
+  if (p_rec >= &p_db->record[0] && p_rec < &p_db->record[SDP_MAX_RECORDS])
+    p_db->generation++;
+}
+
 /*******************************************************************************
  *
  * Function         sdp_db_find_record
@@ -269,6 +288,7 @@ uint32_t SDP_CreateRecord(void) {
     p_db->record[p_db->num_records].record_handle = handle;
 
     p_db->num_records++;
+    p_db->generation++;
     SDP_TRACE_DEBUG("SDP_CreateRecord ok, num_records:%d", p_db->num_records);
     /* Add the first attribute (the handle) automatically */
     UINT32_TO_BE_FIELD(buf, handle);
@@ -302,6 +322,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
     /* Delete all records in the database */
     sdp_cb.server_db.num_records = 0;
+    sdp_cb.server_db.generation++;
 
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
@@ -321,6 +342,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
         }
 
         sdp_cb.server_db.num_records--;
+        sdp_cb.server_db.generation++;
 
         SDP_TRACE_DEBUG("SDP_DeleteRecord ok, num_records:%d",
                         sdp_cb.server_db.num_records);
@@ -444,6 +466,8 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id,
   uint16_t xx, yy;
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
+  sdp_db_record_changed(p_rec);
+
   /* Found the record. Now, see if the attribute already exists */
   for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
     /* The attribute exists. replace it */
@@ -888,6 +912,8 @@ bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
   for (uint16_t attribute_index = 0; attribute_index < p_rec->num_attributes;
        attribute_index++, p_attr++) {
     if (p_attr->id == attr_id) {
+      sdp_db_record_changed(p_rec);
+
       pad_ptr = p_attr->value_ptr;
       len = p_attr->len;
 
@@ -24,9 +24,11 @@
 
 #define LOG_TAG "sdp_discovery"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "bt_target.h"
+#include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
@@ -48,6 +50,11 @@ static void process_service_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                      uint8_t* p_reply_end);
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end);
+static void process_service_search_attr_lists(tCONN_CB* p_ccb,
+                                              bool is_cached);
+static bool sdp_disc_cache_load(tCONN_CB* p_ccb);
+static void sdp_disc_cache_store(const tCONN_CB* p_ccb);
+static void sdp_disc_cache_timeout(void* data);
 static uint8_t* save_attr_seq(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_msg_end);
 static tSDP_DISC_REC* add_record(tSDP_DISCOVERY_DB* p_db,
                                  const RawAddress& p_bda);
@@ -58,6 +65,25 @@ static uint8_t* add_attr(uint8_t* p, uint8_t* p_end, tSDP_DISCOVERY_DB* p_db,
 /* Safety check in case we go crazy */
 #define MAX_NEST_LEVELS 5
 
+/* The service search attribute responses are kept per peer for a while, so
+ * that the profiles discovering the same services on connection, and the
+ * requests queued behind each other, do not query the peer again. */
+#define SDP_DISC_CACHE_SIZE 8
+#define SDP_DISC_CACHE_TTL_MS (30 * 1000)
+
+typedef struct {
+  RawAddress bd_addr;
+  uint64_t timestamp_ms;
+  uint16_t num_uuid_filters;
+  Uuid uuid_filters[SDP_MAX_UUID_FILTERS];
+  uint16_t num_attr_filters;
+  uint16_t attr_filters[SDP_MAX_ATTR_FILTERS];
+  uint8_t* p_list; /* Complete attribute lists, NULL if unused */
+  uint16_t list_len;
+} tSDP_DISC_CACHE_ENTRY;
+
+static tSDP_DISC_CACHE_ENTRY sdp_disc_cache[SDP_DISC_CACHE_SIZE];
+
 /*******************************************************************************
  *
  * Function         sdpu_build_uuid_seq
@@ -212,6 +238,13 @@ void sdp_disc_connected(tCONN_CB* p_ccb) {
   if (p_ccb->is_attr_search) {
     p_ccb->disc_state = SDP_DISC_WAIT_SEARCH_ATTR;
 
+    /* The request queued before may have answered this one already */
+    if (sdp_disc_cache_load(p_ccb)) {
+      alarm_set_on_mloop(p_ccb->sdp_conn_timer, 0, sdp_disc_cache_timeout,
+                         p_ccb);
+      return;
+    }
+
     process_service_search_attr_rsp(p_ccb, NULL, NULL);
   } else {
     /* First step is to get a list of the handles from the server. */
@@ -544,9 +577,7 @@ static void process_service_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
  ******************************************************************************/
 static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
                                             uint8_t* p_reply_end) {
-  uint8_t *p, *p_start, *p_end, *p_param_len;
-  uint8_t type;
-  uint32_t seq_len;
+  uint8_t *p_start, *p_param_len;
   uint16_t param_len, lists_byte_count = 0;
   bool cont_request_needed = false;
 
@@ -666,6 +697,26 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
 /* We now have the full response, which is a sequence of sequences */
 /*******************************************************************/
 
+  process_service_search_attr_lists(p_ccb, false);
+}
+
+/*******************************************************************************
+ *
+ * Function         process_service_search_attr_lists
+ *
+ * Description      This function is called when the complete attribute lists
+ *                  of a search attribute response are in the response list,
+ *                  received from the server or loaded from the cache.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void process_service_search_attr_lists(tCONN_CB* p_ccb,
+                                              bool is_cached) {
+  uint8_t *p, *p_end;
+  uint8_t type;
+  uint32_t seq_len;
+
   if (!sdp_copy_raw_data(p_ccb, true)) {
     LOG_ERROR("sdp_copy_raw_data failed");
     sdp_disconnect(p_ccb, SDP_ILLEGAL_PARAMETER);
@@ -703,11 +754,176 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
     }
   }
 
+  if (!is_cached) sdp_disc_cache_store(p_ccb);
+
   /* Since we got everything we need, disconnect the call */
   sdpu_log_attribute_metrics(p_ccb->device_address, p_ccb->p_db);
   sdp_disconnect(p_ccb, SDP_SUCCESS);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_find
+ *
+ * Description      This function looks for the attribute lists received
+ *                  recently from a peer, for the filters of a discovery
+ *                  database.
+ *
+ * Returns          the cache entry, or NULL if not found
+ *
+ ******************************************************************************/
+static tSDP_DISC_CACHE_ENTRY* sdp_disc_cache_find(
+    const RawAddress& bd_addr, const tSDP_DISCOVERY_DB* p_db) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  for (uint8_t xx = 0; xx < SDP_DISC_CACHE_SIZE; xx++) {
+    tSDP_DISC_CACHE_ENTRY* p_entry = &sdp_disc_cache[xx];
+    if (p_entry->p_list == NULL || p_entry->bd_addr != bd_addr ||
+        p_entry->num_uuid_filters != p_db->num_uuid_filters ||
+        p_entry->num_attr_filters != p_db->num_attr_filters)
+      continue;
+
+    if (now_ms - p_entry->timestamp_ms > SDP_DISC_CACHE_TTL_MS) {
+      osi_free_and_reset((void**)&p_entry->p_list);
+      continue;
+    }
+
+    if (std::equal(p_db->uuid_filters,
+                   p_db->uuid_filters + p_db->num_uuid_filters,
+                   p_entry->uuid_filters) &&
+        std::equal(p_db->attr_filters,
+                   p_db->attr_filters + p_db->num_attr_filters,
+                   p_entry->attr_filters))
+      return p_entry;
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_store
+ *
+ * Description      This function adds the complete attribute lists received
+ *                  from a peer to the cache, replacing the oldest entry.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_disc_cache_store(const tCONN_CB* p_ccb) {
+  const tSDP_DISCOVERY_DB* p_db = p_ccb->p_db;
+  tSDP_DISC_CACHE_ENTRY* p_entry =
+      sdp_disc_cache_find(p_ccb->device_address, p_db);
+
+  if (p_entry == NULL) {
+    p_entry = &sdp_disc_cache[0];
+    for (uint8_t xx = 1; xx < SDP_DISC_CACHE_SIZE && p_entry->p_list; xx++) {
+      if (sdp_disc_cache[xx].p_list == NULL ||
+          sdp_disc_cache[xx].timestamp_ms < p_entry->timestamp_ms)
+        p_entry = &sdp_disc_cache[xx];
+    }
+  }
+
+  osi_free(p_entry->p_list);
+  p_entry->p_list = (uint8_t*)osi_malloc(p_ccb->list_len);
+  memcpy(p_entry->p_list, p_ccb->rsp_list, p_ccb->list_len);
+  p_entry->list_len = p_ccb->list_len;
+  p_entry->bd_addr = p_ccb->device_address;
+  p_entry->timestamp_ms = bluetooth::common::time_get_os_boottime_ms();
+  p_entry->num_uuid_filters = p_db->num_uuid_filters;
+  std::copy(p_db->uuid_filters, p_db->uuid_filters + p_db->num_uuid_filters,
+            p_entry->uuid_filters);
+  p_entry->num_attr_filters = p_db->num_attr_filters;
+  std::copy(p_db->attr_filters, p_db->attr_filters + p_db->num_attr_filters,
+            p_entry->attr_filters);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_load
+ *
+ * Description      This function copies the attribute lists received
+ *                  recently from the peer of a connection, for the filters of
+ *                  its discovery database, into its response list.
+ *
+ * Returns          true if found
+ *
+ ******************************************************************************/
+static bool sdp_disc_cache_load(tCONN_CB* p_ccb) {
+  const tSDP_DISC_CACHE_ENTRY* p_entry =
+      sdp_disc_cache_find(p_ccb->device_address, p_ccb->p_db);
+  if (p_entry == NULL) return false;
+
+  SDP_TRACE_EVENT("%s: %d bytes from the cache for peer %s", __func__,
+                  p_entry->list_len,
+                  ADDRESS_TO_LOGGABLE_CSTR(p_ccb->device_address));
+  osi_free(p_ccb->rsp_list);
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(p_entry->list_len);
+  memcpy(p_ccb->rsp_list, p_entry->p_list, p_entry->list_len);
+  p_ccb->list_len = p_entry->list_len;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_timeout
+ *
+ * Description      This function completes a discovery from the attribute
+ *                  lists loaded from the cache, once the caller returned.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_disc_cache_timeout(void* data) {
+  tCONN_CB* p_ccb = (tCONN_CB*)data;
+
+  process_service_search_attr_lists(p_ccb, true);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_originate_from_cache
+ *
+ * Description      This function starts a service search attribute discovery
+ *                  answered from the attribute lists received recently from
+ *                  the peer, without connecting to it.
+ *
+ * Returns          the CCB of the discovery, or NULL if not in the cache
+ *
+ ******************************************************************************/
+tCONN_CB* sdp_disc_originate_from_cache(const RawAddress& p_bd_addr,
+                                        tSDP_DISCOVERY_DB* p_db) {
+  if (sdp_disc_cache_find(p_bd_addr, p_db) == NULL) return NULL;
+
+  tCONN_CB* p_ccb = sdpu_allocate_ccb();
+  if (p_ccb == NULL) return NULL;
+
+  /* There is no connection, sdp_disconnect() completes the discovery */
+  p_ccb->con_flags |= SDP_FLAGS_IS_ORIG;
+  p_ccb->device_address = p_bd_addr;
+  p_ccb->con_state = SDP_STATE_CONN_SETUP;
+  p_ccb->p_db = p_db;
+  p_ccb->disc_state = SDP_DISC_WAIT_SEARCH_ATTR;
+  sdp_disc_cache_load(p_ccb);
+
+  alarm_set_on_mloop(p_ccb->sdp_conn_timer, 0, sdp_disc_cache_timeout, p_ccb);
+  return p_ccb;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_clear_cache
+ *
+ * Description      This function drops all the cached attribute lists.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_disc_clear_cache(void) {
+  for (uint8_t xx = 0; xx < SDP_DISC_CACHE_SIZE; xx++) {
+    osi_free_and_reset((void**)&sdp_disc_cache[xx].p_list);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         save_attr_seq
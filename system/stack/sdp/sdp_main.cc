@@ -68,6 +68,8 @@ static void sdp_on_l2cap_error(uint16_t l2cap_cid, uint16_t result);
 void sdp_init(void) {
   /* Clears all structures and local SDP database (if Server is enabled) */
   memset(&sdp_cb, 0, sizeof(tSDP_CB));
+  sdp_server_clear_rsp_cache();
+  sdp_disc_clear_cache();
 
   for (int i = 0; i < SDP_MAX_CONNECTIONS; i++) {
     sdp_cb.ccb[i].sdp_conn_timer = alarm_new("sdp.sdp_conn_timer");
@@ -103,6 +105,8 @@ void sdp_free(void) {
     alarm_free(sdp_cb.ccb[i].sdp_conn_timer);
     sdp_cb.ccb[i].sdp_conn_timer = NULL;
   }
+  sdp_server_clear_rsp_cache();
+  sdp_disc_clear_cache();
 }
 
 /*******************************************************************************
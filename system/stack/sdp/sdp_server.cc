@@ -81,6 +81,22 @@ typedef struct {
 
 static tSDP_PSE_LOCAL_RECORD sdpPseLocalRecord;
 
+/* Number of ServiceSearchAttribute responses kept in the response cache */
+#define SDP_RSP_CACHE_SIZE 8
+
+/* Attribute lists of a ServiceSearchAttribute response, cached for its UUID
+ * and attribute sequences */
+typedef struct {
+  uint8_t* p_list;        /* Attribute lists, with the sequence header */
+  uint16_t list_len;      /* Length of the attribute lists */
+  uint32_t db_generation; /* Generation of the server database p_list is for */
+  tSDP_UUID_SEQ uid_seq;
+  tSDP_ATTR_SEQ attr_seq;
+} tSDP_RSP_CACHE_ENTRY;
+
+static tSDP_RSP_CACHE_ENTRY sdp_rsp_cache[SDP_RSP_CACHE_SIZE];
+static uint8_t sdp_rsp_cache_next;
+
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
@@ -95,6 +111,18 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
 static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                                             uint16_t param_len, uint8_t* p_req,
                                             uint8_t* p_req_end);
+
+static bool sdp_rsp_cache_load(tCONN_CB* p_ccb, tSDP_UUID_SEQ* p_uid_seq,
+                               tSDP_ATTR_SEQ* p_attr_seq);
+
+static void sdp_send_cached_attr_lists(tCONN_CB* p_ccb, uint16_t trans_num,
+                                       uint16_t max_list_len, bool is_cont);
+
+static void sdp_send_service_search_attr_rsp(tCONN_CB* p_ccb,
+                                             uint16_t trans_num,
+                                             const uint8_t* p_list,
+                                             uint16_t len_to_send);
+
 bool sdp_dynamic_change_hfp_version(const tSDP_ATTRIBUTE* p_attr,
                                     const RawAddress& remote_address);
 void hfp_fallback(bool& is_hfp_fallback, const tSDP_ATTRIBUTE* p_attr);
@@ -695,8 +723,8 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   int16_t rem_len;
   uint16_t len_to_send, cont_offset;
   tSDP_UUID_SEQ uid_seq;
-  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
-  uint16_t rsp_param_len, xx;
+  uint8_t* p_rsp;
+  uint16_t xx;
   const tSDP_RECORD* p_rec;
   tSDP_RECORD* p_prev_rec;
   tSDP_ATTR_SEQ attr_seq, attr_seq_sav;
@@ -739,10 +767,6 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     return;
   }
 
-  /* Free and reallocate buffer */
-  osi_free(p_ccb->rsp_list);
-  p_ccb->rsp_list = (uint8_t*)osi_malloc(max_list_len);
-
   /* Check if this is a continuation request */
   if (p_req + 1 > p_req_end) {
     sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
@@ -764,7 +788,22 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
       return;
     }
     is_cont = true;
+  } else {
+    p_ccb->cont_info.is_cached_rsp =
+        sdp_rsp_cache_load(p_ccb, &uid_seq, &attr_seq_sav);
+  }
+
+  /* Responses built only from static records are sent from the cache */
+  if (p_ccb->cont_info.is_cached_rsp) {
+    sdp_send_cached_attr_lists(p_ccb, trans_num, max_list_len, is_cont);
+    return;
+  }
 
+  /* Free and reallocate buffer */
+  osi_free(p_ccb->rsp_list);
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(max_list_len);
+
+  if (is_cont) {
     /* Initialise for continuation response */
     p_rsp = &p_ccb->rsp_list[0];
     attr_seq.attr_entry[p_ccb->cont_info.next_attr_index].start =
@@ -1007,6 +1046,277 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     }
   }
 
+  sdp_send_service_search_attr_rsp(p_ccb, trans_num,
+                                   &p_ccb->rsp_list[cont_offset], len_to_send);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_uid_seq_equal
+ *
+ * Description      This function compares two UUID sequences.
+ *
+ * Returns          true if they hold the same UUIDs, in the same order
+ *
+ ******************************************************************************/
+static bool sdp_uid_seq_equal(const tSDP_UUID_SEQ* p_seq1,
+                              const tSDP_UUID_SEQ* p_seq2) {
+  if (p_seq1->num_uids != p_seq2->num_uids) return false;
+
+  for (uint16_t xx = 0; xx < p_seq1->num_uids; xx++) {
+    const tUID_ENT* p_uid1 = &p_seq1->uuid_entry[xx];
+    const tUID_ENT* p_uid2 = &p_seq2->uuid_entry[xx];
+    if ((p_uid1->len != p_uid2->len) ||
+        memcmp(p_uid1->value, p_uid2->value, p_uid1->len))
+      return false;
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_attr_seq_equal
+ *
+ * Description      This function compares two attribute sequences.
+ *
+ * Returns          true if they hold the same attribute ranges, in the same
+ *                  order
+ *
+ ******************************************************************************/
+static bool sdp_attr_seq_equal(const tSDP_ATTR_SEQ* p_seq1,
+                               const tSDP_ATTR_SEQ* p_seq2) {
+  return (p_seq1->num_attr == p_seq2->num_attr) &&
+         !memcmp(p_seq1->attr_entry, p_seq2->attr_entry,
+                 p_seq1->num_attr * sizeof(tATT_ENT));
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_is_record_rsp_static
+ *
+ * Description      This function checks if the attributes of a record are
+ *                  sent the same to all peers. AVRCP target, PBAP PSE and
+ *                  HFP AG records are adapted to each peer.
+ *
+ * Returns          true if the attributes can be served from the cache
+ *
+ ******************************************************************************/
+static bool sdp_is_record_rsp_static(const tSDP_RECORD* p_rec) {
+  const tSDP_ATTRIBUTE* p_attr = sdp_db_find_attr_in_rec(
+      p_rec, ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_SERVICE_CLASS_ID_LIST);
+  if (p_attr && sdpu_is_service_id_avrc_target(p_attr)) return false;
+
+  if (bluetooth::common::init_flags::
+          pbap_pse_dynamic_version_upgrade_is_enabled() &&
+      (p_rec->num_attributes > 1)) {
+    const tSDP_ATTRIBUTE& attr = p_rec->attribute[1];
+    if ((attr.id == ATTR_ID_SERVICE_CLASS_ID_LIST) &&
+        (((attr.value_ptr[1] << 8) | (attr.value_ptr[2])) ==
+         UUID_SERVCLASS_PBAP_PSE))
+      return false;
+  }
+
+  if (bluetooth::common::init_flags::hfp_dynamic_version_is_enabled()) {
+    p_attr = sdp_db_find_attr_in_rec(p_rec, ATTR_ID_BT_PROFILE_DESC_LIST,
+                                     ATTR_ID_BT_PROFILE_DESC_LIST);
+    if (p_attr && (p_attr->len >= SDP_PROFILE_DESC_LENGTH) &&
+        (((p_attr->value_ptr[3] << 8) | (p_attr->value_ptr[4])) ==
+         UUID_SERVCLASS_HF_HANDSFREE))
+      return false;
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_build
+ *
+ * Description      This function builds the complete attribute lists
+ *                  returned for a UUID and attribute sequence, and adds them
+ *                  to the response cache, replacing the oldest entry.
+ *
+ * Returns          the cache entry, or NULL if the response has to be built
+ *                  for each peer
+ *
+ ******************************************************************************/
+static tSDP_RSP_CACHE_ENTRY* sdp_rsp_cache_build(tSDP_UUID_SEQ* p_uid_seq,
+                                                 tSDP_ATTR_SEQ* p_attr_seq) {
+  const tSDP_RECORD* p_rec;
+
+  for (p_rec = sdp_db_service_search(NULL, p_uid_seq); p_rec;
+       p_rec = sdp_db_service_search(p_rec, p_uid_seq)) {
+    if (!sdp_is_record_rsp_static(p_rec)) return NULL;
+  }
+
+  /* Total length, with a 3 byte sequence header */
+  uint32_t list_len = sdpu_get_list_len(p_uid_seq, p_attr_seq) + 3;
+  if (list_len > SDP_MAX_LIST_BYTE_COUNT) return NULL;
+
+  uint8_t* p_list = (uint8_t*)osi_malloc(list_len);
+  uint8_t* p = p_list;
+
+  /* Put in the sequence header (2 or 3 bytes) */
+  if (list_len > 255) {
+    UINT8_TO_BE_STREAM(p, (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
+    UINT16_TO_BE_STREAM(p, list_len - 3);
+  } else {
+    UINT8_TO_BE_STREAM(p, (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE);
+    UINT8_TO_BE_STREAM(p, list_len - 3);
+    list_len--;
+  }
+
+  for (p_rec = sdp_db_service_search(NULL, p_uid_seq); p_rec;
+       p_rec = sdp_db_service_search(p_rec, p_uid_seq)) {
+    uint16_t seq_len = sdpu_get_attrib_seq_len(p_rec, p_attr_seq);
+    if (seq_len == 0) continue;
+
+    UINT8_TO_BE_STREAM(p, (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
+    UINT16_TO_BE_STREAM(p, seq_len);
+
+    /* Same walk as sdpu_get_attrib_seq_len() */
+    bool is_range = false;
+    uint16_t start_id = 0, end_id = 0;
+    for (uint16_t xx = 0; xx < p_attr_seq->num_attr; xx++) {
+      if (!is_range) {
+        start_id = p_attr_seq->attr_entry[xx].start;
+        end_id = p_attr_seq->attr_entry[xx].end;
+      }
+      const tSDP_ATTRIBUTE* p_attr =
+          sdp_db_find_attr_in_rec(p_rec, start_id, end_id);
+      is_range = false;
+      if (p_attr) {
+        p = sdpu_build_attrib_entry(p, p_attr);
+
+        /* If doing a range, stick with this one till no more attributes
+         * found */
+        if (start_id != end_id) {
+          start_id = p_attr->id + 1;
+          xx--;
+          is_range = true;
+        }
+      }
+    }
+  }
+
+  if (p != p_list + list_len) {
+    SDP_TRACE_ERROR("%s: built %d bytes instead of %d", __func__,
+                    (int)(p - p_list), (int)list_len);
+    osi_free(p_list);
+    return NULL;
+  }
+
+  tSDP_RSP_CACHE_ENTRY* p_entry = &sdp_rsp_cache[sdp_rsp_cache_next];
+  sdp_rsp_cache_next = (sdp_rsp_cache_next + 1) % SDP_RSP_CACHE_SIZE;
+
+  osi_free(p_entry->p_list);
+  p_entry->p_list = p_list;
+  p_entry->list_len = (uint16_t)list_len;
+  p_entry->db_generation = sdp_cb.server_db.generation;
+  memcpy(&p_entry->uid_seq, p_uid_seq, sizeof(tSDP_UUID_SEQ));
+  memcpy(&p_entry->attr_seq, p_attr_seq, sizeof(tSDP_ATTR_SEQ));
+  return p_entry;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_load
+ *
+ * Description      This function copies the cached attribute lists for a
+ *                  UUID and attribute sequence into the response list of the
+ *                  connection, building them if needed.  The cache entries
+ *                  are dropped when a record or an attribute changes.
+ *
+ * Returns          true if the response list of the connection holds the
+ *                  complete attribute lists
+ *
+ ******************************************************************************/
+static bool sdp_rsp_cache_load(tCONN_CB* p_ccb, tSDP_UUID_SEQ* p_uid_seq,
+                               tSDP_ATTR_SEQ* p_attr_seq) {
+  tSDP_RSP_CACHE_ENTRY* p_entry = NULL;
+
+  for (uint8_t xx = 0; xx < SDP_RSP_CACHE_SIZE; xx++) {
+    tSDP_RSP_CACHE_ENTRY* p_cached = &sdp_rsp_cache[xx];
+    if (p_cached->p_list &&
+        (p_cached->db_generation == sdp_cb.server_db.generation) &&
+        sdp_uid_seq_equal(&p_cached->uid_seq, p_uid_seq) &&
+        sdp_attr_seq_equal(&p_cached->attr_seq, p_attr_seq)) {
+      p_entry = p_cached;
+      break;
+    }
+  }
+
+  if (p_entry == NULL) p_entry = sdp_rsp_cache_build(p_uid_seq, p_attr_seq);
+  if (p_entry == NULL) return false;
+
+  osi_free(p_ccb->rsp_list);
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(p_entry->list_len);
+  memcpy(p_ccb->rsp_list, p_entry->p_list, p_entry->list_len);
+  p_ccb->list_len = p_entry->list_len;
+  p_ccb->pse_dynamic_attributes_len = 0;
+  p_ccb->cont_offset = 0;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_server_clear_rsp_cache
+ *
+ * Description      This function drops all the cached responses.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_server_clear_rsp_cache(void) {
+  for (uint8_t xx = 0; xx < SDP_RSP_CACHE_SIZE; xx++) {
+    osi_free_and_reset((void**)&sdp_rsp_cache[xx].p_list);
+  }
+  sdp_rsp_cache_next = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_send_cached_attr_lists
+ *
+ * Description      This function sends the next part of the attribute lists
+ *                  loaded from the response cache.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_send_cached_attr_lists(tCONN_CB* p_ccb, uint16_t trans_num,
+                                       uint16_t max_list_len, bool is_cont) {
+  uint16_t len_to_send = p_ccb->list_len - p_ccb->cont_offset;
+  if (len_to_send > max_list_len) len_to_send = max_list_len;
+
+  /* No forward progress, see process_service_search_attr_req() */
+  if (is_cont && len_to_send == 0) {
+    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE, NULL);
+    return;
+  }
+
+  sdp_send_service_search_attr_rsp(p_ccb, trans_num,
+                                   &p_ccb->rsp_list[p_ccb->cont_offset],
+                                   len_to_send);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_send_service_search_attr_rsp
+ *
+ * Description      This function sends a service search attribute response
+ *                  with the next |len_to_send| bytes of the attribute lists,
+ *                  and a continuation state if more remain.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_send_service_search_attr_rsp(tCONN_CB* p_ccb,
+                                             uint16_t trans_num,
+                                             const uint8_t* p_list,
+                                             uint16_t len_to_send) {
+  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
+  uint16_t rsp_param_len;
+
   /* Get a buffer to use to build the response */
   BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
   p_buf->offset = L2CAP_MIN_OFFSET;
@@ -1024,7 +1334,7 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   UINT16_TO_BE_STREAM(p_rsp, len_to_send);
 
   /* copy from rsp_list to the actual buffer to be sent */
-  memcpy(p_rsp, &p_ccb->rsp_list[cont_offset], len_to_send);
+  memcpy(p_rsp, p_list, len_to_send);
   p_rsp += len_to_send;
 
   p_ccb->cont_offset += len_to_send;
@@ -1037,7 +1347,6 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   /* If anything left to send, continuation needed */
   if (p_ccb->cont_offset <
       (p_ccb->list_len + p_ccb->pse_dynamic_attributes_len)) {
-    is_cont = true;
     UINT8_TO_BE_STREAM(p_rsp, SDP_CONTINUATION_LEN);
     UINT16_TO_BE_STREAM(p_rsp, p_ccb->cont_offset);
   } else {
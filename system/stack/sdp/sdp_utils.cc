@@ -457,7 +457,8 @@ uint16_t sdpu_get_active_ccb_cid(const RawAddress& remote_bd_addr) {
     if ((p_ccb->con_state == SDP_STATE_CONN_SETUP) ||
         (p_ccb->con_state == SDP_STATE_CFG_SETUP) ||
         (p_ccb->con_state == SDP_STATE_CONNECTED)) {
-      if (p_ccb->con_flags & SDP_FLAGS_IS_ORIG &&
+      // Discoveries answered from the cache have no channel
+      if (p_ccb->con_flags & SDP_FLAGS_IS_ORIG && p_ccb->connection_id != 0 &&
           p_ccb->device_address == remote_bd_addr) {
         return p_ccb->connection_id;
       }
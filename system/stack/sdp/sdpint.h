@@ -108,6 +108,7 @@ typedef struct {
   uint32_t
       di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
   uint16_t num_records;
+  uint32_t generation; /* Changes whenever a record or attribute changes */
   tSDP_RECORD record[SDP_MAX_RECORDS];
 } tSDP_DB;
 
@@ -122,6 +123,8 @@ typedef struct {
                                    previously */
   uint16_t attr_offset; /* offset within the attr to keep trak of partial
                            attributes in the responses */
+  bool is_cached_rsp; /* whether rsp_list holds the complete attribute lists
+                         from the response cache */
 } tSDP_CONT_INFO;
 
 enum : uint8_t {
@@ -329,11 +332,15 @@ const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec,
 /* Functions provided by sdp_server.cc
  */
 void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
+void sdp_server_clear_rsp_cache(void);
 
 /* Functions provided by sdp_discovery.cc
  */
 void sdp_disc_connected(tCONN_CB* p_ccb);
 void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+tCONN_CB* sdp_disc_originate_from_cache(const RawAddress& p_bd_addr,
+                                        tSDP_DISCOVERY_DB* p_db);
+void sdp_disc_clear_cache(void);
 
 void update_pce_entry_to_interop_database(RawAddress remote_addr);
 bool is_sdp_pbap_pce_disabled(RawAddress remote_addr);
@@ -62,4 +62,8 @@ void ECC_PointMult_Bin_NAF(Point* q, Point* p, uint32_t* n);
 
 #define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
 
+// q = n * G, faster than ECC_PointMult(q, &curve_p256.G, n) once the table of
+// the multiples of G is computed by the first call
+void ECC_PointMult_Base(Point* q, uint32_t* n);
+
 void p_256_init_curve();
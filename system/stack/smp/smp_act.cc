@@ -288,6 +288,9 @@ void smp_send_pair_req(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   /* do not manipulate the key, let app decide,
      leave out to BTM to mandate key distribution for bonding case */
   smp_send_cmd(SMP_OPCODE_PAIRING_REQ, p_cb);
+
+  /* read the random values of the key distribution during the pairing */
+  smp_generate_next_key_dist_rand();
 }
 
 /*******************************************************************************
@@ -301,6 +304,9 @@ void smp_send_pair_rsp(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
   p_cb->local_r_key &= p_cb->peer_r_key;
 
   if (smp_send_cmd(SMP_OPCODE_PAIRING_RSP, p_cb)) {
+    /* read the random values of the key distribution during the pairing */
+    smp_generate_next_key_dist_rand();
+
     if (p_cb->selected_association_model == SMP_MODEL_SEC_CONN_OOB)
       smp_use_oob_private_key(p_cb, NULL);
     else
@@ -443,6 +443,8 @@ void smp_generate_ltk(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_generate_passkey(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_generate_rand_cont(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
+void smp_generate_next_key_pair();
+void smp_generate_next_key_dist_rand();
 void smp_use_oob_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data);
 void smp_compute_dhkey(tSMP_CB* p_cb);
 void smp_calculate_local_commitment(tSMP_CB* p_cb);
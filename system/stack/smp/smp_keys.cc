@@ -53,6 +53,7 @@ using crypto_toolbox::aes_128;
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_process_local_key_pair(tSMP_CB* p_cb);
 
 #define SMP_PASSKEY_MASK 0xfff00000
 
@@ -73,6 +74,112 @@ static bool is_empty(tSMP_LOC_OOB_DATA* data) {
 
 bool smp_has_local_oob_data() { return !is_empty(&saved_local_oob_data); }
 
+/* Key pair generated ahead of the next pairing, out of its critical path.
+ * The private key comes from the controller as for the pairings, and each key
+ * pair is used by a single pairing, as the spec recommends a new key pair for
+ * each pairing attempt. */
+static struct {
+  bool generating;
+  bool available;
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY public_key;
+} next_key_pair;
+
+static void smp_next_key_pair_rand(uint8_t offset) {
+  btsnd_hcic_ble_rand(Bind(
+      [](uint8_t offset, BT_OCTET8 rand) {
+        memcpy(&next_key_pair.private_key[offset], rand, BT_OCTET8_LEN);
+        offset += BT_OCTET8_LEN;
+        if (offset < BT_OCTET32_LEN) {
+          smp_next_key_pair_rand(offset);
+          return;
+        }
+
+        Point public_key;
+        BT_OCTET32 private_key;
+        memcpy(private_key, next_key_pair.private_key, BT_OCTET32_LEN);
+        ECC_PointMult_Base(&public_key, (uint32_t*)private_key);
+        memcpy(next_key_pair.public_key.x, public_key.x, BT_OCTET32_LEN);
+        memcpy(next_key_pair.public_key.y, public_key.y, BT_OCTET32_LEN);
+
+        next_key_pair.generating = false;
+        next_key_pair.available = true;
+      },
+      offset));
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_generate_next_key_pair
+ *
+ * Description      This function starts the generation of the key pair of the
+ *                  next LE Secure Connections pairing, unless there is one
+ *                  already.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_generate_next_key_pair() {
+  if (next_key_pair.generating || next_key_pair.available) return;
+
+  next_key_pair.generating = true;
+  smp_next_key_pair_rand(0);
+}
+
+/* Random values of the legacy key distribution read ahead of the next one:
+ * the DIV of the LTK or CSRK, and the Rand of the EDIV. Without them, each
+ * distributed key waits for one or two LE Rand round trips after the link is
+ * encrypted. Each value is used by a single key, as when it is read during the
+ * distribution. */
+static struct {
+  bool generating;
+  bool div_available;
+  bool rand_available;
+  uint16_t div;
+  BT_OCTET8 rand;
+} next_key_dist;
+
+static void smp_next_key_dist_div(BT_OCTET8 rand) {
+  STREAM_TO_UINT16(next_key_dist.div, rand);
+  next_key_dist.div_available = true;
+  next_key_dist.generating = false;
+}
+
+static void smp_next_key_dist_rand(BT_OCTET8 rand) {
+  memcpy(next_key_dist.rand, rand, BT_OCTET8_LEN);
+  next_key_dist.rand_available = true;
+  btsnd_hcic_ble_rand(Bind(&smp_next_key_dist_div));
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_generate_next_key_dist_rand
+ *
+ * Description      This function starts reading the random values of the next
+ *                  key distribution, unless they are available already.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_generate_next_key_dist_rand() {
+  if (next_key_dist.generating ||
+      (next_key_dist.div_available && next_key_dist.rand_available)) {
+    return;
+  }
+
+  next_key_dist.generating = true;
+  btsnd_hcic_ble_rand(Bind(&smp_next_key_dist_rand));
+}
+
+/* Takes the DIV read ahead of the key distribution, if there is one */
+static bool smp_take_next_key_dist_div(uint16_t* p_div) {
+  if (!next_key_dist.div_available) return false;
+
+  *p_div = next_key_dist.div;
+  next_key_dist.div_available = false;
+  return true;
+}
+
 void smp_debug_print_nbyte_little_endian(uint8_t* p, const char* key_name,
                                          uint8_t len) {}
 
@@ -195,8 +302,11 @@ void smp_generate_csrk(tSMP_CB* p_cb, UNUSED_ATTR tSMP_INT_DATA* p_data) {
   SMP_TRACE_DEBUG("smp_generate_csrk");
 
   div_status = btm_get_local_div(p_cb->pairing_bda, &p_cb->div);
+  uint16_t div;
   if (div_status) {
     smp_compute_csrk(p_cb->div, p_cb);
+  } else if (smp_take_next_key_dist_div(&div)) {
+    smp_compute_csrk(div, p_cb);
   } else {
     SMP_TRACE_DEBUG("Generate DIV for CSRK");
     btsnd_hcic_ble_rand(Bind(
@@ -511,6 +621,11 @@ static void smp_generate_ltk_cont(uint16_t div, tSMP_CB* p_cb) {
   p_cb->ltk = ltk;
 
   /* generate EDIV and rand now */
+  if (next_key_dist.rand_available) {
+    next_key_dist.rand_available = false;
+    smp_generate_y(p_cb, next_key_dist.rand);
+    return;
+  }
   btsnd_hcic_ble_rand(Bind(&smp_generate_y, p_cb));
 }
 
@@ -541,9 +656,12 @@ void smp_generate_ltk(tSMP_CB* p_cb, UNUSED_ATTR tSMP_INT_DATA* p_data) {
   }
 
   bool div_status = btm_get_local_div(p_cb->pairing_bda, &p_cb->div);
+  uint16_t div;
 
   if (div_status) {
     smp_generate_ltk_cont(p_cb->div, p_cb);
+  } else if (smp_take_next_key_dist_div(&div)) {
+    smp_generate_ltk_cont(div, p_cb);
   } else {
     SMP_TRACE_DEBUG("%s: Generate DIV for LTK", __func__);
 
@@ -612,6 +730,14 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     LOG_WARN("OOB Association Model with no saved data present");
   }
 
+  if (next_key_pair.available) {
+    memcpy(p_cb->private_key, next_key_pair.private_key, BT_OCTET32_LEN);
+    p_cb->loc_publ_key = next_key_pair.public_key;
+    memset(&next_key_pair, 0, sizeof(next_key_pair));
+    smp_process_local_key_pair(p_cb);
+    return;
+  }
+
   btsnd_hcic_ble_rand(Bind(
       [](tSMP_CB* p_cb, BT_OCTET8 rand) {
         memcpy((void*)p_cb->private_key, rand, BT_OCTET8_LEN);
@@ -716,6 +842,20 @@ void smp_process_private_key(tSMP_CB* p_cb) {
   memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
   memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
 
+  smp_process_local_key_pair(p_cb);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_process_local_key_pair
+ *
+ * Description      This function notifies SM that the private key / public
+ *                  key pair is created.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_process_local_key_pair(tSMP_CB* p_cb) {
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
                                       BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
@@ -1007,6 +1007,13 @@ void smp_proc_pairing_cmpl(tSMP_CB* p_cb) {
 
   smp_reset_control_value(p_cb);
 
+  /* The key pair of this pairing is not reused, the one of the next pairing
+   * is generated now rather than when it starts */
+  if (!evt_data.cmplt.smp_over_br) {
+    smp_generate_next_key_pair();
+    smp_generate_next_key_dist_rand();
+  }
+
   if (p_callback) (*p_callback)(SMP_COMPLT_EVT, pairing_bda, &evt_data);
 }
 
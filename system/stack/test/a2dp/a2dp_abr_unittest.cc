@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/include/a2dp_abr.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint8_t kNumLevels = 5;
+
+class A2dpAbrTest : public ::testing::Test {
+ protected:
+  void SetUp() override { a2dp_abr_init(&abr_, kNumLevels); }
+
+  // Samples |count| media ticks with |queue_length| buffers queued, returns
+  // the number of level changes
+  int Sample(int count, size_t queue_length) {
+    int changes = 0;
+    for (int i = 0; i < count; i++) {
+      if (a2dp_abr_set_transmit_queue_length(&abr_, queue_length)) changes++;
+    }
+    return changes;
+  }
+
+  tA2DP_ABR abr_;
+};
+
+TEST_F(A2dpAbrTest, clear_link_keeps_highest_level) {
+  EXPECT_EQ(0, Sample(1000, 0));
+  EXPECT_EQ(0, Sample(1000, 1));
+  EXPECT_EQ(0, abr_.level);
+  EXPECT_EQ(328u, a2dp_abr_scale(&abr_, 328, 164));
+}
+
+TEST_F(A2dpAbrTest, congestion_steps_down_with_hold) {
+  // A few ticks of queued buffers to detect the congestion
+  EXPECT_EQ(0, Sample(1, 3));
+  EXPECT_EQ(1, Sample(1, 3));
+  EXPECT_EQ(1, abr_.level);
+
+  // The next step waits for the queue to drain at the new level
+  EXPECT_EQ(0, Sample(9, 3));
+  EXPECT_EQ(1, Sample(1, 3));
+  EXPECT_EQ(2, abr_.level);
+
+  // Down to the lowest level only
+  Sample(1000, 3);
+  EXPECT_EQ(kNumLevels - 1, abr_.level);
+  EXPECT_EQ(4u, abr_.total_decreases);
+  EXPECT_EQ(164u, a2dp_abr_scale(&abr_, 328, 164));
+}
+
+TEST_F(A2dpAbrTest, clear_link_steps_up_slowly) {
+  Sample(20, 3);
+  ASSERT_EQ(2, abr_.level);
+
+  // The queue average has to decay before the link is clear
+  EXPECT_EQ(0, Sample(150, 0));
+  EXPECT_EQ(1, Sample(10, 0));
+  EXPECT_EQ(1, abr_.level);
+  EXPECT_EQ(1, Sample(150, 0));
+  EXPECT_EQ(0, abr_.level);
+  EXPECT_EQ(2u, abr_.total_increases);
+
+  // Short congestions restart the wait
+  Sample(20, 3);
+  int level = abr_.level;
+  Sample(100, 0);
+  Sample(1, 3);
+  Sample(100, 0);
+  EXPECT_EQ(level, abr_.level);
+}
+
+TEST_F(A2dpAbrTest, flush_steps_down_two_levels) {
+  EXPECT_TRUE(a2dp_abr_on_transmit_flush(&abr_));
+  EXPECT_EQ(2, abr_.level);
+  EXPECT_TRUE(a2dp_abr_on_transmit_flush(&abr_));
+  EXPECT_EQ(kNumLevels - 1, abr_.level);
+  EXPECT_FALSE(a2dp_abr_on_transmit_flush(&abr_));
+  EXPECT_EQ(3u, abr_.total_flushes);
+  EXPECT_EQ(0u, abr_.queue_average);
+}
+
+TEST_F(A2dpAbrTest, scale_levels) {
+  abr_.level = 2;
+  EXPECT_EQ(246u, a2dp_abr_scale(&abr_, 328, 164));
+  // Inverted bounds keep the maximum
+  EXPECT_EQ(100u, a2dp_abr_scale(&abr_, 100, 200));
+
+  tA2DP_ABR single_level;
+  a2dp_abr_init(&single_level, 0);
+  EXPECT_EQ(1, single_level.num_levels);
+  EXPECT_FALSE(a2dp_abr_on_transmit_flush(&single_level));
+  EXPECT_EQ(328u, a2dp_abr_scale(&single_level, 328, 164));
+}
+
+}  // namespace
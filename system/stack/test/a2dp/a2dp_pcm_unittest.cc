@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/include/a2dp_pcm.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// Frame counts around the widths of the vector loops
+constexpr size_t kFrameCounts[] = {0, 1, 3, 4, 7, 8, 9, 17, 56, 341};
+
+std::vector<uint8_t> RandomBytes(size_t size) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> bytes(size);
+  for (auto& value : bytes) value = byte(generator);
+  return bytes;
+}
+
+TEST(A2dpPcmTest, deinterleave_16_matches_the_aptx_encoder_loop) {
+  for (size_t frames : kFrameCounts) {
+    std::vector<uint8_t> bytes = RandomBytes(4 * frames);
+    std::vector<int16_t> src(2 * frames);
+    memcpy(src.data(), bytes.data(), bytes.size());
+
+    std::vector<int32_t> left(frames, 0x5a5a5a5a);
+    std::vector<int32_t> right(frames, 0x5a5a5a5a);
+    a2dp_pcm_deinterleave_16(src.data(), left.data(), right.data(), frames);
+
+    // The aptX encoder keeps the low 16 bits of its input samples
+    const uint16_t* data16_in = reinterpret_cast<const uint16_t*>(src.data());
+    for (size_t i = 0; i < frames; i++) {
+      ASSERT_EQ(static_cast<int16_t>(data16_in[2 * i]), left[i]);
+      ASSERT_EQ(static_cast<int16_t>(data16_in[2 * i + 1]), right[i]);
+    }
+  }
+}
+
+TEST(A2dpPcmTest, deinterleave_24_packed_matches_the_aptx_hd_encoder_loop) {
+  for (size_t frames : kFrameCounts) {
+    std::vector<uint8_t> src = RandomBytes(6 * frames);
+
+    std::vector<int32_t> left(frames, 0x5a5a5a5a);
+    std::vector<int32_t> right(frames, 0x5a5a5a5a);
+    a2dp_pcm_deinterleave_24_packed(src.data(), left.data(), right.data(),
+                                    frames);
+
+    const uint8_t* p = src.data();
+    for (size_t i = 0; i < frames; i++) {
+      ASSERT_EQ((p[0] << 0) | (p[1] << 8) | (((int8_t)p[2]) << 16), left[i]);
+      p += 3;
+      ASSERT_EQ((p[0] << 0) | (p[1] << 8) | (((int8_t)p[2]) << 16), right[i]);
+      p += 3;
+    }
+  }
+}
+
+TEST(A2dpPcmTest, deinterleave_24_packed_extends_the_sign) {
+  const uint8_t src[] = {0xff, 0xff, 0x7f, 0x00, 0x00, 0x80};
+  int32_t left;
+  int32_t right;
+  a2dp_pcm_deinterleave_24_packed(src, &left, &right, 1);
+  ASSERT_EQ(8388607, left);
+  ASSERT_EQ(-8388608, right);
+}
+
+}  // namespace
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
@@ -129,8 +130,9 @@ class A2dpSbcTest : public AllocationTestHarness {
   }
 
   void InitializeEncoder(bool peer_supports_3mbps, a2dp_source_read_callback_t read_cb,
-                         a2dp_source_enqueue_callback_t enqueue_cb) {
-    tA2DP_ENCODER_INIT_PEER_PARAMS peer_params = {true, peer_supports_3mbps, kPeerMtu};
+                         a2dp_source_enqueue_callback_t enqueue_cb, bool is_low_latency = false) {
+    tA2DP_ENCODER_INIT_PEER_PARAMS peer_params = {true, peer_supports_3mbps, kPeerMtu,
+                                                  is_low_latency};
     encoder_iface_->encoder_init(&peer_params, sink_codec_config_, read_cb,
                                  enqueue_cb);
   }
@@ -290,6 +292,37 @@ TEST_F(A2dpSbcTest, effective_mtu_when_peer_does_not_support_3mbps) {
   ASSERT_EQ(a2dp_sbc_get_effective_frame_size(), 663 /* MAX_2MBPS_AVDTP_MTU */);
 }
 
+static size_t max_frames_per_packet = 0;
+
+TEST_F(A2dpSbcTest, low_latency_mode_sends_fewer_frames_per_packet) {
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t { return len; };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    max_frames_per_packet = std::max(max_frames_per_packet, frames_n);
+    osi_free(p_buf);
+    return true;
+  };
+  auto send_ticks = [this](uint64_t interval_us) {
+    max_frames_per_packet = 0;
+    uint64_t timestamp_us = bluetooth::common::time_gettimeofday_us();
+    for (int i = 0; i < 10; i++) {
+      encoder_iface_->send_frames(timestamp_us);
+      timestamp_us += interval_us;
+    }
+  };
+
+  InitializeEncoder(true, read_cb, enqueue_cb);
+  ASSERT_EQ(encoder_iface_->get_encoder_interval_ms(), 20u);
+  send_ticks(20 * 1000);
+  ASSERT_GT(max_frames_per_packet, 4u);
+
+  encoder_iface_->encoder_cleanup();
+  InitializeEncoder(true, read_cb, enqueue_cb, true /* is_low_latency */);
+  ASSERT_EQ(encoder_iface_->get_encoder_interval_ms(), 10u);
+  send_ticks(10 * 1000);
+  ASSERT_GT(max_frames_per_packet, 0u);
+  ASSERT_LE(max_frames_per_packet, 4u);
+}
+
 TEST_F(A2dpSbcTest, debug_codec_dump) {
   log_capture_ = std::make_unique<LogCapture>();
   a2dp_codecs_->debug_codec_dump(2);
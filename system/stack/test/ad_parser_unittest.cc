@@ -210,4 +210,72 @@ TEST(AdvertiseDataParserTest, GetFieldByTypeInLoop) {
     match_no++;
   }
   EXPECT_EQ(match_no, 3);
-}
\ No newline at end of file
+}
+TEST(AdvertiseDataIndexTest, GetFieldByType) {
+  const std::vector<uint8_t> data0{0x02, 0x01, 0x06, 0x03, 0x19, 0xc1, 0x03,
+                                   0x05, 0x09, 0x4e, 0x61, 0x6d, 0x65};
+  AdvertiseDataIndex index(data0);
+  EXPECT_EQ(3u, index.size());
+
+  for (uint8_t type : {0x01, 0x09, 0x19, 0x16}) {
+    uint8_t expected_length;
+    const uint8_t* expected =
+        AdvertiseDataParser::GetFieldByType(data0, type, &expected_length);
+    uint8_t p_length;
+    EXPECT_EQ(expected, index.GetFieldByType(type, &p_length));
+    EXPECT_EQ(expected_length, p_length);
+  }
+
+  // Second field have bad length, and is left out of the index.
+  const std::vector<uint8_t> data1{0x02, 0x02, 0x00, 0x03, 0x00};
+  AdvertiseDataIndex index1(data1);
+  EXPECT_EQ(1u, index1.size());
+  uint8_t p_length;
+  EXPECT_EQ(nullptr, index1.GetFieldByType(0x03, &p_length));
+  EXPECT_EQ(0, p_length);
+
+  // Zero padding ends the data.
+  const std::vector<uint8_t> data2{0x02, 0x02, 0x00, 0x00, 0x02, 0x03, 0x00};
+  EXPECT_EQ(1u, AdvertiseDataIndex(data2).size());
+  EXPECT_EQ(0u, AdvertiseDataIndex(std::vector<uint8_t>{}).size());
+}
+
+TEST(AdvertiseDataIndexTest, ForEachFieldOfTypePastCapacity) {
+  // An extended payload with more fields than the index holds, the service
+  // data fields being spread on both sides of its capacity.
+  std::vector<uint8_t> data0;
+  for (size_t i = 0; i < AdvertiseDataIndex::kMaxFields + 8; i++) {
+    uint8_t type = (i % 4 == 0) ? 0x16 : 0xff;
+    data0.insert(data0.end(), {0x03, type, static_cast<uint8_t>(i), 0x18});
+  }
+  data0.insert(data0.end(), {0x05, 0x16});  // Truncated
+
+  AdvertiseDataIndex index(data0);
+  EXPECT_EQ(AdvertiseDataIndex::kMaxFields, index.size());
+
+  std::vector<const uint8_t*> expected;
+  const uint8_t* p_service_data = data0.data();
+  uint8_t service_data_len = 0;
+  while ((p_service_data = AdvertiseDataParser::GetFieldByType(
+              p_service_data + service_data_len,
+              data0.size() - (p_service_data - data0.data()) - service_data_len,
+              0x16, &service_data_len))) {
+    expected.push_back(p_service_data);
+  }
+
+  std::vector<const uint8_t*> fields;
+  index.ForEachFieldOfType(0x16, [&](const uint8_t* field, uint8_t length) {
+    EXPECT_EQ(2, length);
+    fields.push_back(field);
+    return true;
+  });
+  EXPECT_EQ(expected, fields);
+  EXPECT_EQ(10u, fields.size());
+
+  // Stops at the first field the callback returns false for.
+  size_t visited = 0;
+  index.ForEachFieldOfType(0x16, [&](const uint8_t*, uint8_t) {
+    return ++visited < 9;
+  });
+  EXPECT_EQ(9u, visited);
+}
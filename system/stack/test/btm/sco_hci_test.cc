@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "btif/include/core_callbacks.h"
 #include "btif/include/stack_manager.h"
@@ -260,6 +261,28 @@ TEST_F(ScoHciWbsWithInitCleanTest, WbsDecode) {
   ASSERT_EQ(decoded, nullptr);
 }
 
+TEST_F(ScoHciWbsTest, WbsDecodeUnalignedPackets) {
+  const uint8_t* decoded = nullptr;
+  // A few bytes ahead of the first mSBC frame, so that the 60 bytes mSBC
+  // frames never end with the 72 bytes SCO packets
+  std::vector<uint8_t> stream(3, 0xff);
+  for (size_t i = 0; i < 24; i++) {
+    stream.insert(stream.end(), std::begin(msbc_zero_packet),
+                  std::end(msbc_zero_packet));
+  }
+
+  ASSERT_EQ(bluetooth::audio::sco::wbs::init(72), size_t(72));
+  size_t num_decoded = 0;
+  for (size_t i = 0; i < 20; i++) {
+    ASSERT_EQ(bluetooth::audio::sco::wbs::enqueue_packet(&stream[i * 72],
+                                                         size_t(72), false),
+              size_t(72));
+    while (bluetooth::audio::sco::wbs::decode(&decoded)) num_decoded++;
+  }
+  ASSERT_EQ(num_decoded, size_t(23));
+  bluetooth::audio::sco::wbs::cleanup();
+}
+
 TEST_F(ScoHciWbsTest, WbsEncodeWithoutInit) {
   int16_t data[120] = {0};
   // Return 0 if buffer is uninitialized
@@ -38,8 +38,10 @@
 #include "stack/btm/security_device_record.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_hci_link_interface.h"
+#include "stack/include/btm_api.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/hcidefs.h"
+#include "stack/include/inq_hci_link_interface.h"
 #include "stack/include/sec_hci_link_interface.h"
 #include "stack/l2cap/l2c_int.h"
 #include "test/common/mock_functions.h"
@@ -455,3 +457,146 @@ TEST_F(StackBtmWithInitFreeTest, wipe_secrets_and_remove) {
 
   wipe_secrets_and_remove(device_record);
 }
+
+TEST_F(StackBtmWithInitFreeTest, btm_find_dev__cached_lookups) {
+  const RawAddress bd_addr = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  const RawAddress other_addr =
+      RawAddress({0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6});
+  const uint16_t classic_handle = 0x0123;
+  const uint16_t ble_handle = 0x0456;
+
+  tBTM_SEC_DEV_REC* device_record = btm_sec_allocate_dev_rec();
+  ASSERT_NE(nullptr, device_record);
+  device_record->bd_addr = bd_addr;
+  device_record->hci_handle = classic_handle;
+  device_record->ble_hci_handle = ble_handle;
+
+  // Looked up twice, the second time from the caches
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+    ASSERT_EQ(device_record, btm_find_dev_by_handle(classic_handle));
+    ASSERT_EQ(device_record, btm_find_dev_by_handle(ble_handle));
+  }
+
+  // Records changing handle or address aren't found under the old ones
+  device_record->hci_handle = HCI_INVALID_HANDLE;
+  device_record->bd_addr = other_addr;
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(classic_handle));
+  ASSERT_EQ(nullptr, btm_find_dev(bd_addr));
+  ASSERT_EQ(device_record, btm_find_dev(other_addr));
+  ASSERT_EQ(device_record, btm_find_dev_by_handle(ble_handle));
+
+  // A new record given the handle and address of the first one
+  tBTM_SEC_DEV_REC* new_record = btm_sec_allocate_dev_rec();
+  ASSERT_NE(nullptr, new_record);
+  new_record->bd_addr = other_addr;
+  new_record->ble_hci_handle = ble_handle;
+  device_record->ble_hci_handle = HCI_INVALID_HANDLE;
+  device_record->bd_addr = bd_addr;
+  ASSERT_EQ(new_record, btm_find_dev(other_addr));
+  ASSERT_EQ(new_record, btm_find_dev_by_handle(ble_handle));
+
+  // Removed records are dropped from the caches
+  wipe_secrets_and_remove(new_record);
+  ASSERT_EQ(nullptr, btm_find_dev(other_addr));
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(ble_handle));
+  ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+}
+
+namespace {
+tBTM_STATUS access_request_status;
+int access_request_callbacks;
+
+void access_request_callback(const RawAddress* bd_addr,
+                             tBT_TRANSPORT transport, void* p_ref_data,
+                             tBTM_STATUS result) {
+  access_request_status = result;
+  access_request_callbacks++;
+}
+}  // namespace
+
+TEST_F(StackBtmWithInitFreeTest, btm_sec_mx_access_request__granted_access) {
+  const RawAddress bd_addr = RawAddress({0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6});
+  const uint16_t security_required =
+      BTM_SEC_OUT_AUTHENTICATE | BTM_SEC_OUT_ENCRYPT;
+
+  // A device authenticated and encrypted with a P-256 authenticated key
+  tBTM_SEC_DEV_REC* device_record = btm_sec_allocate_dev_rec();
+  ASSERT_NE(nullptr, device_record);
+  device_record->bd_addr = bd_addr;
+  device_record->hci_handle = 0x0123;
+  device_record->sm4 = BTM_SM4_TRUE;
+  device_record->link_key_type = BTM_LKEY_TYPE_AUTH_COMB_P_256;
+  device_record->sec_flags |= BTM_SEC_NAME_KNOWN | BTM_SEC_LINK_KEY_KNOWN |
+                              BTM_SEC_LINK_KEY_AUTHED | BTM_SEC_AUTHENTICATED |
+                              BTM_SEC_ENCRYPTED;
+
+  // Granted by the security procedures, then from the saved access
+  access_request_callbacks = 0;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(BTM_SUCCESS,
+              btm_sec_mx_access_request(bd_addr, true, security_required,
+                                        access_request_callback, nullptr));
+    ASSERT_EQ(i + 1, access_request_callbacks);
+    ASSERT_EQ(BTM_SUCCESS, access_request_status);
+    ASSERT_EQ(1, device_record->num_granted_access);
+  }
+  ASSERT_EQ(BTM_SUCCESS,
+            btm_sec_mx_access_request(bd_addr, true, BTM_SEC_OUT_AUTHENTICATE,
+                                      access_request_callback, nullptr));
+  ASSERT_EQ(2, device_record->num_granted_access);
+
+  // The security procedures run again once the security state changes
+  device_record->sec_flags &= ~BTM_SEC_ENCRYPTED;
+  ASSERT_EQ(BTM_CMD_STARTED,
+            btm_sec_mx_access_request(bd_addr, true, security_required,
+                                      access_request_callback, nullptr));
+  ASSERT_EQ(1, get_func_call_count("btsnd_hcic_set_conn_encrypt"));
+  ASSERT_EQ(BTM_SEC_STATE_ENCRYPTING, device_record->sec_state);
+
+  device_record->sec_state = BTM_SEC_STATE_IDLE;
+  device_record->p_callback = nullptr;
+  device_record->sec_flags |= BTM_SEC_ENCRYPTED;
+  ASSERT_EQ(BTM_SUCCESS,
+            btm_sec_mx_access_request(bd_addr, true, security_required,
+                                      access_request_callback, nullptr));
+  ASSERT_EQ(BTM_SUCCESS, access_request_status);
+  ASSERT_EQ(1, get_func_call_count("btsnd_hcic_set_conn_encrypt"));
+
+  wipe_secrets_and_remove(device_record);
+}
+
+TEST_F(StackBtmWithInitFreeTest, btm_inq_db__lookups_and_eviction) {
+  ASSERT_EQ(BTM_SUCCESS, BTM_ClearInqDb(nullptr));
+
+  // The database holds BTM_INQ_DB_SIZE entries when the size isn't set
+  std::vector<RawAddress> addresses;
+  std::vector<tINQ_DB_ENT*> entries;
+  for (uint8_t i = 0; i < BTM_INQ_DB_SIZE; i++) {
+    addresses.push_back(RawAddress({0xC1, 0xC2, 0xC3, 0xC4, 0xC5, i}));
+    entries.push_back(btm_inq_db_new(addresses.back()));
+    ASSERT_NE(nullptr, entries.back());
+    entries.back()->time_of_resp = i + 1;
+  }
+  for (size_t i = 0; i < addresses.size(); i++) {
+    ASSERT_EQ(entries[i], btm_inq_db_find(addresses[i]));
+    ASSERT_EQ(&entries[i]->inq_info, BTM_InqDbRead(addresses[i]));
+  }
+
+  // A new device replaces the one that responded least recently
+  entries[0]->time_of_resp = BTM_INQ_DB_SIZE + 1;
+  const RawAddress new_address({0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6});
+  tINQ_DB_ENT* new_entry = btm_inq_db_new(new_address);
+  ASSERT_EQ(entries[1], new_entry);
+  ASSERT_EQ(new_entry, btm_inq_db_find(new_address));
+  ASSERT_EQ(nullptr, btm_inq_db_find(addresses[1]));
+  ASSERT_EQ(entries[0], btm_inq_db_find(addresses[0]));
+
+  // Cleared entries are not found anymore
+  ASSERT_EQ(BTM_SUCCESS, BTM_ClearInqDb(&addresses[0]));
+  ASSERT_EQ(nullptr, btm_inq_db_find(addresses[0]));
+  ASSERT_EQ(entries[2], btm_inq_db_find(addresses[2]));
+  ASSERT_EQ(BTM_SUCCESS, BTM_ClearInqDb(nullptr));
+  ASSERT_EQ(nullptr, btm_inq_db_find(new_address));
+  ASSERT_EQ(nullptr, BTM_InqDbFirst());
+}
@@ -2137,6 +2137,110 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturnedByDisconnection) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataBufferCigValid) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                                kDefaultIsoDataPathParams);
+
+    constexpr uint8_t data_len = 108;
+    EXPECT_CALL(bte_interface_, HciSend)
+        .WillOnce([handle](BT_HDR* p_msg, uint16_t event) {
+          uint8_t* p = p_msg->data;
+          uint16_t msg_handle;
+          uint16_t msg_data_len;
+
+          ASSERT_TRUE((event & MSG_STACK_TO_HC_HCI_ISO) != 0);
+          ASSERT_TRUE(p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS);
+          ASSERT_EQ(p_msg->len, data_len + 12);
+
+          STREAM_TO_UINT16(msg_handle, p);
+          ASSERT_EQ(msg_handle, handle);
+          STREAM_SKIP_UINT16(p);  // skip iso load length
+          STREAM_SKIP_UINT16(p);  // skip ts LSB halfword
+          STREAM_SKIP_UINT16(p);  // skip ts MSB halfword
+          STREAM_SKIP_UINT16(p);  // skip seq_nb
+          STREAM_TO_UINT16(msg_data_len, p);
+          ASSERT_EQ(msg_data_len, data_len);
+
+          // The data written in place is sent as is
+          for (uint8_t i = 0; i < data_len; i++) {
+            ASSERT_EQ(p[i], i);
+          }
+          osi_free(p_msg);
+        })
+        .RetiresOnSaturation();
+
+    uint8_t* data =
+        IsoManager::GetInstance()->GetIsoDataBuffer(handle, data_len);
+    ASSERT_NE(data, nullptr);
+    for (uint8_t i = 0; i < data_len; i++) data[i] = i;
+    IsoManager::GetInstance()->SendIsoDataBuffer(handle);
+  }
+
+  // Nothing left to send
+  EXPECT_CALL(bte_interface_, HciSend).Times(0);
+  IsoManager::GetInstance()->SendIsoDataBuffer(
+      volatile_test_cig_create_cmpl_evt_.conn_handles[0]);
+}
+
+TEST_F(IsoManagerTest, GetIsoDataBufferNoCredits) {
+  uint8_t num_buffers = controller_interface_.GetIsoBufferCount();
+  uint16_t handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  // Buffers that are not sent give their credit back
+  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+    ASSERT_NE(IsoManager::GetInstance()->GetIsoDataBuffer(handle, 108),
+              nullptr);
+  }
+
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+    uint8_t* data = IsoManager::GetInstance()->GetIsoDataBuffer(handle, 108);
+    ASSERT_EQ(data == nullptr, i >= num_buffers);
+    IsoManager::GetInstance()->SendIsoDataBuffer(handle);
+  }
+
+  // Disconnection returns the credits, the unsent buffer included
+  uint8_t mock_rsp[5];
+  uint8_t* p = mock_rsp;
+  UINT8_TO_STREAM(p, 1);
+  UINT16_TO_STREAM(p, handle);
+  UINT16_TO_STREAM(p, 1);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
+  ASSERT_NE(IsoManager::GetInstance()->GetIsoDataBuffer(handle, 108), nullptr);
+  IsoManager::GetInstance()->HandleDisconnect(handle, 16);
+
+  uint16_t other_handle = volatile_test_cig_create_cmpl_evt_.conn_handles[1];
+  IsoManager::GetInstance()->SetupIsoDataPath(other_handle,
+                                              kDefaultIsoDataPathParams);
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers).RetiresOnSaturation();
+  for (uint8_t i = 0; i < num_buffers; i++) {
+    ASSERT_NE(IsoManager::GetInstance()->GetIsoDataBuffer(other_handle, 108),
+              nullptr);
+    IsoManager::GetInstance()->SendIsoDataBuffer(other_handle);
+  }
+}
+
 TEST_F(IsoManagerDeathTest, SendIsoDataWithNoDataPath) {
   std::vector<uint8_t> data_vec(108, 0);
 
@@ -399,4 +399,53 @@ TEST(CryptoToolboxTest, bt_spec_example_d_12_test) {
   EXPECT_EQ(expected_ltk, ltk);
 }
 
+// aes_128 uses the AES instructions of the CPU when it has them, they must
+// give the same output as the software AES
+TEST(CryptoToolboxTest, aes_128_matches_software_aes) {
+  uint32_t seed = 0x12345678;
+  auto next_byte = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<uint8_t>(seed >> 16);
+  };
+
+  for (int i = 0; i < 1000; i++) {
+    Octet16 key, message;
+    std::generate(key.begin(), key.end(), next_byte);
+    std::generate(message.begin(), message.end(), next_byte);
+
+    // aes_128 takes and returns little endian values
+    Octet16 key_reversed, message_reversed, expected;
+    std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+    std::reverse_copy(message.begin(), message.end(),
+                      message_reversed.begin());
+    aes_context ctx;
+    aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
+    aes_encrypt(message_reversed.data(), expected.data(), &ctx);
+    std::reverse(expected.begin(), expected.end());
+
+    ASSERT_EQ(expected, aes_128(key, message)) << "at iteration " << i;
+  }
+}
+
+// Each key of aes_128_multi_key gives the same output as aes_128, whether it
+// is encrypted with other keys at once or alone at the end
+TEST(CryptoToolboxTest, aes_128_multi_key_matches_aes_128) {
+  constexpr size_t kNumKeys = 11;
+  Octet16 message{0x47, 0x11, 0x0e, 0x00, 0x00, 0x00, 0x00, 0x00,
+                  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+  std::vector<Octet16> keys(kNumKeys);
+  std::vector<Aes128KeySchedule> schedules;
+  for (size_t i = 0; i < kNumKeys; i++) {
+    for (size_t j = 0; j < OCTET16_LEN; j++) keys[i][j] = i * 37 + j * 11;
+    schedules.push_back(aes_128_key_schedule(keys[i]));
+  }
+
+  std::vector<Octet16> outputs(kNumKeys);
+  aes_128_multi_key(schedules.data(), kNumKeys, message, outputs.data());
+  for (size_t i = 0; i < kNumKeys; i++) {
+    EXPECT_EQ(aes_128(keys[i], message), outputs[i]) << "for key " << i;
+  }
+}
+
 }  // namespace crypto_toolbox
@@ -670,4 +670,33 @@ TEST_F(EattTest, ChannelUnavailableWhileReconfiguring) {
   ASSERT_EQ(available_channel_for_indication, nullptr);
 }
 
+TEST_F(EattTest, ClientRequestsUseLeastLoadedChannel) {
+  ConnectDeviceEattSupported(/* num_of_accepted_connections = */ 3);
+  std::vector<EattChannel*> channels;
+  for (uint16_t cid : connected_cids_) {
+    channels.push_back(
+        eatt_instance_->FindEattChannelByCid(test_address, cid));
+    ASSERT_NE(channels.back(), nullptr);
+  }
+
+  // Equally loaded channels: the lowest CID wins
+  auto channel =
+      eatt_instance_->GetChannelAvailableForClientRequest(test_address);
+  ASSERT_EQ(channel, channels[0]);
+
+  channels[0]->cl_cmd_q_.push_back(tGATT_CMD_Q{});
+  channels[1]->cl_cmd_q_.push_back(tGATT_CMD_Q{});
+  channel = eatt_instance_->GetChannelAvailableForClientRequest(test_address);
+  ASSERT_EQ(channel, channels[2]);
+
+  // All busy, the one with the shortest queue is used rather than none
+  channels[0]->cl_cmd_q_.push_back(tGATT_CMD_Q{});
+  channels[2]->cl_cmd_q_.push_back(tGATT_CMD_Q{});
+  channel = eatt_instance_->GetChannelAvailableForClientRequest(test_address);
+  ASSERT_EQ(channel, channels[1]);
+
+  for (EattChannel* c : channels) c->cl_cmd_q_.clear();
+  DisconnectEattDevice(connected_cids_);
+}
+
 }  // namespace
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bta/ag/bta_ag_at.h"
+#include "bta/ag/bta_ag_int.h"
+#include "gd/fuzz/parser_timer.h"
+
+// Size of the parsing buffer, as set up by the AG state machine
+constexpr uint16_t kCmdMaxLen = 512;
+
+static void at_cmd_cback(tBTA_AG_SCB* p_user, uint16_t command_id,
+                         uint8_t arg_type, char* p_arg, char* p_end,
+                         int16_t int_arg) {}
+
+static void at_err_cback(tBTA_AG_SCB* p_user, bool unknown,
+                         const char* p_arg) {}
+
+// Feeds the input as the AT commands received from a hands-free unit, parsed
+// against the HFP command table
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size > UINT16_MAX) return 0;
+
+  tBTA_AG_AT_CB at_cb{};
+  at_cb.p_at_tbl = bta_ag_at_tbl[BTA_AG_HFP];
+  at_cb.p_cmd_cback = at_cmd_cback;
+  at_cb.p_err_cback = at_err_cback;
+  at_cb.cmd_max_len = kCmdMaxLen;
+  bta_ag_at_init(&at_cb);
+
+  std::vector<char> buf(data, data + size);
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("ag_at", size);
+    bta_ag_at_parse(&at_cb, buf.data(), static_cast<uint16_t>(size));
+  }
+
+  bta_ag_at_reinit(&at_cb);
+  return 0;
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "gd/fuzz/parser_timer.h"
 #include "osi/include/allocator.h"
 #include "stack/include/avrc_api.h"
 
@@ -183,11 +184,17 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
       break;
   }
 
-  AVRC_Ctrl_ParsResponse(&msg, &result, scratch_buf, &scratch_buf_len);
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("avrc_ctrl_response", size);
+    AVRC_Ctrl_ParsResponse(&msg, &result, scratch_buf, &scratch_buf_len);
+  }
   free_avrc_response(result);
 
   memset(&result, 0, sizeof(result));
-  AVRC_ParsResponse(&msg, &result, scratch_buf, scratch_buf_len);
+  {
+    bluetooth::fuzz::ScopedParserTimer timer("avrc_response", size);
+    AVRC_ParsResponse(&msg, &result, scratch_buf, scratch_buf_len);
+  }
   free_avrc_response(result);
 
   return 0;
@@ -17,6 +17,7 @@
 #include <fuzzer/FuzzedDataProvider.h>
 #include "fuzzers/common/commonFuzzHelpers.h"
 #include "fuzzers/sdp/sdpFuzzFunctions.h"
+#include "gd/fuzz/parser_timer.h"
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   // Init our wrapper
@@ -25,6 +26,7 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   setupSdpFuzz();
 
   // Call some functions
+  bluetooth::fuzz::ScopedParserTimer timer("sdp", size);
   while (dataProvider.remaining_bytes() > 0) {
     callArbitraryFunction(&dataProvider, sdp_operations);
   }
@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include <cstdint>
+#include <vector>
 
 #include "osi/test/AllocationTestHarness.h"
 #include "stack/gatt/gatt_int.h"
@@ -50,6 +51,12 @@ struct TestMutables {
     int access_count_{0};
     tGATT_STATUS return_status_{GATT_SUCCESS};
   } gatts_write_attr_perm_check;
+  struct {
+    std::vector<std::vector<uint8_t>> pdus_;
+  } attp_send_sr_msg;
+  struct {
+    bool return_{false};
+  } gatt_sr_is_cl_multi_variable_len_notif_supported;
 };
 
 TestMutables test_state_;
@@ -79,6 +86,11 @@ tGATT_STATUS attp_send_cl_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
   return GATT_SUCCESS;
 }
 tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg) {
+  if (p_msg != nullptr) {
+    uint8_t* p = (uint8_t*)(p_msg + 1) + p_msg->offset;
+    test_state_.attp_send_sr_msg.pdus_.emplace_back(p, p + p_msg->len);
+    osi_free(p_msg);
+  }
   return GATT_SUCCESS;
 }
 
@@ -136,6 +148,9 @@ void ApplicationRequestCallback(uint16_t conn_id, uint32_t trans_id,
 }
 
 bool gatt_sr_is_cl_change_aware(tGATT_TCB& tcb) { return false; }
+bool gatt_sr_is_cl_multi_variable_len_notif_supported(tGATT_TCB& tcb) {
+  return test_state_.gatt_sr_is_cl_multi_variable_len_notif_supported.return_;
+}
 void gatt_sr_init_cl_status(tGATT_TCB& p_tcb) {}
 void gatt_sr_update_cl_status(tGATT_TCB& p_tcb, bool chg_aware) {
   p_tcb.is_robust_cache_change_aware = chg_aware;
@@ -573,3 +588,84 @@ TEST_F(GattSrRobustCachingTest,
 
   ASSERT_FALSE(should_ignore);
 }
+
+TEST_F(GattSrTest, notifications_are_batched_while_congested) {
+  tGATT_TCB tcb = tGATT_TCB();
+  tcb.att_lcid = L2CAP_ATT_CID;
+  tcb.payload_size = 23;
+  test_state_.gatt_sr_is_cl_multi_variable_len_notif_supported.return_ = true;
+
+  tGATT_VALUE notif = {};
+  notif.handle = 0x0010;
+  notif.len = 4;
+
+  ASSERT_FALSE(gatt_sr_hold_notification(tcb, L2CAP_ATT_CID, notif));
+
+  gatt_sr_channel_congestion(tcb, L2CAP_ATT_CID, true);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(gatt_sr_hold_notification(tcb, L2CAP_ATT_CID, notif));
+  }
+  ASSERT_TRUE(test_state_.attp_send_sr_msg.pdus_.empty());
+
+  // Two notifications of 4 bytes fit in the 23 bytes MTU
+  gatt_sr_channel_congestion(tcb, L2CAP_ATT_CID, false);
+  ASSERT_EQ(2u, test_state_.attp_send_sr_msg.pdus_.size());
+  for (const auto& pdu : test_state_.attp_send_sr_msg.pdus_) {
+    ASSERT_EQ(17u, pdu.size());
+    ASSERT_EQ(GATT_HANDLE_MULTI_VALUE_NOTIF, pdu[0]);
+    ASSERT_EQ(0x10, pdu[1]);
+    ASSERT_EQ(4, pdu[3]);
+  }
+  ASSERT_FALSE(gatt_sr_hold_notification(tcb, L2CAP_ATT_CID, notif));
+
+  // A notification left alone is sent as a Handle Value Notification
+  gatt_sr_channel_congestion(tcb, L2CAP_ATT_CID, true);
+  ASSERT_TRUE(gatt_sr_hold_notification(tcb, L2CAP_ATT_CID, notif));
+  gatt_sr_channel_congestion(tcb, L2CAP_ATT_CID, false);
+  ASSERT_EQ(GATT_HANDLE_VALUE_NOTIF, test_state_.attp_build_sr_msg.op_code_);
+}
+
+TEST_F(GattSrTest, notifications_are_not_held_without_client_support) {
+  tGATT_TCB tcb = tGATT_TCB();
+  tcb.att_lcid = L2CAP_ATT_CID;
+  tcb.payload_size = 23;
+
+  tGATT_VALUE notif = {};
+  gatt_sr_channel_congestion(tcb, L2CAP_ATT_CID, true);
+  ASSERT_FALSE(gatt_sr_hold_notification(tcb, L2CAP_ATT_CID, notif));
+}
+
+TEST_F(GattSrTest, latency_histogram_percentiles) {
+  tGATT_LATENCY_HIST hist = {};
+  for (int i = 0; i < 98; i++) gatt_latency_hist_add(hist, 300);
+  gatt_latency_hist_add(hist, 5000);
+  gatt_latency_hist_add(hist, 10000000);
+
+  ASSERT_EQ(100u, hist.count);
+  ASSERT_EQ(1u, gatt_latency_hist_percentile_ms(hist, 50));
+  // 5 ms is in the [4, 8) ms bucket
+  ASSERT_EQ(8u, gatt_latency_hist_percentile_ms(hist, 99));
+  ASSERT_EQ(10000u, gatt_latency_hist_percentile_ms(hist, 100));
+}
+
+TEST_F(GattSrTest, request_latencies_are_recorded) {
+  tGATT_TCB tcb = tGATT_TCB();
+  tcb.att_lcid = L2CAP_ATT_CID;
+
+  gatt_sr_enqueue_cmd(tcb, L2CAP_ATT_CID, GATT_REQ_READ, 0x0010);
+  gatt_dequeue_sr_cmd(tcb, L2CAP_ATT_CID);
+  ASSERT_EQ(1u, tcb.sr_latency[GATT_REQ_READ].count);
+
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  for (int i = 0; i < GATT_SLOW_PEER_MIN_SAMPLES - 1; i++) {
+    gatt_cl_record_latency(tcb, GATT_REQ_WRITE, now_us - 2000000);
+  }
+  ASSERT_FALSE(tcb.slow_peer);
+
+  // Enough slow responses report the peer
+  gatt_cl_record_latency(tcb, GATT_REQ_WRITE, now_us - 2000000);
+  ASSERT_TRUE(tcb.slow_peer);
+  ASSERT_EQ(1u, gatt_cb.slow_peers.size());
+  ASSERT_EQ(GATT_REQ_WRITE, gatt_cb.slow_peers.back().op_code);
+  gatt_cb.slow_peers.clear();
+}
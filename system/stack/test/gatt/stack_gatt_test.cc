@@ -43,7 +43,7 @@ size_t actual_sizeof_tGATT_REG() {
 void tGATT_DISC_RES_CB(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                        tGATT_DISC_RES* p_data) {}
 void tGATT_DISC_CMPL_CB(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
-                        tGATT_STATUS status) {}
+                        tGATT_STATUS status, uint16_t e_handle) {}
 void tGATT_CMPL_CBACK(uint16_t conn_id, tGATTC_OPTYPE op, tGATT_STATUS status,
                       tGATT_CL_COMPLETE* p_data) {}
 void tGATT_CONN_CBACK(tGATT_IF gatt_if, const RawAddress& bda, uint16_t conn_id,
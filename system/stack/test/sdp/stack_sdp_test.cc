@@ -22,6 +22,7 @@
 
 #include "stack/include/sdp_api.h"
 #include "stack/sdp/sdpint.h"
+#include "test/mock/mock_osi_alarm.h"
 #include "test/mock/mock_osi_allocator.h"
 #include "test/mock/mock_stack_l2cap_api.h"
 
@@ -227,3 +228,191 @@ TEST_F(StackSdpMainTest, sdp_flags_text) {
                                   std::numeric_limits<uint8_t>::max()))
                    .c_str());
 }
+
+static std::vector<uint8_t> sdp_rsp;
+
+// Sends a service search attribute request for the serial port UUID and all
+// the attributes, returns the continuation offset of the response or -1
+static int send_service_search_attr_req(tCONN_CB* p_ccb, int cont_offset) {
+  std::vector<uint8_t> params = {
+      0x35, 0x03, 0x19, 0x11, 0x01,              // UUID sequence
+      0xff, 0xff,                                // Maximum byte count
+      0x35, 0x05, 0x0a, 0x00, 0x00, 0xff, 0xff,  // Attribute ID range
+  };
+  if (cont_offset > 0) {
+    params.insert(params.end(), {SDP_CONTINUATION_LEN,
+                                 (uint8_t)(cont_offset >> 8),
+                                 (uint8_t)(cont_offset & 0xff)});
+  } else {
+    params.push_back(0);
+  }
+
+  std::vector<uint8_t> req = {SDP_PDU_SERVICE_SEARCH_ATTR_REQ, 0x00, 0x01,
+                              0x00, (uint8_t)params.size()};
+  req.insert(req.end(), params.begin(), params.end());
+  BT_HDR* p_msg = (BT_HDR*)malloc(sizeof(BT_HDR) + req.size());
+  p_msg->offset = 0;
+  p_msg->len = req.size();
+  memcpy(p_msg->data, req.data(), req.size());
+
+  sdp_rsp.clear();
+  sdp_server_handle_client_req(p_ccb, p_msg);
+  free(p_msg);
+
+  if (sdp_rsp.size() < 8 || sdp_rsp[0] != SDP_PDU_SERVICE_SEARCH_ATTR_RSP) {
+    return -1;
+  }
+  size_t byte_count = (sdp_rsp[5] << 8) | sdp_rsp[6];
+  if (sdp_rsp.size() < 8 + byte_count) return -1;
+  EXPECT_EQ(0x00, sdp_rsp[1]);
+  EXPECT_EQ(0x01, sdp_rsp[2]);
+  if (sdp_rsp[7 + byte_count] == 0) return 0;
+  return (sdp_rsp[8 + byte_count] << 8) | sdp_rsp[9 + byte_count];
+}
+
+// Returns the attribute lists of a service search attribute request
+static std::vector<uint8_t> get_attr_lists(tCONN_CB* p_ccb) {
+  std::vector<uint8_t> attr_lists;
+  int cont_offset = 0;
+  do {
+    cont_offset = send_service_search_attr_req(p_ccb, cont_offset);
+    if (cont_offset < 0) return {};
+    size_t byte_count = (sdp_rsp[5] << 8) | sdp_rsp[6];
+    attr_lists.insert(attr_lists.end(), &sdp_rsp[7], &sdp_rsp[7 + byte_count]);
+  } while (cont_offset > 0);
+  return attr_lists;
+}
+
+TEST_F(StackSdpMainTest, sdp_service_search_attr_rsp_cache) {
+  test::mock::stack_l2cap_api::L2CA_DataWrite.body = [](uint16_t cid,
+                                                        BT_HDR* p_data) {
+    uint8_t* p = p_data->data + p_data->offset;
+    sdp_rsp.assign(p, p + p_data->len);
+    osi_free_and_reset((void**)&p_data);
+    return 0;
+  };
+  sdp_server_clear_rsp_cache();
+
+  uint32_t handle = SDP_CreateRecord();
+  ASSERT_NE(0u, handle);
+  uint16_t uuid = 0x1101;
+  ASSERT_TRUE(SDP_AddServiceClassIdList(handle, 1, &uuid));
+  const char* name = "Serial Port";
+  ASSERT_TRUE(SDP_AddAttribute(handle, ATTR_ID_SERVICE_NAME, TEXT_STR_DESC_TYPE,
+                               strlen(name), (uint8_t*)name));
+
+  tCONN_CB* p_ccb = sdpu_allocate_ccb();
+  ASSERT_NE(nullptr, p_ccb);
+  // Split the attribute lists over a few responses
+  p_ccb->rem_mtu_size = 30;
+
+  std::vector<uint8_t> expected = {
+      0x35, 0x23, 0x36, 0x00, 0x20,
+      0x09, 0x00, 0x00, 0x0a, (uint8_t)(handle >> 24), (uint8_t)(handle >> 16),
+      (uint8_t)(handle >> 8), (uint8_t)handle,
+      0x09, 0x00, 0x01, 0x35, 0x03, 0x19, 0x11, 0x01,
+      0x09, 0x01, 0x00, 0x25, 0x0b,
+  };
+  expected.insert(expected.end(), name, name + strlen(name));
+  ASSERT_EQ(expected, get_attr_lists(p_ccb));
+  ASSERT_TRUE(p_ccb->cont_info.is_cached_rsp);
+
+  // Served from the cache
+  ASSERT_EQ(expected, get_attr_lists(p_ccb));
+
+  // Changing the record drops the cached response
+  const char* provider = "AOSP";
+  ASSERT_TRUE(SDP_AddAttribute(handle, ATTR_ID_PROVIDER_NAME,
+                               TEXT_STR_DESC_TYPE, strlen(provider),
+                               (uint8_t*)provider));
+  expected[1] += 9;
+  expected[4] += 9;
+  expected.insert(expected.end(), {0x09, 0x01, 0x02, 0x25, 0x04});
+  expected.insert(expected.end(), provider, provider + strlen(provider));
+  ASSERT_EQ(expected, get_attr_lists(p_ccb));
+
+  // Bad continuation states are still rejected
+  ASSERT_EQ(-1, send_service_search_attr_req(p_ccb, expected.size() + 1));
+  ASSERT_EQ(SDP_PDU_ERROR_RESPONSE, sdp_rsp[0]);
+
+  sdpu_release_ccb(*p_ccb);
+  sdp_server_clear_rsp_cache();
+}
+
+static int sdp_disc_cmpl_count = 0;
+static tSDP_RESULT sdp_disc_cmpl_result;
+static alarm_callback_t sdp_cached_disc_cb = nullptr;
+static void* sdp_cached_disc_data = nullptr;
+
+static void sdp_disc_cmpl(tSDP_RESULT result) {
+  sdp_disc_cmpl_count++;
+  sdp_disc_cmpl_result = result;
+}
+
+TEST_F(StackSdpMainTest, sdp_service_search_attribute_request_cache) {
+  test::mock::osi_alarm::alarm_set_on_mloop.body =
+      [](alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
+         void* data) {
+        if (interval_ms == 0) {
+          sdp_cached_disc_cb = cb;
+          sdp_cached_disc_data = data;
+        }
+      };
+  sdp_disc_cmpl_count = 0;
+  sdp_cached_disc_cb = nullptr;
+  bluetooth::Uuid uuid = bluetooth::Uuid::From16Bit(0x1101);
+
+  // First discovery, from the peer
+  ASSERT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &uuid, 0,
+                                  nullptr));
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, sdp_disc_cmpl));
+  const int cid = L2CA_ConnectReq2_cid;
+  tCONN_CB* p_ccb = find_ccb(cid, SDP_STATE_CONN_SETUP);
+  ASSERT_NE(p_ccb, nullptr);
+
+  tL2CAP_CFG_INFO cfg;
+  sdp_cb.reg_info.pL2CA_ConfigCfm_Cb(cid, 0, &cfg);
+  ASSERT_EQ(p_ccb->con_state, SDP_STATE_CONNECTED);
+
+  std::vector<uint8_t> rsp = {
+      SDP_PDU_SERVICE_SEARCH_ATTR_RSP, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x0c,
+      0x35, 0x0a, 0x35, 0x08, 0x09, 0x00, 0x01, 0x35, 0x03, 0x19, 0x11, 0x01,
+      0x00,
+  };
+  BT_HDR* p_msg = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + rsp.size());
+  p_msg->offset = 0;
+  p_msg->len = rsp.size();
+  memcpy(p_msg->data, rsp.data(), rsp.size());
+  sdp_cb.reg_info.pL2CA_DataInd_Cb(cid, p_msg);
+  sdp_cb.reg_info.pL2CA_DisconnectCfm_Cb(cid, 0);
+
+  ASSERT_EQ(1, sdp_disc_cmpl_count);
+  ASSERT_EQ(SDP_SUCCESS, sdp_disc_cmpl_result);
+  ASSERT_NE(nullptr, SDP_FindServiceInDb(sdp_db, 0x1101, nullptr));
+  ASSERT_EQ(nullptr, sdp_cached_disc_cb);
+
+  // The same discovery is answered from the cache, without a connection
+  ASSERT_TRUE(SDP_InitDiscoveryDb(sdp_db, BT_DEFAULT_BUFFER_SIZE, 1, &uuid, 0,
+                                  nullptr));
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr, sdp_db, sdp_disc_cmpl));
+  ASSERT_EQ(cid, L2CA_ConnectReq2_cid);
+  ASSERT_NE(nullptr, sdp_cached_disc_cb);
+  ASSERT_EQ(1, sdp_disc_cmpl_count);
+
+  sdp_cached_disc_cb(sdp_cached_disc_data);
+  ASSERT_EQ(2, sdp_disc_cmpl_count);
+  ASSERT_EQ(SDP_SUCCESS, sdp_disc_cmpl_result);
+  ASSERT_NE(nullptr, SDP_FindServiceInDb(sdp_db, 0x1101, nullptr));
+  ASSERT_EQ(nullptr, find_ccb(0, SDP_STATE_CONN_SETUP));
+
+  // But not for another peer
+  const RawAddress addr2 = RawAddress({0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6});
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(addr2, sdp_db, sdp_disc_cmpl));
+  ASSERT_EQ(cid + 1, L2CA_ConnectReq2_cid);
+  p_ccb = find_ccb(L2CA_ConnectReq2_cid, SDP_STATE_CONN_SETUP);
+  ASSERT_NE(p_ccb, nullptr);
+  sdp_disconnect(p_ccb, SDP_SUCCESS);
+
+  sdp_disc_clear_cache();
+  test::mock::osi_alarm::alarm_set_on_mloop = {};
+}
@@ -456,3 +456,45 @@ TEST_F(StackAvdtpTest, avdt_scb_hdl_pkt_no_frag_regression_test3) {
   // thus vt_data.p_pkt will be set to nullptr
   ASSERT_EQ(evt_data.p_pkt, nullptr);
 }
+
+static int sink_data_count = 0;
+static uint16_t sink_data_seq = 0;
+static uint16_t sink_data_len = 0;
+
+// Media packets of the streaming state skip the state table
+TEST_F(StackAvdtpTest, avdt_scb_event_streaming_media_packet) {
+  AvdtpScb* pscb = avdt_scb_by_hdl(scb_handle_);
+  ASSERT_NE(pscb, nullptr);
+  pscb->stream_config.p_sink_data_cback = [](uint8_t handle, BT_HDR* p_pkt,
+                                             uint32_t time_stamp,
+                                             uint8_t m_pt) {
+    sink_data_count++;
+    sink_data_seq = p_pkt->layer_specific;
+    sink_data_len = p_pkt->len;
+    osi_free(p_pkt);
+  };
+  pscb->state = AVDT_SCB_STREAM_ST;
+
+  constexpr uint8_t media_packet[] = {
+      // RTP header, sequence number 0x2a
+      0x80, 0x60, 0x00, 0x2a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02,
+      // Payload
+      0x01, 0x02, 0x03, 0x04,
+  };
+  BT_HDR* p_pkt = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + sizeof(media_packet));
+  p_pkt->len = sizeof(media_packet);
+  p_pkt->offset = 0;
+  p_pkt->layer_specific = AVDT_CHAN_MEDIA;
+  memcpy(p_pkt + 1, media_packet, sizeof(media_packet));
+
+  sink_data_count = 0;
+  avdt_scb_event(pscb, AVDT_SCB_TC_DATA_EVT, (tAVDT_SCB_EVT*)&p_pkt);
+  ASSERT_EQ(1, sink_data_count);
+  ASSERT_EQ(0x2a, sink_data_seq);
+  ASSERT_EQ(4, sink_data_len);
+  ASSERT_EQ(AVDT_SCB_STREAM_ST, pscb->state);
+  ASSERT_EQ(AVDT_SCB_TC_DATA_EVT, pscb->curr_evt);
+
+  pscb->stream_config.p_sink_data_cback = nullptr;
+  pscb->state = AVDT_SCB_IDLE_ST;
+}
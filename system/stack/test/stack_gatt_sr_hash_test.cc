@@ -86,3 +86,71 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
 
   ASSERT_EQ(result_hash, expected_hash);
 }
+
+TEST(GattDatabaseTest, findServiceAndAttributeByHandle) {
+  tGATT_SVC_DB local_db[3];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  gatt_cb.srv_list_info = &srv_list_info;
+
+  // Services with a hole in the handles, not added in handle order
+  const uint16_t start_handles[3] = {0x0030, 0x0001, 0x0010};
+  for (int i = 0; i < 3; i++) {
+    gatts_init_service_db(local_db[i], Uuid::From16Bit(0x1800 + i), true,
+                          start_handles[i], 4);
+    gatts_add_characteristic(local_db[i], GATT_PERM_READ,
+                             GATT_CHAR_PROP_BIT_READ, Uuid::From16Bit(0x2A00));
+    add_item_to_list(srv_list_info, &local_db[i], true);
+    srv_list_info.back().s_hdl = start_handles[i];
+    srv_list_info.back().e_hdl = start_handles[i] + 3;
+  }
+  gatt_sr_update_handle_index();
+
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0000), srv_list_info.end());
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0001)->p_db, &local_db[1]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0004)->p_db, &local_db[1]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0005), srv_list_info.end());
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0012)->p_db, &local_db[2]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0033)->p_db, &local_db[0]);
+  ASSERT_EQ(gatt_sr_find_i_rcb_by_handle(0x0034), srv_list_info.end());
+
+  // The service declaration and the characteristic declaration and value
+  // are there, the handle left over for a descriptor isn't
+  tGATT_SEC_FLAG sec_flag{};
+  for (uint16_t handle = 0x0010; handle < 0x0013; handle++) {
+    ASSERT_EQ(gatts_read_attr_perm_check(&local_db[2], false, handle, sec_flag,
+                                         16),
+              GATT_SUCCESS);
+  }
+  ASSERT_EQ(gatts_read_attr_perm_check(&local_db[2], false, 0x0013, sec_flag,
+                                       16),
+            GATT_NOT_FOUND);
+  ASSERT_EQ(gatts_read_attr_perm_check(&local_db[2], false, 0x000F, sec_flag,
+                                       16),
+            GATT_NOT_FOUND);
+
+  gatt_cb.srv_handle_index.clear();
+  gatt_cb.srv_list_info = nullptr;
+}
+
+TEST(GattDatabaseTest, hashIsComputedWhenNeeded) {
+  tGATT_SVC_DB local_db;
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  gatt_cb.srv_list_info = &srv_list_info;
+  gatt_cb.database_hash = Octet16{};
+  gatt_cb.database_hash_stale = false;
+
+  add_item_to_list(srv_list_info, &local_db, true);
+  gatts_init_service_db(local_db, Uuid::From16Bit(0x1800), true, 0x0001, 3);
+  gatts_add_characteristic(local_db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A00));
+
+  // Not recomputed until the database is marked as changed
+  ASSERT_EQ(gatts_get_database_hash(), Octet16{});
+
+  gatt_cb.database_hash_stale = true;
+  Octet16 expected_hash = gatts_calculate_database_hash(&srv_list_info);
+  ASSERT_EQ(gatts_get_database_hash(), expected_hash);
+  ASSERT_FALSE(gatt_cb.database_hash_stale);
+
+  gatt_cb.srv_list_info = nullptr;
+}
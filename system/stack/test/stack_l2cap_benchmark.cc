@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "common/init_flags.h"
+#include "internal_include/bt_trace.h"
+#include "stack/btm/btm_int_types.h"
+#include "stack/include/l2cdefs.h"
+#include "stack/l2cap/l2c_int.h"
+
+using ::benchmark::State;
+
+tBTM_CB btm_cb;
+extern tL2C_CB l2cb;
+
+// Global trace level referred in the code under test
+uint8_t appl_trace_level = BT_TRACE_LEVEL_NONE;
+
+namespace {
+// A car kit or a phone with a few wearables: 7 ACL links, 32 channels
+constexpr size_t kLinks = 7;
+constexpr size_t kChannelsPerLink[kLinks] = {8, 6, 5, 4, 4, 3, 2};
+
+struct Packet {
+  uint16_t handle;
+  uint16_t cid;
+};
+
+class BM_L2capLookup : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    bluetooth::common::InitFlags::SetAllForTesting();
+    l2c_init();
+
+    // Spread the links and channels over the pools as they are after links
+    // came and went
+    size_t channel = 0;
+    for (size_t link = 0; link < kLinks; link++) {
+      tL2C_LCB& lcb = l2cb.lcb_pool[MAX_L2CAP_LINKS - 1 - 2 * link];
+      lcb.in_use = true;
+      uint16_t handle = static_cast<uint16_t>(0x0040 + 3 * link);
+      l2cu_set_lcb_handle(lcb, handle);
+      for (size_t i = 0; i < kChannelsPerLink[link]; i++, channel++) {
+        tL2C_CCB*& p_ccb =
+            l2cb.ccb_pool[(channel * 7) % MAX_L2CAP_CHANNELS];
+        p_ccb = new tL2C_CCB{};
+        p_ccb->in_use = true;
+        p_ccb->p_lcb = &lcb;
+        p_ccb->local_cid = static_cast<uint16_t>(L2CAP_BASE_APPL_CID +
+                                                 (&p_ccb - &l2cb.ccb_pool[0]));
+        packets_.push_back({handle, p_ccb->local_cid});
+      }
+    }
+  }
+
+  void TearDown(State& st) override {
+    l2c_free();
+    packets_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::vector<Packet> packets_;
+};
+}  // namespace
+
+// Find the link and the channel of one received packet on every channel
+BENCHMARK_DEFINE_F(BM_L2capLookup, receive_path)(State& state) {
+  for (auto _ : state) {
+    for (const auto& packet : packets_) {
+      tL2C_LCB* p_lcb = l2cu_find_lcb_by_handle(packet.handle);
+      tL2C_CCB* p_ccb = l2cu_find_ccb_by_cid(p_lcb, packet.cid);
+      ::benchmark::DoNotOptimize(p_ccb);
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          packets_.size());
+}
+
+BENCHMARK_REGISTER_F(BM_L2capLookup, receive_path);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
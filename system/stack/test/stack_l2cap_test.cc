@@ -80,6 +80,102 @@ TEST_F(StackL2capTest, l2cble_process_data_length_change_event) {
   ASSERT_EQ(0x001b, l2cb.lcb_pool[0].tx_data_len);
 }
 
+TEST_F(StackL2capTest, l2cble_resolve_conn_params) {
+  tL2C_LCB& lcb = l2cb.lcb_pool[0];
+
+  // Default parameters without any request
+  tL2C_BLE_CONN_PARAMS params = l2cble_resolve_conn_params(lcb);
+  ASSERT_EQ(BTM_BLE_CONN_INT_MIN_DEF, params.min_int);
+  ASSERT_EQ(BTM_BLE_CONN_INT_MAX_DEF, params.max_int);
+  ASSERT_EQ(BTM_BLE_CONN_TIMEOUT_DEF, params.timeout);
+
+  // A single request is applied as is
+  lcb.workload_params[L2CA_BLE_WORKLOAD_HID] = {
+      .min_int = 9,
+      .max_int = 12,
+      .latency = 20,
+      .timeout = 300,
+      .min_ce_len = 0,
+      .max_ce_len = 0,
+  };
+  lcb.workload_mask = 1 << L2CA_BLE_WORKLOAD_HID;
+  params = l2cble_resolve_conn_params(lcb);
+  ASSERT_EQ(9, params.min_int);
+  ASSERT_EQ(12, params.max_int);
+  ASSERT_EQ(20, params.latency);
+  ASSERT_EQ(300, params.timeout);
+
+  // The most demanding of the requests win
+  lcb.workload_params[L2CA_BLE_WORKLOAD_AUDIO] = {
+      .min_int = 16,
+      .max_int = 16,
+      .latency = 10,
+      .timeout = 100,
+      .min_ce_len = 4,
+      .max_ce_len = 8,
+  };
+  lcb.workload_mask |= 1 << L2CA_BLE_WORKLOAD_AUDIO;
+  params = l2cble_resolve_conn_params(lcb);
+  ASSERT_EQ(9, params.min_int);
+  ASSERT_EQ(12, params.max_int);
+  ASSERT_EQ(10, params.latency);
+  ASSERT_EQ(300, params.timeout);
+  ASSERT_EQ(4, params.min_ce_len);
+  ASSERT_EQ(8, params.max_ce_len);
+
+  // Withdrawn requests are not
+  lcb.workload_mask = 1 << L2CA_BLE_WORKLOAD_AUDIO;
+  params = l2cble_resolve_conn_params(lcb);
+  ASSERT_EQ(16, params.min_int);
+  ASSERT_EQ(16, params.max_int);
+  ASSERT_EQ(100, params.timeout);
+}
+
+TEST_F(StackL2capTest, l2cu_find_lcb_by_handle) {
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0001));
+
+  l2cb.lcb_pool[3].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[3], 0x0001);
+  l2cb.lcb_pool[5].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[5], 0x0002);
+  ASSERT_EQ(&l2cb.lcb_pool[3], l2cu_find_lcb_by_handle(0x0001));
+  ASSERT_EQ(&l2cb.lcb_pool[5], l2cu_find_lcb_by_handle(0x0002));
+
+  // Released links and links given another handle are not found any more
+  l2cb.lcb_pool[3].in_use = false;
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0001));
+  l2cu_set_lcb_handle(l2cb.lcb_pool[5], 0x0003);
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0002));
+  ASSERT_EQ(&l2cb.lcb_pool[5], l2cu_find_lcb_by_handle(0x0003));
+
+  // A handle reused by another link
+  l2cb.lcb_pool[0].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[0], 0x0001);
+  ASSERT_EQ(&l2cb.lcb_pool[0], l2cu_find_lcb_by_handle(0x0001));
+}
+
+TEST_F(StackL2capTest, l2cu_allocate_ccb_on_demand) {
+  ASSERT_EQ(0, l2cb.num_allocated_ccbs);
+  ASSERT_EQ(nullptr, l2cu_find_ccb_by_cid(nullptr, L2CAP_BASE_APPL_CID));
+
+  tL2C_CCB* p_ccb = l2cu_allocate_ccb(nullptr, 0);
+  ASSERT_NE(nullptr, p_ccb);
+  ASSERT_EQ(L2CAP_BASE_APPL_CID, p_ccb->local_cid);
+  ASSERT_EQ(p_ccb, l2cu_find_ccb_by_cid(nullptr, L2CAP_BASE_APPL_CID));
+  ASSERT_EQ(1, l2cb.num_allocated_ccbs);
+
+  l2cu_release_ccb(p_ccb);
+  ASSERT_EQ(nullptr, l2cu_find_ccb_by_cid(nullptr, L2CAP_BASE_APPL_CID));
+  ASSERT_EQ(1, l2cb.num_free_ccbs);
+
+  // The local CID of a released channel is not given again right away
+  tL2C_CCB* p_next_ccb = l2cu_allocate_ccb(nullptr, 0);
+  ASSERT_NE(nullptr, p_next_ccb);
+  ASSERT_EQ(L2CAP_BASE_APPL_CID + 1, p_next_ccb->local_cid);
+  ASSERT_EQ(2, l2cb.num_allocated_ccbs);
+  l2cu_release_ccb(p_next_ccb);
+}
+
 class StackL2capChannelTest : public StackL2capTest {
  protected:
   void SetUp() override { StackL2capTest::SetUp(); }
@@ -403,6 +403,39 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+// The fixed window multiplication of the base point gives the same points as
+// the NAF multiplication
+TEST(SmpEccMultiplicationTest, test_base_point_multiplication) {
+  p_256_init_curve();
+
+  uint32_t seed = 0x2468ace0;
+  for (int i = 0; i < 50; i++) {
+    uint32_t n[KEY_LENGTH_DWORDS_P256];
+    for (auto& word : n) {
+      seed = seed * 1664525 + 1013904223;
+      word = seed;
+    }
+    // The smallest and largest digits in all the windows
+    if (i == 0) {
+      memset(n, 0, sizeof(n));
+      n[0] = 1;
+    } else if (i == 1) {
+      memset(n, 0xff, sizeof(n));
+      n[7] = 0x7fffffff;
+    }
+
+    uint32_t n_copy[KEY_LENGTH_DWORDS_P256];
+    memcpy(n_copy, n, sizeof(n));
+    Point expected;
+    ECC_PointMult(&expected, &(curve_p256.G), n_copy);
+
+    Point q;
+    ECC_PointMult_Base(&q, n);
+    EXPECT_EQ(0, memcmp(expected.x, q.x, sizeof(q.x))) << "at iteration " << i;
+    EXPECT_EQ(0, memcmp(expected.y, q.y, sizeof(q.y))) << "at iteration " << i;
+  }
+}
+
 TEST(SmpStatusText, smp_status_text) {
   std::vector<std::pair<tSMP_STATUS, std::string>> status = {
       std::make_pair(SMP_SUCCESS, "SMP_SUCCESS"),
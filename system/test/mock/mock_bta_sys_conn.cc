@@ -48,6 +48,12 @@ void bta_sys_app_open(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {
 void bta_sys_busy(uint8_t id, uint8_t app_id, const RawAddress& peer_addr) {
   inc_func_call_count(__func__);
 }
+void bta_sys_burst_register(tBTA_SYS_BURST_CBACK* p_cback) {
+  inc_func_call_count(__func__);
+}
+void bta_sys_expect_burst(uint8_t id, const RawAddress& peer_addr) {
+  inc_func_call_count(__func__);
+}
 void bta_sys_chg_ssr_config(uint8_t id, uint8_t app_id, uint16_t max_latency,
                             uint16_t min_tout) {
   inc_func_call_count(__func__);
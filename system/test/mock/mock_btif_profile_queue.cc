@@ -60,9 +60,9 @@ bt_status_t btif_queue_connect_next::return_value = BT_STATUS_SUCCESS;
 }  // namespace test
 
 // Mocked functions, if any
-void btif_queue_advance() {
+void btif_queue_advance(const RawAddress& bda) {
   inc_func_call_count(__func__);
-  test::mock::btif_profile_queue::btif_queue_advance();
+  test::mock::btif_profile_queue::btif_queue_advance(bda);
 }
 void btif_queue_cleanup(uint16_t uuid) {
   inc_func_call_count(__func__);
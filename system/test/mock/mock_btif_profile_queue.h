@@ -59,11 +59,11 @@ namespace btif_profile_queue {
 
 // Shared state between mocked functions and tests
 // Name: btif_queue_advance
-// Params:
+// Params: const RawAddress& bda
 // Return: void
 struct btif_queue_advance {
-  std::function<void()> body{[]() {}};
-  void operator()() { body(); };
+  std::function<void(const RawAddress& bda)> body{[](const RawAddress& bda) {}};
+  void operator()(const RawAddress& bda) { body(bda); };
 };
 extern struct btif_queue_advance btif_queue_advance;
 
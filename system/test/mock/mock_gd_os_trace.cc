@@ -0,0 +1,30 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gd/os/trace.h"
+
+namespace bluetooth {
+namespace os {
+
+const char* TraceTrackText(TraceTrack track) { return ""; }
+void TraceBegin(TraceTrack track, const char* name) {}
+void TraceEnd(TraceTrack track) {}
+void TraceInstant(TraceTrack track, const char* name, int64_t value) {}
+void TraceCounter(TraceTrack track, const char* name, int64_t value) {}
+void DumpTrace(int fd) {}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -88,3 +88,4 @@ bluetooth::shim::BtifConfigInterface::GetPersistentDevices() {
 void bluetooth::shim::BtifConfigInterface::
     ConvertEncryptOrDecryptKeyIfNeeded(){};
 void bluetooth::shim::BtifConfigInterface::Clear(){};
+void bluetooth::shim::BtifConfigInterface::Dump(int fd){};
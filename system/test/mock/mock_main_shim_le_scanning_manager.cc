@@ -35,6 +35,9 @@
   return nullptr;
 }
 void bluetooth::shim::init_scanning_manager() { inc_func_call_count(__func__); }
+void bluetooth::shim::shutdown_scanning_manager() {
+  inc_func_call_count(__func__);
+}
 
 bool bluetooth::shim::is_ad_type_filter_supported() {
   inc_func_call_count(__func__);
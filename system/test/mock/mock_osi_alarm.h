@@ -175,6 +175,18 @@ struct alarm_set_on_mloop {
 };
 extern struct alarm_set_on_mloop alarm_set_on_mloop;
 
+// Name: alarm_set_slack
+// Params: alarm_t* alarm, uint64_t slack_ms
+// Return: void
+struct alarm_set_slack {
+  std::function<void(alarm_t* alarm, uint64_t slack_ms)> body{
+      [](alarm_t* alarm, uint64_t slack_ms) {}};
+  void operator()(alarm_t* alarm, uint64_t slack_ms) {
+    body(alarm, slack_ms);
+  };
+};
+extern struct alarm_set_slack alarm_set_slack;
+
 }  // namespace osi_alarm
 }  // namespace mock
 }  // namespace test
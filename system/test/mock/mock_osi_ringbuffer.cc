@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:8
+ *   Functions generated:11
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -44,6 +44,9 @@ struct ringbuffer_insert ringbuffer_insert;
 struct ringbuffer_peek ringbuffer_peek;
 struct ringbuffer_pop ringbuffer_pop;
 struct ringbuffer_size ringbuffer_size;
+struct ringbuffer_reserve ringbuffer_reserve;
+struct ringbuffer_commit ringbuffer_commit;
+struct ringbuffer_peek_span ringbuffer_peek_span;
 
 }  // namespace osi_ringbuffer
 }  // namespace mock
@@ -83,5 +86,19 @@ size_t ringbuffer_size(const ringbuffer_t* rb) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_size(rb);
 }
+size_t ringbuffer_reserve(ringbuffer_t* rb, size_t length,
+                          ringbuffer_span_t* span) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_reserve(rb, length, span);
+}
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_commit(rb, length);
+}
+size_t ringbuffer_peek_span(const ringbuffer_t* rb, size_t length,
+                            ringbuffer_span_t* span) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_peek_span(rb, length, span);
+}
 // Mocked functions complete
 // END mockcify generation
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:8
+ *   Functions generated:11
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -148,6 +148,51 @@ struct ringbuffer_size {
 };
 extern struct ringbuffer_size ringbuffer_size;
 
+// Name: ringbuffer_reserve
+// Params: ringbuffer_t* rb, size_t length, ringbuffer_span_t* span
+// Return: size_t
+struct ringbuffer_reserve {
+  size_t return_value{0};
+  std::function<size_t(ringbuffer_t* rb, size_t length,
+                       ringbuffer_span_t* span)>
+      body{[this](ringbuffer_t* rb, size_t length, ringbuffer_span_t* span) {
+        return return_value;
+      }};
+  size_t operator()(ringbuffer_t* rb, size_t length, ringbuffer_span_t* span) {
+    return body(rb, length, span);
+  };
+};
+extern struct ringbuffer_reserve ringbuffer_reserve;
+
+// Name: ringbuffer_commit
+// Params: ringbuffer_t* rb, size_t length
+// Return: size_t
+struct ringbuffer_commit {
+  size_t return_value{0};
+  std::function<size_t(ringbuffer_t* rb, size_t length)> body{
+      [this](ringbuffer_t* rb, size_t length) { return return_value; }};
+  size_t operator()(ringbuffer_t* rb, size_t length) {
+    return body(rb, length);
+  };
+};
+extern struct ringbuffer_commit ringbuffer_commit;
+
+// Name: ringbuffer_peek_span
+// Params: const ringbuffer_t* rb, size_t length, ringbuffer_span_t* span
+// Return: size_t
+struct ringbuffer_peek_span {
+  size_t return_value{0};
+  std::function<size_t(const ringbuffer_t* rb, size_t length,
+                       ringbuffer_span_t* span)>
+      body{[this](const ringbuffer_t* rb, size_t length,
+                  ringbuffer_span_t* span) { return return_value; }};
+  size_t operator()(const ringbuffer_t* rb, size_t length,
+                    ringbuffer_span_t* span) {
+    return body(rb, length, span);
+  };
+};
+extern struct ringbuffer_peek_span ringbuffer_peek_span;
+
 }  // namespace osi_ringbuffer
 }  // namespace mock
 }  // namespace test
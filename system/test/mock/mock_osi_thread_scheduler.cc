@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:3
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -38,6 +38,7 @@ namespace osi_thread_scheduler {
 // Function state capture and return values, if needed
 struct thread_scheduler_enable_real_time thread_scheduler_enable_real_time;
 struct thread_scheduler_get_priority_range thread_scheduler_get_priority_range;
+struct thread_scheduler_apply_policy thread_scheduler_apply_policy;
 
 }  // namespace osi_thread_scheduler
 }  // namespace mock
@@ -54,5 +55,11 @@ bool thread_scheduler_get_priority_range(int& min, int& max) {
   return test::mock::osi_thread_scheduler::thread_scheduler_get_priority_range(
       min, max);
 }
+bool thread_scheduler_apply_policy(pid_t linux_tid, const char* thread_name,
+                                   int real_time_priority) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_thread_scheduler::thread_scheduler_apply_policy(
+      linux_tid, thread_name, real_time_priority);
+}
 // Mocked functions complete
 // END mockcify generation
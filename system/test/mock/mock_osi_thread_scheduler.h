@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:3
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -68,6 +68,22 @@ struct thread_scheduler_get_priority_range {
 extern struct thread_scheduler_get_priority_range
     thread_scheduler_get_priority_range;
 
+// Name: thread_scheduler_apply_policy
+// Params: pid_t linux_tid, const char* thread_name, int real_time_priority
+// Return: bool
+struct thread_scheduler_apply_policy {
+  bool return_value{true};
+  std::function<bool(pid_t linux_tid, const char* thread_name,
+                     int real_time_priority)>
+      body{[this](pid_t linux_tid, const char* thread_name,
+                  int real_time_priority) { return return_value; }};
+  bool operator()(pid_t linux_tid, const char* thread_name,
+                  int real_time_priority) {
+    return body(linux_tid, thread_name, real_time_priority);
+  };
+};
+extern struct thread_scheduler_apply_policy thread_scheduler_apply_policy;
+
 }  // namespace osi_thread_scheduler
 }  // namespace mock
 }  // namespace test
@@ -42,15 +42,16 @@ struct wakelock_debug_dump wakelock_debug_dump;
 struct wakelock_release wakelock_release;
 struct wakelock_set_os_callouts wakelock_set_os_callouts;
 struct wakelock_set_paths wakelock_set_paths;
+struct wakelock_set_release_delay wakelock_set_release_delay;
 
 }  // namespace osi_wakelock
 }  // namespace mock
 }  // namespace test
 
 // Mocked functions, if any
-bool wakelock_acquire(void) {
+bool wakelock_acquire(const char* owner) {
   inc_func_call_count(__func__);
-  return test::mock::osi_wakelock::wakelock_acquire();
+  return test::mock::osi_wakelock::wakelock_acquire(owner);
 }
 void wakelock_cleanup(void) {
   inc_func_call_count(__func__);
@@ -60,9 +61,9 @@ void wakelock_debug_dump(int fd) {
   inc_func_call_count(__func__);
   test::mock::osi_wakelock::wakelock_debug_dump(fd);
 }
-bool wakelock_release(void) {
+bool wakelock_release(const char* owner) {
   inc_func_call_count(__func__);
-  return test::mock::osi_wakelock::wakelock_release();
+  return test::mock::osi_wakelock::wakelock_release(owner);
 }
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   inc_func_call_count(__func__);
@@ -72,5 +73,9 @@ void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   inc_func_call_count(__func__);
   test::mock::osi_wakelock::wakelock_set_paths(lock_path, unlock_path);
 }
+void wakelock_set_release_delay(uint64_t delay_ms) {
+  inc_func_call_count(__func__);
+  test::mock::osi_wakelock::wakelock_set_release_delay(delay_ms);
+}
 // Mocked functions complete
 // END mockcify generation
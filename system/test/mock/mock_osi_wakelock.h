@@ -66,12 +66,13 @@ namespace osi_wakelock {
 
 // Shared state between mocked functions and tests
 // Name: wakelock_acquire
-// Params: void
+// Params: const char* owner
 // Return: bool
 struct wakelock_acquire {
   bool return_value{false};
-  std::function<bool(void)> body{[this](void) { return return_value; }};
-  bool operator()(void) { return body(); };
+  std::function<bool(const char* owner)> body{
+      [this](const char* owner) { return return_value; }};
+  bool operator()(const char* owner) { return body(owner); };
 };
 extern struct wakelock_acquire wakelock_acquire;
 
@@ -94,12 +95,13 @@ struct wakelock_debug_dump {
 extern struct wakelock_debug_dump wakelock_debug_dump;
 
 // Name: wakelock_release
-// Params: void
+// Params: const char* owner
 // Return: bool
 struct wakelock_release {
   bool return_value{false};
-  std::function<bool(void)> body{[this](void) { return return_value; }};
-  bool operator()(void) { return body(); };
+  std::function<bool(const char* owner)> body{
+      [this](const char* owner) { return return_value; }};
+  bool operator()(const char* owner) { return body(owner); };
 };
 extern struct wakelock_release wakelock_release;
 
@@ -125,6 +127,15 @@ struct wakelock_set_paths {
 };
 extern struct wakelock_set_paths wakelock_set_paths;
 
+// Name: wakelock_set_release_delay
+// Params: uint64_t delay_ms
+// Return: void
+struct wakelock_set_release_delay {
+  std::function<void(uint64_t delay_ms)> body{[](uint64_t delay_ms) {}};
+  void operator()(uint64_t delay_ms) { body(delay_ms); };
+};
+extern struct wakelock_set_release_delay wakelock_set_release_delay;
+
 }  // namespace osi_wakelock
 }  // namespace mock
 }  // namespace test
@@ -93,6 +93,7 @@ struct btm_get_acl_disc_reason_code btm_get_acl_disc_reason_code;
 struct btm_is_acl_locally_initiated btm_is_acl_locally_initiated;
 struct BTM_GetHCIConnHandle BTM_GetHCIConnHandle;
 struct BTM_GetMaxPacketSize BTM_GetMaxPacketSize;
+struct BTM_GetAclTrafficBytes BTM_GetAclTrafficBytes;
 struct BTM_GetNumAclLinks BTM_GetNumAclLinks;
 struct acl_get_supported_packet_types acl_get_supported_packet_types;
 struct BTM_GetPeerSCA BTM_GetPeerSCA;
@@ -391,6 +392,11 @@ uint16_t BTM_GetMaxPacketSize(const RawAddress& addr) {
   inc_func_call_count(__func__);
   return test::mock::stack_acl::BTM_GetMaxPacketSize(addr);
 }
+uint64_t BTM_GetAclTrafficBytes(const RawAddress& remote_bda,
+                                tBT_TRANSPORT transport) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_acl::BTM_GetAclTrafficBytes(remote_bda, transport);
+}
 uint16_t BTM_GetNumAclLinks(void) {
   inc_func_call_count(__func__);
   return test::mock::stack_acl::BTM_GetNumAclLinks();
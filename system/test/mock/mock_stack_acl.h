@@ -537,6 +537,20 @@ struct BTM_GetMaxPacketSize {
   uint16_t operator()(const RawAddress& addr) { return body(addr); };
 };
 extern struct BTM_GetMaxPacketSize BTM_GetMaxPacketSize;
+// Name: BTM_GetAclTrafficBytes
+// Params: const RawAddress& remote_bda, tBT_TRANSPORT transport
+// Returns: uint64_t
+struct BTM_GetAclTrafficBytes {
+  std::function<uint64_t(const RawAddress& remote_bda,
+                         tBT_TRANSPORT transport)>
+      body{[](const RawAddress& remote_bda, tBT_TRANSPORT transport) {
+        return 0;
+      }};
+  uint64_t operator()(const RawAddress& remote_bda, tBT_TRANSPORT transport) {
+    return body(remote_bda, transport);
+  };
+};
+extern struct BTM_GetAclTrafficBytes BTM_GetAclTrafficBytes;
 // Name: BTM_GetNumAclLinks
 // Params: void
 // Returns: uint16_t
@@ -157,6 +157,11 @@ bool btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data,
   inc_func_call_count(__func__);
   return false;
 }
+bool btm_ble_get_appearance_as_cod(AdvertiseDataIndex const& data,
+                                   DEV_CLASS dev_class) {
+  inc_func_call_count(__func__);
+  return false;
+}
 void btm_ble_process_adv_addr(RawAddress& bda, tBLE_ADDR_TYPE* addr_type) {
   inc_func_call_count(__func__);
 }
@@ -46,6 +46,9 @@ struct GATTC_ConfigureMTU GATTC_ConfigureMTU;
 struct GATTC_Discover GATTC_Discover;
 struct GATTC_ExecuteWrite GATTC_ExecuteWrite;
 struct GATTC_Read GATTC_Read;
+struct GATTC_IsReadMultipleVariableLengthSupported
+    GATTC_IsReadMultipleVariableLengthSupported;
+struct GATTC_GetNumBearers GATTC_GetNumBearers;
 struct GATTC_SendHandleValueConfirm GATTC_SendHandleValueConfirm;
 struct GATTC_Write GATTC_Write;
 struct GATTS_AddService GATTS_AddService;
@@ -66,6 +69,7 @@ struct GATT_SetIdleTimeout GATT_SetIdleTimeout;
 struct GATT_StartIf GATT_StartIf;
 // struct gatt_add_an_item_to_list gatt_add_an_item_to_list;
 struct is_active_service is_active_service;
+struct GATT_Dumpsys GATT_Dumpsys;
 
 }  // namespace stack_gatt_api
 }  // namespace mock
@@ -85,6 +89,8 @@ tGATT_STATUS GATTC_ConfigureMTU::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Discover::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_ExecuteWrite::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Read::return_value = GATT_SUCCESS;
+bool GATTC_IsReadMultipleVariableLengthSupported::return_value = false;
+uint8_t GATTC_GetNumBearers::return_value = 1;
 tGATT_STATUS GATTC_SendHandleValueConfirm::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Write::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTS_AddService::return_value = GATT_SUCCESS;
@@ -148,6 +154,15 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTC_Read(conn_id, type, p_read);
 }
+bool GATTC_IsReadMultipleVariableLengthSupported(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::
+      GATTC_IsReadMultipleVariableLengthSupported(conn_id);
+}
+uint8_t GATTC_GetNumBearers(uint16_t conn_id) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTC_GetNumBearers(conn_id);
+}
 tGATT_STATUS GATTC_SendHandleValueConfirm(uint16_t conn_id, uint16_t cid) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTC_SendHandleValueConfirm(conn_id, cid);
@@ -255,6 +270,10 @@ bool is_active_service(const Uuid& app_uuid128, Uuid* p_svc_uuid,
   return test::mock::stack_gatt_api::is_active_service(app_uuid128, p_svc_uuid,
                                                        start_handle);
 }
+void GATT_Dumpsys(int fd) {
+  inc_func_call_count(__func__);
+  test::mock::stack_gatt_api::GATT_Dumpsys(fd);
+}
 // Mocked functions complete
 //
 bool GATT_Connect(tGATT_IF gatt_if, const RawAddress& bd_addr,
@@ -177,6 +177,29 @@ struct GATTC_Read {
 };
 extern struct GATTC_Read GATTC_Read;
 
+// Name: GATTC_IsReadMultipleVariableLengthSupported
+// Params: uint16_t conn_id
+// Return: bool
+struct GATTC_IsReadMultipleVariableLengthSupported {
+  static bool return_value;
+  std::function<bool(uint16_t conn_id)> body{
+      [](uint16_t conn_id) { return return_value; }};
+  bool operator()(uint16_t conn_id) { return body(conn_id); };
+};
+extern struct GATTC_IsReadMultipleVariableLengthSupported
+    GATTC_IsReadMultipleVariableLengthSupported;
+
+// Name: GATTC_GetNumBearers
+// Params: uint16_t conn_id
+// Return: uint8_t
+struct GATTC_GetNumBearers {
+  static uint8_t return_value;
+  std::function<uint8_t(uint16_t conn_id)> body{
+      [](uint16_t conn_id) { return return_value; }};
+  uint8_t operator()(uint16_t conn_id) { return body(conn_id); };
+};
+extern struct GATTC_GetNumBearers GATTC_GetNumBearers;
+
 // Name: GATTC_SendHandleValueConfirm
 // Params: uint16_t conn_id, uint16_t cid
 // Return: tGATT_STATUS
@@ -469,6 +492,15 @@ struct is_active_service {
 };
 extern struct is_active_service is_active_service;
 
+// Name: GATT_Dumpsys
+// Params: int fd
+// Return: void
+struct GATT_Dumpsys {
+  std::function<void(int fd)> body{[](int fd) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct GATT_Dumpsys GATT_Dumpsys;
+
 }  // namespace stack_gatt_api
 }  // namespace mock
 }  // namespace test
@@ -291,5 +291,6 @@ uint16_t L2CA_LeCreditThreshold() {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_api::L2CA_LeCreditThreshold();
 }
+void L2CA_Dumpsys(int fd) { inc_func_call_count(__func__); }
 
 // END mockcify generation
@@ -48,6 +48,9 @@ namespace stack_l2cap_ble {
 
 // Function state capture and return values, if needed
 struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+struct L2CA_RequestBleConnParams L2CA_RequestBleConnParams;
+struct L2CA_ReleaseBleConnParams L2CA_ReleaseBleConnParams;
+struct L2CA_SetBleBulkTransfer L2CA_SetBleBulkTransfer;
 struct L2CA_EnableUpdateBleConnParams L2CA_EnableUpdateBleConnParams;
 struct L2CA_ConsolidateParams L2CA_ConsolidateParams;
 struct L2CA_GetBleConnRole L2CA_GetBleConnRole;
@@ -88,6 +91,26 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
   return test::mock::stack_l2cap_ble::L2CA_UpdateBleConnParams(
       rem_bda, min_int, max_int, latency, timeout, min_ce_len, max_ce_len);
 }
+bool L2CA_RequestBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload, uint16_t min_int,
+                               uint16_t max_int, uint16_t latency,
+                               uint16_t timeout, uint16_t min_ce_len,
+                               uint16_t max_ce_len) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_RequestBleConnParams(
+      rem_bda, workload, min_int, max_int, latency, timeout, min_ce_len,
+      max_ce_len);
+}
+bool L2CA_ReleaseBleConnParams(const RawAddress& rem_bda,
+                               tL2CA_BLE_WORKLOAD workload) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_ReleaseBleConnParams(rem_bda,
+                                                                workload);
+}
+bool L2CA_SetBleBulkTransfer(const RawAddress& rem_bda, bool active) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_l2cap_ble::L2CA_SetBleBulkTransfer(rem_bda, active);
+}
 bool L2CA_EnableUpdateBleConnParams(const RawAddress& rem_bda, bool enable) {
   inc_func_call_count(__func__);
   return test::mock::stack_l2cap_ble::L2CA_EnableUpdateBleConnParams(rem_bda,
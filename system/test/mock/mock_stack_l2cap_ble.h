@@ -68,6 +68,52 @@ struct L2CA_UpdateBleConnParams {
   };
 };
 extern struct L2CA_UpdateBleConnParams L2CA_UpdateBleConnParams;
+// Name: L2CA_RequestBleConnParams
+// Params: const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload,
+// uint16_t min_int, uint16_t max_int, uint16_t latency, uint16_t timeout,
+// uint16_t min_ce_len, uint16_t max_ce_len
+// Returns: bool
+struct L2CA_RequestBleConnParams {
+  std::function<bool(const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload,
+                     uint16_t min_int, uint16_t max_int, uint16_t latency,
+                     uint16_t timeout, uint16_t min_ce_len,
+                     uint16_t max_ce_len)>
+      body{[](const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload,
+              uint16_t min_int, uint16_t max_int, uint16_t latency,
+              uint16_t timeout, uint16_t min_ce_len,
+              uint16_t max_ce_len) { return false; }};
+  bool operator()(const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload,
+                  uint16_t min_int, uint16_t max_int, uint16_t latency,
+                  uint16_t timeout, uint16_t min_ce_len, uint16_t max_ce_len) {
+    return body(rem_bda, workload, min_int, max_int, latency, timeout,
+                min_ce_len, max_ce_len);
+  };
+};
+extern struct L2CA_RequestBleConnParams L2CA_RequestBleConnParams;
+// Name: L2CA_ReleaseBleConnParams
+// Params: const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload
+// Returns: bool
+struct L2CA_ReleaseBleConnParams {
+  std::function<bool(const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload)>
+      body{[](const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload) {
+        return false;
+      }};
+  bool operator()(const RawAddress& rem_bda, tL2CA_BLE_WORKLOAD workload) {
+    return body(rem_bda, workload);
+  };
+};
+extern struct L2CA_ReleaseBleConnParams L2CA_ReleaseBleConnParams;
+// Name: L2CA_SetBleBulkTransfer
+// Params: const RawAddress& rem_bda, bool active
+// Returns: bool
+struct L2CA_SetBleBulkTransfer {
+  std::function<bool(const RawAddress& rem_bda, bool active)> body{
+      [](const RawAddress& rem_bda, bool active) { return false; }};
+  bool operator()(const RawAddress& rem_bda, bool active) {
+    return body(rem_bda, active);
+  };
+};
+extern struct L2CA_SetBleBulkTransfer L2CA_SetBleBulkTransfer;
 // Name: L2CA_EnableUpdateBleConnParams
 // Params: const RawAddress& rem_bda, bool enable
 // Returns: bool
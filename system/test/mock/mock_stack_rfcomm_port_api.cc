@@ -62,6 +62,10 @@ int PORT_FlowControl_MaxCredit(uint16_t handle, bool enable) {
   inc_func_call_count(__func__);
   return 0;
 }
+int PORT_SetTxCoalescing(uint16_t handle, uint16_t delay_ms) {
+  inc_func_call_count(__func__);
+  return 0;
+}
 int PORT_GetState(uint16_t handle, tPORT_STATE* p_settings) {
   inc_func_call_count(__func__);
   return 0;
@@ -419,6 +419,9 @@ void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
   fake_osi_alarm_set_on_mloop_.cb = cb;
   fake_osi_alarm_set_on_mloop_.data = data;
 }
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms) {
+  inc_func_call_count(__func__);
+}
 
 int osi_rand(void) {
   inc_func_call_count(__func__);
@@ -600,6 +603,20 @@ size_t ringbuffer_size(const ringbuffer_t* rb) {
   inc_func_call_count(__func__);
   return 0;
 }
+size_t ringbuffer_reserve(ringbuffer_t* rb, size_t length,
+                          ringbuffer_span_t* span) {
+  inc_func_call_count(__func__);
+  return 0;
+}
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  inc_func_call_count(__func__);
+  return 0;
+}
+size_t ringbuffer_peek_span(const ringbuffer_t* rb, size_t length,
+                            ringbuffer_span_t* span) {
+  inc_func_call_count(__func__);
+  return 0;
+}
 void ringbuffer_free(ringbuffer_t* rb) { inc_func_call_count(__func__); }
 
 bool osi_property_get_bool(const char* key, bool default_value) {
@@ -626,11 +643,11 @@ int32_t osi_property_get_int32(const char* key, int32_t default_value) {
   return 0;
 }
 
-bool wakelock_acquire(void) {
+bool wakelock_acquire(const char* owner) {
   inc_func_call_count(__func__);
   return false;
 }
-bool wakelock_release(void) {
+bool wakelock_release(const char* owner) {
   inc_func_call_count(__func__);
   return false;
 }
@@ -642,3 +659,6 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   inc_func_call_count(__func__);
 }
+void wakelock_set_release_delay(uint64_t delay_ms) {
+  inc_func_call_count(__func__);
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""
+This script converts a compressed btsnoop log (btsnoop_hci.log.z, written
+when persist.bluetooth.btsnoopcompressed is set) back to a plain btsnoop
+log which can be viewed using standard tools like Wireshark.
+
+The compressed btsnoop log can be described as:
+
+file_header
+repeated {
+  chunk_header
+  deflate {
+    repeated {
+      record_header
+      record_data
+    }
+  }
+}
+
+where the file_header is the btsnoop file header with the 'btsnoopz'
+identification pattern, and the records are plain btsnoop records. The
+chunk headers hold the time range of each chunk, so that a time window is
+extracted without decompressing the chunks outside of it.
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+BTSNOOP_FILE_HEADER = b'btsnoop\x00'
+BTSNOOPZ_FILE_HEADER = b'btsnoopz'
+FILE_HEADER_FORMAT = '>8sII'
+# compressed_length, original_length, packets, first_timestamp, last_timestamp
+CHUNK_HEADER_FORMAT = '>IIIQQ'
+RECORD_HEADER_FORMAT = '>IIIIQ'
+
+# Epoch in microseconds since 01/01/0000.
+BTSNOOP_EPOCH_DELTA = 0x00dcddb30f2f8000
+
+
+def to_btsnoop_timestamp(seconds):
+    """
+  Returns the btsnoop timestamp of |seconds| since the Unix epoch.
+  """
+    return int(seconds * 1000000) + BTSNOOP_EPOCH_DELTA
+
+
+def read_chunks(log):
+    """
+  Yields the offset and the header fields of each chunk of |log|.
+  """
+    offset = struct.calcsize(FILE_HEADER_FORMAT)
+    chunk_header_size = struct.calcsize(CHUNK_HEADER_FORMAT)
+    while offset + chunk_header_size <= len(log):
+        chunk = struct.unpack_from(CHUNK_HEADER_FORMAT, log, offset)
+        offset += chunk_header_size
+        if offset + chunk[0] > len(log):
+            sys.stderr.write('Truncated chunk at offset %d, ignoring the end of the log\n' % offset)
+            return
+        yield offset, chunk
+        offset += chunk[0]
+
+
+def filter_records(records, start, end):
+    """
+  Returns the btsnoop records of |records| between timestamps |start| and |end|.
+  """
+    filtered = bytearray()
+    offset = 0
+    record_header_size = struct.calcsize(RECORD_HEADER_FORMAT)
+    while offset + record_header_size <= len(records):
+        _, length_captured, _, _, timestamp = struct.unpack_from(RECORD_HEADER_FORMAT, records, offset)
+        record_size = record_header_size + length_captured
+        if start <= timestamp <= end:
+            filtered += records[offset:offset + record_size]
+        offset += record_size
+    return filtered
+
+
+def decode_snoopz(log, out, start, end):
+    """
+  Writes the btsnoop records of |log| between timestamps |start| and |end| as a
+  plain btsnoop log to |out|.
+  """
+    _, version, datalink = struct.unpack_from(FILE_HEADER_FORMAT, log)
+    out.write(struct.pack(FILE_HEADER_FORMAT, BTSNOOP_FILE_HEADER, version, datalink))
+    for offset, (compressed_length, _, _, first_timestamp, last_timestamp) in read_chunks(log):
+        if last_timestamp < start or first_timestamp > end:
+            continue
+        records = zlib.decompress(log[offset:offset + compressed_length])
+        if first_timestamp < start or last_timestamp > end:
+            records = filter_records(records, start, end)
+        out.write(records)
+
+
+def print_index(log):
+    """
+  Prints the time range and size of each chunk of |log|.
+  """
+    for offset, (compressed_length, original_length, packets, first_timestamp, last_timestamp) in read_chunks(log):
+        print('offset %10d: %.6f - %.6f, %6d packets, %8d -> %8d bytes' %
+              (offset, (first_timestamp - BTSNOOP_EPOCH_DELTA) / 1000000.0,
+               (last_timestamp - BTSNOOP_EPOCH_DELTA) / 1000000.0, packets, original_length, compressed_length))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a compressed btsnoop log to a plain btsnoop log.')
+    parser.add_argument('log', help='compressed btsnoop log (btsnoop_hci.log.z)')
+    parser.add_argument('--start', type=float, help='start of the time window, in seconds since the Unix epoch')
+    parser.add_argument('--end', type=float, help='end of the time window, in seconds since the Unix epoch')
+    parser.add_argument('--index', action='store_true', help='print the chunks of the log instead of converting it')
+    args = parser.parse_args()
+
+    with open(args.log, 'rb') as f:
+        log = f.read()
+
+    if len(log) < struct.calcsize(FILE_HEADER_FORMAT) or log[:8] != BTSNOOPZ_FILE_HEADER:
+        sys.stderr.write('%s is not a compressed btsnoop log\n' % args.log)
+        sys.exit(1)
+
+    if args.index:
+        print_index(log)
+        sys.exit(0)
+
+    if sys.stdout.isatty():
+        sys.stderr.write('Redirect the output of this script to a file.\n')
+        sys.exit(1)
+
+    start = to_btsnoop_timestamp(args.start) if args.start is not None else 0
+    end = to_btsnoop_timestamp(args.end) if args.end is not None else 2**64 - 1
+    decode_snoopz(log, sys.stdout.buffer, start, end)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A ring buffer in shared memory carrying a byte stream from a single writer
+// process to a single reader process, without going through the kernel for
+// each buffer like the UIPC sockets do. The reader creates the ring and hands
+// its memory and event file descriptors to the writer over a UIPC channel.
+//
+// The writer blocks while the ring is full, the reader never blocks: it reads
+// whatever is available and wakes the writer up, by signaling the eventfd,
+// only when the writer is waiting for room.
+
+struct uipc_shm_t;
+typedef struct uipc_shm_t uipc_shm_t;
+
+// Creates a new ring of at least |capacity| bytes, for the reader side.
+// |capacity| is rounded up to the next power of two. Returns NULL on failure.
+// The caller must free the returned ring with |uipc_shm_free|.
+uipc_shm_t* uipc_shm_new(size_t capacity);
+
+// Maps the ring created by the reader, for the writer side. Takes ownership
+// of |memory_fd| and |event_fd|, that are closed on failure. Returns NULL if
+// the memory doesn't hold a valid ring. The caller must free the returned ring
+// with |uipc_shm_free|.
+uipc_shm_t* uipc_shm_attach(int memory_fd, int event_fd);
+
+// Unmaps the |ring| and closes its file descriptors. |ring| may be NULL.
+void uipc_shm_free(uipc_shm_t* ring);
+
+// Returns the file descriptors to hand to the writer, that must make its own
+// copies of them (e.g. by sending them with SCM_RIGHTS). |ring| may not be
+// NULL.
+int uipc_shm_get_memory_fd(const uipc_shm_t* ring);
+int uipc_shm_get_event_fd(const uipc_shm_t* ring);
+
+// Returns the size of the ring in bytes. |ring| may not be NULL.
+size_t uipc_shm_capacity(const uipc_shm_t* ring);
+
+// Limits the number of bytes the writer may queue to |limit|, which bounds
+// the latency of the stream like the size of a socket buffer does. |limit| is
+// capped to the capacity of the |ring|. Must only be called from the reader.
+void uipc_shm_set_limit(uipc_shm_t* ring, size_t limit);
+
+// Returns the number of bytes written and not read yet. |ring| may not be
+// NULL.
+size_t uipc_shm_length(const uipc_shm_t* ring);
+
+// Writes |len| bytes from |data| to the |ring|, waiting for room for up to
+// |timeout_ms| in total. Returns the number of bytes written, less than |len|
+// if the reader didn't make room in time. Must only be called from the writer.
+size_t uipc_shm_write(uipc_shm_t* ring, const void* data, size_t len,
+                      int timeout_ms);
+
+// Reads up to |len| bytes from the |ring| into |data|. This function never
+// blocks, and returns the number of bytes read. Must only be called from the
+// reader.
+size_t uipc_shm_read(uipc_shm_t* ring, void* data, size_t len);
+
+// Discards the bytes written and not read yet. Must only be called from the
+// reader.
+void uipc_shm_flush(uipc_shm_t* ring);
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udrv/include/uipc_shm.h"
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+static const size_t TEST_RING_SIZE = 1000;
+
+// Attaches to |ring| like the writer process does, with its own copies of the
+// file descriptors
+static uipc_shm_t* attach_writer(uipc_shm_t* ring) {
+  return uipc_shm_attach(dup(uipc_shm_get_memory_fd(ring)),
+                         dup(uipc_shm_get_event_fd(ring)));
+}
+
+static std::vector<uint8_t> make_pattern(size_t len, uint8_t seed) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; i++) data[i] = (uint8_t)(seed + i);
+  return data;
+}
+
+TEST(UipcShmTest, test_new_attach_free) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  EXPECT_EQ(1024u, uipc_shm_capacity(reader));
+
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+  EXPECT_EQ(1024u, uipc_shm_capacity(writer));
+  EXPECT_EQ(0u, uipc_shm_length(writer));
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+  uipc_shm_free(NULL);
+}
+
+TEST(UipcShmTest, test_attach_invalid_memory) {
+  int memory_fd = memfd_create("uipc_shm_test", MFD_CLOEXEC);
+  ASSERT_NE(-1, memory_fd);
+  ASSERT_EQ(0, ftruncate(memory_fd, 4096));
+  int event_fd = dup(memory_fd);
+
+  EXPECT_TRUE(uipc_shm_attach(memory_fd, event_fd) == NULL);
+}
+
+TEST(UipcShmTest, test_write_read_wraparound) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+
+  // Writes and reads across the end of the ring several times
+  for (int i = 0; i < 10; i++) {
+    std::vector<uint8_t> data = make_pattern(700, i);
+    EXPECT_EQ(data.size(), uipc_shm_write(writer, data.data(), data.size(), 0));
+    EXPECT_EQ(data.size(), uipc_shm_length(reader));
+
+    std::vector<uint8_t> read(data.size());
+    EXPECT_EQ(300u, uipc_shm_read(reader, read.data(), 300));
+    EXPECT_EQ(400u, uipc_shm_read(reader, read.data() + 300, 1000));
+    EXPECT_EQ(data, read);
+    EXPECT_EQ(0u, uipc_shm_read(reader, read.data(), read.size()));
+  }
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+}
+
+TEST(UipcShmTest, test_write_full_timeout) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+
+  std::vector<uint8_t> data = make_pattern(2000, 0);
+  EXPECT_EQ(1024u, uipc_shm_write(writer, data.data(), data.size(), 10));
+  EXPECT_EQ(1024u, uipc_shm_length(reader));
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+}
+
+TEST(UipcShmTest, test_set_limit) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+
+  uipc_shm_set_limit(reader, 100);
+  std::vector<uint8_t> data = make_pattern(200, 0);
+  EXPECT_EQ(100u, uipc_shm_write(writer, data.data(), data.size(), 0));
+
+  // The limit is capped to the capacity
+  uipc_shm_set_limit(reader, 1 << 20);
+  EXPECT_EQ(200u, uipc_shm_write(writer, data.data(), data.size(), 0));
+  EXPECT_EQ(300u, uipc_shm_length(reader));
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+}
+
+TEST(UipcShmTest, test_flush) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+
+  std::vector<uint8_t> data = make_pattern(500, 0);
+  EXPECT_EQ(500u, uipc_shm_write(writer, data.data(), data.size(), 0));
+  uipc_shm_flush(reader);
+  EXPECT_EQ(0u, uipc_shm_length(reader));
+
+  std::vector<uint8_t> read(data.size());
+  EXPECT_EQ(0u, uipc_shm_read(reader, read.data(), read.size()));
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+}
+
+TEST(UipcShmTest, test_blocked_writer_woken_by_reader) {
+  uipc_shm_t* reader = uipc_shm_new(TEST_RING_SIZE);
+  ASSERT_TRUE(reader != NULL);
+  uipc_shm_t* writer = attach_writer(reader);
+  ASSERT_TRUE(writer != NULL);
+
+  // Much more than the ring holds, the writer has to wait for the reader
+  std::vector<uint8_t> data = make_pattern(64 * 1024, 0);
+  size_t written = 0;
+  std::thread writer_thread([&]() {
+    written = uipc_shm_write(writer, data.data(), data.size(), 5000);
+  });
+
+  std::vector<uint8_t> read;
+  uint8_t buffer[100];
+  while (read.size() < data.size()) {
+    size_t count = uipc_shm_read(reader, buffer, sizeof(buffer));
+    if (count == 0) {
+      usleep(100);
+      continue;
+    }
+    read.insert(read.end(), buffer, buffer + count);
+  }
+  writer_thread.join();
+
+  EXPECT_EQ(data.size(), written);
+  EXPECT_EQ(data, read);
+
+  uipc_shm_free(writer);
+  uipc_shm_free(reader);
+}
@@ -594,6 +594,60 @@ bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
   return true;
 }
 
+/*******************************************************************************
+ **
+ ** Function         UIPC_SendFds
+ **
+ ** Description      Called to transmit a message over UIPC, along with file
+ **                  descriptors for the peer.
+ **
+ ** Returns          true in case of success, false in case of failure.
+ **
+ ******************************************************************************/
+bool UIPC_SendFds(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, const uint8_t* p_buf,
+                  uint16_t msglen, const int* fds, size_t num_fds) {
+  LOG_DEBUG("UIPC_SendFds : ch_id:%d %d bytes %zu fds", ch_id, msglen,
+            num_fds);
+
+  if (ch_id >= UIPC_CH_NUM || msglen == 0 || num_fds > UIPC_MAX_FDS) {
+    LOG_ERROR("UIPC_SendFds : invalid parameters ch id %d", ch_id);
+    return false;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+
+  struct iovec iov = {
+      .iov_base = const_cast<uint8_t*>(p_buf),
+      .iov_len = msglen,
+  };
+  char control[CMSG_SPACE(sizeof(int) * UIPC_MAX_FDS)];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  if (num_fds > 0) {
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * num_fds);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * num_fds);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * num_fds);
+  }
+
+  ssize_t ret;
+  OSI_NO_INTR(ret = sendmsg(uipc.ch[ch_id].fd, &msg, MSG_NOSIGNAL));
+  if (ret < 0) {
+    LOG_ERROR("failed to send (%s)", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
 /*******************************************************************************
  **
  ** Function         UIPC_Read
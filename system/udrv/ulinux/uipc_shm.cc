@@ -0,0 +1,321 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "uipc_shm"
+
+#include "uipc_shm.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "check.h"
+#include "osi/include/log.h"
+#include "osi/include/osi.h"
+
+namespace {
+
+constexpr uint32_t kMagic = 0x42544d53;  // "BTMS"
+
+// Keeps the positions written by the writer and by the reader on separate
+// cache lines
+constexpr size_t kCacheLineSize = 64;
+
+// The largest ring, the positions are free running 32 bits counters
+constexpr size_t kMaxCapacity = 1 << 24;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the positions are shared between processes");
+
+// Layout of the start of the shared memory, followed by the ring data
+struct shm_header_t {
+  uint32_t magic;
+  uint32_t capacity;
+
+  // Written by the reader
+  alignas(kCacheLineSize) std::atomic<uint32_t> read_position;
+  std::atomic<uint32_t> limit;
+
+  // Written by the writer
+  alignas(kCacheLineSize) std::atomic<uint32_t> write_position;
+  std::atomic<uint32_t> writer_waiting;
+};
+
+constexpr size_t kDataOffset = sizeof(shm_header_t);
+
+size_t round_up_to_power_of_two(size_t value) {
+  size_t result = 1;
+  while (result < value) result <<= 1;
+  return result;
+}
+
+int64_t now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+}  // namespace
+
+struct uipc_shm_t {
+  int memory_fd;
+  int event_fd;
+  size_t size;
+  shm_header_t* header;
+  uint8_t* data;
+};
+
+static uipc_shm_t* map_ring(int memory_fd, int event_fd, size_t size) {
+  void* memory =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+  if (memory == MAP_FAILED) {
+    LOG_ERROR("%s unable to map ring: %s", __func__, strerror(errno));
+    return NULL;
+  }
+
+  uipc_shm_t* ring = new uipc_shm_t();
+  ring->memory_fd = memory_fd;
+  ring->event_fd = event_fd;
+  ring->size = size;
+  ring->header = static_cast<shm_header_t*>(memory);
+  ring->data = static_cast<uint8_t*>(memory) + kDataOffset;
+  return ring;
+}
+
+uipc_shm_t* uipc_shm_new(size_t capacity) {
+  capacity = round_up_to_power_of_two(capacity);
+  if (capacity > kMaxCapacity) {
+    LOG_ERROR("%s capacity of %zu bytes is too large", __func__, capacity);
+    return NULL;
+  }
+
+  int memory_fd = memfd_create("bt_uipc_shm", MFD_CLOEXEC);
+  if (memory_fd == INVALID_FD) {
+    LOG_ERROR("%s unable to create memfd: %s", __func__, strerror(errno));
+    return NULL;
+  }
+
+  size_t size = kDataOffset + capacity;
+  if (ftruncate(memory_fd, size) == -1) {
+    LOG_ERROR("%s unable to size memfd: %s", __func__, strerror(errno));
+    close(memory_fd);
+    return NULL;
+  }
+
+  int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd == INVALID_FD) {
+    LOG_ERROR("%s unable to create eventfd: %s", __func__, strerror(errno));
+    close(memory_fd);
+    return NULL;
+  }
+
+  uipc_shm_t* ring = map_ring(memory_fd, event_fd, size);
+  if (ring == NULL) {
+    close(event_fd);
+    close(memory_fd);
+    return NULL;
+  }
+
+  // The memfd is zero filled, the positions start at 0
+  shm_header_t* header = ring->header;
+  header->capacity = capacity;
+  header->limit.store(capacity, std::memory_order_relaxed);
+  header->magic = kMagic;
+  return ring;
+}
+
+uipc_shm_t* uipc_shm_attach(int memory_fd, int event_fd) {
+  struct stat st;
+  if (fstat(memory_fd, &st) == -1 ||
+      st.st_size <= static_cast<off_t>(kDataOffset)) {
+    LOG_ERROR("%s invalid ring memory", __func__);
+    close(event_fd);
+    close(memory_fd);
+    return NULL;
+  }
+
+  uipc_shm_t* ring = map_ring(memory_fd, event_fd, st.st_size);
+  if (ring == NULL) {
+    close(event_fd);
+    close(memory_fd);
+    return NULL;
+  }
+
+  // The capacity is only used once checked against the mapping
+  uint32_t capacity = ring->header->capacity;
+  if (ring->header->magic != kMagic || capacity == 0 ||
+      (capacity & (capacity - 1)) != 0 ||
+      kDataOffset + capacity != ring->size) {
+    LOG_ERROR("%s invalid ring header", __func__);
+    uipc_shm_free(ring);
+    return NULL;
+  }
+  return ring;
+}
+
+void uipc_shm_free(uipc_shm_t* ring) {
+  if (ring == NULL) return;
+
+  munmap(ring->header, ring->size);
+  close(ring->event_fd);
+  close(ring->memory_fd);
+  delete ring;
+}
+
+int uipc_shm_get_memory_fd(const uipc_shm_t* ring) {
+  CHECK(ring != NULL);
+
+  return ring->memory_fd;
+}
+
+int uipc_shm_get_event_fd(const uipc_shm_t* ring) {
+  CHECK(ring != NULL);
+
+  return ring->event_fd;
+}
+
+size_t uipc_shm_capacity(const uipc_shm_t* ring) {
+  CHECK(ring != NULL);
+
+  return ring->size - kDataOffset;
+}
+
+void uipc_shm_set_limit(uipc_shm_t* ring, size_t limit) {
+  CHECK(ring != NULL);
+
+  limit = std::min(limit, uipc_shm_capacity(ring));
+  ring->header->limit.store(limit, std::memory_order_relaxed);
+}
+
+size_t uipc_shm_length(const uipc_shm_t* ring) {
+  CHECK(ring != NULL);
+
+  uint32_t write_position =
+      ring->header->write_position.load(std::memory_order_acquire);
+  uint32_t read_position =
+      ring->header->read_position.load(std::memory_order_acquire);
+  return write_position - read_position;
+}
+
+// Returns the number of bytes that can be written, must only be called from
+// the writer. The limit is read again on each call, in case the reader
+// changed it while the writer was waiting.
+static size_t writable_length(uipc_shm_t* ring) {
+  size_t capacity = uipc_shm_capacity(ring);
+  size_t limit = std::min<size_t>(
+      ring->header->limit.load(std::memory_order_relaxed), capacity);
+  size_t length = uipc_shm_length(ring);
+  return length < limit ? limit - length : 0;
+}
+
+size_t uipc_shm_write(uipc_shm_t* ring, const void* data, size_t len,
+                      int timeout_ms) {
+  CHECK(ring != NULL);
+  CHECK(data != NULL || len == 0);
+
+  shm_header_t* header = ring->header;
+  size_t mask = uipc_shm_capacity(ring) - 1;
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  size_t count = 0;
+  int64_t deadline_ms = -1;
+
+  while (count < len) {
+    size_t room = writable_length(ring);
+    if (room == 0) {
+      // Tell the reader to signal the eventfd, then look again in case it
+      // read before seeing the flag
+      header->writer_waiting.store(1, std::memory_order_seq_cst);
+      if (writable_length(ring) > 0) {
+        header->writer_waiting.store(0, std::memory_order_relaxed);
+        continue;
+      }
+
+      if (deadline_ms < 0) deadline_ms = now_ms() + timeout_ms;
+      int64_t remaining_ms = std::max<int64_t>(deadline_ms - now_ms(), 0);
+
+      struct pollfd pfd = {.fd = ring->event_fd, .events = POLLIN};
+      int ret;
+      OSI_NO_INTR(ret = poll(&pfd, 1, remaining_ms));
+      if (ret <= 0) {
+        if (ret == -1) {
+          LOG_ERROR("%s unable to wait for the reader: %s", __func__,
+                    strerror(errno));
+        }
+        break;
+      }
+      eventfd_t value;
+      eventfd_read(ring->event_fd, &value);
+      continue;
+    }
+
+    uint32_t position = header->write_position.load(std::memory_order_relaxed);
+    size_t offset = position & mask;
+    size_t n = std::min({room, len - count, mask + 1 - offset});
+    memcpy(ring->data + offset, p + count, n);
+    header->write_position.store(position + n, std::memory_order_release);
+    count += n;
+  }
+  return count;
+}
+
+size_t uipc_shm_read(uipc_shm_t* ring, void* data, size_t len) {
+  CHECK(ring != NULL);
+  CHECK(data != NULL || len == 0);
+
+  shm_header_t* header = ring->header;
+  size_t mask = uipc_shm_capacity(ring) - 1;
+  uint8_t* p = static_cast<uint8_t*>(data);
+
+  uint32_t position = header->read_position.load(std::memory_order_relaxed);
+  uint32_t write_position =
+      header->write_position.load(std::memory_order_acquire);
+  // The writer is another process, don't trust it to stay within the ring
+  size_t count = std::min<size_t>(write_position - position, mask + 1);
+  count = std::min(count, len);
+  if (count == 0) return 0;
+
+  size_t offset = position & mask;
+  size_t first = std::min(count, mask + 1 - offset);
+  memcpy(p, ring->data + offset, first);
+  memcpy(p + first, ring->data, count - first);
+  header->read_position.store(position + count, std::memory_order_seq_cst);
+
+  if (header->writer_waiting.exchange(0, std::memory_order_seq_cst)) {
+    eventfd_write(ring->event_fd, 1ULL);
+  }
+  return count;
+}
+
+void uipc_shm_flush(uipc_shm_t* ring) {
+  CHECK(ring != NULL);
+
+  shm_header_t* header = ring->header;
+  header->read_position.store(
+      header->write_position.load(std::memory_order_acquire),
+      std::memory_order_seq_cst);
+
+  if (header->writer_waiting.exchange(0, std::memory_order_seq_cst)) {
+    eventfd_write(ring->event_fd, 1ULL);
+  }
+}
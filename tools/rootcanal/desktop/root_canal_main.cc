@@ -48,6 +48,12 @@ DEFINE_bool(enable_baseband_sniffer, false, "enable baseband sniffer");
 DEFINE_bool(enable_pcap_filter, false, "enable PCAP filter");
 DEFINE_bool(disable_address_reuse, false,
             "prevent rootcanal from reusing device addresses");
+DEFINE_uint32(virtual_time_idle_ms, 0,
+              "run in virtual time, fast-forwarding to the next event once "
+              "the devices are idle for this many milliseconds (0 disables)");
+DEFINE_uint32(device_threads, 1,
+              "number of threads ticking the devices concurrently, 1 ticks "
+              "them in sequence on the task thread");
 DEFINE_uint32(test_port, 6401, "test tcp port");
 DEFINE_uint32(hci_port, 6402, "hci server tcp port");
 DEFINE_uint32(link_port, 6403, "link server tcp port");
@@ -138,7 +144,9 @@ int main(int argc, char** argv) {
       static_cast<int>(FLAGS_link_port), static_cast<int>(FLAGS_link_ble_port),
       configuration_str, FLAGS_enable_hci_sniffer,
       FLAGS_enable_baseband_sniffer, FLAGS_enable_pcap_filter,
-      FLAGS_disable_address_reuse);
+      FLAGS_disable_address_reuse,
+      std::chrono::milliseconds(FLAGS_virtual_time_idle_ms),
+      FLAGS_device_threads);
 
   std::promise<void> barrier;
   std::future<void> barrier_future = barrier.get_future();
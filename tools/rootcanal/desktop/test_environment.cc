@@ -51,7 +51,8 @@ TestEnvironment::TestEnvironment(
     int test_port, int hci_port, int link_port, int link_ble_port,
     const std::string& config_str,
     bool enable_hci_sniffer, bool enable_baseband_sniffer,
-    bool enable_pcap_filter, bool disable_address_reuse)
+    bool enable_pcap_filter, bool disable_address_reuse,
+    std::chrono::milliseconds virtual_time_idle_period, size_t device_threads)
     : enable_hci_sniffer_(enable_hci_sniffer),
       enable_baseband_sniffer_(enable_baseband_sniffer),
       enable_pcap_filter_(enable_pcap_filter) {
@@ -60,6 +61,12 @@ TestEnvironment::TestEnvironment(
   link_ble_socket_server_ = open_server(&async_manager_, link_ble_port);
   connector_ = open_connector(&async_manager_);
   test_model_.SetReuseDeviceIds(!disable_address_reuse);
+  test_model_.SetDeviceThreads(device_threads);
+  if (virtual_time_idle_period > std::chrono::milliseconds::zero()) {
+    LOG_INFO("Using virtual time, idle period of %d ms",
+             static_cast<int>(virtual_time_idle_period.count()));
+    async_manager_.EnableVirtualTime(virtual_time_idle_period);
+  }
 
   // Get a user ID for tasks scheduled within the test environment.
   socket_user_id_ = async_manager_.GetNextUserId();
@@ -56,7 +56,9 @@ class TestEnvironment {
       int test_port, int hci_port, int link_port, int link_ble_port,
       std::string const& config_str,
       bool enable_hci_sniffer = false, bool enable_baseband_sniffer = false,
-      bool enable_pcap_filter = false, bool disable_address_reuse = false);
+      bool enable_pcap_filter = false, bool disable_address_reuse = false,
+      std::chrono::milliseconds virtual_time_idle_period = {},
+      size_t device_threads = 1);
 
   void initialize(std::promise<void> barrier);
   void close();
@@ -2217,8 +2217,8 @@ void DualModeController::LeEncrypt(CommandView command) {
       kNumCommandPackets, ErrorCode::SUCCESS, encrypted_data));
 }
 
-static std::random_device rd{};
-static std::mt19937_64 s_mt{rd()};
+// Per thread as the controllers may run concurrently.
+static thread_local std::mt19937_64 s_mt{std::random_device{}()};
 
 void DualModeController::LeRand(CommandView command) {
   auto command_view = bluetooth::hci::LeRandView::Create(command);
@@ -243,8 +243,7 @@ ErrorCode LinkLayerController::LeSetAdvertisingEnable(bool advertising_enable) {
     case AdvertisingType::ADV_DIRECT_IND_HIGH:
       // The Link Layer shall exit the Advertising state no later than 1.28 s
       // after the Advertising state was entered.
-      legacy_advertiser_.timeout =
-          std::chrono::steady_clock::now() + adv_direct_ind_high_timeout;
+      legacy_advertiser_.timeout = Clock::now() + adv_direct_ind_high_timeout;
       [[fallthrough]];
 
     case AdvertisingType::ADV_DIRECT_IND_LOW: {
@@ -268,8 +267,8 @@ ErrorCode LinkLayerController::LeSetAdvertisingEnable(bool advertising_enable) {
   }
 
   legacy_advertiser_.advertising_enable = true;
-  legacy_advertiser_.next_event = std::chrono::steady_clock::now() +
-                                  legacy_advertiser_.advertising_interval;
+  legacy_advertiser_.next_event =
+      Clock::now() + legacy_advertiser_.advertising_interval;
   return ErrorCode::SUCCESS;
 }
 
@@ -1149,7 +1148,7 @@ ErrorCode LinkLayerController::LeSetExtendedAdvertisingEnable(
     if (set.duration_ > 0) {
       std::chrono::milliseconds duration =
           std::chrono::milliseconds(set.duration_ * 10);
-      advertiser.timeout = std::chrono::steady_clock::now() + duration;
+      advertiser.timeout = Clock::now() + duration;
     } else {
       advertiser.timeout.reset();
     }
@@ -1604,7 +1603,7 @@ uint16_t ExtendedAdvertiser::GetMaxPeriodicAdvertisingDataLength(
 // =============================================================================
 
 void LinkLayerController::LeAdvertising() {
-  chrono::time_point now = std::chrono::steady_clock::now();
+  chrono::time_point now = Clock::now();
 
   // Legacy Advertising Timeout
 
@@ -22,6 +22,7 @@
 
 #include "crypto/crypto.h"
 #include "log.h"
+#include "model/setup/clock.h"
 #include "packet/raw_builder.h"
 
 using namespace std::chrono;
@@ -1436,7 +1437,7 @@ ErrorCode LinkLayerController::LeSetExtendedScanEnable(
   scanner_.duration = duration_ms;
   scanner_.period = period_ms;
 
-  auto now = std::chrono::steady_clock::now();
+  auto now = Clock::now();
 
   // At the end of a single scan (Duration non-zero but Period zero), an
   // HCI_LE_Scan_Timeout event shall be generated.
@@ -4029,8 +4030,7 @@ void LinkLayerController::IncomingLePeriodicAdvertisingPdu(
              .advertising_sid = advertising_sid,
              .sync_handle = sync_handle,
              .sync_timeout = synchronizing_->sync_timeout,
-             .timeout = std::chrono::steady_clock::now() +
-                        synchronizing_->sync_timeout,
+             .timeout = Clock::now() + synchronizing_->sync_timeout,
          }});
 
     // Quit synchronizing state.
@@ -4081,7 +4081,7 @@ void LinkLayerController::IncomingLePeriodicAdvertisingPdu(
     }
 
     // Refresh the timeout for the sync disconnection.
-    sync.timeout = std::chrono::steady_clock::now() + sync.sync_timeout;
+    sync.timeout = Clock::now() + sync.sync_timeout;
   }
 }
 
@@ -5051,7 +5051,7 @@ void LinkLayerController::LeScanning() {
     return;
   }
 
-  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = Clock::now();
 
   // Extended Scanning Timeout
 
@@ -5093,7 +5093,7 @@ void LinkLayerController::LeScanning() {
 void LinkLayerController::LeSynchronization() {
   std::vector<uint16_t> removed_sync_handles;
   for (auto& [_, sync] : synchronized_) {
-    if (sync.timeout > std::chrono::steady_clock::now()) {
+    if (sync.timeout > Clock::now()) {
       LOG_INFO("Periodic advertising sync with handle 0x%x lost",
                sync.sync_handle);
       removed_sync_handles.push_back(sync.sync_handle);
@@ -6128,7 +6128,7 @@ void LinkLayerController::Reset() {
   initiator_ = Initiator{};
   synchronizing_ = {};
   synchronized_ = {};
-  last_inquiry_ = steady_clock::now();
+  last_inquiry_ = Clock::now();
   inquiry_mode_ = InquiryType::STANDARD;
   inquiry_lap_ = 0;
   inquiry_max_responses_ = 0;
@@ -6186,7 +6186,7 @@ void LinkLayerController::SetInquiryMaxResponses(uint8_t max) {
 }
 
 void LinkLayerController::Inquiry() {
-  steady_clock::time_point now = steady_clock::now();
+  steady_clock::time_point now = Clock::now();
   if (duration_cast<milliseconds>(now - last_inquiry_) < milliseconds(2000)) {
     return;
   }
@@ -6437,8 +6437,8 @@ TaskId LinkLayerController::NextTaskId() {
 TaskId LinkLayerController::ScheduleTask(std::chrono::milliseconds delay,
                                          TaskCallback task_callback) {
   TaskId task_id = NextTaskId();
-  task_queue_.emplace(std::chrono::steady_clock::now() + delay,
-                      std::move(task_callback), task_id);
+  task_queue_.emplace(Clock::now() + delay, std::move(task_callback),
+                      task_id);
   return task_id;
 }
 
@@ -6446,7 +6446,7 @@ TaskId LinkLayerController::SchedulePeriodicTask(
     std::chrono::milliseconds delay, std::chrono::milliseconds period,
     TaskCallback task_callback) {
   TaskId task_id = NextTaskId();
-  task_queue_.emplace(std::chrono::steady_clock::now() + delay, period,
+  task_queue_.emplace(Clock::now() + delay, period,
                       std::move(task_callback), task_id);
   return task_id;
 }
@@ -6462,7 +6462,7 @@ void LinkLayerController::CancelScheduledTask(TaskId task_id) {
 }
 
 void LinkLayerController::RunPendingTasks() {
-  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = Clock::now();
   while (!task_queue_.empty()) {
     auto it = task_queue_.begin();
     if (it->time > now) {
@@ -16,6 +16,7 @@
 
 #include "beacon.h"
 
+#include "model/setup/clock.h"
 #include "model/setup/device_boutique.h"
 
 namespace rootcanal {
@@ -47,7 +48,7 @@ Beacon::Beacon(const std::vector<std::string>& args) : Beacon() {
 }
 
 void Beacon::Tick() {
-  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point now = Clock::now();
   if ((now - advertising_last_) >= advertising_interval_) {
     advertising_last_ = now;
     SendLinkLayerPacket(
@@ -59,6 +60,11 @@ void Beacon::Tick() {
   }
 }
 
+bool Beacon::IsListening(PacketType type) const {
+  // Beacons only answer the scan requests
+  return type == PacketType::LE_SCAN;
+}
+
 void Beacon::ReceiveLinkLayerPacket(LinkLayerPacketView packet,
                                     Phy::Type /*type*/, int8_t /*rssi*/) {
   if (packet.GetDestinationAddress() == address_ &&
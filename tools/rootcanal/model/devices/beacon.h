@@ -39,6 +39,7 @@ class Beacon : public Device {
   virtual std::string GetTypeString() const override { return "beacon"; }
 
   virtual void Tick() override;
+  virtual bool IsListening(model::packets::PacketType type) const override;
   virtual void ReceiveLinkLayerPacket(
       model::packets::LinkLayerPacketView packet, Phy::Type type,
       int8_t rssi) override;
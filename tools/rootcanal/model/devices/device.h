@@ -56,6 +56,15 @@ class Device {
       model::packets::LinkLayerPacketView packet, Phy::Type type,
       int8_t rssi){};
 
+  // Return true if the device receives the link layer packets of the given
+  // type. The phy layers only deliver to the device the types it listens to,
+  // which spares dispatching the packets of dense populations of advertisers
+  // to the devices that would discard them. The answer must not change once
+  // the device is registered to a phy layer.
+  virtual bool IsListening(model::packets::PacketType /*type*/) const {
+    return true;
+  }
+
   void SendLinkLayerPacket(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
       Phy::Type type, int8_t tx_power = 0);
@@ -71,10 +71,7 @@ void H4DataChannelPacketizer::OnDataReady(
   // are available to read. Otherwise this limits the number of HCI
   // packets parsed to one every 3 ticks.
   for (;;) {
-    ssize_t bytes_to_read = h4_parser_.BytesRequested();
-    std::vector<uint8_t> buffer(bytes_to_read);
-
-    ssize_t bytes_read = socket->Recv(buffer.data(), bytes_to_read);
+    ssize_t bytes_read = socket->Recv(read_buffer_.data(), read_buffer_.size());
     if (bytes_read == 0) {
       LOG_INFO("remote disconnected!");
       disconnected_ = true;
@@ -95,7 +92,7 @@ void H4DataChannelPacketizer::OnDataReady(
       LOG_ALWAYS_FATAL("Read error in %u: %s", h4_parser_.CurrentState(),
                        strerror(errno));
     }
-    h4_parser_.Consume(buffer.data(), bytes_read);
+    h4_parser_.ConsumeAll(read_buffer_.data(), bytes_read);
   }
 }
 
@@ -57,12 +57,9 @@ void H4Packetizer::OnDataReady(int fd) {
   if (disconnected_) {
     return;
   }
-  ssize_t bytes_to_read = h4_parser_.BytesRequested();
-  std::vector<uint8_t> buffer(bytes_to_read);
-
   ssize_t bytes_read;
   do {
-    bytes_read = read(fd, buffer.data(), bytes_to_read);
+    bytes_read = read(fd, read_buffer_.data(), read_buffer_.size());
   } while (bytes_read == -1 && errno == EINTR);
 
   if (bytes_read == 0) {
@@ -86,7 +83,7 @@ void H4Packetizer::OnDataReady(int fd) {
     LOG_ALWAYS_FATAL("Read error in %d: %s", h4_parser_.CurrentState(),
                      strerror(errno));
   }
-  h4_parser_.Consume(buffer.data(), bytes_read);
+  h4_parser_.ConsumeAll(read_buffer_.data(), bytes_read);
 }
 
 }  // namespace rootcanal
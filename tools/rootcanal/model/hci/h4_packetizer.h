@@ -43,6 +43,10 @@ class H4Packetizer : public HciProtocol {
   int uart_fd_;
   H4Parser h4_parser_;
 
+  // Buffer of the bulk reads, parsed in place.
+  static constexpr size_t kReadBufferSize = 16384;
+  std::vector<uint8_t> read_buffer_ = std::vector<uint8_t>(kReadBufferSize);
+
   ClientDisconnectCallback disconnect_cb_;
   bool disconnected_{false};
 };
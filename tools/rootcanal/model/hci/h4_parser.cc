@@ -16,6 +16,7 @@
 
 #include "model/hci/h4_parser.h"  // for H4Parser, PacketType, H4Pars...
 
+#include <algorithm>   // for min
 #include <array>
 #include <cstddef>     // for size_t
 #include <cstdint>     // for uint8_t, int32_t
@@ -58,6 +59,23 @@ size_t H4Parser::HciGetPacketLengthForType(PacketType type,
   return size;
 }
 
+size_t H4Parser::HciGetPreambleSizeForType(uint8_t type) {
+  switch (static_cast<PacketType>(type)) {
+    case PacketType::COMMAND:
+      return H4Parser::COMMAND_PREAMBLE_SIZE;
+    case PacketType::ACL:
+      return H4Parser::ACL_PREAMBLE_SIZE;
+    case PacketType::SCO:
+      return H4Parser::SCO_PREAMBLE_SIZE;
+    case PacketType::EVENT:
+      return H4Parser::EVENT_PREAMBLE_SIZE;
+    case PacketType::ISO:
+      return H4Parser::ISO_PREAMBLE_SIZE;
+    default:
+      return 0;
+  }
+}
+
 H4Parser::H4Parser(PacketReadCallback command_cb, PacketReadCallback event_cb,
                    PacketReadCallback acl_cb, PacketReadCallback sco_cb,
                    PacketReadCallback iso_cb, bool enable_recovery_state)
@@ -69,27 +87,29 @@ H4Parser::H4Parser(PacketReadCallback command_cb, PacketReadCallback event_cb,
       enable_recovery_state_(enable_recovery_state) {}
 
 void H4Parser::OnPacketReady() {
+  // The packet is moved to the callbacks.
   switch (hci_packet_type_) {
     case PacketType::COMMAND:
-      command_cb_(packet_);
+      command_cb_(std::move(packet_));
       break;
     case PacketType::ACL:
-      acl_cb_(packet_);
+      acl_cb_(std::move(packet_));
       break;
     case PacketType::SCO:
-      sco_cb_(packet_);
+      sco_cb_(std::move(packet_));
       break;
     case PacketType::EVENT:
-      event_cb_(packet_);
+      event_cb_(std::move(packet_));
       break;
     case PacketType::ISO:
-      iso_cb_(packet_);
+      iso_cb_(std::move(packet_));
       break;
     default:
       LOG_ALWAYS_FATAL("Unimplemented packet type %d",
                        static_cast<int>(hci_packet_type_));
   }
   // Get ready for the next type byte.
+  packet_.clear();
   hci_packet_type_ = PacketType::UNKNOWN;
 }
 
@@ -116,15 +136,6 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
                      static_cast<int>(bytes_to_read));
   }
 
-  static const size_t preamble_size[static_cast<size_t>(PacketType::ISO) + 1] =
-      {
-          0,
-          H4Parser::COMMAND_PREAMBLE_SIZE,
-          H4Parser::ACL_PREAMBLE_SIZE,
-          H4Parser::SCO_PREAMBLE_SIZE,
-          H4Parser::EVENT_PREAMBLE_SIZE,
-          H4Parser::ISO_PREAMBLE_SIZE,
-      };
   switch (state_) {
     case HCI_TYPE:
       // bytes_read >= 1
@@ -171,11 +182,7 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
   switch (state_) {
     case HCI_TYPE:
       hci_packet_type_ = static_cast<PacketType>(packet_type_);
-      if (hci_packet_type_ != PacketType::ACL &&
-          hci_packet_type_ != PacketType::SCO &&
-          hci_packet_type_ != PacketType::COMMAND &&
-          hci_packet_type_ != PacketType::EVENT &&
-          hci_packet_type_ != PacketType::ISO) {
+      if (HciGetPreambleSizeForType(packet_type_) == 0) {
         if (!enable_recovery_state_) {
           LOG_ALWAYS_FATAL("Received invalid packet type 0x%x",
                            static_cast<unsigned>(packet_type_));
@@ -187,7 +194,7 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
         bytes_wanted_ = 1;
       } else {
         state_ = HCI_PREAMBLE;
-        bytes_wanted_ = preamble_size[static_cast<size_t>(hci_packet_type_)];
+        bytes_wanted_ = HciGetPreambleSizeForType(packet_type_);
       }
       break;
     case HCI_PREAMBLE:
@@ -198,6 +205,7 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
           OnPacketReady();
           state_ = HCI_TYPE;
         } else {
+          packet_.reserve(packet_.size() + payload_size);
           bytes_wanted_ = payload_size;
           state_ = HCI_PAYLOAD;
         }
@@ -213,4 +221,34 @@ bool H4Parser::Consume(const uint8_t* buffer, int32_t bytes_read) {
   }
   return true;
 }
+
+bool H4Parser::ConsumeAll(const uint8_t* buffer, size_t bytes) {
+  while (bytes > 0) {
+    // Extract the packets fully contained in the buffer in one go.
+    size_t preamble_size =
+        state_ == HCI_TYPE ? HciGetPreambleSizeForType(buffer[0]) : 0;
+    if (preamble_size > 0 && bytes > preamble_size) {
+      PacketType type = static_cast<PacketType>(buffer[0]);
+      size_t packet_size =
+          preamble_size + HciGetPacketLengthForType(type, buffer + 1);
+      if (bytes > packet_size) {
+        packet_type_ = buffer[0];
+        hci_packet_type_ = type;
+        packet_.assign(buffer + 1, buffer + 1 + packet_size);
+        OnPacketReady();
+        buffer += 1 + packet_size;
+        bytes -= 1 + packet_size;
+        continue;
+      }
+    }
+
+    size_t bytes_consumed = std::min(bytes, BytesRequested());
+    if (!Consume(buffer, static_cast<int32_t>(bytes_consumed))) {
+      return false;
+    }
+    buffer += bytes_consumed;
+    bytes -= bytes_consumed;
+  }
+  return true;
+}
 }  // namespace rootcanal
@@ -42,6 +42,8 @@ using ClientDisconnectCallback = std::function<void()>;
 // h4.Consume(fill_this_vector_with_at_most_nr_bytes.data(), nr_bytes.size());
 //
 // The parser will invoke the proper callbacks once a packet has been parsed.
+// Alternatively, ConsumeAll accepts buffers of any size, filled by bulk reads,
+// and parses the packets they contain in place.
 // The parser keeps internal state and is not thread safe.
 class H4Parser {
  public:
@@ -54,6 +56,11 @@ class H4Parser {
   // Consumes the given number of bytes, returns true on success.
   bool Consume(const uint8_t* buffer, int32_t bytes);
 
+  // Consumes all the given bytes, which may hold several packets, returns
+  // true on success. The packets fully contained in the buffer are extracted
+  // in one go, the other bytes are consumed as requested.
+  bool ConsumeAll(const uint8_t* buffer, size_t bytes);
+
   // The maximum number of bytes the parser can consume in the current state.
   size_t BytesRequested();
 
@@ -97,6 +104,9 @@ class H4Parser {
   static size_t HciGetPacketLengthForType(PacketType type,
                                           const uint8_t* preamble);
 
+  // Returns the size of the preamble of a valid packet type, 0 otherwise.
+  static size_t HciGetPreambleSizeForType(uint8_t type);
+
   PacketType hci_packet_type_{PacketType::UNKNOWN};
 
   State state_{HCI_TYPE};
@@ -23,7 +23,8 @@
 
 namespace rootcanal {
 
-using PacketReadCallback = std::function<void(const std::vector<uint8_t>&)>;
+// The packet is handed over to the callback, which can take it without copy.
+using PacketReadCallback = std::function<void(std::vector<uint8_t>&&)>;
 using android::net::AsyncDataChannel;
 
 // Implementation of HCI protocol bits common to different transports
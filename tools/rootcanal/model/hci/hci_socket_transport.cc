@@ -28,31 +28,27 @@ void HciSocketTransport::RegisterCallbacks(PacketCallback command_callback,
                                            PacketCallback sco_callback,
                                            PacketCallback iso_callback,
                                            CloseCallback close_callback) {
-  // TODO: Avoid the copy here by using new buffer in H4DataChannel
+  // The packets are moved from the parser buffer without copy.
   h4_ = H4DataChannelPacketizer(
       socket_,
-      [command_callback](const std::vector<uint8_t>& raw_command) {
-        std::shared_ptr<std::vector<uint8_t>> packet_copy =
-            std::make_shared<std::vector<uint8_t>>(raw_command);
-        command_callback(packet_copy);
+      [command_callback](std::vector<uint8_t>&& raw_command) {
+        command_callback(
+            std::make_shared<std::vector<uint8_t>>(std::move(raw_command)));
       },
-      [](const std::vector<uint8_t>&) {
+      [](std::vector<uint8_t>&&) {
         LOG_ALWAYS_FATAL("Unexpected Event in HciSocketTransport!");
       },
-      [acl_callback](const std::vector<uint8_t>& raw_acl) {
-        std::shared_ptr<std::vector<uint8_t>> packet_copy =
-            std::make_shared<std::vector<uint8_t>>(raw_acl);
-        acl_callback(packet_copy);
+      [acl_callback](std::vector<uint8_t>&& raw_acl) {
+        acl_callback(
+            std::make_shared<std::vector<uint8_t>>(std::move(raw_acl)));
       },
-      [sco_callback](const std::vector<uint8_t>& raw_sco) {
-        std::shared_ptr<std::vector<uint8_t>> packet_copy =
-            std::make_shared<std::vector<uint8_t>>(raw_sco);
-        sco_callback(packet_copy);
+      [sco_callback](std::vector<uint8_t>&& raw_sco) {
+        sco_callback(
+            std::make_shared<std::vector<uint8_t>>(std::move(raw_sco)));
       },
-      [iso_callback](const std::vector<uint8_t>& raw_iso) {
-        std::shared_ptr<std::vector<uint8_t>> packet_copy =
-            std::make_shared<std::vector<uint8_t>>(raw_iso);
-        iso_callback(packet_copy);
+      [iso_callback](std::vector<uint8_t>&& raw_iso) {
+        iso_callback(
+            std::make_shared<std::vector<uint8_t>>(std::move(raw_iso)));
       },
       close_callback);
 }
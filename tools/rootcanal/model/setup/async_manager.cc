@@ -25,6 +25,7 @@
 
 #include "fcntl.h"
 #include "log.h"
+#include "model/setup/clock.h"
 #include "sys/select.h"
 #include "unistd.h"
 
@@ -272,16 +273,16 @@ class AsyncManager::AsyncTaskManager {
 
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback& callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+    return scheduleTask(
+        std::make_shared<Task>(Clock::now() + delay, callback, user_id));
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
                                     std::chrono::milliseconds delay,
                                     std::chrono::milliseconds period,
                                     const TaskCallback& callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+    return scheduleTask(std::make_shared<Task>(Clock::now() + delay, period,
+                                               callback, user_id));
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -308,6 +309,15 @@ class AsyncManager::AsyncTaskManager {
     critical();
   }
 
+  void EnableVirtualTime(std::chrono::milliseconds idle_period) {
+    std::unique_lock<std::mutex> guard(internal_mutex_);
+    idle_period_ = idle_period;
+  }
+
+  // Called when a file descriptor is read, to not skip time while the devices
+  // are processing the incoming data.
+  void NotifyActivity() { activity_++; }
+
   AsyncTaskManager() = default;
   AsyncTaskManager(const AsyncTaskManager&) = delete;
   AsyncTaskManager& operator=(const AsyncTaskManager&) = delete;
@@ -421,6 +431,7 @@ class AsyncManager::AsyncTaskManager {
       tasks_by_id_[lastTaskId_] = task;
       tasks_by_user_id_[task->user_id].insert(task->task_id);
       task_queue_.insert(task);
+      activity_++;
     }
     // start thread if necessary
     int started = tryStartThread();
@@ -464,7 +475,7 @@ class AsyncManager::AsyncTaskManager {
         std::unique_lock<std::mutex> guard(internal_mutex_);
         if (!task_queue_.empty()) {
           task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+          if (task_p->time < Clock::now()) {
             run_it = true;
             callback = task_p->callback;
             task_queue_.erase(task_p);  // need to remove and add again if
@@ -496,7 +507,18 @@ class AsyncManager::AsyncTaskManager {
           // have been freed (e.g. via CancelAsyncTask).
           std::chrono::steady_clock::time_point time =
               (*task_queue_.begin())->time;
-          internal_cond_var_.wait_until(guard, time);
+          // The task times are in the clock of the simulation
+          std::chrono::steady_clock::time_point deadline =
+              time - Clock::Offset();
+          if (idle_period_ > std::chrono::milliseconds::zero()) {
+            if (isIdle()) {
+              Clock::Advance(time - Clock::now());
+              continue;
+            }
+            // Wake up at the end of the idle period to fast-forward
+            deadline = std::min(deadline, last_activity_time_ + idle_period_);
+          }
+          internal_cond_var_.wait_until(guard, deadline);
         } else {
           internal_cond_var_.wait(guard);
         }
@@ -504,7 +526,26 @@ class AsyncManager::AsyncTaskManager {
     }
   }
 
+  // Returns true when nothing happened for a whole idle period. Once idle,
+  // the devices stay idle and the tasks are run back to back until the next
+  // file descriptor read or newly scheduled task.
+  bool isIdle() {
+    uint64_t activity = activity_;
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    if (activity != last_activity_) {
+      last_activity_ = activity;
+      last_activity_time_ = now;
+      return false;
+    }
+    return now >= last_activity_time_ + idle_period_;
+  }
+
   bool running_ = false;
+  std::chrono::milliseconds idle_period_{};
+  std::atomic_uint64_t activity_{0};
+  uint64_t last_activity_{0};
+  std::chrono::steady_clock::time_point last_activity_time_{};
   std::thread thread_;
   std::mutex internal_mutex_;
   std::mutex synchronization_mutex_;
@@ -535,8 +576,11 @@ AsyncManager::~AsyncManager() {
 
 int AsyncManager::WatchFdForNonBlockingReads(
     int file_descriptor, const ReadCallback& on_read_fd_ready_callback) {
-  return fdWatcher_p_->WatchFdForNonBlockingReads(file_descriptor,
-                                                  on_read_fd_ready_callback);
+  return fdWatcher_p_->WatchFdForNonBlockingReads(
+      file_descriptor, [this, on_read_fd_ready_callback](int fd) {
+        taskManager_p_->NotifyActivity();
+        on_read_fd_ready_callback(fd);
+      });
 }
 
 void AsyncManager::StopWatchingFileDescriptor(int file_descriptor) {
@@ -571,4 +615,8 @@ bool AsyncManager::CancelAsyncTasksFromUser(rootcanal::AsyncUserId user_id) {
 void AsyncManager::Synchronize(const CriticalCallback& critical) {
   taskManager_p_->Synchronize(critical);
 }
+
+void AsyncManager::EnableVirtualTime(std::chrono::milliseconds idle_period) {
+  taskManager_p_->EnableVirtualTime(idle_period);
+}
 }  // namespace rootcanal
@@ -100,6 +100,13 @@ class AsyncManager {
   // have very simple CriticalCallbacks, preferably using lambda expressions.
   void Synchronize(const CriticalCallback& critical_callback);
 
+  // Runs the tasks in virtual time: when no file descriptor was read and no
+  // task was scheduled for |idle_period| of real time, the devices are
+  // considered idle and the Clock jumps to the time of the next task instead
+  // of waiting for it. The idle period must leave the hosts enough time to
+  // answer the events they were sent.
+  void EnableVirtualTime(std::chrono::milliseconds idle_period);
+
   AsyncManager();
   AsyncManager(const AsyncManager&) = delete;
   AsyncManager& operator=(const AsyncManager&) = delete;
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace rootcanal {
+
+// Clock of the simulation, to be used by the models in place of
+// std::chrono::steady_clock. It follows the steady clock, and is fast-forwarded
+// by the AsyncManager in virtual time mode when all the devices are idle until
+// the next scheduled task. The time points are those of the steady clock so
+// that they can be stored in the same fields.
+class Clock {
+ public:
+  using duration = std::chrono::steady_clock::duration;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::steady_clock::time_point;
+  static constexpr bool is_steady = true;
+
+  static time_point now() {
+    return std::chrono::steady_clock::now() + Offset();
+  }
+
+  // Time skipped so far, to convert a deadline of the simulation to the
+  // steady clock.
+  static duration Offset() { return duration(offset_.load()); }
+
+  // Move the clock forward, never backward, by the given duration.
+  static void Advance(duration skipped) {
+    if (skipped > duration::zero()) {
+      offset_ += skipped.count();
+    }
+  }
+
+ private:
+  static inline std::atomic<rep> offset_{0};
+};
+
+}  // namespace rootcanal
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parallel_runner.h"
+
+namespace rootcanal {
+
+ParallelRunner::ParallelRunner(size_t num_threads) {
+  for (size_t i = 1; i < num_threads; i++) {
+    threads_.emplace_back([this]() { ThreadRoutine(); });
+  }
+}
+
+ParallelRunner::~ParallelRunner() {
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    running_ = false;
+  }
+  start_cond_var_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ParallelRunner::Run(size_t count,
+                         const std::function<void(size_t)>& job) {
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    job_ = &job;
+    count_ = count;
+    next_job_ = 0;
+    pending_threads_ = threads_.size();
+    batch_++;
+  }
+  start_cond_var_.notify_all();
+  RunJobs();
+  std::unique_lock<std::mutex> guard(mutex_);
+  done_cond_var_.wait(guard, [this]() { return pending_threads_ == 0; });
+  job_ = nullptr;
+}
+
+void ParallelRunner::RunJobs() {
+  for (size_t i = next_job_++; i < count_; i = next_job_++) {
+    (*job_)(i);
+  }
+}
+
+void ParallelRunner::ThreadRoutine() {
+  uint64_t batch = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      start_cond_var_.wait(
+          guard, [this, batch]() { return !running_ || batch_ != batch; });
+      if (!running_) {
+        return;
+      }
+      batch = batch_;
+    }
+    RunJobs();
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      if (--pending_threads_ == 0) {
+        done_cond_var_.notify_one();
+      }
+    }
+  }
+}
+
+}  // namespace rootcanal
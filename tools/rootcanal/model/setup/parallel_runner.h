@@ -0,0 +1,63 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rootcanal {
+
+// Runs batches of independent jobs on a fixed set of threads. The calling
+// thread takes part in the batch and only returns once all the jobs of the
+// batch have completed, so that the jobs can access the state of the caller
+// without further synchronization.
+class ParallelRunner {
+ public:
+  // Run the jobs on |num_threads| threads, the calling thread included.
+  explicit ParallelRunner(size_t num_threads);
+  ParallelRunner(const ParallelRunner&) = delete;
+  ParallelRunner& operator=(const ParallelRunner&) = delete;
+  ~ParallelRunner();
+
+  // Call job(i) for all i in [0, count), and wait for all the calls to
+  // return. Must not be called concurrently or from a job.
+  void Run(size_t count, const std::function<void(size_t)>& job);
+
+ private:
+  void RunJobs();
+  void ThreadRoutine();
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cond_var_;
+  std::condition_variable done_cond_var_;
+  bool running_{true};
+  // Incremented for each batch to wake up the threads.
+  uint64_t batch_{0};
+  size_t pending_threads_{0};
+  const std::function<void(size_t)>* job_{nullptr};
+  size_t count_{0};
+  std::atomic<size_t> next_job_{0};
+};
+
+}  // namespace rootcanal
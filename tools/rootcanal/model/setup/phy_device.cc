@@ -39,23 +39,34 @@ void PhyDevice::SetAddress(bluetooth::hci::Address address) {
   device_->SetAddress(std::move(address));
 }
 
-void PhyDevice::Receive(std::vector<uint8_t> const& packet, Phy::Type type,
-                        int8_t rssi) {
-  std::shared_ptr<std::vector<uint8_t>> packet_copy =
-      std::make_shared<std::vector<uint8_t>>(packet);
-  model::packets::LinkLayerPacketView packet_view =
-      model::packets::LinkLayerPacketView::Create(
-          bluetooth::packet::PacketView<bluetooth::packet::kLittleEndian>(
-              packet_copy));
-  if (packet_view.IsValid()) {
-    device_->ReceiveLinkLayerPacket(std::move(packet_view), type, rssi);
-  } else {
-    LOG_WARN("received invalid LL packet");
+bool PhyDevice::IsListening(model::packets::PacketType type) const {
+  return device_->IsListening(type);
+}
+
+void PhyDevice::Receive(model::packets::LinkLayerPacketView packet,
+                        Phy::Type type, int8_t rssi) {
+  if (deferred_) {
+    incoming_.push_back(IncomingPacket{std::move(packet), type, rssi});
+    return;
+  }
+  device_->ReceiveLinkLayerPacket(std::move(packet), type, rssi);
+}
+
+void PhyDevice::ReceiveIncoming() {
+  std::vector<IncomingPacket> incoming;
+  std::swap(incoming, incoming_);
+  for (auto& packet : incoming) {
+    device_->ReceiveLinkLayerPacket(std::move(packet.packet), packet.type,
+                                    packet.rssi);
   }
 }
 
 void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
                      int8_t tx_power) {
+  if (deferred_) {
+    outgoing_.push_back(OutgoingPacket{packet, type, tx_power});
+    return;
+  }
   for (auto const& phy : phy_layers_) {
     if (phy->type == type) {
       phy->Send(packet, tx_power, id);
@@ -63,6 +74,22 @@ void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
   }
 }
 
+bool PhyDevice::FlushOutgoing() {
+  if (outgoing_.empty()) {
+    return false;
+  }
+  std::vector<OutgoingPacket> outgoing;
+  std::swap(outgoing, outgoing_);
+  for (auto const& packet : outgoing) {
+    for (auto const& phy : phy_layers_) {
+      if (phy->type == packet.type) {
+        phy->Send(packet.packet, packet.tx_power, id);
+      }
+    }
+  }
+  return true;
+}
+
 std::string PhyDevice::ToString() { return device_->ToString(); }
 
 }  // namespace rootcanal
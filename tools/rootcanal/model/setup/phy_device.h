@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 #include "model/devices/device.h"
 #include "phy.h"
@@ -39,10 +40,24 @@ class PhyDevice {
   void Unregister(PhyLayer* phy);
 
   void Tick();
-  void Receive(std::vector<uint8_t> const& packet, Phy::Type type, int8_t rssi);
+  bool IsListening(model::packets::PacketType type) const;
+  void Receive(model::packets::LinkLayerPacketView packet, Phy::Type type,
+               int8_t rssi);
   void Send(std::vector<uint8_t> const& packet, Phy::Type type,
             int8_t tx_power);
 
+  // Defer the delivery of the packets sent and received by the device, so
+  // that devices can run concurrently. The sent packets are kept until the
+  // next call to FlushOutgoing, the received ones until the next call to
+  // ReceiveIncoming, and both are delivered in order.
+  void SetDeferred(bool deferred) { deferred_ = deferred; }
+
+  // Send the deferred outgoing packets, returns false if there was none.
+  bool FlushOutgoing();
+
+  // Receive the deferred incoming packets.
+  void ReceiveIncoming();
+
   void SetAddress(bluetooth::hci::Address address);
   std::string ToString();
 
@@ -53,6 +68,22 @@ class PhyDevice {
  private:
   const std::shared_ptr<Device> device_;
   std::unordered_set<PhyLayer*> phy_layers_;
+
+  struct OutgoingPacket {
+    std::vector<uint8_t> packet;
+    Phy::Type type;
+    int8_t tx_power;
+  };
+
+  struct IncomingPacket {
+    model::packets::LinkLayerPacketView packet;
+    Phy::Type type;
+    int8_t rssi;
+  };
+
+  bool deferred_{false};
+  std::vector<OutgoingPacket> outgoing_;
+  std::vector<IncomingPacket> incoming_;
 };
 
 }  // namespace rootcanal
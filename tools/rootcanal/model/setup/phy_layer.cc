@@ -16,8 +16,11 @@
 
 #include "phy_layer.h"
 
+#include <algorithm>
 #include <sstream>
 
+#include "log.h"
+
 namespace rootcanal {
 
 PhyLayer::PhyLayer(Identifier id, Phy::Type type) : id(id), type(type) {}
@@ -25,12 +28,22 @@ PhyLayer::PhyLayer(Identifier id, Phy::Type type) : id(id), type(type) {}
 void PhyLayer::Register(std::shared_ptr<PhyDevice> device) {
   device->Register(this);
   phy_devices_.push_back(device);
+  for (size_t type = 0; type < listeners_.size(); type++) {
+    if (device->IsListening(static_cast<model::packets::PacketType>(type))) {
+      listeners_[type].push_back(device);
+    }
+  }
 }
 
 void PhyLayer::Unregister(PhyDevice::Identifier id) {
   for (auto& device : phy_devices_) {
     if (device->id == id) {
       device->Unregister(this);
+      for (auto& listeners : listeners_) {
+        listeners.erase(
+            std::remove(listeners.begin(), listeners.end(), device),
+            listeners.end());
+      }
       phy_devices_.remove(device);
       return;
     }
@@ -42,6 +55,9 @@ void PhyLayer::UnregisterAll() {
     device->Unregister(this);
   }
   phy_devices_.clear();
+  for (auto& listeners : listeners_) {
+    listeners.clear();
+  }
 }
 
 int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier sender_id,
@@ -57,10 +73,21 @@ int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier sender_id,
 
 void PhyLayer::Send(std::vector<uint8_t> const& packet, int8_t tx_power,
                     PhyDevice::Identifier sender_id) {
-  for (const auto& device : phy_devices_) {
+  // Parse the packet once for all the receivers.
+  model::packets::LinkLayerPacketView packet_view =
+      model::packets::LinkLayerPacketView::Create(
+          bluetooth::packet::PacketView<bluetooth::packet::kLittleEndian>(
+              std::make_shared<std::vector<uint8_t>>(packet)));
+  if (!packet_view.IsValid()) {
+    LOG_WARN("sending invalid LL packet");
+    return;
+  }
+
+  for (const auto& device :
+       listeners_[static_cast<uint8_t>(packet_view.GetType())]) {
     // Do not send the packet back to the sender.
     if (sender_id != device->id) {
-      device->Receive(packet, type,
+      device->Receive(packet_view, type,
                       ComputeRssi(sender_id, device->id, tx_power));
     }
   }
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <memory>
 #include <vector>
@@ -57,6 +58,11 @@ class PhyLayer {
  protected:
   // List of devices currently connected to the phy.
   std::list<std::shared_ptr<rootcanal::PhyDevice>> phy_devices_;
+
+  // Devices currently connected to the phy, indexed by the link layer packet
+  // types they listen to.
+  std::array<std::vector<std::shared_ptr<rootcanal::PhyDevice>>, 256>
+      listeners_;
 };
 
 }  // namespace rootcanal
@@ -72,6 +72,19 @@ void TestModel::SetTimerPeriod(std::chrono::milliseconds new_period) {
   StartTimer();
 }
 
+void TestModel::SetDeviceThreads(size_t num_threads) {
+  if (num_threads > 1) {
+    device_runner_ = std::make_unique<ParallelRunner>(num_threads);
+  } else {
+    device_runner_.reset();
+  }
+  for (auto& [_, device] : phy_devices_) {
+    device->FlushOutgoing();
+    device->ReceiveIncoming();
+    device->SetDeferred(device_runner_ != nullptr);
+  }
+}
+
 void TestModel::StartTimer() {
   LOG_INFO("StartTimer()");
   timer_tick_task_ =
@@ -119,6 +132,7 @@ PhyDevice::Identifier TestModel::AddDevice(std::shared_ptr<Device> device) {
   std::string device_type = device->GetTypeString();
   std::shared_ptr<PhyDevice> phy_device =
       CreatePhyDevice(device_id.value(), device_type, std::move(device));
+  phy_device->SetDeferred(device_runner_ != nullptr);
   phy_devices_[phy_device->id] = phy_device;
   return phy_device->id;
 }
@@ -260,8 +274,35 @@ const std::string& TestModel::List() {
 }
 
 void TestModel::Tick() {
+  if (device_runner_ == nullptr) {
+    for (auto& [_, device] : phy_devices_) {
+      device->Tick();
+    }
+    return;
+  }
+
+  // The devices are sorted by identifier.
+  std::vector<PhyDevice*> devices;
+  devices.reserve(phy_devices_.size());
   for (auto& [_, device] : phy_devices_) {
-    device->Tick();
+    devices.push_back(device.get());
+  }
+  device_runner_->Run(devices.size(),
+                      [&devices](size_t i) { devices[i]->Tick(); });
+
+  // Deliver the packets sent by the devices, and then the packets sent in
+  // response, until no device has anything left to send.
+  while (true) {
+    bool sent = false;
+    for (auto* device : devices) {
+      sent |= device->FlushOutgoing();
+    }
+    if (!sent) {
+      break;
+    }
+    device_runner_->Run(devices.size(), [&devices](size_t i) {
+      devices[i]->ReceiveIncoming();
+    });
   }
 }
 
@@ -27,6 +27,7 @@
 #include "hci/address.h"                       // for Address
 #include "model/devices/hci_device.h"          // for HciDevice
 #include "model/setup/async_manager.h"         // for AsyncUserId, AsyncTaskId
+#include "model/setup/parallel_runner.h"       // for ParallelRunner
 #include "phy.h"                               // for Phy, Phy::Type
 #include "phy_layer.h"
 
@@ -60,6 +61,13 @@ class TestModel {
     reuse_device_ids_ = reuse_device_ids;
   }
 
+  // Tick the devices concurrently on |num_threads| threads. The link layer
+  // packets exchanged by the devices are then delivered between the ticks,
+  // by rounds, in the order of the sender identifiers so that the simulation
+  // stays deterministic. A single thread runs the devices in sequence on the
+  // task thread, with immediate delivery of the packets.
+  void SetDeviceThreads(size_t num_threads);
+
   // Allow derived classes to use custom phy layer.
   virtual std::unique_ptr<PhyLayer> CreatePhyLayer(PhyLayer::Identifier id,
                                                    Phy::Type type);
@@ -118,6 +126,9 @@ class TestModel {
   PhyDevice::Identifier next_device_id_{0};
   bool reuse_device_ids_{true};
 
+  // Runner of the device ticks, null if they run in sequence.
+  std::unique_ptr<ParallelRunner> device_runner_;
+
   // Prefix used to generate public device addresses for hosts
   // connecting over TCP.
   std::array<uint8_t, 5> bluetooth_address_prefix_;
@@ -29,12 +29,15 @@
 #include <condition_variable>  // for condition_variable
 #include <cstdint>             // for uint16_t
 #include <cstring>             // for memset, strcmp, strcpy, strlen
+#include <future>              // for promise, future
 #include <mutex>               // for mutex
 #include <ratio>               // for ratio
 #include <string>              // for string
 #include <thread>
 #include <tuple>  // for tuple
 
+#include "model/setup/clock.h"  // for Clock
+
 namespace rootcanal {
 
 class Event {
@@ -490,4 +493,36 @@ TEST_F(AsyncManagerTest, TestCancelAsyncTasksFromUser) {
   ASSERT_FALSE(async_manager_.CancelAsyncTask(task5_id));
 }
 
+TEST_F(AsyncManagerTest, TestVirtualTime) {
+  async_manager_.EnableVirtualTime(std::chrono::milliseconds(10));
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  std::promise<Clock::time_point> task1_time;
+  Clock::time_point start = Clock::now();
+  async_manager_.ExecAsync(user1, std::chrono::hours(1), [&task1_time]() {
+    task1_time.set_value(Clock::now());
+  });
+  auto task1_future = task1_time.get_future();
+  ASSERT_EQ(task1_future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  ASSERT_GE(task1_future.get() - start, std::chrono::hours(1));
+}
+
+TEST_F(AsyncManagerTest, TestVirtualTimePeriodicTask) {
+  async_manager_.EnableVirtualTime(std::chrono::milliseconds(10));
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  // One minute of ticks of 5ms, the period of the test model timer
+  int ticks = 0;
+  std::promise<void> ticks_done;
+  AsyncTaskId task1_id = async_manager_.ExecAsyncPeriodically(
+      user1, std::chrono::milliseconds(0), std::chrono::milliseconds(5),
+      [&ticks, &ticks_done]() {
+        if (++ticks == 12000) {
+          ticks_done.set_value();
+        }
+      });
+  ASSERT_EQ(ticks_done.get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  ASSERT_TRUE(async_manager_.CancelAsyncTask(task1_id));
+}
+
 }  // namespace rootcanal
@@ -28,6 +28,7 @@ class H4ParserTest : public ::testing::Test {
  protected:
   void SetUp() override {
     packet_.clear();
+    packets_.clear();
     parser_.Reset();
   }
 
@@ -35,6 +36,7 @@ class H4ParserTest : public ::testing::Test {
 
   void PacketReadCallback(const std::vector<uint8_t>& packet) {
     packet_ = std::move(packet);
+    packets_.push_back(packet_);
   }
 
  protected:
@@ -62,6 +64,7 @@ class H4ParserTest : public ::testing::Test {
       true,
   };
   PacketData packet_;
+  std::vector<PacketData> packets_;
   PacketType type_;
 };
 
@@ -182,4 +185,37 @@ TEST_F(H4ParserTest, Recovery) {
   }
 }
 
+TEST_F(H4ParserTest, ConsumeAllParsesSeveralPackets) {
+  PacketData data({
+      0x01, 0x03, 0x0c, 0x00,                    // HCI Reset
+      0x02, 0x01, 0x00, 0x03, 0x00, 0xa, 0xb, 0xc,  // ACL
+      0x01, 0x01, 0x10, 0x00,                    // HCI Read Local Version
+  });
+  ASSERT_TRUE(parser_.ConsumeAll(data.data(), data.size()));
+  ASSERT_EQ(parser_.CurrentState(), H4Parser::State::HCI_TYPE);
+  ASSERT_EQ(packets_, std::vector<PacketData>({
+                          {0x03, 0x0c, 0x00},
+                          {0x01, 0x00, 0x03, 0x00, 0xa, 0xb, 0xc},
+                          {0x01, 0x10, 0x00},
+                      }));
+}
+
+TEST_F(H4ParserTest, ConsumeAllParsesSplitPackets) {
+  PacketData data({
+      0x02, 0x01, 0x00, 0x03, 0x00, 0xa, 0xb, 0xc,  // ACL
+      0x01, 0x01, 0x10, 0x00,                    // HCI Read Local Version
+  });
+  // Split the stream at every possible offset.
+  for (size_t split = 0; split <= data.size(); split++) {
+    packets_.clear();
+    ASSERT_TRUE(parser_.ConsumeAll(data.data(), split));
+    ASSERT_TRUE(parser_.ConsumeAll(data.data() + split, data.size() - split));
+    ASSERT_EQ(parser_.CurrentState(), H4Parser::State::HCI_TYPE);
+    ASSERT_EQ(packets_, std::vector<PacketData>({
+                            {0x01, 0x00, 0x03, 0x00, 0xa, 0xb, 0xc},
+                            {0x01, 0x10, 0x00},
+                        }));
+  }
+}
+
 }  // namespace rootcanal
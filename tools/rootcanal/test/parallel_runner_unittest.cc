@@ -0,0 +1,61 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/parallel_runner.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace rootcanal {
+
+TEST(ParallelRunnerTest, RunsAllJobs) {
+  ParallelRunner runner(4);
+  for (size_t count : {0, 1, 3, 100}) {
+    std::vector<int> calls(count, 0);
+    runner.Run(count, [&calls](size_t i) { calls[i]++; });
+    ASSERT_EQ(calls, std::vector<int>(count, 1));
+  }
+}
+
+TEST(ParallelRunnerTest, RunsOnCallingThreadAlone) {
+  ParallelRunner runner(1);
+  std::thread::id caller = std::this_thread::get_id();
+  std::atomic_bool other_thread{false};
+  runner.Run(10, [caller, &other_thread](size_t) {
+    if (std::this_thread::get_id() != caller) {
+      other_thread = true;
+    }
+  });
+  ASSERT_FALSE(other_thread);
+}
+
+TEST(ParallelRunnerTest, WaitsForAllJobs) {
+  ParallelRunner runner(4);
+  std::atomic_int completed{0};
+  for (int batch = 1; batch <= 20; batch++) {
+    runner.Run(8, [&completed](size_t) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      completed++;
+    });
+    ASSERT_EQ(completed, 8 * batch);
+  }
+}
+
+}  // namespace rootcanal